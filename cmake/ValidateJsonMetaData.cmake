@@ -0,0 +1,112 @@
+# Validates an internal FactMetaData or MavCmdInfo json file at build time, so that a broken file fails the
+# build instead of only logging a warning when it is loaded.
+#
+# cmake -DJSON_FILE=<file> -DSTAMP_FILE=<stamp> -P ValidateJsonMetaData.cmake
+
+cmake_minimum_required(VERSION 3.22.1)
+
+if(NOT JSON_FILE OR NOT STAMP_FILE)
+    message(FATAL_ERROR "JSON_FILE and STAMP_FILE are required")
+endif()
+
+set(KNOWN_FACT_TYPES Uint8 Int8 Uint16 Int16 Uint32 Int32 Uint64 Int64 Float Double String Bool ElapsedSeconds Custom)
+set(KNOWN_MAVCMD_KEYS
+    comment id rawName friendlyName description standaloneCoordinate specifiesCoordinate friendlyEdit
+    param1 param2 param3 param4 param5 param6 param7 paramRemove category specifiesAltitudeOnly
+    isLandCommand isTakeoffCommand isLoiterCommand
+)
+
+function(json_error message)
+    message(FATAL_ERROR "${JSON_FILE}: ${message}")
+endfunction()
+
+file(READ ${JSON_FILE} json)
+
+string(JSON type ERROR_VARIABLE error TYPE "${json}")
+if(error)
+    json_error("${error}")
+elseif(NOT type STREQUAL "OBJECT")
+    json_error("root is not an object")
+endif()
+
+# Header, see JsonHelper::validateInternalQGCJsonFile
+string(JSON file_type ERROR_VARIABLE error GET "${json}" fileType)
+if(error)
+    json_error("fileType is missing")
+endif()
+string(JSON version ERROR_VARIABLE error GET "${json}" version)
+if(error OR NOT version MATCHES "^[0-9]+$")
+    json_error("version is missing or not a number")
+endif()
+
+if(file_type STREQUAL "FactMetaData")
+    # See FactMetaData::createMapFromJsonFile and FactMetaData::createFromJsonObject
+    string(JSON facts_type ERROR_VARIABLE error TYPE "${json}" "QGC.MetaData.Facts")
+    if(error OR NOT facts_type STREQUAL "ARRAY")
+        json_error("QGC.MetaData.Facts is missing or not an array")
+    endif()
+    string(JSON count LENGTH "${json}" "QGC.MetaData.Facts")
+    set(names)
+    if(count GREATER 0)
+        math(EXPR last "${count} - 1")
+        foreach(index RANGE ${last})
+            string(JSON name ERROR_VARIABLE error GET "${json}" "QGC.MetaData.Facts" ${index} name)
+            if(error)
+                json_error("fact ${index} has no name")
+            endif()
+            string(JSON fact_type ERROR_VARIABLE error GET "${json}" "QGC.MetaData.Facts" ${index} type)
+            if(error)
+                json_error("fact ${name} has no type")
+            endif()
+            # FactMetaData::stringToType is case insensitive
+            set(known_type FALSE)
+            foreach(known ${KNOWN_FACT_TYPES})
+                string(TOLOWER "${known}" known)
+                string(TOLOWER "${fact_type}" lower_type)
+                if(known STREQUAL lower_type)
+                    set(known_type TRUE)
+                endif()
+            endforeach()
+            if(NOT known_type)
+                json_error("fact ${name} has unknown type ${fact_type}")
+            endif()
+            if(name IN_LIST names)
+                json_error("duplicate fact ${name}")
+            endif()
+            list(APPEND names ${name})
+        endforeach()
+    endif()
+elseif(file_type STREQUAL "MavCmdInfo")
+    # See MissionCommandList::_loadMavCmdInfoJson and MissionCommandUIInfo::loadJsonInfo
+    string(JSON info_type ERROR_VARIABLE error TYPE "${json}" mavCmdInfo)
+    if(error OR NOT info_type STREQUAL "ARRAY")
+        json_error("mavCmdInfo is missing or not an array")
+    endif()
+    string(JSON count LENGTH "${json}" mavCmdInfo)
+    set(ids)
+    if(count GREATER 0)
+        math(EXPR last "${count} - 1")
+        foreach(index RANGE ${last})
+            string(JSON id ERROR_VARIABLE error GET "${json}" mavCmdInfo ${index} id)
+            if(error OR NOT id MATCHES "^[0-9]+$")
+                json_error("mavCmdInfo ${index} has no numeric id")
+            endif()
+            string(JSON key_count LENGTH "${json}" mavCmdInfo ${index})
+            math(EXPR last_key "${key_count} - 1")
+            foreach(key_index RANGE ${last_key})
+                string(JSON key MEMBER "${json}" mavCmdInfo ${index} ${key_index})
+                if(NOT key IN_LIST KNOWN_MAVCMD_KEYS)
+                    json_error("command ${id} has unknown key ${key}")
+                endif()
+            endforeach()
+            if(id IN_LIST ids)
+                json_error("duplicate command ${id}")
+            endif()
+            list(APPEND ids ${id})
+        endforeach()
+    endif()
+else()
+    json_error("unexpected fileType ${file_type}")
+endif()
+
+file(TOUCH ${STAMP_FILE})
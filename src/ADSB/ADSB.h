@@ -43,6 +43,7 @@ enum AvailableInfoType {
     AltitudeAvailable = 1 << 2,
     HeadingAvailable = 1 << 3,
     AlertAvailable = 1 << 4,
+    VelocityAvailable = 1 << 5,
 };
 Q_FLAG_NS(AvailableInfoType)
 Q_DECLARE_FLAGS(AvailableInfoTypes, AvailableInfoType)
@@ -54,6 +55,8 @@ struct VehicleInfo_t {
     QGeoCoordinate location;
     double altitude; // TODO: Use Altitude in QGeoCoordinate?
     double heading;
+    double velocity;            ///< Horizontal speed in m/s
+    double verticalVelocity;    ///< Climb rate in m/s, positive up
     bool alert;
     AvailableInfoTypes availableFlags;
 };
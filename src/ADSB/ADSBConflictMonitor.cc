@@ -0,0 +1,166 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBConflictMonitor.h"
+#include "ADSBVehicleListModel.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QtMath>
+#include <QtCore/QTimer>
+
+#include <cmath>
+
+QGC_LOGGING_CATEGORY(ADSBConflictMonitorLog, "qgc.adsb.adsbconflictmonitor")
+
+ADSBConflictMonitor::ADSBConflictMonitor(QObject *parent)
+    : QObject(parent)
+{
+    // qCDebug(ADSBConflictMonitorLog) << Q_FUNC_INFO << this;
+}
+
+ADSBConflictMonitor::~ADSBConflictMonitor()
+{
+    // qCDebug(ADSBConflictMonitorLog) << Q_FUNC_INFO << this;
+}
+
+void ADSBConflictMonitor::start()
+{
+    // Created here so they belong to the thread of the monitor
+    _traffic = new ADSBVehicleListModel(this);
+
+    _probeTimer = new QTimer(this);
+    _probeTimer->setInterval(_probeIntervalMSecs);
+    (void) connect(_probeTimer, &QTimer::timeout, this, &ADSBConflictMonitor::_probe);
+    _probeTimer->start();
+}
+
+void ADSBConflictMonitor::adsbVehicleUpdates(const QList<ADSB::VehicleInfo_t> &vehicleInfos)
+{
+    if (!_traffic) {
+        return;
+    }
+
+    for (const ADSB::VehicleInfo_t &vehicleInfo : vehicleInfos) {
+        _traffic->update(vehicleInfo);
+    }
+}
+
+void ADSBConflictMonitor::setVehicleStates(const QList<VehicleState_t> &vehicleStates)
+{
+    _vehicles = vehicleStates;
+}
+
+void ADSBConflictMonitor::_probe()
+{
+    _traffic->removeExpired();
+
+    QList<Conflict_t> conflicts;
+    if (_traffic->count() > 0) {
+        for (const VehicleState_t &vehicle : _vehicles) {
+            if (vehicle.coordinate.isValid()) {
+                _probeVehicle(vehicle, conflicts);
+            }
+        }
+    }
+
+    if (!conflicts.isEmpty() || _conflictsReported) {
+        _conflictsReported = !conflicts.isEmpty();
+        emit conflictsUpdated(conflicts);
+    }
+}
+
+void ADSBConflictMonitor::_probeVehicle(const VehicleState_t &vehicle, QList<Conflict_t> &conflicts)
+{
+    const QList<ADSB::VehicleInfo_t> candidates = _traffic->aircraftWithin(vehicle.coordinate, _horizontalSeparationMeters + (_maxClosingSpeed * _lookAheadSecs));
+    if (candidates.isEmpty()) {
+        return;
+    }
+
+    // Flat earth around the vehicle, east/north/up relative to the vehicle
+    static constexpr double metersPerDegree = 111320.0;
+    const double lonScale = metersPerDegree * std::cos(qDegreesToRadians(vehicle.coordinate.latitude()));
+    const double vehicleHeading = qDegreesToRadians(vehicle.heading);
+    const double vehicleVx = vehicle.groundSpeed * std::sin(vehicleHeading);
+    const double vehicleVy = vehicle.groundSpeed * std::cos(vehicleHeading);
+
+    const size_t count = static_cast<size_t>(candidates.count());
+    _x.resize(count);
+    _y.resize(count);
+    _z.resize(count);
+    _vx.resize(count);
+    _vy.resize(count);
+    _vz.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const ADSB::VehicleInfo_t &aircraft = candidates[static_cast<qsizetype>(i)];
+        double deltaLon = aircraft.location.longitude() - vehicle.coordinate.longitude();
+        if (deltaLon > 180.0) {
+            deltaLon -= 360.0;
+        } else if (deltaLon < -180.0) {
+            deltaLon += 360.0;
+        }
+        _x[i] = deltaLon * lonScale;
+        _y[i] = (aircraft.location.latitude() - vehicle.coordinate.latitude()) * metersPerDegree;
+        _z[i] = (aircraft.availableFlags & ADSB::AltitudeAvailable) ? (aircraft.altitude - vehicle.altitudeAMSL) : 0.0;
+
+        // Aircraft without velocity or heading are probed as if they were stationary
+        double speed = 0;
+        double verticalSpeed = 0;
+        if ((aircraft.availableFlags & ADSB::VelocityAvailable) && (aircraft.availableFlags & ADSB::HeadingAvailable)) {
+            speed = aircraft.velocity;
+            verticalSpeed = aircraft.verticalVelocity;
+        }
+        const double heading = qDegreesToRadians(aircraft.heading);
+        _vx[i] = (speed * std::sin(heading)) - vehicleVx;
+        _vy[i] = (speed * std::cos(heading)) - vehicleVy;
+        _vz[i] = verticalSpeed - vehicle.climbRate;
+    }
+
+    // Closest point of approach of the horizontal tracks, the vertical distance is taken at that time
+    _cpaHorizontal.resize(count);
+    _cpaVertical.resize(count);
+    _cpaTime.resize(count);
+    const double *const x = _x.data();
+    const double *const y = _y.data();
+    const double *const z = _z.data();
+    const double *const vx = _vx.data();
+    const double *const vy = _vy.data();
+    const double *const vz = _vz.data();
+    double *const cpaHorizontal = _cpaHorizontal.data();
+    double *const cpaVertical = _cpaVertical.data();
+    double *const cpaTime = _cpaTime.data();
+    for (size_t i = 0; i < count; i++) {
+        const double vv = (vx[i] * vx[i]) + (vy[i] * vy[i]);
+        const double rv = (x[i] * vx[i]) + (y[i] * vy[i]);
+        const double t = (vv > 1e-6) ? qBound(0.0, -rv / vv, _lookAheadSecs) : 0.0;
+        const double dx = x[i] + (vx[i] * t);
+        const double dy = y[i] + (vy[i] * t);
+        cpaHorizontal[i] = std::sqrt((dx * dx) + (dy * dy));
+        cpaVertical[i] = std::fabs(z[i] + (vz[i] * t));
+        cpaTime[i] = t;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if ((cpaHorizontal[i] < _horizontalSeparationMeters) && (cpaVertical[i] < _verticalSeparationMeters)) {
+            const ADSB::VehicleInfo_t &aircraft = candidates[static_cast<qsizetype>(i)];
+
+            Conflict_t conflict;
+            conflict.vehicleId = vehicle.vehicleId;
+            conflict.icaoAddress = aircraft.icaoAddress;
+            conflict.callsign = aircraft.callsign;
+            conflict.horizontalDistance = cpaHorizontal[i];
+            conflict.verticalDistance = cpaVertical[i];
+            conflict.timeToClosestApproach = cpaTime[i];
+            conflicts.append(conflict);
+
+            qCDebug(ADSBConflictMonitorLog) << "Conflict vehicle" << vehicle.vehicleId << "aircraft" << QString::number(aircraft.icaoAddress, 16)
+                                            << "cpa" << conflict.horizontalDistance << conflict.verticalDistance << "tcpa" << conflict.timeToClosestApproach;
+        }
+    }
+}
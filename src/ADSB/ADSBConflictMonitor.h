@@ -0,0 +1,96 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+
+#include <vector>
+
+#include "ADSB.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ADSBConflictMonitorLog)
+
+class ADSBVehicleListModel;
+class QTimer;
+
+/// Probes the ADS-B traffic for conflicts with the connected vehicles at a fixed rate. The monitor lives on its
+/// own thread and keeps its own copy of the traffic, so probing does not touch the GUI thread. Only aircraft which
+/// could reach a vehicle within the look ahead time are taken from the spatial index, their closest point of
+/// approach is then computed for all of them at once on flat arrays.
+class ADSBConflictMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Vehicle as of the last update from the GUI thread
+    typedef struct {
+        int vehicleId = 0;
+        QGeoCoordinate coordinate;
+        double altitudeAMSL = 0;            ///< m
+        double groundSpeed = 0;             ///< m/s
+        double heading = 0;                 ///< degrees
+        double climbRate = 0;               ///< m/s
+    } VehicleState_t;
+
+    /// Predicted loss of separation between a vehicle and an aircraft
+    typedef struct {
+        int vehicleId = 0;
+        uint32_t icaoAddress = 0;
+        QString callsign;
+        double horizontalDistance = 0;      ///< Horizontal distance at the closest point of approach in m
+        double verticalDistance = 0;        ///< Vertical distance at the closest point of approach in m
+        double timeToClosestApproach = 0;   ///< s, 0 if separation is already lost
+    } Conflict_t;
+
+    explicit ADSBConflictMonitor(QObject *parent = nullptr);
+    ~ADSBConflictMonitor();
+
+public slots:
+    /// Starts probing, must be called on the thread the monitor lives on
+    void start();
+
+    void adsbVehicleUpdates(const QList<ADSB::VehicleInfo_t> &vehicleInfos);
+    void setVehicleStates(const QList<ADSBConflictMonitor::VehicleState_t> &vehicleStates);
+
+signals:
+    /// Emitted after each probe which found conflicts, and once after the last conflict cleared
+    void conflictsUpdated(const QList<ADSBConflictMonitor::Conflict_t> &conflicts);
+
+private:
+    void _probe();
+    void _probeVehicle(const VehicleState_t &vehicle, QList<Conflict_t> &conflicts);
+
+    ADSBVehicleListModel *_traffic = nullptr;
+    QTimer *_probeTimer = nullptr;
+    QList<VehicleState_t> _vehicles;
+    bool _conflictsReported = false;
+
+    // Traffic relative to the vehicle being probed, one entry per candidate aircraft
+    std::vector<double> _x;
+    std::vector<double> _y;
+    std::vector<double> _z;
+    std::vector<double> _vx;
+    std::vector<double> _vy;
+    std::vector<double> _vz;
+    std::vector<double> _cpaHorizontal;
+    std::vector<double> _cpaVertical;
+    std::vector<double> _cpaTime;
+
+    static constexpr int _probeIntervalMSecs = 1000;
+    static constexpr double _lookAheadSecs = 60.0;
+    static constexpr double _horizontalSeparationMeters = 1000.0;
+    static constexpr double _verticalSeparationMeters = 150.0;
+    static constexpr double _maxClosingSpeed = 350.0;       ///< m/s, bounds the search radius around a vehicle
+};
+
+Q_DECLARE_METATYPE(ADSBConflictMonitor::VehicleState_t)
+Q_DECLARE_METATYPE(ADSBConflictMonitor::Conflict_t)
@@ -12,17 +12,24 @@
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QTimer>
+#include <QtCore/QtMath>
 #include <QtNetwork/QTcpSocket>
 
+#include <cmath>
+
 QGC_LOGGING_CATEGORY(ADSBTCPLinkLog, "qgc.adsb.adsbtcplink")
 
-ADSBTCPLink::ADSBTCPLink(const QHostAddress &hostAddress, quint16 port, QObject *parent)
+ADSBTCPLink::ADSBTCPLink(const QHostAddress &hostAddress, quint16 port, DataFormat format, QObject *parent)
     : QObject(parent)
     , _hostAddress(hostAddress)
     , _port(port)
+    , _format(format)
     , _socket(new QTcpSocket(this))
-    , _processTimer(new QTimer(this))
+    , _reconnectTimer(new QTimer(this))
 {
+    _reconnectTimer->setSingleShot(true);
+    (void) connect(_reconnectTimer, &QTimer::timeout, this, &ADSBTCPLink::_connectToHost);
+
 #ifdef QT_DEBUG
     (void) connect(_socket, &QTcpSocket::stateChanged, this, [](QTcpSocket::SocketState state) {
         switch (state) {
@@ -46,16 +53,17 @@ ADSBTCPLink::ADSBTCPLink(const QHostAddress &hostAddress, quint16 port, QObject
 
     (void) QObject::connect(_socket, &QTcpSocket::errorOccurred, this, [this](QTcpSocket::SocketError error) {
         qCDebug(ADSBTCPLinkLog) << error << _socket->errorString();
-        // TODO: Check if it is a critical error or not and send if the socket is stopped/recoverable
-        emit errorOccurred(_socket->errorString(), false);
+        // The connection is retried, so only the first error of an outage is reported
+        if (!_errorReported) {
+            _errorReported = true;
+            emit errorOccurred(_socket->errorString(), false);
+        }
     }, Qt::AutoConnection);
 
+    (void) connect(_socket, &QTcpSocket::stateChanged, this, &ADSBTCPLink::_socketStateChanged);
     (void) connect(_socket, &QTcpSocket::readyRead, this, &ADSBTCPLink::_readBytes);
 
-    _processTimer->setInterval(_processInterval); // Set an interval for processing lines
-    (void) connect(_processTimer, &QTimer::timeout, this, &ADSBTCPLink::_processLines);
-
-    init();
+    _clock.start();
 
     // qCDebug(ADSBTCPLinkLog) << Q_FUNC_INFO << this;
 }
@@ -74,50 +82,103 @@ bool ADSBTCPLink::init()
         return false;
     }
 
-    _socket->connectToHost(_hostAddress, _port);
+    _connectToHost();
 
     return true;
 }
 
+void ADSBTCPLink::_connectToHost()
+{
+    // Partial data of the previous connection cannot be continued
+    _lineBuffer.clear();
+    _beastFrameLength = 0;
+    _beastFrameBytes = 0;
+    _beastEscape = false;
+
+    _socket->connectToHost(_hostAddress, _port);
+}
+
+void ADSBTCPLink::_socketStateChanged(QAbstractSocket::SocketState state)
+{
+    if (state == QAbstractSocket::ConnectedState) {
+        _reconnectDelayMSecs = _minReconnectDelayMSecs;
+        _errorReported = false;
+    } else if ((state == QAbstractSocket::UnconnectedState) && !_reconnectTimer->isActive()) {
+        qCDebug(ADSBTCPLinkLog) << "Reconnecting to" << _hostAddress << _port << "in" << _reconnectDelayMSecs << "ms";
+        _reconnectTimer->start(_reconnectDelayMSecs);
+        _reconnectDelayMSecs = qMin(_reconnectDelayMSecs * 2, _maxReconnectDelayMSecs);
+    }
+}
+
 void ADSBTCPLink::_readBytes()
 {
-    while (_socket && _socket->canReadLine()) {
-        const QByteArray bytes = _socket->readLine();
-        (void) _lineBuffer.append(QString::fromLocal8Bit(bytes));
+    char buffer[_readChunkSize];
+
+    while (_socket && (_socket->bytesAvailable() > 0)) {
+        const qint64 bytesRead = _socket->read(buffer, sizeof(buffer));
+        if (bytesRead <= 0) {
+            break;
+        }
+
+        const QByteArrayView bytes(buffer, bytesRead);
+        if (_format == BeastFormat) {
+            _processBeast(bytes);
+        } else {
+            _processSbs(bytes);
+        }
     }
 
-    // Start or restart the timer to process lines
-    if (!_processTimer->isActive()) {
-        _processTimer->start();
+    if (!_updates.isEmpty()) {
+        emit adsbVehicleUpdates(_updates);
+        _updates.clear();
+    }
+
+    if (_format == BeastFormat) {
+        _pruneCprCache();
     }
 }
 
-void ADSBTCPLink::_processLines()
+void ADSBTCPLink::_processSbs(QByteArrayView bytes)
 {
-    int linesProcessed = 0;
-    while (!_lineBuffer.isEmpty() && (linesProcessed < _maxLinesToProcess)) {
-        const QString line = _lineBuffer.takeFirst();
-        _parseLine(line);
-        ++linesProcessed;
+    qsizetype lineStart = 0;
+    qsizetype lineEnd;
+    while ((lineEnd = bytes.indexOf('\n', lineStart)) >= 0) {
+        const QByteArrayView line = bytes.sliced(lineStart, lineEnd - lineStart);
+        if (_lineBuffer.isEmpty()) {
+            _parseLine(line);
+        } else {
+            (void) _lineBuffer.append(line);
+            _parseLine(_lineBuffer);
+            _lineBuffer.resize(0);
+        }
+        lineStart = lineEnd + 1;
     }
 
-    // Stop the timer if there are no more lines to process
-    if (_lineBuffer.isEmpty()) {
-        _processTimer->stop();
+    if (lineStart < bytes.size()) {
+        (void) _lineBuffer.append(bytes.sliced(lineStart));
+        if (_lineBuffer.size() > _maxSbsLineLength) {
+            qCDebug(ADSBTCPLinkLog) << "ADSB SBS-1 line too long, dropped";
+            _lineBuffer.resize(0);
+        }
     }
 }
 
-void ADSBTCPLink::_parseLine(const QString &line)
+void ADSBTCPLink::_parseLine(QByteArrayView line)
 {
+    if (line.endsWith('\r')) {
+        line.chop(1);
+    }
+
     if (line.size() <= 4) {
         return;
     }
 
-    if (!line.startsWith(QStringLiteral("MSG"))) {
+    if (!line.startsWith("MSG")) {
         return;
     }
 
-    const int msgType = line.at(4).digitValue();
+    const char type = line.at(4);
+    const int msgType = ((type >= '0') && (type <= '9')) ? (type - '0') : ADSB::Unsupported;
     if (msgType == ADSB::Unsupported) {
         qCDebug(ADSBTCPLinkLog) << "ADSB Invalid message type" << msgType;
         return;
@@ -130,13 +191,23 @@ void ADSBTCPLink::_parseLine(const QString &line)
 
     qCDebug(ADSBTCPLinkLog) << "ADSB SBS-1" << line;
 
-    const QStringList values = line.split(QChar(','));
-    if (values.size() <= 4) {
+    // Split in place, the fields are views into the line
+    std::array<QByteArrayView, _sbsFieldCount> values;
+    qsizetype valueCount = 0;
+    qsizetype fieldStart = 0;
+    for (qsizetype i = 0; (i <= line.size()) && (valueCount < _sbsFieldCount); i++) {
+        if ((i == line.size()) || (line.at(i) == ',')) {
+            values[valueCount++] = line.sliced(fieldStart, i - fieldStart);
+            fieldStart = i + 1;
+        }
+    }
+
+    if (valueCount <= 4) {
         return;
     }
 
     bool icaoOk;
-    const uint32_t icaoAddress = values.at(4).toUInt(&icaoOk, 16);
+    const uint32_t icaoAddress = values[4].toUInt(&icaoOk, 16);
     if (!icaoOk) {
         return;
     }
@@ -148,91 +219,348 @@ void ADSBTCPLink::_parseLine(const QString &line)
     case ADSB::IdentificationAndCategory:
     case ADSB::SurveillanceAltitude:
     case ADSB::SurveillanceId:
-        _parseAndEmitCallsign(adsbInfo, values);
+    {
+        if (valueCount <= 10) {
+            return;
+        }
+
+        const QByteArrayView callsign = values[10].trimmed();
+        if (callsign.isEmpty()) {
+            return;
+        }
+
+        adsbInfo.callsign = QString::fromLatin1(callsign);
+        adsbInfo.availableFlags = ADSB::CallsignAvailable;
         break;
+    }
     case ADSB::AirbornePosition:
-        _parseAndEmitLocation(adsbInfo, values);
+    {
+        if (valueCount <= 19) {
+            return;
+        }
+
+        // Altitude is either Barometric - based on pressure, in ft
+        // or HAE - as reported by GPS - based on WGS84 Ellipsoid, in ft
+        // If altitude ends with H, we have HAE
+        // There's a slight difference between Barometric alt and HAE, but it would require
+        // knowledge about Geoid shape in particular Lat, Lon. It's not worth complicating the code
+        QByteArrayView altitudeStr = values[11];
+        if (altitudeStr.endsWith('H')) {
+            altitudeStr.chop(1);
+        }
+
+        bool altOk, latOk, lonOk, alertOk;
+        const int modeCAltitude = altitudeStr.toInt(&altOk);
+        const double lat = values[14].toDouble(&latOk);
+        const double lon = values[15].toDouble(&lonOk);
+        const int alert = values[19].toInt(&alertOk);
+
+        if (!altOk || !latOk || !lonOk || !alertOk) {
+            return;
+        }
+
+        if (qFuzzyIsNull(lat) && qFuzzyIsNull(lon)) {
+            return;
+        }
+
+        adsbInfo.location = QGeoCoordinate(lat, lon);
+        adsbInfo.altitude = modeCAltitude * 0.3048;
+        adsbInfo.alert = (alert == 1);
+        adsbInfo.availableFlags = ADSB::LocationAvailable | ADSB::AltitudeAvailable | ADSB::AlertAvailable;
         break;
+    }
     case ADSB::AirborneVelocity:
-        _parseAndEmitHeading(adsbInfo, values);
+    {
+        if (valueCount <= 13) {
+            return;
+        }
+
+        bool headingOk;
+        const double heading = values[13].toDouble(&headingOk);
+        if (!headingOk) {
+            return;
+        }
+
+        adsbInfo.heading = heading;
+        adsbInfo.availableFlags = ADSB::HeadingAvailable;
+
+        // Ground speed in knots, vertical rate in ft/min
+        if (valueCount > 16) {
+            bool speedOk, verticalRateOk;
+            const double groundSpeed = values[12].toDouble(&speedOk);
+            const double verticalRate = values[16].toDouble(&verticalRateOk);
+            if (speedOk) {
+                adsbInfo.velocity = groundSpeed * 0.514444;
+                adsbInfo.verticalVelocity = verticalRateOk ? (verticalRate * 0.00508) : 0.0;
+                adsbInfo.availableFlags |= ADSB::VelocityAvailable;
+            }
+        }
         break;
+    }
     default:
-        break;
+        return;
     }
+
+    _updates.append(adsbInfo);
 }
 
-void ADSBTCPLink::_parseAndEmitCallsign(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values)
+void ADSBTCPLink::_processBeast(QByteArrayView bytes)
 {
-    if (values.size() <= 10) {
+    // <0x1a> <type> <6 byte timestamp> <signal level> <message>, 0x1a within a frame is sent twice
+    static constexpr quint8 escape = 0x1a;
+
+    for (const char c : bytes) {
+        const quint8 byte = static_cast<quint8>(c);
+
+        if (_beastEscape) {
+            _beastEscape = false;
+            if (byte != escape) {
+                // Start of a frame, a partial frame before it is dropped
+                switch (byte) {
+                case '1':
+                    _beastFrameLength = _beastHeaderLength + 2;     // Mode A/C
+                    break;
+                case '2':
+                    _beastFrameLength = _beastHeaderLength + 7;     // Mode S short
+                    break;
+                case '3':
+                    _beastFrameLength = _beastHeaderLength + 14;    // Mode S long
+                    break;
+                default:
+                    _beastFrameLength = 0;
+                    break;
+                }
+                _beastFrameBytes = 0;
+                continue;
+            }
+        } else if (byte == escape) {
+            _beastEscape = true;
+            continue;
+        }
+
+        if (_beastFrameLength == 0) {
+            continue;
+        }
+
+        _beastFrame[_beastFrameBytes++] = byte;
+        if (_beastFrameBytes == _beastFrameLength) {
+            if (_beastFrameLength > (_beastHeaderLength + 2)) {
+                _decodeModeS(QByteArrayView(_beastFrame.data() + _beastHeaderLength, _beastFrameLength - _beastHeaderLength));
+            }
+            _beastFrameLength = 0;
+        }
+    }
+}
+
+void ADSBTCPLink::_decodeModeS(QByteArrayView frame)
+{
+    // Only extended squitters carry callsign, position and velocity
+    if (frame.size() < 14) {
         return;
     }
 
-    const QString callsign = values.at(10).trimmed();
-    if (callsign.isEmpty()) {
+    const quint8 *const data = reinterpret_cast<const quint8*>(frame.data());
+    const int df = data[0] >> 3;
+    const int ca = data[0] & 0x07;
+    if ((df != 17) && !((df == 18) && (ca <= 1))) {
         return;
     }
 
-    adsbInfo.callsign = callsign;
-    adsbInfo.availableFlags = ADSB::CallsignAvailable;
+    const uint32_t icaoAddress = (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3];
 
-    emit adsbVehicleUpdate(adsbInfo);
-}
+    quint64 me = 0;
+    for (int i = 4; i < 11; i++) {
+        me = (me << 8) | data[i];
+    }
 
-void ADSBTCPLink::_parseAndEmitLocation(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values)
-{
-    if (values.size() <= 19) {
+    // Bits of the 56 bit ME field, numbered from 1 like in the specification
+    const auto meBits = [me](int first, int count) -> uint32_t {
+        return static_cast<uint32_t>((me >> (56 - first - count + 1)) & ((1ULL << count) - 1));
+    };
+
+    ADSB::VehicleInfo_t adsbInfo;
+    adsbInfo.icaoAddress = icaoAddress;
+
+    const uint32_t tc = meBits(1, 5);
+    if ((tc >= 1) && (tc <= 4)) {
+        static constexpr char charset[] = "#ABCDEFGHIJKLMNOPQRSTUVWXYZ##### ###############0123456789######";
+
+        char callsign[8];
+        for (int i = 0; i < 8; i++) {
+            callsign[i] = charset[meBits(9 + (i * 6), 6)];
+        }
+
+        const QByteArrayView trimmed = QByteArrayView(callsign, sizeof(callsign)).trimmed();
+        if (trimmed.isEmpty() || trimmed.contains('#')) {
+            return;
+        }
+
+        adsbInfo.callsign = QString::fromLatin1(trimmed);
+        adsbInfo.availableFlags = ADSB::CallsignAvailable;
+    } else if (((tc >= 9) && (tc <= 18)) || ((tc >= 20) && (tc <= 22))) {
+        const uint32_t altitudeCode = meBits(9, 12);
+        if (tc <= 18) {
+            // Barometric altitude in 25 ft steps when the Q bit is set, Gillham coded altitudes are not decoded
+            if (altitudeCode & 0x10) {
+                const int n = static_cast<int>(((altitudeCode & 0xfe0) >> 1) | (altitudeCode & 0x0f));
+                adsbInfo.altitude = ((n * 25) - 1000) * 0.3048;
+                adsbInfo.availableFlags |= ADSB::AltitudeAvailable;
+            }
+        } else if (altitudeCode != 0) {
+            // GNSS height in meters
+            adsbInfo.altitude = altitudeCode;
+            adsbInfo.availableFlags |= ADSB::AltitudeAvailable;
+        }
+
+        QGeoCoordinate location;
+        if (_decodeCprPosition(icaoAddress, meBits(22, 1), meBits(23, 17), meBits(40, 17), location)) {
+            adsbInfo.location = location;
+            adsbInfo.availableFlags |= ADSB::LocationAvailable;
+        }
+
+        if (!adsbInfo.availableFlags) {
+            return;
+        }
+    } else if (tc == 19) {
+        const uint32_t subtype = meBits(6, 3);
+        if ((subtype == 1) || (subtype == 2)) {
+            // Ground speed, east-west and north-south velocity offset by 1, 0 means not available
+            const uint32_t vew = meBits(15, 10);
+            const uint32_t vns = meBits(26, 10);
+            if ((vew == 0) || (vns == 0)) {
+                return;
+            }
+
+            // Supersonic subtype counts in 4 kt steps
+            const double scale = (subtype == 2) ? 4.0 : 1.0;
+            const double vx = (meBits(14, 1) ? -scale : scale) * (vew - 1);
+            const double vy = (meBits(25, 1) ? -scale : scale) * (vns - 1);
+            double heading = qRadiansToDegrees(std::atan2(vx, vy));
+            if (heading < 0.0) {
+                heading += 360.0;
+            }
+            adsbInfo.heading = heading;
+            adsbInfo.velocity = std::hypot(vx, vy) * 0.514444;
+            adsbInfo.availableFlags |= ADSB::VelocityAvailable;
+        } else if ((subtype == 3) || (subtype == 4)) {
+            // Airspeed, heading is sent when the status bit is set
+            if (!meBits(14, 1)) {
+                return;
+            }
+            adsbInfo.heading = meBits(15, 10) * (360.0 / 1024.0);
+
+            const uint32_t airspeed = meBits(27, 10);
+            if (airspeed != 0) {
+                adsbInfo.velocity = (airspeed - 1) * ((subtype == 4) ? 4.0 : 1.0) * 0.514444;
+                adsbInfo.availableFlags |= ADSB::VelocityAvailable;
+            }
+        } else {
+            return;
+        }
+
+        // Vertical rate in 64 ft/min steps, 0 means not available
+        const uint32_t verticalRate = meBits(38, 9);
+        adsbInfo.verticalVelocity = (verticalRate == 0) ? 0.0 : ((meBits(37, 1) ? -1.0 : 1.0) * (verticalRate - 1) * 64 * 0.00508);
+        adsbInfo.availableFlags |= ADSB::HeadingAvailable;
+    } else {
         return;
     }
 
-    // Altitude is either Barometric - based on pressure, in ft
-    // or HAE - as reported by GPS - based on WGS84 Ellipsoid, in ft
-    // If altitude ends with H, we have HAE
-    // There's a slight difference between Barometric alt and HAE, but it would require
-    // knowledge about Geoid shape in particular Lat, Lon. It's not worth complicating the code
-    QString altitudeStr = values.at(11);
-    if (altitudeStr.endsWith('H')) {
-        (void) altitudeStr.chop(1);
-    }
+    _updates.append(adsbInfo);
+}
 
-    bool altOk, latOk, lonOk, alertOk;
-    const int modeCAltitude = altitudeStr.toInt(&altOk);
-    const double lat = values.at(14).toDouble(&latOk);
-    const double lon = values.at(15).toDouble(&lonOk);
-    const int alert = values.at(19).toInt(&alertOk);
+bool ADSBTCPLink::_decodeCprPosition(uint32_t icaoAddress, bool odd, uint32_t latCpr, uint32_t lonCpr, QGeoCoordinate &location)
+{
+    const qint64 now = _clock.elapsed();
+    const int current = odd ? 1 : 0;
+    const int other = odd ? 0 : 1;
 
-    if (!altOk || !latOk || !lonOk || !alertOk) {
-        return;
+    CprFrames_t &frames = _cprFrames[icaoAddress];
+    frames.latCpr[current] = latCpr;
+    frames.lonCpr[current] = lonCpr;
+    frames.msecs[current] = now;
+
+    if ((frames.msecs[other] < 0) || ((now - frames.msecs[other]) > _cprMaxFrameAgeMSecs)) {
+        return false;
     }
 
-    if (qFuzzyIsNull(lat) && qFuzzyIsNull(lon)) {
-        return;
+    const auto cprMod = [](double a, double b) {
+        const double result = std::fmod(a, b);
+        return (result < 0.0) ? (result + b) : result;
+    };
+
+    static constexpr double cprScale = 131072.0;   // 2^17
+    const double latEven = frames.latCpr[0] / cprScale;
+    const double latOdd = frames.latCpr[1] / cprScale;
+    const double lonEven = frames.lonCpr[0] / cprScale;
+    const double lonOdd = frames.lonCpr[1] / cprScale;
+
+    const double j = std::floor((59.0 * latEven) - (60.0 * latOdd) + 0.5);
+    double rlatEven = (360.0 / 60.0) * (cprMod(j, 60.0) + latEven);
+    double rlatOdd = (360.0 / 59.0) * (cprMod(j, 59.0) + latOdd);
+    if (rlatEven >= 270.0) {
+        rlatEven -= 360.0;
+    }
+    if (rlatOdd >= 270.0) {
+        rlatOdd -= 360.0;
     }
 
-    const double altitude = modeCAltitude * 0.3048;
-    const QGeoCoordinate location(lat, lon);
+    if ((std::fabs(rlatEven) > 90.0) || (std::fabs(rlatOdd) > 90.0)) {
+        return false;
+    }
 
-    adsbInfo.location = location;
-    adsbInfo.altitude = altitude;
-    adsbInfo.alert = (alert == 1);
-    adsbInfo.availableFlags = ADSB::LocationAvailable | ADSB::AltitudeAvailable | ADSB::AlertAvailable;
+    // The frames straddle a longitude zone boundary, wait for the next pair
+    if (_cprNL(rlatEven) != _cprNL(rlatOdd)) {
+        return false;
+    }
+
+    const double lat = odd ? rlatOdd : rlatEven;
+    const int nl = _cprNL(lat);
+    const int ni = qMax(nl - current, 1);
+    const double m = std::floor((lonEven * (nl - 1)) - (lonOdd * nl) + 0.5);
+    double lon = (360.0 / ni) * (cprMod(m, ni) + (odd ? lonOdd : lonEven));
+    if (lon >= 180.0) {
+        lon -= 360.0;
+    }
 
-    emit adsbVehicleUpdate(adsbInfo);
+    location = QGeoCoordinate(lat, lon);
+    return location.isValid();
 }
 
-void ADSBTCPLink::_parseAndEmitHeading(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values)
+void ADSBTCPLink::_pruneCprCache()
 {
-    if (values.size() <= 13) {
+    const qint64 now = _clock.elapsed();
+    if ((now - _lastCprPruneMSecs) < _cprPruneIntervalMSecs) {
         return;
     }
-
-    bool headingOk;
-    const double heading = values.at(13).toDouble(&headingOk);
-    if (!headingOk) {
-        return;
+    _lastCprPruneMSecs = now;
+
+    for (auto it = _cprFrames.begin(); it != _cprFrames.end();) {
+        const qint64 lastHeard = qMax(it->msecs[0], it->msecs[1]);
+        if ((now - lastHeard) > _cprPruneIntervalMSecs) {
+            it = _cprFrames.erase(it);
+        } else {
+            ++it;
+        }
     }
+}
 
-    adsbInfo.heading = heading;
-    adsbInfo.availableFlags = ADSB::HeadingAvailable;
+int ADSBTCPLink::_cprNL(double lat)
+{
+    // Number of longitude zones at a latitude, 15 latitude zones between the equator and a pole
+    lat = std::fabs(lat);
+    if (lat < 1e-9) {
+        return 59;
+    }
+    if (lat > 87.0) {
+        return 1;
+    }
+    if (qFuzzyCompare(lat, 87.0)) {
+        return 2;
+    }
 
-    emit adsbVehicleUpdate(adsbInfo);
+    static constexpr int nz = 15;
+    const double a = 1.0 - std::cos(M_PI / (2.0 * nz));
+    const double b = std::cos(qDegreesToRadians(lat));
+    return static_cast<int>(std::floor((2.0 * M_PI) / std::acos(1.0 - (a / (b * b)))));
 }
@@ -9,10 +9,18 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
+#include <QtNetwork/QAbstractSocket>
 #include <QtNetwork/QHostAddress>
 
+#include <array>
+
 #include "ADSB.h"
 
 Q_DECLARE_LOGGING_CATEGORY(ADSBTCPLinkLog)
@@ -22,29 +30,41 @@ class QTimer;
 
 /// The ADSBTCPLink class handles the TCP connection to an ADS-B server
 /// and processes incoming ADS-B data.
+/// The link is meant to live on its own thread. Data is parsed as it arrives and the updates of one read are
+/// sent in a single batch, so a busy server does not flood the thread of the receiver with one event per message.
+/// A lost or refused connection is retried from the socket state change, with a delay which doubles up to
+/// _maxReconnectDelayMSecs, so a receiver which restarts is picked up again without polling.
 class ADSBTCPLink : public QObject
 {
     Q_OBJECT
 
 public:
+    /// Format of the data sent by the server
+    enum DataFormat {
+        SbsFormat,      ///< SBS-1 BaseStation text, usually port 30003
+        BeastFormat,    ///< Beast binary Mode S frames, usually port 30005
+    };
+
     /// Constructs an ADSBTCPLink object.
     ///     @param hostAddress The address of the host to connect to.
     ///     @param port The port to connect to on the host.
+    ///     @param format The format of the data sent by the host.
     ///     @param parent The parent object.
-    explicit ADSBTCPLink(const QHostAddress &hostAddress, quint16 port = 30003, QObject *parent = nullptr);
+    explicit ADSBTCPLink(const QHostAddress &hostAddress, quint16 port = 30003, DataFormat format = SbsFormat, QObject *parent = nullptr);
 
     /// Destroys the ADSBTCPLink object.
     ~ADSBTCPLink();
 
-    /// Attempts connection to a host.
+public slots:
+    /// Attempts connection to a host. Must be called on the thread the link lives on.
     bool init();
 
 signals:
-    /// Emitted when an ADS-B vehicle update is received.
-    ///     @param vehicleInfo The updated vehicle information.
-    void adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo);
+    /// Emitted with the vehicle updates decoded from one read of the socket.
+    ///     @param vehicleInfos The updated vehicle information.
+    void adsbVehicleUpdates(const QList<ADSB::VehicleInfo_t> &vehicleInfos);
 
-    /// Emitted when an error occurs.
+    /// Emitted when an error occurs, once until the connection is made again.
     ///     @param errorMsg The error message.
     void errorOccurred(const QString &errorMsg, bool stopped = false);
 
@@ -52,36 +72,68 @@ private slots:
     /// Reads bytes from the TCP socket.
     void _readBytes();
 
-    /// Processes buffered lines of ADS-B data.
-    void _processLines();
+    /// Schedules a reconnect once the socket is unconnected.
+    void _socketStateChanged(QAbstractSocket::SocketState state);
+
+    void _connectToHost();
 
 private:
-    /// Parses a line of ADS-B data.
-    ///     @param line The line to parse.
-    void _parseLine(const QString &line);
+    /// Splits the buffered SBS-1 data into lines, the incomplete last line stays buffered.
+    void _processSbs(QByteArrayView bytes);
 
-    /// Parses and emits the callsign from ADS-B data.
-    ///     @param adsbInfo The ADS-B vehicle info structure to update.
-    ///     @param values The values parsed from the line.
-    void _parseAndEmitCallsign(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values);
+    /// Parses a line of SBS-1 data.
+    ///     @param line The line to parse, without the line ending.
+    void _parseLine(QByteArrayView line);
 
-    /// Parses and emits the location from ADS-B data.
-    ///     @param adsbInfo The ADS-B vehicle info structure to update.
-    ///     @param values The values parsed from the line.
-    void _parseAndEmitLocation(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values);
+    /// Unescapes Beast frames, frames may span several reads.
+    void _processBeast(QByteArrayView bytes);
 
-    /// Parses and emits the heading from ADS-B data.
-    ///     @param adsbInfo The ADS-B vehicle info structure to update.
-    ///     @param values The values parsed from the line.
-    void _parseAndEmitHeading(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values);
+    /// Decodes a Mode S frame received from a Beast server.
+    ///     @param frame The Mode S message without the Beast timestamp and signal level.
+    void _decodeModeS(QByteArrayView frame);
 
-    QHostAddress _hostAddress;
-    quint16 _port = 30003;
+    /// Decodes an airborne position from the last even and odd frame of the vehicle.
+    ///     @return false: No pair of frames recent enough to decode a position
+    bool _decodeCprPosition(uint32_t icaoAddress, bool odd, uint32_t latCpr, uint32_t lonCpr, QGeoCoordinate &location);
 
-    QTcpSocket *_socket = nullptr;     ///< Pointer to the TCP socket used for connection
-    QTimer *_processTimer = nullptr;   ///< Timer for periodic processing of ADS-B data
-    QStringList _lineBuffer;           ///< Buffer for storing incoming lines of ADS-B data
+    /// Drops the position frames of vehicles not heard from in a while.
+    void _pruneCprCache();
 
-    static constexpr int _processInterval = 50;     ///< Interval for processing lines
-    static constexpr int _maxLinesToProcess = 100;  ///< Maximum number of lines to process per timer timeout
+    static int _cprNL(double lat);
+
+    typedef struct {
+        uint32_t latCpr[2] = { 0, 0 };      ///< Even, odd
+        uint32_t lonCpr[2] = { 0, 0 };
+        qint64 msecs[2] = { -1, -1 };       ///< Time the frames were received, -1 if none
+    } CprFrames_t;
+
+    QHostAddress _hostAddress;
+    quint16 _port = 30003;
+    DataFormat _format = SbsFormat;
+
+    QTcpSocket *_socket = nullptr;              ///< Pointer to the TCP socket used for connection
+    QTimer *_reconnectTimer = nullptr;
+    int _reconnectDelayMSecs = _minReconnectDelayMSecs;
+    bool _errorReported = false;                ///< An error was reported since the last connection
+    QList<ADSB::VehicleInfo_t> _updates;        ///< Updates decoded from the current read
+
+    QByteArray _lineBuffer;                     ///< Incomplete SBS-1 line from the previous read
+
+    std::array<quint8, 21> _beastFrame{};       ///< Unescaped timestamp, signal level and Mode S message
+    int _beastFrameLength = 0;                  ///< Length of the frame in _beastFrame, 0 while waiting for a frame
+    int _beastFrameBytes = 0;
+    bool _beastEscape = false;                  ///< Last byte was the escape byte, 0x1a
+
+    QHash<uint32_t, CprFrames_t> _cprFrames;
+    QElapsedTimer _clock;
+    qint64 _lastCprPruneMSecs = 0;
+
+    static constexpr int _readChunkSize = 16384;
+    static constexpr int _maxSbsLineLength = 512;          ///< Longer lines are garbage, the buffer is dropped
+    static constexpr int _sbsFieldCount = 22;
+    static constexpr int _beastHeaderLength = 7;           ///< 48 bit timestamp and signal level
+    static constexpr qint64 _cprMaxFrameAgeMSecs = 10000;  ///< Even and odd frame must be this close for a global decode
+    static constexpr qint64 _cprPruneIntervalMSecs = 30000;
+    static constexpr int _minReconnectDelayMSecs = 1000;
+    static constexpr int _maxReconnectDelayMSecs = 30000;
 };
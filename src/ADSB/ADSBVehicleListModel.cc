@@ -0,0 +1,341 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBVehicleListModel.h"
+#include "QGC.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QtMath>
+
+#include <cmath>
+
+QGC_LOGGING_CATEGORY(ADSBVehicleListModelLog, "qgc.adsb.adsbvehiclelistmodel")
+
+ADSBVehicleListModel::ADSBVehicleListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    _changeTimer.setSingleShot(true);
+    _changeTimer.setInterval(_changeIntervalMSecs);
+    (void) connect(&_changeTimer, &QTimer::timeout, this, &ADSBVehicleListModel::_emitChanges);
+
+    _clock.start();
+}
+
+ADSBVehicleListModel::~ADSBVehicleListModel()
+{
+
+}
+
+bool ADSBVehicleListModel::update(const ADSB::VehicleInfo_t &vehicleInfo, int source)
+{
+    const qint64 now = _clock.elapsed();
+
+    const auto it = _rows.constFind(vehicleInfo.icaoAddress);
+    if (it == _rows.constEnd()) {
+        if (!(vehicleInfo.availableFlags & ADSB::LocationAvailable)) {
+            return false;
+        }
+
+        Aircraft_t aircraft;
+        aircraft.info.icaoAddress = vehicleInfo.icaoAddress;
+        (void) _merge(aircraft.info, vehicleInfo);
+        aircraft.lastUpdateMSecs = now;
+        aircraft.positionMSecs = now;
+        aircraft.positionSource = source;
+        aircraft.cell = _cellKey(aircraft.info.location);
+
+        const int row = count();
+        beginInsertRows(QModelIndex(), row, row);
+        _aircraft.append(aircraft);
+        _rows.insert(aircraft.info.icaoAddress, row);
+        _cells[aircraft.cell].append(row);
+        endInsertRows();
+
+        qCDebug(ADSBVehicleListModelLog) << "Added" << QString::number(vehicleInfo.icaoAddress);
+        emit countChanged();
+        return true;
+    }
+
+    const int row = it.value();
+    Aircraft_t &aircraft = _aircraft[row];
+    aircraft.lastUpdateMSecs = now;
+
+    static constexpr ADSB::AvailableInfoTypes positionFlags = ADSB::LocationAvailable | ADSB::AltitudeAvailable | ADSB::HeadingAvailable | ADSB::VelocityAvailable;
+    bool changed = false;
+    if (!(vehicleInfo.availableFlags & positionFlags)) {
+        changed = _merge(aircraft.info, vehicleInfo);
+    } else if ((source == aircraft.positionSource) || ((now - aircraft.positionMSecs) > positionTakeoverMSecs)) {
+        if (source != aircraft.positionSource) {
+            qCDebug(ADSBVehicleListModelLog) << "Position source of" << QString::number(vehicleInfo.icaoAddress) << "changed to" << source;
+            aircraft.positionSource = source;
+        }
+        aircraft.positionMSecs = now;
+        changed = _merge(aircraft.info, vehicleInfo);
+    } else {
+        ADSB::VehicleInfo_t otherFields = vehicleInfo;
+        otherFields.availableFlags &= ~positionFlags;
+        changed = _merge(aircraft.info, otherFields);
+    }
+
+    if (!changed) {
+        return false;
+    }
+
+    const quint64 cell = _cellKey(aircraft.info.location);
+    if (cell != aircraft.cell) {
+        const auto cellIt = _cells.find(aircraft.cell);
+        if (cellIt != _cells.end()) {
+            (void) cellIt->removeOne(row);
+            if (cellIt->isEmpty()) {
+                (void) _cells.erase(cellIt);
+            }
+        }
+        _cells[cell].append(row);
+        aircraft.cell = cell;
+    }
+
+    _markChanged(row);
+    return true;
+}
+
+bool ADSBVehicleListModel::aircraftInfo(uint32_t icaoAddress, ADSB::VehicleInfo_t &info) const
+{
+    const auto it = _rows.constFind(icaoAddress);
+    if (it == _rows.constEnd()) {
+        return false;
+    }
+
+    info = _aircraft[it.value()].info;
+    return true;
+}
+
+bool ADSBVehicleListModel::_merge(ADSB::VehicleInfo_t &info, const ADSB::VehicleInfo_t &update)
+{
+    bool changed = false;
+
+    if ((update.availableFlags & ADSB::CallsignAvailable) && (update.callsign != info.callsign)) {
+        info.callsign = update.callsign;
+        changed = true;
+    }
+
+    if ((update.availableFlags & ADSB::LocationAvailable) && (update.location != info.location)) {
+        info.location = update.location;
+        changed = true;
+    }
+
+    if ((update.availableFlags & ADSB::AltitudeAvailable) && !QGC::fuzzyCompare(update.altitude, info.altitude)) {
+        info.altitude = update.altitude;
+        changed = true;
+    }
+
+    if ((update.availableFlags & ADSB::HeadingAvailable) && !QGC::fuzzyCompare(update.heading, info.heading)) {
+        info.heading = update.heading;
+        changed = true;
+    }
+
+    if ((update.availableFlags & ADSB::VelocityAvailable) && (!QGC::fuzzyCompare(update.velocity, info.velocity) || !QGC::fuzzyCompare(update.verticalVelocity, info.verticalVelocity))) {
+        info.velocity = update.velocity;
+        info.verticalVelocity = update.verticalVelocity;
+        changed = true;
+    }
+
+    if ((update.availableFlags & ADSB::AlertAvailable) && (update.alert != info.alert)) {
+        info.alert = update.alert;
+        changed = true;
+    }
+
+    info.availableFlags |= update.availableFlags;
+
+    return changed;
+}
+
+void ADSBVehicleListModel::removeExpired()
+{
+    const qint64 now = _clock.elapsed();
+    bool removed = false;
+
+    for (int row = count() - 1; row >= 0; row--) {
+        if ((now - _aircraft[row].lastUpdateMSecs) > _expirationTimeoutMSecs) {
+            qCDebug(ADSBVehicleListModelLog) << "Expired" << QString::number(_aircraft[row].info.icaoAddress);
+            beginRemoveRows(QModelIndex(), row, row);
+            _aircraft.removeAt(row);
+            endRemoveRows();
+            removed = true;
+        }
+    }
+
+    if (removed) {
+        _rebuildIndex();
+        if (_firstChangedRow >= 0) {
+            if (count() == 0) {
+                _firstChangedRow = _lastChangedRow = -1;
+            } else {
+                _firstChangedRow = qMin(_firstChangedRow, count() - 1);
+                _lastChangedRow = qMin(_lastChangedRow, count() - 1);
+            }
+        }
+        emit countChanged();
+    }
+}
+
+void ADSBVehicleListModel::clear()
+{
+    if (_aircraft.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    _aircraft.clear();
+    _rows.clear();
+    _cells.clear();
+    endResetModel();
+
+    _changeTimer.stop();
+    _firstChangedRow = _lastChangedRow = -1;
+
+    emit countChanged();
+}
+
+QList<ADSB::VehicleInfo_t> ADSBVehicleListModel::aircraftWithin(const QGeoCoordinate &center, double radiusMeters) const
+{
+    QList<ADSB::VehicleInfo_t> result;
+    if (!center.isValid() || (radiusMeters <= 0.0)) {
+        return result;
+    }
+
+    static constexpr double metersPerDegree = 111320.0;
+    const double latSpan = radiusMeters / metersPerDegree;
+    const double maxLat = qMin(std::fabs(center.latitude()) + latSpan, 89.0);
+    const double lonSpan = latSpan / std::cos(qDegreesToRadians(maxLat));
+
+    const int firstRow = qMax(static_cast<int>(std::floor((center.latitude() - latSpan + 90.0) / _cellSizeDegrees)), 0);
+    const int lastRow = qMin(static_cast<int>(std::floor((center.latitude() + latSpan + 90.0) / _cellSizeDegrees)), _cellRows - 1);
+    int firstCol = static_cast<int>(std::floor((center.longitude() - lonSpan + 180.0) / _cellSizeDegrees));
+    int lastCol = static_cast<int>(std::floor((center.longitude() + lonSpan + 180.0) / _cellSizeDegrees));
+    if ((lastCol - firstCol + 1) >= _cellColumns) {
+        firstCol = 0;
+        lastCol = _cellColumns - 1;
+    }
+
+    const auto addIfWithin = [&result, &center, radiusMeters](const Aircraft_t &aircraft) {
+        if (aircraft.info.location.distanceTo(center) <= radiusMeters) {
+            result.append(aircraft.info);
+        }
+    };
+
+    // Scanning the aircraft is cheaper than visiting more cells than there are aircraft
+    const qint64 cellCount = static_cast<qint64>(lastRow - firstRow + 1) * (lastCol - firstCol + 1);
+    if (cellCount >= _aircraft.count()) {
+        for (const Aircraft_t &aircraft : _aircraft) {
+            addIfWithin(aircraft);
+        }
+        return result;
+    }
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            const int wrappedCol = ((col % _cellColumns) + _cellColumns) % _cellColumns;
+            const auto it = _cells.constFind(_cellKey(row, wrappedCol));
+            if (it == _cells.constEnd()) {
+                continue;
+            }
+            for (const int aircraftRow : it.value()) {
+                addIfWithin(_aircraft[aircraftRow]);
+            }
+        }
+    }
+
+    return result;
+}
+
+int ADSBVehicleListModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+
+    return count();
+}
+
+QVariant ADSBVehicleListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() < 0) || (index.row() >= count())) {
+        return QVariant();
+    }
+
+    const ADSB::VehicleInfo_t &info = _aircraft[index.row()].info;
+    switch (role) {
+    case IcaoAddressRole:
+        return info.icaoAddress;
+    case CallsignRole:
+        return info.callsign;
+    case CoordinateRole:
+        return QVariant::fromValue(info.location);
+    case AltitudeRole:
+        return info.altitude;
+    case HeadingRole:
+        return info.heading;
+    case AlertRole:
+        return info.alert;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ADSBVehicleListModel::roleNames() const
+{
+    return {
+        { IcaoAddressRole,  "icaoAddress" },
+        { CallsignRole,     "callsign" },
+        { CoordinateRole,   "coordinate" },
+        { AltitudeRole,     "altitude" },
+        { HeadingRole,      "heading" },
+        { AlertRole,        "alert" },
+    };
+}
+
+quint64 ADSBVehicleListModel::_cellKey(const QGeoCoordinate &coordinate)
+{
+    const int row = qBound(0, static_cast<int>(std::floor((coordinate.latitude() + 90.0) / _cellSizeDegrees)), _cellRows - 1);
+    const int col = qBound(0, static_cast<int>(std::floor((coordinate.longitude() + 180.0) / _cellSizeDegrees)), _cellColumns - 1);
+    return _cellKey(row, col);
+}
+
+void ADSBVehicleListModel::_markChanged(int row)
+{
+    if (_firstChangedRow < 0) {
+        _firstChangedRow = _lastChangedRow = row;
+    } else {
+        _firstChangedRow = qMin(_firstChangedRow, row);
+        _lastChangedRow = qMax(_lastChangedRow, row);
+    }
+
+    if (!_changeTimer.isActive()) {
+        _changeTimer.start();
+    }
+}
+
+void ADSBVehicleListModel::_emitChanges()
+{
+    if (_firstChangedRow < 0) {
+        return;
+    }
+
+    emit dataChanged(index(_firstChangedRow), index(_lastChangedRow));
+    _firstChangedRow = _lastChangedRow = -1;
+}
+
+void ADSBVehicleListModel::_rebuildIndex()
+{
+    _rows.clear();
+    _cells.clear();
+    for (int row = 0; row < count(); row++) {
+        const Aircraft_t &aircraft = _aircraft[row];
+        _rows.insert(aircraft.info.icaoAddress, row);
+        _cells[aircraft.cell].append(row);
+    }
+}
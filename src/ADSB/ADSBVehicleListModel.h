@@ -0,0 +1,112 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
+#include <QtQmlIntegration/QtQmlIntegration>
+
+#include "ADSB.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ADSBVehicleListModelLog)
+
+/// State of all ADS-B aircraft, one row per aircraft. The aircraft are kept in a flat list with an ICAO address to
+/// row hash and a grid of lat/lon cells for proximity queries. Updates only mark their row, the changed rows are
+/// sent to QML as a single dataChanged per tick.
+///
+/// Updates for the same aircraft may come from several sources, such as multiple receivers and vehicle transponders.
+/// The position, altitude, heading and velocity of an aircraft are taken from one source only, which keeps it until it
+/// falls silent for positionTakeoverMSecs. Other sources can still fill in the callsign and alert. This avoids an
+/// aircraft jumping between the slightly different positions and latencies of several receivers.
+class ADSBVehicleListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("")
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        IcaoAddressRole = Qt::UserRole + 1,
+        CallsignRole,
+        CoordinateRole,
+        AltitudeRole,
+        HeadingRole,
+        AlertRole,
+    };
+
+    explicit ADSBVehicleListModel(QObject *parent = nullptr);
+    ~ADSBVehicleListModel();
+
+    int count() const { return static_cast<int>(_aircraft.count()); }
+
+    /// Merges the available fields into the aircraft, an unknown aircraft is only added once its location is known
+    ///     @param source Identifies the receiver or vehicle the update came from
+    ///     @return true: The aircraft was added or changed
+    bool update(const ADSB::VehicleInfo_t &vehicleInfo, int source = 0);
+
+    /// @return false: No such aircraft
+    bool aircraftInfo(uint32_t icaoAddress, ADSB::VehicleInfo_t &info) const;
+
+    /// Removes the aircraft which were not updated within the expiration timeout
+    void removeExpired();
+
+    void clear();
+
+    /// @return Aircraft within radiusMeters of center
+    QList<ADSB::VehicleInfo_t> aircraftWithin(const QGeoCoordinate &center, double radiusMeters) const;
+
+    // Overrides from QAbstractListModel
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    static constexpr qint64 positionTakeoverMSecs = 3000;  ///< Silence after which another source takes over the position
+
+signals:
+    void countChanged();
+
+private:
+    typedef struct {
+        ADSB::VehicleInfo_t info{};
+        qint64 lastUpdateMSecs = 0;
+        qint64 positionMSecs = 0;               ///< Last position update from positionSource
+        int positionSource = 0;
+        quint64 cell = 0;
+    } Aircraft_t;
+
+    /// @return true: A field changed
+    static bool _merge(ADSB::VehicleInfo_t &info, const ADSB::VehicleInfo_t &update);
+    static quint64 _cellKey(int row, int col) { return (static_cast<quint64>(row) << 32) | static_cast<quint32>(col); }
+    static quint64 _cellKey(const QGeoCoordinate &coordinate);
+
+    void _markChanged(int row);
+    void _emitChanges();
+    void _rebuildIndex();
+
+    QList<Aircraft_t> _aircraft;
+    QHash<uint32_t, int> _rows;                 ///< ICAO address to row
+    QHash<quint64, QList<int>> _cells;          ///< Grid cell to rows
+    int _firstChangedRow = -1;
+    int _lastChangedRow = -1;
+    QTimer _changeTimer;
+    QElapsedTimer _clock;
+
+    static constexpr double _cellSizeDegrees = 0.25;            ///< About 28 km north-south
+    static constexpr int _cellRows = 720;                       ///< 180 / _cellSizeDegrees
+    static constexpr int _cellColumns = 1440;                   ///< 360 / _cellSizeDegrees
+    static constexpr int _changeIntervalMSecs = 200;
+    static constexpr qint64 _expirationTimeoutMSecs = 120000;   ///< timeout with no update in ms after which the aircraft is removed.
+};
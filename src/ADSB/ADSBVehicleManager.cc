@@ -13,11 +13,14 @@
 #include "SettingsManager.h"
 #include "ADSBVehicleManagerSettings.h"
 #include "ADSBTCPLink.h"
-#include "ADSBVehicle.h"
+#include "ADSBVehicleListModel.h"
+#include "MultiVehicleManager.h"
 #include "QmlObjectListModel.h"
+#include "Vehicle.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/qapplicationstatic.h>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
 #include <qassert.h>
 
@@ -29,28 +32,61 @@ ADSBVehicleManager::ADSBVehicleManager(ADSBVehicleManagerSettings *settings, QOb
     : QObject(parent)
     , _adsbSettings(settings)
     , _adsbVehicleCleanupTimer(new QTimer(this))
-    , _adsbVehicles(new QmlObjectListModel(this))
+    , _adsbVehicles(new ADSBVehicleListModel(this))
+    , _conflictMonitorThread(new QThread(this))
+    , _vehicleStateTimer(new QTimer(this))
+    , _conflictUpdateTimer(new QTimer(this))
 {
     (void) qRegisterMetaType<ADSB::VehicleInfo_t>("ADSB::VehicleInfo_t");
+    (void) qRegisterMetaType<QList<ADSB::VehicleInfo_t>>("QList<ADSB::VehicleInfo_t>");
+    (void) qRegisterMetaType<QList<ADSBConflictMonitor::VehicleState_t>>("QList<ADSBConflictMonitor::VehicleState_t>");
+    (void) qRegisterMetaType<QList<ADSBConflictMonitor::Conflict_t>>("QList<ADSBConflictMonitor::Conflict_t>");
+
+    // The monitor has no parent so it can be moved to its thread, it is deleted when the thread finishes
+    _conflictMonitorThread->setObjectName(QStringLiteral("ADSBConflict"));
+    _conflictMonitor = new ADSBConflictMonitor();
+    _conflictMonitor->moveToThread(_conflictMonitorThread);
+    (void) connect(_conflictMonitorThread, &QThread::started, _conflictMonitor, &ADSBConflictMonitor::start);
+    (void) connect(_conflictMonitorThread, &QThread::finished, _conflictMonitor, &QObject::deleteLater);
+    // Only the newest snapshot matters if the conflict monitor falls behind
+    qgcApp()->addCompressedSignal(&ADSBVehicleManager::_vehicleStatesChanged);
+    (void) connect(this, &ADSBVehicleManager::_vehicleStatesChanged, _conflictMonitor, &ADSBConflictMonitor::setVehicleStates, Qt::QueuedConnection);
+    (void) connect(_conflictMonitor, &ADSBConflictMonitor::conflictsUpdated, this, &ADSBVehicleManager::_conflictsUpdated, Qt::QueuedConnection);
+    _conflictMonitorThread->start();
+
+    _vehicleStateTimer->setInterval(1000);
+    (void) connect(_vehicleStateTimer, &QTimer::timeout, this, &ADSBVehicleManager::_updateVehicleStates);
+    _vehicleStateTimer->start();
+
+    _conflictUpdateTimer->setSingleShot(true);
+    _conflictUpdateTimer->setInterval(_conflictUpdateIntervalMSecs);
+    (void) connect(_conflictUpdateTimer, &QTimer::timeout, this, &ADSBVehicleManager::_sendConflictUpdates);
 
     _adsbVehicleCleanupTimer->setSingleShot(false);
     _adsbVehicleCleanupTimer->setInterval(1000);
     (void) connect(_adsbVehicleCleanupTimer, &QTimer::timeout, this, &ADSBVehicleManager::_cleanupStaleVehicles);
+    // Aircraft reported by vehicles expire too, not just those from the servers
+    _adsbVehicleCleanupTimer->start();
 
     Fact* const adsbEnabled = _adsbSettings->adsbServerConnectEnabled();
     Fact* const hostAddress = _adsbSettings->adsbServerHostAddress();
     Fact* const port = _adsbSettings->adsbServerPort();
+    Fact* const format = _adsbSettings->adsbServerFormat();
 
-    (void) connect(adsbEnabled, &Fact::rawValueChanged, this, [this, hostAddress, port](QVariant value) {
+    (void) connect(adsbEnabled, &Fact::rawValueChanged, this, [this, hostAddress, port, format](QVariant value) {
         if (value.toBool()) {
-            _start(hostAddress->rawValue().toString(), port->rawValue().toUInt());
+            _start(hostAddress->rawValue().toString(), port->rawValue().toUInt(), format->rawValue().toInt());
         } else {
             _stop();
         }
     });
 
+    (void) connect(hostAddress, &Fact::rawValueChanged, this, &ADSBVehicleManager::_restart);
+    (void) connect(port, &Fact::rawValueChanged, this, &ADSBVehicleManager::_restart);
+    (void) connect(format, &Fact::rawValueChanged, this, &ADSBVehicleManager::_restart);
+
     if (adsbEnabled->rawValue().toBool()) {
-        _start(hostAddress->rawValue().toString(), port->rawValue().toUInt());
+        _start(hostAddress->rawValue().toString(), port->rawValue().toUInt(), format->rawValue().toInt());
     }
 
     // qCDebug(ADSBTCPLinkLog) << Q_FUNC_INFO << this;
@@ -58,6 +94,14 @@ ADSBVehicleManager::ADSBVehicleManager(ADSBVehicleManagerSettings *settings, QOb
 
 ADSBVehicleManager::~ADSBVehicleManager()
 {
+    if (_adsbTcpLinkThread) {
+        _adsbTcpLinkThread->quit();
+        _adsbTcpLinkThread->wait();
+    }
+
+    _conflictMonitorThread->quit();
+    _conflictMonitorThread->wait();
+
     // qCDebug(ADSBTCPLinkLog) << Q_FUNC_INFO << this;
 }
 
@@ -66,54 +110,177 @@ ADSBVehicleManager *ADSBVehicleManager::instance()
     return _adsbVehicleManager();
 }
 
-void ADSBVehicleManager::adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo)
+void ADSBVehicleManager::adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo, int source)
 {
-    const uint32_t icaoAddress = vehicleInfo.icaoAddress;
-    if (_adsbICAOMap.contains(icaoAddress)) {
-        _adsbICAOMap[icaoAddress]->update(vehicleInfo);
-        return;
+    if (_adsbVehicles->update(vehicleInfo, source)) {
+        _changedAircraft.insert(vehicleInfo.icaoAddress);
+        if (!_conflictUpdateTimer->isActive()) {
+            _conflictUpdateTimer->start();
+        }
+    }
+}
+
+void ADSBVehicleManager::adsbVehicleUpdates(const QList<ADSB::VehicleInfo_t> &vehicleInfos, int source)
+{
+    for (const ADSB::VehicleInfo_t &vehicleInfo : vehicleInfos) {
+        if (_adsbVehicles->update(vehicleInfo, source)) {
+            _changedAircraft.insert(vehicleInfo.icaoAddress);
+        }
     }
 
-    if (vehicleInfo.availableFlags & ADSB::LocationAvailable) {
-        ADSBVehicle* const adsbVehicle = new ADSBVehicle(vehicleInfo, this);
-        _adsbICAOMap[icaoAddress] = adsbVehicle;
-        (void) _adsbVehicles->append(adsbVehicle);
-        qCDebug(ADSBVehicleManagerLog) << "Added" << QString::number(adsbVehicle->icaoAddress());
+    if (!_changedAircraft.isEmpty() && !_conflictUpdateTimer->isActive()) {
+        _conflictUpdateTimer->start();
     }
 }
 
-void ADSBVehicleManager::_start(const QString &hostAddress, quint16 port)
+void ADSBVehicleManager::_sendConflictUpdates()
 {
-    Q_ASSERT(!_adsbTcpLink);
-    _adsbTcpLink = new ADSBTCPLink(QHostAddress(hostAddress), port, this);
-    (void) connect(_adsbTcpLink, &ADSBTCPLink::adsbVehicleUpdate, this, &ADSBVehicleManager::adsbVehicleUpdate, Qt::AutoConnection);
-    (void) connect(_adsbTcpLink, &ADSBTCPLink::errorOccurred, this, &ADSBVehicleManager::_linkError, Qt::AutoConnection);
+    QList<ADSB::VehicleInfo_t> vehicleInfos;
+    vehicleInfos.reserve(_changedAircraft.count());
+    for (const uint32_t icaoAddress : std::as_const(_changedAircraft)) {
+        ADSB::VehicleInfo_t vehicleInfo;
+        if (_adsbVehicles->aircraftInfo(icaoAddress, vehicleInfo)) {
+            vehicleInfos.append(vehicleInfo);
+        }
+    }
+    _changedAircraft.clear();
 
-    _adsbVehicleCleanupTimer->start();
+    if (!vehicleInfos.isEmpty()) {
+        (void) QMetaObject::invokeMethod(_conflictMonitor, [monitor = _conflictMonitor, vehicleInfos]() {
+            monitor->adsbVehicleUpdates(vehicleInfos);
+        }, Qt::QueuedConnection);
+    }
+}
+
+void ADSBVehicleManager::_start(const QString &hostAddresses, quint16 port, int format)
+{
+    Q_ASSERT(_adsbTcpLinks.isEmpty());
+
+    // All links share one thread, they only wake up when their socket has data
+    _adsbTcpLinkThread = new QThread(this);
+    _adsbTcpLinkThread->setObjectName(QStringLiteral("ADSB"));
+
+    const QStringList servers = hostAddresses.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QString &server : servers) {
+        QString host = server.trimmed();
+        quint16 serverPort = port;
+
+        // host:port, but not an IPv6 address which has several colons
+        const qsizetype colon = host.lastIndexOf(QLatin1Char(':'));
+        if ((colon > 0) && (host.indexOf(QLatin1Char(':')) == colon)) {
+            bool ok = false;
+            const uint parsedPort = QStringView(host).mid(colon + 1).toUInt(&ok);
+            if (!ok || (parsedPort == 0) || (parsedPort > 65535)) {
+                qCWarning(ADSBVehicleManagerLog) << "Invalid ADSB server" << server;
+                continue;
+            }
+            serverPort = static_cast<quint16>(parsedPort);
+            host.truncate(colon);
+        }
+
+        // The link has no parent so it can be moved to its thread, it is deleted when the thread finishes
+        ADSBTCPLink *const link = new ADSBTCPLink(QHostAddress(host), serverPort, static_cast<ADSBTCPLink::DataFormat>(format));
+        link->moveToThread(_adsbTcpLinkThread);
+
+        const int source = static_cast<int>(_adsbTcpLinks.count()) + 1;
+        (void) connect(_adsbTcpLinkThread, &QThread::started, link, &ADSBTCPLink::init);
+        (void) connect(_adsbTcpLinkThread, &QThread::finished, link, &QObject::deleteLater);
+        (void) connect(link, &ADSBTCPLink::adsbVehicleUpdates, this, [this, source](const QList<ADSB::VehicleInfo_t> &vehicleInfos) {
+            adsbVehicleUpdates(vehicleInfos, source);
+        }, Qt::QueuedConnection);
+        (void) connect(link, &ADSBTCPLink::errorOccurred, this, &ADSBVehicleManager::_linkError, Qt::QueuedConnection);
+
+        qCDebug(ADSBVehicleManagerLog) << "ADSB server" << source << host << serverPort;
+        _adsbTcpLinks.append(link);
+    }
+
+    _adsbTcpLinkThread->start();
 }
 
 void ADSBVehicleManager::_stop()
 {
-    Q_CHECK_PTR(_adsbTcpLink);
-    _adsbTcpLink->deleteLater();
-    _adsbTcpLink = nullptr;
+    for (ADSBTCPLink *const link : std::as_const(_adsbTcpLinks)) {
+        (void) disconnect(link, nullptr, this, nullptr);
+    }
+    _adsbTcpLinks.clear();
+
+    if (_adsbTcpLinkThread) {
+        _adsbTcpLinkThread->quit();
+        _adsbTcpLinkThread->wait();
+        _adsbTcpLinkThread->deleteLater();
+        _adsbTcpLinkThread = nullptr;
+    }
+
+    _adsbVehicles->clear();
+    _changedAircraft.clear();
+}
+
+void ADSBVehicleManager::_restart()
+{
+    if (!_adsbTcpLinkThread) {
+        return;
+    }
 
-    _adsbVehicleCleanupTimer->stop();
+    _stop();
+    _start(_adsbSettings->adsbServerHostAddress()->rawValue().toString(), _adsbSettings->adsbServerPort()->rawValue().toUInt(), _adsbSettings->adsbServerFormat()->rawValue().toInt());
+}
 
-    _adsbVehicles->clearAndDeleteContents();
-    _adsbICAOMap.clear();
+QList<ADSB::VehicleInfo_t> ADSBVehicleManager::aircraftWithin(const QGeoCoordinate &center, double radiusMeters) const
+{
+    return _adsbVehicles->aircraftWithin(center, radiusMeters);
 }
 
 void ADSBVehicleManager::_cleanupStaleVehicles()
 {
-    for (qsizetype i = _adsbVehicles->count() - 1; i >= 0; i--) {
-        ADSBVehicle* const adsbVehicle = _adsbVehicles->value<ADSBVehicle*>(i);
-        if (adsbVehicle->expired()) {
-            qCDebug(ADSBVehicleManagerLog) << "Expired" << QString::number(adsbVehicle->icaoAddress());
-            (void) _adsbVehicles->removeAt(i);
-            (void) _adsbICAOMap.remove(adsbVehicle->icaoAddress());
-            adsbVehicle->deleteLater();
+    _adsbVehicles->removeExpired();
+}
+
+void ADSBVehicleManager::_updateVehicleStates()
+{
+    QList<ADSBConflictMonitor::VehicleState_t> vehicleStates;
+
+    QmlObjectListModel* const vehicles = qgcApp()->toolbox()->multiVehicleManager()->vehicles();
+    for (int i = 0; i < vehicles->count(); i++) {
+        Vehicle* const vehicle = vehicles->value<Vehicle*>(i);
+
+        ADSBConflictMonitor::VehicleState_t vehicleState;
+        vehicleState.vehicleId = vehicle->id();
+        vehicleState.coordinate = vehicle->coordinate();
+        vehicleState.altitudeAMSL = vehicle->altitudeAMSL()->rawValue().toDouble();
+        vehicleState.groundSpeed = vehicle->groundSpeed()->rawValue().toDouble();
+        vehicleState.heading = vehicle->heading()->rawValue().toDouble();
+        vehicleState.climbRate = vehicle->climbRate()->rawValue().toDouble();
+        vehicleStates.append(vehicleState);
+    }
+
+    emit _vehicleStatesChanged(vehicleStates);
+}
+
+void ADSBVehicleManager::_conflictsUpdated(const QList<ADSBConflictMonitor::Conflict_t> &conflicts)
+{
+    QmlObjectListModel* const vehicles = qgcApp()->toolbox()->multiVehicleManager()->vehicles();
+    for (int i = 0; i < vehicles->count(); i++) {
+        Vehicle* const vehicle = vehicles->value<Vehicle*>(i);
+
+        // Closest in time first
+        const ADSBConflictMonitor::Conflict_t *urgent = nullptr;
+        for (const ADSBConflictMonitor::Conflict_t &conflict : conflicts) {
+            if ((conflict.vehicleId == vehicle->id()) && (!urgent || (conflict.timeToClosestApproach < urgent->timeToClosestApproach))) {
+                urgent = &conflict;
+            }
         }
+
+        if (!urgent) {
+            vehicle->setTrafficConflict(QString());
+            continue;
+        }
+
+        const QString aircraft = urgent->callsign.isEmpty() ? QString::number(urgent->icaoAddress, 16).toUpper() : urgent->callsign;
+        vehicle->setTrafficConflict(tr("Traffic %1: %2 m, %3 m vertical in %4 s")
+                                    .arg(aircraft)
+                                    .arg(qRound(urgent->horizontalDistance))
+                                    .arg(qRound(urgent->verticalDistance))
+                                    .arg(qRound(urgent->timeToClosestApproach)));
     }
 }
 
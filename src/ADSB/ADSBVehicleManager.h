@@ -9,25 +9,33 @@
 
 #pragma once
 
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 
 #include "ADSB.h"
+#include "ADSBConflictMonitor.h"
 
 Q_DECLARE_LOGGING_CATEGORY(ADSBVehicleManagerLog)
 
 class ADSBTCPLink;
-class ADSBVehicle;
-class QmlObjectListModel;
+class ADSBVehicleListModel;
+class QThread;
 class QTimer;
 class ADSBVehicleManagerSettings;
 
+/// Aggregates ADS-B traffic from any number of TCP servers and from the ADSB_VEHICLE messages of vehicles into a single
+/// list of aircraft keyed by ICAO address. The host address setting takes several servers separated by commas, each
+/// optionally as host:port. Updates are applied to the list as they arrive; the conflict monitor is sent the merged
+/// state of each changed aircraft once per _conflictUpdateIntervalMSecs, so its cost follows the number of distinct
+/// aircraft rather than the number of sources.
 class ADSBVehicleManager : public QObject
 {
     Q_OBJECT
-    Q_MOC_INCLUDE("QmlObjectListModel.h")
+    Q_MOC_INCLUDE("ADSBVehicleListModel.h")
 
-    Q_PROPERTY(const QmlObjectListModel *adsbVehicles READ adsbVehicles CONSTANT)
+    Q_PROPERTY(const ADSBVehicleListModel *adsbVehicles READ adsbVehicles CONSTANT)
 
 public:
     ADSBVehicleManager(ADSBVehicleManagerSettings *settings, QObject *parent = nullptr);
@@ -35,23 +43,45 @@ public:
 
     static ADSBVehicleManager *instance();
 
-    const QmlObjectListModel *adsbVehicles() const { return _adsbVehicles; }
+    const ADSBVehicleListModel *adsbVehicles() const { return _adsbVehicles; }
+
+    /// @return ADS-B aircraft within radiusMeters of center, for traffic alerting
+    QList<ADSB::VehicleInfo_t> aircraftWithin(const QGeoCoordinate &center, double radiusMeters) const;
+
+    static constexpr int vehicleSourceBase = 1000;     ///< Source of ADSB_VEHICLE updates is this plus the vehicle id
 
 public slots:
-    void adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo);
+    /// @param source Identifies the receiver or vehicle the update came from, see ADSBVehicleListModel::update
+    void adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo, int source = vehicleSourceBase);
+    void adsbVehicleUpdates(const QList<ADSB::VehicleInfo_t> &vehicleInfos, int source = 0);
+
+signals:
+    void _vehicleStatesChanged(const QList<ADSBConflictMonitor::VehicleState_t> &vehicleStates);
 
 private slots:
     void _cleanupStaleVehicles();
+    void _updateVehicleStates();
+    void _conflictsUpdated(const QList<ADSBConflictMonitor::Conflict_t> &conflicts);
     void _linkError(const QString &errorMsg, bool stopped = false);
+    void _sendConflictUpdates();
 
 private:
-    void _start(const QString &hostAddress, quint16 port);
+    /// Starts a link for each server in hostAddresses, port is the default for servers without one
+    void _start(const QString &hostAddresses, quint16 port, int format);
     void _stop();
+    void _restart();
 
     ADSBVehicleManagerSettings *_adsbSettings = nullptr;
     QTimer *_adsbVehicleCleanupTimer = nullptr;
-    QmlObjectListModel *_adsbVehicles = nullptr;
+    ADSBVehicleListModel *_adsbVehicles = nullptr;
+
+    QList<ADSBTCPLink*> _adsbTcpLinks;
+    QThread *_adsbTcpLinkThread = nullptr;      ///< Socket reads and parsing of all links run here
+    ADSBConflictMonitor *_conflictMonitor = nullptr;
+    QThread *_conflictMonitorThread = nullptr;
+    QTimer *_vehicleStateTimer = nullptr;       ///< Sends the vehicle states to the conflict monitor
+    QTimer *_conflictUpdateTimer = nullptr;
+    QSet<uint32_t> _changedAircraft;            ///< Not sent to the conflict monitor yet
 
-    QMap<uint32_t, ADSBVehicle*> _adsbICAOMap;
-    ADSBTCPLink *_adsbTcpLink = nullptr;
+    static constexpr int _conflictUpdateIntervalMSecs = 500;
 };
@@ -117,10 +117,23 @@ public:
     /// Allows the plugin to override the release of VideoSink.
     virtual void releaseVideoSink(void* sink);
 
-    /// Allows the plugin to see all mavlink traffic to a vehicle
+    /// Allows the plugin to see all mavlink traffic to a vehicle. Called on the GUI thread for every message, so it
+    /// must be quick. Plugins which only read messages or vehicle state should use MAVLinkMessageSubscription or
+    /// MultiVehicleManager::sharedVehicleState instead, which keep the work off the message path.
+    /// Only called for the message ids returned by mavlinkMessageIds.
     /// @return true: Allow vehicle to continue processing, false: Vehicle should not process message
     virtual bool mavlinkMessage(Vehicle* vehicle, LinkInterface* link, mavlink_message_t message);
 
+    /// Message ids mavlinkMessage is called for, MAVLinkMsgIdFilter::allIds for all messages. Plugins which override
+    /// mavlinkMessage must override this as well. Read once when a Vehicle is created.
+    virtual QList<uint32_t> mavlinkMessageIds(void) const { return QList<uint32_t>(); }
+
+    /// Allows custom builds to add their own values to the Performance analyze page. Called on the GUI thread once a
+    /// second while the page is open. Values updated on hot paths are better kept in a QGCPerfCounter, those show up
+    /// on the page without any plugin code.
+    ///     @param values Append a QVariantMap with "group", "name", "value" (double) and "unit" for each value
+    virtual void performanceValues(QVariantList& /*values*/) {}
+
     /// Allows custom builds to add custom items to the FlightMap. Objects put into QmlObjectListModel should derive from QmlComponentInfo and set the url property.
     virtual QmlObjectListModel* customMapItems();
 
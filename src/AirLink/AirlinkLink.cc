@@ -131,9 +131,9 @@ bool AirlinkLink::_connect()
         }
     });
     MAVLinkProtocol *mavlink = qgcApp()->toolbox()->mavlinkProtocol();
-    auto conn = std::make_shared<QMetaObject::Connection>();
-    *conn = connect(mavlink, &MAVLinkProtocol::messageReceived, [this, conn] (LinkInterface* linkSrc, mavlink_message_t message) {
-        if (this != linkSrc || message.msgid != MAVLINK_MSG_ID_AIRLINK_AUTH_RESPONSE) {
+    mavlink->unsubscribeMessage(MAVLINK_MSG_ID_AIRLINK_AUTH_RESPONSE, this);
+    mavlink->subscribeMessage(MAVLINK_MSG_ID_AIRLINK_AUTH_RESPONSE, this, [this, mavlink] (LinkInterface* linkSrc, const mavlink_message_t& message) {
+        if (this != linkSrc) {
             return;
         }
         mavlink_airlink_auth_response_t responseMsg;
@@ -144,7 +144,7 @@ bool AirlinkLink::_connect()
             return;
         }
         qDebug() << "Connected successfully";
-        QObject::disconnect(*conn);
+        mavlink->unsubscribeMessage(MAVLINK_MSG_ID_AIRLINK_AUTH_RESPONSE, this);
         _setConnectFlag(false);
     });
     _setConnectFlag(true);
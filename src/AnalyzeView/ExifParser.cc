@@ -12,6 +12,11 @@
 
 #include <QtCore/QByteArray>
 #include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <functional>
 
 #include <exif.h>
 #include <exiv2/exiv2.hpp>
@@ -20,16 +25,8 @@ QGC_LOGGING_CATEGORY(ExifParserLog, "qgc.analyzeview.exifparser")
 
 namespace ExifParser {
 
-double readTime(const QByteArray &buf)
+static double _exifDateTimeToSeconds(const QString &createDate)
 {
-    easyexif::EXIFInfo result;
-    if (result.parseFrom(reinterpret_cast<const unsigned char*>(buf.constData()), buf.size()) != PARSE_EXIF_SUCCESS) {
-        qCWarning(ExifParserLog) << "Could not parse buffer";
-        return -1.0;
-    }
-
-    const QString createDate = QString(result.DateTimeOriginal.c_str());
-
     const QStringList createDateList = createDate.split(' ');
     if (createDateList.count() < 2) {
         qCWarning(ExifParserLog) << "Could not decode creation time and date: " << createDateList;
@@ -56,6 +53,17 @@ double readTime(const QByteArray &buf)
     return (tagTime.toMSecsSinceEpoch() / 1000.0);
 }
 
+double readTime(const QByteArray &buf)
+{
+    easyexif::EXIFInfo result;
+    if (result.parseFrom(reinterpret_cast<const unsigned char*>(buf.constData()), buf.size()) != PARSE_EXIF_SUCCESS) {
+        qCWarning(ExifParserLog) << "Could not parse buffer";
+        return -1.0;
+    }
+
+    return _exifDateTimeToSeconds(QString(result.DateTimeOriginal.c_str()));
+}
+
 double readTime2(const QByteArray &buf)
 {
     try {
@@ -107,6 +115,45 @@ double readTime2(const QByteArray &buf)
     }
 }
 
+static void _setGpsTags(Exiv2::ExifData &exifData, const GeoTagWorker::cameraFeedbackPacket &geotag)
+{
+    // Set GPSVersionID
+    exifData["Exif.GPSInfo.GPSVersionID"] = "2 2 0 0";
+
+    // Set GPS map datum
+    exifData["Exif.GPSInfo.GPSMapDatum"] = "WGS-84";
+
+    // Latitude in degrees, minutes, seconds
+    const double latitude = std::fabs(geotag.latitude); // Absolute value for conversion
+    const int latDegrees = static_cast<int>(latitude);
+    const int latMinutes = static_cast<int>((latitude - latDegrees) * 60);
+    const double latSeconds = (latitude - latDegrees - latMinutes / 60.0) * 3600.0;
+
+    // Set GPS latitude
+    exifData["Exif.GPSInfo.GPSLatitudeRef"] = (geotag.latitude > 0) ? "N" : "S";
+    exifData["Exif.GPSInfo.GPSLatitude"] =
+        std::to_string(latDegrees) + "/1 " +
+        std::to_string(latMinutes) + "/1 " +
+        std::to_string(static_cast<int>(latSeconds * 1000)) + "/1000";
+
+    // Longitude in degrees, minutes, seconds
+    const double longitude = std::fabs(geotag.longitude);
+    const int lonDegrees = static_cast<int>(longitude);
+    const int lonMinutes = static_cast<int>((longitude - lonDegrees) * 60);
+    const double lonSeconds = (longitude - lonDegrees - lonMinutes / 60.0) * 3600.0;
+
+    // Set GPS longitude
+    exifData["Exif.GPSInfo.GPSLongitudeRef"] = (geotag.longitude > 0) ? "E" : "W";
+    exifData["Exif.GPSInfo.GPSLongitude"] =
+        std::to_string(lonDegrees) + "/1 " +
+        std::to_string(lonMinutes) + "/1 " +
+        std::to_string(static_cast<int>(lonSeconds * 1000)) + "/1000";
+
+    // Set GPS altitude
+    exifData["Exif.GPSInfo.GPSAltitudeRef"] = (geotag.altitude < 0) ? 1 : 0;
+    exifData["Exif.GPSInfo.GPSAltitude"] = std::to_string(static_cast<uint32_t>(geotag.altitude * 100)) + "/100";
+}
+
 bool write(QByteArray &buf, const GeoTagWorker::cameraFeedbackPacket &geotag)
 {
     try {
@@ -116,41 +163,7 @@ bool write(QByteArray &buf, const GeoTagWorker::cameraFeedbackPacket &geotag)
 
         Exiv2::ExifData &exifData = image->exifData();
 
-        // Set GPSVersionID
-        exifData["Exif.GPSInfo.GPSVersionID"] = "2 2 0 0";
-
-        // Set GPS map datum
-        exifData["Exif.GPSInfo.GPSMapDatum"] = "WGS-84";
-
-        // Latitude in degrees, minutes, seconds
-        const double latitude = std::fabs(geotag.latitude); // Absolute value for conversion
-        const int latDegrees = static_cast<int>(latitude);
-        const int latMinutes = static_cast<int>((latitude - latDegrees) * 60);
-        const double latSeconds = (latitude - latDegrees - latMinutes / 60.0) * 3600.0;
-
-        // Set GPS latitude
-        exifData["Exif.GPSInfo.GPSLatitudeRef"] = (geotag.latitude > 0) ? "N" : "S";
-        exifData["Exif.GPSInfo.GPSLatitude"] =
-            std::to_string(latDegrees) + "/1 " +
-            std::to_string(latMinutes) + "/1 " +
-            std::to_string(static_cast<int>(latSeconds * 1000)) + "/1000";
-
-        // Longitude in degrees, minutes, seconds
-        const double longitude = std::fabs(geotag.longitude);
-        const int lonDegrees = static_cast<int>(longitude);
-        const int lonMinutes = static_cast<int>((longitude - lonDegrees) * 60);
-        const double lonSeconds = (longitude - lonDegrees - lonMinutes / 60.0) * 3600.0;
-
-        // Set GPS longitude
-        exifData["Exif.GPSInfo.GPSLongitudeRef"] = (geotag.longitude > 0) ? "E" : "W";
-        exifData["Exif.GPSInfo.GPSLongitude"] =
-            std::to_string(lonDegrees) + "/1 " +
-            std::to_string(lonMinutes) + "/1 " +
-            std::to_string(static_cast<int>(lonSeconds * 1000)) + "/1000";
-
-        // Set GPS altitude
-        exifData["Exif.GPSInfo.GPSAltitudeRef"] = (geotag.altitude < 0) ? 1 : 0;
-        exifData["Exif.GPSInfo.GPSAltitude"] = std::to_string(static_cast<uint32_t>(geotag.altitude * 100)) + "/100";
+        _setGpsTags(exifData, geotag);
 
         // Write the updated metadata back to the buffer
         image->setExifData(exifData);
@@ -165,4 +178,256 @@ bool write(QByteArray &buf, const GeoTagWorker::cameraFeedbackPacket &geotag)
     }
 }
 
+/// Location of the EXIF APP1 segment of a JPEG
+typedef struct {
+    qint64 offset = -1;         ///< Start of the segment marker, -1 if the file has no EXIF segment
+    qint64 size = 0;            ///< Size of the segment including marker and length
+    qint64 insertOffset = 2;    ///< Where a new segment goes if there is none: after SOI and APP0
+} ExifSegment_t;
+
+static constexpr char kExifHeader[] = "Exif\0\0";
+static constexpr qint64 kExifHeaderSize = 6;
+static constexpr qint64 kSegmentHeaderSize = 4;         ///< Marker and length
+static constexpr qint64 kCopyChunkSize = 1024 * 1024;
+
+/// Reads size bytes at pos of a file or a mapped file, false if they are not all there
+typedef std::function<bool(qint64 pos, char *data, qint64 size)> ReadAt_t;
+
+/// Walks the JPEG segment headers up to the image data, only the marker and length of each segment are read
+static bool _findExifSegment(const ReadAt_t &readAt, const QString &fileName, ExifSegment_t &segment)
+{
+    uchar soi[2];
+    if (!readAt(0, reinterpret_cast<char*>(soi), 2) || (soi[0] != 0xFF) || (soi[1] != 0xD8)) {
+        qCWarning(ExifParserLog) << "Not a JPEG:" << fileName;
+        return false;
+    }
+
+    qint64 pos = 2;
+    while (true) {
+        uchar header[kSegmentHeaderSize];
+        if (!readAt(pos, reinterpret_cast<char*>(header), kSegmentHeaderSize) || (header[0] != 0xFF)) {
+            qCWarning(ExifParserLog) << "Invalid JPEG segment in" << fileName;
+            return false;
+        }
+
+        const uchar marker = header[1];
+        if ((marker == 0xDA) || (marker == 0xD9)) {
+            // Start of scan, no metadata follows
+            return true;
+        }
+
+        const quint16 length = qFromBigEndian<quint16>(header + 2);
+        if (length < 2) {
+            qCWarning(ExifParserLog) << "Invalid JPEG segment length in" << fileName;
+            return false;
+        }
+        const qint64 size = 2 + length;
+        if (marker == 0xE1) {
+            char exifHeader[kExifHeaderSize];
+            if (readAt(pos + kSegmentHeaderSize, exifHeader, kExifHeaderSize) && (memcmp(exifHeader, kExifHeader, kExifHeaderSize) == 0)) {
+                segment.offset = pos;
+                segment.size = size;
+                return true;
+            }
+        } else if (marker == 0xE0) {
+            segment.insertOffset = pos + size;
+        }
+        pos += size;
+    }
+}
+
+static bool _findExifSegment(QFile &file, ExifSegment_t &segment)
+{
+    return _findExifSegment([&file](qint64 pos, char *data, qint64 size) {
+        return file.seek(pos) && (file.read(data, size) == size);
+    }, file.fileName(), segment);
+}
+
+double readTimeFromFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(ExifParserLog) << "Could not open" << fileName;
+        return -1.0;
+    }
+
+    ExifSegment_t segment;
+    if (!_findExifSegment(file, segment) || (segment.offset < 0)) {
+        qCWarning(ExifParserLog) << "No EXIF data in" << fileName;
+        return -1.0;
+    }
+
+    // easyexif takes the segment without marker and length, starting at the Exif header
+    if (!file.seek(segment.offset + kSegmentHeaderSize)) {
+        return -1.0;
+    }
+    const QByteArray exif = file.read(segment.size - kSegmentHeaderSize);
+
+    easyexif::EXIFInfo result;
+    if (result.parseFromEXIFSegment(reinterpret_cast<const unsigned char*>(exif.constData()), exif.size()) != PARSE_EXIF_SUCCESS) {
+        qCWarning(ExifParserLog) << "Could not parse EXIF segment of" << fileName;
+        return -1.0;
+    }
+
+    return _exifDateTimeToSeconds(QString(result.DateTimeOriginal.c_str()));
+}
+
+bool readImageInfoFromFile(const QString &fileName, ImageInfo &info)
+{
+    info = ImageInfo();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(ExifParserLog) << "Could not open" << fileName;
+        return false;
+    }
+
+    // Mapping fails for some file systems and compressed resources, those are read through the file instead
+    const qint64 fileSize = file.size();
+    const uchar *const mapped = file.map(0, fileSize);
+
+    ExifSegment_t segment;
+    QByteArray exif;
+    if (mapped) {
+        const ReadAt_t readAt = [mapped, fileSize](qint64 pos, char *data, qint64 size) {
+            if ((pos < 0) || ((pos + size) > fileSize)) {
+                return false;
+            }
+            memcpy(data, mapped + pos, static_cast<size_t>(size));
+            return true;
+        };
+        if (_findExifSegment(readAt, fileName, segment) && (segment.offset >= 0) && ((segment.offset + segment.size) <= fileSize)) {
+            exif = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped) + segment.offset + kSegmentHeaderSize, segment.size - kSegmentHeaderSize);
+        }
+    } else if (_findExifSegment(file, segment) && (segment.offset >= 0) && file.seek(segment.offset + kSegmentHeaderSize)) {
+        exif = file.read(segment.size - kSegmentHeaderSize);
+    }
+
+    if (exif.isEmpty()) {
+        qCWarning(ExifParserLog) << "No EXIF data in" << fileName;
+        return false;
+    }
+
+    // easyexif takes the segment without marker and length, starting at the Exif header
+    easyexif::EXIFInfo result;
+    if (result.parseFromEXIFSegment(reinterpret_cast<const unsigned char*>(exif.constData()), exif.size()) != PARSE_EXIF_SUCCESS) {
+        qCWarning(ExifParserLog) << "Could not parse EXIF segment of" << fileName;
+        return false;
+    }
+    info.time = _exifDateTimeToSeconds(QString(result.DateTimeOriginal.c_str()));
+    info.latitude = result.GeoLocation.Latitude;
+    info.longitude = result.GeoLocation.Longitude;
+    info.altitude = result.GeoLocation.Altitude;
+    info.hasPosition = (info.latitude != 0.0) || (info.longitude != 0.0);
+
+    // The thumbnail is in IFD1 of the same segment, which easyexif does not read
+    try {
+        Exiv2::ExifData exifData;
+        (void) Exiv2::ExifParser::decode(exifData, reinterpret_cast<const Exiv2::byte*>(exif.constData()) + kExifHeaderSize, exif.size() - kExifHeaderSize);
+        const Exiv2::DataBuf thumbnail = Exiv2::ExifThumbC(exifData).copy();
+        if (!thumbnail.empty()) {
+            info.thumbnail = QByteArray(reinterpret_cast<const char*>(thumbnail.c_data()), static_cast<qsizetype>(thumbnail.size()));
+        }
+    } catch (Exiv2::Error& e) {
+        qCDebug(ExifParserLog) << "Could not read thumbnail of" << fileName << e.what();
+    }
+
+    return true;
+}
+
+bool writeFile(const QString &sourceFile, const QString &destFile, const GeoTagWorker::cameraFeedbackPacket &geotag)
+{
+    QFile source(sourceFile);
+    if (!source.open(QIODevice::ReadOnly)) {
+        qCWarning(ExifParserLog) << "Could not open" << sourceFile;
+        return false;
+    }
+
+    ExifSegment_t segment;
+    if (!_findExifSegment(source, segment)) {
+        return false;
+    }
+
+    QByteArray tiff;
+    if (segment.offset >= 0) {
+        (void) source.seek(segment.offset + kSegmentHeaderSize + kExifHeaderSize);
+        tiff = source.read(segment.size - kSegmentHeaderSize - kExifHeaderSize);
+    }
+
+    Exiv2::Blob blob;
+    Exiv2::WriteMethod writeMethod = Exiv2::wmIntrusive;
+    try {
+        Exiv2::ExifData exifData;
+        Exiv2::ByteOrder byteOrder = Exiv2::littleEndian;
+        if (!tiff.isEmpty()) {
+            byteOrder = Exiv2::ExifParser::decode(exifData, reinterpret_cast<const Exiv2::byte*>(tiff.constData()), tiff.size());
+        }
+        _setGpsTags(exifData, geotag);
+        // Non intrusive writing updates the data in tiff in place and leaves blob empty
+        writeMethod = Exiv2::ExifParser::encode(blob, reinterpret_cast<Exiv2::byte*>(tiff.data()), tiff.size(), byteOrder, exifData);
+    } catch (Exiv2::Error& e) {
+        qCWarning(ExifParserLog) << "Error writing EXIF GPS data:" << e.what();
+        return false;
+    }
+
+    if (QFile::exists(destFile) && !QFile::remove(destFile)) {
+        qCWarning(ExifParserLog) << "Could not replace" << destFile;
+        return false;
+    }
+
+    if ((writeMethod == Exiv2::wmNonIntrusive) && !tiff.isEmpty()) {
+        // Same layout, only the bytes of the EXIF segment change
+        source.close();
+        if (!QFile::copy(sourceFile, destFile)) {
+            qCWarning(ExifParserLog) << "Could not copy" << sourceFile << "to" << destFile;
+            return false;
+        }
+        QFile dest(destFile);
+        if (!dest.open(QIODevice::ReadWrite) || !dest.seek(segment.offset + kSegmentHeaderSize + kExifHeaderSize) || (dest.write(tiff) != tiff.size())) {
+            qCWarning(ExifParserLog) << "Could not patch" << destFile;
+            return false;
+        }
+        return true;
+    }
+
+    const qint64 segmentSize = kSegmentHeaderSize + kExifHeaderSize + static_cast<qint64>(blob.size());
+    if (segmentSize - 2 > 0xFFFF) {
+        qCWarning(ExifParserLog) << "EXIF data too large for" << destFile;
+        return false;
+    }
+
+    // New EXIF segment, everything else is copied over unchanged
+    const qint64 prefixEnd = (segment.offset >= 0) ? segment.offset : segment.insertOffset;
+    const qint64 suffixStart = (segment.offset >= 0) ? (segment.offset + segment.size) : segment.insertOffset;
+
+    QByteArray exifSegment(kSegmentHeaderSize, Qt::Uninitialized);
+    exifSegment[0] = static_cast<char>(0xFF);
+    exifSegment[1] = static_cast<char>(0xE1);
+    qToBigEndian<quint16>(static_cast<quint16>(segmentSize - 2), exifSegment.data() + 2);
+    exifSegment.append(kExifHeader, kExifHeaderSize);
+    exifSegment.append(reinterpret_cast<const char*>(blob.data()), static_cast<qsizetype>(blob.size()));
+
+    QSaveFile dest(destFile);
+    if (!dest.open(QIODevice::WriteOnly) || !source.seek(0)) {
+        qCWarning(ExifParserLog) << "Could not write" << destFile;
+        return false;
+    }
+    (void) dest.write(source.read(prefixEnd));
+    (void) dest.write(exifSegment);
+    (void) source.seek(suffixStart);
+    while (!source.atEnd()) {
+        const QByteArray chunk = source.read(kCopyChunkSize);
+        if (chunk.isEmpty() || (dest.write(chunk) != chunk.size())) {
+            dest.cancelWriting();
+            break;
+        }
+    }
+
+    if (!dest.commit()) {
+        qCWarning(ExifParserLog) << "Could not write" << destFile << dest.errorString();
+        return false;
+    }
+    return true;
+}
+
 } // namespace ExifParser
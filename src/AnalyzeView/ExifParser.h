@@ -9,11 +9,12 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QLoggingCategory>
 
 #include "GeoTagWorker.h"
 
-class QByteArray;
+class QString;
 
 Q_DECLARE_LOGGING_CATEGORY(ExifParserLog)
 
@@ -21,4 +22,26 @@ namespace ExifParser {
     double readTime(const QByteArray &buf);
     double readTime2(const QByteArray &buf);
     bool write(QByteArray &buf, const GeoTagWorker::cameraFeedbackPacket &geotag);
+
+    /// Reads the time from the EXIF segment of a JPEG, the image data itself is not read
+    ///     @return Seconds since epoch, -1 on failure
+    double readTimeFromFile(const QString &fileName);
+
+    /// Writes a copy of a JPEG with the geotag. The GPS tags are patched in the copy when the existing EXIF
+    /// segment has room for them, otherwise only the EXIF segment is rebuilt and the image data is streamed over.
+    bool writeFile(const QString &sourceFile, const QString &destFile, const GeoTagWorker::cameraFeedbackPacket &geotag);
+
+    /// What the EXIF segment of an image tells about it
+    struct ImageInfo {
+        double time = -1.0;         ///< Seconds since epoch, -1 if unknown
+        bool hasPosition = false;
+        double latitude = 0;
+        double longitude = 0;
+        double altitude = 0;
+        QByteArray thumbnail;       ///< JPEG thumbnail embedded in the EXIF data, empty if there is none
+    };
+
+    /// Reads time, GPS position and thumbnail from the EXIF segment of a JPEG. The file is memory mapped so only the
+    /// pages of the segment headers and the EXIF data are read from disk.
+    bool readImageInfoFromFile(const QString &fileName, ImageInfo &info);
 } // namespace ExifParser
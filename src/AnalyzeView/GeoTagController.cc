@@ -8,8 +8,10 @@
  ****************************************************************************/
 
 #include "GeoTagController.h"
+#include "ImageIndex.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QDir>
 #include <QtCore/QUrl>
 
@@ -23,11 +25,56 @@ GeoTagController::GeoTagController()
     connect(&_worker, &GeoTagWorker::error,             this, &GeoTagController::_workerError);
     connect(&_worker, &GeoTagWorker::started,           this, &GeoTagController::inProgressChanged);
     connect(&_worker, &GeoTagWorker::finished,          this, &GeoTagController::inProgressChanged);
+    (void) connect(&_indexWatcher, &QFutureWatcherBase::finished, this, &GeoTagController::_indexFinished);
 }
 
 GeoTagController::~GeoTagController()
 {
+    _cancelIndexing();
+}
+
+/// Indexes the images in the background as soon as the directory is selected, so tagging finds them already read
+void GeoTagController::_startIndexing(const QString& directory)
+{
+    _cancelIndexing();
 
+    _imageCount = 0;
+    _positionImageCount = 0;
+    _indexCancel = false;
+    _indexWatcher.setFuture(QtConcurrent::run([this, directory]() {
+        IndexResult_t result;
+        ImageIndex imageIndex(directory);
+        result.complete = imageIndex.update([this](qsizetype, qsizetype) {
+            return !_indexCancel;
+        });
+        for (const ImageIndex::Entry& entry : imageIndex.entries()) {
+            result.imageCount++;
+            if (entry.valid && entry.info.hasPosition) {
+                result.positionImageCount++;
+            }
+        }
+        return result;
+    }));
+    emit indexChanged();
+}
+
+void GeoTagController::_cancelIndexing()
+{
+    if (_indexWatcher.isRunning()) {
+        _indexCancel = true;
+        _indexWatcher.waitForFinished();
+    }
+}
+
+void GeoTagController::_indexFinished()
+{
+    const IndexResult_t result = _indexWatcher.result();
+    if (result.complete) {
+        qCDebug(GeoTagControllerLog) << "Indexed" << result.imageCount << "images," << result.positionImageCount << "with position";
+        _imageCount = result.imageCount;
+        _positionImageCount = result.positionImageCount;
+    }
+    emit indexChanged();
 }
 
 void GeoTagController::setLogFile(QString filename)
@@ -45,6 +92,7 @@ void GeoTagController::setImageDirectory(QString dir)
     if (!dir.isEmpty()) {
         _worker.setImageDirectory(dir);
         emit imageDirectoryChanged(dir);
+        _startIndexing(dir);
         if(_worker.saveDirectory() == "") {
             QDir saveDirectory = QDir(_worker.imageDirectory() + kTagged);
             if(saveDirectory.exists()) {
@@ -79,6 +127,22 @@ void GeoTagController::setSaveDirectory(QString dir)
     emit errorMessageChanged(_errorMessage);
 }
 
+void GeoTagController::setTimeTolerance(double seconds)
+{
+    if (seconds != _worker.timeTolerance()) {
+        _worker.setTimeTolerance(seconds);
+        emit timeToleranceChanged();
+    }
+}
+
+void GeoTagController::setImageTimeOffset(double seconds)
+{
+    if (seconds != _worker.imageTimeOffset()) {
+        _worker.setImageTimeOffset(seconds);
+        emit imageTimeOffsetChanged();
+    }
+}
+
 void GeoTagController::startTagging()
 {
     _errorMessage.clear();
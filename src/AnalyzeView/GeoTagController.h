@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QLoggingCategory>
@@ -32,6 +34,12 @@ public:
     Q_PROPERTY(QString  imageDirectory  READ imageDirectory WRITE setImageDirectory NOTIFY imageDirectoryChanged)
     Q_PROPERTY(QString  saveDirectory   READ saveDirectory  WRITE setSaveDirectory  NOTIFY saveDirectoryChanged)
 
+    /// Seconds between an image and its trigger for them to match, 0 matches by image sequence number
+    Q_PROPERTY(double   timeTolerance   READ timeTolerance  WRITE setTimeTolerance  NOTIFY timeToleranceChanged)
+
+    /// Camera clock minus UTC in seconds, used when matching by time
+    Q_PROPERTY(double   imageTimeOffset READ imageTimeOffset WRITE setImageTimeOffset NOTIFY imageTimeOffsetChanged)
+
     /// Set to an error message is geotagging fails
     Q_PROPERTY(QString  errorMessage    READ errorMessage   NOTIFY errorMessageChanged)
 
@@ -41,39 +49,69 @@ public:
     /// true: Currently in the process of tagging
     Q_PROPERTY(bool     inProgress      READ inProgress     NOTIFY inProgressChanged)
 
+    /// true: The images of the image directory are being indexed, which tagging then reuses
+    Q_PROPERTY(bool     indexing            READ indexing           NOTIFY indexChanged)
+    Q_PROPERTY(int      imageCount          READ imageCount         NOTIFY indexChanged)
+    Q_PROPERTY(int      positionImageCount  READ positionImageCount NOTIFY indexChanged)    ///< Images which already have a GPS position
+
     Q_INVOKABLE void startTagging();
     Q_INVOKABLE void cancelTagging() { _worker.cancelTagging(); }
 
     QString logFile             () const { return _worker.logFile(); }
     QString imageDirectory      () const { return _worker.imageDirectory(); }
     QString saveDirectory       () const { return _worker.saveDirectory(); }
+    double  timeTolerance       () const { return _worker.timeTolerance(); }
+    double  imageTimeOffset     () const { return _worker.imageTimeOffset(); }
     double  progress            () const { return _progress; }
     bool    inProgress          () const { return _worker.isRunning(); }
     QString errorMessage        () const { return _errorMessage; }
+    bool    indexing            () const { return _indexWatcher.isRunning(); }
+    int     imageCount          () const { return _imageCount; }
+    int     positionImageCount  () const { return _positionImageCount; }
 
     void    setLogFile          (QString file);
     void    setImageDirectory   (QString dir);
     void    setSaveDirectory    (QString dir);
+    void    setTimeTolerance    (double seconds);
+    void    setImageTimeOffset  (double seconds);
 
 signals:
     void logFileChanged         (QString logFile);
     void imageDirectoryChanged  (QString imageDirectory);
     void saveDirectoryChanged   (QString saveDirectory);
+    void timeToleranceChanged   ();
+    void imageTimeOffsetChanged ();
     void progressChanged        (double progress);
     void inProgressChanged      ();
     void errorMessageChanged    (QString errorMessage);
+    void indexChanged           ();
 
 private slots:
     void _workerProgressChanged (double progress);
     void _workerError           (QString errorMsg);
     void _setErrorMessage       (const QString& error);
+    void _indexFinished         ();
 
 private:
+    typedef struct {
+        bool complete = false;
+        int imageCount = 0;
+        int positionImageCount = 0;
+    } IndexResult_t;
+
+    void _startIndexing         (const QString& directory);
+    void _cancelIndexing        ();
+
     QString             _errorMessage;
     double              _progress;
     bool                _inProgress;
 
     GeoTagWorker        _worker;
 
+    QFutureWatcher<IndexResult_t>   _indexWatcher;
+    QAtomicInteger<bool>            _indexCancel = false;
+    int                             _imageCount = 0;
+    int                             _positionImageCount = 0;
+
     static constexpr const char* kTagged = "/TAGGED";
 };
@@ -28,6 +28,7 @@ AnalyzePage {
     readonly property real _margin:     ScreenTools.defaultFontPixelWidth * 2
     readonly property real _minWidth:   ScreenTools.defaultFontPixelWidth * 20
     readonly property real _maxWidth:   ScreenTools.defaultFontPixelWidth * 30
+    readonly property real _defaultTimeTolerance: 1    ///< Seconds, used when matching by time is turned on
 
     Component {
         id:  pageComponent
@@ -107,7 +108,8 @@ AnalyzePage {
                 }
             }
             QGCLabel {
-                text:               geoController.imageDirectory
+                text:               geoController.imageDirectory === "" ? "" : geoController.imageDirectory + "  " +
+                                        (geoController.indexing ? qsTr("(indexing images)") : qsTr("(%1 images, %2 with position)").arg(geoController.imageCount).arg(geoController.positionImageCount))
                 elide:              Text.ElideLeft
                 Layout.fillWidth:   true
                 Layout.alignment:   Qt.AlignVCenter
@@ -138,6 +140,55 @@ AnalyzePage {
                 Layout.alignment:   Qt.AlignVCenter
             }
             //-----------------------------------------------------------------
+            //-- Time matching
+            QGCCheckBox {
+                id:                 matchByTimeCheckBox
+                text:               qsTr("Match images to triggers by time")
+                checked:            geoController.timeTolerance > 0
+                enabled:            !geoController.inProgress
+                Layout.alignment:   Qt.AlignVCenter
+                onClicked:          geoController.timeTolerance = checked ? _tolerance() : 0
+
+                function _tolerance() {
+                    var tolerance = parseFloat(toleranceField.text)
+                    return tolerance > 0 ? tolerance : _defaultTimeTolerance
+                }
+            }
+            RowLayout {
+                spacing:            _margin / 2
+                enabled:            matchByTimeCheckBox.checked && !geoController.inProgress
+                Layout.fillWidth:   true
+                Layout.alignment:   Qt.AlignVCenter
+
+                QGCLabel { text: qsTr("Tolerance") }
+                QGCTextField {
+                    id:                 toleranceField
+                    text:               geoController.timeTolerance > 0 ? geoController.timeTolerance.toString() : _defaultTimeTolerance.toString()
+                    numericValuesOnly:  true
+                    showUnits:          true
+                    unitsLabel:         qsTr("s")
+                    onEditingFinished: {
+                        var tolerance = parseFloat(text)
+                        if (tolerance > 0) {
+                            geoController.timeTolerance = tolerance
+                        }
+                    }
+                }
+                QGCLabel { text: qsTr("Camera clock minus UTC") }
+                QGCTextField {
+                    text:               geoController.imageTimeOffset.toString()
+                    numericValuesOnly:  true
+                    showUnits:          true
+                    unitsLabel:         qsTr("s")
+                    onEditingFinished: {
+                        var offset = parseFloat(text)
+                        if (!isNaN(offset)) {
+                            geoController.imageTimeOffset = offset
+                        }
+                    }
+                }
+            }
+            //-----------------------------------------------------------------
             //-- Execute
             QGCButton {
                 text:               geoController.inProgress ? qsTr("Cancel Tagging") : qsTr("Start Tagging")
@@ -9,12 +9,17 @@
 
 #include "GeoTagWorker.h"
 #include "ExifParser.h"
+#include "ImageIndex.h"
 #include "ULogParser.h"
 #include "PX4LogParser.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrentMap>
 #include <QtCore/QDir>
 
+#include <algorithm>
+#include <numeric>
+
 QGC_LOGGING_CATEGORY(GeoTagWorkerLog, "qgc.analyzeview.geotagworker")
 
 GeoTagWorker::GeoTagWorker()
@@ -44,27 +49,25 @@ void GeoTagWorker::run()
     }
     emit progressChanged((100/nSteps));
 
-    // Parse EXIF
-    _imageTime.clear();
-    for (int i = 0; i < _imageList.size(); ++i) {
-        QFile file(_imageList.at(i).absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
-        }
-        QByteArray imageBuffer = file.readAll();
-        file.close();
-
-        _imageTime.append(ExifParser::readTime(imageBuffer));
-
-        emit progressChanged((100/nSteps) + ((100/nSteps) / _imageList.size())*i);
+    // Image times come from the index of the directory, only images not indexed before are read
+    ImageIndex imageIndex(_imageDirectory);
+    const bool indexComplete = imageIndex.update([this, nSteps](qsizetype done, qsizetype total) {
+        emit progressChanged((100/nSteps) + ((100/nSteps) / total)*done);
+        return !_cancel;
+    });
+    if (!indexComplete) {
+        qCDebug(GeotaggingLog) << "Tagging cancelled";
+        emit error(tr("Tagging cancelled"));
+        return;
+    }
 
-        if (_cancel) {
-            qCDebug(GeotaggingLog) << "Tagging cancelled";
-            emit error(tr("Tagging cancelled"));
-            return;
-        }
+    _imageTime.clear();
+    _imageTime.reserve(_imageList.size());
+    for (const QFileInfo &imageInfo : std::as_const(_imageList)) {
+        const ImageIndex::Entry *const entry = imageIndex.entry(imageInfo.fileName());
+        _imageTime.append((entry && entry->valid) ? entry->info.time : -1.0);
     }
+    emit progressChanged(2*(100/nSteps));
 
     // Load log
     bool isULog = _logFile.endsWith(".ulg", Qt::CaseSensitive);
@@ -73,16 +76,18 @@ void GeoTagWorker::run()
         emit error(tr("Geotagging failed. Couldn't open log file."));
         return;
     }
-    QByteArray log = file.readAll();
-    file.close();
 
     // Instantiate appropriate parser
     _triggerList.clear();
     bool parseComplete = false;
     QString errorString;
     if (isULog) {
-        parseComplete = ULogParser::getTagsFromLog(log, _triggerList, errorString);
+        // ULogs can be several gigabytes, they are streamed from the file instead of read into memory
+        file.close();
+        parseComplete = ULogParser::getTagsFromLogFile(_logFile, _triggerList, errorString);
     } else {
+        QByteArray log = file.readAll();
+        file.close();
         parseComplete = PX4LogParser::getTagsFromLog(log, _triggerList);
     }
 
@@ -125,38 +130,35 @@ void GeoTagWorker::run()
     // Tag images
     auto maxIndex = std::min(_imageIndices.count(), _triggerIndices.count());
     maxIndex = std::min(maxIndex, _imageList.count());
+    QList<TagJob_t> tagJobs;
+    tagJobs.reserve(maxIndex);
     for(int i = 0; i < maxIndex; i++) {
         int imageIndex = _imageIndices[i];
         if (imageIndex >= _imageList.count()) {
             emit error(tr("Geotagging failed. Requesting image #%1, but only %2 images present.").arg(imageIndex).arg(_imageList.count()));
             return;
         }
-        QFile fileRead(_imageList.at(_imageIndices[i]).absoluteFilePath());
-        if (!fileRead.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
+        TagJob_t tagJob;
+        tagJob.sourceFile = _imageList.at(imageIndex).absoluteFilePath();
+        if(_saveDirectory == "") {
+            tagJob.destFile = _imageDirectory + "/TAGGED/" + _imageList.at(imageIndex).fileName();
+        } else {
+            tagJob.destFile = _saveDirectory + "/" + _imageList.at(imageIndex).fileName();
         }
-        QByteArray imageBuffer = fileRead.readAll();
-        fileRead.close();
+        tagJob.geotag = _triggerList[_triggerIndices[i]];
+        tagJobs.append(tagJob);
+    }
 
-        if (!ExifParser::write(imageBuffer, _triggerList[_triggerIndices[i]])) {
+    for (qsizetype batchStart = 0; batchStart < tagJobs.size(); batchStart += kBatchSize) {
+        const QList<TagJob_t> batch = tagJobs.mid(batchStart, kBatchSize);
+        const QList<bool> results = QtConcurrent::blockingMapped<QList<bool>>(batch, [](const TagJob_t &tagJob) {
+            return ExifParser::writeFile(tagJob.sourceFile, tagJob.destFile, tagJob.geotag);
+        });
+        if (results.contains(false)) {
             emit error(tr("Geotagging failed. Couldn't write to image."));
             return;
-        } else {
-            QFile fileWrite;
-            if(_saveDirectory == "") {
-                fileWrite.setFileName(_imageDirectory + "/TAGGED/" + _imageList.at(_imageIndices[i]).fileName());
-            } else {
-                fileWrite.setFileName(_saveDirectory + "/" + _imageList.at(_imageIndices[i]).fileName());
-            }
-            if (!fileWrite.open(QFile::WriteOnly)) {
-                emit error(tr("Geotagging failed. Couldn't write to an image."));
-                return;
-            }
-            fileWrite.write(imageBuffer);
-            fileWrite.close();
         }
-        emit progressChanged(4*(100/nSteps) + ((100/nSteps) / maxIndex)*i);
+        emit progressChanged(4*(100/nSteps) + ((100/nSteps) / maxIndex)*(batchStart + batch.size()));
 
         if (_cancel) {
             qCDebug(GeotaggingLog) << "Tagging cancelled";
@@ -183,9 +185,133 @@ bool GeoTagWorker::triggerFiltering()
     } else if (_imageList.count() < _triggerList.count()) {     // Camera skipped frames
         qCDebug(GeotaggingLog) << "Detected missing image frames.";
     }
+
+    _interpolateMissingPositions();
+
+    const bool triggerTimes = std::any_of(_triggerList.cbegin(), _triggerList.cend(), [](const cameraFeedbackPacket &trigger) {
+        return trigger.timestampUTC > 0;
+    });
+    if ((_timeTolerance > 0) && triggerTimes) {
+        _matchByTime();
+    } else {
+        if (_timeTolerance > 0) {
+            qCDebug(GeotaggingLog) << "Log has no UTC trigger times, matching by sequence number";
+        }
+        _matchBySequence();
+    }
+    qCDebug(GeotaggingLog) << "Matched" << _imageIndices.count() << "images to triggers";
+
+    return !_imageIndices.isEmpty();
+}
+
+void GeoTagWorker::_matchBySequence()
+{
     for(int i = 0; i < _imageList.count() && i < _triggerList.count(); i++) {
         _imageIndices.append(static_cast<int>(_triggerList[i].imageSequence));
         _triggerIndices.append(i);
     }
-    return true;
+}
+
+/// Sorts both sides by time and matches each image to the nearest unused trigger within the tolerance, which is
+/// O((n + m) log m) instead of comparing every image with every trigger
+void GeoTagWorker::_matchByTime()
+{
+    QList<int> triggerOrder(_triggerList.count());
+    std::iota(triggerOrder.begin(), triggerOrder.end(), 0);
+    std::sort(triggerOrder.begin(), triggerOrder.end(), [this](int a, int b) {
+        return _triggerList[a].timestampUTC < _triggerList[b].timestampUTC;
+    });
+    QList<double> triggerTimes;
+    triggerTimes.reserve(triggerOrder.count());
+    for (const int triggerIndex : triggerOrder) {
+        triggerTimes.append(_triggerList[triggerIndex].timestampUTC);
+    }
+
+    QList<int> imageOrder;
+    imageOrder.reserve(_imageTime.count());
+    for (int i = 0; i < _imageTime.count(); i++) {
+        if (_imageTime[i] >= 0) {
+            imageOrder.append(i);
+        }
+    }
+    std::sort(imageOrder.begin(), imageOrder.end(), [this](int a, int b) {
+        return _imageTime[a] < _imageTime[b];
+    });
+
+    QList<bool> triggerUsed(triggerTimes.count(), false);
+    for (const int imageIndex : imageOrder) {
+        const double imageTime = _imageTime[imageIndex] - _imageTimeOffset;
+        const auto next = std::lower_bound(triggerTimes.cbegin(), triggerTimes.cend(), imageTime);
+        const qsizetype nextIndex = next - triggerTimes.cbegin();
+
+        // Nearest unused trigger on either side
+        qsizetype bestIndex = -1;
+        double bestDelta = _timeTolerance;
+        for (qsizetype i = nextIndex; (i < triggerTimes.count()) && ((triggerTimes[i] - imageTime) <= bestDelta); i++) {
+            if (!triggerUsed[i]) {
+                bestIndex = i;
+                bestDelta = triggerTimes[i] - imageTime;
+                break;
+            }
+        }
+        for (qsizetype i = nextIndex - 1; (i >= 0) && ((imageTime - triggerTimes[i]) <= bestDelta); i--) {
+            if (!triggerUsed[i]) {
+                bestIndex = i;
+                break;
+            }
+        }
+
+        if (bestIndex >= 0) {
+            triggerUsed[bestIndex] = true;
+            _imageIndices.append(imageIndex);
+            _triggerIndices.append(triggerOrder[bestIndex]);
+        } else {
+            qCDebug(GeotaggingLog) << "No trigger within" << _timeTolerance << "s of" << _imageList.at(imageIndex).fileName();
+        }
+    }
+}
+
+/// Triggers logged without a position fix get a position interpolated in time from the nearest triggers which have one
+void GeoTagWorker::_interpolateMissingPositions()
+{
+    auto hasPosition = [](const cameraFeedbackPacket &trigger) {
+        return (trigger.latitude != 0.0) || (trigger.longitude != 0.0);
+    };
+
+    QList<int> order(_triggerList.count());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return _triggerList[a].timestamp < _triggerList[b].timestamp;
+    });
+
+    int previous = -1;
+    qsizetype nextPosition = 0;     ///< Position in order of the next trigger with a position, shared by a run of missing ones
+    for (qsizetype i = 0; i < order.count(); i++) {
+        if (hasPosition(_triggerList[order[i]])) {
+            previous = order[i];
+            continue;
+        }
+
+        if (nextPosition <= i) {
+            nextPosition = i + 1;
+            while ((nextPosition < order.count()) && !hasPosition(_triggerList[order[nextPosition]])) {
+                nextPosition++;
+            }
+        }
+        if ((previous < 0) || (nextPosition >= order.count())) {
+            continue;
+        }
+        const int next = order[nextPosition];
+
+        const cameraFeedbackPacket &before = _triggerList[previous];
+        const cameraFeedbackPacket &after = _triggerList[next];
+        cameraFeedbackPacket &trigger = _triggerList[order[i]];
+        const double span = after.timestamp - before.timestamp;
+        const double fraction = (span > 0) ? ((trigger.timestamp - before.timestamp) / span) : 0.0;
+        trigger.latitude = before.latitude + (fraction * (after.latitude - before.latitude));
+        trigger.longitude = before.longitude + (fraction * (after.longitude - before.longitude));
+        trigger.altitude = before.altitude + static_cast<float>(fraction * (after.altitude - before.altitude));
+        trigger.groundDistance = before.groundDistance + static_cast<float>(fraction * (after.groundDistance - before.groundDistance));
+        qCDebug(GeotaggingLog) << "Interpolated position of trigger" << trigger.imageSequence;
+    }
 }
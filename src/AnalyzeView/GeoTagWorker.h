@@ -21,16 +21,24 @@ class GeoTagWorker : public QThread
 {
     Q_OBJECT
 
+    friend class GeoTagWorkerTest;
+
 public:
     GeoTagWorker();
 
     void setLogFile         (const QString& logFile)        { _logFile = logFile; }
     void setImageDirectory  (const QString& imageDirectory) { _imageDirectory = imageDirectory; }
     void setSaveDirectory   (const QString& saveDirectory)  { _saveDirectory = saveDirectory; }
+    /// Images are matched to triggers by time within this window. 0 matches by image sequence number.
+    void setTimeTolerance   (double seconds)                { _timeTolerance = seconds; }
+    /// Camera clock minus UTC, used when matching by time
+    void setImageTimeOffset (double seconds)                { _imageTimeOffset = seconds; }
 
     QString logFile         () const { return _logFile; }
     QString imageDirectory  () const { return _imageDirectory; }
     QString saveDirectory   () const { return _saveDirectory; }
+    double  timeTolerance   () const { return _timeTolerance; }
+    double  imageTimeOffset () const { return _imageTimeOffset; }
 
     void cancelTagging      () { _cancel = true; }
 
@@ -55,12 +63,25 @@ signals:
     void progressChanged    (double progress);
 
 private:
+    typedef struct {
+        QString sourceFile;
+        QString destFile;
+        cameraFeedbackPacket geotag;
+    } TagJob_t;
+
     bool triggerFiltering();
+    void _matchBySequence();
+    void _matchByTime();
+    void _interpolateMissingPositions();
+
+    static constexpr qsizetype kBatchSize = 64;     ///< Images processed in parallel between progress updates
 
     bool                    _cancel;
     QString                 _logFile;
     QString                 _imageDirectory;
     QString                 _saveDirectory;
+    double                  _timeTolerance = 0;
+    double                  _imageTimeOffset = 0;
     QFileInfoList           _imageList;
     QList<double>           _imageTime;
     QList<cameraFeedbackPacket> _triggerList;
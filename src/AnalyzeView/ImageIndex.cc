@@ -0,0 +1,182 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ImageIndex.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+QGC_LOGGING_CATEGORY(ImageIndexLog, "qgc.analyzeview.imageindex")
+
+/// Updates of the same directory from the controller and the geotag worker run one after the other, so the second
+/// one finds the images already indexed
+Q_GLOBAL_STATIC(QMutex, _updateMutex)
+
+ImageIndex::ImageIndex(const QString &directory)
+    : _directory(QDir(directory).absolutePath())
+{
+
+}
+
+QString ImageIndex::indexFileName(const QString &directory)
+{
+    const QByteArray pathHash = QCryptographicHash::hash(QDir(directory).absolutePath().toUtf8(), QCryptographicHash::Md5).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/ImageIndex/") + QString::fromLatin1(pathHash) + QLatin1String(".idx");
+}
+
+const ImageIndex::Entry *ImageIndex::entry(const QString &fileName) const
+{
+    const auto it = _entryIndex.constFind(fileName);
+    return (it != _entryIndex.constEnd()) ? &_entries[it.value()] : nullptr;
+}
+
+bool ImageIndex::load()
+{
+    _entries.clear();
+    _entryIndex.clear();
+
+    QFile file(indexFileName(_directory));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic, version;
+    QString directory;
+    quint32 count;
+    stream >> magic >> version >> directory >> count;
+    if ((magic != kIndexMagic) || (version != kIndexVersion) || (directory != _directory)) {
+        return false;
+    }
+
+    _entries.reserve(count);
+    for (quint32 i = 0; (i < count) && (stream.status() == QDataStream::Ok); i++) {
+        Entry entry;
+        stream >> entry.fileName >> entry.size >> entry.lastModified >> entry.valid
+               >> entry.info.time >> entry.info.hasPosition >> entry.info.latitude >> entry.info.longitude >> entry.info.altitude
+               >> entry.info.thumbnail;
+        _entries.append(entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(ImageIndexLog) << "Invalid image index" << file.fileName();
+        _entries.clear();
+        return false;
+    }
+
+    for (qsizetype i = 0; i < _entries.count(); i++) {
+        _entryIndex.insert(_entries[i].fileName, i);
+    }
+
+    qCDebug(ImageIndexLog) << "Loaded" << _entries.count() << "images of" << _directory;
+    return true;
+}
+
+bool ImageIndex::_save() const
+{
+    const QString fileName = indexFileName(_directory);
+    if (!QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+        return false;
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(ImageIndexLog) << "Could not write" << fileName << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << kIndexMagic << kIndexVersion << _directory << static_cast<quint32>(_entries.count());
+    for (const Entry &entry : _entries) {
+        stream << entry.fileName << entry.size << entry.lastModified << entry.valid
+               << entry.info.time << entry.info.hasPosition << entry.info.latitude << entry.info.longitude << entry.info.altitude
+               << entry.info.thumbnail;
+    }
+
+    return file.commit();
+}
+
+bool ImageIndex::update(const Progress_t &progress)
+{
+    QMutexLocker lock(_updateMutex());
+
+    (void) load();
+
+    QDir imageDirectory(_directory);
+    imageDirectory.setFilter(QDir::Files | QDir::Readable | QDir::NoSymLinks);
+    imageDirectory.setSorting(QDir::Name);
+    imageDirectory.setNameFilters({ QStringLiteral("*.jpg"), QStringLiteral("*.JPG") });
+    const QFileInfoList imageList = imageDirectory.entryInfoList();
+
+    // Unchanged images keep their entry, the others are read again
+    QList<Entry> entries;
+    entries.reserve(imageList.count());
+    QList<qsizetype> toRead;
+    bool changed = imageList.count() != _entries.count();
+    for (const QFileInfo &imageInfo : imageList) {
+        const Entry *const existing = entry(imageInfo.fileName());
+        const qint64 lastModified = imageInfo.lastModified().toMSecsSinceEpoch();
+        if (existing && (existing->size == imageInfo.size()) && (existing->lastModified == lastModified)) {
+            entries.append(*existing);
+            continue;
+        }
+
+        Entry newEntry;
+        newEntry.fileName = imageInfo.fileName();
+        newEntry.size = imageInfo.size();
+        newEntry.lastModified = lastModified;
+        toRead.append(entries.count());
+        entries.append(newEntry);
+        changed = true;
+    }
+
+    qCDebug(ImageIndexLog) << "Reading" << toRead.count() << "of" << imageList.count() << "images of" << _directory;
+
+    for (qsizetype batchStart = 0; batchStart < toRead.count(); batchStart += kBatchSize) {
+        const QList<qsizetype> batch = toRead.mid(batchStart, kBatchSize);
+        const QString directory = _directory;
+        const QList<Entry> &pending = entries;
+        const QList<Entry> batchEntries = QtConcurrent::blockingMapped<QList<Entry>>(batch, [&pending, directory](qsizetype index) {
+            Entry readEntry = pending[index];
+            readEntry.valid = ExifParser::readImageInfoFromFile(directory + QLatin1Char('/') + readEntry.fileName, readEntry.info);
+            return readEntry;
+        });
+        for (qsizetype i = 0; i < batch.count(); i++) {
+            entries[batch[i]] = batchEntries[i];
+        }
+
+        if (progress && !progress(batchStart + batch.count(), toRead.count())) {
+            qCDebug(ImageIndexLog) << "Indexing cancelled" << _directory;
+            return false;
+        }
+    }
+
+    _entries = entries;
+    _entryIndex.clear();
+    for (qsizetype i = 0; i < _entries.count(); i++) {
+        _entryIndex.insert(_entries[i].fileName, i);
+    }
+
+    if (changed && !_save()) {
+        qCWarning(ImageIndexLog) << "Could not save the image index of" << _directory;
+    }
+
+    return true;
+}
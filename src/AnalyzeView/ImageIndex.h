@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+
+#include <functional>
+
+#include "ExifParser.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ImageIndexLog)
+
+/// Index of the JPEG images of a directory with the EXIF time, GPS position and thumbnail of each. The index is kept
+/// in the cache location, so opening a directory again only reads the images which were added or changed since.
+class ImageIndex
+{
+public:
+    explicit ImageIndex(const QString &directory);
+
+    struct Entry {
+        QString fileName;               ///< Relative to the directory
+        qint64 size = 0;
+        qint64 lastModified = 0;        ///< msecs since epoch
+        bool valid = false;             ///< false if the EXIF data could not be read
+        ExifParser::ImageInfo info;
+    };
+
+    /// Called while updating, return false to cancel
+    typedef std::function<bool(qsizetype done, qsizetype total)> Progress_t;
+
+    QString directory() const { return _directory; }
+
+    /// Loads the index saved for the directory, without looking at the images
+    ///     @return false if there is none
+    bool load();
+
+    /// Brings the index up to date with the directory and saves it. New or changed images are read in parallel.
+    ///     @return false if cancelled
+    bool update(const Progress_t &progress = nullptr);
+
+    const QList<Entry> &entries() const { return _entries; }
+
+    /// @return nullptr if the image is not in the index
+    const Entry *entry(const QString &fileName) const;
+
+    /// File the index of a directory is kept in
+    static QString indexFileName(const QString &directory);
+
+private:
+    bool _save() const;
+
+    QString _directory;
+    QList<Entry> _entries;
+    QHash<QString, qsizetype> _entryIndex;  ///< File name to index in _entries
+
+    static constexpr quint32 kIndexMagic = 0x51494458;     ///< "QIDX"
+    static constexpr quint32 kIndexVersion = 1;
+    static constexpr qsizetype kBatchSize = 64;             ///< Images read in parallel between progress updates
+};
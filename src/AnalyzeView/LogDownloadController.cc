@@ -20,15 +20,17 @@
 
 #define kTimeOutMilliseconds 500
 #define kGUIRateMilliseconds 17
-#define kTableBins           512
-#define kChunkSize           (kTableBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)
+#define kTimeOutCheckMilliseconds 50
+#define kInitialWindowBins   512
+#define kMinWindowBins       16
+#define kMaxWindowBins       16384
+#define kRttTimeoutFactor    4
 
 QGC_LOGGING_CATEGORY(LogDownloadControllerLog, "qgc.analyzeview.logdownloadcontroller")
 
 //----------------------------------------------------------------------------------------
 LogDownloadController::LogDownloadController(void)
-    : _downloadData(nullptr)
-    , _vehicle(nullptr)
+    : _vehicle(nullptr)
     , _requestingLogEntries(false)
     , _downloadingLogs(false)
     , _retries(0)
@@ -37,17 +39,37 @@ LogDownloadController::LogDownloadController(void)
     MultiVehicleManager *manager = qgcApp()->toolbox()->multiVehicleManager();
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &LogDownloadController::_setActiveVehicle);
     connect(&_timer, &QTimer::timeout, this, &LogDownloadController::_processDownload);
+    connect(&_downloadTimer, &QTimer::timeout, this, &LogDownloadController::_checkDownloadTimeouts);
+    _downloadTimer.setInterval(kTimeOutCheckMilliseconds);
     _setActiveVehicle(manager->activeVehicle());
 }
 
+//----------------------------------------------------------------------------------------
+LogDownloadController::~LogDownloadController()
+{
+    //-- Part files are kept, downloading the logs again resumes them
+    qDeleteAll(_downloads);
+}
+
 //----------------------------------------------------------------------------------------
 void
 LogDownloadController::_processDownload()
 {
     if(_requestingLogEntries) {
         _findMissingEntries();
-    } else if(_downloadingLogs) {
-        _findMissingData();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_checkDownloadTimeouts()
+{
+    //-- A time out can finish a download and start the next one
+    const QList<LogDownloadData*> downloads = _downloads;
+    for(LogDownloadData* download : downloads) {
+        if(_downloads.contains(download) && download->timeout.hasExpired()) {
+            _findMissingData(download);
+        }
     }
 }
 
@@ -56,6 +78,7 @@ void
 LogDownloadController::_setActiveVehicle(Vehicle* vehicle)
 {
     if(_vehicle) {
+        _stopDownloads();
         _logEntriesModel.clearAndDeleteContents();
         disconnect(_vehicle, &Vehicle::logEntry, this, &LogDownloadController::_logEntry);
         disconnect(_vehicle, &Vehicle::logData,  this, &LogDownloadController::_logData);
@@ -213,20 +236,44 @@ LogDownloadController::_findMissingEntries()
     }
 }
 
-void LogDownloadController::_updateDataRate(void)
+void LogDownloadController::_updateDataRate(LogDownloadData* download)
 {
-    if (_downloadData->elapsed.elapsed() >= kGUIRateMilliseconds) {
+    if (download->elapsed.elapsed() >= kGUIRateMilliseconds) {
         //-- Update download rate
-        qreal rrate = _downloadData->rate_bytes / (_downloadData->elapsed.elapsed() / 1000.0);
-        _downloadData->rate_avg = (_downloadData->rate_avg * 0.95) + (rrate * 0.05);
-        _downloadData->rate_bytes = 0;
+        qreal rrate = download->rate_bytes / (download->elapsed.elapsed() / 1000.0);
+        download->rate_avg = (download->rate_avg * 0.95) + (rrate * 0.05);
+        download->rate_bytes = 0;
 
         //-- Update status
-        const QString status = QString("%1 (%2/s)").arg(qgcApp()->bigSizeToString(_downloadData->written),
-                                                        qgcApp()->bigSizeToString(_downloadData->rate_avg));
+        const QString status = QString("%1 (%2/s)").arg(qgcApp()->bigSizeToString(download->written),
+                                                        qgcApp()->bigSizeToString(download->rate_avg));
+
+        download->entry->setStatus(status);
+        download->elapsed.start();
 
-        _downloadData->entry->setStatus(status);
-        _downloadData->elapsed.start();
+        _updateDownloadStatus();
+    }
+}
+
+void LogDownloadController::_updateDownloadStatus(void)
+{
+    QString status;
+    if (!_downloads.isEmpty()) {
+        uint written = 0, size = 0;
+        qreal rate = 0;
+        for (const LogDownloadData* download : _downloads) {
+            written += download->written;
+            size += download->entry->size();
+            rate += download->rate_avg;
+        }
+        status = tr("%1 of %2, %3 queued (%4/s)").arg(qgcApp()->bigSizeToString(written),
+                                                      qgcApp()->bigSizeToString(size))
+                                                 .arg(_queue.count())
+                                                 .arg(qgcApp()->bigSizeToString(rate));
+    }
+    if (status != _downloadStatus) {
+        _downloadStatus = status;
+        emit downloadStatusChanged();
     }
 }
 
@@ -234,12 +281,13 @@ void LogDownloadController::_updateDataRate(void)
 void
 LogDownloadController::_logData(uint32_t ofs, uint16_t id, uint8_t count, const uint8_t* data)
 {
-    if(!_downloadData) {
+    if(_downloads.isEmpty()) {
         return;
     }
     //-- APM "Fix"
     id -= _apmOneBased;
-    if(_downloadData->ID != id) {
+    LogDownloadData* const download = _findDownload(id);
+    if(!download) {
         qCWarning(LogDownloadControllerLog) << "Received log data for wrong log";
         return;
     }
@@ -249,88 +297,141 @@ LogDownloadController::_logData(uint32_t ofs, uint16_t id, uint8_t count, const
         return;
     }
 
-    bool result = false;
-    uint32_t timeout_time = kTimeOutMilliseconds;
-    if(ofs <= _downloadData->entry->size()) {
-        const uint32_t chunk = ofs / kChunkSize;
-        if (chunk != _downloadData->current_chunk) {
-            qCWarning(LogDownloadControllerLog) << "Ignored packet for out of order chunk actual:expected" << chunk << _downloadData->current_chunk;
-            return;
-        }
-        const uint16_t bin = (ofs - chunk*kChunkSize) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-        if (bin >= _downloadData->chunk_table.size()) {
-            qCWarning(LogDownloadControllerLog) << "Out of range bin received";
-        } else
-            _downloadData->chunk_table.setBit(bin);
-        if (_downloadData->file.pos() != ofs) {
-            // Seek to correct position
-            if (!_downloadData->file.seek(ofs)) {
-                qCWarning(LogDownloadControllerLog) << "Error while seeking log file offset";
-                return;
-            }
-        }
+    if(ofs >= download->entry->size()) {
+        qCWarning(LogDownloadControllerLog) << "Received log offset greater than expected";
+        return;
+    }
 
-        //-- Write chunk to file
-        if(_downloadData->file.write((const char*)data, count)) {
-            _downloadData->written += count;
-            _downloadData->rate_bytes += count;
-            _updateDataRate();
-            result = true;
-            //-- reset retries
-            _retries = 0;
-            //-- Reset timer
-            _timer.start(timeout_time);
-            //-- Do we have it all?
-            if(_logComplete()) {
-                _downloadData->entry->setStatus(tr("Downloaded"));
-                //-- Check for more
-                _receivedAllData();
-            } else if (_chunkComplete()) {
-                _downloadData->advanceChunk();
-                _requestLogData(_downloadData->ID,
-                                _downloadData->current_chunk*kChunkSize,
-                                _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-            } else if (bin < _downloadData->chunk_table.size() - 1 && _downloadData->chunk_table.at(bin+1)) {
-                // Likely to be grabbing fragments and got to the end of a gap
-                _findMissingData();
-            }
-        } else {
-            qCWarning(LogDownloadControllerLog) << "Error while writing log file chunk";
-        }
+    //-- Write data to file
+    if(!download->storeData(ofs, data, count)) {
+        qCWarning(LogDownloadControllerLog) << "Error while writing log file chunk";
+        download->entry->setStatus(tr("Error"));
+        return;
+    }
+    _updateDataRate(download);
+    //-- reset retries
+    download->retries = 0;
+
+    //-- Do we have it all?
+    if(download->complete()) {
+        _logDownloaded(download);
+        return;
+    }
+
+    //-- Data of earlier requests is kept but does not move the window
+    const uint32_t bin = ofs / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    if(bin < download->requestStart || bin >= download->requestEnd) {
+        return;
+    }
+    if(!download->requestAnswered) {
+        download->requestAnswered = true;
+        const qreal rtt = download->requestTimer.elapsed();
+        download->rttMSecs = download->rttMSecs > 0 ? (download->rttMSecs * 0.875) + (rtt * 0.125) : rtt;
+    }
+    //-- Bins are sent in order, skipped ones were lost
+    if(bin > download->expectedBin) {
+        download->requestLoss = true;
+    }
+    download->expectedBin = qMax(download->expectedBin, bin + 1);
+
+    if(bin + 1 == download->requestEnd) {
+        _adjustWindow(download, !download->requestLoss);
+        _requestNextRange(download);
     } else {
-        qCWarning(LogDownloadControllerLog) << "Received log offset greater than expected";
+        //-- Reset timer
+        download->timeout.setRemainingTime(_requestTimeout(download));
     }
-    if(!result) {
-        _downloadData->entry->setStatus(tr("Error"));
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_logDownloaded(LogDownloadData* download)
+{
+    if(download->finishFile()) {
+        download->entry->setStatus(tr("Downloaded"));
+    } else {
+        download->entry->setStatus(tr("Error"));
     }
+    //-- Check for more
+    _receivedAllData(download);
 }
 
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_adjustWindow(LogDownloadData* download, bool noLoss)
+{
+    //-- Grow the window while the link keeps up, back off on loss
+    const uint32_t windowBins = noLoss ? qMin<uint32_t>(download->windowBins * 2, kMaxWindowBins)
+                                       : qMax<uint32_t>(download->windowBins / 2, kMinWindowBins);
+    if(windowBins != download->windowBins) {
+        qCDebug(LogDownloadControllerLog) << "Log" << download->ID << "download window" << windowBins << "bins, rtt" << download->rttMSecs << "ms";
+        download->windowBins = windowBins;
+    }
+}
 
 //----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_chunkComplete() const
+int
+LogDownloadController::_requestTimeout(const LogDownloadData* download) const
 {
-    return _downloadData->chunkEquals(true);
+    return qMax(kTimeOutMilliseconds, qRound(download->rttMSecs * kRttTimeoutFactor));
 }
 
 //----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_logComplete() const
+void
+LogDownloadController::_requestNextRange(LogDownloadData* download)
 {
-    return _chunkComplete() && (_downloadData->current_chunk+1) == _downloadData->numChunks();
+    uint32_t start = 0, end = 0;
+    if(!download->nextRange(start, end)) {
+        _logDownloaded(download);
+        return;
+    }
+
+    download->requestStart = start;
+    download->requestEnd = end;
+    download->expectedBin = start;
+    download->requestLoss = false;
+    download->requestAnswered = false;
+    download->requestTimer.start();
+
+    const quint64 pos = static_cast<quint64>(start) * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    const quint64 len = qMin<quint64>(static_cast<quint64>(end) * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN, download->entry->size()) - pos;
+    _requestLogData(download, static_cast<uint32_t>(pos), static_cast<uint32_t>(len));
+    download->timeout.setRemainingTime(_requestTimeout(download));
 }
 
 //----------------------------------------------------------------------------------------
 void
-LogDownloadController::_receivedAllData()
+LogDownloadController::_receivedAllData(LogDownloadData* download)
 {
-    _timer.stop();
+    _downloads.removeOne(download);
+    delete download;
     //-- Anything queued up for download?
-    if(_prepareLogDownload()) {
-        //-- Request Log
-        _requestLogData(_downloadData->ID, 0, _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-        _timer.start(kTimeOutMilliseconds);
-    } else {
+    _startDownloads();
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_startDownloads()
+{
+    if(_vehicle) {
+        const QList<SharedLinkInterfacePtr> links = _downloadLinks();
+        for(const SharedLinkInterfacePtr& link : links) {
+            if(_linkBusy(link)) {
+                continue;
+            }
+            LogDownloadData* const download = _prepareLogDownload();
+            if(!download) {
+                break;
+            }
+            download->link = link;
+            _downloads.append(download);
+            //-- Request Log
+            _requestNextRange(download);
+        }
+    }
+    _updateDownloadStatus();
+    if(_downloads.isEmpty()) {
+        _queue.clear();
         _resetSelection();
         _setDownloading(false);
     }
@@ -338,60 +439,113 @@ LogDownloadController::_receivedAllData()
 
 //----------------------------------------------------------------------------------------
 void
-LogDownloadController::_findMissingData()
+LogDownloadController::_stopDownloads()
 {
-    if (_logComplete()) {
-         _receivedAllData();
-         return;
-    } else if (_chunkComplete()) {
-        _downloadData->advanceChunk();
+    //-- Part files are kept, downloading the logs again resumes them
+    for(LogDownloadData* download : _downloads) {
+        download->entry->setStatus(tr("Interrupted"));
+    }
+    qDeleteAll(_downloads);
+    _downloads.clear();
+    _queue.clear();
+    _updateDownloadStatus();
+    _setDownloading(false);
+}
+
+//----------------------------------------------------------------------------------------
+QList<SharedLinkInterfacePtr>
+LogDownloadController::_downloadLinks() const
+{
+    QList<SharedLinkInterfacePtr> links = _vehicle->vehicleLinkManager()->activeLinks();
+    //-- PX4 runs a log transfer per MAVLink instance, other firmware one for all links
+    if(_vehicle->firmwareType() != MAV_AUTOPILOT_PX4 && links.count() > 1) {
+        links = links.mid(0, 1);
+    }
+    return links;
+}
+
+//----------------------------------------------------------------------------------------
+bool
+LogDownloadController::_linkBusy(const SharedLinkInterfacePtr& link) const
+{
+    for(const LogDownloadData* download : _downloads) {
+        if(download->link.lock() == link) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------------
+LogDownloadData*
+LogDownloadController::_findDownload(uint id) const
+{
+    for(LogDownloadData* download : _downloads) {
+        if(download->ID == id) {
+            return download;
+        }
     }
+    return nullptr;
+}
+
+//----------------------------------------------------------------------------------------
+bool
+LogDownloadController::_downloadingEntry(const QGCLogEntry* entry) const
+{
+    for(const LogDownloadData* download : _downloads) {
+        if(download->entry == entry) {
+            return true;
+        }
+    }
+    for(const QueuedLog_t& queued : _queue) {
+        if(queued.entry == entry) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    _retries++;
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_findMissingData(LogDownloadData* download)
+{
+    download->retries++;
 #if 0
     // Trying the change to infinite log download. This way if retries hit 100% failure the data rate will
     // slowly fall to 0 and the user can Cancel. This should work better on really crappy links.
-    if(_retries > 5) {
-        _downloadData->entry->setStatus(tr("Timed Out"));
+    if(download->retries > 5) {
+        download->entry->setStatus(tr("Timed Out"));
         //-- Give up
         qCWarning(LogDownloadControllerLog) << "Too many errors retreiving log data. Giving up.";
-        _receivedAllData();
+        _receivedAllData(download);
         return;
     }
 #endif
 
-    _updateDataRate();
-
-    uint16_t start = 0, end = 0;
-    const int size = _downloadData->chunk_table.size();
-    for (; start < size; start++) {
-        if (!_downloadData->chunk_table.testBit(start)) {
-            break;
-        }
-    }
-
-    for (end = start; end < size; end++) {
-        if (_downloadData->chunk_table.testBit(end)) {
-            break;
-        }
-    }
+    _updateDataRate(download);
 
-    const uint32_t pos = _downloadData->current_chunk*kChunkSize + start*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
-                   len = (end - start)*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-    _requestLogData(_downloadData->ID, pos, len, _retries);
+    //-- The rest of the outstanding request was lost, ask again for less
+    qCDebug(LogDownloadControllerLog) << "Log" << download->ID << "data request timed out at bin" << download->expectedBin;
+    _adjustWindow(download, false);
+    _requestNextRange(download);
 }
 
 //----------------------------------------------------------------------------------------
 void
-LogDownloadController::_requestLogData(uint16_t id, uint32_t offset, uint32_t count, int retryCount)
+LogDownloadController::_requestLogData(LogDownloadData* download, uint32_t offset, uint32_t count)
 {
     if (_vehicle) {
-        SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+        SharedLinkInterfacePtr sharedLink = download->link.lock();
+        if (!sharedLink) {
+            //-- The link went away, carry on over the primary link
+            sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+            download->link = sharedLink;
+        }
         if (sharedLink) {
 
             //-- APM "Fix"
-            id += _apmOneBased;
-            qCDebug(LogDownloadControllerLog) << "Request log data (id:" << id << "offset:" << offset << "size:" << count << "retryCount" << retryCount << ")";
+            const uint16_t id = download->ID + _apmOneBased;
+            qCDebug(LogDownloadControllerLog) << "Request log data (id:" << id << "offset:" << offset << "size:" << count << "retryCount" << download->retries << "link:" << sharedLink->linkConfiguration()->name() << ")";
             mavlink_message_t msg;
             mavlink_msg_log_request_data_pack_chan(
                         qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
@@ -409,6 +563,7 @@ LogDownloadController::_requestLogData(uint16_t id, uint32_t offset, uint32_t co
 void
 LogDownloadController::refresh(void)
 {
+    _stopDownloads();
     _logEntriesModel.clearAndDeleteContents();
     //-- Get first 50 entries
     _requestLogList(0, 49);
@@ -455,114 +610,73 @@ void LogDownloadController::downloadToDirectory(const QString& dir)
 {
     //-- Stop listing just in case
     _receivedAllEntries();
-    //-- Reset downloads, again just in case
-    delete _downloadData;
-    _downloadData = nullptr;
-
-    _downloadPath = dir;
-    if(!_downloadPath.isEmpty()) {
-        if(!_downloadPath.endsWith(QDir::separator()))
-            _downloadPath += QDir::separator();
-        //-- Iterate selected entries and shown them as waiting
+
+    QString downloadPath = dir;
+    if(!downloadPath.isEmpty()) {
+        if(!downloadPath.endsWith(QDir::separator()))
+            downloadPath += QDir::separator();
+        //-- Queue selected entries and shown them as waiting
         int num_logs = _logEntriesModel.count();
         for(int i = 0; i < num_logs; i++) {
             QGCLogEntry* entry = _logEntriesModel.value<QGCLogEntry*>(i);
             if(entry) {
                 if(entry->selected()) {
-                   entry->setStatus(tr("Waiting"));
+                    entry->setSelected(false);
+                    if(!_downloadingEntry(entry)) {
+                        entry->setStatus(tr("Waiting"));
+                        _queue.append({ entry, downloadPath });
+                    }
                 }
             }
         }
+        emit selectionChanged();
         //-- Start download process
         _setDownloading(true);
-        _receivedAllData();
-    }
-}
-
-//----------------------------------------------------------------------------------------
-QGCLogEntry*
-LogDownloadController::_getNextSelected()
-{
-    //-- Iterate entries and look for a selected file
-    int num_logs = _logEntriesModel.count();
-    for(int i = 0; i < num_logs; i++) {
-        QGCLogEntry* entry = _logEntriesModel.value<QGCLogEntry*>(i);
-        if(entry) {
-            if(entry->selected()) {
-               return entry;
-            }
-        }
+        _startDownloads();
     }
-    return nullptr;
 }
 
 //----------------------------------------------------------------------------------------
-bool
+LogDownloadData*
 LogDownloadController::_prepareLogDownload()
 {
-    delete _downloadData;
-    _downloadData = nullptr;
-
-    QGCLogEntry* entry = _getNextSelected();
-    if(!entry) {
-        return false;
-    }
-    //-- Deselect file
-    entry->setSelected(false);
-    emit selectionChanged();
-    bool result = false;
-    QString ftime;
-    if(entry->time().date().year() < 2010) {
-        ftime = tr("UnknownDate");
-    } else {
-        ftime = entry->time().toString(QStringLiteral("yyyy-M-d-hh-mm-ss"));
-    }
-    _downloadData = new LogDownloadData(entry);
-    _downloadData->filename = QString("log_") + QString::number(entry->id()) + "_" + ftime;
-    if (_vehicle->firmwareType() == MAV_AUTOPILOT_PX4) {
-        QString loggerParam = QStringLiteral("SYS_LOGGER");
-        if (_vehicle->parameterManager()->parameterExists(ParameterManager::defaultComponentId, loggerParam) &&
-                _vehicle->parameterManager()->getParameter(ParameterManager::defaultComponentId, loggerParam)->rawValue().toInt() == 0) {
-            _downloadData->filename += ".px4log";
+    while(!_queue.isEmpty()) {
+        const QueuedLog_t queued = _queue.takeFirst();
+        QGCLogEntry* const entry = queued.entry;
+        QString ftime;
+        if(entry->time().date().year() < 2010) {
+            ftime = tr("UnknownDate");
         } else {
-            _downloadData->filename += ".ulg";
+            ftime = entry->time().toString(QStringLiteral("yyyy-M-d-hh-mm-ss"));
         }
-    } else {
-        _downloadData->filename += ".bin";
-    }
-    _downloadData->file.setFileName(_downloadPath + _downloadData->filename);
-    //-- Append a number to the end if the filename already exists
-    if (_downloadData->file.exists()){
-        uint num_dups = 0;
-        QStringList filename_spl = _downloadData->filename.split('.');
-        do {
-            num_dups +=1;
-            _downloadData->file.setFileName(filename_spl[0] + '_' + QString::number(num_dups) + '.' + filename_spl[1]);
-        } while( _downloadData->file.exists());
-    }
-    //-- Create file
-    if (!_downloadData->file.open(QIODevice::WriteOnly)) {
-        qCWarning(LogDownloadControllerLog) << "Failed to create log file:" <<  _downloadData->filename;
-    } else {
-        //-- Preallocate file
-        if(!_downloadData->file.resize(entry->size())) {
-            qCWarning(LogDownloadControllerLog) << "Failed to allocate space for log file:" <<  _downloadData->filename;
+        LogDownloadData* const download = new LogDownloadData(entry);
+        download->directory = queued.directory;
+        download->filename = QString("log_") + QString::number(entry->id()) + "_" + ftime;
+        if (_vehicle->firmwareType() == MAV_AUTOPILOT_PX4) {
+            QString loggerParam = QStringLiteral("SYS_LOGGER");
+            if (_vehicle->parameterManager()->parameterExists(ParameterManager::defaultComponentId, loggerParam) &&
+                    _vehicle->parameterManager()->getParameter(ParameterManager::defaultComponentId, loggerParam)->rawValue().toInt() == 0) {
+                download->filename += ".px4log";
+            } else {
+                download->filename += ".ulg";
+            }
         } else {
-            _downloadData->current_chunk = 0;
-            _downloadData->chunk_table = QBitArray(_downloadData->chunkBins(), false);
-            _downloadData->elapsed.start();
-            result = true;
+            download->filename += ".bin";
         }
-    }
-    if(!result) {
-        if (_downloadData->file.exists()) {
-            _downloadData->file.remove();
+        //-- Create and preallocate file, or pick up an interrupted download of it
+        if (download->openFile()) {
+            download->windowBins = kInitialWindowBins;
+            download->elapsed.start();
+            return download;
+        }
+        download->closeFile();
+        if (download->file.exists()) {
+            download->file.remove();
         }
-        _downloadData->entry->setStatus(tr("Error"));
-        delete _downloadData;
-        _downloadData = nullptr;
+        entry->setStatus(tr("Error"));
+        delete download;
     }
-    return result;
+    return nullptr;
 }
 
 //----------------------------------------------------------------------------------------
@@ -571,7 +685,14 @@ LogDownloadController::_setDownloading(bool active)
 {
     if (_downloadingLogs != active) {
         _downloadingLogs = active;
-        _vehicle->vehicleLinkManager()->setCommunicationLostEnabled(!active);
+        if (active) {
+            _downloadTimer.start();
+        } else {
+            _downloadTimer.stop();
+        }
+        if (_vehicle) {
+            _vehicle->vehicleLinkManager()->setCommunicationLostEnabled(!active);
+        }
         emit downloadingLogsChanged();
     }
 }
@@ -612,14 +733,17 @@ void
 LogDownloadController::cancel(void)
 {
     _receivedAllEntries();
-    if(_downloadData) {
-        _downloadData->entry->setStatus(tr("Canceled"));
-        if (_downloadData->file.exists()) {
-            _downloadData->file.remove();
-        }
-        delete _downloadData;
-        _downloadData = 0;
+    //-- Part files are kept, downloading the logs again resumes them
+    for(LogDownloadData* download : _downloads) {
+        download->entry->setStatus(tr("Canceled"));
+    }
+    qDeleteAll(_downloads);
+    _downloads.clear();
+    for(const QueuedLog_t& queued : _queue) {
+        queued.entry->setStatus(tr("Canceled"));
     }
+    _queue.clear();
+    _updateDownloadStatus();
     _resetSelection(true);
     _setDownloading(false);
 }
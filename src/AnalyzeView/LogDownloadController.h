@@ -15,6 +15,7 @@
 #include <QtQmlIntegration/QtQmlIntegration>
 
 #include "QmlObjectListModel.h"
+#include "LinkInterface.h"
 
 Q_DECLARE_LOGGING_CATEGORY(LogDownloadControllerLog)
 
@@ -23,24 +24,31 @@ class QGCLogEntry;
 struct LogDownloadData;
 
 //-----------------------------------------------------------------------------
+/// Downloads logs from the active vehicle. It is a singleton to QML so queued downloads keep running while the view
+/// is closed. Logs are downloaded in parallel on the links of the vehicle, one log per link.
 class LogDownloadController : public QObject
 {
     Q_OBJECT
     QML_ELEMENT
+    QML_SINGLETON
     Q_MOC_INCLUDE("Vehicle.h")
 
 public:
     LogDownloadController(void);
+    ~LogDownloadController();
 
     Q_PROPERTY(QmlObjectListModel* model    READ model              NOTIFY modelChanged)
     Q_PROPERTY(bool         requestingList  READ requestingList     NOTIFY requestingListChanged)
     Q_PROPERTY(bool         downloadingLogs READ downloadingLogs    NOTIFY downloadingLogsChanged)
+    Q_PROPERTY(QString      downloadStatus  READ downloadStatus     NOTIFY downloadStatusChanged)   ///< Aggregate progress and throughput of all downloads
 
     QmlObjectListModel* model           () { return &_logEntriesModel; }
     bool                requestingList  () const{ return _requestingLogEntries; }
     bool                downloadingLogs () const{ return _downloadingLogs; }
+    QString             downloadStatus  () const{ return _downloadStatus; }
 
     Q_INVOKABLE void refresh                ();
+    /// Adds the selected logs to the download queue
     Q_INVOKABLE void download               (QString path = QString());
     Q_INVOKABLE void eraseAll               ();
     Q_INVOKABLE void cancel                 ();
@@ -51,6 +59,7 @@ signals:
     void requestingListChanged  ();
     void downloadingLogsChanged ();
     void modelChanged           ();
+    void downloadStatusChanged  ();
     void selectionChanged       ();
 
 private slots:
@@ -58,32 +67,48 @@ private slots:
     void _logEntry          (uint32_t time_utc, uint32_t size, uint16_t id, uint16_t num_logs, uint16_t last_log_num);
     void _logData           (uint32_t ofs, uint16_t id, uint8_t count, const uint8_t *data);
     void _processDownload   ();
+    void _checkDownloadTimeouts();
 
 private:
+    typedef struct QueuedLog_s {
+        QGCLogEntry*    entry;
+        QString         directory;
+    } QueuedLog_t;
+
     bool _entriesComplete   ();
-    bool _chunkComplete     () const;
-    bool _logComplete       () const;
     void _findMissingEntries();
     void _receivedAllEntries();
-    void _receivedAllData   ();
+    void _receivedAllData   (LogDownloadData* download);
     void _resetSelection    (bool canceled = false);
-    void _findMissingData   ();
+    void _findMissingData   (LogDownloadData* download);
+    void _requestNextRange  (LogDownloadData* download);
+    void _adjustWindow      (LogDownloadData* download, bool noLoss);
+    int  _requestTimeout    (const LogDownloadData* download) const;
+    void _logDownloaded     (LogDownloadData* download);
     void _requestLogList    (uint32_t start, uint32_t end);
-    void _requestLogData    (uint16_t id, uint32_t offset, uint32_t count, int retryCount = 0);
-    bool _prepareLogDownload();
+    void _requestLogData    (LogDownloadData* download, uint32_t offset, uint32_t count);
+    void _startDownloads    ();
+    void _stopDownloads     ();
     void _setDownloading    (bool active);
     void _setListing        (bool active);
-    void _updateDataRate    ();
-
-    QGCLogEntry* _getNextSelected();
-
-    LogDownloadData*    _downloadData;
-    QTimer              _timer;
-    QmlObjectListModel  _logEntriesModel;
-    Vehicle*            _vehicle;
-    bool                _requestingLogEntries;
-    bool                _downloadingLogs;
-    int                 _retries;
-    int                 _apmOneBased;
-    QString             _downloadPath;
+    void _updateDataRate    (LogDownloadData* download);
+    void _updateDownloadStatus();
+
+    LogDownloadData*                _prepareLogDownload ();
+    LogDownloadData*                _findDownload       (uint id) const;
+    bool                            _downloadingEntry   (const QGCLogEntry* entry) const;
+    bool                            _linkBusy           (const SharedLinkInterfacePtr& link) const;
+    QList<SharedLinkInterfacePtr>   _downloadLinks      () const;
+
+    QList<LogDownloadData*> _downloads;     ///< Active downloads, one per link
+    QList<QueuedLog_t>      _queue;         ///< Logs waiting for a free link
+    QTimer                  _timer;
+    QTimer                  _downloadTimer;     ///< Checks the time outs of the downloads
+    QmlObjectListModel      _logEntriesModel;
+    Vehicle*                _vehicle;
+    bool                    _requestingLogEntries;
+    bool                    _downloadingLogs;
+    int                     _retries;
+    int                     _apmOneBased;
+    QString                 _downloadStatus;
 };
@@ -26,6 +26,7 @@ AnalyzePage {
 
     property real _margin:          ScreenTools.defaultFontPixelWidth
     property real _butttonWidth:    ScreenTools.defaultFontPixelWidth * 10
+    property var  logController:    LogDownloadController
 
     QGCPalette { id: qgcPal; colorGroupEnabled: enabled }
 
@@ -138,7 +139,7 @@ AnalyzePage {
                     }
                 }
                 QGCButton {
-                    enabled:    !logController.requestingList && !logController.downloadingLogs
+                    enabled:    !logController.requestingList
                     text:       qsTr("Download")
                     width:      _butttonWidth
 
@@ -192,6 +193,13 @@ AnalyzePage {
                     enabled:    logController.requestingList || logController.downloadingLogs
                     onClicked:  logController.cancel()
                 }
+
+                QGCLabel {
+                    width:      _butttonWidth
+                    text:       logController.downloadStatus
+                    wrapMode:   Text.WordWrap
+                    visible:    logController.downloadingLogs
+                }
             }
         }
     }
@@ -12,47 +12,220 @@
 #include "MAVLinkLib.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QtEndian>
 #include <QtCore/QtMath>
 
-#define kTableBins 512
-#define kChunkSize (kTableBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)
+/// Received bins between two missing ones are requested again if the run is shorter than this, one request for
+/// both gaps is faster than waiting for the answer to the first before requesting the second
+#define kMaxBridgeBins 8
 
 QGC_LOGGING_CATEGORY(LogEntryLog, "qgc.analyzeview.logentry")
 
 //-----------------------------------------------------------------------------
 LogDownloadData::LogDownloadData(QGCLogEntry* entry_)
-    : ID(entry_->id())
+    : map(nullptr)
+    , ID(entry_->id())
     , entry(entry_)
     , written(0)
     , rate_bytes(0)
     , rate_avg(0)
+    , retries(0)
+    , windowBins(0)
+    , requestStart(0)
+    , requestEnd(0)
+    , expectedBin(0)
+    , requestLoss(false)
+    , requestAnswered(false)
+    , rttMSecs(0)
+    , _streamBin(0)
+    , _firstMissingBin(0)
 {
 
 }
 
-void LogDownloadData::advanceChunk()
+LogDownloadData::~LogDownloadData()
 {
-       current_chunk++;
-       chunk_table = QBitArray(chunkBins(), false);
+    closeFile();
 }
 
-// The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the current chunk
-uint32_t LogDownloadData::chunkBins() const
+bool LogDownloadData::openFile()
 {
-    return qMin(qCeil((entry->size() - current_chunk*kChunkSize)/static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)),
-                kTableBins);
+    file.setFileName(directory + filename + QStringLiteral(".part"));
+    bins = QBitArray(numBins(), false);
+
+    const bool resume = file.exists() && (file.size() == _partSize());
+
+    // Read access is needed by the mapping
+    if (!file.open(resume ? QIODevice::ReadWrite : (QIODevice::ReadWrite | QIODevice::Truncate))) {
+        qCWarning(LogEntryLog) << "Failed to create log file:" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    if (!resume || !_resume()) {
+        written = 0;
+        bins.fill(false);
+
+        //-- Preallocate file, the bin table is zeroed by the resize
+        const QByteArray footer = _footer();
+        if (!file.resize(0) || !file.resize(_partSize()) || !file.seek(entry->size() + _tableSize()) || (file.write(footer) != kFooterSize)) {
+            qCWarning(LogEntryLog) << "Failed to allocate space for log file:" << file.fileName() << file.errorString();
+            return false;
+        }
+    }
+
+    map = file.map(0, _partSize());
+    if (!map) {
+        qCDebug(LogEntryLog) << "Failed to map log file, falling back to writes:" << file.fileName() << file.errorString();
+    }
+
+    return true;
+}
+
+bool LogDownloadData::_resume()
+{
+    if (!file.seek(entry->size())) {
+        return false;
+    }
+    const QByteArray table = file.read(_tableSize() + kFooterSize);
+    if ((table.size() != (_tableSize() + kFooterSize)) || (table.sliced(_tableSize()) != _footer())) {
+        qCDebug(LogEntryLog) << "Part file holds a different log, restarting" << file.fileName();
+        return false;
+    }
+
+    bins = QBitArray::fromBits(table.constData(), numBins());
+    const uint32_t receivedBins = static_cast<uint32_t>(bins.count(true));
+    written = receivedBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    if ((receivedBins > 0) && bins.testBit(numBins() - 1)) {
+        // The last bin is shorter
+        written -= (numBins() * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) - entry->size();
+    }
+
+    qCDebug(LogEntryLog) << "Resuming" << file.fileName() << "at" << written << "of" << entry->size() << "bytes";
+    return true;
+}
+
+// Identifies the log held by the part file. The file name only holds the log id and date, logs of another vehicle
+// or of the same vehicle after its logs were erased end up with the same part file.
+QByteArray LogDownloadData::_footer() const
+{
+    const QDateTime time = entry->time();
+    QByteArray footer(kFooterSize, 0);
+    qToLittleEndian<quint32>(kPartMagic, footer.data());
+    qToLittleEndian<quint32>(entry->size(), footer.data() + 4);
+    qToLittleEndian<quint32>(ID, footer.data() + 8);
+    qToLittleEndian<qint64>(time.isValid() ? time.toSecsSinceEpoch() : 0, footer.data() + 12);
+    return footer;
 }
 
-// The number of kChunkSize chunks in the file
-uint32_t LogDownloadData::numChunks() const
+void LogDownloadData::closeFile()
 {
-    return qCeil(entry->size() / static_cast<qreal>(kChunkSize));
+    if (map) {
+        (void) file.unmap(map);
+        map = nullptr;
+    } else if (file.isOpen() && file.seek(entry->size())) {
+        (void) file.write(bins.bits(), _tableSize());
+    }
+    file.close();
+}
+
+bool LogDownloadData::finishFile()
+{
+    closeFile();
+
+    if (!file.resize(entry->size())) {
+        qCWarning(LogEntryLog) << "Failed to truncate log file:" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    //-- Append a number to the end if the filename already exists
+    QString fileName = directory + filename;
+    if (QFile::exists(fileName)) {
+        uint num_dups = 0;
+        const QStringList filename_spl = filename.split('.');
+        do {
+            num_dups +=1;
+            fileName = directory + filename_spl[0] + '_' + QString::number(num_dups) + '.' + filename_spl[1];
+        } while (QFile::exists(fileName));
+    }
+
+    if (!file.rename(fileName)) {
+        qCWarning(LogEntryLog) << "Failed to rename log file:" << file.fileName() << fileName << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// Stores the data of a LOG_DATA message. Data of bins which were already received is dropped.
+bool LogDownloadData::storeData(uint32_t ofs, const uint8_t* data, uint8_t count)
+{
+    const uint32_t bin = ofs / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    if (bin >= static_cast<uint32_t>(bins.size())) {
+        return false;
+    }
+    if (bins.testBit(bin)) {
+        return true;
+    }
+
+    count = static_cast<uint8_t>(qMin<uint32_t>(count, entry->size() - ofs));
+    if (map) {
+        memcpy(map + ofs, data, count);
+        // Marked after the data so a killed download never claims data it does not have
+        map[entry->size() + (bin / 8)] |= static_cast<uchar>(1 << (bin % 8));
+    } else if (!file.seek(ofs) || (file.write(reinterpret_cast<const char*>(data), count) != count)) {
+        return false;
+    }
+
+    bins.setBit(bin);
+    written += count;
+    rate_bytes += count;
+    return true;
+}
+
+// Next range of bins to request. The log is streamed front to back first, after that the missing bins are requested.
+// @return false: all bins were received
+bool LogDownloadData::nextRange(uint32_t& start, uint32_t& end)
+{
+    const uint32_t binCount = numBins();
+
+    // Bins of a resumed download are skipped
+    while ((_streamBin < binCount) && bins.testBit(_streamBin)) {
+        _streamBin++;
+    }
+    if (_streamBin < binCount) {
+        start = _streamBin;
+        end = start + 1;
+        const uint32_t limit = qMin(start + windowBins, binCount);
+        while ((end < limit) && !bins.testBit(end)) {
+            end++;
+        }
+        _streamBin = end;
+        return true;
+    }
+
+    while ((_firstMissingBin < binCount) && bins.testBit(_firstMissingBin)) {
+        _firstMissingBin++;
+    }
+    if (_firstMissingBin >= binCount) {
+        return false;
+    }
+
+    start = _firstMissingBin;
+    end = start + 1;
+    const uint32_t limit = qMin(start + windowBins, binCount);
+    for (uint32_t bin = end; bin < limit; bin++) {
+        if (!bins.testBit(bin)) {
+            end = bin + 1;
+        } else if ((bin - end) >= kMaxBridgeBins) {
+            break;
+        }
+    }
+    return true;
 }
 
-// True if all bins in the chunk have been set to val
-bool LogDownloadData::chunkEquals(const bool val) const
+// The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the file
+uint32_t LogDownloadData::numBins() const
 {
-    return chunk_table == QBitArray(chunk_table.size(), val);
+    return qCeil(entry->size() / static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN));
 }
 
 //----------------------------------------------------------------------------------------
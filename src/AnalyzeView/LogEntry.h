@@ -14,11 +14,17 @@
 #include <QtCore/QString>
 #include <QtCore/QBitArray>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QDeadlineTimer>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include <memory>
+
 Q_DECLARE_LOGGING_CATEGORY(LogEntryLog)
 
+class LinkInterface;
+
 //-----------------------------------------------------------------------------
 class QGCLogEntry : public QObject
 {
@@ -68,13 +74,23 @@ private:
     QString     _status;
 };
 
+/// Log being downloaded. Every MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bytes of the log are one bin. The log is streamed
+/// in windows of bins, bins lost on the way are requested again once the whole log has been streamed. The data is
+/// written straight into a mapping of a preallocated ".part" file. The table of received bins is kept behind the log
+/// data of the part file, so an interrupted download resumes where it stopped and only the last bins are lost if the
+/// application is killed. A footer behind the table identifies the log by id, time and size, a part file of any other
+/// log is downloaded again.
 struct LogDownloadData {
+    friend class LogDownloadDataTest;
+
     LogDownloadData(QGCLogEntry* entry);
+    ~LogDownloadData();
 
-    QBitArray     chunk_table;
-    uint32_t      current_chunk;
-    QFile         file;
-    QString       filename;
+    QBitArray     bins;               ///< Received bins of the whole log
+    QFile         file;               ///< Part file
+    uchar*        map;                ///< Mapping of the part file, nullptr if it could not be mapped
+    QString       filename;           ///< Final file name
+    QString       directory;
     uint          ID;
     QGCLogEntry*  entry;
     uint          written;
@@ -82,8 +98,38 @@ struct LogDownloadData {
     qreal         rate_avg;
     QElapsedTimer elapsed;
 
-    void advanceChunk();
-    uint32_t chunkBins() const;
-    uint32_t numChunks() const;
-    bool chunkEquals(const bool val) const;
+    std::weak_ptr<LinkInterface> link;  ///< Link the log is requested on
+    QDeadlineTimer timeout;           ///< Time out of the outstanding request
+    int           retries;
+    uint32_t      windowBins;         ///< Number of bins requested at once
+    uint32_t      requestStart;       ///< First bin of the outstanding request
+    uint32_t      requestEnd;         ///< One past the last bin of the outstanding request
+    uint32_t      expectedBin;        ///< Next bin expected for the outstanding request
+    bool          requestLoss;        ///< Bins of the outstanding request were skipped
+    bool          requestAnswered;    ///< Data arrived for the outstanding request
+    QElapsedTimer requestTimer;
+    qreal         rttMSecs;           ///< Smoothed time from a request to its first data, 0 until measured
+
+    /// Opens the part file, resuming the download if it holds an earlier download of the same log
+    bool     openFile();
+    /// Writes the bin table if the file is not mapped, the part file is kept
+    void     closeFile();
+    /// Strips the bin table from the part file and renames it to the final file name, made unique if needed
+    bool     finishFile();
+    bool     storeData(uint32_t ofs, const uint8_t* data, uint8_t count);
+    bool     nextRange(uint32_t& start, uint32_t& end);
+    uint32_t numBins() const;
+    bool     complete() const { return written >= entry->size(); }
+
+private:
+    qint64   _tableSize() const { return (numBins() + 7) / 8; }
+    qint64   _partSize() const { return entry->size() + _tableSize() + kFooterSize; }
+    bool     _resume();
+    QByteArray _footer() const;
+
+    uint32_t _streamBin;              ///< Bins before it have been requested or were received before
+    uint32_t _firstMissingBin;        ///< All bins before it have been received
+
+    static constexpr quint32 kPartMagic = 0x4c434751;   ///< "QGCL"
+    static constexpr qint64  kFooterSize = 20;          ///< Magic, log size, log id and log time behind the bin table
 };
@@ -56,6 +56,40 @@ MAVLinkChartController::setRangeXIndex(quint32 t)
     _rangeXIndex = t;
     emit rangeXIndexChanged();
     updateXRange();
+    for(int i = 0; i < _chartFields.count(); i++) {
+        QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
+        QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
+        if(pField) {
+            pField->setCapacity(sampleCapacity());
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkChartController::setPlotWidth(int width)
+{
+    if(_plotWidth != width) {
+        _plotWidth = width;
+        emit plotWidthChanged();
+    }
+}
+
+//-----------------------------------------------------------------------------
+qint64
+MAVLinkChartController::timeScaleMSecs() const
+{
+    if(_rangeXIndex < static_cast<quint32>(_controller->timeScaleSt().count())) {
+        return _controller->timeScaleSt()[static_cast<int>(_rangeXIndex)]->timeScale;
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+int
+MAVLinkChartController::sampleCapacity() const
+{
+    return static_cast<int>(timeScaleMSecs() * kMaxSampleRateHz / 1000);
 }
 
 //-----------------------------------------------------------------------------
@@ -102,11 +136,13 @@ void
 MAVLinkChartController::_refreshSeries()
 {
     updateXRange();
+    const qint64 windowStart = _rangeXMin.toMSecsSinceEpoch();
+    const qint64 windowMSecs = timeScaleMSecs();
     for(int i = 0; i < _chartFields.count(); i++) {
         QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
         QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
         if(pField) {
-            pField->updateSeries();
+            pField->updateSeries(windowStart, windowMSecs, _plotWidth);
         }
     }
 }
@@ -48,6 +48,7 @@ public:
 
     Q_PROPERTY(quint32      rangeYIndex         READ rangeYIndex            WRITE setRangeYIndex    NOTIFY rangeYIndexChanged)
     Q_PROPERTY(quint32      rangeXIndex         READ rangeXIndex            WRITE setRangeXIndex    NOTIFY rangeXIndexChanged)
+    Q_PROPERTY(int          plotWidth           READ plotWidth              WRITE setPlotWidth      NOTIFY plotWidthChanged)
 
     Q_INVOKABLE void        addSeries           (QGCMAVLinkMessageField* field, QAbstractSeries* series);
     Q_INVOKABLE void        delSeries           (QGCMAVLinkMessageField* field);
@@ -62,9 +63,14 @@ public:
     quint32                 rangeXIndex         () const{ return _rangeXIndex; }
     quint32                 rangeYIndex         () const{ return _rangeYIndex; }
     int                     chartIndex          () const{ return _index; }
+    int                     plotWidth           () const{ return _plotWidth; }
+    qint64                  timeScaleMSecs      () const;
+    /// @return Number of samples a field keeps for the selected time scale
+    int                     sampleCapacity      () const;
 
     void                    setRangeXIndex      (quint32 t);
     void                    setRangeYIndex      (quint32 r);
+    void                    setPlotWidth        (int width);
     void                    updateXRange        ();
     void                    updateYRange        ();
 
@@ -76,6 +82,7 @@ signals:
     void rangeYMaxChanged   ();
     void rangeYIndexChanged ();
     void rangeXIndexChanged ();
+    void plotWidthChanged   ();
 
 private slots:
     void _refreshSeries     ();
@@ -89,6 +96,9 @@ private:
     qreal               _rangeYMax           = 1;
     quint32             _rangeXIndex         = 0;                    ///< 5 Seconds
     quint32             _rangeYIndex         = 0;                    ///< Auto Range
+    int                 _plotWidth           = 0;
     QVariantList        _chartFields;
     MAVLinkInspectorController* _controller  = nullptr;
+
+    static constexpr int kMaxSampleRateHz = 100;                    ///< Faster fields only keep the newest part of the time scale
 };
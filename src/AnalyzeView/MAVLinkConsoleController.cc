@@ -21,8 +21,16 @@
 QGC_LOGGING_CATEGORY(MAVLinkConsoleControllerLog, "qgc.analyzeview.mavlinkconsolecontroller")
 
 MAVLinkConsoleController::MAVLinkConsoleController()
-    : QStringListModel()
+    : QObject()
 {
+    _lines.resize(_max_num_lines);
+    _richLines.resize(_max_num_lines);
+    _richLineValid.resize(_max_num_lines);
+
+    _updateTimer.setSingleShot(true);
+    _updateTimer.setInterval(_updateIntervalMsecs);
+    connect(&_updateTimer, &QTimer::timeout, this, &MAVLinkConsoleController::textChanged);
+
     auto *manager = qgcApp()->toolbox()->multiVehicleManager();
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &MAVLinkConsoleController::_setActiveVehicle);
     _setActiveVehicle(manager->activeVehicle());
@@ -47,7 +55,7 @@ MAVLinkConsoleController::sendCommand(QString command)
         }
     }
     command.append("\n");
-    _sendSerialData(qPrintable(command));
+    _sendSerialData(command.toUtf8());
     _cursor_home_pos = -1;
 }
 
@@ -86,56 +94,49 @@ MAVLinkConsoleController::_setActiveVehicle(Vehicle* vehicle)
     _vehicle = vehicle;
 
     if (_vehicle) {
-        _incoming_buffer.clear();
-        // Reset the model
-        setStringList(QStringList());
-        _cursorY = 0;
-        _cursorX = 0;
-        _cursor_home_pos = -1;
+        _resetConsole();
         _uas_connections << connect(_vehicle, &Vehicle::mavlinkSerialControl, this, &MAVLinkConsoleController::_receiveData);
     }
 }
 
+void
+MAVLinkConsoleController::_resetConsole()
+{
+    for (int i = 0; i < _max_num_lines; i++) {
+        _lines[i].clear();
+        _richLineValid[i] = false;
+    }
+    _firstLine = 0;
+    _lineCount = 0;
+    _cursorY = 0;
+    _cursorX = 0;
+    _cursor_home_pos = -1;
+    _ansiState = AnsiState::Text;
+    _csiParams.clear();
+    _pendingText.clear();
+    _decoder.resetState();
+    _textValid = false;
+    emit textChanged();
+}
+
 void
 MAVLinkConsoleController::_receiveData(uint8_t device, uint8_t, uint16_t, uint32_t, QByteArray data)
 {
     if (device != SERIAL_CONTROL_DEV_SHELL)
         return;
 
-    // Append incoming data and parse for ANSI codes
-    _incoming_buffer.append(data);
-    while(!_incoming_buffer.isEmpty()) {
-        bool newline = false;
-        int idx = _incoming_buffer.indexOf('\n');
-        if (idx == -1) {
-            // Read the whole incoming buffer
-            idx = _incoming_buffer.size();
-        } else {
-            newline = true;
-        }
+    _processANSItext(data);
+    _flushText();
 
-        QByteArray fragment = _incoming_buffer.mid(0, idx);
-        if (_processANSItext(fragment)) {
-            writeLine(_cursorY, fragment);
-            if (newline) {
-                _cursorY++;
-                _cursorX = 0;
-                // ensure line exists
-                int rc = rowCount();
-                if (_cursorY >= rc) {
-                    insertRows(rc, 1 + _cursorY - rc);
-                }
-            }
-            _incoming_buffer.remove(0, idx + (newline ? 1 : 0));
-        } else {
-            // ANSI processing failed, need more data
-            return;
-        }
+    // Repaint at a fixed rate while output streams in. The timer is not restarted, so continuous output can not
+    // hold off the update.
+    if (!_updateTimer.isActive()) {
+        _updateTimer.start();
     }
 }
 
 void
-MAVLinkConsoleController::_sendSerialData(QByteArray data, bool close)
+MAVLinkConsoleController::_sendSerialData(const QByteArray& data, bool close)
 {
     if (!_vehicle) {
         qWarning() << "Internal error";
@@ -147,96 +148,184 @@ MAVLinkConsoleController::_sendSerialData(QByteArray data, bool close)
         return;
     }
 
-    // Send maximum sized chunks until the complete buffer is transmitted
-    while(data.size()) {
-        QByteArray chunk{data.left(MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN)};
-        int dataSize = chunk.size();
-        // Ensure the buffer is large enough, as the MAVLink parser expects MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN bytes
-        chunk.append(MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN - chunk.size(), '\0');
-        uint8_t flags = SERIAL_CONTROL_FLAG_EXCLUSIVE |  SERIAL_CONTROL_FLAG_RESPOND | SERIAL_CONTROL_FLAG_MULTI;
-        if (close) flags = 0;
-        auto protocol = qgcApp()->toolbox()->mavlinkProtocol();
-        auto link = _vehicle->vehicleLinkManager()->primaryLink();
+    const auto protocol = qgcApp()->toolbox()->mavlinkProtocol();
+    const uint8_t systemId = protocol->getSystemId();
+    const uint8_t componentId = protocol->getComponentId();
+    const uint8_t channel = sharedLink->mavlinkChannel();
+    const uint8_t flags = close ? 0 : (SERIAL_CONTROL_FLAG_EXCLUSIVE | SERIAL_CONTROL_FLAG_RESPOND | SERIAL_CONTROL_FLAG_MULTI);
+
+    // Send maximum sized chunks until the complete buffer is transmitted. A large paste is walked by offset
+    // instead of removing each chunk from the front of the buffer.
+    for (qsizetype offset = 0; offset < data.size(); offset += MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN) {
+        const uint8_t dataSize = static_cast<uint8_t>(qMin<qsizetype>(data.size() - offset, MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN));
+        // The MAVLink packer always reads MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN bytes
+        uint8_t chunk[MAVLINK_MSG_SERIAL_CONTROL_FIELD_DATA_LEN] = {};
+        memcpy(chunk, data.constData() + offset, dataSize);
         mavlink_message_t msg;
         mavlink_msg_serial_control_pack_chan(
-                    protocol->getSystemId(),
-                    protocol->getComponentId(),
-                    sharedLink->mavlinkChannel(),
+                    systemId,
+                    componentId,
+                    channel,
                     &msg,
                     SERIAL_CONTROL_DEV_SHELL,
                     flags,
                     0,
                     0,
                     dataSize,
-                    reinterpret_cast<uint8_t*>(chunk.data()),
+                    chunk,
                     _vehicle->id(), _vehicle->defaultComponentId());
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
-        data.remove(0, chunk.size());
     }
 }
 
-bool
-MAVLinkConsoleController::_processANSItext(QByteArray &line)
+void
+MAVLinkConsoleController::_processANSItext(QByteArrayView data)
 {
-    // Iterate over the incoming buffer to parse off known ANSI control codes
-    for (int i = 0; i < line.size(); i++) {
-        if (line.at(i) == '\x1B') {
-            // For ANSI codes we expect at least 3 incoming chars
-            if (i < line.size() - 2 && line.at(i+1) == '[') {
-                // Parse ANSI code
-                switch(line.at(i+2)) {
-                    default:
-                        continue;
-                    case 'H':
-                        if (_cursor_home_pos == -1) {
-                            // Assign new home position if home is unset
-                            _cursor_home_pos = _cursorY;
-                        } else {
-                            // Rewind write cursor position to home
-                            _cursorY = _cursor_home_pos;
-                            _cursorX = 0;
-                        }
-                        break;
-                    case 'K':
-                        // Erase the current line to the end
-                        if (_cursorY < rowCount()) {
-                            auto idx = index(_cursorY);
-                            QString updated = data(idx, Qt::DisplayRole).toString();
-                            int eraseIdx = _cursorX + i;
-                            if (eraseIdx < updated.length()) {
-                                setData(idx, updated.remove(eraseIdx, updated.length()));
-                            }
-                        }
-                        break;
-                    case '2':
-                        // Check for sufficient buffer size
-                        if ( i >= line.size() - 3)
-                            return false;
-
-                        if (line.at(i+3) == 'J' && _cursor_home_pos != -1) {
-                            // Erase everything and rewind to home
-                            bool blocked = blockSignals(true);
-                            for (int j = _cursor_home_pos; j < rowCount(); j++)
-                                setData(index(j), "");
-                            blockSignals(blocked);
-                            QVector<int> roles({Qt::DisplayRole, Qt::EditRole});
-                            emit dataChanged(index(_cursorY), index(rowCount()), roles);
-                        }
-                        // Even if we didn't understand this ANSI code, remove the 4th char
-                        line.remove(i+3,1);
-                        break;
-                }
-                // Remove the parsed ANSI code and decrement the bufferpos
-                line.remove(i, 3);
-                i--;
+    // The parser state is kept between calls, so codes and lines split over several messages are picked up
+    // where the previous message left off
+    for (const char c : data) {
+        switch (_ansiState) {
+        case AnsiState::Text:
+            if (c == '\x1B') {
+                _flushText();
+                _ansiState = AnsiState::Escape;
+            } else if (c == '\n') {
+                _flushText();
+                _newLine();
+            } else if (c == '\r') {
+                _flushText();
+                _cursorX = 0;
+            } else {
+                _pendingText.append(c);
+            }
+            break;
+        case AnsiState::Escape:
+            if (c == '[') {
+                _csiParams.clear();
+                _ansiState = AnsiState::Csi;
             } else {
-                // We can reasonably expect a control code was fragemented
-                // Stop parsing here and wait for it to come in
-                return false;
+                // Not a code we know, drop it
+                _ansiState = AnsiState::Text;
+            }
+            break;
+        case AnsiState::Csi:
+            if (c >= 0x40 && c <= 0x7E) {
+                _processCsi(c);
+                _ansiState = AnsiState::Text;
+            } else if (_csiParams.size() < 16) {
+                _csiParams.append(c);
+            } else {
+                _ansiState = AnsiState::Text;
+            }
+            break;
+        }
+    }
+}
+
+void
+MAVLinkConsoleController::_processCsi(char command)
+{
+    switch (command) {
+    case 'H':
+        if (_cursor_home_pos == -1) {
+            // Assign new home position if home is unset
+            _cursor_home_pos = _cursorY;
+        } else {
+            // Rewind write cursor position to home
+            _cursorY = _cursor_home_pos;
+            _cursorX = 0;
+        }
+        break;
+    case 'K':
+        // Erase the current line to the end
+        if (_cursorY < _lineCount) {
+            QString& line = _line(_cursorY);
+            if (_cursorX < line.length()) {
+                line.truncate(_cursorX);
+                _lineChanged(_cursorY);
+            }
+        }
+        break;
+    case 'J':
+        if (_csiParams == "2" && _cursor_home_pos != -1) {
+            // Erase everything and rewind to home
+            for (int row = _cursor_home_pos; row < _lineCount; row++) {
+                _line(row).clear();
+                _lineChanged(row);
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void
+MAVLinkConsoleController::_flushText()
+{
+    if (_pendingText.isEmpty()) {
+        return;
+    }
+
+    // The decoder holds back a multi-byte character split over two messages
+    const QString text = _decoder.decode(_pendingText);
+    _pendingText.clear();
+    if (text.isEmpty()) {
+        return;
+    }
+
+    _ensureLine(_cursorY);
+    QString& line = _line(_cursorY);
+    if (_cursorX > line.length()) {
+        line.append(QString(_cursorX - line.length(), ' '));
+    }
+    line.replace(_cursorX, text.length(), text);
+    _cursorX += text.length();
+    _lineChanged(_cursorY);
+}
+
+void
+MAVLinkConsoleController::_newLine()
+{
+    _ensureLine(_cursorY);
+    _cursorY++;
+    _cursorX = 0;
+    _ensureLine(_cursorY);
+}
+
+QString&
+MAVLinkConsoleController::_line(int row)
+{
+    return _lines[(_firstLine + row) % _max_num_lines];
+}
+
+void
+MAVLinkConsoleController::_ensureLine(int row)
+{
+    while (row >= _lineCount) {
+        if (_lineCount == _max_num_lines) {
+            // Ring is full, the oldest line is reused
+            _firstLine = (_firstLine + 1) % _max_num_lines;
+            _lineCount--;
+            row--;
+            _cursorY--;
+            if (_cursor_home_pos != -1) {
+                _cursor_home_pos--;
             }
         }
+        const int index = (_firstLine + _lineCount) % _max_num_lines;
+        _lines[index].clear();
+        _richLineValid[index] = false;
+        _lineCount++;
     }
-    return true;
+    _textValid = false;
+}
+
+void
+MAVLinkConsoleController::_lineChanged(int row)
+{
+    _richLineValid[(_firstLine + row) % _max_num_lines] = false;
+    _textValid = false;
 }
 
 QString
@@ -256,38 +345,32 @@ MAVLinkConsoleController::transformLineForRichText(const QString& line) const
 QString
 MAVLinkConsoleController::getText() const
 {
-    QString ret;
-    if (rowCount() > 0) {
-        ret = transformLineForRichText(data(index(0), Qt::DisplayRole).toString());
-    }
-    for (int i = 1; i < rowCount(); ++i) {
-        ret += "<br>" + transformLineForRichText(data(index(i), Qt::DisplayRole).toString());
+    if (_textValid) {
+        return _text;
     }
 
-    return ret;
-}
-
-void
-MAVLinkConsoleController::writeLine(int line, const QByteArray &text)
-{
-    auto rc = rowCount();
-    if (line >= rc) {
-        insertRows(rc, 1 + line - rc);
+    // Only lines changed since the last call are converted again
+    qsizetype length = 0;
+    for (int row = 0; row < _lineCount; row++) {
+        const int index = (_firstLine + row) % _max_num_lines;
+        if (!_richLineValid[index]) {
+            _richLines[index] = transformLineForRichText(_lines[index]);
+            _richLineValid[index] = true;
+        }
+        length += _richLines[index].length() + 4;
     }
-    if (rowCount() > _max_num_lines) {
-        int count = rowCount() - _max_num_lines;
-        removeRows(0, count);
-        line -= count;
-        _cursorY -= count;
-        _cursor_home_pos -= count;
-        if (_cursor_home_pos < 0)
-            _cursor_home_pos = -1;
+
+    _text.clear();
+    _text.reserve(length);
+    for (int row = 0; row < _lineCount; row++) {
+        if (row > 0) {
+            _text += QStringLiteral("<br>");
+        }
+        _text += _richLines[(_firstLine + row) % _max_num_lines];
     }
-    auto idx = index(line);
-    QString updated = data(idx, Qt::DisplayRole).toString();
-    updated.replace(_cursorX, text.size(), text);
-    setData(idx, updated);
-    _cursorX += text.size();
+    _textValid = true;
+
+    return _text;
 }
 
 void MAVLinkConsoleController::CommandHistory::append(const QString& command)
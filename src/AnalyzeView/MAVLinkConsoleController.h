@@ -11,8 +11,9 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QStringDecoder>
 #include <QtCore/QMetaObject>
-#include <QtCore/QStringListModel>
+#include <QtCore/QTimer>
 #include <QtQmlIntegration/QtQmlIntegration>
 #include <QtCore/QLoggingCategory>
 
@@ -23,7 +24,11 @@ Q_DECLARE_LOGGING_CATEGORY(MAVLinkConsoleControllerLog)
 class Vehicle;
 
 /// Controller for MavlinkConsole.qml.
-class MAVLinkConsoleController : public QStringListModel
+///
+/// Shell output is kept in a fixed ring of lines and parsed for ANSI codes as it streams in, a byte at a time, so
+/// a code split over two SERIAL_CONTROL messages costs nothing extra. The rich text of each line is cached and
+/// textChanged is emitted at most every _updateIntervalMsecs, so commands like top or listener do not flood the UI.
+class MAVLinkConsoleController : public QObject
 {
     Q_OBJECT
     QML_ELEMENT
@@ -45,16 +50,25 @@ public:
      */
     Q_INVOKABLE QString handleClipboard(const QString& command_pre);
 
-    Q_PROPERTY(QString text                     READ getText                    CONSTANT)
+    Q_PROPERTY(QString text                     READ getText                    NOTIFY textChanged)
+
+signals:
+    void textChanged();
 
 private slots:
     void _setActiveVehicle  (Vehicle* vehicle);
     void _receiveData(uint8_t device, uint8_t flags, uint16_t timeout, uint32_t baudrate, QByteArray data);
 
 private:
-    bool _processANSItext(QByteArray &line);
-    void _sendSerialData(QByteArray, bool close = false);
-    void writeLine(int line, const QByteArray &text);
+    void _processANSItext(QByteArrayView data);
+    void _processCsi(char command);
+    void _sendSerialData(const QByteArray& data, bool close = false);
+    void _flushText();
+    void _newLine();
+    void _resetConsole();
+    QString& _line(int row);
+    void _ensureLine(int row);
+    void _lineChanged(int row);
 
     QString transformLineForRichText(const QString& line) const;
 
@@ -72,12 +86,33 @@ private:
         int _index = 0;
     };
 
+    enum class AnsiState {
+        Text,
+        Escape,         ///< After ESC
+        Csi,            ///< After ESC [
+    };
+
     static constexpr int _max_num_lines = 500; ///< history size (affects CPU load)
+    static constexpr int _updateIntervalMsecs = 50;
 
     int           _cursor_home_pos{-1};
     int           _cursorY{0};
     int           _cursorX{0};
-    QByteArray    _incoming_buffer;
+    AnsiState     _ansiState{AnsiState::Text};
+    QByteArray    _csiParams;
+    QByteArray    _pendingText;         ///< Printable bytes not yet written at the cursor
+    QStringDecoder _decoder{QStringDecoder::Utf8};
+
+    // Ring of lines, row 0 is _lines[_firstLine]
+    QList<QString> _lines;
+    mutable QList<QString> _richLines;  ///< transformLineForRichText of each line
+    mutable QList<bool> _richLineValid;
+    int           _firstLine{0};
+    int           _lineCount{0};
+    mutable QString _text;
+    mutable bool  _textValid{false};
+    QTimer        _updateTimer;
+
     Vehicle*      _vehicle{nullptr};
     QList<QMetaObject::Connection> _uas_connections;
     CommandHistory _history;
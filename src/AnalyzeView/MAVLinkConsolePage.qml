@@ -47,9 +47,9 @@ AnalyzePage {
             Connections {
                 target: conController
 
-                onDataChanged: {
+                onTextChanged: {
                     if (isLoaded) {
-                        // rate-limit updates to reduce CPU load
+                        // The controller already limits the rate, this defers the update while scrolled up
                         updateTimer.start();
                     }
                 }
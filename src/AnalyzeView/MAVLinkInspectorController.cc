@@ -32,6 +32,8 @@ MAVLinkInspectorController::MAVLinkInspectorController()
     connect(mavlinkProtocol, &MAVLinkProtocol::messageReceived, this, &MAVLinkInspectorController::_receiveMessage);
     connect(&_updateFrequencyTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshFrequency);
     _updateFrequencyTimer.start(1000);
+    connect(&_refreshTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshMessages);
+    _refreshTimer.start(kRefreshIntervalMSecs);
     _timeScaleSt.append(new TimeScale_st(this, tr("5 Sec"),   5 * 1000));
     _timeScaleSt.append(new TimeScale_st(this, tr("10 Sec"), 10 * 1000));
     _timeScaleSt.append(new TimeScale_st(this, tr("30 Sec"), 30 * 1000));
@@ -101,29 +103,38 @@ MAVLinkInspectorController::_setActiveVehicle(Vehicle* vehicle)
 //-----------------------------------------------------------------------------
 QGCMAVLinkSystem*
 MAVLinkInspectorController::_findVehicle(uint8_t id)
+{
+    return _systemIndex.value(id, nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkInspectorController::_refreshFrequency()
 {
     for(int i = 0; i < _systems.count(); i++) {
         QGCMAVLinkSystem* v = qobject_cast<QGCMAVLinkSystem*>(_systems.get(i));
         if(v) {
-            if(v->id() == id) {
-                return v;
+            for(int i = 0; i < v->messages()->count(); i++) {
+                QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(v->messages()->get(i));
+                if(m) {
+                    m->updateFreq();
+                }
             }
         }
     }
-    return nullptr;
 }
 
 //-----------------------------------------------------------------------------
 void
-MAVLinkInspectorController::_refreshFrequency()
+MAVLinkInspectorController::_refreshMessages()
 {
     for(int i = 0; i < _systems.count(); i++) {
         QGCMAVLinkSystem* v = qobject_cast<QGCMAVLinkSystem*>(_systems.get(i));
         if(v) {
-            for(int i = 0; i < v->messages()->count(); i++) {
-                QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(v->messages()->get(i));
+            for(int j = 0; j < v->messages()->count(); j++) {
+                QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(v->messages()->get(j));
                 if(m) {
-                    m->updateFreq();
+                    m->refresh();
                 }
             }
         }
@@ -137,23 +148,20 @@ MAVLinkInspectorController::_vehicleAdded(Vehicle* vehicle)
     QGCMAVLinkSystem* sys = _findVehicle(static_cast<uint8_t>(vehicle->id()));
     if(sys)
     {
-        sys->messages()->clearAndDeleteContents();
+        sys->clearMessages();
     }
     else
     {
         sys = new QGCMAVLinkSystem(this, static_cast<uint8_t>(vehicle->id()));
         _systems.append(sys);
+        _systemIndex.insert(sys->id(), sys);
         _systemNames.append(tr("System %1").arg(vehicle->id()));
         connect(vehicle, &Vehicle::mavlinkMsgIntervalsChanged, sys, [sys](uint8_t compid, uint16_t msgId, int32_t rate)
         {
-            for(int i = 0; i < sys->messages()->count(); i++)
+            QGCMAVLinkMessage* msg = sys->findMessage(msgId, compid);
+            if(msg)
             {
-                QGCMAVLinkMessage* msg = qobject_cast<QGCMAVLinkMessage*>(sys->messages()->get(i));
-                if((msg->compId() == compid) && (msg->id() == msgId))
-                {
-                    msg->setTargetRateHz(rate);
-                    break;
-                }
+                msg->setTargetRateHz(rate);
             }
         });
     }
@@ -168,6 +176,7 @@ MAVLinkInspectorController::_vehicleRemoved(Vehicle* vehicle)
     if(v) {
         v->deleteLater();
         _systems.removeOne(v);
+        _systemIndex.remove(v->id());
         QString vs = tr("System %1").arg(vehicle->id());
         _systemNames.removeOne(vs);
         emit systemsChanged();
@@ -183,6 +192,7 @@ MAVLinkInspectorController::_receiveMessage(LinkInterface*, mavlink_message_t me
     if(!v) {
         v = new QGCMAVLinkSystem(this, message.sysid);
         _systems.append(v);
+        _systemIndex.insert(message.sysid, v);
         _systemNames.append(tr("System %1").arg(message.sysid));
         emit systemsChanged();
         if(!_activeSystem) {
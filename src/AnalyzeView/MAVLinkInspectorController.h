@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QTimer>
@@ -93,6 +94,7 @@ private slots:
     void _vehicleRemoved    (Vehicle* vehicle);
     void _setActiveVehicle  (Vehicle* vehicle);
     void _refreshFrequency  ();
+    void _refreshMessages   ();
 
 private:
     QGCMAVLinkSystem* _findVehicle (uint8_t id);
@@ -106,10 +108,14 @@ private:
     QStringList         _rangeList;
     QGCMAVLinkSystem*   _activeSystem           = nullptr;
     QTimer              _updateFrequencyTimer;
+    QTimer              _refreshTimer;                      ///< Publishes received messages to the UI
+    QHash<quint8, QGCMAVLinkSystem*> _systemIndex;          ///< _systems by system id
     QStringList         _systemNames;
     QmlObjectListModel  _systems;                           ///< List of QGCMAVLinkSystem
     QmlObjectListModel  _charts;                            ///< List of MAVLinkCharts
     QList<TimeScale_st*>_timeScaleSt;
     QList<Range_st*>    _rangeSt;
 
+    static constexpr int kRefreshIntervalMSecs = 250;
+
 };
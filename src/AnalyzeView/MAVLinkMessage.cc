@@ -9,8 +9,11 @@
 
 #include "MAVLinkMessage.h"
 #include "MAVLinkMessageField.h"
+#include "QGC.h"
 #include "QGCLoggingCategory.h"
 
+#include <cstring>
+
 QGC_LOGGING_CATEGORY(MAVLinkMessageLog, "qgc.analyzeview.mavlinkmessage")
 
 //-----------------------------------------------------------------------------
@@ -75,9 +78,10 @@ QGCMAVLinkMessage::updateFieldSelection()
 void
 QGCMAVLinkMessage::updateFreq()
 {
-    quint64 msgCount = _count - _lastCount;
+    const quint64 currentCount = count();
+    quint64 msgCount = currentCount - _lastCount;
     _actualRateHz = (0.2 * _actualRateHz) + (0.8 * msgCount);
-    _lastCount = _count;
+    _lastCount = currentCount;
     emit actualRateHzChanged();
 }
 
@@ -86,6 +90,7 @@ void QGCMAVLinkMessage::setSelected(bool sel)
     if (_selected != sel) {
         _selected = sel;
         _updateFields();
+        _fieldsDirty = false;
         emit selectedChanged();
     }
 }
@@ -103,14 +108,75 @@ void QGCMAVLinkMessage::setTargetRateHz(int32_t rate)
 void
 QGCMAVLinkMessage::update(mavlink_message_t* message)
 {
-    _count++;
+    (void) _count.fetch_add(1, std::memory_order_relaxed);
     _message = *message;
+    _receivedMSecs = QGC::bootTimeMilliseconds();
 
-    if (_selected) {
-        // Don't update field info unless selected to reduce perf hit of message processing
-        _updateFields();
+    // The field values are only decoded from the snapshot when the UI refreshes, and only for the selected
+    // message. Charts need every sample, so only charted fields are decoded for every message.
+    _fieldsDirty = true;
+    if (_fieldSelected) {
+        _addChartSamples();
+    }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T>
+static qreal
+_readValue(const uint8_t* data)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return static_cast<qreal>(value);
+}
+
+void QGCMAVLinkMessage::_addChartSamples()
+{
+    const mavlink_message_info_t* msgInfo = mavlink_get_message_info(&_message);
+    if (!msgInfo || (_fields.count() != static_cast<int>(msgInfo->num_fields))) {
+        return;
+    }
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(&_message.payload64[0]);
+    for (unsigned int i = 0; i < msgInfo->num_fields; ++i) {
+        QGCMAVLinkMessageField* f = qobject_cast<QGCMAVLinkMessageField*>(_fields.get(static_cast<int>(i)));
+        if (!f || !f->selected()) {
+            continue;
+        }
+        // Arrays are charted by their first element
+        const uint8_t* data = m + msgInfo->fields[i].wire_offset;
+        qreal v = 0;
+        switch (msgInfo->fields[i].type) {
+            case MAVLINK_TYPE_UINT8_T:  v = _readValue<uint8_t>(data);     break;
+            case MAVLINK_TYPE_INT8_T:   v = _readValue<int8_t>(data);      break;
+            case MAVLINK_TYPE_UINT16_T: v = _readValue<uint16_t>(data);    break;
+            case MAVLINK_TYPE_INT16_T:  v = _readValue<int16_t>(data);     break;
+            case MAVLINK_TYPE_UINT32_T: v = _readValue<uint32_t>(data);    break;
+            case MAVLINK_TYPE_INT32_T:  v = _readValue<int32_t>(data);     break;
+            case MAVLINK_TYPE_FLOAT:    v = _readValue<float>(data);       break;
+            case MAVLINK_TYPE_DOUBLE:   v = _readValue<double>(data);      break;
+            case MAVLINK_TYPE_UINT64_T: v = _readValue<uint64_t>(data);    break;
+            case MAVLINK_TYPE_INT64_T:  v = _readValue<int64_t>(data);     break;
+            default:                                                        continue;
+        }
+        f->addSample(_receivedMSecs, v);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessage::refresh()
+{
+    const quint64 currentCount = count();
+    if (currentCount != _reportedCount) {
+        _reportedCount = currentCount;
+        emit countChanged();
+    }
+    if (_fieldsDirty) {
+        _fieldsDirty = false;
+        if (_selected) {
+            _updateFields();
+        }
     }
-    emit countChanged();
 }
 
 void QGCMAVLinkMessage::_updateFields(void)
@@ -139,12 +205,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                     // Enforce null termination
                     str[array_length - 1] = '\0';
                     QString v(str);
-                    f->updateValue(v, 0);
+                    f->updateValue(v);
                 } else {
                     // Single char
                     char b = *(reinterpret_cast<char*>(m + offset));
                     QString v(b);
-                    f->updateValue(v, 0);
+                    f->updateValue(v);
                 }
                 break;
             case MAVLINK_TYPE_UINT8_T:
@@ -156,11 +222,11 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint8_t u = *(m + offset);
-                    f->updateValue(QString::number(u), static_cast<qreal>(u));
+                    f->updateValue(QString::number(u));
                 }
                 break;
             case MAVLINK_TYPE_INT8_T:
@@ -172,11 +238,11 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int8_t n = *(reinterpret_cast<int8_t*>(m + offset));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_UINT16_T:
@@ -189,12 +255,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint16_t n;
                     memcpy(&n, m + offset, sizeof(uint16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_INT16_T:
@@ -207,12 +273,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int16_t n;
                     memcpy(&n, m + offset, sizeof(int16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_UINT32_T:
@@ -225,7 +291,7 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint32_t n;
@@ -233,9 +299,9 @@ void QGCMAVLinkMessage::_updateFields(void)
                     //-- Special case
                     if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
                         QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n),Qt::UTC,0);
-                        f->updateValue(d.toString("HH:mm:ss"), static_cast<qreal>(n));
+                        f->updateValue(d.toString("HH:mm:ss"));
                     } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
+                        f->updateValue(QString::number(n));
                     }
                 }
                 break;
@@ -249,12 +315,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int32_t n;
                     memcpy(&n, m + offset, sizeof(int32_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_FLOAT:
@@ -267,12 +333,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                        string += tmp.arg(static_cast<double>(nums[j]));
                     }
                     string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     float fv;
                     memcpy(&fv, m + offset, sizeof(float));
-                    f->updateValue(QString::number(static_cast<double>(fv)), static_cast<qreal>(fv));
+                    f->updateValue(QString::number(static_cast<double>(fv)));
                 }
                 break;
             case MAVLINK_TYPE_DOUBLE:
@@ -285,12 +351,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     double d;
                     memcpy(&d, m + offset, sizeof(double));
-                    f->updateValue(QString::number(d), static_cast<qreal>(d));
+                    f->updateValue(QString::number(d));
                 }
                 break;
             case MAVLINK_TYPE_UINT64_T:
@@ -303,7 +369,7 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint64_t n;
@@ -311,9 +377,9 @@ void QGCMAVLinkMessage::_updateFields(void)
                     //-- Special case
                     if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
                         QDateTime d = QDateTime::fromMSecsSinceEpoch(n/1000,Qt::UTC,0);
-                        f->updateValue(d.toString("yyyy MM dd HH:mm:ss"), static_cast<qreal>(n));
+                        f->updateValue(d.toString("yyyy MM dd HH:mm:ss"));
                     } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
+                        f->updateValue(QString::number(n));
                     }
                 }
                 break;
@@ -327,12 +393,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int64_t n;
                     memcpy(&n, m + offset, sizeof(int64_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             }
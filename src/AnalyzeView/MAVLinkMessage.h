@@ -18,6 +18,8 @@
 #include <QtCore/QLoggingCategory>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include <atomic>
+
 #include "MAVLinkLib.h"
 #include "QmlObjectListModel.h"
 
@@ -51,15 +53,19 @@ public:
     QString             name            () const { return _name;  }
     qreal               actualRateHz    () const { return _actualRateHz; }
     int32_t             targetRateHz    () const { return _targetRateHz; }
-    quint64             count           () const { return _count; }
+    quint64             count           () const { return _count.load(std::memory_order_relaxed); }
     quint64             lastCount       () const { return _lastCount; }
     QmlObjectListModel* fields          () { return &_fields; }
     bool                fieldSelected   () const { return _fieldSelected; }
     bool                selected        () const { return _selected; }
 
     void                updateFieldSelection();
+    /// Called for every received message. Only charted fields are decoded right away, everything else shown in
+    /// the UI is decoded from refresh().
     void                update          (mavlink_message_t* message);
     void                updateFreq      ();
+    /// Publishes the count and the field values received since the last refresh
+    void                refresh         ();
     void                setSelected     (bool sel);
     void                setTargetRateHz (int32_t rate);
 
@@ -72,14 +78,18 @@ signals:
 
 private:
     void _updateFields(void);
+    void _addChartSamples(void);
 
     QmlObjectListModel  _fields;
     QString             _name;
     qreal               _actualRateHz   = 0.0;
     int32_t             _targetRateHz   = 0;
-    uint64_t            _count          = 1;
+    std::atomic<quint64> _count         {1};
+    quint64             _reportedCount  = 1;
     uint64_t            _lastCount      = 0;
-    mavlink_message_t   _message;
+    mavlink_message_t   _message;                   ///< Latest message, fields are decoded from it on demand
+    quint64             _receivedMSecs  = 0;        ///< Boot time _message was received at
     bool                _fieldSelected  = false;
     bool                _selected       = false;
+    bool                _fieldsDirty    = false;    ///< Fields are behind _message
 };
@@ -36,7 +36,12 @@ QGCMAVLinkMessageField::addSeries(MAVLinkChartController* chart, QAbstractSeries
         _chart = chart;
         _pSeries = series;
         emit seriesChanged();
-        _dataIndex = 0;
+        _values.clear();
+        _head = 0;
+        _size = 0;
+        _unpublished = 0;
+        _bucketMSecs = -1;
+        setCapacity(chart->sampleCapacity());
         _msg->updateFieldSelection();
     }
 }
@@ -47,8 +52,11 @@ QGCMAVLinkMessageField::delSeries()
 {
     if(_pSeries) {
         _values.clear();
+        _head = 0;
+        _size = 0;
+        _unpublished = 0;
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(_values);
+        lineSeries->clear();
         _pSeries = nullptr;
         _chart   = nullptr;
         emit seriesChanged();
@@ -56,6 +64,46 @@ QGCMAVLinkMessageField::delSeries()
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessageField::setCapacity(int capacity)
+{
+    capacity = qMax(capacity, 1);
+    if(capacity == _values.count()) {
+        return;
+    }
+    const int keep = qMin(_size, capacity);
+    QList<QPointF> values;
+    values.reserve(capacity);
+    for(int i = _size - keep; i < _size; i++) {
+        values.append(_sample(i));
+    }
+    values.resize(capacity);
+    _values = values;
+    _head = 0;
+    _size = keep;
+    _unpublished = qMin(_unpublished, _size);
+    _bucketMSecs = -1;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessageField::_appendSample(const QPointF& sample)
+{
+    if(_values.isEmpty()) {
+        return;
+    }
+    if(_size < _values.count()) {
+        _values[(_head + _size) % _values.count()] = sample;
+        _size++;
+    } else {
+        //-- Full, the oldest sample is overwritten
+        _values[_head] = sample;
+        _head = (_head + 1) % _values.count();
+    }
+    _unpublished = qMin(_unpublished + 1, _size);
+}
+
 //-----------------------------------------------------------------------------
 QString
 QGCMAVLinkMessageField::label()
@@ -85,64 +133,151 @@ QGCMAVLinkMessageField::chartIndex()
 
 //-----------------------------------------------------------------------------
 void
-QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
+QGCMAVLinkMessageField::updateValue(QString newValue)
 {
     if(_value != newValue) {
         _value = newValue;
         emit valueChanged();
     }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessageField::addSample(quint64 time, qreal v)
+{
     if(_pSeries && _chart) {
-        int count = _values.count();
-        //-- Arbitrary limit of 1 minute of data at 50Hz for now
-        if(count < (50 * 60)) {
-            QPointF p(QGC::bootTimeMilliseconds(), v);
-            _values.append(p);
+        _appendSample(QPointF(time, v));
+    }
+}
+
+//-----------------------------------------------------------------------------
+int
+QGCMAVLinkMessageField::_firstSampleAfter(qint64 time) const
+{
+    //-- Samples are in time order
+    int low = 0;
+    int high = _size;
+    while(low < high) {
+        const int mid = (low + high) / 2;
+        if(_sample(mid).x() < time) {
+            low = mid + 1;
         } else {
-            if(_dataIndex >= count) _dataIndex = 0;
-            _values[_dataIndex].setX(QGC::bootTimeMilliseconds());
-            _values[_dataIndex].setY(v);
-            _dataIndex++;
+            high = mid;
         }
-        //-- Auto Range
-        if(_chart->rangeYIndex() == 0) {
-            qreal vmin  = std::numeric_limits<qreal>::max();
-            qreal vmax  = std::numeric_limits<qreal>::min();
-            for(int i = 0; i < _values.count(); i++) {
-                qreal v = _values[i].y();
-                if(vmax < v) vmax = v;
-                if(vmin > v) vmin = v;
-            }
-            bool changed = false;
-            if(std::abs(_rangeMin - vmin) > 0.000001) {
-                _rangeMin = vmin;
-                changed = true;
-            }
-            if(std::abs(_rangeMax - vmax) > 0.000001) {
-                _rangeMax = vmax;
-                changed = true;
-            }
-            if(changed) {
-                _chart->updateYRange();
+    }
+    return low;
+}
+
+//-----------------------------------------------------------------------------
+/// Appends the samples from begin to end to points, reduced to the min and max of each bucket when the series is
+/// decimated. The bucket which is still filling up is left for the next update.
+///     @return Number of samples consumed
+int
+QGCMAVLinkMessageField::_decimate(int begin, int end, qint64 now, QList<QPointF>& points) const
+{
+    if(_bucketMSecs <= 0) {
+        for(int i = begin; i < end; i++) {
+            points.append(_sample(i));
+        }
+        return end - begin;
+    }
+
+    const qint64 currentBucket = now / _bucketMSecs;
+    int i = begin;
+    while(i < end) {
+        const qint64 bucket = static_cast<qint64>(_sample(i).x()) / _bucketMSecs;
+        if(bucket >= currentBucket) {
+            break;
+        }
+        QPointF minSample = _sample(i);
+        QPointF maxSample = minSample;
+        int j = i + 1;
+        for(; (j < end) && (static_cast<qint64>(_sample(j).x()) / _bucketMSecs == bucket); j++) {
+            const QPointF& sample = _sample(j);
+            if(sample.y() < minSample.y()) minSample = sample;
+            if(sample.y() > maxSample.y()) maxSample = sample;
+        }
+        //-- Keep both in time order so the line goes through them
+        if(minSample.x() <= maxSample.x()) {
+            points.append(minSample);
+            if(maxSample != minSample) points.append(maxSample);
+        } else {
+            points.append(maxSample);
+            points.append(minSample);
+        }
+        i = j;
+    }
+    return i - begin;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessageField::updateSeries(qint64 windowStart, qint64 windowMSecs, int plotWidth)
+{
+    if(!_pSeries || !_chart) {
+        return;
+    }
+    QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
+    const qint64 now = windowStart + windowMSecs;
+    const int first = _firstSampleAfter(windowStart);
+
+    //-- Two points per pixel column are all the plot can show
+    const int windowSamples = _size - first;
+    const qint64 bucketMSecs = ((plotWidth > 0) && (windowSamples > 2 * plotWidth)) ? qMax<qint64>(1, windowMSecs / plotWidth) : 0;
+
+    if(bucketMSecs != _bucketMSecs) {
+        _bucketMSecs = bucketMSecs;
+        QList<QPointF> points;
+        points.reserve(_bucketMSecs ? 2 * plotWidth : windowSamples);
+        const int published = _decimate(first, _size, now, points);
+        lineSeries->replace(points);
+        _unpublished = _size - first - published;
+    } else {
+        //-- Drop what scrolled out of the window and append what came in
+        const int seriesCount = lineSeries->count();
+        int expired = 0;
+        while((expired < seriesCount) && (lineSeries->at(expired).x() < windowStart)) {
+            expired++;
+        }
+        if(expired) {
+            lineSeries->removePoints(0, expired);
+        }
+        if(_unpublished) {
+            QList<QPointF> points;
+            _unpublished -= _decimate(_size - _unpublished, _size, now, points);
+            if(!points.isEmpty()) {
+                lineSeries->append(points);
             }
         }
     }
+
+    _updateRange(first);
 }
 
 //-----------------------------------------------------------------------------
 void
-QGCMAVLinkMessageField::updateSeries()
+QGCMAVLinkMessageField::_updateRange(int first)
 {
-    int count = _values.count();
-    if (count > 1) {
-        QList<QPointF> s;
-        s.reserve(count);
-        int idx = _dataIndex;
-        for(int i = 0; i < count; i++, idx++) {
-            if(idx >= count) idx = 0;
-            QPointF p(_values[idx]);
-            s.append(p);
+    //-- Auto Range
+    if(_chart->rangeYIndex() == 0 && first < _size) {
+        qreal vmin  = std::numeric_limits<qreal>::max();
+        qreal vmax  = std::numeric_limits<qreal>::lowest();
+        for(int i = first; i < _size; i++) {
+            const qreal v = _sample(i).y();
+            if(vmax < v) vmax = v;
+            if(vmin > v) vmin = v;
+        }
+        bool changed = false;
+        if(std::abs(_rangeMin - vmin) > 0.000001) {
+            _rangeMin = vmin;
+            changed = true;
+        }
+        if(std::abs(_rangeMax - vmax) > 0.000001) {
+            _rangeMax = vmax;
+            changed = true;
+        }
+        if(changed) {
+            _chart->updateYRange();
         }
-        QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(s);
     }
 }
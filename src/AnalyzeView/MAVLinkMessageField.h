@@ -51,17 +51,24 @@ public:
     bool            selectable      () const{ return _selectable; }
     bool            selected        () { return _pSeries != nullptr; }
     QAbstractSeries*series          () { return _pSeries; }
-    QList<QPointF>* values          () { return &_values;}
     qreal           rangeMin        () const{ return _rangeMin; }
     qreal           rangeMax        () const{ return _rangeMax; }
     int             chartIndex      ();
 
     void            setSelectable   (bool sel);
-    void            updateValue     (QString newValue, qreal v);
+    void            updateValue     (QString newValue);
+    /// Adds a sample to the chart if the field is charted
+    void            addSample       (quint64 time, qreal v);
 
     void            addSeries       (MAVLinkChartController* chart, QAbstractSeries* series);
     void            delSeries       ();
-    void            updateSeries    ();
+    /// Sets the number of samples kept. The newest samples are kept when the buffer shrinks.
+    void            setCapacity     (int capacity);
+    /// Brings the series up to date with the samples received since the last update
+    ///     @param windowStart Oldest time shown by the chart, in boot milliseconds
+    ///     @param windowMSecs Time span shown by the chart
+    ///     @param plotWidth Width of the plot area in pixels
+    void            updateSeries    (qint64 windowStart, qint64 windowMSecs, int plotWidth);
 
 signals:
     void            seriesChanged       ();
@@ -69,16 +76,25 @@ signals:
     void            valueChanged        ();
 
 private:
+    const QPointF&  _sample         (int index) const { return _values[(_head + index) % _values.count()]; }
+    void            _appendSample   (const QPointF& sample);
+    int             _firstSampleAfter(qint64 time) const;
+    int             _decimate       (int begin, int end, qint64 now, QList<QPointF>& points) const;
+    void            _updateRange    (int first);
+
     QString     _type;
     QString     _name;
     QString     _value;
     bool        _selectable = true;
-    int         _dataIndex  = 0;
+    int         _head       = 0;            ///< Index of the oldest sample in _values
+    int         _size       = 0;            ///< Number of samples in _values
+    int         _unpublished = 0;           ///< Newest samples which are not in the series yet
+    qint64      _bucketMSecs = -1;          ///< Time of a min/max pair in the series, 0 for raw samples, -1 before the series is built
     qreal       _rangeMin   = 0;
     qreal       _rangeMax   = 0;
 
     QAbstractSeries*    _pSeries = nullptr;
     QGCMAVLinkMessage*  _msg     = nullptr;
     MAVLinkChartController*      _chart   = nullptr;
-    QList<QPointF>      _values;
+    QList<QPointF>      _values;                ///< Ring buffer of samples, sized by the time scale of the chart
 };
@@ -24,22 +24,15 @@ QGCMAVLinkSystem::QGCMAVLinkSystem(QObject* parent, quint8 id)
 //-----------------------------------------------------------------------------
 QGCMAVLinkSystem::~QGCMAVLinkSystem()
 {
-    _messages.clearAndDeleteContents();
+    clearMessages();
 }
 
 //-----------------------------------------------------------------------------
-QGCMAVLinkMessage*
-QGCMAVLinkSystem::findMessage(uint32_t id, uint8_t compId)
+void
+QGCMAVLinkSystem::clearMessages()
 {
-    for(int i = 0; i < _messages.count(); i++) {
-        QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(_messages.get(i));
-        if(m) {
-            if(m->id() == id && m->compId() == compId) {
-                return m;
-            }
-        }
-    }
-    return nullptr;
+    _messageIndex.clear();
+    _messages.clearAndDeleteContents();
 }
 
 //-----------------------------------------------------------------------------
@@ -118,6 +111,7 @@ QGCMAVLinkSystem::append(QGCMAVLinkMessage* message)
         message->setSelected(true);
     }
     _messages.append(message);
+    _messageIndex.insert(_messageKey(message->id(), message->compId()), message);
     //-- Sort messages by id and then compId
     if (_messages.count() > 0) {
         _messages.beginReset();
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
 #include <QtCore/QLoggingCategory>
@@ -48,10 +49,12 @@ public:
     int                 selected        () const{ return _selected; }
 
     void                setSelected     (int sel);
-    QGCMAVLinkMessage*  findMessage     (uint32_t id, uint8_t compId);
+    /// Constant time lookup, called for every received message
+    QGCMAVLinkMessage*  findMessage     (uint32_t id, uint8_t compId) const { return _messageIndex.value(_messageKey(id, compId), nullptr); }
     int                 findMessage     (QGCMAVLinkMessage* message);
     void                append          (QGCMAVLinkMessage* message);
     QGCMAVLinkMessage*  selectedMsg     ();
+    void                clearMessages   ();
 
 signals:
     void compIDsChanged                 ();
@@ -61,10 +64,14 @@ private:
     void _checkCompID                   (QGCMAVLinkMessage *message);
     void _resetSelection                ();
 
+    /// Message ids have 24 bits
+    static quint32 _messageKey          (uint32_t id, uint8_t compId) { return (static_cast<quint32>(compId) << 24) | (id & 0xffffff); }
+
 private:
     quint8              _id;
     QList<int>          _compIDs;
     QStringList         _compIDsStr;
     QmlObjectListModel  _messages;      //-- List of QGCMAVLinkMessage
+    QHash<quint32, QGCMAVLinkMessage*> _messageIndex;   ///< _messages by _messageKey
     int                 _selected = 0;
 };
@@ -12,6 +12,8 @@
 
 #include <QtCore/QtEndian>
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(PX4LogParserLog, "qgc.analyzeview.px4logparser")
 
 // general message header
@@ -33,6 +35,76 @@ static constexpr const char triggerHeader[4] = {static_cast<char>(0xA3), static_
 static constexpr const int triggerOffsets[2] = {3, 11};
 static constexpr const int triggerLengths[2] = {8, 4};
 
+// header for GPS message header and GPS message, which starts with the UTC time of the fix in microseconds
+static constexpr const char gpsHeaderHeader[5] = {static_cast<char>(0xA3), static_cast<char>(0x95), static_cast<char>(0x80), static_cast<char>(0x08), static_cast<char>(0x00)};
+static constexpr const char gpsHeader[4] = {static_cast<char>(0xA3), static_cast<char>(0x95), static_cast<char>(0x08), static_cast<char>(0x00)};
+
+// header for TIME message header and TIME message, which holds the boot time of each logging cycle in microseconds
+static constexpr const char timeHeaderHeader[5] = {static_cast<char>(0xA3), static_cast<char>(0x95), static_cast<char>(0x80), static_cast<char>(0x81), static_cast<char>(0x00)};
+static constexpr const char timeHeader[4] = {static_cast<char>(0xA3), static_cast<char>(0x95), static_cast<char>(0x81), static_cast<char>(0x00)};
+
+static constexpr const int timeOffset = 3;
+static constexpr const int timeLength = 8;
+
+/// @return Length of a message from its format message, -1 if the log has no such messages
+static int messageLength(const QByteArray& log, const char* formatHeader)
+{
+    const int formatIndex = log.indexOf(formatHeader);
+    if ((formatIndex < 0) || ((formatIndex + 4) >= log.length())) {
+        return -1;
+    }
+    return static_cast<int>(static_cast<uint8_t>(log.at(formatIndex + 4)));
+}
+
+/// @return Offset from boot time to UTC in seconds at each GPS message with a fix time, paired with the log position
+/// of the message. The boot time is taken from the TIME message of the logging cycle the GPS message is in.
+static QList<QPair<int, double>> utcOffsets(const QByteArray& log)
+{
+    QList<QPair<int, double>> offsets;
+
+    const int gpsMessageLength = messageLength(log, gpsHeaderHeader);
+    const int timeMessageLength = messageLength(log, timeHeaderHeader);
+    if ((gpsMessageLength < (timeOffset + timeLength)) || (timeMessageLength < (timeOffset + timeLength))) {
+        return offsets;
+    }
+
+    // Verify that the next log message starts right after the message, as for triggers and positions
+    auto readTime = [&log](int index, int messageLength, uint64_t& time) {
+        if (log.indexOf(header, index + 1) != (index + messageLength)) {
+            return false;
+        }
+        time = qFromLittleEndian<uint64_t>(log.constData() + index + timeOffset);
+        return true;
+    };
+
+    double bootTime = -1;
+    int index = 0;
+    while (index < log.length()) {
+        const int timeIndex = log.indexOf(timeHeader, index);
+        const int gpsIndex = log.indexOf(gpsHeader, index);
+        if ((timeIndex < 0) && (gpsIndex < 0)) {
+            break;
+        }
+
+        uint64_t time = 0;
+        if ((gpsIndex < 0) || ((timeIndex >= 0) && (timeIndex < gpsIndex))) {
+            if (readTime(timeIndex, timeMessageLength, time)) {
+                bootTime = static_cast<double>(time) / 1.0e6;
+            }
+            index = timeIndex + 1;
+        } else {
+            if ((bootTime >= 0) && readTime(gpsIndex, gpsMessageLength, time) && (time > 0)) {
+                offsets.append(qMakePair(gpsIndex, (static_cast<double>(time) / 1.0e6) - bootTime));
+            }
+            index = gpsIndex + 1;
+        }
+    }
+
+    qCDebug(PX4LogParserLog) << "UTC offsets found:" << offsets.count();
+
+    return offsets;
+}
+
 namespace PX4LogParser {
 
 bool getTagsFromLog(const QByteArray& log, QList<GeoTagWorker::cameraFeedbackPacket>& cameraFeedback)
@@ -44,6 +116,21 @@ bool getTagsFromLog(const QByteArray& log, QList<GeoTagWorker::cameraFeedbackPac
     iptr = reinterpret_cast<const uint8_t*>(log.mid(log.indexOf(triggerHeaderHeader) + 4, 1).constData());
     const int triggerHeaderOffset = static_cast<int>(qFromLittleEndian(*iptr));
 
+    // Triggers are logged in boot time, their UTC time is taken from the GPS fix logged closest before them
+    const QList<QPair<int, double>> offsets = utcOffsets(log);
+    auto timestampUTC = [&offsets](int triggerIndex, double timestamp) {
+        if (offsets.isEmpty()) {
+            return 0.0;
+        }
+        auto it = std::upper_bound(offsets.cbegin(), offsets.cend(), triggerIndex, [](int value, const QPair<int, double>& offset) {
+            return value < offset.first;
+        });
+        if (it != offsets.cbegin()) {
+            it--;
+        }
+        return timestamp + it->second;
+    };
+
     // extract trigger data
     int index = 1;
     int sequence = -1;
@@ -73,6 +160,7 @@ bool getTagsFromLog(const QByteArray& log, QList<GeoTagWorker::cameraFeedbackPac
         }
 
         feedback.timestamp = timeDouble;
+        feedback.timestampUTC = timestampUTC(index, timeDouble);
         feedback.imageSequence = seqInt;
         sequence = seqInt;
 
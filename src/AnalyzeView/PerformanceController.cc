@@ -0,0 +1,251 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "PerformanceController.h"
+#include "QGCApplication.h"
+#include "QGCToolbox.h"
+#include "QGCCorePlugin.h"
+#include "QGCPerfCounter.h"
+#include "QGCStartupScheduler.h"
+#include "LinkManager.h"
+#include "MAVLinkProtocol.h"
+#include "MultiVehicleManager.h"
+#include "QmlObjectListModel.h"
+#include "TerrainTileManager.h"
+#include "Vehicle.h"
+#include "VideoManager.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QFile>
+
+#include <utility>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+#include <unistd.h>
+#elif defined(Q_OS_MACOS)
+#include <sys/resource.h>
+#endif
+
+QGC_LOGGING_CATEGORY(PerformanceControllerLog, "qgc.analyzeview.performancecontroller")
+
+PerformanceController::PerformanceController(QObject* parent)
+    : QObject(parent)
+{
+    // The lag timer fires late by however long the event loop was busy with something else
+    _lagTimer.setTimerType(Qt::PreciseTimer);
+    _lagTimer.setInterval(_lagIntervalMSecs);
+    (void) connect(&_lagTimer, &QTimer::timeout, this, &PerformanceController::_lagTimeout);
+    _lagTimer.start();
+    _lagClock.start();
+
+    _sampleTimer.setInterval(sampleIntervalMSecs);
+    (void) connect(&_sampleTimer, &QTimer::timeout, this, &PerformanceController::_sample);
+    _sampleTimer.start();
+    _sampleClock.start();
+
+    _sample();
+}
+
+void PerformanceController::_lagTimeout(void)
+{
+    const qint64 lagNSecs = qMax<qint64>(0, _lagClock.nsecsElapsed() - (static_cast<qint64>(_lagIntervalMSecs) * 1000000));
+    _lagClock.restart();
+
+    _lagSumNSecs += lagNSecs;
+    _lagMaxNSecs = qMax(_lagMaxNSecs, lagNSecs);
+    _lagCount++;
+}
+
+void PerformanceController::_addValue(QVariantList& values, const QString& group, const QString& name, double value, const QString& unit)
+{
+    values.append(QVariantMap {
+        { QStringLiteral("group"),  group },
+        { QStringLiteral("name"),   name },
+        { QStringLiteral("value"),  value },
+        { QStringLiteral("unit"),   unit },
+    });
+}
+
+/// @return Per second rate of a running total since the last sample, 0 the first time the source is seen
+double PerformanceController::_rate(const void* source, quint64 total, double elapsedSecs)
+{
+    _currentTotals[source] = total;
+
+    const auto it = _previousTotals.constFind(source);
+    if ((it == _previousTotals.constEnd()) || (total < it.value()) || (elapsedSecs <= 0)) {
+        return 0;
+    }
+    return (total - it.value()) / elapsedSecs;
+}
+
+void PerformanceController::_sample(void)
+{
+    const double elapsedSecs = _sampleClock.restart() / 1000.0;
+    QVariantList values;
+
+    const QString eventLoopGroup = tr("Event Loop");
+    _eventLoopLag = _lagMaxNSecs / 1e6;
+    _addValue(values, eventLoopGroup, tr("Lag average"), (_lagCount > 0) ? ((_lagSumNSecs / _lagCount) / 1e6) : 0, tr("ms"));
+    _addValue(values, eventLoopGroup, tr("Lag max"), _eventLoopLag, tr("ms"));
+    _lagSumNSecs = 0;
+    _lagMaxNSecs = 0;
+    _lagCount = 0;
+
+    _addLinkValues(values, elapsedSecs);
+    _addVehicleValues(values, elapsedSecs);
+    _addSubsystemValues(values);
+    _addCounterValues(values, elapsedSecs);
+    _addStartupValues(values);
+    qgcApp()->toolbox()->corePlugin()->performanceValues(values);
+
+    // Sources which went away are dropped with the previous totals
+    _previousTotals = std::exchange(_currentTotals, {});
+
+    _groups = _groupValues(values);
+    emit groupsChanged();
+}
+
+void PerformanceController::_addLinkValues(QVariantList& values, double elapsedSecs)
+{
+    const MAVLinkProtocol* const mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+    const QString group = tr("Links (messages/s)");
+
+    for (const SharedLinkInterfacePtr& link: qgcApp()->toolbox()->linkManager()->links()) {
+        if (!link->mavlinkChannelIsSet()) {
+            continue;
+        }
+        const double rate = _rate(link.get(), mavlinkProtocol->receivedMessageCount(link->mavlinkChannel()), elapsedSecs);
+        _addValue(values, group, link->linkConfiguration()->name(), rate, QString());
+    }
+}
+
+void PerformanceController::_addVehicleValues(QVariantList& values, double elapsedSecs)
+{
+    QmlObjectListModel* const vehicles = qgcApp()->toolbox()->multiVehicleManager()->vehicles();
+
+    for (int i=0; i<vehicles->count(); i++) {
+        const Vehicle* const vehicle = vehicles->value<Vehicle*>(i);
+        const QString group = tr("Vehicle %1 (messages/s)").arg(vehicle->id());
+
+        _addValue(values, group, tr("Received"), _rate(vehicle, vehicle->messagesReceived(), elapsedSecs), QString());
+        for (auto it = vehicle->factGroups().constBegin(); it != vehicle->factGroups().constEnd(); it++) {
+            const double rate = _rate(it.value(), it.value()->handledMessageCount(), elapsedSecs);
+            if (rate > 0) {
+                _addValue(values, group, tr("FactGroup %1").arg(it.key()), rate, QString());
+            }
+        }
+    }
+}
+
+void PerformanceController::_addSubsystemValues(QVariantList& values)
+{
+    const QString memoryGroup = tr("Memory");
+    const qint64 residentBytes = _residentBytes();
+    if (residentBytes >= 0) {
+        _addValue(values, memoryGroup, tr("Process"), residentBytes / (1024.0 * 1024.0), tr("MB"));
+    }
+
+    const TerrainTileManager::CacheStats_t terrainStats = TerrainTileManager::instance()->cacheStats();
+    const quint64 terrainLookups = terrainStats.hits + terrainStats.misses;
+    _addValue(values, memoryGroup, tr("Terrain tiles"), terrainStats.memoryBytes / (1024.0 * 1024.0), tr("MB"));
+    _addValue(values, tr("Terrain"), tr("Cache hit ratio"), (terrainLookups > 0) ? ((100.0 * terrainStats.hits) / terrainLookups) : 0, QStringLiteral("%"));
+
+    const QString signalGroup = tr("Coalesced signals (total)");
+    const QMap<QString, quint64> signalCounts = qgcApp()->compressedSignalCounts();
+    for (auto it = signalCounts.constBegin(); it != signalCounts.constEnd(); it++) {
+        _addValue(values, signalGroup, it.key(), it.value(), QString());
+    }
+
+    const VideoManager* const videoManager = qgcApp()->toolbox()->videoManager();
+    if (videoManager->hasVideo()) {
+        const QString videoGroup = tr("Video");
+        _addValue(values, videoGroup, tr("Decode time"), videoManager->videoDecodeTime(), tr("ms"));
+        _addValue(values, videoGroup, tr("Frame age"), videoManager->videoFrameAge(), tr("ms"));
+        _addValue(values, videoGroup, tr("Jitter"), videoManager->videoJitter(), tr("ms"));
+        _addValue(values, videoGroup, tr("Dropped frames"), videoManager->videoDroppedFrames(), QString());
+    }
+}
+
+void PerformanceController::_addCounterValues(QVariantList& values, double elapsedSecs)
+{
+    for (const QGCPerfCounter* counter: QGCPerfCounter::counters()) {
+        const QString group = QString::fromUtf8(counter->group());
+        const QString name = QString::fromUtf8(counter->name());
+
+        switch (counter->type()) {
+        case QGCPerfCounter::Count:
+            _addValue(values, group, name, _rate(counter, static_cast<quint64>(counter->value()), elapsedSecs), tr("/s"));
+            break;
+        case QGCPerfCounter::Gauge:
+            _addValue(values, group, name, counter->value(), QString());
+            break;
+        case QGCPerfCounter::Bytes:
+            _addValue(values, group, name, counter->value() / (1024.0 * 1024.0), tr("MB"));
+            break;
+        case QGCPerfCounter::Percent:
+            _addValue(values, group, name, counter->value(), QStringLiteral("%"));
+            break;
+        }
+    }
+}
+
+void PerformanceController::_addStartupValues(QVariantList& values)
+{
+    const QString group = tr("Startup");
+
+    for (const QGCStartupScheduler::Step_t& step: qgcApp()->startupScheduler()->timeline()) {
+        const QString name = QString::fromUtf8(step.name);
+        _addValue(values, group, step.deferred ? tr("%1 (deferred)").arg(name) : name, step.durationMSecs, tr("ms"));
+    }
+}
+
+/// Collects the values into groups, in the order the groups first appear
+QVariantList PerformanceController::_groupValues(const QVariantList& values)
+{
+    QStringList groupNames;
+    QHash<QString, QVariantList> groupValues;
+
+    for (const QVariant& value: values) {
+        const QString groupName = value.toMap()[QStringLiteral("group")].toString();
+        if (!groupValues.contains(groupName)) {
+            groupNames.append(groupName);
+        }
+        groupValues[groupName].append(value);
+    }
+
+    QVariantList groups;
+    for (const QString& groupName: groupNames) {
+        groups.append(QVariantMap {
+            { QStringLiteral("name"),   groupName },
+            { QStringLiteral("values"), groupValues[groupName] },
+        });
+    }
+    return groups;
+}
+
+/// @return Current resident set size of the process, -1 if not available on this platform
+qint64 PerformanceController::_residentBytes(void)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.count() > 1) {
+            return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#elif defined(Q_OS_MACOS)
+    // Peak rather than current, reported in bytes on macOS
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return static_cast<qint64>(usage.ru_maxrss);
+    }
+#endif
+    return -1;
+}
@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVariantList>
+#include <QtQmlIntegration/QtQmlIntegration>
+
+Q_DECLARE_LOGGING_CATEGORY(PerformanceControllerLog)
+
+/// Runtime diagnostics for the Performance analyze page. Once a second it samples GUI event loop lag, message rates
+/// per link, vehicle and FactGroup, the subsystem figures which are already tracked elsewhere (terrain cache, video
+/// latency), the startup timeline and all QGCPerfCounters. Custom builds can add values through
+/// QGCCorePlugin::performanceValues.
+class PerformanceController : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+public:
+    PerformanceController(QObject* parent = nullptr);
+
+    /// List of groups, each a map with "name" and "values". Every value is a map with "name", "value" and "unit".
+    Q_PROPERTY(QVariantList groups          READ groups         NOTIFY groupsChanged)
+    Q_PROPERTY(double       eventLoopLag    READ eventLoopLag   NOTIFY groupsChanged)   ///< Worst lag over the last sample in msecs
+
+    QVariantList    groups      (void) const { return _groups; }
+    double          eventLoopLag(void) const { return _eventLoopLag; }
+
+    static constexpr int sampleIntervalMSecs = 1000;
+
+signals:
+    void groupsChanged(void);
+
+private slots:
+    void _lagTimeout(void);
+    void _sample    (void);
+
+private:
+    void    _addValue       (QVariantList& values, const QString& group, const QString& name, double value, const QString& unit);
+    double  _rate           (const void* source, quint64 total, double elapsedSecs);
+    void    _addLinkValues  (QVariantList& values, double elapsedSecs);
+    void    _addVehicleValues(QVariantList& values, double elapsedSecs);
+    void    _addSubsystemValues(QVariantList& values);
+    void    _addCounterValues(QVariantList& values, double elapsedSecs);
+    void    _addStartupValues(QVariantList& values);
+
+    static QVariantList _groupValues    (const QVariantList& values);
+    static qint64       _residentBytes  (void);
+
+    QTimer          _lagTimer;
+    QElapsedTimer   _lagClock;
+    qint64          _lagSumNSecs    = 0;
+    qint64          _lagMaxNSecs    = 0;
+    int             _lagCount       = 0;
+
+    QTimer          _sampleTimer;
+    QElapsedTimer   _sampleClock;
+    QHash<const void*, quint64> _previousTotals;    ///< Totals at the last sample, keyed by the object counting
+    QHash<const void*, quint64> _currentTotals;
+
+    QVariantList    _groups;
+    double          _eventLoopLag   = 0;
+
+    static constexpr int _lagIntervalMSecs = 50;
+};
@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+
+import QGroundControl
+import QGroundControl.Palette
+import QGroundControl.Controls
+import QGroundControl.ScreenTools
+import QGroundControl.Controllers
+
+AnalyzePage {
+    id:                 performancePage
+    pageComponent:      pageComponent
+    pageDescription:    qsTr("Runtime performance of QGroundControl. Values are updated once a second.")
+    allowPopout:        true
+
+    property real _spacing:         ScreenTools.defaultFontPixelWidth
+    property real _valueWidth:      ScreenTools.defaultFontPixelWidth * 12
+
+    PerformanceController { id: controller }
+
+    Component {
+        id: pageComponent
+
+        Flow {
+            width:      availableWidth
+            spacing:    _spacing * 2
+
+            Repeater {
+                model: controller.groups
+
+                ColumnLayout {
+                    spacing: _spacing / 2
+
+                    QGCLabel {
+                        text:           modelData.name
+                        font.bold:      true
+                    }
+
+                    GridLayout {
+                        id:             valueGrid
+                        rows:           _values.length
+                        flow:           GridLayout.TopToBottom
+                        columnSpacing:  _spacing
+                        rowSpacing:     0
+
+                        property var _values: modelData.values
+
+                        Repeater {
+                            model: valueGrid._values
+
+                            QGCLabel { text: modelData.name }
+                        }
+
+                        Repeater {
+                            model: valueGrid._values
+
+                            QGCLabel {
+                                text:                   modelData.value.toFixed(1) + (modelData.unit === "" ? "" : " " + modelData.unit)
+                                horizontalAlignment:    Text.AlignRight
+                                Layout.minimumWidth:    _valueWidth
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
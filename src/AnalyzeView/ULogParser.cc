@@ -11,6 +11,7 @@
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QByteArray>
+#include <QtCore/QFile>
 #include <QtCore/QString>
 
 #include <ulog_cpp/data_container.hpp>
@@ -20,58 +21,86 @@ using namespace ulog_cpp;
 
 QGC_LOGGING_CATEGORY(ULogParserLog, "qgc.analyzeview.ulogparser")
 
-namespace ULogParser {
+namespace {
 
-bool getTagsFromLog(const QByteArray &log, QList<GeoTagWorker::cameraFeedbackPacket> &cameraFeedback, QString &errorMessage)
+constexpr qint64 kChunkSize = 1024 * 1024;
+
+/// Keeps the log header and turns camera_capture samples into feedback packets while the log is parsed. All other
+/// message data is dropped.
+class CameraCaptureHandler : public DataContainer
 {
-    errorMessage.clear();
+public:
+    explicit CameraCaptureHandler(QList<GeoTagWorker::cameraFeedbackPacket> &cameraFeedback)
+        : DataContainer(DataContainer::StorageConfig::Header)
+        , _cameraFeedback(cameraFeedback)
+    {
 
-    std::shared_ptr<DataContainer> data = std::make_shared<DataContainer>(DataContainer::StorageConfig::FullLog);
-    Reader parser(data);
-    parser.readChunk(reinterpret_cast<const uint8_t*>(log.constData()), log.size());
+    }
 
-    if (!data->parsingErrors().empty()) {
-        for (const std::string &parsing_error : data->parsingErrors()) {
+    void addLoggedMessage(const AddLoggedMessage &addLoggedMessage) override
+    {
+        DataContainer::addLoggedMessage(addLoggedMessage);
+
+        if (addLoggedMessage.messageName() == "camera_capture") {
+            const auto format = messageFormats().find(addLoggedMessage.messageName());
+            if (format != messageFormats().end()) {
+                _captureFormats[addLoggedMessage.msgId()] = format->second;
+            }
+        }
+    }
+
+    void data(const Data &data) override
+    {
+        const auto format = _captureFormats.find(data.msgId());
+        if (format == _captureFormats.end()) {
+            return;
+        }
+
+        const TypedDataView sample(data, *format->second);
+        GeoTagWorker::cameraFeedbackPacket feedback = {0};
+
+        try {
+            feedback.timestamp = sample.at("timestamp").as<uint64_t>() / 1.0e6; // to seconds
+            feedback.timestampUTC = sample.at("timestamp_utc").as<uint64_t>() / 1.0e6; // to seconds
+            feedback.imageSequence = sample.at("seq").as<uint32_t>();
+            feedback.latitude = sample.at("lat").as<double>();
+            feedback.longitude = sample.at("lon").as<double>();
+            feedback.longitude = fmod(180.0 + feedback.longitude, 360.0) - 180.0;
+            feedback.altitude = sample.at("alt").as<float>();
+            feedback.groundDistance = sample.at("ground_distance").as<float>();
+            // feedback.attitude = sample.at("q");
+            feedback.captureResult = sample.at("result").as<uint8_t>();
+
+            (void) _cameraFeedback.append(feedback);
+        } catch (const AccessException &exception) {
+            qCDebug(ULogParserLog) << Q_FUNC_INFO << exception.what();
+        }
+    }
+
+private:
+    QList<GeoTagWorker::cameraFeedbackPacket> &_cameraFeedback;
+    std::map<uint16_t, std::shared_ptr<MessageFormat>> _captureFormats;  ///< camera_capture formats by message id
+};
+
+bool checkParseResult(const CameraCaptureHandler &handler, const QList<GeoTagWorker::cameraFeedbackPacket> &cameraFeedback, QString &errorMessage)
+{
+    if (!handler.parsingErrors().empty()) {
+        for (const std::string &parsing_error : handler.parsingErrors()) {
             (void) errorMessage.append(parsing_error);
             (void) errorMessage.append(", ");
         }
     }
 
-    if (data->hadFatalError()) {
+    if (handler.hadFatalError()) {
         errorMessage = QStringLiteral("Could not parse ULog");
         return false;
     }
 
-    if (!data->isHeaderComplete()) {
+    if (!handler.isHeaderComplete()) {
         errorMessage = QStringLiteral("Could not parse ULog header");
         return false;
     }
 
-    const std::set<std::string> subscription_names = data->subscriptionNames();
-    if (subscription_names.find("camera_capture") != subscription_names.end()) {
-        const std::shared_ptr<Subscription> subscription = data->subscription("camera_capture");
-        for (const TypedDataView &sample : *subscription) {
-            GeoTagWorker::cameraFeedbackPacket feedback = {0};
-
-            try {
-                feedback.timestamp = sample.at("timestamp").as<uint64_t>() / 1.0e6; // to seconds
-                feedback.timestampUTC = sample.at("timestamp_utc").as<uint64_t>() / 1.0e6; // to seconds
-                feedback.imageSequence = sample.at("seq").as<uint32_t>();
-                feedback.latitude = sample.at("lat").as<double>();
-                feedback.longitude = sample.at("lon").as<double>();
-                feedback.longitude = fmod(180.0 + feedback.longitude, 360.0) - 180.0;
-                feedback.altitude = sample.at("alt").as<float>();
-                feedback.groundDistance = sample.at("ground_distance").as<float>();
-                // feedback.attitude = sample.at("q");
-                feedback.captureResult = sample.at("result").as<uint8_t>();
-
-                (void) cameraFeedback.append(feedback);
-            } catch (const AccessException &exception) {
-                qCDebug(ULogParserLog) << Q_FUNC_INFO << exception.what();
-            }
-        }
-    }
-
     if (cameraFeedback.isEmpty()) {
         errorMessage = QStringLiteral("Could not detect camera_capture packets in ULog");
         return false;
@@ -80,4 +109,45 @@ bool getTagsFromLog(const QByteArray &log, QList<GeoTagWorker::cameraFeedbackPac
     return true;
 }
 
+} // namespace
+
+namespace ULogParser {
+
+bool getTagsFromLog(const QByteArray &log, QList<GeoTagWorker::cameraFeedbackPacket> &cameraFeedback, QString &errorMessage)
+{
+    errorMessage.clear();
+
+    std::shared_ptr<CameraCaptureHandler> handler = std::make_shared<CameraCaptureHandler>(cameraFeedback);
+    Reader parser(handler);
+    parser.readChunk(reinterpret_cast<const uint8_t*>(log.constData()), log.size());
+
+    return checkParseResult(*handler, cameraFeedback, errorMessage);
+}
+
+bool getTagsFromLogFile(const QString &fileName, QList<GeoTagWorker::cameraFeedbackPacket> &cameraFeedback, QString &errorMessage)
+{
+    errorMessage.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    std::shared_ptr<CameraCaptureHandler> handler = std::make_shared<CameraCaptureHandler>(cameraFeedback);
+    Reader parser(handler);
+
+    QByteArray chunk(kChunkSize, Qt::Uninitialized);
+    while (!file.atEnd() && !handler->hadFatalError()) {
+        const qint64 bytesRead = file.read(chunk.data(), chunk.size());
+        if (bytesRead <= 0) {
+            break;
+        }
+        parser.readChunk(reinterpret_cast<const uint8_t*>(chunk.constData()), static_cast<int>(bytesRead));
+    }
+    file.close();
+
+    return checkParseResult(*handler, cameraFeedback, errorMessage);
+}
+
 } // namespace ULogParser
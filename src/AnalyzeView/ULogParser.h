@@ -23,4 +23,9 @@ namespace ULogParser {
     /// Get GeoTags from a ULog
     ///     @return true if failed, errorMessage set
     bool getTagsFromLog(const QByteArray &log, QList<GeoTagWorker::cameraFeedbackPacket> &cameraFeedback, QString &errorMessage);
+
+    /// Get GeoTags from a ULog file. The file is parsed in chunks and only the camera_capture samples are kept, so
+    /// the memory use does not depend on the size of the log.
+    ///     @return true if failed, errorMessage set
+    bool getTagsFromLogFile(const QString &fileName, QList<GeoTagWorker::cameraFeedbackPacket> &cameraFeedback, QString &errorMessage);
 } // namespace ULogParser
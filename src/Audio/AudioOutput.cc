@@ -42,12 +42,53 @@ const QHash<QString, QString> AudioOutput::_textHash = {
 
 Q_APPLICATION_STATIC(AudioOutput, _audioOutput);
 
+namespace {
+
+/// Patterns used for every text read, compiled once up front
+struct AudioTextPatterns
+{
+    AudioTextPatterns()
+    {
+        milliseconds.optimize();
+        negativeNumber.optimize();
+        realNumber.optimize();
+        realNumberMeter.optimize();
+    }
+
+    const QRegularExpression milliseconds{QStringLiteral("([0-9]+)ms")};
+    const QRegularExpression negativeNumber{QStringLiteral("(-)[0-9]*\\.?[0-9]")};
+    const QRegularExpression realNumber{QStringLiteral("([0-9]+)(\\.)([0-9]+)")};
+    const QRegularExpression realNumberMeter{QStringLiteral("[0-9]*\\.?[0-9]\\s?(m)([^A-Za-z]|$)")};
+};
+
+Q_GLOBAL_STATIC(AudioTextPatterns, _audioTextPatterns);
+
+/// Replaces the captured group of every match of the pattern. Matching continues after the inserted text, which
+/// never forms a new match itself.
+void _replaceCaptured(QString &result, const QRegularExpression &regex, int group, const QString &replacement)
+{
+    qsizetype offset = 0;
+    QRegularExpressionMatch match = regex.match(result, offset);
+    while (match.hasMatch()) {
+        if (match.captured(group).isNull()) {
+            break;
+        }
+        (void) result.replace(match.capturedStart(group), match.capturedLength(group), replacement);
+        offset = match.capturedStart(group) + replacement.length();
+        match = regex.match(result, offset);
+    }
+}
+
+} // namespace
+
 AudioOutput::AudioOutput(QObject *parent)
     : QObject(parent)
     , _engine(new QTextToSpeech(QStringLiteral("none"), this))
 {
     // qCDebug(AudioOutputLog) << Q_FUNC_INFO << this;
 
+    _queueTimer.start();
+
     if (!QTextToSpeech::availableEngines().isEmpty()) {
         if (_engine->setEngine(QString())) {
             // Autoselect engine by priority
@@ -58,8 +99,17 @@ AudioOutput::AudioOutput(QObject *parent)
 
             (void) connect(this, &AudioOutput::mutedChanged, [this](bool muted) {
                 qCDebug(AudioOutputLog) << Q_FUNC_INFO << "muted:" << muted;
+                if (muted) {
+                    _queue.clear();
+                }
                 (void) QMetaObject::invokeMethod(_engine, "setVolume", Qt::AutoConnection, muted ? 0. : 1.);
             });
+
+            (void) connect(_engine, &QTextToSpeech::stateChanged, this, [this](QTextToSpeech::State state) {
+                if (state == QTextToSpeech::Ready) {
+                    _sayNext();
+                }
+            });
         }
     }
 
@@ -97,7 +147,7 @@ void AudioOutput::init(Fact *mutedFact)
     setMuted(mutedFact->rawValue().toBool());
 }
 
-void AudioOutput::say(const QString &text, AudioOutput::TextMods textMods)
+void AudioOutput::say(const QString &text, AudioOutput::TextMods textMods, Priority priority, const QString &collapseKey)
 {
     if (_muted) {
         return;
@@ -108,39 +158,41 @@ void AudioOutput::say(const QString &text, AudioOutput::TextMods textMods)
         return;
     }
 
-    if (_textQueueSize > kMaxTextQueueSize) {
-        (void) QMetaObject::invokeMethod(_engine, "stop", Qt::AutoConnection, QTextToSpeech::BoundaryHint::Default);
-    }
-
     QString outText = AudioOutput::fixTextMessageForAudio(text);
 
     if (textMods.testFlag(AudioOutput::TextMod::Translate)) {
         outText = QCoreApplication::translate("AudioOutput", outText.toStdString().c_str());
     }
 
-    qsizetype index = -1;
-    (void) QMetaObject::invokeMethod(_engine, "enqueue", Qt::AutoConnection, qReturnArg(index), outText);
-    if (index != -1) {
-        _textQueueSize = index;
+    if (!_queue.enqueue(outText, priority, collapseKey, _queueTimer.elapsed())) {
+        qCDebug(AudioOutputLog) << Q_FUNC_INFO << "Already queued:" << outText;
     }
+
+    _sayNext();
 }
 
-bool AudioOutput::getMillisecondString(const QString &string, QString &match, int &number)
+void AudioOutput::_sayNext()
 {
-    static const QRegularExpression regexp("([0-9]+ms)");
+    if (_engine->state() != QTextToSpeech::Ready) {
+        return;
+    }
 
-    bool result = false;
+    const QString text = _queue.takeNext(_queueTimer.elapsed());
+    if (!text.isEmpty()) {
+        (void) QMetaObject::invokeMethod(_engine, "say", Qt::AutoConnection, text);
+    }
+}
 
-    for (const QRegularExpressionMatch &tempMatch : regexp.globalMatch(string)) {
-        if (tempMatch.hasMatch()) {
-            match = tempMatch.captured(0);
-            number = tempMatch.captured(0).replace("ms", "").toInt();
-            result = true;
-            break;
-        }
+bool AudioOutput::getMillisecondString(const QString &string, QString &match, int &number)
+{
+    const QRegularExpressionMatch regexMatch = _audioTextPatterns->milliseconds.match(string);
+    if (!regexMatch.hasMatch()) {
+        return false;
     }
 
-    return result;
+    match = regexMatch.captured(0);
+    number = regexMatch.captured(1).toInt();
+    return true;
 }
 
 QString AudioOutput::fixTextMessageForAudio(const QString &string)
@@ -154,34 +206,13 @@ QString AudioOutput::fixTextMessageForAudio(const QString &string)
     }
 
     // Convert negative numbers
-    static const QRegularExpression negNumRegex(QStringLiteral("(-)[0-9]*\\.?[0-9]"));
-    QRegularExpressionMatch negNumRegexMatch = negNumRegex.match(result);
-    while (negNumRegexMatch.hasMatch()) {
-        if (!negNumRegexMatch.captured(1).isNull()) {
-            result.replace(negNumRegexMatch.capturedStart(1), negNumRegexMatch.capturedEnd(1) - negNumRegexMatch.capturedStart(1), QStringLiteral(" negative "));
-        }
-        negNumRegexMatch = negNumRegex.match(result);
-    }
+    _replaceCaptured(result, _audioTextPatterns->negativeNumber, 1, QStringLiteral(" negative "));
 
     // Convert real number with decimal point
-    static const QRegularExpression realNumRegex(QStringLiteral("([0-9]+)(\\.)([0-9]+)"));
-    QRegularExpressionMatch realNumRegexMatch = realNumRegex.match(result);
-    while (realNumRegexMatch.hasMatch()) {
-        if (!realNumRegexMatch.captured(2).isNull()) {
-            result.replace(realNumRegexMatch.capturedStart(2), realNumRegexMatch.capturedEnd(2) - realNumRegexMatch.capturedStart(2), QStringLiteral(" point "));
-        }
-        realNumRegexMatch = realNumRegex.match(result);
-    }
+    _replaceCaptured(result, _audioTextPatterns->realNumber, 2, QStringLiteral(" point "));
 
     // Convert meter postfix after real number
-    static const QRegularExpression realNumMeterRegex(QStringLiteral("[0-9]*\\.?[0-9]\\s?(m)([^A-Za-z]|$)"));
-    QRegularExpressionMatch realNumMeterRegexMatch = realNumMeterRegex.match(result);
-    while (realNumMeterRegexMatch.hasMatch()) {
-        if (!realNumMeterRegexMatch.captured(1).isNull()) {
-            result.replace(realNumMeterRegexMatch.capturedStart(1), realNumMeterRegexMatch.capturedEnd(1) - realNumMeterRegexMatch.capturedStart(1), QStringLiteral(" meters"));
-        }
-        realNumMeterRegexMatch = realNumMeterRegex.match(result);
-    }
+    _replaceCaptured(result, _audioTextPatterns->realNumberMeter, 1, QStringLiteral(" meters"));
 
     QString match;
     int number;
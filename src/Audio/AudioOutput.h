@@ -9,6 +9,9 @@
 
 #pragma once
 
+#include "AudioOutputQueue.h"
+
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 
@@ -33,6 +36,8 @@ public:
     Q_FLAG(TextMod)
     Q_DECLARE_FLAGS(TextMods, TextMod)
 
+    using Priority = AudioOutputQueue::Priority;
+
     /// Constructs an AudioOutput object.
     ///     @param parent The parent QObject.
     explicit AudioOutput(QObject *parent = nullptr);
@@ -55,10 +60,12 @@ public:
     ///     @param enable True to mute, false to unmute.
     void setMuted(bool muted) { if (muted != _muted) { _muted = muted; emit mutedChanged(_muted); } }
 
-    /// Reads the specified text with optional text modifications.
+    /// Queues the specified text with optional text modifications. Identical pending texts are only read once.
     ///     @param text The text to be read.
     ///     @param textMods The text modifications to apply.
-    void say(const QString &text, AudioOutput::TextMods textMods = TextMod::None);
+    ///     @param priority Texts with a higher priority are read first, stale low priority texts are dropped.
+    ///     @param collapseKey Pending texts with the same non-empty key are replaced by this one.
+    void say(const QString &text, AudioOutput::TextMods textMods = TextMod::None, Priority priority = Priority::Normal, const QString &collapseKey = QString());
 
     /// Extracts a millisecond value from the given string.
     ///     @param string The string to extract from.
@@ -78,14 +85,15 @@ signals:
     void mutedChanged(bool muted);
 
 private:
+    /// Reads the next queued text if the engine is idle.
+    void _sayNext();
+
     QTextToSpeech *_engine = nullptr;
-    qsizetype _textQueueSize = 0;
+    AudioOutputQueue _queue;
+    QElapsedTimer _queueTimer;
     bool _muted = false;
     Fact *_mutedFact = nullptr;
 
     static const QHash<QString, QString> _textHash;
-
-    static constexpr qsizetype kMaxTextQueueSize = 20;
-
 };
 Q_DECLARE_OPERATORS_FOR_FLAGS(AudioOutput::TextMods)
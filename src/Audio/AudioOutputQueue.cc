@@ -0,0 +1,66 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "AudioOutputQueue.h"
+
+bool AudioOutputQueue::enqueue(const QString &text, Priority priority, const QString &collapseKey, qint64 nowMs)
+{
+    for (qsizetype i = 0; i < _entries.count(); i++) {
+        if (_entries[i].text == text) {
+            // Keep the pending one, it only moves up if the new one is more urgent
+            if (priority > _entries[i].priority) {
+                Entry entry = _entries.takeAt(i);
+                entry.priority = priority;
+                _insert(entry);
+            }
+            return false;
+        }
+    }
+
+    if (!collapseKey.isEmpty()) {
+        (void) _entries.removeIf([&collapseKey](const Entry &entry) { return entry.collapseKey == collapseKey; });
+    }
+
+    _insert(Entry{ text, priority, collapseKey, nowMs });
+
+    if (_entries.count() > kMaxSize) {
+        // Drop the oldest text of the lowest priority
+        const Priority lowest = _entries.last().priority;
+        for (qsizetype i = 0; i < _entries.count(); i++) {
+            if (_entries[i].priority == lowest) {
+                _entries.removeAt(i);
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+QString AudioOutputQueue::takeNext(qint64 nowMs)
+{
+    while (!_entries.isEmpty()) {
+        const Entry entry = _entries.takeFirst();
+        if ((entry.priority == Priority::Low) && ((nowMs - entry.queuedMs) > kMaxLowPriorityAgeMs)) {
+            continue;
+        }
+        return entry.text;
+    }
+
+    return QString();
+}
+
+void AudioOutputQueue::_insert(const Entry &entry)
+{
+    qsizetype index = 0;
+    while ((index < _entries.count()) && (_entries[index].priority >= entry.priority)) {
+        index++;
+    }
+    _entries.insert(index, entry);
+}
@@ -0,0 +1,56 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+/// Pending texts of AudioOutput, ordered by priority and by age within a priority.
+class AudioOutputQueue
+{
+public:
+    enum class Priority {
+        Low = 0,    ///< Dropped if it waited longer than kMaxLowPriorityAgeMs
+        Normal,
+        High,
+    };
+
+    /// Adds a text to the queue.
+    ///     @param text The text to be read, already fixed for audio.
+    ///     @param priority Texts with a higher priority are read first.
+    ///     @param collapseKey Pending texts with the same non-empty key are replaced by this one (e.g. the flight mode of a vehicle).
+    ///     @param nowMs Current time in milliseconds.
+    ///     @return False if the identical text was already pending, true otherwise.
+    bool enqueue(const QString &text, Priority priority, const QString &collapseKey, qint64 nowMs);
+
+    /// Removes the next text to read, stale low priority texts are skipped.
+    ///     @param nowMs Current time in milliseconds.
+    ///     @return The text, empty if nothing is left.
+    QString takeNext(qint64 nowMs);
+
+    qsizetype count() const { return _entries.count(); }
+    bool isEmpty() const { return _entries.isEmpty(); }
+    void clear() { _entries.clear(); }
+
+    static constexpr qsizetype kMaxSize = 20;
+    static constexpr qint64 kMaxLowPriorityAgeMs = 10000;
+
+private:
+    struct Entry {
+        QString text;
+        Priority priority;
+        QString collapseKey;
+        qint64 queuedMs;
+    };
+
+    void _insert(const Entry &entry);
+
+    QList<Entry> _entries; ///< Highest priority first, oldest first within a priority
+};
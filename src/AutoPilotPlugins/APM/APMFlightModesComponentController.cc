@@ -74,20 +74,25 @@ APMFlightModesComponentController::APMFlightModesComponentController(void)
 }
 
 /// Connected to Vehicle::rcChannelsChanged signal
-void APMFlightModesComponentController::_rcChannelsChanged(int channelCount, int pwmValues[QGCMAVLink::maxRcChannels])
+void APMFlightModesComponentController::_rcChannelsChanged(const QGCMAVLink::RCChannels_t& channels)
 {
+    // Unchanged values only arrive while radio calibration requests every message
+    if (channels.changedMask == 0) {
+        return;
+    }
+
     int flightModeChannel = 4;
 
     if (parameterExists(ParameterManager::defaultComponentId, _modeChannelParam)) {
         flightModeChannel = getParameterFact(ParameterManager::defaultComponentId, _modeChannelParam)->rawValue().toInt() - 1;
     }
 
-    if (flightModeChannel >= channelCount) {
+    if (flightModeChannel >= channels.channelCount) {
         return;
     }
 
     _activeFlightMode = 0;
-    int channelValue = pwmValues[flightModeChannel];
+    int channelValue = channels.pwmValues[flightModeChannel];
     if (channelValue != -1) {
         bool found = false;
         int rgThreshold[] = { 1230, 1360, 1490, 1620, 1749 };
@@ -106,7 +111,7 @@ void APMFlightModesComponentController::_rcChannelsChanged(int channelCount, int
 
     for (int i=0; i<_cChannelOptions; i++) {
         _rgChannelOptionEnabled[i] = QVariant(false);
-        channelValue = pwmValues[i+5];
+        channelValue = channels.pwmValues[i+5];
         if (channelValue > 1800) {
             _rgChannelOptionEnabled[i] = QVariant(true);
         }
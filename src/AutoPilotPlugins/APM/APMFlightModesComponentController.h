@@ -57,7 +57,7 @@ signals:
     void superSimpleModeEnabledChanged  (void);
 
 private slots:
-    void _rcChannelsChanged                     (int channelCount, int pwmValues[QGCMAVLink::maxRcChannels]);
+    void _rcChannelsChanged                     (const QGCMAVLink::RCChannels_t& channels);
     void _updateSimpleParamsFromSimpleMode      (void);
     void _setupSimpleModeEnabled     (void);
 
@@ -156,6 +156,7 @@ SetupPage {
                 orientationCalAreaHelpText: orientationCalAreaHelpText
 
                 property var rgCompassCalFitness: [ controller.compass1CalFitness, controller.compass2CalFitness, controller.compass3CalFitness ]
+                property var rgCompassFit:        [ controller.compass1Fit, controller.compass2Fit, controller.compass3Fit ]
 
                 onResetStatusTextArea: statusLog.text = statusTextAreaDefaultText
 
@@ -254,6 +255,17 @@ SetupPage {
                         }
                     }
 
+                    QGCLabel {
+                        anchors.left:   parent.left
+                        anchors.right:  parent.right
+                        wrapMode:       Text.WordWrap
+                        visible:        _compassFit.valid
+                        text:           qsTr("Ground station check: %1% of directions covered, fit residual %2 mGauss").arg(Math.round(_compassFit.coverage * 100)).arg(_compassFit.residual.toFixed(1))
+                        color:          _compassFit.coverage < 0.5 || _compassFit.residual > yellowMaxThreshold ? qgcPal.warningText : qgcPal.text
+
+                        property var _compassFit: controller.rgCompassFit[index]
+                    }
+
                     Loader {
                         anchors.leftMargin: ScreenTools.defaultFontPixelWidth * 2
                         anchors.left:       parent.left
@@ -73,6 +73,9 @@ APMSensorsComponentController::APMSensorsComponentController(void)
         qWarning() << "Sensors component is missing";
     }
 
+    _uiUpdateTimer.setSingleShot(true);
+    _uiUpdateTimer.setInterval(_uiUpdateIntervalMSecs);
+    (void) connect(&_uiUpdateTimer, &QTimer::timeout, this, &APMSensorsComponentController::_sendQueuedUiUpdates);
 }
 
 APMSensorsComponentController::~APMSensorsComponentController()
@@ -103,7 +106,7 @@ void APMSensorsComponentController::_startLogCalibration(void)
     }
     _cancelButton->setEnabled(_calTypeInProgress == QGCMAVLink::CalibrationMag);
 
-    connect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messageReceived, this, &APMSensorsComponentController::_mavlinkMessageReceived);
+    _subscribeCalibrationMessages();
 }
 
 void APMSensorsComponentController::_startVisualCalibration(void)
@@ -116,7 +119,7 @@ void APMSensorsComponentController::_startVisualCalibration(void)
     
     _progressBar->setProperty("value", 0);
 
-    connect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messageReceived, this, &APMSensorsComponentController::_mavlinkMessageReceived);
+    _subscribeCalibrationMessages();
 }
 
 void APMSensorsComponentController::_resetInternalState(void)
@@ -147,7 +150,8 @@ void APMSensorsComponentController::_resetInternalState(void)
 
 void APMSensorsComponentController::_stopCalibration(APMSensorsComponentController::StopCalibrationCode code)
 {
-    disconnect(qgcApp()->toolbox()->mavlinkProtocol(), &MAVLinkProtocol::messageReceived, this, &APMSensorsComponentController::_mavlinkMessageReceived);
+    qgcApp()->toolbox()->mavlinkProtocol()->unsubscribeAllMessages(this);
+    _clearQueuedUiUpdates();
     _vehicle->vehicleLinkManager()->setCommunicationLostEnabled(true);
 
     disconnect(_vehicle, &Vehicle::textMessageReceived, this, &APMSensorsComponentController::_handleUASTextMessage);
@@ -221,6 +225,9 @@ void APMSensorsComponentController::_mavCommandResult(int vehicleId, int compone
             _rgCompassCalComplete[0] = false;
             _rgCompassCalComplete[1] = false;
             _rgCompassCalComplete[2] = false;
+            for (CompassCalibrationFit& compassFit : _rgCompassFit) {
+                compassFit.reset();
+            }
 
             _startLogCalibration();
             uint8_t compassBits = 0;
@@ -547,9 +554,14 @@ void APMSensorsComponentController::_handleMagCalProgress(mavlink_message_t& mes
             _rgCompassCalProgress[magCalProgress.compass_id] = magCalProgress.completion_pct / compassCalCount;
         }
 
-        if (_progressBar) {
-            _progressBar->setProperty("value", (float)(_rgCompassCalProgress[0] + _rgCompassCalProgress[1] + _rgCompassCalProgress[2]) / 100.0);
-        }
+        _queueProgress((qreal)(_rgCompassCalProgress[0] + _rgCompassCalProgress[1] + _rgCompassCalProgress[2]) / 100.0);
+    }
+}
+
+void APMSensorsComponentController::_handleMagSample(int compassIndex, int16_t xmag, int16_t ymag, int16_t zmag)
+{
+    if (_calTypeInProgress == QGCMAVLink::CalibrationMag && !_rgCompassCalComplete[compassIndex]) {
+        _rgCompassFit[compassIndex].addSample(QVector3D(xmag, ymag, zmag));
     }
 }
 
@@ -573,6 +585,14 @@ void APMSensorsComponentController::_handleMagCalReport(mavlink_message_t& messa
             _rgCompassCalSucceeded[magCalReport.compass_id] = magCalReport.cal_status == MAG_CAL_SUCCESS;
             _rgCompassCalFitness[magCalReport.compass_id] = magCalReport.fitness;
             additionalCompassCompleted = true;
+
+            const CompassCalibrationFit::Result_t& gcsFit = _rgCompassFit[magCalReport.compass_id].result();
+            if (gcsFit.valid) {
+                qCDebug(APMSensorsComponentControllerLog) << "Ground station compass fit #" << magCalReport.compass_id << "samples:coverage:residual"
+                                                          << gcsFit.sampleCount << gcsFit.coverage << gcsFit.residual;
+                _appendStatusLog(tr("Compass %1 ground station check: %2 samples covering %3% of directions, fit residual %4 mGauss")
+                                 .arg(magCalReport.compass_id).arg(gcsFit.sampleCount).arg(qRound(gcsFit.coverage * 100)).arg(gcsFit.residual, 0, 'f', 1));
+            }
         }
 
         if (_rgCompassCalComplete[0] && _rgCompassCalComplete[1] &&_rgCompassCalComplete[2]) {
@@ -623,7 +643,7 @@ void APMSensorsComponentController::_handleCommandLong(mavlink_message_t& messag
                 _orientationCalDownSideDone =       true;
                 _orientationCalDownSideInProgress = false;
                 _orientationCalLeftSideInProgress = true;
-                _progressBar->setProperty("value", (qreal)(17 / 100.0));
+                _queueProgress((qreal)(17 / 100.0));
             }
             break;
         case ACCELCAL_VEHICLE_POS_RIGHT:
@@ -632,7 +652,7 @@ void APMSensorsComponentController::_handleCommandLong(mavlink_message_t& messag
                 _orientationCalLeftSideDone =       true;
                 _orientationCalLeftSideInProgress = false;
                 _orientationCalRightSideInProgress = true;
-                _progressBar->setProperty("value", (qreal)(34 / 100.0));
+                _queueProgress((qreal)(34 / 100.0));
             }
             break;
         case ACCELCAL_VEHICLE_POS_NOSEDOWN:
@@ -641,7 +661,7 @@ void APMSensorsComponentController::_handleCommandLong(mavlink_message_t& messag
                 _orientationCalRightSideDone =       true;
                 _orientationCalRightSideInProgress = false;
                 _orientationCalNoseDownSideInProgress = true;
-                _progressBar->setProperty("value", (qreal)(51 / 100.0));
+                _queueProgress((qreal)(51 / 100.0));
             }
             break;
         case ACCELCAL_VEHICLE_POS_NOSEUP:
@@ -650,7 +670,7 @@ void APMSensorsComponentController::_handleCommandLong(mavlink_message_t& messag
                 _orientationCalNoseDownSideDone =       true;
                 _orientationCalNoseDownSideInProgress = false;
                 _orientationCalTailDownSideInProgress = true;
-                _progressBar->setProperty("value", (qreal)(68 / 100.0));
+                _queueProgress((qreal)(68 / 100.0));
             }
             break;
         case ACCELCAL_VEHICLE_POS_BACK:
@@ -659,7 +679,7 @@ void APMSensorsComponentController::_handleCommandLong(mavlink_message_t& messag
                 _orientationCalTailDownSideDone =       true;
                 _orientationCalTailDownSideInProgress = false;
                 _orientationCalUpsideDownSideInProgress = true;
-                _progressBar->setProperty("value", (qreal)(85 / 100.0));
+                _queueProgress((qreal)(85 / 100.0));
             }
             break;
         case ACCELCAL_VEHICLE_POS_SUCCESS:
@@ -674,13 +694,28 @@ void APMSensorsComponentController::_handleCommandLong(mavlink_message_t& messag
         }
 
         if (updateImages) {
-            emit orientationCalSidesDoneChanged();
-            emit orientationCalSidesInProgressChanged();
-            emit orientationCalSidesRotateChanged();
+            _queueUiUpdates(UiUpdateSidesDone | UiUpdateSidesInProgress | UiUpdateSidesRotate);
         }
     }
 }
 
+void APMSensorsComponentController::_subscribeCalibrationMessages(void)
+{
+    MAVLinkProtocol* mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+
+    // Make sure we don't end up with duplicate subscriptions if a calibration is restarted
+    mavlinkProtocol->unsubscribeAllMessages(this);
+
+    // RAW_IMU and SCALED_IMU2/3 carry the fields of the first three compasses for the ground station fit
+    const QList<uint32_t> rgMsgIds = { MAVLINK_MSG_ID_COMMAND_ACK, MAVLINK_MSG_ID_MAG_CAL_PROGRESS, MAVLINK_MSG_ID_MAG_CAL_REPORT, MAVLINK_MSG_ID_COMMAND_LONG,
+                                       MAVLINK_MSG_ID_RAW_IMU, MAVLINK_MSG_ID_SCALED_IMU2, MAVLINK_MSG_ID_SCALED_IMU3 };
+    for (uint32_t msgId : rgMsgIds) {
+        mavlinkProtocol->subscribeMessage(msgId, this, [this](LinkInterface* link, const mavlink_message_t& message) {
+            _mavlinkMessageReceived(link, message);
+        });
+    }
+}
+
 void APMSensorsComponentController::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
     Q_UNUSED(link);
@@ -702,6 +737,67 @@ void APMSensorsComponentController::_mavlinkMessageReceived(LinkInterface* link,
     case MAVLINK_MSG_ID_COMMAND_LONG:
         _handleCommandLong(message);
         break;
+    case MAVLINK_MSG_ID_RAW_IMU:
+    {
+        mavlink_raw_imu_t rawImu;
+        mavlink_msg_raw_imu_decode(&message, &rawImu);
+        _handleMagSample(0, rawImu.xmag, rawImu.ymag, rawImu.zmag);
+        break;
+    }
+    case MAVLINK_MSG_ID_SCALED_IMU2:
+    {
+        mavlink_scaled_imu2_t scaledImu;
+        mavlink_msg_scaled_imu2_decode(&message, &scaledImu);
+        _handleMagSample(1, scaledImu.xmag, scaledImu.ymag, scaledImu.zmag);
+        break;
+    }
+    case MAVLINK_MSG_ID_SCALED_IMU3:
+    {
+        mavlink_scaled_imu3_t scaledImu;
+        mavlink_msg_scaled_imu3_decode(&message, &scaledImu);
+        _handleMagSample(2, scaledImu.xmag, scaledImu.ymag, scaledImu.zmag);
+        break;
+    }
+    }
+}
+
+void APMSensorsComponentController::_queueUiUpdates(int uiUpdates)
+{
+    _queuedUiUpdates |= uiUpdates;
+    if (!_uiUpdateTimer.isActive()) {
+        _uiUpdateTimer.start();
+    }
+}
+
+void APMSensorsComponentController::_queueProgress(qreal progress)
+{
+    _queuedProgress = progress;
+    _queueUiUpdates(UiUpdateProgress);
+}
+
+/// Drops updates which are not sent yet, the final state is set directly when a calibration stops
+void APMSensorsComponentController::_clearQueuedUiUpdates(void)
+{
+    _uiUpdateTimer.stop();
+    _queuedUiUpdates = 0;
+}
+
+void APMSensorsComponentController::_sendQueuedUiUpdates(void)
+{
+    const int uiUpdates = _queuedUiUpdates;
+    _queuedUiUpdates = 0;
+
+    if ((uiUpdates & UiUpdateProgress) && _progressBar) {
+        _progressBar->setProperty("value", _queuedProgress);
+    }
+    if (uiUpdates & UiUpdateSidesDone) {
+        emit orientationCalSidesDoneChanged();
+    }
+    if (uiUpdates & UiUpdateSidesInProgress) {
+        emit orientationCalSidesInProgressChanged();
+    }
+    if (uiUpdates & UiUpdateSidesRotate) {
+        emit orientationCalSidesRotateChanged();
     }
 }
 
@@ -11,10 +11,12 @@
 
 #include "FactPanelController.h"
 #include "QGCMAVLink.h"
+#include "CompassCalibrationFit.h"
 
 #include <QtQuick/QQuickItem>
 #include <QtCore/QObject>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
 
 Q_DECLARE_LOGGING_CATEGORY(APMSensorsComponentControllerLog)
 Q_DECLARE_LOGGING_CATEGORY(APMSensorsComponentControllerVerboseLog)
@@ -81,6 +83,10 @@ public:
     Q_PROPERTY(double compass2CalFitness                    READ compass2CalFitness                         NOTIFY compass2CalFitnessChanged)
     Q_PROPERTY(double compass3CalFitness                    READ compass3CalFitness                         NOTIFY compass3CalFitnessChanged)
 
+    Q_PROPERTY(CompassCalibrationFit* compass1Fit           READ compass1Fit                                CONSTANT)
+    Q_PROPERTY(CompassCalibrationFit* compass2Fit           READ compass2Fit                                CONSTANT)
+    Q_PROPERTY(CompassCalibrationFit* compass3Fit           READ compass3Fit                                CONSTANT)
+
     Q_INVOKABLE void calibrateCompass           (void);
     Q_INVOKABLE void calibrateAccel             (bool doSimpleAccelCal);
     Q_INVOKABLE void calibrateCompassNorth      (float lat, float lon, int mask);
@@ -103,6 +109,10 @@ public:
     double compass2CalFitness(void) const { return _rgCompassCalFitness[1]; }
     double compass3CalFitness(void) const { return _rgCompassCalFitness[2]; }
 
+    CompassCalibrationFit* compass1Fit(void) { return &_rgCompassFit[0]; }
+    CompassCalibrationFit* compass2Fit(void) { return &_rgCompassFit[1]; }
+    CompassCalibrationFit* compass3Fit(void) { return &_rgCompassFit[2]; }
+
 signals:
     void showGyroCalAreaChanged                 (void);
     void showOrientationCalAreaChanged          (void);
@@ -126,8 +136,10 @@ private slots:
     void _handleUASTextMessage  (int uasId, int compId, int severity, QString text);
     void _mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message);
     void _mavCommandResult      (int vehicleId, int component, int command, int result, bool noReponseFromVehicle);
+    void _sendQueuedUiUpdates   (void);
 
 private:
+    void _subscribeCalibrationMessages      (void);
     void _startLogCalibration               (void);
     void _startVisualCalibration            (void);
     void _appendStatusLog                   (const QString& text);
@@ -138,6 +150,7 @@ private:
     void _handleMagCalProgress              (mavlink_message_t& message);
     void _handleMagCalReport                (mavlink_message_t& message);
     void _handleCommandLong                 (mavlink_message_t& message);
+    void _handleMagSample                   (int compassIndex, int16_t xmag, int16_t ymag, int16_t zmag);
     void _restorePreviousCompassCalFitness  (void);
 
     enum StopCalibrationCode {
@@ -150,6 +163,17 @@ private:
     
     void _updateAndEmitShowOrientationCalArea(bool show);
 
+    /// Progress and side indicator changes are collected and sent to the ui at most every _uiUpdateIntervalMSecs
+    enum UiUpdate {
+        UiUpdateProgress                = 1 << 0,
+        UiUpdateSidesDone               = 1 << 1,
+        UiUpdateSidesInProgress         = 1 << 2,
+        UiUpdateSidesRotate             = 1 << 3,
+    };
+    void _queueUiUpdates    (int uiUpdates);
+    void _queueProgress     (qreal progress);
+    void _clearQueuedUiUpdates(void);
+
     APMSensorsComponent*    _sensorsComponent;
 
     QQuickItem* _statusLog;
@@ -167,6 +191,12 @@ private:
     bool    _rgCompassCalSucceeded[3];
     float   _rgCompassCalFitness[3];
 
+    CompassCalibrationFit _rgCompassFit[3];
+
+    QTimer  _uiUpdateTimer;
+    int     _queuedUiUpdates = 0;
+    qreal   _queuedProgress = 0;
+
     bool _orientationCalDownSideDone;
     bool _orientationCalUpsideDownSideDone;
     bool _orientationCalLeftSideDone;
@@ -202,4 +232,5 @@ private:
     static constexpr const char* _compassCalFitnessParam = "COMPASS_CAL_FIT";
     
     static const int _supportedFirmwareCalVersion = 2;
+    static constexpr int _uiUpdateIntervalMSecs = 100;
 };
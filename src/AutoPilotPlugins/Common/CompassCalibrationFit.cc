@@ -0,0 +1,294 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CompassCalibrationFit.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QtMath>
+
+#include <array>
+#include <cmath>
+
+QGC_LOGGING_CATEGORY(CompassCalibrationFitLog, "qgc.autopilotplugins.compasscalibrationfit")
+
+namespace {
+
+/// Solves a x = b in place by Gaussian elimination with partial pivoting
+///     @return false: singular
+template<int N>
+bool solveLinear(std::array<std::array<double, N>, N>& a, std::array<double, N>& b)
+{
+    for (int col = 0; col < N; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < N; row++) {
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::fabs(a[pivot][col]) < 1e-12) {
+            return false;
+        }
+        std::swap(a[pivot], a[col]);
+        std::swap(b[pivot], b[col]);
+
+        for (int row = col + 1; row < N; row++) {
+            const double factor = a[row][col] / a[col][col];
+            for (int i = col; i < N; i++) {
+                a[row][i] -= factor * a[col][i];
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+
+    for (int row = N - 1; row >= 0; row--) {
+        double sum = b[row];
+        for (int i = row + 1; i < N; i++) {
+            sum -= a[row][i] * b[i];
+        }
+        b[row] = sum / a[row][row];
+    }
+
+    return true;
+}
+
+/// Least squares fit of u² + v² + w² = 2 cx u + 2 cy v + 2 cz w + k
+bool fitSphere(const QList<QVector3D>& points, QVector3D& center, double& radius)
+{
+    std::array<std::array<double, 4>, 4> normal{};
+    std::array<double, 4> rhs{};
+
+    for (const QVector3D& p : points) {
+        const std::array<double, 4> row = { 2.0 * p.x(), 2.0 * p.y(), 2.0 * p.z(), 1.0 };
+        const double target = p.lengthSquared();
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                normal[i][j] += row[i] * row[j];
+            }
+            rhs[i] += row[i] * target;
+        }
+    }
+
+    if (!solveLinear<4>(normal, rhs)) {
+        return false;
+    }
+
+    center = QVector3D(rhs[0], rhs[1], rhs[2]);
+    const double radiusSquared = rhs[3] + center.lengthSquared();
+    if (radiusSquared <= 0) {
+        return false;
+    }
+    radius = std::sqrt(radiusSquared);
+
+    return true;
+}
+
+/// Least squares fit of a u² + b v² + c w² + d u + e v + f w = 1, an ellipsoid whose axes are the sensor axes
+bool fitAxisAlignedEllipsoid(const QList<QVector3D>& points, QVector3D& center, QVector3D& radii)
+{
+    std::array<std::array<double, 6>, 6> normal{};
+    std::array<double, 6> rhs{};
+
+    for (const QVector3D& p : points) {
+        const std::array<double, 6> row = { p.x() * p.x(), p.y() * p.y(), p.z() * p.z(), p.x(), p.y(), p.z() };
+        for (int i = 0; i < 6; i++) {
+            for (int j = 0; j < 6; j++) {
+                normal[i][j] += row[i] * row[j];
+            }
+            rhs[i] += row[i];
+        }
+    }
+
+    if (!solveLinear<6>(normal, rhs)) {
+        return false;
+    }
+
+    const double a = rhs[0];
+    const double b = rhs[1];
+    const double c = rhs[2];
+    if ((a <= 0) || (b <= 0) || (c <= 0)) {
+        return false;
+    }
+
+    center = QVector3D(-rhs[3] / (2 * a), -rhs[4] / (2 * b), -rhs[5] / (2 * c));
+    const double g = 1 + (a * center.x() * center.x()) + (b * center.y() * center.y()) + (c * center.z() * center.z());
+    if (g <= 0) {
+        return false;
+    }
+    radii = QVector3D(std::sqrt(g / a), std::sqrt(g / b), std::sqrt(g / c));
+
+    return true;
+}
+
+} // namespace
+
+CompassCalibrationFit::CompassCalibrationFit(QObject* parent)
+    : QObject(parent)
+{
+    _fitTimer.setSingleShot(true);
+    _fitTimer.setInterval(_fitIntervalMSecs);
+
+    (void) connect(&_fitTimer, &QTimer::timeout, this, &CompassCalibrationFit::_startFit);
+    (void) connect(&_fitWatcher, &QFutureWatcher<BackgroundFit_t>::finished, this, &CompassCalibrationFit::_fitDone);
+}
+
+void CompassCalibrationFit::reset(void)
+{
+    _samples.clear();
+    _nextSampleIndex = 0;
+    _lastSample = QVector3D();
+    _result = Result_t();
+    _generation++;
+    _samplesChanged = false;
+    _fitTimer.stop();
+
+    emit fitChanged();
+}
+
+void CompassCalibrationFit::addSample(const QVector3D& field)
+{
+    if (!_samples.isEmpty() && ((field - _lastSample).length() < (minSampleSpacing * field.length()))) {
+        return;
+    }
+    _lastSample = field;
+
+    if (_samples.count() < maxSamples) {
+        _samples.append(field);
+    } else {
+        _samples[_nextSampleIndex] = field;
+        _nextSampleIndex = (_nextSampleIndex + 1) % maxSamples;
+    }
+
+    _samplesChanged = true;
+    if (!_fitTimer.isActive()) {
+        _fitTimer.start();
+    }
+}
+
+void CompassCalibrationFit::_startFit(void)
+{
+    if (_fitWatcher.isRunning()) {
+        // _fitDone starts the timer again for the samples which came in meanwhile
+        return;
+    }
+    _samplesChanged = false;
+
+    if (_samples.count() < minFitSamples) {
+        _result.sampleCount = _samples.count();
+        emit fitChanged();
+        return;
+    }
+
+    const QList<QVector3D> samples = _samples;
+    const quint64 generation = _generation;
+    _fitWatcher.setFuture(QtConcurrent::run([samples, generation]() {
+        return BackgroundFit_t{ generation, fit(samples) };
+    }));
+}
+
+void CompassCalibrationFit::_fitDone(void)
+{
+    const BackgroundFit_t background = _fitWatcher.result();
+
+    if (background.generation == _generation) {
+        _result = background.result;
+        qCDebug(CompassCalibrationFitLog) << "samples:coverage:residual:radius:offsets:scale"
+                                          << _result.sampleCount << _result.coverage << _result.residual << _result.radius << _result.offsets << _result.scale;
+        emit fitChanged();
+    }
+
+    if (_samplesChanged && !_fitTimer.isActive()) {
+        _fitTimer.start();
+    }
+}
+
+CompassCalibrationFit::Result_t CompassCalibrationFit::fit(const QList<QVector3D>& samples)
+{
+    Result_t result;
+    result.sampleCount = samples.count();
+
+    if (samples.count() < minFitSamples) {
+        return result;
+    }
+
+    // Center and normalize the samples so the normal equations stay well conditioned
+    QVector3D mean;
+    for (const QVector3D& sample : samples) {
+        mean += sample;
+    }
+    mean /= samples.count();
+
+    double spread = 0;
+    for (const QVector3D& sample : samples) {
+        spread += (sample - mean).length();
+    }
+    spread /= samples.count();
+    if (spread <= 0) {
+        return result;
+    }
+
+    QList<QVector3D> points;
+    points.reserve(samples.count());
+    for (const QVector3D& sample : samples) {
+        points.append((sample - mean) / spread);
+    }
+
+    QVector3D center;
+    double radius = 0;
+    if (!fitSphere(points, center, radius)) {
+        return result;
+    }
+
+    // The scale factors of an ellipsoid are only determined by samples on all sides, fall back to the sphere when
+    // the ellipsoid fit fails or comes out implausibly stretched
+    QVector3D ellipsoidCenter;
+    QVector3D radii;
+    QVector3D scale(1, 1, 1);
+    if (fitAxisAlignedEllipsoid(points, ellipsoidCenter, radii)) {
+        const double meanRadius = std::cbrt(radii.x() * radii.y() * radii.z());
+        const QVector3D ellipsoidScale(meanRadius / radii.x(), meanRadius / radii.y(), meanRadius / radii.z());
+        const float minScale = qMin(ellipsoidScale.x(), qMin(ellipsoidScale.y(), ellipsoidScale.z()));
+        const float maxScale = qMax(ellipsoidScale.x(), qMax(ellipsoidScale.y(), ellipsoidScale.z()));
+        if ((minScale > 0.5f) && (maxScale < 2.0f)) {
+            center = ellipsoidCenter;
+            radius = meanRadius;
+            scale = ellipsoidScale;
+        }
+    }
+
+    std::array<bool, coverageBands * coverageSectors> bins{};
+    double sumSquares = 0;
+    for (const QVector3D& point : points) {
+        const QVector3D corrected = (point - center) * scale;
+        const double length = corrected.length();
+        const double error = length - radius;
+        sumSquares += error * error;
+
+        if (length > 0) {
+            const QVector3D direction = corrected / length;
+            const int band = qBound(0, static_cast<int>((direction.z() + 1.0) / 2.0 * coverageBands), coverageBands - 1);
+            const int sector = qBound(0, static_cast<int>((std::atan2(direction.y(), direction.x()) + M_PI) / (2 * M_PI) * coverageSectors), coverageSectors - 1);
+            bins[(band * coverageSectors) + sector] = true;
+        }
+    }
+
+    int filledBins = 0;
+    for (bool filled : bins) {
+        filledBins += filled ? 1 : 0;
+    }
+
+    result.valid = true;
+    result.coverage = static_cast<double>(filledBins) / bins.size();
+    result.residual = std::sqrt(sumSquares / points.count()) * spread;
+    result.radius = radius * spread;
+    result.offsets = mean + (center * spread);
+    result.scale = scale;
+
+    return result;
+}
@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtGui/QVector3D>
+
+Q_DECLARE_LOGGING_CATEGORY(CompassCalibrationFitLog)
+
+/// Ground station side check of a compass calibration. Buffers the magnetometer samples the vehicle streams while it
+/// is rotated and fits an axis aligned ellipsoid to them on a worker thread, once a second at most.
+///
+/// The samples already have the current onboard calibration applied, so the offsets found here are what is left over.
+/// The quality metrics do not depend on that: the residual is the RMS distance in mGauss of the corrected samples from
+/// the fitted sphere, like the fitness the firmware reports, and the coverage is the fraction of directions the samples
+/// reached.
+class CompassCalibrationFit : public QObject
+{
+    Q_OBJECT
+
+public:
+    CompassCalibrationFit(QObject* parent = nullptr);
+
+    Q_PROPERTY(bool         valid       READ valid          NOTIFY fitChanged)
+    Q_PROPERTY(int          sampleCount READ sampleCount    NOTIFY fitChanged)
+    Q_PROPERTY(double       coverage    READ coverage       NOTIFY fitChanged)  ///< 0 to 1
+    Q_PROPERTY(double       residual    READ residual       NOTIFY fitChanged)  ///< mGauss
+    Q_PROPERTY(double       radius      READ radius         NOTIFY fitChanged)  ///< Field strength, mGauss
+    Q_PROPERTY(QVector3D    offsets     READ offsets        NOTIFY fitChanged)  ///< mGauss
+    Q_PROPERTY(QVector3D    scale       READ scale          NOTIFY fitChanged)
+
+    struct Result_t {
+        bool        valid =         false;
+        int         sampleCount =   0;
+        double      coverage =      0;
+        double      residual =      0;
+        double      radius =        0;
+        QVector3D   offsets;
+        QVector3D   scale =         QVector3D(1, 1, 1);
+    };
+
+    bool        valid       (void) const { return _result.valid; }
+    int         sampleCount (void) const { return _result.sampleCount; }
+    double      coverage    (void) const { return _result.coverage; }
+    double      residual    (void) const { return _result.residual; }
+    double      radius      (void) const { return _result.radius; }
+    QVector3D   offsets     (void) const { return _result.offsets; }
+    QVector3D   scale       (void) const { return _result.scale; }
+
+    const Result_t& result(void) const { return _result; }
+
+    /// Drops all samples and the current fit, a fit still running in the background is discarded
+    void reset(void);
+
+    /// Adds a magnetometer sample in mGauss. Samples closer than minSampleSpacing to the previous one are skipped so
+    /// that holding the vehicle still does not flood the buffer.
+    void addSample(const QVector3D& field);
+
+    /// Fits the samples on the calling thread
+    static Result_t fit(const QList<QVector3D>& samples);
+
+    static constexpr int    maxSamples =        1000;
+    static constexpr int    minFitSamples =     30;
+    static constexpr float  minSampleSpacing =  0.02f;  ///< Fraction of the field strength
+    static constexpr int    coverageBands =     6;      ///< Equal area bins of sample direction: bands of equal height...
+    static constexpr int    coverageSectors =   12;     ///< ...times sectors of equal angle
+
+signals:
+    void fitChanged(void);
+
+private slots:
+    void _startFit  (void);
+    void _fitDone   (void);
+
+private:
+    struct BackgroundFit_t {
+        quint64     generation = 0;
+        Result_t    result;
+    };
+
+    QList<QVector3D>                _samples;
+    int                             _nextSampleIndex = 0;   ///< Oldest sample, which is replaced once the buffer is full
+    QVector3D                       _lastSample;
+    Result_t                        _result;
+    quint64                         _generation = 0;        ///< Bumped by reset, results of older generations are stale
+    bool                            _samplesChanged = false;
+    QTimer                          _fitTimer;
+    QFutureWatcher<BackgroundFit_t> _fitWatcher;
+
+    static constexpr int _fitIntervalMSecs = 1000;
+};
@@ -64,9 +64,21 @@ void RadioComponentController::start(void)
 
 RadioComponentController::~RadioComponentController()
 {
+    _setRCChannelsFullRate(false);
     _storeSettings();
 }
 
+void RadioComponentController::_setRCChannelsFullRate(bool fullRate)
+{
+    if (fullRate && !_rcChannelsFullRateVehicle && _vehicle) {
+        _rcChannelsFullRateVehicle = _vehicle;
+        _vehicle->setRCChannelsFullRate(true);
+    } else if (!fullRate && _rcChannelsFullRateVehicle) {
+        _rcChannelsFullRateVehicle->setRCChannelsFullRate(false);
+        _rcChannelsFullRateVehicle.clear();
+    }
+}
+
 /// @brief Returns the state machine entry for the specified state.
 const RadioComponentController::stateMachineEntry* RadioComponentController::_getStateMachineEntry(int step) const
 {
@@ -178,19 +190,24 @@ void RadioComponentController::_setupCurrentState(void)
 }
 
 /// Connected to Vehicle::rcChannelsChanged signal
-void RadioComponentController::_rcChannelsChanged(int channelCount, int pwmValues[QGCMAVLink::maxRcChannels])
+void RadioComponentController::_rcChannelsChanged(const QGCMAVLink::RCChannels_t& channels)
 {
+    const int channelCount = channels.channelCount;
     for (int channel=0; channel<channelCount; channel++) {
-        int channelValue = pwmValues[channel];
+        int channelValue = channels.pwmValues[channel];
 
-        if (channelValue != -1) {
+        // The calibration steps time how long a stick is held, so they see every value. The displays only changes.
+        const bool changed = channels.changedMask & (1u << channel);
+        if ((channelValue != -1) && (changed || (_currentStep != -1))) {
             qCDebug(RadioComponentControllerVerboseLog) << "Raw value" << channel << channelValue;
 
             _rcRawValue[channel] = channelValue;
-            emit channelRCValueChanged(channel, channelValue);
+            if (changed) {
+                emit channelRCValueChanged(channel, channelValue);
+            }
 
             // Signal attitude rc values to Qml if mapped
-            if (_rgChannelInfo[channel].function != rcCalFunctionMax) {
+            if (changed && (_rgChannelInfo[channel].function != rcCalFunctionMax)) {
                 switch (_rgChannelInfo[channel].function) {
                 case rcCalFunctionRoll:
                     emit rollChannelRCValueChanged(channelValue);
@@ -753,6 +770,7 @@ void RadioComponentController::_startCalibration(void)
 
     // Let the mav known we are starting calibration. This should turn off motors and so forth.
     _vehicle->startCalibration(QGCMAVLink::CalibrationRadio);
+    _setRCChannelsFullRate(true);
 
     _nextButton->setProperty("text", tr("Next"));
     _cancelButton->setEnabled(true);
@@ -765,6 +783,7 @@ void RadioComponentController::_startCalibration(void)
 void RadioComponentController::_stopCalibration(void)
 {
     _currentStep = -1;
+    _setRCChannelsFullRate(false);
 
     if (_vehicle) {
         // Only PX4 is known to support this command in all versions. For other firmware which may or may not
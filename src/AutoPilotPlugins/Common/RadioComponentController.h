@@ -20,6 +20,7 @@
 
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
 #include <QtQuick/QQuickItem>
 
 Q_DECLARE_LOGGING_CATEGORY(RadioComponentControllerLog)
@@ -139,7 +140,7 @@ signals:
     void throttleReversedCalFailure(void);
 
 private slots:
-    void _rcChannelsChanged(int channelCount, int pwmValues[QGCMAVLink::maxRcChannels]);
+    void _rcChannelsChanged(const QGCMAVLink::RCChannels_t& channels);
 
 private:
     /// @brief These identify the various controls functions. They are also used as indices into the _rgFunctioInfo
@@ -190,6 +191,7 @@ private:
     };
 
     int _currentStep;  ///< Current step of state machine
+    QPointer<Vehicle> _rcChannelsFullRateVehicle;   ///< Set while every RC_CHANNELS message is requested for calibration
 
     const struct stateMachineEntry* _getStateMachineEntry(int step) const;
     const struct FunctionInfo* _functionInfo(void) const;
@@ -218,6 +220,7 @@ private:
 
     void _startCalibration(void);
     void _stopCalibration(void);
+    void _setRCChannelsFullRate(bool fullRate);
     void _rcCalSave(void);
 
     void _writeParameters(void);
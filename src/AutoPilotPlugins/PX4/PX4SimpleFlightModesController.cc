@@ -30,11 +30,16 @@ PX4SimpleFlightModesController::PX4SimpleFlightModesController(void)
 }
 
 /// Connected to Vehicle::rcChannelsChanged signal
-void PX4SimpleFlightModesController::_rcChannelsChanged(int channelCount, int pwmValues[QGCMAVLink::maxRcChannels])
+void PX4SimpleFlightModesController::_rcChannelsChanged(const QGCMAVLink::RCChannels_t& channels)
 {
+    // Unchanged values only arrive while radio calibration requests every message
+    if (channels.changedMask == 0) {
+        return;
+    }
+
     _rcChannelValues.clear();
-    for (int i=0; i<channelCount; i++) {
-        _rcChannelValues.append(pwmValues[i]);
+    for (int i=0; i<channels.channelCount; i++) {
+        _rcChannelValues.append(channels.pwmValues[i]);
     }
     emit rcChannelValuesChanged();
 
@@ -116,12 +121,12 @@ void PX4SimpleFlightModesController::_rcChannelsChanged(int channelCount, int pw
 
     int pwmDz = pFact->rawValue().toInt();
 
-    if (flightModeChannel < 0 || flightModeChannel > channelCount) {
+    if (flightModeChannel < 0 || flightModeChannel > channels.channelCount) {
         return;
     }
 
     _activeFlightMode = 0;
-    int channelValue = pwmValues[flightModeChannel];
+    int channelValue = channels.pwmValues[flightModeChannel];
 
     if (channelValue != -1) {
         /* the half width of the range of a slot is the total range
@@ -11,6 +11,7 @@
 #include "QGCApplication.h"
 #include "ParameterManager.h"
 #include "Vehicle.h"
+#include "MAVLinkProtocol.h"
 #include "QGCLoggingCategory.h"
 
 QGC_LOGGING_CATEGORY(SensorsComponentControllerLog, "SensorsComponentControllerLog")
@@ -60,6 +61,9 @@ SensorsComponentController::SensorsComponentController(void)
 {
     connect(_vehicle, &Vehicle::sensorsParametersResetAck, this, &SensorsComponentController::_handleParametersReset);
 
+    _uiUpdateTimer.setSingleShot(true);
+    _uiUpdateTimer.setInterval(_uiUpdateIntervalMSecs);
+    (void) connect(&_uiUpdateTimer, &QTimer::timeout, this, &SensorsComponentController::_sendQueuedUiUpdates);
 }
 
 bool SensorsComponentController::usingUDPLink(void)
@@ -90,6 +94,7 @@ void SensorsComponentController::_startLogCalibration(void)
 {
     _unknownFirmwareVersion = false;
     _hideAllCalAreas();
+    _compassFit.reset();
     
     connect(_vehicle, &Vehicle::textMessageReceived, this, &SensorsComponentController::_handleUASTextMessage);
     
@@ -140,6 +145,8 @@ void SensorsComponentController::_resetInternalState(void)
 void SensorsComponentController::_stopCalibration(SensorsComponentController::StopCalibrationCode code)
 {
     disconnect(_vehicle, &Vehicle::textMessageReceived, this, &SensorsComponentController::_handleUASTextMessage);
+    qgcApp()->toolbox()->mavlinkProtocol()->unsubscribeAllMessages(this);
+    _clearQueuedUiUpdates();
     
     _compassButton->setEnabled(true);
     _gyroButton->setEnabled(true);
@@ -235,11 +242,8 @@ void SensorsComponentController::_handleUASTextMessage(int uasId, int compId, in
         bool ok;
         int p = percent.toInt(&ok);
         if (ok) {
-            if (_progressBar) {
-                _progressBar->setProperty("value", (float)(p / 100.0));
-            } else {
-                qWarning() << "Internal error";
-            }
+            _queuedProgress = p / 100.0;
+            _queueUiUpdates(UiUpdateProgress);
         }
         return;
     }
@@ -323,6 +327,7 @@ void SensorsComponentController::_handleUASTextMessage(int uasId, int compId, in
                 }
 
                 _magCalInProgress = true;
+                _subscribeMagSamples();
                 _orientationCalTailDownSideVisible =   ((sides & (1 << 0)) > 0);
                 _orientationCalNoseDownSideVisible =   ((sides & (1 << 1)) > 0);
                 _orientationCalLeftSideVisible =       ((sides & (1 << 2)) > 0);
@@ -389,8 +394,7 @@ void SensorsComponentController::_handleUASTextMessage(int uasId, int compId, in
             _orientationCalAreaHelpText->setProperty("text", tr("Hold still in the current orientation"));
         }
         
-        emit orientationCalSidesInProgressChanged();
-        emit orientationCalSidesRotateChanged();
+        _queueUiUpdates(UiUpdateSidesInProgress | UiUpdateSidesRotate);
         return;
     }
     
@@ -426,9 +430,7 @@ void SensorsComponentController::_handleUASTextMessage(int uasId, int compId, in
         
         _orientationCalAreaHelpText->setProperty("text", tr("Place you vehicle into one of the orientations shown below and hold it still"));
 
-        emit orientationCalSidesInProgressChanged();
-        emit orientationCalSidesDoneChanged();
-        emit orientationCalSidesRotateChanged();
+        _queueUiUpdates(UiUpdateSidesInProgress | UiUpdateSidesDone | UiUpdateSidesRotate);
         return;
     }
 
@@ -454,6 +456,81 @@ void SensorsComponentController::_handleUASTextMessage(int uasId, int compId, in
     }
 }
 
+/// The ground station compass fit uses the first magnetometer, from HIGHRES_IMU or SCALED_IMU whichever is streamed
+void SensorsComponentController::_subscribeMagSamples(void)
+{
+    MAVLinkProtocol* mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+
+    mavlinkProtocol->unsubscribeAllMessages(this);
+    for (uint32_t msgId : { MAVLINK_MSG_ID_HIGHRES_IMU, MAVLINK_MSG_ID_SCALED_IMU }) {
+        mavlinkProtocol->subscribeMessage(msgId, this, [this](LinkInterface* link, const mavlink_message_t& message) {
+            Q_UNUSED(link);
+            _mavlinkMessageReceived(message);
+        });
+    }
+}
+
+void SensorsComponentController::_mavlinkMessageReceived(const mavlink_message_t& message)
+{
+    if (message.sysid != _vehicle->id() || !_magCalInProgress) {
+        return;
+    }
+
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_HIGHRES_IMU:
+    {
+        mavlink_highres_imu_t highresImu;
+        mavlink_msg_highres_imu_decode(&message, &highresImu);
+        // Bits 6 to 8 flag updated magnetometer fields, which are in Gauss
+        if (highresImu.fields_updated & 0x1C0) {
+            _compassFit.addSample(QVector3D(highresImu.xmag, highresImu.ymag, highresImu.zmag) * 1000.0f);
+        }
+        break;
+    }
+    case MAVLINK_MSG_ID_SCALED_IMU:
+    {
+        mavlink_scaled_imu_t scaledImu;
+        mavlink_msg_scaled_imu_decode(&message, &scaledImu);
+        _compassFit.addSample(QVector3D(scaledImu.xmag, scaledImu.ymag, scaledImu.zmag));
+        break;
+    }
+    }
+}
+
+void SensorsComponentController::_queueUiUpdates(int uiUpdates)
+{
+    _queuedUiUpdates |= uiUpdates;
+    if (!_uiUpdateTimer.isActive()) {
+        _uiUpdateTimer.start();
+    }
+}
+
+/// Drops updates which are not sent yet, the final state is set directly when a calibration stops
+void SensorsComponentController::_clearQueuedUiUpdates(void)
+{
+    _uiUpdateTimer.stop();
+    _queuedUiUpdates = 0;
+}
+
+void SensorsComponentController::_sendQueuedUiUpdates(void)
+{
+    const int uiUpdates = _queuedUiUpdates;
+    _queuedUiUpdates = 0;
+
+    if ((uiUpdates & UiUpdateProgress) && _progressBar) {
+        _progressBar->setProperty("value", _queuedProgress);
+    }
+    if (uiUpdates & UiUpdateSidesDone) {
+        emit orientationCalSidesDoneChanged();
+    }
+    if (uiUpdates & UiUpdateSidesInProgress) {
+        emit orientationCalSidesInProgressChanged();
+    }
+    if (uiUpdates & UiUpdateSidesRotate) {
+        emit orientationCalSidesRotateChanged();
+    }
+}
+
 void SensorsComponentController::_refreshParams(void)
 {
     QStringList fastRefreshList;
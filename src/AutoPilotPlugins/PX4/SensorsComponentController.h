@@ -15,8 +15,11 @@
 
 #include <QtQuick/QQuickItem>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
 
 #include "FactPanelController.h"
+#include "CompassCalibrationFit.h"
+#include "QGCMAVLink.h"
 
 Q_DECLARE_LOGGING_CATEGORY(SensorsComponentControllerLog)
 
@@ -71,6 +74,8 @@ public:
     Q_PROPERTY(bool orientationCalTailDownSideRotate MEMBER _orientationCalTailDownSideRotate NOTIFY orientationCalSidesRotateChanged)
     
     Q_PROPERTY(bool waitingForCancel MEMBER _waitingForCancel NOTIFY waitingForCancelChanged)
+
+    Q_PROPERTY(CompassCalibrationFit* compassFit READ compassFit CONSTANT)
     
     Q_INVOKABLE void calibrateCompass(void);
     Q_INVOKABLE void calibrateGyro(void);
@@ -80,6 +85,8 @@ public:
     Q_INVOKABLE void cancelCalibration(void);
     Q_INVOKABLE bool usingUDPLink(void);
     Q_INVOKABLE void resetFactoryParameters();
+
+    CompassCalibrationFit* compassFit(void) { return &_compassFit; }
     
 signals:
     void showGyroCalAreaChanged(void);
@@ -95,6 +102,7 @@ signals:
 private slots:
     void _handleUASTextMessage(int uasId, int compId, int severity, QString text);
     void _handleParametersReset(bool success);
+    void _sendQueuedUiUpdates(void);
     
 private:
     void _startLogCalibration(void);
@@ -103,6 +111,8 @@ private:
     void _refreshParams(void);
     void _hideAllCalAreas(void);
     void _resetInternalState(void);
+    void _subscribeMagSamples(void);
+    void _mavlinkMessageReceived(const mavlink_message_t& message);
     
     enum StopCalibrationCode {
         StopCalibrationSuccess,
@@ -113,6 +123,16 @@ private:
     
     void _updateAndEmitShowOrientationCalArea(bool show);
 
+    /// Progress and side indicator changes are collected and sent to the ui at most every _uiUpdateIntervalMSecs
+    enum UiUpdate {
+        UiUpdateProgress                = 1 << 0,
+        UiUpdateSidesDone               = 1 << 1,
+        UiUpdateSidesInProgress         = 1 << 2,
+        UiUpdateSidesRotate             = 1 << 3,
+    };
+    void _queueUiUpdates(int uiUpdates);
+    void _clearQueuedUiUpdates(void);
+
     QQuickItem* _statusLog;
     QQuickItem* _progressBar;
     QQuickItem* _compassButton;
@@ -163,6 +183,13 @@ private:
     
     bool _unknownFirmwareVersion;
     bool _waitingForCancel;
+
+    CompassCalibrationFit _compassFit;
+
+    QTimer  _uiUpdateTimer;
+    int     _queuedUiUpdates = 0;
+    qreal   _queuedProgress = 0;
     
     static const int _supportedFirmwareCalVersion = 2;
+    static constexpr int _uiUpdateIntervalMSecs = 100;
 };
@@ -506,6 +506,14 @@ Item {
             anchors.right:  parent.right
         }
 
+        QGCLabel {
+            anchors.left:   parent.left
+            anchors.right:  parent.right
+            wrapMode:       Text.WordWrap
+            visible:        controller.compassFit.valid
+            text:           qsTr("Compass ground station check: %1% of directions covered, fit residual %2 mGauss").arg(Math.round(controller.compassFit.coverage * 100)).arg(controller.compassFit.residual.toFixed(1))
+        }
+
         Item { height: ScreenTools.defaultFontPixelHeight; width: 10 } // spacer
 
         Item {
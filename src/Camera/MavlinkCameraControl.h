@@ -12,6 +12,7 @@
 #include "FactGroup.h"
 
 #include <QtCore/QObject>
+#include <QtCore/QSize>
 #include <QtCore/QSizeF>
 #include <QtCore/QRectF>
 #include <QtCore/QPointF>
@@ -40,6 +41,8 @@ public:
     Q_PROPERTY(qreal        aspectRatio         READ aspectRatio        NOTIFY infoChanged)
     Q_PROPERTY(qreal        hfov                READ hfov               NOTIFY infoChanged)
     Q_PROPERTY(bool         isThermal           READ isThermal          NOTIFY infoChanged)
+    Q_PROPERTY(QSize        resolution          READ resolution         NOTIFY infoChanged)
+    Q_PROPERTY(quint32      bitrate             READ bitrate            NOTIFY infoChanged)     ///< bits/s, 0 if unknown
 
     QString uri             () const { return QString(_streamInfo.uri);  }
     QString name            () const { return QString(_streamInfo.name); }
@@ -48,6 +51,8 @@ public:
     int     type            () const{ return _streamInfo.type; }
     int     streamID        () const{ return _streamInfo.stream_id; }
     bool    isThermal       () const{ return _streamInfo.flags & VIDEO_STREAM_STATUS_FLAGS_THERMAL; }
+    QSize   resolution      () const{ return QSize(_streamInfo.resolution_h, _streamInfo.resolution_v); }
+    quint32 bitrate         () const{ return _streamInfo.bitrate; }
 
     bool    update          (const mavlink_video_stream_status_t* vs);
 
@@ -0,0 +1,498 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCCameraDefinition.h"
+#include "VehicleCameraControl.h"
+#include "FactMetaData.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QLocale>
+#include <QtXml/QDomDocument>
+#include <QtXml/QDomNodeList>
+
+QHash<QString, QSharedPointer<const QGCCameraDefinition>> QGCCameraDefinition::_cache;
+
+//-----------------------------------------------------------------------------
+static bool
+read_attribute(QDomNode& node, const char* tagName, bool& target)
+{
+    QDomNamedNodeMap attrs = node.attributes();
+    if(!attrs.count()) {
+        return false;
+    }
+    QDomNode subNode = attrs.namedItem(tagName);
+    if(subNode.isNull()) {
+        return false;
+    }
+    target = subNode.nodeValue() != "0";
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static bool
+read_attribute(QDomNode& node, const char* tagName, int& target)
+{
+    QDomNamedNodeMap attrs = node.attributes();
+    if(!attrs.count()) {
+        return false;
+    }
+    QDomNode subNode = attrs.namedItem(tagName);
+    if(subNode.isNull()) {
+        return false;
+    }
+    target = subNode.nodeValue().toInt();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static bool
+read_attribute(QDomNode& node, const char* tagName, QString& target)
+{
+    QDomNamedNodeMap attrs = node.attributes();
+    if(!attrs.count()) {
+        return false;
+    }
+    QDomNode subNode = attrs.namedItem(tagName);
+    if(subNode.isNull()) {
+        return false;
+    }
+    target = subNode.nodeValue();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static bool
+read_value(QDomNode& element, const char* tagName, QString& target)
+{
+    QDomElement de = element.firstChildElement(tagName);
+    if(de.isNull()) {
+        return false;
+    }
+    target = de.text();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static QStringList
+read_list(QDomNode& node, const char* rootTagName, const char* tagName)
+{
+    QStringList list;
+    QDomNodeList root = node.toElement().elementsByTagName(rootTagName);
+    if(root.size()) {
+        QDomNodeList items = root.item(0).toElement().elementsByTagName(tagName);
+        for(int i = 0; i < items.size(); i++) {
+            QString item = items.item(i).toElement().text();
+            if(!item.isEmpty()) {
+                list << item;
+            }
+        }
+    }
+    return list;
+}
+
+//-----------------------------------------------------------------------------
+QSharedPointer<const QGCCameraDefinition>
+QGCCameraDefinition::cached(const QString& key)
+{
+    return _cache.value(key);
+}
+
+//-----------------------------------------------------------------------------
+QString
+QGCCameraDefinition::localeName()
+{
+    QLocale locale = QLocale::system();
+#if defined (Q_OS_MAC)
+    locale = QLocale(locale.name());
+#endif
+    return locale.name().toLower().replace("-", "_");
+}
+
+//-----------------------------------------------------------------------------
+QString
+QGCCameraDefinition::cacheKey(const QString& uri, int version)
+{
+    return QStringLiteral("%1|%2|%3").arg(uri).arg(version).arg(localeName());
+}
+
+//-----------------------------------------------------------------------------
+QSharedPointer<const QGCCameraDefinition>
+QGCCameraDefinition::loadBinary(const QString& key, const QString& fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_6);
+    quint32 magic = 0;
+    quint32 binaryVersion = 0;
+    QString fileKey;
+    stream >> magic >> binaryVersion >> fileKey;
+    if(magic != _binaryMagic || binaryVersion != _binaryVersion || fileKey != key) {
+        qCDebug(CameraControlLog) << "Ignoring stale camera definition cache" << fileName;
+        return nullptr;
+    }
+    QSharedPointer<QGCCameraDefinition> definition(new QGCCameraDefinition);
+    if(!definition->_read(stream) || stream.status() != QDataStream::Ok) {
+        qCWarning(CameraControlLog) << "Could not read camera definition cache" << fileName;
+        return nullptr;
+    }
+    _cache[key] = definition;
+    return definition;
+}
+
+//-----------------------------------------------------------------------------
+QSharedPointer<const QGCCameraDefinition>
+QGCCameraDefinition::parse(const QString& key, const QByteArray& bytes, const QString& binaryFileName)
+{
+    QSharedPointer<QGCCameraDefinition> definition(new QGCCameraDefinition);
+    if(!definition->_parse(bytes)) {
+        return nullptr;
+    }
+    _cache[key] = definition;
+    if(!binaryFileName.isEmpty()) {
+        QFile file(binaryFileName);
+        if(file.open(QIODevice::WriteOnly)) {
+            QDataStream stream(&file);
+            stream.setVersion(QDataStream::Qt_6_6);
+            stream << _binaryMagic << _binaryVersion << key;
+            definition->_write(stream);
+        } else {
+            qCWarning(CameraControlLog) << "Could not save camera definition cache" << binaryFileName << file.errorString();
+        }
+    }
+    return definition;
+}
+
+//-----------------------------------------------------------------------------
+QList<QGCCameraDefinition::ConditionTest_t>
+QGCCameraDefinition::compileCondition(const QString& condition)
+{
+    QList<ConditionTest_t> tests;
+    const QStringList terms = condition.split(" ", Qt::SkipEmptyParts);
+    bool andOp = true;
+    for(int i = 0; i < terms.size(); i += 2) {
+        const QString& term = terms[i];
+        ConditionTest_t test;
+        test.andWithPrevious = andOp;
+        QString separator;
+        if(term.contains("!=")) {
+            separator = "!=";
+            test.op = ConditionNotEqual;
+        } else if(term.contains("=")) {
+            separator = "=";
+            test.op = ConditionEqual;
+        } else if(term.contains(">")) {
+            separator = ">";
+            test.op = ConditionGreater;
+        } else if(term.contains("<")) {
+            separator = "<";
+            test.op = ConditionSmaller;
+        }
+        const QStringList parts = separator.isEmpty() ? QStringList() : term.split(separator, Qt::SkipEmptyParts);
+        if(parts.size() == 2) {
+            test.param = parts[0];
+            test.value = parts[1];
+        } else {
+            qWarning() << "Invalid condition" << term << "in" << condition;
+            test.op = ConditionInvalid;
+        }
+        tests.append(test);
+        if(i + 1 < terms.size()) {
+            andOp = terms[i + 1].toUpper() == "AND";
+        }
+    }
+    return tests;
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCameraDefinition::_parse(const QByteArray& bytes)
+{
+    int errorLine;
+    QString errorMsg;
+    QDomDocument doc;
+    if(!doc.setContent(bytes, false, &errorMsg, &errorLine)) {
+        qCCritical(CameraControlLog) << "Unable to parse camera definition file on line:" << errorLine;
+        qCCritical(CameraControlLog) << errorMsg;
+        return false;
+    }
+    //-- Load camera constants
+    QDomNodeList defElements = doc.elementsByTagName(VehicleCameraControl::kDefnition);
+    if(!defElements.size()) {
+        qCWarning(CameraControlLog) <<  "Unable to load camera constants from camera definition";
+        return false;
+    }
+    QDomNode defNode = defElements.item(0);
+    if(!read_attribute(defNode, VehicleCameraControl::kVersion, version) ||
+            !read_value(defNode, VehicleCameraControl::kModel, model) ||
+            !read_value(defNode, VehicleCameraControl::kVendor, vendor)) {
+        qCWarning(CameraControlLog) <<  "Unable to load camera constants from camera definition";
+        return false;
+    }
+    //-- Load camera parameters
+    QDomNodeList paramElements = doc.elementsByTagName(VehicleCameraControl::kParameters);
+    if(!paramElements.size()) {
+        qCDebug(CameraControlLog) <<  "No parameters to load from camera";
+        return false;
+    }
+    QDomNodeList parameterNodes = paramElements.item(0).toElement().elementsByTagName(VehicleCameraControl::kParameter);
+    for(int i = 0; i < parameterNodes.size(); i++) {
+        Parameter_t parameter;
+        if(!_parseParameter(parameterNodes.item(i), parameter)) {
+            qCWarning(CameraControlLog) <<  "Unable to load camera parameters from camera definition";
+            return false;
+        }
+        parameters.append(parameter);
+    }
+    //-- Apply localization to the parsed strings
+    QDomNodeList locRoot = doc.elementsByTagName(VehicleCameraControl::kLocalization);
+    if(locRoot.size()) {
+        QHash<QString, QString> translations = _loadTranslations(locRoot.item(0));
+        if(!translations.isEmpty()) {
+            _localize(translations);
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCameraDefinition::_parseParameter(QDomNode parameterNode, Parameter_t& parameter)
+{
+    if(!read_attribute(parameterNode, VehicleCameraControl::kName, parameter.name)) {
+        qCritical() << "Parameter entry missing parameter name";
+        return false;
+    }
+    const QString& factName = parameter.name;
+    if(!read_attribute(parameterNode, VehicleCameraControl::kType, parameter.type)) {
+        qCritical() << QString("Parameter %1 missing parameter type").arg(factName);
+        return false;
+    }
+    bool unknownType;
+    FactMetaData::stringToType(parameter.type, unknownType);
+    if(unknownType) {
+        qCritical() << QString("Unknown type for parameter %1").arg(factName);
+        return false;
+    }
+    read_attribute(parameterNode, VehicleCameraControl::kControl,   parameter.control);
+    read_attribute(parameterNode, VehicleCameraControl::kReadOnly,  parameter.readOnly);
+    read_attribute(parameterNode, VehicleCameraControl::kWriteOnly, parameter.writeOnly);
+    if(!read_value(parameterNode, VehicleCameraControl::kDescription, parameter.description)) {
+        qCritical() << QString("Parameter %1 missing parameter description").arg(factName);
+        return false;
+    }
+    parameter.updates = read_list(parameterNode, VehicleCameraControl::kUpdates, VehicleCameraControl::kUpdate);
+    //-- Options (enums)
+    QDomNodeList optionsRoot = parameterNode.toElement().elementsByTagName(VehicleCameraControl::kOptions);
+    if(optionsRoot.size()) {
+        QDomNodeList options = optionsRoot.item(0).toElement().elementsByTagName(VehicleCameraControl::kOption);
+        for(int i = 0; i < options.size(); i++) {
+            QDomNode optionNode = options.item(i);
+            Option_t option;
+            if(!read_attribute(optionNode, VehicleCameraControl::kName, option.name)) {
+                qCritical() << QString("Malformed option for parameter %1").arg(factName);
+                return false;
+            }
+            if(!read_attribute(optionNode, VehicleCameraControl::kValue, option.value)) {
+                qCritical() << QString("Malformed value for parameter %1").arg(factName);
+                return false;
+            }
+            option.exclusions = read_list(optionNode, VehicleCameraControl::kExclusions, VehicleCameraControl::kExclusion);
+            if(!_parseRanges(optionNode, factName, option.ranges)) {
+                return false;
+            }
+            parameter.options.append(option);
+        }
+    }
+    read_attribute(parameterNode, VehicleCameraControl::kDefault,       parameter.defaultValue);
+    read_attribute(parameterNode, VehicleCameraControl::kMin,           parameter.min);
+    read_attribute(parameterNode, VehicleCameraControl::kMax,           parameter.max);
+    read_attribute(parameterNode, VehicleCameraControl::kStep,          parameter.step);
+    read_attribute(parameterNode, VehicleCameraControl::kDecimalPlaces, parameter.decimalPlaces);
+    read_attribute(parameterNode, VehicleCameraControl::kUnit,          parameter.unit);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCameraDefinition::_parseRanges(QDomNode option, const QString& factName, QList<Range_t>& ranges)
+{
+    QDomNodeList rangeRoot = option.toElement().elementsByTagName(VehicleCameraControl::kParameterranges);
+    if(!rangeRoot.size()) {
+        return true;
+    }
+    QDomNodeList parameterRanges = rangeRoot.item(0).toElement().elementsByTagName(VehicleCameraControl::kParameterrange);
+    for(int i = 0; i < parameterRanges.size(); i++) {
+        QDomNode paramRange = parameterRanges.item(i);
+        Range_t range;
+        if(!read_attribute(paramRange, VehicleCameraControl::kParameter, range.targetParam)) {
+            qCritical() << QString("Malformed option range for parameter %1").arg(factName);
+            return false;
+        }
+        read_attribute(paramRange, VehicleCameraControl::kCondition, range.condition);
+        QDomNodeList rangeOptions = paramRange.toElement().elementsByTagName(VehicleCameraControl::kRoption);
+        for(int j = 0; j < rangeOptions.size(); j++) {
+            QString optName;
+            QString optValue;
+            QDomNode roption = rangeOptions.item(j);
+            if(!read_attribute(roption, VehicleCameraControl::kName, optName)) {
+                qCritical() << QString("Malformed roption for parameter %1").arg(factName);
+                return false;
+            }
+            if(!read_attribute(roption, VehicleCameraControl::kValue, optValue)) {
+                qCritical() << QString("Malformed rvalue for parameter %1").arg(factName);
+                return false;
+            }
+            range.optNames  << optName;
+            range.optValues << optValue;
+        }
+        if(range.optNames.size()) {
+            range.conditionTests = compileCondition(range.condition);
+            ranges.append(range);
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+QHash<QString, QString>
+QGCCameraDefinition::_loadTranslations(QDomNode localizationNode)
+{
+    QHash<QString, QString> translations;
+    QString currentLocale = localeName();
+    qCDebug(CameraControlLog) << "Current locale:" << currentLocale;
+    if(currentLocale == "en_us") {
+        return translations;
+    }
+    QDomNodeList locales = localizationNode.toElement().elementsByTagName(VehicleCameraControl::kLocale);
+    QDomNode match;
+    //-- Look for a direct match first
+    for(int i = 0; i < locales.size() && match.isNull(); i++) {
+        QDomNode locale = locales.item(i);
+        QString name;
+        if(!read_attribute(locale, VehicleCameraControl::kName, name)) {
+            qWarning() << "Localization entry is missing its name attribute";
+            continue;
+        }
+        if(currentLocale == name.toLower().replace("-", "_")) {
+            match = locale;
+        }
+    }
+    //-- No direct match. Pick first matching language (if any)
+    const QString language = currentLocale.left(3);
+    for(int i = 0; i < locales.size() && match.isNull(); i++) {
+        QDomNode locale = locales.item(i);
+        QString name;
+        read_attribute(locale, VehicleCameraControl::kName, name);
+        if(name.toLower().startsWith(language)) {
+            match = locale;
+        }
+    }
+    if(match.isNull()) {
+        //-- Just use default, en_US
+        qWarning() <<  "No match for" << QLocale::system().name() << "in camera definition file";
+        return translations;
+    }
+    QDomNodeList strings = match.toElement().elementsByTagName(VehicleCameraControl::kStrings);
+    for(int i = 0; i < strings.size(); i++) {
+        QDomNode stringNode = strings.item(i);
+        QString original;
+        QString translated;
+        if(read_attribute(stringNode, VehicleCameraControl::kOriginal, original) && read_attribute(stringNode, VehicleCameraControl::kTranslated, translated)) {
+            translations[original] = translated;
+        }
+    }
+    return translations;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraDefinition::_localize(const QHash<QString, QString>& translations)
+{
+    auto translate = [&translations](QString& string) {
+        auto it = translations.constFind(string);
+        if(it != translations.constEnd()) {
+            string = it.value();
+        }
+    };
+    for(Parameter_t& parameter: parameters) {
+        translate(parameter.description);
+        for(Option_t& option: parameter.options) {
+            translate(option.name);
+            for(Range_t& range: option.ranges) {
+                for(QString& optName: range.optNames) {
+                    translate(optName);
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCameraDefinition::_write(QDataStream& stream) const
+{
+    stream << static_cast<qint32>(version) << model << vendor << static_cast<qint32>(parameters.size());
+    for(const Parameter_t& parameter: parameters) {
+        stream << parameter.name << parameter.type << parameter.control << parameter.readOnly << parameter.writeOnly
+               << parameter.description << parameter.updates
+               << parameter.defaultValue << parameter.min << parameter.max << parameter.step << parameter.decimalPlaces << parameter.unit
+               << static_cast<qint32>(parameter.options.size());
+        for(const Option_t& option: parameter.options) {
+            stream << option.name << option.value << option.exclusions << static_cast<qint32>(option.ranges.size());
+            for(const Range_t& range: option.ranges) {
+                stream << range.targetParam << range.condition << range.optNames << range.optValues << static_cast<qint32>(range.conditionTests.size());
+                for(const ConditionTest_t& test: range.conditionTests) {
+                    stream << test.param << static_cast<qint32>(test.op) << test.value << test.andWithPrevious;
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCameraDefinition::_read(QDataStream& stream)
+{
+    qint32 value = 0;
+    qint32 parameterCount = 0;
+    stream >> value >> model >> vendor >> parameterCount;
+    version = value;
+    for(qint32 i = 0; i < parameterCount && stream.status() == QDataStream::Ok; i++) {
+        Parameter_t parameter;
+        qint32 optionCount = 0;
+        stream >> parameter.name >> parameter.type >> parameter.control >> parameter.readOnly >> parameter.writeOnly
+               >> parameter.description >> parameter.updates
+               >> parameter.defaultValue >> parameter.min >> parameter.max >> parameter.step >> parameter.decimalPlaces >> parameter.unit
+               >> optionCount;
+        for(qint32 j = 0; j < optionCount && stream.status() == QDataStream::Ok; j++) {
+            Option_t option;
+            qint32 rangeCount = 0;
+            stream >> option.name >> option.value >> option.exclusions >> rangeCount;
+            for(qint32 k = 0; k < rangeCount && stream.status() == QDataStream::Ok; k++) {
+                Range_t range;
+                qint32 testCount = 0;
+                stream >> range.targetParam >> range.condition >> range.optNames >> range.optValues >> testCount;
+                for(qint32 l = 0; l < testCount && stream.status() == QDataStream::Ok; l++) {
+                    ConditionTest_t test;
+                    stream >> test.param >> value >> test.value >> test.andWithPrevious;
+                    test.op = static_cast<ConditionOp_t>(value);
+                    range.conditionTests.append(test);
+                }
+                option.ranges.append(range);
+            }
+            parameter.options.append(option);
+        }
+        parameters.append(parameter);
+    }
+    return stream.status() == QDataStream::Ok;
+}
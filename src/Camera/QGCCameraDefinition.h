@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+class QDataStream;
+class QDomNode;
+
+//-----------------------------------------------------------------------------
+/// Parsed camera definition file (MAVLink camera protocol XML). Parsing is done once per definition URI, version
+/// and locale: the result is kept in a process wide cache shared by all cameras of all vehicles, and written next to
+/// the XML cache file in binary form so later sessions skip the XML parse entirely.
+///
+/// Localization is already applied and range conditions are already compiled into tests, so a camera only has to
+/// build its Facts from it.
+class QGCCameraDefinition
+{
+public:
+    enum ConditionOp_t {
+        ConditionInvalid,
+        ConditionEqual,
+        ConditionNotEqual,
+        ConditionGreater,
+        ConditionSmaller,
+    };
+
+    /// Single "PARAM=value" term of a range condition
+    struct ConditionTest_t {
+        QString         param;
+        ConditionOp_t   op              = ConditionInvalid;
+        QString         value;
+        bool            andWithPrevious = true; ///< Combined with the result so far using AND, otherwise OR
+    };
+
+    struct Range_t {
+        QString                 targetParam;
+        QString                 condition;      ///< Original condition string, for logging
+        QList<ConditionTest_t>  conditionTests;
+        QStringList             optNames;
+        QStringList             optValues;
+    };
+
+    struct Option_t {
+        QString         name;
+        QString         value;
+        QStringList     exclusions;
+        QList<Range_t>  ranges;
+    };
+
+    /// Optional attributes which are not present in the file are null strings
+    struct Parameter_t {
+        QString         name;
+        QString         type;
+        bool            control     = true;
+        bool            readOnly    = false;
+        bool            writeOnly   = false;
+        QString         description;
+        QStringList     updates;
+        QList<Option_t> options;
+        QString         defaultValue;
+        QString         min;
+        QString         max;
+        QString         step;
+        QString         decimalPlaces;
+        QString         unit;
+    };
+
+    int                 version = 0;
+    QString             model;
+    QString             vendor;
+    QList<Parameter_t>  parameters;
+
+    /// @return Parsed definition for the key if it was loaded before in this session, null otherwise
+    static QSharedPointer<const QGCCameraDefinition> cached(const QString& key);
+
+    /// Loads a definition from its binary cache file and adds it to the session cache
+    ///     @return null if the file does not exist or was written for another key or format
+    static QSharedPointer<const QGCCameraDefinition> loadBinary(const QString& key, const QString& fileName);
+
+    /// Parses the definition XML, adds it to the session cache and writes the binary cache file
+    ///     @param binaryFileName Binary cache file to write, empty to skip it
+    ///     @return null if the XML is not a valid camera definition
+    static QSharedPointer<const QGCCameraDefinition> parse(const QString& key, const QByteArray& bytes, const QString& binaryFileName);
+
+    /// @return Cache key for a definition URI and version in the current locale
+    static QString cacheKey(const QString& uri, int version);
+
+    /// @return Current locale in the form used by camera definition files (lower case, '_' separated)
+    static QString localeName();
+
+    /// Splits a range condition ("PARAM1=1 AND PARAM2!=2 OR ...") into tests evaluated left to right
+    static QList<ConditionTest_t> compileCondition(const QString& condition);
+
+private:
+    bool _parse                 (const QByteArray& bytes);
+    bool _parseParameter        (QDomNode parameterNode, Parameter_t& parameter);
+    bool _parseRanges           (QDomNode option, const QString& factName, QList<Range_t>& ranges);
+    void _localize              (const QHash<QString, QString>& translations);
+    void _write                 (QDataStream& stream) const;
+    bool _read                  (QDataStream& stream);
+
+    static QHash<QString, QString> _loadTranslations(QDomNode localizationNode);
+
+    static QHash<QString, QSharedPointer<const QGCCameraDefinition>> _cache;
+
+    static constexpr quint32 _binaryMagic   = 0x51434446;   // "QCDF"
+    static constexpr quint32 _binaryVersion = 1;
+};
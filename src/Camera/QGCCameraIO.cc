@@ -29,6 +29,7 @@ QGCCameraParamIO::QGCCameraParamIO(MavlinkCameraControl *control, Fact* fact, Ve
     , _vehicle(vehicle)
     , _sentRetries(0)
     , _requestRetries(0)
+    , _paramRequestReceived(false)
     , _done(false)
     , _updateOnSet(false)
     , _forceUIUpdate(false)
@@ -99,7 +100,6 @@ QGCCameraParamIO::setParamRequest()
     if(!_fact->writeOnly()) {
         _paramRequestReceived = false;
         _requestRetries = 0;
-        _paramRequestTimer.start();
     }
 }
 
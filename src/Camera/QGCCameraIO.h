@@ -49,6 +49,7 @@ public:
     void        handleParamValue            (const mavlink_param_ext_value_t& value);
     void        setParamRequest             ();
     bool        paramDone                   () const { return _done; }
+    bool        paramReceived               () const { return _paramRequestReceived; }
     void        paramRequest                (bool reset = true);
     void        sendParameter               (bool updateUI = false);
 
@@ -16,6 +16,7 @@
 
 #include "VehicleCameraControl.h"
 #include "QGCCameraIO.h"
+#include "QGCCameraDefinition.h"
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "VideoManager.h"
@@ -30,8 +31,6 @@
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtCore/QDir>
 #include <QtCore/QSettings>
-#include <QtXml/QDomDocument>
-#include <QtXml/QDomNodeList>
 #include <QtQml/QQmlEngine>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QNetworkReply>
@@ -57,66 +56,6 @@ QGCCameraOptionRange::QGCCameraOptionRange(QObject* parent, QString param_, QStr
 {
 }
 
-//-----------------------------------------------------------------------------
-static bool
-read_attribute(QDomNode& node, const char* tagName, bool& target)
-{
-    QDomNamedNodeMap attrs = node.attributes();
-    if(!attrs.count()) {
-        return false;
-    }
-    QDomNode subNode = attrs.namedItem(tagName);
-    if(subNode.isNull()) {
-        return false;
-    }
-    target = subNode.nodeValue() != "0";
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-static bool
-read_attribute(QDomNode& node, const char* tagName, int& target)
-{
-    QDomNamedNodeMap attrs = node.attributes();
-    if(!attrs.count()) {
-        return false;
-    }
-    QDomNode subNode = attrs.namedItem(tagName);
-    if(subNode.isNull()) {
-        return false;
-    }
-    target = subNode.nodeValue().toInt();
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-static bool
-read_attribute(QDomNode& node, const char* tagName, QString& target)
-{
-    QDomNamedNodeMap attrs = node.attributes();
-    if(!attrs.count()) {
-        return false;
-    }
-    QDomNode subNode = attrs.namedItem(tagName);
-    if(subNode.isNull()) {
-        return false;
-    }
-    target = subNode.nodeValue();
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-static bool
-read_value(QDomNode& element, const char* tagName, QString& target)
-{
-    QDomElement de = element.firstChildElement(tagName);
-    if(de.isNull()) {
-        return false;
-    }
-    target = de.text();
-    return true;
-}
-
 //-----------------------------------------------------------------------------
 VehicleCameraControl::VehicleCameraControl(const mavlink_camera_information_t *info, Vehicle* vehicle, int compID, QObject* parent)
     : MavlinkCameraControl(parent)
@@ -126,6 +65,12 @@ VehicleCameraControl::VehicleCameraControl(const mavlink_camera_information_t *i
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
     memcpy(&_info, info, sizeof(mavlink_camera_information_t));
     connect(this, &VehicleCameraControl::dataReady, this, &VehicleCameraControl::_dataReady);
+    _paramListTimer.setSingleShot(true);
+    _paramListTimer.setInterval(_paramListIdleMsecs);
+    connect(&_paramListTimer, &QTimer::timeout, this, &VehicleCameraControl::_paramListTimeout);
+    _paramReadTimer.setSingleShot(true);
+    connect(&_paramReadTimer, &QTimer::timeout, this, &VehicleCameraControl::_paramReadTimeout);
+    _paramValueTimer.start();
     _vendor = QString(reinterpret_cast<const char*>(info->vendor_name));
     _modelName = QString(reinterpret_cast<const char*>(info->model_name));
     int ver = static_cast<int>(_info.cam_definition_version);
@@ -134,7 +79,9 @@ VehicleCameraControl::VehicleCameraControl(const mavlink_camera_information_t *i
         _vendor.toStdString().c_str(),
         _modelName.toStdString().c_str(),
         ver);
+    _binaryCacheFile = _cacheFile.chopped(4) + ".bin";
     if(info->cam_definition_uri[0] != 0) {
+        _definitionKey = QGCCameraDefinition::cacheKey(QString(reinterpret_cast<const char*>(info->cam_definition_uri)), ver);
         //-- Process camera definition file
         _handleDefinitionFile(info->cam_definition_uri);
     } else {
@@ -776,33 +723,8 @@ VehicleCameraControl::_setPhotoStatus(PhotoCaptureStatus status)
 bool
 VehicleCameraControl::_loadCameraDefinitionFile(QByteArray& bytes)
 {
-    QByteArray originalData(bytes);
-    //-- Handle localization
-    if(!_handleLocalization(bytes)) {
-        return false;
-    }
-    int errorLine;
-    QString errorMsg;
-    QDomDocument doc;
-    if(!doc.setContent(bytes, false, &errorMsg, &errorLine)) {
-        qCCritical(CameraControlLog) << "Unable to parse camera definition file on line:" << errorLine;
-        qCCritical(CameraControlLog) << errorMsg;
-        return false;
-    }
-    //-- Load camera constants
-    QDomNodeList defElements = doc.elementsByTagName(kDefnition);
-    if(!defElements.size() || !_loadConstants(defElements)) {
-        qCWarning(CameraControlLog) <<  "Unable to load camera constants from camera definition";
-        return false;
-    }
-    //-- Load camera parameters
-    QDomNodeList paramElements = doc.elementsByTagName(kParameters);
-    if(!paramElements.size()) {
-        qCDebug(CameraControlLog) <<  "No parameters to load from camera";
-        return false;
-    }
-    if(!_loadSettings(paramElements)) {
-        qCWarning(CameraControlLog) <<  "Unable to load camera parameters from camera definition";
+    QSharedPointer<const QGCCameraDefinition> definition = QGCCameraDefinition::parse(_definitionKey, bytes, _binaryCacheFile);
+    if(!definition || !_loadDefinition(definition)) {
         return false;
     }
     //-- If this is new, cache it
@@ -812,7 +734,7 @@ VehicleCameraControl::_loadCameraDefinitionFile(QByteArray& bytes)
         if (!file.open(QIODevice::WriteOnly)) {
             qWarning() << QString("Could not save cache file %1. Error: %2").arg(_cacheFile).arg(file.errorString());
         } else {
-            file.write(originalData);
+            file.write(bytes);
         }
     }
     return true;
@@ -820,232 +742,153 @@ VehicleCameraControl::_loadCameraDefinitionFile(QByteArray& bytes)
 
 //-----------------------------------------------------------------------------
 bool
-VehicleCameraControl::_loadConstants(const QDomNodeList nodeList)
+VehicleCameraControl::_loadDefinition(QSharedPointer<const QGCCameraDefinition> definition)
 {
-    QDomNode node = nodeList.item(0);
-    if(!read_attribute(node, kVersion, _version)) {
-        return false;
-    }
-    if(!read_value(node, kModel, _modelName)) {
-        return false;
-    }
-    if(!read_value(node, kVendor, _vendor)) {
-        return false;
-    }
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-bool
-VehicleCameraControl::_loadSettings(const QDomNodeList nodeList)
-{
-    QDomNode node = nodeList.item(0);
-    QDomElement elem = node.toElement();
-    QDomNodeList parameters = elem.elementsByTagName(kParameter);
+    _version    = definition->version;
+    _modelName  = definition->model;
+    _vendor     = definition->vendor;
     //-- Pre-process settings (maintain order and skip non-controls)
-    for(int i = 0; i < parameters.size(); i++) {
-        QDomNode parameterNode = parameters.item(i);
-        QString name;
-        if(read_attribute(parameterNode, kName, name)) {
-            bool control = true;
-            read_attribute(parameterNode, kControl, control);
-            if(control) {
-                _settings << name;
-            }
-        } else {
-            qCritical() << "Parameter entry missing parameter name";
-            return false;
+    for(const QGCCameraDefinition::Parameter_t& parameter: definition->parameters) {
+        if(parameter.control) {
+            _settings << parameter.name;
         }
     }
     //-- Load parameters
-    for(int i = 0; i < parameters.size(); i++) {
-        QDomNode parameterNode = parameters.item(i);
-        QString factName;
-        read_attribute(parameterNode, kName, factName);
-        QString type;
-        if(!read_attribute(parameterNode, kType, type)) {
-            qCritical() << QString("Parameter %1 missing parameter type").arg(factName);
-            return false;
-        }
-        //-- Does it have a control?
-        bool control = true;
-        read_attribute(parameterNode, kControl, control);
-        //-- Is it read only?
-        bool readOnly = false;
-        read_attribute(parameterNode, kReadOnly, readOnly);
-        //-- Is it write only?
-        bool writeOnly = false;
-        read_attribute(parameterNode, kWriteOnly, writeOnly);
+    for(const QGCCameraDefinition::Parameter_t& parameter: definition->parameters) {
+        const QString& factName = parameter.name;
         //-- It can't be both
-        if(readOnly && writeOnly) {
+        if(parameter.readOnly && parameter.writeOnly) {
             qCritical() << QString("Parameter %1 cannot be both read only and write only").arg(factName);
         }
-        //-- Param type
+        //-- Param type, validated when the definition was parsed
         bool unknownType;
-        FactMetaData::ValueType_t factType = FactMetaData::stringToType(type, unknownType);
-        if (unknownType) {
-            qCritical() << QString("Unknown type for parameter %1").arg(factName);
-            return false;
-        }
+        FactMetaData::ValueType_t factType = FactMetaData::stringToType(parameter.type, unknownType);
         //-- By definition, custom types do not have control
-        if(factType == FactMetaData::valueTypeCustom) {
-            control = false;
-        }
-        //-- Description
-        QString description;
-        if(!read_value(parameterNode, kDescription, description)) {
-            qCritical() << QString("Parameter %1 missing parameter description").arg(factName);
-            return false;
-        }
+        bool control = parameter.control && factType != FactMetaData::valueTypeCustom;
         //-- Check for updates
-        QStringList updates = _loadUpdates(parameterNode);
-        if(updates.size()) {
-            qCDebug(CameraControlVerboseLog) << "Parameter" << factName << "requires updates for:" << updates;
-            _requestUpdates[factName] = updates;
+        if(parameter.updates.size()) {
+            qCDebug(CameraControlVerboseLog) << "Parameter" << factName << "requires updates for:" << parameter.updates;
+            _requestUpdates[factName] = parameter.updates;
+        }
+        if (_nameToFactMetaDataMap.contains(factName)) {
+            qWarning() << QStringLiteral("Duplicate fact name:") << factName;
+            continue;
         }
         //-- Build metadata
         FactMetaData* metaData = new FactMetaData(factType, factName, this);
         QQmlEngine::setObjectOwnership(metaData, QQmlEngine::CppOwnership);
-        metaData->setShortDescription(description);
-        metaData->setLongDescription(description);
+        metaData->setShortDescription(parameter.description);
+        metaData->setLongDescription(parameter.description);
         metaData->setHasControl(control);
-        metaData->setReadOnly(readOnly);
-        metaData->setWriteOnly(writeOnly);
+        metaData->setReadOnly(parameter.readOnly);
+        metaData->setWriteOnly(parameter.writeOnly);
         //-- Options (enums)
-        QDomElement optionElem = parameterNode.toElement();
-        QDomNodeList optionsRoot = optionElem.elementsByTagName(kOptions);
-        if(optionsRoot.size()) {
-            //-- Iterate options
-            QDomNode node = optionsRoot.item(0);
-            QDomElement elem = node.toElement();
-            QDomNodeList options = elem.elementsByTagName(kOption);
-            for(int i = 0; i < options.size(); i++) {
-                QDomNode option = options.item(i);
-                QString optName;
-                QString optValue;
-                QVariant optVariant;
-                if(!_loadNameValue(option, factName, metaData, optName, optValue, optVariant)) {
-                    delete metaData;
-                    return false;
-                }
-                metaData->addEnumInfo(optName, optVariant);
-                _originalOptNames[factName]  << optName;
-                _originalOptValues[factName] << optVariant;
-                //-- Check for exclusions
-                QStringList exclusions = _loadExclusions(option);
-                if(exclusions.size()) {
-                    qCDebug(CameraControlVerboseLog) << "New exclusions:" << factName << optValue << exclusions;
-                    QGCCameraOptionExclusion* pExc = new QGCCameraOptionExclusion(this, factName, optValue, exclusions);
-                    QQmlEngine::setObjectOwnership(pExc, QQmlEngine::CppOwnership);
-                    _valueExclusions.append(pExc);
-                }
-                //-- Check for range rules
-                if(!_loadRanges(option, factName, optValue)) {
-                    delete metaData;
-                    return false;
-                }
+        for(const QGCCameraDefinition::Option_t& option: parameter.options) {
+            QVariant optVariant;
+            QString  errorString;
+            if (!metaData->convertAndValidateRaw(option.value, false, optVariant, errorString)) {
+                qWarning() << "Invalid option value, name:" << factName
+                           << " type:"  << metaData->type()
+                           << " value:" << option.value
+                           << " error:" << errorString;
+            }
+            metaData->addEnumInfo(option.name, optVariant);
+            _originalOptNames[factName]  << option.name;
+            _originalOptValues[factName] << optVariant;
+            //-- Check for exclusions
+            if(option.exclusions.size()) {
+                qCDebug(CameraControlVerboseLog) << "New exclusions:" << factName << option.value << option.exclusions;
+                QGCCameraOptionExclusion* pExc = new QGCCameraOptionExclusion(this, factName, option.value, option.exclusions);
+                QQmlEngine::setObjectOwnership(pExc, QQmlEngine::CppOwnership);
+                _valueExclusions.append(pExc);
+            }
+            //-- Check for range rules
+            for(const QGCCameraDefinition::Range_t& range: option.ranges) {
+                QGCCameraOptionRange* pRange = new QGCCameraOptionRange(this, factName, option.value, range.targetParam, range.condition, range.optNames, range.optValues);
+                pRange->conditionTests = range.conditionTests;
+                _optionRanges.append(pRange);
+                qCDebug(CameraControlVerboseLog) << "New range limit:" << factName << option.value << range.targetParam << range.condition << range.optNames << range.optValues;
             }
         }
-        QString defaultValue;
-        if(read_attribute(parameterNode, kDefault, defaultValue)) {
+        if(!parameter.defaultValue.isNull()) {
             QVariant defaultVariant;
             QString  errorString;
-            if (metaData->convertAndValidateRaw(defaultValue, false, defaultVariant, errorString)) {
+            if (metaData->convertAndValidateRaw(parameter.defaultValue, false, defaultVariant, errorString)) {
                 metaData->setRawDefaultValue(defaultVariant);
             } else {
                 qWarning() << "Invalid default value for" << factName
                            << " type:"  << metaData->type()
-                           << " value:" << defaultValue
+                           << " value:" << parameter.defaultValue
                            << " error:" << errorString;
             }
         }
-        //-- Set metadata and Fact
-        if (_nameToFactMetaDataMap.contains(factName)) {
-            qWarning() << QStringLiteral("Duplicate fact name:") << factName;
-            delete metaData;
-        } else {
-            {
-                //-- Check for Min Value
-                QString attr;
-                if(read_attribute(parameterNode, kMin, attr)) {
-                    QVariant typedValue;
-                    QString  errorString;
-                    if (metaData->convertAndValidateRaw(attr, true /* convertOnly */, typedValue, errorString)) {
-                        metaData->setRawMin(typedValue);
-                    } else {
-                        qWarning() << "Invalid min value for" << factName
-                                   << " type:"  << metaData->type()
-                                   << " value:" << attr
-                                   << " error:" << errorString;
-                    }
-                }
-            }
-            {
-                //-- Check for Max Value
-                QString attr;
-                if(read_attribute(parameterNode, kMax, attr)) {
-                    QVariant typedValue;
-                    QString  errorString;
-                    if (metaData->convertAndValidateRaw(attr, true /* convertOnly */, typedValue, errorString)) {
-                        metaData->setRawMax(typedValue);
-                    } else {
-                        qWarning() << "Invalid max value for" << factName
-                                   << " type:"  << metaData->type()
-                                   << " value:" << attr
-                                   << " error:" << errorString;
-                    }
-                }
+        //-- Check for Min Value
+        if(!parameter.min.isNull()) {
+            QVariant typedValue;
+            QString  errorString;
+            if (metaData->convertAndValidateRaw(parameter.min, true /* convertOnly */, typedValue, errorString)) {
+                metaData->setRawMin(typedValue);
+            } else {
+                qWarning() << "Invalid min value for" << factName
+                           << " type:"  << metaData->type()
+                           << " value:" << parameter.min
+                           << " error:" << errorString;
             }
-            {
-                //-- Check for Step Value
-                QString attr;
-                if(read_attribute(parameterNode, kStep, attr)) {
-                    QVariant typedValue;
-                    QString  errorString;
-                    if (metaData->convertAndValidateRaw(attr, true /* convertOnly */, typedValue, errorString)) {
-                        metaData->setRawIncrement(typedValue.toDouble());
-                    } else {
-                        qWarning() << "Invalid step value for" << factName
-                                   << " type:"  << metaData->type()
-                                   << " value:" << attr
-                                   << " error:" << errorString;
-                    }
-                }
+        }
+        //-- Check for Max Value
+        if(!parameter.max.isNull()) {
+            QVariant typedValue;
+            QString  errorString;
+            if (metaData->convertAndValidateRaw(parameter.max, true /* convertOnly */, typedValue, errorString)) {
+                metaData->setRawMax(typedValue);
+            } else {
+                qWarning() << "Invalid max value for" << factName
+                           << " type:"  << metaData->type()
+                           << " value:" << parameter.max
+                           << " error:" << errorString;
             }
-            {
-                //-- Check for Decimal Places
-                QString attr;
-                if(read_attribute(parameterNode, kDecimalPlaces, attr)) {
-                    QVariant typedValue;
-                    QString  errorString;
-                    if (metaData->convertAndValidateRaw(attr, true /* convertOnly */, typedValue, errorString)) {
-                        metaData->setDecimalPlaces(typedValue.toInt());
-                    } else {
-                        qWarning() << "Invalid decimal places value for" << factName
-                                   << " type:"  << metaData->type()
-                                   << " value:" << attr
-                                   << " error:" << errorString;
-                    }
-                }
+        }
+        //-- Check for Step Value
+        if(!parameter.step.isNull()) {
+            QVariant typedValue;
+            QString  errorString;
+            if (metaData->convertAndValidateRaw(parameter.step, true /* convertOnly */, typedValue, errorString)) {
+                metaData->setRawIncrement(typedValue.toDouble());
+            } else {
+                qWarning() << "Invalid step value for" << factName
+                           << " type:"  << metaData->type()
+                           << " value:" << parameter.step
+                           << " error:" << errorString;
             }
-            {
-                //-- Check for Units
-                QString attr;
-                if(read_attribute(parameterNode, kUnit, attr)) {
-                    metaData->setRawUnits(attr);
-                }
+        }
+        //-- Check for Decimal Places
+        if(!parameter.decimalPlaces.isNull()) {
+            QVariant typedValue;
+            QString  errorString;
+            if (metaData->convertAndValidateRaw(parameter.decimalPlaces, true /* convertOnly */, typedValue, errorString)) {
+                metaData->setDecimalPlaces(typedValue.toInt());
+            } else {
+                qWarning() << "Invalid decimal places value for" << factName
+                           << " type:"  << metaData->type()
+                           << " value:" << parameter.decimalPlaces
+                           << " error:" << errorString;
             }
-            qCDebug(CameraControlLog) << "New parameter:" << factName << (readOnly ? "ReadOnly" : "Writable") << (writeOnly ? "WriteOnly" : "Readable");
-            _nameToFactMetaDataMap[factName] = metaData;
-            Fact* pFact = new Fact(_compID, factName, factType, this);
-            QQmlEngine::setObjectOwnership(pFact, QQmlEngine::CppOwnership);
-            pFact->setMetaData(metaData);
-            pFact->_containerSetRawValue(metaData->rawDefaultValue());
-            QGCCameraParamIO* pIO = new QGCCameraParamIO(this, pFact, _vehicle);
-            QQmlEngine::setObjectOwnership(pIO, QQmlEngine::CppOwnership);
-            _paramIO[factName] = pIO;
-            _addFact(pFact, factName);
         }
+        //-- Check for Units
+        if(!parameter.unit.isNull()) {
+            metaData->setRawUnits(parameter.unit);
+        }
+        //-- Set metadata and Fact
+        qCDebug(CameraControlLog) << "New parameter:" << factName << (parameter.readOnly ? "ReadOnly" : "Writable") << (parameter.writeOnly ? "WriteOnly" : "Readable");
+        _nameToFactMetaDataMap[factName] = metaData;
+        Fact* pFact = new Fact(_compID, factName, factType, this);
+        QQmlEngine::setObjectOwnership(pFact, QQmlEngine::CppOwnership);
+        pFact->setMetaData(metaData);
+        pFact->_containerSetRawValue(metaData->rawDefaultValue());
+        QGCCameraParamIO* pIO = new QGCCameraParamIO(this, pFact, _vehicle);
+        QQmlEngine::setObjectOwnership(pIO, QQmlEngine::CppOwnership);
+        _paramIO[factName] = pIO;
+        _addFact(pFact, factName);
     }
     if(_nameToFactMetaDataMap.size() > 0) {
         _addFactGroup(this, "camera");
@@ -1057,90 +900,6 @@ VehicleCameraControl::_loadSettings(const QDomNodeList nodeList)
     return false;
 }
 
-//-----------------------------------------------------------------------------
-bool
-VehicleCameraControl::_handleLocalization(QByteArray& bytes)
-{
-    QString errorMsg;
-    int errorLine;
-    QDomDocument doc;
-    if(!doc.setContent(bytes, false, &errorMsg, &errorLine)) {
-        qCritical() << "Unable to parse camera definition file on line:" << errorLine;
-        qCritical() << errorMsg;
-        return false;
-    }
-    //-- Find out where we are
-    QLocale locale = QLocale::system();
-#if defined (Q_OS_MAC)
-    locale = QLocale(locale.name());
-#endif
-    QString localeName = locale.name().toLower().replace("-", "_");
-    qCDebug(CameraControlLog) << "Current locale:" << localeName;
-    if(localeName == "en_us") {
-        // Nothing to do
-        return true;
-    }
-    QDomNodeList locRoot = doc.elementsByTagName(kLocalization);
-    if(!locRoot.size()) {
-        // Nothing to do
-        return true;
-    }
-    //-- Iterate locales
-    QDomNode node = locRoot.item(0);
-    QDomElement elem = node.toElement();
-    QDomNodeList locales = elem.elementsByTagName(kLocale);
-    for(int i = 0; i < locales.size(); i++) {
-        QDomNode locale = locales.item(i);
-        QString name;
-        if(!read_attribute(locale, kName, name)) {
-            qWarning() << "Localization entry is missing its name attribute";
-            continue;
-        }
-        // If we found a direct match, deal with it now
-        if(localeName == name.toLower().replace("-", "_")) {
-            return _replaceLocaleStrings(locale, bytes);
-        }
-    }
-    //-- No direct match. Pick first matching language (if any)
-    localeName = localeName.left(3);
-    for(int i = 0; i < locales.size(); i++) {
-        QDomNode locale = locales.item(i);
-        QString name;
-        read_attribute(locale, kName, name);
-        if(name.toLower().startsWith(localeName)) {
-            return _replaceLocaleStrings(locale, bytes);
-        }
-    }
-    //-- Could not find a language to use
-    qWarning() <<  "No match for" << QLocale::system().name() << "in camera definition file";
-    //-- Just use default, en_US
-    return true;
-}
-
-//-----------------------------------------------------------------------------
-bool
-VehicleCameraControl::_replaceLocaleStrings(const QDomNode node, QByteArray& bytes)
-{
-    QDomElement stringElem = node.toElement();
-    QDomNodeList strings = stringElem.elementsByTagName(kStrings);
-    for(int i = 0; i < strings.size(); i++) {
-        QDomNode stringNode = strings.item(i);
-        QString original;
-        QString translated;
-        if(read_attribute(stringNode, kOriginal, original)) {
-            if(read_attribute(stringNode, kTranslated, translated)) {
-                QString o; o = "\"" + original + "\"";
-                QString t; t = "\"" + translated + "\"";
-                bytes.replace(o.toUtf8(), t.toUtf8());
-                o = ">" + original + "<";
-                t = ">" + translated + "<";
-                bytes.replace(o.toUtf8(), t.toUtf8());
-            }
-        }
-    }
-    return true;
-}
-
 //-----------------------------------------------------------------------------
 void
 VehicleCameraControl::_requestAllParameters()
@@ -1166,9 +925,76 @@ VehicleCameraControl::_requestAllParameters()
                     static_cast<uint8_t>(compID()));
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
     }
+    //-- Parameters missing once the list stops coming in are read individually
+    _paramListTimer.start();
     qCDebug(CameraControlVerboseLog) << "Request all parameters";
 }
 
+//-----------------------------------------------------------------------------
+void
+VehicleCameraControl::_paramListTimeout()
+{
+    for(const QString& paramName: _paramIO.keys()) {
+        if(_paramIO[paramName] && !_paramIO[paramName]->paramReceived()) {
+            _queueParamRead(paramName, false);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VehicleCameraControl::_queueParamRead(const QString& paramName, bool reset)
+{
+    //-- A read already pending answers this one as well
+    if(_paramReadsInFlight.contains(paramName)) {
+        return;
+    }
+    for(ParamRead_t& read: _paramReadQueue) {
+        if(read.name == paramName) {
+            read.reset |= reset;
+            return;
+        }
+    }
+    _paramReadQueue.append({ paramName, reset });
+    _sendParamReads();
+}
+
+//-----------------------------------------------------------------------------
+void
+VehicleCameraControl::_sendParamReads()
+{
+    while(_paramReadsInFlight.size() < _paramReadWindow.size() && !_paramReadQueue.isEmpty()) {
+        ParamRead_t read = _paramReadQueue.takeFirst();
+        QGCCameraParamIO* pIO = _paramIO.value(read.name);
+        Fact* pFact = getFact(read.name);
+        if(!pIO || !pFact) {
+            continue;
+        }
+        //-- Write only parameters are never answered
+        if(!pFact->writeOnly()) {
+            _paramReadsInFlight << read.name;
+        }
+        pIO->paramRequest(read.reset);
+    }
+    if(!_paramReadsInFlight.isEmpty() && !_paramReadTimer.isActive()) {
+        _paramReadTimer.start(_paramReadWindow.timeoutMsecs(_minParamReadTimeoutMsecs, _maxParamReadTimeoutMsecs, _paramReadTimeoutValues));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+VehicleCameraControl::_paramReadTimeout()
+{
+    if(_paramReadsInFlight.isEmpty()) {
+        return;
+    }
+    //-- Requests got lost, back off. The parameter handlers retry their own reads.
+    _paramReadWindow.requestsLost();
+    qCDebug(CameraControlLog) << "Parameter reads timed out" << _paramReadsInFlight << "window:" << _paramReadWindow.size();
+    _paramReadsInFlight.clear();
+    _sendParamReads();
+}
+
 //-----------------------------------------------------------------------------
 QString
 VehicleCameraControl::_getParamName(const char* param_id)
@@ -1208,6 +1034,15 @@ VehicleCameraControl::handleParamValue(const mavlink_param_ext_value_t& value)
     } else {
         qCritical() << "QGCParamIO is NULL" << paramName;
     }
+    _paramReadWindow.valueReceived(_paramValueTimer.elapsed());
+    if(_paramListTimer.isActive()) {
+        _paramListTimer.start();
+    }
+    if(_paramReadsInFlight.removeOne(paramName)) {
+        _paramReadWindow.requestAnswered();
+        _paramReadTimer.stop();
+        _sendParamReads();
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -1244,83 +1079,33 @@ VehicleCameraControl::_updateActiveList()
 
 //-----------------------------------------------------------------------------
 bool
-VehicleCameraControl::_processConditionTest(const QString conditionTest)
-{
-    enum {
-        TEST_NONE,
-        TEST_EQUAL,
-        TEST_NOT_EQUAL,
-        TEST_GREATER,
-        TEST_SMALLER
-    };
-    qCDebug(CameraControlVerboseLog) << "_processConditionTest(" << conditionTest << ")";
-    int op = TEST_NONE;
-    QStringList test;
-
-    auto split = [&conditionTest](const QString& sep ) {
-        return conditionTest.split(sep, Qt::SkipEmptyParts);
-    };
-
-    if(conditionTest.contains("!=")) {
-        test = split("!=");
-        op = TEST_NOT_EQUAL;
-    } else if(conditionTest.contains("=")) {
-        test = split("=");
-        op = TEST_EQUAL;
-    } else if(conditionTest.contains(">")) {
-        test = split(">");
-        op = TEST_GREATER;
-    } else if(conditionTest.contains("<")) {
-        test = split("<");
-        op = TEST_SMALLER;
-    }
-    if(test.size() == 2) {
-        Fact* pFact = getFact(test[0]);
-        if(pFact) {
-            switch(op) {
-            case TEST_EQUAL:
-                return pFact->rawValueString() == test[1];
-            case TEST_NOT_EQUAL:
-                return pFact->rawValueString() != test[1];
-            case TEST_GREATER:
-                return pFact->rawValueString() > test[1];
-            case TEST_SMALLER:
-                return pFact->rawValueString() < test[1];
-            case TEST_NONE:
-                break;
-            }
-        } else {
-            qWarning() << "Invalid condition parameter:" << test[0] << "in" << conditionTest;
-            return false;
-        }
-    }
-    qWarning() << "Invalid condition" << conditionTest;
-    return false;
-}
-
-//-----------------------------------------------------------------------------
-bool
-VehicleCameraControl::_processCondition(const QString condition)
+VehicleCameraControl::_evaluateCondition(const QGCCameraOptionRange* pRange)
 {
-    qCDebug(CameraControlVerboseLog) << "_processCondition(" << condition << ")";
     bool result = true;
-    bool andOp  = true;
-    if(!condition.isEmpty()) {
-        QStringList scond = condition.split(" ", Qt::SkipEmptyParts);
-        while(scond.size()) {
-            QString test = scond.first();
-            scond.removeFirst();
-            if(andOp) {
-                result = result && _processConditionTest(test);
-            } else {
-                result = result || _processConditionTest(test);
-            }
-            if(!scond.size()) {
-                return result;
+    for(int i = 0; i < pRange->conditionTests.size(); i++) {
+        const QGCCameraDefinition::ConditionTest_t& test = pRange->conditionTests[i];
+        Fact* pFact = pRange->conditionFacts[i];
+        bool testResult = false;
+        if(pFact) {
+            const QString value = pFact->rawValueString();
+            switch(test.op) {
+            case QGCCameraDefinition::ConditionEqual:
+                testResult = value == test.value;
+                break;
+            case QGCCameraDefinition::ConditionNotEqual:
+                testResult = value != test.value;
+                break;
+            case QGCCameraDefinition::ConditionGreater:
+                testResult = value > test.value;
+                break;
+            case QGCCameraDefinition::ConditionSmaller:
+                testResult = value < test.value;
+                break;
+            case QGCCameraDefinition::ConditionInvalid:
+                break;
             }
-            andOp = scond.first().toUpper() == "AND";
-            scond.removeFirst();
         }
+        result = test.andWithPrevious ? (result && testResult) : (result || testResult);
     }
     return result;
 }
@@ -1334,18 +1119,16 @@ VehicleCameraControl::_updateRanges(Fact* pFact)
     QStringList changedList;
     QStringList resetList;
     QStringList updates;
+    //-- Only the range sets this fact or one of its conditions is part of
+    const QList<QGCCameraOptionRange*> ranges = _rangesByParam.value(pFact->name());
     //-- Iterate range sets looking for limited ranges
-    for(QGCCameraOptionRange* pRange: _optionRanges) {
-        //-- If this fact or one of its conditions is part of this range set
-        if(!changedList.contains(pRange->targetParam) && (pRange->param == pFact->name() || pRange->condition.contains(pFact->name()))) {
-            Fact* pRFact = getFact(pRange->param);          //-- This parameter
-            Fact* pTFact = getFact(pRange->targetParam);    //-- The target parameter (the one its range is to change)
+    for(QGCCameraOptionRange* pRange: ranges) {
+        if(!changedList.contains(pRange->targetParam)) {
+            Fact* pRFact = pRange->paramFact;       //-- This parameter
+            Fact* pTFact = pRange->targetFact;      //-- The target parameter (the one its range is to change)
             if(pRFact && pTFact) {
-                //qCDebug(CameraControlVerboseLog) << "Check new set of options for" << pTFact->name();
-                QString option = pRFact->rawValueString();  //-- This parameter value
                 //-- If this value (and condition) triggers a change in the target range
-                //qCDebug(CameraControlVerboseLog) << "Range value:" << pRange->value << "Current value:" << option << "Condition:" << pRange->condition;
-                if(pRange->value == option && _processCondition(pRange->condition)) {
+                if(pRange->value == pRFact->rawValueString() && _evaluateCondition(pRange)) {
                     if(pTFact->enumStrings() != pRange->optNames) {
                         //-- Set limited range set
                         rangesSet[pTFact] = pRange;
@@ -1356,9 +1139,9 @@ VehicleCameraControl::_updateRanges(Fact* pFact)
         }
     }
     //-- Iterate range sets again looking for resets
-    for(QGCCameraOptionRange* pRange: _optionRanges) {
-        if(!changedList.contains(pRange->targetParam) && (pRange->param == pFact->name() || pRange->condition.contains(pFact->name()))) {
-            Fact* pTFact = getFact(pRange->targetParam);    //-- The target parameter (the one its range is to change)
+    for(QGCCameraOptionRange* pRange: ranges) {
+        if(!changedList.contains(pRange->targetParam) && pRange->targetFact) {
+            Fact* pTFact = pRange->targetFact;
             if(!resetList.contains(pRange->targetParam)) {
                 if(pTFact->enumStrings() != _originalOptNames[pRange->targetParam]) {
                     //-- Restore full option set
@@ -1408,7 +1191,7 @@ void
 VehicleCameraControl::_requestParamUpdates()
 {
     for(const QString& param: _updatesToRequest) {
-        _paramIO[param]->paramRequest();
+        _queueParamRead(param, true);
     }
     _updatesToRequest.clear();
 }
@@ -1882,107 +1665,18 @@ VehicleCameraControl::_streamStatusTimeout()
     }
 }
 
-//-----------------------------------------------------------------------------
-QStringList
-VehicleCameraControl::_loadExclusions(QDomNode option)
-{
-    QStringList exclusionList;
-    QDomElement optionElem = option.toElement();
-    QDomNodeList excRoot = optionElem.elementsByTagName(kExclusions);
-    if(excRoot.size()) {
-        //-- Iterate exclusions
-        QDomNode node = excRoot.item(0);
-        QDomElement elem = node.toElement();
-        QDomNodeList exclusions = elem.elementsByTagName(kExclusion);
-        for(int i = 0; i < exclusions.size(); i++) {
-            QString exclude = exclusions.item(i).toElement().text();
-            if(!exclude.isEmpty()) {
-                exclusionList << exclude;
-            }
-        }
-    }
-    return exclusionList;
-}
-
-//-----------------------------------------------------------------------------
-QStringList
-VehicleCameraControl::_loadUpdates(QDomNode option)
-{
-    QStringList updateList;
-    QDomElement optionElem = option.toElement();
-    QDomNodeList updateRoot = optionElem.elementsByTagName(kUpdates);
-    if(updateRoot.size()) {
-        //-- Iterate updates
-        QDomNode node = updateRoot.item(0);
-        QDomElement elem = node.toElement();
-        QDomNodeList updates = elem.elementsByTagName(kUpdate);
-        for(int i = 0; i < updates.size(); i++) {
-            QString update = updates.item(i).toElement().text();
-            if(!update.isEmpty()) {
-                updateList << update;
-            }
-        }
-    }
-    return updateList;
-}
-
-//-----------------------------------------------------------------------------
-bool
-VehicleCameraControl::_loadRanges(QDomNode option, const QString factName, QString paramValue)
-{
-    QDomElement optionElem = option.toElement();
-    QDomNodeList rangeRoot = optionElem.elementsByTagName(kParameterranges);
-    if(rangeRoot.size()) {
-        QDomNode node = rangeRoot.item(0);
-        QDomElement elem = node.toElement();
-        QDomNodeList parameterRanges = elem.elementsByTagName(kParameterrange);
-        //-- Iterate parameter ranges
-        for(int i = 0; i < parameterRanges.size(); i++) {
-            QString param;
-            QString condition;
-            QDomNode paramRange = parameterRanges.item(i);
-            if(!read_attribute(paramRange, kParameter, param)) {
-                qCritical() << QString("Malformed option range for parameter %1").arg(factName);
-                return false;
-            }
-            read_attribute(paramRange, kCondition, condition);
-            QDomElement pelem = paramRange.toElement();
-            QDomNodeList rangeOptions = pelem.elementsByTagName(kRoption);
-            QStringList  optNames;
-            QStringList  optValues;
-            //-- Iterate options
-            for(int i = 0; i < rangeOptions.size(); i++) {
-                QString optName;
-                QString optValue;
-                QDomNode roption = rangeOptions.item(i);
-                if(!read_attribute(roption, kName, optName)) {
-                    qCritical() << QString("Malformed roption for parameter %1").arg(factName);
-                    return false;
-                }
-                if(!read_attribute(roption, kValue, optValue)) {
-                    qCritical() << QString("Malformed rvalue for parameter %1").arg(factName);
-                    return false;
-                }
-                optNames  << optName;
-                optValues << optValue;
-            }
-            if(optNames.size()) {
-                QGCCameraOptionRange* pRange = new QGCCameraOptionRange(this, factName, paramValue, param, condition, optNames, optValues);
-                _optionRanges.append(pRange);
-                qCDebug(CameraControlVerboseLog) << "New range limit:" << factName << paramValue << param << condition << optNames << optValues;
-            }
-        }
-    }
-    return true;
-}
-
 //-----------------------------------------------------------------------------
 void
 VehicleCameraControl::_processRanges()
 {
     //-- After all parameter are loaded, process parameter ranges
     for(QGCCameraOptionRange* pRange: _optionRanges) {
-        Fact* pRFact = getFact(pRange->targetParam);
+        pRange->paramFact  = getFact(pRange->param);
+        pRange->targetFact = getFact(pRange->targetParam);
+        if(!pRange->targetFact) {
+            qWarning() << "Invalid range target parameter:" << pRange->targetParam << "for" << pRange->param;
+        }
+        Fact* pRFact = pRange->targetFact;
         if(pRFact) {
             for(int i = 0; i < pRange->optNames.size(); i++) {
                 QVariant optVariant;
@@ -1997,35 +1691,38 @@ VehicleCameraControl::_processRanges()
                 }
             }
         }
+        //-- Resolve condition parameters and index the range under every parameter which can change its outcome
+        QStringList params(pRange->param);
+        for(const QGCCameraDefinition::ConditionTest_t& test: pRange->conditionTests) {
+            Fact* pFact = test.param.isEmpty() ? nullptr : getFact(test.param);
+            if(!pFact && test.op != QGCCameraDefinition::ConditionInvalid) {
+                qWarning() << "Invalid condition parameter:" << test.param << "in" << pRange->condition;
+            }
+            pRange->conditionFacts.append(pFact);
+            if(pFact && !params.contains(test.param)) {
+                params << test.param;
+            }
+        }
+        for(const QString& param: params) {
+            _rangesByParam[param].append(pRange);
+        }
     }
 }
 
-//-----------------------------------------------------------------------------
-bool
-VehicleCameraControl::_loadNameValue(QDomNode option, const QString factName, FactMetaData* metaData, QString& optName, QString& optValue, QVariant& optVariant)
-{
-    if(!read_attribute(option, kName, optName)) {
-        qCritical() << QString("Malformed option for parameter %1").arg(factName);
-        return false;
-    }
-    if(!read_attribute(option, kValue, optValue)) {
-        qCritical() << QString("Malformed value for parameter %1").arg(factName);
-        return false;
-    }
-    QString  errorString;
-    if (!metaData->convertAndValidateRaw(optValue, false, optVariant, errorString)) {
-        qWarning() << "Invalid option value, name:" << factName
-                   << " type:"  << metaData->type()
-                   << " value:" << optValue
-                   << " error:" << errorString;
-    }
-    return true;
-}
-
 //-----------------------------------------------------------------------------
 void
 VehicleCameraControl::_handleDefinitionFile(const QString &url)
 {
+    //-- Parsed already by another camera in this session
+    QSharedPointer<const QGCCameraDefinition> definition = QGCCameraDefinition::cached(_definitionKey);
+    if (definition) {
+        qCDebug(CameraControlLog) << "Using parsed camera definition:" << _definitionKey;
+        _cached = true;
+        _loadDefinition(definition);
+        _initWhenReady();
+        return;
+    }
+
     //-- First check and see if we have it cached
     QFile xmlFile(_cacheFile);
 
@@ -2042,9 +1739,12 @@ VehicleCameraControl::_handleDefinitionFile(const QString &url)
             ver,
             ext.toStdString().c_str());
         connect(_vehicle->ftpManager(), &FTPManager::downloadComplete, this, &VehicleCameraControl::_ftpDownloadComplete);
-        _vehicle->ftpManager()->download(_compID, url,
+        _ftpDownloadFile = _vehicle->ftpManager()->download(_compID, url,
             qgcApp()->toolbox()->settingsManager()->appSettings()->parameterSavePath().toStdString().c_str(),
             fileName);
+        if (_ftpDownloadFile.isEmpty()) {
+            disconnect(_vehicle->ftpManager(), &FTPManager::downloadComplete, this, &VehicleCameraControl::_ftpDownloadComplete);
+        }
         return;
     }
 
@@ -2053,22 +1753,26 @@ VehicleCameraControl::_handleDefinitionFile(const QString &url)
         _httpRequest(url);
         return;
     }
-    if (!xmlFile.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not read cached camera definition file:" << _cacheFile;
-        _httpRequest(url);
-        return;
-    }
-    QByteArray bytes = xmlFile.readAll();
-    QDomDocument doc;
-    if(!doc.setContent(bytes, false)) {
-        qWarning() << "Could not parse cached camera definition file:" << _cacheFile;
-        _httpRequest(url);
-        return;
+    //-- The binary form skips the XML parse, it is only trusted while the XML it came from is still cached
+    definition = QGCCameraDefinition::loadBinary(_definitionKey, _binaryCacheFile);
+    if (!definition) {
+        if (!xmlFile.open(QIODevice::ReadOnly)) {
+            qWarning() << "Could not read cached camera definition file:" << _cacheFile;
+            _httpRequest(url);
+            return;
+        }
+        definition = QGCCameraDefinition::parse(_definitionKey, xmlFile.readAll(), _binaryCacheFile);
+        if (!definition) {
+            qWarning() << "Could not parse cached camera definition file:" << _cacheFile;
+            _httpRequest(url);
+            return;
+        }
     }
     //-- We have it
     qCDebug(CameraControlLog) << "Using cached camera definition file:" << _cacheFile;
     _cached = true;
-    emit dataReady(bytes);
+    _loadDefinition(definition);
+    _initWhenReady();
 }
 
 //-----------------------------------------------------------------------------
@@ -2120,6 +1824,11 @@ VehicleCameraControl::_downloadFinished()
 
 void VehicleCameraControl::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg)
 {
+    if (fileName != _ftpDownloadFile) {
+        return;
+    }
+    _ftpDownloadFile.clear();
+
     qCDebug(CameraControlLog) << "FTP Download completed: " << fileName << ", " << errorMsg;
 
     disconnect(_vehicle->ftpManager(), &FTPManager::downloadComplete, this, &VehicleCameraControl::_ftpDownloadComplete);
@@ -11,10 +11,12 @@
 
 #include "MavlinkCameraControl.h"
 #include "QmlObjectListModel.h"
+#include "QGCCameraDefinition.h"
+#include "ParameterRequestWindow.h"
+
+#include <QtCore/QElapsedTimer>
 
 class QNetworkAccessManager;
-class QDomNode;
-class QDomNodeList;
 
 //-----------------------------------------------------------------------------
 /// Camera option exclusions
@@ -40,6 +42,11 @@ public:
     QStringList  optNames;
     QStringList  optValues;
     QVariantList optVariants;
+    QList<QGCCameraDefinition::ConditionTest_t> conditionTests;
+    //-- Resolved once all Facts exist
+    Fact*        paramFact   = nullptr;
+    Fact*        targetFact  = nullptr;
+    QList<Fact*> conditionFacts;    ///< One per condition test, nullptr for unknown parameters
 };
 
 //-----------------------------------------------------------------------------
@@ -233,26 +240,22 @@ protected slots:
     virtual void    _streamStatusTimeout    ();
     virtual void    _recTimerHandler        ();
     virtual void    _checkForVideoStreams   ();
+    void            _paramListTimeout       ();
+    void            _paramReadTimeout       ();
 
 private:
-    bool    _handleLocalization             (QByteArray& bytes);
-    bool    _replaceLocaleStrings           (const QDomNode node, QByteArray& bytes);
     bool    _loadCameraDefinitionFile       (QByteArray& bytes);
-    bool    _loadConstants                  (const QDomNodeList nodeList);
-    bool    _loadSettings                   (const QDomNodeList nodeList);
+    bool    _loadDefinition                 (QSharedPointer<const QGCCameraDefinition> definition);
     void    _processRanges                  ();
-    bool    _processCondition               (const QString condition);
-    bool    _processConditionTest           (const QString conditionTest);
-    bool    _loadNameValue                  (QDomNode option, const QString factName, FactMetaData* metaData, QString& optName, QString& optValue, QVariant& optVariant);
-    bool    _loadRanges                     (QDomNode option, const QString factName, QString paramValue);
+    bool    _evaluateCondition              (const QGCCameraOptionRange* pRange);
     void    _updateActiveList               ();
     void    _updateRanges                   (Fact* pFact);
     void    _httpRequest                    (const QString& url);
     void    _handleDefinitionFile           (const QString& url);
     void    _ftpDownloadComplete            (const QString& fileName, const QString& errorMsg);
+    void    _queueParamRead                 (const QString& paramName, bool reset);
+    void    _sendParamReads                 ();
 
-    QStringList     _loadExclusions         (QDomNode option);
-    QStringList     _loadUpdates            (QDomNode option);
     QString         _getParamName           (const char* param_id);
 
 protected:
@@ -271,6 +274,9 @@ protected:
     QString                             _modelName;
     QString                             _vendor;
     QString                             _cacheFile;
+    QString                             _binaryCacheFile;   ///< Parsed form of _cacheFile, see QGCCameraDefinition
+    QString                             _definitionKey;     ///< Definition URI, version and locale
+    QString                             _ftpDownloadFile;   ///< Local file of the definition file download, other FTP downloads share the signals
     CameraMode                          _cameraMode         = CAM_MODE_UNDEFINED;
     StorageStatus                       _storageStatus      = STORAGE_NOT_SUPPORTED;
     PhotoCaptureMode                    _photoMode          = PHOTO_CAPTURE_SINGLE;
@@ -283,6 +289,7 @@ protected:
     QTimer                              _captureStatusTimer;
     QList<QGCCameraOptionExclusion*>    _valueExclusions;
     QList<QGCCameraOptionRange*>        _optionRanges;
+    QHash<QString, QList<QGCCameraOptionRange*>> _rangesByParam;  ///< Ranges whose outcome depends on each parameter
     QMap<QString, QStringList>          _originalOptNames;
     QMap<QString, QVariantList>         _originalOptValues;
     QMap<QString, QGCCameraParamIO*>    _paramIO;
@@ -296,6 +303,24 @@ protected:
     //-- Parameters that require a full update
     QMap<QString, QStringList>          _requestUpdates;
     QStringList                         _updatesToRequest;
+    //-- Parameter reads, a bounded window of PARAM_EXT_REQUEST_READ is kept in flight
+    typedef struct {
+        QString name;
+        bool    reset;
+    } ParamRead_t;
+    QList<ParamRead_t>                  _paramReadQueue;
+    QStringList                         _paramReadsInFlight;
+    ParameterRequestWindow              _paramReadWindow    { _initialParamReadWindow, _minParamReadWindow, _maxParamReadWindow };
+    QTimer                              _paramReadTimer;
+    QTimer                              _paramListTimer;    ///< Restarted by each value while the parameter list comes in
+    QElapsedTimer                       _paramValueTimer;
+    static constexpr int                _initialParamReadWindow     = 4;
+    static constexpr int                _minParamReadWindow         = 1;
+    static constexpr int                _maxParamReadWindow         = 16;
+    static constexpr int                _minParamReadTimeoutMsecs   = 500;
+    static constexpr int                _maxParamReadTimeoutMsecs   = 3500;
+    static constexpr int                _paramReadTimeoutValues     = 20;
+    static constexpr int                _paramListIdleMsecs         = 3500;
     //-- Video Streams
     int                                 _videoStreamInfoRetries   = 0;
     int                                 _videoStreamStatusRetries = 0;
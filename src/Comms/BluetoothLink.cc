@@ -9,6 +9,7 @@
 
 #include "BluetoothLink.h"
 #include "DeviceInfo.h"
+#include "QGC.h"
 
 #include <QtBluetooth/QBluetoothDeviceDiscoveryAgent>
 #include <QtBluetooth/QBluetoothSocket>
@@ -60,10 +61,11 @@ void BluetoothLink::readBytes()
 {
     if (_targetSocket) {
         while (_targetSocket->bytesAvailable() > 0) {
+            const quint64 timestampUsecs = QGC::utcTimeUsecs();
             QByteArray datagram;
             datagram.resize(_targetSocket->bytesAvailable());
             _targetSocket->read(datagram.data(), datagram.size());
-            emit bytesReceived(this, datagram);
+            emit bytesReceived(this, datagram, timestampUsecs);
         }
     }
 }
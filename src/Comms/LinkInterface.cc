@@ -19,6 +19,9 @@
 #include "MockLink.h"
 #endif
 
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTimer>
+#include <QtCore/QtMath>
 #include <QtQml/QQmlEngine>
 
 QGC_LOGGING_CATEGORY(LinkInterfaceLog, "LinkInterfaceLog")
@@ -28,6 +31,7 @@ LinkInterface::LinkInterface(SharedLinkConfigurationPtr &config, QObject *parent
     , _config(config)
 {
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+    _transmitClock.start();
 }
 
 LinkInterface::~LinkInterface()
@@ -109,10 +113,213 @@ void LinkInterface::_freeMavlinkChannel()
     _mavlinkChannel = LinkManager::invalidMavlinkChannel();
 }
 
-void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
+LinkInterface::WritePriority LinkInterface::messageWritePriority(uint32_t msgid)
 {
-    const QByteArray data(bytes, length);
-    (void) QMetaObject::invokeMethod(this, "_writeBytes", Qt::AutoConnection, data);
+    switch (msgid) {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+    case MAVLINK_MSG_ID_COMMAND_INT:
+    case MAVLINK_MSG_ID_SET_MODE:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
+    // Remote ID has to go out at its regulated rate however busy the link is
+    case MAVLINK_MSG_ID_OPEN_DRONE_ID_BASIC_ID:
+    case MAVLINK_MSG_ID_OPEN_DRONE_ID_SELF_ID:
+    case MAVLINK_MSG_ID_OPEN_DRONE_ID_OPERATOR_ID:
+    case MAVLINK_MSG_ID_OPEN_DRONE_ID_SYSTEM:
+        return WritePriorityControl;
+    case MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL:
+    case MAVLINK_MSG_ID_MISSION_ITEM:
+    case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+    case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+    case MAVLINK_MSG_ID_PARAM_SET:
+    case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+    case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+    case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
+    case MAVLINK_MSG_ID_TERRAIN_DATA:
+    case MAVLINK_MSG_ID_GPS_RTCM_DATA:
+        return WritePriorityBulk;
+    default:
+        return WritePriorityNormal;
+    }
+}
+
+void LinkInterface::writeBytesThreadSafe(const char *bytes, int length, WritePriority priority)
+{
+    bool backpressureChanged = false;
+
+    {
+        QMutexLocker locker(&_writeQueueMutex);
+
+        _writeQueue[priority].append(QByteArray(bytes, length));
+        _writeQueueBytes[priority] += length;
+        backpressureChanged = _updateWriteBackpressure();
+
+        // A single queued flush picks up everything written before it runs
+        if (!_writeFlushPending) {
+            _writeFlushPending = true;
+            (void) QMetaObject::invokeMethod(this, &LinkInterface::_flushWriteQueue, Qt::QueuedConnection);
+        }
+    }
+
+    if (backpressureChanged) {
+        _emitWriteBackpressureChanged();
+    }
+}
+
+void LinkInterface::setTransmitCapacity(double bytesPerSecond)
+{
+    QMutexLocker locker(&_writeQueueMutex);
+
+    _transmitCapacity = qMax(0.0, bytesPerSecond);
+    _transmitRateFactor = 1;
+    _transmitTokens = _transmitCapacity * _maxTransmitBurstSecs;
+
+    qCDebug(LinkInterfaceLog) << Q_FUNC_INFO << _transmitCapacity;
+}
+
+double LinkInterface::transmitCapacity() const
+{
+    QMutexLocker locker(&_writeQueueMutex);
+
+    return _transmitCapacity;
+}
+
+void LinkInterface::setRemoteTransmitBuffer(int percentFree)
+{
+    QMutexLocker locker(&_writeQueueMutex);
+
+    // Back off quickly while the radio is filling up, recover slowly once it drains
+    if (percentFree < _lowTransmitBuffer) {
+        _transmitRateFactor = qMax(_minTransmitRateFactor, _transmitRateFactor * 0.7);
+    } else if (percentFree > _highTransmitBuffer) {
+        _transmitRateFactor = qMin(1.0, _transmitRateFactor + 0.1);
+    }
+}
+
+/// @return Bytes per second the link currently transmits at, 0 for no limit
+double LinkInterface::_transmitRate() const
+{
+    return _transmitCapacity * _transmitRateFactor;
+}
+
+bool LinkInterface::_updateWriteBackpressure()
+{
+    const double rate = _transmitRate();
+    const qsizetype highWaterBytes = (rate > 0) ? qMax(_minBackpressureBytes, static_cast<qsizetype>(rate * _backpressureSecs)) : _unlimitedBackpressureBytes;
+    const qsizetype queuedBytes = _writeQueueBytes[WritePriorityNormal] + _writeQueueBytes[WritePriorityBulk];
+
+    // Hysteresis so producers are not toggled on every message
+    bool backpressure = _writeBackpressure;
+    if (queuedBytes > highWaterBytes) {
+        backpressure = true;
+    } else if (queuedBytes < (highWaterBytes / 2)) {
+        backpressure = false;
+    }
+
+    if (backpressure == _writeBackpressure) {
+        return false;
+    }
+    _writeBackpressure = backpressure;
+    return true;
+}
+
+void LinkInterface::_emitWriteBackpressureChanged()
+{
+    qCDebug(LinkInterfaceLog) << Q_FUNC_INFO << _writeBackpressure;
+    emit writeBackpressureChanged(_writeBackpressure);
+}
+
+void LinkInterface::_flushWriteQueue()
+{
+    QList<QByteArray> writes;
+    qsizetype totalBytes = 0;
+    bool backpressureChanged = false;
+
+    {
+        QMutexLocker locker(&_writeQueueMutex);
+
+        const double rate = _transmitRate();
+        double budget = _maxBytesPerFlush;
+        if (rate > 0) {
+            const double elapsedSecs = _transmitClock.restart() / 1000.0;
+            _transmitTokens = qMin(rate * _maxTransmitBurstSecs, _transmitTokens + (elapsedSecs * rate));
+            budget = _transmitTokens;
+        }
+
+        // Control traffic is never held back, it may run the budget into debt
+        for (const QByteArray &bytes : _writeQueue[WritePriorityControl]) {
+            budget -= bytes.size();
+        }
+        writes.append(_writeQueue[WritePriorityControl]);
+        totalBytes += _writeQueueBytes[WritePriorityControl];
+        _writeQueue[WritePriorityControl].clear();
+        _writeQueueBytes[WritePriorityControl] = 0;
+
+        // Deficit round robin between the weighted lanes for whatever budget is left
+        static constexpr int weights[WritePriorityCount] = { 0, _normalWriteWeight, _bulkWriteWeight };
+        bool progress = true;
+        while ((budget > 0) && progress) {
+            progress = false;
+            for (int priority = WritePriorityNormal; priority < WritePriorityCount; priority++) {
+                QList<QByteArray> &queue = _writeQueue[priority];
+                if (queue.isEmpty()) {
+                    _writeDeficit[priority] = 0;
+                    continue;
+                }
+
+                _writeDeficit[priority] += _writeQuantumBytes * weights[priority];
+                progress = true;
+                while (!queue.isEmpty() && (queue.first().size() <= _writeDeficit[priority]) && (budget > 0)) {
+                    const QByteArray bytes = queue.takeFirst();
+                    _writeDeficit[priority] -= bytes.size();
+                    _writeQueueBytes[priority] -= bytes.size();
+                    budget -= bytes.size();
+                    totalBytes += bytes.size();
+                    writes.append(bytes);
+                }
+            }
+        }
+
+        if (rate > 0) {
+            _transmitTokens = budget;
+        }
+        backpressureChanged = _updateWriteBackpressure();
+
+        _writeFlushPending = !_writeQueue[WritePriorityNormal].isEmpty() || !_writeQueue[WritePriorityBulk].isEmpty();
+        if (_writeFlushPending) {
+            if (rate > 0) {
+                // The budget ran out, come back once the bucket has refilled enough for another round
+                const int delayMSecs = qMax(1, qCeil(((_writeQuantumBytes - budget) / rate) * 1000.0));
+                QTimer::singleShot(delayMSecs, this, &LinkInterface::_flushWriteQueue);
+            } else {
+                (void) QMetaObject::invokeMethod(this, &LinkInterface::_flushWriteQueue, Qt::QueuedConnection);
+            }
+        }
+    }
+
+    if (backpressureChanged) {
+        _emitWriteBackpressureChanged();
+    }
+
+    if (writes.isEmpty()) {
+        return;
+    }
+
+    if (_coalesceWrites() && (writes.count() > 1)) {
+        QByteArray buffer;
+        buffer.reserve(totalBytes);
+        for (const QByteArray &bytes : writes) {
+            buffer.append(bytes);
+        }
+        _writeBytes(buffer);
+    } else {
+        for (const QByteArray &bytes : writes) {
+            _writeBytes(bytes);
+        }
+    }
 }
 
 void LinkInterface::removeVehicleReference()
@@ -144,3 +351,85 @@ void LinkInterface::setSigningSignatureFailure(bool failure)
         }
     }
 }
+
+void LinkInterface::setDecodeOnLinkThread(bool decodeOnLinkThread)
+{
+    if (decodeOnLinkThread == _decodeOnLinkThread) {
+        return;
+    }
+
+    _decodeOnLinkThread = decodeOnLinkThread;
+    if (_decodeOnLinkThread) {
+        // Direct connection so decoding happens on whichever thread the link emits bytesReceived from
+        _decodeConnection = connect(this, &LinkInterface::bytesReceived, this, &LinkInterface::_decodeBytes, Qt::DirectConnection);
+    } else {
+        (void) QObject::disconnect(_decodeConnection);
+    }
+
+    qCDebug(LinkInterfaceLog) << Q_FUNC_INFO << _decodeOnLinkThread;
+}
+
+void LinkInterface::_decodeBytes(LinkInterface *link, const QByteArray &bytes, quint64 timestampUsecs)
+{
+    if (!mavlinkChannelIsSet()) {
+        return;
+    }
+
+    // Frames are parsed with a state of our own which has no signing set. Signatures are then checked by
+    // MAVLinkSigning::verifyMessage with the channel's own replay table, instead of in the parser against the table
+    // all channels share. The channel's mavlink_status_t is never written from here: it belongs to the main thread,
+    // which packs outgoing messages with it and switches its outbound version flag in MAVLinkProtocol::_handleMessage.
+    const mavlink_channel_t channel = static_cast<mavlink_channel_t>(_mavlinkChannel);
+    const bool verifySignatures = MAVLinkSigning::verifierEnabled(channel);
+    bool signatureFailure = false;
+
+    QList<mavlink_message_t> messages;
+    for (const char byte : bytes) {
+        const uint8_t framing = mavlink_frame_char_buffer(&_decodeBuffer, &_decodeParseStatus, static_cast<uint8_t>(byte), &_decodeMessage, &_decodeStatus);
+        if (framing == MAVLINK_FRAMING_OK) {
+            if (verifySignatures && !MAVLinkSigning::verifyMessage(channel, _decodeMessage)) {
+                signatureFailure = true;
+                continue;
+            }
+            messages.append(_decodeMessage);
+        } else if (framing == MAVLINK_FRAMING_BAD_CRC) {
+            // Same recovery as mavlink_parse_char
+            _decodeParseStatus.parse_error++;
+            _decodeParseStatus.msg_received = MAVLINK_FRAMING_INCOMPLETE;
+            _decodeParseStatus.parse_state = MAVLINK_PARSE_STATE_IDLE;
+            if (static_cast<uint8_t>(byte) == MAVLINK_STX) {
+                _decodeParseStatus.parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+                _decodeBuffer.len = 0;
+                mavlink_start_checksum(&_decodeBuffer);
+            }
+        }
+    }
+
+    if (signatureFailure && !_decodeSignatureFailure) {
+        _decodeSignatureFailure = true;
+        (void) QMetaObject::invokeMethod(this, [this]() { setSigningSignatureFailure(true); }, Qt::QueuedConnection);
+    }
+
+    if (!messages.isEmpty()) {
+        emit messagesReceived(link, messages, timestampUsecs);
+    }
+}
+
+QByteArray &LinkInterface::_readBuffer(qint64 size)
+{
+    for (QByteArray &pooledBuffer: _readBufferPool) {
+        if (pooledBuffer.isDetached()) {
+            pooledBuffer.resize(size);
+            return pooledBuffer;
+        }
+    }
+
+    if (_readBufferPool.count() < _maxReadBufferPoolCount) {
+        _readBufferPool.append(QByteArray(size, Qt::Uninitialized));
+        return _readBufferPool.last();
+    }
+
+    // Every pooled buffer is still in use, the previous spare buffer stays with whoever holds it
+    _spareReadBuffer = QByteArray(size, Qt::Uninitialized);
+    return _spareReadBuffer;
+}
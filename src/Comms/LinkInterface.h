@@ -10,9 +10,15 @@
 #pragma once
 
 #include <QtCore/QThread>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+
+#include <atomic>
 
 #include "LinkConfiguration.h"
+#include "MAVLinkLib.h"
 
 class LinkManager;
 
@@ -28,6 +34,18 @@ class LinkInterface : public QThread
 public:
     virtual ~LinkInterface();
 
+    /// Outbound traffic classes. Control traffic always goes out first, normal and bulk traffic share whatever
+    /// transmit budget is left by weighted fair queuing.
+    enum WritePriority {
+        WritePriorityControl,   ///< Heartbeats, manual control, commands and Remote ID
+        WritePriorityNormal,
+        WritePriorityBulk,      ///< FTP, mission, parameter and RTCM transfers
+        WritePriorityCount
+    };
+
+    /// @return Lane for an outgoing MAVLink message
+    static WritePriority messageWritePriority(uint32_t msgid);
+
     Q_INVOKABLE virtual void disconnect() = 0;
 
     virtual bool isConnected() const = 0;
@@ -40,17 +58,38 @@ public:
     bool mavlinkChannelIsSet() const;
     bool decodedFirstMavlinkPacket(void) const { return _decodedFirstMavlinkPacket; }
     void setDecodedFirstMavlinkPacket(bool decodedFirstMavlinkPacket) { _decodedFirstMavlinkPacket = decodedFirstMavlinkPacket; }
-    void writeBytesThreadSafe(const char *bytes, int length);
+    /// Queues the bytes for the link thread, which writes everything queued in one go the next time it runs
+    void writeBytesThreadSafe(const char *bytes, int length, WritePriority priority = WritePriorityNormal);
+
+    /// Sets the capacity the link can transmit at, 0 for no limit. Thread safe.
+    void setTransmitCapacity(double bytesPerSecond);
+    double transmitCapacity() const;
+    /// Feeds back the free transmit buffer of a radio on the link (RADIO_STATUS.txbuf). The rate the link transmits at is
+    /// cut back while the radio's buffer runs low and raised again up to the capacity once it drains. Thread safe.
+    void setRemoteTransmitBuffer(int percentFree);
+    /// true while so much normal and bulk traffic is queued that bulk producers should hold off. Thread safe.
+    bool writeBackpressure() const { return _writeBackpressure; }
     void addVehicleReference() { ++_vehicleReferenceCount; }
     void removeVehicleReference();
     bool initMavlinkSigning();
     void setSigningSignatureFailure(bool failure);
 
+    /// When enabled, bytes received on this link are decoded into MAVLink messages on the thread which emitted
+    /// bytesReceived. Complete messages are then delivered in batches through messagesReceived instead of the
+    /// raw bytes being parsed by MAVLinkProtocol on the main thread.
+    void setDecodeOnLinkThread(bool decodeOnLinkThread);
+    bool decodeOnLinkThread() const { return _decodeOnLinkThread; }
+
 signals:
-    void bytesReceived(LinkInterface *link, const QByteArray &data);
+    /// @param timestampUsecs UTC time in microseconds at which the data was read from the device, see QGC::utcTimeUsecs
+    void bytesReceived(LinkInterface *link, const QByteArray &data, quint64 timestampUsecs);
+    /// Emitted with all messages decoded from a single bytesReceived buffer when decodeOnLinkThread is enabled
+    void messagesReceived(LinkInterface *link, const QList<mavlink_message_t> &messages, quint64 timestampUsecs);
     void bytesSent(LinkInterface *link, const QByteArray &data);
     void connected();
     void disconnected();
+    /// Emitted from whichever thread queued or flushed the writes which changed it
+    void writeBackpressureChanged(bool backpressure);
     void communicationError(const QString &title, const QString &error);
 
 protected:
@@ -65,20 +104,76 @@ protected:
 
     void _connectionRemoved();
 
+    /// Stream links have each batch of queued writes joined into a single buffer. Datagram links return false so every
+    /// write still goes out on its own.
+    virtual bool _coalesceWrites() const { return true; }
+
+    /// @return Buffer of the specified size for stream links to read into. Reuses the storage of a pooled buffer once
+    /// every receiver of the bytesReceived signal it was passed to has let go of it. Link thread only.
+    QByteArray &_readBuffer(qint64 size);
+
     SharedLinkConfigurationPtr _config;
 
 private slots:
     /// Not thread safe if called directly, only writeBytesThreadSafe is thread safe
     virtual void _writeBytes(const QByteArray &bytes) = 0;
 
+    void _flushWriteQueue();
+
 private:
     /// connect is private since all links should be created through LinkManager::createConnectedLink calls
     virtual bool _connect() = 0;
 
+    /// Runs on the thread which emitted bytesReceived. Only touches the _decode* state, never the channel status.
+    void _decodeBytes(LinkInterface *link, const QByteArray &bytes, quint64 timestampUsecs);
+
     uint8_t _mavlinkChannel = std::numeric_limits<uint8_t>::max();
     bool _decodedFirstMavlinkPacket = false;
     int _vehicleReferenceCount = 0;
     bool _signingSignatureFailure = false;
+
+    bool _decodeOnLinkThread = false;
+    QMetaObject::Connection _decodeConnection;
+    mavlink_message_t _decodeMessage{};
+    mavlink_status_t _decodeStatus{};
+    mavlink_message_t _decodeBuffer{};         ///< Parse state for decoding on the link thread, has no signing set
+    mavlink_status_t _decodeParseStatus{};
+    bool _decodeSignatureFailure = false;
+
+    /// @return true if the backpressure state changed, must be called with _writeQueueMutex locked
+    bool _updateWriteBackpressure();
+    void _emitWriteBackpressureChanged();
+    double _transmitRate() const;
+
+    mutable QMutex _writeQueueMutex;
+    // Protected by _writeQueueMutex
+    QList<QByteArray> _writeQueue[WritePriorityCount];
+    qsizetype _writeQueueBytes[WritePriorityCount] = {};
+    qsizetype _writeDeficit[WritePriorityCount] = {};   ///< Deficit round robin counters of the weighted lanes
+    bool _writeFlushPending = false;
+    double _transmitCapacity = 0;                       ///< Bytes per second, 0 for no limit
+    double _transmitRateFactor = 1;                     ///< Cut back from the capacity by radio feedback
+    double _transmitTokens = 0;                         ///< Token bucket of the transmit budget in bytes
+    QElapsedTimer _transmitClock;
+    std::atomic<bool> _writeBackpressure = false;
+
+    QList<QByteArray> _readBufferPool;                  ///< Buffers handed out by bytesReceived
+    QByteArray _spareReadBuffer;                        ///< Used while every pooled buffer is still held
+    static constexpr int _maxReadBufferPoolCount = 4;
+
+    /// Bytes written per flush when the link has no capacity limit, the rest waits for the next flush so control
+    /// traffic queued meanwhile goes first
+    static constexpr qsizetype _maxBytesPerFlush = 4096;
+    static constexpr qsizetype _writeQuantumBytes = 256;        ///< Deficit added per round, scaled by the lane weight
+    static constexpr int _normalWriteWeight = 3;
+    static constexpr int _bulkWriteWeight = 1;
+    static constexpr double _maxTransmitBurstSecs = 0.1;        ///< Tokens the bucket holds at most
+    static constexpr double _backpressureSecs = 0.5;            ///< Queued traffic which raises backpressure
+    static constexpr qsizetype _minBackpressureBytes = 1024;
+    static constexpr qsizetype _unlimitedBackpressureBytes = 65536;
+    static constexpr int _lowTransmitBuffer = 30;               ///< Radio txbuf percentages for the rate feedback
+    static constexpr int _highTransmitBuffer = 70;
+    static constexpr double _minTransmitRateFactor = 0.1;
 };
 
 typedef std::shared_ptr<LinkInterface> SharedLinkInterfacePtr;
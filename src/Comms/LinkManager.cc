@@ -25,6 +25,7 @@
 
 #ifndef NO_SERIAL_LINK
 #include "SerialLink.h"
+#include "SerialPortWatcher.h"
 #include "GPSManager.h"
 #include "PositionManager.h"
 #include "UdpIODevice.h"
@@ -32,6 +33,7 @@
 
 #ifdef QT_DEBUG
 #include "MockLink.h"
+#include "MockLinkSwarm.h"
 #endif
 
 #ifndef QGC_AIRLINK_DISABLED
@@ -57,6 +59,7 @@ LinkManager::LinkManager(QGCApplication *app, QGCToolbox *toolbox)
     , _portListTimer(new QTimer(this))
     , _qmlConfigurations(new QmlObjectListModel(this))
 #ifndef NO_SERIAL_LINK
+    , _serialPortWatcher(new SerialPortWatcher(this))
     , _nmeaSocket(new UdpIODevice(this))
 #endif
 {
@@ -89,6 +92,14 @@ void LinkManager::setToolbox(QGCToolbox *toolbox)
     _autoConnectSettings = toolbox->settingsManager()->autoConnectSettings();
     _mavlinkProtocol = _toolbox->mavlinkProtocol();
 
+#ifndef NO_SERIAL_LINK
+    (void) connect(_serialPortWatcher, &SerialPortWatcher::portsChanged, this, [this]() {
+        _updateCommPortLists();
+        emit commPortsChanged();
+        emit commPortStringsChanged();
+    });
+#endif
+
     if (!qgcApp()->runningUnitTests()) {
         (void) connect(_portListTimer, &QTimer::timeout, this, &LinkManager::_updateAutoConnectLinks);
         _portListTimer->start(_autoconnectUpdateTimerMSecs); // timeout must be long enough to get past bootloader on second pass
@@ -135,7 +146,11 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
         break;
 #ifdef QT_DEBUG
     case LinkConfiguration::TypeMock:
-        link = std::make_shared<MockLink>(config);
+        if (qobject_cast<const MockConfiguration*>(config.get())->swarm().vehicleCount > 0) {
+            link = std::make_shared<MockLinkSwarm>(config);
+        } else {
+            link = std::make_shared<MockLink>(config);
+        }
         break;
 #endif
 #ifndef QGC_AIRLINK_DISABLED
@@ -161,7 +176,12 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
     config->setLink(link);
 
     (void) connect(link.get(), &LinkInterface::communicationError, _app, &QGCApplication::criticalMessageBoxOnMainThread);
-    (void) connect(link.get(), &LinkInterface::bytesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveBytes);
+    if (_toolbox->settingsManager()->appSettings()->decodeMavlinkOnLinkThread()->rawValue().toBool()) {
+        link->setDecodeOnLinkThread(true);
+        (void) connect(link.get(), &LinkInterface::messagesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveMessages);
+    } else {
+        (void) connect(link.get(), &LinkInterface::bytesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveBytes);
+    }
     (void) connect(link.get(), &LinkInterface::bytesSent, _mavlinkProtocol, &MAVLinkProtocol::logSentBytes);
     (void) connect(link.get(), &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
@@ -220,6 +240,7 @@ void LinkManager::_linkDisconnected()
 
     (void) disconnect(link, &LinkInterface::communicationError, _app, &QGCApplication::criticalMessageBoxOnMainThread);
     (void) disconnect(link, &LinkInterface::bytesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveBytes);
+    (void) disconnect(link, &LinkInterface::messagesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveMessages);
     (void) disconnect(link, &LinkInterface::bytesSent, _mavlinkProtocol, &MAVLinkProtocol::logSentBytes);
     (void) disconnect(link, &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
@@ -689,10 +710,11 @@ void LinkManager::freeMavlinkChannel(uint8_t channel)
     _mavlinkChannelsUsedBitMask &= ~(1 << channel);
 }
 
-LogReplayLink *LinkManager::startLogReplay(const QString &logFile)
+LogReplayLink *LinkManager::startLogReplay(const QString &logFile, bool fastReplay)
 {
     LogReplayLinkConfiguration* const linkConfig = new LogReplayLinkConfiguration(tr("Log Replay"));
     linkConfig->setLogFilename(logFile);
+    linkConfig->setFastReplay(fastReplay);
     linkConfig->setName(linkConfig->logFilenameShort());
 
     SharedLinkConfigurationPtr sharedConfig = addConfiguration(linkConfig);
@@ -768,20 +790,20 @@ void LinkManager::_addSerialAutoConnectLink()
         _nmeaSocket->close();
     }
 
-    QList<QGCSerialPortInfo> portList;
 #ifdef Q_OS_ANDROID
     // Android builds only support a single serial connection. Repeatedly calling availablePorts after that one serial
     // port is connected leaks file handles due to a bug somewhere in android serial code. In order to work around that
     // bug after we connect the first serial port we stop probing for additional ports.
-    if (!_isSerialPortConnected()) {
-        portList = QGCSerialPortInfo::availablePorts();
+    if (_isSerialPortConnected()) {
+        return;
     }
-#else
-    portList = QGCSerialPortInfo::availablePorts();
 #endif
+    // Only enumerates the ports again if the system signaled a change, board types were detected when the ports showed up
+    _serialPortWatcher->update();
 
     QStringList currentPorts;
-    for (const QGCSerialPortInfo &portInfo: portList) {
+    for (const SerialPortWatcher::Port_t &port: _serialPortWatcher->ports()) {
+        const QGCSerialPortInfo &portInfo = port.info;
         qCDebug(LinkManagerVerboseLog) << "-----------------------------------------------------";
         qCDebug(LinkManagerVerboseLog) << "portName:          " << portInfo.portName();
         qCDebug(LinkManagerVerboseLog) << "systemLocation:    " << portInfo.systemLocation();
@@ -793,8 +815,8 @@ void LinkManager::_addSerialAutoConnectLink()
 
         currentPorts << portInfo.systemLocation();
 
-        QGCSerialPortInfo::BoardType_t boardType;
-        QString boardName;
+        const QGCSerialPortInfo::BoardType_t boardType = port.boardType;
+        const QString &boardName = port.boardName;
 
         // check to see if nmea gps is configured for current Serial port, if so, set it up to connect
         if (portInfo.systemLocation().trimmed() == _autoConnectSettings->autoConnectNmeaPort()->cookedValueString()) {
@@ -816,13 +838,13 @@ void LinkManager::_addSerialAutoConnectLink()
                 _nmeaPort->setBaudRate(static_cast<qint32>(_nmeaBaud));
                 qCDebug(LinkManagerLog) << "Configuring nmea baudrate" << _nmeaBaud;
             }
-        } else if (portInfo.getBoardInfo(boardType, boardName)) {
+        } else if (port.knownBoard) {
             // Should we be auto-connecting to this board type?
             if (!_allowAutoConnectToBoard(boardType)) {
                 continue;
             }
 
-            if (portInfo.isBootloader()) {
+            if (port.bootloader) {
                 // Don't connect to bootloader
                 qCDebug(LinkManagerLog) << "Waiting for bootloader to finish" << portInfo.systemLocation();
                 continue;
@@ -927,12 +949,17 @@ bool LinkManager::_portAlreadyConnected(const QString &portName) const
 }
 
 void LinkManager::_updateSerialPorts()
+{
+    _serialPortWatcher->update();
+    _updateCommPortLists();
+}
+
+void LinkManager::_updateCommPortLists()
 {
     _commPortList.clear();
     _commPortDisplayList.clear();
-    const QList<QGCSerialPortInfo> portList = QGCSerialPortInfo::availablePorts();
-    for (const QGCSerialPortInfo &info: portList) {
-        const QString port = info.systemLocation().trimmed();
+    for (const SerialPortWatcher::Port_t &watchedPort: _serialPortWatcher->ports()) {
+        const QString port = watchedPort.info.systemLocation().trimmed();
         _commPortList += port;
         _commPortDisplayList += SerialConfiguration::cleanPortDisplayname(port);
     }
@@ -32,6 +32,7 @@ class QGCApplication;
 class QmlObjectListModel;
 class QTimer;
 class SerialLink;
+class SerialPortWatcher;
 class UDPConfiguration;
 class UdpIODevice;
 
@@ -67,7 +68,8 @@ public:
     Q_INVOKABLE void createMavlinkForwardingSupportLink();
     /// Called to signal app shutdown. Disconnects all links while turning off auto-connect.
     Q_INVOKABLE void shutdown();
-    Q_INVOKABLE LogReplayLink *startLogReplay(const QString &logFile);
+    /// @param fastReplay true: Replay as fast as possible instead of following the log timing
+    Q_INVOKABLE LogReplayLink *startLogReplay(const QString &logFile, bool fastReplay = false);
 
     QList<SharedLinkInterfacePtr> links() { return _rgLinks; }
     QStringList linkTypeStrings() const;
@@ -185,10 +187,12 @@ signals:
 private:
     bool _isSerialPortConnected() const;
     void _updateSerialPorts();
+    void _updateCommPortLists();
     bool _allowAutoConnectToBoard(QGCSerialPortInfo::BoardType_t boardType) const;
     void _addSerialAutoConnectLink();
     bool _portAlreadyConnected(const QString &portName) const;
 
+    SerialPortWatcher *_serialPortWatcher = nullptr;
     QMap<QString, int> _autoconnectPortWaitList;   ///< key: QGCSerialPortInfo::systemLocation, value: wait count
     QList<SerialLink*> _activeLinkCheckList;       ///< List of links we are waiting for a vehicle to show up on
     QStringList _commPortList;
@@ -16,11 +16,17 @@
 #include "MAVLinkProtocol.h"
 #endif
 #include "MAVLinkLib.h"
+#include "QGC.h"
+#include "QGCLoggingCategory.h"
 
 #include <QtCore/QFileInfo>
 #include <QtCore/QtEndian>
 #include <QtTest/QSignalSpy>
 
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(LogReplayLinkLog, "qgc.comms.logreplaylink")
+
 LogReplayLinkConfiguration::LogReplayLinkConfiguration(const QString& name)
     : LinkConfiguration(name)
 {
@@ -31,6 +37,7 @@ LogReplayLinkConfiguration::LogReplayLinkConfiguration(const LogReplayLinkConfig
     : LinkConfiguration(copy)
 {
     _logFilename = copy->logFilename();
+    _fastReplay = copy->fastReplay();
 }
 
 void LogReplayLinkConfiguration::copyFrom(const LinkConfiguration *source)
@@ -39,6 +46,7 @@ void LogReplayLinkConfiguration::copyFrom(const LinkConfiguration *source)
     const LogReplayLinkConfiguration* ssource = qobject_cast<const LogReplayLinkConfiguration*>(source);
     if (ssource) {
         _logFilename = ssource->logFilename();
+        _fastReplay = ssource->fastReplay();
     } else {
         qWarning() << "Internal error";
     }
@@ -78,6 +86,7 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     , _playbackStartLogTimeUSecs (0)
     , _mavlink                   (nullptr)
     , _logFileSize               (0)
+    , _fastReplayBatchesInFlight (std::make_shared<std::atomic_int>(0))
 {
     if (!_logReplayConfig) {
         qWarning() << "Internal error";
@@ -135,7 +144,18 @@ void LogReplayLink::run(void)
     
     _connected = true;
     emit connected();
-    
+
+    if (_logReplayConfig->fastReplay()) {
+        // Each batch is acknowledged once the main thread gets to it. Since this connection is made after the
+        // connection to MAVLinkProtocol, the acknowledgement is queued behind the processing of the batch itself.
+        // The counter is shared so that acknowledgements still in the queue are harmless if the link goes away.
+        std::shared_ptr<std::atomic_int> batchesInFlight = _fastReplayBatchesInFlight;
+        *batchesInFlight = 0;
+        _fastReplayAckConnection = QObject::connect(this, &LogReplayLink::bytesReceived, qgcApp(), [batchesInFlight]() {
+            (*batchesInFlight)--;
+        }, Qt::QueuedConnection);
+    }
+
     // Start playback
     _play();
 
@@ -143,6 +163,7 @@ void LogReplayLink::run(void)
     exec();
     
     _readTickTimer.stop();
+    (void) QObject::disconnect(_fastReplayAckConnection);
 }
 
 void LogReplayLink::_replayError(const QString& errorMsg)
@@ -159,17 +180,16 @@ void LogReplayLink::_writeBytes(const QByteArray &bytes)
 
 /// Parses a BigEndian quint64 timestamp
 /// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_parseTimestamp(const QByteArray& bytes)
+quint64 LogReplayLink::_parseTimestamp(const uchar* bytes) const
 {
-    quint64 timestamp = qFromBigEndian(*((quint64*)(bytes.constData())));
-    quint64 currentTimestamp = ((quint64)QDateTime::currentMSecsSinceEpoch()) * 1000;
-    
+    quint64 timestamp = qFromBigEndian<quint64>(bytes);
+
     // Now if the parsed timestamp is in the future, it must be an old file where the timestamp was stored as
     // little endian, so switch it.
-    if (timestamp > currentTimestamp) {
+    if (timestamp > _loadTimeUSecs) {
         timestamp = qbswap(timestamp);
     }
-    
+
     return timestamp;
 }
 
@@ -178,85 +198,131 @@ quint64 LogReplayLink::_parseTimestamp(const QByteArray& bytes)
 /// @return Unix timestamp in microseconds UTC for NEXT mavlink message or 0 if no message found
 quint64 LogReplayLink::_readNextMavlinkMessage(QByteArray& bytes)
 {
-    char                nextByte;
     mavlink_status_t    status;
+    mavlink_message_t   message;
+    qint64              messageStartPos = _logPos;
 
     bytes.clear();
 
-    while (_logFile.getChar(&nextByte)) { // Loop over every byte
-        mavlink_message_t message;
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &message, &status);
+    while (_logPos < _logFileSize) { // Loop over every byte
+        bool messageFound = mavlink_parse_char(_mavlinkChannel, _logData[_logPos++], &message, &status);
 
         if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message, clear any partial bytes
-            bytes.clear();
+            // This is the possible beginning of a mavlink message, skip any partial bytes
+            messageStartPos = _logPos - 1;
         }
-        bytes.append(nextByte);
 
         if (messageFound) {
+            bytes = QByteArray(reinterpret_cast<const char*>(_logData + messageStartPos), _logPos - messageStartPos);
+
             // Return the timestamp for the next message
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
+            if ((_logFileSize - _logPos) < cbTimestamp) {
+                _logPos = _logFileSize;
+                return 0;
+            }
+            const quint64 timestamp = _parseTimestamp(_logData + _logPos);
+            _logPos += cbTimestamp;
+            return timestamp;
         }
     }
 
     return 0;
 }
 
-/// Seeks to the beginning of the next successfully parsed mavlink message in the log file.
-///     @param nextMsg[output] Parsed next message that was found
-/// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_seekToNextMavlinkMessage(mavlink_message_t* nextMsg)
+/// Builds the timestamp index for the log and finds the last timestamp. This is a single pass over the mapped file,
+/// after which moving the playhead is a binary search of the index.
+///     @param startPos Record to start at, the index up to there is kept
+///     @return Last timestamp in the log
+quint64 LogReplayLink::_buildLogIndex(qint64 startPos)
 {
-    char                nextByte;
     mavlink_status_t    status;
-    qint64              messageStartPos = -1;
+    mavlink_message_t   msg;
+    quint64             lastTimestamp = 0;
+    qint64              pos = startPos;
 
+    if (startPos == 0) {
+        _logIndex.clear();
+    }
     mavlink_reset_channel_status(_mavlinkChannel);
 
-    while (_logFile.getChar(&nextByte)) {
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, nextMsg, &status);
+    while ((_logFileSize - pos) > cbTimestamp) {
+        lastTimestamp = _parseTimestamp(_logData + pos);
+        pos += cbTimestamp;
 
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message
-            messageStartPos = _logFile.pos() - 1;
+        // Only record entries which keep the index sorted, so a log with the clock jumping backwards still works
+        if (_logIndex.isEmpty() || (lastTimestamp >= (_logIndex.last().timestampUSecs + _logIndexIntervalUSecs))) {
+            _logIndex.append({ lastTimestamp, pos });
         }
-        
-        // If we've found a message, jump back to the start of the message, grab the timestamp,
-        // and go back to the end of this file.
-        if (messageFound && messageStartPos != -1) {
-            _logFile.seek(messageStartPos - cbTimestamp);
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
+
+        bool endOfMessage = false;
+        while (!endOfMessage && (pos < _logFileSize)) {
+            endOfMessage = mavlink_parse_char(_mavlinkChannel, _logData[pos++], &msg, &status);
         }
     }
-    
-    return 0;
+
+    mavlink_reset_channel_status(_mavlinkChannel);
+
+    return lastTimestamp;
 }
 
-quint64 LogReplayLink::_findLastTimestamp(void)
+/// Reads the index file MAVLinkLogWriter writes next to the log. Each entry is checked against the timestamp in the log,
+/// so an index which does not belong to the log is ignored.
+///     @return Offset of the last indexed record, from where the rest of the log still needs to be scanned. 0 if there
+///             is no usable index.
+qint64 LogReplayLink::_loadLogIndexFile(void)
 {
-    char                nextByte;
-    mavlink_status_t    status;
-    quint64             lastTimestamp = 0;
-    mavlink_message_t   msg;
+    _logIndex.clear();
 
-    // We read through the entire file looking for the last good timestamp. This can be somewhat slow, but trying to work from the
-    // end of the file can be way slower due to all the seeking back and forth required. So instead we take the simple reliable approach.
+    QFile indexFile(MAVLinkLogWriter::indexFileName(_logFile.fileName()));
+    if (!indexFile.open(QFile::ReadOnly)) {
+        return 0;
+    }
+    const QByteArray bytes = indexFile.readAll();
+    if (!bytes.startsWith(QByteArray(MAVLinkLogWriter::indexMagic, 8))) {
+        qCWarning(LogReplayLinkLog) << "Unknown index format" << indexFile.fileName();
+        return 0;
+    }
 
-    _logFile.reset();
-    mavlink_reset_channel_status(_mavlinkChannel);
+    constexpr qsizetype indexEntrySize = sizeof(quint64) + sizeof(quint64) + sizeof(quint32);
+    const uchar* const data = reinterpret_cast<const uchar*>(bytes.constData());
+    qint64 lastOffset = 0;
+    qsizetype pos = 8;
+    while (pos < bytes.size()) {
+        const char type = bytes[pos++];
+        if (type == MAVLinkLogWriter::indexLinkType) {
+            if ((bytes.size() - pos) < 2) {
+                break;
+            }
+            pos += 2 + data[pos + 1];
+            continue;
+        }
+        if ((type != MAVLinkLogWriter::indexEntryType) || ((bytes.size() - pos) < indexEntrySize)) {
+            // Cut short by a crash, or written by a newer version
+            break;
+        }
 
-    while (_logFile.bytesAvailable() > cbTimestamp) {
-        lastTimestamp = _parseTimestamp(_logFile.read(cbTimestamp));
+        const quint64 timestamp = qFromLittleEndian<quint64>(data + pos);
+        const qint64 offset = static_cast<qint64>(qFromLittleEndian<quint64>(data + pos + sizeof(quint64)));
+        pos += indexEntrySize;
 
-        bool endOfMessage = false;
-        while (!endOfMessage && _logFile.getChar(&nextByte)) {
-            endOfMessage = mavlink_parse_char(_mavlinkChannel, nextByte, &msg, &status);
+        if ((offset < lastOffset) || ((_logFileSize - offset) <= cbTimestamp)) {
+            break;
         }
+        if (_parseTimestamp(_logData + offset) != timestamp) {
+            qCWarning(LogReplayLinkLog) << "Index does not match log, scanning instead" << indexFile.fileName();
+            _logIndex.clear();
+            return 0;
+        }
+
+        if (_logIndex.isEmpty() || (timestamp >= (_logIndex.last().timestampUSecs + _logIndexIntervalUSecs))) {
+            _logIndex.append({ timestamp, offset + cbTimestamp });
+        }
+        lastOffset = offset;
     }
 
-    return lastTimestamp;
+    qCDebug(LogReplayLinkLog) << "Loaded index entries" << _logIndex.count() << "scanning from" << lastOffset << "of" << _logFileSize;
+
+    return lastOffset;
 }
 
 bool LogReplayLink::_loadLogFile(void)
@@ -280,9 +346,23 @@ bool LogReplayLink::_loadLogFile(void)
     }
     logFileInfo.setFile(logFilename);
     _logFileSize = logFileInfo.size();
-    
-    startTimeUSecs = _parseTimestamp(_logFile.read(cbTimestamp));
-    endTimeUSecs = _findLastTimestamp();
+    if (_logFileSize <= cbTimestamp) {
+        errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
+        goto Error;
+    }
+
+    // The whole log is read through a memory mapped view, which makes reading and seeking a matter of pointer arithmetic
+    _logData = _logFile.map(0, _logFileSize);
+    if (!_logData) {
+        errorMsg = tr("Unable to map log file: '%1', error: %2").arg(logFilename).arg(_logFile.errorString());
+        goto Error;
+    }
+    _loadTimeUSecs = QGC::utcTimeUsecs();
+
+    startTimeUSecs = _parseTimestamp(_logData);
+    // Only the part of the log after the last entry of its index file needs scanning, which for a log which was saved
+    // normally is at most the last index interval
+    endTimeUSecs = _buildLogIndex(_loadLogIndexFile());
 
     if (endTimeUSecs <= startTimeUSecs) {
         errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
@@ -296,7 +376,7 @@ bool LogReplayLink::_loadLogFile(void)
     _logCurrentTimeUSecs = startTimeUSecs;
 
     // Reset our log file so when we go to read it for the first time, we start at the beginning.
-    _logFile.reset();
+    _resetPlaybackToBeginning();
 
     logDurationSecondsTotal = (_logDurationUSecs) / 1000000;
     
@@ -306,8 +386,11 @@ bool LogReplayLink::_loadLogFile(void)
     
 Error:
     if (_logFile.isOpen()) {
+        // Closing also unmaps
         _logFile.close();
     }
+    _logData = nullptr;
+    _logIndex.clear();
     _replayError(errorMsg);
     return false;
 }
@@ -318,6 +401,11 @@ Error:
 /// induce a static drift into the log file replay.
 void LogReplayLink::_readNextLogEntry(void)
 {
+    if (_logReplayConfig->fastReplay()) {
+        _readNextLogBatch();
+        return;
+    }
+
     QByteArray bytes;
 
     // Now parse MAVLink messages, grabbing their timestamps as we go. We stop once we
@@ -330,10 +418,11 @@ void LogReplayLink::_readNextLogEntry(void)
     while (timeToNextExecutionMSecs < 3) {
         // Read the next mavlink message from the log
         qint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
-        emit bytesReceived(this, bytes);
+        // Messages are stamped with their original arrival time from the log
+        emit bytesReceived(this, bytes, _logCurrentTimeUSecs);
         emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
 
-        if (_logFile.atEnd()) {
+        if (_logAtEnd()) {
             _finishPlayback();
             return;
         }
@@ -356,6 +445,51 @@ void LogReplayLink::_readNextLogEntry(void)
     _readTickTimer.start(timeToNextExecutionMSecs);
 }
 
+/// Fast replay: reads the log without regard to timing and passes it on in large batches. The link never gets more
+/// than a few batches ahead of the main thread, which keeps memory bounded without dropping anything. Progress is
+/// only signalled periodically.
+void LogReplayLink::_readNextLogBatch(void)
+{
+    if (*_fastReplayBatchesInFlight >= _fastReplayMaxBatchesInFlight) {
+        // Wait for the main thread to catch up
+        _readTickTimer.start(1);
+        return;
+    }
+
+    QByteArray batch;
+    batch.reserve(_fastReplayBatchSize + MAVLINK_MAX_PACKET_LEN);
+    const quint64 batchTimeUSecs = _logCurrentTimeUSecs;
+
+    QByteArray bytes;
+    while (batch.size() < _fastReplayBatchSize) {
+        const quint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
+        batch.append(bytes);
+        if (_logAtEnd()) {
+            break;
+        }
+        _logCurrentTimeUSecs = nextTimeUSecs;
+    }
+
+    if (!batch.isEmpty()) {
+        (*_fastReplayBatchesInFlight)++;
+        emit bytesReceived(this, batch, batchTimeUSecs);
+    }
+
+    if (!_fastReplayProgressTimer.isValid() || (_fastReplayProgressTimer.elapsed() >= _fastReplayProgressIntervalMSecs) || _logAtEnd()) {
+        _fastReplayProgressTimer.start();
+        emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
+        _signalCurrentLogTimeSecs();
+    }
+
+    if (_logAtEnd()) {
+        _finishPlayback();
+        return;
+    }
+
+    // Let the event loop run between batches so pause and disconnect requests are still handled
+    _readTickTimer.start(0);
+}
+
 void LogReplayLink::_play(void)
 {
     qgcApp()->toolbox()->linkManager()->setConnectionsSuspended(tr("Connect not allowed during Flight Data replay."));
@@ -364,7 +498,7 @@ void LogReplayLink::_play(void)
 #endif
     
     // Make sure we aren't at the end of the file, if we are, reset to the beginning and play from there.
-    if (_logFile.atEnd()) {
+    if (_logAtEnd()) {
         _resetPlaybackToBeginning();
     }
     
@@ -389,10 +523,10 @@ void LogReplayLink::_pause(void)
 
 void LogReplayLink::_resetPlaybackToBeginning(void)
 {
-    if (_logFile.isOpen()) {
-        _logFile.reset();
-    }
-    
+    // The first record starts with the timestamp of the first message
+    _logPos = cbTimestamp;
+    mavlink_reset_channel_status(_mavlinkChannel);
+
     // And since we haven't starting playback, clear the time of initial playback and the current timestamp.
     _playbackStartTimeMSecs = 0;
     _playbackStartLogTimeUSecs = 0;
@@ -418,44 +552,27 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
     }
     
     qreal percentCompleteMult = percentComplete / 100.0;
-    
-    // But if we have a timestamped MAVLink log, then actually aim to hit that percentage in terms of
-    // time through the file.
-    qint64 newFilePos = (qint64)(percentCompleteMult * (qreal)_logFile.size());
-
-    // Now seek to the appropriate position, failing gracefully if we can't.
-    if (!_logFile.seek(newFilePos)) {
-        _replayError(tr("Unable to seek to new position"));
-        return;
+    const quint64 desiredTimeUSecs = _logStartTimeUSecs + static_cast<quint64>(percentCompleteMult * _logDurationUSecs);
+
+    // Binary search the index for the last entry at or before the desired time
+    auto it = std::upper_bound(_logIndex.cbegin(), _logIndex.cend(), desiredTimeUSecs, [](quint64 timestampUSecs, const LogIndexEntry& entry) {
+        return timestampUSecs < entry.timestampUSecs;
+    });
+    if (it != _logIndex.cbegin()) {
+        --it;
     }
-
-    // But we do align to the next MAVLink message for consistency.
-    mavlink_message_t dummy;
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
-
-    // Now calculate the current file location based on time.
-    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
-
-    // Calculate the effective baud rate of the file in bytes/s.
-    qreal baudRate = _logFile.size() / (qreal)_logDurationUSecs / 1e6;
-
-    // And the desired time is:
-    qreal desiredTimeUSecs = percentCompleteMult * _logDurationUSecs;
-
-    // And now jump the necessary number of bytes in the proper direction
-    qint64 offset = (newRelativeTimeUSecs - desiredTimeUSecs) * baudRate;
-    if (!_logFile.seek(_logFile.pos() + offset)) {
+    if (it == _logIndex.cend()) {
         _replayError(tr("Unable to seek to new position"));
         return;
     }
 
-    // And scan until we reach the start of a MAVLink message. We make sure to record this timestamp for
-    // smooth jumping around the file.
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
+    mavlink_reset_channel_status(_mavlinkChannel);
+    _logPos = it->offset;
+    _logCurrentTimeUSecs = it->timestampUSecs;
     _signalCurrentLogTimeSecs();
 
     // Now update the UI with our actual final position.
-    newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
+    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
     percentComplete = (newRelativeTimeUSecs / _logDurationUSecs) * 100;
     emit playbackPercentCompleteChanged(percentComplete);
 }
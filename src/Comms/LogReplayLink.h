@@ -14,6 +14,14 @@
 
 #include <QtCore/QTimer>
 #include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLoggingCategory>
+
+#include <atomic>
+#include <memory>
+
+Q_DECLARE_LOGGING_CATEGORY(LogReplayLinkLog)
 
 class LinkManager;
 class MAVLinkProtocol;
@@ -35,6 +43,10 @@ public:
 
     QString logFilenameShort(void);
 
+    /// Fast replay ignores the log timing and feeds the log through as fast as it can be processed
+    bool fastReplay(void) const { return _fastReplay; }
+    void setFastReplay(bool fastReplay) { _fastReplay = fastReplay; }
+
     // Virtuals from LinkConfiguration
     LinkType    type                    (void) const override                                         { return LinkConfiguration::TypeLogReplay; }
     void        copyFrom                (const LinkConfiguration* source) override;
@@ -49,6 +61,7 @@ signals:
 private:
     static constexpr const char*  _logFilenameKey = "logFilename";
     QString             _logFilename;
+    bool                _fastReplay = false;
 };
 
 /// Pseudo link that reads a telemetry log and feeds it into the application.
@@ -104,10 +117,12 @@ private:
     bool _connect(void) override;
 
     void    _replayError                (const QString& errorMsg);
-    quint64 _parseTimestamp             (const QByteArray& bytes);
-    quint64 _seekToNextMavlinkMessage   (mavlink_message_t* nextMsg);
-    quint64 _findLastTimestamp          (void);
+    quint64 _parseTimestamp             (const uchar* bytes) const;
+    quint64 _buildLogIndex              (qint64 startPos = 0);
+    qint64  _loadLogIndexFile           (void);
     quint64 _readNextMavlinkMessage     (QByteArray& bytes);
+    void    _readNextLogBatch           (void);
+    bool    _logAtEnd                   (void) const { return _logPos >= _logFileSize; }
     bool    _loadLogFile                (void);
     void    _finishPlayback             (void);
     void    _resetPlaybackToBeginning   (void);
@@ -135,9 +150,27 @@ private:
 
     MAVLinkProtocol*    _mavlink;
     QFile               _logFile;
-    quint64             _logFileSize;
+    qint64              _logFileSize;
+    const uchar*        _logData = nullptr;     ///< Memory mapped view of the whole log file
+    qint64              _logPos = 0;            ///< Current read position in _logData
+    quint64             _loadTimeUSecs = 0;     ///< Time the log was loaded, used to detect old little endian timestamps
+
+    /// Sparse, time sorted index into the log used to move the playhead
+    struct LogIndexEntry {
+        quint64 timestampUSecs;
+        qint64  offset;         ///< Offset of the message following the timestamp
+    };
+    QList<LogIndexEntry> _logIndex;
+
+    std::shared_ptr<std::atomic_int>    _fastReplayBatchesInFlight;     ///< Batches emitted but not yet processed by the main thread
+    QMetaObject::Connection             _fastReplayAckConnection;
+    QElapsedTimer                       _fastReplayProgressTimer;
 
     static const int cbTimestamp = sizeof(quint64);
+    static constexpr qsizetype  _fastReplayBatchSize                = 64 * 1024;
+    static constexpr int        _fastReplayMaxBatchesInFlight       = 4;
+    static constexpr qint64     _fastReplayProgressIntervalMSecs    = 250;
+    static constexpr quint64 _logIndexIntervalUSecs = 100 * 1000;   ///< Minimum time between index entries, sets the playhead resolution
 };
 
 class LogReplayLinkController : public QObject
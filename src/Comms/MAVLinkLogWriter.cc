@@ -0,0 +1,274 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriter.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+QGC_LOGGING_CATEGORY(MAVLinkLogWriterLog, "MAVLinkLogWriterLog")
+
+MAVLinkLogWriter::MAVLinkLogWriter(QObject* parent)
+    : QThread(parent)
+{
+
+}
+
+MAVLinkLogWriter::~MAVLinkLogWriter()
+{
+    stopWriting();
+}
+
+bool MAVLinkLogWriter::startWriting(const QString& fileName, int syncIntervalMsecs)
+{
+    if (_writing) {
+        stopWriting();
+    }
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(MAVLinkLogWriterLog) << "Unable to open" << fileName << _file.errorString();
+        return false;
+    }
+
+    // The log is still usable without an index, players fall back to scanning it
+    _indexFile.setFileName(indexFileName(fileName));
+    if (!_indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || (_indexFile.write(indexMagic, 8) != 8)) {
+        qCWarning(MAVLinkLogWriterLog) << "Unable to write index" << _indexFile.fileName() << _indexFile.errorString();
+        _indexFile.close();
+    }
+
+    if (_ring.size() != _ringSize) {
+        _ring.resize(_ringSize);
+    }
+    _head = 0;
+    _tail = 0;
+    _indexHead = 0;
+    _indexTail = 0;
+    _lastIndexUSecs = 0;
+    _linkMask = 0;
+    _indexed = false;
+    _droppedRecords = 0;
+    _stopRequested = false;
+    _syncIntervalMsecs = syncIntervalMsecs;
+    _writing = true;
+
+    start(LowPriority);
+
+    return true;
+}
+
+void MAVLinkLogWriter::stopWriting(void)
+{
+    if (!_writing) {
+        return;
+    }
+
+    _stopRequested = true;
+    wait();
+
+    _syncFile();
+    _file.close();
+    _indexFile.close();
+    _writing = false;
+
+    if (_droppedRecords) {
+        qCWarning(MAVLinkLogWriterLog) << "Dropped" << _droppedRecords << "records, storage was unable to keep up";
+    }
+}
+
+void MAVLinkLogWriter::setLinkName(int linkId, const QString& name)
+{
+    if (!_writing || (linkId < 0) || (linkId > 31)) {
+        return;
+    }
+
+    IndexEntry_t entry{};
+    entry.type = indexLinkType;
+    entry.linkId = static_cast<quint8>(linkId);
+
+    const QByteArray utf8 = name.toUtf8().left(sizeof(entry.name));
+    memcpy(entry.name, utf8.constData(), utf8.size());
+    entry.nameLen = static_cast<quint8>(utf8.size());
+
+    _queueIndex(entry);
+}
+
+bool MAVLinkLogWriter::queueRecord(quint64 timestampUsecs, const char* data, qsizetype len, int linkId)
+{
+    if (!_writing) {
+        return false;
+    }
+
+    const quint64 recordLen = sizeof(quint64) + static_cast<quint64>(len);
+    const quint64 head = _head.load(std::memory_order_relaxed);
+    const quint64 tail = _tail.load(std::memory_order_acquire);
+    if ((_ringSize - (head - tail)) < recordLen) {
+        _droppedRecords++;
+        return false;
+    }
+
+    uchar timestamp[sizeof(quint64)];
+    qToBigEndian(timestampUsecs, timestamp);
+    _copyToRing(head, reinterpret_cast<const char*>(timestamp), sizeof(timestamp));
+    _copyToRing(head + sizeof(timestamp), data, len);
+
+    // Publish the complete record to the writer thread
+    _head.store(head + recordLen, std::memory_order_release);
+
+    if ((linkId >= 0) && (linkId <= 31)) {
+        _linkMask |= 1u << linkId;
+    }
+    // A clock jumping backwards also starts a new entry, players skip the ones which are out of order
+    if (!_indexed || (timestampUsecs >= (_lastIndexUSecs + indexIntervalUSecs)) || (timestampUsecs < _lastIndexUSecs)) {
+        IndexEntry_t entry{};
+        entry.type = indexEntryType;
+        entry.linkMask = _linkMask;
+        entry.timestampUSecs = timestampUsecs;
+        entry.offset = head;
+        _queueIndex(entry);
+
+        _linkMask = 0;
+        _lastIndexUSecs = timestampUsecs;
+        _indexed = true;
+    }
+
+    return true;
+}
+
+void MAVLinkLogWriter::_queueIndex(const IndexEntry_t& entry)
+{
+    const quint64 head = _indexHead.load(std::memory_order_relaxed);
+    if ((head - _indexTail.load(std::memory_order_acquire)) >= _indexRing.size()) {
+        return;
+    }
+
+    _indexRing[head % _indexRing.size()] = entry;
+    _indexHead.store(head + 1, std::memory_order_release);
+}
+
+void MAVLinkLogWriter::_copyToRing(quint64 position, const char* data, qsizetype len)
+{
+    const qsizetype index = static_cast<qsizetype>(position % _ringSize);
+    const qsizetype firstLen = std::min(len, _ringSize - index);
+    memcpy(_ring.data() + index, data, firstLen);
+    if (firstLen < len) {
+        memcpy(_ring.data(), data + firstLen, len - firstLen);
+    }
+}
+
+void MAVLinkLogWriter::run(void)
+{
+    QElapsedTimer syncTimer;
+    syncTimer.start();
+
+    while (!_stopRequested) {
+        if (!_writeQueued()) {
+            return;
+        }
+        _writeIndex();
+        if ((_syncIntervalMsecs > 0) && (syncTimer.elapsed() >= _syncIntervalMsecs)) {
+            _syncFile();
+            syncTimer.restart();
+        }
+        QThread::msleep(_writeIntervalMsecs);
+    }
+
+    // Drain whatever was queued before the stop request
+    if (_writeQueued()) {
+        _writeIndex();
+    }
+}
+
+/// Writes everything currently in the ring to the file, at most two writes due to wrap around
+///     @return false: write failed
+bool MAVLinkLogWriter::_writeQueued(void)
+{
+    const quint64 head = _head.load(std::memory_order_acquire);
+    quint64 tail = _tail.load(std::memory_order_relaxed);
+    if (head == tail) {
+        return true;
+    }
+
+    while (tail != head) {
+        const qsizetype index = static_cast<qsizetype>(tail % _ringSize);
+        const qsizetype len = static_cast<qsizetype>(std::min<quint64>(head - tail, _ringSize - index));
+        if (_file.write(_ring.constData() + index, len) != len) {
+            qCWarning(MAVLinkLogWriterLog) << "Write failed" << _file.fileName() << _file.errorString();
+            emit writeFailed(_file.errorString());
+            return false;
+        }
+        tail += len;
+
+        // Hand the space back to the producer
+        _tail.store(tail, std::memory_order_release);
+    }
+
+    // Push QFile's buffer to the OS, only _syncFile waits on the storage itself
+    (void) _file.flush();
+
+    return true;
+}
+
+/// Writes the queued index entries, after the records they point to
+void MAVLinkLogWriter::_writeIndex(void)
+{
+    const quint64 head = _indexHead.load(std::memory_order_acquire);
+    quint64 tail = _indexTail.load(std::memory_order_relaxed);
+    if (head == tail) {
+        return;
+    }
+
+    QByteArray bytes;
+    for (; tail != head; tail++) {
+        const IndexEntry_t& entry = _indexRing[tail % _indexRing.size()];
+        bytes.append(entry.type);
+        if (entry.type == indexEntryType) {
+            uchar fields[sizeof(quint64) + sizeof(quint64) + sizeof(quint32)];
+            qToLittleEndian(entry.timestampUSecs, fields);
+            qToLittleEndian(entry.offset, fields + sizeof(quint64));
+            qToLittleEndian(entry.linkMask, fields + (2 * sizeof(quint64)));
+            bytes.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+        } else {
+            bytes.append(static_cast<char>(entry.linkId));
+            bytes.append(static_cast<char>(entry.nameLen));
+            bytes.append(entry.name, entry.nameLen);
+        }
+    }
+    _indexTail.store(tail, std::memory_order_release);
+
+    if (_indexFile.isOpen() && ((_indexFile.write(bytes) != bytes.size()) || !_indexFile.flush())) {
+        qCWarning(MAVLinkLogWriterLog) << "Index write failed, continuing without index" << _indexFile.fileName() << _indexFile.errorString();
+        _indexFile.close();
+        (void) QFile::remove(_indexFile.fileName());
+    }
+}
+
+void MAVLinkLogWriter::_syncFile(void)
+{
+    if (!_file.isOpen() || !_file.flush()) {
+        return;
+    }
+
+#ifdef Q_OS_WIN
+    (void) _commit(_file.handle());
+#else
+    (void) ::fsync(_file.handle());
+#endif
+}
@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+
+#include <array>
+#include <atomic>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkLogWriterLog)
+
+/// Writes telemetry log records from a dedicated thread so that a slow file system never stalls the thread
+/// producing the records. Records are handed over through a preallocated single producer/single consumer ring
+/// buffer: queueing a record is a couple of memcpys and never allocates, locks or touches the file. The writer
+/// thread drains the ring in large blocks and syncs the file to storage at a configurable interval.
+///
+/// Alongside the log the writer keeps an index file, named by indexFileName, so that a player can seek without scanning
+/// the whole log. The log itself stays a plain tlog which any tool can read. The index file starts with indexMagic
+/// followed by little endian entries:
+///
+///     'I' timestampUSecs:u64 offset:u64 linkMask:u32  Record at offset, written every indexIntervalUSecs of log time.
+///                                                     linkMask has a bit set for each link id with records since
+///                                                     the previous entry.
+///     'L' linkId:u8 nameLen:u8 name:utf8              Name of a link id, written before its first record
+///
+/// Index entries reach the writer thread through a second, much smaller ring. An entry which does not fit is dropped,
+/// a gap in the index only makes seeking there coarser.
+///
+/// startWriting, stopWriting, setLinkName and queueRecord must all be called from the same (producer) thread.
+class MAVLinkLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    MAVLinkLogWriter(QObject* parent = nullptr);
+    ~MAVLinkLogWriter();
+
+    /// Opens the file and starts the writer thread
+    ///     @param fileName File to write to, existing contents are discarded
+    ///     @param syncIntervalMsecs How often the file is synced to storage, 0 to only sync when writing stops
+    /// @return false: file could not be opened
+    bool startWriting(const QString& fileName, int syncIntervalMsecs);
+
+    /// Writes out everything which is still queued, syncs and closes the file and stops the writer thread
+    void stopWriting(void);
+
+    bool isWriting(void) const { return _writing; }
+
+    /// Names a link id in the index file. Call before the first record of the link and again if the id is reused.
+    void setLinkName(int linkId, const QString& name);
+
+    /// Queues a log record consisting of a big endian timestamp followed by the data. The record is dropped as a
+    /// whole if the ring buffer is full so the log never contains partial records.
+    ///     @param timestampUsecs Timestamp in microseconds
+    ///     @param linkId Link the record came from or went to, 0 to 31, -1 for unknown
+    /// @return false: record was dropped
+    bool queueRecord(quint64 timestampUsecs, const char* data, qsizetype len, int linkId = -1);
+
+    static QString indexFileName(const QString& logFileName) { return logFileName + QStringLiteral(".idx"); }
+
+    static constexpr const char*    indexMagic =            "QGCTIDX1";         ///< 8 bytes, last character is the format version
+    static constexpr quint64        indexIntervalUSecs =    100 * 1000;
+    static constexpr char           indexEntryType =        'I';
+    static constexpr char           indexLinkType =         'L';
+
+    // QThread overrides
+    void run(void) override;
+
+signals:
+    /// Emitted from the writer thread when writing to the file failed. The writer stops writing after this.
+    void writeFailed(const QString& errorString);
+
+private:
+    struct IndexEntry_t {
+        char    type;
+        quint8  linkId;
+        quint32 linkMask;
+        quint64 timestampUSecs;
+        quint64 offset;
+        char    name[64];
+        quint8  nameLen;
+    };
+
+    void _copyToRing    (quint64 position, const char* data, qsizetype len);
+    void _queueIndex    (const IndexEntry_t& entry);
+    bool _writeQueued   (void);
+    void _writeIndex    (void);
+    void _syncFile      (void);
+
+    QFile               _file;
+    QFile               _indexFile;
+    QByteArray          _ring;
+    std::atomic<quint64> _head { 0 };               ///< Total bytes queued, only written by the producer
+    std::atomic<quint64> _tail { 0 };               ///< Total bytes written to the file, only written by the writer thread
+    std::atomic_bool    _stopRequested { false };
+    bool                _writing = false;
+    int                 _syncIntervalMsecs = 0;
+    quint64             _droppedRecords = 0;
+
+    std::array<IndexEntry_t, 256>   _indexRing;
+    std::atomic<quint64>            _indexHead { 0 };
+    std::atomic<quint64>            _indexTail { 0 };
+    quint64                         _lastIndexUSecs = 0;    ///< Producer side
+    quint32                         _linkMask = 0;          ///< Producer side, links seen since the last index entry
+    bool                            _indexed = false;       ///< Producer side, an index entry was queued since startWriting
+
+    static constexpr qsizetype  _ringSize           = 4 * 1024 * 1024;  ///< Enough to ride out multi second storage stalls at high telemetry rates
+    static constexpr int        _writeIntervalMsecs = 100;              ///< How often the writer thread drains the ring
+};
@@ -0,0 +1,278 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageStats.h"
+#include "MAVLinkLib.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <algorithm>
+#include <cstdlib>
+
+QGC_LOGGING_CATEGORY(MAVLinkMessageStatsLog, "qgc.comms.mavlinkmessagestats")
+
+namespace {
+
+QString messageName(quint32 msgid)
+{
+    if (msgid == MAVLinkMessageStats::componentMsgId) {
+        return QString();
+    }
+    const mavlink_message_info_t* const info = mavlink_get_message_info_by_id(msgid);
+    return info ? QString::fromLatin1(info->name) : QString::number(msgid);
+}
+
+quint64 snapshotKey(const MAVLinkMessageStats::Snapshot_t& entry)
+{
+    return (quint64(entry.sysid) << 32) | (quint64(entry.compid) << 24) | entry.msgid;
+}
+
+} // namespace
+
+MAVLinkMessageStats::MAVLinkMessageStats(QObject* parent)
+    : QObject(parent)
+{
+    _updateTimer.setInterval(updateIntervalMSecs);
+
+    (void) connect(&_updateTimer, &QTimer::timeout, this, &MAVLinkMessageStats::_updateMessages);
+}
+
+void MAVLinkMessageStats::setActive(bool active)
+{
+    if (active == _active) {
+        return;
+    }
+
+    _active = active;
+    _previous.clear();
+    if (_active) {
+        _updateElapsed.start();
+        _updateTimer.start();
+        _updateMessages();
+    } else {
+        _updateTimer.stop();
+        _messages.clear();
+        emit messagesChanged();
+    }
+
+    emit activeChanged(_active);
+}
+
+MAVLinkMessageStats::Entry_t* MAVLinkMessageStats::_entry(quint64 key)
+{
+    const quint64 hash = key * 0x9E3779B97F4A7C15ull;
+    quint32 index = static_cast<quint32>(hash >> 32) & (tableSize - 1);
+
+    for (int probe = 0; probe < tableSize; probe++) {
+        Entry_t& entry = _table[index];
+        const quint64 entryKey = entry.key.load(std::memory_order_relaxed);
+        if (entryKey == key) {
+            return &entry;
+        }
+        if (entryKey == 0) {
+            // Keep probe sequences short, the remaining entries stay free
+            if (_entryCount.load(std::memory_order_relaxed) >= ((tableSize / 4) * 3)) {
+                return nullptr;
+            }
+            _entryCount.store(_entryCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            // Publish the key last, readers skip the entry until then
+            entry.key.store(key, std::memory_order_release);
+            return &entry;
+        }
+        index = (index + 1) & (tableSize - 1);
+    }
+
+    return nullptr;
+}
+
+void MAVLinkMessageStats::record(quint8 sysid, quint8 compid, quint32 msgid, quint32 bytes, quint64 timestampUSecs, quint32 lost)
+{
+    if (_resetRequested.exchange(false, std::memory_order_acquire)) {
+        _clear();
+    }
+
+    // Only this thread writes, so the counters are updated with plain loads and stores instead of read-modify-write
+    const auto add = [](std::atomic<quint64>& counter, quint64 value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+
+    for (const quint32 id : { msgid, componentMsgId }) {
+        Entry_t* const entry = _entry(_key(sysid, compid, id));
+        if (!entry) {
+            add(_untracked, 1);
+            continue;
+        }
+
+        const quint64 lastUSecs = entry->lastUSecs.load(std::memory_order_relaxed);
+        if (lastUSecs == 0) {
+            entry->firstUSecs.store(timestampUSecs, std::memory_order_relaxed);
+        } else if (timestampUSecs >= lastUSecs) {
+            // Smoothed interval, and the smoothed deviation from it as the jitter
+            const qint64 interval = static_cast<qint64>(timestampUSecs - lastUSecs);
+            qint64 smoothedInterval = static_cast<qint64>(entry->intervalUSecs.load(std::memory_order_relaxed));
+            qint64 jitter = static_cast<qint64>(entry->jitterUSecs.load(std::memory_order_relaxed));
+            if (entry->count.load(std::memory_order_relaxed) == 1) {
+                smoothedInterval = interval;
+            } else {
+                smoothedInterval += (interval - smoothedInterval) / _jitterGain;
+            }
+            jitter += (std::abs(interval - smoothedInterval) - jitter) / _jitterGain;
+            entry->intervalUSecs.store(static_cast<quint64>(smoothedInterval), std::memory_order_relaxed);
+            entry->jitterUSecs.store(static_cast<quint64>(jitter), std::memory_order_relaxed);
+        }
+        entry->lastUSecs.store(timestampUSecs, std::memory_order_relaxed);
+        add(entry->bytes, bytes);
+        if ((id == componentMsgId) && lost) {
+            add(entry->lost, lost);
+        }
+        // Count last, a reader which sees the new count also sees the rest
+        entry->count.store(entry->count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+}
+
+void MAVLinkMessageStats::reset(void)
+{
+    _resetRequested.store(true, std::memory_order_release);
+    _previous.clear();
+}
+
+void MAVLinkMessageStats::_clear(void)
+{
+    for (Entry_t& entry : _table) {
+        entry.key.store(0, std::memory_order_relaxed);
+        entry.count.store(0, std::memory_order_relaxed);
+        entry.bytes.store(0, std::memory_order_relaxed);
+        entry.lost.store(0, std::memory_order_relaxed);
+        entry.firstUSecs.store(0, std::memory_order_relaxed);
+        entry.lastUSecs.store(0, std::memory_order_relaxed);
+        entry.intervalUSecs.store(0, std::memory_order_relaxed);
+        entry.jitterUSecs.store(0, std::memory_order_relaxed);
+    }
+    _entryCount.store(0, std::memory_order_relaxed);
+    _untracked.store(0, std::memory_order_relaxed);
+}
+
+QList<MAVLinkMessageStats::Snapshot_t> MAVLinkMessageStats::snapshot(void) const
+{
+    QList<Snapshot_t> snapshot;
+    snapshot.reserve(_entryCount.load(std::memory_order_relaxed));
+
+    for (const Entry_t& entry : _table) {
+        const quint64 key = entry.key.load(std::memory_order_acquire);
+        if (key == 0) {
+            continue;
+        }
+
+        Snapshot_t sample;
+        sample.count            = entry.count.load(std::memory_order_acquire);
+        sample.sysid            = static_cast<quint8>(key >> 32);
+        sample.compid           = static_cast<quint8>(key >> 24);
+        sample.msgid            = static_cast<quint32>(key & 0xFFFFFF);
+        sample.bytes            = entry.bytes.load(std::memory_order_relaxed);
+        sample.lost             = entry.lost.load(std::memory_order_relaxed);
+        sample.firstUSecs       = entry.firstUSecs.load(std::memory_order_relaxed);
+        sample.lastUSecs        = entry.lastUSecs.load(std::memory_order_relaxed);
+        sample.intervalUSecs    = entry.intervalUSecs.load(std::memory_order_relaxed);
+        sample.jitterUSecs      = entry.jitterUSecs.load(std::memory_order_relaxed);
+        if (sample.count) {
+            snapshot.append(sample);
+        }
+    }
+
+    std::sort(snapshot.begin(), snapshot.end(), [](const Snapshot_t& a, const Snapshot_t& b) {
+        return snapshotKey(a) < snapshotKey(b);
+    });
+
+    return snapshot;
+}
+
+/// Rates are over elapsedSecs since previous, or over the lifetime of an entry for entries not in previous
+QJsonArray MAVLinkMessageStats::_toJsonArray(const QList<Snapshot_t>& snapshot, const QHash<quint64, Snapshot_t>& previous, double elapsedSecs)
+{
+    QJsonArray array;
+
+    for (const Snapshot_t& entry : snapshot) {
+        const auto it = previous.constFind(snapshotKey(entry));
+
+        double rateHz = 0;
+        double bytesPerSec = 0;
+        if ((it != previous.constEnd()) && (elapsedSecs > 0)) {
+            rateHz = (entry.count - it->count) / elapsedSecs;
+            bytesPerSec = (entry.bytes - it->bytes) / elapsedSecs;
+        } else if (entry.lastUSecs > entry.firstUSecs) {
+            const double lifetimeSecs = (entry.lastUSecs - entry.firstUSecs) / 1e6;
+            rateHz = (entry.count - 1) / lifetimeSecs;
+            bytesPerSec = entry.bytes / lifetimeSecs;
+        }
+
+        QJsonObject object;
+        object[QStringLiteral("sysid")]         = entry.sysid;
+        object[QStringLiteral("compid")]        = entry.compid;
+        object[QStringLiteral("count")]         = static_cast<qint64>(entry.count);
+        object[QStringLiteral("bytes")]         = static_cast<qint64>(entry.bytes);
+        object[QStringLiteral("rateHz")]        = rateHz;
+        object[QStringLiteral("bytesPerSec")]   = bytesPerSec;
+        object[QStringLiteral("intervalMSecs")] = entry.intervalUSecs / 1000.0;
+        object[QStringLiteral("jitterMSecs")]   = entry.jitterUSecs / 1000.0;
+        if (entry.msgid == componentMsgId) {
+            object[QStringLiteral("lost")]          = static_cast<qint64>(entry.lost);
+            object[QStringLiteral("lossPercent")]   = (100.0 * entry.lost) / (entry.count + entry.lost);
+        } else {
+            object[QStringLiteral("msgid")]         = static_cast<qint64>(entry.msgid);
+            object[QStringLiteral("name")]          = messageName(entry.msgid);
+        }
+        array.append(object);
+    }
+
+    return array;
+}
+
+QString MAVLinkMessageStats::toJson(void) const
+{
+    return QString::fromUtf8(QJsonDocument(_toJsonArray(snapshot(), {}, 0)).toJson(QJsonDocument::Indented));
+}
+
+bool MAVLinkMessageStats::exportJson(const QString& fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(MAVLinkMessageStatsLog) << "Unable to open" << fileName << file.errorString();
+        return false;
+    }
+
+    const QByteArray json = toJson().toUtf8();
+    if (file.write(json) != json.size()) {
+        qCWarning(MAVLinkMessageStatsLog) << "Unable to write" << fileName << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void MAVLinkMessageStats::_updateMessages(void)
+{
+    const double elapsedSecs = _updateElapsed.restart() / 1000.0;
+    const QList<Snapshot_t> current = snapshot();
+
+    _messages = _toJsonArray(current, _previous, elapsedSecs).toVariantList();
+
+    _previous.clear();
+    for (const Snapshot_t& entry : current) {
+        _previous[snapshotKey(entry)] = entry;
+    }
+
+    if (_untracked.load(std::memory_order_relaxed)) {
+        qCDebug(MAVLinkMessageStatsLog) << "Messages not tracked, table full" << _untracked.load(std::memory_order_relaxed);
+    }
+
+    emit messagesChanged();
+}
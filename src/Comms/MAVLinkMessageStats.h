@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVariantList>
+
+#include <array>
+#include <atomic>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkMessageStatsLog)
+
+/// Receive statistics per (sysid, compid, msgid): count, bytes, inter-arrival interval and jitter, plus sequence loss
+/// per (sysid, compid), since the sequence number is per component and not per message.
+///
+/// record is called for every received message and only touches a fixed size open addressing table of relaxed atomic
+/// counters, so it never allocates or locks and the table can be read from any thread. Rates are derived on the reader
+/// side from the difference between two snapshots: while active, a timer takes one a second and publishes the result
+/// in messages. toJson reads the table directly.
+class MAVLinkMessageStats : public QObject
+{
+    Q_OBJECT
+
+public:
+    MAVLinkMessageStats(QObject* parent = nullptr);
+
+    Q_PROPERTY(bool         active      READ active     WRITE setActive NOTIFY activeChanged)   ///< Set while a view shows messages
+    Q_PROPERTY(QVariantList messages    READ messages                   NOTIFY messagesChanged) ///< Per message rows, sorted by sysid, compid, msgid
+
+    /// Entry for one message of one component, or for the component itself with msgid componentMsgId
+    struct Snapshot_t {
+        quint8  sysid =             0;
+        quint8  compid =            0;
+        quint32 msgid =             0;
+        quint64 count =             0;
+        quint64 bytes =             0;
+        quint64 lost =              0;  ///< Component entries only
+        quint64 firstUSecs =        0;  ///< Arrival time of the first message
+        quint64 lastUSecs =         0;  ///< Arrival time of the latest message
+        quint64 intervalUSecs =     0;  ///< Smoothed inter-arrival time
+        quint64 jitterUSecs =       0;  ///< Smoothed deviation of the inter-arrival time from intervalUSecs
+    };
+
+    bool         active  (void) const { return _active; }
+    QVariantList messages(void) const { return _messages; }
+
+    void setActive(bool active);
+
+    /// Accounts a received message, from the thread which handles received messages
+    ///     @param bytes Size of the message on the wire
+    ///     @param lost Messages missing in the sequence of the component before this one
+    void record(quint8 sysid, quint8 compid, quint32 msgid, quint32 bytes, quint64 timestampUSecs, quint32 lost);
+
+    /// Thread safe copy of all entries
+    QList<Snapshot_t> snapshot(void) const;
+
+    /// Clears all entries. The table is cleared by the next record call, so this is safe from any thread.
+    Q_INVOKABLE void reset(void);
+
+    /// All entries with rates over their lifetime, as a JSON array of objects
+    Q_INVOKABLE QString toJson(void) const;
+
+    /// Writes toJson to a file
+    ///     @return false: file could not be written
+    Q_INVOKABLE bool exportJson(const QString& fileName) const;
+
+    static constexpr quint32    componentMsgId =    0xFFFFFF;   ///< Not a valid mavlink id, which are 24 bits
+    static constexpr int        tableSize =         4096;       ///< Power of two. Entries past about 3/4 full are not tracked.
+    static constexpr int        updateIntervalMSecs = 1000;
+
+signals:
+    void activeChanged  (bool active);
+    void messagesChanged(void);
+
+private slots:
+    void _updateMessages(void);
+
+private:
+    struct Entry_t {
+        std::atomic<quint64> key { 0 };             ///< 0 for a free entry, else _key()
+        std::atomic<quint64> count { 0 };
+        std::atomic<quint64> bytes { 0 };
+        std::atomic<quint64> lost { 0 };
+        std::atomic<quint64> firstUSecs { 0 };
+        std::atomic<quint64> lastUSecs { 0 };
+        std::atomic<quint64> intervalUSecs { 0 };
+        std::atomic<quint64> jitterUSecs { 0 };
+    };
+
+    static quint64 _key(quint8 sysid, quint8 compid, quint32 msgid) { return (1ull << 48) | (quint64(sysid) << 32) | (quint64(compid) << 24) | msgid; }
+
+    Entry_t*    _entry  (quint64 key);
+    void        _clear  (void);
+    static QJsonArray _toJsonArray(const QList<Snapshot_t>& snapshot, const QHash<quint64, Snapshot_t>& previous, double elapsedSecs);
+
+    std::array<Entry_t, tableSize>  _table;
+    std::atomic<int>                _entryCount { 0 };
+    std::atomic<quint64>            _untracked { 0 };       ///< Records dropped because the table is full
+    std::atomic_bool                _resetRequested { false };
+
+    bool                            _active = false;
+    QTimer                          _updateTimer;
+    QElapsedTimer                   _updateElapsed;
+    QHash<quint64, Snapshot_t>      _previous;              ///< Last snapshot of _updateMessages, for rates
+    QVariantList                    _messages;
+
+    static constexpr int _jitterGain = 16;                  ///< Smoothing of interval and jitter, as in RFC 3550
+};
@@ -13,11 +13,14 @@
 #include "MultiVehicleManager.h"
 #include "SettingsManager.h"
 #include "QGCLoggingCategory.h"
+#include "QGC.h"
+#include "QGCTrace.h"
 
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QMetaType>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFileInfo>
 
 #include <QtQml/QtQml>
@@ -92,6 +95,7 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
 
    qmlRegisterSingletonType<QGCMAVLink>("MAVLink", 1, 0, "MAVLink", mavlinkSingletonFactory);
    qRegisterMetaType<mavlink_message_t>("mavlink_message_t");
+   qRegisterMetaType<QList<mavlink_message_t>>("QList<mavlink_message_t>");
 
    loadSettings();
 
@@ -105,6 +109,15 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleAdded, this, &MAVLinkProtocol::_vehicleCountChanged);
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &MAVLinkProtocol::_vehicleCountChanged);
 
+   // Forwarding state is checked for every message, so keep a cached copy instead of going through the settings each time
+   Fact* forwardMavlinkFact = _toolbox->settingsManager()->appSettings()->forwardMavlink();
+   _forwardingEnabled = forwardMavlinkFact->rawValue().toBool();
+   connect(forwardMavlinkFact, &Fact::rawValueChanged, this, [this](const QVariant& value) { _forwardingEnabled = value.toBool(); });
+   _forwardingSupportEnabled = _linkMgr->mavlinkSupportForwardingEnabled();
+   connect(_linkMgr, &LinkManager::mavlinkSupportForwardingEnabledChanged, this, [this]() { _forwardingSupportEnabled = _linkMgr->mavlinkSupportForwardingEnabled(); });
+
+   connect(&_logWriter, &MAVLinkLogWriter::writeFailed, this, &MAVLinkProtocol::_logWriteFailed);
+
    emit versionCheckChanged(_enable_version_check);
 }
 
@@ -153,26 +166,8 @@ void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
 
 void MAVLinkProtocol::logSentBytes(LinkInterface* link, QByteArray b){
 
-    uint8_t bytes_time[sizeof(quint64)];
-
-    Q_UNUSED(link);
-    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
-
-        quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-
-        qToBigEndian(time,bytes_time);
-
-        b.insert(0,QByteArray((const char*)bytes_time,sizeof(bytes_time)));
-
-        int len = b.length();
-
-        if(_tempLogFile.write(b) != len)
-        {
-            // If there's an error logging data, raise an alert and stop logging.
-            emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-            _stopLogging();
-            _logSuspendError = true;
-        }
+    if (!_logSuspendError && !_logSuspendReplay && _logWriter.isWriting()) {
+        (void) _logWriter.queueRecord(QGC::utcTimeUsecs(), b.constData(), b.size(), _logLinkId(link));
     }
 
 }
@@ -182,17 +177,20 @@ void MAVLinkProtocol::logSentBytes(LinkInterface* link, QByteArray b){
  * It can handle multiple links in parallel, as each link has it's own buffer/
  * parsing state machine.
  * @param link The interface to read from
+ * @param timestampUsecs Time at which the link read the bytes
  * @see LinkInterface
  **/
 
-void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
+void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b, quint64 timestampUsecs)
 {
+    QGC_TRACE_SCOPE("MAVLinkProtocol::receiveBytes");
+
     // Since receiveBytes signals cross threads we can end up with signals in the queue
     // that come through after the link is disconnected. For these we just drop the data
     // since the link is closed.
     SharedLinkInterfacePtr linkPtr = _linkMgr->sharedLinkInterfacePointerForLink(link);
     if (!linkPtr) {
-        qCDebug(MAVLinkProtocolLog) << "receiveBytes: link gone!" << b.size() << " bytes arrived too late";
+        qCDebugRateLimited(MAVLinkProtocolLog, 1) << "receiveBytes: link gone!" << b.size() << " bytes arrived too late";
         return;
     }
 
@@ -201,189 +199,310 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
     for (int position = 0; position < b.size(); position++) {
         if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &_message, &_status)) {
             // Got a valid message
-            if (!link->decodedFirstMavlinkPacket()) {
-                link->setDecodedFirstMavlinkPacket(true);
-                mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-                if (!(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                    mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-                    // Set all links to v2
-                    setVersion(200);
-                }
+            if (!_handleMessage(link, linkPtr, _message, timestampUsecs)) {
+                break;
             }
 
-            //-----------------------------------------------------------------
-            // MAVLink Status
-            uint8_t lastSeq = lastIndex[_message.sysid][_message.compid];
-            uint8_t expectedSeq = lastSeq + 1;
-            // Increase receive counter
-            totalReceiveCounter[mavlinkChannel]++;
-            // Determine what the next expected sequence number is, accounting for
-            // never having seen a message for this system/component pair.
-            if(firstMessage[_message.sysid][_message.compid]) {
-                firstMessage[_message.sysid][_message.compid] = 0;
-                lastSeq     = _message.seq;
-                expectedSeq = _message.seq;
-            }
-            // And if we didn't encounter that sequence number, record the error
-            //int foo = 0;
-            if (_message.seq != expectedSeq)
-            {
-                //foo = 1;
-                int lostMessages = 0;
-                //-- Account for overflow during packet loss
-                if(_message.seq < expectedSeq) {
-                    lostMessages = (_message.seq + 255) - expectedSeq;
-                } else {
-                    lostMessages = _message.seq - expectedSeq;
-                }
-                // Log how many were lost
-                totalLossCounter[mavlinkChannel] += static_cast<uint64_t>(lostMessages);
-            }
+            // Reset message parsing
+            memset(&_status,  0, sizeof(_status));
+            memset(&_message, 0, sizeof(_message));
+        }
+    }
 
-            // And update the last sequence number for this system/component pair
-            lastIndex[_message.sysid][_message.compid] = _message.seq;;
-            // Calculate new loss ratio
-            uint64_t totalSent = totalReceiveCounter[mavlinkChannel] + totalLossCounter[mavlinkChannel];
-            float receiveLossPercent = static_cast<float>(static_cast<double>(totalLossCounter[mavlinkChannel]) / static_cast<double>(totalSent));
-            receiveLossPercent *= 100.0f;
-            receiveLossPercent = (receiveLossPercent * 0.5f) + (runningLossPercent[mavlinkChannel] * 0.5f);
-            runningLossPercent[mavlinkChannel] = receiveLossPercent;
-
-            //qDebug() << foo << _message.seq << expectedSeq << lastSeq << totalLossCounter[mavlinkChannel] << totalReceiveCounter[mavlinkChannel] << totalSentCounter[mavlinkChannel] << "(" << _message.sysid << _message.compid << ")";
-
-            //-----------------------------------------------------------------
-            // MAVLink forwarding
-            bool forwardingEnabled = _app->toolbox()->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool();
-            if (_message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
-                forwardingEnabled = false;
-            }
-            if (forwardingEnabled) {
-                SharedLinkInterfacePtr forwardingLink = _linkMgr->mavlinkForwardingLink();
+    _flushForwarding();
+}
 
-                if (forwardingLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingLink->writeBytesThreadSafe((const char*)buf, len);
-                }
-            }
+/**
+ * This method handles messages which were already decoded on the link thread.
+ * @param link The interface the messages were received on
+ * @param timestampUsecs Time at which the link read the bytes holding the messages
+ * @see LinkInterface::setDecodeOnLinkThread
+ **/
 
-            // MAVLink forwarding support
-            bool forwardingSupportEnabled = _linkMgr->mavlinkSupportForwardingEnabled();
-            if (_message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
-                forwardingSupportEnabled = false;
-            }
-            if (forwardingSupportEnabled) {
-                SharedLinkInterfacePtr forwardingSupportLink = _linkMgr->mavlinkForwardingSupportLink();
+void MAVLinkProtocol::receiveMessages(LinkInterface* link, const QList<mavlink_message_t>& messages, quint64 timestampUsecs)
+{
+    QGC_TRACE_SCOPE("MAVLinkProtocol::receiveMessages");
 
-                if (forwardingSupportLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingSupportLink->writeBytesThreadSafe((const char*)buf, len);
-                }
-            }
+    // Same as receiveBytes, batches can still be queued after the link is gone
+    SharedLinkInterfacePtr linkPtr = _linkMgr->sharedLinkInterfacePointerForLink(link);
+    if (!linkPtr) {
+        qCDebugRateLimited(MAVLinkProtocolLog, 1) << "receiveMessages: link gone!" << messages.size() << " messages arrived too late";
+        return;
+    }
 
-            //-----------------------------------------------------------------
-            // Log data
-            if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
-                uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)];
-
-                // Write the uint64 time in microseconds in big endian format before the message.
-                // This timestamp is saved in UTC time. We are only saving in ms precision because
-                // getting more than this isn't possible with Qt without a ton of extra code.
-                quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-                qToBigEndian(time, buf);
-
-                // Then write the message to the buffer
-                int len = mavlink_msg_to_send_buffer(buf + sizeof(quint64), &_message);
-
-                // Determine how many bytes were written by adding the timestamp size to the message size
-                len += sizeof(quint64);
-
-                // Now write this timestamp/message pair to the log.
-                QByteArray b(reinterpret_cast<const char*>(buf), len);
-                if(_tempLogFile.write(b) != len)
-                {
-                    // If there's an error logging data, raise an alert and stop logging.
-                    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-                    _stopLogging();
-                    _logSuspendError = true;
-                }
+    for (const mavlink_message_t& message : messages) {
+        if (!_handleMessage(link, linkPtr, message, timestampUsecs)) {
+            break;
+        }
+    }
 
-                // Check for the vehicle arming going by. This is used to trigger log save.
-                if (!_vehicleWasArmed && _message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                    mavlink_heartbeat_t state;
-                    mavlink_msg_heartbeat_decode(&_message, &state);
-                    if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
-                        _vehicleWasArmed = true;
-                    }
-                }
-            }
+    _flushForwarding();
+}
+
+/// Performs sequence/loss accounting, forwarding and logging for a single decoded message and then
+/// passes it on to the rest of the system.
+///     @return false: link was closed while handling the message, stop processing further messages
+bool MAVLinkProtocol::_handleMessage(LinkInterface* link, const SharedLinkInterfacePtr& linkPtr, const mavlink_message_t& message, quint64 timestampUsecs)
+{
+    const uint8_t mavlinkChannel = link->mavlinkChannel();
+
+    // Always on the main thread, also when the link decodes on its own thread, so the outbound version flag of the
+    // channel status is only ever changed here and in setVersion
+    if (!link->decodedFirstMavlinkPacket()) {
+        link->setDecodedFirstMavlinkPacket(true);
+        mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+        if ((message.magic == MAVLINK_STX) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
+            qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
+            mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+            // Set all links to v2
+            setVersion(200);
+        }
+    }
+
+    //-----------------------------------------------------------------
+    // MAVLink Status
+    uint8_t lastSeq = lastIndex[message.sysid][message.compid];
+    uint8_t expectedSeq = lastSeq + 1;
+    // Increase receive counter
+    totalReceiveCounter[mavlinkChannel]++;
+    // Determine what the next expected sequence number is, accounting for
+    // never having seen a message for this system/component pair.
+    if(firstMessage[message.sysid][message.compid]) {
+        firstMessage[message.sysid][message.compid] = 0;
+        lastSeq     = message.seq;
+        expectedSeq = message.seq;
+    }
+    // And if we didn't encounter that sequence number, record the error
+    //int foo = 0;
+    int lostMessages = 0;
+    if (message.seq != expectedSeq)
+    {
+        //foo = 1;
+        //-- Account for overflow during packet loss
+        if(message.seq < expectedSeq) {
+            lostMessages = (message.seq + 255) - expectedSeq;
+        } else {
+            lostMessages = message.seq - expectedSeq;
+        }
+        // Log how many were lost
+        totalLossCounter[mavlinkChannel] += static_cast<uint64_t>(lostMessages);
+        qCDebugRateLimited(MAVLinkProtocolLog, 1) << "Lost" << lostMessages << "messages on channel" << mavlinkChannel << "from" << message.sysid << message.compid;
+    }
+
+    // And update the last sequence number for this system/component pair
+    lastIndex[message.sysid][message.compid] = message.seq;;
+    // Calculate new loss ratio
+    uint64_t totalSent = totalReceiveCounter[mavlinkChannel] + totalLossCounter[mavlinkChannel];
+    float receiveLossPercent = static_cast<float>(static_cast<double>(totalLossCounter[mavlinkChannel]) / static_cast<double>(totalSent));
+    receiveLossPercent *= 100.0f;
+    receiveLossPercent = (receiveLossPercent * 0.5f) + (runningLossPercent[mavlinkChannel] * 0.5f);
+    runningLossPercent[mavlinkChannel] = receiveLossPercent;
+
+    // Size on the wire, the frame is not serialized just for this
+    quint32 messageBytes = message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+    if (message.magic == MAVLINK_STX_MAVLINK1) {
+        messageBytes -= MAVLINK_CORE_HEADER_LEN - MAVLINK_CORE_HEADER_MAVLINK1_LEN;
+    } else if (message.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+        messageBytes += MAVLINK_SIGNATURE_BLOCK_LEN;
+    }
+    _messageStats.record(message.sysid, message.compid, message.msgid, messageBytes, timestampUsecs, static_cast<quint32>(lostMessages));
+
+    //qDebug() << foo << message.seq << expectedSeq << lastSeq << totalLossCounter[mavlinkChannel] << totalReceiveCounter[mavlinkChannel] << totalSentCounter[mavlinkChannel] << "(" << message.sysid << message.compid << ")";
+
+    //-----------------------------------------------------------------
+    // The message is serialized back to its wire format at most once. Both forwarding targets as well as the log
+    // share the same frame.
+    const bool forwarding = (_forwardingEnabled || _forwardingSupportEnabled) && (message.msgid != MAVLINK_MSG_ID_SETUP_SIGNING);
+    const bool logging = !_logSuspendError && !_logSuspendReplay && _logWriter.isWriting();
+    uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+    int frameLen = 0;
+    if (forwarding || logging) {
+        frameLen = mavlink_msg_to_send_buffer(frame, &message);
+    }
 
-            if (_message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                _startLogging();
-                mavlink_heartbeat_t heartbeat;
-                mavlink_msg_heartbeat_decode(&_message, &heartbeat);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, heartbeat.autopilot, heartbeat.type);
-            } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY) {
-                _startLogging();
-                mavlink_high_latency_t highLatency;
-                mavlink_msg_high_latency_decode(&_message, &highLatency);
-                // HIGH_LATENCY does not provide autopilot or type information, generic is our safest bet
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
-            } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-                _startLogging();
-                mavlink_high_latency2_t highLatency2;
-                mavlink_msg_high_latency2_decode(&_message, &highLatency2);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, highLatency2.autopilot, highLatency2.type);
+    //-----------------------------------------------------------------
+    // MAVLink forwarding
+    if (forwarding) {
+        if (_forwardingEnabled) {
+            _queueForwarding(_forwardingBuffer, &LinkManager::mavlinkForwardingLink, frame, frameLen);
+        }
+        if (_forwardingSupportEnabled) {
+            _queueForwarding(_forwardingSupportBuffer, &LinkManager::mavlinkForwardingSupportLink, frame, frameLen);
+        }
+    }
+
+    //-----------------------------------------------------------------
+    // Log data
+    if (logging) {
+        // The writer puts the uint64 time in microseconds in big endian format before the message.
+        // This timestamp is saved in UTC time and is the time the link read the message from the device.
+
+        // Queue this timestamp/message pair for the log writer thread
+        (void) _logWriter.queueRecord(timestampUsecs, reinterpret_cast<const char*>(frame), frameLen, _logLinkId(link));
+
+        // Check for the vehicle arming going by. This is used to trigger log save.
+        if (!_vehicleWasArmed && message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            mavlink_heartbeat_t state;
+            mavlink_msg_heartbeat_decode(&message, &state);
+            if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
+                _vehicleWasArmed = true;
             }
+        }
+    }
+
+    if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        _startLogging();
+        mavlink_heartbeat_t heartbeat;
+        mavlink_msg_heartbeat_decode(&message, &heartbeat);
+        emit vehicleHeartbeatInfo(link, message.sysid, message.compid, heartbeat.autopilot, heartbeat.type);
+    } else if (message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY) {
+        _startLogging();
+        mavlink_high_latency_t highLatency;
+        mavlink_msg_high_latency_decode(&message, &highLatency);
+        // HIGH_LATENCY does not provide autopilot or type information, generic is our safest bet
+        emit vehicleHeartbeatInfo(link, message.sysid, message.compid, MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
+    } else if (message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+        _startLogging();
+        mavlink_high_latency2_t highLatency2;
+        mavlink_msg_high_latency2_decode(&message, &highLatency2);
+        emit vehicleHeartbeatInfo(link, message.sysid, message.compid, highLatency2.autopilot, highLatency2.type);
+    }
 
 #if 0
-            // Given the current state of SiK Radio firmwares there is no way to make the code below work.
-            // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
-            // packet even if the vehicle is sending Mavlink 2.
-
-            // Detect if we are talking to an old radio not supporting v2
-            mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-            if (_message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
-                if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
-                && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    _radio_version_mismatch_count++;
-                }
-            }
+    // Given the current state of SiK Radio firmwares there is no way to make the code below work.
+    // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
+    // packet even if the vehicle is sending Mavlink 2.
+
+    // Detect if we are talking to an old radio not supporting v2
+    mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+    if (message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
+        if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
+        && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
+            _radio_version_mismatch_count++;
+        }
+    }
 
-            if (_radio_version_mismatch_count == 5) {
-                // Warn the user if the radio continues to send v1 while the link uses v2
-                emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
-                // Set to flag warning already shown
-                _radio_version_mismatch_count = -1;
-                // Flick link back to v1
-                qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-            }
+    if (_radio_version_mismatch_count == 5) {
+        // Warn the user if the radio continues to send v1 while the link uses v2
+        emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
+        // Set to flag warning already shown
+        _radio_version_mismatch_count = -1;
+        // Flick link back to v1
+        qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
+        mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    }
 #endif
 
-            // Update MAVLink status on every 32th packet
-            if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0) {
-                emit mavlinkMessageStatus(_message.sysid, totalSent, totalReceiveCounter[mavlinkChannel], totalLossCounter[mavlinkChannel], receiveLossPercent);
-            }
+    // Update MAVLink status on every 32th packet
+    if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0) {
+        emit mavlinkMessageStatus(message.sysid, totalSent, totalReceiveCounter[mavlinkChannel], totalLossCounter[mavlinkChannel], receiveLossPercent);
+    }
 
-            // The packet is emitted as a whole, as it is only 255 - 261 bytes short
-            // kind of inefficient, but no issue for a groundstation pc.
-            // It buys as reentrancy for the whole code over all threads
-            emit messageReceived(link, _message);
+    // The packet is emitted as a whole, as it is only 255 - 261 bytes short
+    // kind of inefficient, but no issue for a groundstation pc.
+    // It buys as reentrancy for the whole code over all threads
+    QElapsedTimer handlerTimer;
+    if (_messageHandlerStatsEnabled) {
+        handlerTimer.start();
+    }
+    emit messageReceived(link, message);
+    _dispatchMessageSubscriptions(link, message);
+    if (_messageHandlerStatsEnabled) {
+        MessageHandlerStats_t& stats = _messageHandlerStats[message.msgid];
+        stats.count++;
+        stats.nsecs += static_cast<quint64>(handlerTimer.nsecsElapsed());
+    }
 
-            // Anyone handling the message could close the connection, which deletes the link,
-            // so we check if it's expired
-            if (1 == linkPtr.use_count()) {
-                break;
-            }
+    // Anyone handling the message could close the connection, which deletes the link,
+    // so we check if it's expired
+    return linkPtr.use_count() != 1;
+}
 
-            // Reset message parsing
-            memset(&_status,  0, sizeof(_status));
-            memset(&_message, 0, sizeof(_message));
+/// Adds a serialized frame to the pending writes for a forwarding link. Frames are collected over a receive batch
+/// and written out together, flushing early before a write would grow beyond a single unfragmented UDP datagram.
+void MAVLinkProtocol::_queueForwarding(QByteArray& buffer, ForwardingLinkGetter linkGetter, const uint8_t* frame, int frameLen)
+{
+    if (!buffer.isEmpty() && ((buffer.size() + frameLen) > _forwardingBatchMaxBytes)) {
+        _writeForwarding(buffer, linkGetter);
+    }
+    if (buffer.isEmpty()) {
+        buffer.reserve(_forwardingBatchMaxBytes);
+    }
+    buffer.append(reinterpret_cast<const char*>(frame), frameLen);
+}
+
+void MAVLinkProtocol::_writeForwarding(QByteArray& buffer, ForwardingLinkGetter linkGetter)
+{
+    SharedLinkInterfacePtr forwardingLink = (_linkMgr->*linkGetter)();
+    if (forwardingLink) {
+        forwardingLink->writeBytesThreadSafe(buffer.constData(), buffer.size());
+    }
+    buffer.clear();
+}
+
+/// Writes out everything queued for the forwarding links during the current receive batch
+void MAVLinkProtocol::_flushForwarding(void)
+{
+    if (!_forwardingBuffer.isEmpty()) {
+        _writeForwarding(_forwardingBuffer, &LinkManager::mavlinkForwardingLink);
+    }
+    if (!_forwardingSupportBuffer.isEmpty()) {
+        _writeForwarding(_forwardingSupportBuffer, &LinkManager::mavlinkForwardingSupportLink);
+    }
+}
+
+void MAVLinkProtocol::subscribeMessage(uint32_t msgid, QObject* receiver, MessageHandler handler)
+{
+    _messageSubscriptions[msgid].append({ receiver, handler });
+
+    if (!_subscriberDestroyedConnections.contains(receiver)) {
+        _subscriberDestroyedConnections[receiver] = connect(receiver, &QObject::destroyed, this, [this, receiver]() {
+            unsubscribeAllMessages(receiver);
+        }, Qt::DirectConnection);
+    }
+}
+
+void MAVLinkProtocol::unsubscribeMessage(uint32_t msgid, QObject* receiver)
+{
+    auto it = _messageSubscriptions.find(msgid);
+    if (it == _messageSubscriptions.end()) {
+        return;
+    }
+
+    it->removeIf([receiver](const MessageSubscription& subscription) { return subscription.receiver == receiver; });
+    if (it->isEmpty()) {
+        _messageSubscriptions.erase(it);
+    }
+}
+
+void MAVLinkProtocol::unsubscribeAllMessages(QObject* receiver)
+{
+    for (auto it = _messageSubscriptions.begin(); it != _messageSubscriptions.end(); ) {
+        it->removeIf([receiver](const MessageSubscription& subscription) { return subscription.receiver == receiver; });
+        if (it->isEmpty()) {
+            it = _messageSubscriptions.erase(it);
+        } else {
+            ++it;
         }
     }
+
+    if (_subscriberDestroyedConnections.contains(receiver)) {
+        (void) disconnect(_subscriberDestroyedConnections.take(receiver));
+    }
+}
+
+void MAVLinkProtocol::_dispatchMessageSubscriptions(LinkInterface* link, const mavlink_message_t& message)
+{
+    auto it = _messageSubscriptions.constFind(message.msgid);
+    if (it == _messageSubscriptions.constEnd()) {
+        return;
+    }
+
+    // Handlers are allowed to unsubscribe, so work from a copy
+    const QList<MessageSubscription> subscriptions = *it;
+    for (const MessageSubscription& subscription : subscriptions) {
+        subscription.handler(link, message);
+    }
 }
 
 /**
@@ -430,20 +549,67 @@ void MAVLinkProtocol::_vehicleCountChanged(void)
 /// @brief Closes the log file if it is open
 bool MAVLinkProtocol::_closeLogFile(void)
 {
-    if (_tempLogFile.isOpen()) {
-        if (_tempLogFile.size() == 0) {
+    if (_logWriter.isWriting()) {
+        // Writes out anything still queued before closing the file
+        _logWriter.stopWriting();
+        if (QFileInfo(_tempLogFile.fileName()).size() == 0) {
             // Don't save zero byte files
             _tempLogFile.remove();
+            QFile::remove(MAVLinkLogWriter::indexFileName(_tempLogFile.fileName()));
             return false;
         } else {
-            _tempLogFile.flush();
-            _tempLogFile.close();
             return true;
         }
     }
     return false;
 }
 
+void MAVLinkProtocol::_logWriteFailed(const QString& errorString)
+{
+    if (!_logWriter.isWriting()) {
+        return;
+    }
+
+    // If there's an error logging data, raise an alert and stop logging.
+    qCWarning(MAVLinkProtocolLog) << "Log write failed" << errorString;
+    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
+    _stopLogging();
+    _logSuspendError = true;
+}
+
+/// Link ids in the log index are the mavlink channels, the name is written again when a channel changes hands
+///     @return Link id for MAVLinkLogWriter::queueRecord
+int MAVLinkProtocol::_logLinkId(LinkInterface* link)
+{
+    if (!link || !link->mavlinkChannelIsSet() || (link->mavlinkChannel() >= _loggedLinks.size())) {
+        return -1;
+    }
+
+    const int linkId = link->mavlinkChannel();
+    if (_loggedLinks[linkId] != link) {
+        _loggedLinks[linkId] = link;
+        _logWriter.setLinkName(linkId, link->linkConfiguration() ? link->linkConfiguration()->name() : QString());
+    }
+
+    return linkId;
+}
+
+/// The log is written next to where it will be saved when possible, so that saving it is a rename instead of a copy
+///     @return Directories which may hold logs in progress, the first is where new logs go
+QStringList MAVLinkProtocol::_tempLogDirectories(void) const
+{
+    QStringList directories;
+
+    AppSettings* appSettings = _app->toolbox()->settingsManager()->appSettings();
+    const QString telemetrySavePath = appSettings->telemetrySavePath();
+    if (!telemetrySavePath.isEmpty() && QDir(telemetrySavePath).exists() && appSettings->telemetrySave()->rawValue().toBool()) {
+        directories.append(telemetrySavePath);
+    }
+    directories.append(QStandardPaths::writableLocation(QStandardPaths::TempLocation));
+
+    return directories;
+}
+
 void MAVLinkProtocol::_startLogging(void)
 {
     //-- Are we supposed to write logs?
@@ -462,16 +628,26 @@ void MAVLinkProtocol::_startLogging(void)
 #endif
     //-- Log is always written to a temp file. If later the user decides they want
     //   it, it's all there for them.
-    if (!_tempLogFile.isOpen()) {
+    if (!_logWriter.isWriting()) {
         if (!_logSuspendReplay) {
-            if (!_tempLogFile.open()) {
+            // The temp file is only used to come up with a unique file name, the writer thread does the writing
+            _tempLogFile.setDirectory(_tempLogDirectories().constFirst());
+            const bool created = _tempLogFile.open();
+            _tempLogFile.close();
+            const int syncIntervalMsecs = appSettings->telemetrySyncInterval()->rawValue().toInt() * 1000;
+            if (!created || !_logWriter.startWriting(_tempLogFile.fileName(), syncIntervalMsecs)) {
                 emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Opening Flight Data file for writing failed. "
                                                                       "Unable to write to %1. Please choose a different file location.").arg(_tempLogFile.fileName()));
+                if (created) {
+                    QFile::remove(_tempLogFile.fileName());
+                    QFile::remove(MAVLinkLogWriter::indexFileName(_tempLogFile.fileName()));
+                }
                 _closeLogFile();
                 _logSuspendError = true;
                 return;
             }
 
+            _loggedLinks.fill(nullptr);
             qCDebug(MAVLinkProtocolLog) << "Temp log" << _tempLogFile.fileName();
             emit checkTelemetrySavePath();
 
@@ -482,7 +658,7 @@ void MAVLinkProtocol::_startLogging(void)
 
 void MAVLinkProtocol::_stopLogging(void)
 {
-    if (_tempLogFile.isOpen()) {
+    if (_logWriter.isWriting()) {
         if (_closeLogFile()) {
             if ((_vehicleWasArmed || _app->toolbox()->settingsManager()->appSettings()->telemetrySaveNotArmed()->rawValue().toBool()) &&
                 _app->toolbox()->settingsManager()->appSettings()->telemetrySave()->rawValue().toBool() &&
@@ -490,6 +666,7 @@ void MAVLinkProtocol::_stopLogging(void)
                 emit saveTelemetryLog(_tempLogFile.fileName());
             } else {
                 QFile::remove(_tempLogFile.fileName());
+                QFile::remove(MAVLinkLogWriter::indexFileName(_tempLogFile.fileName()));
             }
         }
     }
@@ -501,20 +678,22 @@ void MAVLinkProtocol::_stopLogging(void)
 ///         Give the user an option to save these orphaned files.
 void MAVLinkProtocol::checkForLostLogFiles(void)
 {
-    QDir tempDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation));
-
     QString filter(QString("*.%1").arg(_logFileExtension));
-    QFileInfoList fileInfoList = tempDir.entryInfoList(QStringList(filter), QDir::Files);
-    //qDebug() << "Orphaned log file count" << fileInfoList.count();
-
-    for(const QFileInfo& fileInfo: fileInfoList) {
-        //qDebug() << "Orphaned log file" << fileInfo.filePath();
-        if (fileInfo.size() == 0) {
-            // Delete all zero length files
-            QFile::remove(fileInfo.filePath());
-            continue;
+
+    for (const QString& directory: _tempLogDirectories()) {
+        QFileInfoList fileInfoList = QDir(directory).entryInfoList(QStringList(filter), QDir::Files);
+        //qDebug() << "Orphaned log file count" << fileInfoList.count();
+
+        for(const QFileInfo& fileInfo: fileInfoList) {
+            //qDebug() << "Orphaned log file" << fileInfo.filePath();
+            if (fileInfo.size() == 0) {
+                // Delete all zero length files
+                QFile::remove(fileInfo.filePath());
+                QFile::remove(MAVLinkLogWriter::indexFileName(fileInfo.filePath()));
+                continue;
+            }
+            emit saveTelemetryLog(fileInfo.filePath());
         }
-        emit saveTelemetryLog(fileInfo.filePath());
     }
 }
 
@@ -532,6 +711,7 @@ void MAVLinkProtocol::deleteTempLogFiles(void)
 
     for (const QFileInfo& fileInfo: fileInfoList) {
         QFile::remove(fileInfo.filePath());
+        QFile::remove(MAVLinkLogWriter::indexFileName(fileInfo.filePath()));
     }
 }
 
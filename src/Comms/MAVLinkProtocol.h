@@ -10,14 +10,20 @@
 #pragma once
 
 #include "LinkInterface.h"
+#include "MAVLinkLogWriter.h"
+#include "MAVLinkMessageStats.h"
 #include "QGCMAVLink.h"
 #include "QGCTemporaryFile.h"
 #include "QGCToolbox.h"
 
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 
+#include <functional>
+
 class LinkManager;
 class MultiVehicleManager;
 class QGCApplication;
@@ -71,9 +77,41 @@ public:
     // Override from QGCTool
     virtual void setToolbox(QGCToolbox *toolbox);
 
+    typedef std::function<void(LinkInterface* link, const mavlink_message_t& message)> MessageHandler;
+
+    /// Registers interest in a single message id. Unlike messageReceived the handler is only called for messages with
+    /// that id. Subscriptions are removed automatically when the receiver is destroyed.
+    void subscribeMessage(uint32_t msgid, QObject* receiver, MessageHandler handler);
+
+    /// Removes the receivers subscription for the specified message id
+    void unsubscribeMessage(uint32_t msgid, QObject* receiver);
+
+    /// Removes all subscriptions for the receiver
+    void unsubscribeAllMessages(QObject* receiver);
+
+    /// @return Total number of messages received on the specified channel
+    uint64_t receivedMessageCount(uint8_t channel) const { return totalReceiveCounter[channel]; }
+
+    /// Time spent handing messages to the rest of the system (messageReceived and subscriptions), per message id
+    typedef struct {
+        quint64 count = 0;
+        quint64 nsecs = 0;
+    } MessageHandlerStats_t;
+
+    /// Collection is off by default, it costs a clock read per message while enabled
+    void setMessageHandlerStatsEnabled(bool enabled) { _messageHandlerStatsEnabled = enabled; }
+    const QHash<uint32_t, MessageHandlerStats_t>& messageHandlerStats(void) const { return _messageHandlerStats; }
+    void clearMessageHandlerStats(void) { _messageHandlerStats.clear(); }
+
+    /// Receive rate, interval, jitter and loss per message of each component
+    MAVLinkMessageStats* messageStats(void) { return &_messageStats; }
+
 public slots:
     /** @brief Receive bytes from a communication interface */
-    void receiveBytes(LinkInterface* link, QByteArray b);
+    void receiveBytes(LinkInterface* link, QByteArray b, quint64 timestampUsecs);
+
+    /** @brief Receive messages which were already decoded on the link thread */
+    void receiveMessages(LinkInterface* link, const QList<mavlink_message_t>& messages, quint64 timestampUsecs);
 
     /** @brief Log bytes sent from a communication interface */
     void logSentBytes(LinkInterface* link, QByteArray b);
@@ -148,21 +186,52 @@ signals:
 
 private slots:
     void _vehicleCountChanged(void);
+    void _logWriteFailed(const QString& errorString);
 
 private:
+    bool _handleMessage(LinkInterface* link, const SharedLinkInterfacePtr& linkPtr, const mavlink_message_t& message, quint64 timestampUsecs);
+    void _dispatchMessageSubscriptions(LinkInterface* link, const mavlink_message_t& message);
+
+    typedef SharedLinkInterfacePtr (LinkManager::*ForwardingLinkGetter)(void);
+    void _queueForwarding   (QByteArray& buffer, ForwardingLinkGetter linkGetter, const uint8_t* frame, int frameLen);
+    void _writeForwarding   (QByteArray& buffer, ForwardingLinkGetter linkGetter);
+    void _flushForwarding   (void);
+
     bool _closeLogFile(void);
     void _startLogging(void);
     void _stopLogging(void);
+    int  _logLinkId(LinkInterface* link);
+    QStringList _tempLogDirectories(void) const;
 
     bool _logSuspendError;      ///< true: Logging suspended due to error
     bool _logSuspendReplay;     ///< true: Logging suspended due to replay
     bool _vehicleWasArmed;      ///< true: Vehicle was armed during log sequence
 
-    QGCTemporaryFile    _tempLogFile;            ///< File to log to
+    QGCTemporaryFile    _tempLogFile;            ///< Provides the name of the file to log to
+    MAVLinkLogWriter    _logWriter;              ///< Writes the log on its own thread
+    std::array<const LinkInterface*, 32> _loggedLinks{};    ///< Link last named in the log index for each link id
+    MAVLinkMessageStats _messageStats;           ///< Per message receive statistics
     static constexpr const char* _tempLogFileTemplate   = "FlightDataXXXXXX";   ///< Template for temporary log file
     static constexpr const char* _logFileExtension      = "mavlink";            ///< Extension for log files
 
     LinkManager*            _linkMgr;
     MultiVehicleManager*    _multiVehicleManager;
+
+    bool        _forwardingEnabled          = false;    ///< Cached AppSettings::forwardMavlink
+    bool        _forwardingSupportEnabled   = false;    ///< Cached LinkManager::mavlinkSupportForwardingEnabled
+    QByteArray  _forwardingBuffer;                      ///< Frames pending for the forwarding link
+    QByteArray  _forwardingSupportBuffer;               ///< Frames pending for the support forwarding link
+
+    static constexpr qsizetype _forwardingBatchMaxBytes = 1400; ///< Keeps batched forwarding writes within a single Ethernet frame
+
+    struct MessageSubscription {
+        QObject*        receiver;
+        MessageHandler  handler;
+    };
+    QHash<uint32_t, QList<MessageSubscription>> _messageSubscriptions;         ///< Keyed by msgid
+    QHash<QObject*, QMetaObject::Connection>    _subscriberDestroyedConnections;
+
+    bool                                    _messageHandlerStatsEnabled = false;
+    QHash<uint32_t, MessageHandlerStats_t>  _messageHandlerStats;
 };
 
@@ -11,6 +11,7 @@
 #include "QGCLoggingCategory.h"
 #include "QGCApplication.h"
 #include "LinkManager.h"
+#include "QGC.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QFile>
@@ -532,7 +533,7 @@ void MockLink::respondWithMavlinkMessage(const mavlink_message_t& msg)
 
         int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
         QByteArray bytes((char *)buffer, cBuffer);
-        emit bytesReceived(this, bytes);
+        emit bytesReceived(this, bytes, QGC::utcTimeUsecs());
     }
 }
 
@@ -1442,6 +1443,7 @@ MockConfiguration::MockConfiguration(const MockConfiguration* source)
     _sendStatusText     = source->_sendStatusText;
     _incrementVehicleId = source->_incrementVehicleId;
     _failureMode        = source->_failureMode;
+    _swarm              = source->_swarm;
 }
 
 void MockConfiguration::copyFrom(const LinkConfiguration *source)
@@ -1459,6 +1461,7 @@ void MockConfiguration::copyFrom(const LinkConfiguration *source)
     _sendStatusText     = usource->_sendStatusText;
     _incrementVehicleId = usource->_incrementVehicleId;
     _failureMode        = usource->_failureMode;
+    _swarm              = usource->_swarm;
 }
 
 void MockConfiguration::saveSettings(QSettings& settings, const QString& root)
@@ -71,6 +71,21 @@ public:
     FailureMode_t failureMode(void) { return _failureMode; }
     void setFailureMode(FailureMode_t failureMode) { _failureMode = failureMode; }
 
+    /// Load generator settings. A non-zero vehicle count creates a MockLinkSwarm instead of a MockLink.
+    /// These are runtime only and not saved with the link settings.
+    typedef struct {
+        int     vehicleCount        = 0;
+        int     positionRateHz      = 10;   ///< GLOBAL_POSITION_INT/GPS_RAW_INT, 0 to disable
+        int     attitudeRateHz      = 10;   ///< ATTITUDE, 0 to disable
+        int     statusRateHz        = 1;    ///< SYS_STATUS/BATTERY_STATUS/EXTENDED_SYS_STATE/HOME_POSITION, 0 to disable
+        int     missionItemCount    = 10;   ///< Waypoints in the mission each vehicle starts with
+        int     paramCount          = 100;
+        double  pathRadius          = 100;  ///< Meters, vehicles fly a circle of this radius around their home, 0 holds them in place
+        double  pathSpeed           = 10;   ///< Meters/second along the path
+    } Swarm_t;
+    const Swarm_t&  swarm       (void) const            { return _swarm; }
+    void            setSwarm    (const Swarm_t& swarm)  { _swarm = swarm; }
+
     // Overrides from LinkConfiguration
     LinkType    type            (void) const override                                         { return LinkConfiguration::TypeMock; }
     void        copyFrom        (const LinkConfiguration* source) override;
@@ -93,6 +108,7 @@ private:
     bool            _incrementVehicleId = true;
     uint16_t        _boardVendorId      = 0;
     uint16_t        _boardProductId     = 0;
+    Swarm_t         _swarm;
 
     static constexpr const char* _firmwareTypeKey         = "FirmwareType";
     static constexpr const char* _vehicleTypeKey          = "VehicleType";
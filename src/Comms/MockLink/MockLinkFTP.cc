@@ -102,7 +102,11 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     Q_UNUSED(cchPath); // Fix initialized-but-not-referenced warning on release builds
     path = (char *)request->data;
 
-    _currentFile.close();
+    if (_currentFile.isOpen()) {
+        // Like PX4 we only support a single session, it has to be terminated or reset first
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrNoSessionsAvailable, outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+        return;
+    }
 
     QString sizePrefix = sizeFilenamePrefix;
     if (path.startsWith(sizePrefix)) {
@@ -242,6 +246,8 @@ void MockLinkFTP::_terminateCommand(uint8_t senderSystemId, uint8_t senderCompon
         return;
     }
     
+    _currentFile.close();
+    _currentFile.remove();
     _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
 
     emit terminateCommandReceived();
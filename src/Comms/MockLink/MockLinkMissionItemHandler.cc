@@ -63,6 +63,10 @@ bool MockLinkMissionItemHandler::handleMessage(const mavlink_message_t& msg)
         _handleMissionCount(msg);
         break;
 
+    case MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST:
+        _handleMissionWritePartialList(msg);
+        break;
+
     case MAVLINK_MSG_ID_MISSION_ACK:
         // Acks are received back for each MISSION_ITEM message
         break;
@@ -289,6 +293,32 @@ void MockLinkMissionItemHandler::_handleMissionCount(const mavlink_message_t& ms
     }
 }
 
+/// Only supported by ArduPilot, items start_index through end_index are replaced in place
+void MockLinkMissionItemHandler::_handleMissionWritePartialList(const mavlink_message_t& msg)
+{
+    mavlink_mission_write_partial_list_t writePartialList;
+
+    mavlink_msg_mission_write_partial_list_decode(&msg, &writePartialList);
+    Q_ASSERT(writePartialList.target_system == _mockLink->vehicleId());
+
+    _requestType = (MAV_MISSION_TYPE)writePartialList.mission_type;
+
+    qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionWritePartialList start:end" << writePartialList.start_index << writePartialList.end_index;
+
+    if (_mockLink->getFirmwareType() != MAV_AUTOPILOT_ARDUPILOTMEGA || writePartialList.mission_type != MAV_MISSION_TYPE_MISSION) {
+        _sendAck(MAV_MISSION_UNSUPPORTED);
+        return;
+    }
+    if (writePartialList.start_index < 0 || writePartialList.end_index < writePartialList.start_index || writePartialList.end_index >= _missionItems.count()) {
+        _sendAck(MAV_MISSION_ERROR);
+        return;
+    }
+
+    _writeSequenceIndex = writePartialList.start_index;
+    _writeSequenceCount = writePartialList.end_index + 1;
+    _requestNextMissionItem(_writeSequenceIndex);
+}
+
 void MockLinkMissionItemHandler::_requestNextMissionItem(int sequenceNumber)
 {
     qCDebug(MockLinkMissionItemHandlerLog) << "_requestNextMissionItem write sequence sequenceNumber:" << sequenceNumber << "_failureMode:" << _failureMode;
@@ -0,0 +1,984 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockLinkSwarm.h"
+#include "QGCApplication.h"
+#include "LinkManager.h"
+#include "QGC.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QTimer>
+#include <QtCore/QtMath>
+
+#include <cmath>
+
+QGC_LOGGING_CATEGORY(MockLinkSwarmLog, "MockLinkSwarmLog")
+
+// Same area as MockLink so both can be used together
+static constexpr double kSwarmOriginLatitude    = 47.397;
+static constexpr double kSwarmOriginLongitude   = 8.5455;
+static constexpr double kSwarmHomeAltitude      = 488.056;
+static constexpr int    kSwarmHomeColumns       = 16;
+
+int MockLinkSwarm::_nextSystemId = 1;
+
+MockLinkSwarm::MockLinkSwarm(SharedLinkConfigurationPtr& config)
+    : LinkInterface(config)
+{
+    qCDebug(MockLinkSwarmLog) << "MockLinkSwarm" << this;
+
+    MockConfiguration* mockConfig = qobject_cast<MockConfiguration*>(_config.get());
+    _swarm = mockConfig->swarm();
+
+    QObject::connect(this, &MockLinkSwarm::writeBytesQueuedSignal, this, &MockLinkSwarm::_writeBytesQueued, Qt::QueuedConnection);
+
+    _createVehicles();
+
+    moveToThread(this);
+}
+
+MockLinkSwarm::~MockLinkSwarm()
+{
+    disconnect();
+    qCDebug(MockLinkSwarmLog) << "~MockLinkSwarm" << this;
+}
+
+void MockLinkSwarm::_createVehicles(void)
+{
+    const double pathSpeed = _flying() ? _swarm.pathSpeed : 0;
+
+    for (int i = 0; i < _swarm.vehicleCount; i++) {
+        // System ids are shared by all swarm links. Wrapping would create duplicate vehicles so the swarm stops growing instead.
+        if (_nextSystemId > _maxSystemId) {
+            qCWarning(MockLinkSwarmLog) << "Out of system ids, only created" << _vehicles.count() << "of" << _swarm.vehicleCount << "vehicles";
+            break;
+        }
+
+        Vehicle_t vehicle;
+        vehicle.systemId = static_cast<uint8_t>(_nextSystemId++);
+
+        // Homes are laid out on a grid far enough apart that the circles don't overlap
+        const int gridIndex = vehicle.systemId - 1;
+        vehicle.home = QGeoCoordinate(kSwarmOriginLatitude - ((gridIndex / kSwarmHomeColumns) * _homeSpacing),
+                                      kSwarmOriginLongitude + ((gridIndex % kSwarmHomeColumns) * _homeSpacing),
+                                      kSwarmHomeAltitude);
+        vehicle.pathAngle = vehicle.systemId * 2.39996;     // Golden angle, spreads the start positions
+        vehicle.pathDirection = (vehicle.systemId % 2) ? 1 : -1;
+        if (pathSpeed > 0) {
+            vehicle.baseMode |= MAV_MODE_FLAG_SAFETY_ARMED;
+        }
+
+        vehicle.paramValues.resize(_swarm.paramCount);
+        for (int paramIndex = 0; paramIndex < _swarm.paramCount; paramIndex++) {
+            vehicle.paramValues[paramIndex] = paramIndex;
+        }
+
+        _generateMission(vehicle);
+
+        _vehicles.append(vehicle);
+    }
+}
+
+/// The mission is a takeoff followed by waypoints evenly spaced around the vehicle's circle
+void MockLinkSwarm::_generateMission(Vehicle_t& vehicle)
+{
+    const double radius = _flying() ? _swarm.pathRadius : 100;
+
+    for (int seq = 0; seq < _swarm.missionItemCount; seq++) {
+        mavlink_mission_item_int_t item{};
+
+        item.seq            = seq;
+        item.frame          = MAV_FRAME_GLOBAL_RELATIVE_ALT_INT;
+        item.autocontinue   = 1;
+        item.mission_type   = MAV_MISSION_TYPE_MISSION;
+        item.z              = _pathAltitude;
+
+        QGeoCoordinate coord;
+        if (seq == 0) {
+            item.command = MAV_CMD_NAV_TAKEOFF;
+            coord = vehicle.home;
+        } else {
+            item.command = MAV_CMD_NAV_WAYPOINT;
+            coord = vehicle.home.atDistanceAndAzimuth(radius, (360.0 * (seq - 1)) / qMax(1, _swarm.missionItemCount - 1));
+        }
+        item.x = static_cast<int32_t>(coord.latitude() * 1E7);
+        item.y = static_cast<int32_t>(coord.longitude() * 1E7);
+
+        vehicle.missionItems.append(item);
+    }
+}
+
+bool MockLinkSwarm::_connect(void)
+{
+    if (!_connected) {
+        _connected = true;
+        // Swarm vehicles use Mavlink 2.0
+        mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel());
+        mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        mavlink_status_t* auxStatus = mavlink_get_channel_status(_mavlinkAuxChannel);
+        auxStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        start();
+        emit connected();
+    }
+
+    return true;
+}
+
+bool MockLinkSwarm::_allocateMavlinkChannel()
+{
+    if (!LinkInterface::_allocateMavlinkChannel()) {
+        qCWarning(MockLinkSwarmLog) << "LinkInterface::_allocateMavlinkChannel failed";
+        return false;
+    }
+
+    _mavlinkAuxChannel = qgcApp()->toolbox()->linkManager()->allocateMavlinkChannel();
+    if (_mavlinkAuxChannel == LinkManager::invalidMavlinkChannel()) {
+        qCWarning(MockLinkSwarmLog) << "_allocateMavlinkChannel failed";
+        LinkInterface::_freeMavlinkChannel();
+        return false;
+    }
+
+    return true;
+}
+
+void MockLinkSwarm::_freeMavlinkChannel()
+{
+    if (_mavlinkAuxChannel != LinkManager::invalidMavlinkChannel()) {
+        qgcApp()->toolbox()->linkManager()->freeMavlinkChannel(_mavlinkAuxChannel);
+        _mavlinkAuxChannel = LinkManager::invalidMavlinkChannel();
+    }
+    LinkInterface::_freeMavlinkChannel();
+}
+
+void MockLinkSwarm::disconnect(void)
+{
+    if (_connected) {
+        _connected = false;
+        quit();
+        wait();
+        emit disconnected();
+    }
+}
+
+void MockLinkSwarm::run(void)
+{
+    QTimer timer;
+
+    QObject::connect(&timer, &QTimer::timeout, this, &MockLinkSwarm::_runTasks);
+    timer.setTimerType(Qt::PreciseTimer);
+    timer.start(_tickMsecs);
+
+    _runningTime.start();
+    _runTasks();
+
+    exec();
+
+    QObject::disconnect(&timer, &QTimer::timeout, this, &MockLinkSwarm::_runTasks);
+}
+
+void MockLinkSwarm::_runTasks(void)
+{
+    if (!_connected) {
+        return;
+    }
+
+    const qint64 nowMsecs = _runningTime.elapsed();
+
+    // Each stream keeps its own schedule, a late tick sends once and then picks up the rate again
+    auto due = [nowMsecs](qint64& nextMsecs, int rateHz) {
+        if ((rateHz <= 0) || (nowMsecs < nextMsecs)) {
+            return false;
+        }
+        nextMsecs += 1000 / rateHz;
+        if (nextMsecs <= nowMsecs) {
+            nextMsecs = nowMsecs + (1000 / rateHz);
+        }
+        return true;
+    };
+
+    _advancePaths((nowMsecs - _lastTickMsecs) / 1000.0);
+    _lastTickMsecs = nowMsecs;
+
+    if (due(_nextHeartbeatMsecs, 1)) {
+        _sendHeartbeats();
+    }
+    if (due(_nextPositionMsecs, _swarm.positionRateHz)) {
+        _sendPositions();
+    }
+    if (due(_nextAttitudeMsecs, _swarm.attitudeRateHz)) {
+        _sendAttitudes();
+    }
+    if (due(_nextStatusMsecs, _swarm.statusRateHz)) {
+        _sendStatus();
+    }
+    _streamParams();
+
+    _flush();
+}
+
+/// Primes the aux channel with the vehicle's own sequence number so QGC doesn't see the other vehicles' traffic as loss
+uint8_t MockLinkSwarm::_packChannel(Vehicle_t& vehicle)
+{
+    mavlink_get_channel_status(_mavlinkAuxChannel)->current_tx_seq = vehicle.txSequence++;
+    return _mavlinkAuxChannel;
+}
+
+void MockLinkSwarm::_send(const mavlink_message_t& msg)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+
+    const int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
+    (void) _outgoing.append(reinterpret_cast<const char*>(buffer), cBuffer);
+    _messagesSent.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MockLinkSwarm::_flush(void)
+{
+    if (_outgoing.isEmpty()) {
+        return;
+    }
+
+    emit bytesReceived(this, _outgoing, QGC::utcTimeUsecs());
+    _outgoing = QByteArray();
+}
+
+/// @brief Called when QGC wants to write bytes to the swarm
+void MockLinkSwarm::_writeBytes(const QByteArray &bytes)
+{
+    emit writeBytesQueuedSignal(bytes);
+}
+
+void MockLinkSwarm::_writeBytesQueued(const QByteArray bytes)
+{
+    mavlink_message_t msg;
+    mavlink_status_t status;
+
+    for (const char byte: bytes) {
+        if (mavlink_parse_char(_mavlinkAuxChannel, static_cast<uint8_t>(byte), &msg, &status)) {
+            _handleIncomingMavlinkMsg(msg);
+        }
+    }
+
+    _flush();
+}
+
+MockLinkSwarm::Vehicle_t* MockLinkSwarm::_vehicleForSystemId(uint8_t systemId)
+{
+    for (Vehicle_t& vehicle: _vehicles) {
+        if (vehicle.systemId == systemId) {
+            return &vehicle;
+        }
+    }
+
+    return nullptr;
+}
+
+void MockLinkSwarm::_handleIncomingMavlinkMsg(const mavlink_message_t& msg)
+{
+    switch (msg.msgid) {
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+        _handleCommandLong(msg);
+        break;
+    case MAVLINK_MSG_ID_SET_MODE:
+        _handleSetMode(msg);
+        break;
+    case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+        _handleParamRequestList(msg);
+        break;
+    case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+        _handleParamRequestRead(msg);
+        break;
+    case MAVLINK_MSG_ID_PARAM_SET:
+        _handleParamSet(msg);
+        break;
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+        _handleMissionRequestList(msg);
+        break;
+    case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+        _handleMissionRequestInt(msg);
+        break;
+    case MAVLINK_MSG_ID_MISSION_COUNT:
+        _handleMissionCount(msg);
+        break;
+    case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+        _handleMissionItemInt(msg);
+        break;
+    case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+        _handleMissionClearAll(msg);
+        break;
+    default:
+        break;
+    }
+}
+
+void MockLinkSwarm::_handleCommandLong(const mavlink_message_t& msg)
+{
+    mavlink_command_long_t request;
+    mavlink_msg_command_long_decode(&msg, &request);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(request.target_system);
+    if (!vehicle) {
+        return;
+    }
+
+    uint8_t commandResult = MAV_RESULT_UNSUPPORTED;
+
+    switch (request.command) {
+    case MAV_CMD_COMPONENT_ARM_DISARM:
+        if (request.param1 == 0.0f) {
+            vehicle->baseMode &= ~MAV_MODE_FLAG_SAFETY_ARMED;
+        } else {
+            vehicle->baseMode |= MAV_MODE_FLAG_SAFETY_ARMED;
+        }
+        commandResult = MAV_RESULT_ACCEPTED;
+        break;
+    case MAV_CMD_SET_MESSAGE_INTERVAL:
+    case MAV_CMD_NAV_TAKEOFF:
+    case MAV_CMD_NAV_RETURN_TO_LAUNCH:
+    case MAV_CMD_NAV_LAND:
+        commandResult = MAV_RESULT_ACCEPTED;
+        break;
+    case MAV_CMD_REQUEST_MESSAGE:
+        switch (static_cast<int>(request.param1)) {
+        case MAVLINK_MSG_ID_AUTOPILOT_VERSION:
+            _sendAutopilotVersion(*vehicle);
+            commandResult = MAV_RESULT_ACCEPTED;
+            break;
+        case MAVLINK_MSG_ID_PROTOCOL_VERSION:
+        {
+            uint8_t nullHash[8] = { 0 };
+            mavlink_message_t responseMsg;
+            mavlink_msg_protocol_version_pack_chan(vehicle->systemId,
+                                                   MAV_COMP_ID_AUTOPILOT1,
+                                                   _packChannel(*vehicle),
+                                                   &responseMsg,
+                                                   200,
+                                                   100,
+                                                   200,
+                                                   nullHash,
+                                                   nullHash);
+            _send(responseMsg);
+            commandResult = MAV_RESULT_ACCEPTED;
+        }
+            break;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+
+    _sendCommandAck(*vehicle, request.command, commandResult);
+}
+
+void MockLinkSwarm::_handleSetMode(const mavlink_message_t& msg)
+{
+    mavlink_set_mode_t request;
+    mavlink_msg_set_mode_decode(&msg, &request);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(request.target_system);
+    if (vehicle) {
+        vehicle->baseMode = request.base_mode;
+        vehicle->customMode = request.custom_mode;
+    }
+}
+
+void MockLinkSwarm::_handleParamRequestList(const mavlink_message_t& msg)
+{
+    mavlink_param_request_list_t request;
+    mavlink_msg_param_request_list_decode(&msg, &request);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(request.target_system);
+    if (vehicle && !vehicle->paramValues.isEmpty()) {
+        vehicle->nextParamIndex = 0;
+    }
+}
+
+void MockLinkSwarm::_handleParamRequestRead(const mavlink_message_t& msg)
+{
+    mavlink_param_request_read_t request;
+    mavlink_msg_param_request_read_decode(&msg, &request);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(request.target_system);
+    if (!vehicle) {
+        return;
+    }
+
+    int paramIndex = request.param_index;
+    if (paramIndex == -1) {
+        const QString paramName(QString::fromLocal8Bit(request.param_id, static_cast<int>(strnlen(request.param_id, MAVLINK_MSG_PARAM_REQUEST_READ_FIELD_PARAM_ID_LEN))));
+        paramIndex = _paramIndex(paramName);
+    }
+
+    // Unknown params, including _HASH_CHECK, are ignored like a vehicle without them would
+    if ((paramIndex >= 0) && (paramIndex < vehicle->paramValues.count())) {
+        _sendParamValue(*vehicle, paramIndex);
+    }
+}
+
+void MockLinkSwarm::_handleParamSet(const mavlink_message_t& msg)
+{
+    mavlink_param_set_t request;
+    mavlink_msg_param_set_decode(&msg, &request);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(request.target_system);
+    if (!vehicle) {
+        return;
+    }
+
+    const QString paramName(QString::fromLocal8Bit(request.param_id, static_cast<int>(strnlen(request.param_id, MAVLINK_MSG_PARAM_SET_FIELD_PARAM_ID_LEN))));
+    const int paramIndex = _paramIndex(paramName);
+    if ((paramIndex >= 0) && (paramIndex < vehicle->paramValues.count())) {
+        vehicle->paramValues[paramIndex] = request.param_value;
+        _sendParamValue(*vehicle, paramIndex);
+    }
+}
+
+void MockLinkSwarm::_handleMissionRequestList(const mavlink_message_t& msg)
+{
+    mavlink_mission_request_list_t request;
+    mavlink_msg_mission_request_list_decode(&msg, &request);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(request.target_system);
+    if (!vehicle) {
+        return;
+    }
+
+    // Only missions are generated, fence and rally point lists are always empty
+    const uint16_t count = (request.mission_type == MAV_MISSION_TYPE_MISSION) ? vehicle->missionItems.count() : 0;
+
+    mavlink_message_t responseMsg;
+    mavlink_msg_mission_count_pack_chan(vehicle->systemId,
+                                        MAV_COMP_ID_AUTOPILOT1,
+                                        _packChannel(*vehicle),
+                                        &responseMsg,
+                                        msg.sysid,
+                                        msg.compid,
+                                        count,
+                                        request.mission_type,
+                                        0);
+    _send(responseMsg);
+}
+
+void MockLinkSwarm::_handleMissionRequestInt(const mavlink_message_t& msg)
+{
+    mavlink_mission_request_int_t request;
+    mavlink_msg_mission_request_int_decode(&msg, &request);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(request.target_system);
+    if (!vehicle) {
+        return;
+    }
+
+    if ((request.mission_type != MAV_MISSION_TYPE_MISSION) || (request.seq >= vehicle->missionItems.count())) {
+        _sendMissionAck(*vehicle, msg.sysid, msg.compid, request.mission_type, MAV_MISSION_INVALID_SEQUENCE);
+        return;
+    }
+
+    mavlink_mission_item_int_t item = vehicle->missionItems[request.seq];
+    item.target_system = msg.sysid;
+    item.target_component = msg.compid;
+    item.current = 0;
+
+    mavlink_message_t responseMsg;
+    mavlink_msg_mission_item_int_encode_chan(vehicle->systemId, MAV_COMP_ID_AUTOPILOT1, _packChannel(*vehicle), &responseMsg, &item);
+    _send(responseMsg);
+}
+
+void MockLinkSwarm::_handleMissionCount(const mavlink_message_t& msg)
+{
+    mavlink_mission_count_t missionCount;
+    mavlink_msg_mission_count_decode(&msg, &missionCount);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(missionCount.target_system);
+    if (!vehicle) {
+        return;
+    }
+
+    if (missionCount.mission_type != MAV_MISSION_TYPE_MISSION) {
+        _sendMissionAck(*vehicle, msg.sysid, msg.compid, missionCount.mission_type, missionCount.count ? MAV_MISSION_UNSUPPORTED : MAV_MISSION_ACCEPTED);
+        return;
+    }
+
+    vehicle->uploadItems.clear();
+    vehicle->uploadCount = missionCount.count;
+    vehicle->uploadSystemId = msg.sysid;
+    vehicle->uploadComponentId = msg.compid;
+
+    if (vehicle->uploadCount == 0) {
+        vehicle->missionItems.clear();
+        _sendMissionAck(*vehicle, msg.sysid, msg.compid, MAV_MISSION_TYPE_MISSION, MAV_MISSION_ACCEPTED);
+        return;
+    }
+
+    mavlink_message_t requestMsg;
+    mavlink_msg_mission_request_int_pack_chan(vehicle->systemId,
+                                              MAV_COMP_ID_AUTOPILOT1,
+                                              _packChannel(*vehicle),
+                                              &requestMsg,
+                                              msg.sysid,
+                                              msg.compid,
+                                              0,
+                                              MAV_MISSION_TYPE_MISSION);
+    _send(requestMsg);
+}
+
+void MockLinkSwarm::_handleMissionItemInt(const mavlink_message_t& msg)
+{
+    mavlink_mission_item_int_t item;
+    mavlink_msg_mission_item_int_decode(&msg, &item);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(item.target_system);
+    if (!vehicle || (vehicle->uploadCount == 0) || (item.seq != vehicle->uploadItems.count())) {
+        // Not part of an upload or a resend of an item we already have
+        return;
+    }
+
+    vehicle->uploadItems.append(item);
+
+    if (vehicle->uploadItems.count() == vehicle->uploadCount) {
+        vehicle->missionItems = vehicle->uploadItems;
+        vehicle->uploadItems.clear();
+        vehicle->uploadCount = 0;
+        _sendMissionAck(*vehicle, vehicle->uploadSystemId, vehicle->uploadComponentId, MAV_MISSION_TYPE_MISSION, MAV_MISSION_ACCEPTED);
+        return;
+    }
+
+    mavlink_message_t requestMsg;
+    mavlink_msg_mission_request_int_pack_chan(vehicle->systemId,
+                                              MAV_COMP_ID_AUTOPILOT1,
+                                              _packChannel(*vehicle),
+                                              &requestMsg,
+                                              vehicle->uploadSystemId,
+                                              vehicle->uploadComponentId,
+                                              vehicle->uploadItems.count(),
+                                              MAV_MISSION_TYPE_MISSION);
+    _send(requestMsg);
+}
+
+void MockLinkSwarm::_handleMissionClearAll(const mavlink_message_t& msg)
+{
+    mavlink_mission_clear_all_t request;
+    mavlink_msg_mission_clear_all_decode(&msg, &request);
+
+    Vehicle_t* const vehicle = _vehicleForSystemId(request.target_system);
+    if (!vehicle) {
+        return;
+    }
+
+    if (request.mission_type == MAV_MISSION_TYPE_MISSION) {
+        vehicle->missionItems.clear();
+    }
+    _sendMissionAck(*vehicle, msg.sysid, msg.compid, request.mission_type, MAV_MISSION_ACCEPTED);
+}
+
+void MockLinkSwarm::_sendCommandAck(Vehicle_t& vehicle, uint16_t command, uint8_t result)
+{
+    mavlink_message_t commandAck;
+    mavlink_msg_command_ack_pack_chan(vehicle.systemId,
+                                      MAV_COMP_ID_AUTOPILOT1,
+                                      _packChannel(vehicle),
+                                      &commandAck,
+                                      command,
+                                      result,
+                                      0,    // progress
+                                      0,    // result_param2
+                                      0,    // target_system
+                                      0);   // target_component
+    _send(commandAck);
+}
+
+void MockLinkSwarm::_sendMissionAck(Vehicle_t& vehicle, uint8_t targetSystem, uint8_t targetComponent, uint8_t missionType, uint8_t result)
+{
+    mavlink_message_t missionAck;
+    mavlink_msg_mission_ack_pack_chan(vehicle.systemId,
+                                      MAV_COMP_ID_AUTOPILOT1,
+                                      _packChannel(vehicle),
+                                      &missionAck,
+                                      targetSystem,
+                                      targetComponent,
+                                      result,
+                                      missionType,
+                                      0);
+    _send(missionAck);
+}
+
+void MockLinkSwarm::_sendParamValue(Vehicle_t& vehicle, int paramIndex)
+{
+    char paramId[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1] = {};
+    strncpy(paramId, _paramName(paramIndex).toLocal8Bit().constData(), MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
+
+    mavlink_message_t paramValue;
+    mavlink_msg_param_value_pack_chan(vehicle.systemId,
+                                      MAV_COMP_ID_AUTOPILOT1,
+                                      _packChannel(vehicle),
+                                      &paramValue,
+                                      paramId,
+                                      vehicle.paramValues[paramIndex],
+                                      MAV_PARAM_TYPE_REAL32,
+                                      vehicle.paramValues.count(),
+                                      paramIndex);
+    _send(paramValue);
+}
+
+void MockLinkSwarm::_sendAutopilotVersion(Vehicle_t& vehicle)
+{
+    uint8_t customVersion[8] = { };
+    const uint64_t capabilities = MAV_PROTOCOL_CAPABILITY_MAVLINK2 | MAV_PROTOCOL_CAPABILITY_MISSION_INT;
+
+    mavlink_message_t msg;
+    mavlink_msg_autopilot_version_pack_chan(vehicle.systemId,
+                                            MAV_COMP_ID_AUTOPILOT1,
+                                            _packChannel(vehicle),
+                                            &msg,
+                                            capabilities,
+                                            0,                               // flight_sw_version,
+                                            0,                               // middleware_sw_version,
+                                            0,                               // os_sw_version,
+                                            0,                               // board_version,
+                                            customVersion,                   // flight_custom_version,
+                                            customVersion,                   // middleware_custom_version,
+                                            customVersion,                   // os_custom_version,
+                                            0,                               // vendor_id
+                                            0,                               // product_id
+                                            vehicle.systemId,                // uid
+                                            0);                              // uid2
+    _send(msg);
+}
+
+void MockLinkSwarm::_sendHeartbeats(void)
+{
+    MockConfiguration* mockConfig = qobject_cast<MockConfiguration*>(_config.get());
+    const MAV_TYPE vehicleType = mockConfig ? mockConfig->vehicleType() : MAV_TYPE_QUADROTOR;
+
+    for (Vehicle_t& vehicle: _vehicles) {
+        const bool armed = vehicle.baseMode & MAV_MODE_FLAG_SAFETY_ARMED;
+
+        mavlink_message_t msg;
+        mavlink_msg_heartbeat_pack_chan(vehicle.systemId,
+                                        MAV_COMP_ID_AUTOPILOT1,
+                                        _packChannel(vehicle),
+                                        &msg,
+                                        vehicleType,
+                                        MAV_AUTOPILOT_GENERIC,
+                                        vehicle.baseMode,
+                                        vehicle.customMode,
+                                        armed ? MAV_STATE_ACTIVE : MAV_STATE_STANDBY);
+        _send(msg);
+    }
+}
+
+void MockLinkSwarm::_advancePaths(double elapsedSecs)
+{
+    if (!_flying()) {
+        return;
+    }
+
+    const double angleStep = (_swarm.pathSpeed / _swarm.pathRadius) * elapsedSecs;
+    for (Vehicle_t& vehicle: _vehicles) {
+        if (vehicle.baseMode & MAV_MODE_FLAG_SAFETY_ARMED) {
+            vehicle.pathAngle = std::fmod(vehicle.pathAngle + (vehicle.pathDirection * angleStep), 2 * M_PI);
+        }
+    }
+}
+
+QGeoCoordinate MockLinkSwarm::_coordinate(const Vehicle_t& vehicle) const
+{
+    if (!_flying()) {
+        return vehicle.home;
+    }
+
+    QGeoCoordinate coord = vehicle.home.atDistanceAndAzimuth(_swarm.pathRadius, qRadiansToDegrees(vehicle.pathAngle));
+    coord.setAltitude(vehicle.home.altitude() + _pathAltitude);
+    return coord;
+}
+
+/// @return Heading in degrees, tangent to the circle in the direction of travel
+double MockLinkSwarm::_heading(const Vehicle_t& vehicle) const
+{
+    const double heading = qRadiansToDegrees(vehicle.pathAngle) + (vehicle.pathDirection * 90.0);
+    return std::fmod(heading + 720.0, 360.0);
+}
+
+void MockLinkSwarm::_sendPositions(void)
+{
+    const uint32_t timeBootMsecs = static_cast<uint32_t>(_runningTime.elapsed());
+
+    for (Vehicle_t& vehicle: _vehicles) {
+        const QGeoCoordinate coord = _coordinate(vehicle);
+        const bool moving = _flying() && (vehicle.baseMode & MAV_MODE_FLAG_SAFETY_ARMED);
+        const double speed = moving ? _swarm.pathSpeed : 0;
+        const double heading = _heading(vehicle);
+
+        mavlink_message_t msg;
+        mavlink_msg_global_position_int_pack_chan(vehicle.systemId,
+                                                  MAV_COMP_ID_AUTOPILOT1,
+                                                  _packChannel(vehicle),
+                                                  &msg,
+                                                  timeBootMsecs,
+                                                  static_cast<int32_t>(coord.latitude() * 1E7),
+                                                  static_cast<int32_t>(coord.longitude() * 1E7),
+                                                  static_cast<int32_t>(coord.altitude() * 1000),
+                                                  static_cast<int32_t>((coord.altitude() - vehicle.home.altitude()) * 1000),
+                                                  static_cast<int16_t>(speed * std::cos(qDegreesToRadians(heading)) * 100),  // vx north cm/s
+                                                  static_cast<int16_t>(speed * std::sin(qDegreesToRadians(heading)) * 100),  // vy east cm/s
+                                                  0,                                                                        // vz
+                                                  static_cast<uint16_t>(heading * 100));
+        _send(msg);
+
+        mavlink_msg_gps_raw_int_pack_chan(vehicle.systemId,
+                                          MAV_COMP_ID_AUTOPILOT1,
+                                          _packChannel(vehicle),
+                                          &msg,
+                                          static_cast<uint64_t>(timeBootMsecs) * 1000,
+                                          GPS_FIX_TYPE_3D_FIX,
+                                          static_cast<int32_t>(coord.latitude() * 1E7),
+                                          static_cast<int32_t>(coord.longitude() * 1E7),
+                                          static_cast<int32_t>(coord.altitude() * 1000),
+                                          1 * 100,                                  // hdop
+                                          1 * 100,                                  // vdop
+                                          static_cast<uint16_t>(speed * 100),       // vel cm/s
+                                          static_cast<uint16_t>(heading * 100),     // cog cdeg
+                                          12,                                       // satellites visible
+                                          0, 0, 0, 0, 0,
+                                          65535);                                   // Yaw not provided
+        _send(msg);
+    }
+}
+
+void MockLinkSwarm::_sendAttitudes(void)
+{
+    const uint32_t timeBootMsecs = static_cast<uint32_t>(_runningTime.elapsed());
+
+    for (Vehicle_t& vehicle: _vehicles) {
+        const bool moving = _flying() && (vehicle.baseMode & MAV_MODE_FLAG_SAFETY_ARMED);
+
+        // Coordinated turn around the circle
+        const double roll = moving ? vehicle.pathDirection * std::atan((_swarm.pathSpeed * _swarm.pathSpeed) / (9.81 * _swarm.pathRadius)) : 0;
+        const double yawRate = moving ? vehicle.pathDirection * (_swarm.pathSpeed / _swarm.pathRadius) : 0;
+        double yaw = qDegreesToRadians(_heading(vehicle));
+        if (yaw > M_PI) {
+            yaw -= 2 * M_PI;
+        }
+
+        mavlink_message_t msg;
+        mavlink_msg_attitude_pack_chan(vehicle.systemId,
+                                       MAV_COMP_ID_AUTOPILOT1,
+                                       _packChannel(vehicle),
+                                       &msg,
+                                       timeBootMsecs,
+                                       static_cast<float>(roll),
+                                       0,                               // pitch
+                                       static_cast<float>(yaw),
+                                       0,                               // rollspeed
+                                       0,                               // pitchspeed
+                                       static_cast<float>(yawRate));
+        _send(msg);
+    }
+}
+
+void MockLinkSwarm::_sendStatus(void)
+{
+    // Batteries drain over 30 minutes then stay empty
+    const int8_t batteryRemaining = static_cast<int8_t>(qMax<qint64>(0, 100 - (_runningTime.elapsed() / 18000)));
+
+    uint16_t rgVoltages[10];
+    uint16_t rgVoltagesExtNone[4] = {};
+    for (int i = 0; i < 10; i++) {
+        rgVoltages[i] = UINT16_MAX;
+    }
+    rgVoltages[0] = rgVoltages[1] = rgVoltages[2] = rgVoltages[3] = 4000;
+
+    for (Vehicle_t& vehicle: _vehicles) {
+        const bool inAir = _flying() && (vehicle.baseMode & MAV_MODE_FLAG_SAFETY_ARMED);
+        float q[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+
+        mavlink_message_t msg;
+        mavlink_msg_sys_status_pack_chan(vehicle.systemId,
+                                         MAV_COMP_ID_AUTOPILOT1,
+                                         _packChannel(vehicle),
+                                         &msg,
+                                         MAV_SYS_STATUS_SENSOR_GPS,  // onboard_control_sensors_present
+                                         MAV_SYS_STATUS_SENSOR_GPS,  // onboard_control_sensors_enabled
+                                         MAV_SYS_STATUS_SENSOR_GPS,  // onboard_control_sensors_health
+                                         250,                        // load
+                                         4000 * 4,                   // voltage_battery
+                                         1500,                       // current_battery
+                                         batteryRemaining,
+                                         0,0,0,0,0,0,0,0,0);
+        _send(msg);
+
+        mavlink_msg_battery_status_pack_chan(vehicle.systemId,
+                                             MAV_COMP_ID_AUTOPILOT1,
+                                             _packChannel(vehicle),
+                                             &msg,
+                                             0,                          // battery id
+                                             MAV_BATTERY_FUNCTION_ALL,
+                                             MAV_BATTERY_TYPE_LIPO,
+                                             2500,                       // temp cdegC
+                                             rgVoltages,
+                                             1500,                       // battery cA
+                                             -1,                         // current consumed not supported
+                                             -1,                         // energy consumed not supported
+                                             batteryRemaining,
+                                             0,                          // time remaining not supported
+                                             MAV_BATTERY_CHARGE_STATE_OK,
+                                             rgVoltagesExtNone,
+                                             0,                          // MAV_BATTERY_MODE
+                                             0);                         // MAV_BATTERY_FAULT
+        _send(msg);
+
+        mavlink_msg_extended_sys_state_pack_chan(vehicle.systemId,
+                                                 MAV_COMP_ID_AUTOPILOT1,
+                                                 _packChannel(vehicle),
+                                                 &msg,
+                                                 MAV_VTOL_STATE_UNDEFINED,
+                                                 inAir ? MAV_LANDED_STATE_IN_AIR : MAV_LANDED_STATE_ON_GROUND);
+        _send(msg);
+
+        mavlink_msg_home_position_pack_chan(vehicle.systemId,
+                                            MAV_COMP_ID_AUTOPILOT1,
+                                            _packChannel(vehicle),
+                                            &msg,
+                                            static_cast<int32_t>(vehicle.home.latitude() * 1E7),
+                                            static_cast<int32_t>(vehicle.home.longitude() * 1E7),
+                                            static_cast<int32_t>(vehicle.home.altitude() * 1000),
+                                            0.0f, 0.0f, 0.0f,
+                                            q,
+                                            0.0f, 0.0f, 0.0f,
+                                            0);
+        _send(msg);
+    }
+}
+
+void MockLinkSwarm::_streamParams(void)
+{
+    for (Vehicle_t& vehicle: _vehicles) {
+        for (int i = 0; (i < _paramsPerTick) && (vehicle.nextParamIndex != -1); i++) {
+            _sendParamValue(vehicle, vehicle.nextParamIndex);
+            if (++vehicle.nextParamIndex >= vehicle.paramValues.count()) {
+                vehicle.nextParamIndex = -1;
+            }
+        }
+    }
+}
+
+QString MockLinkSwarm::_paramName(int paramIndex)
+{
+    return QStringLiteral("SWARM_P%1").arg(paramIndex, 5, 10, QLatin1Char('0'));
+}
+
+/// @return -1: not a swarm parameter name
+int MockLinkSwarm::_paramIndex(const QString& paramName)
+{
+    static const QString prefix = QStringLiteral("SWARM_P");
+
+    if (!paramName.startsWith(prefix)) {
+        return -1;
+    }
+
+    bool ok = false;
+    const int paramIndex = paramName.mid(prefix.length()).toInt(&ok);
+    return ok ? paramIndex : -1;
+}
+
+bool MockLinkSwarm::parseOptions(const QString& options, MockConfiguration::Swarm_t& swarm, int& linkCount, QString& errorString)
+{
+    errorString.clear();
+
+    const QStringList pairs = options.split(',', Qt::SkipEmptyParts);
+    for (const QString& pair: pairs) {
+        const QStringList keyValue = pair.split('=');
+        if (keyValue.count() != 2) {
+            errorString = QStringLiteral("Invalid swarm option '%1', expected key=value").arg(pair);
+            return false;
+        }
+
+        const QString key = keyValue[0].trimmed();
+        bool ok = false;
+        const double value = keyValue[1].trimmed().toDouble(&ok);
+        if (!ok || (value < 0)) {
+            errorString = QStringLiteral("Invalid value for swarm option '%1'").arg(key);
+            return false;
+        }
+
+        if (key == QStringLiteral("vehicles")) {
+            swarm.vehicleCount = static_cast<int>(value);
+        } else if (key == QStringLiteral("links")) {
+            linkCount = qMax(1, static_cast<int>(value));
+        } else if (key == QStringLiteral("position")) {
+            swarm.positionRateHz = static_cast<int>(value);
+        } else if (key == QStringLiteral("attitude")) {
+            swarm.attitudeRateHz = static_cast<int>(value);
+        } else if (key == QStringLiteral("status")) {
+            swarm.statusRateHz = static_cast<int>(value);
+        } else if (key == QStringLiteral("mission")) {
+            swarm.missionItemCount = static_cast<int>(value);
+        } else if (key == QStringLiteral("params")) {
+            swarm.paramCount = static_cast<int>(value);
+        } else if (key == QStringLiteral("radius")) {
+            swarm.pathRadius = value;
+        } else if (key == QStringLiteral("speed")) {
+            swarm.pathSpeed = value;
+        } else {
+            errorString = QStringLiteral("Unknown swarm option '%1'").arg(key);
+            return false;
+        }
+    }
+
+    // Stream schedules are kept in whole milliseconds
+    swarm.positionRateHz = qMin(swarm.positionRateHz, 1000 / _tickMsecs);
+    swarm.attitudeRateHz = qMin(swarm.attitudeRateHz, 1000 / _tickMsecs);
+    swarm.statusRateHz = qMin(swarm.statusRateHz, 1000 / _tickMsecs);
+
+    return true;
+}
+
+QList<MockLinkSwarm*> MockLinkSwarm::startSwarm(const MockConfiguration::Swarm_t& swarm, int linkCount)
+{
+    QList<MockLinkSwarm*> links;
+    LinkManager* linkMgr = qgcApp()->toolbox()->linkManager();
+
+    linkCount = qBound(1, linkCount, qMax(1, swarm.vehicleCount));
+    for (int i = 0; i < linkCount; i++) {
+        MockConfiguration::Swarm_t linkSwarm = swarm;
+        linkSwarm.vehicleCount = (swarm.vehicleCount / linkCount) + ((i < (swarm.vehicleCount % linkCount)) ? 1 : 0);
+
+        MockConfiguration* mockConfig = new MockConfiguration(QStringLiteral("MockLink Swarm %1").arg(i + 1));
+        mockConfig->setFirmwareType(MAV_AUTOPILOT_GENERIC);
+        mockConfig->setSwarm(linkSwarm);
+        mockConfig->setDynamic(true);
+
+        SharedLinkConfigurationPtr config = linkMgr->addConfiguration(mockConfig);
+        if (!linkMgr->createConnectedLink(config)) {
+            qCWarning(MockLinkSwarmLog) << "Unable to create swarm link" << (i + 1) << "of" << linkCount;
+            break;
+        }
+        links.append(qobject_cast<MockLinkSwarm*>(config->link()));
+    }
+
+    return links;
+}
+
+bool MockLinkSwarm::startSwarm(const QString& options)
+{
+    MockConfiguration::Swarm_t swarm;
+    swarm.vehicleCount = 10;
+    int linkCount = 1;
+    QString errorString;
+
+    if (!parseOptions(options, swarm, linkCount, errorString)) {
+        qCWarning(MockLinkSwarmLog) << errorString;
+        return false;
+    }
+
+    qCDebug(MockLinkSwarmLog) << "Starting swarm" << swarm.vehicleCount << "vehicles on" << linkCount << "links";
+    return !startSwarm(swarm, linkCount).isEmpty();
+}
@@ -0,0 +1,152 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MockLink.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+#include <atomic>
+
+Q_DECLARE_LOGGING_CATEGORY(MockLinkSwarmLog)
+
+/// Load generator which simulates many vehicles on a single link, used to measure how QGC scales with large numbers
+/// of vehicles. Each vehicle implements just enough of the protocol for a Generic firmware vehicle to complete the
+/// initial connect sequence: heartbeats, telemetry streams at the configured rates, the parameter protocol for a
+/// generated parameter set and the mission protocol for a generated mission. Vehicles fly a circle around their home
+/// position which passes through their mission waypoints.
+///
+/// Unlike MockLink a single swarm link only uses two mavlink channels no matter how many vehicles it carries.
+class MockLinkSwarm : public LinkInterface
+{
+    Q_OBJECT
+
+public:
+    MockLinkSwarm(SharedLinkConfigurationPtr& config);
+    virtual ~MockLinkSwarm();
+
+    int vehicleCount(void) const { return _vehicles.count(); }
+
+    /// Total number of messages sent to QGC since the link connected
+    quint64 messagesSent(void) const { return _messagesSent.load(std::memory_order_relaxed); }
+
+    // Overrides from LinkInterface
+    bool isConnected(void) const override { return _connected; }
+    void disconnect (void) override;
+
+    /// Parses a comma separated key=value list, for example "vehicles=100,links=2,position=20,params=500".
+    /// Keys not specified keep the value they already have in swarm.
+    ///     @param[out] linkCount Number of links to spread the vehicles across
+    /// @return false: options string is invalid
+    static bool parseOptions(const QString& options, MockConfiguration::Swarm_t& swarm, int& linkCount, QString& errorString);
+
+    /// Starts linkCount swarm links with swarm.vehicleCount vehicles spread across them
+    static QList<MockLinkSwarm*> startSwarm(const MockConfiguration::Swarm_t& swarm, int linkCount);
+
+    /// Parses options and starts the swarm
+    /// @return false: options string is invalid, no links were started
+    static bool startSwarm(const QString& options);
+
+signals:
+    void writeBytesQueuedSignal(const QByteArray bytes);
+
+private slots:
+    // LinkInterface overrides
+    void _writeBytes(const QByteArray &bytes) final;
+
+    void _writeBytesQueued  (const QByteArray bytes);
+    void _runTasks          (void);
+
+private:
+    typedef struct {
+        uint8_t                             systemId;
+        uint8_t                             txSequence          = 0;
+        QGeoCoordinate                      home;
+        double                              pathAngle           = 0;    ///< Radians around home
+        double                              pathDirection       = 1;    ///< 1: clockwise, -1: counter clockwise
+        uint8_t                             baseMode            = MAV_MODE_FLAG_CUSTOM_MODE_ENABLED;
+        uint32_t                            customMode          = 0;
+        int                                 nextParamIndex      = -1;   ///< Next param to stream, -1 for no request in progress
+        QList<float>                        paramValues;
+        QList<mavlink_mission_item_int_t>   missionItems;
+        QList<mavlink_mission_item_int_t>   uploadItems;
+        int                                 uploadCount         = 0;    ///< Items in the upload in progress, 0 for none
+        uint8_t                             uploadSystemId      = 0;
+        uint8_t                             uploadComponentId   = 0;
+    } Vehicle_t;
+
+    // LinkInterface overrides
+    bool _connect                   (void) override;
+    bool _allocateMavlinkChannel    () override;
+    void _freeMavlinkChannel        () override;
+
+    // QThread override
+    void run(void) final;
+
+    void        _createVehicles             (void);
+    Vehicle_t*  _vehicleForSystemId         (uint8_t systemId);
+    void        _generateMission            (Vehicle_t& vehicle);
+    uint8_t     _packChannel                (Vehicle_t& vehicle);
+    void        _send                       (const mavlink_message_t& msg);
+    void        _flush                      (void);
+    void        _handleIncomingMavlinkMsg   (const mavlink_message_t& msg);
+    void        _handleCommandLong          (const mavlink_message_t& msg);
+    void        _handleSetMode              (const mavlink_message_t& msg);
+    void        _handleParamRequestList     (const mavlink_message_t& msg);
+    void        _handleParamRequestRead     (const mavlink_message_t& msg);
+    void        _handleParamSet             (const mavlink_message_t& msg);
+    void        _handleMissionRequestList   (const mavlink_message_t& msg);
+    void        _handleMissionRequestInt    (const mavlink_message_t& msg);
+    void        _handleMissionCount         (const mavlink_message_t& msg);
+    void        _handleMissionItemInt       (const mavlink_message_t& msg);
+    void        _handleMissionClearAll      (const mavlink_message_t& msg);
+    void        _sendCommandAck             (Vehicle_t& vehicle, uint16_t command, uint8_t result);
+    void        _sendMissionAck             (Vehicle_t& vehicle, uint8_t targetSystem, uint8_t targetComponent, uint8_t missionType, uint8_t result);
+    void        _sendParamValue             (Vehicle_t& vehicle, int paramIndex);
+    void        _sendAutopilotVersion       (Vehicle_t& vehicle);
+    void        _sendHeartbeats             (void);
+    void        _advancePaths               (double elapsedSecs);
+    void        _sendPositions              (void);
+    void        _sendAttitudes              (void);
+    void        _sendStatus                 (void);
+    void        _streamParams               (void);
+
+    QGeoCoordinate  _coordinate     (const Vehicle_t& vehicle) const;
+    double          _heading        (const Vehicle_t& vehicle) const;
+    bool            _flying         (void) const { return _swarm.pathRadius > 0; }
+
+    static QString  _paramName      (int paramIndex);
+    static int      _paramIndex     (const QString& paramName);
+
+    bool                        _connected          = false;
+    MockConfiguration::Swarm_t  _swarm;
+    QList<Vehicle_t>            _vehicles;
+    QElapsedTimer               _runningTime;
+    qint64                      _lastTickMsecs      = 0;
+    qint64                      _nextHeartbeatMsecs = 0;
+    qint64                      _nextPositionMsecs  = 0;
+    qint64                      _nextAttitudeMsecs  = 0;
+    qint64                      _nextStatusMsecs    = 0;
+    QByteArray                  _outgoing;                          ///< Messages are handed to QGC once per tick
+    std::atomic<quint64>        _messagesSent       { 0 };
+
+    /// Only used from the link thread, for packing outgoing and parsing incoming messages
+    uint8_t                     _mavlinkAuxChannel  = std::numeric_limits<uint8_t>::max();
+
+    static int                  _nextSystemId;
+
+    static constexpr int        _tickMsecs          = 10;
+    static constexpr int        _paramsPerTick      = 5;            ///< Per vehicle, while a param request list is in progress
+    static constexpr double     _pathAltitude       = 50;           ///< Meters above home while flying the path
+    static constexpr double     _homeSpacing        = 0.002;        ///< Degrees between vehicle home positions
+    static constexpr int        _maxSystemId        = 254;
+};
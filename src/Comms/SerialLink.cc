@@ -10,6 +10,8 @@
 #include "SerialLink.h"
 #include "QGC.h"
 #include "QGCLoggingCategory.h"
+#include "QGCSerialPortInfo.h"
+#include "QGCTrace.h"
 #ifdef Q_OS_ANDROID
 #include "QGCApplication.h"
 #include "LinkManager.h"
@@ -20,6 +22,11 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSettings>
 
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#endif
+
 QGC_LOGGING_CATEGORY(SerialLinkLog, "SerialLinkLog")
 
 SerialLink::SerialLink(SharedLinkConfigurationPtr& config)
@@ -29,6 +36,9 @@ SerialLink::SerialLink(SharedLinkConfigurationPtr& config)
     qRegisterMetaType<QSerialPort::SerialPortError>();
     qCDebug(SerialLinkLog) << "Create SerialLink portName:baud:flowControl:parity:dataButs:stopBits" << _serialConfig->portName() << _serialConfig->baud() << _serialConfig->flowControl()
                            << _serialConfig->parity() << _serialConfig->dataBits() << _serialConfig->stopBits();
+
+    _readLatencyTimer.setSingleShot(true);
+    (void) connect(&_readLatencyTimer, &QTimer::timeout, this, &SerialLink::_readBytes);
 }
 
 SerialLink::~SerialLink()
@@ -58,6 +68,15 @@ bool SerialLink::_isBootloader()
     return false;
 }
 
+/// @return true: the port is a telemetry radio detected by its USB ids
+bool SerialLink::_isTelemetryRadio()
+{
+    QGCSerialPortInfo::BoardType_t boardType;
+    QString boardName;
+    const QGCSerialPortInfo portInfo(*_port);
+    return portInfo.getBoardInfo(boardType, boardName) && (boardType == QGCSerialPortInfo::BoardTypeSiKRadio);
+}
+
 void SerialLink::_writeBytes(const QByteArray &data)
 {
     if(_port && _port->isOpen()) {
@@ -72,6 +91,7 @@ void SerialLink::_writeBytes(const QByteArray &data)
 
 void SerialLink::disconnect(void)
 {
+    _readLatencyTimer.stop();
     if (_port) {
         // This prevents stale signals from calling the link after it has been deleted
         QObject::disconnect(_port, &QIODevice::readyRead, this, &SerialLink::_readBytes);
@@ -214,6 +234,14 @@ bool SerialLink::_hardwareConnect(QSerialPort::SerialPortError& error, QString&
     _port->setStopBits     (static_cast<QSerialPort::StopBits>     (_serialConfig->stopBits()));
     _port->setParity       (static_cast<QSerialPort::Parity>       (_serialConfig->parity()));
 
+    // Telemetry radios can only send as fast as the baud rate, about 10 bits per byte on the wire. Other serial
+    // devices, such as autopilots on USB which ignore the baud rate, are not limited.
+    setTransmitCapacity(_isTelemetryRadio() ? (_serialConfig->baud() / 10.0) : 0);
+
+    if (_serialConfig->lowLatency()) {
+        _setLowLatency();
+    }
+
     emit connected();
 
     qCDebug(SerialLinkLog) << "Connection SeriaLink: " << "with settings" << _serialConfig->portName()
@@ -224,13 +252,24 @@ bool SerialLink::_hardwareConnect(QSerialPort::SerialPortError& error, QString&
 
 void SerialLink::_readBytes(void)
 {
+    QGC_TRACE_SCOPE("SerialLink::_readBytes");
+
     if (_port && _port->isOpen()) {
         qint64 byteCount = _port->bytesAvailable();
         if (byteCount) {
-            QByteArray buffer;
-            buffer.resize(byteCount);
+            // Leave small reads in the port until the batch is full or the latency window closes
+            if ((byteCount < _serialConfig->minReadBytes()) && (sender() != &_readLatencyTimer)) {
+                if (!_readLatencyTimer.isActive()) {
+                    _readLatencyTimer.start(_serialConfig->readLatencyMsecs());
+                }
+                return;
+            }
+            _readLatencyTimer.stop();
+
+            const quint64 timestampUsecs = QGC::utcTimeUsecs();
+            QByteArray& buffer = _readBuffer(byteCount);
             _port->read(buffer.data(), buffer.size());
-            emit bytesReceived(this, buffer);
+            emit bytesReceived(this, buffer, timestampUsecs);
         }
     } else {
         // Error occurred
@@ -239,6 +278,24 @@ void SerialLink::_readBytes(void)
     }
 }
 
+/// Drivers such as FTDI hold received bytes back for a few milliseconds to fill a USB packet, low latency mode hands
+/// them over right away
+void SerialLink::_setLowLatency(void)
+{
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    struct serial_struct serial;
+    const int fd = static_cast<int>(_port->handle());
+    if ((ioctl(fd, TIOCGSERIAL, &serial) == 0)) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        if (ioctl(fd, TIOCSSERIAL, &serial) != 0) {
+            qCWarning(SerialLinkLog) << "Unable to set low latency mode" << _serialConfig->portName();
+        }
+    }
+#else
+    qCDebug(SerialLinkLog) << "Low latency mode not supported on this platform";
+#endif
+}
+
 void SerialLink::linkError(QSerialPort::SerialPortError error)
 {
     switch (error) {
@@ -304,6 +361,9 @@ SerialConfiguration::SerialConfiguration(const SerialConfiguration* copy) : Link
     _portName           = copy->portName();
     _portDisplayName    = copy->portDisplayName();
     _usbDirect          = copy->_usbDirect;
+    _minReadBytes       = copy->_minReadBytes;
+    _readLatencyMsecs   = copy->_readLatencyMsecs;
+    _lowLatency         = copy->_lowLatency;
 }
 
 void SerialConfiguration::copyFrom(const LinkConfiguration *source)
@@ -319,6 +379,9 @@ void SerialConfiguration::copyFrom(const LinkConfiguration *source)
         _portName           = ssource->portName();
         _portDisplayName    = ssource->portDisplayName();
         _usbDirect          = ssource->_usbDirect;
+        _minReadBytes       = ssource->_minReadBytes;
+        _readLatencyMsecs   = ssource->_readLatencyMsecs;
+        _lowLatency         = ssource->_lowLatency;
     } else {
         qWarning() << "Internal error";
     }
@@ -381,6 +444,9 @@ void SerialConfiguration::saveSettings(QSettings& settings, const QString& root)
     settings.setValue("parity",         _parity);
     settings.setValue("portName",       _portName);
     settings.setValue("portDisplayName",_portDisplayName);
+    settings.setValue("minReadBytes",   _minReadBytes);
+    settings.setValue("readLatencyMsecs", _readLatencyMsecs);
+    settings.setValue("lowLatency",     _lowLatency);
     settings.endGroup();
 }
 
@@ -394,6 +460,9 @@ void SerialConfiguration::loadSettings(QSettings& settings, const QString& root)
     if(settings.contains("parity"))         _parity         = settings.value("parity").toInt();
     if(settings.contains("portName"))       _portName       = settings.value("portName").toString();
     if(settings.contains("portDisplayName"))_portDisplayName= settings.value("portDisplayName").toString();
+    if(settings.contains("minReadBytes"))   _minReadBytes   = settings.value("minReadBytes").toInt();
+    if(settings.contains("readLatencyMsecs")) _readLatencyMsecs = settings.value("readLatencyMsecs").toInt();
+    if(settings.contains("lowLatency"))     _lowLatency     = settings.value("lowLatency").toBool();
     settings.endGroup();
 }
 
@@ -414,3 +483,29 @@ void SerialConfiguration::setUsbDirect(bool usbDirect)
         emit usbDirectChanged(_usbDirect);
     }
 }
+
+void SerialConfiguration::setMinReadBytes(int minReadBytes)
+{
+    minReadBytes = qMax(0, minReadBytes);
+    if (_minReadBytes != minReadBytes) {
+        _minReadBytes = minReadBytes;
+        emit minReadBytesChanged();
+    }
+}
+
+void SerialConfiguration::setReadLatencyMsecs(int readLatencyMsecs)
+{
+    readLatencyMsecs = qMax(0, readLatencyMsecs);
+    if (_readLatencyMsecs != readLatencyMsecs) {
+        _readLatencyMsecs = readLatencyMsecs;
+        emit readLatencyMsecsChanged();
+    }
+}
+
+void SerialConfiguration::setLowLatency(bool lowLatency)
+{
+    if (_lowLatency != lowLatency) {
+        _lowLatency = lowLatency;
+        emit lowLatencyChanged();
+    }
+}
@@ -14,6 +14,7 @@
 
 #include <QtCore/QMutex>
 #include <QtCore/QString>
+#include <QtCore/QTimer>
 #include <QtCore/QMetaType>
 #ifdef Q_OS_ANDROID
 #include "qserialport.h"
@@ -47,6 +48,9 @@ public:
     Q_PROPERTY(QString  portName        READ portName           WRITE setPortName           NOTIFY portNameChanged)
     Q_PROPERTY(QString  portDisplayName READ portDisplayName                                NOTIFY portDisplayNameChanged)
     Q_PROPERTY(bool     usbDirect       READ usbDirect          WRITE setUsbDirect          NOTIFY usbDirectChanged)        ///< true: direct usb connection to board
+    Q_PROPERTY(int      minReadBytes    READ minReadBytes       WRITE setMinReadBytes       NOTIFY minReadBytesChanged)     ///< Bytes to collect before passing them on, 0 for every read
+    Q_PROPERTY(int      readLatencyMsecs READ readLatencyMsecs  WRITE setReadLatencyMsecs   NOTIFY readLatencyMsecsChanged) ///< Longest wait for minReadBytes to arrive
+    Q_PROPERTY(bool     lowLatency      READ lowLatency         WRITE setLowLatency         NOTIFY lowLatencyChanged)       ///< true: ask the driver for low latency mode (Linux)
 
     int  baud() const        { return _baud; }
     int  dataBits() const    { return _dataBits; }
@@ -54,6 +58,9 @@ public:
     int  stopBits() const    { return _stopBits; }
     int  parity() const      { return _parity; }         ///< QSerialPort Enums
     bool usbDirect() const   { return _usbDirect; }
+    int  minReadBytes() const       { return _minReadBytes; }
+    int  readLatencyMsecs() const   { return _readLatencyMsecs; }
+    bool lowLatency() const         { return _lowLatency; }
 
     const QString portName          () const { return _portName; }
     const QString portDisplayName   () const { return _portDisplayName; }
@@ -65,6 +72,9 @@ public:
     void setParity          (int parity);               ///< QSerialPort Enums
     void setPortName        (const QString& portName);
     void setUsbDirect       (bool usbDirect);
+    void setMinReadBytes    (int minReadBytes);
+    void setReadLatencyMsecs(int readLatencyMsecs);
+    void setLowLatency      (bool lowLatency);
 
     static QStringList supportedBaudRates();
     static QString cleanPortDisplayname(const QString name);
@@ -87,6 +97,9 @@ signals:
     void portNameChanged        ();
     void portDisplayNameChanged ();
     void usbDirectChanged       (bool usbDirect);
+    void minReadBytesChanged    ();
+    void readLatencyMsecsChanged();
+    void lowLatencyChanged      ();
 
 private:
     int _baud;
@@ -97,6 +110,9 @@ private:
     QString _portName;
     QString _portDisplayName;
     bool _usbDirect;
+    int _minReadBytes = 0;
+    int _readLatencyMsecs = 0;
+    bool _lowLatency = false;
 };
 
 class SerialLink : public LinkInterface
@@ -131,6 +147,8 @@ private:
     void _emitLinkError     (const QString& errorMsg);
     bool _hardwareConnect   (QSerialPort::SerialPortError& error, QString& errorString);
     bool _isBootloader      (void);
+    bool _isTelemetryRadio  (void);
+    void _setLowLatency     (void);
 
     QSerialPort*            _port               = nullptr;
     quint64                 _bytesRead          = 0;
@@ -141,4 +159,5 @@ private:
     QMutex                  _stoppMutex;                    ///< Mutex for accessing _stopp
     QByteArray              _transmitBuffer;                ///< An internal buffer for receiving data from member functions and actually transmitting them via the serial port.
     const SerialConfiguration*    _serialConfig       = nullptr;
+    QTimer                  _readLatencyTimer;              ///< Passes on a partial read batch once the latency window closes
 };
@@ -0,0 +1,262 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SerialPortWatcher.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QHash>
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    #include <QtCore/QSocketNotifier>
+    #include <linux/netlink.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#elif defined(Q_OS_WIN)
+    #include <QtCore/QAbstractNativeEventFilter>
+    #include <QtCore/QCoreApplication>
+    #include <qt_windows.h>
+    #include <dbt.h>
+#elif defined(Q_OS_MACOS)
+    #include <CoreFoundation/CoreFoundation.h>
+    #include <IOKit/IOKitLib.h>
+    #include <IOKit/serial/IOSerialKeys.h>
+#endif
+
+QGC_LOGGING_CATEGORY(SerialPortWatcherLog, "qgc.comms.serialportwatcher")
+
+#ifdef Q_OS_WIN
+/// WM_DEVICECHANGE is broadcast to all top level windows, the filter sees it before Qt does
+class SerialPortWatcherEventFilter : public QAbstractNativeEventFilter
+{
+public:
+    explicit SerialPortWatcherEventFilter(SerialPortWatcher *watcher) : _watcher(watcher) {}
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message, qintptr *result) override
+    {
+        Q_UNUSED(result);
+
+        if (eventType == "windows_generic_MSG") {
+            const MSG *const msg = static_cast<const MSG*>(message);
+            if ((msg->message == WM_DEVICECHANGE) && ((msg->wParam == DBT_DEVICEARRIVAL) || (msg->wParam == DBT_DEVICEREMOVECOMPLETE))) {
+                _watcher->_hotplugEvent();
+            }
+        }
+        return false;
+    }
+
+private:
+    SerialPortWatcher *_watcher;
+};
+#endif
+
+SerialPortWatcher::SerialPortWatcher(QObject *parent)
+    : QObject(parent)
+{
+    _startHotplugNotifications();
+    qCDebug(SerialPortWatcherLog) << "hotplug notifications" << _hotplugSupported;
+}
+
+SerialPortWatcher::~SerialPortWatcher()
+{
+    _stopHotplugNotifications();
+}
+
+void SerialPortWatcher::update()
+{
+    if (!_hotplugSupported || _dirty || !_lastEnumerationTimer.isValid() || _lastEnumerationTimer.hasExpired(_fallbackPollMSecs)) {
+        refresh();
+    }
+}
+
+void SerialPortWatcher::refresh()
+{
+    _dirty = false;
+    _lastEnumerationTimer.start();
+
+    QHash<QString, const Port_t*> previousPorts;
+    for (const Port_t &port : _ports) {
+        previousPorts[port.info.systemLocation()] = &port;
+    }
+
+    QList<Port_t> ports;
+    bool changed = false;
+    for (const QGCSerialPortInfo &portInfo : QGCSerialPortInfo::availablePorts()) {
+        const Port_t *const previousPort = previousPorts.value(portInfo.systemLocation(), nullptr);
+
+        // A board which reboots from its bootloader shows up again on the same location with a different description
+        if (previousPort &&
+                (previousPort->info.vendorIdentifier() == portInfo.vendorIdentifier()) &&
+                (previousPort->info.productIdentifier() == portInfo.productIdentifier()) &&
+                (previousPort->info.description() == portInfo.description()) &&
+                (previousPort->info.serialNumber() == portInfo.serialNumber())) {
+            ports.append(*previousPort);
+            ports.last().info = portInfo;
+            continue;
+        }
+
+        Port_t port;
+        port.info = portInfo;
+        port.knownBoard = portInfo.getBoardInfo(port.boardType, port.boardName);
+        port.bootloader = port.knownBoard && portInfo.isBootloader();
+        qCDebug(SerialPortWatcherLog) << "port arrived" << portInfo.systemLocation() << portInfo.description() << port.boardName;
+        ports.append(port);
+        changed = true;
+    }
+
+    if (!changed && (ports.count() != _ports.count())) {
+        qCDebug(SerialPortWatcherLog) << "port removed";
+        changed = true;
+    }
+
+    _ports = ports;
+    if (changed) {
+        emit portsChanged();
+    }
+}
+
+void SerialPortWatcher::_hotplugEvent()
+{
+    qCDebug(SerialPortWatcherLog) << "hotplug event";
+    _dirty = true;
+}
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+
+void SerialPortWatcher::_startHotplugNotifications()
+{
+    // Kernel uevents are what udev itself listens to, so no libudev is needed
+    _ueventSocket = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (_ueventSocket < 0) {
+        qCWarning(SerialPortWatcherLog) << "uevent socket failed, polling ports";
+        return;
+    }
+
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1;  // Kernel uevents
+    if (::bind(_ueventSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        qCWarning(SerialPortWatcherLog) << "uevent bind failed, polling ports";
+        (void) ::close(_ueventSocket);
+        _ueventSocket = -1;
+        return;
+    }
+
+    _ueventNotifier = new QSocketNotifier(_ueventSocket, QSocketNotifier::Read, this);
+    (void) connect(_ueventNotifier, &QSocketNotifier::activated, this, [this]() {
+        // Each message is "action@devpath" followed by null separated KEY=VALUE pairs
+        char buffer[4096];
+        ssize_t length;
+        while ((length = ::recv(_ueventSocket, buffer, sizeof(buffer), 0)) > 0) {
+            if (QByteArrayView(buffer, length).contains(QByteArrayView("SUBSYSTEM=tty"))) {
+                _hotplugEvent();
+            }
+        }
+    });
+    _hotplugSupported = true;
+}
+
+void SerialPortWatcher::_stopHotplugNotifications()
+{
+    if (_ueventSocket >= 0) {
+        delete _ueventNotifier;
+        _ueventNotifier = nullptr;
+        (void) ::close(_ueventSocket);
+        _ueventSocket = -1;
+    }
+}
+
+#elif defined(Q_OS_WIN)
+
+void SerialPortWatcher::_startHotplugNotifications()
+{
+    _eventFilter = new SerialPortWatcherEventFilter(this);
+    QCoreApplication::instance()->installNativeEventFilter(_eventFilter);
+    _hotplugSupported = true;
+}
+
+void SerialPortWatcher::_stopHotplugNotifications()
+{
+    if (_eventFilter) {
+        QCoreApplication::instance()->removeNativeEventFilter(_eventFilter);
+        delete _eventFilter;
+        _eventFilter = nullptr;
+    }
+}
+
+#elif defined(Q_OS_MACOS)
+
+void SerialPortWatcher::_ioKitCallback(void *refcon, unsigned int iterator)
+{
+    // The iterator has to be drained to arm the notification again
+    io_object_t service;
+    while ((service = IOIteratorNext(iterator))) {
+        (void) IOObjectRelease(service);
+    }
+    static_cast<SerialPortWatcher*>(refcon)->_hotplugEvent();
+}
+
+void SerialPortWatcher::_startHotplugNotifications()
+{
+    IONotificationPortRef notificationPort = IONotificationPortCreate(MACH_PORT_NULL);
+    if (!notificationPort) {
+        qCWarning(SerialPortWatcherLog) << "IONotificationPortCreate failed, polling ports";
+        return;
+    }
+    _ioNotificationPort = notificationPort;
+    CFRunLoopAddSource(CFRunLoopGetMain(), IONotificationPortGetRunLoopSource(notificationPort), kCFRunLoopDefaultMode);
+
+    // Each call consumes a reference to the matching dictionary
+    const kern_return_t arrivalResult = IOServiceAddMatchingNotification(notificationPort, kIOFirstMatchNotification, IOServiceMatching(kIOSerialBSDServiceValue), _ioKitCallback, this, &_ioArrivalIterator);
+    const kern_return_t removalResult = IOServiceAddMatchingNotification(notificationPort, kIOTerminatedNotification, IOServiceMatching(kIOSerialBSDServiceValue), _ioKitCallback, this, &_ioRemovalIterator);
+    if ((arrivalResult != KERN_SUCCESS) || (removalResult != KERN_SUCCESS)) {
+        qCWarning(SerialPortWatcherLog) << "IOServiceAddMatchingNotification failed, polling ports";
+        _stopHotplugNotifications();
+        return;
+    }
+
+    // Drain the existing ports, they are picked up by the first enumeration
+    for (const io_iterator_t iterator : { _ioArrivalIterator, _ioRemovalIterator }) {
+        io_object_t service;
+        while ((service = IOIteratorNext(iterator))) {
+            (void) IOObjectRelease(service);
+        }
+    }
+    _hotplugSupported = true;
+}
+
+void SerialPortWatcher::_stopHotplugNotifications()
+{
+    if (_ioArrivalIterator) {
+        (void) IOObjectRelease(_ioArrivalIterator);
+        _ioArrivalIterator = 0;
+    }
+    if (_ioRemovalIterator) {
+        (void) IOObjectRelease(_ioRemovalIterator);
+        _ioRemovalIterator = 0;
+    }
+    if (_ioNotificationPort) {
+        IONotificationPortDestroy(static_cast<IONotificationPortRef>(_ioNotificationPort));
+        _ioNotificationPort = nullptr;
+    }
+    _hotplugSupported = false;
+}
+
+#else
+
+void SerialPortWatcher::_startHotplugNotifications()
+{
+    // Android and iOS poll on each update
+}
+
+void SerialPortWatcher::_stopHotplugNotifications()
+{
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCSerialPortInfo.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+
+Q_DECLARE_LOGGING_CATEGORY(SerialPortWatcherLog)
+
+class QSocketNotifier;
+class SerialPortWatcherEventFilter;
+
+/// Caches the serial port enumeration. The ports are only enumerated again when the operating system signals
+/// that a device arrived or went away (uevents on Linux, WM_DEVICECHANGE on Windows, IOKit on macOS), with a
+/// slow poll as a fallback. Where there are no hotplug notifications every update enumerates the ports.
+///
+/// The board type of a port is detected once when the port shows up, not on each enumeration.
+class SerialPortWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SerialPortWatcher(QObject *parent = nullptr);
+    ~SerialPortWatcher();
+
+    struct Port_t {
+        QGCSerialPortInfo info;
+        bool knownBoard = false;    ///< true: boardType and boardName are valid
+        QGCSerialPortInfo::BoardType_t boardType = QGCSerialPortInfo::BoardTypeUnknown;
+        QString boardName;
+        bool bootloader = false;
+    };
+
+    /// @return true: the operating system signals port changes
+    bool hotplugSupported() const { return _hotplugSupported; }
+
+    /// Ports as of the last enumeration
+    const QList<Port_t> &ports() const { return _ports; }
+
+    /// Enumerates the ports if they may have changed since the last enumeration
+    void update();
+
+    /// Enumerates the ports
+    void refresh();
+
+signals:
+    /// A port arrived or went away
+    void portsChanged();
+
+private:
+    friend class SerialPortWatcherEventFilter;
+
+    void _hotplugEvent();
+    void _startHotplugNotifications();
+    void _stopHotplugNotifications();
+
+    QList<Port_t> _ports;
+    bool _hotplugSupported = false;
+    bool _dirty = true;
+    QElapsedTimer _lastEnumerationTimer;
+
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+    int _ueventSocket = -1;
+    QSocketNotifier *_ueventNotifier = nullptr;
+#elif defined(Q_OS_WIN)
+    SerialPortWatcherEventFilter *_eventFilter = nullptr;
+#elif defined(Q_OS_MACOS)
+    static void _ioKitCallback(void *refcon, unsigned int iterator);
+    void *_ioNotificationPort = nullptr;
+    unsigned int _ioArrivalIterator = 0;
+    unsigned int _ioRemovalIterator = 0;
+#endif
+
+    static constexpr int _fallbackPollMSecs = 10000;   ///< Full enumeration interval even with hotplug notifications
+};
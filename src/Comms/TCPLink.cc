@@ -9,10 +9,15 @@
 
 #include "TCPLink.h"
 #include "DeviceInfo.h"
+#include "QGC.h"
+#include "QGCLoggingCategory.h"
 
 #include <QtCore/QList>
+#include <QtCore/QRandomGenerator>
 #include <QtNetwork/QTcpSocket>
-#include <QtTest/QSignalSpy>
+
+QGC_LOGGING_CATEGORY(TCPLinkLog, "qgc.comms.tcplink")
+QGC_LOGGING_CATEGORY(TCPLinkVerboseLog, "qgc.comms.tcplink:verbose")
 
 TCPLink::TCPLink(SharedLinkConfigurationPtr& config)
     : LinkInterface(config)
@@ -21,6 +26,13 @@ TCPLink::TCPLink(SharedLinkConfigurationPtr& config)
     , _socketIsConnected(false)
 {
     Q_ASSERT(_tcpConfig);
+
+    _connectTimer.setSingleShot(true);
+    _connectTimer.setInterval(_connectTimeoutMsecs);
+    (void) connect(&_connectTimer, &QTimer::timeout, this, &TCPLink::_connectTimeout);
+
+    _reconnectTimer.setSingleShot(true);
+    (void) connect(&_reconnectTimer, &QTimer::timeout, this, &TCPLink::_reconnect);
 }
 
 TCPLink::~TCPLink()
@@ -28,38 +40,22 @@ TCPLink::~TCPLink()
     disconnect();
 }
 
-#ifdef TCPLINK_READWRITE_DEBUG
-void TCPLink::_writeDebugBytes(const QByteArray data)
+/// Hex dump of the traffic, only formatted when the verbose log is enabled
+void TCPLink::_logBytes(const char* direction, const QByteArray& data)
 {
-    QString bytes;
-    QString ascii;
-    for (int i=0, size = data.size(); i<size; i++)
-    {
-        unsigned char v = data[i];
-        bytes.append(QString::asprintf("%02x ", v));
-        if (data[i] > 31 && data[i] < 127)
-        {
-            ascii.append(data[i]);
-        }
-        else
-        {
-            ascii.append(219);
-        }
+    if (!TCPLinkVerboseLog().isDebugEnabled()) {
+        return;
     }
-    qDebug() << "Sent" << size << "bytes to" << _tcpConfig->host() << ":" << _tcpConfig->port() << "data:";
-    qDebug() << bytes;
-    qDebug() << "ASCII:" << ascii;
+
+    qCDebug(TCPLinkVerboseLog) << direction << data.size() << "bytes" << _tcpConfig->host() << _tcpConfig->port() << data.toHex(' ');
 }
-#endif
 
 void TCPLink::_writeBytes(const QByteArray &data)
 {
-#ifdef TCPLINK_READWRITE_DEBUG
-    _writeDebugBytes(data);
-#endif
-
-    if (_socket) {
-        _socket->write(data);
+    // Bytes queued while the link reconnects are dropped, MAVLink retries what matters
+    if (_socket && _socketIsConnected) {
+        _logBytes("Sent", data);
+        (void) _socket->write(data);
         emit bytesSent(this, data);
     }
 }
@@ -67,25 +63,32 @@ void TCPLink::_writeBytes(const QByteArray &data)
 void TCPLink::_readBytes()
 {
     if (_socket) {
-        qint64 byteCount = _socket->bytesAvailable();
-        if (byteCount)
-        {
-            QByteArray buffer;
-            buffer.resize(byteCount);
-            _socket->read(buffer.data(), buffer.size());
-            emit bytesReceived(this, buffer);
-#ifdef TCPLINK_READWRITE_DEBUG
-            writeDebugBytes(buffer.data(), buffer.size());
-#endif
+        // Everything which has arrived is passed on in one batch
+        const qint64 byteCount = _socket->bytesAvailable();
+        if (byteCount > 0) {
+            const quint64 timestampUsecs = QGC::utcTimeUsecs();
+            QByteArray& buffer = _readBuffer(byteCount);
+            const qint64 bytesRead = _socket->read(buffer.data(), buffer.size());
+            if (bytesRead <= 0) {
+                return;
+            }
+            if (bytesRead < buffer.size()) {
+                buffer.resize(bytesRead);
+            }
+            _logBytes("Received", buffer);
+            emit bytesReceived(this, buffer, timestampUsecs);
         }
     }
 }
 
 void TCPLink::disconnect(void)
 {
+    _connectTimer.stop();
+    _reconnectTimer.stop();
+
     if (_socket) {
-        // This prevents stale signal from calling the link after it has been deleted
-        QObject::disconnect(_socket, &QIODevice::readyRead, this, &TCPLink::_readBytes);
+        // This prevents stale signals from calling the link after it has been deleted
+        (void) _socket->disconnect(this);
         _socketIsConnected = false;
         _socket->disconnectFromHost(); // Disconnect tcp
         _socket->deleteLater(); // Make sure delete happens on correct thread
@@ -108,34 +111,93 @@ bool TCPLink::_hardwareConnect()
 {
     Q_ASSERT(_socket == nullptr);
     _socket = new QTcpSocket();
-    QObject::connect(_socket, &QIODevice::readyRead, this, &TCPLink::_readBytes);
+    (void) QObject::connect(_socket, &QIODevice::readyRead, this, &TCPLink::_readBytes);
+    (void) QObject::connect(_socket, &QAbstractSocket::connected, this, &TCPLink::_socketConnected);
+    (void) QObject::connect(_socket, &QAbstractSocket::disconnected, this, &TCPLink::_socketDisconnected);
+    (void) QObject::connect(_socket, &QAbstractSocket::errorOccurred, this, &TCPLink::_socketError);
+
+    _reconnectAttempts = 0;
+    _errorReported = false;
+    _connectToHost();
+
+    return true;
+}
 
-    QSignalSpy errorSpy(_socket, &QAbstractSocket::errorOccurred);
-    QObject::connect(_socket, &QAbstractSocket::errorOccurred, this, &TCPLink::_socketError);
+void TCPLink::_connectToHost(void)
+{
+    qCDebug(TCPLinkLog) << "Connecting to" << _tcpConfig->host() << _tcpConfig->port() << "attempt" << (_reconnectAttempts + 1);
 
     _socket->connectToHost(_tcpConfig->host(), _tcpConfig->port());
+    _connectTimer.start();
+}
 
-    // Give the socket a second to connect to the other side otherwise error out
-    if (!_socket->waitForConnected(1000))
-    {
-        // Whether a failed connection emits an error signal or not is platform specific.
-        // So in cases where it is not emitted, we emit one ourselves.
-        if (errorSpy.count() == 0) {
-            emit communicationError(tr("Link Error"), tr("Error on link %1. Connection failed").arg(_config->name()));
-        }
-        delete _socket;
-        _socket = nullptr;
-        return false;
-    }
+void TCPLink::_socketConnected(void)
+{
+    _connectTimer.stop();
+    _reconnectTimer.stop();
+
+    // MAVLink messages are small and latency sensitive, and the writes of each wakeup are already joined into one
+    // buffer, so Nagle's algorithm would only hold them back waiting for acks
+    _socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    // Detects a peer which went away without closing the connection, such as a companion computer losing power
+    _socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+
+    qCDebug(TCPLinkLog) << "Connected to" << _tcpConfig->host() << _tcpConfig->port();
+
+    _reconnectAttempts = 0;
+    _errorReported = false;
     _socketIsConnected = true;
     emit connected();
-    return true;
+}
+
+void TCPLink::_socketDisconnected(void)
+{
+    _scheduleReconnect(tr("Connection closed by %1").arg(_tcpConfig->host()));
 }
 
 void TCPLink::_socketError(QAbstractSocket::SocketError socketError)
 {
     Q_UNUSED(socketError);
-    emit communicationError(tr("Link Error"), tr("Error on link %1. Error on socket: %2.").arg(_config->name()).arg(_socket->errorString()));
+    _scheduleReconnect(_socket->errorString());
+}
+
+void TCPLink::_connectTimeout(void)
+{
+    _scheduleReconnect(tr("Connection timed out"));
+}
+
+void TCPLink::_scheduleReconnect(const QString& reason)
+{
+    // A failure raises an error and a disconnect, or a timeout and an error, which only count once
+    if (!_socket || _reconnectTimer.isActive()) {
+        return;
+    }
+
+    _connectTimer.stop();
+    _socketIsConnected = false;
+
+    if (!_errorReported) {
+        _errorReported = true;
+        emit communicationError(tr("Link Error"), tr("Error on link %1. %2. Reconnecting.").arg(_config->name(), reason));
+    }
+
+    // Exponential backoff with jitter, so several links to one host which went away do not retry in lockstep
+    const int backoffMsecs = qMin(_maxReconnectMsecs, _minReconnectMsecs << qMin(_reconnectAttempts, 16));
+    const int delayMsecs = backoffMsecs - QRandomGenerator::global()->bounded(backoffMsecs / 4 + 1);
+    _reconnectAttempts++;
+
+    qCDebug(TCPLinkLog) << "Reconnecting in" << delayMsecs << "ms:" << reason;
+    _reconnectTimer.start(delayMsecs);
+
+    // Stops an attempt which timed out. The timer is already running, so the signals this raises are ignored.
+    _socket->abort();
+}
+
+void TCPLink::_reconnect(void)
+{
+    if (_socket) {
+        _connectToHost();
+    }
 }
 
 /**
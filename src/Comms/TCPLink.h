@@ -15,9 +15,12 @@
 
 #include <QtCore/QString>
 #include <QtCore/QMutex>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
 #include <QtNetwork/QAbstractSocket>
 
-//#define TCPLINK_READWRITE_DEBUG   // Use to debug data reads/writes
+Q_DECLARE_LOGGING_CATEGORY(TCPLinkLog)
+Q_DECLARE_LOGGING_CATEGORY(TCPLinkVerboseLog)
 
 class TCPLinkTest;
 class LinkManager;
@@ -59,6 +62,8 @@ private:
     quint16         _port;
 };
 
+/// Connects without blocking the thread it runs on. A connection which fails or is lost is retried with exponential
+/// backoff until the link is disconnected, so a companion computer or router which restarts is picked up again.
 class TCPLink : public LinkInterface
 {
     Q_OBJECT
@@ -76,8 +81,12 @@ public:
     bool isSecureConnection (void) override;
 
 private slots:
-    void _socketError   (QAbstractSocket::SocketError socketError);
-    void _readBytes     (void);
+    void _socketConnected   (void);
+    void _socketDisconnected(void);
+    void _socketError       (QAbstractSocket::SocketError socketError);
+    void _readBytes         (void);
+    void _connectTimeout    (void);
+    void _reconnect         (void);
 
     // LinkInterface overrides
     void _writeBytes(const QByteArray &data) override;
@@ -87,13 +96,21 @@ private:
     bool _connect(void) override;
 
     bool _hardwareConnect   (void);
-#ifdef TCPLINK_READWRITE_DEBUG
-    void _writeDebugBytes   (const QByteArray data);
-#endif
+    void _connectToHost     (void);
+    void _scheduleReconnect (const QString& reason);
+    void _logBytes          (const char* direction, const QByteArray& data);
 
     const TCPConfiguration* _tcpConfig;
     QTcpSocket*       _socket;
     bool              _socketIsConnected;
+    int               _reconnectAttempts    = 0;    ///< Failed attempts since the last connection, scales the backoff
+    bool              _errorReported        = false;///< Only the first failure of a reconnect sequence is reported
+    QTimer            _connectTimer;                ///< Gives up on a connection attempt the OS would keep trying for much longer
+    QTimer            _reconnectTimer;
+
+    static constexpr int _connectTimeoutMsecs   = 1000;
+    static constexpr int _minReconnectMsecs     = 250;
+    static constexpr int _maxReconnectMsecs     = 10000;
 
     quint64 _bitsSentTotal;
     quint64 _bitsSentCurrent;
@@ -12,14 +12,18 @@
 #include "SettingsManager.h"
 #include "AutoConnectSettings.h"
 #include "DeviceInfo.h"
+#include "QGC.h"
+#include "QGCTrace.h"
+#include "QGCLoggingCategory.h"
 
 #include <QtCore/QList>
-#include <QtCore/QMutexLocker>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QNetworkInterface>
 #include <QtNetwork/QHostInfo>
 #include <QtNetwork/QUdpSocket>
 
+QGC_LOGGING_CATEGORY(UDPLinkLog, "qgc.comms.udplink")
+
 static bool is_ip(const QString& address)
 {
     int a,b,c,d;
@@ -75,9 +79,9 @@ UDPLink::UDPLink(SharedLinkConfigurationPtr& config)
     }
     auto allAddresses = QNetworkInterface::allAddresses();
     for (int i=0; i<allAddresses.count(); i++) {
-        QHostAddress &address = allAddresses[i];
-        _localAddresses.append(QHostAddress(address));
+        _localAddresses.insert(allAddresses[i]);
     }
+    _sessionTimer.start();
     moveToThread(this);
 }
 
@@ -86,9 +90,6 @@ UDPLink::~UDPLink()
     disconnect();
     // Tell the thread to exit
     _running = false;
-    // Clear client list
-    qDeleteAll(_sessionTargets);
-    _sessionTargets.clear();
     quit();
     // Wait for it to exit
     wait();
@@ -106,7 +107,7 @@ void UDPLink::run()
     }
 }
 
-bool UDPLink::_isIpLocal(const QHostAddress& add)
+bool UDPLink::_isIpLocal(const QHostAddress& add) const
 {
     // In simulation and testing setups the vehicle and the GCS can be
     // running on the same host. This leads to packets arriving through
@@ -120,16 +121,29 @@ bool UDPLink::_isIpLocal(const QHostAddress& add)
     // IP address in string representation matches the source IP address
     //
     // On Windows, this is a very expensive call only Redmond would know
-    // why. As such, we make it once and keep the list locally. If a new
-    // interface shows up after we start, it won't be on this list.
-    for (int i=0; i<_localAddresses.count(); i++) {
-        QHostAddress &address = _localAddresses[i];
-        if (address == add) {
-            // This is a local address of the same host
-            return true;
+    // why. As such, we make it once and keep the set locally. If a new
+    // interface shows up after we start, it won't be in this set.
+    return _localAddresses.contains(add);
+}
+
+/// Drops session targets which haven't sent anything for a while, so senders which come and go (or a
+/// port scanner) can't grow the table without bounds. Session targets are only ever touched from the
+/// link thread, so no locking is needed.
+void UDPLink::_pruneSessionTargets(qint64 nowMsecs)
+{
+    if (nowMsecs - _lastSessionPruneMsecs < _sessionTargetPruneIntervalMsecs) {
+        return;
+    }
+    _lastSessionPruneMsecs = nowMsecs;
+
+    for (auto it = _sessionTargets.begin(); it != _sessionTargets.end(); ) {
+        if (nowMsecs - it.value() > _sessionTargetTimeoutMsecs) {
+            qCDebug(UDPLinkLog) << "Removing stale target" << it.key().address << it.key().port;
+            it = _sessionTargets.erase(it);
+        } else {
+            ++it;
         }
     }
-    return false;
 }
 
 void UDPLink::_writeBytes(const QByteArray &data)
@@ -139,19 +153,19 @@ void UDPLink::_writeBytes(const QByteArray &data)
     }
     emit bytesSent(this, data);
 
-    QMutexLocker locker(&_sessionTargetsMutex);
+    _pruneSessionTargets(_sessionTimer.elapsed());
 
     // Send to all manually targeted systems
     for (int i=0; i<_udpConfig->targetHosts().count(); i++) {
         UDPCLient* target = _udpConfig->targetHosts()[i];
         // Skip it if it's part of the session clients below
-        if(!contains_target(_sessionTargets, target->address, target->port)) {
+        if(!_sessionTargets.contains(*target)) {
             _writeDataGram(data, target);
         }
     }
     // Send to all connected systems
-    for(UDPCLient* target: _sessionTargets) {
-        _writeDataGram(data, target);
+    for (auto it = _sessionTargets.cbegin(); it != _sessionTargets.cend(); ++it) {
+        _writeDataGram(data, &it.key());
     }
 }
 
@@ -165,48 +179,84 @@ void UDPLink::_writeDataGram(const QByteArray data, const UDPCLient* target)
 
 void UDPLink::readBytes()
 {
+    QGC_TRACE_SCOPE("UDPLink::readBytes");
+
     if (!_socket) {
         return;
     }
-    QByteArray databuffer;
+    // Datagrams are read straight into the tail of a pooled batch buffer which is then handed over to the
+    // protocol layer as is. Since QByteArray is implicitly shared the queued signal doesn't copy the data, and
+    // the buffer keeps its capacity for the next batch once the protocol layer has released it.
+    QByteArray *databuffer = &_receiveBuffer();
+    // Each batch is stamped with the time its first datagram was read
+    quint64 batchTimestampUsecs = 0;
+    // A single timestamp per read is plenty given the resolution the session targets are aged at
+    const qint64 nowMsecs = _sessionTimer.elapsed();
     while (_socket->hasPendingDatagrams())
     {
-        QByteArray datagram;
-        datagram.resize(_socket->pendingDatagramSize());
+        const qint64 datagramSize = _socket->pendingDatagramSize();
+        if (datagramSize < 0) {
+            break;
+        }
+        const qsizetype offset = databuffer->size();
+        if (offset == 0) {
+            batchTimestampUsecs = QGC::utcTimeUsecs();
+        }
+        databuffer->resize(offset + datagramSize);
         QHostAddress sender;
         quint16 senderPort;
         // If the other end is reset then it will still report data available,
         // but will fail on the readDatagram call
-        qint64 slen = _socket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+        qint64 slen = _socket->readDatagram(databuffer->data() + offset, datagramSize, &sender, &senderPort);
         if (slen == -1) {
+            databuffer->resize(offset);
             break;
         }
-        databuffer.append(datagram);
+        databuffer->resize(offset + slen);
         //-- Wait a bit before sending it over
-        if (databuffer.size() > 10 * 1024) {
-            emit bytesReceived(this, databuffer);
-            databuffer.clear();
+        if (databuffer->size() > _receiveBatchSize) {
+            emit bytesReceived(this, *databuffer, batchTimestampUsecs);
+            databuffer = &_receiveBuffer();
         }
         // TODO: This doesn't validade the sender. Anything sending UDP packets to this port gets
         // added to the list and will start receiving datagrams from here. Even a port scanner
         // would trigger this.
         // Add host to broadcast list if not yet present, or update its port
-        QHostAddress asender = sender;
-        if(_isIpLocal(sender)) {
-            asender = QHostAddress(QString("127.0.0.1"));
-        }
-        QMutexLocker locker(&_sessionTargetsMutex);
-        if (!contains_target(_sessionTargets, asender, senderPort)) {
-            qDebug() << "Adding target" << asender << senderPort;
-            UDPCLient* target = new UDPCLient(asender, senderPort);
-            _sessionTargets.append(target);
+        UDPCLient target(_isIpLocal(sender) ? QHostAddress(QHostAddress::LocalHost) : sender, senderPort);
+        auto it = _sessionTargets.find(target);
+        if (it == _sessionTargets.end()) {
+            qCDebug(UDPLinkLog) << "Adding target" << target.address << target.port;
+            _sessionTargets.insert(target, nowMsecs);
+        } else {
+            it.value() = nowMsecs;
         }
-        locker.unlock();
     }
+    _pruneSessionTargets(nowMsecs);
     //-- Send whatever is left
-    if (databuffer.size()) {
-        emit bytesReceived(this, databuffer);
+    if (databuffer->size()) {
+        emit bytesReceived(this, *databuffer, batchTimestampUsecs);
+    }
+}
+
+/// @return An empty batch buffer from the pool. A buffer is free again once the protocol layer has dropped its
+///         reference to the batch it was emitted with, and is reused with the capacity it grew to.
+QByteArray &UDPLink::_receiveBuffer()
+{
+    for (QByteArray &buffer : _receiveBuffers) {
+        if (buffer.isNull() || buffer.isDetached()) {
+            buffer.resize(0);
+            return buffer;
+        }
+    }
+    if (_receiveBuffers.count() < _receiveBufferPoolSize) {
+        _receiveBuffers.append(QByteArray());
+        return _receiveBuffers.last();
     }
+    // Every buffer is still queued to the protocol layer, so they are dropped from the pool in turn
+    QByteArray &buffer = _receiveBuffers[_nextReplacedReceiveBuffer];
+    _nextReplacedReceiveBuffer = (_nextReplacedReceiveBuffer + 1) % _receiveBufferPoolSize;
+    buffer = QByteArray();
+    return buffer;
 }
 
 void UDPLink::disconnect(void)
@@ -14,7 +14,10 @@
 
 #include <QtCore/QString>
 #include <QtCore/QList>
-#include <QtCore/QMutex>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLoggingCategory>
 #include <QtCore/QByteArray>
 #include <QtNetwork/QHostAddress>
 
@@ -22,6 +25,8 @@
 #include <dns_sd.h>
 #endif
 
+Q_DECLARE_LOGGING_CATEGORY(UDPLinkLog)
+
 class LinkManager;
 class QUdpSocket;
 
@@ -37,8 +42,15 @@ public:
     {}
     QHostAddress    address;
     quint16         port;
+
+    bool operator==(const UDPCLient& other) const { return address == other.address && port == other.port; }
 };
 
+inline size_t qHash(const UDPCLient& client, size_t seed = 0)
+{
+    return qHashMulti(seed, client.address, client.port);
+}
+
 class UDPConfiguration : public LinkConfiguration
 {
     Q_OBJECT
@@ -115,9 +127,12 @@ private slots:
 private:
 
     // LinkInterface overrides
+    bool _coalesceWrites() const override { return false; }
     bool _connect(void) override;
 
-    bool _isIpLocal         (const QHostAddress& add);
+    bool _isIpLocal         (const QHostAddress& add) const;
+    void _pruneSessionTargets(qint64 nowMsecs);
+    QByteArray &_receiveBuffer(void);
     bool _hardwareConnect   (void);
     void _registerZeroconf  (uint16_t port, const std::string& regType);
     void _deregisterZeroconf(void);
@@ -127,12 +142,19 @@ private:
     QUdpSocket*         _socket;
     const UDPConfiguration*   _udpConfig;
     bool                _connectState;
-    QList<UDPCLient*>   _sessionTargets;
-    QMutex              _sessionTargetsMutex;
-    QList<QHostAddress> _localAddresses;
+    QHash<UDPCLient, qint64>    _sessionTargets;        ///< Senders seen on this link, value is the last time (msecs) a datagram arrived from it
+    QElapsedTimer               _sessionTimer;
+    qint64                      _lastSessionPruneMsecs = 0;
+    QSet<QHostAddress>          _localAddresses;
+    QList<QByteArray>           _receiveBuffers;            ///< Batch buffers reused once the protocol layer is done with them
+    qsizetype                   _nextReplacedReceiveBuffer = 0;
 #if defined(QGC_ZEROCONF_ENABLED)
     DNSServiceRef       _dnssServiceRef;
 #endif
 
     static constexpr const char* kZeroconfRegistration = "_qgroundcontrol._udp";
+    static constexpr qsizetype _receiveBatchSize    = 10 * 1024;                        ///< Received data is passed on once a batch exceeds this size
+    static constexpr qsizetype _receiveBufferPoolSize = 8;
+    static constexpr qint64 _sessionTargetTimeoutMsecs      = 30 * 1000;    ///< Session targets which haven't sent anything for this long are dropped
+    static constexpr qint64 _sessionTargetPruneIntervalMsecs = 5 * 1000;
 };
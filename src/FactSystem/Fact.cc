@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "Fact.h"
+#include "FactGroup.h"
 #include "FactValueSliderListModel.h"
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
@@ -85,12 +86,13 @@ const Fact& Fact::operator=(const Fact& other)
 {
     _name                       = other._name;
     _componentId                = other._componentId;
-    _rawValue                   = other._rawValue;
+    _rawValue                   = other.rawValue();
     _type                       = other._type;
     _sendValueChangedSignals    = other._sendValueChangedSignals;
     _deferredValueChangeSignal  = other._deferredValueChangeSignal;
     _valueSliderModel           = nullptr;
     _ignoreQGCRebootRequired    = other._ignoreQGCRebootRequired;
+    _invalidateCookedValueCache();
     if (_metaData && other._metaData) {
         *_metaData = *other._metaData;
     } else {
@@ -107,11 +109,11 @@ void Fact::forceSetRawValue(const QVariant& value)
         QString     errorString;
         
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
-            _rawValue.setValue(typedValue);
-            _sendValueChangedSignal(cookedValue());
+            _storeRawValue(typedValue);
+            _sendValueChangedSignal(_coalescing() ? QVariant() : cookedValue());
             //-- Must be in this order
             emit _containerRawValueChanged(rawValue());
-            emit rawValueChanged(_rawValue);
+            _sendRawValueChangedSignal();
         }
     } else {
         qWarning() << kMissingMetadata << name();
@@ -125,12 +127,12 @@ void Fact::setRawValue(const QVariant& value)
         QString     errorString;
         
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
-            if (typedValue != _rawValue) {
-                _rawValue.setValue(typedValue);
-                _sendValueChangedSignal(cookedValue());
+            if (typedValue != rawValue()) {
+                _storeRawValue(typedValue);
+                _sendValueChangedSignal(_coalescing() ? QVariant() : cookedValue());
                 //-- Must be in this order
                 emit _containerRawValueChanged(rawValue());
-                emit rawValueChanged(_rawValue);
+                _sendRawValueChangedSignal();
             }
         }
     } else {
@@ -138,6 +140,49 @@ void Fact::setRawValue(const QVariant& value)
     }
 }
 
+void Fact::_storeRawValue(const QVariant& value)
+{
+    _invalidateCookedValueCache();
+    _rawValue.setValue(value);
+    if (_valueBlockGroup) {
+        _valueBlockGroup->_valueBlock[_valueBlockIndex] = value.toDouble();
+    }
+}
+
+/// Converts the value stored in the FactGroup value block back to the type of this Fact using the same conversions as
+/// setRawValue
+QVariant Fact::_valueBlockRawValue(void) const
+{
+    const QVariant value(_valueBlockGroup->_valueBlock[_valueBlockIndex]);
+
+    switch (_type) {
+    case FactMetaData::valueTypeInt8:
+    case FactMetaData::valueTypeInt16:
+    case FactMetaData::valueTypeInt32:
+        return QVariant(value.toInt());
+    case FactMetaData::valueTypeInt64:
+        return QVariant(value.toLongLong());
+    case FactMetaData::valueTypeUint8:
+    case FactMetaData::valueTypeUint16:
+    case FactMetaData::valueTypeUint32:
+        return QVariant(value.toUInt());
+    case FactMetaData::valueTypeUint64:
+        return QVariant(value.toULongLong());
+    case FactMetaData::valueTypeFloat:
+        return QVariant(value.toFloat());
+    default:
+        return value;
+    }
+}
+
+/// Called by the FactGroup after it changed the value stored in the value block
+void Fact::_valueBlockChanged(void)
+{
+    _invalidateCookedValueCache();
+    _sendValueChangedSignal(_coalescing() ? QVariant() : cookedValue());
+    _sendRawValueChangedSignal();
+}
+
 void Fact::setCookedValue(const QVariant& value)
 {
     if (_metaData) {
@@ -175,14 +220,14 @@ void Fact::setEnumIndex(int index)
 
 void Fact::_containerSetRawValue(const QVariant& value)
 {
-    if(_rawValue != value) {
-        _rawValue = value;
-        _sendValueChangedSignal(cookedValue());
-        emit rawValueChanged(_rawValue);
+    if(rawValue() != value) {
+        _storeRawValue(value);
+        _sendValueChangedSignal(_coalescing() ? QVariant() : cookedValue());
+        _sendRawValueChangedSignal();
     }
 
     // This always need to be signalled in order to support forceSetRawValue usage and waiting for vehicleUpdated signal
-    emit vehicleUpdated(_rawValue);
+    emit vehicleUpdated(rawValue());
 }
 
 QString Fact::name(void) const
@@ -195,13 +240,36 @@ int Fact::componentId(void) const
     return _componentId;
 }
 
+/// Drops the cached cooked value and string if the meta data translation changed since they were cached. Unit
+/// settings changes come through here since they set new translators.
+void Fact::_checkCookedValueCache(void) const
+{
+    const quint32 generation = _metaData->translationGeneration();
+    if (generation != _cookedValueCacheGeneration) {
+        _cookedValueCacheGeneration = generation;
+        _cookedValueCached = false;
+        _cookedValueStringCached = false;
+    }
+}
+
 QVariant Fact::cookedValue(void) const
 {
     if (_metaData) {
-        return _metaData->rawTranslator()(_rawValue);
+        _checkCookedValueCache();
+        if (!_cookedValueCached) {
+            const FactMetaData::DoubleTranslator doubleTranslator = _metaData->rawDoubleTranslator();
+            if (doubleTranslator) {
+                const double rawDouble = _valueBlockGroup ? _valueBlockGroup->_valueBlock[_valueBlockIndex] : _rawValue.toDouble();
+                _cookedValue = QVariant(doubleTranslator(rawDouble));
+            } else {
+                _cookedValue = _metaData->rawTranslator()(rawValue());
+            }
+            _cookedValueCached = true;
+        }
+        return _cookedValue;
     } else {
         qWarning() << kMissingMetadata << name();
-        return _rawValue;
+        return rawValue();
     }
 }
 
@@ -240,7 +308,7 @@ int Fact::enumIndex(void)
                 index ++;
             }
             // Current value is not in list, add it manually
-            _metaData->addEnumInfo(tr("Unknown: %1").arg(rawValue().toString()), rawValue());
+            _ownMetaData()->addEnumInfo(tr("Unknown: %1").arg(rawValue().toString()), rawValue());
             emit enumsChanged();
             return index;
         }
@@ -273,7 +341,7 @@ QVariantList Fact::enumValues(void) const
 void Fact::setEnumInfo(const QStringList& strings, const QVariantList& values)
 {
     if (_metaData) {
-        _metaData->setEnumInfo(strings, values);
+        _ownMetaData()->setEnumInfo(strings, values);
         emit enumsChanged();
     } else {
         qWarning() << kMissingMetadata << name();
@@ -394,7 +462,16 @@ QString Fact::rawValueString(void) const
 
 QString Fact::cookedValueString(void) const
 {
-    return _variantToString(cookedValue(), decimalPlaces());
+    if (!_metaData) {
+        return _variantToString(cookedValue(), decimalPlaces());
+    }
+
+    _checkCookedValueCache();
+    if (!_cookedValueStringCached) {
+        _cookedValueString = _variantToString(cookedValue(), decimalPlaces());
+        _cookedValueStringCached = true;
+    }
+    return _cookedValueString;
 }
 
 QVariant Fact::rawDefaultValue(void) const
@@ -573,9 +650,20 @@ QString Fact::group(void) const
     }
 }
 
+/// Copies shared meta data before it is changed, so the Facts of other vehicles keep theirs
+FactMetaData* Fact::_ownMetaData(void)
+{
+    if (_metaData && _metaData->shared()) {
+        _metaData = new FactMetaData(*_metaData, this);
+        _invalidateCookedValueCache();
+    }
+    return _metaData;
+}
+
 void Fact::setMetaData(FactMetaData* metaData, bool setDefaultFromMetaData)
 {
     _metaData = metaData;
+    _invalidateCookedValueCache();
     if (setDefaultFromMetaData && metaData->defaultValueAvailable()) {
         setRawValue(rawDefaultValue());
     }
@@ -673,16 +761,33 @@ void Fact::_sendValueChangedSignal(QVariant value)
         emit valueChanged(value);
         _deferredValueChangeSignal = false;
     } else {
+        if (!_deferredValueChangeSignal && _coalescingGroup) {
+            _coalescingGroup->_markFactDirty(this);
+        }
         _deferredValueChangeSignal = true;
     }
 }
 
+void Fact::_sendRawValueChangedSignal(void)
+{
+    if (_coalescing()) {
+        // Only store the value, the notification goes out with the next FactGroup update
+        _deferredRawValueChangeSignal = true;
+    } else {
+        emit rawValueChanged(rawValue());
+    }
+}
+
 void Fact::sendDeferredValueChangedSignal(void)
 {
     if (_deferredValueChangeSignal) {
         _deferredValueChangeSignal = false;
         emit valueChanged(cookedValue());
     }
+    if (_deferredRawValueChangeSignal) {
+        _deferredRawValueChangeSignal = false;
+        emit rawValueChanged(rawValue());
+    }
 }
 
 QString Fact::enumOrValueString(void)
@@ -16,6 +16,7 @@
 #include "FactMetaData.h"
 
 class FactValueSliderListModel;
+class FactGroup;
 
 /// @brief A Fact is used to hold a single value within the system.
 class Fact : public QObject
@@ -80,7 +81,7 @@ public:
     Q_INVOKABLE QVariant clamp(const QString& cookedValue);
 
     QVariant        cookedValue             (void) const;   /// Value after translation
-    QVariant        rawValue                (void) const { return _rawValue; }  /// value prior to translation, careful
+    QVariant        rawValue                (void) const { return _valueBlockGroup ? _valueBlockRawValue() : _rawValue; }  /// value prior to translation, careful
     int             componentId             (void) const;
     int             decimalPlaces           (void) const;
     QVariant        rawDefaultValue         (void) const;
@@ -149,6 +150,12 @@ public:
     void clearDeferredValueChangeSignal(void) { _deferredValueChangeSignal = false; }
     void sendDeferredValueChangedSignal(void);
 
+    /// Lets the owning FactGroup coalesce change notifications. While signals are deferred the Fact only stores new
+    /// values from the vehicle and registers itself as dirty with the group on the first change. Both valueChanged and
+    /// rawValueChanged are then sent once by the group's next update.
+    ///     @param group FactGroup to register with, nullptr to turn coalescing off
+    void setCoalescingGroup(FactGroup* group) { _coalescingGroup = group; }
+
     // C++ methods
 
     /// Sets and sends new value to vehicle even if value is the same
@@ -159,6 +166,8 @@ public:
     ///     @param setDefaultFromMetaData true: set the fact value to the default specified in the meta data
     void setMetaData(FactMetaData* metaData, bool setDefaultFromMetaData = false);
     
+    /// Meta data may be shared with the Facts of other vehicles (see FactMetaData::shared), change it through
+    /// the Fact setters which copy it first
     FactMetaData* metaData() { return _metaData; }
 
     //-- Value coming from Vehicle. This does NOT send a _containerRawValueChanged signal.
@@ -194,11 +203,21 @@ private slots:
     void _checkForRebootMessaging(void);
 
 private:
-    void _init(void);
+    void        _init               (void);
+    void        _storeRawValue      (const QVariant& value);
+    QVariant    _valueBlockRawValue (void) const;
+    void        _valueBlockChanged  (void);
+    void        _checkCookedValueCache(void) const;
+    FactMetaData* _ownMetaData      (void);
     
 protected:
     QString _variantToString(const QVariant& variant, int decimalPlaces) const;
     void _sendValueChangedSignal(QVariant value);
+    void _sendRawValueChangedSignal(void);
+    bool _coalescing(void) const { return _coalescingGroup && !_sendValueChangedSignals; }
+
+    /// Must be called when the raw value changes without going through _storeRawValue
+    void _invalidateCookedValueCache(void) { _cookedValueCached = false; _cookedValueStringCached = false; }
 
     QString                     _name;
     int                         _componentId;
@@ -209,6 +228,19 @@ protected:
     bool                        _deferredValueChangeSignal;
     FactValueSliderListModel*   _valueSliderModel;
     bool                        _ignoreQGCRebootRequired;
+    FactGroup*                  _coalescingGroup = nullptr;
+    bool                        _deferredRawValueChangeSignal = false;
+    FactGroup*                  _valueBlockGroup = nullptr;     ///< Group which stores the value, see FactGroup::_addValueBlockFact
+    int                         _valueBlockIndex = -1;
+
+    // Cooked value and string are only computed again when the raw value or the meta data translation changes
+    mutable QVariant            _cookedValue;
+    mutable QString             _cookedValueString;
+    mutable bool                _cookedValueCached = false;
+    mutable bool                _cookedValueStringCached = false;
+    mutable quint32             _cookedValueCacheGeneration = 0;    ///< FactMetaData::translationGeneration the cache was filled with
 
     static constexpr const char* kMissingMetadata = "Meta data pointer missing";
+
+    friend class FactGroup;
 };
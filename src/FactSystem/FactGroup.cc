@@ -10,8 +10,11 @@
 
 #include "FactGroup.h"
 
+#include <QtCore/QtNumeric>
 #include <QtQml/QQmlEngine>
 
+#include <utility>
+
 FactGroup::FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject* parent, bool ignoreCamelCase)
     : QObject(parent)
     , _updateRateMSecs(updateRateMsecs)
@@ -49,53 +52,65 @@ void FactGroup::_setupTimer()
 
 bool FactGroup::factExists(const QString& name)
 {
-    if (name.contains(".")) {
-        QStringList parts = name.split(".");
-        if (parts.count() != 2) {
+    if (_factLookupCache.contains(name)) {
+        return true;
+    }
+
+    const qsizetype separator = name.indexOf(QLatin1Char('.'));
+    if (separator != -1) {
+        if (name.indexOf(QLatin1Char('.'), separator + 1) != -1) {
             qWarning() << "Only single level of hierarchy supported";
             return false;
         }
 
-        FactGroup * factGroup = getFactGroup(parts[0]);
+        FactGroup * factGroup = getFactGroup(name.left(separator));
         if (!factGroup) {
-            qWarning() << "Unknown FactGroup" << parts[0];
+            qWarning() << "Unknown FactGroup" << name.left(separator);
             return false;
         }
 
-        return factGroup->factExists(parts[1]);
+        return factGroup->factExists(name.mid(separator + 1));
     }
 
-    QString camelCaseName = _ignoreCamelCase ? name : _camelCase(name);
-
-    return _nameToFactMap.contains(camelCaseName);
+    return _nameToFactMap.contains(_ignoreCamelCase ? name : _camelCase(name));
 }
 
 Fact* FactGroup::getFact(const QString& name)
 {
-    if (name.contains(".")) {
-        QStringList parts = name.split(".");
-        if (parts.count() != 2) {
+    // QML and the instrument values ask for the same names over and over, so resolved names are cached as given.
+    // Facts are never removed from a group, a cached pointer stays valid for the life of the group.
+    Fact* fact = _factLookupCache.value(name, nullptr);
+    if (fact) {
+        return fact;
+    }
+
+    const qsizetype separator = name.indexOf(QLatin1Char('.'));
+    if (separator != -1) {
+        if (name.indexOf(QLatin1Char('.'), separator + 1) != -1) {
             qWarning() << "Only single level of hierarchy supported";
             return nullptr;
         }
 
-        FactGroup * factGroup = getFactGroup(parts[0]);
+        FactGroup * factGroup = getFactGroup(name.left(separator));
         if (!factGroup) {
-            qWarning() << "Unknown FactGroup" << parts[0];
+            qWarning() << "Unknown FactGroup" << name.left(separator);
             return nullptr;
         }
 
-        return factGroup->getFact(parts[1]);
-    }
+        fact = factGroup->getFact(name.mid(separator + 1));
+    } else {
+        const QString camelCaseName = _ignoreCamelCase ? name : _camelCase(name);
 
-    Fact*   fact =          nullptr;
-    QString camelCaseName = _ignoreCamelCase ? name : _camelCase(name);
+        fact = _nameToFactMap.value(camelCaseName, nullptr);
+        if (fact) {
+            QQmlEngine::setObjectOwnership(fact, QQmlEngine::CppOwnership);
+        } else {
+            qWarning() << "Unknown Fact" << camelCaseName;
+        }
+    }
 
-    if (_nameToFactMap.contains(camelCaseName)) {
-        fact = _nameToFactMap[camelCaseName];
-        QQmlEngine::setObjectOwnership(fact, QQmlEngine::CppOwnership);
-    } else {
-        qWarning() << "Unknown Fact" << camelCaseName;
+    if (fact) {
+        _factLookupCache.insert(name, fact);
     }
 
     return fact;
@@ -103,12 +118,20 @@ Fact* FactGroup::getFact(const QString& name)
 
 FactGroup* FactGroup::getFactGroup(const QString& name)
 {
-    FactGroup*  factGroup = nullptr;
-    QString     camelCaseName = _ignoreCamelCase ? name : _camelCase(name);
+    FactGroup* factGroup = _factGroupLookupCache.value(name, nullptr);
+    if (factGroup) {
+        return factGroup;
+    }
 
-    if (_nameToFactGroupMap.contains(camelCaseName)) {
-        factGroup = _nameToFactGroupMap[camelCaseName];
+    const QString camelCaseName = _ignoreCamelCase ? name : _camelCase(name);
+
+    factGroup = _nameToFactGroupMap.value(camelCaseName, nullptr);
+    if (!factGroup) {
+        factGroup = _createFactGroupOnDemand(camelCaseName);
+    }
+    if (factGroup) {
         QQmlEngine::setObjectOwnership(factGroup, QQmlEngine::CppOwnership);
+        _factGroupLookupCache.insert(name, factGroup);
     } else {
         qWarning() << "Unknown FactGroup" << camelCaseName;
     }
@@ -124,6 +147,9 @@ void FactGroup::_addFact(Fact* fact, const QString& name)
     }
 
     fact->setSendValueChangedSignals(_updateRateMSecs == 0);
+    if (_coalescedUpdates && (_updateRateMSecs > 0)) {
+        fact->setCoalescingGroup(this);
+    }
     if (_nameToFactMetaDataMap.contains(name)) {
         fact->setMetaData(_nameToFactMetaDataMap[name], true /* setDefaultFromMetaData */);
     }
@@ -133,6 +159,43 @@ void FactGroup::_addFact(Fact* fact, const QString& name)
     emit factNamesChanged();
 }
 
+void FactGroup::_addValueBlockFact(Fact* fact, const QString& name)
+{
+    if (_nameToFactMap.contains(name)) {
+        qWarning() << "Duplicate Fact" << name;
+        return;
+    }
+
+    _addFact(fact, name);
+
+    fact->_valueBlockGroup = this;
+    fact->_valueBlockIndex = _valueBlock.count();
+    _valueBlock.append(fact->_rawValue.toDouble());
+    _valueBlockNames.append(name);
+}
+
+void FactGroup::_setValueBlockValue(Fact& fact, double value)
+{
+    Q_ASSERT(fact._valueBlockGroup == this);
+
+    // Same conversion as Fact::setRawValue, so changes are detected on the value of the Fact's type and an integer
+    // Fact doesn't signal for jitter below one. Values which don't convert are dropped as setRawValue does.
+    QVariant typedValue;
+    QString errorString;
+    if (!fact._metaData || !fact._metaData->convertAndValidateRaw(QVariant(value), true /* convertOnly */, typedValue, errorString)) {
+        return;
+    }
+    const double typedDouble = typedValue.toDouble();
+
+    double& storedValue = _valueBlock[fact._valueBlockIndex];
+    if ((storedValue == typedDouble) || (qIsNaN(storedValue) && qIsNaN(typedDouble))) {
+        return;
+    }
+    storedValue = typedDouble;
+
+    fact._valueBlockChanged();
+}
+
 void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
 {
     if (_nameToFactGroupMap.contains(name)) {
@@ -147,11 +210,29 @@ void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
 
 void FactGroup::_updateAllValues(void)
 {
+    if (_coalescedUpdates) {
+        _sendDirtyFacts();
+        return;
+    }
+
     for(Fact* fact: _nameToFactMap) {
         fact->sendDeferredValueChangedSignal();
     }
 }
 
+void FactGroup::_sendDirtyFacts(void)
+{
+    if (_dirtyFacts.isEmpty()) {
+        return;
+    }
+
+    // Signal handlers may set values again, those Facts are then picked up by the next update
+    const QList<Fact*> dirtyFacts = std::exchange(_dirtyFacts, {});
+    for (Fact* fact: dirtyFacts) {
+        fact->sendDeferredValueChangedSignal();
+    }
+}
+
 void FactGroup::setLiveUpdates(bool liveUpdates)
 {
     if (_updateTimer.interval() == 0) {
@@ -160,6 +241,8 @@ void FactGroup::setLiveUpdates(bool liveUpdates)
 
     if (liveUpdates) {
         _updateTimer.stop();
+        // Don't lose the changes still waiting for the next update
+        _updateAllValues();
     } else {
         _updateTimer.start();
     }
@@ -171,7 +254,14 @@ void FactGroup::setLiveUpdates(bool liveUpdates)
 
 QString FactGroup::_camelCase(const QString& text)
 {
-    return text[0].toLower() + text.right(text.length() - 1);
+    if (text.isEmpty() || !text[0].isUpper()) {
+        // Already camel case, shares the string instead of building a new one
+        return text;
+    }
+
+    QString camelCase = text;
+    camelCase[0] = camelCase[0].toLower();
+    return camelCase;
 }
 
 void FactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& /* message */)
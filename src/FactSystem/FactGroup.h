@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QStringList>
 #include <QtCore/QMap>
 #include <QtCore/QTimer>
@@ -51,9 +53,24 @@ public:
     bool        telemetryAvailable  (void) const { return _telemetryAvailable; }
     const QMap<QString, FactGroup*>& factGroups() const { return _nameToFactGroupMap; }
 
+    /// Current values of the Facts added with _addValueBlockFact, in the order given by valueBlockNames. The values are
+    /// contiguous so bulk consumers can take a snapshot of the whole group with a single copy.
+    const QList<double>&    valueBlock      (void) const { return _valueBlock; }
+    QStringList             valueBlockNames (void) const { return _valueBlockNames; }
+
     /// Allows a FactGroup to parse incoming messages and fill in values
     virtual void handleMessage(Vehicle* vehicle, mavlink_message_t& message);
 
+    /// Message ids which handleMessage consumes. Vehicle uses these to only deliver the messages a FactGroup is
+    /// interested in. The default of allMessageIds delivers everything.
+    virtual QList<uint32_t> handledMessageIds(void) const { return { allMessageIds }; }
+
+    static constexpr uint32_t allMessageIds = UINT32_MAX;
+
+    /// Number of messages Vehicle has delivered to handleMessage, for the Performance page
+    quint64 handledMessageCount (void) const { return _handledMessageCount; }
+    void    countHandledMessage (void) { _handledMessageCount++; }
+
 signals:
     void factNamesChanged           (void);
     void factGroupNamesChanged      (void);
@@ -68,6 +85,24 @@ protected:
     void _loadFromJsonArray     (const QJsonArray jsonArray);
     void _setTelemetryAvailable (bool telemetryAvailable);
 
+    /// Called by getFactGroup for a name which is not in the group. Groups which create sub groups on first use
+    /// override this to create and add the group now.
+    ///     @return The added group, nullptr if there is no group by that name
+    virtual FactGroup* _createFactGroupOnDemand(const QString& name) { Q_UNUSED(name); return nullptr; }
+
+    /// Coalesces value change notifications for high rate telemetry. Values coming from the vehicle are only stored
+    /// and each update sends valueChanged/rawValueChanged once, for the Facts which actually changed since the last
+    /// update. Must be called before the Facts are added.
+    void _setCoalescedUpdates   (bool coalescedUpdates) { _coalescedUpdates = coalescedUpdates; }
+
+    /// Adds a numeric Fact whose value is stored in the group's value block instead of in the Fact itself. The Fact
+    /// becomes a view onto its slot: handlers update it with _setValueBlockValue, which writes a double and leaves the
+    /// notifications to the Fact. Values must be representable as a double.
+    void _addValueBlockFact     (Fact* fact, const QString& name);
+
+    /// Updates the value of a Fact added with _addValueBlockFact
+    void _setValueBlockValue    (Fact& fact, double value);
+
     int  _updateRateMSecs;   ///< Update rate for Fact::valueChanged signals, 0: immediate update
 
     QMap<QString, Fact*>            _nameToFactMap;
@@ -76,10 +111,22 @@ protected:
     QStringList                     _factNames;
 
 private:
-    void    _setupTimer (void);
-    QString _camelCase  (const QString& text);
-
-    bool    _ignoreCamelCase    = false;
-    QTimer  _updateTimer;
-    bool    _telemetryAvailable = false;
+    void    _setupTimer     (void);
+    QString _camelCase      (const QString& text);
+    void    _markFactDirty  (Fact* fact) { _dirtyFacts.append(fact); }
+    void    _sendDirtyFacts (void);
+
+    bool            _ignoreCamelCase    = false;
+    QTimer          _updateTimer;
+    bool            _telemetryAvailable = false;
+    bool            _coalescedUpdates   = false;
+    QList<Fact*>    _dirtyFacts;        ///< Facts with pending notifications, only used with coalesced updates
+    QList<double>   _valueBlock;        ///< Values of the Facts added with _addValueBlockFact
+    quint64         _handledMessageCount = 0;
+    QStringList     _valueBlockNames;
+
+    QHash<QString, Fact*>       _factLookupCache;       ///< getFact results by the name as requested, including "group.fact" names
+    QHash<QString, FactGroup*>  _factGroupLookupCache;  ///< getFactGroup results by the name as requested
+
+    friend class Fact;
 };
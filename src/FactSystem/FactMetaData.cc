@@ -15,6 +15,8 @@
 
 #include <QtCore/QtMath>
 
+#include <atomic>
+
 // Built in translations for all Facts
 const FactMetaData::BuiltInTranslation_s FactMetaData::_rgBuiltInTranslations[] = {
     { "centi-degrees",  "deg",  FactMetaData::_centiDegreesToDegrees,                   FactMetaData::_degreesToCentiDegrees },
@@ -56,6 +58,18 @@ const FactMetaData::AppSettingsTranslation_s FactMetaData::_rgAppSettingsTransla
     { "g",      "lbs",      FactMetaData::UnitWeight,                UnitsSettings::WeightUnitsLbs,                FactMetaData::_gramsToPunds,                        FactMetaData::_poundsToGrams },
 };
 
+// Double only versions of the common raw translators. Cooked values which use them skip the QVariant conversions.
+const FactMetaData::DoubleTranslation_s FactMetaData::_rgDoubleTranslations[] = {
+    { FactMetaData::_centiDegreesToDegrees,                 FactMetaData::_centiDegreesToDegrees },
+    { FactMetaData::_radiansToDegrees,                      FactMetaData::_radiansToDegrees },
+    { FactMetaData::_normToPercent,                         FactMetaData::_normToPercent },
+    { FactMetaData::_metersToFeet,                          FactMetaData::_metersToFeet },
+    { FactMetaData::_metersPerSecondToMilesPerHour,         FactMetaData::_metersPerSecondToMilesPerHour },
+    { FactMetaData::_metersPerSecondToKilometersPerHour,    FactMetaData::_metersPerSecondToKilometersPerHour },
+    { FactMetaData::_metersPerSecondToKnots,                FactMetaData::_metersPerSecondToKnots },
+    { FactMetaData::_celsiusToFarenheit,                    FactMetaData::_celsiusToFarenheit },
+};
+
 FactMetaData::FactMetaData(QObject* parent)
     : QObject               (parent)
     , _type                 (valueTypeInt32)
@@ -150,6 +164,7 @@ const FactMetaData& FactMetaData::operator=(const FactMetaData& other)
     _cookedUnits            = other._cookedUnits;
     _rawTranslator          = other._rawTranslator;
     _cookedTranslator       = other._cookedTranslator;
+    _rawDoubleTranslator    = other._rawDoubleTranslator;
     _vehicleRebootRequired  = other._vehicleRebootRequired;
     _qgcRebootRequired      = other._qgcRebootRequired;
     _rawIncrement           = other._rawIncrement;
@@ -157,6 +172,7 @@ const FactMetaData& FactMetaData::operator=(const FactMetaData& other)
     _readOnly               = other._readOnly;
     _writeOnly              = other._writeOnly;
     _volatile               = other._volatile;
+    _translationChanged();
     return *this;
 }
 
@@ -629,6 +645,29 @@ void FactMetaData::setTranslators(Translator rawTranslator, Translator cookedTra
 {
     _rawTranslator = rawTranslator;
     _cookedTranslator = cookedTranslator;
+
+    _rawDoubleTranslator = nullptr;
+    for (const DoubleTranslation_s& doubleTranslation: _rgDoubleTranslations) {
+        if (doubleTranslation.rawTranslator == rawTranslator) {
+            _rawDoubleTranslator = doubleTranslation.rawDoubleTranslator;
+            break;
+        }
+    }
+
+    _translationChanged();
+}
+
+void FactMetaData::_translationChanged(void)
+{
+    _translationGeneration = _nextTranslationGeneration();
+    _cachedDecimalPlaces = kUnknownDecimalPlaces;
+}
+
+quint32 FactMetaData::_nextTranslationGeneration(void)
+{
+    // Meta data is also created on worker threads while parsing metadata json
+    static std::atomic<quint32> nextGeneration(1);
+    return nextGeneration++;
 }
 
 void FactMetaData::setBuiltInTranslator(void)
@@ -659,14 +698,24 @@ QVariant FactMetaData::_degreesToRadians(const QVariant& degrees)
     return QVariant(qDegreesToRadians(degrees.toDouble()));
 }
 
+double FactMetaData::_radiansToDegrees(double radians)
+{
+    return qRadiansToDegrees(radians);
+}
+
 QVariant FactMetaData::_radiansToDegrees(const QVariant& radians)
 {
-    return QVariant(qRadiansToDegrees(radians.toDouble()));
+    return QVariant(_radiansToDegrees(radians.toDouble()));
+}
+
+double FactMetaData::_centiDegreesToDegrees(double centiDegrees)
+{
+    return centiDegrees / 100.0;
 }
 
 QVariant FactMetaData::_centiDegreesToDegrees(const QVariant& centiDegrees)
 {
-    return QVariant(centiDegrees.toReal() / 100.0);
+    return QVariant(_centiDegreesToDegrees(centiDegrees.toDouble()));
 }
 
 QVariant FactMetaData::_degreesToCentiDegrees(const QVariant& degrees)
@@ -688,9 +737,14 @@ QVariant FactMetaData::_mavlinkGimbalDegreesToUserGimbalDegrees(const QVariant&
     return mavlinkGimbalDegrees.toDouble() * -1.0;
 }
 
+double FactMetaData::_metersToFeet(double meters)
+{
+    return meters * 1.0/constants.feetToMeters;
+}
+
 QVariant FactMetaData::_metersToFeet(const QVariant& meters)
 {
-    return QVariant(meters.toDouble() * 1.0/constants.feetToMeters);
+    return QVariant(_metersToFeet(meters.toDouble()));
 }
 
 QVariant FactMetaData::_feetToMeters(const QVariant& feet)
@@ -748,9 +802,14 @@ QVariant FactMetaData::_squareMilesToSquareMeters(const QVariant& squareMiles)
     return QVariant(squareMiles.toDouble() * 258999039.98855);
 }
 
+double FactMetaData::_metersPerSecondToMilesPerHour(double metersPerSecond)
+{
+    return (metersPerSecond * 1.0/constants.milesToMeters) * constants.secondsPerHour;
+}
+
 QVariant FactMetaData::_metersPerSecondToMilesPerHour(const QVariant& metersPerSecond)
 {
-    return QVariant((metersPerSecond.toDouble() * 1.0/constants.milesToMeters) * constants.secondsPerHour);
+    return QVariant(_metersPerSecondToMilesPerHour(metersPerSecond.toDouble()));
 }
 
 QVariant FactMetaData::_milesPerHourToMetersPerSecond(const QVariant& milesPerHour)
@@ -758,9 +817,14 @@ QVariant FactMetaData::_milesPerHourToMetersPerSecond(const QVariant& milesPerHo
     return QVariant((milesPerHour.toDouble() * constants.milesToMeters) / constants.secondsPerHour);
 }
 
+double FactMetaData::_metersPerSecondToKilometersPerHour(double metersPerSecond)
+{
+    return (metersPerSecond / 1000.0) * constants.secondsPerHour;
+}
+
 QVariant FactMetaData::_metersPerSecondToKilometersPerHour(const QVariant& metersPerSecond)
 {
-    return QVariant((metersPerSecond.toDouble() / 1000.0) * constants.secondsPerHour);
+    return QVariant(_metersPerSecondToKilometersPerHour(metersPerSecond.toDouble()));
 }
 
 QVariant FactMetaData::_kilometersPerHourToMetersPerSecond(const QVariant& kilometersPerHour)
@@ -768,9 +832,14 @@ QVariant FactMetaData::_kilometersPerHourToMetersPerSecond(const QVariant& kilom
     return QVariant((kilometersPerHour.toDouble() * 1000.0) / constants.secondsPerHour);
 }
 
+double FactMetaData::_metersPerSecondToKnots(double metersPerSecond)
+{
+    return metersPerSecond * constants.secondsPerHour / (1000.0 * constants.knotsToKPH);
+}
+
 QVariant FactMetaData::_metersPerSecondToKnots(const QVariant& metersPerSecond)
 {
-    return QVariant(metersPerSecond.toDouble() * constants.secondsPerHour / (1000.0 * constants.knotsToKPH));
+    return QVariant(_metersPerSecondToKnots(metersPerSecond.toDouble()));
 }
 
 QVariant FactMetaData::_knotsToMetersPerSecond(const QVariant& knots)
@@ -783,9 +852,14 @@ QVariant FactMetaData::_percentToNorm(const QVariant& percent)
     return QVariant(percent.toDouble() / 100.0);
 }
 
+double FactMetaData::_normToPercent(double normalized)
+{
+    return normalized * 100.0;
+}
+
 QVariant FactMetaData::_normToPercent(const QVariant& normalized)
 {
-    return QVariant(normalized.toDouble() * 100.0);
+    return QVariant(_normToPercent(normalized.toDouble()));
 }
 
 QVariant FactMetaData::_centimetersToInches(const QVariant& centimeters)
@@ -798,9 +872,14 @@ QVariant FactMetaData::_inchesToCentimeters(const QVariant& inches)
     return QVariant(inches.toDouble() * constants.inchesToCentimeters);
 }
 
+double FactMetaData::_celsiusToFarenheit(double celsius)
+{
+    return celsius * (9.0 / 5.0) + 32;
+}
+
 QVariant FactMetaData::_celsiusToFarenheit(const QVariant& celsius)
 {
-    return QVariant(celsius.toDouble() * (9.0 / 5.0) + 32);
+    return QVariant(_celsiusToFarenheit(celsius.toDouble()));
 }
 
 QVariant FactMetaData::_farenheitToCelsius(const QVariant& farenheit)
@@ -1139,6 +1218,10 @@ double FactMetaData::cookedIncrement(void) const
 
 int FactMetaData::decimalPlaces(void) const
 {
+    if (_cachedDecimalPlaces != kUnknownDecimalPlaces) {
+        return _cachedDecimalPlaces;
+    }
+
     int actualDecimalPlaces = kDefaultDecimalPlaces;
     int incrementDecimalPlaces = kUnknownDecimalPlaces;
 
@@ -1174,6 +1257,7 @@ int FactMetaData::decimalPlaces(void) const
         actualDecimalPlaces = _decimalPlaces;
     }
 
+    _cachedDecimalPlaces = actualDecimalPlaces;
     return actualDecimalPlaces;
 }
 
@@ -43,6 +43,7 @@ public:
     } ValueType_t;
 
     typedef QVariant (*Translator)(const QVariant& from);
+    typedef double (*DoubleTranslator)(double from);
 
     // Custom function to validate a cooked value.
     //  @return Error string for failed validation explanation to user. Empty string indicates no error.
@@ -149,6 +150,18 @@ public:
     Translator      rawTranslator           (void) const { return _rawTranslator; }
     Translator      cookedTranslator        (void) const { return _cookedTranslator; }
 
+    /// Double only version of the raw translator for the common unit conversions, nullptr for all others
+    DoubleTranslator rawDoubleTranslator    (void) const { return _rawDoubleTranslator; }
+
+    /// Changes each time the translators, decimal places or increment change. The numbers are unique across all meta
+    /// data, so a Fact can tell whether its cooked value cache is still good.
+    quint32         translationGeneration   (void) const { return _translationGeneration; }
+
+    /// true: The meta data is shared by the Facts of several vehicles, such as parameter meta data loaded once per
+    /// firmware version. Shared meta data must not be changed, Fact makes a copy of its own before it changes it.
+    bool            shared                  (void) const { return _shared; }
+    void            setShared               (bool shared) { _shared = shared; }
+
     /// Used to add new values to the bitmask lists after the meta data has been loaded
     void addBitmaskInfo(const QString& name, const QVariant& value);
 
@@ -158,7 +171,7 @@ public:
     /// Used to remove values from the enum lists after the meta data has been loaded
     void removeEnumInfo(const QVariant& value);
 
-    void setDecimalPlaces           (int decimalPlaces)                 { _decimalPlaces = decimalPlaces; }
+    void setDecimalPlaces           (int decimalPlaces)                 { _decimalPlaces = decimalPlaces; _translationChanged(); }
     void setRawDefaultValue         (const QVariant& rawDefaultValue);
     void setBitmaskInfo             (const QStringList& strings, const QVariantList& values);
     void setEnumInfo                (const QStringList& strings, const QVariantList& values);
@@ -172,7 +185,7 @@ public:
     void setRawUnits                (const QString& rawUnits);
     void setVehicleRebootRequired   (bool rebootRequired)               { _vehicleRebootRequired = rebootRequired; }
     void setQGCRebootRequired       (bool rebootRequired)               { _qgcRebootRequired = rebootRequired; }
-    void setRawIncrement            (double increment)                  { _rawIncrement = increment; }
+    void setRawIncrement            (double increment)                  { _rawIncrement = increment; _translationChanged(); }
     void setHasControl              (bool bValue)                       { _hasControl = bValue; }
     void setReadOnly                (bool bValue)                       { _readOnly = bValue; }
     void setWriteOnly               (bool bValue)                       { _writeOnly = bValue; }
@@ -254,11 +267,14 @@ private:
     static QVariant _defaultTranslator(const QVariant& from) { return from; }
     static QVariant _degreesToRadians(const QVariant& degrees);
     static QVariant _radiansToDegrees(const QVariant& radians);
+    static double   _radiansToDegrees(double radians);
     static QVariant _centiDegreesToDegrees(const QVariant& centiDegrees);
+    static double   _centiDegreesToDegrees(double centiDegrees);
     static QVariant _degreesToCentiDegrees(const QVariant& degrees);
     static QVariant _userGimbalDegreesToMavlinkGimbalDegrees(const QVariant& userGimbalDegrees);
     static QVariant _mavlinkGimbalDegreesToUserGimbalDegrees(const QVariant& mavlinkGimbalDegrees);
     static QVariant _metersToFeet(const QVariant& meters);
+    static double   _metersToFeet(double meters);
     static QVariant _feetToMeters(const QVariant& feet);
     static QVariant _squareMetersToSquareKilometers(const QVariant& squareMeters);
     static QVariant _squareKilometersToSquareMeters(const QVariant& squareKilometers);
@@ -271,16 +287,21 @@ private:
     static QVariant _squareMetersToSquareMiles(const QVariant& squareMeters);
     static QVariant _squareMilesToSquareMeters(const QVariant& squareMiles);
     static QVariant _metersPerSecondToMilesPerHour(const QVariant& metersPerSecond);
+    static double   _metersPerSecondToMilesPerHour(double metersPerSecond);
     static QVariant _milesPerHourToMetersPerSecond(const QVariant& milesPerHour);
     static QVariant _metersPerSecondToKilometersPerHour(const QVariant& metersPerSecond);
+    static double   _metersPerSecondToKilometersPerHour(double metersPerSecond);
     static QVariant _kilometersPerHourToMetersPerSecond(const QVariant& kilometersPerHour);
     static QVariant _metersPerSecondToKnots(const QVariant& metersPerSecond);
+    static double   _metersPerSecondToKnots(double metersPerSecond);
     static QVariant _knotsToMetersPerSecond(const QVariant& knots);
     static QVariant _percentToNorm(const QVariant& percent);
     static QVariant _normToPercent(const QVariant& normalized);
+    static double   _normToPercent(double normalized);
     static QVariant _centimetersToInches(const QVariant& centimeters);
     static QVariant _inchesToCentimeters(const QVariant& inches);
     static QVariant _celsiusToFarenheit(const QVariant& celsius);
+    static double   _celsiusToFarenheit(double celsius);
     static QVariant _farenheitToCelsius(const QVariant& farenheit);
     static QVariant _kilogramsToGrams(const QVariant& kg);
     static QVariant _ouncesToGrams(const QVariant& oz);
@@ -338,7 +359,14 @@ private:
     bool            _readOnly;
     bool            _writeOnly;
     bool            _volatile;
+    bool            _shared = false;            ///< Not copied, a copy is owned by whoever made it
     CustomCookedValidator _customCookedValidator = nullptr;
+    DoubleTranslator _rawDoubleTranslator = nullptr;
+    quint32         _translationGeneration = _nextTranslationGeneration();
+    mutable int     _cachedDecimalPlaces = kUnknownDecimalPlaces;   ///< decimalPlaces() result, kUnknownDecimalPlaces: not computed yet
+
+    void _translationChanged(void);
+    static quint32 _nextTranslationGeneration(void);
 
     // Exact conversion constants
     static constexpr const struct UnitConsts_s {
@@ -362,6 +390,13 @@ private:
 
     static const AppSettingsTranslation_s _rgAppSettingsTranslations[];
 
+    struct DoubleTranslation_s {
+        Translator          rawTranslator;
+        DoubleTranslator    rawDoubleTranslator;
+    };
+
+    static const DoubleTranslation_s _rgDoubleTranslations[];
+
     static constexpr const char* _jsonMetaDataDefinesName              = "QGC.MetaData.Defines";
     static constexpr const char* _jsonMetaDataFactsName                = "QGC.MetaData.Facts";
     static constexpr const char* _enumStringsJsonKey                   = "enumStrings";
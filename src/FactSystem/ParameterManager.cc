@@ -21,8 +21,12 @@
 
 #include <QtCore/QEasingCurve>
 #include <QtCore/QFile>
+#include <QtCore/QtEndian>
 #include <QtCore/QVariantAnimation>
 #include <QtCore/QStandardPaths>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
 
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose1Log,           "ParameterManagerVerbose1Log")
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose2Log,           "ParameterManagerVerbose2Log")
@@ -98,7 +102,8 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
     connect(&_initialRequestTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_initialRequestTimeout);
 
     _waitingParamTimeoutTimer.setSingleShot(true);
-    _waitingParamTimeoutTimer.setInterval(3000);
+    _waitingParamTimeoutTimer.setInterval(_maxWaitingParamTimeoutMsecs);
+    _paramValueTimer.start();
     connect(&_waitingParamTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_waitingParamTimeout);
 
     // Ensure the cache directory exists
@@ -120,6 +125,9 @@ void ParameterManager::_updateProgressBar(void)
     for(int compId: _waitingWriteParamNameMap.keys()) {
         waitingWriteParamCount += _waitingWriteParamNameMap[compId].count();
     }
+    for(int compId: _writeBatchQueueMap.keys()) {
+        waitingWriteParamCount += _writeBatchQueueMap[compId].count();
+    }
 
     if (waitingReadParamIndexCount == 0) {
         if (_readParamIndexProgressActive) {
@@ -181,34 +189,7 @@ void ParameterManager::mavlinkMessageReceived(mavlink_message_t message)
         paramUnion.param_float  = param_value.param_value;
         paramUnion.type         = param_value.param_type;
 
-        QVariant parameterValue;
-
-        switch (paramUnion.type) {
-        case MAV_PARAM_TYPE_REAL32:
-            parameterValue = QVariant(paramUnion.param_float);
-            break;
-        case MAV_PARAM_TYPE_UINT8:
-            parameterValue = QVariant(paramUnion.param_uint8);
-            break;
-        case MAV_PARAM_TYPE_INT8:
-            parameterValue = QVariant(paramUnion.param_int8);
-            break;
-        case MAV_PARAM_TYPE_UINT16:
-            parameterValue = QVariant(paramUnion.param_uint16);
-            break;
-        case MAV_PARAM_TYPE_INT16:
-            parameterValue = QVariant(paramUnion.param_int16);
-            break;
-        case MAV_PARAM_TYPE_UINT32:
-            parameterValue = QVariant(paramUnion.param_uint32);
-            break;
-        case MAV_PARAM_TYPE_INT32:
-            parameterValue = QVariant(paramUnion.param_int32);
-            break;
-        default:
-            qCritical() << "ParameterManager::_handleParamValue - unsupported MAV_PARAM_TYPE" << paramUnion.type;
-            break;
-        }
+        const QVariant parameterValue = _paramUnionToVariant(paramUnion);
 
         _handleParamValue(message.compid, parameterName, param_value.param_count, param_value.param_index, static_cast<MAV_PARAM_TYPE>(param_value.param_type), parameterValue);
     }
@@ -281,6 +262,7 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 
     _initialRequestTimeoutTimer.stop();
     _waitingParamTimeoutTimer.stop();
+    _updateParamValuePacing(componentId);
 
     // Update our total parameter counts
     if (!_paramCountMap.contains(componentId)) {
@@ -312,11 +294,19 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
     // Remove this parameter from the waiting lists
     if (_waitingReadParamIndexMap[componentId].contains(parameterIndex)) {
         _waitingReadParamIndexMap[componentId].remove(parameterIndex);
-        _indexBatchQueue.removeOne(parameterIndex);
+        if (_indexBatchQueueMap[componentId].removeOne(parameterIndex)) {
+            // Re-request got through, grow the batch by one for each batch which gets through
+            _indexBatchPacingMap[componentId].requestAnswered();
+        }
         _fillIndexBatchQueue(false /* waitingParamTimeout */);
     }
     _waitingReadParamNameMap[componentId].remove(parameterName);
-    _waitingWriteParamNameMap[componentId].remove(parameterName);
+    if (_waitingWriteParamNameMap[componentId].remove(parameterName)) {
+        // Write got through, make room for the next queued write
+        _writeBatchPacingMap[componentId].requestAnswered();
+        _fillWriteBatchQueue(componentId);
+        _reportWriteFailures();
+    }
     if (_waitingReadParamIndexMap[componentId].count()) {
         qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap:" << _waitingReadParamIndexMap[componentId];
     }
@@ -395,10 +385,13 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
     // Update param cache. The param cache is only used on PX4 Firmware since ArduPilot and Solo have volatile params
     // which invalidate the cache. The Solo also streams param updates in flight for things like gimbal values
     // which in turn causes a perf problem with all the param cache updates.
-    if (!_logReplay && _vehicle->px4Firmware()) {
+    if (!_logReplay && _vehicle->px4Firmware() && !_cacheLoadInProgress) {
         if (_prevWaitingReadParamIndexCount + _prevWaitingReadParamNameCount != 0 && readWaitingParamCount == 0) {
             // All reads just finished, update the cache
             _writeLocalParamCache(_vehicle->id(), componentId);
+        } else if (_initialLoadComplete) {
+            // A single parameter changed, only its record needs updating
+            _updateLocalParamCache(_vehicle->id(), componentId, parameterName, mavParamType, parameterValue);
         }
     }
 
@@ -415,15 +408,23 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 void ParameterManager::_factRawValueUpdateWorker(int componentId, const QString& name, FactMetaData::ValueType_t valueType, const QVariant& rawValue)
 {
     if (_waitingWriteParamNameMap.contains(componentId)) {
+        QSet<QString>& writeBatchQueue = _writeBatchQueueMap[componentId];
         if (_waitingWriteParamNameMap[componentId].contains(name)) {
             _waitingWriteParamNameMap[componentId].remove(name);
-        } else {
+        } else if (!writeBatchQueue.contains(name)) {
             _waitingWriteParamBatchCount++;
         }
+        _saveRequired = true;
+        if (_writeBatchQueueActive) {
+            // The fact value at the time the write window has room is sent
+            writeBatchQueue.insert(name);
+            _updateProgressBar();
+            return;
+        }
+        writeBatchQueue.remove(name);
         _waitingWriteParamNameMap[componentId][name] = 0; // Add new entry and set retry count
         _updateProgressBar();
         _waitingParamTimeoutTimer.start();
-        _saveRequired = true;
     } else {
         qWarning() << "Internal error ParameterManager::_factValueUpdateWorker: component id not found" << componentId;
     }
@@ -445,6 +446,11 @@ void ParameterManager::_factRawValueUpdated(const QVariant& rawValue)
 
 void ParameterManager::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg)
 {
+    if (fileName != _ftpDownloadFile) {
+        return;
+    }
+    _ftpDownloadFile.clear();
+
     bool continueWithDefaultParameterdownload = true;
     bool immediateRetry = false;
 
@@ -492,8 +498,12 @@ void ParameterManager::_ftpDownloadComplete(const QString& fileName, const QStri
 }
 
 
-void ParameterManager::_ftpDownloadProgress(float progress)
+void ParameterManager::_ftpDownloadProgress(const QString& file, float progress)
 {
+    if (file != _ftpDownloadFile) {
+        return;
+    }
+
     qCDebug(ParameterManagerVerbose1Log) << "ParameterManager::_ftpDownloadProgress: " << progress;
     _setLoadProgress(static_cast<double>(progress));
     if (progress > 0.001)
@@ -525,9 +535,10 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
         FTPManager* ftpManager = _vehicle->ftpManager();
         connect(ftpManager, &FTPManager::downloadComplete, this, &ParameterManager::_ftpDownloadComplete);
         _waitingParamTimeoutTimer.stop();
-        if (ftpManager->download(MAV_COMP_ID_AUTOPILOT1, "@PARAM/param.pck",
-                                 QStandardPaths::writableLocation(QStandardPaths::TempLocation),
-                                 "", false /* No filesize check */)) {
+        _ftpDownloadFile = ftpManager->download(MAV_COMP_ID_AUTOPILOT1, "@PARAM/param.pck",
+                                                QStandardPaths::writableLocation(QStandardPaths::TempLocation),
+                                                "", false /* No filesize check */);
+        if (!_ftpDownloadFile.isEmpty()) {
             connect(ftpManager, &FTPManager::commandProgress, this, &ParameterManager::_ftpDownloadProgress);
         } else {
             qCWarning(ParameterManagerLog) << "ParameterManager::refreshallParameters FTPManager::download returned failure";
@@ -645,7 +656,8 @@ QStringList ParameterManager::parameterNames(int componentId)
     return names;
 }
 
-/// Requests missing index based parameters from the vehicle.
+/// Requests missing index based parameters from the vehicle. Each component gets as many requests in flight as its
+/// batch size allows.
 ///     @param waitingParamTimeout: true: being called due to timeout, false: being called to re-fill the batch queue
 /// return true: Parameters were requested, false: No more requests needed
 bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
@@ -654,29 +666,40 @@ bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
         return false;
     }
 
-    const int maxBatchSize = 10;
-
     if (waitingParamTimeout) {
         // We timed out, clear the queue and try again
         qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to timeout";
-        _indexBatchQueue.clear();
     } else {
         qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to received parameter";
     }
 
+    bool paramsRequested = false;
+
     for(int componentId: _waitingReadParamIndexMap.keys()) {
+        QList<int>&             indexBatchQueue = _indexBatchQueueMap[componentId];
+        ParameterRequestWindow& pacing          = _indexBatchPacingMap[componentId];
+
+        if (waitingParamTimeout) {
+            if (!indexBatchQueue.isEmpty()) {
+                // Requests got lost, back off
+                pacing.requestsLost();
+                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Index batch timed out - batchSize:" << pacing.size();
+            }
+            indexBatchQueue.clear();
+        }
+
         if (_waitingReadParamIndexMap[componentId].count()) {
             qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap count" << _waitingReadParamIndexMap[componentId].count();
             qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap" << _waitingReadParamIndexMap[componentId];
         }
 
         for(int paramIndex: _waitingReadParamIndexMap[componentId].keys()) {
-            if (_indexBatchQueue.contains(paramIndex)) {
+            if (indexBatchQueue.contains(paramIndex)) {
                 // Don't add more than once
                 continue;
             }
 
-            if (_indexBatchQueue.count() > maxBatchSize) {
+            if (indexBatchQueue.count() >= pacing.size()) {
                 break;
             }
 
@@ -688,14 +711,37 @@ bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
                 _waitingReadParamIndexMap[componentId].remove(paramIndex);
             } else {
                 // Retry again
-                _indexBatchQueue.append(paramIndex);
+                indexBatchQueue.append(paramIndex);
                 _readParameterRaw(componentId, "", paramIndex);
                 qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
             }
         }
+
+        paramsRequested |= !indexBatchQueue.isEmpty();
+    }
+
+    return paramsRequested;
+}
+
+/// Measures how fast the component delivers parameter values, the waiting timeout follows the slowest component
+void ParameterManager::_updateParamValuePacing(int componentId)
+{
+    _indexBatchPacingMap[componentId].valueReceived(_paramValueTimer.elapsed());
+    _waitingParamTimeoutTimer.setInterval(_waitingParamTimeoutMsecs());
+}
+
+int ParameterManager::_waitingParamTimeoutMsecs(void) const
+{
+    int msecsPerValue = -1;
+    for (const ParameterRequestWindow& pacing: _indexBatchPacingMap) {
+        msecsPerValue = qMax(msecsPerValue, pacing.msecsPerValue());
+    }
+
+    if (msecsPerValue < 0) {
+        return _maxWaitingParamTimeoutMsecs;
     }
 
-    return _indexBatchQueue.count() != 0;
+    return qBound(_minWaitingParamTimeoutMsecs, _waitingParamTimeoutValues * msecsPerValue, _maxWaitingParamTimeoutMsecs);
 }
 
 void ParameterManager::_waitingParamTimeout(void)
@@ -730,6 +776,10 @@ void ParameterManager::_waitingParamTimeout(void)
 
     if (!paramsRequested) {
         for(int componentId: _waitingWriteParamNameMap.keys()) {
+            if (!_waitingWriteParamNameMap[componentId].isEmpty()) {
+                // Writes timed out, fewer of them go out at a time
+                _writeBatchPacingMap[componentId].requestsLost();
+            }
             for(const QString &paramName: _waitingWriteParamNameMap[componentId].keys()) {
                 paramsRequested = true;
                 _waitingWriteParamNameMap[componentId][paramName]++;   // Bump retry count
@@ -741,11 +791,10 @@ void ParameterManager::_waitingParamTimeout(void)
                         goto Out;
                     }
                 } else {
-                    // Exceeded max retry count, notify user
+                    // Exceeded max retry count, the user is notified once all writes are done
                     _waitingWriteParamNameMap[componentId].remove(paramName);
-                    QString errorMsg = tr("Parameter write failed: veh:%1 comp:%2 param:%3").arg(_vehicle->id()).arg(componentId).arg(paramName);
-                    qCDebug(ParameterManagerLog) << errorMsg;
-                    qgcApp()->showAppMessage(errorMsg);
+                    _writeFailures.append(QStringLiteral("comp:%1 param:%2").arg(componentId).arg(paramName));
+                    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Write failed" << paramName;
                 }
             }
         }
@@ -778,6 +827,57 @@ Out:
         qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer - re-request";
         _waitingParamTimeoutTimer.start();
     }
+
+    // Failed writes left room in the write window
+    for (int componentId: _writeBatchQueueMap.keys()) {
+        _fillWriteBatchQueue(componentId);
+    }
+    _updateProgressBar();
+    _reportWriteFailures();
+}
+
+/// Sends queued parameter writes while the write window of the component has room
+void ParameterManager::_fillWriteBatchQueue(int componentId)
+{
+    QSet<QString>& writeBatchQueue = _writeBatchQueueMap[componentId];
+    QMap<QString, int>& waitingWriteParamNames = _waitingWriteParamNameMap[componentId];
+    const int windowSize = _writeBatchPacingMap[componentId].size();
+
+    bool paramsSent = false;
+    while (!writeBatchQueue.isEmpty() && (waitingWriteParamNames.count() < windowSize)) {
+        const QString paramName = *writeBatchQueue.constBegin();
+        writeBatchQueue.erase(writeBatchQueue.constBegin());
+
+        Fact* fact = _mapCompId2FactMap[componentId].value(paramName, nullptr);
+        if (!fact) {
+            continue;
+        }
+        waitingWriteParamNames[paramName] = 0;
+        _sendParamSetToVehicle(componentId, paramName, fact->type(), fact->rawValue());
+        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Queued write sent" << paramName << "window:" << windowSize;
+        paramsSent = true;
+    }
+
+    if (paramsSent) {
+        _waitingParamTimeoutTimer.start();
+    }
+}
+
+void ParameterManager::_reportWriteFailures(void)
+{
+    if (_writeFailures.isEmpty() || pendingWrites()) {
+        return;
+    }
+
+    QString errorMsg;
+    if (_writeFailures.count() == 1) {
+        errorMsg = tr("Parameter write failed: veh:%1 %2").arg(_vehicle->id()).arg(_writeFailures.first());
+    } else {
+        errorMsg = tr("Parameter write failed for %1 parameters: veh:%2 %3").arg(_writeFailures.count()).arg(_vehicle->id()).arg(_writeFailures.join(QStringLiteral(", ")));
+    }
+    _writeFailures.clear();
+    qCDebug(ParameterManagerLog) << errorMsg;
+    qgcApp()->showAppMessage(errorMsg);
 }
 
 void ParameterManager::_readParameterRaw(int componentId, const QString& paramName, int paramIndex)
@@ -811,40 +911,7 @@ void ParameterManager::_sendParamSetToVehicle(int componentId, const QString& pa
         memset(&p, 0, sizeof(p));
 
         p.param_type = factTypeToMavType(valueType);
-
-        switch (valueType) {
-        case FactMetaData::valueTypeUint8:
-            union_value.param_uint8 = (uint8_t)value.toUInt();
-            break;
-
-        case FactMetaData::valueTypeInt8:
-            union_value.param_int8 = (int8_t)value.toInt();
-            break;
-
-        case FactMetaData::valueTypeUint16:
-            union_value.param_uint16 = (uint16_t)value.toUInt();
-            break;
-
-        case FactMetaData::valueTypeInt16:
-            union_value.param_int16 = (int16_t)value.toInt();
-            break;
-
-        case FactMetaData::valueTypeUint32:
-            union_value.param_uint32 = (uint32_t)value.toUInt();
-            break;
-
-        case FactMetaData::valueTypeFloat:
-            union_value.param_float = value.toFloat();
-            break;
-
-        default:
-            qCritical() << "Unsupported fact falue type" << valueType;
-            // fall through
-
-        case FactMetaData::valueTypeInt32:
-            union_value.param_int32 = (int32_t)value.toInt();
-            break;
-        }
+        union_value = _variantToParamUnion(valueType, value);
 
         p.param_value = union_value.param_float;
         p.target_system = (uint8_t)_vehicle->id();
@@ -862,20 +929,154 @@ void ParameterManager::_sendParamSetToVehicle(int componentId, const QString& pa
     }
 }
 
-void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
+/// Parameter cache file layout. The header is followed by one fixed size record per parameter, sorted by name, so the
+/// file can be mapped and a single parameter changed in place. Integers are little endian.
+typedef struct ParamCacheHeader_s {
+    quint32 magic;
+    quint32 version;
+    quint32 count;                                              ///< Number of records
+    quint32 crc;                                                ///< Parameter set hash as computed by PX4, running crc of the last record
+} ParamCacheHeader_t;
+
+typedef struct ParamCacheRecord_s {
+    char    name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN];  ///< Not null terminated if all characters are used
+    quint8  mavParamType;
+    quint8  flags;
+    quint8  reserved[2];
+    quint32 runningCrc;                                         ///< Crc over this and all preceding records
+    quint8  value[sizeof(float)];                               ///< mavlink_param_union_t value bytes
+} ParamCacheRecord_t;
+
+static_assert(sizeof(ParamCacheHeader_t) == 16, "Parameter cache header layout changed");
+static_assert(sizeof(ParamCacheRecord_t) == 28, "Parameter cache record layout changed");
+
+static constexpr quint32 kParamCacheMagic           = 0x43504751; ///< "QGPC"
+static constexpr quint32 kParamCacheVersion         = 3;
+static constexpr quint8  kParamCacheFlagVolatile    = 0x01;      ///< Value does not take part in the crc
+
+/// Updates the running crc of all records starting at firstRecord
+///     @return crc of the whole parameter set
+static quint32 _updateParamCacheCrc(ParamCacheRecord_t* records, int count, int firstRecord)
 {
-    CacheMapName2ParamTypeVal cacheMap;
+    quint32 crc = (firstRecord > 0) ? qFromLittleEndian(records[firstRecord - 1].runningCrc) : 0;
+
+    for (int i=firstRecord; i<count; i++) {
+        ParamCacheRecord_t& record = records[i];
+        if (!(record.flags & kParamCacheFlagVolatile)) {
+            const FactMetaData::ValueType_t factType = ParameterManager::mavTypeToFactType(static_cast<MAV_PARAM_TYPE>(record.mavParamType));
+            crc = QGC::crc32(reinterpret_cast<const quint8*>(record.name), qstrnlen(record.name, sizeof(record.name)), crc);
+            crc = QGC::crc32(record.value, FactMetaData::typeToSize(factType), crc);
+        }
+        record.runningCrc = qToLittleEndian(crc);
+    }
+
+    return crc;
+}
 
-    for (const QString& paramName: _mapCompId2FactMap[componentId].keys()) {
-        const Fact *fact = _mapCompId2FactMap[componentId][paramName];
-        cacheMap[paramName] = ParamTypeVal(fact->type(), fact->rawValue());
+/// @return Header of a mapped cache file, nullptr if the file is not a valid cache
+static ParamCacheHeader_t* _paramCacheHeader(uchar* data, qint64 size)
+{
+    if (!data || size < static_cast<qint64>(sizeof(ParamCacheHeader_t))) {
+        return nullptr;
+    }
+
+    ParamCacheHeader_t* header = reinterpret_cast<ParamCacheHeader_t*>(data);
+    if (qFromLittleEndian(header->magic) != kParamCacheMagic || qFromLittleEndian(header->version) != kParamCacheVersion) {
+        return nullptr;
     }
+    if (size != static_cast<qint64>(sizeof(ParamCacheHeader_t) + (qFromLittleEndian(header->count) * sizeof(ParamCacheRecord_t)))) {
+        return nullptr;
+    }
+
+    return header;
+}
+
+void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
+{
+    const QMap<QString, Fact*>& factMap = _mapCompId2FactMap[componentId];
+    CompInfoParam* compInfoParam = _vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1);
+
+    // QMap keeps the names sorted
+    QList<ParamCacheRecord_t> records(factMap.count());
+    int index = 0;
+    for (auto it = factMap.constBegin(); it != factMap.constEnd(); it++, index++) {
+        const Fact* fact = it.value();
+        ParamCacheRecord_t& record = records[index];
+
+        memset(&record, 0, sizeof(record));
+        strncpy(record.name, qPrintable(it.key()), sizeof(record.name));
+        record.mavParamType = factTypeToMavType(fact->type());
+        if (compInfoParam->factMetaDataForName(it.key(), fact->type())->volatileValue()) {
+            record.flags |= kParamCacheFlagVolatile;
+        }
+        const mavlink_param_union_t paramUnion = _variantToParamUnion(fact->type(), fact->rawValue());
+        memcpy(record.value, &paramUnion.param_float, sizeof(record.value));
+    }
+
+    // The crc and the file are done on a worker thread, so a fleet of vehicles finishing their loads does not stall
+    // the ui. Later in place updates wait for the write.
+    _cacheWriteFuture.waitForFinished();
+    _cacheWriteFuture = QtConcurrent::run([cacheFileName = parameterCacheFile(vehicleId, componentId), records]() mutable {
+        ParamCacheHeader_t header;
+        header.magic    = qToLittleEndian(kParamCacheMagic);
+        header.version  = qToLittleEndian(kParamCacheVersion);
+        header.count    = qToLittleEndian(static_cast<quint32>(records.count()));
+        header.crc      = qToLittleEndian(_updateParamCacheCrc(records.data(), records.count(), 0));
+
+        QFile cacheFile(cacheFileName);
+        if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(ParameterManagerLog) << "Unable to write parameter cache" << cacheFile.fileName() << cacheFile.errorString();
+            return;
+        }
+        (void) cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        (void) cacheFile.write(reinterpret_cast<const char*>(records.constData()), records.count() * sizeof(ParamCacheRecord_t));
+    });
+}
+
+void ParameterManager::_updateLocalParamCache(int vehicleId, int componentId, const QString& paramName, MAV_PARAM_TYPE mavParamType, const QVariant& value)
+{
+    _cacheWriteFuture.waitForFinished();
 
     QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (!cacheFile.open(QIODevice::ReadWrite)) {
+        return;
+    }
+
+    const qint64 size = cacheFile.size();
+    uchar* data = (size > 0) ? cacheFile.map(0, size) : nullptr;
+    ParamCacheHeader_t* header = _paramCacheHeader(data, size);
 
-    QDataStream ds(&cacheFile);
-    ds << cacheMap;
+    bool recordFound = false;
+    if (header) {
+        ParamCacheRecord_t* records = reinterpret_cast<ParamCacheRecord_t*>(header + 1);
+        const int count = qFromLittleEndian(header->count);
+
+        char name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN] = {};
+        strncpy(name, qPrintable(paramName), sizeof(name));
+
+        ParamCacheRecord_t* record = std::lower_bound(records, records + count, name, [](const ParamCacheRecord_t& entry, const char* key) {
+            return memcmp(entry.name, key, sizeof(entry.name)) < 0;
+        });
+        if (record != records + count && memcmp(record->name, name, sizeof(name)) == 0 && record->mavParamType == mavParamType) {
+            recordFound = true;
+
+            const mavlink_param_union_t paramUnion = _variantToParamUnion(mavTypeToFactType(mavParamType), value);
+            if (memcmp(record->value, &paramUnion.param_float, sizeof(record->value)) != 0) {
+                memcpy(record->value, &paramUnion.param_float, sizeof(record->value));
+                header->crc = qToLittleEndian(_updateParamCacheCrc(records, count, static_cast<int>(record - records)));
+            }
+        }
+    }
+
+    if (data) {
+        (void) cacheFile.unmap(data);
+    }
+    cacheFile.close();
+
+    if (!recordFound) {
+        // New parameter or no usable cache file yet
+        _writeLocalParamCache(vehicleId, componentId);
+    }
 }
 
 QDir ParameterManager::parameterCacheDir()
@@ -886,57 +1087,73 @@ QDir ParameterManager::parameterCacheDir()
 
 QString ParameterManager::parameterCacheFile(int vehicleId, int componentId)
 {
-    return parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId));
+    return parameterCacheDir().filePath(QString("%1_%2.v3").arg(vehicleId).arg(componentId));
 }
 
 void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVariant hash_value)
 {
     qCInfo(ParameterManagerLog) << "Attemping load from cache";
 
-    uint32_t crc32_value = 0;
-    /* The datastructure of the cache table */
-    CacheMapName2ParamTypeVal cacheMap;
+    _cacheWriteFuture.waitForFinished();
+
     QFile cacheFile(parameterCacheFile(vehicleId, componentId));
     if (!cacheFile.exists()) {
         /* no local cache, just wait for them to come in*/
         return;
     }
-    cacheFile.open(QIODevice::ReadOnly);
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        qCWarning(ParameterManagerLog) << "Unable to open parameter cache" << cacheFile.fileName() << cacheFile.errorString();
+        return;
+    }
 
-    /* Deserialize the parameter cache table */
-    QDataStream ds(&cacheFile);
-    ds >> cacheMap;
+    /* The crc of the cache is kept up to date in the header, the records only need to be read on a match */
+    const qint64 size = cacheFile.size();
+    uchar* data = (size > 0) ? cacheFile.map(0, size) : nullptr;
+    const ParamCacheHeader_t* header = _paramCacheHeader(data, size);
+    if (!header) {
+        qCInfo(ParameterManagerLog) << "Parameter cache is not valid" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
+        if (data) {
+            (void) cacheFile.unmap(data);
+        }
+        return;
+    }
 
-    /* compute the crc of the local cache to check against the remote */
+    const uint32_t  crc32_value = qFromLittleEndian(header->crc);
+    const bool      crcMatch    = crc32_value == hash_value.toUInt();
 
-    for (const QString& name: cacheMap.keys()) {
-        const ParamTypeVal&             paramTypeVal    = cacheMap[name];
-        const FactMetaData::ValueType_t fact_type       = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
+    /* The cache already holds the values loaded from it, so it is not written back while loading */
+    _cacheLoadInProgress = true;
 
-        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->factMetaDataForName(name, fact_type)->volatileValue()) {
-            // Does not take part in CRC
-            qCDebug(ParameterManagerLog) << "Volatile parameter" << name;
-        } else {
-            const void *vdat = paramTypeVal.second.constData();
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            crc32_value = QGC::crc32((const uint8_t *)qPrintable(name), name.length(),  crc32_value);
-            crc32_value = QGC::crc32((const uint8_t *)vdat, FactMetaData::typeToSize(fact_type), crc32_value);
+    CacheMapName2ParamTypeVal cacheMap;
+    const ParamCacheRecord_t* records = reinterpret_cast<const ParamCacheRecord_t*>(header + 1);
+    const int count = qFromLittleEndian(header->count);
+    if (crcMatch || ParameterManagerDebugCacheFailureLog().isDebugEnabled()) {
+        for (int index=0; index<count; index++) {
+            const ParamCacheRecord_t& record = records[index];
+
+            mavlink_param_union_t paramUnion;
+            memcpy(&paramUnion.param_float, record.value, sizeof(record.value));
+            paramUnion.type = record.mavParamType;
+
+            const QString           name            = QString::fromLatin1(record.name, qstrnlen(record.name, sizeof(record.name)));
+            const MAV_PARAM_TYPE    mavParamType    = static_cast<MAV_PARAM_TYPE>(record.mavParamType);
+            const QVariant          value           = _paramUnionToVariant(paramUnion);
+            if (crcMatch) {
+                _handleParamValue(componentId, name, count, index, mavParamType, value);
+            } else {
+                cacheMap[name] = ParamTypeVal(mavTypeToFactType(mavParamType), value);
+            }
         }
     }
 
+    _cacheLoadInProgress = false;
+    (void) cacheFile.unmap(data);
+    cacheFile.close();
+
     /* if the two param set hashes match, just load from the disk */
-    if (crc32_value == hash_value.toUInt()) {
+    if (crcMatch) {
         qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
 
-        int count = cacheMap.count();
-        int index = 0;
-        for (const QString& name: cacheMap.keys()) {
-            const ParamTypeVal& paramTypeVal = cacheMap[name];
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            const MAV_PARAM_TYPE mavParamType = factTypeToMavType(fact_type);
-            _handleParamValue(componentId, name, count, index++, mavParamType, paramTypeVal.second);
-        }
-
         SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
         if (sharedLink) {
             mavlink_param_set_t     p;
@@ -995,6 +1212,10 @@ QString ParameterManager::readParametersFromStream(QTextStream& stream)
 {
     QString missingErrors;
     QString typeErrors;
+    QString systemIdError;
+
+    // Facts with a changed value queue their write, setRawValue skips values which are the same as the vehicle's
+    _writeBatchQueueActive = true;
 
     while (!stream.atEnd()) {
         QString line = stream.readLine();
@@ -1003,7 +1224,8 @@ QString ParameterManager::readParametersFromStream(QTextStream& stream)
             int lineMavId = wpParams.at(0).toInt();
             if (wpParams.size() == 5) {
                 if (_vehicle->id() != lineMavId) {
-                    return QString("The parameters in the stream have been saved from System Id %1, but the current vehicle has the System Id %2.").arg(lineMavId).arg(_vehicle->id());
+                    systemIdError = QString("The parameters in the stream have been saved from System Id %1, but the current vehicle has the System Id %2.").arg(lineMavId).arg(_vehicle->id());
+                    break;
                 }
 
                 int     componentId = wpParams.at(1).toInt();
@@ -1034,6 +1256,17 @@ QString ParameterManager::readParametersFromStream(QTextStream& stream)
         }
     }
 
+    _writeBatchQueueActive = false;
+    for (int componentId: _writeBatchQueueMap.keys()) {
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Queued parameter writes" << _writeBatchQueueMap[componentId].count();
+        _fillWriteBatchQueue(componentId);
+    }
+    _updateProgressBar();
+
+    if (!systemIdError.isEmpty()) {
+        return systemIdError;
+    }
+
     QString errors;
 
     if (!missingErrors.isEmpty()) {
@@ -1117,6 +1350,73 @@ MAV_PARAM_TYPE ParameterManager::factTypeToMavType(FactMetaData::ValueType_t fac
     }
 }
 
+QVariant ParameterManager::_paramUnionToVariant(const mavlink_param_union_t& paramUnion)
+{
+    switch (paramUnion.type) {
+    case MAV_PARAM_TYPE_REAL32:
+        return QVariant(paramUnion.param_float);
+    case MAV_PARAM_TYPE_UINT8:
+        return QVariant(paramUnion.param_uint8);
+    case MAV_PARAM_TYPE_INT8:
+        return QVariant(paramUnion.param_int8);
+    case MAV_PARAM_TYPE_UINT16:
+        return QVariant(paramUnion.param_uint16);
+    case MAV_PARAM_TYPE_INT16:
+        return QVariant(paramUnion.param_int16);
+    case MAV_PARAM_TYPE_UINT32:
+        return QVariant(paramUnion.param_uint32);
+    case MAV_PARAM_TYPE_INT32:
+        return QVariant(paramUnion.param_int32);
+    default:
+        qCritical() << "ParameterManager::_paramUnionToVariant - unsupported MAV_PARAM_TYPE" << paramUnion.type;
+        return QVariant();
+    }
+}
+
+mavlink_param_union_t ParameterManager::_variantToParamUnion(FactMetaData::ValueType_t valueType, const QVariant& value)
+{
+    mavlink_param_union_t union_value;
+
+    memset(&union_value, 0, sizeof(union_value));
+    union_value.type = factTypeToMavType(valueType);
+
+    switch (valueType) {
+    case FactMetaData::valueTypeUint8:
+        union_value.param_uint8 = (uint8_t)value.toUInt();
+        break;
+
+    case FactMetaData::valueTypeInt8:
+        union_value.param_int8 = (int8_t)value.toInt();
+        break;
+
+    case FactMetaData::valueTypeUint16:
+        union_value.param_uint16 = (uint16_t)value.toUInt();
+        break;
+
+    case FactMetaData::valueTypeInt16:
+        union_value.param_int16 = (int16_t)value.toInt();
+        break;
+
+    case FactMetaData::valueTypeUint32:
+        union_value.param_uint32 = (uint32_t)value.toUInt();
+        break;
+
+    case FactMetaData::valueTypeFloat:
+        union_value.param_float = value.toFloat();
+        break;
+
+    default:
+        qCritical() << "Unsupported fact falue type" << valueType;
+        // fall through
+
+    case FactMetaData::valueTypeInt32:
+        union_value.param_int32 = (int32_t)value.toInt();
+        break;
+    }
+
+    return union_value;
+}
+
 FactMetaData::ValueType_t ParameterManager::mavTypeToFactType(MAV_PARAM_TYPE mavType)
 {
     switch (mavType) {
@@ -1412,6 +1712,11 @@ bool ParameterManager::pendingWrites(void)
             return true;
         }
     }
+    for (int compId: _writeBatchQueueMap.keys()) {
+        if (_writeBatchQueueMap[compId].count()) {
+            return true;
+        }
+    }
 
     return false;
 }
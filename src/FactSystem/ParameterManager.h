@@ -12,13 +12,17 @@
 #include <QtCore/QObject>
 #include <QtCore/QMap>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFuture>
 #include <QtCore/QTimer>
 #include <QtCore/QString>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QSet>
 
 #include "Fact.h"
 #include "FactMetaData.h"
 #include "MAVLinkLib.h"
+#include "ParameterRequestWindow.h"
 
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose1Log)
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose2Log)
@@ -55,6 +59,9 @@ public:
 
     void mavlinkMessageReceived(mavlink_message_t message);
 
+    /// @return Message ids handled by mavlinkMessageReceived
+    static QList<uint32_t> handledMessageIds(void) { return { MAVLINK_MSG_ID_PARAM_VALUE }; }
+
     QList<int> componentIds(void);
 
     /// Re-request the full set of parameters from the autopilot
@@ -83,7 +90,10 @@ public:
     ///     @param name: Parameter name
     Fact* getParameter(int componentId, const QString& paramName);
 
-    /// Returns error messages from loading
+    /// Sets the parameters from a saved parameter file. Only values which differ from the vehicle are written. The writes
+    /// are queued and sent through a window of PARAM_SETs in flight per component, write failures are reported once
+    /// all writes are done.
+    ///     @return Error messages from loading
     QString readParametersFromStream(QTextStream& stream);
 
     void writeParametersToStream(QTextStream& stream);
@@ -117,6 +127,7 @@ private:
     void    _readParameterRaw                   (int componentId, const QString& paramName, int paramIndex);
     void    _sendParamSetToVehicle              (int componentId, const QString& paramName, FactMetaData::ValueType_t valueType, const QVariant& value);
     void    _writeLocalParamCache               (int vehicleId, int componentId);
+    void    _updateLocalParamCache              (int vehicleId, int componentId, const QString& paramName, MAV_PARAM_TYPE mavParamType, const QVariant& value);
     void    _tryCacheHashLoad                   (int vehicleId, int componentId, QVariant hash_value);
     void    _loadMetaData                       (void);
     void    _clearMetaData                      (void);
@@ -125,13 +136,19 @@ private:
     QString _logVehiclePrefix                   (int componentId);
     void    _setLoadProgress                    (double loadProgress);
     bool    _fillIndexBatchQueue                (bool waitingParamTimeout);
+    void    _fillWriteBatchQueue                (int componentId);
+    void    _reportWriteFailures                (void);
+    void    _updateParamValuePacing             (int componentId);
+    int     _waitingParamTimeoutMsecs           (void) const;
     void    _updateProgressBar                  (void);
     void    _checkInitialLoadComplete           (void);
     void    _ftpDownloadComplete                (const QString& fileName, const QString& errorMsg);
-    void    _ftpDownloadProgress                (float progress);
+    void    _ftpDownloadProgress                (const QString& file, float progress);
     bool    _parseParamFile                     (const QString& filename);
 
     static QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool failOk = false);
+    static QVariant _paramUnionToVariant(const mavlink_param_union_t& paramUnion);
+    static mavlink_param_union_t _variantToParamUnion(FactMetaData::ValueType_t valueType, const QVariant& value);
 
     Vehicle*            _vehicle;
     MAVLinkProtocol*    _mavlink;
@@ -146,6 +163,8 @@ private:
     bool        _saveRequired;                  ///< true: _saveToEEPROM should be called
     bool        _metaDataAddedToFacts;          ///< true: FactMetaData has been adde to the default component facts
     bool        _logReplay;                     ///< true: running with log replay link
+    bool        _cacheLoadInProgress = false;   ///< true: parameters are being loaded from the cache
+    QFuture<void> _cacheWriteFuture;            ///< Full cache write running on a worker thread
 
     typedef QPair<int /* FactMetaData::ValueType_t */, QVariant /* Fact::rawValue */> ParamTypeVal;
     typedef QMap<QString /* parameter name */, ParamTypeVal> CacheMapName2ParamTypeVal;
@@ -169,8 +188,19 @@ private:
     static const int    _maxReadWriteRetry = 5;                 ///< Maximum retries read/write
     bool                _disableAllRetries;                     ///< true: Don't retry any requests (used for testing)
 
-    bool        _indexBatchQueueActive; ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
-    QList<int>  _indexBatchQueue;       ///< The current queue of index re-requests
+    bool                            _indexBatchQueueActive; ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
+    QMap<int, QList<int>>           _indexBatchQueueMap;    ///< Key: Component id, Value: The current queue of index re-requests
+    QMap<int, ParameterRequestWindow> _indexBatchPacingMap; ///< Key: Component id, Value: Pacing of the index based re-requests
+    QElapsedTimer                   _paramValueTimer;       ///< Time base for the parameter value intervals
+
+    bool                            _writeBatchQueueActive = false; ///< true: fact changes are queued for the write window instead of sent right away
+    QMap<int, QSet<QString>>        _writeBatchQueueMap;    ///< Key: Component id, Value: parameter names waiting for room in the write window
+    QMap<int, ParameterRequestWindow> _writeBatchPacingMap; ///< Key: Component id, Value: Window of PARAM_SETs in flight
+    QStringList                     _writeFailures;         ///< Parameter writes which ran out of retries, reported when no writes are left
+
+    static constexpr int _minWaitingParamTimeoutMsecs   = 500;
+    static constexpr int _maxWaitingParamTimeoutMsecs   = 3000;
+    static constexpr int _waitingParamTimeoutValues     = 20;   ///< Timeout in intervals between parameter values
 
     QMap<int, int>                  _paramCountMap;             ///< Key: Component id, Value: count of parameters in this component
     QMap<int, QMap<int, int> >      _waitingReadParamIndexMap;  ///< Key: Component id, Value: Map { Key: parameter index still waiting for, Value: retry count }
@@ -189,4 +219,5 @@ private:
 
     /* MavFTP */
     bool               _tryftp;
+    QString            _ftpDownloadFile;    ///< Local file of the parameter download, other FTP downloads share the signals
 };
@@ -0,0 +1,47 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterRequestWindow.h"
+
+ParameterRequestWindow::ParameterRequestWindow(int initialSize, int minSize, int maxSize)
+    : _size     (initialSize)
+    , _minSize  (minSize)
+    , _maxSize  (maxSize)
+{
+
+}
+
+void ParameterRequestWindow::requestAnswered(void)
+{
+    _size = qMin(_size + (1.0 / _size), static_cast<double>(_maxSize));
+}
+
+void ParameterRequestWindow::requestsLost(void)
+{
+    _size = qMax(_size / 2, static_cast<double>(_minSize));
+}
+
+void ParameterRequestWindow::valueReceived(qint64 nowMsecs)
+{
+    if (_lastValueMsecs >= 0) {
+        const qint64 intervalMsecs = nowMsecs - _lastValueMsecs;
+        if (intervalMsecs < maxValueIntervalMsecs) {
+            _msecsPerValue = (_msecsPerValue < 0) ? static_cast<int>(intervalMsecs) : static_cast<int>(((7 * _msecsPerValue) + intervalMsecs) / 8);
+        }
+    }
+    _lastValueMsecs = nowMsecs;
+}
+
+int ParameterRequestWindow::timeoutMsecs(int minMsecs, int maxMsecs, int intervals) const
+{
+    if (_msecsPerValue < 0) {
+        return maxMsecs;
+    }
+    return qBound(minMsecs, intervals * _msecsPerValue, maxMsecs);
+}
@@ -0,0 +1,53 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QtGlobal>
+
+/// Adaptive window of parameter requests kept in flight to one component. The window grows by one for each window
+/// worth of answered requests and is halved when requests get lost, so it settles at what the link can carry. The
+/// interval between received values is smoothed so request timeouts can follow the link speed.
+///
+/// Used by ParameterManager for the index based PARAM_VALUE re-requests and by the camera PARAM_EXT reads.
+class ParameterRequestWindow
+{
+public:
+    ParameterRequestWindow(int initialSize = 10, int minSize = 2, int maxSize = 100);
+
+    /// @return Number of requests which may be in flight
+    int     size            (void) const { return static_cast<int>(_size); }
+
+    /// @return Smoothed interval between values from the component, -1 if not measured yet
+    int     msecsPerValue   (void) const { return _msecsPerValue; }
+
+    /// A request in the window was answered
+    void    requestAnswered (void);
+
+    /// Requests in the window timed out
+    void    requestsLost    (void);
+
+    /// A value arrived from the component
+    ///     @param nowMsecs Monotonic time base of the caller
+    void    valueReceived   (qint64 nowMsecs);
+
+    /// @return Timeout for requests in flight: the given number of value intervals, bounded. maxMsecs while the interval
+    ///         is not measured yet.
+    int     timeoutMsecs    (int minMsecs, int maxMsecs, int intervals) const;
+
+    /// Gaps between values longer than this are pauses between requests rather than the link speed
+    static constexpr int maxValueIntervalMsecs = 3000;
+
+private:
+    double  _size;
+    int     _minSize;
+    int     _maxSize;
+    int     _msecsPerValue  = -1;
+    qint64  _lastValueMsecs = -1;
+};
@@ -9,10 +9,10 @@
 
 
 #include "SettingsFact.h"
+#include "SettingsWriteBack.h"
 #include "QGCCorePlugin.h"
 #include "QGCApplication.h"
 
-#include <QtCore/QSettings>
 #include <QtQml/QQmlEngine>
 
 SettingsFact::SettingsFact(QObject* parent)
@@ -26,11 +26,7 @@ SettingsFact::SettingsFact(QString settingsGroup, FactMetaData* metaData, QObjec
     , _settingsGroup(settingsGroup)
     , _visible      (true)
 {
-    QSettings settings;
-
-    if (!_settingsGroup.isEmpty()) {
-        settings.beginGroup(_settingsGroup);
-    }
+    SettingsWriteBack* const settings = SettingsWriteBack::instance();
 
     // Allow core plugin a chance to override the default value
     _visible = qgcApp()->toolbox()->corePlugin()->adjustSettingMetaData(settingsGroup, *metaData);
@@ -45,14 +41,15 @@ SettingsFact::SettingsFact(QString settingsGroup, FactMetaData* metaData, QObjec
             if (_visible) {
                 QVariant typedValue;
                 QString errorString;
-                metaData->convertAndValidateRaw(settings.value(_name, rawDefaultValue), true /* conertOnly */, typedValue, errorString);
+                metaData->convertAndValidateRaw(settings->value(_settingsGroup, _name, rawDefaultValue), true /* conertOnly */, typedValue, errorString);
                 _rawValue = typedValue;
             } else {
                 // Setting is not visible, force to default value always
-                settings.setValue(_name, rawDefaultValue);
+                settings->setValue(_settingsGroup, _name, rawDefaultValue);
                 _rawValue = rawDefaultValue;
             }
         }
+        _invalidateCookedValueCache();
     }
 
     connect(this, &Fact::rawValueChanged, this, &SettingsFact::_rawValueChanged);
@@ -75,11 +72,5 @@ const SettingsFact& SettingsFact::operator=(const SettingsFact& other)
 
 void SettingsFact::_rawValueChanged(QVariant value)
 {
-    QSettings settings;
-
-    if (!_settingsGroup.isEmpty()) {
-        settings.beginGroup(_settingsGroup);
-    }
-
-    settings.setValue(_name, value);
+    SettingsWriteBack::instance()->setValue(_settingsGroup, _name, value);
 }
@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SettingsWriteBack.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QSettings>
+
+QGC_LOGGING_CATEGORY(SettingsWriteBackLog, "qgc.factsystem.settingswriteback")
+
+Q_GLOBAL_STATIC(SettingsWriteBack, _settingsWriteBack)
+
+SettingsWriteBack* SettingsWriteBack::instance()
+{
+    return _settingsWriteBack();
+}
+
+SettingsWriteBack::SettingsWriteBack(QObject* parent)
+    : QObject(parent)
+{
+    _idleTimer.setSingleShot(true);
+    _idleTimer.setInterval(idleFlushMSecs);
+    (void) connect(&_idleTimer, &QTimer::timeout, this, &SettingsWriteBack::flush);
+
+    _maxDelayTimer.setSingleShot(true);
+    _maxDelayTimer.setInterval(maxFlushMSecs);
+    (void) connect(&_maxDelayTimer, &QTimer::timeout, this, &SettingsWriteBack::flush);
+
+    if (QCoreApplication::instance()) {
+        (void) connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &SettingsWriteBack::flush);
+    }
+}
+
+SettingsWriteBack::~SettingsWriteBack()
+{
+    // Without the application the settings file name is unknown, aboutToQuit has flushed already in that case
+    if (QCoreApplication::instance()) {
+        flush();
+    }
+}
+
+QString SettingsWriteBack::journalFileName(void)
+{
+    return QSettings().fileName() + QStringLiteral(".journal");
+}
+
+QString SettingsWriteBack::_key(const QString& settingsGroup, const QString& name)
+{
+    return settingsGroup.isEmpty() ? name : QStringLiteral("%1/%2").arg(settingsGroup, name);
+}
+
+void SettingsWriteBack::setValue(const QString& settingsGroup, const QString& name, const QVariant& value)
+{
+    const QString key = _key(settingsGroup, name);
+
+    _pending[key] = value;
+    _appendJournal(key, value);
+
+    _idleTimer.start();
+    if (!_maxDelayTimer.isActive()) {
+        _maxDelayTimer.start();
+    }
+}
+
+QVariant SettingsWriteBack::value(const QString& settingsGroup, const QString& name, const QVariant& defaultValue) const
+{
+    const QString key = _key(settingsGroup, name);
+
+    const auto it = _pending.constFind(key);
+    if (it != _pending.constEnd()) {
+        return it.value();
+    }
+    return QSettings().value(key, defaultValue);
+}
+
+void SettingsWriteBack::flush(void)
+{
+    _idleTimer.stop();
+    _maxDelayTimer.stop();
+
+    if (!_pending.isEmpty()) {
+        qCDebug(SettingsWriteBackLog) << "Writing" << _pending.count() << "changed settings";
+
+        QSettings settings;
+        for (auto it = _pending.constBegin(); it != _pending.constEnd(); it++) {
+            settings.setValue(it.key(), it.value());
+        }
+        settings.sync();
+        if (settings.status() != QSettings::NoError) {
+            // Keep the journal so the changes are replayed on the next start
+            qCWarning(SettingsWriteBackLog) << "Writing settings failed" << settings.status();
+            return;
+        }
+        _pending.clear();
+    }
+
+    if (_journal.isOpen()) {
+        _journal.close();
+    }
+    if (QFile::exists(journalFileName())) {
+        (void) QFile::remove(journalFileName());
+    }
+}
+
+void SettingsWriteBack::_appendJournal(const QString& key, const QVariant& value)
+{
+    if (!_journal.isOpen()) {
+        _journal.setFileName(journalFileName());
+        if (!_journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCWarning(SettingsWriteBackLog) << "Unable to open settings journal" << _journal.fileName() << _journal.errorString();
+            return;
+        }
+    }
+
+    QDataStream stream(&_journal);
+    stream << key << value;
+
+    // Hand the record to the OS now so it survives the process going away
+    (void) _journal.flush();
+}
+
+void SettingsWriteBack::recoverJournal(void)
+{
+    // Changes journaled by this run are replayed as well, the journal is reopened by the next change once it is removed
+    if (_journal.isOpen()) {
+        _journal.close();
+    }
+
+    QFile journal(journalFileName());
+    if (!journal.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QSettings settings;
+    QDataStream stream(&journal);
+    int count = 0;
+    while (!stream.atEnd()) {
+        QString key;
+        QVariant value;
+        stream >> key >> value;
+        if (stream.status() != QDataStream::Ok) {
+            // The last record is cut short if the process died while writing it
+            break;
+        }
+        settings.setValue(key, value);
+        count++;
+    }
+    journal.close();
+    settings.sync();
+
+    qCDebug(SettingsWriteBackLog) << "Recovered" << count << "settings changes from journal";
+    if (settings.status() == QSettings::NoError) {
+        (void) QFile::remove(journalFileName());
+    }
+}
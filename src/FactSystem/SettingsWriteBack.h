@@ -0,0 +1,64 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVariant>
+
+Q_DECLARE_LOGGING_CATEGORY(SettingsWriteBackLog)
+
+/// Write-back cache between SettingsFacts and QSettings. Every QSettings write rewrites the whole settings file, so a
+/// slider bound to a setting would otherwise rewrite it for each step of a drag. Changes are held in memory and written
+/// in one pass once edits stop for a moment, at the latest a few seconds after the first pending change, and on exit.
+/// Each change is also appended to a journal file next to the settings file, which is replayed on the next start if the
+/// process dies before the pending changes reach QSettings.
+class SettingsWriteBack : public QObject
+{
+    Q_OBJECT
+
+public:
+    SettingsWriteBack(QObject* parent = nullptr);
+    ~SettingsWriteBack();
+
+    static SettingsWriteBack* instance();
+
+    /// Queues a value to be written to QSettings
+    void setValue(const QString& settingsGroup, const QString& name, const QVariant& value);
+
+    /// @return The pending value if there is one, otherwise the value from QSettings
+    QVariant value(const QString& settingsGroup, const QString& name, const QVariant& defaultValue) const;
+
+    bool hasPendingChanges(void) const { return !_pending.isEmpty(); }
+
+    /// Writes all pending changes to QSettings and removes the journal
+    void flush(void);
+
+    /// Applies the changes left in the journal by a previous run which did not exit cleanly. Must be called before
+    /// anything else reads settings.
+    void recoverJournal(void);
+
+    static QString journalFileName(void);
+
+    static constexpr int idleFlushMSecs =   1000;   ///< Flush once no change was made for this long
+    static constexpr int maxFlushMSecs =    5000;   ///< Flush at the latest this long after the first pending change
+
+private:
+    static QString _key(const QString& settingsGroup, const QString& name);
+    void _appendJournal(const QString& key, const QVariant& value);
+
+    QHash<QString, QVariant>    _pending;       ///< Keyed by full settings key
+    QTimer                      _idleTimer;
+    QTimer                      _maxDelayTimer;
+    QFile                       _journal;
+};
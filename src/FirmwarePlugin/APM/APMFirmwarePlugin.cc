@@ -103,13 +103,7 @@ QList<VehicleComponent*> APMFirmwarePlugin::componentsForVehicle(AutoPilotPlugin
 QStringList APMFirmwarePlugin::flightModes(Vehicle* vehicle)
 {
     Q_UNUSED(vehicle)
-    QStringList flightModesList;
-    foreach (const APMCustomMode& customMode, _supportedModes) {
-        if (customMode.canBeSet()) {
-            flightModesList << customMode.modeString();
-        }
-    }
-    return flightModesList;
+    return _settableModeNames;
 }
 
 QString APMFirmwarePlugin::flightMode(uint8_t base_mode, uint32_t custom_mode) const
@@ -117,11 +111,7 @@ QString APMFirmwarePlugin::flightMode(uint8_t base_mode, uint32_t custom_mode) c
     QString flightMode = "Unknown";
 
     if (base_mode & MAV_MODE_FLAG_CUSTOM_MODE_ENABLED) {
-        foreach (const APMCustomMode& customMode, _supportedModes) {
-            if (customMode.modeAsInt() == custom_mode) {
-                flightMode = customMode.modeString();
-            }
-        }
+        flightMode = _modeNames.value(custom_mode, flightMode);
     }
     return flightMode;
 }
@@ -350,6 +340,20 @@ bool APMFirmwarePlugin::adjustIncomingMavlinkMessage(Vehicle* vehicle, mavlink_m
     return true;
 }
 
+QList<uint32_t> APMFirmwarePlugin::adjustedIncomingMessageIds(void) const
+{
+    // The stream rate timeout is checked with these as well, the heartbeat keeps it going once the others stop
+    return {
+        MAVLINK_MSG_ID_HEARTBEAT,
+        MAVLINK_MSG_ID_BATTERY_STATUS,
+        MAVLINK_MSG_ID_HOME_POSITION,
+        MAVLINK_MSG_ID_PARAM_VALUE,
+        MAVLINK_MSG_ID_STATUSTEXT,
+        MAVLINK_MSG_ID_RC_CHANNELS,
+        MAVLINK_MSG_ID_RC_CHANNELS_RAW,
+    };
+}
+
 void APMFirmwarePlugin::adjustOutgoingMavlinkMessageThreadSafe(Vehicle* vehicle, LinkInterface* outgoingLink, mavlink_message_t* message)
 {
     switch (message->msgid) {
@@ -495,6 +499,17 @@ void APMFirmwarePlugin::initializeVehicle(Vehicle* vehicle)
 void APMFirmwarePlugin::setSupportedModes(QList<APMCustomMode> supportedModes)
 {
     _supportedModes = supportedModes;
+
+    // Mode names are looked up for every heartbeat of every vehicle, so the strings are built once here
+    _settableModeNames.clear();
+    _modeNames.clear();
+    for (const APMCustomMode& customMode : std::as_const(_supportedModes)) {
+        const QString modeString = customMode.modeString();
+        if (customMode.canBeSet()) {
+            _settableModeNames.append(modeString);
+        }
+        _modeNames[customMode.modeAsInt()] = modeString;
+    }
 }
 
 bool APMFirmwarePlugin::sendHomePositionToVehicle(void)
@@ -14,6 +14,7 @@
 #include "FollowMe.h"
 
 #include <QtNetwork/QAbstractSocket>
+#include <QtCore/QHash>
 #include <QtCore/QMutex>
 #include <QtCore/QLoggingCategory>
 
@@ -68,10 +69,12 @@ public:
     void                guidedModeChangeAltitude        (Vehicle* vehicle, double altitudeChange, bool pauseVehicle) override;
     void                guidedModeChangeHeading         (Vehicle* vehicle, const QGeoCoordinate &headingCoord) override;
     bool                adjustIncomingMavlinkMessage    (Vehicle* vehicle, mavlink_message_t* message) override;
+    QList<uint32_t>     adjustedIncomingMessageIds      (void) const override;
     void                adjustOutgoingMavlinkMessageThreadSafe(Vehicle* vehicle, LinkInterface* outgoingLink, mavlink_message_t* message) override;
     virtual void        initializeStreamRates           (Vehicle* vehicle);
     void                initializeVehicle               (Vehicle* vehicle) override;
     bool                sendHomePositionToVehicle       (void) override;
+    bool                supportsPartialMissionWrite     (void) const override { return true; }
     QString             missionCommandOverrides         (QGCMAVLink::VehicleClass_t vehicleClass) const override;
     QString             _internalParameterMetaDataFile  (const Vehicle* vehicle) const override;
     FactMetaData*       _getMetaDataForFact             (QObject* parameterMetaData, const QString& name, FactMetaData::ValueType_t type, MAV_TYPE vehicleType) override;
@@ -133,6 +136,8 @@ private:
 
     QVariantList            _toolIndicatorList;
     QList<APMCustomMode>    _supportedModes;
+    QStringList             _settableModeNames;     ///< Built once from _supportedModes, shared by all vehicles
+    QHash<uint32_t, QString> _modeNames;            ///< Custom mode to name, built once from _supportedModes
     QMap<int /* vehicle id */, QMap<int /* componentId */, bool /* true: component is part of ArduPilot stack */>> _ardupilotComponentMap;
 
     QMutex _adjustOutgoingMavlinkMutex;
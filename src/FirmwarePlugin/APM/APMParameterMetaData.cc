@@ -140,6 +140,11 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
     }
     _parameterMetaDataLoaded = true;
 
+    if (_compiledMetaData.open(metaDataFile)) {
+        qCDebug(APMParameterMetaDataLog) << "Using compiled parameter meta data:" << metaDataFile;
+        return;
+    }
+
     QString currentCategory;
 
     qCDebug(APMParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
@@ -302,6 +307,66 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         }
         xml.readNext();
     }
+
+    // Later connects map the compiled meta data instead of parsing the xml again
+    QList<CompiledParameterMetaData::RawMetaData> compiledParameters;
+    for (auto categoryIt = _vehicleTypeToParametersMap.constBegin(); categoryIt != _vehicleTypeToParametersMap.constEnd(); categoryIt++) {
+        for (const APMFactMetaDataRaw* rawMetaData : categoryIt.value()) {
+            CompiledParameterMetaData::RawMetaData compiledParameter;
+            compiledParameter.scope             = categoryIt.key();
+            compiledParameter.name              = rawMetaData->name;
+            compiledParameter.category          = rawMetaData->category;
+            compiledParameter.group             = rawMetaData->group;
+            compiledParameter.shortDescription  = rawMetaData->shortDescription;
+            compiledParameter.longDescription   = rawMetaData->longDescription;
+            compiledParameter.min               = rawMetaData->min;
+            compiledParameter.max               = rawMetaData->max;
+            compiledParameter.increment         = rawMetaData->incrementSize;
+            compiledParameter.units             = rawMetaData->units;
+            compiledParameter.values            = rawMetaData->values;
+            compiledParameter.bitmask           = rawMetaData->bitmask;
+            if (rawMetaData->rebootRequired) {
+                compiledParameter.flags |= CompiledParameterMetaData::FlagRebootRequired;
+            }
+            if (rawMetaData->readOnly) {
+                compiledParameter.flags |= CompiledParameterMetaData::FlagReadOnly;
+            }
+            compiledParameters.append(compiledParameter);
+        }
+    }
+    (void) _compiledMetaData.compile(metaDataFile, compiledParameters);
+}
+
+/// @return Raw meta data read from the xml or the compiled meta data, nullptr if not available
+APMFactMetaDataRaw* APMParameterMetaData::_rawMetaData(const QString& category, const QString& name)
+{
+    ParameterNametoFactMetaDataMap& parameterMap = _vehicleTypeToParametersMap[category];
+    if (parameterMap.contains(name)) {
+        return parameterMap[name];
+    }
+
+    CompiledParameterMetaData::RawMetaData compiledParameter;
+    if (!_compiledMetaData.find(category, name, compiledParameter)) {
+        return nullptr;
+    }
+
+    APMFactMetaDataRaw* rawMetaData = new APMFactMetaDataRaw(this);
+    rawMetaData->name               = compiledParameter.name;
+    rawMetaData->category           = compiledParameter.category;
+    rawMetaData->group              = compiledParameter.group;
+    rawMetaData->shortDescription   = compiledParameter.shortDescription;
+    rawMetaData->longDescription    = compiledParameter.longDescription;
+    rawMetaData->min                = compiledParameter.min;
+    rawMetaData->max                = compiledParameter.max;
+    rawMetaData->incrementSize      = compiledParameter.increment;
+    rawMetaData->units              = compiledParameter.units;
+    rawMetaData->rebootRequired     = compiledParameter.flags & CompiledParameterMetaData::FlagRebootRequired;
+    rawMetaData->readOnly           = compiledParameter.flags & CompiledParameterMetaData::FlagReadOnly;
+    rawMetaData->values             = compiledParameter.values;
+    rawMetaData->bitmask            = compiledParameter.bitmask;
+    parameterMap[name] = rawMetaData;
+
+    return rawMetaData;
 }
 
 void APMParameterMetaData::correctGroupMemberships(ParameterNametoFactMetaDataMap& parameterToFactMetaDataMap,
@@ -428,6 +493,17 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
 }
 
 FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type)
+{
+    const QString cacheKey = QStringLiteral("%1:%2:%3").arg(vehicleType).arg(type).arg(name);
+    FactMetaData* metaData = _factMetaDataCache.value(cacheKey);
+    if (!metaData) {
+        metaData = _createMetaDataForFact(name, vehicleType, type);
+        _factMetaDataCache[cacheKey] = metaData;
+    }
+    return metaData;
+}
+
+FactMetaData* APMParameterMetaData::_createMetaDataForFact(const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type)
 {
     bool                keepTrying      = true;
     QString             mavTypeString   = mavTypeToString(vehicleType);
@@ -435,10 +511,9 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
 
     // check if we have metadata for fact, use generic otherwise
     while (keepTrying) {
-        if (_vehicleTypeToParametersMap[mavTypeString].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap[mavTypeString][name];
-        } else if (_vehicleTypeToParametersMap["libraries"].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap["libraries"][name];
+        rawMetaData = _rawMetaData(mavTypeString, name);
+        if (!rawMetaData) {
+            rawMetaData = _rawMetaData(QStringLiteral("libraries"), name);
         }
         if (!rawMetaData && mavTypeString == "Rover") {
             // Hack city: Older versions of Rover have different name
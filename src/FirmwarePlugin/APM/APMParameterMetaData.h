@@ -11,12 +11,14 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QLoggingCategory>
 
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "CompiledParameterMetaData.h"
 
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataLog)
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataVerboseLog)
@@ -26,7 +28,7 @@ class APMFactMetaDataRaw : public QObject
     Q_OBJECT
 public:
     APMFactMetaDataRaw(QObject *parent = nullptr)
-        : QObject(parent), rebootRequired(false)
+        : QObject(parent), rebootRequired(false), readOnly(false)
     { }
 
     QString name;
@@ -56,6 +58,7 @@ class APMParameterMetaData : public QObject
 public:
     APMParameterMetaData(void);
 
+    /// @return Meta data owned by this object, the same for repeated calls with the same arguments
     FactMetaData* getMetaDataForFact(const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type);
     void loadParameterFactMetaDataFile(const QString& metaDataFile);
 
@@ -80,10 +83,14 @@ private:
     void correctGroupMemberships(ParameterNametoFactMetaDataMap& parameterToFactMetaDataMap, QMap<QString,QStringList>& groupMembers);
     QString mavTypeToString(MAV_TYPE vehicleTypeEnum);
     QString _groupFromParameterName(const QString& name);
+    APMFactMetaDataRaw* _rawMetaData(const QString& category, const QString& name);
+    FactMetaData* _createMetaDataForFact(const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type);
 
     bool                                            _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
     // FIXME: metadata is vehicle type specific now
-    QMap<QString, ParameterNametoFactMetaDataMap>   _vehicleTypeToParametersMap;                ///< Maps from a vehicle type to paramametertoFactMeta map>
+    QMap<QString, ParameterNametoFactMetaDataMap>   _vehicleTypeToParametersMap;                ///< Maps from a vehicle type to paramametertoFactMeta map>, filled on first use when the compiled meta data is used
+    CompiledParameterMetaData                       _compiledMetaData;
+    QHash<QString, FactMetaData*>                   _factMetaDataCache;                         ///< Created meta data by vehicle type, value type and name
 
     static constexpr const char* kInvalidConverstion = "Internal Error: No support for string parameters";
 };
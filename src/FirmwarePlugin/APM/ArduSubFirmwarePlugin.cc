@@ -235,21 +235,21 @@ void ArduSubFirmwarePlugin::_handleNamedValueFloat(mavlink_message_t* message)
     QString name = QString(value.name);
 
     if (name == "CamTilt") {
-        _infoFactGroup.getFact("cameraTilt")->setRawValue(value.value * 100);
+        _infoFactGroup.camTilt()->setRawValue(value.value * 100);
     } else if (name == "TetherTrn") {
-        _infoFactGroup.getFact("tetherTurns")->setRawValue(value.value);
+        _infoFactGroup.tetherTurns()->setRawValue(value.value);
     } else if (name == "Lights1") {
-        _infoFactGroup.getFact("lights1")->setRawValue(value.value * 100);
+        _infoFactGroup.lightsLevel1()->setRawValue(value.value * 100);
     } else if (name == "Lights2") {
-        _infoFactGroup.getFact("lights2")->setRawValue(value.value * 100);
+        _infoFactGroup.lightsLevel2()->setRawValue(value.value * 100);
     } else if (name == "PilotGain") {
-        _infoFactGroup.getFact("pilotGain")->setRawValue(value.value * 100);
+        _infoFactGroup.pilotGain()->setRawValue(value.value * 100);
     } else if (name == "InputHold") {
-        _infoFactGroup.getFact("inputHold")->setRawValue(value.value);
+        _infoFactGroup.inputHold()->setRawValue(value.value);
     } else if (name == "RollPitch") {
-        _infoFactGroup.getFact("rollPitchToggle")->setRawValue(value.value);
+        _infoFactGroup.rollPitchToggle()->setRawValue(value.value);
     } else if (name == "RFTarget") {
-      _infoFactGroup.getFact("rangefinderTarget")->setRawValue(value.value);
+      _infoFactGroup.rangefinderTarget()->setRawValue(value.value);
     }
 }
 
@@ -263,7 +263,7 @@ void ArduSubFirmwarePlugin::_handleMavlinkMessage(mavlink_message_t* message)
     {
         mavlink_rangefinder_t msg;
         mavlink_msg_rangefinder_decode(message, &msg);
-        _infoFactGroup.getFact("rangefinderDistance")->setRawValue(msg.distance);
+        _infoFactGroup.rangefinderDistance()->setRawValue(msg.distance);
         break;
     }
     }
@@ -275,6 +275,11 @@ bool ArduSubFirmwarePlugin::adjustIncomingMavlinkMessage(Vehicle* vehicle, mavli
     return APMFirmwarePlugin::adjustIncomingMavlinkMessage(vehicle, message);
 }
 
+QList<uint32_t> ArduSubFirmwarePlugin::adjustedIncomingMessageIds(void) const
+{
+    return APMFirmwarePlugin::adjustedIncomingMessageIds() << MAVLINK_MSG_ID_NAMED_VALUE_FLOAT << MAVLINK_MSG_ID_RANGEFINDER;
+}
+
 QMap<QString, FactGroup*>* ArduSubFirmwarePlugin::factGroups(void) {
     return &_nameToFactGroupMap;
 }
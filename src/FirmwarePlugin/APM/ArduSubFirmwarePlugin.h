@@ -60,9 +60,13 @@ public:
     Fact* lightsLevel2        (void) { return &_lightsLevel2Fact; }
     Fact* pilotGain           (void) { return &_pilotGainFact; }
     Fact* inputHold           (void) { return &_inputHoldFact; }
+    Fact* rollPitchToggle     (void) { return &_rollPitchToggleFact; }
     Fact* rangefinderDistance (void) { return &_rangefinderDistanceFact; }
     Fact* rangefinderTarget   (void) { return &_rangefinderTargetFact; }
 
+    // Overrides from FactGroup
+    QList<uint32_t> handledMessageIds(void) const override { return {}; }   ///< Updated by ArduSubFirmwarePlugin
+
     static const char* _camTiltFactName;
     static const char* _tetherTurnsFactName;
     static const char* _lightsLevel1FactName;
@@ -152,6 +156,7 @@ public:
     const QVariantList& toolIndicators(const Vehicle* vehicle) final;
     const QVariantList& modeIndicators(const Vehicle* vehicle) final;
     bool  adjustIncomingMavlinkMessage(Vehicle* vehicle, mavlink_message_t* message) final;
+    QList<uint32_t> adjustedIncomingMessageIds(void) const final;
     virtual QMap<QString, FactGroup*>* factGroups(void) final;
     void adjustMetaData(MAV_TYPE vehicleType, FactMetaData* metaData) override final;
 
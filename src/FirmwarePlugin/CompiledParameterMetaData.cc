@@ -0,0 +1,334 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CompiledParameterMetaData.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cstddef>
+
+QGC_LOGGING_CATEGORY(CompiledParameterMetaDataLog, "CompiledParameterMetaDataLog")
+
+CompiledParameterMetaData::~CompiledParameterMetaData()
+{
+    _close();
+}
+
+void CompiledParameterMetaData::_close()
+{
+    if (_data) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+        _data = nullptr;
+    }
+    _file.close();
+    _size = 0;
+}
+
+QString CompiledParameterMetaData::_compiledFileName(const QString& metaDataFile, QByteArray& content)
+{
+    QFile sourceFile(metaDataFile);
+    if (!sourceFile.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    content = sourceFile.readAll();
+
+    const QByteArray hash = QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex().left(16);
+    const QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/ParameterMetaData"));
+
+    return cacheDir.absoluteFilePath(QStringLiteral("%1.%2.bin").arg(QFileInfo(metaDataFile).completeBaseName(), QString::fromLatin1(hash)));
+}
+
+quint32 CompiledParameterMetaData::_u32(quint64 offset) const
+{
+    if (offset + sizeof(quint32) > static_cast<quint64>(_size)) {
+        return 0;
+    }
+    return qFromLittleEndian<quint32>(_data + offset);
+}
+
+QByteArrayView CompiledParameterMetaData::_string(quint32 index) const
+{
+    if (index >= _stringCount) {
+        return QByteArrayView();
+    }
+
+    const quint64 offsetsStart  = sizeof(Header_t) + (static_cast<quint64>(index) * sizeof(quint32));
+    const quint32 start         = _u32(offsetsStart);
+    const quint32 end           = _u32(offsetsStart + sizeof(quint32));
+    if ((start > end) || (_stringsOffset + static_cast<quint64>(end) > static_cast<quint64>(_size))) {
+        return QByteArrayView();
+    }
+
+    return QByteArrayView(_data + _stringsOffset + start, end - start);
+}
+
+bool CompiledParameterMetaData::open(const QString& metaDataFile)
+{
+    _close();
+
+    QByteArray content;
+    const QString compiledFileName = _compiledFileName(metaDataFile, content);
+    if (compiledFileName.isEmpty() || !QFile::exists(compiledFileName)) {
+        return false;
+    }
+
+    _file.setFileName(compiledFileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qCWarning(CompiledParameterMetaDataLog) << "Unable to open" << compiledFileName << _file.errorString();
+        return false;
+    }
+    _size = _file.size();
+    if (_size < static_cast<qint64>(sizeof(Header_t))) {
+        _close();
+        return false;
+    }
+    _data = _file.map(0, _size);
+    if (!_data) {
+        qCWarning(CompiledParameterMetaDataLog) << "Unable to map" << compiledFileName << _file.errorString();
+        _close();
+        return false;
+    }
+
+    _stringCount        = _u32(offsetof(Header_t, stringCount));
+    _parameterCount     = _u32(offsetof(Header_t, parameterCount));
+    _valueCount         = _u32(offsetof(Header_t, valueCount));
+    _stringsOffset      = _u32(offsetof(Header_t, stringsOffset));
+    _parametersOffset   = _u32(offsetof(Header_t, parametersOffset));
+    _valuesOffset       = _u32(offsetof(Header_t, valuesOffset));
+
+    const bool valid = (_u32(offsetof(Header_t, magic)) == kMagic) &&
+                       (_u32(offsetof(Header_t, version)) == kVersion) &&
+                       (_stringsOffset >= sizeof(Header_t) + ((static_cast<quint64>(_stringCount) + 1) * sizeof(quint32))) &&
+                       (_parametersOffset + (static_cast<quint64>(_parameterCount) * sizeof(Parameter_t)) <= static_cast<quint64>(_size)) &&
+                       (_valuesOffset + (static_cast<quint64>(_valueCount) * sizeof(Value_t)) <= static_cast<quint64>(_size));
+    if (!valid) {
+        qCWarning(CompiledParameterMetaDataLog) << "Invalid compiled meta data" << compiledFileName;
+        _close();
+        (void) QFile::remove(compiledFileName);
+        return false;
+    }
+
+    qCDebug(CompiledParameterMetaDataLog) << "Mapped" << compiledFileName << "parameters:" << _parameterCount << "strings:" << _stringCount;
+
+    return true;
+}
+
+bool CompiledParameterMetaData::compile(const QString& metaDataFile, const QList<RawMetaData>& parameters)
+{
+    _close();
+
+    QByteArray content;
+    const QString compiledFileName = _compiledFileName(metaDataFile, content);
+    if (compiledFileName.isEmpty()) {
+        return false;
+    }
+
+    QList<QByteArray>           strings;
+    QHash<QString, quint32>     stringIndices;
+    const auto intern = [&strings, &stringIndices](const QString& string) -> quint32 {
+        auto it = stringIndices.constFind(string);
+        if (it == stringIndices.constEnd()) {
+            it = stringIndices.insert(string, static_cast<quint32>(strings.count()));
+            strings.append(string.toUtf8());
+        }
+        return it.value();
+    };
+    (void) intern(QString());
+
+    // Records are serialized in key order, so the lookup can binary search the mapped file
+    QList<QPair<QByteArray, QByteArray>> keys;
+    QList<qsizetype> order;
+    for (qsizetype i = 0; i < parameters.count(); i++) {
+        keys.append(QPair<QByteArray, QByteArray>(parameters[i].scope.toUtf8(), parameters[i].name.toUtf8()));
+        order.append(i);
+    }
+    std::sort(order.begin(), order.end(), [&keys](qsizetype a, qsizetype b) { return keys[a] < keys[b]; });
+
+    QByteArray      parameterBytes;
+    QByteArray      valueBytes;
+    quint32         valueCount = 0;
+    const auto appendU32 = [](QByteArray& bytes, quint32 value) {
+        const quint32 littleEndian = qToLittleEndian(value);
+        bytes.append(reinterpret_cast<const char*>(&littleEndian), sizeof(littleEndian));
+    };
+    const auto appendU16 = [](QByteArray& bytes, quint16 value) {
+        const quint16 littleEndian = qToLittleEndian(value);
+        bytes.append(reinterpret_cast<const char*>(&littleEndian), sizeof(littleEndian));
+    };
+
+    for (const qsizetype i : order) {
+        const RawMetaData& raw = parameters[i];
+        const QString* const fields[FieldCount] = {
+            &raw.scope, &raw.name, &raw.type, &raw.category, &raw.group, &raw.shortDescription, &raw.longDescription,
+            &raw.min, &raw.max, &raw.defaultValue, &raw.increment, &raw.units, &raw.decimalPlaces,
+        };
+
+        const quint16 enumCount     = static_cast<quint16>(qMin<qsizetype>(raw.values.count(), 0xffff));
+        const quint16 bitmaskCount  = static_cast<quint16>(qMin<qsizetype>(raw.bitmask.count(), 0xffff));
+
+        for (const QString* field : fields) {
+            appendU32(parameterBytes, intern(*field));
+        }
+        appendU32(parameterBytes, raw.flags);
+        appendU32(parameterBytes, valueCount);
+        appendU16(parameterBytes, enumCount);
+        appendU16(parameterBytes, bitmaskCount);
+
+        for (quint16 j = 0; j < enumCount; j++) {
+            appendU32(valueBytes, intern(raw.values[j].first));
+            appendU32(valueBytes, intern(raw.values[j].second));
+        }
+        for (quint16 j = 0; j < bitmaskCount; j++) {
+            appendU32(valueBytes, intern(raw.bitmask[j].first));
+            appendU32(valueBytes, intern(raw.bitmask[j].second));
+        }
+        valueCount += enumCount + bitmaskCount;
+    }
+
+    QByteArray stringOffsets;
+    QByteArray stringBytes;
+    for (const QByteArray& string : strings) {
+        appendU32(stringOffsets, static_cast<quint32>(stringBytes.size()));
+        stringBytes.append(string);
+    }
+    appendU32(stringOffsets, static_cast<quint32>(stringBytes.size()));
+    while (stringBytes.size() % sizeof(quint32)) {
+        stringBytes.append('\0');
+    }
+
+    const quint32 stringsOffset     = sizeof(Header_t) + stringOffsets.size();
+    const quint32 parametersOffset  = stringsOffset + stringBytes.size();
+    const quint32 valuesOffset      = parametersOffset + parameterBytes.size();
+
+    QByteArray header;
+    appendU32(header, kMagic);
+    appendU32(header, kVersion);
+    appendU32(header, static_cast<quint32>(strings.count()));
+    appendU32(header, static_cast<quint32>(order.count()));
+    appendU32(header, valueCount);
+    appendU32(header, stringsOffset);
+    appendU32(header, parametersOffset);
+    appendU32(header, valuesOffset);
+
+    const QFileInfo compiledFileInfo(compiledFileName);
+    if (!QDir().mkpath(compiledFileInfo.absolutePath())) {
+        qCWarning(CompiledParameterMetaDataLog) << "Unable to create" << compiledFileInfo.absolutePath();
+        return false;
+    }
+
+    QSaveFile file(compiledFileName);
+    if (!file.open(QIODevice::WriteOnly) ||
+            (file.write(header) != header.size()) ||
+            (file.write(stringOffsets) != stringOffsets.size()) ||
+            (file.write(stringBytes) != stringBytes.size()) ||
+            (file.write(parameterBytes) != parameterBytes.size()) ||
+            (file.write(valueBytes) != valueBytes.size()) ||
+            !file.commit()) {
+        qCWarning(CompiledParameterMetaDataLog) << "Unable to write" << compiledFileName << file.errorString();
+        return false;
+    }
+
+    // Compiled forms of previous versions of the source file are not used anymore
+    const QDir compiledDir = compiledFileInfo.absoluteDir();
+    const QStringList staleFiles = compiledDir.entryList({ QFileInfo(metaDataFile).completeBaseName() + QStringLiteral(".*.bin") }, QDir::Files);
+    for (const QString& staleFile : staleFiles) {
+        if (staleFile != compiledFileInfo.fileName()) {
+            (void) compiledDir.remove(staleFile);
+        }
+    }
+
+    qCDebug(CompiledParameterMetaDataLog) << "Compiled" << metaDataFile << "to" << compiledFileName;
+
+    return open(metaDataFile);
+}
+
+int CompiledParameterMetaData::_compareKey(quint32 index, QByteArrayView scope, QByteArrayView name) const
+{
+    const uchar* const parameter = _parameter(index);
+    const int scopeCompare = _string(qFromLittleEndian<quint32>(parameter + (FieldScope * sizeof(quint32)))).compare(scope);
+    if (scopeCompare != 0) {
+        return scopeCompare;
+    }
+    return _string(qFromLittleEndian<quint32>(parameter + (FieldName * sizeof(quint32)))).compare(name);
+}
+
+bool CompiledParameterMetaData::find(const QString& scope, const QString& name, RawMetaData& rawMetaData) const
+{
+    if (!_data) {
+        return false;
+    }
+
+    const QByteArray scopeUtf8  = scope.toUtf8();
+    const QByteArray nameUtf8   = name.toUtf8();
+
+    quint32 first   = 0;
+    quint32 count   = _parameterCount;
+    while (count > 0) {
+        const quint32 step = count / 2;
+        if (_compareKey(first + step, scopeUtf8, nameUtf8) < 0) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    if ((first >= _parameterCount) || (_compareKey(first, scopeUtf8, nameUtf8) != 0)) {
+        return false;
+    }
+
+    const uchar* const parameter = _parameter(first);
+    const auto field = [this, parameter](int index) -> QString {
+        return QString::fromUtf8(_string(qFromLittleEndian<quint32>(parameter + (index * sizeof(quint32)))));
+    };
+
+    rawMetaData = RawMetaData();
+    rawMetaData.scope               = scope;
+    rawMetaData.name                = name;
+    rawMetaData.type                = field(FieldType);
+    rawMetaData.category            = field(FieldCategory);
+    rawMetaData.group               = field(FieldGroup);
+    rawMetaData.shortDescription    = field(FieldShortDescription);
+    rawMetaData.longDescription     = field(FieldLongDescription);
+    rawMetaData.min                 = field(FieldMin);
+    rawMetaData.max                 = field(FieldMax);
+    rawMetaData.defaultValue        = field(FieldDefaultValue);
+    rawMetaData.increment           = field(FieldIncrement);
+    rawMetaData.units               = field(FieldUnits);
+    rawMetaData.decimalPlaces       = field(FieldDecimalPlaces);
+    rawMetaData.flags               = qFromLittleEndian<quint32>(parameter + offsetof(Parameter_t, flags));
+
+    const quint32 firstValue    = qFromLittleEndian<quint32>(parameter + offsetof(Parameter_t, firstValue));
+    const quint16 enumCount     = qFromLittleEndian<quint16>(parameter + offsetof(Parameter_t, valueCount));
+    const quint16 bitmaskCount  = qFromLittleEndian<quint16>(parameter + offsetof(Parameter_t, bitmaskCount));
+    if (static_cast<quint64>(firstValue) + enumCount + bitmaskCount > _valueCount) {
+        qCWarning(CompiledParameterMetaDataLog) << "Invalid value range for" << name;
+        return true;
+    }
+
+    for (quint32 i = 0; i < static_cast<quint32>(enumCount) + bitmaskCount; i++) {
+        const quint64 valueOffset = _valuesOffset + ((static_cast<quint64>(firstValue) + i) * sizeof(Value_t));
+        const QPair<QString, QString> value(QString::fromUtf8(_string(_u32(valueOffset + offsetof(Value_t, code)))),
+                                            QString::fromUtf8(_string(_u32(valueOffset + offsetof(Value_t, description)))));
+        if (i < enumCount) {
+            rawMetaData.values.append(value);
+        } else {
+            rawMetaData.bitmask.append(value);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArrayView>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+
+Q_DECLARE_LOGGING_CATEGORY(CompiledParameterMetaDataLog)
+
+/// Binary form of a firmware parameter meta data file, written the first time the file is parsed. Strings are
+/// stored once in a string table and the parameters are sorted by scope and name, so the compiled file is mapped
+/// and searched in place. A firmware plugin only builds FactMetaData for the parameters the vehicle actually has.
+/// The compiled file is keyed by the content of the source file, a changed source file is compiled again.
+class CompiledParameterMetaData
+{
+    friend class CompiledParameterMetaDataTest;
+
+public:
+    /// Parameter meta data as found in the source file, values are not converted to the parameter type yet
+    struct RawMetaData {
+        QString scope;                                  ///< Vehicle type the meta data belongs to, empty if not vehicle specific
+        QString name;
+        QString type;
+        QString category;
+        QString group;
+        QString shortDescription;
+        QString longDescription;
+        QString min;
+        QString max;
+        QString defaultValue;
+        QString increment;
+        QString units;
+        QString decimalPlaces;
+        quint32 flags = 0;
+        QList<QPair<QString, QString>> values;          ///< Enum code, description
+        QList<QPair<QString, QString>> bitmask;         ///< Bit index, description
+    };
+
+    enum Flags {
+        FlagRebootRequired  = 1 << 0,
+        FlagReadOnly        = 1 << 1,
+        FlagVolatile        = 1 << 2,
+        FlagBoolean         = 1 << 3,                   ///< Enabled/Disabled enum, added translated when the meta data is created
+        FlagDuplicate       = 1 << 4,                   ///< Defined more than once in the source file, meta data can't be trusted
+    };
+
+    CompiledParameterMetaData() = default;
+    ~CompiledParameterMetaData();
+
+    /// Maps the compiled form of the meta data file
+    ///     @return false: The file was not compiled yet or its content changed since
+    bool open(const QString& metaDataFile);
+
+    /// Writes the compiled form of the meta data file and maps it
+    bool compile(const QString& metaDataFile, const QList<RawMetaData>& parameters);
+
+    bool isOpen() const { return _data != nullptr; }
+
+    /// @return false: No meta data for the parameter
+    bool find(const QString& scope, const QString& name, RawMetaData& rawMetaData) const;
+
+private:
+    typedef struct {
+        quint32 magic;
+        quint32 version;
+        quint32 stringCount;
+        quint32 parameterCount;
+        quint32 valueCount;
+        quint32 stringsOffset;                          ///< Start of the string bytes, the string offsets directly follow the header
+        quint32 parametersOffset;
+        quint32 valuesOffset;
+    } Header_t;
+
+    enum StringField {
+        FieldScope,
+        FieldName,
+        FieldType,
+        FieldCategory,
+        FieldGroup,
+        FieldShortDescription,
+        FieldLongDescription,
+        FieldMin,
+        FieldMax,
+        FieldDefaultValue,
+        FieldIncrement,
+        FieldUnits,
+        FieldDecimalPlaces,
+        FieldCount
+    };
+
+    /// All strings are string table indices, values and bitmask are ranges of the value table
+    typedef struct {
+        quint32 strings[FieldCount];
+        quint32 flags;
+        quint32 firstValue;
+        quint16 valueCount;
+        quint16 bitmaskCount;                           ///< Bitmask entries follow the enum values
+    } Parameter_t;
+
+    typedef struct {
+        quint32 code;
+        quint32 description;
+    } Value_t;
+
+    void _close();
+    quint32 _u32(quint64 offset) const;
+    QByteArrayView _string(quint32 index) const;
+    const uchar* _parameter(quint32 index) const { return _data + _parametersOffset + (static_cast<quint64>(index) * sizeof(Parameter_t)); }
+    int _compareKey(quint32 index, QByteArrayView scope, QByteArrayView name) const;
+    static QString _compiledFileName(const QString& metaDataFile, QByteArray& content);
+
+    QFile           _file;
+    const uchar*    _data               = nullptr;
+    qint64          _size               = 0;
+    quint32         _stringCount        = 0;
+    quint32         _parameterCount     = 0;
+    quint32         _valueCount         = 0;
+    quint32         _stringsOffset      = 0;
+    quint32         _parametersOffset   = 0;
+    quint32         _valuesOffset       = 0;
+
+    static constexpr quint32 kMagic     = 0x4d504751;  ///< "QGPM"
+    static constexpr quint32 kVersion   = 1;
+};
@@ -22,6 +22,7 @@
 #include "QGC.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QFileInfo>
 #include <QtCore/QRegularExpression>
 
 QGC_LOGGING_CATEGORY(FirmwarePluginLog, "FirmwarePluginLog")
@@ -195,6 +196,25 @@ void FirmwarePlugin::_getParameterMetaDataVersionInfo(const QString& metaDataFil
     minorVersion = -1;
 }
 
+void FirmwarePlugin::_cachedParameterMetaDataVersionInfo(const QString& metaDataFile, int& majorVersion, int& minorVersion)
+{
+    // A cached meta data file can be replaced by a newer one with the same name while QGC is running
+    const QFileInfo fileInfo(metaDataFile);
+    const QString cacheKey = QStringLiteral("%1:%2:%3").arg(metaDataFile).arg(fileInfo.size()).arg(fileInfo.lastModified().toMSecsSinceEpoch());
+
+    QMutexLocker locker(&_versionInfoCacheMutex);
+
+    const auto it = _versionInfoCache.constFind(cacheKey);
+    if (it != _versionInfoCache.constEnd()) {
+        majorVersion = it->first;
+        minorVersion = it->second;
+        return;
+    }
+
+    _getParameterMetaDataVersionInfo(metaDataFile, majorVersion, minorVersion);
+    _versionInfoCache[cacheKey] = qMakePair(majorVersion, minorVersion);
+}
+
 bool FirmwarePlugin::isGuidedMode(const Vehicle* vehicle) const
 {
     // Not supported by generic vehicle
@@ -1131,12 +1151,17 @@ void FirmwarePlugin::sendGCSMotionReport(Vehicle *vehicle, FollowMe::GCSMotionRe
     follow_target.timestamp = qgcApp()->msecsSinceBoot();
     follow_target.est_capabilities = estimationCapabilities;
     follow_target.position_cov[0] = static_cast<float>(motionReport.pos_std_dev[0]);
+    follow_target.position_cov[1] = static_cast<float>(motionReport.pos_std_dev[1]);
     follow_target.position_cov[2] = static_cast<float>(motionReport.pos_std_dev[2]);
     follow_target.alt = static_cast<float>(motionReport.altMetersAMSL);
     follow_target.lat = motionReport.lat_int;
     follow_target.lon = motionReport.lon_int;
     follow_target.vel[0] = static_cast<float>(motionReport.vxMetersPerSec);
     follow_target.vel[1] = static_cast<float>(motionReport.vyMetersPerSec);
+    follow_target.vel[2] = static_cast<float>(motionReport.vzMetersPerSec);
+    follow_target.acc[0] = static_cast<float>(motionReport.axMetersPerSec2);
+    follow_target.acc[1] = static_cast<float>(motionReport.ayMetersPerSec2);
+    follow_target.acc[2] = static_cast<float>(motionReport.azMetersPerSec2);
 
     mavlink_message_t message;
     mavlink_msg_follow_target_encode_chan(
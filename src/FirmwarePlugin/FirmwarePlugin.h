@@ -10,7 +10,10 @@
 #pragma once
 /// @file
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
 #include <QtCore/QString>
 #include <QtCore/QVariantList>
 #include <QtPositioning/QGeoCoordinate>
@@ -218,9 +221,14 @@ public:
     /// spec implementations such that the base code can remain mavlink generic.
     ///     @param vehicle Vehicle message came from
     ///     @param message[in,out] Mavlink message to adjust if needed.
+    /// Only called for the message ids returned by adjustedIncomingMessageIds.
     /// @return false: skip message, true: process message
     virtual bool adjustIncomingMavlinkMessage(Vehicle* vehicle, mavlink_message_t* message);
 
+    /// Message ids adjustIncomingMavlinkMessage looks at, MAVLinkMsgIdFilter::allIds for all messages. Plugins which
+    /// override adjustIncomingMavlinkMessage must override this as well. Read once when the Vehicle is created.
+    virtual QList<uint32_t> adjustedIncomingMessageIds(void) const { return QList<uint32_t>(); }
+
     /// Called before any mavlink message is sent to the Vehicle so plugin can adjust any message characteristics.
     /// This is handy to adjust or differences in mavlink spec implementations such that the base code can remain
     /// mavlink generic.
@@ -240,11 +248,18 @@ public:
     ///     false: Do not send first item to vehicle, sequence numbers must be adjusted
     virtual bool sendHomePositionToVehicle(void);
 
+    /// @return true: Vehicle accepts MISSION_WRITE_PARTIAL_LIST to replace a range of mission items in place
+    virtual bool supportsPartialMissionWrite(void) const { return false; }
+
     /// Returns the parameter set version info pulled from inside the meta data file. -1 if not found.
     /// Note: The implementation for this must not vary by vehicle type.
     /// Important: Only CompInfoParam code should use this method
     virtual void _getParameterMetaDataVersionInfo(const QString& metaDataFile, int& majorVersion, int& minorVersion);
 
+    /// _getParameterMetaDataVersionInfo, read once per file content and then shared by all vehicles. Thread safe.
+    /// Important: Only CompInfoParam code should use this method
+    void _cachedParameterMetaDataVersionInfo(const QString& metaDataFile, int& majorVersion, int& minorVersion);
+
     /// Returns the internal resource parameter meta date file.
     /// Important: Only CompInfoParam code should use this method
     virtual QString _internalParameterMetaDataFile(const Vehicle* /*vehicle*/) const { return QString(); }
@@ -388,4 +403,8 @@ protected:
     QVariantList _modeIndicatorList;
 
     static QVariantList _cameraList;    ///< Standard QGC camera list
+
+private:
+    QMutex                          _versionInfoCacheMutex;
+    QHash<QString, QPair<int, int>> _versionInfoCache;          ///< Major, minor version keyed by file, size and modification time
 };
@@ -141,25 +141,45 @@ QList<VehicleComponent*> PX4FirmwarePlugin::componentsForVehicle(AutoPilotPlugin
     return QList<VehicleComponent*>();
 }
 
-QStringList PX4FirmwarePlugin::flightModes(Vehicle* vehicle)
+void PX4FirmwarePlugin::_buildModeTables(void) const
 {
-    QStringList flightModes;
-
-    foreach (const FlightModeInfo_t& info, _flightModeInfoList) {
-        if (info.canBeSet) {
-            bool fw = (vehicle->fixedWing() && info.fixedWing);
-            bool mc = (vehicle->multiRotor() && info.multiRotor);
+    if (_modeTablesBuilt) {
+        return;
+    }
+    _modeTablesBuilt = true;
 
-            // show all modes for generic, vtol, etc
-            bool other = !vehicle->fixedWing() && !vehicle->multiRotor();
+    for (const FlightModeInfo_t& info : _flightModeInfoList) {
+        union px4_custom_mode px4_mode;
+        px4_mode.data = 0;
+        px4_mode.main_mode = info.main_mode;
+        px4_mode.sub_mode = info.sub_mode;
+        if (!_modeNames.contains(px4_mode.data)) {
+            _modeNames[px4_mode.data] = *info.name;
+        }
 
-            if (fw || mc || other) {
-                flightModes += *info.name;
+        if (info.canBeSet) {
+            if (info.fixedWing) {
+                _settableModeNames[ModeTableFixedWing].append(*info.name);
+            }
+            if (info.multiRotor) {
+                _settableModeNames[ModeTableMultiRotor].append(*info.name);
             }
+            // show all modes for generic, vtol, etc
+            _settableModeNames[ModeTableOther].append(*info.name);
         }
     }
+}
+
+QStringList PX4FirmwarePlugin::flightModes(Vehicle* vehicle)
+{
+    _buildModeTables();
 
-    return flightModes;
+    if (vehicle->fixedWing()) {
+        return _settableModeNames[ModeTableFixedWing];
+    } else if (vehicle->multiRotor()) {
+        return _settableModeNames[ModeTableMultiRotor];
+    }
+    return _settableModeNames[ModeTableOther];
 }
 
 QString PX4FirmwarePlugin::flightMode(uint8_t base_mode, uint32_t custom_mode) const
@@ -167,22 +187,23 @@ QString PX4FirmwarePlugin::flightMode(uint8_t base_mode, uint32_t custom_mode) c
     QString flightMode = "Unknown";
 
     if (base_mode & MAV_MODE_FLAG_CUSTOM_MODE_ENABLED) {
+        _buildModeTables();
+
         union px4_custom_mode px4_mode;
         px4_mode.data = custom_mode;
 
-        bool found = false;
-        foreach (const FlightModeInfo_t& info, _flightModeInfoList) {
-            if (info.main_mode == px4_mode.main_mode && info.sub_mode == px4_mode.sub_mode) {
-                flightMode = *info.name;
-                found = true;
-                break;
-            }
-        }
+        // The table is keyed without the reserved byte, which is not used to identify a mode
+        union px4_custom_mode px4_key;
+        px4_key.data = 0;
+        px4_key.main_mode = px4_mode.main_mode;
+        px4_key.sub_mode = px4_mode.sub_mode;
 
-        if (!found) {
+        const auto it = _modeNames.constFind(px4_key.data);
+        if (it == _modeNames.constEnd()) {
             qWarning() << "Unknown flight mode" << custom_mode;
             return tr("Unknown %1:%2").arg(base_mode).arg(custom_mode);
         }
+        flightMode = *it;
     }
 
     return flightMode;
@@ -12,6 +12,8 @@
 #include "FirmwarePlugin.h"
 #include "QGCMAVLink.h"
 
+#include <QtCore/QHash>
+
 class PX4FirmwarePlugin : public FirmwarePlugin
 {
     Q_OBJECT
@@ -65,6 +67,7 @@ public:
     void                _getParameterMetaDataVersionInfo(const QString& metaDataFile, int& majorVersion, int& minorVersion) override;
     QObject*            _loadParameterMetaData          (const QString& metaDataFile) final;
     bool                adjustIncomingMavlinkMessage    (Vehicle* vehicle, mavlink_message_t* message) override;
+    QList<uint32_t>     adjustedIncomingMessageIds      (void) const override { return { MAVLINK_MSG_ID_AUTOPILOT_VERSION }; }
     QString             offlineEditingParamFile         (Vehicle* vehicle) override { Q_UNUSED(vehicle); return QStringLiteral(":/FirmwarePlugin/PX4/PX4.OfflineEditing.params"); }
     QString             brandImageIndoor                (const Vehicle* vehicle) const override { Q_UNUSED(vehicle); return QStringLiteral("/qmlimages/PX4/BrandImage"); }
     QString             brandImageOutdoor               (const Vehicle* vehicle) const override { Q_UNUSED(vehicle); return QStringLiteral("/qmlimages/PX4/BrandImage"); }
@@ -119,9 +122,16 @@ private:
 
     QString _getLatestVersionFileUrl        (Vehicle* vehicle) override;
     QString _versionRegex                   () override;
+    void    _buildModeTables                (void) const;
 
     // Any instance data here must be global to all vehicles
     // Vehicle specific data should go into PX4FirmwarePluginInstanceData
+
+    // Built from _flightModeInfoList on first use, after derived plugin constructors adjusted it
+    enum { ModeTableFixedWing, ModeTableMultiRotor, ModeTableOther, ModeTableCount };
+    mutable bool                        _modeTablesBuilt = false;
+    mutable QStringList                 _settableModeNames[ModeTableCount];
+    mutable QHash<uint32_t, QString>    _modeNames;     ///< px4_custom_mode with main and sub mode only, to name
 };
 
 class PX4FirmwarePluginInstanceData : public QObject
@@ -12,7 +12,9 @@
 
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "CompiledParameterMetaData.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QLoggingCategory>
 
@@ -46,15 +48,20 @@ private:
         XmlStateDone
     };
 
+    typedef CompiledParameterMetaData::RawMetaData RawMetaData_t;
+
     QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
     static void _outputFileWarning(const QString& metaDataFile, const QString& error1, const QString& error2);
+    FactMetaData* _createMetaData(const RawMetaData_t& rawMetaData);
 
 #ifdef GENERATE_PARAMETER_JSON
     void _generateParameterJson();
 #endif
 
     bool                                _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData
+    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData, created on first use
+    QHash<QString, RawMetaData_t>       _rawMetaData;                               ///< Meta data read from the xml, only kept if compiling it failed
+    CompiledParameterMetaData           _compiledMetaData;
 
     static constexpr const char* kInvalidConverstion = "Internal Error: No support for string parameters";
 
@@ -51,6 +51,24 @@ FlightMap {
     property bool   _disableVehicleTracking:    false
     property bool   _keepVehicleCentered:       pipMode ? true : false
     property bool   _saveZoomLevelSetting:      true
+    property real   _adsbVehicleSize:           pipMode ? ScreenTools.defaultFontPixelHeight : ScreenTools.defaultFontPixelHeight * 2.5
+    property real   _vehicleSize:               pipMode ? ScreenTools.defaultFontPixelHeight : ScreenTools.defaultFontPixelHeight * 3
+    property var    _batchedVehicles:           _batchedVehicleList()   // Vehicles shown as full map items while vehicles are batched
+
+    function _batchedVehicleList() {
+        var vehicles = []
+        if (!vehicleMarkerBatch.active) {
+            return vehicles
+        }
+        if (_activeVehicle) {
+            vehicles.push(_activeVehicle)
+        }
+        var hoveredVehicle = vehicleMarkerBatch.hoveredCount === 1 ? vehicleMarkerBatch.hoveredData.object : null
+        if (hoveredVehicle && hoveredVehicle !== _activeVehicle) {
+            vehicles.push(hoveredVehicle)
+        }
+        return vehicles
+    }
 
     function _adjustMapZoomForPipMode() {
         _saveZoomLevelSetting = false
@@ -248,43 +266,44 @@ FlightMap {
         showText: !pipMode
     }
 
-    // Add trajectory lines to the map
-    MapPolyline {
-        id:         trajectoryPolyline
-        line.width: 3
-        line.color: "red"
-        z:          QGroundControl.zOrderTrajectoryLines
-        visible:    !pipMode
-
-        Connections {
-            target:                 QGroundControl.multiVehicleManager
-            function onActiveVehicleChanged(activeVehicle) {
-                trajectoryPolyline.path = _activeVehicle ? _activeVehicle.trajectoryPoints.list() : []
-            }
-        }
-
-        Connections {
-            target:                             _activeVehicle ? _activeVehicle.trajectoryPoints : null
-            onPointAdded: (coordinate) =>       trajectoryPolyline.addCoordinate(coordinate)
-            onUpdateLastPoint: (coordinate) =>  trajectoryPolyline.replaceCoordinate(trajectoryPolyline.pathLength() - 1, coordinate)
-            onPointsCleared:                    trajectoryPolyline.path = []
-        }
+    // Trajectory lines of all vehicles, drawn as a single batch with the active vehicle on top
+    MapTrajectoryBatch {
+        anchors.fill:       parent
+        map:                _root
+        vehicles:           QGroundControl.multiVehicleManager.vehicles
+        highlightVehicle:   _activeVehicle
+        color:              Qt.rgba(1, 0, 0, 0.5)
+        highlightColor:     "red"
+        lineWidth:          3
+        visible:            !pipMode
+        z:                  QGroundControl.zOrderTrajectoryLines
     }
 
-    // Add the vehicles to the map
+    // Add the vehicles to the map. Once there are too many vehicles for individual map items they are drawn as a
+    // single batch, with the full visuals only for the active vehicle and the vehicle under the mouse.
     MapItemView {
-        model: QGroundControl.multiVehicleManager.vehicles
+        model: vehicleMarkerBatch.active ? undefined : QGroundControl.multiVehicleManager.vehicles
         delegate: VehicleMapItem {
             vehicle:        object
             coordinate:     object.coordinate
             map:            _root
-            size:           pipMode ? ScreenTools.defaultFontPixelHeight : ScreenTools.defaultFontPixelHeight * 3
+            size:           _vehicleSize
             z:              QGroundControl.zOrderVehicles
         }
     }
+    MapItemView {
+        model: _batchedVehicles
+        delegate: VehicleMapItem {
+            vehicle:        modelData
+            coordinate:     modelData.coordinate
+            map:            _root
+            size:           _vehicleSize
+            z:              QGroundControl.zOrderVehicles + 1
+        }
+    }
     // Add distance sensor view
     MapItemView{
-        model: QGroundControl.multiVehicleManager.vehicles
+        model: vehicleMarkerBatch.active ? undefined : QGroundControl.multiVehicleManager.vehicles
         delegate: ProximityRadarMapView {
             vehicle:        object
             coordinate:     object.coordinate
@@ -292,24 +311,97 @@ FlightMap {
             z:              QGroundControl.zOrderVehicles
         }
     }
-    // Add ADSB vehicles to the map
+    MapItemView{
+        model: vehicleMarkerBatch.active && _activeVehicle ? [ _activeVehicle ] : undefined
+        delegate: ProximityRadarMapView {
+            vehicle:        modelData
+            coordinate:     modelData.coordinate
+            map:            _root
+            z:              QGroundControl.zOrderVehicles
+        }
+    }
+    // Add ADSB vehicles to the map. Once there are too many aircraft for individual map items they are drawn as a
+    // single batch, with the full visual only for the aircraft under the mouse.
     MapItemView {
-        model: QGroundControl.adsbVehicleManager.adsbVehicles
+        model: adsbMarkerBatch.active ? undefined : QGroundControl.adsbVehicleManager.adsbVehicles
         delegate: VehicleMapItem {
-            coordinate:     object.coordinate
-            altitude:       object.altitude
-            callsign:       object.callsign
-            heading:        object.heading
-            alert:          object.alert
+            coordinate:     model.coordinate
+            altitude:       model.altitude
+            callsign:       model.callsign
+            heading:        model.heading
+            alert:          model.alert
             map:            _root
-            size:           pipMode ? ScreenTools.defaultFontPixelHeight : ScreenTools.defaultFontPixelHeight * 2.5
+            size:           _adsbVehicleSize
             z:              QGroundControl.zOrderVehicles
         }
     }
 
-    // Add the items associated with each vehicles flight plan to the map
+    // Reference overlays from KML or SHP files, below all other map items
+    MapOverlayItem {
+        anchors.fill:   parent
+        map:            _root
+        z:              QGroundControl.zOrderMapItems - 2
+    }
+
+    MapMarkerBatch {
+        id:             adsbMarkerBatch
+        anchors.fill:   parent
+        map:            _root
+        model:          QGroundControl.adsbVehicleManager.adsbVehicles
+        headingRole:    "heading"
+        alertRole:      "alert"
+        shape:          MapMarkerBatch.Arrow
+        color:          QGroundControl.globalPalette.mapIndicator
+        alertColor:     "red"
+        borderColor:    "black"
+        markerSize:     _adsbVehicleSize * 0.75
+        threshold:      100
+        z:              QGroundControl.zOrderVehicles
+    }
+
+    MapMarkerBatch {
+        id:             vehicleMarkerBatch
+        anchors.fill:   parent
+        map:            _root
+        model:          QGroundControl.multiVehicleManager.vehicles
+        headingRole:    "heading.rawValue"
+        shape:          MapMarkerBatch.Arrow
+        color:          QGroundControl.globalPalette.mapIndicator
+        borderColor:    "black"
+        markerSize:     _vehicleSize * 0.5
+        clusterRadius:  ScreenTools.defaultFontPixelHeight * 2
+        threshold:      20
+        z:              QGroundControl.zOrderVehicles
+
+        // A click on a single vehicle makes it active, a click on a cluster zooms in on it
+        onClicked: (row) => {
+            var vehicle = QGroundControl.multiVehicleManager.vehicles.get(row)
+            if (hoveredCount > 1) {
+                _root.center = vehicle.coordinate
+                _root.zoomLevel = Math.min(_root.zoomLevel + 2, _root.maximumZoomLevel)
+            } else {
+                QGroundControl.multiVehicleManager.activeVehicle = vehicle
+            }
+        }
+    }
+
+    VehicleMapItem {
+        coordinate:     _hovered ? adsbMarkerBatch.hoveredData.coordinate : QtPositioning.coordinate()
+        altitude:       _hovered ? adsbMarkerBatch.hoveredData.altitude : Number.NaN
+        callsign:       _hovered ? adsbMarkerBatch.hoveredData.callsign : ""
+        heading:        _hovered ? adsbMarkerBatch.hoveredData.heading : Number.NaN
+        alert:          _hovered ? adsbMarkerBatch.hoveredData.alert : false
+        map:            _root
+        size:           _adsbVehicleSize
+        z:              QGroundControl.zOrderVehicles + 1
+
+        property bool _hovered: adsbMarkerBatch.hoveredRow >= 0
+    }
+
+    // Add the items associated with each vehicles flight plan to the map, only for the active vehicle once vehicles
+    // are batched
     Repeater {
-        model: QGroundControl.multiVehicleManager.vehicles
+        model: vehicleMarkerBatch.active ? 0 : QGroundControl.multiVehicleManager.vehicles
 
         PlanMapItems {
             map:                    _root
@@ -325,6 +417,16 @@ FlightMap {
             }
         }
     }
+    Repeater {
+        model: vehicleMarkerBatch.active && _activeVehicle ? [ _activeVehicle ] : 0
+
+        PlanMapItems {
+            map:                    _root
+            largeMapView:           !pipMode
+            planMasterController:   _planMasterController
+            vehicle:                modelData
+        }
+    }
 
     MapItemView {
         model: pipMode ? undefined : _missionController.directionArrows
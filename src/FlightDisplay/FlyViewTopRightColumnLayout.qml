@@ -24,7 +24,7 @@ ColumnLayout {
         id:                 multiVehiclePanelSelector
         Layout.alignment:   Qt.AlignTop
         spacing:            ScreenTools.defaultFontPixelWidth
-        visible:            QGroundControl.multiVehicleManager.vehicles.count > 1 && QGroundControl.corePlugin.options.flyView.showMultiVehicleList
+        visible:            (QGroundControl.multiVehicleManager.vehicles.count + QGroundControl.multiVehicleManager.overviewVehicles.count) > 1 && QGroundControl.corePlugin.options.flyView.showMultiVehicleList
 
         QGCMapPalette { id: mapPal; lightColors: true }
 
@@ -73,12 +73,73 @@ Item {
         }
     }
 
+    // Vehicles which are only monitored, selecting one connects it fully
+    Column {
+        id:                 overviewColumn
+        anchors.topMargin:  _margin
+        anchors.top:        mvCommands.bottom
+        anchors.left:       parent.left
+        anchors.right:      parent.right
+        spacing:            _margin / 2
+        visible:            QGroundControl.multiVehicleManager.overviewVehicles.count > 0
+
+        Repeater {
+            model: QGroundControl.multiVehicleManager.overviewVehicles
+
+            Rectangle {
+                width:      overviewColumn.width
+                height:     overviewRow.height + _margin
+                color:      qgcPal.missionItemEditor
+                opacity:    _rectOpacity
+                radius:     _margin
+
+                property var _state: object
+
+                RowLayout {
+                    id:                     overviewRow
+                    anchors.margins:        _margin
+                    anchors.left:           parent.left
+                    anchors.right:          parent.right
+                    anchors.verticalCenter: parent.verticalCenter
+                    spacing:                _margin * 2
+
+                    QGCLabel {
+                        text:   _state.id
+                        color:  _textColor
+                    }
+
+                    QGCLabel {
+                        Layout.fillWidth:   true
+                        text:               _state.communicationLost ? qsTr("Lost") : _state.flightMode
+                        color:              _textColor
+                        elide:              Text.ElideRight
+                    }
+
+                    QGCLabel {
+                        text:   _state.batteryRemaining >= 0 ? _state.batteryRemaining + "%" : "--"
+                        color:  _textColor
+                    }
+
+                    QGCLabel {
+                        text:   _state.healthy ? qsTr("OK") : qsTr("Unhealthy")
+                        color:  _state.healthy ? _textColor : qgcPal.colorRed
+                    }
+
+                    QGCButton {
+                        text:       qsTr("Select")
+                        onClicked:  QGroundControl.multiVehicleManager.promoteOverviewVehicle(_state.id)
+                    }
+                }
+            }
+        }
+    }
+
     QGCListView {
         id:                 missionItemEditorListView
         anchors.left:       parent.left
         anchors.right:      parent.right
         anchors.topMargin:  _margin
-        anchors.top:        mvCommands.bottom
+        anchors.top:        overviewColumn.visible ? overviewColumn.bottom : mvCommands.bottom
         anchors.bottom:     parent.bottom
         spacing:            ScreenTools.defaultFontPixelHeight / 2
         orientation:        ListView.Vertical
@@ -85,7 +85,7 @@ Item {
 
     Timer {
         id:             sendRateTimer
-        interval:       100
+        interval:       gimbalControllerSettings.LatencyCompensation.rawValue ? 1000 / gimbalControllerSettings.ControlRate.rawValue : 100
         repeat:         true
         onTriggered: {
             if (rootItem.gimbalAvailable) {
@@ -14,6 +14,7 @@ import QtPositioning
 import QGroundControl
 import QGroundControl.Controls
 import QGroundControl.FlightMap
+import QGroundControl.ScreenTools
 
 // Adds visual items associated with the Flight Plan to the map.
 // Currently only used by Fly View even though it's called PlanMapItems!
@@ -42,10 +43,29 @@ Item {
         delegate: MissionItemMapVisual {
             map:        _map
             vehicle:    _vehicle
+            batched:    missionMarkerBatch.active
             onClicked:  _guidedController.confirmAction(_guidedController.actionSetWaypoint, Math.max(object.sequenceNumber, 1))
         }
     }
 
+    // Large missions draw their simple items as a single batch, only the current item gets the full visuals
+    MapMarkerBatch {
+        id:             missionMarkerBatch
+        x:              0
+        y:              0
+        width:          _map.width
+        height:         _map.height
+        map:            _map
+        model:          largeMapView ? _missionController.visualItems : null
+        visibleRoles:   [ "isSimpleItem", "specifiesCoordinate" ]
+        color:          QGroundControl.globalPalette.mapIndicator
+        borderColor:    "white"
+        markerSize:     ScreenTools.defaultFontPixelHeight
+        threshold:      200
+
+        onClicked: (row) => { _guidedController.confirmAction(_guidedController.actionSetWaypoint, Math.max(_missionController.visualItems.get(row).sequenceNumber, 1)) }
+    }
+
     Component.onCompleted: {
         _missionLineViewComponent = missionLineViewComponent.createObject(map)
         if (_missionLineViewComponent.status === Component.Error)
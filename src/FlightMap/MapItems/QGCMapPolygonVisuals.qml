@@ -224,12 +224,21 @@ Item {
         title:          qsTr("Select Polygon File")
 
         onAcceptedForLoad: (file) => {
-            mapPolygon.loadKMLOrSHPFile(file)
-            mapFitFunctions.fitMapViewportToMissionItems()
+            mapPolygon.loadKMLOrSHPFileAsync(file)
             close()
         }
     }
 
+    Connections {
+        target: mapPolygon
+
+        function onLoadKMLOrSHPFileComplete(success) {
+            if (success) {
+                mapFitFunctions.fitMapViewportToMissionItems()
+            }
+        }
+    }
+
     QGCMenu {
         id: menu
 
@@ -17,7 +17,7 @@
 #include "AppSettings.h"
 #include "QGCLoggingCategory.h"
 
-#include <QtPositioning/QGeoPositionInfo>
+#include <QtCore/QtMath>
 
 QGC_LOGGING_CATEGORY(FollowMeLog, "qgc.followme")
 
@@ -25,11 +25,8 @@ Q_APPLICATION_STATIC(FollowMe, _followMeInstance);
 
 FollowMe::FollowMe(QObject *parent)
     : QObject(parent)
-    , _gcsMotionReportTimer(new QTimer(this))
 {
     // qCDebug(FollowMeLog) << Q_FUNC_INFO << this;
-
-    _gcsMotionReportTimer->setSingleShot(false);
 }
 
 FollowMe::~FollowMe()
@@ -46,7 +43,7 @@ void FollowMe::init()
 {
     static bool once = false;
     if (!once) {
-        (void) connect(_gcsMotionReportTimer, &QTimer::timeout, this, &FollowMe::_sendGCSMotionReport);
+        (void) connect(qgcApp()->toolbox()->qgcPositionManager(), &QGCPositionManager::motionEstimateUpdated, this, &FollowMe::_sendGCSMotionReport);
         (void) connect(qgcApp()->toolbox()->settingsManager()->appSettings()->followTarget(), &Fact::rawValueChanged, this, &FollowMe::_settingsChanged);
 
         _settingsChanged(qgcApp()->toolbox()->settingsManager()->appSettings()->followTarget()->rawValue());
@@ -79,25 +76,23 @@ void FollowMe::_settingsChanged(QVariant value)
 
 void FollowMe::_enableFollowSend()
 {
-    if (!_gcsMotionReportTimer->isActive()) {
-        _gcsMotionReportTimer->setInterval(qMin(qgcApp()->toolbox()->qgcPositionManager()->updateInterval(), kMotionUpdateInterval));
-        _gcsMotionReportTimer->start();
+    if (!_followSendEnabled) {
+        _followSendEnabled = true;
+        qgcApp()->toolbox()->qgcPositionManager()->setMotionReportInterval(kMotionUpdateInterval);
     }
 }
 
 void FollowMe::_disableFollowSend()
 {
-    if (_gcsMotionReportTimer->isActive()) {
-        _gcsMotionReportTimer->stop();
+    if (_followSendEnabled) {
+        _followSendEnabled = false;
+        qgcApp()->toolbox()->qgcPositionManager()->setMotionReportInterval(0);
     }
 }
 
-void FollowMe::_sendGCSMotionReport()
+void FollowMe::_sendGCSMotionReport(const GCSMotionEstimator::Estimate_t &estimate)
 {
-    const QGeoPositionInfo geoPositionInfo = qgcApp()->toolbox()->qgcPositionManager()->geoPositionInfo();
-    const QGeoCoordinate gcsCoordinate = geoPositionInfo.coordinate();
-
-    if (!geoPositionInfo.isValid()) {
+    if (!_followSendEnabled || !estimate.valid) {
         return;
     }
 
@@ -118,6 +113,10 @@ void FollowMe::_sendGCSMotionReport()
         return;
     }
 
+    // The estimate was made on the position thread, carry it over the time it waited for the GUI thread
+    const GCSMotionEstimator::Estimate_t current = GCSMotionEstimator::extrapolate(estimate, GCSMotionEstimator::nowMsecs());
+    const QGeoCoordinate gcsCoordinate = current.coordinate;
+
     GCSMotionReport motionReport{0};
     uint8_t estimationCapabilities = 0;
 
@@ -126,40 +125,31 @@ void FollowMe::_sendGCSMotionReport()
     motionReport.lat_int = static_cast<int>(gcsCoordinate.latitude() * 1e7);
     motionReport.lon_int = static_cast<int>(gcsCoordinate.longitude() * 1e7);
     motionReport.altMetersAMSL = gcsCoordinate.altitude();
+    motionReport.pos_std_dev[0] = current.positionStdDev[0];
+    motionReport.pos_std_dev[1] = current.positionStdDev[1];
+    motionReport.pos_std_dev[2] = current.altitudeValid ? current.positionStdDev[2] : -1;
     estimationCapabilities |= (1 << POS);
 
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::Direction)) {
-        estimationCapabilities |= (1 << HEADING);
-        motionReport.headingDegrees = geoPositionInfo.attribute(QGeoPositionInfo::Direction);
-    }
-
-    // get the current eph
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::HorizontalAccuracy)) {
-        motionReport.pos_std_dev[0] = motionReport.pos_std_dev[1] = geoPositionInfo.attribute(QGeoPositionInfo::HorizontalAccuracy);
-    }
-
-    // get the current epv
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::VerticalAccuracy)) {
-        motionReport.pos_std_dev[2] = geoPositionInfo.attribute(QGeoPositionInfo::VerticalAccuracy);
-    }
-
-    // calculate z velocity if it's available
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::VerticalSpeed)) {
-        motionReport.vzMetersPerSec = geoPositionInfo.attribute(QGeoPositionInfo::VerticalSpeed);
-    }
+    motionReport.vxMetersPerSec = current.velocity[0];
+    motionReport.vyMetersPerSec = current.velocity[1];
+    motionReport.vzMetersPerSec = current.velocity[2];
+    estimationCapabilities |= (1 << VEL);
 
-    // calculate x,y velocity if it's available
-    if (geoPositionInfo.hasAttribute(QGeoPositionInfo::Direction) && geoPositionInfo.hasAttribute(QGeoPositionInfo::GroundSpeed)) {
-        estimationCapabilities |= (1 << VEL);
+    motionReport.axMetersPerSec2 = current.acceleration[0];
+    motionReport.ayMetersPerSec2 = current.acceleration[1];
+    motionReport.azMetersPerSec2 = current.acceleration[2];
+    estimationCapabilities |= (1 << ACCEL);
 
-        const qreal direction = qDegreesToRadians(geoPositionInfo.attribute(QGeoPositionInfo::Direction));
-        const qreal velocity = geoPositionInfo.attribute(QGeoPositionInfo::GroundSpeed);
-
-        motionReport.vxMetersPerSec = cos(direction) * velocity;
-        motionReport.vyMetersPerSec = sin(direction) * velocity;
+    const double groundSpeed = qSqrt((current.velocity[0] * current.velocity[0]) + (current.velocity[1] * current.velocity[1]));
+    if (groundSpeed >= kMinHeadingSpeed) {
+        estimationCapabilities |= (1 << HEADING);
+        motionReport.headingDegrees = fmod(qRadiansToDegrees(atan2(current.velocity[1], current.velocity[0])) + 360.0, 360.0);
     } else {
-        motionReport.vxMetersPerSec = 0;
-        motionReport.vyMetersPerSec = 0;
+        const qreal gcsHeading = qgcApp()->toolbox()->qgcPositionManager()->gcsHeading();
+        if (!qIsNaN(gcsHeading)) {
+            estimationCapabilities |= (1 << HEADING);
+            motionReport.headingDegrees = gcsHeading;
+        }
     }
 
     QmlObjectListModel* const vehicles = qgcApp()->toolbox()->multiVehicleManager()->vehicles();
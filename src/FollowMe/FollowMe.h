@@ -12,9 +12,10 @@
 
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
-#include <QtCore/QTimer>
 #include <QtCore/QVariant>
 
+#include "GCSMotionEstimator.h"
+
 Q_DECLARE_LOGGING_CATEGORY(FollowMeLog)
 
 class Vehicle;
@@ -39,6 +40,9 @@ public:
         double vxMetersPerSec;  // X velocity in NED frame in meter / s
         double vyMetersPerSec;  // Y velocity in NED frame in meter / s
         double vzMetersPerSec;  // Z velocity in NED frame in meter / s
+        double axMetersPerSec2; // X acceleration in NED frame in meter / s / s
+        double ayMetersPerSec2; // Y acceleration in NED frame in meter / s / s
+        double azMetersPerSec2; // Z acceleration in NED frame in meter / s / s
         double pos_std_dev[3];  // -1 for unknown
     };
 
@@ -52,7 +56,7 @@ public:
     };
 
 private slots:
-    void _sendGCSMotionReport();
+    void _sendGCSMotionReport(const GCSMotionEstimator::Estimate_t &estimate);
     void _settingsChanged(QVariant value);
     void _vehicleAdded(Vehicle *vehicle);
     void _vehicleRemoved(Vehicle *vehicle);
@@ -69,8 +73,9 @@ private:
     void _enableFollowSend();
     bool _isFollowFlightMode(const Vehicle *vehicle, const QString &flightMode);
 
-    QTimer *_gcsMotionReportTimer = nullptr;
+    bool _followSendEnabled = false;
     FollowMode _currentMode = MODE_NEVER;
 
-    static constexpr int kMotionUpdateInterval = 250;
+    static constexpr int kMotionUpdateInterval = 100;       ///< 10 Hz, timed on the position thread
+    static constexpr double kMinHeadingSpeed = 0.5;         ///< m/s, slower the heading comes from the position source
 };
@@ -105,7 +105,12 @@ void GPSManager::connectGPS(const QString& device, const QString& gps_type)
     //create RTCM device
     _rtcmMavlink = new RTCMMavlink(*_toolbox);
 
-    connect(_gpsProvider, &GPSProvider::RTCMDataUpdate, _rtcmMavlink, &RTCMMavlink::RTCMDataUpdate);
+    connect(_gpsProvider, &GPSProvider::RTCMDataAvailable, _rtcmMavlink, [this]() {
+        QByteArray message;
+        while (_gpsProvider && _gpsProvider->takeRTCMData(message)) {
+            _rtcmMavlink->RTCMDataUpdate(message);
+        }
+    });
 
     //test: connect to position update
     connect(_gpsProvider, &GPSProvider::positionUpdate,         this, &GPSManager::GPSPositionUpdate);
@@ -22,6 +22,15 @@
 #include <QSerialPort>
 #endif
 
+#include <QtCore/QtEndian>
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_ANDROID)
+#define GPS_POLL_IO
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
 #define GPS_RECEIVE_TIMEOUT 1200
 
 //#define SIMULATE_RTCM_OUTPUT //if defined, generate simulated RTCM messages
@@ -70,6 +79,12 @@ void GPSProvider::run()
     _serial->setStopBits(QSerialPort::OneStop);
     _serial->setFlowControl(QSerialPort::NoFlowControl);
 
+#ifdef GPS_POLL_IO
+    // The thread has no event loop, so QSerialPort never reads on its own and the descriptor can be read directly
+    _serialFd = static_cast<int>(_serial->handle());
+#endif
+    _ioError = false;
+
     unsigned int baudrate;
     GPSBaseStationSupport* gpsDriver = nullptr;
 
@@ -125,11 +140,21 @@ void GPSProvider::run()
                     ++numTries;
                 }
             }
-            if (_serial->error() != QSerialPort::NoError && _serial->error() != QSerialPort::TimeoutError) {
+            if (_ioError || (_serial->error() != QSerialPort::NoError && _serial->error() != QSerialPort::TimeoutError)) {
                 break;
             }
         }
     }
+    if (gpsDriver) {
+        delete gpsDriver;
+        gpsDriver = nullptr;
+    }
+    _serialFd = -1;
+
+    if (_rtcmDropped > 0) {
+        qCWarning(RTKGPSLog) << "Dropped" << _rtcmDropped << "RTCM messages, the queue was full";
+    }
+
     qCDebug(RTKGPSLog) << "Exiting GPS thread";
 }
 
@@ -157,6 +182,7 @@ GPSProvider::GPSProvider(const QString& device,
 {
     qCDebug(RTKGPSLog) << "Survey in accuracy:duration" << surveyInAccMeters << surveryInDurationSecs;
     if (enableSatInfo) _pReportSatInfo = new satellite_info_s();
+    _rtcmRing.resize(_rtcmRingSize);
 }
 
 GPSProvider::~GPSProvider()
@@ -181,8 +207,108 @@ void GPSProvider::publishGPSSatellite()
 
 void GPSProvider::gotRTCMData(uint8_t* data, size_t len)
 {
-    QByteArray message((char*)data, static_cast<int>(len));
-    emit RTCMDataUpdate(message);
+    // Records are a 16 bit length followed by the message
+    const quint64 recordLen = sizeof(quint16) + len;
+    const quint64 head = _rtcmHead.load(std::memory_order_relaxed);
+    const quint64 tail = _rtcmTail.load(std::memory_order_acquire);
+    if ((len > 0xFFFF) || ((_rtcmRingSize - (head - tail)) < recordLen)) {
+        _rtcmDropped++;
+        return;
+    }
+
+    uchar length[sizeof(quint16)];
+    qToLittleEndian(static_cast<quint16>(len), length);
+    _copyToRing(head, reinterpret_cast<const char*>(length), sizeof(length));
+    _copyToRing(head + sizeof(length), reinterpret_cast<const char*>(data), static_cast<qsizetype>(len));
+
+    // Publish the complete record to the consumer
+    _rtcmHead.store(head + recordLen, std::memory_order_release);
+
+    if (!_rtcmNotifyPending.exchange(true)) {
+        emit RTCMDataAvailable();
+    }
+}
+
+bool GPSProvider::takeRTCMData(QByteArray& message)
+{
+    // Cleared first, so a message queued while taking notifies again
+    _rtcmNotifyPending.store(false);
+
+    const quint64 tail = _rtcmTail.load(std::memory_order_relaxed);
+    const quint64 head = _rtcmHead.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+
+    uchar length[sizeof(quint16)];
+    _copyFromRing(tail, reinterpret_cast<char*>(length), sizeof(length));
+    const qsizetype len = qFromLittleEndian<quint16>(length);
+
+    message.resize(len);
+    _copyFromRing(tail + sizeof(length), message.data(), len);
+
+    _rtcmTail.store(tail + sizeof(length) + len, std::memory_order_release);
+
+    return true;
+}
+
+void GPSProvider::_copyToRing(quint64 position, const char* data, qsizetype len)
+{
+    const qsizetype index = static_cast<qsizetype>(position % _rtcmRingSize);
+    const qsizetype firstLen = std::min(len, _rtcmRingSize - index);
+    memcpy(_rtcmRing.data() + index, data, firstLen);
+    if (firstLen < len) {
+        memcpy(_rtcmRing.data(), data + firstLen, len - firstLen);
+    }
+}
+
+void GPSProvider::_copyFromRing(quint64 position, char* data, qsizetype len) const
+{
+    const qsizetype index = static_cast<qsizetype>(position % _rtcmRingSize);
+    const qsizetype firstLen = std::min(len, _rtcmRingSize - index);
+    memcpy(data, _rtcmRing.constData() + index, firstLen);
+    if (firstLen < len) {
+        memcpy(data + firstLen, _rtcmRing.constData(), len - firstLen);
+    }
+}
+
+int GPSProvider::_readDevice(uint8_t* buffer, int len, int timeoutMsecs)
+{
+#ifdef GPS_POLL_IO
+    if (_serialFd >= 0) {
+        struct pollfd fds = { _serialFd, POLLIN, 0 };
+
+        int ret;
+        do {
+            ret = ::poll(&fds, 1, timeoutMsecs);
+        } while ((ret < 0) && (errno == EINTR));
+
+        if (ret == 0) {
+            return 0; //timeout
+        }
+        if ((ret < 0) || (fds.revents & (POLLERR | POLLHUP | POLLNVAL))) {
+            _ioError = true;
+            return -1;
+        }
+
+        const ssize_t bytesRead = ::read(_serialFd, buffer, len);
+        if (bytesRead < 0) {
+            if ((errno == EAGAIN) || (errno == EINTR)) {
+                return 0;
+            }
+            _ioError = true;
+            return -1;
+        }
+
+        return static_cast<int>(bytesRead);
+    }
+#endif
+
+    if (_serial->bytesAvailable() == 0) {
+        if (!_serial->waitForReadyRead(timeoutMsecs))
+            return 0; //timeout
+    }
+    return (int)_serial->read((char*) buffer, len);
 }
 
 int GPSProvider::callbackEntry(GPSCallbackType type, void *data1, int data2, void *user)
@@ -195,12 +321,9 @@ int GPSProvider::callback(GPSCallbackType type, void *data1, int data2)
 {
     switch (type) {
         case GPSCallbackType::readDeviceData: {
-            if (_serial->bytesAvailable() == 0) {
-                int timeout = *((int *) data1);
-                if (!_serial->waitForReadyRead(timeout))
-                    return 0; //timeout
-            }
-            return (int)_serial->read((char*) data1, data2);
+            // The timeout is passed in the buffer the data is read into
+            const int timeout = *((int *) data1);
+            return _readDevice((uint8_t*) data1, data2, timeout);
         }
         case GPSCallbackType::writeDeviceData:
             if (_serial->write((char*) data1, data2) >= 0) {
@@ -18,12 +18,18 @@
 #include <QtCore/QThread>
 #include <QtCore/QByteArray>
 
+#include <atomic>
+
 class QSerialPort;
 
 
 /**
  ** class GPSProvider
  * opens a GPS device and handles the protocol
+ *
+ * The drivers read straight from the serial device into their own buffer, waiting for data with poll() where the
+ * serial port has a file descriptor. RTCM messages are handed to the GUI thread through a preallocated single
+ * producer/single consumer ring, with one RTCMDataAvailable() per batch instead of a queued signal per message.
  */
 class GPSProvider : public QThread
 {
@@ -54,10 +60,16 @@ public:
      */
     void gotRTCMData(uint8_t *data, size_t len);
 
+    /// Takes the oldest queued RTCM message, called by the consumer of RTCMDataAvailable()
+    ///     @param message Reused between calls, so its buffer isn't allocated again
+    ///     @return false: Queue is empty
+    bool takeRTCMData(QByteArray& message);
+
 signals:
     void positionUpdate(GPSPositionMessage message);
     void satelliteInfoUpdate(GPSSatelliteMessage message);
-    void RTCMDataUpdate(QByteArray message);
+    /// RTCM messages were queued, emitted again only after the consumer started taking them
+    void RTCMDataAvailable();
     void surveyInStatus(float duration, float accuracyMM, double latitude, double longitude, float altitude, bool valid, bool active);
 
 protected:
@@ -74,6 +86,10 @@ private:
 
 	int callback(GPSCallbackType type, void *data1, int data2);
 
+    int _readDevice(uint8_t* buffer, int len, int timeoutMsecs);
+    void _copyToRing(quint64 position, const char* data, qsizetype len);
+    void _copyFromRing(quint64 position, char* data, qsizetype len) const;
+
     QString _device;
     GPSType _type;
     const std::atomic_bool& _requestStop;
@@ -90,4 +106,14 @@ private:
 	struct satellite_info_s    *_pReportSatInfo = nullptr;
 
 	QSerialPort *_serial = nullptr;
+    int _serialFd = -1;             ///< Native descriptor polled for reads, -1 to read through QSerialPort
+    bool _ioError = false;
+
+    QByteArray              _rtcmRing;
+    std::atomic<quint64>    _rtcmHead { 0 };            ///< Total bytes queued, only written by the GPS thread
+    std::atomic<quint64>    _rtcmTail { 0 };            ///< Total bytes taken, only written by the consumer
+    std::atomic_bool        _rtcmNotifyPending { false };
+    quint64                 _rtcmDropped = 0;
+
+    static constexpr qsizetype _rtcmRingSize = 64 * 1024;   ///< Seconds of corrections at RTK base rates
 };
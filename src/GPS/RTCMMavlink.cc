@@ -12,6 +12,9 @@
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
 #include "MAVLinkProtocol.h"
+#include "SettingsManager.h"
+#include "RTKSettings.h"
+#include "QGCLoggingCategory.h"
 
 RTCMMavlink::RTCMMavlink(QGCToolbox& toolbox)
     : _toolbox(toolbox)
@@ -19,6 +22,34 @@ RTCMMavlink::RTCMMavlink(QGCToolbox& toolbox)
     _bandwidthTimer.start();
 }
 
+int RTCMMavlink::rtcmMessageType(const QByteArray& message)
+{
+    // Preamble, 6 reserved bits and a 10 bit length, then the 12 bit message number
+    if ((message.size() < 6) || (static_cast<uint8_t>(message[0]) != 0xD3)) {
+        return 0;
+    }
+
+    return (static_cast<uint8_t>(message[3]) << 4) | (static_cast<uint8_t>(message[4]) >> 4);
+}
+
+bool RTCMMavlink::isLowPriorityMessage(int messageType)
+{
+    switch (messageType) {
+    case 1019:  // GPS ephemeris
+    case 1020:  // GLONASS ephemeris
+    case 1041:  // NavIC ephemeris
+    case 1042:  // BeiDou ephemeris
+    case 1043:  // SBAS ephemeris
+    case 1044:  // QZSS ephemeris
+    case 1045:  // Galileo F/NAV ephemeris
+    case 1046:  // Galileo I/NAV ephemeris
+    case 1033:  // Receiver and antenna descriptors
+        return true;
+    default:
+        return false;
+    }
+}
+
 void RTCMMavlink::RTCMDataUpdate(QByteArray message)
 {
     /* statistics */
@@ -30,7 +61,34 @@ void RTCMMavlink::RTCMDataUpdate(QByteArray message)
         _bandwidthByteCounter = 0;
     }
 
+    QList<Vehicle*> senders;
+    const QList<LinkInterface*> links = _rtcmLinks(senders);
+    if (links.isEmpty()) {
+        return;
+    }
+
     const qsizetype maxMessageLength = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
+    const int fragmentCount = (message.size() + maxMessageLength - 1) / maxMessageLength;
+    const int linkBytes = message.size() + (fragmentCount * (MAVLINK_NUM_NON_PAYLOAD_BYTES + 2));
+    const int bandwidthLimit = _toolbox.settingsManager()->rtkSettings()->rtcmBandwidthLimit()->rawValue().toInt();
+    const int messageType = rtcmMessageType(message);
+    const bool lowPriority = isLowPriorityMessage(messageType);
+
+    QList<int> sendLinks;
+    for (int i = 0; i < links.count(); i++) {
+        // Low priority corrections are dropped while the link is backed up, they would only arrive stale
+        if (lowPriority && links[i]->writeBackpressure()) {
+            continue;
+        }
+        if (_takeBudget(links[i], linkBytes, lowPriority, bandwidthLimit)) {
+            sendLinks.append(i);
+        }
+    }
+
+    if (sendLinks.isEmpty()) {
+        return;
+    }
+
     mavlink_gps_rtcm_data_t mavlinkRtcmData;
     memset(&mavlinkRtcmData, 0, sizeof(mavlink_gps_rtcm_data_t));
 
@@ -38,7 +96,9 @@ void RTCMMavlink::RTCMDataUpdate(QByteArray message)
         mavlinkRtcmData.len = message.size();
         mavlinkRtcmData.flags = (_sequenceId & 0x1F) << 3;
         memcpy(&mavlinkRtcmData.data, message.data(), message.size());
-        sendMessageToVehicle(mavlinkRtcmData);
+        for (int i : sendLinks) {
+            _sendMessageToLink(senders[i], links[i], mavlinkRtcmData);
+        }
     } else {
         // We need to fragment
 
@@ -51,30 +111,83 @@ void RTCMMavlink::RTCMDataUpdate(QByteArray message)
             mavlinkRtcmData.flags |= (_sequenceId & 0x1F) << 3;     // Next 5 bits are sequence id
             mavlinkRtcmData.len = length;
             memcpy(&mavlinkRtcmData.data, message.data() + start, length);
-            sendMessageToVehicle(mavlinkRtcmData);
+            for (int i : sendLinks) {
+                _sendMessageToLink(senders[i], links[i], mavlinkRtcmData);
+            }
             start += length;
         }
     }
     ++_sequenceId;
 }
 
-void RTCMMavlink::sendMessageToVehicle(const mavlink_gps_rtcm_data_t& msg)
+QList<LinkInterface*> RTCMMavlink::_rtcmLinks(QList<Vehicle*>& senders)
 {
+    QList<LinkInterface*> links;
+    senders.clear();
+
+    // Vehicles sharing a radio share its link, each link gets the corrections once
     QmlObjectListModel& vehicles = *_toolbox.multiVehicleManager()->vehicles();
-    MAVLinkProtocol* mavlinkProtocol = _toolbox.mavlinkProtocol();
     for (int i = 0; i < vehicles.count(); i++) {
         Vehicle*                vehicle     = qobject_cast<Vehicle*>(vehicles[i]);
         SharedLinkInterfacePtr  sharedLink  = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-        if (sharedLink) {
-            mavlink_message_t       message;
+        if (sharedLink && !links.contains(sharedLink.get())) {
+            links.append(sharedLink.get());
+            senders.append(vehicle);
+        }
+    }
 
-            mavlink_msg_gps_rtcm_data_encode_chan(mavlinkProtocol->getSystemId(),
-                                                  mavlinkProtocol->getComponentId(),
-                                                  sharedLink->mavlinkChannel(),
-                                                  &message,
-                                                  &msg);
-            vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+    // Forget the budgets of links which are gone
+    for (auto it = _linkBudgets.begin(); it != _linkBudgets.end();) {
+        if (links.contains(it.key())) {
+            ++it;
+        } else {
+            it = _linkBudgets.erase(it);
         }
     }
+
+    return links;
+}
+
+bool RTCMMavlink::_takeBudget(LinkInterface* link, int bytes, bool lowPriority, int bandwidthLimit)
+{
+    if (bandwidthLimit <= 0) {
+        return true;
+    }
+
+    const qint64 now = _bandwidthTimer.msecsSinceReference();
+
+    auto it = _linkBudgets.find(link);
+    if (it == _linkBudgets.end()) {
+        it = _linkBudgets.insert(link, { static_cast<double>(bandwidthLimit), now, 0 });
+    }
+    LinkBudget_t& budget = it.value();
+
+    budget.budgetBytes = qMin(static_cast<double>(bandwidthLimit), budget.budgetBytes + ((now - budget.lastRefillMSecs) * bandwidthLimit / 1000.0));
+    budget.lastRefillMSecs = now;
+
+    if (lowPriority && (budget.budgetBytes < bytes)) {
+        if ((budget.droppedMessages++ % 100) == 0) {
+            qCDebug(RTKGPSLog) << "RTCM bandwidth limit reached, dropped messages:" << budget.droppedMessages;
+        }
+        return false;
+    }
+
+    // High priority messages always go out, they may borrow up to a second of budget
+    budget.budgetBytes = qMax(-static_cast<double>(bandwidthLimit), budget.budgetBytes - bytes);
+
+    return true;
+}
+
+void RTCMMavlink::_sendMessageToLink(Vehicle* vehicle, LinkInterface* link, const mavlink_gps_rtcm_data_t& msg)
+{
+    MAVLinkProtocol* mavlinkProtocol = _toolbox.mavlinkProtocol();
+    mavlink_message_t message;
+
+    mavlink_msg_gps_rtcm_data_encode_chan(mavlinkProtocol->getSystemId(),
+                                          mavlinkProtocol->getComponentId(),
+                                          link->mavlinkChannel(),
+                                          &message,
+                                          &msg);
+    vehicle->sendMessageOnLinkThreadSafe(link, message);
 }
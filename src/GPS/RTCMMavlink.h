@@ -15,10 +15,19 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+
+class LinkInterface;
+class Vehicle;
 
 /**
  ** class RTCMMavlink
  * Receives RTCM updates and sends them via MAVLINK to the device
+ *
+ * GPS_RTCM_DATA has no target, every vehicle on a link takes it. So the corrections are encoded and sent once per
+ * link, no matter how many vehicles share it. With a bandwidth limit set, ephemeris messages are dropped first when
+ * a link runs out of budget as they are repeated anyway, observations and base station messages are always sent.
  */
 class RTCMMavlink : public QObject
 {
@@ -27,14 +36,28 @@ public:
     RTCMMavlink(QGCToolbox& toolbox);
     //TODO: API to select device(s)?
 
+    /// @return RTCM3 message number of the frame, 0 if it is not an RTCM3 frame
+    static int rtcmMessageType(const QByteArray& message);
+    /// @return true: Message can be dropped under a tight link budget without losing the fix
+    static bool isLowPriorityMessage(int messageType);
+
 public slots:
     void RTCMDataUpdate(QByteArray message);
 
 private:
-    void sendMessageToVehicle(const mavlink_gps_rtcm_data_t& msg);
+    typedef struct {
+        double          budgetBytes = 0;        ///< Token bucket, refilled at the bandwidth limit, up to one second of it
+        qint64          lastRefillMSecs = 0;
+        quint64         droppedMessages = 0;
+    } LinkBudget_t;
+
+    QList<LinkInterface*> _rtcmLinks(QList<Vehicle*>& senders);
+    bool _takeBudget(LinkInterface* link, int bytes, bool lowPriority, int bandwidthLimit);
+    void _sendMessageToLink(Vehicle* vehicle, LinkInterface* link, const mavlink_gps_rtcm_data_t& msg);
 
     QGCToolbox& _toolbox;
     QElapsedTimer _bandwidthTimer;
     int _bandwidthByteCounter = 0;
     uint8_t _sequenceId = 0;
+    QHash<LinkInterface*, LinkBudget_t> _linkBudgets;
 };
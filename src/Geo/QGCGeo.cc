@@ -86,6 +86,175 @@ void convertNedToGeo(double x, double y, double z, const QGeoCoordinate &origin,
     coord.setAltitude(-z + origin.altitude());
 }
 
+void convertGeoToNed(const double *lat, const double *lon, const double *alt, qsizetype count, const QGeoCoordinate &origin, double *x, double *y, double *z)
+{
+    const double ref_lat_rad = qDegreesToRadians(origin.latitude());
+    const double ref_lon_rad = qDegreesToRadians(origin.longitude());
+    const double ref_sin_lat = sin(ref_lat_rad);
+    const double ref_cos_lat = cos(ref_lat_rad);
+    const double radius = GeographicLib::Constants::WGS84_a();
+
+    for (qsizetype i = 0; i < count; i++) {
+        const double lat_rad = qDegreesToRadians(lat[i]);
+        const double d_lon_rad = qDegreesToRadians(lon[i]) - ref_lon_rad;
+
+        const double sin_lat = sin(lat_rad);
+        const double cos_lat = cos(lat_rad);
+        const double cos_d_lon = cos(d_lon_rad);
+
+        // Clamping keeps acos defined for points at the origin, where rounding can push the argument above 1
+        const double c = acos(qMin(1.0, ref_sin_lat * sin_lat + ref_cos_lat * cos_lat * cos_d_lon));
+        const double k = (c < epsilon) ? 1.0 : (c / sin(c));
+
+        x[i] = k * (ref_cos_lat * sin_lat - ref_sin_lat * cos_lat * cos_d_lon) * radius;
+        y[i] = k * cos_lat * sin(d_lon_rad) * radius;
+    }
+
+    if (alt) {
+        const double ref_alt = origin.altitude();
+        for (qsizetype i = 0; i < count; i++) {
+            z[i] = -(alt[i] - ref_alt);
+        }
+    }
+}
+
+void convertNedToGeo(const double *x, const double *y, const double *z, qsizetype count, const QGeoCoordinate &origin, double *lat, double *lon, double *alt)
+{
+    const double ref_lat_rad = qDegreesToRadians(origin.latitude());
+    const double ref_lon_rad = qDegreesToRadians(origin.longitude());
+    const double ref_sin_lat = sin(ref_lat_rad);
+    const double ref_cos_lat = cos(ref_lat_rad);
+    const double radius = GeographicLib::Constants::WGS84_a();
+
+    for (qsizetype i = 0; i < count; i++) {
+        const double x_rad = x[i] / radius;
+        const double y_rad = y[i] / radius;
+        const double c = sqrt(x_rad * x_rad + y_rad * y_rad);
+        const double sin_c = sin(c);
+        const double cos_c = cos(c);
+
+        // sin(c)/c tends to 1 at the origin, which gives back the reference latitude and longitude
+        const double sin_c_over_c = (c > epsilon) ? (sin_c / c) : 1.0;
+        const double lat_rad = asin(qBound(-1.0, cos_c * ref_sin_lat + x_rad * sin_c_over_c * ref_cos_lat, 1.0));
+        const double lon_rad = ref_lon_rad + atan2(y_rad * sin_c_over_c, ref_cos_lat * cos_c - x_rad * ref_sin_lat * sin_c_over_c);
+
+        lat[i] = qRadiansToDegrees(lat_rad);
+        lon[i] = qRadiansToDegrees(lon_rad);
+    }
+
+    if (z) {
+        const double ref_alt = origin.altitude();
+        for (qsizetype i = 0; i < count; i++) {
+            alt[i] = -z[i] + ref_alt;
+        }
+    }
+}
+
+void distancesFrom(const QGeoCoordinate &origin, const double *lat, const double *lon, qsizetype count, double *distances, double *azimuths)
+{
+    // Same sphere as QGeoCoordinate
+    constexpr double earthMeanRadius = 6371007.2;
+
+    const double ref_lat_rad = qDegreesToRadians(origin.latitude());
+    const double ref_sin_lat = sin(ref_lat_rad);
+    const double ref_cos_lat = cos(ref_lat_rad);
+
+    for (qsizetype i = 0; i < count; i++) {
+        const double lat_rad = qDegreesToRadians(lat[i]);
+        const double d_lat_rad = lat_rad - ref_lat_rad;
+        const double d_lon_rad = qDegreesToRadians(lon[i] - origin.longitude());
+
+        const double haversine_d_lat = sin(d_lat_rad / 2.0);
+        const double haversine_d_lon = sin(d_lon_rad / 2.0);
+        const double h = (haversine_d_lat * haversine_d_lat) + (ref_cos_lat * cos(lat_rad) * haversine_d_lon * haversine_d_lon);
+
+        distances[i] = 2.0 * asin(sqrt(h)) * earthMeanRadius;
+    }
+
+    if (azimuths) {
+        for (qsizetype i = 0; i < count; i++) {
+            const double lat_rad = qDegreesToRadians(lat[i]);
+            const double d_lon_rad = qDegreesToRadians(lon[i] - origin.longitude());
+            const double cos_lat = cos(lat_rad);
+
+            const double azimuth = qRadiansToDegrees(atan2(sin(d_lon_rad) * cos_lat, ref_cos_lat * sin(lat_rad) - ref_sin_lat * cos_lat * cos(d_lon_rad)));
+            azimuths[i] = (azimuth < 0) ? (azimuth + 360.0) : azimuth;
+        }
+    }
+}
+
+QList<QGeoCoordinate> simplifyPolygon(const QList<QGeoCoordinate> &polygon, double tolerance)
+{
+    const qsizetype count = polygon.count();
+    if ((count <= 3) || (tolerance <= 0)) {
+        return polygon;
+    }
+
+    QVector<double> lat(count), lon(count), north(count), east(count);
+    for (qsizetype i = 0; i < count; i++) {
+        lat[i] = polygon[i].latitude();
+        lon[i] = polygon[i].longitude();
+    }
+    convertGeoToNed(lat.constData(), lon.constData(), nullptr, count, polygon.first(), north.data(), east.data(), nullptr);
+
+    // The ring is split at the first vertex and the vertex farthest from it, each half is then simplified as a polyline
+    qsizetype farthest = 1;
+    for (qsizetype i = 2; i < count; i++) {
+        if ((north[i] * north[i] + east[i] * east[i]) > (north[farthest] * north[farthest] + east[farthest] * east[farthest])) {
+            farthest = i;
+        }
+    }
+
+    QVector<bool> keep(count, false);
+    keep[0] = true;
+    keep[farthest] = true;
+
+    // Ranges are [first, last] with last == count standing for vertex 0 closing the ring
+    const double toleranceSquared = tolerance * tolerance;
+    QList<QPair<qsizetype, qsizetype>> ranges = { { 0, farthest }, { farthest, count } };
+    while (!ranges.isEmpty()) {
+        const auto [first, last] = ranges.takeLast();
+        const double startNorth = north[first];
+        const double startEast = east[first];
+        const double segmentNorth = north[last % count] - startNorth;
+        const double segmentEast = east[last % count] - startEast;
+        const double segmentLengthSquared = segmentNorth * segmentNorth + segmentEast * segmentEast;
+
+        qsizetype maxIndex = -1;
+        double maxDistanceSquared = toleranceSquared;
+        for (qsizetype i = first + 1; i < last; i++) {
+            // Distance to the segment, not the infinite line, so spikes running back along the outline are kept
+            double pointNorth = north[i] - startNorth;
+            double pointEast = east[i] - startEast;
+            if (segmentLengthSquared > 0) {
+                const double t = qBound(0.0, (pointNorth * segmentNorth + pointEast * segmentEast) / segmentLengthSquared, 1.0);
+                pointNorth -= t * segmentNorth;
+                pointEast -= t * segmentEast;
+            }
+            const double distanceSquared = pointNorth * pointNorth + pointEast * pointEast;
+            if (distanceSquared > maxDistanceSquared) {
+                maxDistanceSquared = distanceSquared;
+                maxIndex = i;
+            }
+        }
+
+        if (maxIndex >= 0) {
+            keep[maxIndex] = true;
+            ranges.append({ first, maxIndex });
+            ranges.append({ maxIndex, last });
+        }
+    }
+
+    QList<QGeoCoordinate> simplified;
+    for (qsizetype i = 0; i < count; i++) {
+        if (keep[i]) {
+            simplified.append(polygon[i]);
+        }
+    }
+
+    return (simplified.count() >= 3) ? simplified : polygon;
+}
+
 int convertGeoToUTM(const QGeoCoordinate& coord, double &easting, double &northing)
 {
     try {
@@ -99,6 +268,24 @@ int convertGeoToUTM(const QGeoCoordinate& coord, double &easting, double &northi
     }
 }
 
+bool convertGeoToUTMZone(const QGeoCoordinate &coord, int zone, bool southhemi, double &easting, double &northing)
+{
+    static constexpr double kFalseNorthing = 10000000.;
+
+    try {
+        int outZone;
+        bool northp;
+        GeographicLib::UTMUPS::Forward(coord.latitude(), coord.longitude(), outZone, northp, easting, northing, zone);
+        if (northp == southhemi) {
+            northing += southhemi ? kFalseNorthing : -kFalseNorthing;
+        }
+        return true;
+    } catch(const GeographicLib::GeographicErr& e) {
+        qCDebug(QGCGeoLog) << Q_FUNC_INFO << e.what();
+        return false;
+    }
+}
+
 bool convertUTMToGeo(double easting, double northing, int zone, bool southhemi, QGeoCoordinate &coord)
 {
     double lat, lon;
@@ -163,4 +350,38 @@ bool convertMGRSToGeo(const QString &mgrs, QGeoCoordinate &coord)
     return true;
 }
 
+void LocalFrame::setAnchor(const QGeoCoordinate &anchor)
+{
+    // Same sphere as QGeoCoordinate
+    constexpr double earthMeanRadius = 6371007.2;
+
+    _anchored = true;
+    _anchorLat = anchor.latitude();
+    _anchorLon = anchor.longitude();
+    _metersPerDegreeLat = qDegreesToRadians(earthMeanRadius);
+    _metersPerDegreeLon = _metersPerDegreeLat * cos(qDegreesToRadians(_anchorLat));
+}
+
+bool LocalFrame::inRange(const QGeoCoordinate &coord) const
+{
+    if (!_anchored) {
+        return false;
+    }
+
+    double north, east;
+    toLocal(coord, north, east);
+    return ((north * north) + (east * east)) <= (reanchorDistance * reanchorDistance);
+}
+
+double LocalFrame::distance(double north1, double east1, double north2, double east2)
+{
+    return hypot(north2 - north1, east2 - east1);
+}
+
+double LocalFrame::azimuth(double north1, double east1, double north2, double east2)
+{
+    const double azimuth = qRadiansToDegrees(atan2(east2 - east1, north2 - north1));
+    return (azimuth < 0) ? (azimuth + 360.) : azimuth;
+}
+
 } // namespace QGCGeo
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <QtCore/QList>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtCore/QLoggingCategory>
 
@@ -45,6 +46,26 @@ void convertGeoToNed(const QGeoCoordinate &coord, const QGeoCoordinate &origin,
  */
 void convertNedToGeo(double x, double y, double z, const QGeoCoordinate &origin, QGeoCoordinate &coord);
 
+/// Batch version of convertGeoToNed on plain arrays of latitude/longitude/altitude (structure of arrays). The origin
+/// trigonometry is computed once and no QGeoCoordinates are involved, so this is much faster than calling the single
+/// coordinate version in a loop. The loop has no branches, which leaves it to the compiler to vectorize it.
+///     @param alt Altitudes, may be nullptr in which case z is not written (z may then be nullptr as well)
+void convertGeoToNed(const double *lat, const double *lon, const double *alt, qsizetype count, const QGeoCoordinate &origin, double *x, double *y, double *z);
+
+/// Batch version of convertNedToGeo, see the batch convertGeoToNed
+///     @param z Down components, may be nullptr in which case alt is not written (alt may then be nullptr as well)
+void convertNedToGeo(const double *x, const double *y, const double *z, qsizetype count, const QGeoCoordinate &origin, double *lat, double *lon, double *alt);
+
+/// Distance in meters and azimuth in degrees from origin to each point, the results match QGeoCoordinate::distanceTo
+/// and QGeoCoordinate::azimuthTo. Use in place of per point QGeoCoordinate calls in hot loops.
+///     @param azimuths May be nullptr if only distances are needed
+void distancesFrom(const QGeoCoordinate &origin, const double *lat, const double *lon, qsizetype count, double *distances, double *azimuths = nullptr);
+
+/// Douglas-Peucker simplification of a closed polygon in a local NED frame. Vertices which are closer than tolerance
+/// meters to the simplified outline are dropped. Used to thin out large imported boundaries before they are edited.
+///     @return polygon unchanged if it has three vertices or less, tolerance is not positive or the result would be degenerate
+QList<QGeoCoordinate> simplifyPolygon(const QList<QGeoCoordinate> &polygon, double tolerance);
+
 // LatLonToUTMXY
 // Converts a latitude/longitude pair to x and y coordinates in the
 // Universal Transverse Mercator projection.
@@ -65,6 +86,11 @@ void convertNedToGeo(double x, double y, double z, const QGeoCoordinate &origin,
 //   If conversion failed the function returns 0
 int convertGeoToUTM(const QGeoCoordinate& coord, double &easting, double &northing);
 
+/// Same as convertGeoToUTM but always in the specified zone and hemisphere, for grids which extend past the borders
+/// of their zone. Northings are continued across the equator, negative or above 10000km where needed.
+///     @return false: conversion failed
+bool convertGeoToUTMZone(const QGeoCoordinate &coord, int zone, bool southhemi, double &easting, double &northing);
+
 // UTMXYToLatLon
 //
 // Converts x and y coordinates in the Universal Transverse Mercator//   The UTM zone parameter should be in the range [1,60].
@@ -109,4 +135,44 @@ QString convertGeoToMGRS(const QGeoCoordinate &coord);
 // The function returns true if conversion succeeded.
 bool convertMGRSToGeo(const QString &mgrs, QGeoCoordinate &coord);
 
+/// Flat local frame for repeated distance and azimuth computations between nearby points, for example consecutive
+/// vehicle positions. The scale factors are computed once when the frame is anchored, after which every conversion is
+/// plain arithmetic instead of spherical trigonometry. Results are on the same sphere as QGeoCoordinate::distanceTo
+/// and azimuthTo and agree with them to well under 0.1% while points stay within reanchorDistance of the anchor.
+class LocalFrame
+{
+public:
+    /// Moves the anchor of the frame, local positions computed against the previous anchor become invalid
+    void setAnchor(const QGeoCoordinate &anchor);
+
+    bool isAnchored() const { return _anchored; }
+
+    /// @return true: coord is close enough to the anchor for accurate results, re-anchor otherwise
+    bool inRange(const QGeoCoordinate &coord) const;
+
+    /// Converts to meters north and east of the anchor
+    void toLocal(const QGeoCoordinate &coord, double &north, double &east) const
+    {
+        north = (coord.latitude() - _anchorLat) * _metersPerDegreeLat;
+        east = _wrapLongitude(coord.longitude() - _anchorLon) * _metersPerDegreeLon;
+    }
+
+    /// @return Distance in meters between two local positions
+    static double distance(double north1, double east1, double north2, double east2);
+
+    /// @return Azimuth in degrees [0, 360) from the first local position to the second
+    static double azimuth(double north1, double east1, double north2, double east2);
+
+    static constexpr double reanchorDistance = 1000.;
+
+private:
+    static double _wrapLongitude(double degrees) { return (degrees > 180.) ? (degrees - 360.) : ((degrees < -180.) ? (degrees + 360.) : degrees); }
+
+    bool    _anchored = false;
+    double  _anchorLat = 0;
+    double  _anchorLon = 0;
+    double  _metersPerDegreeLat = 0;
+    double  _metersPerDegreeLon = 0;
+};
+
 } // namespace QGCGeo
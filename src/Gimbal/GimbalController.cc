@@ -14,9 +14,13 @@
 #include "QGCLoggingCategory.h"
 #include "ParameterManager.h"
 #include "MAVLinkProtocol.h"
+#include "VehicleLinkManager.h"
+#include "VideoManager.h"
 
 #include <QtQml/QQmlEngine>
 
+#include <cmath>
+
 QGC_LOGGING_CATEGORY(GimbalLog, "GimbalLog")
 
 const char* GimbalController::_gimbalFactGroupNamePrefix =  "gimbal";
@@ -51,6 +55,9 @@ const Gimbal& Gimbal::operator=(const Gimbal& other)
     _isComplete                = other._isComplete;
     _retracted                 = other._retracted;
     _neutral                   = other._neutral;
+    _attitudeMSecs             = other._attitudeMSecs;
+    _pitchRate                 = other._pitchRate;
+    _bodyYawRate               = other._bodyYawRate;
     _haveControl               = other._haveControl;
     _othersHaveControl         = other._othersHaveControl;
     _absoluteRollFact          = other._absoluteRollFact;
@@ -97,6 +104,10 @@ GimbalController::GimbalController(MAVLinkProtocol* mavlink, Vehicle* vehicle)
 {
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
     connect(_vehicle, &Vehicle::mavlinkMessageReceived, this, &GimbalController::_mavlinkMessageReceived);
+
+    _attitudeClock.start();
+    _pitchYawTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_pitchYawTimer, &QTimer::timeout, this, &GimbalController::_sendQueuedPitchYaw);
 }
 
 GimbalController::~GimbalController()
@@ -297,6 +308,29 @@ GimbalController::_handleGimbalDeviceAttitudeStatus(const mavlink_message_t& mes
     float roll, pitch, yaw;
     mavlink_quaternion_to_euler(attitude_status.q, &roll, &pitch, &yaw);
 
+    // Estimate the gimbal motion so the attitude can be predicted across the video latency
+    const qint64 nowMSecs = _attitudeClock.elapsed();
+    const qint64 sampleGapMSecs = nowMSecs - gimbal._attitudeMSecs;
+    if ((gimbal._attitudeMSecs != 0) && (sampleGapMSecs > 0) && (sampleGapMSecs < _maxRateSampleGapMSecs)) {
+        const float previousBodyYaw = gimbal.bodyYaw()->rawValue().toFloat();
+        const float newBodyYaw = yaw_in_vehicle_frame ? qRadiansToDegrees(yaw) : qRadiansToDegrees(yaw) - _vehicle->heading()->rawValue().toFloat();
+        float bodyYawDelta = std::fmod(newBodyYaw - previousBodyYaw, 360.0f);
+        if (bodyYawDelta > 180.0f) {
+            bodyYawDelta -= 360.0f;
+        } else if (bodyYawDelta < -180.0f) {
+            bodyYawDelta += 360.0f;
+        }
+        const float pitchRate = (qRadiansToDegrees(pitch) - gimbal.absolutePitch()->rawValue().toFloat()) * 1000.0f / sampleGapMSecs;
+        const float bodyYawRate = bodyYawDelta * 1000.0f / sampleGapMSecs;
+        // Light low pass, status messages arrive with the link jitter
+        gimbal._pitchRate += (pitchRate - gimbal._pitchRate) * 0.5f;
+        gimbal._bodyYawRate += (bodyYawRate - gimbal._bodyYawRate) * 0.5f;
+    } else {
+        gimbal._pitchRate = 0;
+        gimbal._bodyYawRate = 0;
+    }
+    gimbal._attitudeMSecs = nowMSecs;
+
     gimbal.setAbsoluteRoll(qRadiansToDegrees(roll));
     gimbal.setAbsolutePitch(qRadiansToDegrees(pitch));
 
@@ -435,6 +469,84 @@ bool GimbalController::_yawInVehicleFrame(uint32_t flags)
     }
 }
 
+bool GimbalController::_latencyCompensation()
+{
+    return qgcApp()->toolbox()->settingsManager()->gimbalControllerSettings()->LatencyCompensation()->rawValue().toBool();
+}
+
+// Latency between the gimbal moving and the operator seeing it on screen
+float GimbalController::_videoLatencyMSecs()
+{
+    const float configuredMSecs = qgcApp()->toolbox()->settingsManager()->gimbalControllerSettings()->VideoLatency()->rawValue().toFloat();
+    const float measuredMSecs = static_cast<float>(qgcApp()->toolbox()->videoManager()->videoFrameAge());
+    return configuredMSecs + measuredMSecs;
+}
+
+// Extrapolates the active gimbal attitude from the last status. A negative offset gives the attitude at that time in the past,
+// e.g. when the video frame currently on screen was captured.
+void GimbalController::_predictedAttitude(float offsetMSecs, float& pitch, float& bodyYaw)
+{
+    pitch = _activeGimbal->absolutePitch()->rawValue().toFloat();
+    bodyYaw = _activeGimbal->bodyYaw()->rawValue().toFloat();
+
+    if (_activeGimbal->_attitudeMSecs == 0) {
+        return;
+    }
+
+    float predictionMSecs = static_cast<float>(_attitudeClock.elapsed() - _activeGimbal->_attitudeMSecs) + offsetMSecs;
+    predictionMSecs = qBound(-_maxPredictionMSecs, predictionMSecs, _maxPredictionMSecs);
+
+    pitch += _activeGimbal->_pitchRate * predictionMSecs / 1000.0f;
+    bodyYaw += _activeGimbal->_bodyYawRate * predictionMSecs / 1000.0f;
+}
+
+// Only the latest target is kept, it goes out immediately if nothing was sent for a period and otherwise on the next tick
+void GimbalController::_queuePitchYaw(float pitch, float yaw, uint32_t flags)
+{
+    _queuedPitch = pitch;
+    _queuedYaw = yaw;
+    _queuedFlags = flags;
+    _pitchYawQueued = true;
+
+    if (!_pitchYawTimer.isActive()) {
+        const float rateHz = qgcApp()->toolbox()->settingsManager()->gimbalControllerSettings()->ControlRate()->rawValue().toFloat();
+        _pitchYawTimer.setInterval(static_cast<int>(1000.0f / qMax(rateHz, 1.0f)));
+        _pitchYawTimer.start();
+        _sendQueuedPitchYaw();
+    }
+}
+
+void GimbalController::_sendQueuedPitchYaw()
+{
+    if (!_pitchYawQueued || !_activeGimbal) {
+        _pitchYawTimer.stop();
+        return;
+    }
+    _pitchYawQueued = false;
+
+    SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (!sharedLink) {
+        qCDebug(GimbalLog) << "_sendQueuedPitchYaw: primary link gone!";
+        return;
+    }
+
+    mavlink_message_t message;
+    mavlink_msg_gimbal_manager_set_pitchyaw_pack_chan(
+        static_cast<uint8_t>(_mavlink->getSystemId()),
+        static_cast<uint8_t>(_mavlink->getComponentId()),
+        sharedLink->mavlinkChannel(),
+        &message,
+        static_cast<uint8_t>(_vehicle->id()),
+        static_cast<uint8_t>(_activeGimbal->managerCompid()->rawValue().toUInt()),
+        _queuedFlags,
+        static_cast<uint8_t>(_activeGimbal->deviceId()->rawValue().toUInt()),
+        qDegreesToRadians(_queuedPitch),
+        qDegreesToRadians(_queuedYaw),
+        NAN,
+        NAN);
+    _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+}
+
 void GimbalController::gimbalPitchStep(int direction)
 {
     if (!_activeGimbal) {
@@ -490,6 +602,14 @@ void GimbalController::gimbalOnScreenControl(float panPct, float tiltPct, bool c
         float panDesired = panIncDesired + _activeGimbal->bodyYaw()->rawValue().toFloat();
         float tiltDesired = tiltIncDesired + _activeGimbal->absolutePitch()->rawValue().toFloat();
 
+        if (_latencyCompensation()) {
+            // The click is relative to the frame on screen, which shows the gimbal where it was one video latency ago
+            float framePitch, frameBodyYaw;
+            _predictedAttitude(-_videoLatencyMSecs(), framePitch, frameBodyYaw);
+            panDesired = panIncDesired + frameBodyYaw;
+            tiltDesired = tiltIncDesired + framePitch;
+        }
+
         if (_activeGimbal->yawLock()) {
             sendPitchAbsoluteYaw(tiltDesired, panDesired + _vehicle->heading()->rawValue().toFloat(), false);
         } else {
@@ -509,6 +629,15 @@ void GimbalController::gimbalOnScreenControl(float panPct, float tiltPct, bool c
         float panDesired = panIncDesired + _activeGimbal->bodyYaw()->rawValue().toFloat();
         float tiltDesired = tiltIncDesired + _activeGimbal->absolutePitch()->rawValue().toFloat();
 
+        if (_latencyCompensation()) {
+            // Called at the control rate, step from where the gimbal is now rather than from its last reported attitude
+            const float rateHz = qgcApp()->toolbox()->settingsManager()->gimbalControllerSettings()->ControlRate()->rawValue().toFloat();
+            float currentPitch, currentBodyYaw;
+            _predictedAttitude(0, currentPitch, currentBodyYaw);
+            panDesired = (panPct * maxSpeed / rateHz) + currentBodyYaw;
+            tiltDesired = (tiltPct * maxSpeed / rateHz) + currentPitch;
+        }
+
         if (_activeGimbal->yawLock()) {
             sendPitchAbsoluteYaw(tiltDesired, panDesired + _vehicle->heading()->rawValue().toFloat(), false);
         } else {
@@ -528,6 +657,11 @@ void GimbalController::sendPitchBodyYaw(float pitch, float yaw, bool showError)
         | GIMBAL_MANAGER_FLAGS_PITCH_LOCK
         | GIMBAL_MANAGER_FLAGS_YAW_IN_VEHICLE_FRAME;
 
+    if (_latencyCompensation()) {
+        _queuePitchYaw(pitch, yaw, flags);
+        return;
+    }
+
     _vehicle->sendMavCommand(
                 _activeGimbal->managerCompid()->rawValue().toUInt(),
                 MAV_CMD_DO_GIMBAL_MANAGER_PITCHYAW,
@@ -561,6 +695,11 @@ void GimbalController::sendPitchAbsoluteYaw(float pitch, float yaw, bool showErr
         | GIMBAL_MANAGER_FLAGS_YAW_LOCK
         | GIMBAL_MANAGER_FLAGS_YAW_IN_EARTH_FRAME;
 
+    if (_latencyCompensation()) {
+        _queuePitchYaw(pitch, yaw, flags);
+        return;
+    }
+
     _vehicle->sendMavCommand(
                 _activeGimbal->managerCompid()->rawValue().toUInt(),
                 MAV_CMD_DO_GIMBAL_MANAGER_PITCHYAW,
@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
 
 #include <QmlObjectListModel.h>
 #include <FactGroup.h>
@@ -58,6 +60,9 @@ public:
     void  setAbsolutePitch(float absolutePitch) { _absolutePitchFact.setRawValue(absolutePitch);                   }
     void  setBodyYaw(float bodyYaw)             { _bodyYawFact.setRawValue(bodyYaw);                               }
     void  setAbsoluteYaw(float absoluteYaw)     { _absoluteYawFact.setRawValue(absoluteYaw);                       }
+
+    // Overrides from FactGroup
+    QList<uint32_t> handledMessageIds(void) const override { return {}; }   ///< Updated by GimbalController
     void  setDeviceId(uint id)                  { _deviceIdFact.setRawValue(id);                                   }
     void  setManagerCompid(uint id)             { _managerCompidFact.setRawValue(id);                              }
     void  setYawLock(bool yawLock)              { _yawLock = yawLock;       emit yawLockChanged();                 }
@@ -85,6 +90,11 @@ private:
     bool _isComplete = false;
     bool _neutral = false;
 
+    // Attitude motion estimated from consecutive GIMBAL_DEVICE_ATTITUDE_STATUS, used for latency compensation
+    qint64 _attitudeMSecs = 0;  ///< Controller clock time of the last attitude status, 0 if none received
+    float _pitchRate = 0;       ///< deg/s
+    float _bodyYawRate = 0;     ///< deg/s
+
     // Q_PROPERTIES
     Fact _absoluteRollFact;
     Fact _absolutePitchFact;
@@ -190,10 +200,23 @@ private:
     void    _checkComplete                      (Gimbal& gimbal, GimbalPairId pairId);
     bool    _tryGetGimbalControl                ();
     bool    _yawInVehicleFrame                  (uint32_t flags);
+    bool    _latencyCompensation                ();
+    float   _videoLatencyMSecs                  ();
+    void    _predictedAttitude                  (float offsetMSecs, float& pitch, float& bodyYaw);
+    void    _queuePitchYaw                      (float pitch, float yaw, uint32_t flags);
+    void    _sendQueuedPitchYaw                 ();
 
     MAVLinkProtocol*    _mavlink            = nullptr;
     Vehicle*            _vehicle            = nullptr;
     Gimbal*             _activeGimbal       = nullptr;
+    QElapsedTimer       _attitudeClock;
+
+    // Latest target of the latency compensated mode, sent as GIMBAL_MANAGER_SET_PITCHYAW on _pitchYawTimer
+    QTimer              _pitchYawTimer;
+    bool                _pitchYawQueued     = false;
+    float               _queuedPitch        = 0;
+    float               _queuedYaw          = 0;
+    uint32_t            _queuedFlags        = 0;
 
     QMap<uint8_t, PotentialGimbalManager> _potentialGimbalManagers; // key is compid
 
@@ -201,4 +224,7 @@ private:
     QmlObjectListModel _gimbals;
 
     static const char* _gimbalFactGroupNamePrefix;
+
+    static constexpr qint64 _maxRateSampleGapMSecs  = 500;     ///< Attitude statuses further apart than this reset the rate estimate
+    static constexpr float  _maxPredictionMSecs     = 1000.0f; ///< Limit of the attitude extrapolation
 };
@@ -439,23 +439,50 @@ void Joystick::run()
     //-- Joystick thread
     _open();
     //-- Reset timers
-    _axisTime.start();
+    _pollTime.start();
+    _nextAxisSendNSecs = 0;
     for (int buttonIndex = 0; buttonIndex < _totalButtonCount; buttonIndex++) {
         if(_buttonActionArray[buttonIndex]) {
             _buttonActionArray[buttonIndex]->buttonTime.start();
         }
     }
     while (!_exitThread) {
+        // Sleep until there is input, the next MANUAL_CONTROL is due or a repeat button needs checking
+        const qint64 axisPeriodNSecs = static_cast<qint64>(1e9f / _axisFrequencyHz);
+        qint64 waitNSecs = static_cast<qint64>(1e9f / _buttonFrequencyHz);
+        if (axisCount() != 0) {
+            waitNSecs = qMin(waitNSecs, _nextAxisSendNSecs - _pollTime.nsecsElapsed());
+        }
+        // The input wait only has millisecond resolution, the last millisecond before a deadline is slept precisely
+        if (waitNSecs > 1000000) {
+            _waitForInput(static_cast<int>((waitNSecs / 1000000) - 1));
+        } else if (waitNSecs > 0) {
+            QThread::usleep(static_cast<unsigned long>(waitNSecs / 1000));
+        }
+
         _update();
         _handleButtons();
         if (axisCount() != 0) {
-            _handleAxis();
+            const qint64 now = _pollTime.nsecsElapsed();
+            const bool sendManualControl = now >= _nextAxisSendNSecs;
+            if (sendManualControl) {
+                // Advance by whole periods so the send rate does not drift with the wake up latency
+                _nextAxisSendNSecs += axisPeriodNSecs;
+                if (_nextAxisSendNSecs <= now) {
+                    _nextAxisSendNSecs = now + axisPeriodNSecs;
+                }
+            }
+            _handleAxis(sendManualControl);
         }
-        QGC::SLEEP::msleep(qMin(static_cast<int>(1000.0f / _maxAxisFrequencyHz), static_cast<int>(1000.0f / _maxButtonFrequencyHz)) / 2);
     }
     _close();
 }
 
+void Joystick::_waitForInput(int timeoutMSecs)
+{
+    QThread::msleep(static_cast<unsigned long>(timeoutMSecs));
+}
+
 void Joystick::_handleButtons()
 {
     int lastBbuttonValues[256];
@@ -554,19 +581,25 @@ void Joystick::_handleButtons()
     }
 }
 
-void Joystick::_handleAxis()
+void Joystick::_handleAxis(bool sendManualControl)
 {
-    //-- Get frequency
-    int axisDelay = static_cast<int>(1000.0f / _axisFrequencyHz);
-    //-- Check elapsed time since last run
-    if(_axisTime.elapsed() > axisDelay) {
-        _axisTime.start();
-        //-- Update axis
-        for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
-            int newAxisValue = _getAxis(axisIndex);
-            // Calibration code requires signal to be emitted even if value hasn't changed
+    //-- Update axis, raw values are only emitted when they change
+    for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
+        const int newAxisValue = _getAxis(axisIndex);
+        if (newAxisValue != _rgAxisValues[axisIndex]) {
             _rgAxisValues[axisIndex] = newAxisValue;
-            emit rawAxisValueChanged(axisIndex, newAxisValue);
+            if (!_calibrationMode) {
+                emit rawAxisValueChanged(axisIndex, newAxisValue);
+            }
+        }
+    }
+    //-- Send at the axis frequency
+    if (sendManualControl) {
+        if (_calibrationMode) {
+            // Calibration code requires signal to be emitted even if value hasn't changed
+            for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
+                emit rawAxisValueChanged(axisIndex, _rgAxisValues[axisIndex]);
+            }
         }
         if (_activeVehicle->joystickEnabled() && !_calibrationMode && _calibrated) {
             int     axis = _rgFunctionAxis[rollFunction];
@@ -671,6 +704,7 @@ void Joystick::startPolling(Vehicle* vehicle)
         }
         // Always set up the new vehicle
         _activeVehicle = vehicle;
+        _activeVehicle->setManualControlRateHz(_axisFrequencyHz);
         // If joystick is not calibrated, disable it
         if ( axisCount() != 0 && !_calibrated ) {
             vehicle->setJoystickEnabled(false);
@@ -927,6 +961,9 @@ void Joystick::setAxisFrequency(float val)
     val = qMax(_minAxisFrequencyHz, val);
     val = qMin(_maxAxisFrequencyHz, val);
     _axisFrequencyHz = val;
+    if (_activeVehicle) {
+        _activeVehicle->setManualControlRateHz(_axisFrequencyHz);
+    }
     _saveSettings();
     emit axisFrequencyHzChanged();
 }
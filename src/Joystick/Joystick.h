@@ -233,7 +233,7 @@ protected:
     int     _findAssignableButtonAction(const QString& action);
     bool    _validAxis              (int axis) const;
     bool    _validButton            (int button) const;
-    void    _handleAxis             ();
+    void    _handleAxis             (bool sendManualControl);
     void    _handleButtons          ();
     void    _buildActionList        (Vehicle* activeVehicle);
 
@@ -241,6 +241,8 @@ private:
     virtual bool _open      ()          = 0;
     virtual void _close     ()          = 0;
     virtual bool _update    ()          = 0;
+    /// Blocks until there is new input or the timeout expired. The default implementation sleeps for the timeout.
+    virtual void _waitForInput(int timeoutMSecs);
 
     virtual bool _getButton (int i)      = 0;
     virtual int  _getAxis   (int i)      = 0;
@@ -292,7 +294,8 @@ protected:
 
     static int          _transmitterMode;
     int                 _rgFunctionAxis[maxFunction] = {};
-    QElapsedTimer       _axisTime;
+    QElapsedTimer       _pollTime;                  ///< Started when the polling thread starts
+    qint64              _nextAxisSendNSecs = 0;     ///< MANUAL_CONTROL deadline on _pollTime
 
     QmlObjectListModel              _assignableButtonActions;
     QList<AssignedButtonAction*>    _buttonActionArray;
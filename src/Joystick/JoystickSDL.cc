@@ -166,6 +166,31 @@ bool JoystickSDL::_update(void)
     return true;
 }
 
+void JoystickSDL::_waitForInput(int timeoutMSecs)
+{
+    // The events only wake the thread, the state is read from the device afterwards
+    SDL_Event event;
+    if (SDL_WaitEventTimeout(&event, timeoutMSecs) != 1) {
+        return;
+    }
+
+    switch (event.type) {
+    case SDL_JOYDEVICEADDED:
+    case SDL_JOYDEVICEREMOVED:
+    case SDL_QUIT:
+        // Left for JoystickManager, which polls the queue on its timer. Sleep so the event does not wake us again
+        // right away until then.
+        (void) SDL_PushEvent(&event);
+        QThread::msleep(static_cast<unsigned long>(timeoutMSecs));
+        break;
+    default:
+        // Input which was already handled would wake the next wait
+        SDL_FlushEvents(SDL_JOYAXISMOTION, SDL_JOYBUTTONUP);
+        SDL_FlushEvents(SDL_CONTROLLERAXISMOTION, SDL_CONTROLLERBUTTONUP);
+        break;
+    }
+}
+
 bool JoystickSDL::_getButton(int i) {
     if (_isGameController) {
         return SDL_GameControllerGetButton(sdlController, SDL_GameControllerButton(i)) == 1;
@@ -42,6 +42,7 @@ private:
     bool _open      () final;
     void _close     () final;
     bool _update    () final;
+    void _waitForInput(int timeoutMSecs) final;
 
     bool _getButton (int i) final;
     int  _getAxis   (int i) final;
@@ -10,23 +10,32 @@
 #include "ImageProtocolManager.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QStringList>
+
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(ImageProtocolManagerLog, "qgc.mavlink.imageprotocolmanager")
 
 ImageProtocolManager::ImageProtocolManager(QObject *parent)
     : QObject(parent)
 {
     // qCDebug(ImageProtocolManagerLog) << Q_FUNC_INFO << this;
+
+    (void) connect(&_decodeWatcher, &QFutureWatcherBase::finished, this, &ImageProtocolManager::_imageDecoded);
 }
 
 ImageProtocolManager::~ImageProtocolManager()
 {
     // qCDebug(ImageProtocolManagerLog) << Q_FUNC_INFO << this;
+
+    _decodeWatcher.waitForFinished();
 }
 
 bool ImageProtocolManager::requestImage(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t &message)
 {
     // Check if there is already an image transmission going on
-    if (_imageHandshake.packets != 0) {
+    if (_transferInProgress()) {
         return false;
     }
 
@@ -52,17 +61,22 @@ void ImageProtocolManager::mavlinkMessageReceived(const mavlink_message_t &messa
     switch (message.msgid) {
     case MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE:
     {
-        if (_imageHandshake.packets > 0) {
+        if (_transferInProgress()) {
             qCWarning(ImageProtocolManagerLog) << "DATA_TRANSMISSION_HANDSHAKE: Previous image transmission incomplete.";
+            _discardIncompleteImage();
         }
-        _imageBytes.clear();
         mavlink_msg_data_transmission_handshake_decode(&message, &_imageHandshake);
         qCDebug(ImageProtocolManagerLog) << QStringLiteral("DATA_TRANSMISSION_HANDSHAKE: type(%1) width(%2) height (%3)").arg(_imageHandshake.type).arg(_imageHandshake.width).arg(_imageHandshake.height);
+
+        // Sized up front, packets are copied straight into place as they arrive
+        _imageBytes = QByteArray(static_cast<qsizetype>(_imageHandshake.size), Qt::Uninitialized);
+        _receivedPackets.fill(false, _imageHandshake.packets);
+        _packetsReceived = 0;
         break;
     }
     case MAVLINK_MSG_ID_ENCAPSULATED_DATA:
     {
-        if (_imageHandshake.packets == 0) {
+        if (!_transferInProgress()) {
             qCWarning(ImageProtocolManagerLog) << "ENCAPSULATED_DATA: received with no prior DATA_TRANSMISSION_HANDSHAKE.";
             break;
         }
@@ -70,25 +84,25 @@ void ImageProtocolManager::mavlinkMessageReceived(const mavlink_message_t &messa
         mavlink_encapsulated_data_t encapsulatedData;
         mavlink_msg_encapsulated_data_decode(&message, &encapsulatedData);
 
-        uint32_t bytePosition = encapsulatedData.seqnr * _imageHandshake.payload;
-        if (bytePosition >= _imageHandshake.size) {
+        const uint32_t bytePosition = encapsulatedData.seqnr * _imageHandshake.payload;
+        if ((encapsulatedData.seqnr >= _imageHandshake.packets) || (bytePosition >= _imageHandshake.size)) {
             qCWarning(ImageProtocolManagerLog) << "ENCAPSULATED_DATA: seqnr is past end of image size. seqnr:" << encapsulatedData.seqnr << "_imageHandshake.size:" << _imageHandshake.size;
             break;
         }
-
-        for (uint8_t i = 0; i < _imageHandshake.payload; i++) {
-            _imageBytes[bytePosition] = encapsulatedData.data[i];
-            bytePosition++;
+        if (_receivedPackets.testBit(encapsulatedData.seqnr)) {
+            qCDebug(ImageProtocolManagerLog) << "ENCAPSULATED_DATA: duplicate packet seqnr:" << encapsulatedData.seqnr;
+            break;
         }
 
-        // We use the packets field to track completion
-        _imageHandshake.packets--;
-        if (_imageHandshake.packets == 0) {
-            // We have all the packets
-            emit imageReady(_getImage());
+        // The last packet only carries the remainder of the image
+        const uint32_t byteCount = std::min<uint32_t>({ _imageHandshake.payload, static_cast<uint32_t>(sizeof(encapsulatedData.data)), _imageHandshake.size - bytePosition });
+        (void) memcpy(_imageBytes.data() + bytePosition, encapsulatedData.data, byteCount);
 
-            _flowImageIndex++;
-            emit flowImageIndexChanged(_flowImageIndex);
+        _receivedPackets.setBit(encapsulatedData.seqnr);
+        _packetsReceived++;
+        if (_packetsReceived == _imageHandshake.packets) {
+            // We have all the packets
+            _startDecode();
         }
         break;
     }
@@ -97,46 +111,112 @@ void ImageProtocolManager::mavlinkMessageReceived(const mavlink_message_t &messa
     }
 }
 
-QImage ImageProtocolManager::_getImage()
+void ImageProtocolManager::_discardIncompleteImage()
 {
-    QImage image;
+    const uint32_t missing = _imageHandshake.packets - _packetsReceived;
+    _lostPackets += missing;
+
+    if (ImageProtocolManagerLog().isDebugEnabled()) {
+        QStringList missingSeqnrs;
+        for (qsizetype i = 0; i < _receivedPackets.size(); i++) {
+            if (!_receivedPackets.testBit(i)) {
+                missingSeqnrs.append(QString::number(i));
+            }
+        }
+        qCDebug(ImageProtocolManagerLog) << "Lost packets:" << missingSeqnrs.join(QStringLiteral(","));
+    }
+    qCWarning(ImageProtocolManagerLog) << "Image discarded, lost" << missing << "of" << _imageHandshake.packets << "packets";
 
-    if (_imageBytes.isEmpty()) {
-        qCWarning(ImageProtocolManagerLog) << Q_FUNC_INFO << "Called when no image available";
-        return image;
+    _imageHandshake.packets = 0;
+    _imageBytes.clear();
+    _receivedPackets.clear();
+    _packetsReceived = 0;
+}
+
+void ImageProtocolManager::_startDecode()
+{
+    // The buffer moves to the decoder, the next handshake allocates a new one
+    QByteArray imageBytes = std::move(_imageBytes);
+    const mavlink_data_transmission_handshake_t handshake = _imageHandshake;
+
+    _imageHandshake.packets = 0;
+    _imageBytes.clear();
+    _receivedPackets.clear();
+    _packetsReceived = 0;
+
+    if (_decodeWatcher.isRunning()) {
+        // Only the latest image is worth decoding, an older pending one is dropped
+        _pendingImageBytes = std::move(imageBytes);
+        _pendingHandshake = handshake;
+        _decodePending = true;
+        return;
     }
 
-    if (_imageHandshake.packets > 0) {
-        qCWarning(ImageProtocolManagerLog) << Q_FUNC_INFO << "Called when image is imcomplete. _imageHandshake.packets:" << _imageHandshake.packets;
+    _runDecode(imageBytes, handshake);
+}
+
+void ImageProtocolManager::_runDecode(const QByteArray &imageBytes, const mavlink_data_transmission_handshake_t &handshake)
+{
+    _decodeWatcher.setFuture(QtConcurrent::run([imageBytes, handshake]() {
+        return decodeImage(imageBytes, handshake);
+    }));
+}
+
+void ImageProtocolManager::_imageDecoded()
+{
+    const QImage image = _decodeWatcher.result();
+
+    if (_decodePending) {
+        _decodePending = false;
+        _runDecode(std::exchange(_pendingImageBytes, QByteArray()), _pendingHandshake);
+    }
+
+    if (image.isNull()) {
+        return;
+    }
+
+    emit imageReady(image);
+
+    _flowImageIndex++;
+    emit flowImageIndexChanged(_flowImageIndex);
+}
+
+QImage ImageProtocolManager::decodeImage(const QByteArray &imageBytes, const mavlink_data_transmission_handshake_t &handshake)
+{
+    QImage image;
+
+    if (imageBytes.isEmpty()) {
+        qCWarning(ImageProtocolManagerLog) << Q_FUNC_INFO << "Called when no image available";
         return image;
     }
 
-    switch (_imageHandshake.type) {
+    switch (handshake.type) {
     case MAVLINK_DATA_STREAM_IMG_RAW8U:
     case MAVLINK_DATA_STREAM_IMG_RAW32U:
     {
-        // Construct PGM header
-        const QString header = QStringLiteral("P5\n%1 %2\n255\n").arg(_imageHandshake.width).arg(_imageHandshake.height);
-
-        QByteArray tempImage(header.toStdString().c_str(), header.length());
-        (void) tempImage.append(_imageBytes);
-
-        if (!image.loadFromData(tempImage, "PGM")) {
-            qCWarning(ImageProtocolManagerLog) << Q_FUNC_INFO << "IMG_RAW8U QImage::loadFromData failed";
+        // 8 bit grayscale, the image uses the received buffer directly and keeps a reference to it
+        const qsizetype imageSize = static_cast<qsizetype>(handshake.width) * handshake.height;
+        if ((imageSize == 0) || (imageBytes.size() < imageSize)) {
+            qCWarning(ImageProtocolManagerLog) << Q_FUNC_INFO << "IMG_RAW8U image size mismatch. width:" << handshake.width << "height:" << handshake.height << "bytes:" << imageBytes.size();
+            break;
         }
+
+        QByteArray *const buffer = new QByteArray(imageBytes);
+        image = QImage(reinterpret_cast<const uchar*>(buffer->constData()), handshake.width, handshake.height, handshake.width, QImage::Format_Grayscale8,
+                       [](void *info) { delete static_cast<QByteArray*>(info); }, buffer);
         break;
     }
     case MAVLINK_DATA_STREAM_IMG_BMP:
     case MAVLINK_DATA_STREAM_IMG_JPEG:
     case MAVLINK_DATA_STREAM_IMG_PGM:
     case MAVLINK_DATA_STREAM_IMG_PNG:
-        if (!image.loadFromData(_imageBytes)) {
+        if (!image.loadFromData(imageBytes)) {
             qCWarning(ImageProtocolManagerLog) << Q_FUNC_INFO << "Known header QImage::loadFromData failed";
         }
         break;
 
     default:
-        qCWarning(ImageProtocolManagerLog) << Q_FUNC_INFO << "Unsupported image type:" << _imageHandshake.type;
+        qCWarning(ImageProtocolManagerLog) << Q_FUNC_INFO << "Unsupported image type:" << handshake.type;
         break;
     }
 
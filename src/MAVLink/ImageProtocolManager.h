@@ -11,7 +11,9 @@
 
 #include "MAVLinkLib.h"
 
+#include <QtCore/QBitArray>
 #include <QtCore/QByteArray>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtGui/QImage>
@@ -20,6 +22,10 @@ Q_DECLARE_LOGGING_CATEGORY(ImageProtocolManagerLog)
 
 /// Supports the Mavlink image transmission protocol (https://mavlink.io/en/services/image_transmission.html).
 /// Mainly used by optical flow cameras.
+///
+/// The image is reassembled into a buffer sized from the handshake, received packets are tracked so lost and
+/// duplicate packets are detected. Completed images are decoded on a worker thread, if images complete faster than
+/// they can be decoded only the latest one is decoded next.
 class ImageProtocolManager : public QObject
 {
     Q_OBJECT
@@ -33,6 +39,9 @@ public:
     bool requestImage(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t &message);
     void cancelRequest(uint8_t system_id, uint8_t component_id, uint8_t chan, mavlink_message_t &message);
 
+    /// @return Message ids handled by mavlinkMessageReceived
+    static QList<uint32_t> handledMessageIds() { return { MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE, MAVLINK_MSG_ID_ENCAPSULATED_DATA }; }
+
 signals:
     void imageReady(const QImage &image);
     void flowImageIndexChanged(uint32_t index);
@@ -40,10 +49,30 @@ signals:
 public slots:
     void mavlinkMessageReceived(const mavlink_message_t &message);
 
+    /// @return Number of packets which were lost from incomplete images since creation
+    uint32_t lostPackets() const { return _lostPackets; }
+
+    /// Decodes a complete image received with the specified handshake
+    static QImage decodeImage(const QByteArray &imageBytes, const mavlink_data_transmission_handshake_t &handshake);
+
+private slots:
+    void _imageDecoded();
+
 private:
-    QImage _getImage();
+    bool _transferInProgress() const { return (_imageHandshake.packets > 0) && (_packetsReceived < _imageHandshake.packets); }
+    void _discardIncompleteImage();
+    void _startDecode();
+    void _runDecode(const QByteArray &imageBytes, const mavlink_data_transmission_handshake_t &handshake);
 
     mavlink_data_transmission_handshake_t _imageHandshake{0};
     QByteArray _imageBytes;
+    QBitArray _receivedPackets;
+    uint16_t _packetsReceived = 0;
+    uint32_t _lostPackets = 0;
     uint32_t _flowImageIndex = 0;
+
+    QFutureWatcher<QImage> _decodeWatcher;
+    bool _decodePending = false;                            ///< A newer image completed while decoding
+    QByteArray _pendingImageBytes;
+    mavlink_data_transmission_handshake_t _pendingHandshake{0};
 };
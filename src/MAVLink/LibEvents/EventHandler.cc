@@ -14,7 +14,7 @@
 
 Q_DECLARE_METATYPE(QSharedPointer<events::parser::ParsedEvent>);
 
-EventHandler::EventHandler(QObject* parent, const QString& profile, handle_event_f handleEventCB,
+EventHandler::EventHandler(QObject* parent, handle_event_f handleEventCB,
             send_request_event_message_f sendRequestCB,
             uint8_t ourSystemId, uint8_t ourComponentId, uint8_t systemId, uint8_t componentId)
     : QObject(parent), _timer(parent),
@@ -36,22 +36,12 @@ EventHandler::EventHandler(QObject* parent, const QString& profile, handle_event
         }
     };
 
-    _parser.setProfile(profile.toStdString());
-
-    _parser.formatters().url = [](const std::string& content, const std::string& link) {
-        return "<a href=\""+link+"\">"+content+"</a>"; };
-
-    _parser.formatters().param = [](const std::string& content) {
-        return "<a href=\"param://"+content+"\">"+content+"</a>"; };
-
-    _parser.formatters().escape = [](const std::string& str) {
-        return QString::fromStdString(str).toHtmlEscaped().toStdString(); };
-
     events::ReceiveProtocol::Callbacks callbacks{error_cb, _sendRequestCB,
         std::bind(&EventHandler::gotEvent, this, std::placeholders::_1), timeout_cb};
     _protocol = new events::ReceiveProtocol(callbacks, ourSystemId, ourComponentId, systemId, componentId);
 
     connect(&_timer, &QTimer::timeout, this, [this]() { _protocol->timerEvent(); });
+    connect(&_metadataWatcher, &QFutureWatcher<EventsMetadata::SharedParser>::finished, this, &EventHandler::metadataParsed);
 
     qRegisterMetaType<QSharedPointer<events::parser::ParsedEvent>>("ParsedEvent");
 }
@@ -63,7 +53,7 @@ EventHandler::~EventHandler()
 
 void EventHandler::gotEvent(const mavlink_event_t& event)
 {
-    if (!_parser.hasDefinitions()) {
+    if (!_parser || !_parser->hasDefinitions()) {
         if (_pendingEvents.size() > 50) { // limit size (not expected to happen)
             _pendingEvents.clear();
         }
@@ -72,7 +62,7 @@ void EventHandler::gotEvent(const mavlink_event_t& event)
         return;
     }
 
-    std::unique_ptr<events::parser::ParsedEvent> parsed_event = _parser.parse(events::EventType(event));
+    std::unique_ptr<events::parser::ParsedEvent> parsed_event = _parser->parse(events::EventType(event));
     if (parsed_event == nullptr) {
         qCWarning(EventsLog) << "Got Event w/o known metadata: ID:" << event.id << "comp id:" << _compid;
         return;
@@ -93,24 +83,41 @@ void EventHandler::handleEvents(const mavlink_message_t& message)
     _protocol->processMessage(message);
 }
 
-void EventHandler::setMetadata(const QString &metadataJsonFileName)
+void EventHandler::setMetadata(const QSharedPointer<const EventsMetadata>& metadata)
 {
-    if (_parser.loadDefinitionsFile(metadataJsonFileName.toStdString())) {
-        if (_parser.hasDefinitions()) {
-            // do we have queued events?
-            for (const auto& event : _pendingEvents) {
-                gotEvent(event);
-            }
-            _pendingEvents.clear();
-        }
+    _metadata = metadata;
+    if (_metadata->parser().isFinished()) {
+        // Already parsed for another vehicle or component
+        metadataParsed();
     } else {
-        qCWarning(EventsLog) << "Failed to load events JSON metadata file";
+        _metadataWatcher.setFuture(_metadata->parser());
+    }
+}
+
+void EventHandler::metadataParsed()
+{
+    _parser = _metadata->parser().result();
+    if (!_parser) {
+        return;
+    }
+
+    if (_parser->hasDefinitions()) {
+        // do we have queued events?
+        for (const auto& event : _pendingEvents) {
+            gotEvent(event);
+        }
+        _pendingEvents.clear();
     }
+
+    emit metadataLoaded();
 }
 
 int EventHandler::getModeGroup(int32_t customMode)
 {
-    events::parser::Parser::NavigationModeGroups groups = _parser.navigationModeGroups(_compid);
+    if (!_parser) {
+        return -1;
+    }
+    events::parser::Parser::NavigationModeGroups groups = _parser->navigationModeGroups(_compid);
     for (auto groupIter : groups.groups) {
         if (groupIter.second.find(customMode) != groupIter.second.end()) {
             return groupIter.first;
@@ -9,6 +9,10 @@
 
 #pragma once
 
+#include "EventsMetadata.h"
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QString>
 #include <QtCore/QVector>
 #include <QtCore/QTimer>
@@ -24,7 +28,7 @@ public:
     using send_request_event_message_f = std::function<void(const mavlink_request_event_t& msg)>;
     using handle_event_f = std::function<void(std::unique_ptr<events::parser::ParsedEvent>)>;
 
-    EventHandler(QObject* parent, const QString& profile, handle_event_f handleEventCB,
+    EventHandler(QObject* parent, handle_event_f handleEventCB,
             send_request_event_message_f sendRequestCB,
             uint8_t ourSystemId, uint8_t ourComponentId, uint8_t systemId, uint8_t componentId);
     ~EventHandler();
@@ -32,7 +36,8 @@ public:
 
     void handleEvents(const mavlink_message_t& message);
 
-    void setMetadata(const QString& metadataJsonFileName);
+    /// Uses the metadata once it is parsed, metadataLoaded is emitted then
+    void setMetadata(const QSharedPointer<const EventsMetadata>& metadata);
 
     const events::HealthAndArmingChecks::Results& healthAndArmingCheckResults() const { return _healthAndArmingChecks.results(); }
     bool healthAndArmingCheckResultsValid() const { return _healthAndArmingChecksValid; }
@@ -40,19 +45,26 @@ public:
     int getModeGroup(int32_t customMode);
 
     bool healthAndArmingChecksSupported() const {
-        const auto& protocols = _parser.supportedProtocols(_compid);
+        if (!_parser) {
+            return false;
+        }
+        const auto& protocols = _parser->supportedProtocols(_compid);
         return protocols.find("health_and_arming_check") != protocols.end();
     }
 
 signals:
     void healthAndArmingChecksUpdated();
+    void metadataLoaded();
 
 private:
     void gotEvent(const mavlink_event_t& event);
+    void metadataParsed();
 
     events::ReceiveProtocol* _protocol{nullptr};
     QTimer _timer;
-    events::parser::Parser _parser;
+    QSharedPointer<const EventsMetadata> _metadata;
+    QFutureWatcher<EventsMetadata::SharedParser> _metadataWatcher;
+    EventsMetadata::SharedParser _parser; ///< shared with other vehicles, nullptr until the metadata is loaded
     events::HealthAndArmingChecks _healthAndArmingChecks;
     bool _healthAndArmingChecksValid{false};
     QVector<mavlink_event_t> _pendingEvents; ///< stores incoming events until we have the metadata loaded
@@ -0,0 +1,43 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "EventsMetadata.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+EventsMetadata::EventsMetadata(std::string definitions, const QString& profile)
+{
+    _parser = QtConcurrent::run([definitions = std::move(definitions), profile = profile.toStdString()]() {
+        return _parse(definitions, profile);
+    });
+}
+
+EventsMetadata::SharedParser EventsMetadata::_parse(const std::string& definitions, const std::string& profile)
+{
+    SharedParser parser = std::make_shared<events::parser::Parser>();
+
+    parser->setProfile(profile);
+
+    parser->formatters().url = [](const std::string& content, const std::string& link) {
+        return "<a href=\""+link+"\">"+content+"</a>"; };
+
+    parser->formatters().param = [](const std::string& content) {
+        return "<a href=\"param://"+content+"\">"+content+"</a>"; };
+
+    parser->formatters().escape = [](const std::string& str) {
+        return QString::fromStdString(str).toHtmlEscaped().toStdString(); };
+
+    if (!parser->loadDefinitions(definitions)) {
+        qCWarning(EventsLog) << "Failed to load events JSON metadata file";
+        return nullptr;
+    }
+
+    qCDebug(EventsLog) << "Events metadata parsed";
+    return parser;
+}
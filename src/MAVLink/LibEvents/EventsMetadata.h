@@ -0,0 +1,40 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QFuture>
+#include <QtCore/QString>
+
+#include <memory>
+#include <string>
+
+#include <libevents_includes.h>
+
+/// Events metadata of a firmware build, parsed once on a worker thread. It is kept with the shared component
+/// meta data, so all vehicles and components using the same metadata crc use the same parser. The parser is
+/// only used on the GUI thread once the future finished, and must not be changed after that.
+class EventsMetadata
+{
+public:
+    using SharedParser = std::shared_ptr<events::parser::Parser>;
+
+    /// Starts parsing on a worker thread
+    ///     @param definitions Content of the events json metadata
+    ///     @param profile Event profile to use
+    EventsMetadata(std::string definitions, const QString& profile);
+
+    /// @return Future for the parser, the result is nullptr if the metadata failed to load
+    const QFuture<SharedParser>& parser() const { return _parser; }
+
+private:
+    static SharedParser _parse(const std::string& definitions, const std::string& profile);
+
+    QFuture<SharedParser> _parser;
+};
@@ -0,0 +1,134 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSet>
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+
+/// Lookup table from MAVLink message id to the handlers which consume that message. Message ids below 256, which covers
+/// all the high rate telemetry messages, are stored in a flat array. Larger ids fall back to a hash.
+template<typename T>
+class MAVLinkMsgIdTable
+{
+public:
+    void clear()
+    {
+        for (QList<T>& handlers : _lowIdHandlers) {
+            handlers.clear();
+        }
+        _highIdHandlers.clear();
+        _allIdHandlers.clear();
+    }
+
+    /// Adds a handler for a single message id
+    void add(uint32_t msgid, const T& handler)
+    {
+        if (msgid < _lowIdCount) {
+            _lowIdHandlers[msgid].append(handler);
+        } else {
+            auto it = _highIdHandlers.find(msgid);
+            if (it == _highIdHandlers.end()) {
+                // New entries must still see the handlers which were previously added for all ids
+                it = _highIdHandlers.insert(msgid, _allIdHandlers);
+            }
+            it->append(handler);
+        }
+    }
+
+    void add(const QList<uint32_t>& msgids, const T& handler)
+    {
+        for (uint32_t msgid : msgids) {
+            add(msgid, handler);
+        }
+    }
+
+    /// Adds a handler which is called for every message id
+    void addForAllIds(const T& handler)
+    {
+        for (QList<T>& handlers : _lowIdHandlers) {
+            handlers.append(handler);
+        }
+        for (QList<T>& handlers : _highIdHandlers) {
+            handlers.append(handler);
+        }
+        _allIdHandlers.append(handler);
+    }
+
+    /// @return Handlers for the specified message id in the order they were added
+    const QList<T>& handlers(uint32_t msgid) const
+    {
+        if (msgid < _lowIdCount) {
+            return _lowIdHandlers[msgid];
+        }
+
+        auto it = _highIdHandlers.constFind(msgid);
+        return (it == _highIdHandlers.constEnd()) ? _allIdHandlers : *it;
+    }
+
+private:
+    static constexpr uint32_t _lowIdCount = 256;
+
+    std::array<QList<T>, _lowIdCount>   _lowIdHandlers;
+    QHash<uint32_t, QList<T>>           _highIdHandlers;
+    QList<T>                            _allIdHandlers;
+};
+
+/// Set of MAVLink message ids, split into a flat bitset and a hash like MAVLinkMsgIdTable. Used to skip a call for the
+/// messages the callee has no interest in.
+class MAVLinkMsgIdFilter
+{
+public:
+    static constexpr uint32_t allIds = UINT32_MAX;  ///< Passing this id to add matches every message id
+
+    void clear()
+    {
+        _lowIds.reset();
+        _highIds.clear();
+        _allIds = false;
+    }
+
+    void add(uint32_t msgid)
+    {
+        if (msgid == allIds) {
+            _allIds = true;
+        } else if (msgid < _lowIdCount) {
+            _lowIds.set(msgid);
+        } else {
+            _highIds.insert(msgid);
+        }
+    }
+
+    void add(const QList<uint32_t>& msgids)
+    {
+        for (uint32_t msgid : msgids) {
+            add(msgid);
+        }
+    }
+
+    bool contains(uint32_t msgid) const
+    {
+        if (_allIds) {
+            return true;
+        }
+        return (msgid < _lowIdCount) ? _lowIds.test(msgid) : _highIds.contains(msgid);
+    }
+
+private:
+    static constexpr uint32_t _lowIdCount = 256;
+
+    std::bitset<_lowIdCount>    _lowIds;
+    QSet<uint32_t>              _highIds;
+    bool                        _allIds = false;
+};
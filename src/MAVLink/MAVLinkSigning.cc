@@ -11,11 +11,39 @@
 #include "QGCMAVLink.h"
 #include "DeviceInfo.h"
 
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDateTime>
 
+#include <array>
+
 namespace
 {
 
+/// Replay window of one signed stream, keyed by (link id, sysid, compid) of the sender
+struct SigningStream
+{
+    uint32_t key = 0;           ///< 0 for an unused slot
+    uint64_t timestamp = 0;
+};
+
+/// Verification state of a channel. Only touched by the thread decoding the channel once initSigning has set it up.
+struct ChannelVerifier
+{
+    bool enabled = false;
+    uint8_t secretKey[32]{};
+    uint64_t timestamp = 0;     ///< Newest timestamp seen, new streams must not be older than a minute before it
+    mavlink_accept_unsigned_t acceptUnsignedCallback = nullptr;
+    QCryptographicHash hash{QCryptographicHash::Sha256};
+
+    /// Open addressed so a lookup is a couple of probes into one flat array
+    std::array<SigningStream, 64> streams{};
+    int streamCount = 0;
+};
+
+ChannelVerifier s_verifiers[MAVLINK_COMM_NUM_BUFFERS];
+
+constexpr uint64_t kNewStreamMaxAge = 6000 * 1000UL;   ///< One minute in 10us units, same as the mavlink parser
+
 mavlink_signing_t* _getChannelSigning(uint8_t channel)
 {
     mavlink_status_t* const status = mavlink_get_channel_status(channel);
@@ -87,6 +115,7 @@ bool initSigning(mavlink_channel_t channel, QByteArrayView key, mavlink_accept_u
     if (key.isEmpty()) {
         status->signing = nullptr;
         status->signing_streams = nullptr;
+        s_verifiers[channel].enabled = false;
     } else {
         static mavlink_signing_t s_signing[MAVLINK_COMM_NUM_BUFFERS];
         static mavlink_signing_streams_t s_signing_streams;
@@ -101,6 +130,14 @@ bool initSigning(mavlink_channel_t channel, QByteArrayView key, mavlink_accept_u
 
         status->signing = signing;
         status->signing_streams = &s_signing_streams;
+
+        ChannelVerifier& verifier = s_verifiers[channel];
+        (void) memcpy(verifier.secretKey, signing->secret_key, sizeof(verifier.secretKey));
+        verifier.timestamp = signing->timestamp;
+        verifier.acceptUnsignedCallback = callback;
+        verifier.streams.fill(SigningStream());
+        verifier.streamCount = 0;
+        verifier.enabled = true;
     }
 
     return true;
@@ -132,4 +169,61 @@ void createSetupSigning(mavlink_channel_t channel, mavlink_system_t target_syste
     }
 }
 
+bool verifierEnabled(mavlink_channel_t channel)
+{
+    return (channel < MAVLINK_COMM_NUM_BUFFERS) && s_verifiers[channel].enabled;
+}
+
+/// Checks the signature and replay window the same way mavlink_signature_check does
+///     @return true: message is accepted
+bool verifyMessage(mavlink_channel_t channel, const mavlink_message_t &message)
+{
+    if (!verifierEnabled(channel)) {
+        return true;
+    }
+    ChannelVerifier& verifier = s_verifiers[channel];
+
+    if (!(message.incompat_flags & MAVLINK_IFLAG_SIGNED)) {
+        return verifier.acceptUnsignedCallback && verifier.acceptUnsignedCallback(mavlink_get_channel_status(channel), message.msgid);
+    }
+
+    // QCryptographicHash uses the platform's accelerated SHA-256 where Qt was built with one, the parser's is plain C
+    verifier.hash.reset();
+    verifier.hash.addData(QByteArrayView(verifier.secretKey, sizeof(verifier.secretKey)));
+    verifier.hash.addData(QByteArrayView(&message.magic, MAVLINK_NUM_HEADER_BYTES));
+    verifier.hash.addData(QByteArrayView(_MAV_PAYLOAD(&message), message.len));
+    verifier.hash.addData(QByteArrayView(message.ck, 2));
+    verifier.hash.addData(QByteArrayView(message.signature, 1 + 6));
+    if (memcmp(verifier.hash.resultView().constData(), &message.signature[7], 6) != 0) {
+        return verifier.acceptUnsignedCallback && verifier.acceptUnsignedCallback(mavlink_get_channel_status(channel), message.msgid);
+    }
+
+    uint64_t timestamp = 0;
+    (void) memcpy(&timestamp, &message.signature[1], 6);
+
+    const uint32_t key = ((static_cast<uint32_t>(message.signature[0]) << 16) | (static_cast<uint32_t>(message.sysid) << 8) | message.compid) + 1;
+    const size_t mask = verifier.streams.size() - 1;
+    size_t slot = (key * 2654435761U) & mask;
+    while ((verifier.streams[slot].key != 0) && (verifier.streams[slot].key != key)) {
+        slot = (slot + 1) & mask;
+    }
+
+    SigningStream& stream = verifier.streams[slot];
+    if (stream.key == 0) {
+        // Keep a free slot so probing always ends
+        if ((verifier.streamCount >= static_cast<int>(verifier.streams.size()) - 1) || ((timestamp + kNewStreamMaxAge) < verifier.timestamp)) {
+            return false;
+        }
+        stream.key = key;
+        verifier.streamCount++;
+    } else if (timestamp <= stream.timestamp) {
+        // Replayed or repeated timestamp
+        return false;
+    }
+
+    stream.timestamp = timestamp;
+    verifier.timestamp = qMax(verifier.timestamp, timestamp);
+    return true;
+}
+
 } // namespace MAVLinkSigning
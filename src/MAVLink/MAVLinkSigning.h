@@ -21,4 +21,9 @@ namespace MAVLinkSigning
     bool initSigning(mavlink_channel_t channel, QByteArrayView key, mavlink_accept_unsigned_t callback);
     bool checkSigningLinkId(mavlink_channel_t channel, const mavlink_message_t &message);
     void createSetupSigning(mavlink_channel_t channel, mavlink_system_t target_system, mavlink_setup_signing_t &setup_signing);
+
+    /// Signature verification outside of mavlink_parse_char, for messages framed on the link thread with a parse state
+    /// which has no signing set. Each channel has its own replay table so links verify in parallel without sharing state.
+    bool verifierEnabled(mavlink_channel_t channel);
+    bool verifyMessage(mavlink_channel_t channel, const mavlink_message_t &message);
 }; // namespace MAVLinkSigning
@@ -48,6 +48,13 @@ public:
 
     static constexpr const uint8_t        maxRcChannels           = 18; // mavlink_rc_channels_t->chancount
 
+    /// RC channel values from RC_CHANNELS messages
+    struct RCChannels_t {
+        int         channelCount = 0;                   ///< Number of available channels, maxRcChannels max
+        int         pwmValues[maxRcChannels];           ///< -1 signals channel not available
+        uint32_t    changedMask = 0;                    ///< Bit per channel whose value changed since the previous update, every bit about once a second
+    };
+
     static bool                     isPX4FirmwareClass          (MAV_AUTOPILOT autopilot) { return autopilot == MAV_AUTOPILOT_PX4; }
     static bool                     isArduPilotFirmwareClass    (MAV_AUTOPILOT autopilot) { return autopilot == MAV_AUTOPILOT_ARDUPILOTMEGA; }
     static bool                     isGenericFirmwareClass      (MAV_AUTOPILOT autopilot) { return !isPX4FirmwareClass(autopilot) && ! isArduPilotFirmwareClass(autopilot); }
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "StatusTextHandler.h"
+#include "StatusTextListModel.h"
 #include <QGCLoggingCategory.h>
 
 #include <QtCore/QTimer>
@@ -40,6 +41,7 @@ bool StatusText::severityIsError() const
 StatusTextHandler::StatusTextHandler(QObject *parent)
     : QObject(parent)
     , m_chunkedStatusTextTimer(new QTimer(this))
+    , m_messages(new StatusTextListModel(this))
 {
     // qCDebug(StatusTextHandlerLog) << Q_FUNC_INFO << this;
 
@@ -72,18 +74,12 @@ QString StatusTextHandler::getMessageText(const mavlink_message_t &message)
 
 QString StatusTextHandler::formattedMessages() const
 {
-    QString result;
-    for (const StatusText *message: messages()) {
-        (void) result.prepend(message->getFormattedText());
-    }
-
-    return result;
+    return m_messages->formattedText();
 }
 
 void StatusTextHandler::clearMessages()
 {
-    qDeleteAll(m_messages);
-    m_messages.clear();
+    m_messages->clear();
 
     m_errorCount = 0;
     m_warningCount = 0;
@@ -235,18 +231,18 @@ void StatusTextHandler::handleTextMessage(MAV_COMPONENT compId, MAV_SEVERITY sev
 
     const QString formatText = QString("<font style=\"%1\">[%2 %3] %4: %5</font><br/>").arg(style, dateString, compString, severityText, htmlText);
 
-    StatusText* const message = new StatusText(compId, severity, text);
-    message->setFormatedText(formatText);
+    StatusText message(compId, severity, text);
+    message.setFormatedText(formatText);
 
     emit newFormattedMessage(formatText);
 
-    (void) m_messages.append(message);
-    const uint32_t count = m_messages.count();
+    m_messages->append(message);
+    const uint32_t count = m_messages->count();
 
     _handleTextMessage(count, messageType);
 
-    if (message->severityIsError()) {
-        emit newErrorMessage(message->getText());
+    if (message.severityIsError()) {
+        emit newErrorMessage(message.getText());
     }
 }
 
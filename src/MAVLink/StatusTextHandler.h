@@ -18,11 +18,13 @@
 Q_DECLARE_LOGGING_CATEGORY(StatusTextHandlerLog)
 
 class StatusTextHandler;
+class StatusTextListModel;
 class QTimer;
 
 class StatusText
 {
 public:
+    StatusText() = default;
     StatusText(MAV_COMPONENT componentid, MAV_SEVERITY severity, const QString &text);
 
     bool severityIsError() const;
@@ -35,8 +37,8 @@ public:
     void setFormatedText(const QString &formatedText) { m_formatedText = formatedText; }
 
 private:
-    MAV_COMPONENT m_compId;
-    MAV_SEVERITY m_severity;
+    MAV_COMPONENT m_compId = MAV_COMP_ID_ALL;
+    MAV_SEVERITY m_severity = MAV_SEVERITY_DEBUG;
     QString m_text;
     QString m_formatedText;
 };
@@ -63,7 +65,8 @@ public:
     void resetAllMessages();
     void resetErrorLevelMessages();
 
-    const QList<StatusText*>& messages() const { return m_messages; }
+    /// Bounded message history, newest first
+    StatusTextListModel *messages() const { return m_messages; }
     QString formattedMessages() const;
 
     bool messageTypeNone() const { return (m_messageType == MessageType::MessageNone); }
@@ -104,7 +107,7 @@ private:
     uint32_t m_normalCount = 0;
     uint32_t m_messageCount = 0;
 
-    QVector<StatusText*> m_messages;
+    StatusTextListModel *m_messages = nullptr;
 
     MessageType m_messageType = MessageType::MessageNone;
 
@@ -0,0 +1,118 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "StatusTextListModel.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(StatusTextListModelLog, "qgc.mavlink.statustextlistmodel")
+
+StatusTextListModel::StatusTextListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    // qCDebug(StatusTextListModelLog) << Q_FUNC_INFO << this;
+
+    _ring.resize(_capacity);
+}
+
+StatusTextListModel::~StatusTextListModel()
+{
+    // qCDebug(StatusTextListModelLog) << Q_FUNC_INFO << this;
+}
+
+void StatusTextListModel::append(const StatusText &message)
+{
+    if (_count == capacity()) {
+        const int oldestRow = _count - 1;
+        const StatusText &oldest = at(oldestRow);
+
+        beginRemoveRows(QModelIndex(), oldestRow, oldestRow);
+        if (oldest.getSeverity() < MAV_SEVERITY_ENUM_END) {
+            _severityCounts[oldest.getSeverity()]--;
+        }
+        _formattedText.chop(oldest.getFormattedText().length());
+        _count--;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), 0, 0);
+    _ring[_head] = message;
+    _head = (_head + 1) % capacity();
+    _count++;
+    if (message.getSeverity() < MAV_SEVERITY_ENUM_END) {
+        _severityCounts[message.getSeverity()]++;
+    }
+    (void) _formattedText.prepend(message.getFormattedText());
+    endInsertRows();
+
+    emit countChanged();
+}
+
+void StatusTextListModel::clear()
+{
+    if (_count == 0) {
+        return;
+    }
+
+    beginResetModel();
+    _head = 0;
+    _count = 0;
+    _severityCounts.fill(0);
+    _formattedText.clear();
+    _ring.fill(StatusText());
+    endResetModel();
+
+    emit countChanged();
+}
+
+int StatusTextListModel::severityCount(MAV_SEVERITY severity) const
+{
+    if (severity >= MAV_SEVERITY_ENUM_END) {
+        return 0;
+    }
+
+    return _severityCounts[severity];
+}
+
+int StatusTextListModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+
+    return count();
+}
+
+QVariant StatusTextListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() < 0) || (index.row() >= count())) {
+        return QVariant();
+    }
+
+    const StatusText &message = at(index.row());
+    switch (role) {
+    case FormattedTextRole:
+        return message.getFormattedText();
+    case TextRole:
+        return message.getText();
+    case SeverityRole:
+        return static_cast<int>(message.getSeverity());
+    case ComponentIdRole:
+        return static_cast<int>(message.getComponentID());
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> StatusTextListModel::roleNames() const
+{
+    return {
+        { FormattedTextRole,    "formattedText" },
+        { TextRole,             "text" },
+        { SeverityRole,         "severity" },
+        { ComponentIdRole,      "componentId" },
+    };
+}
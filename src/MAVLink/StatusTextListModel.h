@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtQmlIntegration/QtQmlIntegration>
+
+#include "MAVLinkLib.h"
+#include "StatusTextHandler.h"
+
+#include <array>
+
+Q_DECLARE_LOGGING_CATEGORY(StatusTextListModelLog)
+
+/// Bounded status text history, newest message first. The messages live in a fixed size ring so a chatty component
+/// cannot grow the history for the whole flight. Each message is formatted once when it arrives, the joined history
+/// is kept up to date incrementally and the number of retained messages per severity is indexed.
+class StatusTextListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("")
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        FormattedTextRole = Qt::UserRole + 1,
+        TextRole,
+        SeverityRole,
+        ComponentIdRole,
+    };
+
+    explicit StatusTextListModel(QObject *parent = nullptr);
+    ~StatusTextListModel();
+
+    int count() const { return _count; }
+    int capacity() const { return static_cast<int>(_ring.count()); }
+
+    /// Adds the message as row 0, the oldest message is dropped once the capacity is reached
+    void append(const StatusText &message);
+
+    void clear();
+
+    /// @return Message at row, row 0 is the newest
+    const StatusText &at(int row) const { return _ring[_ringIndex(row)]; }
+
+    /// @return Number of retained messages with the specified severity
+    int severityCount(MAV_SEVERITY severity) const;
+
+    /// @return Formatted text of all retained messages, newest first
+    const QString &formattedText() const { return _formattedText; }
+
+    // Overrides from QAbstractListModel
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void countChanged();
+
+private:
+    int _ringIndex(int row) const { return (_head - 1 - row + capacity()) % capacity(); }
+
+    QList<StatusText> _ring;
+    int _head = 0;                                  ///< Ring slot the next message is written to
+    int _count = 0;
+    std::array<int, MAV_SEVERITY_ENUM_END> _severityCounts{};
+    QString _formattedText;
+
+    static constexpr int _capacity = 500;
+};
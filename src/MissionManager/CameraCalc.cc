@@ -45,10 +45,17 @@ CameraCalc::CameraCalc(PlanMasterController* masterController, const QString& se
     connect(&_cameraNameFact, &Fact::valueChanged, this, &CameraCalc::isManualCameraChanged);
     connect(&_cameraNameFact, &Fact::valueChanged, this, &CameraCalc::isCustomCameraChanged);
 
+    // The footprint is only recalculated when next needed. These must be connected ahead of the recalc slots.
+    connect(&_imageDensityFact,         &Fact::rawValueChanged, this, &CameraCalc::_invalidateImageFootprint);
+    connect(imageWidth(),               &Fact::rawValueChanged, this, &CameraCalc::_invalidateImageFootprint);
+    connect(imageHeight(),              &Fact::rawValueChanged, this, &CameraCalc::_invalidateImageFootprint);
+    connect(landscape(),                &Fact::rawValueChanged, this, &CameraCalc::_invalidateImageFootprint);
+
+    // The overlaps only affect their own adjusted footprint, everything else affects all values
+    connect(&_frontalOverlapFact,       &Fact::rawValueChanged, this, &CameraCalc::_recalcAdjustedFootprintFrontal);
+    connect(&_sideOverlapFact,          &Fact::rawValueChanged, this, &CameraCalc::_recalcAdjustedFootprintSide);
     connect(&_distanceToSurfaceFact,    &Fact::rawValueChanged, this, &CameraCalc::_recalcTriggerDistance);
     connect(&_imageDensityFact,         &Fact::rawValueChanged, this, &CameraCalc::_recalcTriggerDistance);
-    connect(&_frontalOverlapFact,       &Fact::rawValueChanged, this, &CameraCalc::_recalcTriggerDistance);
-    connect(&_sideOverlapFact,          &Fact::rawValueChanged, this, &CameraCalc::_recalcTriggerDistance);
     connect(sensorWidth(),              &Fact::rawValueChanged, this, &CameraCalc::_recalcTriggerDistance);
     connect(sensorHeight(),             &Fact::rawValueChanged, this, &CameraCalc::_recalcTriggerDistance);
     connect(imageWidth(),               &Fact::rawValueChanged, this, &CameraCalc::_recalcTriggerDistance);
@@ -125,47 +132,88 @@ void CameraCalc::_cameraNameChanged(void)
     }
 }
 
+bool CameraCalc::_validCameraSpecs(void)
+{
+    return focalLength()->rawValue().toDouble() > 0 &&
+            sensorWidth()->rawValue().toDouble() > 0 &&
+            sensorHeight()->rawValue().toDouble() > 0 &&
+            imageWidth()->rawValue().toDouble() > 0 &&
+            imageHeight()->rawValue().toDouble() > 0 &&
+            _imageDensityFact.rawValue().toDouble() > 0;
+}
+
 void CameraCalc::_recalcTriggerDistance(void)
 {
-    if (_disableRecalc || isManualCamera()) {
+    if (_disableRecalc || isManualCamera() || !_validCameraSpecs()) {
         return;
     }
 
-    _disableRecalc = true;
-
     double focalLength =    this->focalLength()->rawValue().toDouble();
     double sensorWidth =    this->sensorWidth()->rawValue().toDouble();
-    double sensorHeight =   this->sensorHeight()->rawValue().toDouble();
     double imageWidth =     this->imageWidth()->rawValue().toDouble();
-    double imageHeight =    this->imageHeight()->rawValue().toDouble();
-    double imageDensity =   _imageDensityFact.rawValue().toDouble();
-
-    if (focalLength <= 0 || sensorWidth <= 0 || sensorHeight <= 0 || imageWidth <= 0 || imageHeight <= 0 || imageDensity <= 0) {
-        return;
-    }
 
+    _disableRecalc = true;
     if (_valueSetIsDistanceFact.rawValue().toBool()) {
         _imageDensityFact.setRawValue((_distanceToSurfaceFact.rawValue().toDouble() * sensorWidth * 100.0) / (imageWidth * focalLength));
     } else {
         _distanceToSurfaceFact.setRawValue((imageWidth * _imageDensityFact.rawValue().toDouble() * focalLength) / (sensorWidth * 100.0));
     }
+    _disableRecalc = false;
+
+    _recalcAdjustedFootprintSide();
+    _recalcAdjustedFootprintFrontal();
+}
+
+void CameraCalc::_recalcAdjustedFootprintSide(void)
+{
+    if (_disableRecalc || isManualCamera() || !_validCameraSpecs()) {
+        return;
+    }
+
+    _updateImageFootprint();
+    _adjustedFootprintSideFact.setRawValue(_imageFootprintSide * ((100.0 - _sideOverlapFact.rawValue().toDouble()) / 100.0));
+}
+
+void CameraCalc::_recalcAdjustedFootprintFrontal(void)
+{
+    if (_disableRecalc || isManualCamera() || !_validCameraSpecs()) {
+        return;
+    }
+
+    _updateImageFootprint();
+    _adjustedFootprintFrontalFact.setRawValue(_imageFootprintFrontal * ((100.0 - _frontalOverlapFact.rawValue().toDouble()) / 100.0));
+}
+
+/// Recalculates the image footprint if one of its inputs changed since the last time
+void CameraCalc::_updateImageFootprint(void)
+{
+    if (_imageFootprintValid) {
+        return;
+    }
+    _imageFootprintValid = true;
 
-    imageDensity = _imageDensityFact.rawValue().toDouble();
+    double imageWidth =     this->imageWidth()->rawValue().toDouble();
+    double imageHeight =    this->imageHeight()->rawValue().toDouble();
+    double imageDensity =   _imageDensityFact.rawValue().toDouble();
 
+    double imageFootprintSide;
+    double imageFootprintFrontal;
     if (landscape()->rawValue().toBool()) {
-        _imageFootprintSide =       (imageWidth  * imageDensity) / 100.0;
-        _imageFootprintFrontal =    (imageHeight * imageDensity) / 100.0;
+        imageFootprintSide =    (imageWidth  * imageDensity) / 100.0;
+        imageFootprintFrontal = (imageHeight * imageDensity) / 100.0;
     } else {
-        _imageFootprintSide  =      (imageHeight * imageDensity) / 100.0;
-        _imageFootprintFrontal =    (imageWidth  * imageDensity) / 100.0;
+        imageFootprintSide =    (imageHeight * imageDensity) / 100.0;
+        imageFootprintFrontal = (imageWidth  * imageDensity) / 100.0;
     }
-    _adjustedFootprintSideFact.setRawValue      (_imageFootprintSide * ((100.0 - _sideOverlapFact.rawValue().toDouble()) / 100.0));
-    _adjustedFootprintFrontalFact.setRawValue   (_imageFootprintFrontal * ((100.0 - _frontalOverlapFact.rawValue().toDouble()) / 100.0));
 
-    emit imageFootprintSideChanged      (_imageFootprintSide);
-    emit imageFootprintFrontalChanged   (_imageFootprintFrontal);
-
-    _disableRecalc = false;
+    if (imageFootprintSide != _imageFootprintSide) {
+        _imageFootprintSide = imageFootprintSide;
+        emit imageFootprintSideChanged(_imageFootprintSide);
+    }
+    if (imageFootprintFrontal != _imageFootprintFrontal) {
+        _imageFootprintFrontal = imageFootprintFrontal;
+        emit imageFootprintFrontalChanged(_imageFootprintFrontal);
+    }
 }
 
 void CameraCalc::save(QJsonObject& json) const
@@ -275,6 +323,11 @@ bool CameraCalc::load(const QJsonObject& originalJson, bool deprecatedFollowTerr
 
     _disableRecalc = false;
 
+    if (!isManualCamera()) {
+        // The stored adjusted footprints are kept as loaded, only the image footprint is brought up to date
+        _updateImageFootprint();
+    }
+
     _setBrandModelFromCanonicalName(canonicalCameraName);
 
     return true;
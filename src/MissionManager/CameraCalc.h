@@ -109,6 +109,9 @@ signals:
 
 private slots:
     void _recalcTriggerDistance             (void);
+    void _recalcAdjustedFootprintSide       (void);
+    void _recalcAdjustedFootprintFrontal    (void);
+    void _invalidateImageFootprint          (void) { _imageFootprintValid = false; }
     void _setDirty                          (void);
     void _cameraNameChanged                 (void);
 
@@ -116,6 +119,8 @@ private:
     void    _setBrandModelFromCanonicalName (const QString& cameraName);
     void    _rebuildCameraModelList         (void);
     QString _validCanonicalCameraName       (const QString& cameraName);
+    bool    _validCameraSpecs               (void);
+    void    _updateImageFootprint           (void);
 
     bool                                _disableRecalc              = false;
     QString                             _cameraBrand;
@@ -125,6 +130,7 @@ private:
     QGroundControlQmlGlobal::AltMode    _distanceMode               = QGroundControlQmlGlobal::AltitudeModeRelative;
     double                              _imageFootprintSide         = 0;
     double                              _imageFootprintFrontal      = 0;
+    bool                                _imageFootprintValid        = false;    ///< Cleared when an input of the image footprint changes
     QVariantList                        _knownCameraList;
 
     QMap<QString, FactMetaData*> _metaDataMap;
@@ -15,7 +15,7 @@
 #include "PlanMasterController.h"
 #include "FlightPathSegment.h"
 #include "MissionController.h"
-#include "KMLPlanDomDocument.h"
+#include "KMLPlanStreamWriter.h"
 #include "SettingsManager.h"
 
 #include <QtCore/QCborMap>
@@ -113,14 +113,14 @@ QJsonObject ComplexMissionItem::_loadPresetJson(const QString& name)
     return QCborValue::fromVariant(settings.value(name)).toMap().toJsonObject();
 }
 
-void ComplexMissionItem::addKMLVisuals(KMLPlanDomDocument& /* domDocument */)
+void ComplexMissionItem::addKMLVisuals(KMLPlanStreamWriter& /* kml */)
 {
     // Default implementation has no visuals
 }
 
-void ComplexMissionItem::_appendFlightPathSegment(FlightPathSegment::SegmentType segmentType, const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt)
+FlightPathSegment* ComplexMissionItem::_appendFlightPathSegment(FlightPathSegment::SegmentType segmentType, const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt, bool queryTerrainData)
 {
-    FlightPathSegment* segment = new FlightPathSegment(segmentType, coord1, coord1AMSLAlt, coord2, coord2AMSLAlt, true /* queryTerrainData */, this /* parent */);
+    FlightPathSegment* segment = new FlightPathSegment(segmentType, coord1, coord1AMSLAlt, coord2, coord2AMSLAlt, queryTerrainData, this /* parent */);
 
     connect(segment, &FlightPathSegment::terrainCollisionChanged,       this,               &ComplexMissionItem::_segmentTerrainCollisionChanged);
     connect(segment, &FlightPathSegment::terrainCollisionChanged,       _missionController, &MissionController::recalcTerrainProfile, Qt::QueuedConnection);
@@ -136,6 +136,8 @@ void ComplexMissionItem::_appendFlightPathSegment(FlightPathSegment::SegmentType
     if (segment->amslTerrainHeights().count()) {
         _missionController->recalcTerrainProfile();
     }
+
+    return segment;
 }
 
 void ComplexMissionItem::_segmentTerrainCollisionChanged(bool terrainCollision)
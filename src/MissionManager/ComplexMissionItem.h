@@ -15,7 +15,7 @@
 
 class PlanMasterController;
 class MissionController;
-class KMLPlanDomDocument;
+class KMLPlanStreamWriter;
 class SettingsManager;
 class QGCToolbox;
 
@@ -91,7 +91,7 @@ public:
     ///     Empty string signals no support for presets.
     virtual QString presetsSettingsGroup(void) { return QString(); }
 
-    virtual void addKMLVisuals(KMLPlanDomDocument& domDocument);
+    virtual void addKMLVisuals(KMLPlanStreamWriter& kml);
 
     bool presetsSupported   (void) { return !presetsSettingsGroup().isEmpty(); }
     bool isIncomplete       (void) const { return _isIncomplete; }
@@ -115,7 +115,8 @@ protected slots:
 protected:
     void        _savePresetJson         (const QString& name, QJsonObject& presetObject);
     QJsonObject _loadPresetJson         (const QString& name);
-    void        _appendFlightPathSegment(FlightPathSegment::SegmentType segmentType, const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt);
+    /// @param queryTerrainData false: the caller supplies the terrain heights through FlightPathSegment::setTerrainPathHeights
+    FlightPathSegment* _appendFlightPathSegment(FlightPathSegment::SegmentType segmentType, const QGeoCoordinate& coord1, double coord1AMSLAlt, const QGeoCoordinate& coord2, double coord2AMSLAlt, bool queryTerrainData = true);
 
     bool                _isIncomplete =                 true;
     int                 _cTerrainCollisionSegments =    0;
@@ -15,6 +15,7 @@
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrent>
 #include <QtCore/QJsonArray>
 
 QGC_LOGGING_CATEGORY(CorridorScanComplexItemLog, "CorridorScanComplexItemLog")
@@ -45,6 +46,11 @@ CorridorScanComplexItem::CorridorScanComplexItem(PlanMasterController* masterCon
     connect(&_corridorPolyline,     &QGCMapPolyline::isValidChanged,                this, &CorridorScanComplexItem::_updateWizardMode);
     connect(&_corridorPolyline,     &QGCMapPolyline::traceModeChanged,              this, &CorridorScanComplexItem::_updateWizardMode);
 
+    _transectRebuildTimer.setSingleShot(true);
+    _transectRebuildTimer.setInterval(_backgroundRebuildDebounceMsecs);
+    connect(&_transectRebuildTimer,     &QTimer::timeout,                           this, &CorridorScanComplexItem::_startBackgroundTransectRebuild);
+    connect(&_transectRebuildWatcher,   &QFutureWatcherBase::finished,              this, &CorridorScanComplexItem::_backgroundTransectsReady);
+
     if (!kmlFile.isEmpty()) {
         _corridorPolyline.loadKMLFile(kmlFile);
         _corridorPolyline.setDirty(false);
@@ -125,6 +131,9 @@ bool CorridorScanComplexItem::_loadWorker(const QJsonObject& complexObject, int
     }
 
     if (!forPresets) {
+        // The loaded transects replace whatever a background rebuild would deliver
+        _cancelBackgroundTransectRebuild();
+
         if (!_corridorPolyline.loadFromJson(complexObject, true, errorString)) {
             _ignoreRecalc = false;
             return false;
@@ -216,20 +225,110 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
         return;
     }
 
+    _clearLoadedMissionItems();
+    _cancelBackgroundTransectRebuild();
+
+    _transects = _generateTransects(_transectGenerationParams());
+}
+
+/// Drops any pending or running background rebuild, the current _transects are up to date
+void CorridorScanComplexItem::_cancelBackgroundTransectRebuild(void)
+{
+    _transectRebuildTimer.stop();
+    _transectGeneration++;
+    _appliedTransectGeneration = _transectGeneration;
+}
+
+bool CorridorScanComplexItem::_rebuildTransectsPhase1Background(void)
+{
+    // Short polylines are quick enough to rebuild in place. Unit tests need the transects to be available on return.
+    if ((_corridorPolyline.count() < _backgroundRebuildMinVertices) || qgcApp()->runningUnitTests()) {
+        return false;
+    }
+
+    _clearLoadedMissionItems();
+
+    // Any result still being computed is stale from now on
+    _transectGeneration++;
+    _transectRebuildTimer.start();
+    emit readyForSaveStateChanged();
+
+    return true;
+}
+
+void CorridorScanComplexItem::_clearLoadedMissionItems(void)
+{
     // If the transects are getting rebuilt then any previsouly loaded mission items are now invalid
     if (_loadedMissionItemsParent) {
         _loadedMissionItems.clear();
         _loadedMissionItemsParent->deleteLater();
         _loadedMissionItemsParent = nullptr;
     }
+}
 
-    double transectSpacing = _calcTransectSpacing();
-    double fullWidth = _corridorWidthFact.rawValue().toDouble();
-    double halfWidth = fullWidth / 2.0;
-    int transectCount = _calcTransectCount();
+void CorridorScanComplexItem::_startBackgroundTransectRebuild(void)
+{
+    if (_transectRebuildWatcher.isRunning()) {
+        // _backgroundTransectsReady starts the rebuild again for the latest generation once the running one is done
+        return;
+    }
+
+    const TransectGenerationParams_t params = _transectGenerationParams();
+    const quint64 generation = _transectGeneration;
+    qCDebug(CorridorScanComplexItemLog) << "_startBackgroundTransectRebuild generation" << generation;
+
+    _transectRebuildWatcher.setFuture(QtConcurrent::run([params, generation]() {
+        return BackgroundTransects_t{ generation, _generateTransects(params) };
+    }));
+}
+
+void CorridorScanComplexItem::_backgroundTransectsReady(void)
+{
+    const BackgroundTransects_t result = _transectRebuildWatcher.result();
+
+    if (result.generation != _transectGeneration) {
+        qCDebug(CorridorScanComplexItemLog) << "_backgroundTransectsReady dropping stale generation" << result.generation << _transectGeneration;
+        if ((_appliedTransectGeneration != _transectGeneration) && !_transectRebuildTimer.isActive()) {
+            _startBackgroundTransectRebuild();
+        }
+        return;
+    }
+
+    _appliedTransectGeneration = result.generation;
+    _setBackgroundTransects(result.transects);
+    emit readyForSaveStateChanged();
+}
+
+CorridorScanComplexItem::TransectGenerationParams_t CorridorScanComplexItem::_transectGenerationParams(void) const
+{
+    TransectGenerationParams_t params;
+
+    params.polyline             = _corridorPolyline.coordinateList();
+    params.transectSpacing      = _calcTransectSpacing();
+    params.corridorWidth        = _corridorWidthFact.rawValue().toDouble();
+    params.transectCount        = _calcTransectCount();
+    params.entryPoint           = _entryPoint;
+    params.turnAroundDistance   = _turnAroundDistanceFact.rawValue().toDouble();
+
+    return params;
+}
+
+/// Generates the transects from a snapshot of the corridor settings. This doesn't touch the item so it is safe to
+/// run on a worker thread. The transects only differ by their offset from the polyline, so the polyline is converted
+/// to the local frame once and each transect is offset from that.
+QList<QList<TransectStyleComplexItem::CoordInfo_t>> CorridorScanComplexItem::_generateTransects(const TransectGenerationParams_t& params)
+{
+    QList<QList<CoordInfo_t>> transects;
+
+    double transectSpacing = params.transectSpacing;
+    double halfWidth = params.corridorWidth / 2.0;
+    int transectCount = params.transectCount;
     double normalizedTransectPosition = transectSpacing / 2.0;
 
-    if (_corridorPolyline.count() >= 2) {
+    if (params.polyline.count() >= 2) {
+        const QList<QPointF> nedPolyline = QGCMapPolyline::nedPolyline(params.polyline);
+        const QGeoCoordinate& tangentOrigin = params.polyline.first();
+
         // First build up the transects all going the same direction
         //qDebug() << "_rebuildTransectsPhase1";
         for (int i=0; i<transectCount; i++) {
@@ -245,7 +344,7 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
 
             // Turn transect into CoordInfo transect
             QList<TransectStyleComplexItem::CoordInfo_t> transect;
-            QList<QGeoCoordinate> transectCoords = _corridorPolyline.offsetPolyline(offsetDistance);
+            QList<QGeoCoordinate> transectCoords = QGCMapPolyline::offsetPolyline(nedPolyline, tangentOrigin, offsetDistance);
             for (int j=1; j<transectCoords.count() - 1; j++) {
                 TransectStyleComplexItem::CoordInfo_t coordInfo = { transectCoords[j], CoordTypeInterior };
                 transect.append(coordInfo);
@@ -256,9 +355,9 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
             transect.append(coordInfo);
 
             // Extend the transect ends for turnaround
-            if (_hasTurnaround()) {
+            if (params.turnAroundDistance > 0) {
                 QGeoCoordinate turnaroundCoord;
-                double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+                double turnAroundDistance = params.turnAroundDistance;
 
                 double azimuth = transectCoords[0].azimuthTo(transectCoords[1]);
                 turnaroundCoord = transectCoords[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -280,7 +379,7 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
             }
 #endif
 
-            _transects.append(transect);
+            transects.append(transect);
             normalizedTransectPosition += transectSpacing;
         }
 
@@ -292,7 +391,7 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
 
         bool reverseTransects = false;
         bool reverseVertices = false;
-        switch (_entryPoint) {
+        switch (params.entryPoint) {
         case 0:
             reverseTransects = false;
             reverseVertices = false;
@@ -312,26 +411,26 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
         }
         if (reverseTransects) {
             QList<QList<TransectStyleComplexItem::CoordInfo_t>> reversedTransects;
-            for (const QList<TransectStyleComplexItem::CoordInfo_t>& transect: _transects) {
+            for (const QList<TransectStyleComplexItem::CoordInfo_t>& transect: transects) {
                 reversedTransects.prepend(transect);
             }
-            _transects = reversedTransects;
+            transects = reversedTransects;
         }
         if (reverseVertices) {
-            for (int i=0; i<_transects.count(); i++) {
+            for (int i=0; i<transects.count(); i++) {
                 QList<TransectStyleComplexItem::CoordInfo_t> reversedVertices;
-                for (const TransectStyleComplexItem::CoordInfo_t& vertex: _transects[i]) {
+                for (const TransectStyleComplexItem::CoordInfo_t& vertex: transects[i]) {
                     reversedVertices.prepend(vertex);
                 }
-                _transects[i] = reversedVertices;
+                transects[i] = reversedVertices;
             }
         }
 
         // Adjust to lawnmower pattern
         reverseVertices = false;
-        for (int i=0; i<_transects.count(); i++) {
+        for (int i=0; i<transects.count(); i++) {
             // We must reverse the vertices for every other transect in order to make a lawnmower pattern
-            QList<TransectStyleComplexItem::CoordInfo_t> transectVertices = _transects[i];
+            QList<TransectStyleComplexItem::CoordInfo_t> transectVertices = transects[i];
             if (reverseVertices) {
                 reverseVertices = false;
                 QList<TransectStyleComplexItem::CoordInfo_t> reversedVertices;
@@ -350,9 +449,11 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
             } else {
                 reverseVertices = true;
             }
-            _transects[i] = transectVertices;
+            transects[i] = transectVertices;
         }
     }
+
+    return transects;
 }
 
 void CorridorScanComplexItem::_recalcCameraShots(void)
@@ -373,6 +474,10 @@ void CorridorScanComplexItem::_recalcCameraShots(void)
 
 CorridorScanComplexItem::ReadyForSaveState CorridorScanComplexItem::readyForSaveState(void) const
 {
+    if (_appliedTransectGeneration != _transectGeneration) {
+        // Transects are still being rebuilt in the background
+        return NotReadyForSaveData;
+    }
     return TransectStyleComplexItem::readyForSaveState();
 }
 
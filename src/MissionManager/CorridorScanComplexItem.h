@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
 
 #include "TransectStyleComplexItem.h"
 #include "SettingsFact.h"
@@ -70,7 +72,31 @@ private slots:
     void _rebuildTransectsPhase1    (void) final;
     void _recalcCameraShots         (void) final;
 
+    void _startBackgroundTransectRebuild(void);
+    void _backgroundTransectsReady      (void);
+
 private:
+    /// Snapshot of everything transect generation depends on, so it can run away from the item
+    struct TransectGenerationParams_t {
+        QList<QGeoCoordinate>   polyline;
+        double                  transectSpacing     = 0;
+        double                  corridorWidth       = 0;
+        int                     transectCount       = 0;
+        int                     entryPoint          = 0;
+        double                  turnAroundDistance  = 0;
+    };
+
+    struct BackgroundTransects_t {
+        quint64                     generation = 0;
+        QList<QList<CoordInfo_t>>   transects;
+    };
+
+    bool _rebuildTransectsPhase1Background(void) final;
+    void _clearLoadedMissionItems(void);
+    void _cancelBackgroundTransectRebuild(void);
+    TransectGenerationParams_t _transectGenerationParams(void) const;
+    static QList<QList<CoordInfo_t>> _generateTransects(const TransectGenerationParams_t& params);
+
     double  _calcTransectSpacing    (void) const;
     int     _calcTransectCount      (void) const;
     void    _saveCommon             (QJsonObject& complexObject);
@@ -84,5 +110,15 @@ private:
     QMap<QString, FactMetaData*>    _metaDataMap;
     SettingsFact                    _corridorWidthFact;
 
+    QTimer                                  _transectRebuildTimer;                  ///< Debounces background rebuilds
+    QFutureWatcher<BackgroundTransects_t>   _transectRebuildWatcher;
+    quint64                                 _transectGeneration         = 0;        ///< Incremented for each requested rebuild
+    quint64                                 _appliedTransectGeneration  = 0;        ///< Generation _transects was built for
+
+    static constexpr int _backgroundRebuildMinVertices      = 16;
+    static constexpr int _backgroundRebuildDebounceMsecs    = 100;
+
     static constexpr const char* _jsonEntryPointKey =       "EntryPoint";
+
+    friend class PlanningGeometryBenchmark;
 };
@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GeoFenceBreachMonitor.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(GeoFenceBreachMonitorLog, "qgc.missionmanager.geofencebreachmonitor")
+
+GeoFenceBreachMonitor::GeoFenceBreachMonitor(QObject *parent)
+    : QObject(parent)
+{
+    // qCDebug(GeoFenceBreachMonitorLog) << Q_FUNC_INFO << this;
+}
+
+GeoFenceBreachMonitor::~GeoFenceBreachMonitor()
+{
+    // qCDebug(GeoFenceBreachMonitorLog) << Q_FUNC_INFO << this;
+}
+
+void GeoFenceBreachMonitor::setVehicleStates(const QList<VehicleState_t> &vehicleStates)
+{
+    QList<Breach_t> breaches;
+    for (const VehicleState_t &vehicle : vehicleStates) {
+        const Breach_t breach = evaluate(vehicle);
+        if (breach.state != BreachNone) {
+            breaches.append(breach);
+        }
+    }
+
+    if (!breaches.isEmpty() || _breachesReported) {
+        _breachesReported = !breaches.isEmpty();
+        emit breachesUpdated(breaches);
+    }
+}
+
+GeoFenceBreachMonitor::Breach_t GeoFenceBreachMonitor::evaluate(const VehicleState_t &vehicle)
+{
+    Breach_t breach;
+    breach.vehicleId = vehicle.vehicleId;
+
+    if (!vehicle.fence || vehicle.fence->isEmpty() || !vehicle.coordinate.isValid()) {
+        return breach;
+    }
+
+    const GeoFenceIndex &fence = *vehicle.fence;
+    if (fence.breached(vehicle.coordinate)) {
+        breach.state = BreachActive;
+        return breach;
+    }
+
+    if (vehicle.groundSpeed >= _minPredictionSpeed) {
+        const double lookAheadDistance = vehicle.groundSpeed * _lookAheadSecs;
+        if (!fence.segmentInside(vehicle.coordinate, vehicle.coordinate.atDistanceAndAzimuth(lookAheadDistance, vehicle.heading))) {
+            // Narrow down where the track leaves the fence
+            double inside = 0;
+            double outside = lookAheadDistance;
+            for (int i = 0; i < _timeToBreachSteps; i++) {
+                const double distance = (inside + outside) / 2.0;
+                if (fence.segmentInside(vehicle.coordinate, vehicle.coordinate.atDistanceAndAzimuth(distance, vehicle.heading))) {
+                    inside = distance;
+                } else {
+                    outside = distance;
+                }
+            }
+
+            breach.state = BreachPredicted;
+            breach.timeToBreach = outside / vehicle.groundSpeed;
+            return breach;
+        }
+    }
+
+    const double boundaryDistance = fence.boundaryDistance(vehicle.coordinate, _proximityMeters);
+    if (boundaryDistance < _proximityMeters) {
+        breach.state = BreachProximity;
+        breach.boundaryDistance = boundaryDistance;
+    }
+
+    return breach;
+}
@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+#include <QtPositioning/QGeoCoordinate>
+
+#include "GeoFenceIndex.h"
+
+Q_DECLARE_LOGGING_CATEGORY(GeoFenceBreachMonitorLog)
+
+/// Checks the connected vehicles against their own geofence. The monitor lives on its own thread and only works on
+/// snapshots of the vehicle states and on the immutable fence indices of the vehicles, so nothing here touches the
+/// GUI thread. A vehicle is reported when it is outside its fence, when its current track leaves the fence within
+/// the look ahead time, or when it is close to a fence boundary.
+class GeoFenceBreachMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef enum {
+        BreachNone,
+        BreachProximity,        ///< Within _proximityMeters of a boundary
+        BreachPredicted,        ///< Current track leaves the fence within _lookAheadSecs
+        BreachActive,           ///< Outside the fence
+    } BreachState_t;
+
+    /// Vehicle as of the last update from the GUI thread
+    typedef struct {
+        int vehicleId = 0;
+        QGeoCoordinate coordinate;
+        double groundSpeed = 0;                         ///< m/s
+        double heading = 0;                             ///< degrees
+        QSharedPointer<const GeoFenceIndex> fence;
+    } VehicleState_t;
+
+    typedef struct {
+        int vehicleId = 0;
+        BreachState_t state = BreachNone;
+        double boundaryDistance = 0;                    ///< m, BreachProximity only
+        double timeToBreach = 0;                        ///< s, BreachPredicted only
+    } Breach_t;
+
+    explicit GeoFenceBreachMonitor(QObject *parent = nullptr);
+    ~GeoFenceBreachMonitor();
+
+    /// Checks a single vehicle, callable from any thread
+    static Breach_t evaluate(const VehicleState_t &vehicle);
+
+public slots:
+    /// Checks all the vehicles in the snapshot
+    void setVehicleStates(const QList<GeoFenceBreachMonitor::VehicleState_t> &vehicleStates);
+
+signals:
+    /// Emitted after each check which found breaches, and once after the last breach cleared
+    void breachesUpdated(const QList<GeoFenceBreachMonitor::Breach_t> &breaches);
+
+private:
+    bool _breachesReported = false;
+
+    static constexpr double _lookAheadSecs = 30.0;
+    static constexpr double _proximityMeters = 50.0;
+    static constexpr double _minPredictionSpeed = 0.5;     ///< m/s, slower vehicles are not extrapolated
+    static constexpr int _timeToBreachSteps = 8;            ///< Bisection steps when locating the predicted breach
+};
+
+Q_DECLARE_METATYPE(GeoFenceBreachMonitor::VehicleState_t)
+Q_DECLARE_METATYPE(GeoFenceBreachMonitor::Breach_t)
@@ -20,6 +20,7 @@
 #include "SettingsManager.h"
 #include "AppSettings.h"
 #include "GeoFenceManager.h"
+#include "GeoFenceIndex.h"
 #include "QGCFenceCircle.h"
 #include "QGCFencePolygon.h"
 #include "QGCLoggingCategory.h"
@@ -591,6 +592,44 @@ bool GeoFenceController::isEmpty(void) const
 
 }
 
+QList<int> GeoFenceController::breachingSegments(const QList<QGeoCoordinate>& path)
+{
+    if (_polygons.count() == 0 && _circles.count() == 0) {
+        return QList<int>();
+    }
+
+    QList<GeoFenceIndex::Polygon_t> polygons;
+    for (int i=0; i<_polygons.count(); i++) {
+        QGCFencePolygon* polygon = _polygons.value<QGCFencePolygon*>(i);
+        polygons.append({ polygon->coordinateList(), polygon->inclusion() });
+    }
+    QList<GeoFenceIndex::Circle_t> circles;
+    for (int i=0; i<_circles.count(); i++) {
+        QGCFenceCircle* circle = _circles.value<QGCFenceCircle*>(i);
+        circles.append({ circle->center(), circle->radius()->rawValue().toDouble(), circle->inclusion() });
+    }
+
+    // The fence is edited interactively, so the index is built per call. That is still far cheaper than
+    // testing every leg against every shape once a plan has many zones.
+    const GeoFenceIndex fenceIndex(polygons, circles, _managerVehicle->apmFirmware());
+    return fenceIndex.breachingSegments(path);
+}
+
+QVariantList GeoFenceController::breachingSegments(const QVariantList& path)
+{
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(path.count());
+    for (const QVariant& coordinate : path) {
+        coordinates.append(coordinate.value<QGeoCoordinate>());
+    }
+
+    QVariantList result;
+    for (const int segment : breachingSegments(coordinates)) {
+        result.append(segment);
+    }
+    return result;
+}
+
 #ifdef QGC_UTM_ADAPTER
 void GeoFenceController::loadFlightPlanData()
 {
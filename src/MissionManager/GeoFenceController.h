@@ -62,6 +62,12 @@ public:
     /// Clears the interactive bit from all fence items
     Q_INVOKABLE void clearAllInteractive(void);
 
+    /// Checks all legs of a path against the fence in one pass
+    ///     @param path: List of QGeoCoordinate
+    /// @return Indices of the legs (path[i] to path[i + 1]) which leave the fence
+    Q_INVOKABLE QVariantList breachingSegments(const QVariantList& path);
+    QList<int> breachingSegments(const QList<QGeoCoordinate>& path);
+
 #ifdef QGC_UTM_ADAPTER
     Q_INVOKABLE void loadFlightPlanData(void);
 #endif
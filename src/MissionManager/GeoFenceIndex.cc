@@ -0,0 +1,503 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GeoFenceIndex.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QtMath>
+
+#include <algorithm>
+#include <cmath>
+
+GeoFenceIndex::GeoFenceIndex(const QList<Polygon_t>& polygons, const QList<Circle_t>& circles, bool allInclusionsRequired)
+    : _allInclusionsRequired(allInclusionsRequired)
+{
+    // The local frame is anchored at the center of the fence
+    double minLat = 90, maxLat = -90, minLon = 180, maxLon = -180;
+    auto extend = [&](const QGeoCoordinate& coordinate) {
+        minLat = qMin(minLat, coordinate.latitude());
+        maxLat = qMax(maxLat, coordinate.latitude());
+        minLon = qMin(minLon, coordinate.longitude());
+        maxLon = qMax(maxLon, coordinate.longitude());
+    };
+    for (const Polygon_t& polygon : polygons) {
+        if (polygon.vertices.count() >= 3) {
+            for (const QGeoCoordinate& vertex : polygon.vertices) {
+                extend(vertex);
+            }
+        }
+    }
+    for (const Circle_t& circle : circles) {
+        if (circle.center.isValid() && (circle.radius > 0)) {
+            extend(circle.center);
+        }
+    }
+    if (minLat > maxLat) {
+        return;
+    }
+    _frame.setAnchor(QGeoCoordinate((minLat + maxLat) / 2.0, (minLon + maxLon) / 2.0));
+
+    QList<QPair<int, int>> shapeEdges;   // First edge and edge count of each shape
+    for (const Polygon_t& polygon : polygons) {
+        const int vertexCount = polygon.vertices.count();
+        if (vertexCount < 3) {
+            continue;
+        }
+
+        QList<QPointF> vertices;
+        vertices.reserve(vertexCount);
+        for (const QGeoCoordinate& vertex : polygon.vertices) {
+            vertices.append(_toLocal(vertex));
+        }
+
+        const int firstEdge = static_cast<int>(_edges.size());
+        double minX = vertices[0].x(), maxX = minX, minY = vertices[0].y(), maxY = minY;
+        for (int i = 0; i < vertexCount; i++) {
+            _edges.push_back({ vertices[i], vertices[(i + 1) % vertexCount] });
+            minX = qMin(minX, vertices[i].x());
+            maxX = qMax(maxX, vertices[i].x());
+            minY = qMin(minY, vertices[i].y());
+            maxY = qMax(maxY, vertices[i].y());
+        }
+
+        _shapes.push_back({ polygon.inclusion, false, QPointF(), 0, QRectF(QPointF(minX, minY), QPointF(maxX, maxY)) });
+        shapeEdges.append(qMakePair(firstEdge, vertexCount));
+    }
+    for (const Circle_t& circle : circles) {
+        if (!circle.center.isValid() || (circle.radius <= 0)) {
+            continue;
+        }
+
+        const QPointF center = _toLocal(circle.center);
+        const QRectF bounds(center.x() - circle.radius, center.y() - circle.radius, 2 * circle.radius, 2 * circle.radius);
+        _shapes.push_back({ circle.inclusion, true, center, circle.radius, bounds });
+        shapeEdges.append(qMakePair(0, 0));
+    }
+
+    QRectF gridBounds;
+    for (const Shape_t& shape : _shapes) {
+        gridBounds = gridBounds.isNull() ? shape.bounds : gridBounds.united(shape.bounds);
+        if (shape.inclusion) {
+            _inclusionCount++;
+        }
+    }
+
+    // Roughly a handful of edges per boundary cell
+    const int cellsPerSide = qBound(_minCellsPerSide, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(_edges.size() + (4 * circles.count()))) * 2)), _maxCellsPerSide);
+    _cellSize = qMax(gridBounds.width(), gridBounds.height()) / cellsPerSide;
+    if (_cellSize <= 0) {
+        _cellSize = 1;
+    }
+    _gridOrigin = gridBounds.topLeft();
+    _columns = qMax(1, static_cast<int>(std::ceil(gridBounds.width() / _cellSize)));
+    _rows = qMax(1, static_cast<int>(std::ceil(gridBounds.height() / _cellSize)));
+
+    typedef struct {
+        CellShape_t cellShape;
+        QList<int>  edges;
+    } PendingCellShape_t;
+    std::vector<QList<PendingCellShape_t>> pendingCells(static_cast<size_t>(_columns) * _rows);
+
+    for (int shapeIndex = 0; shapeIndex < static_cast<int>(_shapes.size()); shapeIndex++) {
+        const Shape_t& shape = _shapes[shapeIndex];
+        const int firstColumn = qBound(0, static_cast<int>(std::floor((shape.bounds.left() - _gridOrigin.x()) / _cellSize)), _columns - 1);
+        const int lastColumn = qBound(0, static_cast<int>(std::floor((shape.bounds.right() - _gridOrigin.x()) / _cellSize)), _columns - 1);
+        const int firstRow = qBound(0, static_cast<int>(std::floor((shape.bounds.top() - _gridOrigin.y()) / _cellSize)), _rows - 1);
+        const int lastRow = qBound(0, static_cast<int>(std::floor((shape.bounds.bottom() - _gridOrigin.y()) / _cellSize)), _rows - 1);
+
+        if (shape.circle) {
+            for (int row = firstRow; row <= lastRow; row++) {
+                for (int column = firstColumn; column <= lastColumn; column++) {
+                    const int cellIndex = (row * _columns) + column;
+                    const QPointF cellCenter = _cellCenter(cellIndex);
+                    const double dx = qAbs(cellCenter.x() - shape.center.x());
+                    const double dy = qAbs(cellCenter.y() - shape.center.y());
+                    const double half = _cellSize / 2.0;
+                    const double nearest = std::hypot(qMax(0.0, dx - half), qMax(0.0, dy - half));
+                    const double farthest = std::hypot(dx + half, dy + half);
+                    if (nearest >= shape.radius) {
+                        continue;
+                    }
+                    const bool boundary = farthest > shape.radius;
+                    pendingCells[cellIndex].append({ { shapeIndex, std::hypot(dx, dy) < shape.radius, boundary, 0, 0 }, {} });
+                }
+            }
+            continue;
+        }
+
+        const int firstEdge = shapeEdges[shapeIndex].first;
+        const int edgeCount = shapeEdges[shapeIndex].second;
+
+        QHash<int, QList<int>> edgesByCell;
+        QList<int> cells;
+        for (int edgeIndex = firstEdge; edgeIndex < firstEdge + edgeCount; edgeIndex++) {
+            cells.clear();
+            _cellsOnSegment(_edges[edgeIndex].start, _edges[edgeIndex].end, cells);
+            for (const int cellIndex : cells) {
+                edgesByCell[cellIndex].append(edgeIndex);
+            }
+        }
+
+        // Inside flags of the cell centers, one scan line per row
+        QList<double> crossings;
+        for (int row = firstRow; row <= lastRow; row++) {
+            const double y = _gridOrigin.y() + ((row + 0.5) * _cellSize);
+            crossings.clear();
+            for (int edgeIndex = firstEdge; edgeIndex < firstEdge + edgeCount; edgeIndex++) {
+                const Edge_t& edge = _edges[edgeIndex];
+                if ((edge.start.y() > y) != (edge.end.y() > y)) {
+                    crossings.append(edge.start.x() + ((y - edge.start.y()) * (edge.end.x() - edge.start.x()) / (edge.end.y() - edge.start.y())));
+                }
+            }
+            std::sort(crossings.begin(), crossings.end());
+
+            for (int column = firstColumn; column <= lastColumn; column++) {
+                const int cellIndex = (row * _columns) + column;
+                const double x = _gridOrigin.x() + ((column + 0.5) * _cellSize);
+                const bool centerInside = ((crossings.cend() - std::upper_bound(crossings.cbegin(), crossings.cend(), x)) % 2) == 1;
+                const auto cellEdges = edgesByCell.constFind(cellIndex);
+                const bool boundary = cellEdges != edgesByCell.constEnd();
+                if (centerInside || boundary) {
+                    pendingCells[cellIndex].append({ { shapeIndex, centerInside, boundary, 0, 0 }, boundary ? cellEdges.value() : QList<int>() });
+                }
+            }
+        }
+    }
+
+    _cellStart.reserve(pendingCells.size() + 1);
+    for (const QList<PendingCellShape_t>& pendingCell : pendingCells) {
+        _cellStart.push_back(static_cast<int>(_cellShapes.size()));
+        for (const PendingCellShape_t& pending : pendingCell) {
+            CellShape_t cellShape = pending.cellShape;
+            cellShape.firstEdge = static_cast<int>(_cellEdges.size());
+            cellShape.edgeCount = pending.edges.count();
+            _cellEdges.insert(_cellEdges.end(), pending.edges.cbegin(), pending.edges.cend());
+            _cellShapes.push_back(cellShape);
+        }
+    }
+    _cellStart.push_back(static_cast<int>(_cellShapes.size()));
+}
+
+bool GeoFenceIndex::breached(const QGeoCoordinate& coordinate) const
+{
+    if (isEmpty()) {
+        return false;
+    }
+
+    std::vector<char> inside;
+    _shapesContaining(_toLocal(coordinate), inside);
+    return _breached(inside);
+}
+
+double GeoFenceIndex::boundaryDistance(const QGeoCoordinate& coordinate, double maxDistance) const
+{
+    if (isEmpty()) {
+        return maxDistance;
+    }
+
+    const QPointF point = _toLocal(coordinate);
+    const int firstColumn = qMax(0, static_cast<int>(std::floor((point.x() - maxDistance - _gridOrigin.x()) / _cellSize)));
+    const int lastColumn = qMin(_columns - 1, static_cast<int>(std::floor((point.x() + maxDistance - _gridOrigin.x()) / _cellSize)));
+    const int firstRow = qMax(0, static_cast<int>(std::floor((point.y() - maxDistance - _gridOrigin.y()) / _cellSize)));
+    const int lastRow = qMin(_rows - 1, static_cast<int>(std::floor((point.y() + maxDistance - _gridOrigin.y()) / _cellSize)));
+
+    double distance = maxDistance;
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            const int cellIndex = (row * _columns) + column;
+            for (int i = _cellStart[cellIndex]; i < _cellStart[cellIndex + 1]; i++) {
+                const CellShape_t& cellShape = _cellShapes[i];
+                if (!cellShape.boundary) {
+                    continue;
+                }
+                const Shape_t& shape = _shapes[cellShape.shape];
+                if (shape.circle) {
+                    distance = qMin(distance, qAbs(std::hypot(point.x() - shape.center.x(), point.y() - shape.center.y()) - shape.radius));
+                    continue;
+                }
+                for (int j = cellShape.firstEdge; j < cellShape.firstEdge + cellShape.edgeCount; j++) {
+                    const Edge_t& edge = _edges[_cellEdges[j]];
+                    distance = qMin(distance, _pointSegmentDistance(point, edge.start, edge.end));
+                }
+            }
+        }
+    }
+
+    return distance;
+}
+
+bool GeoFenceIndex::segmentInside(const QGeoCoordinate& start, const QGeoCoordinate& end) const
+{
+    if (isEmpty()) {
+        return true;
+    }
+
+    const QPointF localStart = _toLocal(start);
+    const QPointF localEnd = _toLocal(end);
+
+    std::vector<char> startInside;
+    std::vector<char> endInside;
+    _shapesContaining(localStart, startInside);
+    _shapesContaining(localEnd, endInside);
+    if (_breached(startInside) || _breached(endInside)) {
+        return false;
+    }
+
+    std::vector<char> crossed;
+    return _segmentClear(localStart, localEnd, startInside, endInside, crossed);
+}
+
+QList<int> GeoFenceIndex::breachingSegments(const QList<QGeoCoordinate>& path) const
+{
+    QList<int> segments;
+    if (isEmpty() || (path.count() < 2)) {
+        return segments;
+    }
+
+    QList<QPointF> points;
+    std::vector<std::vector<char>> inside(path.count());
+    std::vector<char> vertexBreached(path.count());
+    points.reserve(path.count());
+    for (int i = 0; i < path.count(); i++) {
+        points.append(_toLocal(path[i]));
+        _shapesContaining(points[i], inside[i]);
+        vertexBreached[i] = _breached(inside[i]);
+    }
+
+    std::vector<char> crossed;
+    for (int i = 0; i < path.count() - 1; i++) {
+        if (vertexBreached[i] || vertexBreached[i + 1] || !_segmentClear(points[i], points[i + 1], inside[i], inside[i + 1], crossed)) {
+            segments.append(i);
+        }
+    }
+
+    return segments;
+}
+
+QPointF GeoFenceIndex::_toLocal(const QGeoCoordinate& coordinate) const
+{
+    double north, east;
+    _frame.toLocal(coordinate, north, east);
+    return QPointF(east, north);
+}
+
+int GeoFenceIndex::_cellIndex(const QPointF& point) const
+{
+    const double column = (point.x() - _gridOrigin.x()) / _cellSize;
+    const double row = (point.y() - _gridOrigin.y()) / _cellSize;
+    if ((column < 0) || (row < 0) || (column > _columns) || (row > _rows)) {
+        return -1;
+    }
+
+    // Points on the far edges of the grid belong to the last cells
+    return (qMin(static_cast<int>(row), _rows - 1) * _columns) + qMin(static_cast<int>(column), _columns - 1);
+}
+
+QPointF GeoFenceIndex::_cellCenter(int cellIndex) const
+{
+    const int row = cellIndex / _columns;
+    const int column = cellIndex % _columns;
+    return QPointF(_gridOrigin.x() + ((column + 0.5) * _cellSize), _gridOrigin.y() + ((row + 0.5) * _cellSize));
+}
+
+bool GeoFenceIndex::_insideShape(const CellShape_t& cellShape, int cellIndex, const QPointF& point) const
+{
+    if (!cellShape.boundary) {
+        return cellShape.centerInside;
+    }
+
+    const Shape_t& shape = _shapes[cellShape.shape];
+    if (shape.circle) {
+        return std::hypot(point.x() - shape.center.x(), point.y() - shape.center.y()) < shape.radius;
+    }
+
+    // Count the crossings on the way to the cell center, first along x then along y. Both legs stay in the cell so
+    // only the edges of the cell can cross them. Half open comparisons keep vertices from being counted twice.
+    const QPointF center = _cellCenter(cellIndex);
+    const double minX = qMin(point.x(), center.x());
+    const double maxX = qMax(point.x(), center.x());
+    const double minY = qMin(point.y(), center.y());
+    const double maxY = qMax(point.y(), center.y());
+
+    bool inside = cellShape.centerInside;
+    for (int i = cellShape.firstEdge; i < cellShape.firstEdge + cellShape.edgeCount; i++) {
+        const Edge_t& edge = _edges[_cellEdges[i]];
+        if ((edge.start.y() > point.y()) != (edge.end.y() > point.y())) {
+            const double x = edge.start.x() + ((point.y() - edge.start.y()) * (edge.end.x() - edge.start.x()) / (edge.end.y() - edge.start.y()));
+            if ((x >= minX) && (x < maxX)) {
+                inside = !inside;
+            }
+        }
+        if ((edge.start.x() > center.x()) != (edge.end.x() > center.x())) {
+            const double y = edge.start.y() + ((center.x() - edge.start.x()) * (edge.end.y() - edge.start.y()) / (edge.end.x() - edge.start.x()));
+            if ((y >= minY) && (y < maxY)) {
+                inside = !inside;
+            }
+        }
+    }
+
+    return inside;
+}
+
+void GeoFenceIndex::_shapesContaining(const QPointF& point, std::vector<char>& inside) const
+{
+    inside.assign(_shapes.size(), 0);
+
+    const int cellIndex = _cellIndex(point);
+    if (cellIndex < 0) {
+        return;
+    }
+
+    for (int i = _cellStart[cellIndex]; i < _cellStart[cellIndex + 1]; i++) {
+        const CellShape_t& cellShape = _cellShapes[i];
+        inside[cellShape.shape] = _insideShape(cellShape, cellIndex, point);
+    }
+}
+
+bool GeoFenceIndex::_breached(const std::vector<char>& inside) const
+{
+    int inclusions = 0;
+    for (size_t i = 0; i < _shapes.size(); i++) {
+        if (inside[i]) {
+            if (!_shapes[i].inclusion) {
+                return true;
+            }
+            inclusions++;
+        }
+    }
+
+    if (_inclusionCount == 0) {
+        return false;
+    }
+    return _allInclusionsRequired ? (inclusions < _inclusionCount) : (inclusions == 0);
+}
+
+/// Both ends of the segment are known to be within the fence
+bool GeoFenceIndex::_segmentClear(const QPointF& start, const QPointF& end, const std::vector<char>& startInside, const std::vector<char>& endInside, std::vector<char>& crossed) const
+{
+    crossed.assign(_shapes.size(), 0);
+
+    QList<int> cells;
+    _cellsOnSegment(start, end, cells);
+    for (const int cellIndex : cells) {
+        for (int i = _cellStart[cellIndex]; i < _cellStart[cellIndex + 1]; i++) {
+            const CellShape_t& cellShape = _cellShapes[i];
+            if (!cellShape.boundary || crossed[cellShape.shape]) {
+                continue;
+            }
+
+            const Shape_t& shape = _shapes[cellShape.shape];
+            if (shape.circle) {
+                // Circles are convex, a segment can only clip an exclusion circle
+                if (!shape.inclusion && (_pointSegmentDistance(shape.center, start, end) < shape.radius)) {
+                    crossed[cellShape.shape] = 1;
+                }
+                continue;
+            }
+
+            for (int j = cellShape.firstEdge; j < cellShape.firstEdge + cellShape.edgeCount; j++) {
+                const Edge_t& edge = _edges[_cellEdges[j]];
+                if (_segmentsIntersect(start, end, edge.start, edge.end)) {
+                    crossed[cellShape.shape] = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    bool inclusionClear = _allInclusionsRequired || (_inclusionCount == 0);
+    for (size_t i = 0; i < _shapes.size(); i++) {
+        if (!_shapes[i].inclusion) {
+            if (crossed[i]) {
+                return false;
+            }
+        } else if (_allInclusionsRequired) {
+            if (crossed[i]) {
+                return false;
+            }
+        } else if (startInside[i] && endInside[i] && !crossed[i]) {
+            inclusionClear = true;
+        }
+    }
+
+    return inclusionClear;
+}
+
+/// Every cell the segment touches, row by row
+void GeoFenceIndex::_cellsOnSegment(const QPointF& start, const QPointF& end, QList<int>& cells) const
+{
+    const double startColumn = (start.x() - _gridOrigin.x()) / _cellSize;
+    const double endColumn = (end.x() - _gridOrigin.x()) / _cellSize;
+    const double startRow = (start.y() - _gridOrigin.y()) / _cellSize;
+    const double endRow = (end.y() - _gridOrigin.y()) / _cellSize;
+
+    const int firstRow = qMax(0, static_cast<int>(std::floor(qMin(startRow, endRow))));
+    const int lastRow = qMin(_rows - 1, static_cast<int>(std::floor(qMax(startRow, endRow))));
+    for (int row = firstRow; row <= lastRow; row++) {
+        // Part of the segment within this row
+        double t0 = 0;
+        double t1 = 1;
+        if (endRow != startRow) {
+            t0 = (row - startRow) / (endRow - startRow);
+            t1 = (row + 1 - startRow) / (endRow - startRow);
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            t0 = qMax(0.0, t0);
+            t1 = qMin(1.0, t1);
+        }
+        const double column0 = startColumn + (t0 * (endColumn - startColumn));
+        const double column1 = startColumn + (t1 * (endColumn - startColumn));
+
+        const int firstColumn = qMax(0, static_cast<int>(std::floor(qMin(column0, column1))));
+        const int lastColumn = qMin(_columns - 1, static_cast<int>(std::floor(qMax(column0, column1))));
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            cells.append((row * _columns) + column);
+        }
+    }
+}
+
+/// Touching counts as intersecting
+bool GeoFenceIndex::_segmentsIntersect(const QPointF& a1, const QPointF& a2, const QPointF& b1, const QPointF& b2)
+{
+    auto cross = [](const QPointF& o, const QPointF& a, const QPointF& b) {
+        return ((a.x() - o.x()) * (b.y() - o.y())) - ((a.y() - o.y()) * (b.x() - o.x()));
+    };
+    auto onSegment = [](const QPointF& p, const QPointF& a, const QPointF& b) {
+        return (p.x() >= qMin(a.x(), b.x())) && (p.x() <= qMax(a.x(), b.x())) && (p.y() >= qMin(a.y(), b.y())) && (p.y() <= qMax(a.y(), b.y()));
+    };
+
+    const double d1 = cross(b1, b2, a1);
+    const double d2 = cross(b1, b2, a2);
+    const double d3 = cross(a1, a2, b1);
+    const double d4 = cross(a1, a2, b2);
+
+    if ((((d1 > 0) && (d2 < 0)) || ((d1 < 0) && (d2 > 0))) && (((d3 > 0) && (d4 < 0)) || ((d3 < 0) && (d4 > 0)))) {
+        return true;
+    }
+
+    return ((d1 == 0) && onSegment(a1, b1, b2)) ||
+           ((d2 == 0) && onSegment(a2, b1, b2)) ||
+           ((d3 == 0) && onSegment(b1, a1, a2)) ||
+           ((d4 == 0) && onSegment(b2, a1, a2));
+}
+
+double GeoFenceIndex::_pointSegmentDistance(const QPointF& point, const QPointF& start, const QPointF& end)
+{
+    const double dx = end.x() - start.x();
+    const double dy = end.y() - start.y();
+    const double lengthSquared = (dx * dx) + (dy * dy);
+
+    double t = 0;
+    if (lengthSquared > 0) {
+        t = qBound(0.0, (((point.x() - start.x()) * dx) + ((point.y() - start.y()) * dy)) / lengthSquared, 1.0);
+    }
+
+    return std::hypot(point.x() - (start.x() + (t * dx)), point.y() - (start.y() + (t * dy)));
+}
@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+#include <QtCore/QRectF>
+#include <QtPositioning/QGeoCoordinate>
+
+#include <vector>
+
+#include "QGCGeo.h"
+
+/// Spatial index over the inclusion and exclusion shapes of a geofence, for breach checks against fences with many
+/// zones. The shapes are projected once into a flat local frame and bucketed into a uniform grid. Each grid cell
+/// records for each shape reaching into it whether the cell center is inside the shape, and the polygon edges which
+/// cross the cell. Cells no edge crosses are decided by that flag alone. Elsewhere only the edges of the cell are
+/// tested, by counting crossings between the point and the cell center.
+///
+/// The index is immutable once built, so it can be shared with other threads.
+class GeoFenceIndex
+{
+public:
+    typedef struct {
+        QList<QGeoCoordinate>   vertices;
+        bool                    inclusion = true;
+    } Polygon_t;
+
+    typedef struct {
+        QGeoCoordinate          center;
+        double                  radius = 0;
+        bool                    inclusion = true;
+    } Circle_t;
+
+    GeoFenceIndex() = default;
+
+    /// @param allInclusionsRequired true: a position has to be inside every inclusion shape (ArduPilot),
+    ///                              false: inside any of them (PX4)
+    GeoFenceIndex(const QList<Polygon_t>& polygons, const QList<Circle_t>& circles, bool allInclusionsRequired);
+
+    bool isEmpty(void) const { return _shapes.empty(); }
+
+    /// @return true: coordinate is inside an exclusion shape or not inside the inclusion shapes
+    bool breached(const QGeoCoordinate& coordinate) const;
+
+    /// @return Distance in meters from coordinate to the closest shape boundary, maxDistance if no boundary is closer
+    double boundaryDistance(const QGeoCoordinate& coordinate, double maxDistance) const;
+
+    /// @return true: the straight line from start to end stays within the fence. Where overlapping inclusion shapes
+    ///               are allowed (PX4) a line has to stay within a single one of them.
+    bool segmentInside(const QGeoCoordinate& start, const QGeoCoordinate& end) const;
+
+    /// Checks all legs of a path at once, each vertex is only classified once
+    /// @return Indices of the legs (path[i] to path[i + 1]) which leave the fence
+    QList<int> breachingSegments(const QList<QGeoCoordinate>& path) const;
+
+private:
+    typedef struct {
+        bool    inclusion;
+        bool    circle;
+        QPointF center;         ///< Circles only
+        double  radius;         ///< Circles only
+        QRectF  bounds;
+    } Shape_t;
+
+    typedef struct {
+        QPointF start;
+        QPointF end;
+    } Edge_t;
+
+    typedef struct {
+        int     shape;
+        bool    centerInside;   ///< Cell center is inside the shape
+        bool    boundary;       ///< Shape boundary crosses the cell
+        int     firstEdge;      ///< Into _cellEdges, polygons only
+        int     edgeCount;
+    } CellShape_t;
+
+    QPointF _toLocal            (const QGeoCoordinate& coordinate) const;
+    int     _cellIndex          (const QPointF& point) const;
+    QPointF _cellCenter         (int cellIndex) const;
+    bool    _insideShape        (const CellShape_t& cellShape, int cellIndex, const QPointF& point) const;
+    void    _shapesContaining   (const QPointF& point, std::vector<char>& inside) const;
+    bool    _breached           (const std::vector<char>& inside) const;
+    bool    _segmentClear       (const QPointF& start, const QPointF& end, const std::vector<char>& startInside, const std::vector<char>& endInside, std::vector<char>& crossed) const;
+    void    _cellsOnSegment     (const QPointF& start, const QPointF& end, QList<int>& cells) const;
+
+    static bool     _segmentsIntersect  (const QPointF& a1, const QPointF& a2, const QPointF& b1, const QPointF& b2);
+    static double   _pointSegmentDistance(const QPointF& point, const QPointF& start, const QPointF& end);
+
+    QGCGeo::LocalFrame          _frame;
+    bool                        _allInclusionsRequired = false;
+    int                         _inclusionCount = 0;
+    std::vector<Shape_t>        _shapes;
+    std::vector<Edge_t>         _edges;
+
+    // Uniform grid, cells are stored row by row. The shapes of cell i are _cellShapes[_cellStart[i].._cellStart[i + 1]).
+    QPointF                     _gridOrigin;
+    double                      _cellSize = 1;
+    int                         _columns = 0;
+    int                         _rows = 0;
+    std::vector<int>            _cellStart;
+    std::vector<CellShape_t>    _cellShapes;
+    std::vector<int>            _cellEdges;
+
+    static constexpr int _minCellsPerSide = 8;
+    static constexpr int _maxCellsPerSide = 256;
+};
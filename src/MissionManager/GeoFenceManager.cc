@@ -107,6 +107,7 @@ void GeoFenceManager::removeAll(void)
     _polygons.clear();
     _circles.clear();
     _breachReturnPoint = QGeoCoordinate();
+    _updateFenceIndex();
 
     PlanManager::removeAll();
 }
@@ -123,6 +124,7 @@ void GeoFenceManager::_sendComplete(bool error)
     }
     _sendPolygons.clear();
     _sendCircles.clear();
+    _updateFenceIndex();
     emit sendComplete(error);
 }
 
@@ -188,9 +190,30 @@ void GeoFenceManager::_planManagerLoadComplete(bool removeAllRequested)
         _breachReturnPoint = QGeoCoordinate();
     }
 
+    _updateFenceIndex();
     emit loadComplete();
 }
 
+void GeoFenceManager::_updateFenceIndex(void)
+{
+    if (_polygons.isEmpty() && _circles.isEmpty()) {
+        _fenceIndex.reset();
+        return;
+    }
+
+    QList<GeoFenceIndex::Polygon_t> polygons;
+    for (const QGCFencePolygon& polygon : _polygons) {
+        polygons.append({ polygon.coordinateList(), polygon.inclusion() });
+    }
+    QList<GeoFenceIndex::Circle_t> circles;
+    for (QGCFenceCircle& circle : _circles) {
+        circles.append({ circle.center(), circle.radius()->rawValue().toDouble(), circle.inclusion() });
+    }
+
+    // ArduPilot requires the vehicle to be inside every inclusion fence, PX4 inside any of them
+    _fenceIndex = QSharedPointer<const GeoFenceIndex>::create(polygons, circles, _vehicle->apmFirmware());
+}
+
 bool GeoFenceManager::supported(void) const
 {
     return (_vehicle->capabilityBits() & MAV_PROTOCOL_CAPABILITY_MISSION_FENCE) && (_vehicle->maxProtoVersion() >= 200);
@@ -10,12 +10,14 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtCore/QLoggingCategory>
 
 #include "QGCFencePolygon.h"
 #include "QGCFenceCircle.h"
 #include "PlanManager.h"
+#include "GeoFenceIndex.h"
 
 class Vehicle;
 class QmlObjectListModel;
@@ -50,6 +52,10 @@ public:
     const QList<QGCFenceCircle>&    circles(void) { return _circles; }
     const QGeoCoordinate&           breachReturnPoint(void) const { return _breachReturnPoint; }
 
+    /// Index over the fence currently on the vehicle, nullptr if there is none. Rebuilt when the fence changes,
+    /// the index itself never changes so it can be handed to other threads.
+    QSharedPointer<const GeoFenceIndex> fenceIndex(void) const { return _fenceIndex; }
+
     /// Error codes returned in error signal
     typedef enum {
         InternalError,
@@ -74,6 +80,7 @@ private slots:
 
 private:
     void _sendError(ErrorCode_t errorCode, const QString& errorMsg);
+    void _updateFenceIndex(void);
 
     QList<QGCFencePolygon>  _polygons;
     QList<QGCFenceCircle>   _circles;
@@ -81,4 +88,6 @@ private:
     bool                    _firstParamLoadComplete = false;
     QList<QGCFencePolygon>  _sendPolygons;
     QList<QGCFenceCircle>   _sendCircles;
+
+    QSharedPointer<const GeoFenceIndex> _fenceIndex;
 };
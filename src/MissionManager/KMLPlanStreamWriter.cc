@@ -0,0 +1,149 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "KMLPlanStreamWriter.h"
+#include "QGCPalette.h"
+#include "QGCApplication.h"
+#include "MissionCommandTree.h"
+#include "MissionCommandUIInfo.h"
+#include "MissionItem.h"
+#include "FactMetaData.h"
+#include "ComplexMissionItem.h"
+#include "Vehicle.h"
+#include "QmlObjectListModel.h"
+
+KMLPlanStreamWriter::KMLPlanStreamWriter(QIODevice* device)
+    : KMLStreamWriter(device, QStringLiteral("%1 Plan KML").arg(QCoreApplication::applicationName()))
+{
+    _writeStyles();
+}
+
+void KMLPlanStreamWriter::_writeFlightPath(Vehicle* vehicle, QList<MissionItem*> rgMissionItems)
+{
+    if (rgMissionItems.count() == 0) {
+        return;
+    }
+
+    writeStartElement("Folder");
+    writeTextElement("name", "Items");
+
+    // The item placemarks are written as the trajectory line coords are built up, the line follows the folder
+    QList<QGeoCoordinate> rgFlightCoords;
+    QGeoCoordinate homeCoord = rgMissionItems[0]->coordinate();
+    for (const MissionItem* item : rgMissionItems) {
+        const MissionCommandUIInfo* uiInfo = qgcApp()->toolbox()->missionCommandTree()->getUIInfo(vehicle, QGCMAVLink::VehicleClassGeneric, item->command());
+        if (uiInfo) {
+            double altAdjustment = item->frame() == MAV_FRAME_GLOBAL ? 0 : homeCoord.altitude(); // Used to convert to amsl
+            if (uiInfo->isTakeoffCommand() && !vehicle->fixedWing()) {
+                // These takeoff items go straight up from home position to specified altitude
+                QGeoCoordinate coord = homeCoord;
+                coord.setAltitude(item->param7() + altAdjustment);
+                rgFlightCoords += coord;
+            }
+            if (uiInfo->specifiesCoordinate()) {
+                QGeoCoordinate coord = item->coordinate();
+                coord.setAltitude(coord.altitude() + altAdjustment); // convert to amsl
+
+                if (!uiInfo->isStandaloneCoordinate()) {
+                    // Flight path goes through this item
+                    rgFlightCoords += coord;
+                }
+
+                // Add a place mark for each WP
+
+                writeStartElement("Placemark");
+                writeTextElement("name",     QStringLiteral("%1 %2").arg(QString::number(item->sequenceNumber())).arg(item->command() == MAV_CMD_NAV_WAYPOINT ? "" : uiInfo->friendlyName()));
+                writeTextElement("styleUrl", QStringLiteral("#%1").arg(balloonStyleName));
+
+                QString htmlString;
+                htmlString += QStringLiteral("Index: %1\n").arg(item->sequenceNumber());
+                htmlString += uiInfo->friendlyName() + "\n";
+                htmlString += QStringLiteral("Alt AMSL: %1 %2\n").arg(QString::number(FactMetaData::metersToAppSettingsVerticalDistanceUnits(coord.altitude()).toDouble(), 'f', 2)).arg(FactMetaData::appSettingsVerticalDistanceUnitsString());
+                htmlString += QStringLiteral("Alt Rel: %1 %2\n").arg(QString::number(FactMetaData::metersToAppSettingsVerticalDistanceUnits(coord.altitude() - homeCoord.altitude()).toDouble(), 'f', 2)).arg(FactMetaData::appSettingsVerticalDistanceUnitsString());
+                htmlString += QStringLiteral("Lat: %1\n").arg(QString::number(coord.latitude(), 'f', 7));
+                htmlString += QStringLiteral("Lon: %1\n").arg(QString::number(coord.longitude(), 'f', 7));
+                writeStartElement("description");
+                writeCDATA(htmlString);
+                writeEndElement();
+
+                writeStartElement("Point");
+                writeTextElement("altitudeMode", "absolute");
+                writeTextElement("coordinates",  kmlCoordString(coord));
+                writeTextElement("extrude",      "1");
+                writeEndElement();
+
+                writeEndElement();
+            }
+        }
+    }
+
+    writeEndElement();
+
+    writeStartElement("Placemark");
+    writeTextElement("styleUrl",     QStringLiteral("#%1").arg(_missionLineStyleName));
+    writeTextElement("name",         "Flight Path");
+    writeTextElement("visibility",   "1");
+    writeLookAt(rgMissionItems[0]->coordinate());
+
+    // Create a LineString element from the coords
+
+    writeStartElement("LineString");
+    writeTextElement("extruder",      "1");
+    writeTextElement("tessellate",    "1");
+    writeTextElement("altitudeMode",  "absolute");
+
+    writeStartElement("coordinates");
+    for (const QGeoCoordinate& coord : rgFlightCoords) {
+        writeCharacters(QStringLiteral("%1\n").arg(kmlCoordString(coord)));
+    }
+    writeEndElement();
+
+    writeEndElement();
+    writeEndElement();
+}
+
+void KMLPlanStreamWriter::_writeComplexItems(QmlObjectListModel* visualItems)
+{
+    for (int i=0; i<visualItems->count(); i++) {
+        ComplexMissionItem* complexItem = visualItems->value<ComplexMissionItem*>(i);
+        if (complexItem) {
+            complexItem->addKMLVisuals(*this);
+        }
+    }
+}
+
+void KMLPlanStreamWriter::writeMission(Vehicle* vehicle, QmlObjectListModel* visualItems, QList<MissionItem*> rgMissionItems)
+{
+    _writeFlightPath(vehicle, rgMissionItems);
+    _writeComplexItems(visualItems);
+}
+
+void KMLPlanStreamWriter::_writeStyles(void)
+{
+    QGCPalette palette;
+
+    writeStartElement("Style");
+    writeAttribute("id", _missionLineStyleName);
+    writeStartElement("LineStyle");
+    writeTextElement("color", kmlColorString(palette.mapMissionTrajectory()));
+    writeTextElement("width", "4");
+    writeEndElement();
+    writeEndElement();
+
+    QString kmlSurveyColorString = kmlColorString(palette.surveyPolygonInterior(), 0.5 /* opacity */);
+    writeStartElement("Style");
+    writeAttribute("id", surveyPolygonStyleName);
+    writeStartElement("PolyStyle");
+    writeTextElement("color", kmlSurveyColorString);
+    writeEndElement();
+    writeStartElement("LineStyle");
+    writeTextElement("color", kmlSurveyColorString);
+    writeEndElement();
+    writeEndElement();
+}
@@ -9,27 +9,27 @@
 
 #pragma once
 
-#include "KMLDomDocument.h"
+#include "KMLStreamWriter.h"
 
 class MissionItem;
 class Vehicle;
 class QmlObjectListModel;
 
-/// Used to convert a Plan to a KML document
-class KMLPlanDomDocument : public KMLDomDocument
+/// Used to write a Plan as a KML document
+class KMLPlanStreamWriter : public KMLStreamWriter
 {
 
 public:
-    KMLPlanDomDocument();
+    KMLPlanStreamWriter(QIODevice* device);
 
-    void addMission(Vehicle* vehicle, QmlObjectListModel* visualItems, QList<MissionItem*> rgMissionItems);
+    void writeMission(Vehicle* vehicle, QmlObjectListModel* visualItems, QList<MissionItem*> rgMissionItems);
 
     static constexpr const char* surveyPolygonStyleName =   "SurveyPolygonStyle";
 
 private:
-    void _addStyles         (void);
-    void _addFlightPath     (Vehicle* vehicle, QList<MissionItem*> rgMissionItems);
-    void _addComplexItems   (QmlObjectListModel* visualItems);
+    void _writeStyles       (void);
+    void _writeFlightPath   (Vehicle* vehicle, QList<MissionItem*> rgMissionItems);
+    void _writeComplexItems (QmlObjectListModel* visualItems);
 
     static constexpr const char* _missionLineStyleName =     "MissionLineStyle";
 };
@@ -441,9 +441,7 @@ bool LandingComplexItem::_scanForItem(QmlObjectListModel* visualItems, bool flyV
         deleteCount += CameraSection::stopTakingVideoCommandCount();
     }
     int firstItem = visualItems->count() - deleteCount;
-    while (deleteCount--) {
-        visualItems->removeAt(firstItem)->deleteLater();
-    }
+    QmlObjectListModel::deleteLaterBatch(visualItems->removeRange(firstItem, deleteCount));
 
     // Now stuff all the scanned information into the item
 
@@ -25,7 +25,7 @@
 #include "AppSettings.h"
 #include "MissionSettingsItem.h"
 #include "PlanMasterController.h"
-#include "KMLPlanDomDocument.h"
+#include "KMLPlanStreamWriter.h"
 #include "QGCCorePlugin.h"
 #include "TakeoffMissionItem.h"
 #include "PlanViewSettings.h"
@@ -33,6 +33,7 @@
 #include "QGC.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 
@@ -52,8 +53,11 @@ MissionController::MissionController(PlanMasterController* masterController, QOb
     _resetMissionFlightStatus();
 
     _updateTimer.setSingleShot(true);
+    _jsonLoadTimer.setSingleShot(true);
+    _jsonLoadTimer.setInterval(0);
 
     connect(&_updateTimer,                                  &QTimer::timeout,                           this, &MissionController::_updateTimeout);
+    connect(&_jsonLoadTimer,                                &QTimer::timeout,                           this, &MissionController::_loadNextJsonItems);
     connect(_planViewSettings->takeoffItemNotRequired(),    &Fact::rawValueChanged,                     this, &MissionController::_takeoffItemNotRequiredChanged);
     connect(this,                                           &MissionController::missionDistanceChanged, this, &MissionController::recalcTerrainProfile);
 
@@ -263,13 +267,13 @@ bool MissionController::_convertToMissionItems(QmlObjectListModel* visualMission
     return endActionSet;
 }
 
-void MissionController::addMissionToKML(KMLPlanDomDocument& planKML)
+void MissionController::addMissionToKML(KMLPlanStreamWriter& planKML)
 {
     QObject*            deleteParent = new QObject();
     QList<MissionItem*> rgMissionItems;
 
     _convertToMissionItems(_visualItems, rgMissionItems, deleteParent);
-    planKML.addMission(_controllerVehicle, _visualItems, rgMissionItems);
+    planKML.writeMission(_controllerVehicle, _visualItems, rgMissionItems);
     deleteParent->deleteLater();
 }
 
@@ -706,6 +710,25 @@ bool MissionController::_loadJsonMissionFileV1(const QJsonObject& json, QmlObjec
 }
 
 bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString)
+{
+    JsonLoadState_t loadState;
+    loadState.visualItems = visualItems;
+
+    if (!_loadJsonMissionFileV2Start(json, loadState, errorString)) {
+        return false;
+    }
+    while (loadState.nextItemIndex < loadState.rgMissionItems.count()) {
+        if (!_loadJsonMissionItem(loadState, errorString)) {
+            return false;
+        }
+    }
+
+    return _fixupDoJumpSequenceNumbers(visualItems, errorString);
+}
+
+/// Validates the mission object and loads everything but the items. The items are then loaded one by one through
+/// _loadJsonMissionItem.
+bool MissionController::_loadJsonMissionFileV2Start(const QJsonObject& json, JsonLoadState_t& loadState, QString& errorString)
 {
     // Validate root object keys
     QList<JsonHelper::KeyValidateInfo> rootKeyInfoList = {
@@ -761,113 +784,126 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
     if (!JsonHelper::loadGeoCoordinate(json[_jsonPlannedHomePositionKey], true /* altitudeRequired */, homeCoordinate, errorString)) {
         return false;
     }
-    MissionSettingsItem* settingsItem = new MissionSettingsItem(_masterController, _flyView);
-    settingsItem->setCoordinate(homeCoordinate);
-    visualItems->insert(0, settingsItem);
+    loadState.settingsItem = new MissionSettingsItem(_masterController, _flyView);
+    loadState.settingsItem->setCoordinate(homeCoordinate);
+    loadState.visualItems->insert(0, loadState.settingsItem);
     qCDebug(MissionControllerLog) << "plannedHomePosition" << homeCoordinate;
 
-    // Read mission items
+    loadState.rgMissionItems = json[_jsonItemsKey].toArray();
+    loadState.nextItemIndex = 0;
+    loadState.nextSequenceNumber = 1; // Start with 1 since home is in 0
 
-    int nextSequenceNumber = 1; // Start with 1 since home is in 0
-    const QJsonArray rgMissionItems(json[_jsonItemsKey].toArray());
-    for (int i=0; i<rgMissionItems.count(); i++) {
-        // Convert to QJsonObject
-        const QJsonValue& itemValue = rgMissionItems[i];
-        if (!itemValue.isObject()) {
-            errorString = tr("Mission item %1 is not an object").arg(i);
-            return false;
-        }
-        const QJsonObject itemObject = itemValue.toObject();
+    return true;
+}
 
-        // Load item based on type
+bool MissionController::_loadJsonMissionItem(JsonLoadState_t& loadState, QString& errorString)
+{
+    QmlObjectListModel* visualItems = loadState.visualItems;
+    MissionSettingsItem* settingsItem = loadState.settingsItem;
+    int& nextSequenceNumber = loadState.nextSequenceNumber;
+    const int i = loadState.nextItemIndex++;
 
-        QList<JsonHelper::KeyValidateInfo> itemKeyInfoList = {
-            { VisualMissionItem::jsonTypeKey,  QJsonValue::String, true },
+    // Convert to QJsonObject
+    const QJsonValue itemValue = loadState.rgMissionItems[i];
+    if (!itemValue.isObject()) {
+        errorString = tr("Mission item %1 is not an object").arg(i);
+        return false;
+    }
+    const QJsonObject itemObject = itemValue.toObject();
+
+    // Load item based on type
+
+    QList<JsonHelper::KeyValidateInfo> itemKeyInfoList = {
+        { VisualMissionItem::jsonTypeKey,  QJsonValue::String, true },
+    };
+    if (!JsonHelper::validateKeys(itemObject, itemKeyInfoList, errorString)) {
+        return false;
+    }
+    QString itemType = itemObject[VisualMissionItem::jsonTypeKey].toString();
+
+    if (itemType == VisualMissionItem::jsonTypeSimpleItemValue) {
+        SimpleMissionItem* simpleItem = new SimpleMissionItem(_masterController, _flyView, true /* forLoad */);
+        if (simpleItem->load(itemObject, nextSequenceNumber, errorString)) {
+            if (TakeoffMissionItem::isTakeoffCommand(static_cast<MAV_CMD>(simpleItem->command()))) {
+                // This needs to be a TakeoffMissionItem
+                TakeoffMissionItem* takeoffItem = new TakeoffMissionItem(_masterController, _flyView, settingsItem, true /* forLoad */);
+                takeoffItem->load(itemObject, nextSequenceNumber, errorString);
+                simpleItem->deleteLater();
+                simpleItem = takeoffItem;
+            }
+            qCDebug(MissionControllerLog) << "Loading simple item: nextSequenceNumber:command" << nextSequenceNumber << simpleItem->command();
+            nextSequenceNumber = simpleItem->lastSequenceNumber() + 1;
+            visualItems->append(simpleItem);
+        } else {
+            return false;
+        }
+    } else if (itemType == VisualMissionItem::jsonTypeComplexItemValue) {
+        QList<JsonHelper::KeyValidateInfo> complexItemKeyInfoList = {
+            { ComplexMissionItem::jsonComplexItemTypeKey,  QJsonValue::String, true },
         };
-        if (!JsonHelper::validateKeys(itemObject, itemKeyInfoList, errorString)) {
+        if (!JsonHelper::validateKeys(itemObject, complexItemKeyInfoList, errorString)) {
             return false;
         }
-        QString itemType = itemObject[VisualMissionItem::jsonTypeKey].toString();
+        QString complexItemType = itemObject[ComplexMissionItem::jsonComplexItemTypeKey].toString();
 
-        if (itemType == VisualMissionItem::jsonTypeSimpleItemValue) {
-            SimpleMissionItem* simpleItem = new SimpleMissionItem(_masterController, _flyView, true /* forLoad */);
-            if (simpleItem->load(itemObject, nextSequenceNumber, errorString)) {
-                if (TakeoffMissionItem::isTakeoffCommand(static_cast<MAV_CMD>(simpleItem->command()))) {
-                    // This needs to be a TakeoffMissionItem
-                    TakeoffMissionItem* takeoffItem = new TakeoffMissionItem(_masterController, _flyView, settingsItem, true /* forLoad */);
-                    takeoffItem->load(itemObject, nextSequenceNumber, errorString);
-                    simpleItem->deleteLater();
-                    simpleItem = takeoffItem;
-                }
-                qCDebug(MissionControllerLog) << "Loading simple item: nextSequenceNumber:command" << nextSequenceNumber << simpleItem->command();
-                nextSequenceNumber = simpleItem->lastSequenceNumber() + 1;
-                visualItems->append(simpleItem);
-            } else {
+        if (complexItemType == SurveyComplexItem::jsonComplexItemTypeValue) {
+            qCDebug(MissionControllerLog) << "Loading Survey: nextSequenceNumber" << nextSequenceNumber;
+            SurveyComplexItem* surveyItem = new SurveyComplexItem(_masterController, _flyView, QString() /* kmlFile */);
+            if (!surveyItem->load(itemObject, nextSequenceNumber++, errorString)) {
                 return false;
             }
-        } else if (itemType == VisualMissionItem::jsonTypeComplexItemValue) {
-            QList<JsonHelper::KeyValidateInfo> complexItemKeyInfoList = {
-                { ComplexMissionItem::jsonComplexItemTypeKey,  QJsonValue::String, true },
-            };
-            if (!JsonHelper::validateKeys(itemObject, complexItemKeyInfoList, errorString)) {
+            nextSequenceNumber = surveyItem->lastSequenceNumber() + 1;
+            qCDebug(MissionControllerLog) << "Survey load complete: nextSequenceNumber" << nextSequenceNumber;
+            visualItems->append(surveyItem);
+        } else if (complexItemType == FixedWingLandingComplexItem::jsonComplexItemTypeValue) {
+            qCDebug(MissionControllerLog) << "Loading Fixed Wing Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
+            FixedWingLandingComplexItem* landingItem = new FixedWingLandingComplexItem(_masterController, _flyView);
+            if (!landingItem->load(itemObject, nextSequenceNumber++, errorString)) {
                 return false;
             }
-            QString complexItemType = itemObject[ComplexMissionItem::jsonComplexItemTypeKey].toString();
-
-            if (complexItemType == SurveyComplexItem::jsonComplexItemTypeValue) {
-                qCDebug(MissionControllerLog) << "Loading Survey: nextSequenceNumber" << nextSequenceNumber;
-                SurveyComplexItem* surveyItem = new SurveyComplexItem(_masterController, _flyView, QString() /* kmlFile */);
-                if (!surveyItem->load(itemObject, nextSequenceNumber++, errorString)) {
-                    return false;
-                }
-                nextSequenceNumber = surveyItem->lastSequenceNumber() + 1;
-                qCDebug(MissionControllerLog) << "Survey load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(surveyItem);
-            } else if (complexItemType == FixedWingLandingComplexItem::jsonComplexItemTypeValue) {
-                qCDebug(MissionControllerLog) << "Loading Fixed Wing Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
-                FixedWingLandingComplexItem* landingItem = new FixedWingLandingComplexItem(_masterController, _flyView);
-                if (!landingItem->load(itemObject, nextSequenceNumber++, errorString)) {
-                    return false;
-                }
-                nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
-                qCDebug(MissionControllerLog) << "FW Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(landingItem);
-            } else if (complexItemType == VTOLLandingComplexItem::jsonComplexItemTypeValue) {
-                qCDebug(MissionControllerLog) << "Loading VTOL Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
-                VTOLLandingComplexItem* landingItem = new VTOLLandingComplexItem(_masterController, _flyView);
-                if (!landingItem->load(itemObject, nextSequenceNumber++, errorString)) {
-                    return false;
-                }
-                nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
-                qCDebug(MissionControllerLog) << "VTOL Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(landingItem);
-            } else if (complexItemType == StructureScanComplexItem::jsonComplexItemTypeValue) {
-                qCDebug(MissionControllerLog) << "Loading Structure Scan: nextSequenceNumber" << nextSequenceNumber;
-                StructureScanComplexItem* structureItem = new StructureScanComplexItem(_masterController, _flyView, QString() /* kmlFile */);
-                if (!structureItem->load(itemObject, nextSequenceNumber++, errorString)) {
-                    return false;
-                }
-                nextSequenceNumber = structureItem->lastSequenceNumber() + 1;
-                qCDebug(MissionControllerLog) << "Structure Scan load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(structureItem);
-            } else if (complexItemType == CorridorScanComplexItem::jsonComplexItemTypeValue) {
-                qCDebug(MissionControllerLog) << "Loading Corridor Scan: nextSequenceNumber" << nextSequenceNumber;
-                CorridorScanComplexItem* corridorItem = new CorridorScanComplexItem(_masterController, _flyView, QString() /* kmlFile */);
-                if (!corridorItem->load(itemObject, nextSequenceNumber++, errorString)) {
-                    return false;
-                }
-                nextSequenceNumber = corridorItem->lastSequenceNumber() + 1;
-                qCDebug(MissionControllerLog) << "Corridor Scan load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(corridorItem);
-            } else {
-                errorString = tr("Unsupported complex item type: %1").arg(complexItemType);
+            nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
+            qCDebug(MissionControllerLog) << "FW Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
+            visualItems->append(landingItem);
+        } else if (complexItemType == VTOLLandingComplexItem::jsonComplexItemTypeValue) {
+            qCDebug(MissionControllerLog) << "Loading VTOL Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
+            VTOLLandingComplexItem* landingItem = new VTOLLandingComplexItem(_masterController, _flyView);
+            if (!landingItem->load(itemObject, nextSequenceNumber++, errorString)) {
+                return false;
+            }
+            nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
+            qCDebug(MissionControllerLog) << "VTOL Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
+            visualItems->append(landingItem);
+        } else if (complexItemType == StructureScanComplexItem::jsonComplexItemTypeValue) {
+            qCDebug(MissionControllerLog) << "Loading Structure Scan: nextSequenceNumber" << nextSequenceNumber;
+            StructureScanComplexItem* structureItem = new StructureScanComplexItem(_masterController, _flyView, QString() /* kmlFile */);
+            if (!structureItem->load(itemObject, nextSequenceNumber++, errorString)) {
+                return false;
+            }
+            nextSequenceNumber = structureItem->lastSequenceNumber() + 1;
+            qCDebug(MissionControllerLog) << "Structure Scan load complete: nextSequenceNumber" << nextSequenceNumber;
+            visualItems->append(structureItem);
+        } else if (complexItemType == CorridorScanComplexItem::jsonComplexItemTypeValue) {
+            qCDebug(MissionControllerLog) << "Loading Corridor Scan: nextSequenceNumber" << nextSequenceNumber;
+            CorridorScanComplexItem* corridorItem = new CorridorScanComplexItem(_masterController, _flyView, QString() /* kmlFile */);
+            if (!corridorItem->load(itemObject, nextSequenceNumber++, errorString)) {
+                return false;
             }
+            nextSequenceNumber = corridorItem->lastSequenceNumber() + 1;
+            qCDebug(MissionControllerLog) << "Corridor Scan load complete: nextSequenceNumber" << nextSequenceNumber;
+            visualItems->append(corridorItem);
         } else {
-            errorString = tr("Unknown item type: %1").arg(itemType);
-            return false;
+            errorString = tr("Unsupported complex item type: %1").arg(complexItemType);
         }
+    } else {
+        errorString = tr("Unknown item type: %1").arg(itemType);
+        return false;
     }
 
+    return true;
+}
+
+bool MissionController::_fixupDoJumpSequenceNumbers(QmlObjectListModel* visualItems, QString& errorString)
+{
     // Fix up the DO_JUMP commands jump sequence number by finding the item with the matching doJumpId
     for (int i=0; i<visualItems->count(); i++) {
         if (visualItems->value<VisualMissionItem*>(i)->isSimpleItem()) {
@@ -896,7 +932,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
     return true;
 }
 
-bool MissionController::_loadItemsFromJson(const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString)
+int MissionController::_jsonMissionFileVersion(const QJsonObject& json, QString& errorString)
 {
     // V1 file format has no file type key and version key is string. Convert to new format.
     if (!json.contains(JsonHelper::jsonFileTypeKey)) {
@@ -911,7 +947,12 @@ bool MissionController::_loadItemsFromJson(const QJsonObject& json, QmlObjectLis
                                             fileVersion,
                                             errorString);
 
-    if (fileVersion == 1) {
+    return fileVersion;
+}
+
+bool MissionController::_loadItemsFromJson(const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString)
+{
+    if (_jsonMissionFileVersion(json, errorString) == 1) {
         return _loadJsonMissionFileV1(json, visualItems, errorString);
     } else {
         return _loadJsonMissionFileV2(json, visualItems, errorString);
@@ -1029,9 +1070,9 @@ bool MissionController::loadJsonFile(QFile& file, QString& errorString)
     QString         errorStr;
     QString         errorMessage = tr("Mission: %1");
     QJsonDocument   jsonDoc;
-    QByteArray      bytes = file.readAll();
 
-    if (!JsonHelper::isJsonFile(bytes, jsonDoc, errorStr)) {
+    // The file bytes are released as soon as they are parsed, large missions would otherwise be held twice during the load
+    if (!JsonHelper::isJsonFile(file.readAll(), jsonDoc, errorStr)) {
         errorString = errorMessage.arg(errorStr);
         return false;
     }
@@ -1048,6 +1089,97 @@ bool MissionController::loadJsonFile(QFile& file, QString& errorString)
     return true;
 }
 
+void MissionController::loadAsync(const QJsonObject& json, bool missionFile)
+{
+    cancelLoad();
+
+    QString errorStr;
+    QmlObjectListModel* loadedVisualItems = new QmlObjectListModel(this);
+
+    if (missionFile && (_jsonMissionFileVersion(json, errorStr) == 1)) {
+        // V1 files come from old versions which couldn't handle large missions, no need to load them in slices
+        if (!_loadJsonMissionFileV1(json, loadedVisualItems, errorStr)) {
+            loadedVisualItems->clearAndDeleteContents();
+            loadedVisualItems->deleteLater();
+            emit loadComplete(false, tr("Mission: %1").arg(errorStr));
+            return;
+        }
+        _initLoadedVisualItems(loadedVisualItems);
+        emit loadComplete(true, QString());
+        return;
+    }
+
+    _jsonLoadState.visualItems = loadedVisualItems;
+    if (!_loadJsonMissionFileV2Start(json, _jsonLoadState, errorStr)) {
+        _finishLoadAsync(false, errorStr);
+        return;
+    }
+
+    qCDebug(MissionControllerLog) << "loadAsync itemCount:" << _jsonLoadState.rgMissionItems.count();
+    emit loadProgressChanged(loadProgress());
+    _jsonLoadTimer.start();
+}
+
+void MissionController::cancelLoad(void)
+{
+    if (!loadInProgress()) {
+        return;
+    }
+
+    qCDebug(MissionControllerLog) << "cancelLoad";
+    _jsonLoadTimer.stop();
+    _jsonLoadState.visualItems->clearAndDeleteContents();
+    _jsonLoadState.visualItems->deleteLater();
+    _jsonLoadState = JsonLoadState_t();
+    emit loadProgressChanged(loadProgress());
+}
+
+double MissionController::loadProgress(void) const
+{
+    if (!loadInProgress() || _jsonLoadState.rgMissionItems.isEmpty()) {
+        return 0;
+    }
+    return static_cast<double>(_jsonLoadState.nextItemIndex) / static_cast<double>(_jsonLoadState.rgMissionItems.count());
+}
+
+/// Loads items until the time slice is used up, then gives the event loop a turn
+void MissionController::_loadNextJsonItems(void)
+{
+    QElapsedTimer sliceTimer;
+    sliceTimer.start();
+
+    QString errorStr;
+    while (_jsonLoadState.nextItemIndex < _jsonLoadState.rgMissionItems.count()) {
+        if (!_loadJsonMissionItem(_jsonLoadState, errorStr)) {
+            _finishLoadAsync(false, errorStr);
+            return;
+        }
+        if (sliceTimer.elapsed() >= _jsonLoadSliceMSecs) {
+            emit loadProgressChanged(loadProgress());
+            _jsonLoadTimer.start();
+            return;
+        }
+    }
+
+    _finishLoadAsync(_fixupDoJumpSequenceNumbers(_jsonLoadState.visualItems, errorStr), errorStr);
+}
+
+void MissionController::_finishLoadAsync(bool success, const QString& errorString)
+{
+    QmlObjectListModel* loadedVisualItems = _jsonLoadState.visualItems;
+    _jsonLoadState = JsonLoadState_t();
+
+    if (success) {
+        _initLoadedVisualItems(loadedVisualItems);
+    } else {
+        loadedVisualItems->clearAndDeleteContents();
+        loadedVisualItems->deleteLater();
+    }
+
+    emit loadProgressChanged(loadProgress());
+    emit loadComplete(success, success ? QString() : tr("Mission: %1").arg(errorString));
+}
+
 bool MissionController::loadTextFile(QFile& file, QString& errorString)
 {
     QString     errorStr;
@@ -1179,11 +1311,12 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     connect(pair.second, &VisualMissionItem::coordinateChanged,     segment,    &FlightPathSegment::setCoordinate2);
     connect(pair.second, &VisualMissionItem::amslEntryAltChanged,   segment,    &FlightPathSegment::setCoord2AMSLAlt);
 
-    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_itemFlightStatusChanged);
 
+    VisualMissionItem* segmentEndItem = pair.second;
     connect(segment,    &FlightPathSegment::totalDistanceChanged,       this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       [this, segmentEndItem]() { _setFlightStatusDirty(_visualItems->indexOf(segmentEndItem)); });
+    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       [this, segmentEndItem]() { _setFlightStatusDirty(_visualItems->indexOf(segmentEndItem)); });
     connect(segment,    &FlightPathSegment::amslTerrainHeightsChanged,  this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
     connect(segment,    &FlightPathSegment::terrainCollisionChanged,    this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
 
@@ -1432,7 +1565,7 @@ void MissionController::_recalcFlightPathSegments(void)
     // Anything left in the old table is an obsolete line object that can go
     qDeleteAll(oldSegmentTable);
 
-    emit _recalcMissionFlightStatusSignal();
+    _setFlightStatusDirty(0);
 
     if (_waypointPath.count() == 0) {
         // MapPolyLine has a bug where if you change from a path which has elements to an empty path the line drawn
@@ -1520,27 +1653,64 @@ void MissionController::_recalcMissionFlightStatus()
 
     bool homePositionValid = _settingsItem->coordinate().isValid();
 
-    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus";
+    // The values of an item only depend on the items before it. So the walk restarts at the first changed item from
+    // the state saved there by the previous walk. Any change to the structure of the list recalcs from the start.
+    const int itemCount = _visualItems->count();
+    int startIndex = _flightStatusDirtyIndex;
+    _flightStatusDirtyIndex = -1;
+    if (startIndex < 0 || startIndex >= itemCount || _flightStatusCheckpoints.count() != itemCount) {
+        startIndex = 0;
+    }
+
+    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus startIndex" << startIndex;
 
     // If home position is valid we can calculate distances between all waypoints.
     // If home position is not valid we can only calculate distances between waypoints which are
     // both relative altitude.
 
-    // No values for first item
-    lastFlyThroughVI->setAltDifference(0);
-    lastFlyThroughVI->setAzimuth(0);
-    lastFlyThroughVI->setDistance(0);
-    lastFlyThroughVI->setDistanceFromStart(0);
-
-    _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
-
-    _resetMissionFlightStatus();
+    const double prevMinAMSLAltitude = _minAMSLAltitude;
+    const double prevMaxAMSLAltitude = _maxAMSLAltitude;
 
     bool   linkStartToHome =            false;
     bool   foundRTL =                   false;
     double totalHorizontalDistance =    0;
 
-    for (int i=0; i<_visualItems->count(); i++) {
+    if (startIndex == 0) {
+        // No values for first item
+        lastFlyThroughVI->setAltDifference(0);
+        lastFlyThroughVI->setAzimuth(0);
+        lastFlyThroughVI->setDistance(0);
+        lastFlyThroughVI->setDistanceFromStart(0);
+
+        _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
+
+        _resetMissionFlightStatus();
+
+        _flightStatusCheckpoints.resize(itemCount);
+    } else {
+        const FlightStatusCheckpoint_t& checkpoint = _flightStatusCheckpoints[startIndex];
+
+        _missionFlightStatus =      checkpoint.missionFlightStatus;
+        lastFlyThroughVI =          checkpoint.lastFlyThroughVI;
+        totalHorizontalDistance =   checkpoint.totalHorizontalDistance;
+        _minAMSLAltitude =          checkpoint.minAMSLAltitude;
+        _maxAMSLAltitude =          checkpoint.maxAMSLAltitude;
+        firstCoordinateItem =       checkpoint.firstCoordinateItem;
+        linkStartToHome =           checkpoint.linkStartToHome;
+        foundRTL =                  checkpoint.foundRTL;
+    }
+
+    for (int i=startIndex; i<itemCount; i++) {
+        FlightStatusCheckpoint_t& checkpoint = _flightStatusCheckpoints[i];
+        checkpoint.missionFlightStatus =        _missionFlightStatus;
+        checkpoint.lastFlyThroughVI =           lastFlyThroughVI;
+        checkpoint.totalHorizontalDistance =    totalHorizontalDistance;
+        checkpoint.minAMSLAltitude =            _minAMSLAltitude;
+        checkpoint.maxAMSLAltitude =            _maxAMSLAltitude;
+        checkpoint.firstCoordinateItem =        firstCoordinateItem;
+        checkpoint.linkStartToHome =            linkStartToHome;
+        checkpoint.foundRTL =                   foundRTL;
+
         VisualMissionItem*  item =          qobject_cast<VisualMissionItem*>(_visualItems->get(i));
         SimpleMissionItem*  simpleItem =    qobject_cast<SimpleMissionItem*>(item);
         ComplexMissionItem* complexItem =   qobject_cast<ComplexMissionItem*>(item);
@@ -1754,9 +1924,12 @@ void MissionController::_recalcMissionFlightStatus()
     emit minAMSLAltitudeChanged         (_minAMSLAltitude);
     emit maxAMSLAltitudeChanged         (_maxAMSLAltitude);
 
-    // Walk the list again calculating altitude percentages
+    // Walk the list again calculating altitude percentages. Unless the altitude range changed only the recalculated
+    // items can have new percentages.
+    auto sameAltitude = [](double alt1, double alt2) { return (qIsNaN(alt1) && qIsNaN(alt2)) || (alt1 == alt2); };
+    const int altPercentStartIndex = sameAltitude(prevMinAMSLAltitude, _minAMSLAltitude) && sameAltitude(prevMaxAMSLAltitude, _maxAMSLAltitude) ? startIndex : 0;
     double altRange = _maxAMSLAltitude - _minAMSLAltitude;
-    for (int i=0; i<_visualItems->count(); i++) {
+    for (int i=altPercentStartIndex; i<itemCount; i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
 
         if (item->specifiesCoordinate()) {
@@ -1795,6 +1968,7 @@ void MissionController::_recalcSequence(void)
     // Setup ascending sequence numbers for all visual items
 
     _inRecalcSequence = true;
+    _setFlightStatusDirty(0);
     int sequenceNumber = 0;
     for (int i=0; i<_visualItems->count(); i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
@@ -1868,6 +2042,7 @@ void MissionController::_recalcAllWithCoordinate(const QGeoCoordinate& coordinat
     if (!_flyView) {
         _setPlannedHomePositionFromFirstCoordinate(coordinate);
     }
+    _flightStatusCheckpoints.clear();
     _recalcSequence();
     _recalcChildItems();
     emit _recalcFlightPathSegmentsSignal();
@@ -1940,13 +2115,13 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     setDirty(false);
 
     connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_itemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_itemFlightStatusChanged);
     connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_recalcSequence);
 
     if (visualItem->isSimpleItem()) {
@@ -1960,10 +2135,10 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     } else {
         ComplexMissionItem* complexItem = qobject_cast<ComplexMissionItem*>(visualItem);
         if (complexItem) {
-            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_itemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_itemFlightStatusChanged);
             connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
         } else {
             qWarning() << "ComplexMissionItem not found";
@@ -1977,6 +2152,19 @@ void MissionController::_deinitVisualItem(VisualMissionItem* visualItem)
     disconnect(visualItem, nullptr, nullptr, nullptr);
 }
 
+/// Marks the flight status of the item and all items after it for recalc
+void MissionController::_setFlightStatusDirty(int visualItemIndex)
+{
+    visualItemIndex = qMax(visualItemIndex, 0);
+    _flightStatusDirtyIndex = (_flightStatusDirtyIndex < 0) ? visualItemIndex : qMin(_flightStatusDirtyIndex, visualItemIndex);
+    emit _recalcMissionFlightStatusSignal();
+}
+
+void MissionController::_itemFlightStatusChanged(void)
+{
+    _setFlightStatusDirty(_visualItems->indexOf(sender()));
+}
+
 void MissionController::_itemCommandChanged(void)
 {
     _recalcChildItems();
@@ -2008,8 +2196,8 @@ void MissionController::_managerVehicleChanged(Vehicle* managerVehicle)
     connect(_missionManager, &MissionManager::lastCurrentIndexChanged,  this, &MissionController::resumeMissionIndexChanged);
     connect(_missionManager, &MissionManager::resumeMissionReady,       this, &MissionController::resumeMissionReady);
     connect(_missionManager, &MissionManager::resumeMissionUploadFail,  this, &MissionController::resumeMissionUploadFail);
-    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, [this]() { _setFlightStatusDirty(0); });
+    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, [this]() { _setFlightStatusDirty(0); });
     connect(_managerVehicle, &Vehicle::vehicleTypeChanged,              this, &MissionController::complexMissionItemNamesChanged);
 
     emit complexMissionItemNamesChanged();
@@ -11,6 +11,7 @@
 
 #include <QtCore/QHash>
 #include <QtCore/QFile>
+#include <QtCore/QJsonArray>
 #include <QtCore/QLoggingCategory>
 
 #include "PlanElementController.h"
@@ -31,7 +32,7 @@ class ComplexMissionItem;
 class MissionSettingsItem;
 class TakeoffMissionItem;
 class PlanViewSettings;
-class KMLPlanDomDocument;
+class KMLPlanStreamWriter;
 class Vehicle;
 
 typedef QPair<VisualMissionItem*,VisualMissionItem*> VisualItemPair;
@@ -44,6 +45,8 @@ class MissionController : public PlanElementController
     Q_MOC_INCLUDE("VisualMissionItem.h")
     Q_MOC_INCLUDE("TakeoffMissionItem.h")
 
+    friend class MissionControllerTest;
+
 public:
     MissionController(PlanMasterController* masterController, QObject* parent = nullptr);
     ~MissionController();
@@ -199,6 +202,17 @@ public:
     bool loadJsonFile(QFile& file, QString& errorString);
     bool loadTextFile(QFile& file, QString& errorString);
 
+    /// Loads the mission like load does, but builds the visual items over several event loop iterations so a large
+    /// mission doesn't block the ui. loadComplete is signalled when done.
+    ///     @param missionFile true: json is a mission file, false: json is the mission object of a plan file
+    void loadAsync(const QJsonObject& json, bool missionFile);
+
+    /// Drops a running loadAsync, loadComplete is not signalled and the current mission stays
+    void cancelLoad(void);
+
+    bool    loadInProgress  (void) const { return _jsonLoadState.visualItems != nullptr; }
+    double  loadProgress    (void) const;   ///< Fraction of the items loaded by a running loadAsync
+
     QGCGeoBoundingCube* travelBoundingCube  () { return &_travelBoundingCube; }
     QGeoCoordinate      takeoffCoordinate   () { return _takeoffCoordinate; }
 
@@ -218,7 +232,7 @@ public:
     bool showPlanFromManagerVehicle (void) final;
 
     // Create KML file
-    void addMissionToKML(KMLPlanDomDocument& planKML);
+    void addMissionToKML(KMLPlanStreamWriter& planKML);
 
     // Property accessors
 
@@ -302,6 +316,8 @@ signals:
     void _recalcMissionFlightStatusSignal   (void);
     void _recalcFlightPathSegmentsSignal    (void);
     void globalAltitudeModeChanged          (void);
+    void loadProgressChanged                (double loadProgress);
+    void loadComplete                       (bool success, const QString& errorString);
 
 private slots:
     void _newMissionItemsAvailableFromVehicle   (bool removeAllRequested);
@@ -320,8 +336,31 @@ private slots:
     void _recalcAll                             (void);
     void _managerVehicleChanged                 (Vehicle* managerVehicle);
     void _takeoffItemNotRequiredChanged         (void);
+    void _loadNextJsonItems                     (void);
+    void _itemFlightStatusChanged               (void);
 
 private:
+    /// Progress of loading the items of a V2 mission
+    typedef struct {
+        QmlObjectListModel*     visualItems =           nullptr;
+        MissionSettingsItem*    settingsItem =          nullptr;
+        QJsonArray              rgMissionItems;
+        int                     nextItemIndex =         0;
+        int                     nextSequenceNumber =    1;
+    } JsonLoadState_t;
+
+    /// State of the flight status walk before an item, the walk restarts from it when the item changes
+    typedef struct {
+        MissionFlightStatus_t   missionFlightStatus;
+        VisualMissionItem*      lastFlyThroughVI;
+        double                  totalHorizontalDistance;
+        double                  minAMSLAltitude;
+        double                  maxAMSLAltitude;
+        bool                    firstCoordinateItem;
+        bool                    linkStartToHome;
+        bool                    foundRTL;
+    } FlightStatusCheckpoint_t;
+
     void                    _init                               (void);
     void                    _recalcSequence                     (void);
     void                    _recalcChildItems                   (void);
@@ -339,6 +378,12 @@ private:
     bool                    _loadJsonMissionFile                (const QByteArray& bytes, QmlObjectListModel* visualItems, QString& errorString);
     bool                    _loadJsonMissionFileV1              (const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString);
     bool                    _loadJsonMissionFileV2              (const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString);
+    bool                    _loadJsonMissionFileV2Start         (const QJsonObject& json, JsonLoadState_t& loadState, QString& errorString);
+    bool                    _loadJsonMissionItem                (JsonLoadState_t& loadState, QString& errorString);
+    bool                    _fixupDoJumpSequenceNumbers         (QmlObjectListModel* visualItems, QString& errorString);
+    int                     _jsonMissionFileVersion             (const QJsonObject& json, QString& errorString);
+    void                    _finishLoadAsync                    (bool success, const QString& errorString);
+    void                    _setFlightStatusDirty               (int visualItemIndex);
     bool                    _loadTextMissionFile                (QTextStream& stream, QmlObjectListModel* visualItems, QString& errorString);
     int                     _nextSequenceNumber                 (void);
     void                    _scanForAdditionalSettings          (QmlObjectListModel* visualItems, PlanMasterController* masterController);
@@ -388,6 +433,8 @@ private:
     VisualMissionItem*          _currentPlanViewItem =          nullptr;
     TakeoffMissionItem*         _takeoffMissionItem =           nullptr;
     QTimer                      _updateTimer;
+    QTimer                      _jsonLoadTimer;
+    JsonLoadState_t             _jsonLoadState;
     QGCGeoBoundingCube          _travelBoundingCube;
     QGeoCoordinate              _takeoffCoordinate;
     QGeoCoordinate              _previousCoordinate;
@@ -402,9 +449,13 @@ private:
     double                      _minAMSLAltitude =              0;
     double                      _maxAMSLAltitude =              0;
     bool                        _missionContainsVTOLTakeoff =   false;
+    QList<FlightStatusCheckpoint_t> _flightStatusCheckpoints;                  ///< Index matches _visualItems
+    int                         _flightStatusDirtyIndex =       -1;             ///< First item needing a flight status recalc, -1: recalc all
 
     QGroundControlQmlGlobal::AltMode _globalAltMode = QGroundControlQmlGlobal::AltitudeModeRelative;
 
+    static constexpr int _jsonLoadSliceMSecs = 20;   ///< Time loadAsync spends building items before giving the event loop a turn
+
     static constexpr const char* _settingsGroup =                 "MissionController";
     static constexpr const char* _jsonFileTypeValue =             "Mission";
     static constexpr const char* _jsonItemsKey =                  "items";
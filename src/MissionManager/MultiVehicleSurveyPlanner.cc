@@ -0,0 +1,221 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MultiVehicleSurveyPlanner.h"
+#include "MissionController.h"
+#include "PlanMasterController.h"
+#include "QGCGeo.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QJsonArray>
+#include <QtGui/QPolygonF>
+
+QGC_LOGGING_CATEGORY(MultiVehicleSurveyPlannerLog, "qgc.missionmanager.multivehiclesurveyplanner")
+
+MultiVehicleSurveyPlanner::MultiVehicleSurveyPlanner(QObject* parent)
+    : QObject(parent)
+{
+    (void) connect(&_watcher, &QFutureWatcher<Transects_t>::finished, this, &MultiVehicleSurveyPlanner::_transectsReady);
+}
+
+MultiVehicleSurveyPlanner::~MultiVehicleSurveyPlanner()
+{
+    _watcher.cancel();
+    _watcher.waitForFinished();
+}
+
+void MultiVehicleSurveyPlanner::start(SurveyComplexItem* survey, const QList<VehicleCapability_t>& vehicles)
+{
+    _watcher.cancel();
+    _watcher.waitForFinished();
+    _clearPlans();
+
+    if (vehicles.isEmpty()) {
+        emit planComplete();
+        return;
+    }
+
+    // The settings are saved once and loaded into each vehicle's survey
+    QJsonArray savedItems;
+    survey->save(savedItems);
+    _sourceObject = savedItems.isEmpty() ? QJsonObject() : savedItems[0].toObject();
+
+    QList<double> weights;
+    for (const VehicleCapability_t& vehicle: vehicles) {
+        weights.append(qMax(0.0, vehicle.enduranceSecs * vehicle.cruiseSpeed));
+    }
+
+    const SurveyComplexItem::TransectGenerationParams_t sourceParams = survey->_transectGenerationParams();
+    _partitions = partitionSurveyArea(sourceParams.polygon, sourceParams.gridAngle, sourceParams.gridSpacing, weights);
+
+    QList<SurveyComplexItem::TransectGenerationParams_t> partitionParams;
+    for (const QList<QGeoCoordinate>& partition: _partitions) {
+        SurveyComplexItem::TransectGenerationParams_t params = sourceParams;
+        params.polygon = partition;
+        partitionParams.append(params);
+    }
+
+    qCDebug(MultiVehicleSurveyPlannerLog) << "start vehicles" << vehicles.count();
+    _watcher.setFuture(QtConcurrent::mapped(partitionParams, &SurveyComplexItem::_generateTransects));
+}
+
+void MultiVehicleSurveyPlanner::_transectsReady(void)
+{
+    if (_watcher.isCanceled()) {
+        return;
+    }
+
+    const QList<Transects_t> results = _watcher.future().results();
+
+    for (qsizetype i=0; i<_partitions.count(); i++) {
+        PlanMasterController* const plan = new PlanMasterController(this);
+        plan->start();
+        _plans.append(plan);
+
+        const QList<QGeoCoordinate>& partition = _partitions[i];
+        if (partition.count() < 3) {
+            // Vehicle without a share of the area
+            continue;
+        }
+
+        SurveyComplexItem* const survey = qobject_cast<SurveyComplexItem*>(plan->missionController()->insertComplexMissionItem(SurveyComplexItem::name, partition.first(), 1));
+        if (!survey) {
+            qCWarning(MultiVehicleSurveyPlannerLog) << "_transectsReady unable to create survey for vehicle" << i;
+            continue;
+        }
+        survey->_setPartition(_sourceObject, partition, (i < results.count()) ? results[i] : Transects_t());
+    }
+
+    qCDebug(MultiVehicleSurveyPlannerLog) << "_transectsReady plans" << _plans.count();
+    emit planComplete();
+}
+
+void MultiVehicleSurveyPlanner::_clearPlans(void)
+{
+    qDeleteAll(_plans);
+    _plans.clear();
+    _partitions.clear();
+}
+
+QList<QList<QGeoCoordinate>> MultiVehicleSurveyPlanner::partitionSurveyArea(const QList<QGeoCoordinate>& polygon, double gridAngle, double gridSpacing, const QList<double>& weights)
+{
+    QList<QList<QGeoCoordinate>> partitions(weights.count());
+    if ((polygon.count() < 3) || weights.isEmpty()) {
+        return partitions;
+    }
+
+    // Convert to NED and rotate so that the transects run along the y axis, same as SurveyComplexItem generates them
+
+    const qsizetype vertexCount = polygon.count();
+    const QGeoCoordinate tangentOrigin = polygon.first();
+
+    QList<double> vertexLats(vertexCount);
+    QList<double> vertexLons(vertexCount);
+    for (qsizetype i=0; i<vertexCount; i++) {
+        vertexLats[i] = polygon[i].latitude();
+        vertexLons[i] = polygon[i].longitude();
+    }
+    QList<double> vertexNorths(vertexCount);
+    QList<double> vertexEasts(vertexCount);
+    QGCGeo::convertGeoToNed(vertexLats.constData(), vertexLons.constData(), nullptr, vertexCount, tangentOrigin, vertexNorths.data(), vertexEasts.data(), nullptr);
+
+    QPolygonF rotatedPolygon;
+    for (qsizetype i=0; i<vertexCount; i++) {
+        rotatedPolygon << SurveyComplexItem::_rotatePoint(QPointF(vertexEasts[i], vertexNorths[i]), QPointF(), -gridAngle);
+    }
+    const QRectF boundingRect = rotatedPolygon.boundingRect();
+
+    double totalWeight = 0;
+    for (const double weight: weights) {
+        totalWeight += weight;
+    }
+    const bool equalWeights = totalWeight <= 0;
+    if (equalWeights) {
+        totalWeight = weights.count();
+    }
+
+    // Place each cut so the area to its left matches the running total of the weights
+    const double totalArea = _polygonArea(rotatedPolygon);
+    QList<double> cuts { boundingRect.left() };
+    double cumulativeWeight = 0;
+    for (qsizetype i=0; i<weights.count() - 1; i++) {
+        cumulativeWeight += equalWeights ? 1.0 : weights[i];
+        const double targetArea = totalArea * (cumulativeWeight / totalWeight);
+
+        double low = cuts.last();
+        double high = boundingRect.right();
+        for (int iteration=0; iteration<_cutSearchIterations; iteration++) {
+            const double mid = (low + high) / 2.0;
+            if (_stripArea(rotatedPolygon, boundingRect.left(), mid) < targetArea) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        cuts.append((low + high) / 2.0);
+    }
+    cuts.append(boundingRect.right());
+
+    const double overlap = qMax(0.0, gridSpacing / 2.0);
+    for (qsizetype i=0; i<weights.count(); i++) {
+        const double minX = (i == 0) ? cuts[i] - 1 : cuts[i] - overlap;
+        const double maxX = (i == weights.count() - 1) ? cuts[i + 1] + 1 : cuts[i + 1] + overlap;
+        if (!equalWeights && (weights[i] <= 0)) {
+            continue;
+        }
+
+        const QRectF stripRect(QPointF(minX, boundingRect.top() - 1), QPointF(maxX, boundingRect.bottom() + 1));
+        QPolygonF strip = rotatedPolygon.intersected(QPolygonF(stripRect));
+        if (strip.isClosed()) {
+            strip.removeLast();
+        }
+        if (strip.count() < 3) {
+            continue;
+        }
+
+        const qsizetype stripCount = strip.count();
+        QList<double> stripNorths(stripCount);
+        QList<double> stripEasts(stripCount);
+        for (qsizetype j=0; j<stripCount; j++) {
+            const QPointF point = SurveyComplexItem::_rotatePoint(strip[j], QPointF(), gridAngle);
+            stripEasts[j] = point.x();
+            stripNorths[j] = point.y();
+        }
+        QList<double> stripLats(stripCount);
+        QList<double> stripLons(stripCount);
+        QGCGeo::convertNedToGeo(stripNorths.constData(), stripEasts.constData(), nullptr, stripCount, tangentOrigin, stripLats.data(), stripLons.data(), nullptr);
+
+        for (qsizetype j=0; j<stripCount; j++) {
+            partitions[i].append(QGeoCoordinate(stripLats[j], stripLons[j]));
+        }
+    }
+
+    return partitions;
+}
+
+/// @return Area of a simple polygon using the shoelace formula
+double MultiVehicleSurveyPlanner::_polygonArea(const QPolygonF& polygon)
+{
+    double area = 0;
+    for (qsizetype i=0; i<polygon.count(); i++) {
+        const QPointF& p1 = polygon[i];
+        const QPointF& p2 = polygon[(i + 1) % polygon.count()];
+        area += (p1.x() * p2.y()) - (p2.x() * p1.y());
+    }
+    return qAbs(area) / 2.0;
+}
+
+/// @return Area of the part of the polygon between minX and maxX
+double MultiVehicleSurveyPlanner::_stripArea(const QPolygonF& polygon, double minX, double maxX)
+{
+    const QRectF boundingRect = polygon.boundingRect();
+    const QRectF stripRect(QPointF(minX, boundingRect.top() - 1), QPointF(maxX, boundingRect.bottom() + 1));
+    return _polygonArea(polygon.intersected(QPolygonF(stripRect)));
+}
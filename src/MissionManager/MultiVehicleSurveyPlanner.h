@@ -0,0 +1,75 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "SurveyComplexItem.h"
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QJsonObject>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtPositioning/QGeoCoordinate>
+
+Q_DECLARE_LOGGING_CATEGORY(MultiVehicleSurveyPlannerLog)
+
+class PlanMasterController;
+
+/// Splits the area of a survey between a number of vehicles and builds a plan for each of them. The area is cut across
+/// the transects into strips sized by how much each vehicle can fly (endurance times cruise speed). Transects for all
+/// strips are generated in parallel on the global thread pool, after which each plan gets a survey item with the source
+/// survey's settings, its strip of the area and the transects already generated for it. The plans can then be sent
+/// with MissionController::sendItemsToVehicle(vehicle, plan->missionController()->visualItems()).
+class MultiVehicleSurveyPlanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    MultiVehicleSurveyPlanner(QObject* parent = nullptr);
+    ~MultiVehicleSurveyPlanner();
+
+    typedef struct {
+        double enduranceSecs;
+        double cruiseSpeed;     ///< Meters per second
+    } VehicleCapability_t;
+
+    /// Starts building one plan per vehicle from the specified survey. Any plans from a previous run are deleted.
+    void start(SurveyComplexItem* survey, const QList<VehicleCapability_t>& vehicles);
+
+    bool running(void) const { return _watcher.isRunning(); }
+
+    /// Plans in the same order as the vehicles passed to start, valid once planComplete is signalled
+    const QList<PlanMasterController*>& plans(void) const { return _plans; }
+
+    /// Splits a polygon into strips parallel to the transects of a survey with the specified grid angle. The area of
+    /// each strip is proportional to its weight. Neighbouring strips overlap by half the grid spacing so no part of the
+    /// area falls between two vehicles.
+    static QList<QList<QGeoCoordinate>> partitionSurveyArea(const QList<QGeoCoordinate>& polygon, double gridAngle, double gridSpacing, const QList<double>& weights);
+
+signals:
+    void planComplete(void);
+
+private slots:
+    void _transectsReady(void);
+
+private:
+    void _clearPlans(void);
+
+    static double _polygonArea(const QPolygonF& polygon);
+    static double _stripArea(const QPolygonF& polygon, double minX, double maxX);
+
+    typedef QList<QList<SurveyComplexItem::CoordInfo_t>> Transects_t;
+
+    QFutureWatcher<Transects_t>         _watcher;
+    QJsonObject                         _sourceObject;      ///< Saved settings of the source survey
+    QList<QList<QGeoCoordinate>>        _partitions;
+    QList<PlanMasterController*>        _plans;
+
+    static constexpr int _cutSearchIterations = 50;
+};
@@ -14,6 +14,10 @@
 #include "QGCApplication.h"
 #include "MissionCommandTree.h"
 #include "QGCLoggingCategory.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+
+#include <algorithm>
 
 QGC_LOGGING_CATEGORY(PlanManagerLog, "PlanManagerLog")
 
@@ -35,6 +39,8 @@ PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
     _ackTimeoutTimer->setSingleShot(true);
 
     connect(_ackTimeoutTimer, &QTimer::timeout, this, &PlanManager::_ackTimeout);
+
+    _rttClock.start();
 }
 
 PlanManager::~PlanManager()
@@ -50,18 +56,128 @@ void PlanManager::_writeMissionItemsWorker(void)
 
     qCDebug(PlanManagerLog) << QStringLiteral("writeMissionItems %1 count:").arg(_planTypeString()) << _writeMissionItems.count();
 
-    // Prime write list
-    _itemIndicesToWrite.clear();
+    // Encode the items up front, a MISSION_REQUEST is then answered by just packing the message
+    _writeMissionItemPayloads.clear();
+    _writeMissionItemPayloads.reserve(_writeMissionItems.count());
     for (int i=0; i<_writeMissionItems.count(); i++) {
-        _itemIndicesToWrite << i;
+        _writeMissionItemPayloads.append(_missionItemPayload(i));
     }
 
     _retryCount = 0;
+    _updatePipelinedTransfer();
     _setTransactionInProgress(TransactionWrite);
     _connectToMavlink();
+
+    if (!_partialWriteAllowed()) {
+        _startFullWrite();
+        return;
+    }
+
+    _writeRanges = _changedWriteRanges();
+    qCDebug(PlanManagerLog) << QStringLiteral("_writeMissionItemsWorker %1 partial write ranges:").arg(_planTypeString()) << _writeRanges;
+    if (_writeRanges.isEmpty()) {
+        // Vehicle already has these items. Completed from the event loop as a write to the vehicle would be.
+        QTimer::singleShot(0, this, [this]() {
+            if (_transactionInProgress == TransactionWrite) {
+                _finishTransaction(true);
+            }
+        });
+    } else {
+        _startNextWriteRange();
+    }
+}
+
+/// Writes all items, started by MISSION_COUNT
+void PlanManager::_startFullWrite(void)
+{
+    _writeRanges.clear();
+    _writeRangeFirst = 0;
+    _writeRangeLast = -1;
+
+    _itemIndicesToWrite.clear();
+    for (int i=0; i<_writeMissionItems.count(); i++) {
+        _itemIndicesToWrite << i;
+    }
+
+    _retryCount = 0;
+    _writeMissionCount();
+}
+
+/// Writes the next range of a partial write, started by MISSION_WRITE_PARTIAL_LIST
+void PlanManager::_startNextWriteRange(void)
+{
+    const QPair<int, int> range = _writeRanges.takeFirst();
+    _writeRangeFirst = range.first;
+    _writeRangeLast = range.second;
+
+    _itemIndicesToWrite.clear();
+    for (int i=_writeRangeFirst; i<=_writeRangeLast; i++) {
+        _itemIndicesToWrite << i;
+    }
+
+    _retryCount = 0;
     _writeMissionCount();
 }
 
+/// A partial write replaces items in place, so it needs the same item count as the vehicle. It also keeps the current
+/// item of the vehicle, which a resume mission relies on being reset.
+bool PlanManager::_partialWriteAllowed(void) const
+{
+    return _planType == MAV_MISSION_TYPE_MISSION &&
+            !_resumeMission &&
+            _vehicleMissionItemPayloadsValid &&
+            _vehicleMissionItemPayloads.count() == _writeMissionItemPayloads.count() &&
+            !_writeMissionItemPayloads.isEmpty() &&
+            _vehicle->firmwarePlugin()->supportsPartialMissionWrite() &&
+            qgcApp()->toolbox()->settingsManager()->appSettings()->partialPlanUpload()->rawValue().toBool();
+}
+
+/// @return First and last sequence number of the ranges of items which differ from the vehicle
+QList<QPair<int, int>> PlanManager::_changedWriteRanges(void) const
+{
+    QList<QPair<int, int>> ranges;
+    for (int i=0; i<_writeMissionItemPayloads.count(); i++) {
+        if (_samePayload(_writeMissionItemPayloads[i], _vehicleMissionItemPayloads[i])) {
+            continue;
+        }
+        if (!ranges.isEmpty() && (i - ranges.last().second) <= _partialWriteMergeGap) {
+            // A few unchanged items cost less than the extra handshake of another range
+            ranges.last().second = i;
+        } else {
+            ranges.append(qMakePair(i, i));
+        }
+    }
+    return ranges;
+}
+
+/// Compares what the vehicle stores of an item, the INT variants of the global frames are the same frame
+bool PlanManager::_samePayload(const mavlink_mission_item_int_t& item1, const mavlink_mission_item_int_t& item2)
+{
+    auto storedFrame = [](uint8_t frame) {
+        switch (frame) {
+        case MAV_FRAME_GLOBAL_INT:
+            return static_cast<uint8_t>(MAV_FRAME_GLOBAL);
+        case MAV_FRAME_GLOBAL_RELATIVE_ALT_INT:
+            return static_cast<uint8_t>(MAV_FRAME_GLOBAL_RELATIVE_ALT);
+        case MAV_FRAME_GLOBAL_TERRAIN_ALT_INT:
+            return static_cast<uint8_t>(MAV_FRAME_GLOBAL_TERRAIN_ALT);
+        default:
+            return frame;
+        }
+    };
+
+    return item1.command == item2.command &&
+            storedFrame(item1.frame) == storedFrame(item2.frame) &&
+            item1.autocontinue == item2.autocontinue &&
+            item1.param1 == item2.param1 &&
+            item1.param2 == item2.param2 &&
+            item1.param3 == item2.param3 &&
+            item1.param4 == item2.param4 &&
+            item1.x == item2.x &&
+            item1.y == item2.y &&
+            item1.z == item2.z;
+}
+
 
 void PlanManager::writeMissionItems(const QList<MissionItem*>& missionItems)
 {
@@ -98,13 +214,30 @@ void PlanManager::writeMissionItems(const QList<MissionItem*>& missionItems)
     _writeMissionItemsWorker();
 }
 
-/// This begins the write sequence with the vehicle. This may be called during a retry.
+/// This begins the write sequence with the vehicle, or the write of the next range of a partial write with
+/// MISSION_WRITE_PARTIAL_LIST. This may be called during a retry.
 void PlanManager::_writeMissionCount(void)
 {
-    qCDebug(PlanManagerLog) << QStringLiteral("_writeMissionCount %1 count:_retryCount").arg(_planTypeString()) << _writeMissionItems.count() << _retryCount;
+    qCDebug(PlanManagerLog) << QStringLiteral("_writeMissionCount %1 count:first:last:_retryCount").arg(_planTypeString()) << _writeMissionItems.count() << _writeRangeFirst << _writeRangeLast << _retryCount;
 
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
-    if (sharedLink) {
+    if (sharedLink && (_writeRangeLast >= 0)) {
+        mavlink_message_t       message;
+
+        mavlink_msg_mission_write_partial_list_pack_chan(
+            qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
+            qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
+            sharedLink->mavlinkChannel(),
+            &message,
+            _vehicle->id(),
+            MAV_COMP_ID_AUTOPILOT1,
+            static_cast<int16_t>(_writeRangeFirst),
+            static_cast<int16_t>(_writeRangeLast),
+            _planType
+        );
+
+        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+    } else if (sharedLink) {
         mavlink_message_t       message;
 
         mavlink_msg_mission_count_pack_chan(
@@ -121,6 +254,8 @@ void PlanManager::_writeMissionCount(void)
 
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     }
+    // The round trip to the first MISSION_REQUEST can only be measured if this isn't a retry
+    _writeItemSentMSecs = _retryCount == 0 ? _rttClock.elapsed() : -1;
     _startAckTimeout(AckMissionRequest);
 }
 
@@ -138,6 +273,7 @@ void PlanManager::loadFromVehicle(void)
     }
 
     _retryCount = 0;
+    _updatePipelinedTransfer();
     _setTransactionInProgress(TransactionRead);
     _connectToMavlink();
     _requestList();
@@ -150,6 +286,7 @@ void PlanManager::_requestList(void)
 
     _itemIndicesToRead.clear();
     _clearMissionItems();
+    _readMissionItemPayloads.clear();
 
     SharedLinkInterfacePtr  sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink){
@@ -197,7 +334,11 @@ void PlanManager::_ackTimeout(void)
         } else {
             _retryCount++;
             qCDebug(PlanManagerLog) << tr("Retrying %1 MISSION_REQUEST retry Count").arg(_planTypeString()) << _retryCount;
-            _requestNextMissionItem();
+            if (_pipelinedTransfer) {
+                _requestMissionItemWindow(true /* resend */);
+            } else {
+                _requestNextMissionItem();
+            }
         }
         break;
     case AckMissionRequest:
@@ -206,9 +347,12 @@ void PlanManager::_ackTimeout(void)
             // Vehicle did not send final MISSION_ACK at end of sequence
             _sendError(ProtocolError, tr("Mission write failed, vehicle failed to send final ack."));
             _finishTransaction(false);
-        } else if (_itemIndicesToWrite[0] == 0) {
-            // Vehicle did not respond to MISSION_COUNT, try again
-            if (_retryCount > _maxRetryCount) {
+        } else if (_itemIndicesToWrite[0] == _writeRangeFirst) {
+            // Vehicle did not respond to MISSION_COUNT or MISSION_WRITE_PARTIAL_LIST, try again
+            if (_retryCount > _maxRetryCount && _writeRangeLast >= 0) {
+                qCDebug(PlanManagerLog) << QStringLiteral("%1 partial write not answered, falling back to full write").arg(_planTypeString());
+                _startFullWrite();
+            } else if (_retryCount > _maxRetryCount) {
                 _sendError(MaxRetryExceeded, tr("Mission write mission count failed, maximum retries exceeded."));
                 _finishTransaction(false);
             } else {
@@ -263,6 +407,11 @@ void PlanManager::_startAckTimeout(AckType_t ack)
         break;
     }
 
+    if (_pipelinedTransfer) {
+        // Wait for the measured round trip time instead, backing off on retries. The backoff must not exceed the upper limit either.
+        _ackTimeoutTimer->setInterval(qMin(_adaptiveTimeout(_ackTimeoutTimer->interval()) << qMin(_retryCount, 3), _maxAdaptiveTimeoutMilliseconds));
+    }
+
     _expectedAck = ack;
     _ackTimeoutTimer->start();
 }
@@ -343,7 +492,13 @@ void PlanManager::_handleMissionCount(const mavlink_message_t& message)
             _itemIndicesToRead << i;
         }
         _missionItemCountToRead = missionCount.count;
-        _requestNextMissionItem();
+        if (_pipelinedTransfer) {
+            _nextReadRequestIndex = 0;
+            _readRequestMSecs.clear();
+            _requestMissionItemWindow(false /* resend */);
+        } else {
+            _requestNextMissionItem();
+        }
     }
 }
 
@@ -356,6 +511,40 @@ void PlanManager::_requestNextMissionItem(void)
 
     qCDebug(PlanManagerLog) << QStringLiteral("_requestNextMissionItem %1 sequenceNumber:retry").arg(_planTypeString()) << _itemIndicesToRead[0] << _retryCount;
 
+    _sendMissionRequest(_itemIndicesToRead[0]);
+    _startAckTimeout(AckMissionItem);
+}
+
+/// Pipelined read: Keeps up to _readWindowSize MISSION_REQUESTs in flight
+///     @param resend true: Send the requests in flight again
+void PlanManager::_requestMissionItemWindow(bool resend)
+{
+    int inFlightCount = 0;
+    for (const int seq: _itemIndicesToRead) {
+        if (seq >= _nextReadRequestIndex) {
+            break;
+        }
+        inFlightCount++;
+        if (resend) {
+            // A response to a resent request doesn't tell which request it belongs to, so it isn't a round trip sample
+            _readRequestMSecs.remove(seq);
+            _sendMissionRequest(seq);
+        }
+    }
+
+    while ((inFlightCount < _readWindowSize) && (_nextReadRequestIndex < _missionItemCountToRead)) {
+        _readRequestMSecs[_nextReadRequestIndex] = _rttClock.elapsed();
+        _sendMissionRequest(_nextReadRequestIndex++);
+        inFlightCount++;
+    }
+
+    qCDebug(PlanManagerLog) << QStringLiteral("_requestMissionItemWindow %1 inFlight:nextRequest:resend").arg(_planTypeString()) << inFlightCount << _nextReadRequestIndex << resend;
+
+    _startAckTimeout(AckMissionItem);
+}
+
+void PlanManager::_sendMissionRequest(int seq)
+{
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink) {
         mavlink_message_t       message;
@@ -366,11 +555,10 @@ void PlanManager::_requestNextMissionItem(void)
                                                   &message,
                                                   _vehicle->id(),
                                                   MAV_COMP_ID_AUTOPILOT1,
-                                                  _itemIndicesToRead[0],
+                                                  seq,
                                                   _planType);
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     }
-    _startAckTimeout(AckMissionItem);
 }
 
 void PlanManager::_handleMissionItem(const mavlink_message_t& message)
@@ -461,6 +649,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
         }
 
         _missionItems.append(item);
+        _readMissionItemPayloads.append(missionItem);
     } else {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 mission item received item index which was not requested, disregrarding:").arg(_planTypeString()) << seq;
         // We have to put the ack timeout back since it was removed above
@@ -471,7 +660,22 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
     emit progressPctChanged((double)seq / (double)_missionItemCountToRead);
     
     _retryCount = 0;
-    if (_itemIndicesToRead.count() == 0) {
+    if (_pipelinedTransfer) {
+        const auto requestMSecs = _readRequestMSecs.constFind(seq);
+        if (requestMSecs != _readRequestMSecs.constEnd()) {
+            _addRttSample(_rttClock.elapsed() - requestMSecs.value());
+            _readRequestMSecs.erase(requestMSecs);
+        }
+        if (_itemIndicesToRead.count() == 0) {
+            // Items can arrive out of order with several requests in flight
+            std::sort(_missionItems.begin(), _missionItems.end(), [](const MissionItem* item1, const MissionItem* item2) {
+                return item1->sequenceNumber() < item2->sequenceNumber();
+            });
+            _readTransactionComplete();
+        } else {
+            _requestMissionItemWindow(false /* resend */);
+        }
+    } else if (_itemIndicesToRead.count() == 0) {
         _readTransactionComplete();
     } else {
         _requestNextMissionItem();
@@ -516,40 +720,31 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message)
     emit progressPctChanged((double)missionRequestSeq / (double)_writeMissionItems.count());
 
     _lastMissionRequest = missionRequestSeq;
-    if (!_itemIndicesToWrite.contains(missionRequestSeq)) {
+    const bool resend = !_itemIndicesToWrite.contains(missionRequestSeq);
+    if (resend) {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequence number requested which has already been sent, sending again:").arg(_planTypeString()) << missionRequestSeq;
     } else {
         _itemIndicesToWrite.removeOne(missionRequestSeq);
+        if (_pipelinedTransfer && (_writeItemSentMSecs >= 0)) {
+            // The request for a new item is the response to the previous item
+            _addRttSample(_rttClock.elapsed() - _writeItemSentMSecs);
+        }
     }
     
-    MissionItem* item = _writeMissionItems[missionRequestSeq];
-    qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << item->command();
+    qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << _writeMissionItems[missionRequestSeq]->command();
 
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink) {
         mavlink_message_t       messageOut;
 
-        mavlink_msg_mission_item_int_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
-                                               qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
-                                               sharedLink->mavlinkChannel(),
-                                               &messageOut,
-                                               _vehicle->id(),
-                                               MAV_COMP_ID_AUTOPILOT1,
-                                               missionRequestSeq,
-                                               item->frame(),
-                                               item->command(),
-                                               missionRequestSeq == 0,
-                                               item->autoContinue(),
-                                               item->param1(),
-                                               item->param2(),
-                                               item->param3(),
-                                               item->param4(),
-                                               item->frame() == MAV_FRAME_MISSION ? item->param5() : item->param5() * 1e7,
-                                               item->frame() == MAV_FRAME_MISSION ? item->param6() : item->param6() * 1e7,
-                                               item->param7(),
-                                               _planType);
+        mavlink_msg_mission_item_int_encode_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
+                                                 qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
+                                                 sharedLink->mavlinkChannel(),
+                                                 &messageOut,
+                                                 &_writeMissionItemPayloads[missionRequestSeq]);
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), messageOut);
     }
+    _writeItemSentMSecs = resend ? -1 : _rttClock.elapsed();
     _startAckTimeout(AckMissionRequest);
 }
 
@@ -605,8 +800,14 @@ void PlanManager::_handleMissionAck(const mavlink_message_t& message)
         break;
     case AckMissionRequest:
         // MISSION_REQUEST is expected, or MAV_MISSION_ACCEPTED to end sequence
-        if (missionAck.type == MAV_MISSION_ACCEPTED) {
-            if (_itemIndicesToWrite.count() == 0) {
+        if (_writeRangeLast >= 0 && (missionAck.type != MAV_MISSION_ACCEPTED || _itemIndicesToWrite.count() != 0)) {
+            // Whatever the vehicle has now, a full write replaces it
+            qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionAck %1 partial write failed, falling back to full write").arg(_planTypeString());
+            _startFullWrite();
+        } else if (missionAck.type == MAV_MISSION_ACCEPTED) {
+            if (_itemIndicesToWrite.count() == 0 && !_writeRanges.isEmpty()) {
+                _startNextWriteRange();
+            } else if (_itemIndicesToWrite.count() == 0) {
                 qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionAck write sequence complete %1").arg(_planTypeString());
                 _finishTransaction(true);
             } else {
@@ -816,10 +1017,18 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
 
     switch (currentTransactionType) {
     case TransactionRead:
-        if (!success) {
+        if (success) {
+            std::sort(_readMissionItemPayloads.begin(), _readMissionItemPayloads.end(), [](const mavlink_mission_item_int_t& item1, const mavlink_mission_item_int_t& item2) {
+                return item1.seq < item2.seq;
+            });
+            _vehicleMissionItemPayloads = _readMissionItemPayloads;
+        } else {
             // Read from vehicle failed, clear partial list
             _clearAndDeleteMissionItems();
+            _vehicleMissionItemPayloads.clear();
         }
+        _vehicleMissionItemPayloadsValid = success;
+        _readMissionItemPayloads.clear();
         emit newMissionItemsAvailable(false);
         break;
     case TransactionWrite:
@@ -838,14 +1047,22 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
                     _missionItems.append(_writeMissionItems[i]);
                 }
                 _writeMissionItems.clear();
+                _vehicleMissionItemPayloads = _writeMissionItemPayloads;
             } else {
                 // Write failed, throw out the write list
                 _clearAndDeleteWriteMissionItems();
+                _vehicleMissionItemPayloads.clear();
             }
+            _vehicleMissionItemPayloadsValid = success;
+            _writeRanges.clear();
+            _writeRangeFirst = 0;
+            _writeRangeLast = -1;
             emit sendComplete(!success /* error */);
         }
         break;
     case TransactionRemoveAll:
+        _vehicleMissionItemPayloads.clear();
+        _vehicleMissionItemPayloadsValid = success;
         emit removeAllComplete(!success /* error */);
         break;
     default:
@@ -862,6 +1079,55 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
     }
 }
 
+mavlink_mission_item_int_t PlanManager::_missionItemPayload(int seq) const
+{
+    const MissionItem* item = _writeMissionItems[seq];
+
+    mavlink_mission_item_int_t missionItem{};
+    missionItem.target_system =     static_cast<uint8_t>(_vehicle->id());
+    missionItem.target_component =  MAV_COMP_ID_AUTOPILOT1;
+    missionItem.seq =               static_cast<uint16_t>(seq);
+    missionItem.frame =             static_cast<uint8_t>(item->frame());
+    missionItem.command =           static_cast<uint16_t>(item->command());
+    missionItem.current =           seq == 0;
+    missionItem.autocontinue =      item->autoContinue();
+    missionItem.param1 =            static_cast<float>(item->param1());
+    missionItem.param2 =            static_cast<float>(item->param2());
+    missionItem.param3 =            static_cast<float>(item->param3());
+    missionItem.param4 =            static_cast<float>(item->param4());
+    missionItem.x =                 static_cast<int32_t>(item->frame() == MAV_FRAME_MISSION ? item->param5() : item->param5() * 1e7);
+    missionItem.y =                 static_cast<int32_t>(item->frame() == MAV_FRAME_MISSION ? item->param6() : item->param6() * 1e7);
+    missionItem.z =                 static_cast<float>(item->param7());
+    missionItem.mission_type =      _planType;
+
+    return missionItem;
+}
+
+void PlanManager::_updatePipelinedTransfer(void)
+{
+    _pipelinedTransfer = qgcApp()->toolbox()->settingsManager()->appSettings()->pipelinedPlanTransfer()->rawValue().toBool();
+}
+
+/// Smoothed round trip time and its variation are tracked as done by TCP (RFC 6298)
+void PlanManager::_addRttSample(qint64 rttMSecs)
+{
+    if (_srttMSecs < 0) {
+        _srttMSecs = rttMSecs;
+        _rttVarMSecs = rttMSecs / 2.0;
+    } else {
+        _rttVarMSecs = (0.75 * _rttVarMSecs) + (0.25 * qAbs(_srttMSecs - rttMSecs));
+        _srttMSecs = (0.875 * _srttMSecs) + (0.125 * rttMSecs);
+    }
+}
+
+int PlanManager::_adaptiveTimeout(int minimumMSecs) const
+{
+    if (_srttMSecs < 0) {
+        return minimumMSecs;
+    }
+    return qBound(minimumMSecs, static_cast<int>(_srttMSecs + (4 * _rttVarMSecs)), _maxAdaptiveTimeoutMilliseconds);
+}
+
 bool PlanManager::inProgress(void) const
 {
     return _transactionInProgress != TransactionNone;
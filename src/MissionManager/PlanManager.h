@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtCore/QLoggingCategory>
@@ -27,6 +29,8 @@ class PlanManager : public QObject
 {
     Q_OBJECT
 
+    friend class MissionManagerTest;
+
 public:
     PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType);
     ~PlanManager();
@@ -44,7 +48,10 @@ public:
     ///     Signals newMissionItemsAvailable when done
     void loadFromVehicle(void);
 
-    /// Writes the specified set of mission items to the vehicle
+    /// Writes the specified set of mission items to the vehicle. If the firmware supports MISSION_WRITE_PARTIAL_LIST and
+    /// the item count is unchanged, only the ranges of items which differ from the items last written to or read from
+    /// the vehicle are sent. See AppSettings::partialPlanUpload, which is off by default since a mission changed on the
+    /// vehicle by anything else is not detected.
     /// IMPORTANT NOTE: PlanManager will take control of the MissionItem objects with the missionItems list. It will free them when done.
     ///     @param missionItems Items to send to vehicle
     ///     Signals sendComplete when done
@@ -73,6 +80,12 @@ public:
     // When actively retrying to request mission items, use a shorter timeout instead.
     static const int _retryTimeoutMilliseconds = 250;
     static const int _maxRetryCount = 5;
+    // Pipelined transfers keep this many MISSION_REQUESTs in flight while reading
+    static const int _readWindowSize = 8;
+    // Upper limit of the round trip based timeout of pipelined transfers
+    static const int _maxAdaptiveTimeoutMilliseconds = 10000;
+    // Changed ranges of a partial write closer than this many unchanged items are sent as one range
+    static const int _partialWriteMergeGap = 4;
 
 signals:
     void newMissionItemsAvailable   (bool removeAllRequested);
@@ -115,6 +128,12 @@ protected:
     void _handleMissionRequest(const mavlink_message_t& message);
     void _handleMissionAck(const mavlink_message_t& message);
     void _requestNextMissionItem(void);
+    void _requestMissionItemWindow(bool resend);
+    void _sendMissionRequest(int seq);
+    mavlink_mission_item_int_t _missionItemPayload(int seq) const;
+    void _updatePipelinedTransfer(void);
+    void _addRttSample(qint64 rttMSecs);
+    int _adaptiveTimeout(int minimumMSecs) const;
     void _clearMissionItems(void);
     void _sendError(ErrorCode_t errorCode, const QString& errorMsg);
     QString _ackTypeToString(AckType_t ackType);
@@ -123,6 +142,11 @@ protected:
     void _requestList(void);
     void _writeMissionCount(void);
     void _writeMissionItemsWorker(void);
+    void _startFullWrite(void);
+    void _startNextWriteRange(void);
+    bool _partialWriteAllowed(void) const;
+    QList<QPair<int, int>> _changedWriteRanges(void) const;
+    static bool _samePayload(const mavlink_mission_item_int_t& item1, const mavlink_mission_item_int_t& item2);
     void _clearAndDeleteMissionItems(void);
     void _clearAndDeleteWriteMissionItems(void);
     QString _lastMissionReqestString(MAV_MISSION_RESULT result);
@@ -152,6 +176,23 @@ protected:
     int                 _currentMissionIndex;
     int                 _lastCurrentIndex;
 
+    QList<mavlink_mission_item_int_t> _writeMissionItemPayloads; ///< _writeMissionItems encoded for MISSION_ITEM_INT
+
+    QList<mavlink_mission_item_int_t> _vehicleMissionItemPayloads;         ///< Items on the vehicle as last written or read, compared against by partial writes
+    bool                _vehicleMissionItemPayloadsValid =  false;          ///< false: not known what is on the vehicle
+    QList<mavlink_mission_item_int_t> _readMissionItemPayloads;            ///< Items as received by the read in progress
+    QList<QPair<int, int>> _writeRanges;                                    ///< First and last sequence number of the ranges a partial write has still to send
+    int                 _writeRangeFirst =      0;      ///< First sequence number of the range being written
+    int                 _writeRangeLast =       -1;     ///< Last sequence number of the range being written, -1: full write started by MISSION_COUNT
+
+    bool                _pipelinedTransfer =    false;  ///< Windowed reads and round trip based timeouts, see AppSettings::pipelinedPlanTransfer
+    QElapsedTimer       _rttClock;
+    QHash<int, qint64>  _readRequestMSecs;              ///< Send time of the read requests in flight which weren't resent
+    int                 _nextReadRequestIndex = 0;      ///< First item not requested yet by a pipelined read
+    qint64              _writeItemSentMSecs =   -1;     ///< Send time of the last written item, -1: it was resent
+    double              _srttMSecs =            -1;     ///< Smoothed round trip time, -1: no sample yet
+    double              _rttVarMSecs =          0;
+
 private:
     void _setTransactionInProgress(TransactionType_t type);
 };
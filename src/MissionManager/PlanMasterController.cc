@@ -16,7 +16,8 @@
 #include "AppSettings.h"
 #include "JsonHelper.h"
 #include "MissionManager.h"
-#include "KMLPlanDomDocument.h"
+#include "KMLPlanStreamWriter.h"
+#include "TrackRecorder.h"
 #include "SurveyPlanCreator.h"
 #include "StructureScanPlanCreator.h"
 #include "CorridorScanPlanCreator.h"
@@ -25,7 +26,9 @@
 #include "GeoFenceManager.h"
 #include "RallyPointManager.h"
 #include "QGCLoggingCategory.h"
+#include "TerrainTileManager.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QFileInfo>
 
@@ -71,6 +74,12 @@ void PlanMasterController::_commonInit(void)
     connect(&_geoFenceController,   &GeoFenceController::syncInProgressChanged,     this, &PlanMasterController::syncInProgressChanged);
     connect(&_rallyPointController, &RallyPointController::syncInProgressChanged,   this, &PlanMasterController::syncInProgressChanged);
 
+    connect(&_missionController,    &MissionController::missionBoundingCubeChanged, this, &PlanMasterController::_missionBoundingCubeChanged);
+    connect(&_missionController,    &MissionController::loadProgressChanged,        this, &PlanMasterController::loadProgressChanged);
+    connect(&_missionController,    &MissionController::loadComplete,               this, &PlanMasterController::_missionLoadComplete);
+    connect(&_planFileReadWatcher,  &QFutureWatcherBase::finished,                  this, &PlanMasterController::_planFileRead);
+    connect(&_planFileWriteWatcher, &QFutureWatcherBase::finished,                  this, &PlanMasterController::_planFileWritten);
+
     // Offline vehicle can change firmware/vehicle type
     connect(_controllerVehicle,     &Vehicle::vehicleTypeChanged,                   this, &PlanMasterController::_updatePlanCreatorsList);
 }
@@ -78,7 +87,8 @@ void PlanMasterController::_commonInit(void)
 
 PlanMasterController::~PlanMasterController()
 {
-
+    // Don't let the app exit with a half written plan file
+    _planFileWriteWatcher.waitForFinished();
 }
 
 void PlanMasterController::start(void)
@@ -336,6 +346,9 @@ void PlanMasterController::loadFromFile(const QString& filename)
         return;
     }
 
+    cancelLoadFromFile();
+    _planFileWriteWatcher.waitForFinished();
+
     QFileInfo fileInfo(filename);
     QFile file(filename);
 
@@ -359,46 +372,199 @@ void PlanMasterController::loadFromFile(const QString& filename)
             success = true;
         }
     } else {
-        QJsonDocument   jsonDoc;
-        QByteArray      bytes = file.readAll();
+        QJsonDocument jsonDoc;
 
-        if (!JsonHelper::isJsonFile(bytes, jsonDoc, errorString)) {
+        // The file bytes are released as soon as they are parsed, large plans would otherwise be held twice during the load
+        if (!JsonHelper::isJsonFile(file.readAll(), jsonDoc, errorString)) {
             qgcApp()->showAppMessage(errorMessage.arg(errorString));
             return;
         }
 
         QJsonObject json = jsonDoc.object();
-        //-- Allow plugins to pre process the load
-        qgcApp()->toolbox()->corePlugin()->preLoadFromJson(this, json);
-
-        int version;
-        if (!JsonHelper::validateExternalQGCJsonFile(json, kPlanFileType, kPlanFileVersion, kPlanFileVersion, version, errorString)) {
-            qgcApp()->showAppMessage(errorMessage.arg(errorString));
-            return;
-        }
-
-        QList<JsonHelper::KeyValidateInfo> rgKeyInfo = {
-            { kJsonMissionObjectKey,        QJsonValue::Object, true },
-            { kJsonGeoFenceObjectKey,       QJsonValue::Object, true },
-            { kJsonRallyPointsObjectKey,    QJsonValue::Object, true },
-        };
-        if (!JsonHelper::validateKeys(json, rgKeyInfo, errorString)) {
+        if (!_validatePlanJson(json, errorString)) {
             qgcApp()->showAppMessage(errorMessage.arg(errorString));
             return;
         }
 
         if (!_missionController.load(json[kJsonMissionObjectKey].toObject(), errorString) ||
-                !_geoFenceController.load(json[kJsonGeoFenceObjectKey].toObject(), errorString) ||
-                !_rallyPointController.load(json[kJsonRallyPointsObjectKey].toObject(), errorString)) {
+                !_loadFenceAndRallyFromJson(json, errorString)) {
             qgcApp()->showAppMessage(errorMessage.arg(errorString));
         } else {
-            //-- Allow plugins to post process the load
-            qgcApp()->toolbox()->corePlugin()->postLoadFromJson(this, json);
             success = true;
         }
     }
 
+    _loadFromFileComplete(fileInfo, success);
+}
+
+void PlanMasterController::loadFromFileAsync(const QString& filename)
+{
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    cancelLoadFromFile();
+
+    const QFileInfo fileInfo(filename);
+    if (fileInfo.suffix() == AppSettings::waypointsFileExtension || fileInfo.suffix() == QStringLiteral("txt")) {
+        // Text files can't hold more than simple items, there is nothing worth loading in the background
+        loadFromFile(filename);
+        emit loadFromFileComplete(!_currentPlanFile.isEmpty());
+        return;
+    }
+
+    qCDebug(PlanMasterControllerLog) << "loadFromFileAsync" << filename;
+
+    _loadFilename = filename;
+    _loadInProgress = true;
+    emit loadInProgressChanged(true);
+    emit loadProgressChanged(loadProgress());
+
+    // A pending save of the same file has to be written before it is read back
+    _planFileWriteWatcher.waitForFinished();
+
+    const quint64 generation = ++_loadGeneration;
+    _planFileReadWatcher.setFuture(QtConcurrent::run([filename, generation]() {
+        return _readPlanFile(filename, generation);
+    }));
+}
+
+void PlanMasterController::cancelLoadFromFile(void)
+{
+    if (!_loadInProgress) {
+        return;
+    }
+
+    qCDebug(PlanMasterControllerLog) << "cancelLoadFromFile" << _loadFilename;
+
+    // A running file read can't be stopped, its result is dropped by generation
+    _loadGeneration++;
+    _missionController.cancelLoad();
+    _loadJson = QJsonObject();
+    _loadFilename.clear();
+    _loadInProgress = false;
+    emit loadInProgressChanged(false);
+    emit loadProgressChanged(loadProgress());
+}
+
+double PlanMasterController::loadProgress(void) const
+{
+    return _loadInProgress ? _missionController.loadProgress() : 0;
+}
+
+/// Reads and parses the file. This doesn't touch the controller so it is safe to run on a worker thread.
+PlanMasterController::PlanFileRead_t PlanMasterController::_readPlanFile(const QString& filename, quint64 generation)
+{
+    PlanFileRead_t result;
+    result.generation = generation;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        result.errorString = file.errorString() + QStringLiteral(" ") + filename;
+        return result;
+    }
+
+    result.success = JsonHelper::isJsonFile(file.readAll(), result.jsonDoc, result.errorString);
+    return result;
+}
+
+void PlanMasterController::_planFileRead(void)
+{
+    const PlanFileRead_t result = _planFileReadWatcher.result();
+    if (!_loadInProgress || (result.generation != _loadGeneration)) {
+        qCDebug(PlanMasterControllerLog) << "_planFileRead dropping stale read" << result.generation << _loadGeneration;
+        return;
+    }
+
+    if (!result.success) {
+        _finishLoadFromFileAsync(false, result.errorString);
+        return;
+    }
+
+    if (QFileInfo(_loadFilename).suffix() == AppSettings::missionFileExtension) {
+        _missionController.loadAsync(result.jsonDoc.object(), true /* missionFile */);
+        return;
+    }
+
+    QString errorString;
+    _loadJson = result.jsonDoc.object();
+    if (!_validatePlanJson(_loadJson, errorString)) {
+        _finishLoadFromFileAsync(false, errorString);
+        return;
+    }
+
+    _missionController.loadAsync(_loadJson[kJsonMissionObjectKey].toObject(), false /* missionFile */);
+}
+
+void PlanMasterController::_missionLoadComplete(bool success, const QString& errorString)
+{
+    if (!_loadInProgress) {
+        return;
+    }
+
+    QString loadErrorString = errorString;
+    if (success && !_loadJson.isEmpty()) {
+        // Fence and rally points are small enough to be loaded in one go
+        success = _loadFenceAndRallyFromJson(_loadJson, loadErrorString);
+    }
+    _finishLoadFromFileAsync(success, loadErrorString);
+}
+
+void PlanMasterController::_finishLoadFromFileAsync(bool success, const QString& errorString)
+{
+    const QFileInfo fileInfo(_loadFilename);
+
+    if (!success) {
+        qgcApp()->showAppMessage(tr("Error loading Plan file (%1). %2").arg(_loadFilename, errorString));
+    }
+
+    _loadJson = QJsonObject();
+    _loadFilename.clear();
+    _loadInProgress = false;
+
+    _loadFromFileComplete(fileInfo, success);
+
+    emit loadInProgressChanged(false);
+    emit loadProgressChanged(loadProgress());
+    emit loadFromFileComplete(success);
+}
+
+/// Validates the plan file and gives plugins the chance to pre process it
+bool PlanMasterController::_validatePlanJson(QJsonObject& json, QString& errorString)
+{
+    //-- Allow plugins to pre process the load
+    qgcApp()->toolbox()->corePlugin()->preLoadFromJson(this, json);
+
+    int version;
+    if (!JsonHelper::validateExternalQGCJsonFile(json, kPlanFileType, kPlanFileVersion, kPlanFileVersion, version, errorString)) {
+        return false;
+    }
+
+    QList<JsonHelper::KeyValidateInfo> rgKeyInfo = {
+        { kJsonMissionObjectKey,        QJsonValue::Object, true },
+        { kJsonGeoFenceObjectKey,       QJsonValue::Object, true },
+        { kJsonRallyPointsObjectKey,    QJsonValue::Object, true },
+    };
+    return JsonHelper::validateKeys(json, rgKeyInfo, errorString);
+}
+
+bool PlanMasterController::_loadFenceAndRallyFromJson(const QJsonObject& json, QString& errorString)
+{
+    if (!_geoFenceController.load(json[kJsonGeoFenceObjectKey].toObject(), errorString) ||
+            !_rallyPointController.load(json[kJsonRallyPointsObjectKey].toObject(), errorString)) {
+        return false;
+    }
+
+    //-- Allow plugins to post process the load
+    qgcApp()->toolbox()->corePlugin()->postLoadFromJson(this, json);
+    return true;
+}
+
+void PlanMasterController::_loadFromFileComplete(const QFileInfo& fileInfo, bool success)
+{
     if(success){
+        // The mission bounds are calculated asynchronously, the terrain prefetch starts once they are available
+        _prefetchTerrain = true;
         _currentPlanFile = QString::asprintf("%s/%s.%s", fileInfo.path().toLocal8Bit().data(), fileInfo.completeBaseName().toLocal8Bit().data(), AppSettings::planFileExtension);
     } else {
         _currentPlanFile.clear();
@@ -410,6 +576,17 @@ void PlanMasterController::loadFromFile(const QString& filename)
     }
 }
 
+void PlanMasterController::_missionBoundingCubeChanged(void)
+{
+    QGCGeoBoundingCube* const boundingCube = _missionController.travelBoundingCube();
+    if (!_prefetchTerrain || !boundingCube->isValid()) {
+        return;
+    }
+
+    _prefetchTerrain = false;
+    TerrainTileManager::instance()->prefetchTiles(boundingCube->pointNW, boundingCube->pointSE);
+}
+
 QJsonDocument PlanMasterController::saveToJson()
 {
     QJsonObject planJson;
@@ -451,19 +628,24 @@ void PlanMasterController::saveToFile(const QString& filename)
         planFilename += QString(".%1").arg(fileExtension());
     }
 
-    QFile file(planFilename);
+    // The json has to be built from the items here, serializing and writing it is left to a worker thread
+    const QJsonDocument saveDoc = saveToJson();
+    _planFileWriteWatcher.waitForFinished();
+    _writeFilename = filename;
+    _planFileWriteWatcher.setFuture(QtConcurrent::run([planFilename, saveDoc]() {
+        QFile file(planFilename);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            return file.errorString();
+        }
+        if (file.write(saveDoc.toJson()) < 0) {
+            return file.errorString();
+        }
+        return QString();
+    }));
 
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qgcApp()->showAppMessage(tr("Plan save error %1 : %2").arg(filename).arg(file.errorString()));
-        _currentPlanFile.clear();
+    if(_currentPlanFile != planFilename) {
+        _currentPlanFile = planFilename;
         emit currentPlanFileChanged();
-    } else {
-        QJsonDocument saveDoc = saveToJson();
-        file.write(saveDoc.toJson());
-        if(_currentPlanFile != planFilename) {
-            _currentPlanFile = planFilename;
-            emit currentPlanFileChanged();
-        }
     }
 
     // Only clear dirty bit if we are offline
@@ -472,6 +654,16 @@ void PlanMasterController::saveToFile(const QString& filename)
     }
 }
 
+void PlanMasterController::_planFileWritten(void)
+{
+    const QString errorString = _planFileWriteWatcher.result();
+    if (!errorString.isEmpty()) {
+        qgcApp()->showAppMessage(tr("Plan save error %1 : %2").arg(_writeFilename).arg(errorString));
+        _currentPlanFile.clear();
+        emit currentPlanFileChanged();
+    }
+}
+
 void PlanMasterController::saveToKml(const QString& filename)
 {
     if (filename.isEmpty()) {
@@ -488,16 +680,26 @@ void PlanMasterController::saveToKml(const QString& filename)
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         qgcApp()->showAppMessage(tr("KML save error %1 : %2").arg(filename).arg(file.errorString()));
     } else {
-        KMLPlanDomDocument planKML;
+        KMLPlanStreamWriter planKML(&file);
         _missionController.addMissionToKML(planKML);
-        QTextStream stream(&file);
-        stream << planKML.toString();
+        if (!_offline && !_managerVehicle->trackRecorder()->fileName().isEmpty()) {
+            // Include the flown track at full resolution
+            QString errorString;
+            if (!_managerVehicle->trackRecorder()->writeKmlTrack(planKML, errorString)) {
+                qCWarning(PlanMasterControllerLog) << "Flight track not added to KML" << errorString;
+            }
+        }
+        planKML.finish();
+        if (planKML.hasError()) {
+            qgcApp()->showAppMessage(tr("KML save error %1 : %2").arg(filename).arg(file.errorString()));
+        }
         file.close();
     }
 }
 
 void PlanMasterController::removeAll(void)
 {
+    cancelLoadFromFile();
     _missionController.removeAll();
     _geoFenceController.removeAll();
     _rallyPointController.removeAll();
@@ -9,8 +9,11 @@
 
 #pragma once
 
-#include <QtCore/QObject>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
 
 #include "MissionController.h"
 #include "GeoFenceController.h"
@@ -18,6 +21,7 @@
 
 Q_DECLARE_LOGGING_CATEGORY(PlanMasterControllerLog)
 
+class QFileInfo;
 class QmlObjectListModel;
 class MultiVehicleManager;
 class Vehicle;
@@ -54,6 +58,8 @@ public:
     Q_PROPERTY(QStringList              loadNameFilters         READ loadNameFilters                        CONSTANT)                       ///< File filter list loading plan files
     Q_PROPERTY(QStringList              saveNameFilters         READ saveNameFilters                        CONSTANT)                       ///< File filter list saving plan files
     Q_PROPERTY(QmlObjectListModel*      planCreators            MEMBER _planCreators                        NOTIFY planCreatorsChanged)
+    Q_PROPERTY(bool                     loadInProgress          READ loadInProgress                         NOTIFY loadInProgressChanged)   ///< true: loadFromFileAsync is running
+    Q_PROPERTY(double                   loadProgress            READ loadProgress                           NOTIFY loadProgressChanged)     ///< Fraction of the mission items built by loadFromFileAsync
 
     /// Should be called immediately upon Component.onCompleted.
     Q_INVOKABLE void start(void);
@@ -78,6 +84,12 @@ public:
     Q_INVOKABLE void loadFromVehicle(void);
     Q_INVOKABLE void sendToVehicle(void);
     Q_INVOKABLE void loadFromFile(const QString& filename);
+
+    /// Loads the plan like loadFromFile, but reads and parses the file on a worker thread and builds the mission
+    /// items over several event loop iterations. loadFromFileComplete is signalled when done.
+    Q_INVOKABLE void loadFromFileAsync(const QString& filename);
+    Q_INVOKABLE void cancelLoadFromFile(void);
+
     Q_INVOKABLE void saveToCurrent();
     Q_INVOKABLE void saveToFile(const QString& filename);
     Q_INVOKABLE void saveToKml(const QString& filename);
@@ -99,6 +111,8 @@ public:
     QStringList loadNameFilters (void) const;
     QStringList saveNameFilters (void) const;
     bool        isEmpty         (void) const;
+    bool        loadInProgress  (void) const { return _loadInProgress; }
+    double      loadProgress    (void) const;
 
     void        setFlyView(bool flyView) { _flyView = flyView; }
 
@@ -122,6 +136,9 @@ signals:
     void planCreatorsChanged                (QmlObjectListModel* planCreators);
     void managerVehicleChanged              (Vehicle* managerVehicle);
     void promptForPlanUsageOnVehicleChange  (void);
+    void loadInProgressChanged              (bool loadInProgress);
+    void loadProgressChanged                (double loadProgress);
+    void loadFromFileComplete               (bool success);
 
 private slots:
     void _activeVehicleChanged      (Vehicle* activeVehicle);
@@ -132,10 +149,27 @@ private slots:
     void _sendGeoFenceComplete      (void);
     void _sendRallyPointsComplete   (void);
     void _updatePlanCreatorsList    (void);
+    void _missionBoundingCubeChanged(void);
+    void _planFileRead              (void);
+    void _planFileWritten           (void);
+    void _missionLoadComplete       (bool success, const QString& errorString);
 
 private:
     void _commonInit                (void);
     void _showPlanFromManagerVehicle(void);
+    bool _validatePlanJson          (QJsonObject& json, QString& errorString);
+    bool _loadFenceAndRallyFromJson (const QJsonObject& json, QString& errorString);
+    void _loadFromFileComplete      (const QFileInfo& fileInfo, bool success);
+    void _finishLoadFromFileAsync   (bool success, const QString& errorString);
+
+    typedef struct {
+        quint64         generation  = 0;
+        bool            success     = false;
+        QJsonDocument   jsonDoc;
+        QString         errorString;
+    } PlanFileRead_t;
+
+    static PlanFileRead_t _readPlanFile(const QString& filename, quint64 generation);
 
     MultiVehicleManager*    _multiVehicleMgr =          nullptr;
     Vehicle*                _controllerVehicle =        nullptr;    ///< Offline controller vehicle
@@ -151,5 +185,13 @@ private:
     bool                    _sendRallyPoints =          false;
     QString                 _currentPlanFile;
     bool                    _deleteWhenSendCompleted =  false;
+    bool                    _prefetchTerrain =          false;  ///< Prefetch terrain once the bounds of a newly loaded plan are known
     QmlObjectListModel*     _planCreators =             nullptr;
+    bool                    _loadInProgress =           false;
+    quint64                 _loadGeneration =           0;      ///< Incremented for each loadFromFileAsync, stale file reads are dropped
+    QString                 _loadFilename;
+    QJsonObject             _loadJson;                          ///< Plan file being loaded, empty for mission files
+    QString                 _writeFilename;
+    QFutureWatcher<PlanFileRead_t>  _planFileReadWatcher;
+    QFutureWatcher<QString>         _planFileWriteWatcher;      ///< Result is the error string, empty on success
 };
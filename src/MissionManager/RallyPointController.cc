@@ -111,7 +111,7 @@ bool RallyPointController::load(const QJsonObject& json, QString& errorString)
     for (int i=0; i<rgPoints.count(); i++) {
         pointList.append(new RallyPoint(rgPoints[i], this));
     }
-    _points.swapObjectList(pointList);
+    _points.swapObjectList(std::move(pointList));
 
     setDirty(false);
     _setFirstPointCurrent();
@@ -209,7 +209,7 @@ void RallyPointController::_managerLoadComplete(void)
         for (int i=0; i<_rallyPointManager->points().count(); i++) {
             pointList.append(new RallyPoint(_rallyPointManager->points()[i], this));
         }
-        _points.swapObjectList(pointList);
+        _points.swapObjectList(std::move(pointList));
         setDirty(false);
         _setFirstPointCurrent();
         emit loadComplete();
@@ -674,10 +674,20 @@ void StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly(void)
         _structurePolygon.setShowAltColor(false);
     }
 
+    // Results of a previous terrain query would go to the segments which are deleted below
+    if (_layerTerrainQuery) {
+        disconnect(_layerTerrainQuery);
+        _layerTerrainQuery = nullptr;
+    }
+    _layerSegments.clear();
+
     _flightPathSegments.beginReset();
     _flightPathSegments.clearAndDeleteContents();
 
     if (_flightPolygon.count() > 2) {
+        // Layer path is the same for all layers, only the altitude changes
+        QList<QGeoCoordinate> layerPath = _flightPolygon.coordinateList();
+        layerPath.append(layerPath.first());
 
         bool    startFromTop =  _startFromTopFact.rawValue().toBool();
         double  startAltitude = (startFromTop ? _structureHeightFact.rawValue().toDouble() : _scanBottomAltFact.rawValue().toDouble());
@@ -706,14 +716,9 @@ void StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly(void)
                 _appendFlightPathSegment(FlightPathSegment::SegmentTypeGeneric, layerEntranceCoord, prevLayerAltitude, layerEntranceCoord, layerAltitude);
             }
 
-            QGeoCoordinate prevCoord = QGeoCoordinate();
-            for (const QGeoCoordinate& coord: _flightPolygon.coordinateList()) {
-                if (prevCoord.isValid()) {
-                    _appendFlightPathSegment(FlightPathSegment::SegmentTypeGeneric, prevCoord, layerAltitude, coord, layerAltitude);
-                }
-                prevCoord = coord;
+            for (int i=0; i<layerPath.count() - 1; i++) {
+                _layerSegments.append(_appendFlightPathSegment(FlightPathSegment::SegmentTypeGeneric, layerPath[i], layerAltitude, layerPath[i + 1], layerAltitude, false /* queryTerrainData */));
             }
-            _appendFlightPathSegment(FlightPathSegment::SegmentTypeGeneric, _flightPolygon.coordinateList().last(), layerAltitude, _flightPolygon.coordinateList().first(), layerAltitude);
 
             // Move to next layer altitude
             prevLayerAltitude = layerAltitude;
@@ -726,6 +731,10 @@ void StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly(void)
 
         // Last layer exit back to entrance
         _appendFlightPathSegment(FlightPathSegment::SegmentTypeGeneric, layerEntranceCoord, prevLayerAltitude, layerEntranceCoord, entranceAlt);
+
+        _layerTerrainQuery = new TerrainPolyPathQuery(true /* autoDelete */);
+        connect(_layerTerrainQuery, &TerrainPolyPathQuery::terrainDataReceived, this, &StructureScanComplexItem::_layerTerrainDataReceived);
+        _layerTerrainQuery->requestData(layerPath);
     }
 
     _flightPathSegments.endReset();
@@ -737,6 +746,21 @@ void StructureScanComplexItem::_updateFlightPathSegmentsDontCallDirectly(void)
     _masterController->missionController()->recalcTerrainProfile();
 }
 
+void StructureScanComplexItem::_layerTerrainDataReceived(bool success, const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo)
+{
+    _layerTerrainQuery = nullptr;
+
+    const int layerSegmentCount = rgPathHeightInfo.count();
+    if (!success || (layerSegmentCount == 0) || (_layerSegments.count() % layerSegmentCount != 0)) {
+        qCDebug(StructureScanComplexItemLog) << "_layerTerrainDataReceived failed" << success << rgPathHeightInfo.count() << _layerSegments.count();
+        return;
+    }
+
+    for (int i=0; i<_layerSegments.count(); i++) {
+        _layerSegments[i]->setTerrainPathHeights(rgPathHeightInfo[i % layerSegmentCount]);
+    }
+}
+
 double StructureScanComplexItem::minAMSLAltitude(void) const
 {
     double minAlt = qMin(bottomFlightAlt(), _entranceAltFact.rawValue().toDouble());
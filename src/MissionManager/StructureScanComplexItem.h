@@ -134,6 +134,7 @@ private slots:
     void _recalcScanDistance                        (void);
     void _updateWizardMode                          (void);
     void _updateFlightPathSegmentsDontCallDirectly  (void);
+    void _layerTerrainDataReceived                  (bool success, const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo);
 
 private:
     void    _setCameraShots                 (int cameraShots);
@@ -152,6 +153,9 @@ private:
     double          _vehicleSpeed;
     CameraCalc      _cameraCalc;
 
+    // Every layer flies the same path at a different altitude, so the terrain below it is queried once for all layers
+    TerrainPolyPathQuery*       _layerTerrainQuery = nullptr;
+    QList<FlightPathSegment*>   _layerSegments;     ///< Segments of all layers, layer by layer in flight polygon order
 
     SettingsFact    _scanBottomAltFact;
     SettingsFact    _structureHeightFact;
@@ -165,4 +169,5 @@ private:
     static constexpr const char* _entranceAltName = "EntranceAltitude"; // This value cannot be overriden
 
     friend class StructureScanComplexItemTest;
+    friend class PlanningGeometryBenchmark;
 };
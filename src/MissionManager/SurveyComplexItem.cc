@@ -20,6 +20,7 @@
 #include "Vehicle.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrent>
 #include <QtGui/QPolygonF>
 #include <QtCore/QJsonArray>
 #include <QtCore/QLineF>
@@ -61,6 +62,11 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::isValidChanged,             this, &SurveyComplexItem::_updateWizardMode);
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::traceModeChanged,           this, &SurveyComplexItem::_updateWizardMode);
 
+    _transectRebuildTimer.setSingleShot(true);
+    _transectRebuildTimer.setInterval(_backgroundRebuildDebounceMsecs);
+    connect(&_transectRebuildTimer,     &QTimer::timeout,                           this, &SurveyComplexItem::_startBackgroundTransectRebuild);
+    connect(&_transectRebuildWatcher,   &QFutureWatcherBase::finished,              this, &SurveyComplexItem::_backgroundTransectsReady);
+
     if (!kmlOrShpFile.isEmpty()) {
         _surveyAreaPolygon.loadKMLOrSHPFile(kmlOrShpFile);
         _surveyAreaPolygon.setDirty(false);
@@ -187,6 +193,8 @@ bool SurveyComplexItem::_loadV4V5(const QJsonObject& complexObject, int sequence
     _ignoreRecalc = !forPresets;
 
     if (!forPresets) {
+        // The loaded transects replace whatever a background rebuild would deliver
+        _cancelBackgroundTransectRebuild();
         setSequenceNumber(sequenceNumber);
 
         if (!_surveyAreaPolygon.loadFromJson(complexObject, true /* required */, errorString)) {
@@ -241,6 +249,7 @@ bool SurveyComplexItem::_loadV3(const QJsonObject& complexObject, int sequenceNu
     }
 
     _ignoreRecalc = true;
+    _cancelBackgroundTransectRebuild();
 
     setSequenceNumber(sequenceNumber);
 
@@ -426,7 +435,7 @@ bool SurveyComplexItem::_gridAngleIsNorthSouthTransects()
     return gridAngle < 45.0 || (gridAngle > 360.0 - 45.0) || (gridAngle > 90.0 + 45.0 && gridAngle < 270.0 - 45.0);
 }
 
-void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects)
+void SurveyComplexItem::_adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects)
 {
     if (transects.count() == 0) {
         return;
@@ -435,10 +444,10 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
     bool reversePoints = false;
     bool reverseTransects = false;
 
-    if (_entryPoint == EntryLocationBottomLeft || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationBottomLeft || entryPoint == EntryLocationBottomRight) {
         reversePoints = true;
     }
-    if (_entryPoint == EntryLocationTopRight || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationTopRight || entryPoint == EntryLocationBottomRight) {
         reverseTransects = true;
     }
 
@@ -451,7 +460,7 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
         _reverseTransectOrder(transects);
     }
 
-    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << _entryPoint;
+    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << entryPoint;
 }
 
 QPointF SurveyComplexItem::_rotatePoint(const QPointF& point, const QPointF& origin, double angle)
@@ -629,51 +638,163 @@ double SurveyComplexItem::_turnaroundDistance(void) const
 
 void SurveyComplexItem::_rebuildTransectsPhase1(void)
 {
-    _rebuildTransectsPhase1WorkerSinglePolygon(false /* refly */);
-    if (_refly90DegreesFact.rawValue().toBool()) {
-        _rebuildTransectsPhase1WorkerSinglePolygon(true /* refly */);
-    }
+    _clearLoadedMissionItems();
+    _cancelBackgroundTransectRebuild();
+
+    _transects = _generateTransects(_transectGenerationParams());
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
+/// Drops any pending or running background rebuild, the current _transects are up to date
+void SurveyComplexItem::_cancelBackgroundTransectRebuild(void)
 {
-    if (_ignoreRecalc) {
-        return;
+    _transectRebuildTimer.stop();
+    _transectGeneration++;
+    _appliedTransectGeneration = _transectGeneration;
+}
+
+bool SurveyComplexItem::_rebuildTransectsPhase1Background(void)
+{
+    // Small polygons are quick enough to rebuild in place. Unit tests need the transects to be available on return.
+    if ((_surveyAreaPolygon.count() < _backgroundRebuildMinVertices) || qgcApp()->runningUnitTests()) {
+        return false;
     }
 
+    _clearLoadedMissionItems();
+
+    // Any result still being computed is stale from now on
+    _transectGeneration++;
+    _transectRebuildTimer.start();
+    emit readyForSaveStateChanged();
+
+    return true;
+}
+
+void SurveyComplexItem::_clearLoadedMissionItems(void)
+{
     // If the transects are getting rebuilt then any previously loaded mission items are now invalid
     if (_loadedMissionItemsParent) {
         _loadedMissionItems.clear();
         _loadedMissionItemsParent->deleteLater();
         _loadedMissionItemsParent = nullptr;
     }
+}
 
-    if (_surveyAreaPolygon.count() < 3) {
+void SurveyComplexItem::_startBackgroundTransectRebuild(void)
+{
+    if (_transectRebuildWatcher.isRunning()) {
+        // _backgroundTransectsReady starts the rebuild again for the latest generation once the running one is done
+        return;
+    }
+
+    const TransectGenerationParams_t params = _transectGenerationParams();
+    const quint64 generation = _transectGeneration;
+    qCDebug(SurveyComplexItemLog) << "_startBackgroundTransectRebuild generation" << generation;
+
+    _transectRebuildWatcher.setFuture(QtConcurrent::run([params, generation]() {
+        return BackgroundTransects_t{ generation, _generateTransects(params) };
+    }));
+}
+
+void SurveyComplexItem::_backgroundTransectsReady(void)
+{
+    const BackgroundTransects_t result = _transectRebuildWatcher.result();
+
+    if (result.generation != _transectGeneration) {
+        qCDebug(SurveyComplexItemLog) << "_backgroundTransectsReady dropping stale generation" << result.generation << _transectGeneration;
+        if ((_appliedTransectGeneration != _transectGeneration) && !_transectRebuildTimer.isActive()) {
+            _startBackgroundTransectRebuild();
+        }
+        return;
+    }
+
+    _appliedTransectGeneration = result.generation;
+    _setBackgroundTransects(result.transects);
+    emit readyForSaveStateChanged();
+}
+
+/// Takes the settings saved from another survey along with one vehicle's share of its survey area and the transects
+/// already generated for that share
+void SurveyComplexItem::_setPartition(const QJsonObject& sourceObject, const QList<QGeoCoordinate>& polygon, const QList<QList<CoordInfo_t>>& transects)
+{
+    QString errorString;
+    if (!_loadV4V5(sourceObject, sequenceNumber(), errorString, 5, true /* forPresets */)) {
+        qCWarning(SurveyComplexItemLog) << "_setPartition load failed" << errorString;
+    }
+
+    _ignoreRecalc = true;
+    _surveyAreaPolygon.setPath(polygon);
+    _ignoreRecalc = false;
+
+    _clearLoadedMissionItems();
+    _cancelBackgroundTransectRebuild();
+    _setBackgroundTransects(transects);
+    setDirty(true);
+}
+
+SurveyComplexItem::TransectGenerationParams_t SurveyComplexItem::_transectGenerationParams(void) const
+{
+    TransectGenerationParams_t params;
+
+    params.polygon                  = _surveyAreaPolygon.coordinateList();
+    params.gridAngle                = _gridAngleFact.rawValue().toDouble();
+    params.gridSpacing              = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    params.entryPoint               = _entryPoint;
+    params.flyAlternateTransects    = _flyAlternateTransectsFact.rawValue().toBool();
+    params.refly90Degrees           = _refly90DegreesFact.rawValue().toBool();
+    params.hoverAndCapture          = triggerCamera() && hoverAndCaptureEnabled();
+    params.triggerDistance          = triggerDistance();
+    params.turnAroundDistance       = _turnAroundDistanceFact.rawValue().toDouble();
+
+    return params;
+}
+
+/// Generates the transects from a snapshot of the survey settings. This doesn't touch the item so it is safe to
+/// run on a worker thread.
+QList<QList<TransectStyleComplexItem::CoordInfo_t>> SurveyComplexItem::_generateTransects(const TransectGenerationParams_t& params)
+{
+    QList<QList<CoordInfo_t>> coordInfoTransects;
+
+    _appendTransectsSinglePolygon(params, false /* refly */, coordInfoTransects);
+    if (params.refly90Degrees) {
+        _appendTransectsSinglePolygon(params, true /* refly */, coordInfoTransects);
+    }
+
+    return coordInfoTransects;
+}
+
+void SurveyComplexItem::_appendTransectsSinglePolygon(const TransectGenerationParams_t& params, bool refly, QList<QList<CoordInfo_t>>& coordInfoTransects)
+{
+    if (params.polygon.count() < 3) {
         return;
     }
 
     // Convert polygon to NED
 
+    const qsizetype vertexCount = params.polygon.count();
+    QGeoCoordinate tangentOrigin = params.polygon.first();
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << vertexCount << tangentOrigin;
+
+    QList<double> vertexLats(vertexCount);
+    QList<double> vertexLons(vertexCount);
+    for (qsizetype i=0; i<vertexCount; i++) {
+        vertexLats[i] = params.polygon[i].latitude();
+        vertexLons[i] = params.polygon[i].longitude();
+    }
+    QList<double> vertexNorths(vertexCount);
+    QList<double> vertexEasts(vertexCount);
+    QGCGeo::convertGeoToNed(vertexLats.constData(), vertexLons.constData(), nullptr, vertexCount, tangentOrigin, vertexNorths.data(), vertexEasts.data(), nullptr);
+
     QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
-        double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
-        if (i == 0) {
-            // This avoids a nan calculation that comes out of convertGeoToNed
-            x = y = 0;
-        } else {
-            QGCGeo::convertGeoToNed(vertex, tangentOrigin, y, x, down);
-        }
-        polygonPoints += QPointF(x, y);
-        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertex << polygonPoints.last().x() << polygonPoints.last().y();
+    polygonPoints.reserve(vertexCount);
+    for (qsizetype i=0; i<vertexCount; i++) {
+        polygonPoints += QPointF(vertexEasts[i], vertexNorths[i]);
+        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << params.polygon[i] << polygonPoints.last().x() << polygonPoints.last().y();
     }
 
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    double gridAngle = params.gridAngle;
+    double gridSpacing = params.gridSpacing;
     if (gridSpacing < 0.5) {
         // We can't let gridSpacing get too small otherwise we will end up with too many transects.
         // So we limit to 0.5 meter spacing as min and set to huge value which will cause a single
@@ -733,7 +854,6 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -749,27 +869,34 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     QList<QLineF> resultLines;
     _adjustLineDirection(intersectLines, resultLines);
 
-    // Convert from NED to Geo
+    // Convert from NED to Geo, both ends of all lines in one batch
+    const qsizetype pointCount = resultLines.count() * 2;
+    QList<double> pointNorths(pointCount);
+    QList<double> pointEasts(pointCount);
+    for (qsizetype i=0; i<resultLines.count(); i++) {
+        pointNorths[i * 2]      = resultLines[i].p1().y();
+        pointEasts[i * 2]       = resultLines[i].p1().x();
+        pointNorths[i * 2 + 1]  = resultLines[i].p2().y();
+        pointEasts[i * 2 + 1]   = resultLines[i].p2().x();
+    }
+    QList<double> pointLats(pointCount);
+    QList<double> pointLons(pointCount);
+    QGCGeo::convertNedToGeo(pointNorths.constData(), pointEasts.constData(), nullptr, pointCount, tangentOrigin, pointLats.data(), pointLons.data(), nullptr);
+
+    // Down is 0, so the altitude is the origin altitude as with the single coordinate conversion
     QList<QList<QGeoCoordinate>> transects;
-    for (const QLineF& line : resultLines) {
-        QGeoCoordinate          coord;
-        QList<QGeoCoordinate>   transect;
-
-        QGCGeo::convertNedToGeo(line.p1().y(), line.p1().x(), 0, tangentOrigin, coord);
-        transect.append(coord);
-        QGCGeo::convertNedToGeo(line.p2().y(), line.p2().x(), 0, tangentOrigin, coord);
-        transect.append(coord);
-
-        transects.append(transect);
+    transects.reserve(resultLines.count());
+    for (qsizetype i=0; i<pointCount; i+=2) {
+        transects.append({ QGeoCoordinate(pointLats[i], pointLons[i], tangentOrigin.altitude()), QGeoCoordinate(pointLats[i + 1], pointLons[i + 1], tangentOrigin.altitude()) });
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(params.entryPoint, transects);
 
-    if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+    if (refly && !coordInfoTransects.isEmpty()) {
+        _optimizeTransectsForShortestDistance(coordInfoTransects.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (params.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -802,7 +929,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Convert to CoordInfo transects and append to coordInfoTransects
     for (const QList<QGeoCoordinate>& transect : transects) {
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
@@ -814,14 +941,14 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (params.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (params.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / params.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(params.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, coordInfo);
                 }
@@ -829,9 +956,9 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (params.turnAroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = params.turnAroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -846,7 +973,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        coordInfoTransects.append(coordInfoTransect);
     }
 }
 
@@ -1170,7 +1297,7 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(_entryPoint, transects);
 
     if (refly) {
         _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
@@ -1304,17 +1431,26 @@ void SurveyComplexItem::_recalcCameraShots(void)
 
                 }
             } else {
-                // We have transects available, calc from those
-                for (const QList<TransectStyleComplexItem::CoordInfo_t>& transect: _transects) {
-                    QGeoCoordinate firstCameraCoord, lastCameraCoord;
-                    if (_hasTurnaround() && !hoverAndCaptureEnabled()) {
-                        firstCameraCoord = transect[1].coord;
-                        lastCameraCoord = transect[transect.count() - 2].coord;
-                    } else {
-                        firstCameraCoord = transect.first().coord;
-                        lastCameraCoord = transect.last().coord;
+                // We have transects available, calc from those. The distances only change with the transects, so a new
+                // trigger distance doesn't need to go through the transects again.
+                if (_transectCameraDistancesRevision != _transectsRevision) {
+                    _transectCameraDistances.clear();
+                    _transectCameraDistances.reserve(_transects.count());
+                    for (const QList<TransectStyleComplexItem::CoordInfo_t>& transect: _transects) {
+                        QGeoCoordinate firstCameraCoord, lastCameraCoord;
+                        if (_hasTurnaround() && !hoverAndCaptureEnabled()) {
+                            firstCameraCoord = transect[1].coord;
+                            lastCameraCoord = transect[transect.count() - 2].coord;
+                        } else {
+                            firstCameraCoord = transect.first().coord;
+                            lastCameraCoord = transect.last().coord;
+                        }
+                        _transectCameraDistances.append(firstCameraCoord.distanceTo(lastCameraCoord));
                     }
-                    _cameraShots += qCeil(firstCameraCoord.distanceTo(lastCameraCoord) / triggerDistance);
+                    _transectCameraDistancesRevision = _transectsRevision;
+                }
+                for (const double cameraDistance: _transectCameraDistances) {
+                    _cameraShots += qCeil(cameraDistance / triggerDistance);
                 }
             }
         }
@@ -1325,6 +1461,10 @@ void SurveyComplexItem::_recalcCameraShots(void)
 
 SurveyComplexItem::ReadyForSaveState SurveyComplexItem::readyForSaveState(void) const
 {
+    if (_appliedTransectGeneration != _transectGeneration) {
+        // Transects are still being rebuilt in the background
+        return NotReadyForSaveData;
+    }
     return TransectStyleComplexItem::readyForSaveState();
 }
 
@@ -12,7 +12,9 @@
 #include "TransectStyleComplexItem.h"
 #include "SettingsFact.h"
 
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
 
 Q_DECLARE_LOGGING_CATEGORY(SurveyComplexItemLog)
 
@@ -93,6 +95,9 @@ private slots:
     void _rebuildTransectsPhase1        (void) final;
     void _recalcCameraShots             (void) final;
 
+    void _startBackgroundTransectRebuild(void);
+    void _backgroundTransectsReady      (void);
+
 private:
     enum CameraTriggerCode {
         CameraTriggerNone,
@@ -101,21 +106,46 @@ private:
         CameraTriggerHoverAndCapture
     };
 
-    QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
-    void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
-    void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
-    void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
+    /// Snapshot of everything transect generation depends on, so it can run away from the item
+    struct TransectGenerationParams_t {
+        QList<QGeoCoordinate>   polygon;
+        double                  gridAngle               = 0;
+        double                  gridSpacing             = 0;
+        int                     entryPoint              = EntryLocationTopLeft;
+        bool                    flyAlternateTransects   = false;
+        bool                    refly90Degrees          = false;
+        bool                    hoverAndCapture         = false;
+        double                  triggerDistance         = 0;
+        double                  turnAroundDistance      = 0;
+    };
+
+    struct BackgroundTransects_t {
+        quint64                     generation = 0;
+        QList<QList<CoordInfo_t>>   transects;
+    };
+
+    bool _rebuildTransectsPhase1Background(void) final;
+    void _clearLoadedMissionItems(void);
+    void _cancelBackgroundTransectRebuild(void);
+    TransectGenerationParams_t _transectGenerationParams(void) const;
+    static QList<QList<CoordInfo_t>> _generateTransects(const TransectGenerationParams_t& params);
+    static void _appendTransectsSinglePolygon(const TransectGenerationParams_t& params, bool refly, QList<QList<CoordInfo_t>>& coordInfoTransects);
+
+    static QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
+    static void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
+    static void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
+    static void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
     bool _nextTransectCoord(const QList<QGeoCoordinate>& transectPoints, int pointIndex, QGeoCoordinate& coord);
     bool _appendMissionItemsWorker(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, bool hasRefly, bool buildRefly);
-    void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
+    static void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
     qreal _ccw(QPointF pt1, QPointF pt2, QPointF pt3);
     qreal _dp(QPointF pt1, QPointF pt2);
     void _swapPoints(QList<QPointF>& points, int index1, int index2);
-    void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
-    void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
-    void _adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
+    static void _adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects);
     bool _gridAngleIsNorthSouthTransects();
-    double _clampGridAngle90(double gridAngle);
+    static double _clampGridAngle90(double gridAngle);
     bool _imagesEverywhere(void) const;
     bool _triggerCamera(void) const;
     bool _hasTurnaround(void) const;
@@ -125,7 +155,7 @@ private:
     bool _loadV4V5(const QJsonObject& complexObject, int sequenceNumber, QString& errorString, int version, bool forPresets);
     void _saveCommon(QJsonObject& complexObject);
     void _rebuildTransectsPhase1Worker(bool refly);
-    void _rebuildTransectsPhase1WorkerSinglePolygon(bool refly);
+    void _setPartition(const QJsonObject& sourceObject, const QList<QGeoCoordinate>& polygon, const QList<QList<CoordInfo_t>>& transects);
     /// Adds to the _transects array from one polygon
     void _rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint);
 
@@ -149,6 +179,17 @@ private:
     SettingsFact    _splitConcavePolygonsFact;
     int             _entryPoint;
 
+    QTimer                                  _transectRebuildTimer;          ///< Debounces background rebuilds
+    QFutureWatcher<BackgroundTransects_t>   _transectRebuildWatcher;
+    quint64                                 _transectGeneration         = 0;    ///< Incremented for each requested rebuild
+    quint64                                 _appliedTransectGeneration  = 0;    ///< Generation _transects was built for
+
+    QList<double>   _transectCameraDistances;                   ///< Distance flown with the camera on for each transect, only depends on the transects
+    int             _transectCameraDistancesRevision    = -1;   ///< _transectsRevision _transectCameraDistances was built for
+
+    static constexpr int _backgroundRebuildMinVertices  = 32;
+    static constexpr int _backgroundRebuildDebounceMsecs = 100;
+
     static constexpr const char* _jsonGridAngleKey =          "angle";
     static constexpr const char* _jsonEntryPointKey =         "entryLocation";
 
@@ -179,4 +220,7 @@ private:
     static constexpr const char* _jsonV3Refly90DegreesKey =               "refly90Degrees";
     static constexpr const char* _jsonFlyAlternateTransectsKey =          "flyAlternateTransects";
     static constexpr const char* _jsonSplitConcavePolygonsKey =           "splitConcavePolygons";
+
+    friend class PlanningGeometryBenchmark;
+    friend class MultiVehicleSurveyPlanner;
 };
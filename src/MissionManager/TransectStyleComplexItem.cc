@@ -17,7 +17,7 @@
 #include "MissionCommandUIInfo.h"
 #include "QGC.h"
 #include "FirmwarePlugin.h"
-#include "KMLPlanDomDocument.h"
+#include "KMLPlanStreamWriter.h"
 #include "Vehicle.h"
 #include "QGCLoggingCategory.h"
 
@@ -54,7 +54,7 @@ TransectStyleComplexItem::TransectStyleComplexItem(PlanMasterController* masterC
     connect(&_surveyAreaPolygon,                        &QGCMapPolygon::pathChanged,        this, &TransectStyleComplexItem::_rebuildTransects);
     connect(&_cameraTriggerInTurnAroundFact,            &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
     connect(_cameraCalc.adjustedFootprintSide(),        &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(_cameraCalc.adjustedFootprintFrontal(),     &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
+    connect(_cameraCalc.adjustedFootprintFrontal(),     &Fact::valueChanged,                this, &TransectStyleComplexItem::_triggerDistanceChanged);
     connect(_cameraCalc.distanceToSurface(),            &Fact::rawValueChanged,             this, &TransectStyleComplexItem::_rebuildTransects);
     connect(&_cameraCalc,                               &CameraCalc::distanceModeChanged,   this, &TransectStyleComplexItem::_rebuildTransects);
 
@@ -389,11 +389,50 @@ void TransectStyleComplexItem::_rebuildTransects(void)
         return;
     }
 
+    if (_rebuildTransectsPhase1Background()) {
+        // The current transects stay in place until _setBackgroundTransects delivers the new ones
+        return;
+    }
+
     _transects.clear();
     _rgPathHeightInfo.clear();
     _rgFlightPathCoordInfo.clear();
 
     _rebuildTransectsPhase1();
+    _rebuildTransectsPhase2();
+}
+
+void TransectStyleComplexItem::_setBackgroundTransects(const QList<QList<CoordInfo_t>>& transects)
+{
+    _transects = transects;
+    _rgPathHeightInfo.clear();
+    _rgFlightPathCoordInfo.clear();
+
+    _rebuildTransectsPhase2();
+}
+
+/// Trigger distance only shapes the transects when hovering for each image or when camera triggering is switched on or
+/// off. Otherwise just the shot count changes, so dragging the overlap doesn't rebuild the transects each step.
+void TransectStyleComplexItem::_triggerDistanceChanged(void)
+{
+    if (_loadedMissionItemsParent || hoverAndCaptureEnabled() || (triggerCamera() != _transectsTriggerCamera)) {
+        _rebuildTransects();
+        return;
+    }
+
+    if (_ignoreRecalc) {
+        return;
+    }
+
+    _recalcCameraShots();
+    emit timeBetweenShotsChanged();
+}
+
+/// Builds the flight path and updates everything which depends on it from the new _transects
+void TransectStyleComplexItem::_rebuildTransectsPhase2(void)
+{
+    _transectsRevision++;
+    _transectsTriggerCamera = triggerCamera();
 
     _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
@@ -1309,16 +1348,14 @@ void TransectStyleComplexItem::_appendLoadedMissionItems(QList<MissionItem*>& it
     }
 }
 
-void TransectStyleComplexItem::addKMLVisuals(KMLPlanDomDocument& domDocument)
+void TransectStyleComplexItem::addKMLVisuals(KMLPlanStreamWriter& kml)
 {
     // We add the survey area polygon as a Placemark
 
-    QDomElement placemarkElement = domDocument.addPlacemark(QStringLiteral("Survey Area"), true);
-    QDomElement polygonElement = _surveyAreaPolygon.kmlPolygonElement(domDocument);
-
-    placemarkElement.appendChild(polygonElement);
-    domDocument.addTextElement(placemarkElement, "styleUrl", QStringLiteral("#%1").arg(domDocument.surveyPolygonStyleName));
-    domDocument.appendChildToRoot(placemarkElement);
+    kml.writeStartPlacemark(QStringLiteral("Survey Area"), true);
+    _surveyAreaPolygon.writeKmlPolygon(kml);
+    kml.writeTextElement("styleUrl", QStringLiteral("#%1").arg(KMLPlanStreamWriter::surveyPolygonStyleName));
+    kml.writeEndElement();
 }
 
 void TransectStyleComplexItem::_recalcComplexDistance(void)
@@ -77,7 +77,7 @@ public:
     int     lastSequenceNumber  (void) const final;
     QString mapVisualQML        (void) const override = 0;
     bool    load                (const QJsonObject& complexObject, int sequenceNumber, QString& errorString) override = 0;
-    void    addKMLVisuals       (KMLPlanDomDocument& domDocument) final;
+    void    addKMLVisuals       (KMLPlanStreamWriter& kml) final;
     double  complexDistance     (void) const final { return _complexDistance; }
     double  greatestDistanceTo  (const QGeoCoordinate &other) const final;
 
@@ -133,9 +133,15 @@ protected slots:
     void _polyPathTerrainData               (bool success, const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo);
     void _missionItemCoordTerrainData       (bool success, QList<double> heights);
     void _rebuildTransects                  (void);
+    void _triggerDistanceChanged            (void);
 
 protected:
     virtual void _rebuildTransectsPhase1    (void) = 0; ///< Rebuilds the _transects array
+
+    /// Allows a derived class to compute the transects on a worker thread instead of in _rebuildTransectsPhase1.
+    /// Once they are ready the derived class hands them over through _setBackgroundTransects.
+    ///     @return true: rebuild was started in the background
+    virtual bool _rebuildTransectsPhase1Background(void) { return false; }
     virtual void _recalcCameraShots         (void) = 0;
 
     void    _save                           (QJsonObject& saveObject);
@@ -153,6 +159,7 @@ protected:
     void    _buildAndAppendMissionItems     (QList<MissionItem*>& items, QObject* missionItemParent);
     void    _appendLoadedMissionItems       (QList<MissionItem*>& items, QObject* missionItemParent);
     void    _recalcComplexDistance          (void);
+    void    _rebuildTransectsPhase2         (void);
 
     int                 _sequenceNumber = 0;
     QGeoCoordinate      _coordinate;
@@ -173,14 +180,18 @@ protected:
         CoordType       coordType;
     } CoordInfo_t;
 
+    void _setBackgroundTransects(const QList<QList<CoordInfo_t>>& transects);
+
     QVariantList                                _visualTransectPoints;                          ///< Used to draw the flight path visuals on the screen
     QList<QList<CoordInfo_t>>                   _transects;
+    int                                         _transectsRevision = 0;                         ///< Incremented whenever _transects is rebuilt
     QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;                              ///< Path height for each segment includes turn segments
     QList<QGeoCoordinate>                       _rgFlyThroughMissionItemCoords;
     QList<double>                               _rgFlyThroughMissionItemCoordsTerrainHeights;
     QList<CoordInfo_t>                          _rgFlightPathCoordInfo;                         ///< Fully calculated flight path (including terrain if needed)
 
     bool            _ignoreRecalc =     false;
+    bool            _transectsTriggerCamera = false;    ///< triggerCamera() as of the last transect rebuild
     double          _complexDistance =  qQNaN();
     int             _cameraShots =      0;
     double          _timeBetweenShots = 0;
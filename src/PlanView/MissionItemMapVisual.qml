@@ -24,6 +24,7 @@ Item {
     property var map        ///< Map control to place item in
     property var vehicle    ///< Vehicle associated with this item
     property var interactive: true    ///< Vehicle associated with this item
+    property bool batched: false      ///< true: simple items are drawn by a MapMarkerBatch unless they are the current item
 
     signal clicked(int sequenceNumber)
 
@@ -35,7 +36,11 @@ Item {
             if (component.status === Component.Error) {
                 console.log("Error loading Qml: ", object.mapVisualQML, component.errorString())
             }
-            _visualItem = component.createObject(map, { "map": _root.map, vehicle: _root.vehicle, 'opacity': Qt.binding(function() { return _root.opacity }), 'interactive': Qt.binding(function() { return _root.interactive }) })
+            var properties = { "map": _root.map, vehicle: _root.vehicle, 'opacity': Qt.binding(function() { return _root.opacity }), 'interactive': Qt.binding(function() { return _root.interactive }) }
+            if (object.isSimpleItem) {
+                properties["batched"] = Qt.binding(function() { return _root.batched })
+            }
+            _visualItem = component.createObject(map, properties)
             _visualItem.clicked.connect(_root.clicked)
         }
     }
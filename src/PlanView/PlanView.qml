@@ -261,6 +261,17 @@ Item {
         }
     }
 
+    Connections {
+        target: _planMasterController
+
+        function onLoadFromFileComplete(success) {
+            if (success) {
+                _planMasterController.fitViewportToItems()
+                _missionController.setCurrentPlanViewSeqNum(0, true)
+            }
+        }
+    }
+
     function insertSimpleItemAfterCurrent(coordinate) {
         var nextIndex = _missionController.currentPlanViewVIIndex + 1
         _missionController.insertSimpleMissionItem(coordinate, nextIndex, true /* makeCurrentItem */)
@@ -319,9 +330,7 @@ Item {
         }
 
         onAcceptedForLoad: (file) => {
-            _planMasterController.loadFromFile(file)
-            _planMasterController.fitViewportToItems()
-            _missionController.setCurrentPlanViewSeqNum(0, true)
+            _planMasterController.loadFromFileAsync(file)
             close()
         }
     }
@@ -414,10 +423,36 @@ Item {
                     opacity:     _editingLayer == _layerMission || _editingLayer == _layerUTMSP ? 1 : editorMap._nonInteractiveOpacity
                     interactive: _editingLayer == _layerMission || _editingLayer == _layerUTMSP
                     vehicle:     _planMasterController.controllerVehicle
+                    batched:     missionMarkerBatch.active
                     onClicked:   (sequenceNumber) => { _missionController.setCurrentPlanViewSeqNum(sequenceNumber, false) }
                 }
             }
 
+            // Reference overlays from KML or SHP files, below all other map items
+            MapOverlayItem {
+                anchors.fill:   parent
+                map:            editorMap
+                z:              QGroundControl.zOrderMapItems - 2
+            }
+
+            // Large missions draw their simple items as a single batch, only the current item gets the full visuals
+            MapMarkerBatch {
+                id:             missionMarkerBatch
+                anchors.fill:   parent
+                map:            editorMap
+                model:          _missionController.visualItems
+                visibleRoles:   [ "isSimpleItem", "specifiesCoordinate" ]
+                color:          QGroundControl.globalPalette.mapIndicator
+                borderColor:    "white"
+                markerSize:     ScreenTools.defaultFontPixelHeight
+                threshold:      200
+                opacity:        _editingLayer == _layerMission || _editingLayer == _layerUTMSP ? 1 : editorMap._nonInteractiveOpacity
+                enabled:        _editingLayer == _layerMission || _editingLayer == _layerUTMSP
+                z:              QGroundControl.zOrderMapItems - 1
+
+                onClicked: (row) => { _missionController.setCurrentPlanViewSeqNum(_missionController.visualItems.get(row).sequenceNumber, false) }
+            }
+
             // Add lines between waypoints
             MissionLineView {
                 showSpecialVisual:  _missionController.isROIBeginCurrentItem
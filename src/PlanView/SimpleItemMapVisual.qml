@@ -25,6 +25,7 @@ Item {
     property var map        ///< Map control to place item in
     property var vehicle    ///< Vehicle associated with this item
     property bool interactive: true
+    property bool batched:     false    ///< true: a MapMarkerBatch draws this item unless it is the current item
 
     property var    _missionItem:       object
     property var    _itemVisual
@@ -75,11 +76,21 @@ Item {
         }
     }
 
+    function updateItemVisuals() {
+        if (!batched || _missionItem.isCurrentItem) {
+            showItemVisuals()
+        } else {
+            hideItemVisuals()
+        }
+    }
+
     Component.onCompleted: {
-        showItemVisuals()
+        updateItemVisuals()
         updateDragArea()
     }
 
+    onBatchedChanged: updateItemVisuals()
+
     Component.onDestruction: {
         hideDragArea()
         hideItemVisuals()
@@ -89,7 +100,7 @@ Item {
     Connections {
         target: _missionItem
 
-        function onIsCurrentItemChanged() {         updateDragArea() }
+        function onIsCurrentItemChanged() {         updateItemVisuals(); updateDragArea() }
         function onSpecifiesCoordinateChanged() {   updateDragArea() }
     }
 
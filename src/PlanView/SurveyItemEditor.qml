@@ -106,7 +106,7 @@ TransectStyleComplexItemEditor {
         title:          qsTr("Select Polygon File")
 
         onAcceptedForLoad: (file) => {
-            missionItem.surveyAreaPolygon.loadKMLOrSHPFile(file)
+            missionItem.surveyAreaPolygon.loadKMLOrSHPFileAsync(file)
             missionItem.resetState = false
             //editorMap.mapFitFunctions.fitMapViewportTomissionItems()
             close()
@@ -0,0 +1,257 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GCSMotionEstimator.h"
+#include "QGCGeo.h"
+
+#include <QtCore/QtMath>
+#include <QtPositioning/QGeoPositionInfo>
+
+#include <chrono>
+
+void GCSMotionEstimator::Axis::init(double position, double variance)
+{
+    x[0] = position;
+    x[1] = 0;
+    x[2] = 0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            P[i][j] = 0;
+        }
+    }
+    P[0][0] = variance;
+    P[1][1] = _initialVelocityStdDev * _initialVelocityStdDev;
+    P[2][2] = _initialAccelStdDev * _initialAccelStdDev;
+}
+
+void GCSMotionEstimator::Axis::predict(double dt, double jerkDensity)
+{
+    if (dt <= 0) {
+        return;
+    }
+
+    const double dt2 = dt * dt;
+    const double dt3 = dt2 * dt;
+    const double F[3][3] = {
+        { 1, dt, dt2 / 2 },
+        { 0, 1,  dt },
+        { 0, 0,  1 },
+    };
+
+    x[0] += (x[1] * dt) + (x[2] * dt2 / 2);
+    x[1] += x[2] * dt;
+
+    // P = F P F' + Q
+    double FP[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            FP[i][j] = (F[i][0] * P[0][j]) + (F[i][1] * P[1][j]) + (F[i][2] * P[2][j]);
+        }
+    }
+    const double Q[3][3] = {
+        { dt3 * dt2 / 20,   dt2 * dt2 / 8,  dt3 / 6 },
+        { dt2 * dt2 / 8,    dt3 / 3,        dt2 / 2 },
+        { dt3 / 6,          dt2 / 2,        dt },
+    };
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            P[i][j] = (FP[i][0] * F[j][0]) + (FP[i][1] * F[j][1]) + (FP[i][2] * F[j][2]) + (Q[i][j] * jerkDensity);
+        }
+    }
+}
+
+void GCSMotionEstimator::Axis::update(int index, double measurement, double variance)
+{
+    const double S = P[index][index] + variance;
+    if (S <= 0) {
+        return;
+    }
+
+    double K[3];
+    for (int i = 0; i < 3; i++) {
+        K[i] = P[i][index] / S;
+    }
+
+    const double innovation = measurement - x[index];
+    for (int i = 0; i < 3; i++) {
+        x[i] += K[i] * innovation;
+    }
+
+    // P = (I - K H) P, H selects index
+    double row[3];
+    for (int j = 0; j < 3; j++) {
+        row[j] = P[index][j];
+    }
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            P[i][j] -= K[i] * row[j];
+        }
+    }
+}
+
+void GCSMotionEstimator::reset()
+{
+    _valid = false;
+    _altitudeValid = false;
+    _origin = QGeoCoordinate();
+    _timeMsecs = 0;
+}
+
+void GCSMotionEstimator::_predictTo(qint64 msecs)
+{
+    const double dt = (msecs - _timeMsecs) / 1000.0;
+    if (dt <= 0) {
+        return;
+    }
+
+    _axes[0].predict(dt, _horizontalJerkDensity);
+    _axes[1].predict(dt, _horizontalJerkDensity);
+    if (_altitudeValid) {
+        _axes[2].predict(dt, _verticalJerkDensity);
+    }
+    _timeMsecs = msecs;
+}
+
+void GCSMotionEstimator::updatePosition(qint64 msecs, const QGeoCoordinate& coordinate, double horizontalStdDev, double verticalStdDev)
+{
+    if (!coordinate.isValid()) {
+        return;
+    }
+
+    if (qIsNaN(horizontalStdDev) || horizontalStdDev <= 0) {
+        horizontalStdDev = _defaultHorizontalStdDev;
+    }
+    const double horizontalVariance = horizontalStdDev * horizontalStdDev;
+    const bool haveAltitude = !qIsNaN(coordinate.altitude());
+    if (qIsNaN(verticalStdDev) || verticalStdDev <= 0) {
+        verticalStdDev = horizontalStdDev * _unknownVerticalFactor;
+    }
+
+    if (_valid && ((msecs - _timeMsecs) > _resetGapMsecs || _origin.distanceTo(coordinate) > _reoriginDistance)) {
+        reset();
+    }
+
+    const QGeoCoordinate flatCoordinate(coordinate.latitude(), coordinate.longitude(), 0);
+    if (!_valid) {
+        _origin = flatCoordinate;
+        _timeMsecs = msecs;
+        _axes[0].init(0, horizontalVariance);
+        _axes[1].init(0, horizontalVariance);
+        _valid = true;
+    } else {
+        _predictTo(msecs);
+        double north, east, down;
+        QGCGeo::convertGeoToNed(flatCoordinate, _origin, north, east, down);
+        _axes[0].update(0, north, horizontalVariance);
+        _axes[1].update(0, east, horizontalVariance);
+    }
+
+    if (haveAltitude) {
+        const double verticalVariance = verticalStdDev * verticalStdDev;
+        if (_altitudeValid) {
+            _axes[2].update(0, coordinate.altitude(), verticalVariance);
+        } else {
+            _axes[2].init(coordinate.altitude(), verticalVariance);
+            _altitudeValid = true;
+        }
+    }
+}
+
+void GCSMotionEstimator::updateVelocity(qint64 msecs, double north, double east, double verticalSpeed)
+{
+    if (!_valid) {
+        return;
+    }
+
+    _predictTo(msecs);
+    const double variance = _velocityStdDev * _velocityStdDev;
+    _axes[0].update(1, north, variance);
+    _axes[1].update(1, east, variance);
+    if (_altitudeValid && !qIsNaN(verticalSpeed)) {
+        _axes[2].update(1, verticalSpeed, variance);
+    }
+}
+
+void GCSMotionEstimator::update(qint64 msecs, const QGeoPositionInfo& info)
+{
+    if (!info.isValid()) {
+        return;
+    }
+
+    const double horizontalStdDev = info.hasAttribute(QGeoPositionInfo::HorizontalAccuracy) ? info.attribute(QGeoPositionInfo::HorizontalAccuracy) : qQNaN();
+    const double verticalStdDev = info.hasAttribute(QGeoPositionInfo::VerticalAccuracy) ? info.attribute(QGeoPositionInfo::VerticalAccuracy) : qQNaN();
+    updatePosition(msecs, info.coordinate(), horizontalStdDev, verticalStdDev);
+
+    if (info.hasAttribute(QGeoPositionInfo::GroundSpeed) && info.hasAttribute(QGeoPositionInfo::Direction)) {
+        const double direction = qDegreesToRadians(info.attribute(QGeoPositionInfo::Direction));
+        const double speed = info.attribute(QGeoPositionInfo::GroundSpeed);
+        const double verticalSpeed = info.hasAttribute(QGeoPositionInfo::VerticalSpeed) ? info.attribute(QGeoPositionInfo::VerticalSpeed) : qQNaN();
+        updateVelocity(msecs, cos(direction) * speed, sin(direction) * speed, verticalSpeed);
+    }
+}
+
+GCSMotionEstimator::Estimate_t GCSMotionEstimator::estimate(qint64 msecs) const
+{
+    Estimate_t estimate;
+    if (!_valid) {
+        return estimate;
+    }
+
+    estimate.valid = true;
+    estimate.timestampMsecs = _timeMsecs;
+    QGCGeo::convertNedToGeo(_axes[0].x[0], _axes[1].x[0], 0, _origin, estimate.coordinate);
+    estimate.velocity[0] = _axes[0].x[1];
+    estimate.velocity[1] = _axes[1].x[1];
+    estimate.acceleration[0] = _axes[0].x[2];
+    estimate.acceleration[1] = _axes[1].x[2];
+    estimate.positionStdDev[0] = qSqrt(_axes[0].P[0][0]);
+    estimate.positionStdDev[1] = qSqrt(_axes[1].P[0][0]);
+    estimate.altitudeValid = _altitudeValid;
+    if (_altitudeValid) {
+        estimate.coordinate.setAltitude(_axes[2].x[0]);
+        estimate.velocity[2] = -_axes[2].x[1];
+        estimate.acceleration[2] = -_axes[2].x[2];
+        estimate.positionStdDev[2] = qSqrt(_axes[2].P[0][0]);
+    } else {
+        estimate.coordinate.setAltitude(qQNaN());
+    }
+
+    return extrapolate(estimate, msecs);
+}
+
+qint64 GCSMotionEstimator::nowMsecs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+GCSMotionEstimator::Estimate_t GCSMotionEstimator::extrapolate(const Estimate_t& estimate, qint64 msecs)
+{
+    if (!estimate.valid || msecs <= estimate.timestampMsecs) {
+        return estimate;
+    }
+
+    const double dt = qMin(msecs - estimate.timestampMsecs, _maxExtrapolationMsecs) / 1000.0;
+    Estimate_t result = estimate;
+    result.timestampMsecs = msecs;
+
+    double offset[3];
+    for (int i = 0; i < 3; i++) {
+        offset[i] = (estimate.velocity[i] * dt) + (estimate.acceleration[i] * dt * dt / 2);
+        result.velocity[i] = estimate.velocity[i] + (estimate.acceleration[i] * dt);
+    }
+    if (!estimate.altitudeValid) {
+        offset[2] = 0;
+    }
+
+    const QGeoCoordinate origin(estimate.coordinate.latitude(), estimate.coordinate.longitude(), 0);
+    QGCGeo::convertNedToGeo(offset[0], offset[1], 0, origin, result.coordinate);
+    result.coordinate.setAltitude(estimate.altitudeValid ? estimate.coordinate.altitude() - offset[2] : qQNaN());
+
+    return result;
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QMetaType>
+#include <QtPositioning/QGeoCoordinate>
+
+class QGeoPositionInfo;
+
+/// Smooths the ground station position and estimates its velocity and acceleration, so the position can be
+/// extrapolated between fixes. North, east and altitude are filtered independently, each by a constant
+/// acceleration Kalman filter driven by white jerk. Positions and, where the source provides them, velocities
+/// are fused as measurements.
+class GCSMotionEstimator
+{
+public:
+    typedef struct {
+        bool            valid = false;
+        qint64          timestampMsecs = 0;         ///< Monotonic, the time the estimate refers to
+        QGeoCoordinate  coordinate;
+        double          velocity[3] = {};           ///< m/s north, east, down
+        double          acceleration[3] = {};       ///< m/s/s north, east, down
+        double          positionStdDev[3] = {};     ///< m north, east, down
+        bool            altitudeValid = false;
+    } Estimate_t;
+
+    void reset();
+    bool isValid() const { return _valid; }
+
+    /// @param horizontalStdDev Position standard deviation in meters, NaN: unknown
+    /// @param verticalStdDev   Altitude standard deviation in meters, NaN: unknown
+    void updatePosition(qint64 msecs, const QGeoCoordinate& coordinate, double horizontalStdDev, double verticalStdDev);
+
+    /// @param verticalSpeed m/s up, NaN: unknown
+    void updateVelocity(qint64 msecs, double north, double east, double verticalSpeed);
+
+    /// Fuses the coordinate, accuracies, ground speed, direction and vertical speed of info
+    void update(qint64 msecs, const QGeoPositionInfo& info);
+
+    /// @return Estimate extrapolated to msecs, not valid before the first position
+    Estimate_t estimate(qint64 msecs) const;
+
+    /// Moves an estimate forward in time along its velocity and acceleration
+    static Estimate_t extrapolate(const Estimate_t& estimate, qint64 msecs);
+
+    /// @return Monotonic clock the estimates are timed with, the same on all threads
+    static qint64 nowMsecs();
+
+private:
+    /// Position, velocity, acceleration along one axis
+    class Axis
+    {
+    public:
+        void init       (double position, double variance);
+        void predict    (double dt, double jerkDensity);
+        void update     (int index, double measurement, double variance);
+
+        double x[3] = {};
+        double P[3][3] = {};
+    };
+
+    void _predictTo(qint64 msecs);
+
+    Axis            _axes[3];                       ///< North, east, altitude up
+    QGeoCoordinate  _origin;                        ///< North/east axes are relative to this
+    bool            _valid = false;
+    bool            _altitudeValid = false;
+    qint64          _timeMsecs = 0;
+
+    static constexpr double _horizontalJerkDensity  = 2.0;      ///< (m/s^3)^2/Hz, how quickly the GCS may change course
+    static constexpr double _verticalJerkDensity    = 0.2;
+    static constexpr double _defaultHorizontalStdDev = 5.0;     ///< m, sources without an accuracy
+    static constexpr double _unknownVerticalFactor  = 1.5;      ///< Altitude without an accuracy is this much worse than horizontal
+    static constexpr double _velocityStdDev         = 0.5;      ///< m/s
+    static constexpr double _initialVelocityStdDev  = 5.0;
+    static constexpr double _initialAccelStdDev     = 2.0;
+    static constexpr qint64 _resetGapMsecs          = 10000;    ///< Longer gaps between fixes start over
+    static constexpr qint64 _maxExtrapolationMsecs  = 2000;
+    static constexpr double _reoriginDistance       = 5000.0;   ///< m
+};
+
+Q_DECLARE_METATYPE(GCSMotionEstimator::Estimate_t)
@@ -0,0 +1,167 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GCSPositionWorker.h"
+#include <QGCLoggingCategory.h>
+
+#include <QtCore/QtMath>
+#include <QtPositioning/QNmeaPositionInfoSource>
+
+QGC_LOGGING_CATEGORY(GCSPositionWorkerLog, "qgc.positionmanager.gcspositionworker")
+
+/// Only used for its sentence parser, it never reads a device itself
+class NmeaSentenceParser : public QNmeaPositionInfoSource
+{
+public:
+    explicit NmeaSentenceParser(QObject *parent)
+        : QNmeaPositionInfoSource(QNmeaPositionInfoSource::RealTimeMode, parent)
+    {}
+
+    bool parse(const QByteArray &sentence, QGeoPositionInfo &info, bool &hasFix)
+    {
+        return parsePosInfoFromNmeaData(sentence.constData(), static_cast<int>(sentence.size()), &info, &hasFix);
+    }
+};
+
+GCSPositionWorker::GCSPositionWorker(QObject *parent)
+    : QObject(parent)
+    , _reportTimer(new QTimer(this))
+    , _nmeaParser(new NmeaSentenceParser(this))
+{
+    // qCDebug(GCSPositionWorkerLog) << Q_FUNC_INFO << this;
+
+    _nmeaParser->setUserEquivalentRangeError(s_userEquivalentRangeError);
+
+    _reportTimer->setTimerType(Qt::PreciseTimer);
+    _reportTimer->setSingleShot(false);
+    (void) connect(_reportTimer, &QTimer::timeout, this, &GCSPositionWorker::_reportMotion);
+}
+
+GCSPositionWorker::~GCSPositionWorker()
+{
+    // qCDebug(GCSPositionWorkerLog) << Q_FUNC_INFO << this;
+}
+
+void GCSPositionWorker::positionUpdate(const QGeoPositionInfo &info)
+{
+    if (!info.isValid()) {
+        return;
+    }
+
+    _lastFixMsecs = GCSMotionEstimator::nowMsecs();
+    _estimator.update(_lastFixMsecs, info);
+}
+
+void GCSPositionWorker::nmeaData(const QByteArray &data)
+{
+    _nmeaBuffer.append(data);
+
+    qsizetype lineStart = 0;
+    qsizetype lineEnd;
+    while ((lineEnd = _nmeaBuffer.indexOf('\n', lineStart)) >= 0) {
+        const QByteArray sentence = _nmeaBuffer.mid(lineStart, lineEnd - lineStart + 1);
+        lineStart = lineEnd + 1;
+        if (sentence.startsWith('$')) {
+            _parseNmeaSentence(sentence);
+        }
+    }
+    _nmeaBuffer.remove(0, lineStart);
+
+    if (_nmeaBuffer.size() > s_maxNmeaBufferBytes) {
+        qCWarning(GCSPositionWorkerLog) << "Discarding NMEA data without line breaks";
+        _nmeaBuffer.clear();
+    }
+}
+
+void GCSPositionWorker::_parseNmeaSentence(const QByteArray &sentence)
+{
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    if (!_nmeaParser->parse(sentence, info, hasFix)) {
+        return;
+    }
+
+    // Qt's real time reader merges the GGA/RMC/GSA... sentences of an epoch the same way, sentences of the
+    // next epoch carry a new time
+    if (_nmeaFix.timestamp().isValid() && info.timestamp().isValid() && (info.timestamp().time() != _nmeaFix.timestamp().time())) {
+        _flushNmeaFix();
+    }
+    if (info.timestamp().isValid()) {
+        _nmeaFix.setTimestamp(info.timestamp());
+    }
+    if (info.coordinate().isValid()) {
+        QGeoCoordinate coordinate = info.coordinate();
+        if (qIsNaN(coordinate.altitude()) && _nmeaFix.coordinate().isValid()) {
+            coordinate.setAltitude(_nmeaFix.coordinate().altitude());
+        }
+        _nmeaFix.setCoordinate(coordinate);
+    }
+    for (int attribute = QGeoPositionInfo::Direction; attribute <= QGeoPositionInfo::DirectionAccuracy; attribute++) {
+        const QGeoPositionInfo::Attribute attr = static_cast<QGeoPositionInfo::Attribute>(attribute);
+        if (info.hasAttribute(attr)) {
+            _nmeaFix.setAttribute(attr, info.attribute(attr));
+        }
+    }
+
+    if (!hasFix || !info.coordinate().isValid()) {
+        return;
+    }
+
+    // Feed each sentence as it arrives instead of waiting for the end of the epoch. Positions are taken from
+    // the sentences with an accuracy only, so the same fix does not count twice.
+    _lastFixMsecs = GCSMotionEstimator::nowMsecs();
+    const bool hasAccuracy = info.hasAttribute(QGeoPositionInfo::HorizontalAccuracy);
+    _nmeaAccuracySeen |= hasAccuracy;
+    if (hasAccuracy || !_nmeaAccuracySeen) {
+        _estimator.updatePosition(_lastFixMsecs, info.coordinate(),
+                                  hasAccuracy ? info.attribute(QGeoPositionInfo::HorizontalAccuracy) : qQNaN(),
+                                  info.hasAttribute(QGeoPositionInfo::VerticalAccuracy) ? info.attribute(QGeoPositionInfo::VerticalAccuracy) : qQNaN());
+    }
+    if (info.hasAttribute(QGeoPositionInfo::GroundSpeed) && info.hasAttribute(QGeoPositionInfo::Direction)) {
+        const double direction = qDegreesToRadians(info.attribute(QGeoPositionInfo::Direction));
+        const double speed = info.attribute(QGeoPositionInfo::GroundSpeed);
+        _estimator.updateVelocity(_lastFixMsecs, cos(direction) * speed, sin(direction) * speed, qQNaN());
+    }
+}
+
+void GCSPositionWorker::_flushNmeaFix()
+{
+    if (_nmeaFix.isValid()) {
+        emit nmeaPositionUpdated(_nmeaFix);
+    }
+    _nmeaFix = QGeoPositionInfo();
+}
+
+void GCSPositionWorker::reset()
+{
+    _nmeaBuffer.clear();
+    _nmeaFix = QGeoPositionInfo();
+    _nmeaAccuracySeen = false;
+    _estimator.reset();
+    _lastFixMsecs = 0;
+}
+
+void GCSPositionWorker::setMotionReportInterval(int msecs)
+{
+    if (msecs <= 0) {
+        _reportTimer->stop();
+    } else if (!_reportTimer->isActive() || (_reportTimer->interval() != msecs)) {
+        _reportTimer->start(msecs);
+    }
+}
+
+void GCSPositionWorker::_reportMotion()
+{
+    const qint64 now = GCSMotionEstimator::nowMsecs();
+    if (!_estimator.isValid() || ((now - _lastFixMsecs) > s_staleFixMsecs)) {
+        return;
+    }
+
+    emit motionEstimateUpdated(_estimator.estimate(now));
+}
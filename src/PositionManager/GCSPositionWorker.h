@@ -0,0 +1,73 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtPositioning/QGeoPositionInfo>
+
+#include "GCSMotionEstimator.h"
+
+Q_DECLARE_LOGGING_CATEGORY(GCSPositionWorkerLog)
+
+class NmeaSentenceParser;
+
+/// Runs on the position thread of QGCPositionManager. NMEA data is parsed here, all ground station fixes go through
+/// the GCSMotionEstimator, and motion estimates are reported on a precise timer, so neither the fix rate nor the
+/// report timing depends on the load of the GUI thread.
+class GCSPositionWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GCSPositionWorker(QObject *parent = nullptr);
+    ~GCSPositionWorker();
+
+public slots:
+    /// Fix from a QGeoPositionInfoSource on the GUI thread
+    void positionUpdate(const QGeoPositionInfo &info);
+
+    /// Raw data read from the NMEA device
+    void nmeaData(const QByteArray &data);
+
+    /// Drops partial NMEA data and the filter state, called when the source changes
+    void reset();
+
+    /// @param msecs 0: stop reporting
+    void setMotionReportInterval(int msecs);
+
+signals:
+    /// A complete fix parsed from the NMEA data
+    void nmeaPositionUpdated(const QGeoPositionInfo &info);
+
+    /// Estimate extrapolated to the time of the report
+    void motionEstimateUpdated(const GCSMotionEstimator::Estimate_t &estimate);
+
+private slots:
+    void _reportMotion();
+
+private:
+    void _parseNmeaSentence(const QByteArray &sentence);
+    void _flushNmeaFix();
+
+    QTimer *_reportTimer = nullptr;
+    NmeaSentenceParser *_nmeaParser = nullptr;
+    QByteArray _nmeaBuffer;
+    QGeoPositionInfo _nmeaFix;          ///< Sentences of the current NMEA epoch merged
+    bool _nmeaAccuracySeen = false;     ///< Stream has sentences with an accuracy (GGA), only those position the filter
+    GCSMotionEstimator _estimator;
+    qint64 _lastFixMsecs = 0;
+
+    static constexpr int s_maxNmeaBufferBytes = 4096;
+    static constexpr qint64 s_staleFixMsecs = 3000;        ///< No reports without a fix this recent
+    static constexpr double s_userEquivalentRangeError = 5.1;
+};
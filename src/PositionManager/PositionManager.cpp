@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "PositionManager.h"
+#include "GCSPositionWorker.h"
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
 #include "SimulatedPosition.h"
@@ -17,19 +18,30 @@
 #include <QtCore/QPermissions>
 #include <QtPositioning/QGeoPositionInfoSource>
 #include <QtPositioning/private/qgeopositioninfosource_p.h>
-#include <QtPositioning/QNmeaPositionInfoSource>
 #include <QtQml/QtQml>
 
 QGC_LOGGING_CATEGORY(QGCPositionManagerLog, "qgc.positionmanager.positionmanager")
 
 QGCPositionManager::QGCPositionManager(QGCApplication *app, QGCToolbox *toolbox)
     : QGCTool(app, toolbox)
+    , m_positionWorker(new GCSPositionWorker())
 {
     // qCDebug(QGCPositionManagerLog) << Q_FUNC_INFO << this;
+
+    (void) qRegisterMetaType<GCSMotionEstimator::Estimate_t>("GCSMotionEstimator::Estimate_t");
+
+    m_positionThread.setObjectName(QStringLiteral("GCSPosition"));
+    m_positionWorker->moveToThread(&m_positionThread);
+    (void) connect(m_positionWorker, &GCSPositionWorker::motionEstimateUpdated, this, &QGCPositionManager::motionEstimateUpdated, Qt::DirectConnection);
+    m_positionThread.start();
 }
 
 QGCPositionManager::~QGCPositionManager()
 {
+    m_positionThread.quit();
+    m_positionThread.wait();
+    delete m_positionWorker;
+
     // qCDebug(QGCPositionManagerLog) << Q_FUNC_INFO << this;
 }
 
@@ -91,24 +103,31 @@ void QGCPositionManager::setToolbox(QGCToolbox *toolbox)
 
 void QGCPositionManager::setNmeaSourceDevice(QIODevice *device)
 {
-    if (m_nmeaSource) {
-        m_nmeaSource->stopUpdates();
-        (void) disconnect(m_nmeaSource);
-
-        if (m_currentSource == m_nmeaSource) {
-            m_currentSource = nullptr;
-        }
+    if (m_nmeaDevice) {
+        (void) disconnect(m_nmeaDevice, nullptr, this, nullptr);
+    }
+    m_nmeaDevice = device;
 
-        delete m_nmeaSource;
-        m_nmeaSource = nullptr;
+    if (!device->isOpen() && !device->open(QIODevice::ReadOnly)) {
+        qCWarning(QGCPositionManagerLog) << Q_FUNC_INFO << "Could not open NMEA device" << device->errorString();
     }
 
-    m_nmeaSource = new QNmeaPositionInfoSource(QNmeaPositionInfoSource::RealTimeMode, this);
-    m_nmeaSource->setDevice(device);
-    m_nmeaSource->setUserEquivalentRangeError(5.1);
+    // Only the read stays on the GUI thread, which owns the device
+    (void) connect(device, &QIODevice::readyRead, this, [this, device]() {
+        const QByteArray data = device->readAll();
+        GCSPositionWorker *const worker = m_positionWorker;
+        (void) QMetaObject::invokeMethod(worker, [worker, data]() { worker->nmeaData(data); }, Qt::QueuedConnection);
+    });
+
     _setPositionSource(QGCPositionManager::NmeaGPS);
 }
 
+void QGCPositionManager::setMotionReportInterval(int msecs)
+{
+    GCSPositionWorker *const worker = m_positionWorker;
+    (void) QMetaObject::invokeMethod(worker, [worker, msecs]() { worker->setMotionReportInterval(msecs); }, Qt::QueuedConnection);
+}
+
 void QGCPositionManager::_positionUpdated(const QGeoPositionInfo &update)
 {
     m_geoPositionInfo = update;
@@ -167,9 +186,14 @@ void QGCPositionManager::_setGCSPosition(const QGeoCoordinate& newGCSPosition)
 
 void QGCPositionManager::_setPositionSource(QGCPositionSource source)
 {
-    if (m_currentSource != nullptr) {
-        m_currentSource->stopUpdates();
-        (void) disconnect(m_currentSource);
+    if ((m_currentSource != nullptr) || m_nmeaConnection) {
+        if (m_currentSource != nullptr) {
+            m_currentSource->stopUpdates();
+            (void) disconnect(m_currentSource);
+            m_currentSource = nullptr;
+        }
+        (void) disconnect(m_nmeaConnection);
+        m_nmeaConnection = QMetaObject::Connection();
 
         m_geoPositionInfo = QGeoPositionInfo();
         m_gcsPosition = QGeoCoordinate();
@@ -182,6 +206,9 @@ void QGCPositionManager::_setPositionSource(QGCPositionSource source)
         emit gcsPositionHorizontalAccuracyChanged(m_gcsPositionHorizontalAccuracy);
     }
 
+    GCSPositionWorker *const worker = m_positionWorker;
+    (void) QMetaObject::invokeMethod(worker, [worker]() { worker->reset(); }, Qt::QueuedConnection);
+
     switch (source) {
     case QGCPositionManager::Log:
         break;
@@ -189,7 +216,9 @@ void QGCPositionManager::_setPositionSource(QGCPositionSource source)
         m_currentSource = m_simulatedSource;
         break;
     case QGCPositionManager::NmeaGPS:
-        m_currentSource = m_nmeaSource;
+        // Parsed on the position thread, see setNmeaSourceDevice
+        m_updateInterval = 0;
+        m_nmeaConnection = connect(m_positionWorker, &GCSPositionWorker::nmeaPositionUpdated, this, &QGCPositionManager::_positionUpdated);
         break;
     case QGCPositionManager::InternalGPS:
         m_currentSource = m_defaultSource;
@@ -208,6 +237,7 @@ void QGCPositionManager::_setPositionSource(QGCPositionSource source)
             m_currentSource->setUpdateInterval(m_updateInterval);
         #endif
         (void) connect(m_currentSource, &QGeoPositionInfoSource::positionUpdated, this, &QGCPositionManager::_positionUpdated);
+        (void) connect(m_currentSource, &QGeoPositionInfoSource::positionUpdated, m_positionWorker, &GCSPositionWorker::positionUpdate);
         (void) connect(m_currentSource, &QGeoPositionInfoSource::errorOccurred, this, [](QGeoPositionInfoSource::Error positioningError) {
             qCWarning(QGCPositionManagerLog) << Q_FUNC_INFO << positioningError;
         });
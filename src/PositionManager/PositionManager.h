@@ -10,16 +10,19 @@
 #pragma once
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/QGeoPositionInfo>
 
+#include "GCSMotionEstimator.h"
 #include "QGCToolbox.h"
 
 Q_DECLARE_LOGGING_CATEGORY(QGCPositionManagerLog)
 
 class QGeoPositionInfoSource;
-class QNmeaPositionInfoSource;
 class QGCCompass;
+class GCSPositionWorker;
 
 class QGCPositionManager : public QGCTool
 {
@@ -49,13 +52,20 @@ public:
     QGeoPositionInfo geoPositionInfo() const { return m_geoPositionInfo; }
     int updateInterval() const { return m_updateInterval; }
 
+    /// The device is read on the GUI thread, its data is parsed on the position thread
     void setNmeaSourceDevice(QIODevice *device);
 
+    /// Starts or stops motionEstimateUpdated
+    ///     @param msecs 0: stop
+    void setMotionReportInterval(int msecs);
+
 signals:
     void gcsPositionChanged(QGeoCoordinate gcsPosition);
     void gcsHeadingChanged(qreal gcsHeading);
     void positionInfoUpdated(QGeoPositionInfo update);
     void gcsPositionHorizontalAccuracyChanged(qreal gcsPositionHorizontalAccuracy);
+    /// Emitted from the position thread at the motion report interval
+    void motionEstimateUpdated(const GCSMotionEstimator::Estimate_t &estimate);
 
 private slots:
     void _positionUpdated(const QGeoPositionInfo &update);
@@ -81,9 +91,14 @@ private:
 
     QGeoPositionInfoSource *m_currentSource = nullptr;
     QGeoPositionInfoSource *m_defaultSource = nullptr;
-    QNmeaPositionInfoSource *m_nmeaSource = nullptr;
     QGeoPositionInfoSource *m_simulatedSource = nullptr;
 
+    QPointer<QIODevice> m_nmeaDevice;
+    QMetaObject::Connection m_nmeaConnection;   ///< Fixes from the worker while NMEA is the source
+
+    QThread m_positionThread;
+    GCSPositionWorker *m_positionWorker = nullptr;  ///< Lives on m_positionThread
+
     QGCCompass *m_compass = nullptr;
 
     static constexpr qreal s_minHorizonalAccuracyMeters = 100.;
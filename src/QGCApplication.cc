@@ -38,6 +38,8 @@
 #include "QGCPalette.h"
 #include "QGCMapPalette.h"
 #include "QGCLoggingCategory.h"
+#include "QGCPerfCounter.h"
+#include "QGCStartupScheduler.h"
 #include "ParameterEditorController.h"
 #include "ESP8266ComponentController.h"
 #include "ScreenToolsController.h"
@@ -61,6 +63,7 @@
 #include "LogDownloadController.h"
 #if !defined(QGC_DISABLE_MAVLINK_INSPECTOR)
 #include "MAVLinkInspectorController.h"
+#include "PerformanceController.h"
 #endif
 #include "HorizontalFactValueGrid.h"
 #include "InstrumentValueData.h"
@@ -70,6 +73,7 @@
 #include "QGCMapCircle.h"
 #include "ParameterManager.h"
 #include "SettingsManager.h"
+#include "SettingsWriteBack.h"
 #include "QGCCorePlugin.h"
 #include "QGCCameraManager.h"
 #include "CameraCalc.h"
@@ -84,11 +88,17 @@
 #include "MAVLinkChartController.h"
 #include "GeoTagController.h"
 #include "LogReplayLink.h"
+#include "TelemetryServer.h"
 #include "VehicleObjectAvoidance.h"
 #include "TrajectoryPoints.h"
 #include "RCToParamDialogController.h"
 #include "QGCImageProvider.h"
 #include "TerrainProfile.h"
+#include "MapMarkerBatch.h"
+#include "MapOverlayItem.h"
+#include "MapOverlayLayer.h"
+#include "MapTrajectoryBatch.h"
+#include "ObstacleDistanceItem.h"
 #include "ToolStripAction.h"
 #include "ToolStripActionList.h"
 #include "VehicleLinkManager.h"
@@ -98,6 +108,9 @@
 #include "CustomActionManager.h"
 #include "AudioOutput.h"
 #include "FollowMe.h"
+#ifdef QT_DEBUG
+#include "MockLinkSwarm.h"
+#endif
 #include "JsonHelper.h"
 // #ifdef QGC_VIEWER3D
 #include "Viewer3DManager.h"
@@ -117,6 +130,8 @@
 
 QGC_LOGGING_CATEGORY(QGCApplicationLog, "qgc.qgcapplication")
 
+static QGCPerfCounter s_mergedSignals("Event Loop", "Coalesced signals", QGCPerfCounter::Count);
+
 // Qml Singleton factories
 
 static QObject* screenToolsControllerSingletonFactory(QQmlEngine*, QJSEngine*)
@@ -139,11 +154,18 @@ static QObject* shapeFileHelperSingletonFactory(QQmlEngine*, QJSEngine*)
     return new ShapeFileHelper;
 }
 
+static QObject* logDownloadControllerSingletonFactory(QQmlEngine*, QJSEngine*)
+{
+    // Lives as long as the engine, so downloads continue while the Analyze view is closed
+    return new LogDownloadController;
+}
+
 QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
     : QApplication(argc, argv)
     , _runningUnitTests(unitTesting)
 {
     _msecsElapsedTime.start();
+    _startupScheduler = new QGCStartupScheduler(this);
 
     // Setup for network proxy support
     QNetworkProxyFactory::setUseSystemConfiguration(true);
@@ -160,6 +182,9 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
         { "--logging",          &logging,               &loggingOptions },
         { "--fake-mobile",      &_fakeMobile,           nullptr },
         { "--log-output",       &_logOutput,            nullptr },
+        { "--replay-log",       &_headlessReplay,       &_headlessReplayFile },
+        { "--telemetry-server", &_telemetryServer,      &_telemetryServerOptions },
+        { "--mock-swarm",       &_mockSwarm,            &_mockSwarmOptions },
         // Add additional command line option flags here
     };
 
@@ -195,6 +220,10 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
 
     // Set settings format
     QSettings::setDefaultFormat(QSettings::IniFormat);
+
+    // Changes which did not make it to disk because the last run did not exit cleanly
+    SettingsWriteBack::instance()->recoverJournal();
+
     QSettings settings;
     qCDebug(QGCApplicationLog) << "Settings location" << settings.fileName() << "Is writable?:" << settings.isWritable();
 
@@ -246,10 +275,13 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
     setLanguage();
 
     _toolbox = new QGCToolbox(this);
-    _toolbox->setChildToolboxes();
+    {
+        const QGCStartupScheduler::Step step(_startupScheduler, "Toolbox setup");
+        _toolbox->setChildToolboxes();
+    }
 
 #ifndef DAILY_BUILD
-    _checkForNewVersion();
+    _startupScheduler->addDeferredTask("Version check", [this]() { _checkForNewVersion(); });
 #endif
 }
 
@@ -319,6 +351,7 @@ void QGCApplication::init()
 
     qmlRegisterUncreatableType<FactValueGrid>        ("QGroundControl.Templates",             1, 0, "FactValueGrid",       "Reference only");
     qmlRegisterUncreatableType<FlightPathSegment>    ("QGroundControl",                       1, 0, "FlightPathSegment",   "Reference only");
+    qmlRegisterUncreatableType<MapOverlayLayer>      ("QGroundControl.FlightMap",             1, 0, "MapOverlayLayer",     "Reference only");
     qmlRegisterUncreatableType<InstrumentValueData>  ("QGroundControl",                       1, 0, "InstrumentValueData", "Reference only");
     qmlRegisterUncreatableType<QGCGeoBoundingCube>   ("QGroundControl.FlightMap",             1, 0, "QGCGeoBoundingCube",  "Reference only");
     qmlRegisterUncreatableType<QGCMapPolygon>        ("QGroundControl.FlightMap",             1, 0, "QGCMapPolygon",       "Reference only");
@@ -327,9 +360,13 @@ void QGCApplication::init()
     qmlRegisterType<CustomActionManager>             ("QGroundControl.Controllers",           1, 0, "CustomActionManager");
     qmlRegisterType<EditPositionDialogController>    ("QGroundControl.Controllers",           1, 0, "EditPositionDialogController");
     qmlRegisterType<HorizontalFactValueGrid>         ("QGroundControl.Templates",             1, 0, "HorizontalFactValueGrid");
+    qmlRegisterType<ObstacleDistanceItem>            ("QGroundControl.Controls",              1, 0, "ObstacleDistanceItem");
     qmlRegisterType<ParameterEditorController>       ("QGroundControl.Controllers",           1, 0, "ParameterEditorController");
     qmlRegisterType<QGCFileDialogController>         ("QGroundControl.Controllers",           1, 0, "QGCFileDialogController");
     qmlRegisterType<QGCMapCircle>                    ("QGroundControl.FlightMap",             1, 0, "QGCMapCircle");
+    qmlRegisterType<MapMarkerBatch>                  ("QGroundControl.FlightMap",             1, 0, "MapMarkerBatch");
+    qmlRegisterType<MapOverlayItem>                  ("QGroundControl.FlightMap",             1, 0, "MapOverlayItem");
+    qmlRegisterType<MapTrajectoryBatch>              ("QGroundControl.FlightMap",             1, 0, "MapTrajectoryBatch");
     qmlRegisterType<QGCMapPalette>                   ("QGroundControl.Palette",               1, 0, "QGCMapPalette");
     qmlRegisterType<QGCPalette>                      ("QGroundControl.Palette",               1, 0, "QGCPalette");
     qmlRegisterType<RCChannelMonitorController>      ("QGroundControl.Controllers",           1, 0, "RCChannelMonitorController");
@@ -369,10 +406,12 @@ void QGCApplication::init()
 
 #if !defined(QGC_DISABLE_MAVLINK_INSPECTOR)
     qmlRegisterUncreatableType<MAVLinkChartController>("QGroundControl",             1, 0, "MAVLinkChart", "Reference only");
+    qmlRegisterUncreatableType<MAVLinkMessageStats>   ("QGroundControl",             1, 0, "MAVLinkMessageStats", "Reference only");
     qmlRegisterType<MAVLinkInspectorController>       ("QGroundControl.Controllers", 1, 0, "MAVLinkInspectorController");
 #endif
     qmlRegisterType<GeoTagController>        ("QGroundControl.Controllers", 1, 0, "GeoTagController");
-    qmlRegisterType<LogDownloadController>   ("QGroundControl.Controllers", 1, 0, "LogDownloadController");
+    qmlRegisterType<PerformanceController>   ("QGroundControl.Controllers", 1, 0, "PerformanceController");
+    qmlRegisterSingletonType<LogDownloadController>("QGroundControl.Controllers", 1, 0, "LogDownloadController", logDownloadControllerSingletonFactory);
     qmlRegisterType<MAVLinkConsoleController>("QGroundControl.Controllers", 1, 0, "MAVLinkConsoleController");
 
 
@@ -399,7 +438,11 @@ void QGCApplication::init()
         qWarning() << "Could not load /fonts/opensans-demibold font";
     }
 
-    if (!_runningUnitTests) {
+    if (_headlessReplay && !_runningUnitTests) {
+        _initForHeadlessReplay();
+    } else if (_telemetryServer && !_runningUnitTests) {
+        _initForTelemetryServer();
+    } else if (!_runningUnitTests) {
         _initForNormalAppBoot();
     } else {
         AudioOutput::instance()->setMuted(true);
@@ -437,12 +480,20 @@ void QGCApplication::_initForNormalAppBoot()
 #endif
 
     QQuickStyle::setStyle("Basic");
-    _qmlAppEngine = _toolbox->corePlugin()->createQmlApplicationEngine(this);
-    QObject::connect(_qmlAppEngine, &QQmlApplicationEngine::objectCreationFailed, this, QCoreApplication::quit, Qt::QueuedConnection);
-    _toolbox->corePlugin()->createRootWindow(_qmlAppEngine);
+    {
+        const QGCStartupScheduler::Step step(_startupScheduler, "QML engine");
+        _qmlAppEngine = _toolbox->corePlugin()->createQmlApplicationEngine(this);
+        QObject::connect(_qmlAppEngine, &QQmlApplicationEngine::objectCreationFailed, this, QCoreApplication::quit, Qt::QueuedConnection);
+    }
+    {
+        const QGCStartupScheduler::Step step(_startupScheduler, "Root window");
+        _toolbox->corePlugin()->createRootWindow(_qmlAppEngine);
+    }
 
-    AudioOutput::instance()->init(_toolbox->settingsManager()->appSettings()->audioMuted());
-    FollowMe::instance()->init();
+    {
+        const QGCStartupScheduler::Step step(_startupScheduler, "Audio");
+        AudioOutput::instance()->init(_toolbox->settingsManager()->appSettings()->audioMuted());
+    }
 
     // Image provider for Optical Flow
     _qmlAppEngine->addImageProvider(qgcImageProviderId, new QGCImageProvider());
@@ -483,22 +534,93 @@ void QGCApplication::_initForNormalAppBoot()
     #endif
     #endif
 
+    if (_settingsUpgraded) {
+        showAppMessage(QString(tr("The format for %1 saved settings has been modified. "
+                    "Your saved settings have been reset to defaults.")).arg(applicationName()));
+    }
+
+    // Nothing below is needed to show the main window, so it waits for the first frame
+
+    _startupScheduler->addDeferredTask("Follow Me", []() { FollowMe::instance()->init(); });
+
     // Now that main window is up check for lost log files
-    connect(this, &QGCApplication::checkForLostLogFiles, _toolbox->mavlinkProtocol(), &MAVLinkProtocol::checkForLostLogFiles);
-    emit checkForLostLogFiles();
+    _startupScheduler->addDeferredTask("Lost log files", [this]() {
+        connect(this, &QGCApplication::checkForLostLogFiles, _toolbox->mavlinkProtocol(), &MAVLinkProtocol::checkForLostLogFiles);
+        emit checkForLostLogFiles();
+    });
 
     // Load known link configurations
-    _toolbox->linkManager()->loadLinkConfigurationList();
+    _startupScheduler->addDeferredTask("Link configurations", [this]() { _toolbox->linkManager()->loadLinkConfigurationList(); });
 
     // Probe for joysticks
-    _toolbox->joystickManager()->init();
+    _startupScheduler->addDeferredTask("Joystick probe", [this]() { _toolbox->joystickManager()->init(); });
 
-    if (_settingsUpgraded) {
-        showAppMessage(QString(tr("The format for %1 saved settings has been modified. "
-                    "Your saved settings have been reset to defaults.")).arg(applicationName()));
-    }
+    // Vehicle streamed logging needs the log manager in place before the first vehicle shows up
+    _startupScheduler->addDeferredTask("MAVLink log manager", [this]() { (void) _toolbox->mavlinkLogManager(); });
 
     // Connect links with flag AutoconnectLink
+    _startupScheduler->addDeferredTask("Auto connect links", [this]() {
+        _toolbox->linkManager()->startAutoConnectedLinks();
+    }, { QStringLiteral("Link configurations"), QStringLiteral("MAVLink log manager") });
+
+#ifdef QT_DEBUG
+    // Load generator, for example: --mock-swarm:vehicles=100,links=2,position=10,params=500
+    _startupScheduler->addDeferredTask("Mock swarm", [this]() {
+        if (_mockSwarm && !MockLinkSwarm::startSwarm(_mockSwarmOptions)) {
+            showAppMessage(tr("Invalid --mock-swarm options: %1").arg(_mockSwarmOptions));
+        }
+    }, { QStringLiteral("Auto connect links") });
+#endif
+
+    _startupScheduler->start(rootWindow);
+}
+
+void QGCApplication::_initForHeadlessReplay()
+{
+    AudioOutput::instance()->setMuted(true);
+
+    if (_headlessReplayFile.isEmpty()) {
+        qCWarning(QGCApplicationLog) << "--replay-log requires a log file: --replay-log:<file>";
+        QTimer::singleShot(0, this, []() { QCoreApplication::exit(-1); });
+        return;
+    }
+
+    qCInfo(QGCApplicationLog) << "Replaying" << _headlessReplayFile;
+    LogReplayLink* const link = _toolbox->linkManager()->startLogReplay(_headlessReplayFile, true /* fastReplay */);
+    if (!link) {
+        qCWarning(QGCApplicationLog) << "Unable to replay" << _headlessReplayFile;
+        QTimer::singleShot(0, this, []() { QCoreApplication::exit(-1); });
+        return;
+    }
+
+    (void) connect(link, &LogReplayLink::playbackPercentCompleteChanged, this, [](qreal percentComplete) {
+        qCInfo(QGCApplicationLog) << "Replay" << qRound(percentComplete) << "%";
+    });
+    (void) connect(link, &LinkInterface::communicationError, this, [](const QString& title, const QString& error) {
+        qCWarning(QGCApplicationLog) << title << error;
+        QCoreApplication::exit(-1);
+    });
+    // Queued behind the last batch of the log, so everything has been processed by the time this arrives
+    (void) connect(link, &LogReplayLink::playbackAtEnd, this, []() {
+        qCInfo(QGCApplicationLog) << "Replay complete";
+        QCoreApplication::quit();
+    });
+}
+
+void QGCApplication::_initForTelemetryServer()
+{
+    AudioOutput::instance()->setMuted(true);
+
+    // For example: --telemetry-server:port=5790,rate=10
+    TelemetryServer* const server = new TelemetryServer(this);
+    if (!server->start(_telemetryServerOptions)) {
+        QTimer::singleShot(0, this, []() { QCoreApplication::exit(-1); });
+        return;
+    }
+
+    // Same link and vehicle setup as a normal boot, just without the ui
+    (void) _toolbox->mavlinkLogManager();
+    _toolbox->linkManager()->loadLinkConfigurationList();
     _toolbox->linkManager()->startAutoConnectedLinks();
 }
 
@@ -549,13 +671,21 @@ void QGCApplication::saveTelemetryLogOnMainThread(const QString &tempLogfile)
         }
         const QString saveFilePath = saveDir.absoluteFilePath(saveFileName);
 
+        // The log is usually written in the save directory already, so saving it is a rename. A copy is only needed
+        // when it was written to another file system.
         QFile tempFile(tempLogfile);
-        if (!tempFile.copy(saveFilePath)) {
+        if (!tempFile.rename(saveFilePath) && !tempFile.copy(saveFilePath)) {
             const QString error = tr("Unable to save telemetry log. Error copying telemetry to '%1': '%2'.").arg(saveFilePath).arg(tempFile.errorString());
             showAppMessage(error);
+        } else {
+            QFile tempIndexFile(MAVLinkLogWriter::indexFileName(tempLogfile));
+            if (tempIndexFile.exists() && !tempIndexFile.rename(MAVLinkLogWriter::indexFileName(saveFilePath))) {
+                (void) tempIndexFile.copy(MAVLinkLogWriter::indexFileName(saveFilePath));
+            }
         }
     }
     QFile::remove(tempLogfile);
+    QFile::remove(MAVLinkLogWriter::indexFileName(tempLogfile));
 }
 
 void QGCApplication::checkTelemetrySavePathOnMainThread()
@@ -799,30 +929,134 @@ int QGCApplication::CompressedSignalList::_signalIndex(const QMetaMethod & metho
 
 void QGCApplication::CompressedSignalList::add(const QMetaMethod & method)
 {
-    const QMetaObject*  metaObject  = method.enclosingMetaObject();
-    int                 signalIndex = _signalIndex(method);
-
-    if (signalIndex != -1 && !contains(metaObject, signalIndex)) {
-        _signalMap[method.enclosingMetaObject()].insert(signalIndex);
+    const int signalIndex = _signalIndex(method);
+    if (signalIndex == -1) {
+        return;
     }
+
+    QMutexLocker locker(&_mutex);
+    _signals[SignalKey_t(method.enclosingMetaObject(), signalIndex)] = QStringLiteral("%1::%2").arg(QString::fromUtf8(method.enclosingMetaObject()->className()), QString::fromUtf8(method.name()));
+    _resolvedSignals.clear();
 }
 
 void QGCApplication::CompressedSignalList::remove(const QMetaMethod & method)
 {
     const int signalIndex = _signalIndex(method);
-    const QMetaObject*  metaObject  = method.enclosingMetaObject();
+    if (signalIndex == -1) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+    if (_signals.remove(SignalKey_t(method.enclosingMetaObject(), signalIndex))) {
+        _resolvedSignals.clear();
+    }
+}
+
+/// Signal indices of a base class are the same in all derived classes, so the sender class and its base classes are
+/// checked for a registration. The result is cached per sender class. Must be called with _mutex locked.
+///     @return Registered signal, first member is nullptr if the signal is not compressed
+QGCApplication::CompressedSignalList::SignalKey_t QGCApplication::CompressedSignalList::_registeredSignal(const QMetaObject* metaObject, int signalIndex)
+{
+    const SignalKey_t senderKey(metaObject, signalIndex);
 
-    if (signalIndex != -1 && _signalMap.contains(metaObject) && _signalMap[metaObject].contains(signalIndex)) {
-        _signalMap[metaObject].remove(signalIndex);
-        if (_signalMap[metaObject].count() == 0) {
-            _signalMap.remove(metaObject);
+    const auto resolvedIt = _resolvedSignals.constFind(senderKey);
+    if (resolvedIt != _resolvedSignals.constEnd()) {
+        return resolvedIt.value();
+    }
+
+    SignalKey_t registeredKey(nullptr, -1);
+    for (const QMetaObject* classMetaObject = metaObject; classMetaObject; classMetaObject = classMetaObject->superClass()) {
+        if (_signals.contains(SignalKey_t(classMetaObject, signalIndex))) {
+            registeredKey = SignalKey_t(classMetaObject, signalIndex);
+            break;
         }
     }
+    _resolvedSignals[senderKey] = registeredKey;
+
+    return registeredKey;
 }
 
 bool QGCApplication::CompressedSignalList::contains(const QMetaObject* metaObject, int signalIndex)
 {
-    return _signalMap.contains(metaObject) && _signalMap[metaObject].contains(signalIndex);
+    QMutexLocker locker(&_mutex);
+    return _registeredSignal(metaObject, signalIndex).first != nullptr;
+}
+
+/// Replaces a pending duplicate of the queued call in the posted event list with the new call
+///     @return true: call was merged, false: no duplicate is pending so the call must be posted
+bool QGCApplication::CompressedSignalList::merge(QEvent* event, QObject* receiver, QPostEventList* postedEvents)
+{
+    const QMetaCallEvent* mce = static_cast<QMetaCallEvent*>(event);
+    const PendingKey_t pendingKey = { receiver, mce->sender(), mce->signalId(), mce->id() };
+
+    const auto isDuplicate = [&](const QPostEvent& cur) {
+        if (cur.receiver != receiver || cur.event == 0 || cur.event->type() != event->type()) {
+            return false;
+        }
+        const QMetaCallEvent *cur_mce = static_cast<QMetaCallEvent*>(cur.event);
+        return cur_mce->sender() == mce->sender() && cur_mce->signalId() == mce->signalId() && cur_mce->id() == mce->id();
+    };
+
+    QMutexLocker locker(&_mutex);
+
+    // A burst of emits keeps hitting the same pending event, so try where it was last seen before searching the list.
+    // The index goes stale once the list is processed, the entry is checked so a stale index only costs the search.
+    qsizetype pendingIndex = -1;
+    const auto hintIt = _pendingIndices.constFind(pendingKey);
+    if (hintIt != _pendingIndices.constEnd() && hintIt.value() < postedEvents->size() && isDuplicate(postedEvents->at(hintIt.value()))) {
+        pendingIndex = hintIt.value();
+    } else {
+        for (qsizetype i=0; i<postedEvents->size(); i++) {
+            if (isDuplicate(postedEvents->at(i))) {
+                pendingIndex = i;
+                break;
+            }
+        }
+    }
+
+    if (pendingIndex == -1) {
+        // Normal priority events are appended to the list after we return
+        if (_pendingIndices.count() >= _maxPendingIndices) {
+            _pendingIndices.clear();
+        }
+        _pendingIndices[pendingKey] = postedEvents->size();
+        return false;
+    }
+    _pendingIndices[pendingKey] = pendingIndex;
+
+    QPostEvent &cur = (*postedEvents)[pendingIndex];
+    /* Keep The Newest Call */
+    // We can't merely qSwap the existing posted event with the new one, since QEvent
+    // keeps track of whether it has been posted. Deletion of a formerly posted event
+    // takes the posted event list mutex and does a useless search of the posted event
+    // list upon deletion. We thus clear the QEvent::posted flag before deletion.
+    struct EventHelper : private QEvent {
+        static void clearPostedFlag(QEvent * ev) {
+            (&static_cast<EventHelper*>(ev)->t)[1] &= ~0x8001; // Hack to clear QEvent::posted
+        }
+    };
+    EventHelper::clearPostedFlag(cur.event);
+    delete cur.event;
+    cur.event = event;
+
+    _mergedCounts[_registeredSignal(mce->sender()->metaObject(), mce->signalId())]++;
+    s_mergedSignals.add();
+
+    return true;
+}
+
+QMap<QString, quint64> QGCApplication::CompressedSignalList::mergedCounts(void)
+{
+    QMutexLocker locker(&_mutex);
+
+    QMap<QString, quint64> counts;
+    for (auto it = _mergedCounts.constBegin(); it != _mergedCounts.constEnd(); it++) {
+        const auto nameIt = _signals.constFind(it.key());
+        if (nameIt != _signals.constEnd()) {
+            counts[nameIt.value()] = it.value();
+        }
+    }
+    return counts;
 }
 
 void QGCApplication::addCompressedSignal(const QMetaMethod & method)
@@ -835,6 +1069,11 @@ void QGCApplication::removeCompressedSignal(const QMetaMethod & method)
     _compressedSignals.remove(method);
 }
 
+QMap<QString, quint64> QGCApplication::compressedSignalCounts(void)
+{
+    return _compressedSignals.mergedCounts();
+}
+
 bool QGCApplication::compressEvent(QEvent*event, QObject* receiver, QPostEventList* postedEvents)
 {
     if (event->type() != QEvent::MetaCall) {
@@ -846,32 +1085,7 @@ bool QGCApplication::compressEvent(QEvent*event, QObject* receiver, QPostEventLi
         return QApplication::compressEvent(event, receiver, postedEvents);
     }
 
-    for (QPostEventList::iterator it = postedEvents->begin(); it != postedEvents->end(); ++it) {
-        QPostEvent &cur = *it;
-        if (cur.receiver != receiver || cur.event == 0 || cur.event->type() != event->type()) {
-            continue;
-        }
-        const QMetaCallEvent *cur_mce = static_cast<QMetaCallEvent*>(cur.event);
-        if (cur_mce->sender() != mce->sender() || cur_mce->signalId() != mce->signalId() || cur_mce->id() != mce->id()) {
-            continue;
-        }
-        /* Keep The Newest Call */
-        // We can't merely qSwap the existing posted event with the new one, since QEvent
-        // keeps track of whether it has been posted. Deletion of a formerly posted event
-        // takes the posted event list mutex and does a useless search of the posted event
-        // list upon deletion. We thus clear the QEvent::posted flag before deletion.
-        struct EventHelper : private QEvent {
-            static void clearPostedFlag(QEvent * ev) {
-                (&static_cast<EventHelper*>(ev)->t)[1] &= ~0x8001; // Hack to clear QEvent::posted
-            }
-        };
-        EventHelper::clearPostedFlag(cur.event);
-        delete cur.event;
-        cur.event = event;
-        return true;
-    }
-
-    return false;
+    return _compressedSignals.merge(event, receiver, postedEvents);
 }
 
 bool QGCApplication::event(QEvent *e)
@@ -905,6 +1119,8 @@ void QGCApplication::shutdown()
     qCDebug(QGCApplicationLog) << "Exit";
     // This is bad, but currently qobject inheritances are incorrect and cause crashes on exit without
     delete _qmlAppEngine;
+
+    SettingsWriteBack::instance()->flush();
 }
 
 QString QGCApplication::numberToString(quint64 number)
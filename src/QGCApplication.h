@@ -12,7 +12,9 @@
 #include <QtWidgets/QApplication>
 #include <QtCore/QTimer>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
+#include <QtCore/QMutex>
 #include <QtCore/QSet>
 #include <QtCore/QEvent>
 #include <QtCore/QMetaMethod>
@@ -28,6 +30,7 @@ class QQmlApplicationEngine;
 class QGCToolbox;
 class QQuickWindow;
 class QGCImageProvider;
+class QGCStartupScheduler;
 class QGCApplication;
 
 #if defined(qApp)
@@ -85,6 +88,9 @@ public:
     // Still working on getting rid of this and using dependency injection instead for everything
     QGCToolbox* toolbox(void) { return _toolbox; }
 
+    /// Times startup steps and runs the startup work which can wait until the main window is showing
+    QGCStartupScheduler* startupScheduler(void) { return _startupScheduler; }
+
     void            setLanguage();
     QQuickWindow*   mainRootWindow();
     uint64_t        msecsSinceBoot(void) { return _msecsElapsedTime.elapsed(); }
@@ -92,11 +98,18 @@ public:
     QString         bigSizeToString(quint64 size);
     QString         bigSizeMBToString(quint64 size_MB);
 
-    /// Registers the signal such that only the last duplicate signal added is left in the queue.
+    /// Registers the signal such that only the last duplicate signal added is left in the queue. Queued calls from the
+    /// same sender to the same receiver slot are merged and the remaining call delivers the arguments of the newest
+    /// emit. Signals declared in a base class are also compressed when emitted by a derived class.
     void addCompressedSignal(const QMetaMethod & method);
+    template <typename Func>
+    void addCompressedSignal(Func signal) { addCompressedSignal(QMetaMethod::fromSignal(signal)); }
 
     void removeCompressedSignal(const QMetaMethod & method);
 
+    /// @return Number of queued calls merged away so far for each compressed signal, keyed by "Class::signal"
+    QMap<QString, quint64> compressedSignalCounts(void);
+
     bool event(QEvent *e) override;
 
     static QString cachedParameterMetaDataFile(void);
@@ -162,6 +175,12 @@ private:
     /// @brief Initialize the application for normal application boot. Or in other words we are not going to run unit tests.
     void _initForNormalAppBoot();
 
+    /// @brief Initialize the application for replaying a log as fast as possible without any ui, then exit
+    void _initForHeadlessReplay();
+
+    /// @brief Initialize the application to connect the links without any ui and serve the vehicles to viewers
+    void _initForTelemetryServer();
+
     QObject* _rootQmlObject();
     void _checkForNewVersion();
     bool _checkTelemetrySavePath(bool useMessageBox);
@@ -177,11 +196,18 @@ private:
     QQmlApplicationEngine* _qmlAppEngine        = nullptr;
     bool                _logOutput              = false;    ///< true: Log Qt debug output to file
     bool				_fakeMobile             = false;    ///< true: Fake ui into displaying mobile interface
+    bool                _headlessReplay         = false;    ///< true: Replay _headlessReplayFile without ui and exit
+    QString             _headlessReplayFile;
+    bool                _telemetryServer        = false;    ///< true: Run headless as TelemetryServer
+    QString             _telemetryServerOptions;
+    bool                _mockSwarm              = false;    ///< true: Start a MockLinkSwarm load generator, debug builds only
+    QString             _mockSwarmOptions;
     bool                _settingsUpgraded       = false;    ///< true: Settings format has been upgrade to new version
     int                 _majorVersion           = 0;
     int                 _minorVersion           = 0;
     int                 _buildVersion           = 0;
     QGCToolbox*         _toolbox                = nullptr;
+    QGCStartupScheduler* _startupScheduler      = nullptr;
     QQuickWindow*       _mainRootWindow         = nullptr;
     QTranslator         _qgcTranslatorSourceCode;           ///< translations for source code C++/Qml
     QTranslator         _qgcTranslatorQtLibs;               ///< tranlsations for Qt libraries
@@ -192,6 +218,7 @@ private:
 
     QList<QPair<QString /* title */, QString /* message */>> _delayedAppMessages;
 
+    /// Lookups are called from compressEvent by whichever thread posts the event, so all access is under _mutex
     class CompressedSignalList {
         Q_DISABLE_COPY(CompressedSignalList)
 
@@ -201,11 +228,38 @@ private:
         void add        (const QMetaMethod & method);
         void remove     (const QMetaMethod & method);
         bool contains   (const QMetaObject * metaObject, int signalIndex);
+        bool merge      (QEvent * event, QObject * receiver, QPostEventList * postedEvents);
 
-    private:
-        static int _signalIndex(const QMetaMethod & method);
+        QMap<QString, quint64> mergedCounts(void);
 
-        QMap<const QMetaObject*, QSet<int> > _signalMap;
+    private:
+        typedef QPair<const QMetaObject*, int> SignalKey_t;
+
+        /// Identifies a queued call which can be merged with another
+        struct PendingKey_t {
+            const QObject*  receiver;
+            const QObject*  sender;
+            int             signalId;
+            int             methodId;
+
+            bool operator==(const PendingKey_t& other) const {
+                return receiver == other.receiver && sender == other.sender && signalId == other.signalId && methodId == other.methodId;
+            }
+            friend size_t qHash(const PendingKey_t& key, size_t seed = 0) {
+                return qHashMulti(seed, key.receiver, key.sender, key.signalId, key.methodId);
+            }
+        };
+
+        SignalKey_t _registeredSignal(const QMetaObject * metaObject, int signalIndex);
+        static int  _signalIndex(const QMetaMethod & method);
+
+        QMutex                          _mutex;
+        QHash<SignalKey_t, QString>     _signals;           ///< Registered signals, keyed by declaring class
+        QHash<SignalKey_t, SignalKey_t> _resolvedSignals;   ///< Sender class to registered signal, invalid key for not compressed
+        QHash<SignalKey_t, quint64>     _mergedCounts;
+        QHash<PendingKey_t, qsizetype>  _pendingIndices;    ///< Posted event list index each call was last seen at, only a hint
+
+        static constexpr int _maxPendingIndices = 1000;
     };
 
     CompressedSignalList _compressedSignals;
@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCStartupScheduler.h"
+#include "QGCLoggingCategory.h"
+#include "QGCTrace.h"
+
+#include <QtCore/QTimer>
+#include <QtQuick/QQuickWindow>
+
+QGC_LOGGING_CATEGORY(QGCStartupSchedulerLog, "qgc.qgcstartupscheduler")
+
+QGCStartupScheduler::QGCStartupScheduler(QObject* parent)
+    : QObject(parent)
+{
+    _clock.start();
+}
+
+QGCStartupScheduler::Step::Step(QGCStartupScheduler* scheduler, const char* name)
+    : _scheduler(scheduler)
+    , _name(name)
+    , _startNSecs(scheduler->_clock.nsecsElapsed())
+{
+
+}
+
+QGCStartupScheduler::Step::~Step()
+{
+    _scheduler->_recordStep(_name, _startNSecs, _scheduler->_clock.nsecsElapsed());
+}
+
+void QGCStartupScheduler::_recordStep(const char* name, qint64 startNSecs, qint64 endNSecs)
+{
+    _timeline.append({ name, startNSecs / 1e6, (endNSecs - startNSecs) / 1e6, _firstFrameShown });
+
+    if (QGCTrace::supported()) {
+        const qint64 offsetNSecs = QGCTrace::nowNsecs() - _clock.nsecsElapsed();
+        QGCTrace::record(name, offsetNSecs + startNSecs, offsetNSecs + endNSecs);
+    }
+}
+
+void QGCStartupScheduler::addDeferredTask(const char* name, std::function<void()> task, const QStringList& dependsOn)
+{
+    _tasks.append({ name, std::move(task), dependsOn });
+}
+
+void QGCStartupScheduler::start(QQuickWindow* window)
+{
+    if (window) {
+        // frameSwapped comes from the render thread, the connection queues it to us
+        (void) connect(window, &QQuickWindow::frameSwapped, this, &QGCStartupScheduler::_firstFrame, Qt::SingleShotConnection);
+    } else {
+        QTimer::singleShot(0, this, &QGCStartupScheduler::_firstFrame);
+    }
+}
+
+void QGCStartupScheduler::_firstFrame(void)
+{
+    if (_firstFrameShown) {
+        return;
+    }
+    _firstFrameShown = true;
+    qCDebug(QGCStartupSchedulerLog) << "First frame at" << _clock.elapsed() << "msecs";
+
+    _runNextTask();
+}
+
+void QGCStartupScheduler::_runNextTask(void)
+{
+    if (_tasks.isEmpty()) {
+        if (!_complete) {
+            _complete = true;
+            _logTimeline();
+            emit completed();
+        }
+        return;
+    }
+
+    qsizetype readyIndex = -1;
+    for (qsizetype i=0; i<_tasks.count(); i++) {
+        bool ready = true;
+        for (const QString& dependency: _tasks[i].dependsOn) {
+            if (!_finishedTasks.contains(dependency)) {
+                ready = false;
+                break;
+            }
+        }
+        if (ready) {
+            readyIndex = i;
+            break;
+        }
+    }
+    if (readyIndex == -1) {
+        // Only a dependency on a task which was never added gets here, running in order beats not running at all
+        qCWarning(QGCStartupSchedulerLog) << "Unresolved dependencies for" << _tasks.first().name << _tasks.first().dependsOn;
+        readyIndex = 0;
+    }
+
+    const Task_t task = _tasks.takeAt(readyIndex);
+    {
+        const Step step(this, task.name);
+        task.task();
+    }
+    _finishedTasks.insert(QString::fromUtf8(task.name));
+
+    // Give the event loop a turn between tasks
+    QTimer::singleShot(0, this, &QGCStartupScheduler::_runNextTask);
+}
+
+void QGCStartupScheduler::_logTimeline(void)
+{
+    for (const Step_t& step: _timeline) {
+        qCDebug(QGCStartupSchedulerLog) << qPrintable(QStringLiteral("%1 %2 ms %3 ms%4")
+            .arg(QString::fromUtf8(step.name), -32)
+            .arg(step.startMSecs, 8, 'f', 1)
+            .arg(step.durationMSecs, 7, 'f', 1)
+            .arg(step.deferred ? QStringLiteral(" (deferred)") : QString()));
+    }
+    qCDebug(QGCStartupSchedulerLog) << "Startup complete at" << _clock.elapsed() << "msecs";
+}
@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+
+#include <functional>
+
+class QQuickWindow;
+
+Q_DECLARE_LOGGING_CATEGORY(QGCStartupSchedulerLog)
+
+/// Keeps the work done before the main window shows its first frame down to what the window needs. Everything else is
+/// added as a deferred task which runs once the first frame is up, one task per event loop pass so the UI stays
+/// responsive. A task only runs after the tasks it depends on. Startup steps, deferred or not, are recorded in a
+/// timeline which is logged once all deferred tasks have run and is shown on the Performance page.
+class QGCStartupScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    QGCStartupScheduler(QObject* parent = nullptr);
+
+    typedef struct {
+        const char* name;
+        double      startMSecs;     ///< Since the scheduler was created, which is right at application start
+        double      durationMSecs;
+        bool        deferred;       ///< true: ran after the first frame
+    } Step_t;
+
+    /// Records the time spent in the enclosing scope as a startup step
+    class Step
+    {
+    public:
+        ///     @param name String literal, only the pointer is stored
+        Step(QGCStartupScheduler* scheduler, const char* name);
+        ~Step();
+
+        Step(const Step&) = delete;
+        Step& operator=(const Step&) = delete;
+
+    private:
+        QGCStartupScheduler*    _scheduler;
+        const char*             _name;
+        qint64                  _startNSecs;
+    };
+
+    ///     @param name String literal, only the pointer is stored
+    ///     @param dependsOn Names of deferred tasks which must run first
+    void addDeferredTask(const char* name, std::function<void()> task, const QStringList& dependsOn = QStringList());
+
+    /// Runs the deferred tasks once the window has shown its first frame, right away if there is no window
+    void start(QQuickWindow* window);
+
+    QList<Step_t>   timeline    (void) const { return _timeline; }
+    bool            complete    (void) const { return _complete; }
+
+signals:
+    /// All deferred tasks have run
+    void completed(void);
+
+private slots:
+    void _firstFrame    (void);
+    void _runNextTask   (void);
+
+private:
+    typedef struct {
+        const char*             name;
+        std::function<void()>   task;
+        QStringList             dependsOn;
+    } Task_t;
+
+    void _recordStep    (const char* name, qint64 startNSecs, qint64 endNSecs);
+    void _logTimeline   (void);
+
+    QElapsedTimer   _clock;
+    QList<Task_t>   _tasks;
+    QSet<QString>   _finishedTasks;
+    QList<Step_t>   _timeline;
+    bool            _firstFrameShown    = false;
+    bool            _complete           = false;
+};
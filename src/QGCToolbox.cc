@@ -23,6 +23,7 @@
 #include "QGCCorePlugin.h"
 #include "SettingsManager.h"
 #include "QGCApplication.h"
+#include "QGCStartupScheduler.h"
 #ifndef QGC_AIRLINK_DISABLED
 #include "AirLinkManager.h"
 #endif
@@ -35,33 +36,35 @@
 #include "UTMSPManager.h"
 #endif
 
+template <typename T>
+T* QGCToolbox::_createTool(QGCApplication* app, const char* name)
+{
+    const QGCStartupScheduler::Step step(app->startupScheduler(), name);
+    return new T(app, this);
+}
+
 QGCToolbox::QGCToolbox(QGCApplication* app)
     : QObject(app)
 {
     // SettingsManager must be first so settings are available to any subsequent tools
-    _settingsManager        = new SettingsManager           (app, this);
+    _settingsManager        = _createTool<SettingsManager>          (app, "SettingsManager");
 
     //-- Scan and load plugins
     _scanAndLoadPlugins(app);
-    _firmwarePluginManager  = new FirmwarePluginManager     (app, this);
+    _firmwarePluginManager  = _createTool<FirmwarePluginManager>    (app, "FirmwarePluginManager");
 #ifndef NO_SERIAL_LINK
-    _gpsManager             = new GPSManager                (app, this);
-#endif
-    _joystickManager        = new JoystickManager           (app, this);
-    _linkManager            = new LinkManager               (app, this);
-    _mavlinkProtocol        = new MAVLinkProtocol           (app, this);
-    _missionCommandTree     = new MissionCommandTree        (app, this);
-    _multiVehicleManager    = new MultiVehicleManager       (app, this);
-    _qgcPositionManager     = new QGCPositionManager        (app, this);
-    _videoManager           = new VideoManager              (app, this);
-
-    _mavlinkLogManager      = new MAVLinkLogManager         (app, this);
-#ifndef QGC_AIRLINK_DISABLED
-    _airlinkManager         = new AirLinkManager            (app, this);
-#endif
-#ifdef QGC_UTM_ADAPTER
-    _utmspManager            = new UTMSPManager               (app, this);
+    _gpsManager             = _createTool<GPSManager>               (app, "GPSManager");
 #endif
+    _joystickManager        = _createTool<JoystickManager>          (app, "JoystickManager");
+    _linkManager            = _createTool<LinkManager>              (app, "LinkManager");
+    _mavlinkProtocol        = _createTool<MAVLinkProtocol>          (app, "MAVLinkProtocol");
+    _missionCommandTree     = _createTool<MissionCommandTree>       (app, "MissionCommandTree");
+    _multiVehicleManager    = _createTool<MultiVehicleManager>      (app, "MultiVehicleManager");
+    _qgcPositionManager     = _createTool<QGCPositionManager>       (app, "QGCPositionManager");
+    _videoManager           = _createTool<VideoManager>             (app, "VideoManager");
+
+    // MAVLinkLogManager, AirLinkManager and UTMSPManager are not needed to show the main window, they are created
+    // on first use
 }
 
 void QGCToolbox::setChildToolboxes(void)
@@ -81,14 +84,39 @@ void QGCToolbox::setChildToolboxes(void)
     _multiVehicleManager->setToolbox(this);
     _qgcPositionManager->setToolbox(this);
     _videoManager->setToolbox(this);
-    _mavlinkLogManager->setToolbox(this);
+}
+
+MAVLinkLogManager* QGCToolbox::mavlinkLogManager()
+{
+    // Loads the list of logs from disk, which is slow on some devices
+    if (!_mavlinkLogManager) {
+        _mavlinkLogManager = _createTool<MAVLinkLogManager>(qgcApp(), "MAVLinkLogManager");
+        _mavlinkLogManager->setToolbox(this);
+    }
+    return _mavlinkLogManager;
+}
+
 #ifndef QGC_AIRLINK_DISABLED
-    _airlinkManager->setToolbox(this);
+AirLinkManager* QGCToolbox::airlinkManager()
+{
+    if (!_airlinkManager) {
+        _airlinkManager = _createTool<AirLinkManager>(qgcApp(), "AirLinkManager");
+        _airlinkManager->setToolbox(this);
+    }
+    return _airlinkManager;
+}
 #endif
+
 #ifdef QGC_UTM_ADAPTER
-    _utmspManager->setToolbox(this);
-#endif
+UTMSPManager* QGCToolbox::utmspManager()
+{
+    if (!_utmspManager) {
+        _utmspManager = _createTool<UTMSPManager>(qgcApp(), "UTMSPManager");
+        _utmspManager->setToolbox(this);
+    }
+    return _utmspManager;
 }
+#endif
 
 void QGCToolbox::_scanAndLoadPlugins(QGCApplication* app)
 {
@@ -48,22 +48,24 @@ public:
     MultiVehicleManager*        multiVehicleManager     () { return _multiVehicleManager; }
     QGCPositionManager*         qgcPositionManager      () { return _qgcPositionManager; }
     VideoManager*               videoManager            () { return _videoManager; }
-    MAVLinkLogManager*          mavlinkLogManager       () { return _mavlinkLogManager; }
+    MAVLinkLogManager*          mavlinkLogManager       ();
     QGCCorePlugin*              corePlugin              () { return _corePlugin; }
     SettingsManager*            settingsManager         () { return _settingsManager; }
 #ifndef NO_SERIAL_LINK
     GPSManager*                 gpsManager              () { return _gpsManager; }
 #endif
 #ifndef QGC_AIRLINK_DISABLED
-    AirLinkManager*              airlinkManager          () { return _airlinkManager; }
+    AirLinkManager*              airlinkManager          ();
 #endif
 #ifdef QGC_UTM_ADAPTER
-    UTMSPManager*                utmspManager             () { return _utmspManager; }
+    UTMSPManager*                utmspManager             ();
 #endif
 
 private:
     void setChildToolboxes(void);
     void _scanAndLoadPlugins(QGCApplication *app);
+    template <typename T>
+    T* _createTool(QGCApplication* app, const char* name);
 
     FirmwarePluginManager*      _firmwarePluginManager  = nullptr;
 #ifndef NO_SERIAL_LINK
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "AppLogWriter.h"
+
+#include <QtCore/QDir>
+
+#include <cstring>
+
+// Nothing in here may log through the Qt message handler, it would feed back into the ring
+
+AppLogWriter::AppLogWriter(QObject* parent)
+    : QThread(parent)
+    , _slots(new Slot_t[_slotCount])
+{
+    for (quint64 i = 0; i < _slotCount; i++) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _clock.start();
+}
+
+AppLogWriter::~AppLogWriter()
+{
+    stop();
+}
+
+bool AppLogWriter::queueLine(QString line)
+{
+    // Per second budget, the window is restarted by whichever thread first sees it expire
+    const qint64 nowMsecs = _clock.elapsed();
+    qint64 windowMsecs = _budgetWindowMsecs.load(std::memory_order_relaxed);
+    if (((nowMsecs - windowMsecs) >= 1000) && _budgetWindowMsecs.compare_exchange_strong(windowMsecs, nowMsecs, std::memory_order_relaxed)) {
+        _budgetUsed.store(0, std::memory_order_relaxed);
+    }
+    if (_budgetUsed.fetch_add(1, std::memory_order_relaxed) >= _maxLinesPerSecond) {
+        _droppedLines.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Claim a slot, the slot sequence tells whether the consumer has released it yet
+    quint64 position = _enqueuePosition.load(std::memory_order_relaxed);
+    Slot_t* slot;
+    for (;;) {
+        slot = &_slots[position & (_slotCount - 1)];
+        const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        const qint64 diff = static_cast<qint64>(sequence - position);
+        if (diff == 0) {
+            if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Full
+            _droppedLines.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->line = std::move(line);
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool AppLogWriter::_popLine(QString& line)
+{
+    Slot_t& slot = _slots[_dequeuePosition & (_slotCount - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != (_dequeuePosition + 1)) {
+        return false;
+    }
+
+    line = std::move(slot.line);
+    slot.line = QString();
+    slot.sequence.store(_dequeuePosition + _slotCount, std::memory_order_release);
+    _dequeuePosition++;
+
+    return true;
+}
+
+void AppLogWriter::setSpillDirectory(const QString& directory)
+{
+    QMutexLocker locker(&_requestMutex);
+    _spillDirectoryRequest = directory;
+}
+
+void AppLogWriter::requestDump(const QString& fileName)
+{
+    QMutexLocker locker(&_requestMutex);
+    _dumpRequest = fileName;
+}
+
+void AppLogWriter::stop(void)
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    _stopRequested = true;
+    wait();
+}
+
+void AppLogWriter::run(void)
+{
+    while (!_stopRequested) {
+        QString spillDirectory;
+        QString dumpFileName;
+        {
+            QMutexLocker locker(&_requestMutex);
+            spillDirectory.swap(_spillDirectoryRequest);
+            dumpFileName.swap(_dumpRequest);
+        }
+
+        if (!spillDirectory.isEmpty()) {
+            _spilling = _openSpill(spillDirectory);
+        }
+
+        _drain();
+
+        if (!dumpFileName.isEmpty()) {
+            emit dumpStarted();
+            emit dumpFinished(_dump(dumpFileName));
+        }
+
+        QThread::msleep(_drainIntervalMsecs);
+    }
+
+    _drain();
+    _closeSpill();
+}
+
+void AppLogWriter::_drain(void)
+{
+    QStringList lines;
+    QString line;
+    while (_popLine(line)) {
+        _spillLine(line);
+        lines.append(std::move(line));
+    }
+
+    const quint64 dropped = _droppedLines.exchange(0, std::memory_order_relaxed);
+    if (dropped != 0) {
+        const QString summary = QStringLiteral("[!] %1 log lines dropped, logging exceeded %2 lines per second").arg(dropped).arg(_maxLinesPerSecond);
+        _spillLine(summary);
+        lines.append(summary);
+    }
+
+    if (!lines.isEmpty()) {
+        emit linesAvailable(lines);
+    }
+}
+
+bool AppLogWriter::_openSpill(const QString& directory)
+{
+    _closeSpill();
+
+    const QDir dir(directory);
+    _previousSpillFileName = dir.absoluteFilePath(QStringLiteral("QGCConsole.1.log"));
+    (void) QFile::remove(_previousSpillFileName);
+
+    _spillFile.setFileName(dir.absoluteFilePath(QStringLiteral("QGCConsole.log")));
+    if (!_spillFile.open(QIODevice::ReadWrite | QIODevice::Truncate) || !_spillFile.resize(_spillSegmentSize)) {
+        _spillFile.close();
+        return false;
+    }
+
+    _spillMap = _spillFile.map(0, _spillSegmentSize);
+    if (!_spillMap) {
+        _spillFile.close();
+        return false;
+    }
+    _spillPosition = 0;
+
+    return true;
+}
+
+void AppLogWriter::_closeSpill(void)
+{
+    if (!_spillFile.isOpen()) {
+        return;
+    }
+
+    if (_spillMap) {
+        (void) _spillFile.unmap(_spillMap);
+        _spillMap = nullptr;
+    }
+
+    // Drop the unused tail of the preallocated segment
+    (void) _spillFile.resize(_spillPosition);
+    _spillFile.close();
+}
+
+/// Moves the full segment to QGCConsole.1.log and starts a new one
+///     @return false: new segment could not be created, spilling stops
+bool AppLogWriter::_rotateSpill(void)
+{
+    const QString fileName = _spillFile.fileName();
+    _closeSpill();
+
+    (void) QFile::remove(_previousSpillFileName);
+    (void) QFile::rename(fileName, _previousSpillFileName);
+
+    _spillFile.setFileName(fileName);
+    if (!_spillFile.open(QIODevice::ReadWrite | QIODevice::Truncate) || !_spillFile.resize(_spillSegmentSize)) {
+        _spillFile.close();
+        _spilling = false;
+        return false;
+    }
+
+    _spillMap = _spillFile.map(0, _spillSegmentSize);
+    if (!_spillMap) {
+        _spillFile.close();
+        _spilling = false;
+        return false;
+    }
+    _spillPosition = 0;
+
+    return true;
+}
+
+void AppLogWriter::_spillLine(const QString& line)
+{
+    if (!_spillMap) {
+        return;
+    }
+
+    QByteArray bytes = line.toUtf8();
+    bytes.append('\n');
+    if (bytes.size() > _spillSegmentSize) {
+        bytes.truncate(_spillSegmentSize - 1);
+        bytes.append('\n');
+    }
+
+    if (((_spillPosition + bytes.size()) > _spillSegmentSize) && !_rotateSpill()) {
+        return;
+    }
+
+    memcpy(_spillMap + _spillPosition, bytes.constData(), bytes.size());
+    _spillPosition += bytes.size();
+}
+
+bool AppLogWriter::_dump(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QFile previous(_previousSpillFileName);
+    if (previous.open(QIODevice::ReadOnly)) {
+        while (!previous.atEnd()) {
+            const QByteArray block = previous.read(64 * 1024);
+            if (file.write(block) != block.size()) {
+                return false;
+            }
+        }
+    }
+
+    if (_spillMap && (file.write(reinterpret_cast<const char*>(_spillMap), _spillPosition) != _spillPosition)) {
+        return false;
+    }
+
+    return file.flush();
+}
@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+
+#include <atomic>
+#include <memory>
+
+/// Collects application log lines from any thread and hands them to the console model and a spill file from its own
+/// thread. Lines are queued into a preallocated multi producer/single consumer ring of slots, so logging never takes a
+/// lock or waits on the GUI thread. The writer thread drains the ring at a fixed interval, appends the lines to a
+/// memory mapped spill file which rotates once full, and passes them to the model as one batch per interval.
+///
+/// Logging is rate limited: lines beyond the per second budget, or while the ring is full, are dropped and reported
+/// as a single summary line.
+class AppLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    AppLogWriter(QObject* parent = nullptr);
+    ~AppLogWriter();
+
+    /// Queues a line, safe to call from any thread including the Qt message handler
+    /// @return false: line was dropped
+    bool queueLine(QString line);
+
+    /// Starts spilling to QGCConsole.log in the specified directory, the previous segment is kept as QGCConsole.1.log
+    void setSpillDirectory(const QString& directory);
+
+    /// @return true: the spill file is open, dumps include everything spilled this session
+    bool spilling(void) const { return _spilling; }
+
+    /// Copies the spilled lines to fileName from the writer thread
+    void requestDump(const QString& fileName);
+
+    void stop(void);
+
+    // QThread overrides
+    void run(void) override;
+
+signals:
+    /// Emitted from the writer thread with the lines queued since the last batch
+    void linesAvailable(const QStringList& lines);
+    void dumpStarted(void);
+    void dumpFinished(bool success);
+
+private:
+    typedef struct {
+        std::atomic<quint64>    sequence;
+        QString                 line;
+    } Slot_t;
+
+    bool _popLine       (QString& line);
+    void _drain         (void);
+    bool _openSpill     (const QString& directory);
+    void _closeSpill    (void);
+    bool _rotateSpill   (void);
+    void _spillLine     (const QString& line);
+    bool _dump          (const QString& fileName);
+
+    std::unique_ptr<Slot_t[]>   _slots;
+    std::atomic<quint64>        _enqueuePosition { 0 };
+    quint64                     _dequeuePosition = 0;           ///< Only used by the writer thread
+    std::atomic<qint64>         _budgetWindowMsecs { 0 };
+    std::atomic<int>            _budgetUsed { 0 };
+    std::atomic<quint64>        _droppedLines { 0 };
+    std::atomic_bool            _stopRequested { false };
+    std::atomic_bool            _spilling { false };
+    QElapsedTimer               _clock;
+
+    QMutex                      _requestMutex;                  ///< Protects the requests below
+    QString                     _spillDirectoryRequest;
+    QString                     _dumpRequest;
+
+    // Spill file, only used by the writer thread
+    QFile                       _spillFile;
+    QString                     _previousSpillFileName;
+    uchar*                      _spillMap = nullptr;
+    qint64                      _spillPosition = 0;
+
+    static constexpr quint64    _slotCount              = 16384;            ///< Must be a power of two
+    static constexpr int        _maxLinesPerSecond      = 2000;
+    static constexpr qint64     _spillSegmentSize       = 4 * 1024 * 1024;
+    static constexpr int        _drainIntervalMsecs     = 100;
+};
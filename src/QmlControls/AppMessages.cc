@@ -17,7 +17,6 @@
 #include "SettingsManager.h"
 #include "AppSettings.h"
 
-#include <QtCore/QStringListModel>
 #include <QtConcurrent/QtConcurrent>
 #include <QtCore/QTextStream>
 
@@ -32,7 +31,7 @@ static void msgHandler(QtMsgType type, const QMessageLogContext &context, const
 
     // Avoid recursion
     if (!QString(context.category).startsWith("qt.quick")) {
-        debug_model->log(output);
+        AppLogModel::log(output);
     }
 
     if (old_handler != nullptr) {
@@ -54,19 +53,29 @@ AppLogModel *AppMessages::getModel()
     return debug_model;
 }
 
-AppLogModel::AppLogModel() : QStringListModel()
+AppLogModel::AppLogModel() : QAbstractListModel()
 {
-#ifdef __mobile__
-    Qt::ConnectionType contype = Qt::QueuedConnection;
-#else
-    Qt::ConnectionType contype = Qt::AutoConnection;
-#endif
-    connect(this, &AppLogModel::emitLog, this, &AppLogModel::threadsafeLog, contype);
+    connect(&_writer, &AppLogWriter::linesAvailable, this, &AppLogModel::_linesAvailable, Qt::QueuedConnection);
+    connect(&_writer, &AppLogWriter::dumpStarted, this, &AppLogModel::writeStarted, Qt::QueuedConnection);
+    connect(&_writer, &AppLogWriter::dumpFinished, this, &AppLogModel::writeFinished, Qt::QueuedConnection);
+
+    _writer.start(QThread::LowPriority);
+}
+
+AppLogModel::~AppLogModel()
+{
+    _writer.stop();
 }
 
 void AppLogModel::writeMessages(const QString dest_file)
 {
-    const QString writebuffer(stringList().join('\n').append('\n'));
+    if (_writer.spilling()) {
+        _writer.requestDump(dest_file);
+        return;
+    }
+
+    // No spill file, only the lines still in memory can be saved
+    const QString writebuffer(_lines.join('\n').append('\n'));
 
     QFuture<void> future = QtConcurrent::run([dest_file, writebuffer] {
         emit debug_model->writeStarted();
@@ -85,34 +94,55 @@ void AppLogModel::writeMessages(const QString dest_file)
 
 void AppLogModel::log(const QString message)
 {
-    emit debug_model->emitLog(message);
+    if (debug_model.isDestroyed()) {
+        return;
+    }
+
+    (void) debug_model->_writer.queueLine(message);
 }
 
-void AppLogModel::threadsafeLog(const QString message)
+void AppLogModel::_linesAvailable(const QStringList &lines)
 {
-    const int line = rowCount();
-    insertRows(line, 1);
-    setData(index(line), message, Qt::DisplayRole);
-
-    if (qgcApp() && qgcApp()->logOutput() && _logFile.fileName().isEmpty()) {
-        qDebug() << _logFile.fileName().isEmpty() << qgcApp()->logOutput();
+    if (!_spillRequested && qgcApp()) {
         QGCToolbox* toolbox = qgcApp()->toolbox();
         // Be careful of toolbox not being open yet
         if (toolbox) {
-            QString saveDirPath = qgcApp()->toolbox()->settingsManager()->appSettings()->crashSavePath();
-            QDir saveDir(saveDirPath);
-            QString saveFilePath = saveDir.absoluteFilePath(QStringLiteral("QGCConsole.log"));
-
-            _logFile.setFileName(saveFilePath);
-            if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                qgcApp()->showAppMessage(tr("Open console log output file failed %1 : %2").arg(_logFile.fileName()).arg(_logFile.errorString()));
-            }
+            _writer.setSpillDirectory(toolbox->settingsManager()->appSettings()->crashSavePath());
+            _spillRequested = true;
         }
     }
 
-    if (_logFile.isOpen()) {
-        QTextStream out(&_logFile);
-        out << message << "\n";
-        _logFile.flush();
+    // Only the newest lines are kept, the batch itself may be larger than the limit
+    const int keepFromBatch = qMin(static_cast<int>(lines.count()), _maxLines);
+    const int removeCount = qMin(static_cast<int>(_lines.count()), (static_cast<int>(_lines.count()) + keepFromBatch) - _maxLines);
+    if (removeCount > 0) {
+        beginRemoveRows(QModelIndex(), 0, removeCount - 1);
+        _lines.remove(0, removeCount);
+        endRemoveRows();
     }
+
+    const int firstRow = static_cast<int>(_lines.count());
+    beginInsertRows(QModelIndex(), firstRow, firstRow + keepFromBatch - 1);
+    _lines.append(lines.mid(lines.count() - keepFromBatch));
+    endInsertRows();
+}
+
+int AppLogModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+
+    return static_cast<int>(_lines.count());
+}
+
+QVariant AppLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() < 0) || (index.row() >= _lines.count())) {
+        return QVariant();
+    }
+
+    if ((role == Qt::DisplayRole) || (role == Qt::EditRole)) {
+        return _lines[index.row()];
+    }
+
+    return QVariant();
 }
@@ -10,31 +10,44 @@
 
 #pragma once
 
-#include <QtCore/QStringListModel>
-#include <QtCore/QFile>
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QStringList>
+
+#include "AppLogWriter.h"
 
 // Hackish way to force only this translation unit to have public ctor access
 #ifndef _LOG_CTOR_ACCESS_
 #define _LOG_CTOR_ACCESS_ private
 #endif
 
-class AppLogModel : public QStringListModel
+/// Console log lines shown in the app messages panel. Lines arrive in batches from the AppLogWriter thread and only
+/// the most recent ones are kept in memory, the complete session log is in the spill file.
+class AppLogModel : public QAbstractListModel
 {
     Q_OBJECT
 public:
+    ~AppLogModel();
+
     Q_INVOKABLE void writeMessages(const QString dest_file);
     static void log(const QString message);
 
+    // Overrides from QAbstractListModel
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
 signals:
-    void emitLog(const QString message);
     void writeStarted();
     void writeFinished(bool success);
 
 private slots:
-    void threadsafeLog(const QString message);
+    void _linesAvailable(const QStringList &lines);
 
 private:
-    QFile _logFile;
+    AppLogWriter _writer;
+    QStringList _lines;
+    bool _spillRequested = false;
+
+    static constexpr int _maxLines = 10000;
 
 _LOG_CTOR_ACCESS_:
     AppLogModel();
@@ -38,7 +38,7 @@ Item {
             Connections {
                 target: debugMessageModel
 
-                onDataChanged: {
+                onRowsInserted: {
                     // Keep the view in sync if the button is checked
                     if (loaded) {
                         if (followTail.checked) {
@@ -105,9 +105,30 @@ Item {
                 text:            qsTr("Save App Log")
             }
 
+            QGCFileDialog {
+                id:             traceDialog
+                folder:         QGroundControl.settingsManager.appSettings.logSavePath
+                nameFilters:    [qsTr("Trace files (*.json)"), qsTr("All Files (*)")]
+                title:          qsTr("Select trace save file")
+                onAcceptedForSave: (file) => {
+                    QGroundControl.saveTrace(file);
+                    visible = false;
+                }
+            }
+
+            QGCButton {
+                id:                 traceButton
+                anchors.bottom:     parent.bottom
+                anchors.left:       writeButton.right
+                anchors.leftMargin: ScreenTools.defaultFontPixelWidth
+                onClicked:          traceDialog.openForSave()
+                text:               qsTr("Save Trace")
+                visible:            QGroundControl.traceSupported
+            }
+
             QGCLabel {
                 id:                     gstLabel
-                anchors.left:           writeButton.right
+                anchors.left:           traceButton.visible ? traceButton.right : writeButton.right
                 anchors.leftMargin:     ScreenTools.defaultFontPixelWidth
                 anchors.verticalCenter: gstCombo.verticalCenter
                 text:                   qsTr("GStreamer Debug Level")
@@ -48,4 +48,52 @@ ColumnLayout {
     ProgressBar {
         value: _autotuneManager.autotuneProgress
     }
+
+    GridLayout {
+        columns:        4
+        columnSpacing:  _margins
+        visible:        _autotuneManager.gainComparison.length > 0
+
+        QGCLabel { text: qsTr("Axis") }
+        QGCLabel { text: qsTr("Gain") }
+        QGCLabel { text: qsTr("Before") }
+        QGCLabel { text: qsTr("After") }
+
+        Repeater {
+            model: _autotuneManager.gainComparison
+
+            delegate: QGCLabel {
+                Layout.row:     index + 1
+                Layout.column:  0
+                text:           modelData.axis
+            }
+        }
+        Repeater {
+            model: _autotuneManager.gainComparison
+
+            delegate: QGCLabel {
+                Layout.row:     index + 1
+                Layout.column:  1
+                text:           modelData.gain
+            }
+        }
+        Repeater {
+            model: _autotuneManager.gainComparison
+
+            delegate: QGCLabel {
+                Layout.row:     index + 1
+                Layout.column:  2
+                text:           isNaN(modelData.before) ? "-" : modelData.before.toPrecision(4)
+            }
+        }
+        Repeater {
+            model: _autotuneManager.gainComparison
+
+            delegate: QGCLabel {
+                Layout.row:     index + 1
+                Layout.column:  3
+                text:           isNaN(modelData.after) ? "-" : modelData.after.toPrecision(4)
+            }
+        }
+    }
 }
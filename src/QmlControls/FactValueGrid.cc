@@ -16,6 +16,7 @@
 
 #include <QtCore/QSettings>
 #include <QtCore/QDir>
+#include <QtQuick/QQuickWindow>
 
 QStringList FactValueGrid::_iconNames;
 
@@ -57,6 +58,50 @@ void FactValueGrid::_init(void)
     _vehicleClass = QGCMAVLink::vehicleClass(offlineVehicle->vehicleType());
 }
 
+void FactValueGrid::itemChange(ItemChange change, const ItemChangeData& data)
+{
+    if (change == ItemSceneChange) {
+        disconnect(_frameConnection);
+        if (data.window) {
+            _frameConnection = connect(data.window, &QQuickWindow::afterAnimating, this, &FactValueGrid::_updateQueuedRanges);
+        } else {
+            _updateQueuedRanges();
+        }
+    }
+
+    QQuickItem::itemChange(change, data);
+}
+
+void FactValueGrid::_queueRangeUpdate(InstrumentValueData* value)
+{
+    QQuickWindow* const quickWindow = window();
+    if (!quickWindow) {
+        value->_updateRanges();
+        return;
+    }
+
+    if (!value->_rangeUpdateQueued) {
+        value->_rangeUpdateQueued = true;
+        if (_queuedRangeUpdates.isEmpty()) {
+            quickWindow->update();
+        }
+        _queuedRangeUpdates.append(value);
+    }
+}
+
+void FactValueGrid::_updateQueuedRanges(void)
+{
+    const QList<QPointer<InstrumentValueData>> queuedRangeUpdates = _queuedRangeUpdates;
+    _queuedRangeUpdates.clear();
+
+    for (InstrumentValueData* value: queuedRangeUpdates) {
+        if (value) {
+            value->_rangeUpdateQueued = false;
+            value->_updateRanges();
+        }
+    }
+}
+
 void FactValueGrid::_offlineVehicleTypeChanged(void)
 {
     Vehicle*                    offlineVehicle  = qgcApp()->toolbox()->multiVehicleManager()->offlineEditingVehicle();
@@ -12,6 +12,7 @@
 #include "QmlObjectListModel.h"
 #include "QGCMAVLink.h"
 
+#include <QtCore/QPointer>
 #include <QtCore/QSettings>
 #include <QtQuick/QQuickItem>
 
@@ -73,6 +74,11 @@ public:
     // Override from QQmlParserStatus
     void componentComplete(void) final;
 
+    /// Called by InstrumentValueData when the value of its Fact changed. The range semantics of all values which changed
+    /// are updated together once per frame, right before the frame is synchronized. Without a window they are updated
+    /// right away.
+    void _queueRangeUpdate(InstrumentValueData* value);
+
 signals:
     void userSettingsGroupChanged   (const QString& userSettingsGroup);
     void defaultSettingsGroupChanged(const QString& defaultSettingsGroup);
@@ -83,6 +89,9 @@ signals:
 protected:
     Q_DISABLE_COPY(FactValueGrid)
 
+    // Override from QQuickItem
+    void itemChange(ItemChange change, const ItemChangeData& data) override;
+
     QGCMAVLink::VehicleClass_t  _vehicleClass           = QGCMAVLink::VehicleClassGeneric;
     QString                     _defaultSettingsGroup;                                      // Settings group to read from if the user has not modified from the default settings
     QString                     _userSettingsGroup;                                         // Settings group to read from for user modified settings
@@ -93,6 +102,7 @@ protected:
 
 private slots:
     void _offlineVehicleTypeChanged(void);
+    void _updateQueuedRanges       (void);
 
 private:
     InstrumentValueData*    _createNewInstrumentValueWorker (QObject* parent);
@@ -104,6 +114,9 @@ private:
     void                    _loadValueData                  (QSettings& settings, InstrumentValueData* value);
 
     // These are user facing string for the various enums.
+    QList<QPointer<InstrumentValueData>>    _queuedRangeUpdates;
+    QMetaObject::Connection                 _frameConnection;
+
     static       QStringList _iconNames;
     static const QStringList _fontSizeNames;
 
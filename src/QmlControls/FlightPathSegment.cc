@@ -11,8 +11,12 @@
 #include "QGC.h"
 #include "QGCLoggingCategory.h"
 
+#include <cmath>
+
 QGC_LOGGING_CATEGORY(FlightPathSegmentLog, "FlightPathSegmentLog")
 
+quint64 FlightPathSegment::_nextTerrainHeightsSerial = 1;
+
 FlightPathSegment::FlightPathSegment(SegmentType segmentType, const QGeoCoordinate& coord1, double amslCoord1Alt, const QGeoCoordinate& coord2, double amslCoord2Alt, bool queryTerrainData, QObject* parent)
     : QObject           (parent)
     , _coord1           (coord1)
@@ -20,6 +24,7 @@ FlightPathSegment::FlightPathSegment(SegmentType segmentType, const QGeoCoordina
     , _coord1AMSLAlt     (amslCoord1Alt)
     , _coord2AMSLAlt     (amslCoord2Alt)
     , _queryTerrainData (queryTerrainData)
+    , _terrainHeightsSerial(_nextTerrainHeightsSerial++)
     , _segmentType      (segmentType)
 {
     _delayedTerrainPathQueryTimer.setSingleShot(true);
@@ -90,12 +95,11 @@ void FlightPathSegment::_sendTerrainPathQuery(void)
         }
 
         // Clear old terrain data
-        _amslTerrainHeights.clear();
         _distanceBetween = 0;
         _finalDistanceBetween = 0;
         emit distanceBetweenChanged(0);
         emit finalDistanceBetweenChanged(0);
-        emit amslTerrainHeightsChanged();
+        _setAMSLTerrainHeights(QList<double>());
 
         _currentTerrainPathQuery = new TerrainPathQuery(true /* autoDelete */);
         connect(_currentTerrainPathQuery, &TerrainPathQuery::terrainDataReceived, this, &FlightPathSegment::_terrainDataReceived);
@@ -106,29 +110,52 @@ void FlightPathSegment::_sendTerrainPathQuery(void)
 void FlightPathSegment::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo)
 {
     qCDebug(FlightPathSegmentLog) << this << "_terrainDataReceived" << success << pathHeightInfo.heights.count();
-    if (success) {
-        if (!QGC::fuzzyCompare(pathHeightInfo.distanceBetween, _distanceBetween)) {
-            _distanceBetween = pathHeightInfo.distanceBetween;
-            emit distanceBetweenChanged(_distanceBetween);
-        }
-        if (!QGC::fuzzyCompare(pathHeightInfo.finalDistanceBetween, _finalDistanceBetween)) {
-            _finalDistanceBetween = pathHeightInfo.finalDistanceBetween;
-            emit finalDistanceBetweenChanged(_finalDistanceBetween);
-        }
-
-        _amslTerrainHeights.clear();
-        for (const double& amslTerrainHeight: pathHeightInfo.heights) {
-            _amslTerrainHeights.append(amslTerrainHeight);
-        }
-        emit amslTerrainHeightsChanged();
-    }
 
     _currentTerrainPathQuery->deleteLater();
     _currentTerrainPathQuery = nullptr;
 
+    if (success) {
+        setTerrainPathHeights(pathHeightInfo);
+    } else {
+        _updateTerrainCollision();
+    }
+}
+
+void FlightPathSegment::setTerrainPathHeights(const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo)
+{
+    if (!QGC::fuzzyCompare(pathHeightInfo.distanceBetween, _distanceBetween)) {
+        _distanceBetween = pathHeightInfo.distanceBetween;
+        emit distanceBetweenChanged(_distanceBetween);
+    }
+    if (!QGC::fuzzyCompare(pathHeightInfo.finalDistanceBetween, _finalDistanceBetween)) {
+        _finalDistanceBetween = pathHeightInfo.finalDistanceBetween;
+        emit finalDistanceBetweenChanged(_finalDistanceBetween);
+    }
+
+    _setAMSLTerrainHeights(pathHeightInfo.heights);
     _updateTerrainCollision();
 }
 
+void FlightPathSegment::_setAMSLTerrainHeights(const QList<double>& amslTerrainHeights)
+{
+    if (amslTerrainHeights.isEmpty() && _amslTerrainHeights.isEmpty()) {
+        return;
+    }
+
+    _amslTerrainHeights = amslTerrainHeights;
+    _terrainHeightsSerial = _nextTerrainHeightsSerial++;
+
+    _minAMSLTerrainHeight = qQNaN();
+    _maxAMSLTerrainHeight = qQNaN();
+    for (const double amslTerrainHeight: _amslTerrainHeights) {
+        _minAMSLTerrainHeight = std::fmin(_minAMSLTerrainHeight, amslTerrainHeight);
+        _maxAMSLTerrainHeight = std::fmax(_maxAMSLTerrainHeight, amslTerrainHeight);
+    }
+    _buildTerrainMaxPyramid();
+
+    emit amslTerrainHeightsChanged();
+}
+
 void FlightPathSegment::_updateTotalDistance(void)
 {
     double newTotalDistance = 0;
@@ -142,37 +169,76 @@ void FlightPathSegment::_updateTotalDistance(void)
     }
 }
 
+void FlightPathSegment::_buildTerrainMaxPyramid(void)
+{
+    _terrainMaxPyramid.clear();
+
+    const QList<double>* previousLevel = &_amslTerrainHeights;
+    while (previousLevel->count() > 1) {
+        QList<double> level;
+        level.reserve((previousLevel->count() + 1) / 2);
+        for (int i=0; i<previousLevel->count(); i+=2) {
+            level.append((i + 1 < previousLevel->count()) ? std::fmax((*previousLevel)[i], (*previousLevel)[i + 1]) : (*previousLevel)[i]);
+        }
+        _terrainMaxPyramid.append(level);
+        previousLevel = &_terrainMaxPyramid.last();
+    }
+}
+
+/// @return Distance from coordinate 1 to the terrain height at the specified index
+double FlightPathSegment::_terrainSampleDistance(int heightIndex) const
+{
+    // The distance between all terrain heights except for the last two is the same
+    if (heightIndex > 0 && heightIndex == _amslTerrainHeights.count() - 1) {
+        return ((heightIndex - 1) * _distanceBetween) + _finalDistanceBetween;
+    }
+    return heightIndex * _distanceBetween;
+}
+
+/// Checks the terrain heights in a node of the max pyramid against the flight path, limited to the heights from
+/// firstIndex to lastIndex. A node whose max height is below the flight path at both ends of its range is clear
+/// without looking any further, since the flight path is a straight line.
+bool FlightPathSegment::_terrainAboveFlightPath(int level, int nodeIndex, int firstIndex, int lastIndex) const
+{
+    const int fromIndex =   qMax(nodeIndex << level, firstIndex);
+    const int toIndex =     qMin(((nodeIndex + 1) << level) - 1, lastIndex);
+    if (fromIndex > toIndex) {
+        return false;
+    }
+
+    const double slope =        (_coord2AMSLAlt - _coord1AMSLAlt) / _totalDistance;
+    const double minFlightAlt = std::fmin(_coord1AMSLAlt + (slope * _terrainSampleDistance(fromIndex)), _coord1AMSLAlt + (slope * _terrainSampleDistance(toIndex)));
+    const double maxTerrain =   (level == 0) ? _amslTerrainHeights[nodeIndex] : _terrainMaxPyramid[level - 1][nodeIndex];
+    if (!(maxTerrain > minFlightAlt)) {
+        return false;
+    }
+    if (level == 0) {
+        return true;
+    }
+
+    return _terrainAboveFlightPath(level - 1, nodeIndex * 2, firstIndex, lastIndex) || _terrainAboveFlightPath(level - 1, (nodeIndex * 2) + 1, firstIndex, lastIndex);
+}
+
 void FlightPathSegment::_updateTerrainCollision(void)
 {
     bool newTerrainCollision = false;
 
-    if (_segmentType != SegmentTypeTerrainFrame) {
-        double slope =      (_coord2AMSLAlt - _coord1AMSLAlt) / _totalDistance;
-        double yIntercept = _coord1AMSLAlt;
-
-        double x = 0;
-        for (int i=0; i<_amslTerrainHeights.count(); i++) {
-            bool ignoreCollision = false;
-            if (_segmentType == SegmentTypeTakeoff && x < _collisionIgnoreMeters) {
-                ignoreCollision = true;
-            } else if (_segmentType == SegmentTypeLand && x > _totalDistance - _collisionIgnoreMeters) {
-                ignoreCollision = true;
+    if (_segmentType != SegmentTypeTerrainFrame && !_amslTerrainHeights.isEmpty()) {
+        // Skip the heights at the ends which takeoff/land segments ignore
+        int firstIndex =    0;
+        int lastIndex =     _amslTerrainHeights.count() - 1;
+        if (_segmentType == SegmentTypeTakeoff) {
+            while (firstIndex <= lastIndex && _terrainSampleDistance(firstIndex) < _collisionIgnoreMeters) {
+                firstIndex++;
             }
-
-            if (!ignoreCollision) {
-                double y = _amslTerrainHeights[i].value<double>();
-                if (y > (slope * x) + yIntercept) {
-                    newTerrainCollision = true;
-                    break;
-                }
-            }
-
-            if (i == _amslTerrainHeights.count() - 2) {
-                x += _finalDistanceBetween;
-            } else {
-                x += _distanceBetween;
+        } else if (_segmentType == SegmentTypeLand) {
+            while (lastIndex >= firstIndex && _terrainSampleDistance(lastIndex) > _totalDistance - _collisionIgnoreMeters) {
+                lastIndex--;
             }
         }
+
+        // Most edits leave the whole path well above terrain, which the top of the pyramid shows right away
+        newTerrainCollision = _terrainAboveFlightPath(_terrainMaxPyramid.count(), 0, firstIndex, lastIndex);
     }
 
     qCDebug(FlightPathSegmentLog) << this << "_updateTerrainCollision new:old" << newTerrainCollision << _terrainCollision;
@@ -40,7 +40,7 @@ public:
     Q_PROPERTY(double           coord1AMSLAlt           MEMBER _coord1AMSLAlt                                   NOTIFY coord1AMSLAltChanged)
     Q_PROPERTY(double           coord2AMSLAlt           MEMBER _coord2AMSLAlt                                   NOTIFY coord2AMSLAltChanged)
     Q_PROPERTY(bool             specialVisual           READ specialVisual              WRITE setSpecialVisual  NOTIFY specialVisualChanged)
-    Q_PROPERTY(QVariantList     amslTerrainHeights      MEMBER _amslTerrainHeights                              NOTIFY amslTerrainHeightsChanged)
+    Q_PROPERTY(QList<double>    amslTerrainHeights      READ amslTerrainHeights                                 NOTIFY amslTerrainHeightsChanged)
     Q_PROPERTY(double           distanceBetween         MEMBER _distanceBetween                                 NOTIFY distanceBetweenChanged)
     Q_PROPERTY(double           finalDistanceBetween    MEMBER _finalDistanceBetween                            NOTIFY finalDistanceBetweenChanged)
     Q_PROPERTY(double           totalDistance           MEMBER _totalDistance                                   NOTIFY totalDistanceChanged)
@@ -51,7 +51,10 @@ public:
     QGeoCoordinate      coordinate2         (void) const { return _coord2; }
     double              coord1AMSLAlt       (void) const { return _coord1AMSLAlt; }
     double              coord2AMSLAlt       (void) const { return _coord2AMSLAlt; }
-    const QVariantList& amslTerrainHeights  (void) const { return _amslTerrainHeights; }
+    const QList<double>& amslTerrainHeights (void) const { return _amslTerrainHeights; }
+    double              minAMSLTerrainHeight(void) const { return _minAMSLTerrainHeight; }   ///< NaN if there are no terrain heights
+    double              maxAMSLTerrainHeight(void) const { return _maxAMSLTerrainHeight; }   ///< NaN if there are no terrain heights
+    quint64             terrainHeightsSerial(void) const { return _terrainHeightsSerial; }   ///< Unique across all segments, changes with the terrain heights
     double              distanceBetween     (void) const { return _distanceBetween; }
     double              finalDistanceBetween(void) const { return _finalDistanceBetween; }
     double              totalDistance       (void) const { return _totalDistance; }
@@ -61,6 +64,10 @@ public:
 
     void setSpecialVisual(bool specialVisual);
 
+    /// Sets the terrain heights from a query made by the owner, for segments created without queryTerrainData which
+    /// share their terrain with other segments
+    void setTerrainPathHeights(const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo);
+
 public slots:
     void setCoordinate1     (const QGeoCoordinate& coordinate);
     void setCoordinate2     (const QGeoCoordinate& coordinate);
@@ -86,6 +93,11 @@ private slots:
     void _updateTerrainCollision    (void);
 
 private:
+    void    _setAMSLTerrainHeights      (const QList<double>& amslTerrainHeights);
+    void    _buildTerrainMaxPyramid     (void);
+    double  _terrainSampleDistance      (int heightIndex) const;
+    bool    _terrainAboveFlightPath     (int level, int nodeIndex, int firstIndex, int lastIndex) const;
+
     QGeoCoordinate      _coord1;
     QGeoCoordinate      _coord2;
     double              _coord1AMSLAlt =                qQNaN();
@@ -95,11 +107,17 @@ private:
     bool                _specialVisual =                false;
     QTimer              _delayedTerrainPathQueryTimer;
     TerrainPathQuery*   _currentTerrainPathQuery =      nullptr;
-    QVariantList        _amslTerrainHeights;
+    QList<double>       _amslTerrainHeights;
+    double              _minAMSLTerrainHeight =         qQNaN();
+    double              _maxAMSLTerrainHeight =         qQNaN();
+    quint64             _terrainHeightsSerial =         0;
+    QList<QList<double>> _terrainMaxPyramid;    ///< Level n holds the max of each block of 2^n terrain heights, level 0 is _amslTerrainHeights itself so is not stored
     double              _distanceBetween =              0;
     double              _finalDistanceBetween =         0;
     double              _totalDistance =                0;
     SegmentType         _segmentType =                  SegmentTypeGeneric;
 
+    static quint64 _nextTerrainHeightsSerial;
+
     static constexpr double _collisionIgnoreMeters =    10; // Distance to ignore for takeoff/land segments
 };
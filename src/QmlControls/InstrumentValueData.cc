@@ -16,6 +16,7 @@
 #include "MultiVehicleManager.h"
 #include "Vehicle.h"
 #include "FactGroup.h"
+#include "MAVLinkStreamSubscriptions.h"
 
 // Important: The indices of these strings must match the InstrumentValueData::RangeType enum
 const QStringList InstrumentValueData::_rangeTypeNames = {
@@ -73,6 +74,10 @@ void InstrumentValueData::_lookForMissingFact(void)
 void InstrumentValueData::clearFact(void)
 {
     _fact = nullptr;
+    if (_streamSubscriptions) {
+        _streamSubscriptions->unsubscribe(this);
+        _streamSubscriptions = nullptr;
+    }
     _factName.clear();
     _text.clear();
     _icon.clear();
@@ -90,9 +95,13 @@ void InstrumentValueData::clearFact(void)
 void InstrumentValueData::_setFactWorker(void)
 {
     if (_fact) {
-        disconnect(_fact, &Fact::rawValueChanged, this, &InstrumentValueData::_updateRanges);
+        disconnect(_fact, &Fact::rawValueChanged, this, &InstrumentValueData::_factValueChanged);
         _fact = nullptr;
     }
+    if (_streamSubscriptions) {
+        _streamSubscriptions->unsubscribe(this);
+        _streamSubscriptions = nullptr;
+    }
 
     FactGroup* factGroup = nullptr;
     if (_factGroupName == vehicleFactGroupName) {
@@ -113,7 +122,13 @@ void InstrumentValueData::_setFactWorker(void)
 
     if (_fact) {
         _factName = nonEmptyFactName;
-        connect(_fact, &Fact::rawValueChanged, this, &InstrumentValueData::_updateRanges);
+        connect(_fact, &Fact::rawValueChanged, this, &InstrumentValueData::_factValueChanged);
+
+        // Declares the messages feeding the value so the vehicle keeps sending them
+        _streamSubscriptions = _activeVehicle->streamSubscriptions();
+        if (_streamSubscriptions) {
+            _streamSubscriptions->subscribeFactGroup(this, factGroup);
+        }
     }
 
     emit factValueNamesChanged  ();
@@ -271,22 +286,33 @@ void InstrumentValueData::removeRangeValue(int index)
     emit rangeIconsChanged      (_rangeIcons);
 }
 
-void InstrumentValueData::_updateRanges(void)
+void InstrumentValueData::_factValueChanged(void)
 {
-    _updateColor();
-    _updateIcon();
-    _updateOpacity();
+    if (_rangeType == NoRangeInfo) {
+        return;
+    }
+
+    // Values can change many times per frame, the grid updates the ranges once per frame
+    if (_factValueGrid) {
+        _factValueGrid->_queueRangeUpdate(this);
+    } else {
+        _updateRanges();
+    }
 }
 
-void InstrumentValueData::_updateColor(void)
+void InstrumentValueData::_updateRanges(void)
 {
-    QColor newColor;
+    // Only the range type in use needs the index, the others fall back to their defaults
+    const int rangeIndex = ((_rangeType != NoRangeInfo) && _fact) ? _currentRangeIndex(_fact->rawValue().toDouble()) : -1;
 
-    int rangeIndex = -1;
+    _updateColor(_rangeType == ColorRange ? rangeIndex : -1);
+    _updateIcon(_rangeType == IconSelectRange ? rangeIndex : -1);
+    _updateOpacity(_rangeType == OpacityRange ? rangeIndex : -1);
+}
 
-    if (_rangeType == ColorRange && _fact) {
-        rangeIndex =_currentRangeIndex(_fact->rawValue().toDouble());
-    }
+void InstrumentValueData::_updateColor(int rangeIndex)
+{
+    QColor newColor;
     if (rangeIndex != -1) {
         newColor = _rangeColors[rangeIndex].value<QColor>();
     }
@@ -297,15 +323,9 @@ void InstrumentValueData::_updateColor(void)
     }
 }
 
-void InstrumentValueData::_updateOpacity(void)
+void InstrumentValueData::_updateOpacity(int rangeIndex)
 {
     double newOpacity = 1.0;
-
-    int rangeIndex = -1;
-
-    if (_rangeType == OpacityRange && _fact) {
-        rangeIndex =_currentRangeIndex(_fact->rawValue().toDouble());
-    }
     if (rangeIndex != -1) {
         newOpacity = _rangeOpacities[rangeIndex].toDouble();
     }
@@ -316,15 +336,9 @@ void InstrumentValueData::_updateOpacity(void)
     }
 }
 
-void InstrumentValueData::_updateIcon(void)
+void InstrumentValueData::_updateIcon(int rangeIndex)
 {
     QString newIcon;
-
-    int rangeIndex = -1;
-
-    if (_rangeType == IconSelectRange && _fact) {
-        rangeIndex =_currentRangeIndex(_fact->rawValue().toDouble());
-    }
     if (rangeIndex != -1) {
         newIcon = _rangeIcons[rangeIndex].toString();
     }
@@ -13,8 +13,10 @@
 #include "FactValueGrid.h"
 
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
 
 class Vehicle;
+class MAVLinkStreamSubscriptions;
 class QmlObjectListModel;
 
 class InstrumentValueData : public QObject
@@ -105,18 +107,22 @@ private slots:
     void _updateRanges          (void);
     void _activeVehicleChanged  (Vehicle* activeVehicle);
     void _lookForMissingFact    (void);
+    void _factValueChanged      (void);
 
 private:
+    friend class FactValueGrid;
+
     int  _currentRangeIndex     (const QVariant& value);
-    void _updateColor           (void);
-    void _updateIcon            (void);
-    void _updateOpacity         (void);
+    void _updateColor           (int rangeIndex);
+    void _updateIcon            (int rangeIndex);
+    void _updateOpacity         (int rangeIndex);
     void _setFactWorker         (void);
 
     FactValueGrid*          _factValueGrid =        nullptr;
     Vehicle*                _activeVehicle =        nullptr;
     QmlObjectListModel*     _rowModel =             nullptr;
     Fact*                   _fact =                 nullptr;
+    QPointer<MAVLinkStreamSubscriptions> _streamSubscriptions;  ///< Where the messages behind _fact are subscribed
     QString                 _factName;
     QString                 _factGroupName;
     QString                 _text;
@@ -125,6 +131,7 @@ private:
     QColor                  _currentColor;
     double                  _currentOpacity =       1.0;
     QString                 _currentIcon;
+    bool                    _rangeUpdateQueued =    false;  ///< true: FactValueGrid updates the ranges with the next frame
 
     // Ranges allow you to specifiy semantics to apply when a value is within a certain range.
     // The limits for each section of the range are specified in _rangeValues. With the first
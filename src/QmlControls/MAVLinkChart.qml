@@ -26,6 +26,7 @@ ChartView {
     function addDimension(field) {
         if(!chartController) {
             chartController = controller.createChart()
+            chartController.plotWidth = Qt.binding(function() { return chartView.plotArea.width })
         }
         var color   = chartView.seriesColors[chartView.count]
         var serie   = createSeries(ChartView.SeriesTypeLine, field.label)
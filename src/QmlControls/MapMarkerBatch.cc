@@ -0,0 +1,556 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MapMarkerBatch.h"
+#include "MapOverlayLayer.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QtMath>
+#include <QtGui/QMouseEvent>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGVertexColorMaterial>
+
+#include <cmath>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(MapMarkerBatchLog, "qgc.qmlcontrols.mapmarkerbatch")
+
+namespace {
+    /// Vertex colors for QSGVertexColorMaterial, which expects premultiplied alpha
+    struct VertexColor_t {
+        uchar r, g, b, a;
+
+        VertexColor_t(const QColor& color)
+            : r(static_cast<uchar>(qRound(color.redF()   * color.alphaF() * 255)))
+            , g(static_cast<uchar>(qRound(color.greenF() * color.alphaF() * 255)))
+            , b(static_cast<uchar>(qRound(color.blueF()  * color.alphaF() * 255)))
+            , a(static_cast<uchar>(qRound(color.alphaF() * 255)))
+        {}
+    };
+
+    void setVertex(QSGGeometry::ColoredPoint2D*& vertex, const QPointF& point, const VertexColor_t& color)
+    {
+        (vertex++)->set(static_cast<float>(point.x()), static_cast<float>(point.y()), color.r, color.g, color.b, color.a);
+    }
+
+    // Arrow outline in units of half the marker size, pointing up (north) with y down
+    constexpr QPointF arrowTip      ( 0.0, -1.0);
+    constexpr QPointF arrowLeft     (-0.7,  0.8);
+    constexpr QPointF arrowNotch    ( 0.0,  0.35);
+    constexpr QPointF arrowRight    ( 0.7,  0.8);
+
+    /// Walks a dotted property path such as "heading.rawValue" through nested objects
+    QVariant propertyPath(const QObject* object, const QString& path)
+    {
+        const QStringList names = path.split(QLatin1Char('.'));
+        for (qsizetype i=0; object && (i<names.count() - 1); i++) {
+            object = object->property(names[i].toUtf8().constData()).value<QObject*>();
+        }
+
+        return object ? object->property(names.last().toUtf8().constData()) : QVariant();
+    }
+}
+
+MapMarkerBatch::MapMarkerBatch(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::NoButton);
+
+    (void) connect(this, &MapMarkerBatch::rolesChanged,         this, &MapMarkerBatch::_rowsChanged);
+    (void) connect(this, &MapMarkerBatch::appearanceChanged,    this, &MapMarkerBatch::_viewChanged);
+    (void) connect(this, &MapMarkerBatch::thresholdChanged,     this, &MapMarkerBatch::_updateActive);
+}
+
+void MapMarkerBatch::setMap(QQuickItem* map)
+{
+    if (map == _map) {
+        return;
+    }
+
+    if (_map) {
+        (void) disconnect(_map, nullptr, this, nullptr);
+    }
+    _map = map;
+    _fromCoordinateMethod = QMetaMethod();
+
+    if (_map) {
+        const int methodIndex = _map->metaObject()->indexOfMethod("fromCoordinate(QGeoCoordinate,bool)");
+        if (methodIndex < 0) {
+            qCWarning(MapMarkerBatchLog) << "map has no fromCoordinate method" << _map;
+        } else {
+            _fromCoordinateMethod = _map->metaObject()->method(methodIndex);
+        }
+
+        for (const char* propertyName: { "center", "zoomLevel", "bearing", "tilt", "fieldOfView", "width", "height" }) {
+            _connectNotify(_map, QString::fromLatin1(propertyName), "_viewChanged()");
+        }
+    }
+
+    emit mapChanged();
+    _viewChanged();
+    _updateActive();
+}
+
+void MapMarkerBatch::setModel(QAbstractItemModel* model)
+{
+    if (model == _model) {
+        return;
+    }
+
+    if (_model) {
+        (void) disconnect(_model, nullptr, this, nullptr);
+    }
+    _model = model;
+
+    if (_model) {
+        (void) connect(_model, &QAbstractItemModel::dataChanged,    this, &MapMarkerBatch::_markersChanged);
+        (void) connect(_model, &QAbstractItemModel::rowsInserted,   this, &MapMarkerBatch::_rowsChanged);
+        (void) connect(_model, &QAbstractItemModel::rowsRemoved,    this, &MapMarkerBatch::_rowsChanged);
+        (void) connect(_model, &QAbstractItemModel::rowsMoved,      this, &MapMarkerBatch::_rowsChanged);
+        (void) connect(_model, &QAbstractItemModel::modelReset,     this, &MapMarkerBatch::_rowsChanged);
+        (void) connect(_model, &QAbstractItemModel::layoutChanged,  this, &MapMarkerBatch::_rowsChanged);
+    }
+
+    emit modelChanged();
+    _rowsChanged();
+}
+
+void MapMarkerBatch::_connectNotify(QObject* object, const QString& propertyName, const char* slot)
+{
+    const int propertyIndex = object->metaObject()->indexOfProperty(propertyName.toUtf8().constData());
+    if (propertyIndex < 0) {
+        return;
+    }
+
+    const QMetaProperty property = object->metaObject()->property(propertyIndex);
+    if (property.hasNotifySignal()) {
+        (void) connect(object, property.notifySignal(), this, metaObject()->method(metaObject()->indexOfSlot(slot)));
+    }
+}
+
+void MapMarkerBatch::_rowsChanged(void)
+{
+    _setHoveredRow(-1);
+    _updateRoleIds();
+    _connectionsDirty = true;
+    _markersChanged();
+    _updateActive();
+}
+
+void MapMarkerBatch::_markersChanged(void)
+{
+    _markersDirty = true;
+    polish();
+
+    if (_hoveredRow >= 0) {
+        emit hoveredDataChanged();
+    }
+}
+
+void MapMarkerBatch::_viewChanged(void)
+{
+    _pointsDirty = true;
+    polish();
+}
+
+void MapMarkerBatch::_updateActive(void)
+{
+    const bool active = _map && _model && (_model->rowCount() >= _threshold);
+    if (active == _active) {
+        return;
+    }
+
+    _active = active;
+    qCDebug(MapMarkerBatchLog) << "active" << _active << (_model ? _model->rowCount() : 0);
+
+    setAcceptedMouseButtons(_active ? Qt::LeftButton : Qt::NoButton);
+    setAcceptHoverEvents(_active);
+    if (!_active) {
+        _setHoveredRow(-1);
+    }
+
+    emit activeChanged(_active);
+    polish();
+    update();
+}
+
+void MapMarkerBatch::_updateRoleIds(void)
+{
+    _roleIds.clear();
+    _objectRoleId = -1;
+
+    if (!_model) {
+        return;
+    }
+
+    const QHash<int, QByteArray> roleNames = _model->roleNames();
+    for (auto it = roleNames.constBegin(); it != roleNames.constEnd(); it++) {
+        _roleIds[QString::fromUtf8(it.value())] = it.key();
+    }
+
+    if (!_roleIds.contains(_coordinateRole) && _roleIds.contains(QStringLiteral("object"))) {
+        _objectRoleId = _roleIds[QStringLiteral("object")];
+    }
+}
+
+QVariant MapMarkerBatch::_rowValue(int row, const QString& name) const
+{
+    const QModelIndex index = _model->index(row, 0);
+
+    if (_objectRoleId >= 0) {
+        return propertyPath(_model->data(index, _objectRoleId).value<QObject*>(), name);
+    }
+
+    return _model->data(index, _roleIds.value(name, -1));
+}
+
+/// Object list models do not signal dataChanged when an object property changes, so the notify signals of the
+/// properties which are drawn are connected instead, at every level of a dotted path. Only redone when rows are added
+/// or removed, so a nested object which is replaced later is not followed.
+void MapMarkerBatch::_connectObjects(void)
+{
+    for (const QPointer<QObject>& object: _connectedObjects) {
+        if (object) {
+            (void) disconnect(object, nullptr, this, nullptr);
+        }
+    }
+    _connectedObjects.clear();
+    _connectionsDirty = false;
+
+    if (!_model || (_objectRoleId < 0)) {
+        return;
+    }
+
+    QStringList propertyNames = _visibleRoles;
+    for (const QString& propertyName: { _coordinateRole, _headingRole, _alertRole }) {
+        if (!propertyName.isEmpty()) {
+            propertyNames.append(propertyName);
+        }
+    }
+
+    for (int row=0; row<_model->rowCount(); row++) {
+        QObject* const object = _model->data(_model->index(row, 0), _objectRoleId).value<QObject*>();
+        if (!object) {
+            continue;
+        }
+        _connectedObjects.append(object);
+        for (const QString& propertyName: propertyNames) {
+            QObject* nested = object;
+            const QStringList names = propertyName.split(QLatin1Char('.'));
+            for (qsizetype i=0; nested && (i<names.count()); i++) {
+                _connectNotify(nested, names[i], "_markersChanged()");
+                if (nested != object) {
+                    _connectedObjects.append(nested);
+                }
+                if (i < names.count() - 1) {
+                    nested = nested->property(names[i].toUtf8().constData()).value<QObject*>();
+                }
+            }
+        }
+    }
+}
+
+void MapMarkerBatch::_rebuildMarkers(void)
+{
+    _markers.clear();
+    _markersDirty = false;
+    _pointsDirty = true;
+
+    if (!_model) {
+        return;
+    }
+
+    const int rowCount = _model->rowCount();
+    _markers.reserve(rowCount);
+
+    for (int row=0; row<rowCount; row++) {
+        bool visible = true;
+        for (const QString& visibleRole: _visibleRoles) {
+            if (!_rowValue(row, visibleRole).toBool()) {
+                visible = false;
+                break;
+            }
+        }
+        if (!visible) {
+            continue;
+        }
+
+        const QGeoCoordinate coordinate = _rowValue(row, _coordinateRole).value<QGeoCoordinate>();
+        if (!coordinate.isValid()) {
+            continue;
+        }
+
+        Marker_t marker;
+        marker.row          = row;
+        marker.coordinate   = coordinate;
+        marker.heading      = _headingRole.isEmpty() ? 0 : _rowValue(row, _headingRole).toDouble();
+        marker.alert        = !_alertRole.isEmpty() && _rowValue(row, _alertRole).toBool();
+        _markers.append(marker);
+    }
+}
+
+void MapMarkerBatch::_projectMarkers(void)
+{
+    _points.resize(_markers.count());
+    _pointsDirty = false;
+
+    if (!_map || !_fromCoordinateMethod.isValid()) {
+        _points.fill(QPointF(qQNaN(), qQNaN()));
+        return;
+    }
+
+    // Markers in the item are offset from the map by the position of the item within the map
+    const QPointF offset = mapFromItem(_map, QPointF(0, 0));
+    _mapBearing = _map->property("bearing").toDouble();
+
+    for (qsizetype i=0; i<_markers.count(); i++) {
+        QPointF point(qQNaN(), qQNaN());
+        (void) _fromCoordinateMethod.invoke(_map, Qt::DirectConnection, Q_RETURN_ARG(QPointF, point), Q_ARG(QGeoCoordinate, _markers[i].coordinate), Q_ARG(bool, false));
+        _points[i] = point + offset;
+    }
+}
+
+/// Culls markers outside the item and, with a clusterRadius, merges the rest by grid cell. The grid is in world pixels
+/// at the current zoom rather than item pixels, so a marker stays in the same cluster while the map pans.
+void MapMarkerBatch::_clusterMarkers(void)
+{
+    _draws.clear();
+
+    const double margin = qMax(_markerSize, _clusterRadius * 2);
+    const QRectF cullRect = QRectF(QPointF(0, 0), size()).adjusted(-margin, -margin, margin, margin);
+
+    const bool cluster = (_clusterRadius > 0) && _map;
+    const double cellSize = _clusterRadius * 2;
+    const double world = cluster ? MapOverlayLayer::worldSize(_map->property("zoomLevel").toDouble()) : 0;
+    QHash<QPair<qint64, qint64>, int> cellDraws;
+    QList<QPointF> pointSums;
+
+    for (qsizetype i=0; i<_markers.count(); i++) {
+        const QPointF& point = _points[i];
+        if (qIsNaN(point.x()) || !cullRect.contains(point)) {
+            continue;
+        }
+
+        if (cluster) {
+            const QPointF worldPoint = MapOverlayLayer::toMercator(_markers[i].coordinate.latitude(), _markers[i].coordinate.longitude()) * world;
+            const QPair<qint64, qint64> cell(static_cast<qint64>(qFloor(worldPoint.x() / cellSize)), static_cast<qint64>(qFloor(worldPoint.y() / cellSize)));
+            const auto it = cellDraws.constFind(cell);
+            if (it != cellDraws.constEnd()) {
+                Draw_t& draw = _draws[it.value()];
+                draw.count++;
+                draw.alert |= _markers[i].alert;
+                pointSums[it.value()] += point;
+                continue;
+            }
+            cellDraws.insert(cell, static_cast<int>(_draws.count()));
+            pointSums.append(point);
+        }
+
+        _draws.append({ point, static_cast<int>(i), 1, _markers[i].alert });
+    }
+
+    // A cluster is drawn at the mean position of its markers
+    for (qsizetype i=0; i<pointSums.count(); i++) {
+        _draws[i].point = pointSums[i] / _draws[i].count;
+    }
+}
+
+double MapMarkerBatch::_drawRadius(const Draw_t& draw) const
+{
+    const double radius = _markerSize / 2.0;
+    if (draw.count == 1) {
+        return radius;
+    }
+
+    return qMin(radius * (1.0 + (std::log2(draw.count) / 2.0)), qMax(radius, _clusterRadius));
+}
+
+void MapMarkerBatch::updatePolish(void)
+{
+    if (!_active) {
+        return;
+    }
+
+    if (_connectionsDirty) {
+        _connectObjects();
+    }
+    if (_markersDirty) {
+        _rebuildMarkers();
+    }
+    if (_pointsDirty) {
+        _projectMarkers();
+        _clusterMarkers();
+    }
+
+    update();
+}
+
+QSGNode* MapMarkerBatch::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    if (!_active || _draws.isEmpty()) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    QSGGeometryNode* node = static_cast<QSGGeometryNode*>(oldNode);
+    if (!node) {
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+
+        node = new QSGGeometryNode;
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+    }
+
+    // Each marker is its outline in the border color with the marker drawn on top at a smaller size. Clusters are
+    // always circles.
+    const auto isCircle = [this](const Draw_t& draw) { return (_shape == Circle) || (draw.count > 1); };
+    int vertexCount = 0;
+    for (const Draw_t& draw: std::as_const(_draws)) {
+        vertexCount += (isCircle(draw) ? (_circleSegments * 3) : 6) * 2;
+    }
+
+    QSGGeometry* const geometry = node->geometry();
+    geometry->allocate(vertexCount);
+    QSGGeometry::ColoredPoint2D* vertex = geometry->vertexDataAsColoredPoint2D();
+
+    const VertexColor_t borderColor(_borderColor);
+    const VertexColor_t color(_color);
+    const VertexColor_t alertColor(_alertColor);
+
+    for (const Draw_t& draw: std::as_const(_draws)) {
+        const QPointF& center = draw.point;
+        const VertexColor_t& fillColor = draw.alert ? alertColor : color;
+        const double outerRadius = _drawRadius(draw);
+        const double innerRadius = outerRadius * 0.75;
+
+        if (isCircle(draw)) {
+            for (const double radius: { outerRadius, innerRadius }) {
+                const VertexColor_t& vertexColor = (radius == outerRadius) ? borderColor : fillColor;
+                for (int segment=0; segment<_circleSegments; segment++) {
+                    const double angle1 = (2.0 * M_PI * segment) / _circleSegments;
+                    const double angle2 = (2.0 * M_PI * (segment + 1)) / _circleSegments;
+                    setVertex(vertex, center, vertexColor);
+                    setVertex(vertex, center + QPointF(qCos(angle1), qSin(angle1)) * radius, vertexColor);
+                    setVertex(vertex, center + QPointF(qCos(angle2), qSin(angle2)) * radius, vertexColor);
+                }
+            }
+        } else {
+            // Screen y is down so a positive angle rotates clockwise, same as heading
+            const double angle = qDegreesToRadians(_markers[draw.marker].heading - _mapBearing);
+            const double cosAngle = qCos(angle);
+            const double sinAngle = qSin(angle);
+            for (const double radius: { outerRadius, innerRadius }) {
+                const VertexColor_t& vertexColor = (radius == outerRadius) ? borderColor : fillColor;
+                const auto toItem = [&](const QPointF& point) {
+                    return center + QPointF((point.x() * cosAngle) - (point.y() * sinAngle), (point.x() * sinAngle) + (point.y() * cosAngle)) * radius;
+                };
+                setVertex(vertex, toItem(arrowTip),     vertexColor);
+                setVertex(vertex, toItem(arrowLeft),    vertexColor);
+                setVertex(vertex, toItem(arrowNotch),   vertexColor);
+                setVertex(vertex, toItem(arrowTip),     vertexColor);
+                setVertex(vertex, toItem(arrowNotch),   vertexColor);
+                setVertex(vertex, toItem(arrowRight),   vertexColor);
+            }
+        }
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
+
+int MapMarkerBatch::_drawIndexAt(double x, double y) const
+{
+    double bestDistanceSquared = std::numeric_limits<double>::max();
+    int bestIndex = -1;
+
+    for (qsizetype i=0; i<_draws.count(); i++) {
+        const double hitRadius = _drawRadius(_draws[i]);
+        const double dx = _draws[i].point.x() - x;
+        const double dy = _draws[i].point.y() - y;
+        const double distanceSquared = (dx * dx) + (dy * dy);
+        if ((distanceSquared <= (hitRadius * hitRadius)) && (distanceSquared < bestDistanceSquared)) {
+            bestDistanceSquared = distanceSquared;
+            bestIndex = static_cast<int>(i);
+        }
+    }
+
+    return bestIndex;
+}
+
+int MapMarkerBatch::rowAt(double x, double y) const
+{
+    const int index = _drawIndexAt(x, y);
+    return (index < 0) ? -1 : _markers[_draws[index].marker].row;
+}
+
+QVariantMap MapMarkerBatch::hoveredData(void) const
+{
+    QVariantMap data;
+
+    if (!_model || (_hoveredRow < 0) || (_hoveredRow >= _model->rowCount())) {
+        return data;
+    }
+
+    const QModelIndex index = _model->index(_hoveredRow, 0);
+    for (auto it = _roleIds.constBegin(); it != _roleIds.constEnd(); it++) {
+        data[it.key()] = _model->data(index, it.value());
+    }
+
+    return data;
+}
+
+void MapMarkerBatch::_setHoveredRow(int row, int count)
+{
+    if ((row != _hoveredRow) || (count != _hoveredCount)) {
+        _hoveredRow = row;
+        _hoveredCount = (row < 0) ? 0 : count;
+        emit hoveredRowChanged(_hoveredRow);
+        emit hoveredDataChanged();
+    }
+}
+
+void MapMarkerBatch::mousePressEvent(QMouseEvent* event)
+{
+    _pressedRow = rowAt(event->position().x(), event->position().y());
+    if (_pressedRow < 0) {
+        // Let the map handle presses which miss all markers
+        event->ignore();
+    }
+}
+
+void MapMarkerBatch::mouseReleaseEvent(QMouseEvent* event)
+{
+    const int row = rowAt(event->position().x(), event->position().y());
+    if ((row >= 0) && (row == _pressedRow)) {
+        emit clicked(row);
+    }
+    _pressedRow = -1;
+}
+
+void MapMarkerBatch::hoverMoveEvent(QHoverEvent* event)
+{
+    const int index = _drawIndexAt(event->position().x(), event->position().y());
+    if (index < 0) {
+        _setHoveredRow(-1);
+    } else {
+        _setHoveredRow(_markers[_draws[index].marker].row, _draws[index].count);
+    }
+    event->ignore();
+}
+
+void MapMarkerBatch::hoverLeaveEvent(QHoverEvent* event)
+{
+    _setHoveredRow(-1);
+    event->ignore();
+}
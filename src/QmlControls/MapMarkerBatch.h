@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMetaMethod>
+#include <QtCore/QPointer>
+#include <QtGui/QColor>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtQuick/QQuickItem>
+
+Q_DECLARE_LOGGING_CATEGORY(MapMarkerBatchLog)
+
+/// Draws a marker for every row of a model as a single scene graph geometry node. Used in place of one QML map item
+/// per row once a map shows more markers than individual items can render at a usable frame rate. Markers are placed
+/// with the map's own fromCoordinate so they line up with regular map items. The item is meant to fill the map:
+///
+///     MapMarkerBatch {
+///         anchors.fill:   parent
+///         map:            parent
+///         model:          QGroundControl.adsbVehicleManager.adsbVehicles
+///         headingRole:    "heading"
+///     }
+///
+/// Values are read through the model roles. For object list models, which only have an "object" role, the role names
+/// are read as properties of the object and their notify signals update the markers. A role name may be a dotted path
+/// through nested objects, such as "heading.rawValue" for a Fact. The batch only draws while active, which is once the
+/// model has at least threshold rows, so QML can switch between the two paths on active.
+///
+/// Markers outside the item are culled. With a clusterRadius, markers closer than about twice that are drawn as one
+/// circle sized by their count. Clusters come from a grid in world pixels, so they do not change while panning.
+class MapMarkerBatch : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    MapMarkerBatch(QQuickItem* parent = nullptr);
+
+    enum Shape {
+        Circle,     ///< Filled circle, for mission items
+        Arrow,      ///< Arrow rotated by heading, for aircraft
+    };
+    Q_ENUM(Shape)
+
+    Q_PROPERTY(QQuickItem*          map             READ map            WRITE setMap        NOTIFY mapChanged)
+    Q_PROPERTY(QAbstractItemModel*  model           READ model          WRITE setModel      NOTIFY modelChanged)
+    Q_PROPERTY(QString              coordinateRole  MEMBER _coordinateRole                  NOTIFY rolesChanged)
+    Q_PROPERTY(QString              headingRole     MEMBER _headingRole                     NOTIFY rolesChanged)    ///< Empty for markers which are not rotated
+    Q_PROPERTY(QString              alertRole       MEMBER _alertRole                       NOTIFY rolesChanged)    ///< Rows where this is true are drawn in alertColor
+    Q_PROPERTY(QStringList          visibleRoles    MEMBER _visibleRoles                    NOTIFY rolesChanged)    ///< Rows are only drawn if all of these are true
+    Q_PROPERTY(Shape                shape           MEMBER _shape                           NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor               color           MEMBER _color                           NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor               alertColor      MEMBER _alertColor                      NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor               borderColor     MEMBER _borderColor                     NOTIFY appearanceChanged)
+    Q_PROPERTY(double               markerSize      MEMBER _markerSize                      NOTIFY appearanceChanged)   ///< Pixels
+    Q_PROPERTY(double               clusterRadius   MEMBER _clusterRadius                   NOTIFY appearanceChanged)   ///< Pixels, 0 for no clustering
+    Q_PROPERTY(int                  threshold       MEMBER _threshold                       NOTIFY thresholdChanged)
+    Q_PROPERTY(bool                 active          READ active                             NOTIFY activeChanged)
+    Q_PROPERTY(int                  hoveredRow      READ hoveredRow                         NOTIFY hoveredRowChanged)   ///< -1 for none, first row of a hovered cluster
+    Q_PROPERTY(int                  hoveredCount    READ hoveredCount                       NOTIFY hoveredRowChanged)   ///< Markers in the hovered cluster, 1 for a single marker
+    Q_PROPERTY(QVariantMap          hoveredData     READ hoveredData                        NOTIFY hoveredDataChanged)  ///< Role name to value of the hovered row
+
+    QQuickItem*         map         (void) const { return _map; }
+    QAbstractItemModel* model       (void) const { return _model; }
+    bool                active      (void) const { return _active; }
+    int                 hoveredRow  (void) const { return _hoveredRow; }
+    int                 hoveredCount(void) const { return _hoveredCount; }
+    QVariantMap         hoveredData (void) const;
+
+    void setMap     (QQuickItem* map);
+    void setModel   (QAbstractItemModel* model);
+
+    /// @return Row of the marker at the specified item position, the first row of a cluster, -1 for none
+    Q_INVOKABLE int rowAt(double x, double y) const;
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) override;
+    void updatePolish(void) override;
+
+signals:
+    void mapChanged         (void);
+    void modelChanged       (void);
+    void rolesChanged       (void);
+    void appearanceChanged  (void);
+    void thresholdChanged   (void);
+    void activeChanged      (bool active);
+    void hoveredRowChanged  (int row);
+    void hoveredDataChanged (void);
+    void clicked            (int row);
+
+protected:
+    void mousePressEvent    (QMouseEvent* event) override;
+    void mouseReleaseEvent  (QMouseEvent* event) override;
+    void hoverMoveEvent     (QHoverEvent* event) override;
+    void hoverLeaveEvent    (QHoverEvent* event) override;
+
+private slots:
+    void _rowsChanged   (void);
+    void _markersChanged(void);
+    void _viewChanged   (void);
+
+private:
+    typedef struct {
+        int             row;
+        QGeoCoordinate  coordinate;
+        double          heading;
+        bool            alert;
+    } Marker_t;
+
+    /// Single marker or cluster as drawn
+    typedef struct {
+        QPointF point;                      ///< Item position
+        int     marker;                     ///< Index in _markers, the first one of a cluster
+        int     count;
+        bool    alert;                      ///< Any marker of a cluster
+    } Draw_t;
+
+    QVariant    _rowValue           (int row, const QString& name) const;
+    int         _drawIndexAt        (double x, double y) const;
+    double      _drawRadius         (const Draw_t& draw) const;
+    void        _updateActive       (void);
+    void        _updateRoleIds      (void);
+    void        _connectObjects     (void);
+    void        _rebuildMarkers     (void);
+    void        _projectMarkers     (void);
+    void        _clusterMarkers     (void);
+    void        _setHoveredRow      (int row, int count = 0);
+    void        _connectNotify      (QObject* object, const QString& propertyName, const char* slot);
+
+    QPointer<QQuickItem>            _map;
+    QPointer<QAbstractItemModel>    _model;
+    QMetaMethod                     _fromCoordinateMethod;
+    QHash<QString, int>             _roleIds;
+    int                             _objectRoleId =     -1;                 ///< -1 unless the model is an object list model
+    QList<QPointer<QObject>>        _connectedObjects;
+
+    QString         _coordinateRole =   QStringLiteral("coordinate");
+    QString         _headingRole;
+    QString         _alertRole;
+    QStringList     _visibleRoles;
+    Shape           _shape =            Circle;
+    QColor          _color =            Qt::white;
+    QColor          _alertColor =       Qt::red;
+    QColor          _borderColor =      Qt::black;
+    double          _markerSize =       16;
+    double          _clusterRadius =    0;
+    int             _threshold =        100;
+    bool            _active =           false;
+    int             _hoveredRow =       -1;
+    int             _hoveredCount =     0;
+    int             _pressedRow =       -1;
+
+    QList<Marker_t> _markers;
+    QList<QPointF>  _points;                ///< Item position of each marker, NaN when not on the map
+    QList<Draw_t>   _draws;
+    double          _mapBearing =       0;
+    bool            _connectionsDirty = true;
+    bool            _markersDirty =     true;
+    bool            _pointsDirty =      true;
+
+    static constexpr int _circleSegments = 12;
+
+    Q_DISABLE_COPY(MapMarkerBatch)
+};
+
+QML_DECLARE_TYPE(MapMarkerBatch)
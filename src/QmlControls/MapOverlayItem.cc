@@ -0,0 +1,235 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MapOverlayItem.h"
+#include "MapOverlayManager.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtGui/QPainter>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGImageNode>
+#include <QtQuick/QSGTransformNode>
+
+#include <utility>
+
+QGC_LOGGING_CATEGORY(MapOverlayItemLog, "qgc.qmlcontrols.mapoverlayitem")
+
+MapOverlayItem::MapOverlayItem(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    _renderTimer.setSingleShot(true);
+    _renderTimer.setInterval(renderIntervalMSecs);
+
+    (void) connect(&_renderTimer,   &QTimer::timeout,                   this, &MapOverlayItem::_startRender);
+    (void) connect(&_renderWatcher, &QFutureWatcher<Render_t>::finished, this, &MapOverlayItem::_renderDone);
+
+    QmlObjectListModel* const layers = MapOverlayManager::instance()->layers();
+    (void) connect(layers, &QAbstractItemModel::rowsInserted,  this, &MapOverlayItem::_layersChanged);
+    (void) connect(layers, &QAbstractItemModel::rowsRemoved,   this, &MapOverlayItem::_layersChanged);
+    (void) connect(layers, &QAbstractItemModel::modelReset,    this, &MapOverlayItem::_layersChanged);
+    _layersChanged();
+}
+
+void MapOverlayItem::setMap(QQuickItem* map)
+{
+    if (map == _map) {
+        return;
+    }
+
+    if (_map) {
+        (void) disconnect(_map, nullptr, this, nullptr);
+    }
+    _map = map;
+
+    if (_map) {
+        for (const char* propertyName: { "center", "zoomLevel", "bearing", "tilt" }) {
+            const int propertyIndex = _map->metaObject()->indexOfProperty(propertyName);
+            if (propertyIndex < 0) {
+                qCWarning(MapOverlayItemLog) << "map has no property" << propertyName << _map;
+                continue;
+            }
+            const QMetaProperty property = _map->metaObject()->property(propertyIndex);
+            if (property.hasNotifySignal()) {
+                (void) connect(_map, property.notifySignal(), this, metaObject()->method(metaObject()->indexOfSlot("_viewChanged()")));
+            }
+        }
+    }
+
+    emit mapChanged();
+    _viewChanged();
+}
+
+void MapOverlayItem::geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+
+    if (newGeometry.size() != oldGeometry.size()) {
+        _viewChanged();
+    }
+}
+
+void MapOverlayItem::_layersChanged(void)
+{
+    for (const QPointer<MapOverlayLayer>& layer: _connectedLayers) {
+        if (layer) {
+            (void) disconnect(layer, nullptr, this, nullptr);
+        }
+    }
+    _connectedLayers.clear();
+
+    QmlObjectListModel* const layers = MapOverlayManager::instance()->layers();
+    for (int i = 0; i < layers->count(); i++) {
+        MapOverlayLayer* const layer = layers->value<MapOverlayLayer*>(i);
+        (void) connect(layer, &MapOverlayLayer::dataChanged,    this, &MapOverlayItem::_renderNeeded);
+        (void) connect(layer, &MapOverlayLayer::visibleChanged, this, &MapOverlayItem::_renderNeeded);
+        (void) connect(layer, &MapOverlayLayer::colorChanged,   this, &MapOverlayItem::_renderNeeded);
+        _connectedLayers.append(layer);
+    }
+
+    _renderNeeded();
+}
+
+void MapOverlayItem::_viewChanged(void)
+{
+    polish();
+    _renderNeeded();
+}
+
+void MapOverlayItem::_renderNeeded(void)
+{
+    // Throttled rather than debounced, so that a long pan still gets new images along the way
+    if (!_renderTimer.isActive()) {
+        _renderTimer.start();
+    }
+}
+
+MapOverlayLayer::View_t MapOverlayItem::_currentView(void) const
+{
+    MapOverlayLayer::View_t view;
+    view.size = size();
+
+    if (_map) {
+        const QGeoCoordinate center = _map->property("center").value<QGeoCoordinate>();
+        view.center     = MapOverlayLayer::toMercator(center.latitude(), center.longitude());
+        view.zoomLevel  = _map->property("zoomLevel").toDouble();
+        view.bearing    = _map->property("bearing").toDouble();
+    }
+
+    return view;
+}
+
+void MapOverlayItem::_startRender(void)
+{
+    if (_renderWatcher.isRunning()) {
+        // _renderDone starts the timer again
+        _renderPending = true;
+        return;
+    }
+    _renderPending = false;
+
+    QList<std::pair<std::shared_ptr<const MapOverlayLayer::Data_t>, QColor>> layers;
+    for (const QPointer<MapOverlayLayer>& layer: std::as_const(_connectedLayers)) {
+        if (layer && layer->visible() && layer->data()) {
+            layers.append({ layer->data(), layer->color() });
+        }
+    }
+
+    const MapOverlayLayer::View_t view = _currentView();
+    const qreal devicePixelRatio = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    if (!_map || layers.isEmpty() || view.size.isEmpty()) {
+        _image = QImage();
+        update();
+        return;
+    }
+
+    _renderWatcher.setFuture(QtConcurrent::run([layers, view, devicePixelRatio]() {
+        Render_t render;
+        render.view = view;
+        render.image = QImage((view.size * devicePixelRatio).toSize(), QImage::Format_ARGB32_Premultiplied);
+        render.image.setDevicePixelRatio(devicePixelRatio);
+        render.image.fill(Qt::transparent);
+
+        QPainter painter(&render.image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        for (const auto& [data, color] : layers) {
+            MapOverlayLayer::render(data, view, color, painter);
+        }
+
+        return render;
+    }));
+}
+
+void MapOverlayItem::_renderDone(void)
+{
+    const Render_t render = _renderWatcher.result();
+
+    _image = render.image;
+    _imageView = render.view;
+    _imageDirty = true;
+    polish();
+
+    if (_renderPending) {
+        _renderNeeded();
+    }
+}
+
+void MapOverlayItem::updatePolish(void)
+{
+    _tilted = _map && !qFuzzyIsNull(_map->property("tilt").toDouble());
+
+    // Image pixels to item pixels: back to the world at the zoom the image was rendered for, over to the current zoom
+    // and into the current view. The center offset is computed in doubles, the matrix is single precision.
+    const MapOverlayLayer::View_t view = _currentView();
+    const double world = MapOverlayLayer::worldSize(view.zoomLevel);
+    const QPointF offset = (_imageView.center - view.center) * world;
+
+    _imageTransform.setToIdentity();
+    _imageTransform.translate(view.size.width() / 2.0, view.size.height() / 2.0);
+    _imageTransform.rotate(-view.bearing, 0, 0, 1);
+    _imageTransform.translate(offset.x(), offset.y());
+    _imageTransform.scale(world / MapOverlayLayer::worldSize(_imageView.zoomLevel));
+    _imageTransform.rotate(_imageView.bearing, 0, 0, 1);
+    _imageTransform.translate(-_imageView.size.width() / 2.0, -_imageView.size.height() / 2.0);
+
+    update();
+}
+
+QSGNode* MapOverlayItem::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    if (_image.isNull() || _tilted) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    QSGTransformNode* transformNode = static_cast<QSGTransformNode*>(oldNode);
+    QSGImageNode* imageNode = nullptr;
+    if (!transformNode) {
+        transformNode = new QSGTransformNode;
+        imageNode = window()->createImageNode();
+        imageNode->setOwnsTexture(true);
+        imageNode->setFiltering(QSGTexture::Linear);
+        transformNode->appendChildNode(imageNode);
+        _imageDirty = true;
+    } else {
+        imageNode = static_cast<QSGImageNode*>(transformNode->firstChild());
+    }
+
+    if (_imageDirty) {
+        imageNode->setTexture(window()->createTextureFromImage(_image));
+        imageNode->setRect(QRectF(QPointF(0, 0), _imageView.size));
+        _imageDirty = false;
+    }
+    transformNode->setMatrix(_imageTransform);
+
+    return transformNode;
+}
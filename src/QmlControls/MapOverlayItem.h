@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MapOverlayLayer.h"
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtGui/QImage>
+#include <QtGui/QMatrix4x4>
+#include <QtQuick/QQuickItem>
+
+Q_DECLARE_LOGGING_CATEGORY(MapOverlayItemLog)
+
+/// Draws the visible layers of MapOverlayManager over a map. The shapes in view are painted into an image on a worker
+/// thread, which the item shows as a single texture, so the scene graph holds one node however large the overlays are.
+/// While the map pans, zooms or rotates the last image is moved along with it until the next one is ready, at most
+/// every renderIntervalMSecs. The item is meant to fill the map:
+///
+///     MapOverlayItem {
+///         anchors.fill:   parent
+///         map:            parent
+///     }
+///
+/// Overlays are hidden while the map is tilted.
+class MapOverlayItem : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    MapOverlayItem(QQuickItem* parent = nullptr);
+
+    Q_PROPERTY(QQuickItem* map READ map WRITE setMap NOTIFY mapChanged)
+
+    QQuickItem* map(void) const { return _map; }
+
+    void setMap(QQuickItem* map);
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) override;
+    void updatePolish(void) override;
+
+    static constexpr int renderIntervalMSecs = 100;
+
+signals:
+    void mapChanged(void);
+
+protected:
+    void geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+
+private slots:
+    void _layersChanged (void);
+    void _viewChanged   (void);
+    void _renderNeeded  (void);
+    void _startRender   (void);
+    void _renderDone    (void);
+
+private:
+    struct Render_t {
+        MapOverlayLayer::View_t view;
+        QImage                  image;
+    };
+
+    MapOverlayLayer::View_t _currentView    (void) const;
+
+    QPointer<QQuickItem>                _map;
+    QList<QPointer<MapOverlayLayer>>    _connectedLayers;
+    QTimer                              _renderTimer;
+    QFutureWatcher<Render_t>            _renderWatcher;
+    bool                                _renderPending =    false;  ///< Something changed while a render was running
+
+    MapOverlayLayer::View_t             _imageView;                 ///< The view _image was rendered for
+    QImage                              _image;
+    bool                                _imageDirty =       false;  ///< _image needs a new texture
+    bool                                _tilted =           false;
+    QMatrix4x4                          _imageTransform;            ///< Places _image in the current view
+
+    Q_DISABLE_COPY(MapOverlayItem)
+};
+
+QML_DECLARE_TYPE(MapOverlayItem)
@@ -0,0 +1,351 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MapOverlayLayer.h"
+#include "QGCLoggingCategory.h"
+#include "ShapeFileHelper.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QtMath>
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+QGC_LOGGING_CATEGORY(MapOverlayLayerLog, "qgc.qmlcontrols.mapoverlaylayer")
+
+namespace {
+
+/// Douglas-Peucker simplification, iterative so that long rings cannot overflow the stack
+QPolygonF simplify(const QPolygonF& points, double tolerance)
+{
+    if (points.count() <= 2) {
+        return points;
+    }
+
+    QList<bool> keep(points.count(), false);
+    keep.first() = true;
+    keep.last() = true;
+
+    const double toleranceSquared = tolerance * tolerance;
+    QList<std::pair<int, int>> stack{ { 0, static_cast<int>(points.count() - 1) } };
+    while (!stack.isEmpty()) {
+        const auto [first, last] = stack.takeLast();
+        const QPointF a = points[first];
+        const QPointF ab = points[last] - a;
+        const double abLengthSquared = QPointF::dotProduct(ab, ab);
+
+        int farthest = -1;
+        double farthestSquared = toleranceSquared;
+        for (int i = first + 1; i < last; i++) {
+            const QPointF ap = points[i] - a;
+            double distanceSquared;
+            if (abLengthSquared > 0) {
+                const double t = qBound(0.0, QPointF::dotProduct(ap, ab) / abLengthSquared, 1.0);
+                const QPointF d = ap - (t * ab);
+                distanceSquared = QPointF::dotProduct(d, d);
+            } else {
+                distanceSquared = QPointF::dotProduct(ap, ap);
+            }
+            if (distanceSquared > farthestSquared) {
+                farthest = i;
+                farthestSquared = distanceSquared;
+            }
+        }
+
+        if (farthest >= 0) {
+            keep[farthest] = true;
+            stack.append({ first, farthest });
+            stack.append({ farthest, last });
+        }
+    }
+
+    QPolygonF simplified;
+    for (int i = 0; i < points.count(); i++) {
+        if (keep[i]) {
+            simplified.append(points[i]);
+        }
+    }
+
+    // Share the original when nothing was dropped
+    return (simplified.count() == points.count()) ? points : simplified;
+}
+
+/// Unlike QRectF::intersects, true for the zero width or height bounds of straight lines
+bool overlaps(const QRectF& a, const QRectF& b)
+{
+    return (a.left() <= b.right()) && (b.left() <= a.right()) && (a.top() <= b.bottom()) && (b.top() <= a.bottom());
+}
+
+} // namespace
+
+MapOverlayLayer::MapOverlayLayer(const QString& file, QObject* parent)
+    : QObject(parent)
+    , _file(file)
+{
+    (void) connect(&_loadWatcher, &QFutureWatcher<BackgroundLoad_t>::finished, this, &MapOverlayLayer::_loadDone);
+
+    reload();
+}
+
+QString MapOverlayLayer::name(void) const
+{
+    return QFileInfo(_file).completeBaseName();
+}
+
+int MapOverlayLayer::shapeCount(void) const
+{
+    return _data ? _data->shapes.count() : 0;
+}
+
+void MapOverlayLayer::setVisible(bool visible)
+{
+    if (visible != _visible) {
+        _visible = visible;
+        emit visibleChanged(_visible);
+    }
+}
+
+void MapOverlayLayer::setColor(const QColor& color)
+{
+    if (color != _color) {
+        _color = color;
+        emit colorChanged(_color);
+    }
+}
+
+void MapOverlayLayer::reload(void)
+{
+    const QString file = _file;
+    const quint64 generation = ++_generation;
+    _loadWatcher.setFuture(QtConcurrent::run([file, generation]() {
+        BackgroundLoad_t result;
+        result.generation = generation;
+        result.data = load(file, result.errorString);
+        return result;
+    }));
+
+    emit loadingChanged(true);
+}
+
+void MapOverlayLayer::_loadDone(void)
+{
+    const BackgroundLoad_t result = _loadWatcher.result();
+    if (result.generation != _generation) {
+        // A newer load is already running
+        return;
+    }
+
+    if (result.data) {
+        _data = result.data;
+        emit dataChanged();
+    }
+    if (result.errorString != _errorString) {
+        _errorString = result.errorString;
+        emit errorStringChanged(_errorString);
+    }
+    emit loadingChanged(false);
+}
+
+double MapOverlayLayer::worldSize(double zoomLevel)
+{
+    return 256.0 * std::exp2(zoomLevel);
+}
+
+QPointF MapOverlayLayer::toMercator(double latitude, double longitude)
+{
+    static constexpr double maxLatitude = 85.05112878;
+
+    const double sinLatitude = std::sin(qDegreesToRadians(qBound(-maxLatitude, latitude, maxLatitude)));
+    return QPointF((longitude + 180.0) / 360.0, 0.5 - (std::log((1.0 + sinLatitude) / (1.0 - sinLatitude)) / (4.0 * M_PI)));
+}
+
+QRectF MapOverlayLayer::visibleRect(const View_t& view)
+{
+    const double radius = std::hypot(view.size.width(), view.size.height()) / 2.0 / worldSize(view.zoomLevel);
+    return QRectF(view.center.x() - radius, view.center.y() - radius, 2 * radius, 2 * radius);
+}
+
+std::shared_ptr<const MapOverlayLayer::Data_t> MapOverlayLayer::load(const QString& file, QString& errorString)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<ShapeFileHelper::Shape_t> shapes;
+    if (!ShapeFileHelper::loadAllShapesFromFile(file, shapes, errorString)) {
+        qCWarning(MapOverlayLayerLog) << "load failed" << file << errorString;
+        return nullptr;
+    }
+    const qint64 parseMSecs = timer.restart();
+
+    auto data = std::make_shared<Data_t>();
+    data->shapes.reserve(shapes.count());
+
+    constexpr int lodCount = std::size(Data_t::lodZoomLevels);
+    qsizetype fullPoints = 0;
+    qsizetype lodPoints = 0;
+    for (const ShapeFileHelper::Shape_t& shape : std::as_const(shapes)) {
+        Data_t::Shape_t overlayShape;
+        overlayShape.polygon = (shape.type == ShapeFileHelper::Polygon);
+        overlayShape.lods.resize(lodCount + 1);
+
+        for (const QList<QPointF>& part : shape.parts) {
+            QPolygonF projected;
+            projected.reserve(part.count() + 1);
+            for (const QPointF& point : part) {
+                projected.append(toMercator(point.y(), point.x()));
+            }
+            if (overlayShape.polygon && (projected.first() != projected.last())) {
+                projected.append(projected.first());
+            }
+
+            overlayShape.bounds = overlayShape.bounds.isNull() ? projected.boundingRect() : overlayShape.bounds.united(projected.boundingRect());
+            overlayShape.lods[lodCount].append(projected);
+            fullPoints += projected.count();
+
+            for (int lod = 0; lod < lodCount; lod++) {
+                const QPolygonF simplified = simplify(projected, 0.5 / worldSize(Data_t::lodZoomLevels[lod]));
+                if (simplified.count() >= (overlayShape.polygon ? 4 : 2)) {
+                    overlayShape.lods[lod].append(simplified);
+                    lodPoints += simplified.count();
+                }
+            }
+        }
+
+        data->bounds = data->bounds.isNull() ? overlayShape.bounds : data->bounds.united(overlayShape.bounds);
+        data->shapes.append(std::move(overlayShape));
+    }
+
+    constexpr int cellsPerSide = 1 << gridLevel;
+    for (int index = 0; index < data->shapes.count(); index++) {
+        const QRectF& bounds = data->shapes[index].bounds;
+        const int x0 = qBound(0, static_cast<int>(bounds.left() * cellsPerSide), cellsPerSide - 1);
+        const int x1 = qBound(0, static_cast<int>(bounds.right() * cellsPerSide), cellsPerSide - 1);
+        const int y0 = qBound(0, static_cast<int>(bounds.top() * cellsPerSide), cellsPerSide - 1);
+        const int y1 = qBound(0, static_cast<int>(bounds.bottom() * cellsPerSide), cellsPerSide - 1);
+
+        if (((x1 - x0 + 1) * (y1 - y0 + 1)) > Data_t::maxShapeCells) {
+            data->large.append(index);
+            continue;
+        }
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                data->grid[(static_cast<quint32>(y) << gridLevel) | static_cast<quint32>(x)].append(index);
+            }
+        }
+    }
+
+    qCDebug(MapOverlayLayerLog) << file << "shapes" << data->shapes.count() << "points" << fullPoints << "simplified points" << lodPoints
+                                << "cells" << data->grid.count() << "parse msecs" << parseMSecs << "index msecs" << timer.elapsed();
+
+    return data;
+}
+
+void MapOverlayLayer::render(const std::shared_ptr<const Data_t>& data, const View_t& view, const QColor& color, QPainter& painter)
+{
+    if (!data || data->shapes.isEmpty()) {
+        return;
+    }
+
+    const QRectF rect = visibleRect(view);
+    if (!overlaps(rect, data->bounds)) {
+        return;
+    }
+
+    // Visit each shape near the view once: the grid cells under the view, or every shape when zoomed out so far that
+    // the view covers more cells than there are shapes
+    constexpr int cellsPerSide = 1 << gridLevel;
+    const int x0 = qBound(0, static_cast<int>(rect.left() * cellsPerSide), cellsPerSide - 1);
+    const int x1 = qBound(0, static_cast<int>(rect.right() * cellsPerSide), cellsPerSide - 1);
+    const int y0 = qBound(0, static_cast<int>(rect.top() * cellsPerSide), cellsPerSide - 1);
+    const int y1 = qBound(0, static_cast<int>(rect.bottom() * cellsPerSide), cellsPerSide - 1);
+
+    QList<int> candidates;
+    if (((x1 - x0 + 1) * (y1 - y0 + 1)) > data->shapes.count()) {
+        candidates.reserve(data->shapes.count());
+        for (int index = 0; index < data->shapes.count(); index++) {
+            candidates.append(index);
+        }
+    } else {
+        QList<bool> seen(data->shapes.count(), false);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                const auto cell = data->grid.constFind((static_cast<quint32>(y) << gridLevel) | static_cast<quint32>(x));
+                if (cell == data->grid.constEnd()) {
+                    continue;
+                }
+                for (int index : cell.value()) {
+                    if (!seen[index]) {
+                        seen[index] = true;
+                        candidates.append(index);
+                    }
+                }
+            }
+        }
+        candidates.append(data->large);
+    }
+
+    // The coarsest band which is still finer than half a pixel at this zoom
+    constexpr int lodCount = std::size(Data_t::lodZoomLevels);
+    int lod = lodCount;
+    for (int i = 0; i < lodCount; i++) {
+        if (view.zoomLevel <= Data_t::lodZoomLevels[i]) {
+            lod = i;
+            break;
+        }
+    }
+
+    const double world = worldSize(view.zoomLevel);
+    QTransform transform;
+    transform.translate(view.size.width() / 2.0, view.size.height() / 2.0);
+    transform.rotate(-view.bearing);
+    transform.scale(world, world);
+    transform.translate(-view.center.x(), -view.center.y());
+
+    QColor fillColor = color;
+    fillColor.setAlphaF(color.alphaF() * 0.25);
+    QPen pen(color, 2);
+    pen.setCosmetic(true);
+    painter.setPen(pen);
+
+    int drawn = 0;
+    for (int index : std::as_const(candidates)) {
+        const Data_t::Shape_t& shape = data->shapes[index];
+        if (!overlaps(rect, shape.bounds)) {
+            continue;
+        }
+        if (((shape.bounds.width() * world) < 1) && ((shape.bounds.height() * world) < 1)) {
+            // Smaller than a pixel
+            continue;
+        }
+
+        const QList<QPolygonF>& parts = shape.lods[lod];
+        if (shape.polygon) {
+            QPainterPath path;
+            path.setFillRule(Qt::OddEvenFill);
+            for (const QPolygonF& part : parts) {
+                path.addPolygon(transform.map(part));
+            }
+            painter.setBrush(fillColor);
+            painter.drawPath(path);
+        } else {
+            painter.setBrush(Qt::NoBrush);
+            for (const QPolygonF& part : parts) {
+                painter.drawPolyline(transform.map(part));
+            }
+        }
+        drawn++;
+    }
+
+    qCDebug(MapOverlayLayerLog) << "render zoom" << view.zoomLevel << "lod" << lod << "candidates" << candidates.count() << "drawn" << drawn;
+}
@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QRectF>
+#include <QtCore/QSizeF>
+#include <QtGui/QColor>
+#include <QtGui/QPolygonF>
+
+#include <memory>
+
+class QPainter;
+
+Q_DECLARE_LOGGING_CATEGORY(MapOverlayLayerLog)
+
+/// A read only reference overlay from a KML or SHP file, such as field boundaries or airspace, drawn on top of the map
+/// by MapOverlayItem. The file is loaded, projected, simplified and indexed on a worker thread, so files of tens of
+/// megabytes neither block the UI nor add map items.
+///
+/// Geometry is held in normalized Web Mercator coordinates, 0 to 1 across the world with y down, once at full
+/// resolution and once per zoom band simplified to half a pixel of that band. A grid of cells over the world lists the
+/// shapes touching each cell, so drawing a view only visits the shapes near it.
+class MapOverlayLayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    MapOverlayLayer(const QString& file, QObject* parent = nullptr);
+
+    Q_PROPERTY(QString  file        READ file                           CONSTANT)
+    Q_PROPERTY(QString  name        READ name                           CONSTANT)
+    Q_PROPERTY(bool     loading     READ loading                        NOTIFY loadingChanged)
+    Q_PROPERTY(QString  errorString READ errorString                    NOTIFY errorStringChanged)
+    Q_PROPERTY(int      shapeCount  READ shapeCount                     NOTIFY dataChanged)
+    Q_PROPERTY(bool     visible     READ visible    WRITE setVisible    NOTIFY visibleChanged)
+    Q_PROPERTY(QColor   color       READ color      WRITE setColor      NOTIFY colorChanged)
+
+    /// Immutable result of a load, shared with the render threads
+    struct Data_t;
+
+    /// The view to draw, as the map shows it
+    struct View_t {
+        QPointF center;         ///< Normalized Web Mercator
+        double  zoomLevel = 0;
+        double  bearing =   0;  ///< Degrees
+        QSizeF  size;           ///< Item pixels
+    };
+
+    QString file        (void) const { return _file; }
+    QString name        (void) const;
+    bool    loading     (void) const { return _loadWatcher.isRunning(); }
+    QString errorString (void) const { return _errorString; }
+    int     shapeCount  (void) const;
+    bool    visible     (void) const { return _visible; }
+    QColor  color       (void) const { return _color; }
+
+    void setVisible (bool visible);
+    void setColor   (const QColor& color);
+
+    std::shared_ptr<const Data_t> data(void) const { return _data; }
+
+    /// Loads the file again, the current geometry stays until the new one is ready
+    Q_INVOKABLE void reload(void);
+
+    /// Draws the shapes of data inside view. Thread safe, data is never modified once loaded.
+    static void render(const std::shared_ptr<const Data_t>& data, const View_t& view, const QColor& color, QPainter& painter);
+
+    /// Loads and indexes a file on the calling thread
+    ///     @return nullptr on error
+    static std::shared_ptr<const Data_t> load(const QString& file, QString& errorString);
+
+    /// Web Mercator world size in pixels at zoomLevel, matching the 256 pixel tiles of the map plugin
+    static double worldSize(double zoomLevel);
+
+    static QPointF  toMercator  (double latitude, double longitude);
+    static QRectF   visibleRect (const View_t& view);   ///< Normalized Web Mercator, covers the view at any bearing
+
+    static constexpr int gridLevel = 10;    ///< The grid has 2^gridLevel cells on each side of the world
+
+signals:
+    void loadingChanged     (bool loading);
+    void errorStringChanged (const QString& errorString);
+    void dataChanged        (void);
+    void visibleChanged     (bool visible);
+    void colorChanged       (const QColor& color);
+
+private slots:
+    void _loadDone(void);
+
+private:
+    struct BackgroundLoad_t {
+        quint64                         generation = 0;
+        std::shared_ptr<const Data_t>   data;
+        QString                         errorString;
+    };
+
+    QString                             _file;
+    bool                                _visible =      true;
+    QColor                              _color =        QColor(255, 160, 0);
+    QString                             _errorString;
+    std::shared_ptr<const Data_t>       _data;
+    quint64                             _generation =   0;  ///< Bumped by reload, results of older generations are stale
+    QFutureWatcher<BackgroundLoad_t>    _loadWatcher;
+};
+
+struct MapOverlayLayer::Data_t {
+    struct Shape_t {
+        bool                    polygon = false;
+        QRectF                  bounds;
+        QList<QList<QPolygonF>> lods;   ///< Parts per zoom band of lodZoomLevels, the last is full resolution
+    };
+
+    QList<Shape_t>              shapes;
+    QHash<quint32, QList<int>>  grid;   ///< Cell (y << gridLevel | x) to the shapes touching it
+    QList<int>                  large;  ///< Shapes touching more than maxShapeCells cells, which are not in the grid
+    QRectF                      bounds;
+
+    static constexpr double lodZoomLevels[] = { 4, 8, 12, 16 };
+    static constexpr int    maxShapeCells =   64;
+};
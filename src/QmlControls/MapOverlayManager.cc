@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MapOverlayManager.h"
+#include "MapOverlayLayer.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QApplicationStatic>
+#include <QtCore/QSettings>
+
+#include <tuple>
+
+QGC_LOGGING_CATEGORY(MapOverlayManagerLog, "qgc.qmlcontrols.mapoverlaymanager")
+
+Q_APPLICATION_STATIC(MapOverlayManager, _mapOverlayManager);
+
+MapOverlayManager::MapOverlayManager(QObject* parent)
+    : QObject(parent)
+{
+    _loadSettings();
+}
+
+MapOverlayManager* MapOverlayManager::instance(void)
+{
+    return _mapOverlayManager();
+}
+
+MapOverlayLayer* MapOverlayManager::addLayer(const QString& file)
+{
+    for (int i = 0; i < _layers.count(); i++) {
+        MapOverlayLayer* const layer = _layers.value<MapOverlayLayer*>(i);
+        if (layer->file() == file) {
+            return layer;
+        }
+    }
+
+    qCDebug(MapOverlayManagerLog) << "add" << file;
+
+    MapOverlayLayer* const layer = new MapOverlayLayer(file, this);
+    (void) connect(layer, &MapOverlayLayer::colorChanged,   this, &MapOverlayManager::_saveSettings);
+    (void) connect(layer, &MapOverlayLayer::visibleChanged, this, &MapOverlayManager::_saveSettings);
+    _layers.append(layer);
+    _saveSettings();
+
+    return layer;
+}
+
+void MapOverlayManager::removeLayer(MapOverlayLayer* layer)
+{
+    if (!layer || (_layers.indexOf(layer) < 0)) {
+        return;
+    }
+
+    qCDebug(MapOverlayManagerLog) << "remove" << layer->file();
+
+    (void) _layers.removeOne(layer);
+    layer->deleteLater();
+    _saveSettings();
+}
+
+void MapOverlayManager::_loadSettings(void)
+{
+    QSettings settings;
+    settings.beginGroup(_settingsGroup);
+
+    const int count = settings.beginReadArray(_layersKey);
+    QList<std::tuple<QString, QColor, bool>> entries;
+    for (int i = 0; i < count; i++) {
+        settings.setArrayIndex(i);
+        entries.append({ settings.value(_fileKey).toString(), settings.value(_colorKey).value<QColor>(), settings.value(_visibleKey, true).toBool() });
+    }
+    settings.endArray();
+
+    for (const auto& [file, color, visible] : std::as_const(entries)) {
+        if (file.isEmpty()) {
+            continue;
+        }
+        MapOverlayLayer* const layer = addLayer(file);
+        if (color.isValid()) {
+            layer->setColor(color);
+        }
+        layer->setVisible(visible);
+    }
+}
+
+void MapOverlayManager::_saveSettings(void)
+{
+    QSettings settings;
+    settings.beginGroup(_settingsGroup);
+
+    settings.beginWriteArray(_layersKey, _layers.count());
+    for (int i = 0; i < _layers.count(); i++) {
+        const MapOverlayLayer* const layer = _layers.value<MapOverlayLayer*>(i);
+        settings.setArrayIndex(i);
+        settings.setValue(_fileKey,     layer->file());
+        settings.setValue(_colorKey,    layer->color());
+        settings.setValue(_visibleKey,  layer->visible());
+    }
+    settings.endArray();
+}
@@ -0,0 +1,55 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QmlObjectListModel.h"
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+
+class MapOverlayLayer;
+
+Q_DECLARE_LOGGING_CATEGORY(MapOverlayManagerLog)
+
+/// The reference overlays shown on the Fly and Plan maps. The list of files with their color and visibility is saved
+/// in the settings and loaded again at startup.
+class MapOverlayManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    MapOverlayManager(QObject* parent = nullptr);
+
+    static MapOverlayManager* instance(void);
+
+    Q_PROPERTY(QmlObjectListModel* layers READ layers CONSTANT)
+
+    QmlObjectListModel* layers(void) { return &_layers; }
+
+    /// Adds a KML or SHP file, which loads in the background
+    ///     @return The new layer, or the existing one if the file is already shown
+    Q_INVOKABLE MapOverlayLayer* addLayer(const QString& file);
+
+    Q_INVOKABLE void removeLayer(MapOverlayLayer* layer);
+
+private slots:
+    void _saveSettings(void);
+
+private:
+    void _loadSettings(void);
+
+    QmlObjectListModel _layers;
+
+    static constexpr const char* _settingsGroup =   "MapOverlays";
+    static constexpr const char* _layersKey =       "layers";
+    static constexpr const char* _fileKey =         "file";
+    static constexpr const char* _colorKey =        "color";
+    static constexpr const char* _visibleKey =      "visible";
+};
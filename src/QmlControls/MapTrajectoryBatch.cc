@@ -0,0 +1,292 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MapTrajectoryBatch.h"
+#include "MapOverlayLayer.h"
+#include "QmlObjectListModel.h"
+#include "TrajectoryPoints.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QtMath>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtQuick/QSGFlatColorMaterial>
+#include <QtQuick/QSGGeometryNode>
+
+QGC_LOGGING_CATEGORY(MapTrajectoryBatchLog, "qgc.qmlcontrols.maptrajectorybatch")
+
+MapTrajectoryBatch::MapTrajectoryBatch(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    (void) connect(this, &MapTrajectoryBatch::appearanceChanged,    this, &MapTrajectoryBatch::_viewChanged);
+    (void) connect(this, &QQuickItem::widthChanged,                 this, &MapTrajectoryBatch::_viewChanged);
+    (void) connect(this, &QQuickItem::heightChanged,                this, &MapTrajectoryBatch::_viewChanged);
+}
+
+void MapTrajectoryBatch::setMap(QQuickItem* map)
+{
+    if (map == _map) {
+        return;
+    }
+
+    if (_map) {
+        (void) disconnect(_map, nullptr, this, nullptr);
+    }
+    _map = map;
+
+    if (_map) {
+        for (const char* propertyName: { "center", "zoomLevel", "bearing", "tilt" }) {
+            const int propertyIndex = _map->metaObject()->indexOfProperty(propertyName);
+            if (propertyIndex < 0) {
+                qCWarning(MapTrajectoryBatchLog) << "map has no property" << propertyName << _map;
+                continue;
+            }
+            const QMetaProperty property = _map->metaObject()->property(propertyIndex);
+            if (property.hasNotifySignal()) {
+                (void) connect(_map, property.notifySignal(), this, metaObject()->method(metaObject()->indexOfSlot("_viewChanged()")));
+            }
+        }
+    }
+
+    emit mapChanged();
+    _viewChanged();
+}
+
+void MapTrajectoryBatch::setVehicles(QmlObjectListModel* vehicles)
+{
+    if (vehicles == _vehicles) {
+        return;
+    }
+
+    if (_vehicles) {
+        (void) disconnect(_vehicles, nullptr, this, nullptr);
+    }
+    _vehicles = vehicles;
+
+    if (_vehicles) {
+        (void) connect(_vehicles, &QAbstractItemModel::rowsInserted,   this, &MapTrajectoryBatch::_vehiclesChanged);
+        (void) connect(_vehicles, &QAbstractItemModel::rowsRemoved,    this, &MapTrajectoryBatch::_vehiclesChanged);
+        (void) connect(_vehicles, &QAbstractItemModel::modelReset,     this, &MapTrajectoryBatch::_vehiclesChanged);
+    }
+
+    emit vehiclesChanged();
+    _vehiclesChanged();
+}
+
+void MapTrajectoryBatch::_vehiclesChanged(void)
+{
+    for (const Trajectory_t& trajectory: std::as_const(_trajectories)) {
+        if (trajectory.trajectoryPoints) {
+            (void) disconnect(trajectory.trajectoryPoints, nullptr, this, nullptr);
+        }
+    }
+    _trajectories.clear();
+
+    if (_vehicles) {
+        for (int i = 0; i < _vehicles->count(); i++) {
+            QObject* const vehicle = _vehicles->get(i);
+            TrajectoryPoints* const trajectoryPoints = vehicle ? vehicle->property("trajectoryPoints").value<TrajectoryPoints*>() : nullptr;
+            if (!trajectoryPoints) {
+                continue;
+            }
+
+            (void) connect(trajectoryPoints, &TrajectoryPoints::pointAdded,     this, [this, trajectoryPoints]() { _trajectoryChanged(trajectoryPoints, true); });
+            (void) connect(trajectoryPoints, &TrajectoryPoints::updateLastPoint,this, [this, trajectoryPoints]() { _trajectoryChanged(trajectoryPoints, true); });
+            (void) connect(trajectoryPoints, &TrajectoryPoints::tailChanged,    this, [this, trajectoryPoints]() { _trajectoryChanged(trajectoryPoints, false); });
+            (void) connect(trajectoryPoints, &TrajectoryPoints::pointsCleared,  this, [this, trajectoryPoints]() { _trajectoryChanged(trajectoryPoints, false); });
+
+            Trajectory_t trajectory;
+            trajectory.vehicle          = vehicle;
+            trajectory.trajectoryPoints = trajectoryPoints;
+            _trajectories.append(trajectory);
+        }
+    }
+
+    _viewChanged();
+}
+
+void MapTrajectoryBatch::_trajectoryChanged(TrajectoryPoints* trajectoryPoints, bool tailOnly)
+{
+    for (Trajectory_t& trajectory: _trajectories) {
+        if (trajectory.trajectoryPoints == trajectoryPoints) {
+            if (tailOnly) {
+                trajectory.tailDirty = true;
+            } else {
+                trajectory.dirty = true;
+            }
+            break;
+        }
+    }
+
+    polish();
+}
+
+void MapTrajectoryBatch::_viewChanged(void)
+{
+    polish();
+}
+
+/// Converts the paths of a trajectory to Web Mercator. Completed chunks only change with the level of detail, so
+/// while a vehicle flies only the tail is converted again.
+void MapTrajectoryBatch::_updateTrajectory(Trajectory_t& trajectory, int lodLevel)
+{
+    const QList<const QList<TrajectoryPoints::Point>*> paths = trajectory.trajectoryPoints->paths(lodLevel);
+
+    const bool all = trajectory.dirty || (trajectory.lodLevel != lodLevel) || (trajectory.paths.count() != paths.count());
+    if (!all && !trajectory.tailDirty) {
+        return;
+    }
+
+    trajectory.paths.resize(paths.count());
+    for (qsizetype i = all ? 0 : (paths.count() - 1); i < paths.count(); i++) {
+        QList<QPointF>& mercatorPath = trajectory.paths[i];
+        mercatorPath.clear();
+        mercatorPath.reserve(paths[i]->count());
+        for (const TrajectoryPoints::Point& point: *paths[i]) {
+            mercatorPath.append(MapOverlayLayer::toMercator(point.latitude, point.longitude));
+        }
+    }
+
+    trajectory.lodLevel     = lodLevel;
+    trajectory.dirty        = false;
+    trajectory.tailDirty    = false;
+}
+
+void MapTrajectoryBatch::updatePolish(void)
+{
+    _segments.clear();
+    _highlightStart = 0;
+    _tilted = _map && !qFuzzyIsNull(_map->property("tilt").toDouble());
+
+    if (!_map || _tilted || _trajectories.isEmpty() || size().isEmpty()) {
+        update();
+        return;
+    }
+
+    const QGeoCoordinate mapCenter = _map->property("center").value<QGeoCoordinate>();
+    const QPointF center = MapOverlayLayer::toMercator(mapCenter.latitude(), mapCenter.longitude());
+    const double zoomLevel = _map->property("zoomLevel").toDouble();
+    const double world = MapOverlayLayer::worldSize(zoomLevel);
+    const double bearing = qDegreesToRadians(_map->property("bearing").toDouble());
+    const double cosBearing = qCos(bearing);
+    const double sinBearing = qSin(bearing);
+    const QPointF itemCenter(width() / 2.0, height() / 2.0);
+    const QRectF cullRect = QRectF(QPointF(0, 0), size()).adjusted(-_lineWidth, -_lineWidth, _lineWidth, _lineWidth);
+
+    // The map is rotated by -bearing, screen y is down
+    const auto toItem = [&](const QPointF& mercator) {
+        const QPointF offset = (mercator - center) * world;
+        return itemCenter + QPointF((offset.x() * cosBearing) + (offset.y() * sinBearing), (offset.y() * cosBearing) - (offset.x() * sinBearing));
+    };
+
+    // Highlighted trajectory last, so it is drawn on top
+    QList<Trajectory_t*> drawOrder;
+    Trajectory_t* highlight = nullptr;
+    for (Trajectory_t& trajectory: _trajectories) {
+        if (!trajectory.trajectoryPoints) {
+            continue;
+        }
+        if (_highlightVehicle && (trajectory.vehicle == _highlightVehicle)) {
+            highlight = &trajectory;
+        } else {
+            drawOrder.append(&trajectory);
+        }
+    }
+    if (highlight) {
+        drawOrder.append(highlight);
+    }
+
+    for (Trajectory_t* const trajectory: std::as_const(drawOrder)) {
+        if (trajectory == highlight) {
+            _highlightStart = _segments.count();
+        }
+
+        _updateTrajectory(*trajectory, trajectory->trajectoryPoints->lodLevelForZoom(zoomLevel));
+
+        for (const QList<QPointF>& path: std::as_const(trajectory->paths)) {
+            if (path.count() < 2) {
+                continue;
+            }
+            QPointF from = toItem(path.first());
+            for (qsizetype i = 1; i < path.count(); i++) {
+                const QPointF to = toItem(path[i]);
+                const QRectF segmentRect = QRectF(from, to).normalized();
+                if ((segmentRect.right() >= cullRect.left()) && (segmentRect.left() <= cullRect.right()) && (segmentRect.bottom() >= cullRect.top()) && (segmentRect.top() <= cullRect.bottom())) {
+                    _segments.append({ from, to });
+                }
+                from = to;
+            }
+        }
+    }
+
+    if (!highlight) {
+        _highlightStart = _segments.count();
+    }
+
+    update();
+}
+
+QSGNode* MapTrajectoryBatch::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    if (_segments.isEmpty() || _tilted) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    // One node for the regular trajectories and one for the highlighted one, which are the only two colors
+    QSGNode* node = oldNode;
+    if (!node) {
+        node = new QSGNode;
+        for (int i = 0; i < 2; i++) {
+            QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+            geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+
+            QSGGeometryNode* geometryNode = new QSGGeometryNode;
+            geometryNode->setGeometry(geometry);
+            geometryNode->setFlag(QSGNode::OwnsGeometry);
+            geometryNode->setMaterial(new QSGFlatColorMaterial);
+            geometryNode->setFlag(QSGNode::OwnsMaterial);
+            node->appendChildNode(geometryNode);
+        }
+    }
+
+    const double halfWidth = _lineWidth / 2.0;
+    QSGGeometryNode* geometryNode = static_cast<QSGGeometryNode*>(node->firstChild());
+    for (int i = 0; i < 2; i++) {
+        const qsizetype first = (i == 0) ? 0 : _highlightStart;
+        const qsizetype last = (i == 0) ? _highlightStart : _segments.count();
+
+        QSGFlatColorMaterial* const material = static_cast<QSGFlatColorMaterial*>(geometryNode->material());
+        const QColor color = (i == 0) ? _color : _highlightColor;
+        if (material->color() != color) {
+            material->setColor(color);
+            geometryNode->markDirty(QSGNode::DirtyMaterial);
+        }
+
+        // Each segment is a quad of two triangles, widened perpendicular to its direction
+        QSGGeometry* const geometry = geometryNode->geometry();
+        geometry->allocate(static_cast<int>((last - first) * 6));
+        QSGGeometry::Point2D* vertex = geometry->vertexDataAsPoint2D();
+        for (qsizetype j = first; j < last; j++) {
+            const Segment_t& segment = _segments[j];
+            const QPointF delta = segment.to - segment.from;
+            const double length = qSqrt(QPointF::dotProduct(delta, delta));
+            const QPointF normal = (length > 0) ? (QPointF(-delta.y(), delta.x()) * (halfWidth / length)) : QPointF(halfWidth, 0);
+            for (const QPointF& point: { segment.from + normal, segment.from - normal, segment.to + normal, segment.to + normal, segment.from - normal, segment.to - normal }) {
+                (vertex++)->set(static_cast<float>(point.x()), static_cast<float>(point.y()));
+            }
+        }
+        geometryNode->markDirty(QSGNode::DirtyGeometry);
+
+        geometryNode = static_cast<QSGGeometryNode*>(geometryNode->nextSibling());
+    }
+
+    return node;
+}
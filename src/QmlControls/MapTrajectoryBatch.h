@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
+#include <QtGui/QColor>
+#include <QtQuick/QQuickItem>
+
+Q_DECLARE_LOGGING_CATEGORY(MapTrajectoryBatchLog)
+
+class QmlObjectListModel;
+class TrajectoryPoints;
+
+/// Draws the trajectories of all vehicles of a model as a single scene graph geometry node, in place of one QML map
+/// polyline per trajectory chunk. Points are read straight from each vehicle's TrajectoryPoints at the level of detail
+/// for the current zoom and kept in Web Mercator, so a change of view only transforms them and a new point only
+/// converts the trajectory chunk which is being filled. Segments outside the item are culled. The item is meant to
+/// fill the map:
+///
+///     MapTrajectoryBatch {
+///         anchors.fill:       parent
+///         map:                parent
+///         vehicles:           QGroundControl.multiVehicleManager.vehicles
+///         highlightVehicle:   QGroundControl.multiVehicleManager.activeVehicle
+///     }
+///
+/// Trajectories are hidden while the map is tilted.
+class MapTrajectoryBatch : public QQuickItem
+{
+    Q_OBJECT
+
+public:
+    MapTrajectoryBatch(QQuickItem* parent = nullptr);
+
+    Q_PROPERTY(QQuickItem*          map                 READ map        WRITE setMap        NOTIFY mapChanged)
+    Q_PROPERTY(QmlObjectListModel*  vehicles            READ vehicles   WRITE setVehicles   NOTIFY vehiclesChanged)
+    Q_PROPERTY(QObject*             highlightVehicle    MEMBER _highlightVehicle            NOTIFY appearanceChanged)   ///< Drawn on top in highlightColor
+    Q_PROPERTY(QColor               color               MEMBER _color                       NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor               highlightColor      MEMBER _highlightColor              NOTIFY appearanceChanged)
+    Q_PROPERTY(double               lineWidth           MEMBER _lineWidth                   NOTIFY appearanceChanged)   ///< Pixels
+
+    QQuickItem*         map     (void) const { return _map; }
+    QmlObjectListModel* vehicles(void) const { return _vehicles; }
+
+    void setMap     (QQuickItem* map);
+    void setVehicles(QmlObjectListModel* vehicles);
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) override;
+    void updatePolish(void) override;
+
+signals:
+    void mapChanged         (void);
+    void vehiclesChanged    (void);
+    void appearanceChanged  (void);
+
+private slots:
+    void _vehiclesChanged   (void);
+    void _viewChanged       (void);
+
+private:
+    /// Trajectory of one vehicle in normalized Web Mercator, one list per chunk with the tail last
+    struct Trajectory_t {
+        QPointer<QObject>           vehicle;
+        QPointer<TrajectoryPoints>  trajectoryPoints;
+        int                         lodLevel =  -2;         ///< Level the paths were converted at, -2 for none
+        bool                        dirty =     true;       ///< All paths need converting
+        bool                        tailDirty = false;      ///< Only the tail path needs converting
+        QList<QList<QPointF>>       paths;
+    };
+
+    struct Segment_t {
+        QPointF from;
+        QPointF to;
+    };
+
+    void _updateTrajectory  (Trajectory_t& trajectory, int lodLevel);
+    void _trajectoryChanged (TrajectoryPoints* trajectoryPoints, bool tailOnly);
+
+    QPointer<QQuickItem>            _map;
+    QPointer<QmlObjectListModel>    _vehicles;
+    QObject*                        _highlightVehicle = nullptr;    ///< Only compared, never dereferenced
+    QList<Trajectory_t>             _trajectories;
+
+    QColor  _color =            QColor(255, 0, 0, 128);
+    QColor  _highlightColor =   Qt::red;
+    double  _lineWidth =        3;
+
+    QList<Segment_t>    _segments;                      ///< Item pixels, the highlighted ones from _highlightStart
+    qsizetype           _highlightStart =   0;
+    bool                _tilted =           false;
+
+    Q_DISABLE_COPY(MapTrajectoryBatch)
+};
+
+QML_DECLARE_TYPE(MapTrajectoryBatch)
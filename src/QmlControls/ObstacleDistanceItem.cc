@@ -0,0 +1,282 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ObstacleDistanceItem.h"
+#include "VehicleObjectAvoidance.h"
+
+#include <QtCore/QtMath>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGVertexColorMaterial>
+
+namespace {
+    typedef struct {
+        float position;
+        float r, g, b, a;
+    } GradientStop_t;
+
+    // Red close to the vehicle fading to transparent green at the gradient end, the same stops the canvas overlays used
+    constexpr GradientStop_t sectorsGradient[] = {
+        { 0.0f,     1.0f, 0.0f,  0.0f, 0.9f },
+        { 0.1f,     1.0f, 0.0f,  0.0f, 0.3f },
+        { 0.5f,     1.0f, 0.64f, 0.0f, 0.3f },
+        { 0.65f,    1.0f, 0.64f, 0.0f, 0.2f },
+        { 0.95f,    0.0f, 1.0f,  0.0f, 0.1f },
+        { 1.0f,     0.0f, 1.0f,  0.0f, 0.0f },
+    };
+    constexpr GradientStop_t bandGradient[] = {
+        { 0.0f,     1.0f, 0.0f,  0.0f, 1.0f },
+        { 0.1f,     1.0f, 0.0f,  0.0f, 0.7f },
+        { 0.5f,     1.0f, 0.64f, 0.0f, 0.7f },
+        { 0.65f,    1.0f, 0.64f, 0.0f, 0.3f },
+        { 0.95f,    0.0f, 1.0f,  0.0f, 0.3f },
+        { 1.0f,     0.0f, 1.0f,  0.0f, 0.0f },
+    };
+
+    /// Gradient color at position as premultiplied vertex color
+    template<size_t N>
+    void setVertex(QSGGeometry::ColoredPoint2D* vertex, const QPointF& point, const GradientStop_t (&stops)[N], float position)
+    {
+        position = qBound(0.0f, position, 1.0f);
+        size_t upper = 1;
+        while ((upper < N - 1) && (stops[upper].position < position)) {
+            upper++;
+        }
+        const GradientStop_t& from = stops[upper - 1];
+        const GradientStop_t& to = stops[upper];
+        const float span = to.position - from.position;
+        const float t = (span > 0) ? qBound(0.0f, (position - from.position) / span, 1.0f) : 1.0f;
+        const float a = from.a + ((to.a - from.a) * t);
+        const auto channel = [a, t](float from, float to) {
+            return static_cast<uchar>(qRound((from + ((to - from) * t)) * a * 255));
+        };
+        vertex->set(static_cast<float>(point.x()), static_cast<float>(point.y()),
+                    channel(from.r, to.r), channel(from.g, to.g), channel(from.b, to.b), static_cast<uchar>(qRound(a * 255)));
+    }
+}
+
+ObstacleDistanceItem::ObstacleDistanceItem(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+
+    (void) connect(this, &ObstacleDistanceItem::layoutChanged, this, &ObstacleDistanceItem::_dataChanged);
+}
+
+void ObstacleDistanceItem::setObjectAvoidance(VehicleObjectAvoidance* objectAvoidance)
+{
+    if (objectAvoidance == _objectAvoidance) {
+        return;
+    }
+
+    if (_objectAvoidance) {
+        (void) disconnect(_objectAvoidance, nullptr, this, nullptr);
+    }
+    _objectAvoidance = objectAvoidance;
+    if (_objectAvoidance) {
+        (void) connect(_objectAvoidance, &VehicleObjectAvoidance::objectAvoidanceChanged, this, &ObstacleDistanceItem::_dataChanged);
+    }
+
+    emit objectAvoidanceChanged();
+    _dataChanged();
+}
+
+/// Only marks the geometry dirty, so several OBSTACLE_DISTANCE messages within one frame cause a single rebuild
+void ObstacleDistanceItem::_dataChanged(void)
+{
+    _dirty = true;
+    polish();
+}
+
+int ObstacleDistanceItem::_rangeIndex(double degrees, double headingDegrees) const
+{
+    const int index = qCeil((360.0 - headingDegrees + degrees - _offsetDegrees) / _incrementDegrees);
+    return ((index % _rangeCount) + _rangeCount) % _rangeCount;
+}
+
+double ObstacleDistanceItem::_rangeMeters(int index) const
+{
+    // UINT16_MAX is no obstacle, so like everything past the maximum it shows as the maximum
+    const int centimeters = _distances[index];
+    if ((centimeters == UINT16_MAX) || (centimeters / 100.0 > _maxRangeMeters)) {
+        return _maxRangeMeters;
+    }
+    return centimeters / 100.0;
+}
+
+QPointF ObstacleDistanceItem::_toItem(double radius, double radians) const
+{
+    return _center + QPointF(radius * qCos(radians) * _horizontalScale, radius * qSin(radians));
+}
+
+void ObstacleDistanceItem::_addQuad(const QPointF& innerFrom, const QPointF& outerFrom, const QPointF& innerTo, const QPointF& outerTo)
+{
+    const auto radius = [this](const QPointF& point) {
+        const QPointF offset = point - _center;
+        return qSqrt(QPointF::dotProduct(offset, offset));
+    };
+
+    for (const QPointF& point: { innerFrom, outerFrom, outerTo, innerFrom, outerTo, innerTo }) {
+        _vertices.append({ point, radius(point) });
+    }
+}
+
+void ObstacleDistanceItem::_addSegment(double radiusFrom, double radiusTo, double radiansFrom, double radiansTo)
+{
+    const double step = (radiansTo - radiansFrom) / _arcSteps;
+    for (int i = 0; i < _arcSteps; i++) {
+        const double from = radiansFrom + (step * i);
+        const double to = from + step;
+        _addQuad(_toItem(radiusTo, from), _toItem(radiusFrom, from), _toItem(radiusTo, to), _toItem(radiusFrom, to));
+    }
+}
+
+/// Each sector stacks one segment per _levelMeters of range from the outside in, down to the closest obstacle
+/// within the sector
+void ObstacleDistanceItem::_buildSectors(QList<QVector3D>& labels)
+{
+    const double levelCount = _maxRangeMeters / _levelMeters;
+    const double sectorDegrees = 360.0 / _sectorCount;
+    _gradientFrom = _outerRadius - (_segmentHeight * levelCount * 2);
+    _gradientTo = _outerRadius;
+
+    for (int sector = 0; sector < _sectorCount; sector++) {
+        const double degrees = sector * sectorDegrees;
+        const int first = _rangeIndex(degrees, 0);
+        const int next = _rangeIndex(degrees + sectorDegrees, 0);
+        const int end = (first < next) ? next : _rangeCount + next;
+        double rangeMin = _maxRangeMeters;
+        for (int i = first; i < end; i++) {
+            rangeMin = qMin(rangeMin, _rangeMeters(i % _rangeCount));
+        }
+
+        const double radiansFrom = qDegreesToRadians(degrees);
+        const double radiansTo = radiansFrom + qDegreesToRadians(sectorDegrees) - _sectorGapRadians;
+        for (int level = 0; level < levelCount; level++) {
+            const double radiusFrom = _outerRadius - (level * _segmentHeight * 2);
+            _addSegment(radiusFrom, radiusFrom - _segmentHeight, radiansFrom, radiansTo);
+
+            const double rangeInLevel = _maxRangeMeters - ((level + 1) * _levelMeters);
+            if ((rangeMin > rangeInLevel) || (level >= levelCount - 1)) {
+                if (_showText && (rangeMin < _maxRangeMeters)) {
+                    const QPointF labelPoint = (_toItem(radiusFrom, radiansFrom) + _toItem(radiusFrom, radiansTo)) / 2;
+                    labels.append(QVector3D(labelPoint.x(), labelPoint.y(), rangeMin));
+                }
+                break;
+            }
+        }
+    }
+}
+
+/// A band at the distance of each sensor sector, rotated by heading
+void ObstacleDistanceItem::_buildBand(QList<QVector3D>& labels)
+{
+    _gradientFrom = _innerRadius;
+    _gradientTo = _outerRadius;
+
+    QList<QPointF> inner(_rangeCount);
+    QList<QPointF> outer(_rangeCount);
+    QList<double> ranges(_rangeCount);
+    for (int i = 0; i < _rangeCount; i++) {
+        const double degrees = i * _incrementDegrees;
+        const double radians = qDegreesToRadians(degrees);
+        ranges[i] = _rangeMeters(_rangeIndex(degrees, _heading));
+        const double radius = _innerRadius + (ranges[i] * _pixelsPerMeter);
+        outer[i] = _toItem(radius, radians);
+        inner[i] = _toItem(radius - _segmentHeight, radians);
+    }
+
+    for (int i = 0; i < _rangeCount; i++) {
+        const int next = (i + 1) % _rangeCount;
+        _addQuad(inner[i], outer[i], inner[next], outer[next]);
+    }
+
+    if (_showText) {
+        // One label for every three sectors at most, at the closer of the first two
+        double previousRange = -1;
+        for (int i = 0; i < _rangeCount; i += 3) {
+            const int next = (i + 1) % _rangeCount;
+            const int closest = (ranges[next] < ranges[i]) ? next : i;
+            const double range = ranges[closest];
+            if ((range < _maxRangeMeters) && (qAbs(range - previousRange) > _labelMinChangeMeters)) {
+                labels.append(QVector3D(inner[closest].x(), inner[closest].y(), range));
+                previousRange = range;
+            }
+        }
+    }
+}
+
+void ObstacleDistanceItem::updatePolish(void)
+{
+    if (!_dirty) {
+        return;
+    }
+    _dirty = false;
+    _vertices.clear();
+
+    QList<QVector3D> labels;
+    if (_objectAvoidance && _objectAvoidance->available() && (_objectAvoidance->increment() > 0)) {
+        _distances          = _objectAvoidance->distances();
+        _incrementDegrees   = _objectAvoidance->increment();
+        _offsetDegrees      = _objectAvoidance->angleOffset();
+        _maxRangeMeters     = _objectAvoidance->maxDistance() / 100.0;
+        _rangeCount         = qMin(static_cast<int>(360.0 / _incrementDegrees), static_cast<int>(_distances.count()));
+
+        if ((_rangeCount > 0) && (_maxRangeMeters > 0)) {
+            if (_style == Sectors) {
+                _buildSectors(labels);
+            } else {
+                _buildBand(labels);
+            }
+        }
+    }
+
+    if (labels != _labels) {
+        _labels = labels;
+        emit labelsChanged();
+    }
+
+    update();
+}
+
+QSGNode* ObstacleDistanceItem::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
+{
+    if (_vertices.isEmpty()) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    QSGGeometryNode* node = static_cast<QSGGeometryNode*>(oldNode);
+    if (!node) {
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+
+        node = new QSGGeometryNode;
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+    }
+
+    QSGGeometry* const geometry = node->geometry();
+    geometry->allocate(_vertices.count());
+    QSGGeometry::ColoredPoint2D* vertex = geometry->vertexDataAsColoredPoint2D();
+
+    const double gradientSpan = _gradientTo - _gradientFrom;
+    for (const Vertex_t& source: _vertices) {
+        const float position = (gradientSpan > 0) ? static_cast<float>((source.radius - _gradientFrom) / gradientSpan) : 0.0f;
+        if (_style == Sectors) {
+            setVertex(vertex++, source.point, sectorsGradient, position);
+        } else {
+            setVertex(vertex++, source.point, bandGradient, position);
+        }
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
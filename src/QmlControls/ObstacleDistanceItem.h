@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QPointer>
+#include <QtGui/QVector3D>
+#include <QtQuick/QQuickItem>
+
+class VehicleObjectAvoidance;
+
+/// Draws the OBSTACLE_DISTANCE sectors of a vehicle as a single scene graph geometry node. The distances are read
+/// straight from VehicleObjectAvoidance, so QML does not have to fetch them sector by sector. Messages arriving
+/// faster than the frame rate are coalesced, the geometry is only rebuilt once per frame in which something changed.
+///
+/// Range labels are not drawn by the item, it only lays them out. Each entry of labels is the item position in x/y
+/// and the range in meters in z, for QML Text items to show.
+class ObstacleDistanceItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_MOC_INCLUDE("VehicleObjectAvoidance.h")
+
+public:
+    ObstacleDistanceItem(QQuickItem* parent = nullptr);
+
+    enum Style {
+        Sectors,    ///< Fixed 16 sectors of stacked segments, for the video overlay
+        Band,       ///< Band following the distances of all sensor sectors, for the map
+    };
+    Q_ENUM(Style)
+
+    Q_PROPERTY(VehicleObjectAvoidance*  objectAvoidance READ objectAvoidance    WRITE setObjectAvoidance    NOTIFY objectAvoidanceChanged)
+    Q_PROPERTY(Style            style           MEMBER _style               NOTIFY layoutChanged)
+    Q_PROPERTY(QPointF          center          MEMBER _center              NOTIFY layoutChanged)   ///< Vehicle position in the item
+    Q_PROPERTY(double           heading         MEMBER _heading             NOTIFY layoutChanged)   ///< Degrees the distances are rotated by, Band only
+    Q_PROPERTY(double           innerRadius     MEMBER _innerRadius         NOTIFY layoutChanged)   ///< Pixels, Band: radius of zero distance
+    Q_PROPERTY(double           outerRadius     MEMBER _outerRadius         NOTIFY layoutChanged)   ///< Pixels, Sectors: radius of the outermost segment, Band: end of the color gradient
+    Q_PROPERTY(double           pixelsPerMeter  MEMBER _pixelsPerMeter      NOTIFY layoutChanged)   ///< Band only
+    Q_PROPERTY(double           segmentHeight   MEMBER _segmentHeight       NOTIFY layoutChanged)   ///< Pixels, height of a segment or of the band
+    Q_PROPERTY(double           horizontalScale MEMBER _horizontalScale     NOTIFY layoutChanged)   ///< Stretches x, the video overlay is drawn wider than high
+    Q_PROPERTY(bool             showText        MEMBER _showText            NOTIFY layoutChanged)
+    Q_PROPERTY(QList<QVector3D> labels          READ labels                 NOTIFY labelsChanged)
+
+    VehicleObjectAvoidance* objectAvoidance (void) const { return _objectAvoidance; }
+    QList<QVector3D>        labels          (void) const { return _labels; }
+
+    void setObjectAvoidance(VehicleObjectAvoidance* objectAvoidance);
+
+    // Overrides from QQuickItem
+    QSGNode* updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* updatePaintNodeData) override;
+    void updatePolish(void) override;
+
+signals:
+    void objectAvoidanceChanged (void);
+    void layoutChanged          (void);
+    void labelsChanged          (void);
+
+private slots:
+    void _dataChanged(void);
+
+private:
+    typedef struct {
+        QPointF point;
+        double  radius;     ///< Distance from center in pixels, selects the gradient color
+    } Vertex_t;
+
+    int     _rangeIndex     (double degrees, double headingDegrees) const;
+    double  _rangeMeters    (int index) const;
+    QPointF _toItem         (double radius, double radians) const;
+    void    _addSegment     (double radiusFrom, double radiusTo, double radiansFrom, double radiansTo);
+    void    _addQuad        (const QPointF& innerFrom, const QPointF& outerFrom, const QPointF& innerTo, const QPointF& outerTo);
+    void    _buildSectors   (QList<QVector3D>& labels);
+    void    _buildBand      (QList<QVector3D>& labels);
+
+    QPointer<VehicleObjectAvoidance> _objectAvoidance;
+
+    Style   _style =            Sectors;
+    QPointF _center;
+    double  _heading =          0;
+    double  _innerRadius =      0;
+    double  _outerRadius =      0;
+    double  _pixelsPerMeter =   0;
+    double  _segmentHeight =    0;
+    double  _horizontalScale =  1;
+    bool    _showText =         true;
+
+    // Copied from VehicleObjectAvoidance when rebuilding
+    QList<int>  _distances;
+    double      _incrementDegrees = 0;
+    double      _offsetDegrees =    0;
+    double      _maxRangeMeters =   0;
+    int         _rangeCount =       0;
+
+    QList<Vertex_t>     _vertices;
+    double              _gradientFrom = 0;      ///< Radius of the first gradient stop
+    double              _gradientTo =   0;
+    QList<QVector3D>    _labels;
+    bool                _dirty =        true;
+
+    static constexpr int    _sectorCount =          16;
+    static constexpr int    _arcSteps =             4;      ///< Straight pieces per sector arc
+    static constexpr double _levelMeters =          10;     ///< Range covered by each segment of a sector
+    static constexpr double _sectorGapRadians =     0.03;
+    static constexpr double _labelMinChangeMeters = 2.0;    ///< Band labels closer in range than this to the previous are skipped
+
+    Q_DISABLE_COPY(ObstacleDistanceItem)
+};
+
+QML_DECLARE_TYPE(ObstacleDistanceItem)
@@ -13,8 +13,9 @@
 #include "QGCQGeoCoordinate.h"
 #include "QGCApplication.h"
 #include "ShapeFileHelper.h"
-#include "KMLDomDocument.h"
+#include "KMLStreamWriter.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QLineF>
 
 QGCMapPolygon::QGCMapPolygon(QObject* parent)
@@ -49,18 +50,15 @@ void QGCMapPolygon::_init(void)
     connect(this, &QGCMapPolygon::pathChanged,  this, &QGCMapPolygon::_updateCenter);
     connect(this, &QGCMapPolygon::countChanged, this, &QGCMapPolygon::isValidChanged);
     connect(this, &QGCMapPolygon::countChanged, this, &QGCMapPolygon::isEmptyChanged);
+
+    connect(&_loadWatcher, &QFutureWatcherBase::finished, this, &QGCMapPolygon::_asyncLoadComplete);
 }
 
 const QGCMapPolygon& QGCMapPolygon::operator=(const QGCMapPolygon& other)
 {
     clear();
 
-    QVariantList vertices = other.path();
-    QList<QGeoCoordinate> rgCoord;
-    for (const QVariant& vertexVar: vertices) {
-        rgCoord.append(vertexVar.value<QGeoCoordinate>());
-    }
-    appendVertices(rgCoord);
+    appendVertices(other.coordinateList());
 
     setDirty(true);
 
@@ -70,16 +68,18 @@ const QGCMapPolygon& QGCMapPolygon::operator=(const QGCMapPolygon& other)
 void QGCMapPolygon::clear(void)
 {
     // Bug workaround, see below
-    while (_polygonPath.count() > 1) {
-        _polygonPath.takeLast();
+    while (_coordinates.count() > 1) {
+        _coordinates.takeLast();
     }
+    _coordinatesChanged();
     emit pathChanged();
 
     // Although this code should remove the polygon from the map it doesn't. There appears
     // to be a bug in QGCMapPolygon which causes it to not be redrawn if the list is empty. So
     // we work around it by using the code above to remove all but the last point which in turn
     // will cause the polygon to go away.
-    _polygonPath.clear();
+    _coordinates.clear();
+    _coordinatesChanged();
 
     _polygonModel.clearAndDeleteContents();
 
@@ -90,8 +90,7 @@ void QGCMapPolygon::clear(void)
 
 void QGCMapPolygon::adjustVertex(int vertexIndex, const QGeoCoordinate coordinate)
 {
-    _polygonPath[vertexIndex] = QVariant::fromValue(coordinate);
-    _polygonModel.value<QGCQGeoCoordinate*>(vertexIndex)->setCoordinate(coordinate);
+    _setVertex(vertexIndex, coordinate);
     if (!_centerDrag) {
         // When dragging center we don't signal path changed until all vertices are updated
         emit pathChanged();
@@ -110,48 +109,78 @@ void QGCMapPolygon::setDirty(bool dirty)
     }
 }
 
-QGeoCoordinate QGCMapPolygon::_coordFromPointF(const QPointF& point) const
+/// Updates a single vertex without signalling. The planar cache is patched in place unless the first vertex, which
+/// is the tangent origin, moved.
+void QGCMapPolygon::_setVertex(int vertexIndex, const QGeoCoordinate& coordinate)
 {
-    QGeoCoordinate coord;
+    _coordinates[vertexIndex] = coordinate;
+    _polygonPathValid = false;
+    _polygonModel.value<QGCQGeoCoordinate*>(vertexIndex)->setCoordinate(coordinate);
 
-    if (_polygonPath.count() > 0) {
-        QGeoCoordinate tangentOrigin = _polygonPath[0].value<QGeoCoordinate>();
-        QGCGeo::convertNedToGeo(-point.y(), point.x(), 0, tangentOrigin, coord);
+    if (vertexIndex == 0) {
+        _nedVerticesValid = false;
+    } else if (_nedVerticesValid) {
+        _nedVerticesCache[vertexIndex] = _nedFromCoord(coordinate);
     }
+}
 
-    return coord;
+void QGCMapPolygon::_coordinatesChanged(void)
+{
+    _polygonPathValid = false;
+    _nedVerticesValid = false;
 }
 
-QPointF QGCMapPolygon::_pointFFromCoord(const QGeoCoordinate& coordinate) const
+QPointF QGCMapPolygon::_nedFromCoord(const QGeoCoordinate& coordinate) const
 {
-    if (_polygonPath.count() > 0) {
-        double y, x, down;
-        QGeoCoordinate tangentOrigin = _polygonPath[0].value<QGeoCoordinate>();
+    // The batch conversion is used since it is well defined for a coordinate at the origin
+    const double lat = coordinate.latitude();
+    const double lon = coordinate.longitude();
+    double north, east;
+    QGCGeo::convertGeoToNed(&lat, &lon, nullptr, 1, _coordinates.first(), &north, &east, nullptr);
+    return QPointF(east, north);
+}
 
-        QGCGeo::convertGeoToNed(coordinate, tangentOrigin, y, x, down);
-        return QPointF(x, -y);
+const QList<QPointF>& QGCMapPolygon::_nedVertices(void) const
+{
+    if (!_nedVerticesValid) {
+        const qsizetype vertexCount = _coordinates.count();
+        QVector<double> lat(vertexCount), lon(vertexCount), north(vertexCount), east(vertexCount);
+        for (qsizetype i=0; i<vertexCount; i++) {
+            lat[i] = _coordinates[i].latitude();
+            lon[i] = _coordinates[i].longitude();
+        }
+        if (vertexCount > 0) {
+            QGCGeo::convertGeoToNed(lat.constData(), lon.constData(), nullptr, vertexCount, _coordinates.first(), north.data(), east.data(), nullptr);
+        }
+
+        _nedVerticesCache.resize(vertexCount);
+        for (qsizetype i=0; i<vertexCount; i++) {
+            _nedVerticesCache[i] = QPointF(east[i], north[i]);
+        }
+        _nedVerticesValid = true;
     }
 
-    return QPointF();
+    return _nedVerticesCache;
 }
 
-QPolygonF QGCMapPolygon::_toPolygonF(void) const
+QVariantList QGCMapPolygon::path(void) const
 {
-    QPolygonF polygon;
-
-    if (_polygonPath.count() > 2) {
-        for (int i=0; i<_polygonPath.count(); i++) {
-            polygon.append(_pointFFromCoord(_polygonPath[i].value<QGeoCoordinate>()));
+    if (!_polygonPathValid) {
+        _polygonPath.clear();
+        _polygonPath.reserve(_coordinates.count());
+        for (const QGeoCoordinate& coord: _coordinates) {
+            _polygonPath.append(QVariant::fromValue(coord));
         }
+        _polygonPathValid = true;
     }
 
-    return polygon;
+    return _polygonPath;
 }
 
 bool QGCMapPolygon::containsCoordinate(const QGeoCoordinate& coordinate) const
 {
-    if (_polygonPath.count() > 2) {
-        return _toPolygonF().containsPoint(_pointFFromCoord(coordinate), Qt::OddEvenFill);
+    if (_coordinates.count() > 2) {
+        return QPolygonF(_nedVertices()).containsPoint(_nedFromCoord(coordinate), Qt::OddEvenFill);
     } else {
         return false;
     }
@@ -159,10 +188,10 @@ bool QGCMapPolygon::containsCoordinate(const QGeoCoordinate& coordinate) const
 
 void QGCMapPolygon::setPath(const QList<QGeoCoordinate>& path)
 {
-    _polygonPath.clear();
+    _coordinates = path;
+    _coordinatesChanged();
     _polygonModel.clearAndDeleteContents();
     for(const QGeoCoordinate& coord: path) {
-        _polygonPath.append(QVariant::fromValue(coord));
         _polygonModel.append(new QGCQGeoCoordinate(coord, this));
     }
 
@@ -172,12 +201,14 @@ void QGCMapPolygon::setPath(const QList<QGeoCoordinate>& path)
 
 void QGCMapPolygon::setPath(const QVariantList& path)
 {
-    _polygonPath = path;
-
+    _coordinates.clear();
     _polygonModel.clearAndDeleteContents();
-    for (int i=0; i<_polygonPath.count(); i++) {
-        _polygonModel.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
+    for (const QVariant& varCoord: path) {
+        const QGeoCoordinate coord = varCoord.value<QGeoCoordinate>();
+        _coordinates.append(coord);
+        _polygonModel.append(new QGCQGeoCoordinate(coord, this));
     }
+    _coordinatesChanged();
 
     setDirty(true);
     emit pathChanged();
@@ -187,7 +218,7 @@ void QGCMapPolygon::saveToJson(QJsonObject& json)
 {
     QJsonValue jsonValue;
 
-    JsonHelper::saveGeoCoordinateArray(_polygonPath, false /* writeAltitude*/, jsonValue);
+    JsonHelper::saveGeoCoordinateArray(_coordinates, false /* writeAltitude*/, jsonValue);
     json.insert(jsonPolygonKey, jsonValue);
     setDirty(false);
 }
@@ -205,12 +236,13 @@ bool QGCMapPolygon::loadFromJson(const QJsonObject& json, bool required, QString
         return true;
     }
 
-    if (!JsonHelper::loadGeoCoordinateArray(json[jsonPolygonKey], false /* altitudeRequired */, _polygonPath, errorString)) {
+    if (!JsonHelper::loadGeoCoordinateArray(json[jsonPolygonKey], false /* altitudeRequired */, _coordinates, errorString)) {
         return false;
     }
+    _coordinatesChanged();
 
-    for (int i=0; i<_polygonPath.count(); i++) {
-        _polygonModel.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
+    for (const QGeoCoordinate& coord: _coordinates) {
+        _polygonModel.append(new QGCQGeoCoordinate(coord, this));
     }
 
     setDirty(false);
@@ -221,24 +253,18 @@ bool QGCMapPolygon::loadFromJson(const QJsonObject& json, bool required, QString
 
 QList<QGeoCoordinate> QGCMapPolygon::coordinateList(void) const
 {
-    QList<QGeoCoordinate> coords;
-
-    for (int i=0; i<_polygonPath.count(); i++) {
-        coords.append(_polygonPath[i].value<QGeoCoordinate>());
-    }
-
-    return coords;
+    return _coordinates;
 }
 
 void QGCMapPolygon::splitPolygonSegment(int vertexIndex)
 {
     int nextIndex = vertexIndex + 1;
-    if (nextIndex > _polygonPath.length() - 1) {
+    if (nextIndex > _coordinates.length() - 1) {
         nextIndex = 0;
     }
 
-    QGeoCoordinate firstVertex = _polygonPath[vertexIndex].value<QGeoCoordinate>();
-    QGeoCoordinate nextVertex = _polygonPath[nextIndex].value<QGeoCoordinate>();
+    QGeoCoordinate firstVertex = _coordinates[vertexIndex];
+    QGeoCoordinate nextVertex = _coordinates[nextIndex];
 
     double distance = firstVertex.distanceTo(nextVertex);
     double azimuth = firstVertex.azimuthTo(nextVertex);
@@ -248,7 +274,11 @@ void QGCMapPolygon::splitPolygonSegment(int vertexIndex)
         appendVertex(newVertex);
     } else {
         _polygonModel.insert(nextIndex, new QGCQGeoCoordinate(newVertex, this));
-        _polygonPath.insert(nextIndex, QVariant::fromValue(newVertex));
+        _coordinates.insert(nextIndex, newVertex);
+        _polygonPathValid = false;
+        if (_nedVerticesValid) {
+            _nedVerticesCache.insert(nextIndex, _nedFromCoord(newVertex));
+        }
         emit pathChanged();
         if (0 <= _selectedVertexIndex && vertexIndex < _selectedVertexIndex) {
             selectVertex(_selectedVertexIndex+1);
@@ -258,7 +288,11 @@ void QGCMapPolygon::splitPolygonSegment(int vertexIndex)
 
 void QGCMapPolygon::appendVertex(const QGeoCoordinate& coordinate)
 {
-    _polygonPath.append(QVariant::fromValue(coordinate));
+    _coordinates.append(coordinate);
+    _polygonPathValid = false;
+    if (_nedVerticesValid) {
+        _nedVerticesCache.append(_nedFromCoord(coordinate));
+    }
     _polygonModel.append(new QGCQGeoCoordinate(coordinate, this));
     emit pathChanged();
 }
@@ -268,10 +302,12 @@ void QGCMapPolygon::appendVertices(const QList<QGeoCoordinate>& coordinates)
     QList<QObject*> objects;
 
     _beginResetIfNotActive();
+    objects.reserve(coordinates.count());
     for (const QGeoCoordinate& coordinate: coordinates) {
         objects.append(new QGCQGeoCoordinate(coordinate, this));
-        _polygonPath.append(QVariant::fromValue(coordinate));
     }
+    _coordinates.append(coordinates);
+    _coordinatesChanged();
     _polygonModel.append(objects);
     _endResetIfNotActive();
 
@@ -296,12 +332,12 @@ void QGCMapPolygon::_polygonModelDirtyChanged(bool dirty)
 
 void QGCMapPolygon::removeVertex(int vertexIndex)
 {
-    if (vertexIndex < 0 && vertexIndex > _polygonPath.length() - 1) {
-        qWarning() << "Call to removePolygonCoordinate with bad vertexIndex:count" << vertexIndex << _polygonPath.length();
+    if (vertexIndex < 0 && vertexIndex > _coordinates.length() - 1) {
+        qWarning() << "Call to removePolygonCoordinate with bad vertexIndex:count" << vertexIndex << _coordinates.length();
         return;
     }
 
-    if (_polygonPath.length() <= 3) {
+    if (_coordinates.length() <= 3) {
         // Don't allow the user to trash the polygon
         return;
     }
@@ -314,7 +350,13 @@ void QGCMapPolygon::removeVertex(int vertexIndex)
         selectVertex(_selectedVertexIndex - 1);
     } // else do nothing - keep current selected vertex
 
-    _polygonPath.removeAt(vertexIndex);
+    _coordinates.removeAt(vertexIndex);
+    _polygonPathValid = false;
+    if (vertexIndex == 0) {
+        _nedVerticesValid = false;
+    } else if (_nedVerticesValid) {
+        _nedVerticesCache.removeAt(vertexIndex);
+    }
     emit pathChanged();
 }
 
@@ -328,13 +370,14 @@ void QGCMapPolygon::_updateCenter(void)
     if (!_ignoreCenterUpdates) {
         QGeoCoordinate center;
 
-        if (_polygonPath.count() > 2) {
+        if (_coordinates.count() > 2) {
             QPointF centroid(0, 0);
-            QPolygonF polygonF = _toPolygonF();
-            for (int i=0; i<polygonF.count(); i++) {
-                centroid += polygonF[i];
+            const QList<QPointF>& nedVertices = _nedVertices();
+            for (const QPointF& vertex: nedVertices) {
+                centroid += vertex;
             }
-            center = _coordFromPointF(QPointF(centroid.x() / polygonF.count(), centroid.y() / polygonF.count()));
+            centroid /= nedVertices.count();
+            QGCGeo::convertNedToGeo(centroid.y(), centroid.x(), 0, _coordinates.first(), center);
         }
         if (_center != center) {
             _center = center;
@@ -352,16 +395,12 @@ void QGCMapPolygon::setCenter(QGeoCoordinate newCenter)
         double distance = _center.distanceTo(newCenter);
         double azimuth = _center.azimuthTo(newCenter);
 
+        // All vertices are moved before signalling once, rather than a path change per vertex
         for (int i=0; i<count(); i++) {
-            QGeoCoordinate oldVertex = _polygonPath[i].value<QGeoCoordinate>();
-            QGeoCoordinate newVertex = oldVertex.atDistanceAndAzimuth(distance, azimuth);
-            adjustVertex(i, newVertex);
-        }
-
-        if (_centerDrag) {
-            // When center dragging, signals from adjustVertext are not sent. So we need to signal here when all adjusting is complete.
-            emit pathChanged();
+            _setVertex(i, _coordinates[i].atDistanceAndAzimuth(distance, azimuth));
         }
+        setDirty(true);
+        emit pathChanged();
 
         _ignoreCenterUpdates = false;
 
@@ -388,38 +427,19 @@ void QGCMapPolygon::setInteractive(bool interactive)
 
 QGeoCoordinate QGCMapPolygon::vertexCoordinate(int vertex) const
 {
-    if (vertex >= 0 && vertex < _polygonPath.count()) {
-        return _polygonPath[vertex].value<QGeoCoordinate>();
+    if (vertex >= 0 && vertex < _coordinates.count()) {
+        return _coordinates[vertex];
     } else {
-        qWarning() << "QGCMapPolygon::vertexCoordinate bad vertex requested:count" << vertex << _polygonPath.count();
+        qWarning() << "QGCMapPolygon::vertexCoordinate bad vertex requested:count" << vertex << _coordinates.count();
         return QGeoCoordinate();
     }
 }
 
 QList<QPointF> QGCMapPolygon::nedPolygon(void) const
 {
-    QList<QPointF>  nedPolygon;
-
-    if (count() > 0) {
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
-
-        for (int i=0; i<_polygonModel.count(); i++) {
-            double y, x, down;
-            QGeoCoordinate vertex = vertexCoordinate(i);
-            if (i == 0) {
-                // This avoids a nan calculation that comes out of convertGeoToNed
-                x = y = 0;
-            } else {
-                QGCGeo::convertGeoToNed(vertex, tangentOrigin, y, x, down);
-            }
-            nedPolygon += QPointF(x, y);
-        }
-    }
-
-    return nedPolygon;
+    return _nedVertices();
 }
 
-
 void QGCMapPolygon::offset(double distance)
 {
     QList<QGeoCoordinate> rgNewPolygon;
@@ -427,8 +447,20 @@ void QGCMapPolygon::offset(double distance)
     // I'm sure there is some beautiful famous algorithm to do this, but here is a brute force method
 
     if (count() > 2) {
-        // Convert the polygon to NED
-        QList<QPointF> rgNedVertices = nedPolygon();
+        // Convert the polygon to NED, dropping repeated vertices since a zero length edge has no direction to offset along
+        QList<QPointF> rgNedVertices;
+        for (const QPointF& vertex: _nedVertices()) {
+            if (rgNedVertices.isEmpty() || QLineF(rgNedVertices.last(), vertex).length() > _minimumEdgeLength) {
+                rgNedVertices.append(vertex);
+            }
+        }
+        while (rgNedVertices.count() > 1 && QLineF(rgNedVertices.last(), rgNedVertices.first()).length() <= _minimumEdgeLength) {
+            rgNedVertices.removeLast();
+        }
+        if (rgNedVertices.count() < 3) {
+            qWarning("QGCMapPolygon::offset degenerate polygon");
+            return;
+        }
 
         // Walk the edges, offsetting by the specified distance
         QList<QLineF> rgOffsetEdges;
@@ -451,19 +483,22 @@ void QGCMapPolygon::offset(double distance)
         }
 
         // Intersect the offset edges to generate new vertices
-        QPointF         newVertex;
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
+        const qsizetype vertexCount = rgOffsetEdges.count();
+        QVector<double> north(vertexCount), east(vertexCount), lat(vertexCount), lon(vertexCount);
         for (int i=0; i<rgOffsetEdges.count(); i++) {
             int prevIndex = i == 0 ? rgOffsetEdges.count() - 1 : i - 1;
+            QPointF newVertex;
             auto intersect = rgOffsetEdges[prevIndex].intersects(rgOffsetEdges[i], &newVertex);
             if (intersect == QLineF::NoIntersection) {
-                // FIXME: Better error handling?
-                qWarning("Intersection failed");
-                return;
+                // Parallel edges come from collinear vertices, both offset edges pass through the same offset point
+                newVertex = rgOffsetEdges[i].p1();
             }
-            QGeoCoordinate coord;
-            QGCGeo::convertNedToGeo(newVertex.y(), newVertex.x(), 0, tangentOrigin, coord);
-            rgNewPolygon.append(coord);
+            north[i] = newVertex.y();
+            east[i] = newVertex.x();
+        }
+        QGCGeo::convertNedToGeo(north.constData(), east.constData(), nullptr, vertexCount, vertexCoordinate(0), lat.data(), lon.data(), nullptr);
+        for (qsizetype i=0; i<vertexCount; i++) {
+            rgNewPolygon.append(QGeoCoordinate(lat[i], lon[i]));
         }
     }
 
@@ -474,33 +509,60 @@ void QGCMapPolygon::offset(double distance)
     _endResetIfNotActive();
 }
 
-bool QGCMapPolygon::loadKMLOrSHPFile(const QString& file)
+/// Loads and simplifies the polygon, safe to call from a worker thread
+QGCMapPolygon::LoadResult_t QGCMapPolygon::_loadFile(const QString& file)
 {
-    QString errorString;
-    QList<QGeoCoordinate> rgCoords;
-    if (!ShapeFileHelper::loadPolygonFromFile(file, rgCoords, errorString)) {
-        qgcApp()->showAppMessage(errorString);
+    LoadResult_t result;
+
+    result.success = ShapeFileHelper::loadPolygonFromFile(file, result.coords, result.errorString);
+    if (result.success) {
+        result.coords = QGCGeo::simplifyPolygon(result.coords, _importSimplifyTolerance);
+    }
+
+    return result;
+}
+
+bool QGCMapPolygon::_applyLoadResult(const LoadResult_t& result)
+{
+    if (!result.success) {
+        qgcApp()->showAppMessage(result.errorString);
         return false;
     }
 
     _beginResetIfNotActive();
     clear();
-    appendVertices(rgCoords);
+    appendVertices(result.coords);
     _endResetIfNotActive();
 
     return true;
 }
 
+bool QGCMapPolygon::loadKMLOrSHPFile(const QString& file)
+{
+    return _applyLoadResult(_loadFile(file));
+}
+
+void QGCMapPolygon::loadKMLOrSHPFileAsync(const QString& file)
+{
+    // Setting a new future drops the result of a load which is still running
+    _loadWatcher.setFuture(QtConcurrent::run(&QGCMapPolygon::_loadFile, file));
+}
+
+void QGCMapPolygon::_asyncLoadComplete(void)
+{
+    emit loadKMLOrSHPFileComplete(_applyLoadResult(_loadWatcher.result()));
+}
+
 double QGCMapPolygon::area(void) const
 {
     // https://www.mathopenref.com/coordpolygonarea2.html
 
-    if (_polygonPath.count() < 3) {
+    if (_coordinates.count() < 3) {
         return 0;
     }
 
     double coveredArea = 0.0;
-    QList<QPointF> nedVertices = nedPolygon();
+    const QList<QPointF>& nedVertices = _nedVertices();
     for (int i=0; i<nedVertices.count(); i++) {
         if (i != 0) {
             coveredArea += nedVertices[i - 1].x() * nedVertices[i].y() - nedVertices[i].x() * nedVertices[i -1].y();
@@ -513,14 +575,14 @@ double QGCMapPolygon::area(void) const
 
 void QGCMapPolygon::verifyClockwiseWinding(void)
 {
-    if (_polygonPath.count() <= 2) {
+    if (_coordinates.count() <= 2) {
         return;
     }
 
     double sum = 0;
-    for (int i=0; i<_polygonPath.count(); i++) {
-        QGeoCoordinate coord1 = _polygonPath[i].value<QGeoCoordinate>();
-        QGeoCoordinate coord2 = (i == _polygonPath.count() - 1) ? _polygonPath[0].value<QGeoCoordinate>() : _polygonPath[i+1].value<QGeoCoordinate>();
+    for (int i=0; i<_coordinates.count(); i++) {
+        const QGeoCoordinate& coord1 = _coordinates[i];
+        const QGeoCoordinate& coord2 = (i == _coordinates.count() - 1) ? _coordinates[0] : _coordinates[i+1];
 
         sum += (coord2.longitude() - coord1.longitude()) * (coord2.latitude() + coord1.latitude());
     }
@@ -528,10 +590,7 @@ void QGCMapPolygon::verifyClockwiseWinding(void)
     if (sum < 0.0) {
         // Winding is counter-clockwise and needs reversal
 
-        QList<QGeoCoordinate> rgReversed;
-        for (const QVariant& varCoord: _polygonPath) {
-            rgReversed.prepend(varCoord.value<QGeoCoordinate>());
-        }
+        QList<QGeoCoordinate> rgReversed(_coordinates.crbegin(), _coordinates.crend());
 
         _beginResetIfNotActive();
         clear();
@@ -568,7 +627,7 @@ void QGCMapPolygon::_endResetIfNotActive(void)
     }
 }
 
-QDomElement QGCMapPolygon::kmlPolygonElement(KMLDomDocument& domDocument)
+void QGCMapPolygon::writeKmlPolygon(KMLStreamWriter& kml) const
 {
 #if 0
     <Polygon id="ID">
@@ -591,24 +650,22 @@ QDomElement QGCMapPolygon::kmlPolygonElement(KMLDomDocument& domDocument)
     </Polygon>
 #endif
 
-    QDomElement polygonElement = domDocument.createElement("Polygon");
-
-    domDocument.addTextElement(polygonElement, "altitudeMode", "clampToGround");
-
-    QDomElement outerBoundaryIsElement = domDocument.createElement("outerBoundaryIs");
-    QDomElement linearRingElement = domDocument.createElement("LinearRing");
+    kml.writeStartElement("Polygon");
+    kml.writeTextElement("altitudeMode", "clampToGround");
 
-    outerBoundaryIsElement.appendChild(linearRingElement);
-    polygonElement.appendChild(outerBoundaryIsElement);
+    kml.writeStartElement("outerBoundaryIs");
+    kml.writeStartElement("LinearRing");
 
-    QString coordString;
-    for (const QVariant& varCoord : _polygonPath) {
-        coordString += QStringLiteral("%1\n").arg(domDocument.kmlCoordString(varCoord.value<QGeoCoordinate>()));
+    kml.writeStartElement("coordinates");
+    for (const QGeoCoordinate& coord : _coordinates) {
+        kml.writeCharacters(QStringLiteral("%1\n").arg(KMLStreamWriter::kmlCoordString(coord)));
     }
-    coordString += QStringLiteral("%1\n").arg(domDocument.kmlCoordString(_polygonPath.first().value<QGeoCoordinate>()));
-    domDocument.addTextElement(linearRingElement, "coordinates", coordString);
+    kml.writeCharacters(QStringLiteral("%1\n").arg(KMLStreamWriter::kmlCoordString(_coordinates.first())));
+    kml.writeEndElement();
 
-    return polygonElement;
+    kml.writeEndElement();
+    kml.writeEndElement();
+    kml.writeEndElement();
 }
 
 void QGCMapPolygon::setTraceMode(bool traceMode)
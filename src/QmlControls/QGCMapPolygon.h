@@ -9,18 +9,21 @@
 
 #pragma once
 
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QObject>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtCore/QVariantList>
 #include <QtGui/QPolygonF>
-#include <QtXml/QDomElement>
 
 #include "QmlObjectListModel.h"
 
-class KMLDomDocument;
+class KMLStreamWriter;
 
 /// The QGCMapPolygon class provides a polygon which can be displayed on a map using a map visuals control.
-/// It maintains a representation of the polygon on QVariantList and QmlObjectListModel format.
+/// It maintains a representation of the polygon on QVariantList and QmlObjectListModel format. The vertices are stored
+/// as a typed coordinate list, the QVariantList path for QML and the planar (NED) vertices used for area, containment
+/// and offset are caches which are only rebuilt when read after a change. Moving a single vertex updates the planar
+/// cache in place, so dragging a vertex of a large imported polygon does not convert every vertex again.
 class QGCMapPolygon : public QObject
 {
     Q_OBJECT
@@ -66,10 +69,14 @@ public:
     /// Offsets the current polygon edges by the specified distance in meters
     Q_INVOKABLE void offset(double distance);
 
-    /// Loads a polygon from a KML/SH{ file
+    /// Loads a polygon from a KML/SH{ file. Vertices which do not change the shape of the boundary are dropped.
     /// @return true: success
     Q_INVOKABLE bool loadKMLOrSHPFile(const QString& file);
 
+    /// Same as loadKMLOrSHPFile but the file is read and simplified on a worker thread. Signals
+    /// loadKMLOrSHPFileComplete when the polygon has been updated.
+    Q_INVOKABLE void loadKMLOrSHPFileAsync(const QString& file);
+
     /// Returns the path in a list of QGeoCoordinate's format
     QList<QGeoCoordinate> coordinateList(void) const;
 
@@ -93,17 +100,18 @@ public:
     /// @return true: success, false: failure (errorString set)
     bool loadFromJson(const QJsonObject& json, bool required, QString& errorString);
 
-    /// Convert polygon to NED and return (D is ignored)
+    /// Convert polygon to NED and return (D is ignored). Points are x: east, y: north from the first vertex.
     QList<QPointF> nedPolygon(void) const;
 
     /// Returns the area of the polygon in meters squared
     double area(void) const;
 
-    QDomElement kmlPolygonElement(KMLDomDocument& domDocument);
+    /// Writes the polygon as a KML Polygon element
+    void writeKmlPolygon(KMLStreamWriter& kml) const;
 
     // Property methods
 
-    int             count       (void) const { return _polygonPath.count(); }
+    int             count       (void) const { return _coordinates.count(); }
     bool            dirty       (void) const { return _dirty; }
     void            setDirty    (bool dirty);
     QGeoCoordinate  center      (void) const { return _center; }
@@ -115,7 +123,7 @@ public:
     bool            showAltColor(void) const { return _showAltColor; }
     int             selectedVertex()   const { return _selectedVertexIndex; }
 
-    QVariantList        path        (void) const { return _polygonPath; }
+    QVariantList        path        (void) const;
     QmlObjectListModel* qmlPathModel(void) { return &_polygonModel; }
     QmlObjectListModel& pathModel   (void) { return _polygonModel; }
 
@@ -143,29 +151,48 @@ signals:
     void traceModeChanged   (bool traceMode);
     void showAltColorChanged(bool showAltColor);
     void selectedVertexChanged(int index);
+    void loadKMLOrSHPFileComplete(bool success);
 
 private slots:
     void _polygonModelCountChanged(int count);
     void _polygonModelDirtyChanged(bool dirty);
     void _updateCenter(void);
+    void _asyncLoadComplete(void);
 
 private:
+    struct LoadResult_t {
+        bool                    success = false;
+        QList<QGeoCoordinate>   coords;
+        QString                 errorString;
+    };
+
+    static LoadResult_t _loadFile           (const QString& file);
+    bool            _applyLoadResult        (const LoadResult_t& result);
     void            _init                   (void);
-    QPolygonF       _toPolygonF             (void) const;
-    QGeoCoordinate  _coordFromPointF        (const QPointF& point) const;
-    QPointF         _pointFFromCoord        (const QGeoCoordinate& coordinate) const;
+    void            _setVertex              (int vertexIndex, const QGeoCoordinate& coordinate);
+    void            _coordinatesChanged     (void);
+    QPointF         _nedFromCoord           (const QGeoCoordinate& coordinate) const;
+    const QList<QPointF>& _nedVertices      (void) const;
     void            _beginResetIfNotActive  (void);
     void            _endResetIfNotActive    (void);
 
-    QVariantList        _polygonPath;
-    QmlObjectListModel  _polygonModel;
-    bool                _dirty =                false;
-    QGeoCoordinate      _center;
-    bool                _centerDrag =           false;
-    bool                _ignoreCenterUpdates =  false;
-    bool                _interactive =          false;
-    bool                _resetActive =          false;
-    bool                _traceMode =            false;
-    bool                _showAltColor =         false;
-    int                 _selectedVertexIndex =  -1;
+    QList<QGeoCoordinate>   _coordinates;
+    mutable QVariantList    _polygonPath;                       ///< Built from _coordinates when path is read
+    mutable bool            _polygonPathValid =     true;
+    mutable QList<QPointF>  _nedVerticesCache;                  ///< x: east, y: north from the first vertex
+    mutable bool            _nedVerticesValid =     true;
+    QmlObjectListModel      _polygonModel;
+    bool                    _dirty =                false;
+    QGeoCoordinate          _center;
+    bool                    _centerDrag =           false;
+    bool                    _ignoreCenterUpdates =  false;
+    bool                    _interactive =          false;
+    bool                    _resetActive =          false;
+    bool                    _traceMode =            false;
+    bool                    _showAltColor =         false;
+    int                     _selectedVertexIndex =  -1;
+    QFutureWatcher<LoadResult_t> _loadWatcher;
+
+    static constexpr double _minimumEdgeLength = 0.01;          ///< Meters, shorter edges are dropped when offsetting
+    static constexpr double _importSimplifyTolerance = 0.1;     ///< Meters, imported vertices closer than this to the outline are dropped
 };
@@ -266,20 +266,24 @@ QGeoCoordinate QGCMapPolyline::vertexCoordinate(int vertex) const
 }
 
 QList<QPointF> QGCMapPolyline::nedPolyline(void)
+{
+    return nedPolyline(coordinateList());
+}
+
+QList<QPointF> QGCMapPolyline::nedPolyline(const QList<QGeoCoordinate>& vertices)
 {
     QList<QPointF>  nedPolyline;
 
-    if (count() > 0) {
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
+    if (vertices.count() > 0) {
+        QGeoCoordinate  tangentOrigin = vertices[0];
 
-        for (int i=0; i<_polylinePath.count(); i++) {
+        for (int i=0; i<vertices.count(); i++) {
             double y, x, down;
-            QGeoCoordinate vertex = vertexCoordinate(i);
             if (i == 0) {
                 // This avoids a nan calculation that comes out of convertGeoToNed
                 x = y = 0;
             } else {
-                QGCGeo::convertGeoToNed(vertex, tangentOrigin, y, x, down);
+                QGCGeo::convertGeoToNed(vertices[i], tangentOrigin, y, x, down);
             }
             nedPolyline += QPointF(x, y);
         }
@@ -290,20 +294,26 @@ QList<QPointF> QGCMapPolyline::nedPolyline(void)
 
 
 QList<QGeoCoordinate> QGCMapPolyline::offsetPolyline(double distance)
+{
+    if (count() < 2) {
+        return QList<QGeoCoordinate>();
+    }
+
+    return offsetPolyline(nedPolyline(), vertexCoordinate(0), distance);
+}
+
+QList<QGeoCoordinate> QGCMapPolyline::offsetPolyline(const QList<QPointF>& nedVertices, const QGeoCoordinate& tangentOrigin, double distance)
 {
     QList<QGeoCoordinate> rgNewPolyline;
 
     // I'm sure there is some beautiful famous algorithm to do this, but here is a brute force method
 
-    if (count() > 1) {
-        // Convert the polygon to NED
-        QList<QPointF> rgNedVertices = nedPolyline();
-
+    if (nedVertices.count() > 1) {
         // Walk the edges, offsetting by the specified distance
         QList<QLineF> rgOffsetEdges;
-        for (int i=0; i<rgNedVertices.count() - 1; i++) {
+        for (int i=0; i<nedVertices.count() - 1; i++) {
             QLineF  offsetEdge;
-            QLineF  originalEdge(rgNedVertices[i], rgNedVertices[i + 1]);
+            QLineF  originalEdge(nedVertices[i], nedVertices[i + 1]);
 
             QLineF workerLine = originalEdge;
             workerLine.setLength(distance);
@@ -318,8 +328,6 @@ QList<QGeoCoordinate> QGCMapPolyline::offsetPolyline(double distance)
             rgOffsetEdges.append(offsetEdge);
         }
 
-        QGeoCoordinate  tangentOrigin = vertexCoordinate(0);
-
         // Add first vertex
         QGeoCoordinate coord;
         QGCGeo::convertNedToGeo(rgOffsetEdges[0].p1().y(), rgOffsetEdges[0].p1().x(), 0, tangentOrigin, coord);
@@ -52,6 +52,11 @@ public:
     /// @return Offset set of vertices
     QList<QGeoCoordinate> offsetPolyline(double distance);
 
+    /// Offsets a polyline already converted with nedPolyline. Doesn't touch any object so it can be used from a worker
+    /// thread, and a polyline offset by many distances only needs to be converted once.
+    ///     @param tangentOrigin First vertex of the polyline, origin of nedVertices
+    static QList<QGeoCoordinate> offsetPolyline(const QList<QPointF>& nedVertices, const QGeoCoordinate& tangentOrigin, double distance);
+
     /// Loads a polyline from a KML file
     /// @return true: success
     Q_INVOKABLE bool loadKMLFile(const QString& kmlFile);
@@ -78,6 +83,7 @@ public:
 
     /// Convert polyline to NED and return (D is ignored)
     QList<QPointF> nedPolyline(void);
+    static QList<QPointF> nedPolyline(const QList<QGeoCoordinate>& vertices);
 
     /// Returns the length of the polyline in meters
     double length(void) const;
@@ -17,6 +17,7 @@
 #include "PositionManager.h"
 #include "QGCMapEngineManager.h"
 #include "ADSBVehicleManager.h"
+#include "MapOverlayManager.h"
 #ifndef NO_SERIAL_LINK
 #include "GPSManager.h"
 #endif
@@ -28,6 +29,8 @@
 #include <QtCore/QSettings>
 #include <QtCore/QLineF>
 
+QGC_LOGGING_CATEGORY(QmlLoadTimingLog, "qgc.qml.loadtiming")
+
 QGeoCoordinate   QGroundControlQmlGlobal::_coord = QGeoCoordinate(0.0,0.0);
 double           QGroundControlQmlGlobal::_zoom = 2;
 
@@ -35,6 +38,7 @@ QGroundControlQmlGlobal::QGroundControlQmlGlobal(QGCApplication* app, QGCToolbox
     : QGCTool(app, toolbox)
     , _mapEngineManager(QGCMapEngineManager::instance())
     , _adsbVehicleManager(ADSBVehicleManager::instance())
+    , _mapOverlayManager(MapOverlayManager::instance())
 {
     // We clear the parent on this object since we run into shutdown problems caused by hybrid qml app. Instead we let it leak on shutdown.
     // setParent(nullptr);
@@ -80,7 +84,6 @@ void QGroundControlQmlGlobal::setToolbox(QGCToolbox* toolbox)
     _qgcPositionManager     = toolbox->qgcPositionManager();
     _missionCommandTree     = toolbox->missionCommandTree();
     _videoManager           = toolbox->videoManager();
-    _mavlinkLogManager      = toolbox->mavlinkLogManager();
     _corePlugin             = toolbox->corePlugin();
     _firmwarePluginManager  = toolbox->firmwarePluginManager();
     _settingsManager        = toolbox->settingsManager();
@@ -88,13 +91,35 @@ void QGroundControlQmlGlobal::setToolbox(QGCToolbox* toolbox)
     _gpsRtkFactGroup        = toolbox->gpsManager()->gpsRtkFactGroup();
 #endif
     _globalPalette          = new QGCPalette(this);
+}
+
+// The managers below are created on first use, so they are only looked up once QML asks for them
+
+MAVLinkLogManager* QGroundControlQmlGlobal::mavlinkLogManager()
+{
+    return _toolbox->mavlinkLogManager();
+}
+
+MAVLinkMessageStats* QGroundControlQmlGlobal::mavlinkMessageStats()
+{
+    return _toolbox->mavlinkProtocol()->messageStats();
+}
+
+AirLinkManager* QGroundControlQmlGlobal::airlinkManager()
+{
 #ifndef QGC_AIRLINK_DISABLED
-    _airlinkManager         = toolbox->airlinkManager();
+    return _toolbox->airlinkManager();
+#else
+    return nullptr;
 #endif
+}
+
 #ifdef QGC_UTM_ADAPTER
-    _utmspManager            = toolbox->utmspManager();
-#endif
+UTMSPManager* QGroundControlQmlGlobal::utmspManager()
+{
+    return _toolbox->utmspManager();
 }
+#endif
 
 void QGroundControlQmlGlobal::saveGlobalSetting (const QString& key, const QString& value)
 {
@@ -230,6 +255,33 @@ bool QGroundControlQmlGlobal::apmFirmwareSupported()
     return _firmwarePluginManager->supportedFirmwareClasses().contains(QGCMAVLink::FirmwareClassArduPilot);
 }
 
+void QGroundControlQmlGlobal::qmlLoadStarted(QObject* loader)
+{
+    if (!loader || !QmlLoadTimingLog().isDebugEnabled()) {
+        return;
+    }
+    _qmlLoadTimers[loader].start();
+}
+
+void QGroundControlQmlGlobal::qmlLoadFinished(QObject* loader)
+{
+    const auto it = _qmlLoadTimers.find(loader);
+    if (it == _qmlLoadTimers.end()) {
+        return;
+    }
+    const double elapsedMSecs = it.value().nsecsElapsed() / 1e6;
+    _qmlLoadTimers.erase(it);
+
+    // Loader resolves the source, so the same page reads the same here no matter how it was set
+    const QUrl source = loader->property("source").toUrl();
+    if (source.isEmpty()) {
+        return;
+    }
+    const bool first = !_qmlLoadedSources.contains(source);
+    _qmlLoadedSources.insert(source);
+    qCDebug(QmlLoadTimingLog) << source.toString() << QStringLiteral("%1 ms").arg(elapsedMSecs, 0, 'f', 1) << (first ? "(first load)" : "");
+}
+
 bool QGroundControlQmlGlobal::linesIntersect(QPointF line1A, QPointF line1B, QPointF line2A, QPointF line2B)
 {
     QPointF intersectPoint;
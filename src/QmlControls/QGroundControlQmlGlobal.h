@@ -12,17 +12,26 @@
 #include "QGCToolbox.h"
 #include "QmlUnitsConversion.h"
 #include "QGCLoggingCategory.h"
+#include "QGCTrace.h"
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QTimer>
 #include <QtCore/QPointF>
+#include <QtCore/QUrl>
 #include <QtPositioning/QGeoCoordinate>
 
+Q_DECLARE_LOGGING_CATEGORY(QmlLoadTimingLog)
+
 class QGCApplication;
 
 class ADSBVehicleManager;
 class FactGroup;
 class LinkManager;
+class MapOverlayManager;
 class MAVLinkLogManager;
+class MAVLinkMessageStats;
 class MissionCommandTree;
 class MultiVehicleManager;
 class QGCCorePlugin;
@@ -78,8 +87,10 @@ public:
     Q_PROPERTY(QGCPositionManager*  qgcPositionManger       READ    qgcPositionManger       CONSTANT)
     Q_PROPERTY(VideoManager*        videoManager            READ    videoManager            CONSTANT)
     Q_PROPERTY(MAVLinkLogManager*   mavlinkLogManager       READ    mavlinkLogManager       CONSTANT)
+    Q_PROPERTY(MAVLinkMessageStats* mavlinkMessageStats     READ    mavlinkMessageStats     CONSTANT)
     Q_PROPERTY(SettingsManager*     settingsManager         READ    settingsManager         CONSTANT)
     Q_PROPERTY(ADSBVehicleManager*  adsbVehicleManager      READ    adsbVehicleManager      CONSTANT)
+    Q_PROPERTY(MapOverlayManager*   mapOverlayManager       READ    mapOverlayManager       CONSTANT)
     Q_PROPERTY(QGCCorePlugin*       corePlugin              READ    corePlugin              CONSTANT)
     Q_PROPERTY(MissionCommandTree*  missionCommandTree      READ    missionCommandTree      CONSTANT)
 #ifndef NO_SERIAL_LINK
@@ -127,6 +138,7 @@ public:
     Q_PROPERTY(QString  elevationProviderNotice         READ elevationProviderNotice            CONSTANT)
 
     Q_PROPERTY(bool              utmspSupported           READ    utmspSupported              CONSTANT)
+    Q_PROPERTY(bool              traceSupported           READ    traceSupported              CONSTANT)
 
 #ifdef QGC_UTM_ADAPTER
     Q_PROPERTY(UTMSPManager*     utmspManager             READ    utmspManager                CONSTANT)
@@ -160,6 +172,14 @@ public:
     /// Updates the logging filter rules after settings have changed
     Q_INVOKABLE void updateLoggingFilterRules(void) { QGCLoggingCategoryRegister::instance()->setFilterRulesFromSettings(QString()); }
 
+    /// Writes the recorded trace events in Chrome trace format, only available when built with QGC_ENABLE_TRACE
+    Q_INVOKABLE bool saveTrace(const QString& fileName) { return QGCTrace::writeChromeTrace(fileName); }
+
+    /// Call before changing the source of a page Loader and again from its onLoaded handler. With the qgc.qml.loadtiming
+    /// logging category on, the time taken to compile and instantiate the page is logged, flagging the first load.
+    Q_INVOKABLE void qmlLoadStarted (QObject* loader);
+    Q_INVOKABLE void qmlLoadFinished(QObject* loader);
+
     Q_INVOKABLE bool linesIntersect(QPointF xLine1, QPointF yLine1, QPointF xLine2, QPointF yLine2);
 
     Q_INVOKABLE QString altitudeModeExtraUnits(AltMode altMode);        ///< String shown in the FactTextField.extraUnits ui
@@ -174,18 +194,20 @@ public:
     QGCPositionManager*     qgcPositionManger   ()  { return _qgcPositionManager; }
     MissionCommandTree*     missionCommandTree  ()  { return _missionCommandTree; }
     VideoManager*           videoManager        ()  { return _videoManager; }
-    MAVLinkLogManager*      mavlinkLogManager   ()  { return _mavlinkLogManager; }
+    MAVLinkLogManager*      mavlinkLogManager   ();
+    MAVLinkMessageStats*    mavlinkMessageStats ();
     QGCCorePlugin*          corePlugin          ()  { return _corePlugin; }
     SettingsManager*        settingsManager     ()  { return _settingsManager; }
 #ifndef NO_SERIAL_LINK
     FactGroup*              gpsRtkFactGroup     ()  { return _gpsRtkFactGroup; }
 #endif
     ADSBVehicleManager*     adsbVehicleManager  ()  { return _adsbVehicleManager; }
+    MapOverlayManager*      mapOverlayManager   ()  { return _mapOverlayManager; }
     QmlUnitsConversion*     unitsConversion     ()  { return &_unitsConversion; }
     static QGeoCoordinate   flightMapPosition   ()  { return _coord; }
     static double           flightMapZoom       ()  { return _zoom; }
 
-    AirLinkManager*         airlinkManager      ()  { return _airlinkManager; }
+    AirLinkManager*         airlinkManager      ();
 #ifndef QGC_AIRLINK_DISABLED
     bool                    airlinkSupported    ()  { return true; }
 #else
@@ -193,7 +215,7 @@ public:
 #endif
 
 #ifdef QGC_UTM_ADAPTER
-    UTMSPManager*            utmspManager         ()  {return _utmspManager;}
+    UTMSPManager*            utmspManager         ();
 #endif
 
     qreal zOrderTopMost             () { return 1000; }
@@ -245,6 +267,8 @@ public:
     bool    utmspSupported() { return false; }
 #endif
 
+    bool    traceSupported() { return QGCTrace::supported(); }
+
     // Overrides from QGCTool
     virtual void setToolbox(QGCToolbox* toolbox);
 
@@ -264,20 +288,16 @@ private:
     QGCPositionManager*     _qgcPositionManager     = nullptr;
     MissionCommandTree*     _missionCommandTree     = nullptr;
     VideoManager*           _videoManager           = nullptr;
-    MAVLinkLogManager*      _mavlinkLogManager      = nullptr;
     QGCCorePlugin*          _corePlugin             = nullptr;
     FirmwarePluginManager*  _firmwarePluginManager  = nullptr;
     SettingsManager*        _settingsManager        = nullptr;
 #ifndef NO_SERIAL_LINK
     FactGroup*              _gpsRtkFactGroup        = nullptr;
 #endif
-    AirLinkManager*         _airlinkManager         = nullptr;
     ADSBVehicleManager*     _adsbVehicleManager     = nullptr;
+    MapOverlayManager*      _mapOverlayManager      = nullptr;
     QGCPalette*             _globalPalette          = nullptr;
     QmlUnitsConversion      _unitsConversion;
-#ifdef QGC_UTM_ADAPTER
-    UTMSPManager*            _utmspManager;
-#endif
 
     bool                    _skipSetupPage          = false;
     QStringList             _altitudeModeEnumString;
@@ -286,6 +306,9 @@ private:
     static double           _zoom;
     QTimer                  _flightMapPositionSettledTimer;
 
+    QHash<QObject*, QElapsedTimer>  _qmlLoadTimers;     ///< Keyed by Loader
+    QSet<QUrl>                      _qmlLoadedSources;  ///< Sources which have been loaded at least once
+
     static constexpr const char* kQmlGlobalKeyName = "QGCQml";
 
     static constexpr const char* _flightMapPositionSettingsGroup =          "FlightMapPosition";
@@ -14,8 +14,31 @@
 #include "QmlObjectListModel.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
 #include <QtQml/QQmlEngine>
 
+#include <utility>
+
+namespace {
+
+/// Deletes the objects of a batch when it is deleted itself, so a whole batch takes a single deferred delete event
+class DeleteLaterBatch : public QObject
+{
+public:
+    ~DeleteLaterBatch()
+    {
+        for (const QPointer<QObject>& object: objects) {
+            delete object.data();
+        }
+    }
+
+    QList<QPointer<QObject>> objects;
+};
+
+} // namespace
+
 QmlObjectListModel::QmlObjectListModel(QObject* parent)
     : QAbstractListModel        (parent)
     , _dirty                    (false)
@@ -112,9 +135,7 @@ bool QmlObjectListModel::removeRows(int position, int rows, const QModelIndex& p
     }
     
     beginRemoveRows(QModelIndex(), position, position + rows - 1);
-    for (int row=0; row<rows; row++) {
-        _objectList.removeAt(position);
-    }
+    _objectList.remove(position, rows);
     endRemoveRows();
     
     emit countChanged(count());
@@ -166,17 +187,33 @@ void QmlObjectListModel::clear()
     }
 }
 
-QObject* QmlObjectListModel::removeAt(int i)
+void QmlObjectListModel::_connectChildDirty(QObject* object, int index)
 {
-    QObject* removedObject = _objectList[i];
-    if(removedObject) {
+    static const QByteArray dirtyChangedSignature = QMetaObject::normalizedSignature("dirtyChanged(bool)");
+
+    if (object) {
+        QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
         // Look for a dirtyChanged signal on the object
-        if (_objectList[i]->metaObject()->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)")) != -1) {
-            if (!_skipDirtyFirstItem || i != 0) {
-                QObject::disconnect(_objectList[i], SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
+        if (object->metaObject()->indexOfSignal(dirtyChangedSignature) != -1) {
+            if (!_skipDirtyFirstItem || index != 0) {
+                QObject::connect(object, SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
             }
         }
     }
+}
+
+void QmlObjectListModel::_disconnectChildDirty(QObject* object, int index)
+{
+    if (object && (!_skipDirtyFirstItem || index != 0)) {
+        // Disconnecting a signal the object does not have is a no-op
+        QObject::disconnect(object, SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
+    }
+}
+
+QObject* QmlObjectListModel::removeAt(int i)
+{
+    QObject* removedObject = _objectList[i];
+    _disconnectChildDirty(removedObject, i);
     removeRows(i, 1);
     setDirty(true);
     return removedObject;
@@ -187,39 +224,26 @@ void QmlObjectListModel::insert(int i, QObject* object)
     if (i < 0 || i > _objectList.count()) {
         qWarning() << "Invalid index index:count" << i << _objectList.count();
     }
-    if(object) {
-        QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
-        // Look for a dirtyChanged signal on the object
-        if (object->metaObject()->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)")) != -1) {
-            if (!_skipDirtyFirstItem || i != 0) {
-                QObject::connect(object, SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
-            }
-        }
-    }
+    _connectChildDirty(object, i);
     _objectList.insert(i, object);
     insertRows(i, 1);
     setDirty(true);
 }
 
-void QmlObjectListModel::insert(int i, QList<QObject*> objects)
+void QmlObjectListModel::insert(int i, const QList<QObject*>& objects)
 {
     if (i < 0 || i > _objectList.count()) {
         qWarning() << "Invalid index index:count" << i << _objectList.count();
     }
+    if (objects.isEmpty()) {
+        return;
+    }
 
-    int j = i;
-    for (QObject* object: objects) {
-        QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
-
-        // Look for a dirtyChanged signal on the object
-        if (object->metaObject()->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)")) != -1) {
-            if (!_skipDirtyFirstItem || j != 0) {
-                QObject::connect(object, SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
-            }
-        }
-
-        _objectList.insert(j, object);
-        j++;
+    // Open the gap once instead of shifting the tail for each object
+    _objectList.insert(i, objects.count(), nullptr);
+    for (int j=0; j<objects.count(); j++) {
+        _connectChildDirty(objects[j], i + j);
+        _objectList[i + j] = objects[j];
     }
 
     insertRows(i, objects.count());
@@ -232,18 +256,142 @@ void QmlObjectListModel::append(QObject* object)
     insert(_objectList.count(), object);
 }
 
-void QmlObjectListModel::append(QList<QObject*> objects)
+void QmlObjectListModel::append(const QList<QObject*>& objects)
 {
     insert(_objectList.count(), objects);
 }
 
+QObjectList QmlObjectListModel::removeRange(int first, int count)
+{
+    if (first < 0 || count < 0 || first + count > _objectList.count()) {
+        qWarning() << "Invalid range first:count:listCount" << first << count << _objectList.count();
+        return QObjectList();
+    }
+    if (count == 0) {
+        return QObjectList();
+    }
+
+    const QObjectList removedObjects = _objectList.mid(first, count);
+    for (int i=0; i<removedObjects.count(); i++) {
+        _disconnectChildDirty(removedObjects[i], first + i);
+    }
+
+    beginRemoveRows(QModelIndex(), first, first + count - 1);
+    _objectList.remove(first, count);
+    endRemoveRows();
+
+    emit countChanged(_objectList.count());
+    setDirty(true);
+
+    return removedObjects;
+}
+
+QObjectList QmlObjectListModel::replaceRange(int first, int count, const QList<QObject*>& objects)
+{
+    if (first < 0 || count < 0 || first + count > _objectList.count()) {
+        qWarning() << "Invalid range first:count:listCount" << first << count << _objectList.count();
+        return QObjectList();
+    }
+
+    if (objects.count() != count) {
+        const QObjectList removedObjects = removeRange(first, count);
+        insert(first, objects);
+        return removedObjects;
+    }
+    if (count == 0) {
+        return QObjectList();
+    }
+
+    const QObjectList replacedObjects = _objectList.mid(first, count);
+    for (int i=0; i<count; i++) {
+        _disconnectChildDirty(replacedObjects[i], first + i);
+        _connectChildDirty(objects[i], first + i);
+        _objectList[first + i] = objects[i];
+    }
+    emit dataChanged(index(first), index(first + count - 1));
+    setDirty(true);
+
+    return replacedObjects;
+}
+
+QObjectList QmlObjectListModel::applyObjectList(const QObjectList& newList)
+{
+    const QSet<QObject*> newObjects(newList.cbegin(), newList.cend());
+    const QSet<QObject*> oldObjects(_objectList.cbegin(), _objectList.cend());
+
+    QObjectList removedObjects;
+    QObjectList keptInOldOrder;
+    for (QObject* object: _objectList) {
+        if (newObjects.contains(object)) {
+            keptInOldOrder.append(object);
+        } else {
+            removedObjects.append(object);
+        }
+    }
+    QObjectList keptInNewOrder;
+    for (QObject* object: newList) {
+        if (oldObjects.contains(object)) {
+            keptInNewOrder.append(object);
+        }
+    }
+
+    if (keptInOldOrder != keptInNewOrder) {
+        // Items were reordered, which only a reset describes
+        for (int i=0; i<_objectList.count(); i++) {
+            if (!newObjects.contains(_objectList[i])) {
+                _disconnectChildDirty(_objectList[i], i);
+            }
+        }
+        for (int i=0; i<newList.count(); i++) {
+            if (!oldObjects.contains(newList[i])) {
+                _connectChildDirty(newList[i], i);
+            }
+        }
+        (void) swapObjectList(newList);
+        setDirty(true);
+        return removedObjects;
+    }
+
+    // Remove from the back so the indices of the runs still to be removed stay valid
+    for (int i=_objectList.count()-1; i>=0; ) {
+        if (newObjects.contains(_objectList[i])) {
+            i--;
+            continue;
+        }
+        const int last = i;
+        while (i >= 0 && !newObjects.contains(_objectList[i])) {
+            i--;
+        }
+        (void) removeRange(i + 1, last - i);
+    }
+
+    // The list now holds the kept items in their new order, the runs of new items go in between
+    for (int i=0; i<newList.count(); ) {
+        if (oldObjects.contains(newList[i])) {
+            i++;
+            continue;
+        }
+        const int first = i;
+        while (i < newList.count() && !oldObjects.contains(newList[i])) {
+            i++;
+        }
+        insert(first, newList.mid(first, i - first));
+    }
+
+    return removedObjects;
+}
+
 QObjectList QmlObjectListModel::swapObjectList(const QObjectList& newlist)
 {
-    QObjectList oldlist(_objectList);
+    return swapObjectList(QObjectList(newlist));
+}
+
+QObjectList QmlObjectListModel::swapObjectList(QObjectList&& newlist)
+{
     if (!_externalBeginResetModel) {
         beginResetModel();
     }
-    _objectList = newlist;
+    QObjectList oldlist = std::exchange(_objectList, std::move(newlist));
     if (!_externalBeginResetModel) {
         endResetModel();
         emit countChanged(count());
@@ -282,20 +430,44 @@ void QmlObjectListModel::_childDirtyChanged(bool dirty)
 
 void QmlObjectListModel::deleteListAndContents()
 {
-    for (int i=0; i<_objectList.count(); i++) {
-        _objectList[i]->deleteLater();
-    }
+    deleteLaterBatch(_objectList);
     deleteLater();
 }
 
 void QmlObjectListModel::clearAndDeleteContents()
 {
-    beginResetModel();
-    for (int i=0; i<_objectList.count(); i++) {
-        _objectList[i]->deleteLater();
+    if (!_externalBeginResetModel) {
+        beginResetModel();
+    }
+    const QObjectList objects = std::exchange(_objectList, QObjectList());
+    if (!_externalBeginResetModel) {
+        endResetModel();
+        emit countChanged(count());
+    }
+    deleteLaterBatch(objects);
+}
+
+void QmlObjectListModel::deleteLaterBatch(const QObjectList& objects)
+{
+    DeleteLaterBatch* batch = nullptr;
+    for (QObject* object: objects) {
+        if (!object) {
+            continue;
+        }
+        if (object->thread() != QThread::currentThread()) {
+            // Must be deleted by its own thread
+            object->deleteLater();
+            continue;
+        }
+        if (!batch) {
+            batch = new DeleteLaterBatch();
+            batch->objects.reserve(objects.count());
+        }
+        batch->objects.append(object);
+    }
+    if (batch) {
+        batch->deleteLater();
     }
-    clear();
-    endResetModel();
 }
 
 void QmlObjectListModel::beginReset()
@@ -36,13 +36,29 @@ public:
 
     void        setDirty            (bool dirty);
     void        append              (QObject* object);
-    void        append              (QList<QObject*> objects);
+    void        append              (const QList<QObject*>& objects);
     QObjectList swapObjectList      (const QObjectList& newlist);
+    QObjectList swapObjectList      (QObjectList&& newlist);
     void        clear               ();
     QObject*    removeAt            (int i);
     QObject*    removeOne           (const QObject* object) { return removeAt(indexOf(object)); }
     void        insert              (int i, QObject* object);
-    void        insert              (int i, QList<QObject*> objects);
+    void        insert              (int i, const QList<QObject*>& objects);
+
+    /// Removes count items starting at index first with a single model update
+    ///     @return The removed items, which are still owned by the caller
+    QObjectList removeRange         (int first, int count);
+
+    /// Replaces count items starting at index first with objects. Replacing with the same number of items only
+    /// changes the data of the rows, otherwise the rows are removed and inserted.
+    ///     @return The replaced items, which are still owned by the caller
+    QObjectList replaceRange        (int first, int count, const QList<QObject*>& objects);
+
+    /// Changes the list to newList with as few model updates as possible: items which are not in newList are removed
+    /// and items new in newList are inserted, each contiguous run with one update. Items which change their order
+    /// relative to each other reset the model instead.
+    ///     @return The items which are not in newList, which are still owned by the caller
+    QObjectList applyObjectList     (const QObjectList& newList);
     bool        contains            (const QObject* object) { return _objectList.indexOf(object) != -1; }
     int         indexOf             (const QObject* object) { return _objectList.indexOf(object); }
 
@@ -60,6 +76,10 @@ public:
     /// Clears the list and calls deleteLater on each entry
     void clearAndDeleteContents     ();
 
+    /// Deletes the objects in one batch once control returns to the event loop, like deleteLater does for each one.
+    /// Objects deleted meanwhile, for instance by their parent, are skipped.
+    static void deleteLaterBatch    (const QObjectList& objects);
+
     void beginReset                 ();
     void endReset                   ();
 
@@ -71,6 +91,9 @@ private slots:
     void _childDirtyChanged         (bool dirty);
     
 private:
+    void _connectChildDirty     (QObject* object, int index);
+    void _disconnectChildDirty  (QObject* object, int index);
+
     // Overrides from QAbstractListModel
     int         rowCount    (const QModelIndex & parent = QModelIndex()) const override;
     QVariant    data        (const QModelIndex & index, int role = Qt::DisplayRole) const override;
@@ -17,17 +17,17 @@ RCChannelMonitorController::RCChannelMonitorController(void)
     connect(_vehicle, &Vehicle::rcChannelsChanged, this, &RCChannelMonitorController::_rcChannelsChanged);
 }
 
-void RCChannelMonitorController::_rcChannelsChanged(int channelCount, int pwmValues[QGCMAVLink::maxRcChannels])
+void RCChannelMonitorController::_rcChannelsChanged(const QGCMAVLink::RCChannels_t& channels)
 {
-    for (int channel=0; channel<channelCount; channel++) {
-        int channelValue = pwmValues[channel];
+    if (_chanCount != channels.channelCount) {
+        _chanCount = channels.channelCount;
+        emit channelCountChanged(_chanCount);
+    }
 
-        if (_chanCount != channelCount) {
-            _chanCount = channelCount;
-            emit channelCountChanged(_chanCount);
-        }
+    for (int channel=0; channel<channels.channelCount; channel++) {
+        int channelValue = channels.pwmValues[channel];
 
-        if (channelValue != -1) {
+        if ((channelValue != -1) && (channels.changedMask & (1u << channel))) {
             emit channelRCValueChanged(channel, channelValue);
         }
     }
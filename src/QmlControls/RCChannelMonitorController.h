@@ -29,7 +29,7 @@ signals:
     void channelRCValueChanged(int channel, int rcValue);
 
 private slots:
-    void _rcChannelsChanged(int channelCount, int pwmValues[QGCMAVLink::maxRcChannels]);
+    void _rcChannelsChanged(const QGCMAVLink::RCChannels_t& channels);
 
 private:
     int _chanCount;
@@ -16,9 +16,21 @@
 #include "QGCApplication.h"
 
 #include <QtQuick/QSGFlatColorMaterial>
+#include <QtQuick/QSGTransformNode>
+
+#include <utility>
 
 QGC_LOGGING_CATEGORY(TerrainProfileLog, "TerrainProfileLog")
 
+/// Terrain heights of one flight path segment. x is the distance along the segment and y the AMSL height, both in meters.
+class TerrainProfileSegmentNode : public QSGTransformNode
+{
+public:
+    TerrainProfileSegmentNode(quint64 terrainHeightsSerial_) : terrainHeightsSerial(terrainHeightsSerial_) {}
+
+    const quint64 terrainHeightsSerial;  ///< FlightPathSegment::terrainHeightsSerial the vertices were built from
+};
+
 TerrainProfile::TerrainProfile(QQuickItem* parent)
     : QQuickItem(parent)
 {
@@ -90,38 +102,56 @@ void TerrainProfile::_updateSegmentCounts(FlightPathSegment* segment, int& cFlig
         cMissingTerrainSegments += 1;
     } else {
         cTerrainProfilePoints += segment->amslTerrainHeights().count();
-        for (int i=0; i<segment->amslTerrainHeights().count(); i++) {
-            minTerrainHeight = std::fmin(minTerrainHeight, segment->amslTerrainHeights()[i].value<double>());
-            maxTerrainHeight = std::fmax(maxTerrainHeight, segment->amslTerrainHeights()[i].value<double>());
-        }
+        minTerrainHeight = std::fmin(minTerrainHeight, segment->minAMSLTerrainHeight());
+        maxTerrainHeight = std::fmax(maxTerrainHeight, segment->maxAMSLTerrainHeight());
     }
     if (segment->terrainCollision()) {
         cTerrainCollisionSegments++;
     }
 }
 
-void TerrainProfile::_addTerrainProfileSegment(FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainVertices, int& terrainProfileVertexIndex)
+void TerrainProfile::_addTerrainProfileSegment(FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGNode* terrainProfileNode, QHash<quint64, TerrainProfileSegmentNode*>& unusedSegmentNodes)
 {
-    double terrainDistance = 0;
-    for (int heightIndex=0; heightIndex<segment->amslTerrainHeights().count(); heightIndex++) {
-        // Move along the x axis which is distance
-        if (heightIndex == 0) {
-            // The first point in the segment is at the position of the last point. So nothing to do here.
-        } else if (heightIndex == segment->amslTerrainHeights().count() - 2) {
-            // The distance between the last two heights differs with each terrain query
-            terrainDistance += segment->finalDistanceBetween();
-        } else {
-            // The distance between all terrain heights except for the last is the same
-            terrainDistance += segment->distanceBetween();
+    const QList<double>& amslTerrainHeights = segment->amslTerrainHeights();
+    if (amslTerrainHeights.isEmpty()) {
+        return;
+    }
+
+    TerrainProfileSegmentNode* segmentNode = unusedSegmentNodes.take(segment->terrainHeightsSerial());
+    if (!segmentNode) {
+        QSGGeometryNode*    geometryNode =  nullptr;
+        QSGGeometry*        geometry =      nullptr;
+        _createGeometry(geometryNode, geometry, QSGGeometry::DrawLineStrip, "green");
+        geometry->allocate(amslTerrainHeights.count());
+
+        QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+        double terrainDistance = 0;
+        for (int heightIndex=0; heightIndex<amslTerrainHeights.count(); heightIndex++) {
+            // Move along the x axis which is distance
+            if (heightIndex == 0) {
+                // The first point in the segment is at the position of the last point. So nothing to do here.
+            } else if (heightIndex == amslTerrainHeights.count() - 2) {
+                // The distance between the last two heights differs with each terrain query
+                terrainDistance += segment->finalDistanceBetween();
+            } else {
+                // The distance between all terrain heights except for the last is the same
+                terrainDistance += segment->distanceBetween();
+            }
+            vertices[heightIndex].set(terrainDistance, amslTerrainHeights[heightIndex]);
         }
 
-        // Move along the y axis which is a view or terrain height as a percentage between the min/max AMSL altitude for all segments
-        double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex].value<double>();
-        double terrainHeightPercent = (amslTerrainHeight - _minAMSLAlt) / amslAltRange;
+        segmentNode = new TerrainProfileSegmentNode(segment->terrainHeightsSerial());
+        segmentNode->setFlag(QSGNode::OwnedByParent);
+        segmentNode->appendChildNode(geometryNode);
+        terrainProfileNode->appendChildNode(segmentNode);
+    }
 
-        float x = (currentDistance + terrainDistance) * _pixelsPerMeter;
-        float y = height() - (terrainHeightPercent * height());
-        terrainVertices[terrainProfileVertexIndex++].set(x, y);
+    // Move along the x axis by distance and the y axis as a percentage between the min/max AMSL altitude for all segments
+    QMatrix4x4 matrix;
+    matrix.translate(currentDistance * _pixelsPerMeter, height() + ((_minAMSLAlt / amslAltRange) * height()));
+    matrix.scale(_pixelsPerMeter, -height() / amslAltRange);
+    if (segmentNode->matrix() != matrix) {
+        segmentNode->setMatrix(matrix);
     }
 }
 
@@ -163,7 +193,7 @@ void TerrainProfile::_addFlightProfileSegment(FlightPathSegment* segment, double
 
     if (segment->segmentType() == FlightPathSegment::SegmentTypeTerrainFrame) {
         double terrainDistance = 0;
-        double distanceToSurface = segment->coord1AMSLAlt() - segment->amslTerrainHeights().first().value<double>();
+        double distanceToSurface = segment->coord1AMSLAlt() - segment->amslTerrainHeights().first();
         for (int heightIndex=0; heightIndex<segment->amslTerrainHeights().count(); heightIndex++) {
             // Move along the x axis which is distance
             if (heightIndex == 0) {
@@ -183,7 +213,7 @@ void TerrainProfile::_addFlightProfileSegment(FlightPathSegment* segment, double
             }
 
             // Add second coord of segment (or very first one)
-            double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex].value<double>() + distanceToSurface;
+            double amslTerrainHeight    = segment->amslTerrainHeights()[heightIndex] + distanceToSurface;
             double terrainHeightPercent = (amslTerrainHeight - _minAMSLAlt) / amslAltRange;
 
             float x = (currentDistance + terrainDistance) * _pixelsPerMeter;
@@ -212,7 +242,6 @@ void TerrainProfile::_addFlightProfileSegment(FlightPathSegment* segment, double
 QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePaintNodeData* /*updatePaintNodeData*/)
 {
     QSGNode*        rootNode =                  static_cast<QSGNode *>(oldNode);
-    QSGGeometry*    terrainProfileGeometry =    nullptr;
     QSGGeometry*    missingTerrainGeometry =    nullptr;
     QSGGeometry*    flightProfileGeometry =     nullptr;
     QSGGeometry*    terrainCollisionGeometry =  nullptr;
@@ -272,12 +301,12 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
     if (!rootNode) {
         rootNode = new QSGNode;
 
-        QSGGeometryNode* terrainProfileNode =   nullptr;
+        QSGNode*         terrainProfileNode =   new QSGNode;
         QSGGeometryNode* missingTerrainNode =   nullptr;
         QSGGeometryNode* flightProfileNode =    nullptr;
         QSGGeometryNode* terrainCollisionNode = nullptr;
 
-        _createGeometry(terrainProfileNode,     terrainProfileGeometry,     QSGGeometry::DrawLineStrip, "green");
+        terrainProfileNode->setFlag(QSGNode::OwnedByParent);
         _createGeometry(missingTerrainNode,     missingTerrainGeometry,     QSGGeometry::DrawLines,     "yellow");
         _createGeometry(flightProfileNode,      flightProfileGeometry,      QSGGeometry::DrawLines,     "orange");
         _createGeometry(terrainCollisionNode,   terrainCollisionGeometry,   QSGGeometry::DrawLines,     "red");
@@ -290,12 +319,15 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
 
     // Allocate space for the vertices
 
-    QSGNode* node = rootNode->childAtIndex(0);
-    terrainProfileGeometry = static_cast<QSGGeometryNode*>(node)->geometry();
-    terrainProfileGeometry->allocate(cTerrainProfilePoints);
-    node->markDirty(QSGNode::DirtyGeometry);
+    // Terrain profile nodes which are not taken for a segment below have stale terrain heights
+    QSGNode* terrainProfileNode = rootNode->childAtIndex(0);
+    QHash<quint64, TerrainProfileSegmentNode*> unusedSegmentNodes;
+    for (QSGNode* child = terrainProfileNode->firstChild(); child; child = child->nextSibling()) {
+        TerrainProfileSegmentNode* segmentNode = static_cast<TerrainProfileSegmentNode*>(child);
+        unusedSegmentNodes[segmentNode->terrainHeightsSerial] = segmentNode;
+    }
 
-    node = rootNode->childAtIndex(1);
+    QSGNode* node = rootNode->childAtIndex(1);
     missingTerrainGeometry = static_cast<QSGGeometryNode*>(node)->geometry();
     missingTerrainGeometry->allocate(cMissingTerrainSegments * 2);
     node->markDirty(QSGNode::DirtyGeometry);
@@ -311,12 +343,10 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
     node->markDirty(QSGNode::DirtyGeometry);
 
     int                     flightProfileVertexIndex =          0;
-    int                     terrainProfileVertexIndex =         0;
     int                     missingterrainProfileVertexIndex =  0;
     int                     terrainCollisionVertexIndex =       0;
     double                  currentDistance =                   0;
     QSGGeometry::Point2D*   flightProfileVertices =             flightProfileGeometry->vertexDataAsPoint2D();
-    QSGGeometry::Point2D*   terrainProfileVertices =            terrainProfileGeometry->vertexDataAsPoint2D();
     QSGGeometry::Point2D*   missingTerrainVertices =            missingTerrainGeometry->vertexDataAsPoint2D();
     QSGGeometry::Point2D*   terrainCollisionVertices =          terrainCollisionGeometry->vertexDataAsPoint2D();
 
@@ -333,7 +363,7 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
                     FlightPathSegment* segment = complexItem->flightPathSegments()->value<FlightPathSegment*>(segmentIndex);
 
                     _addFlightProfileSegment    (segment, currentDistance, amslAltRange,    flightProfileVertices,      flightProfileVertexIndex);
-                    _addTerrainProfileSegment   (segment, currentDistance, amslAltRange,    terrainProfileVertices,     terrainProfileVertexIndex);
+                    _addTerrainProfileSegment   (segment, currentDistance, amslAltRange,    terrainProfileNode,         unusedSegmentNodes);
                     _addMissingTerrainSegment   (segment, currentDistance,                  missingTerrainVertices,     missingterrainProfileVertexIndex);
                     _addTerrainCollisionSegment (segment, currentDistance, amslAltRange,    terrainCollisionVertices,   terrainCollisionVertexIndex);
 
@@ -346,7 +376,7 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
             FlightPathSegment* segment = visualItem->simpleFlightPathSegment();
 
             _addFlightProfileSegment    (segment, currentDistance, amslAltRange,    flightProfileVertices,      flightProfileVertexIndex);
-            _addTerrainProfileSegment   (segment, currentDistance, amslAltRange,    terrainProfileVertices,     terrainProfileVertexIndex);
+            _addTerrainProfileSegment   (segment, currentDistance, amslAltRange,    terrainProfileNode,         unusedSegmentNodes);
             _addMissingTerrainSegment   (segment, currentDistance,                  missingTerrainVertices,     missingterrainProfileVertexIndex);
             _addTerrainCollisionSegment (segment, currentDistance, amslAltRange,    terrainCollisionVertices,   terrainCollisionVertexIndex);
 
@@ -354,6 +384,11 @@ QSGNode* TerrainProfile::updatePaintNode(QSGNode* oldNode, QQuickItem::UpdatePai
         }
     }
 
+    for (TerrainProfileSegmentNode* segmentNode: std::as_const(unusedSegmentNodes)) {
+        terrainProfileNode->removeChildNode(segmentNode);
+        delete segmentNode;
+    }
+
     setImplicitWidth(_visibleWidth/*(_totalDistance * pixelsPerMeter) + (_horizontalMargin * 2)*/);
     setWidth(implicitWidth());
 
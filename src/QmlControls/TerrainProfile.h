@@ -12,6 +12,7 @@
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QSGGeometryNode>
 #include <QtQuick/QSGGeometry>
+#include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainProfileLog)
@@ -19,9 +20,13 @@ Q_DECLARE_LOGGING_CATEGORY(TerrainProfileLog)
 class MissionController;
 class QmlObjectListModel;
 class FlightPathSegment;
+class TerrainProfileSegmentNode;
 
 Q_MOC_INCLUDE("MissionController.h")
 
+/// Plots the flight path and terrain heights along the mission. The terrain heights of each flight path segment are a
+/// separate scene graph node holding its vertices in meters, placed by a transform. Only segments which received new
+/// terrain heights rebuild their vertices; moving or rescaling the profile only changes the transforms.
 class TerrainProfile : public QQuickItem
 {
     Q_OBJECT
@@ -59,7 +64,7 @@ private slots:
 private:
     void    _createGeometry                 (QSGGeometryNode*& geometryNode, QSGGeometry*& geometry, QSGGeometry::DrawingMode drawingMode, const QColor& color);
     void    _updateSegmentCounts            (FlightPathSegment* segment, int& cFlightProfileSegments, int& cTerrainPoints, int& cMissingTerrainSegments, int& cTerrainCollisionSegments, double& minTerrainHeight, double& maxTerrainHeight);
-    void    _addTerrainProfileSegment       (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainProfileVertices, int& terrainVertexIndex);
+    void    _addTerrainProfileSegment       (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGNode* terrainProfileNode, QHash<quint64, TerrainProfileSegmentNode*>& unusedSegmentNodes);
     void    _addMissingTerrainSegment       (FlightPathSegment* segment, double currentDistance, QSGGeometry::Point2D* missingTerrainVertices, int& missingTerrainVertexIndex);
     void    _addTerrainCollisionSegment     (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* terrainCollisionVertices, int& terrainCollisionVertexIndex);
     void    _addFlightProfileSegment        (FlightPathSegment* segment, double currentDistance, double amslAltRange, QSGGeometry::Point2D* flightProfileVertices, int& flightProfileVertexIndex);
@@ -24,6 +24,9 @@ protected:
 
 public:
     bool isBingProvider() const final { return true; }
+    // Bulk downloads aren't allowed by the terms of use, keep offline sets to a trickle
+    int getMaxConcurrentDownloads() const final { return 2; }
+    double getMaxDownloadRate() const final { return 4.; }
 
 private:
     QString _getURL(int x, int y, int zoom) const final;
@@ -25,6 +25,9 @@ protected:
 
 public:
     QByteArray getToken() const final;
+    // ArcGIS Online basemaps are shared public services
+    int getMaxConcurrentDownloads() const final { return 2; }
+    double getMaxDownloadRate() const final { return 4.; }
 
 private:
     QString _getURL(int x, int y, int zoom) const final;
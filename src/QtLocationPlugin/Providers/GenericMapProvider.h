@@ -21,6 +21,9 @@ public:
             AVERAGE_TILE_SIZE,
             QGeoMapType::CustomMap) {}
 
+    // The user's own server, only limited by the max download rate setting
+    double getMaxDownloadRate() const final { return 0.; }
+
 private:
     QString _getURL(int x, int y, int zoom) const final;
 };
@@ -43,6 +43,11 @@ protected:
         , _versionRequest(versionRequest)
         , _version(version) {}
 
+public:
+    // Bulk downloads aren't allowed by the terms of use, keep offline sets to a trickle
+    int getMaxConcurrentDownloads() const final { return 2; }
+    double getMaxDownloadRate() const final { return 4.; }
+
 private:
     void _getSecGoogleWords(int x, int y, QString& sec1, QString& sec2) const;
     QString _getURL(int x, int y, int zoom) const final;
@@ -0,0 +1,47 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LocalFileMapProvider.h"
+#include "LocalTileFile.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "MapsSettings.h"
+
+LocalFileMapProvider::~LocalFileMapProvider()
+{
+
+}
+
+QByteArray LocalFileMapProvider::getLocalTile(int x, int y, int zoom) const
+{
+    const QString fileName = qgcApp()->toolbox()->settingsManager()->mapsSettings()->localTileFile()->rawValue().toString();
+    if (fileName.isEmpty()) {
+        return QByteArray();
+    }
+
+    QMutexLocker lock(&_fileMutex);
+
+    if (!_file || (_file->fileName() != fileName)) {
+        _file.reset();
+        if (fileName == _failedFileName) {
+            return QByteArray();
+        }
+
+        QString errorString;
+        _file = LocalTileFile::open(fileName, errorString);
+        if (!_file) {
+            qCWarning(MapProviderLog) << "Failed to open local tile file" << fileName << errorString;
+            _failedFileName = fileName;
+            return QByteArray();
+        }
+        _failedFileName.clear();
+    }
+
+    return _file->tile(x, y, zoom);
+}
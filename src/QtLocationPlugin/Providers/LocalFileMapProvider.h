@@ -0,0 +1,41 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+#pragma once
+
+#include "MapProvider.h"
+
+#include <QtCore/QMutex>
+
+#include <memory>
+
+class LocalTileFile;
+
+/// Serves raster tiles straight from the MBTiles or PMTiles file set in MapsSettings::localTileFile
+class LocalFileMapProvider : public MapProvider
+{
+public:
+    LocalFileMapProvider()
+        : MapProvider(
+            QStringLiteral("LocalFile Tiles"),
+            QStringLiteral(""),
+            QStringLiteral(""),
+            AVERAGE_TILE_SIZE,
+            QGeoMapType::CustomMap) {}
+    ~LocalFileMapProvider();
+
+    bool isLocalFileProvider() const final { return true; }
+    QByteArray getLocalTile(int x, int y, int zoom) const final;
+
+private:
+    QString _getURL(int x, int y, int zoom) const final { Q_UNUSED(x); Q_UNUSED(y); Q_UNUSED(zoom); return QString(); }
+
+    mutable QMutex _fileMutex;
+    mutable std::unique_ptr<LocalTileFile> _file;
+    mutable QString _failedFileName;    ///< Not retried for every tile
+};
@@ -0,0 +1,355 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LocalTileFile.h"
+#include <QGCLoggingCategory.h>
+#include <QGCZlib.h>
+
+#include <QtCore/QtEndian>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(LocalTileFileLog, "qgc.qtlocationplugin.localtilefile")
+
+std::unique_ptr<LocalTileFile> LocalTileFile::open(const QString &fileName, QString &errorString)
+{
+    errorString.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorString = file.errorString();
+        return nullptr;
+    }
+    const QByteArray magic = file.read(16);
+    file.close();
+
+    std::unique_ptr<LocalTileFile> tileFile;
+    if (magic.startsWith(QByteArrayLiteral("PMTiles"))) {
+        tileFile = std::make_unique<PMTilesFile>(fileName);
+    } else if (magic.startsWith(QByteArrayLiteral("SQLite format 3"))) {
+        tileFile = std::make_unique<MBTilesFile>(fileName);
+    } else {
+        errorString = QStringLiteral("Not an MBTiles or PMTiles file");
+        return nullptr;
+    }
+
+    if (!tileFile->_open(errorString)) {
+        return nullptr;
+    }
+
+    qCDebug(LocalTileFileLog) << "Opened" << fileName;
+
+    return tileFile;
+}
+
+/*===========================================================================*/
+
+MBTilesFile::MBTilesFile(const QString &fileName)
+    : LocalTileFile(fileName)
+    , _connectionName(QStringLiteral("QGCLocalTileFile-%1").arg(reinterpret_cast<quintptr>(this), 0, 16))
+{
+
+}
+
+MBTilesFile::~MBTilesFile()
+{
+    _tileQuery.reset();
+    if (QSqlDatabase::contains(_connectionName)) {
+        QSqlDatabase::removeDatabase(_connectionName);
+    }
+}
+
+bool MBTilesFile::_open(QString &errorString)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", _connectionName);
+    db.setDatabaseName(_fileName);
+    db.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+    if (!db.open()) {
+        errorString = db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    // Tile pages are read straight from a mapping of the file rather than copied through the page cache
+    (void) query.exec(QStringLiteral("PRAGMA mmap_size=%1").arg(kMmapSize));
+
+    if (query.exec(QStringLiteral("SELECT value FROM metadata WHERE name = 'format'")) && query.next()) {
+        if (query.value(0).toString() == QStringLiteral("pbf")) {
+            errorString = QStringLiteral("Vector tiles are not supported");
+            return false;
+        }
+    }
+
+    _tileQuery = std::make_unique<QSqlQuery>(db);
+    _tileQuery->setForwardOnly(true);
+    if (!_tileQuery->prepare(QStringLiteral("SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?"))) {
+        errorString = _tileQuery->lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+QByteArray MBTilesFile::tile(int x, int y, int zoom)
+{
+    if (!_tileQuery) {
+        return QByteArray();
+    }
+
+    // MBTiles rows follow the TMS scheme, counted from the south
+    _tileQuery->bindValue(0, zoom);
+    _tileQuery->bindValue(1, x);
+    _tileQuery->bindValue(2, (1 << zoom) - 1 - y);
+
+    QByteArray image;
+    if (_tileQuery->exec() && _tileQuery->next()) {
+        image = _tileQuery->value(0).toByteArray();
+    }
+    _tileQuery->finish();
+
+    return image;
+}
+
+/*===========================================================================*/
+
+static bool _readVarint(const uchar *&pos, const uchar *end, quint64 &value)
+{
+    value = 0;
+    for (int shift = 0; (pos < end) && (shift < 64); shift += 7) {
+        const uchar byte = *pos++;
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+PMTilesFile::PMTilesFile(const QString &fileName)
+    : LocalTileFile(fileName)
+    , _file(fileName)
+{
+
+}
+
+PMTilesFile::~PMTilesFile()
+{
+    if (_data) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+    }
+}
+
+bool PMTilesFile::_open(QString &errorString)
+{
+    if (!_file.open(QIODevice::ReadOnly)) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    _size = _file.size();
+    if (_size < kHeaderSize) {
+        errorString = QStringLiteral("Not a PMTiles file");
+        return false;
+    }
+
+    _data = _file.map(0, _size);
+    if (!_data) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    if (_data[7] != 3) {
+        errorString = QStringLiteral("Unsupported PMTiles version %1").arg(_data[7]);
+        return false;
+    }
+
+    const quint64 rootOffset = qFromLittleEndian<quint64>(_data + 8);
+    const quint64 rootLength = qFromLittleEndian<quint64>(_data + 16);
+    _leafDirectoriesOffset = qFromLittleEndian<quint64>(_data + 40);
+    _tileDataOffset = qFromLittleEndian<quint64>(_data + 56);
+    _internalCompression = _data[97];
+    _tileCompression = _data[98];
+    const quint8 tileType = _data[99];
+
+    if (tileType == TileTypeMvt) {
+        errorString = QStringLiteral("Vector tiles are not supported");
+        return false;
+    }
+    if ((_internalCompression > CompressionGzip) || (_tileCompression > CompressionGzip)) {
+        errorString = QStringLiteral("Unsupported PMTiles compression");
+        return false;
+    }
+
+    if (!_readDirectory(rootOffset, rootLength, _rootDirectory)) {
+        errorString = QStringLiteral("PMTiles root directory is invalid");
+        return false;
+    }
+
+    return true;
+}
+
+quint64 PMTilesFile::tileId(int x, int y, int zoom)
+{
+    quint64 id = 0;
+    for (int z = 0; z < zoom; z++) {
+        id += static_cast<quint64>(1) << (2 * z);
+    }
+
+    const qint64 n = static_cast<qint64>(1) << zoom;
+    qint64 tx = x;
+    qint64 ty = y;
+    for (qint64 s = n / 2; s > 0; s /= 2) {
+        const qint64 rx = (tx & s) ? 1 : 0;
+        const qint64 ry = (ty & s) ? 1 : 0;
+        id += static_cast<quint64>(s * s * ((3 * rx) ^ ry));
+
+        if (ry == 0) {
+            if (rx == 1) {
+                tx = s - 1 - tx;
+                ty = s - 1 - ty;
+            }
+            std::swap(tx, ty);
+        }
+    }
+
+    return id;
+}
+
+QByteArray PMTilesFile::_uncompress(const uchar *data, quint64 length, quint8 compression) const
+{
+    const QByteArrayView bytes(reinterpret_cast<const char*>(data), static_cast<qsizetype>(length));
+    if (compression == CompressionGzip) {
+        return QGCZlib::inflateGzip(bytes);
+    }
+
+    // Copied so the tile stays valid when the file is closed
+    return bytes.toByteArray();
+}
+
+bool PMTilesFile::_readDirectory(quint64 offset, quint64 length, Directory_t &directory) const
+{
+    directory.clear();
+
+    if ((offset > static_cast<quint64>(_size)) || (length > (static_cast<quint64>(_size) - offset))) {
+        return false;
+    }
+
+    const QByteArray bytes = _uncompress(_data + offset, length, _internalCompression);
+    const uchar *pos = reinterpret_cast<const uchar*>(bytes.constData());
+    const uchar *const end = pos + bytes.size();
+
+    quint64 count = 0;
+    if (!_readVarint(pos, end, count) || (count > static_cast<quint64>(bytes.size()))) {
+        return false;
+    }
+    directory.resize(static_cast<qsizetype>(count));
+
+    quint64 value = 0;
+    quint64 lastId = 0;
+    for (Entry_t &entry : directory) {
+        if (!_readVarint(pos, end, value)) {
+            return false;
+        }
+        lastId += value;
+        entry.tileId = lastId;
+    }
+    for (Entry_t &entry : directory) {
+        if (!_readVarint(pos, end, value)) {
+            return false;
+        }
+        entry.runLength = static_cast<quint32>(value);
+    }
+    for (Entry_t &entry : directory) {
+        if (!_readVarint(pos, end, value)) {
+            return false;
+        }
+        entry.length = static_cast<quint32>(value);
+    }
+    for (qsizetype i = 0; i < directory.size(); i++) {
+        if (!_readVarint(pos, end, value)) {
+            return false;
+        }
+        // 0 marks an entry which directly follows the previous one
+        if ((value == 0) && (i > 0)) {
+            directory[i].offset = directory[i - 1].offset + directory[i - 1].length;
+        } else {
+            directory[i].offset = value - 1;
+        }
+    }
+
+    return true;
+}
+
+const PMTilesFile::Entry_t *PMTilesFile::_findEntry(const Directory_t &directory, quint64 tileId)
+{
+    // Last entry starting at or before the tile
+    const auto it = std::upper_bound(directory.cbegin(), directory.cend(), tileId, [](quint64 id, const Entry_t &entry) {
+        return id < entry.tileId;
+    });
+    if (it == directory.cbegin()) {
+        return nullptr;
+    }
+
+    const Entry_t &entry = *(it - 1);
+    if ((entry.runLength == 0) || ((tileId - entry.tileId) < entry.runLength)) {
+        return &entry;
+    }
+
+    return nullptr;
+}
+
+QByteArray PMTilesFile::tile(int x, int y, int zoom)
+{
+    if (!_data || (zoom < 0) || (zoom > 31)) {
+        return QByteArray();
+    }
+
+    const quint64 id = tileId(x, y, zoom);
+
+    const Directory_t *directory = &_rootDirectory;
+    for (int depth = 0; depth < kMaxDirectoryDepth; depth++) {
+        const Entry_t *const entry = _findEntry(*directory, id);
+        if (!entry) {
+            break;
+        }
+
+        if (entry->runLength > 0) {
+            const quint64 offset = _tileDataOffset + entry->offset;
+            if ((offset > static_cast<quint64>(_size)) || (entry->length > (static_cast<quint64>(_size) - offset))) {
+                qCWarning(LocalTileFileLog) << "Tile" << zoom << x << y << "is outside of" << _fileName;
+                break;
+            }
+            return _uncompress(_data + offset, entry->length, _tileCompression);
+        }
+
+        const quint64 leafOffset = _leafDirectoriesOffset + entry->offset;
+        Directory_t *leaf = _leafDirectories.object(leafOffset);
+        if (!leaf) {
+            leaf = new Directory_t;
+            if (!_readDirectory(leafOffset, entry->length, *leaf)) {
+                qCWarning(LocalTileFileLog) << "Invalid leaf directory in" << _fileName;
+                delete leaf;
+                break;
+            }
+            // QCache deletes the directory if it can not hold it
+            if (!_leafDirectories.insert(leafOffset, leaf)) {
+                break;
+            }
+        }
+        directory = leaf;
+    }
+
+    return QByteArray();
+}
@@ -0,0 +1,118 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCache>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+
+#include <memory>
+
+Q_DECLARE_LOGGING_CATEGORY(LocalTileFileLog)
+
+class QSqlQuery;
+
+/// Read only access to the raster tiles of a local MBTiles or PMTiles file. Tiles are looked up through the file's own
+/// index, so the file is used in place instead of being imported into the tile cache. Not thread safe.
+class LocalTileFile
+{
+public:
+    virtual ~LocalTileFile() = default;
+
+    /// Opens the file with the reader matching its contents
+    ///     @return nullptr: file could not be opened or does not hold raster tiles
+    static std::unique_ptr<LocalTileFile> open(const QString &fileName, QString &errorString);
+
+    const QString &fileName() const { return _fileName; }
+
+    /// @param x, y Tile coordinates in the XYZ scheme used by the map providers
+    /// @return Image data, empty if the file has no such tile
+    virtual QByteArray tile(int x, int y, int zoom) = 0;
+
+protected:
+    explicit LocalTileFile(const QString &fileName) : _fileName(fileName) {}
+
+    virtual bool _open(QString &errorString) = 0;
+
+    const QString _fileName;
+};
+
+/// MBTiles 1.3 file, a SQLite database read through a memory mapping
+class MBTilesFile : public LocalTileFile
+{
+public:
+    explicit MBTilesFile(const QString &fileName);
+    ~MBTilesFile() override;
+
+    QByteArray tile(int x, int y, int zoom) final;
+
+private:
+    bool _open(QString &errorString) final;
+
+    const QString _connectionName;
+    std::unique_ptr<QSqlQuery> _tileQuery;
+
+    static constexpr qint64 kMmapSize = (sizeof(void*) >= 8) ? (static_cast<qint64>(1) << 40) : (static_cast<qint64>(256) << 20);
+};
+
+/// PMTiles v3 file, memory mapped with its directories decoded on demand
+class PMTilesFile : public LocalTileFile
+{
+public:
+    explicit PMTilesFile(const QString &fileName);
+    ~PMTilesFile() override;
+
+    QByteArray tile(int x, int y, int zoom) final;
+
+    /// @return Position of the tile on the Hilbert curves of all zoom levels, which orders the PMTiles directories
+    static quint64 tileId(int x, int y, int zoom);
+
+private:
+    struct Entry_t {
+        quint64 tileId;
+        quint64 offset;
+        quint32 length;
+        quint32 runLength;      ///< 0 for an entry pointing to a leaf directory
+    };
+    using Directory_t = QList<Entry_t>;
+
+    bool _open(QString &errorString) final;
+    bool _readDirectory(quint64 offset, quint64 length, Directory_t &directory) const;
+    QByteArray _uncompress(const uchar *data, quint64 length, quint8 compression) const;
+    static const Entry_t *_findEntry(const Directory_t &directory, quint64 tileId);
+
+    QFile _file;
+    const uchar *_data = nullptr;
+    qint64 _size = 0;
+    quint64 _leafDirectoriesOffset = 0;
+    quint64 _tileDataOffset = 0;
+    quint8 _internalCompression = 0;
+    quint8 _tileCompression = 0;
+    Directory_t _rootDirectory;
+    QCache<quint64, Directory_t> _leafDirectories{kLeafDirectoryCacheSize};
+
+    enum Compression : quint8 {
+        CompressionUnknown = 0,
+        CompressionNone,
+        CompressionGzip
+    };
+
+    enum TileType : quint8 {
+        TileTypeUnknown = 0,
+        TileTypeMvt
+    };
+
+    static constexpr qint64 kHeaderSize = 127;
+    static constexpr int kMaxDirectoryDepth = 4;    ///< Root plus up to three levels of leaf directories
+    static constexpr qsizetype kLeafDirectoryCacheSize = 64;
+};
@@ -65,6 +65,12 @@ QString MapProvider::getImageFormat(QByteArrayView image) const
         return QStringLiteral("gif");
     }
 
+    static constexpr QByteArrayView riffSignature("RIFF");
+    static constexpr QByteArrayView webpSignature("WEBP");
+    if (image.startsWith(riffSignature) && (image.size() >= 12) && (image.sliced(8, 4) == webpSignature)) {
+        return QStringLiteral("webp");
+    }
+
     return _imageFormat;
 }
 
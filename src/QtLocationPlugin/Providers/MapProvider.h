@@ -61,9 +61,25 @@ public:
     virtual int long2tileX(double lon, int z) const;
     virtual int lat2tileY(double lat, int z) const;
 
+    /// Limits for bulk offline downloads, which must stay within what the tile server's terms of use allow
+    virtual int getMaxConcurrentDownloads() const { return 6; }
+    /// @return Tiles per second, 0 for no limit. Conservative by default, as most free tile servers ask to not be bulk
+    /// downloaded from at all.
+    virtual double getMaxDownloadRate() const { return 10.; }
+    /// Limit for tiles fetched while a map is viewed, the same as QNetworkAccessManager's per host HTTP/1 limit
+    virtual int getMaxInteractiveDownloads() const { return 6; }
+
     virtual bool isElevationProvider() const { return false; }
     virtual bool isBingProvider() const { return false; }
 
+    /// Vector tile providers download and cache vector tiles, which VectorTileMapProvider::render turns into images
+    virtual bool isVectorTileProvider() const { return false; }
+
+    /// Local file providers serve tiles through getLocalTile, bypassing the network and the tile cache
+    virtual bool isLocalFileProvider() const { return false; }
+    /// @return Image data of the tile, empty if the tile is not available
+    virtual QByteArray getLocalTile(int x, int y, int zoom) const { Q_UNUSED(x); Q_UNUSED(y); Q_UNUSED(zoom); return QByteArray(); }
+
     virtual QGCTileSet getTileCount(int zoom, double topleftLon,
                                     double topleftLat, double bottomRightLon,
                                     double bottomRightLat) const;
@@ -26,6 +26,12 @@ protected:
             mapType)
         , _mapTypeId(mapTypeId) {}
 
+public:
+    // Mapbox serves over HTTP/2, so many more requests share one connection
+    int getMaxConcurrentDownloads() const final { return 16; }
+    // Requests count against the user's own access token, Mapbox enforces the account's rate limits
+    double getMaxDownloadRate() const final { return 0.; }
+
 private:
     QString _getURL(int x, int y, int zoom) const final;
 
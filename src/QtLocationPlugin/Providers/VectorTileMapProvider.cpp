@@ -0,0 +1,812 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VectorTileMapProvider.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "MapsSettings.h"
+#include "QGCZlib.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QtEndian>
+#include <QtCore/QVariant>
+#include <QtGui/QColor>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+
+#include <cmath>
+#include <cstring>
+
+/// Style for the OpenMapTiles schema, which most public vector tile servers use
+static constexpr const char *kDefaultStyle = R"({
+    "version": 8,
+    "layers": [
+        { "id": "background", "type": "background", "paint": { "background-color": "#f2efe9" } },
+        { "id": "landcover-wood", "type": "fill", "source-layer": "landcover", "filter": ["==", "class", "wood"],
+          "paint": { "fill-color": "#add19e", "fill-opacity": 0.6 } },
+        { "id": "landcover-grass", "type": "fill", "source-layer": "landcover", "filter": ["in", "class", "grass", "farmland"],
+          "paint": { "fill-color": "#cdebb0", "fill-opacity": 0.6 } },
+        { "id": "landcover-ice", "type": "fill", "source-layer": "landcover", "filter": ["==", "class", "ice"],
+          "paint": { "fill-color": "#ffffff", "fill-opacity": 0.8 } },
+        { "id": "landuse-residential", "type": "fill", "source-layer": "landuse", "filter": ["==", "class", "residential"],
+          "paint": { "fill-color": "#e0dfdf", "fill-opacity": 0.7 } },
+        { "id": "park", "type": "fill", "source-layer": "park", "paint": { "fill-color": "#c8facc", "fill-opacity": 0.7 } },
+        { "id": "water", "type": "fill", "source-layer": "water", "paint": { "fill-color": "#aad3df" } },
+        { "id": "waterway", "type": "line", "source-layer": "waterway", "minzoom": 8,
+          "paint": { "line-color": "#aad3df", "line-width": { "base": 1.3, "stops": [[8, 0.5], [20, 8]] } } },
+        { "id": "aeroway-area", "type": "fill", "source-layer": "aeroway", "minzoom": 10, "filter": ["==", "$type", "Polygon"],
+          "paint": { "fill-color": "#dadae0" } },
+        { "id": "aeroway-runway", "type": "line", "source-layer": "aeroway", "minzoom": 10,
+          "filter": ["all", ["==", "$type", "LineString"], ["in", "class", "runway", "taxiway"]],
+          "paint": { "line-color": "#bbbbcc", "line-width": { "base": 1.5, "stops": [[10, 1], [18, 40]] } } },
+        { "id": "building", "type": "fill", "source-layer": "building", "minzoom": 13,
+          "paint": { "fill-color": "#d9d0c9", "fill-outline-color": "#c2b8ae" } },
+        { "id": "road-minor", "type": "line", "source-layer": "transportation", "minzoom": 12,
+          "filter": ["all", ["==", "$type", "LineString"], ["in", "class", "minor", "service", "track", "path"]],
+          "paint": { "line-color": "#ffffff", "line-width": { "base": 1.4, "stops": [[12, 0.5], [20, 16]] } } },
+        { "id": "road-secondary", "type": "line", "source-layer": "transportation",
+          "filter": ["all", ["==", "$type", "LineString"], ["in", "class", "secondary", "tertiary"]],
+          "paint": { "line-color": "#f7fabf", "line-width": { "base": 1.4, "stops": [[8, 0.5], [20, 20]] } } },
+        { "id": "road-primary", "type": "line", "source-layer": "transportation",
+          "filter": ["all", ["==", "$type", "LineString"], ["in", "class", "primary", "trunk"]],
+          "paint": { "line-color": "#fcd6a4", "line-width": { "base": 1.4, "stops": [[5, 0.5], [20, 24]] } } },
+        { "id": "road-motorway", "type": "line", "source-layer": "transportation",
+          "filter": ["all", ["==", "$type", "LineString"], ["==", "class", "motorway"]],
+          "paint": { "line-color": "#e892a2", "line-width": { "base": 1.4, "stops": [[5, 0.5], [20, 28]] } } },
+        { "id": "railway", "type": "line", "source-layer": "transportation", "minzoom": 10, "filter": ["==", "class", "rail"],
+          "paint": { "line-color": "#a0a0a0", "line-width": { "base": 1.4, "stops": [[10, 0.5], [20, 4]] } } },
+        { "id": "boundary", "type": "line", "source-layer": "boundary", "filter": ["<=", "admin_level", 4],
+          "paint": { "line-color": "#9e9cab", "line-width": { "base": 1.3, "stops": [[3, 0.5], [20, 4]] } } }
+    ]
+})";
+
+/// Vector tile and style decoding and rendering
+namespace {
+    enum GeometryType {
+        GeometryUnknown =       0,
+        GeometryPoint =         1,
+        GeometryLineString =    2,
+        GeometryPolygon =       3,
+    };
+
+    struct TileFeature_t {
+        GeometryType type = GeometryUnknown;
+        QList<quint32> tags;                ///< Pairs of key and value indices
+        QList<quint32> geometry;            ///< Encoded drawing commands
+    };
+
+    struct TileLayer_t {
+        quint32 extent = 4096;
+        QStringList keys;
+        QVariantList values;
+        QList<TileFeature_t> features;
+    };
+
+    using Tile_t = QHash<QString, TileLayer_t>;
+
+    /// Reads the protocol buffer encoding of a tile
+    class PbfReader
+    {
+    public:
+        PbfReader(QByteArrayView data)
+            : _pos(reinterpret_cast<const uchar*>(data.constData()))
+            , _end(_pos + data.size()) {}
+
+        bool atEnd() const { return _pos >= _end; }
+        bool failed() const { return _failed; }
+
+        /// Reads the key of the next field
+        bool next(quint32 &field, quint32 &wireType)
+        {
+            if (atEnd() || _failed) {
+                return false;
+            }
+            const quint64 key = varint();
+            field = static_cast<quint32>(key >> 3);
+            wireType = static_cast<quint32>(key & 0x7);
+            return !_failed;
+        }
+
+        quint64 varint()
+        {
+            quint64 value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (_pos >= _end) {
+                    break;
+                }
+                const uchar byte = *_pos++;
+                value |= static_cast<quint64>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            _failed = true;
+            return 0;
+        }
+
+        QByteArrayView bytes()
+        {
+            const quint64 length = varint();
+            if (_failed || (length > static_cast<quint64>(_end - _pos))) {
+                _failed = true;
+                return QByteArrayView();
+            }
+            const QByteArrayView view(_pos, static_cast<qsizetype>(length));
+            _pos += length;
+            return view;
+        }
+
+        template<typename T>
+        T fixed()
+        {
+            T value{};
+            if (static_cast<size_t>(_end - _pos) < sizeof(T)) {
+                _failed = true;
+                return value;
+            }
+            memcpy(&value, _pos, sizeof(T));
+            _pos += sizeof(T);
+            return qFromLittleEndian(value);
+        }
+
+        QList<quint32> packed()
+        {
+            QList<quint32> values;
+            PbfReader reader(bytes());
+            while (!reader.atEnd() && !reader.failed()) {
+                values.append(static_cast<quint32>(reader.varint()));
+            }
+            _failed |= reader.failed();
+            return values;
+        }
+
+        void skip(quint32 wireType)
+        {
+            switch (wireType) {
+            case 0:
+                (void) varint();
+                break;
+            case 1:
+                _advance(8);
+                break;
+            case 2:
+                (void) bytes();
+                break;
+            case 5:
+                _advance(4);
+                break;
+            default:
+                _failed = true;
+                break;
+            }
+        }
+
+    private:
+        void _advance(qsizetype count)
+        {
+            if ((_end - _pos) < count) {
+                _failed = true;
+            } else {
+                _pos += count;
+            }
+        }
+
+        const uchar *_pos = nullptr;
+        const uchar *_end = nullptr;
+        bool _failed = false;
+    };
+
+    qint64 zigZag(quint64 value)
+    {
+        return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+    }
+
+    QVariant decodeValue(QByteArrayView data)
+    {
+        PbfReader reader(data);
+        QVariant value;
+        quint32 field = 0;
+        quint32 wireType = 0;
+        while (reader.next(field, wireType)) {
+            switch (field) {
+            case 1:
+                value = QString::fromUtf8(reader.bytes());
+                break;
+            case 2:
+            {
+                const quint32 bits = reader.fixed<quint32>();
+                float number;
+                memcpy(&number, &bits, sizeof(number));
+                value = static_cast<double>(number);
+                break;
+            }
+            case 3:
+            {
+                const quint64 bits = reader.fixed<quint64>();
+                double number;
+                memcpy(&number, &bits, sizeof(number));
+                value = number;
+                break;
+            }
+            case 4:
+                value = static_cast<qlonglong>(reader.varint());
+                break;
+            case 5:
+                value = static_cast<qulonglong>(reader.varint());
+                break;
+            case 6:
+                value = static_cast<qlonglong>(zigZag(reader.varint()));
+                break;
+            case 7:
+                value = (reader.varint() != 0);
+                break;
+            default:
+                reader.skip(wireType);
+                break;
+            }
+        }
+        return value;
+    }
+
+    bool decodeFeature(QByteArrayView data, TileFeature_t &feature)
+    {
+        PbfReader reader(data);
+        quint32 field = 0;
+        quint32 wireType = 0;
+        while (reader.next(field, wireType)) {
+            if ((field == 2) && (wireType == 2)) {
+                feature.tags = reader.packed();
+            } else if ((field == 3) && (wireType == 0)) {
+                const quint64 type = reader.varint();
+                feature.type = (type <= GeometryPolygon) ? static_cast<GeometryType>(type) : GeometryUnknown;
+            } else if ((field == 4) && (wireType == 2)) {
+                feature.geometry = reader.packed();
+            } else {
+                reader.skip(wireType);
+            }
+        }
+        return !reader.failed();
+    }
+
+    bool decodeLayer(QByteArrayView data, QString &name, TileLayer_t &layer)
+    {
+        PbfReader reader(data);
+        quint32 field = 0;
+        quint32 wireType = 0;
+        while (reader.next(field, wireType)) {
+            if ((field == 1) && (wireType == 2)) {
+                name = QString::fromUtf8(reader.bytes());
+            } else if ((field == 2) && (wireType == 2)) {
+                TileFeature_t feature;
+                if (!decodeFeature(reader.bytes(), feature)) {
+                    return false;
+                }
+                if (feature.type != GeometryUnknown) {
+                    layer.features.append(feature);
+                }
+            } else if ((field == 3) && (wireType == 2)) {
+                layer.keys.append(QString::fromUtf8(reader.bytes()));
+            } else if ((field == 4) && (wireType == 2)) {
+                layer.values.append(decodeValue(reader.bytes()));
+            } else if ((field == 5) && (wireType == 0)) {
+                layer.extent = static_cast<quint32>(reader.varint());
+            } else {
+                reader.skip(wireType);
+            }
+        }
+        return !reader.failed() && !name.isEmpty() && (layer.extent > 0);
+    }
+
+    bool decodeTile(QByteArrayView data, Tile_t &tile)
+    {
+        PbfReader reader(data);
+        quint32 field = 0;
+        quint32 wireType = 0;
+        while (reader.next(field, wireType)) {
+            if ((field == 3) && (wireType == 2)) {
+                QString name;
+                TileLayer_t layer;
+                if (!decodeLayer(reader.bytes(), name, layer)) {
+                    return false;
+                }
+                tile.insert(name, layer);
+            } else {
+                reader.skip(wireType);
+            }
+        }
+        return !reader.failed();
+    }
+
+    QVariant featureProperty(const TileLayer_t &layer, const TileFeature_t &feature, const QString &key)
+    {
+        if (key == QStringLiteral("$type")) {
+            static const QString typeNames[] = { QString(), QStringLiteral("Point"), QStringLiteral("LineString"), QStringLiteral("Polygon") };
+            return typeNames[feature.type];
+        }
+
+        for (qsizetype i = 0; (i + 1) < feature.tags.size(); i += 2) {
+            const quint32 keyIndex = feature.tags[i];
+            const quint32 valueIndex = feature.tags[i + 1];
+            if ((keyIndex < static_cast<quint32>(layer.keys.size())) && (layer.keys[keyIndex] == key)) {
+                return (valueIndex < static_cast<quint32>(layer.values.size())) ? layer.values[valueIndex] : QVariant();
+            }
+        }
+        return QVariant();
+    }
+
+    bool sameValue(const QVariant &property, const QJsonValue &value)
+    {
+        if (!property.isValid()) {
+            return false;
+        }
+        if (value.isString()) {
+            return (property.typeId() == QMetaType::QString) && (property.toString() == value.toString());
+        }
+        if (value.isBool()) {
+            return (property.typeId() == QMetaType::Bool) && (property.toBool() == value.toBool());
+        }
+        if (value.isDouble()) {
+            bool ok = false;
+            const double number = property.toDouble(&ok);
+            return ok && (property.typeId() != QMetaType::QString) && (number == value.toDouble());
+        }
+        return false;
+    }
+
+    /// Evaluates the legacy filter syntax. Unknown operators, such as those of the expression syntax, pass every feature.
+    bool matches(const QJsonArray &filter, const TileLayer_t &layer, const TileFeature_t &feature)
+    {
+        if (filter.isEmpty()) {
+            return true;
+        }
+
+        const QString op = filter[0].toString();
+        if ((op == QStringLiteral("all")) || (op == QStringLiteral("any")) || (op == QStringLiteral("none"))) {
+            bool any = false;
+            bool all = true;
+            for (qsizetype i = 1; i < filter.size(); i++) {
+                const bool match = matches(filter[i].toArray(), layer, feature);
+                any |= match;
+                all &= match;
+            }
+            return (op == QStringLiteral("all")) ? all : ((op == QStringLiteral("any")) ? any : !any);
+        }
+
+        if (filter.size() < 2) {
+            return true;
+        }
+        const QVariant property = featureProperty(layer, feature, filter[1].toString());
+
+        if (op == QStringLiteral("has")) {
+            return property.isValid();
+        }
+        if (op == QStringLiteral("!has")) {
+            return !property.isValid();
+        }
+        if ((op == QStringLiteral("in")) || (op == QStringLiteral("!in"))) {
+            bool found = false;
+            for (qsizetype i = 2; !found && (i < filter.size()); i++) {
+                found = sameValue(property, filter[i]);
+            }
+            return (op == QStringLiteral("in")) ? found : !found;
+        }
+
+        if (filter.size() < 3) {
+            return true;
+        }
+        if (op == QStringLiteral("==")) {
+            return sameValue(property, filter[2]);
+        }
+        if (op == QStringLiteral("!=")) {
+            return !sameValue(property, filter[2]);
+        }
+
+        bool ok = false;
+        const double number = property.toDouble(&ok);
+        if (!ok || (property.typeId() == QMetaType::QString) || !filter[2].isDouble()) {
+            return false;
+        }
+        const double value = filter[2].toDouble();
+        if (op == QStringLiteral("<")) {
+            return number < value;
+        }
+        if (op == QStringLiteral("<=")) {
+            return number <= value;
+        }
+        if (op == QStringLiteral(">")) {
+            return number > value;
+        }
+        if (op == QStringLiteral(">=")) {
+            return number >= value;
+        }
+        return true;
+    }
+
+    QColor parseColor(const QString &text)
+    {
+        static const QRegularExpression functionRegExp(QStringLiteral("^\\s*(rgba?|hsla?)\\s*\\(([^)]*)\\)\\s*$"));
+        const QRegularExpressionMatch match = functionRegExp.match(text);
+        if (!match.hasMatch()) {
+            return QColor::fromString(text.trimmed());
+        }
+
+        const QString function = match.captured(1);
+        QList<double> args;
+        for (QString arg: match.captured(2).split(QLatin1Char(','))) {
+            arg = arg.trimmed();
+            (void) arg.remove(QLatin1Char('%'));
+            bool ok = false;
+            args.append(arg.toDouble(&ok));
+            if (!ok) {
+                return QColor();
+            }
+        }
+        if (args.size() < 3) {
+            return QColor();
+        }
+        const double alpha = (args.size() > 3) ? qBound(0.0, args[3], 1.0) : 1.0;
+
+        if (function.startsWith(QStringLiteral("rgb"))) {
+            return QColor::fromRgbF(qBound(0.0, args[0] / 255., 1.0), qBound(0.0, args[1] / 255., 1.0), qBound(0.0, args[2] / 255., 1.0), alpha);
+        }
+        const double hue = std::fmod(std::fmod(args[0], 360.) + 360., 360.) / 360.;
+        return QColor::fromHslF(hue, qBound(0.0, args[1] / 100., 1.0), qBound(0.0, args[2] / 100., 1.0), alpha);
+    }
+
+    /// Position between the two zoom stops around zoom, exponentially spaced by base as in the style specification
+    double stopFactor(double zoom, double lower, double upper, double base)
+    {
+        const double range = upper - lower;
+        if (range <= 0) {
+            return 0;
+        }
+        const double progress = zoom - lower;
+        if (qFuzzyCompare(base, 1.0)) {
+            return progress / range;
+        }
+        return (std::pow(base, progress) - 1) / (std::pow(base, range) - 1);
+    }
+
+    double numberProperty(const QJsonValue &value, double zoom, double defaultValue)
+    {
+        if (value.isDouble()) {
+            return value.toDouble();
+        }
+
+        const QJsonArray stops = value.toObject().value(QStringLiteral("stops")).toArray();
+        if (stops.isEmpty()) {
+            return defaultValue;
+        }
+        const double base = value.toObject().value(QStringLiteral("base")).toDouble(1.0);
+
+        const QJsonArray first = stops.first().toArray();
+        if (zoom <= first[0].toDouble()) {
+            return first[1].toDouble(defaultValue);
+        }
+        for (qsizetype i = 1; i < stops.size(); i++) {
+            const QJsonArray lower = stops[i - 1].toArray();
+            const QJsonArray upper = stops[i].toArray();
+            if (zoom <= upper[0].toDouble()) {
+                const double factor = stopFactor(zoom, lower[0].toDouble(), upper[0].toDouble(), base);
+                return lower[1].toDouble() + ((upper[1].toDouble() - lower[1].toDouble()) * factor);
+            }
+        }
+        return stops.last().toArray()[1].toDouble(defaultValue);
+    }
+
+    QColor colorProperty(const QJsonValue &value, double zoom, const QColor &defaultColor)
+    {
+        if (value.isString()) {
+            const QColor color = parseColor(value.toString());
+            return color.isValid() ? color : defaultColor;
+        }
+
+        const QJsonArray stops = value.toObject().value(QStringLiteral("stops")).toArray();
+        if (stops.isEmpty()) {
+            return defaultColor;
+        }
+        const double base = value.toObject().value(QStringLiteral("base")).toDouble(1.0);
+
+        const QJsonArray first = stops.first().toArray();
+        if (zoom <= first[0].toDouble()) {
+            return colorProperty(first[1], zoom, defaultColor);
+        }
+        for (qsizetype i = 1; i < stops.size(); i++) {
+            const QJsonArray lower = stops[i - 1].toArray();
+            const QJsonArray upper = stops[i].toArray();
+            if (zoom <= upper[0].toDouble()) {
+                const double factor = stopFactor(zoom, lower[0].toDouble(), upper[0].toDouble(), base);
+                const QColor from = colorProperty(lower[1], zoom, defaultColor);
+                const QColor to = colorProperty(upper[1], zoom, defaultColor);
+                return QColor::fromRgbF(from.redF() + ((to.redF() - from.redF()) * factor),
+                                        from.greenF() + ((to.greenF() - from.greenF()) * factor),
+                                        from.blueF() + ((to.blueF() - from.blueF()) * factor),
+                                        from.alphaF() + ((to.alphaF() - from.alphaF()) * factor));
+            }
+        }
+        return colorProperty(stops.last().toArray()[1], zoom, defaultColor);
+    }
+
+    /// Decodes the drawing commands of a feature into tile pixel coordinates
+    QPainterPath featurePath(const TileFeature_t &feature, double scale, QList<QPointF> *points = nullptr)
+    {
+        enum Command {
+            CommandMoveTo =     1,
+            CommandLineTo =     2,
+            CommandClosePath =  7,
+        };
+
+        QPainterPath path;
+        path.setFillRule(Qt::WindingFill);
+
+        qint64 x = 0;
+        qint64 y = 0;
+        const qsizetype size = feature.geometry.size();
+        for (qsizetype i = 0; i < size;) {
+            const quint32 command = feature.geometry[i] & 0x7;
+            const quint32 count = feature.geometry[i] >> 3;
+            i++;
+
+            if (command == CommandClosePath) {
+                path.closeSubpath();
+                continue;
+            }
+            if ((command != CommandMoveTo) && (command != CommandLineTo)) {
+                break;
+            }
+
+            for (quint32 j = 0; (j < count) && ((i + 1) < size); j++) {
+                x += zigZag(feature.geometry[i++]);
+                y += zigZag(feature.geometry[i++]);
+                const QPointF point(x * scale, y * scale);
+                if (command == CommandMoveTo) {
+                    path.moveTo(point);
+                    if (points) {
+                        points->append(point);
+                    }
+                } else {
+                    path.lineTo(point);
+                }
+            }
+        }
+
+        return path;
+    }
+}
+
+struct VectorTileMapProvider::Style_t {
+    enum LayerType {
+        LayerBackground,
+        LayerFill,
+        LayerLine,
+        LayerCircle,
+    };
+
+    struct StyleLayer_t {
+        LayerType type = LayerFill;
+        QString sourceLayer;
+        double minZoom = 0;
+        double maxZoom = 24;
+        QJsonArray filter;
+        QJsonObject paint;
+    };
+
+    QList<StyleLayer_t> layers;
+
+    /// Reads the layers this renderer supports, others such as symbol layers are left out
+    bool parse(const QByteArray &json, QString &errorString)
+    {
+        QJsonParseError parseError;
+        const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+        if (parseError.error != QJsonParseError::NoError) {
+            errorString = parseError.errorString();
+            return false;
+        }
+
+        const QJsonArray jsonLayers = doc.object().value(QStringLiteral("layers")).toArray();
+        if (jsonLayers.isEmpty()) {
+            errorString = QStringLiteral("Style has no layers");
+            return false;
+        }
+
+        static const QHash<QString, LayerType> layerTypes = {
+            { QStringLiteral("background"), LayerBackground },
+            { QStringLiteral("fill"), LayerFill },
+            { QStringLiteral("line"), LayerLine },
+            { QStringLiteral("circle"), LayerCircle },
+        };
+
+        for (const QJsonValue &value: jsonLayers) {
+            const QJsonObject object = value.toObject();
+            const QString type = object.value(QStringLiteral("type")).toString();
+            if (!layerTypes.contains(type)) {
+                continue;
+            }
+            if (object.value(QStringLiteral("layout")).toObject().value(QStringLiteral("visibility")).toString() == QStringLiteral("none")) {
+                continue;
+            }
+
+            StyleLayer_t layer;
+            layer.type = layerTypes.value(type);
+            layer.sourceLayer = object.value(QStringLiteral("source-layer")).toString();
+            layer.minZoom = object.value(QStringLiteral("minzoom")).toDouble(0);
+            layer.maxZoom = object.value(QStringLiteral("maxzoom")).toDouble(24);
+            layer.filter = object.value(QStringLiteral("filter")).toArray();
+            layer.paint = object.value(QStringLiteral("paint")).toObject();
+            if ((layer.type != LayerBackground) && layer.sourceLayer.isEmpty()) {
+                continue;
+            }
+            layers.append(layer);
+        }
+
+        return true;
+    }
+};
+
+VectorTileMapProvider::~VectorTileMapProvider()
+{
+
+}
+
+std::shared_ptr<const VectorTileMapProvider::Style_t> VectorTileMapProvider::_style() const
+{
+    const QString fileName = _styleFileName();
+
+    QMutexLocker lock(&_styleMutex);
+
+    if (_loadedStyle && (fileName == _loadedStyleFileName)) {
+        return _loadedStyle;
+    }
+
+    std::shared_ptr<Style_t> style = std::make_shared<Style_t>();
+    QString errorString;
+    if (!fileName.isEmpty()) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCWarning(MapProviderLog) << "Failed to open vector tile style" << fileName << file.errorString();
+        } else if (!style->parse(file.readAll(), errorString)) {
+            qCWarning(MapProviderLog) << "Failed to load vector tile style" << fileName << errorString;
+            style = std::make_shared<Style_t>();
+        }
+    }
+    if (style->layers.isEmpty()) {
+        (void) style->parse(QByteArray(kDefaultStyle), errorString);
+    }
+
+    // A style which failed to load is not retried for every tile
+    _loadedStyle = style;
+    _loadedStyleFileName = fileName;
+    return _loadedStyle;
+}
+
+QByteArray VectorTileMapProvider::render(const QByteArray &tile, int zoom) const
+{
+    static constexpr QByteArrayView gzipSignature("\x1F\x8B");
+    const QByteArray data = tile.startsWith(gzipSignature) ? QGCZlib::inflateGzip(tile) : tile;
+
+    Tile_t decodedTile;
+    if (data.isEmpty() || !decodeTile(data, decodedTile)) {
+        qCWarning(MapProviderLog) << "Invalid vector tile at zoom" << zoom;
+        return QByteArray();
+    }
+
+    const std::shared_ptr<const Style_t> style = _style();
+
+    QImage image(renderSize, renderSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    for (const Style_t::StyleLayer_t &styleLayer: style->layers) {
+        if ((zoom < styleLayer.minZoom) || (zoom >= styleLayer.maxZoom)) {
+            continue;
+        }
+
+        const QJsonObject &paint = styleLayer.paint;
+        if (styleLayer.type == Style_t::LayerBackground) {
+            QColor color = colorProperty(paint.value(QStringLiteral("background-color")), zoom, Qt::black);
+            color.setAlphaF(color.alphaF() * numberProperty(paint.value(QStringLiteral("background-opacity")), zoom, 1.0));
+            painter.fillRect(image.rect(), color);
+            continue;
+        }
+
+        const auto it = decodedTile.constFind(styleLayer.sourceLayer);
+        if (it == decodedTile.constEnd()) {
+            continue;
+        }
+        const TileLayer_t &layer = it.value();
+        const double scale = static_cast<double>(renderSize) / layer.extent;
+
+        switch (styleLayer.type) {
+        case Style_t::LayerFill:
+        {
+            QColor color = colorProperty(paint.value(QStringLiteral("fill-color")), zoom, Qt::black);
+            color.setAlphaF(color.alphaF() * numberProperty(paint.value(QStringLiteral("fill-opacity")), zoom, 1.0));
+            const QColor outlineColor = colorProperty(paint.value(QStringLiteral("fill-outline-color")), zoom, QColor());
+            painter.setPen(outlineColor.isValid() ? QPen(outlineColor, 1) : QPen(Qt::NoPen));
+            painter.setBrush(color);
+            for (const TileFeature_t &feature: layer.features) {
+                if ((feature.type == GeometryPolygon) && matches(styleLayer.filter, layer, feature)) {
+                    painter.drawPath(featurePath(feature, scale));
+                }
+            }
+            break;
+        }
+        case Style_t::LayerLine:
+        {
+            QColor color = colorProperty(paint.value(QStringLiteral("line-color")), zoom, Qt::black);
+            color.setAlphaF(color.alphaF() * numberProperty(paint.value(QStringLiteral("line-opacity")), zoom, 1.0));
+            QPen pen(color, numberProperty(paint.value(QStringLiteral("line-width")), zoom, 1.0));
+            pen.setCapStyle(Qt::RoundCap);
+            pen.setJoinStyle(Qt::RoundJoin);
+            painter.setPen(pen);
+            painter.setBrush(Qt::NoBrush);
+            for (const TileFeature_t &feature: layer.features) {
+                if ((feature.type != GeometryPoint) && matches(styleLayer.filter, layer, feature)) {
+                    painter.drawPath(featurePath(feature, scale));
+                }
+            }
+            break;
+        }
+        case Style_t::LayerCircle:
+        {
+            QColor color = colorProperty(paint.value(QStringLiteral("circle-color")), zoom, Qt::black);
+            color.setAlphaF(color.alphaF() * numberProperty(paint.value(QStringLiteral("circle-opacity")), zoom, 1.0));
+            const double radius = numberProperty(paint.value(QStringLiteral("circle-radius")), zoom, 5.0);
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(color);
+            for (const TileFeature_t &feature: layer.features) {
+                if ((feature.type == GeometryPoint) && matches(styleLayer.filter, layer, feature)) {
+                    QList<QPointF> points;
+                    (void) featurePath(feature, scale, &points);
+                    for (const QPointF &point: points) {
+                        painter.drawEllipse(point, radius, radius);
+                    }
+                }
+            }
+            break;
+        }
+        case Style_t::LayerBackground:
+            break;
+        }
+    }
+
+    painter.end();
+
+    QByteArray png;
+    QBuffer buffer(&png);
+    (void) buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "PNG")) {
+        return QByteArray();
+    }
+    return png;
+}
+
+QString VectorTileCustomMapProvider::_getURL(int x, int y, int zoom) const
+{
+    QString url = qgcApp()->toolbox()->settingsManager()->mapsSettings()->vectorTileURL()->rawValue().toString();
+    (void) url.replace("{x}", QString::number(x));
+    (void) url.replace("{y}", QString::number(y));
+    static const QRegularExpression zoomRegExp("\\{(z|zoom)\\}");
+    (void) url.replace(zoomRegExp, QString::number(zoom));
+    return url;
+}
+
+QString VectorTileCustomMapProvider::_styleFileName() const
+{
+    return qgcApp()->toolbox()->settingsManager()->mapsSettings()->vectorTileStyleFile()->rawValue().toString();
+}
@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MapProvider.h"
+
+#include <QtCore/QMutex>
+
+#include <memory>
+
+static constexpr const quint32 AVERAGE_VECTOR_TILE_SIZE = 4096;
+
+/// Serves Mapbox Vector Tiles (MVT), which are a fraction of the size of raster tiles. The tile cache, offline sets and
+/// tile packs hold the vector tiles as downloaded, they are only rendered to images for display.
+///
+/// Rendering follows a style in the Mapbox GL style format, of which the background, fill, line and circle layers,
+/// source layer, zoom range and legacy filters are supported. Paint properties may be constants or zoom stops.
+class VectorTileMapProvider : public MapProvider
+{
+protected:
+    VectorTileMapProvider(const QString &mapName, const QString &referrer, quint32 averageSize, QGeoMapType::MapStyle mapStyle)
+        : MapProvider(
+            mapName,
+            referrer,
+            QStringLiteral("pbf"),
+            averageSize,
+            mapStyle) {}
+
+public:
+    ~VectorTileMapProvider();
+
+    bool isVectorTileProvider() const final { return true; }
+
+    /// Renders a vector tile, plain or gzip compressed, to a PNG image
+    ///     @return Image data, empty if the tile is not a valid vector tile
+    QByteArray render(const QByteArray &tile, int zoom) const;
+
+    /// Size of the rendered images, QtLocation scales them to the map tile size
+    static constexpr int renderSize = 512;
+
+    struct Style_t;
+
+protected:
+    /// @return Path of the style file, empty for the built in style
+    virtual QString _styleFileName() const { return QString(); }
+
+private:
+    std::shared_ptr<const Style_t> _style() const;
+
+    mutable QMutex _styleMutex;
+    mutable std::shared_ptr<const Style_t> _loadedStyle;
+    mutable QString _loadedStyleFileName;
+};
+
+/// Vector tiles from the server and with the style set in MapsSettings
+class VectorTileCustomMapProvider : public VectorTileMapProvider
+{
+public:
+    VectorTileCustomMapProvider()
+        : VectorTileMapProvider(
+            QStringLiteral("VectorTile Custom"),
+            QStringLiteral(""),
+            AVERAGE_VECTOR_TILE_SIZE,
+            QGeoMapType::CustomMap) {}
+
+private:
+    QString _getURL(int x, int y, int zoom) const final;
+    QString _styleFileName() const final;
+};
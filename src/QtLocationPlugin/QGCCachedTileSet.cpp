@@ -30,6 +30,7 @@
 #include <QGCLoggingCategory.h>
 #include <TerrainTile.h>
 
+#include <QtCore/QtMath>
 #include <QtNetwork/QNetworkProxy>
 
 QGC_LOGGING_CATEGORY(QGCCachedTileSetLog, "qgc.qtlocation.qgccachedtileset")
@@ -41,6 +42,13 @@ QGCCachedTileSet::QGCCachedTileSet(const QString &name, QObject *parent)
     , _name(name)
 {
     // qCDebug(QGCCachedTileSetLog) << Q_FUNC_INFO << this;
+
+    _downloadRateTimer.setSingleShot(true);
+    (void) connect(&_downloadRateTimer, &QTimer::timeout, this, &QGCCachedTileSet::_prepareDownload);
+
+    _tileStateTimer.setSingleShot(true);
+    _tileStateTimer.setInterval(kTileStateFlushMsecs);
+    (void) connect(&_tileStateTimer, &QTimer::timeout, this, &QGCCachedTileSet::_flushTileStates);
 }
 
 QGCCachedTileSet::~QGCCachedTileSet()
@@ -67,6 +75,10 @@ void QGCCachedTileSet::createDownloadTask()
         setErrorCount(0);
         setDownloading(true);
         _noMoreTiles = false;
+        // Tiles left over from a cancelled download are pending again in the database
+        qDeleteAll(_tilesToDownload);
+        _tilesToDownload.clear();
+        _downloadTokenTimer.invalidate();
     }
 
     QGCGetTileDownloadListTask* const task = new QGCGetTileDownloadListTask(_id, TILE_BATCH_SIZE);
@@ -84,6 +96,7 @@ void QGCCachedTileSet::createDownloadTask()
 
 void QGCCachedTileSet::resumeDownloadTask()
 {
+    _flushTileStates();
     QGCUpdateTileDownloadStateTask* const task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StatePending, "*");
     getQGCMapEngine()->addTask(task);
     createDownloadTask();
@@ -131,12 +144,20 @@ void QGCCachedTileSet::_doneWithDownload()
     }
 
     setDownloading(false);
+    _flushTileStates();
 
     emit completeChanged();
 }
 
 void QGCCachedTileSet::_prepareDownload()
 {
+    if (!_downloading) {
+        // Cancelled, replies which are still in flight complete but nothing new is requested
+        _downloadRateTimer.stop();
+        _flushTileStates();
+        return;
+    }
+
     if (_tilesToDownload.isEmpty()) {
         if (_noMoreTiles) {
             _doneWithDownload();
@@ -146,16 +167,22 @@ void QGCCachedTileSet::_prepareDownload()
         return;
     }
 
-    for (qsizetype i = _replies.count(); i < QGeoTileFetcherQGC::concurrentDownloads(_type); i++) {
+    const qsizetype concurrentDownloads = QGeoTileFetcherQGC::concurrentDownloads(_type);
+    for (qsizetype i = _replies.count(); i < concurrentDownloads; i++) {
         if (_tilesToDownload.isEmpty()) {
             break;
         }
+        if (!_takeDownloadToken()) {
+            break;
+        }
 
         QGCTile* const tile = _tilesToDownload.dequeue();
         const int mapId = UrlFactory::getQtMapIdFromProviderType(tile->type());
         QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(mapId, tile->x(), tile->y(), tile->z());
         request.setOriginatingObject(this);
         request.setAttribute(QNetworkRequest::User, tile->hash());
+        // Servers which support it multiplex all the concurrent downloads over one reused connection
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
 
         QNetworkReply* const reply = _networkManager->get(request);
         reply->setParent(this);
@@ -165,7 +192,7 @@ void QGCCachedTileSet::_prepareDownload()
         (void) _replies.insert(tile->hash(), reply);
 
         delete tile;
-        if (!_batchRequested && !_noMoreTiles && (_tilesToDownload.count() < (QGeoTileFetcherQGC::concurrentDownloads(_type) * 10))) {
+        if (!_batchRequested && !_noMoreTiles && (_tilesToDownload.count() < (concurrentDownloads * 10))) {
             createDownloadTask();
         }
     }
@@ -229,8 +256,7 @@ void QGCCachedTileSet::_networkReplyFinished()
 
     QGeoFileTileCacheQGC::cacheTile(type, hash, image, format, _id);
 
-    QGCUpdateTileDownloadStateTask* const task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateComplete, hash);
-    getQGCMapEngine()->addTask(task);
+    _queueTileState(_completedHashes, hash);
 
     setSavedTileSize(_savedTileSize + image.size());
     setSavedTileCount(_savedTileCount + 1);
@@ -270,12 +296,68 @@ void QGCCachedTileSet::_networkReplyError(QNetworkReply::NetworkError error)
         qCWarning(QGCCachedTileSetLog) << Q_FUNC_INFO << "Error:" << reply->errorString();
     }
 
-    QGCUpdateTileDownloadStateTask* const task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateError, hash);
-    getQGCMapEngine()->addTask(task);
+    _queueTileState(_erroredHashes, hash);
 
     _prepareDownload();
 }
 
+/// Token bucket limiting downloads to the provider rate, with bursts of up to one second worth of tiles
+///     @return false: no token available, downloading resumes from the rate timer
+bool QGCCachedTileSet::_takeDownloadToken()
+{
+    const double rate = QGeoTileFetcherQGC::maxDownloadRate(_type);
+    if (rate <= 0.) {
+        return true;
+    }
+
+    const double burst = qMax(1., rate);
+    if (!_downloadTokenTimer.isValid()) {
+        _downloadTokens = burst;
+        _downloadTokenTimer.start();
+    } else {
+        _downloadTokens = qMin(burst, _downloadTokens + (_downloadTokenTimer.restart() * rate / 1000.));
+    }
+
+    if (_downloadTokens >= 1.) {
+        _downloadTokens -= 1.;
+        return true;
+    }
+
+    if (!_downloadRateTimer.isActive()) {
+        _downloadRateTimer.start(qCeil((1. - _downloadTokens) * 1000. / rate));
+    }
+    return false;
+}
+
+/// Download state changes are persisted in batches, a single update task per batch instead of one per tile.
+/// Tiles whose state is lost are still marked as downloading, which resumeDownloadTask resets to pending.
+void QGCCachedTileSet::_queueTileState(QStringList &hashes, const QString &hash)
+{
+    hashes.append(hash);
+    if (hashes.count() >= kTileStateBatchSize) {
+        _flushTileStates();
+    } else if (!_tileStateTimer.isActive()) {
+        _tileStateTimer.start();
+    }
+}
+
+void QGCCachedTileSet::_flushTileStates()
+{
+    _tileStateTimer.stop();
+
+    if (!_completedHashes.isEmpty()) {
+        QGCUpdateTileDownloadStateTask* const task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateComplete, _completedHashes);
+        getQGCMapEngine()->addTask(task);
+        _completedHashes.clear();
+    }
+
+    if (!_erroredHashes.isEmpty()) {
+        QGCUpdateTileDownloadStateTask* const task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateError, _erroredHashes);
+        getQGCMapEngine()->addTask(task);
+        _erroredHashes.clear();
+    }
+}
+
 void QGCCachedTileSet::setSelected(bool sel)
 {
     if (sel != _selected) {
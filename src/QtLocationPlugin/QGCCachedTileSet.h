@@ -19,11 +19,14 @@
 #pragma once
 
 #include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
 
 Q_DECLARE_LOGGING_CATEGORY(QGCCachedTileSetLog)
@@ -160,6 +163,9 @@ private slots:
 private:
     void _prepareDownload();
     void _doneWithDownload();
+    bool _takeDownloadToken();
+    void _queueTileState(QStringList &hashes, const QString &hash);
+    void _flushTileStates();
 
     QString _name;
     QString _mapTypeStr;
@@ -188,6 +194,17 @@ private:
 
     QHash<QString, QNetworkReply*> _replies;
     QQueue<QGCTile*> _tilesToDownload;
+
+    double _downloadTokens = 0.;        ///< Token bucket for the provider download rate
+    QElapsedTimer _downloadTokenTimer;
+    QTimer _downloadRateTimer;          ///< Resumes downloading once a token is available
+
+    QStringList _completedHashes;       ///< Download state changes not yet persisted
+    QStringList _erroredHashes;
+    QTimer _tileStateTimer;
+
+    static constexpr int kTileStateBatchSize = 64;
+    static constexpr int kTileStateFlushMsecs = 1000;
     QGCMapEngineManager *_manager = nullptr;
     QNetworkAccessManager *_networkManager = nullptr;
 };
@@ -24,6 +24,9 @@
 #include "QGCTile.h"
 #include "QGCCacheTile.h"
 #include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "MapsSettings.h"
+#include "TerrainTileManager.h"
 #include <QGCLoggingCategory.h>
 
 #include <QtCore/qapplicationstatic.h>
@@ -76,6 +79,12 @@ void QGCMapEngine::init()
 {
     _wipeOldCaches();
 
+    Fact* const terrainMemoryCacheSize = qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxTerrainMemoryCacheSize();
+    TerrainTileManager::instance()->setCacheMemoryBudgetMB(terrainMemoryCacheSize->rawValue().toInt());
+    (void) connect(terrainMemoryCacheSize, &Fact::rawValueChanged, this, [](const QVariant &value) {
+        TerrainTileManager::instance()->setCacheMemoryBudgetMB(value.toInt());
+    });
+
     // QString cacheDir = QAbstractGeoTileCache::baseCacheDirectory()
 #ifdef __mobile__
     QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
@@ -97,8 +106,15 @@ void QGCMapEngine::init()
     if (!m_cachePath.isEmpty()) {
         const QString databaseFilePath(m_cachePath + "/" + QGeoFileTileCacheQGC::getCacheFilename());
         m_worker->setDatabaseFile(databaseFilePath);
+        m_worker->setConcurrentAccess(QGeoFileTileCacheQGC::getConcurrentCacheAccessSetting());
+        _setMaxDiskCache(QGeoFileTileCacheQGC::getMaxDiskCacheSetting());
+        (void) connect(qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxCacheDiskSize(), &Fact::rawValueChanged, this, [this](const QVariant &value) {
+            _setMaxDiskCache(value.toUInt());
+        });
 
         qCDebug(QGCMapEngineLog) << "Map Cache in:" << databaseFilePath;
+
+        TerrainTileManager::instance()->loadTerrainPacks(getTerrainPackPath());
     } else {
         qCCritical(QGCMapEngineLog) << "Could not find suitable map cache directory.";
     }
@@ -162,14 +178,10 @@ void QGCMapEngine::_wipeOldCaches()
 void QGCMapEngine::_updateTotals(quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize)
 {
     emit updateTotals(totaltiles, totalsize, defaulttiles, defaultsize);
+}
 
-    const quint64 maxSize = static_cast<quint64>(QGeoFileTileCacheQGC::getMaxDiskCacheSetting()) * pow(1024, 2);
-    if (!m_prunning && (defaultsize > maxSize)) {
-        m_prunning = true;
-
-        const quint64 amountToPrune = defaultsize - maxSize;
-        QGCPruneCacheTask* const task = new QGCPruneCacheTask(amountToPrune);
-        (void) connect(task, &QGCPruneCacheTask::pruned, this, &QGCMapEngine::_pruned);
-        (void) addTask(task);
-    }
+void QGCMapEngine::_setMaxDiskCache(quint32 maxDiskCacheMB)
+{
+    // The worker prunes the cache itself whenever the limit is exceeded
+    m_worker->setMaxDiskCache(static_cast<quint64>(maxDiskCacheMB) * 1024 * 1024);
 }
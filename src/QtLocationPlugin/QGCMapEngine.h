@@ -39,6 +39,7 @@ public:
     bool addTask(QGCMapTask *task);
 
     QString getCachePath() const { return m_cachePath; }
+    QString getTerrainPackPath() const { return m_cachePath + QStringLiteral("/TerrainPacks"); }
 
     static QGCMapEngine* instance();
 
@@ -47,14 +48,13 @@ signals:
 
 private slots:
     void _updateTotals(quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize);
-    void _pruned() { m_prunning = false; }
 
 private:
+    void _setMaxDiskCache(quint32 maxDiskCacheMB);
     bool _wipeDirectory(const QString &dirPath);
     void _wipeOldCaches();
 
     QGCCacheWorker *m_worker = nullptr;
-    bool m_prunning = false;
     bool m_cacheWasReset = false;
     QString m_cachePath;
 };
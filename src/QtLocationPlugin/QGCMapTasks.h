@@ -21,6 +21,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 
 #include "QGCTile.h"
 #include "QGCCacheTile.h"
@@ -41,7 +42,6 @@ public:
         taskUpdateTileDownloadState,
         taskDeleteTileSet,
         taskRenameTileSet,
-        taskPruneCache,
         taskReset,
         taskExport,
         taskImport
@@ -210,22 +210,27 @@ class QGCUpdateTileDownloadStateTask : public QGCMapTask
     Q_OBJECT
 
 public:
+    /// @param hash "*" updates all tiles of the set
     QGCUpdateTileDownloadStateTask(quint64 setID, QGCTile::TileState state, const QString &hash, QObject *parent = nullptr)
+        : QGCUpdateTileDownloadStateTask(setID, state, QStringList(hash), parent)
+    {}
+    /// Updates all tiles in a single transaction
+    QGCUpdateTileDownloadStateTask(quint64 setID, QGCTile::TileState state, const QStringList &hashes, QObject *parent = nullptr)
         : QGCMapTask(QGCMapTask::taskUpdateTileDownloadState, parent)
         , m_setID(setID)
         , m_state(state)
-        , m_hash(hash)
+        , m_hashes(hashes)
     {}
     ~QGCUpdateTileDownloadStateTask() = default;
 
-    QString hash() const { return m_hash; }
+    const QStringList &hashes() const { return m_hashes; }
     quint64 setID() const { return m_setID; }
     QGCTile::TileState state() const { return m_state; }
 
 private:
     const quint64 m_setID = 0;
     const QGCTile::TileState m_state = QGCTile::StatePending;
-    const QString m_hash;
+    const QStringList m_hashes;
 };
 
 //-----------------------------------------------------------------------------
@@ -279,33 +284,6 @@ private:
 
 //-----------------------------------------------------------------------------
 
-class QGCPruneCacheTask : public QGCMapTask
-{
-    Q_OBJECT
-
-public:
-    explicit QGCPruneCacheTask(quint64 amount, QObject *parent = nullptr)
-        : QGCMapTask(QGCMapTask::taskPruneCache, parent)
-        , m_amount(amount)
-    {}
-    ~QGCPruneCacheTask() = default;
-
-    quint64 amount() const { return m_amount; }
-
-    void setPruned()
-    {
-        emit pruned();
-    }
-
-signals:
-    void pruned();
-
-private:
-    const quint64 m_amount = 0;
-};
-
-//-----------------------------------------------------------------------------
-
 class QGCResetTask : public QGCMapTask
 {
     Q_OBJECT
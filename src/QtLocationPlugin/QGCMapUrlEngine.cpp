@@ -21,6 +21,8 @@
 #include "EsriMapProvider.h"
 #include "MapboxMapProvider.h"
 #include "ElevationMapProvider.h"
+#include "LocalFileMapProvider.h"
+#include "VectorTileMapProvider.h"
 #include <QGCLoggingCategory.h>
 
 QGC_LOGGING_CATEGORY(QGCMapUrlEngineLog, "qgc.qtlocationplugin.qgcmapurlengine")
@@ -72,7 +74,11 @@ const QList<SharedMapProvider> UrlFactory::_providers = {
 
     std::make_shared<LINZBasemapMapProvider>(),
 
-    std::make_shared<CustomURLMapProvider>()
+    std::make_shared<CustomURLMapProvider>(),
+
+    std::make_shared<VectorTileCustomMapProvider>(),
+
+    std::make_shared<LocalFileMapProvider>()
 };
 
 QString UrlFactory::getImageFormat(int qtMapId, QByteArrayView image)
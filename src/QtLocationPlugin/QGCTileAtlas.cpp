@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileAtlas.h"
+#include "QGeoMapReplyQGC.h"
+#include "QGeoTileFetcherQGC.h"
+
+#include <QGCLoggingCategory.h>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtGui/QPainter>
+#include <QtLocation/private/qgeotilespec_p.h>
+#include <QtNetwork/QNetworkAccessManager>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(QGCTileAtlasLog, "qgc.qtlocationplugin.qgctileatlas")
+
+QGCTileAtlas::QGCTileAtlas(int mapId, int zoom, const QRect &tiles, QImage::Format format, QObject *parent)
+    : QObject(parent)
+    , _mapId(mapId)
+    , _zoom(zoom)
+    , _tiles(tiles.normalized())
+    , _atlas(_tiles.width() * kTileSize, _tiles.height() * kTileSize, format)
+    , _networkManager(new QNetworkAccessManager(this))
+{
+    // qCDebug(QGCTileAtlasLog) << Q_FUNC_INFO << this;
+
+    _atlas.fill(Qt::gray);
+
+    (void) connect(&_decodeWatcher, &QFutureWatcher<QList<DecodedTile_t>>::finished, this, &QGCTileAtlas::_tilesDecoded);
+}
+
+QGCTileAtlas::~QGCTileAtlas()
+{
+    // Replies go before the network manager their downloads belong to
+    qDeleteAll(_pendingReplies);
+    _pendingReplies.clear();
+
+    // qCDebug(QGCTileAtlasLog) << Q_FUNC_INFO << this;
+}
+
+void QGCTileAtlas::start()
+{
+    qCDebug(QGCTileAtlasLog) << "Fetching" << tileCount() << "tiles at zoom" << _zoom;
+
+    // The center of the block is what is looked at first, so it is requested first
+    QList<QPoint> tiles;
+    tiles.reserve(tileCount());
+    for (int x = _tiles.left(); x <= _tiles.right(); x++) {
+        for (int y = _tiles.top(); y <= _tiles.bottom(); y++) {
+            tiles.append(QPoint(x, y));
+        }
+    }
+    const QPointF center = QRectF(_tiles).center() - QPointF(0.5, 0.5);
+    std::stable_sort(tiles.begin(), tiles.end(), [center](const QPoint &a, const QPoint &b) {
+        const QPointF da = QPointF(a) - center;
+        const QPointF db = QPointF(b) - center;
+        return QPointF::dotProduct(da, da) < QPointF::dotProduct(db, db);
+    });
+
+    for (const QPoint &tile : tiles) {
+        QGeoTileSpec spec;
+        spec.setX(tile.x());
+        spec.setY(tile.y());
+        spec.setZoom(_zoom);
+        spec.setMapId(_mapId);
+
+        const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(_mapId, tile.x(), tile.y(), _zoom);
+        QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
+        if (reply->isFinished()) {
+            // Served from memory or failed in the constructor, before finished could be connected
+            _tileFinished(reply);
+        } else {
+            _pendingReplies.append(reply);
+            (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, [this, reply]() {
+                (void) _pendingReplies.removeOne(reply);
+                _tileFinished(reply);
+            });
+        }
+    }
+}
+
+void QGCTileAtlas::_tileFinished(QGeoTiledMapReplyQGC *reply)
+{
+    reply->deleteLater();
+
+    if (reply->error() != QGeoTiledMapReplyQGC::NoError) {
+        _failedCount++;
+        if (reply->tileUnavailable()) {
+            _unavailableCount++;
+        }
+    } else if (reply->mapImageData().isEmpty()) {
+        // Canceled
+        _failedCount++;
+    } else {
+        _encodedTiles.append({ QPoint(reply->tileSpec().x(), reply->tileSpec().y()), reply->mapImageData(), reply->mapImageFormat().toLatin1() });
+        _decodeTiles();
+    }
+
+    _doneCount++;
+    emit progress(100.f * static_cast<float>(_doneCount) / static_cast<float>(tileCount()));
+
+    _checkFinished();
+}
+
+/// Decodes the tiles received so far in the background, tiles which come in meanwhile go with the next batch
+void QGCTileAtlas::_decodeTiles()
+{
+    if (_decoding || _encodedTiles.isEmpty()) {
+        return;
+    }
+    _decoding = true;
+
+    const QList<EncodedTile_t> encodedTiles = std::move(_encodedTiles);
+    _encodedTiles.clear();
+    const QImage::Format format = _atlas.format();
+
+    _decodeWatcher.setFuture(QtConcurrent::run([encodedTiles, format]() {
+        QList<DecodedTile_t> decodedTiles;
+        decodedTiles.reserve(encodedTiles.count());
+        for (const EncodedTile_t &encodedTile : encodedTiles) {
+            QImage image = QImage::fromData(encodedTile.data, encodedTile.format.constData());
+            if (!image.isNull()) {
+                if (image.size() != QSize(kTileSize, kTileSize)) {
+                    image = image.scaled(kTileSize, kTileSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+                }
+                image.convertTo(format);
+            }
+            decodedTiles.append({ encodedTile.tile, image });
+        }
+        return decodedTiles;
+    }));
+}
+
+void QGCTileAtlas::_tilesDecoded()
+{
+    const QList<DecodedTile_t> decodedTiles = _decodeWatcher.result();
+    _decoding = false;
+
+    // Same size and format, so this is a plain copy
+    QPainter painter(&_atlas);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const DecodedTile_t &decodedTile : decodedTiles) {
+        if (decodedTile.image.isNull()) {
+            qCWarning(QGCTileAtlasLog) << "Failed to decode tile" << decodedTile.tile.x() << decodedTile.tile.y() << _zoom;
+            _failedCount++;
+            continue;
+        }
+
+        const QPoint target((decodedTile.tile.x() - _tiles.left()) * kTileSize, (decodedTile.tile.y() - _tiles.top()) * kTileSize);
+        painter.drawImage(target, decodedTile.image);
+    }
+    painter.end();
+
+    _decodeTiles();
+    _checkFinished();
+}
+
+void QGCTileAtlas::_checkFinished()
+{
+    if ((_doneCount == tileCount()) && _encodedTiles.isEmpty() && !_decoding) {
+        qCDebug(QGCTileAtlasLog) << "Fetched" << (tileCount() - _failedCount) << "of" << tileCount() << "tiles at zoom" << _zoom;
+        (void) QMetaObject::invokeMethod(this, &QGCTileAtlas::finished, Qt::QueuedConnection);
+    }
+}
@@ -0,0 +1,91 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QRect>
+#include <QtGui/QImage>
+
+Q_DECLARE_LOGGING_CATEGORY(QGCTileAtlasLog)
+
+class QGeoTiledMapReplyQGC;
+class QNetworkAccessManager;
+
+/// Fetches a block of map tiles and stitches them into a single image. Tiles go through the same path as the tiles
+/// of the 2D map: the in memory cache, the tile cache database and then the network, with downloaded tiles saved
+/// to both caches. Tiles are requested from the center of the block outwards and decoded on a worker thread.
+class QGCTileAtlas : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param mapId Qt map id of the provider
+    /// @param tiles Tile coordinates to fetch, inclusive
+    /// @param format Pixel format of the atlas image
+    QGCTileAtlas(int mapId, int zoom, const QRect &tiles, QImage::Format format = QImage::Format_RGBA8888, QObject *parent = nullptr);
+    ~QGCTileAtlas();
+
+    /// Requests all tiles. finished() is always emitted from the event loop, also if every tile was in memory, once
+    /// all tiles are painted into the atlas.
+    void start();
+
+    int mapId() const { return _mapId; }
+    int zoom() const { return _zoom; }
+    const QRect &tiles() const { return _tiles; }
+
+    /// @return The stitched tiles, missing tiles are left gray
+    const QImage &atlas() const { return _atlas; }
+
+    int tileCount() const { return _tiles.width() * _tiles.height(); }
+    int failedCount() const { return _failedCount; }
+
+    /// @return Number of tiles the provider does not have at this zoom level
+    int unavailableCount() const { return _unavailableCount; }
+
+    static constexpr int kTileSize = 256;
+
+signals:
+    /// @param percent Share of the tiles which are done, downloaded or not
+    void progress(float percent);
+    void finished();
+
+private:
+    struct EncodedTile_t {
+        QPoint tile;
+        QByteArray data;
+        QByteArray format;
+    };
+
+    struct DecodedTile_t {
+        QPoint tile;
+        QImage image;           ///< kTileSize square in the atlas format, null if decoding failed
+    };
+
+    void _tileFinished(QGeoTiledMapReplyQGC *reply);
+    void _decodeTiles();
+    void _tilesDecoded();
+    void _checkFinished();
+
+    const int _mapId;
+    const int _zoom;
+    const QRect _tiles;
+    QImage _atlas;
+    QNetworkAccessManager *_networkManager = nullptr;
+    QList<QGeoTiledMapReplyQGC*> _pendingReplies;
+    QList<EncodedTile_t> _encodedTiles;                     ///< Waiting for the decode running in the background
+    QFutureWatcher<QList<DecodedTile_t>> _decodeWatcher;
+    bool _decoding = false;                                 ///< Until the decoded tiles are painted
+    int _doneCount = 0;
+    int _failedCount = 0;
+    int _unavailableCount = 0;
+};
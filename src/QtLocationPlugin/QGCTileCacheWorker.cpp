@@ -20,12 +20,15 @@
 #include "QGCCachedTileSet.h"
 #include "QGCMapTasks.h"
 #include "QGCMapUrlEngine.h"
+#include "QGCTilePack.h"
 #include "QGCLoggingCategory.h"
+#include "QGCTrace.h"
 
 #include <QtCore/QDateTime>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QFile>
 #include <QtCore/QSettings>
+#include <QtCore/QThreadPool>
 #include <QtSql/QSqlDatabase>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
@@ -42,6 +45,7 @@ QGCCacheWorker::QGCCacheWorker(QObject* parent)
 
 QGCCacheWorker::~QGCCacheWorker()
 {
+    _suspendReadPool();
     // qCDebug(QGCTileCacheWorkerLog) << Q_FUNC_INFO << this;
 }
 
@@ -49,6 +53,7 @@ void QGCCacheWorker::stop()
 {
     QMutexLocker lock(&_taskQueueMutex);
     qDeleteAll(_taskQueue);
+    _stopRequested = true;
     lock.unlock();
 
     if(this->isRunning()) {
@@ -64,6 +69,10 @@ bool QGCCacheWorker::enqueueTask(QGCMapTask *task)
         return false;
     }
 
+    if (_startReadTask(task)) {
+        return true;
+    }
+
     // TODO: Prepend Stop Task Instead?
     QMutexLocker lock(&_taskQueueMutex);
     _taskQueue.enqueue(task);
@@ -118,7 +127,27 @@ QGCCacheWorker::run()
                     lock.relock();
                 }
             }
+        } else if (_pendingTileSaves > 0) {
+            // Give further tiles the chance to join the open transaction before committing it
+            (void) _waitc.wait(lock.mutex(), kTileBatchMsecs);
+            if (_taskQueue.isEmpty()) {
+                lock.unlock();
+                _commitTileSaves();
+                lock.relock();
+            }
+        } else if (_pruning && _valid && !_stopRequested) {
+            // Prune in small batches while idle, so queued tasks only ever wait for one batch
+            lock.unlock();
+            _pruneBatch();
+            lock.relock();
         } else {
+            lock.unlock();
+            _flushTouchedTiles();
+            lock.relock();
+            if (!_taskQueue.isEmpty()) {
+                continue;
+            }
+
             (void) _waitc.wait(lock.mutex(), 5000);
             if (_taskQueue.isEmpty()) {
                 break;
@@ -132,6 +161,13 @@ QGCCacheWorker::run()
 
 void QGCCacheWorker::_runTask(QGCMapTask *task)
 {
+    QGC_TRACE_SCOPE("QGCCacheWorker::_runTask");
+
+    if (task->type() != QGCMapTask::taskCacheTile) {
+        // Everything else expects to see the saved tiles
+        _commitTileSaves();
+    }
+
     switch (task->type()) {
     case QGCMapTask::taskInit:
         break;
@@ -159,9 +195,6 @@ void QGCCacheWorker::_runTask(QGCMapTask *task)
     case QGCMapTask::taskRenameTileSet:
         _renameTileSet(task);
         break;
-    case QGCMapTask::taskPruneCache:
-        _pruneCache(task);
-        break;
     case QGCMapTask::taskReset:
         _resetCacheDatabase(task);
         break;
@@ -257,6 +290,11 @@ QGCCacheWorker::_saveTile(QGCMapTask *mtask)
 {
     if(_valid) {
         QGCSaveTileTask* task = static_cast<QGCSaveTileTask*>(mtask);
+        if (_concurrentAccess && !_tileBatchTimer.isValid()) {
+            if (_db->transaction()) {
+                _tileBatchTimer.start();
+            }
+        }
         QSqlQuery query(*_db);
         query.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
         query.addBindValue(task->tile()->hash());
@@ -278,6 +316,11 @@ QGCCacheWorker::_saveTile(QGCMapTask *mtask)
             //-- Tile was already there.
             //   QtLocation some times requests the same tile twice in a row. The first is saved, the second is already there.
         }
+        if (_tileBatchTimer.isValid()) {
+            if ((++_pendingTileSaves >= kTileBatchSize) || _tileBatchTimer.hasExpired(kTileBatchMsecs)) {
+                _commitTileSaves();
+            }
+        }
     } else {
         qWarning() << "Map Cache SQL error (saveTile() open db):" << _db->lastError();
     }
@@ -286,13 +329,20 @@ QGCCacheWorker::_saveTile(QGCMapTask *mtask)
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_getTile(QGCMapTask* mtask)
+{
+    _fetchTile(*_db, mtask);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_fetchTile(QSqlDatabase &db, QGCMapTask* mtask)
 {
     if(!_testTask(mtask)) {
         return;
     }
     bool found = false;
     QGCFetchTileTask* task = static_cast<QGCFetchTileTask*>(mtask);
-    QSqlQuery query(*_db);
+    QSqlQuery query(db);
     QString s = QString("SELECT tile, format, type FROM Tiles WHERE hash = \"%1\"").arg(task->hash());
     if(query.exec(s)) {
         if(query.next()) {
@@ -302,6 +352,7 @@ QGCCacheWorker::_getTile(QGCMapTask* mtask)
             qCDebug(QGCTileCacheWorkerLog) << "_getTile() (Found in DB) HASH:" << task->hash();
             QGCCacheTile* tile = new QGCCacheTile(task->hash(), arrray, format, type);
             task->setTileFetched(tile);
+            _touchTile(task->hash());
             found = true;
         }
     }
@@ -360,47 +411,36 @@ QGCCacheWorker::_updateSetTotals(QGCCachedTileSet* set)
         set->setTotalTileSize(_defaultSize);
         return;
     }
-    QSqlQuery subquery(*_db);
-    QString sq = QString("SELECT COUNT(size), SUM(size) FROM Tiles A INNER JOIN SetTiles B on A.tileID = B.tileID WHERE B.setID = %1").arg(set->id());
-    qCDebug(QGCTileCacheWorkerLog) << "_updateSetTotals(): " << sq;
-    if(subquery.exec(sq)) {
-        if(subquery.next()) {
-            set->setSavedTileCount(subquery.value(0).toUInt());
-            set->setSavedTileSize(subquery.value(1).toULongLong());
-            qCDebug(QGCTileCacheWorkerLog) << "Set" << set->id() << "Totals:" << set->savedTileCount() << " " << set->savedTileSize() << "Expected: " << set->totalTileCount() << " " << set->totalTilesSize();
-            //-- Update (estimated) size
-            quint64 avg = UrlFactory::averageSizeForType(set->type());
-            if(set->totalTileCount() <= set->savedTileCount()) {
-                //-- We're done so the saved size is the total size
-                set->setTotalTileSize(set->savedTileSize());
-            } else {
-                //-- Otherwise we need to estimate it.
-                if(set->savedTileCount() > 10 && set->savedTileSize()) {
-                    avg = set->savedTileSize() / set->savedTileCount();
-                }
-                set->setTotalTileSize(avg * set->totalTileCount());
-            }
-            //-- Now figure out the count for tiles unique to this set
-            quint32 ucount = 0;
-            quint64 usize  = 0;
-            sq = QString("SELECT COUNT(size), SUM(size) FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1)").arg(set->id());
-            if(subquery.exec(sq)) {
-                if(subquery.next()) {
-                    //-- This is only accurate when all tiles are downloaded
-                    ucount = subquery.value(0).toUInt();
-                    usize  = subquery.value(1).toULongLong();
-                }
-            }
-            //-- If we haven't downloaded it all, estimate size of unique tiles
-            quint32 expectedUcount = set->totalTileCount() - set->savedTileCount();
-            if(!ucount) {
-                usize = expectedUcount * avg;
-            } else {
-                expectedUcount = ucount;
+    TileStats_t stats;
+    if(_readTileStats(set->id(), stats)) {
+        set->setSavedTileCount(stats.tileCount);
+        set->setSavedTileSize(stats.tileSize);
+        qCDebug(QGCTileCacheWorkerLog) << "Set" << set->id() << "Totals:" << set->savedTileCount() << " " << set->savedTileSize() << "Expected: " << set->totalTileCount() << " " << set->totalTilesSize();
+        //-- Update (estimated) size
+        quint64 avg = UrlFactory::averageSizeForType(set->type());
+        if(set->totalTileCount() <= set->savedTileCount()) {
+            //-- We're done so the saved size is the total size
+            set->setTotalTileSize(set->savedTileSize());
+        } else {
+            //-- Otherwise we need to estimate it.
+            if(set->savedTileCount() > 10 && set->savedTileSize()) {
+                avg = set->savedTileSize() / set->savedTileCount();
             }
-            set->setUniqueTileCount(expectedUcount);
-            set->setUniqueTileSize(usize);
+            set->setTotalTileSize(avg * set->totalTileCount());
+        }
+        //-- Now figure out the count for tiles unique to this set
+        //   This is only accurate when all tiles are downloaded
+        quint32 ucount = stats.uniqueCount;
+        quint64 usize  = stats.uniqueSize;
+        //-- If we haven't downloaded it all, estimate size of unique tiles
+        quint32 expectedUcount = set->totalTileCount() - set->savedTileCount();
+        if(!ucount) {
+            usize = expectedUcount * avg;
+        } else {
+            expectedUcount = ucount;
         }
+        set->setUniqueTileCount(expectedUcount);
+        set->setUniqueTileSize(usize);
     }
 }
 
@@ -408,23 +448,20 @@ QGCCacheWorker::_updateSetTotals(QGCCachedTileSet* set)
 void
 QGCCacheWorker::_updateTotals()
 {
-    QSqlQuery query(*_db);
-    QString s;
-    s = QString("SELECT COUNT(size), SUM(size) FROM Tiles");
-    qCDebug(QGCTileCacheWorkerLog) << "_updateTotals(): " << s;
-    if(query.exec(s)) {
-        if(query.next()) {
-            _totalCount = query.value(0).toUInt();
-            _totalSize  = query.value(1).toULongLong();
-        }
+    //-- Kept up to date by the TileStats triggers, so this is a lookup rather than a scan of the cache
+    TileStats_t stats;
+    if(_readTileStats(0, stats)) {
+        _totalCount = stats.tileCount;
+        _totalSize  = stats.tileSize;
     }
-    s = QString("SELECT COUNT(size), SUM(size) FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1)").arg(_getDefaultTileSet());
-    qCDebug(QGCTileCacheWorkerLog) << "_updateTotals(): " << s;
-    if(query.exec(s)) {
-        if(query.next()) {
-            _defaultCount = query.value(0).toUInt();
-            _defaultSize  = query.value(1).toULongLong();
-        }
+    if(_readTileStats(_getDefaultTileSet(), stats)) {
+        _defaultCount = stats.uniqueCount;
+        _defaultSize  = stats.uniqueSize;
+    }
+    const quint64 maxDiskCache = _maxDiskCache;
+    if(!_pruning && (maxDiskCache > 0) && (_defaultSize > maxDiskCache)) {
+        qCDebug(QGCTileCacheWorkerLog) << "_updateTotals() default set exceeds cache limit, pruning" << _defaultSize << maxDiskCache;
+        _pruning = true;
     }
     emit updateTotals(_totalCount, _totalSize, _defaultCount, _defaultSize);
     if (!_updateTimer.isValid()) {
@@ -549,12 +586,17 @@ QGCCacheWorker::_getTileDownloadList(QGCMapTask* mtask)
             tile->setZ(query.value("z").toInt());
             tiles.enqueue(tile);
         }
+        (void) _db->transaction();
+        query.prepare("UPDATE TilesDownload SET state = ? WHERE setID = ? and hash = ?");
         for(int i = 0; i < tiles.size(); i++) {
-            s = QString("UPDATE TilesDownload SET state = %1 WHERE setID = %2 and hash = \"%3\"").arg(static_cast<int>(QGCTile::StateDownloading)).arg(task->setID()).arg(tiles[i]->hash());
-            if(!query.exec(s)) {
+            query.addBindValue(static_cast<int>(QGCTile::StateDownloading));
+            query.addBindValue(task->setID());
+            query.addBindValue(tiles[i]->hash());
+            if(!query.exec()) {
                 qWarning() << "Map Cache SQL error (set TilesDownload state):" << query.lastError().text();
             }
         }
+        (void) _db->commit();
     }
     task->setTileListFetched(tiles);
 }
@@ -568,49 +610,128 @@ QGCCacheWorker::_updateTileDownloadState(QGCMapTask* mtask)
     }
     QGCUpdateTileDownloadStateTask* task = static_cast<QGCUpdateTileDownloadStateTask*>(mtask);
     QSqlQuery query(*_db);
-    QString s;
+    if((task->state() != QGCTile::StateComplete) && (task->hashes() == QStringList(QStringLiteral("*")))) {
+        const QString s = QString("UPDATE TilesDownload SET state = %1 WHERE setID = %2").arg(static_cast<int>(task->state())).arg(task->setID());
+        if(!query.exec(s)) {
+            qWarning() << "QGCCacheWorker::_updateTileDownloadState() Error:" << query.lastError().text();
+        }
+        return;
+    }
+    //-- A batch of tiles is a single transaction
+    (void) _db->transaction();
     if(task->state() == QGCTile::StateComplete) {
-        s = QString("DELETE FROM TilesDownload WHERE setID = %1 AND hash = \"%2\"").arg(task->setID()).arg(task->hash());
+        query.prepare("DELETE FROM TilesDownload WHERE setID = ? AND hash = ?");
     } else {
-        if(task->hash() == "*") {
-            s = QString("UPDATE TilesDownload SET state = %1 WHERE setID = %2").arg(static_cast<int>(task->state())).arg(task->setID());
-        } else {
-            s = QString("UPDATE TilesDownload SET state = %1 WHERE setID = %2 AND hash = \"%3\"").arg(static_cast<int>(task->state())).arg(task->setID()).arg(task->hash());
-        }
+        query.prepare("UPDATE TilesDownload SET state = ? WHERE setID = ? AND hash = ?");
     }
-    if(!query.exec(s)) {
-        qWarning() << "QGCCacheWorker::_updateTileDownloadState() Error:" << query.lastError().text();
+    for(const QString &hash : task->hashes()) {
+        if(task->state() != QGCTile::StateComplete) {
+            query.addBindValue(static_cast<int>(task->state()));
+        }
+        query.addBindValue(task->setID());
+        query.addBindValue(hash);
+        if(!query.exec()) {
+            qWarning() << "QGCCacheWorker::_updateTileDownloadState() Error:" << query.lastError().text();
+        }
     }
+    (void) _db->commit();
 }
 
 //-----------------------------------------------------------------------------
 void
-QGCCacheWorker::_pruneCache(QGCMapTask* mtask)
+QGCCacheWorker::_pruneBatch()
 {
-    if(!_testTask(mtask)) {
+    _commitTileSaves();
+    _flushTouchedTiles();
+
+    //-- Prune down to the low watermark once the limit was exceeded, so pruning doesn't restart with every new tile
+    const quint64 maxDiskCache = _maxDiskCache;
+    const quint64 lowWatermark = maxDiskCache / 100 * kPruneLowWatermarkPercent;
+    TileStats_t stats;
+    if((maxDiskCache == 0) || !_readTileStats(_getDefaultTileSet(), stats) || (stats.uniqueSize <= lowWatermark)) {
+        qCDebug(QGCTileCacheWorkerLog) << "_pruneBatch() done";
+        _pruning = false;
+        _updateTotals();
         return;
     }
-    QGCPruneCacheTask* task = static_cast<QGCPruneCacheTask*>(mtask);
+
+    //-- Least recently used tiles which are only in the default set. Start from the default set's tiles rather than
+    //   walking the date index, so tiles kept by offline sets are never visited.
+    const quint64 defaultSetID = _getDefaultTileSet();
+    QList<quint64> tileIDs;
     QSqlQuery query(*_db);
-    QString s;
-    //-- Select tiles in default set only, sorted by oldest.
-    s = QString("SELECT tileID, size, hash FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1) ORDER BY DATE ASC LIMIT 128").arg(_getDefaultTileSet());
-    qint64 amount = (qint64)task->amount();
-    QList<quint64> tlist;
-    if(query.exec(s)) {
-        while(query.next() && amount >= 0) {
-            tlist << query.value(0).toULongLong();
-            amount -= query.value(1).toULongLong();
-            qCDebug(QGCTileCacheWorkerLog) << "_pruneCache() HASH:" << query.value(2).toString();
+    query.setForwardOnly(true);
+    query.prepare("SELECT A.tileID FROM SetTiles B JOIN Tiles A ON A.tileID = B.tileID WHERE B.setID = ? "
+                  "AND NOT EXISTS (SELECT 1 FROM SetTiles C WHERE C.tileID = B.tileID AND C.setID != ?) "
+                  "ORDER BY A.date ASC LIMIT ?");
+    query.addBindValue(defaultSetID);
+    query.addBindValue(defaultSetID);
+    query.addBindValue(kPruneBatchSize);
+    if(query.exec()) {
+        while(query.next()) {
+            tileIDs.append(query.value(0).toULongLong());
         }
-        while(tlist.count()) {
-            s = QString("DELETE FROM Tiles WHERE tileID = %1").arg(tlist[0]);
-            tlist.removeFirst();
-            if(!query.exec(s))
-                break;
+    } else {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (find tiles to prune):" << query.lastError().text();
+    }
+    query.finish();
+
+    if(tileIDs.isEmpty() || !_db->transaction()) {
+        _pruning = false;
+        _updateTotals();
+        return;
+    }
+    query.prepare("DELETE FROM Tiles WHERE tileID = ?");
+    for(const quint64 tileID : std::as_const(tileIDs)) {
+        query.addBindValue(tileID);
+        if(!query.exec()) {
+            //-- Stop pruning, otherwise the worker would retry the same failing batch forever
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (prune tile):" << query.lastError().text();
+            (void) _db->rollback();
+            _pruning = false;
+            _updateTotals();
+            return;
         }
-        task->setPruned();
     }
+    (void) _db->commit();
+    qCDebug(QGCTileCacheWorkerLog) << "_pruneBatch() deleted" << tileIDs.count() << "tiles";
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_touchTile(const QString &hash)
+{
+    QMutexLocker lock(&_touchedTilesMutex);
+    (void) _touchedTiles.insert(hash);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_flushTouchedTiles()
+{
+    QSet<QString> hashes;
+    {
+        QMutexLocker lock(&_touchedTilesMutex);
+        hashes.swap(_touchedTiles);
+    }
+    if(hashes.isEmpty() || !_valid || !_db) {
+        return;
+    }
+
+    //-- The date orders tiles for pruning, so it is moved up for each tile which is displayed
+    _commitTileSaves();
+    if(!_db->transaction()) {
+        return;
+    }
+    QSqlQuery query(*_db);
+    query.prepare("UPDATE Tiles SET date = ? WHERE hash = ?");
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    for(const QString &hash : std::as_const(hashes)) {
+        query.addBindValue(now);
+        query.addBindValue(hash);
+        (void) query.exec();
+    }
+    (void) _db->commit();
 }
 
 //-----------------------------------------------------------------------------
@@ -667,6 +788,14 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
         return;
     }
     QGCResetTask* task = static_cast<QGCResetTask*>(mtask);
+    _resetDB();
+    task->setResetCompleted();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_resetDB()
+{
     QSqlQuery query(*_db);
     QString s;
     s = QString("DROP TABLE Tiles");
@@ -677,8 +806,10 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
     query.exec(s);
     s = QString("DROP TABLE TilesDownload");
     query.exec(s);
+    s = QString("DROP TABLE TileStats");
+    query.exec(s);
+    _defaultSet = UINT64_MAX;
     _valid = _createDB(*_db);
-    task->setResetCompleted();
 }
 
 //-----------------------------------------------------------------------------
@@ -689,9 +820,15 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
         return;
     }
     QGCImportTileTask* task = static_cast<QGCImportTileTask*>(mtask);
+    if(task->path().endsWith(QStringLiteral(".") + QGCTilePack::fileExtension, Qt::CaseInsensitive)) {
+        _importTilePack(task);
+        task->setImportCompleted();
+        return;
+    }
     //-- If replacing, simply copy over it
     if(task->replace()) {
         //-- Close and delete old database
+        _suspendReadPool();
         _disconnectDB();
         QFile file(_databasePath);
         file.remove();
@@ -703,6 +840,7 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
             task->setProgress(50);
             _connectDB();
         }
+        _resumeReadPool();
         task->setProgress(100);
     } else {
         //-- Open imported set
@@ -740,49 +878,16 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                         int     type            = query.value("type").toInt();
                         quint32 numTiles        = query.value("numTiles").toUInt();
                         int     defaultSet      = query.value("defaultSet").toInt();
-                        quint64 insertSetID     = _getDefaultTileSet();
-                        //-- If not default set, create new one
-                        if(!defaultSet) {
-                            //-- Check if we have this tile set already
-                            if(_findTileSetID(name, insertSetID)) {
-                                int testCount = 0;
-                                //-- Set with this name already exists. Make name unique.
-                                while (true) {
-                                    auto testName = QString::asprintf("%s %02d", name.toLatin1().data(), ++testCount);
-                                    if(!_findTileSetID(testName, insertSetID) || testCount > 99) {
-                                        name = testName;
-                                        break;
-                                    }
-                                }
-                            }
-                            //-- Create new set
-                            QSqlQuery cQuery(*_db);
-                            cQuery.prepare("INSERT INTO TileSets("
-                                "name, typeStr, topleftLat, topleftLon, bottomRightLat, bottomRightLon, minZoom, maxZoom, type, numTiles, defaultSet, date"
-                                ") VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-                            cQuery.addBindValue(name);
-                            cQuery.addBindValue(mapType);
-                            cQuery.addBindValue(topleftLat);
-                            cQuery.addBindValue(topleftLon);
-                            cQuery.addBindValue(bottomRightLat);
-                            cQuery.addBindValue(bottomRightLon);
-                            cQuery.addBindValue(minZoom);
-                            cQuery.addBindValue(maxZoom);
-                            cQuery.addBindValue(type);
-                            cQuery.addBindValue(numTiles);
-                            cQuery.addBindValue(defaultSet);
-                            cQuery.addBindValue(QDateTime::currentDateTime().toSecsSinceEpoch());
-                            if(!cQuery.exec()) {
-                                task->setError("Error adding imported tile set to database");
-                                break;
-                            } else {
-                                //-- Get just created (auto-incremented) setID
-                                insertSetID = cQuery.lastInsertId().toULongLong();
-                            }
+                        quint64 insertSetID     = 0;
+                        const QGCTilePack::TileSet_t tileSet{name, mapType, topleftLat, topleftLon, bottomRightLat, bottomRightLon, minZoom, maxZoom, type, numTiles, defaultSet != 0};
+                        if(!_insertImportedTileSet(tileSet, insertSetID)) {
+                            task->setError("Error adding imported tile set to database");
+                            break;
                         }
                         //-- Find set tiles
                         QSqlQuery cQuery(*_db);
                         QSqlQuery subQuery(*dbImport);
+                        subQuery.setForwardOnly(true);
                         QString sb = QString("SELECT * FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = %1 GROUP BY A.tileID HAVING COUNT(A.tileID) = 1)").arg(setID);
                         if(subQuery.exec(sb)) {
                             quint64 tilesFound = 0;
@@ -822,13 +927,10 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                             _db->commit();
                             if(tilesSaved) {
                                 //-- Update tile count (if any added)
-                                s = QString("SELECT COUNT(size) FROM Tiles A INNER JOIN SetTiles B on A.tileID = B.tileID WHERE B.setID = %1").arg(insertSetID);
-                                if(cQuery.exec(s)) {
-                                    if(cQuery.next()) {
-                                        quint64 count  = cQuery.value(0).toULongLong();
-                                        s = QString("UPDATE TileSets SET numTiles = %1 WHERE setID = %2").arg(count).arg(insertSetID);
-                                        cQuery.exec(s);
-                                    }
+                                TileStats_t stats;
+                                if(_readTileStats(insertSetID, stats)) {
+                                    s = QString("UPDATE TileSets SET numTiles = %1 WHERE setID = %2").arg(stats.tileCount).arg(insertSetID);
+                                    cQuery.exec(s);
                                 }
                             }
                             qint64 uniqueTiles = tilesFound - tilesSaved;
@@ -868,6 +970,11 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
         return;
     }
     QGCExportTileTask* task = static_cast<QGCExportTileTask*>(mtask);
+    if(task->path().endsWith(QStringLiteral(".") + QGCTilePack::fileExtension, Qt::CaseInsensitive)) {
+        _exportTilePack(task);
+        task->setExportCompleted();
+        return;
+    }
     //-- Delete target if it exists
     QFile file(task->path());
     file.remove();
@@ -921,6 +1028,7 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
                     //-- Find set tiles
                     QString s = QString("SELECT * FROM SetTiles WHERE setID = %1").arg(set->id());
                     QSqlQuery query(*_db);
+                    query.setForwardOnly(true);
                     if(query.exec(s)) {
                         dbExport->transaction();
                         while(query.next()) {
@@ -969,6 +1077,211 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
     task->setExportCompleted();
 }
 
+//-----------------------------------------------------------------------------
+/// Creates the tile set for an import. Imported default sets go into the default set.
+///     @param[out] setID
+bool
+QGCCacheWorker::_insertImportedTileSet(const QGCTilePack::TileSet_t &tileSet, quint64 &setID)
+{
+    setID = _getDefaultTileSet();
+    if(tileSet.defaultSet) {
+        return true;
+    }
+    QString name = tileSet.name;
+    //-- Check if we have this tile set already
+    if(_findTileSetID(name, setID)) {
+        int testCount = 0;
+        //-- Set with this name already exists. Make name unique.
+        while (true) {
+            auto testName = QString::asprintf("%s %02d", name.toLatin1().data(), ++testCount);
+            if(!_findTileSetID(testName, setID) || testCount > 99) {
+                name = testName;
+                break;
+            }
+        }
+    }
+    //-- Create new set
+    QSqlQuery query(*_db);
+    query.prepare("INSERT INTO TileSets("
+        "name, typeStr, topleftLat, topleftLon, bottomRightLat, bottomRightLon, minZoom, maxZoom, type, numTiles, defaultSet, date"
+        ") VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    query.addBindValue(name);
+    query.addBindValue(tileSet.mapTypeStr);
+    query.addBindValue(tileSet.topleftLat);
+    query.addBindValue(tileSet.topleftLon);
+    query.addBindValue(tileSet.bottomRightLat);
+    query.addBindValue(tileSet.bottomRightLon);
+    query.addBindValue(tileSet.minZoom);
+    query.addBindValue(tileSet.maxZoom);
+    query.addBindValue(tileSet.type);
+    query.addBindValue(tileSet.numTiles);
+    query.addBindValue(0);
+    query.addBindValue(QDateTime::currentDateTime().toSecsSinceEpoch());
+    if(!query.exec()) {
+        return false;
+    }
+    //-- Get just created (auto-incremented) setID
+    setID = query.lastInsertId().toULongLong();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/// Streams the sets into a tile pack, holding only a chunk of tiles in memory at a time
+void
+QGCCacheWorker::_exportTilePack(QGCExportTileTask *task)
+{
+    QGCTilePackWriter writer;
+    QString errorString;
+    if(!writer.open(task->path(), errorString)) {
+        task->setError(QStringLiteral("Error creating tile pack: %1").arg(errorString));
+        return;
+    }
+    //-- Prepare progress report
+    quint64 tileCount = 0;
+    for(const QGCCachedTileSet* set : task->sets()) {
+        //-- Default set has no unique tiles
+        tileCount += set->defaultSet() ? set->totalTileCount() : set->uniqueTileCount();
+    }
+    tileCount = qMax(tileCount, static_cast<quint64>(1));
+    quint64 currentCount = 0;
+    int lastProgress = -1;
+    QList<QGCTilePack::Tile_t> tiles;
+    tiles.reserve(kTilePackChunkSize);
+    //-- Pack the chunk and report progress
+    const auto addTiles = [&](int packSet) -> bool {
+        if(!writer.addTiles(tiles, packSet)) {
+            return false;
+        }
+        currentCount += static_cast<quint64>(tiles.count());
+        tiles.clear();
+        const int progress = static_cast<int>(qMin(currentCount, tileCount) * 100 / tileCount);
+        if(progress != lastProgress) {
+            lastProgress = progress;
+            task->setProgress(progress);
+        }
+        return true;
+    };
+    for(const QGCCachedTileSet* set : task->sets()) {
+        const QGCTilePack::TileSet_t tileSet{set->name(), set->mapTypeStr(), set->topleftLat(), set->topleftLon(), set->bottomRightLat(), set->bottomRightLon(),
+                                             set->minZoom(), set->maxZoom(), UrlFactory::getQtMapIdFromProviderType(set->type()), set->totalTileCount(), set->defaultSet()};
+        const int packSet = writer.addTileSet(tileSet);
+        QSqlQuery query(*_db);
+        query.setForwardOnly(true);
+        const QString s = QString("SELECT A.hash, A.format, A.tile, A.type FROM Tiles A INNER JOIN SetTiles B on A.tileID = B.tileID WHERE B.setID = %1").arg(set->id());
+        if(!query.exec(s)) {
+            task->setError("Error reading tile set for tile pack");
+            return;
+        }
+        while(query.next()) {
+            tiles.append({query.value(0).toString(), query.value(1).toString(), query.value(2).toByteArray(), query.value(3).toInt()});
+            if((tiles.count() >= kTilePackChunkSize) && !addTiles(packSet)) {
+                task->setError("Error writing tile pack");
+                return;
+            }
+        }
+        if(!addTiles(packSet)) {
+            task->setError("Error writing tile pack");
+            return;
+        }
+    }
+    if(!writer.commit(errorString)) {
+        task->setError(QStringLiteral("Error writing tile pack: %1").arg(errorString));
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Imports a tile pack straight from its mapping, committing a chunk of tiles per transaction
+void
+QGCCacheWorker::_importTilePack(QGCImportTileTask *task)
+{
+    QGCTilePack pack;
+    QString errorString;
+    if(!pack.open(task->path(), errorString)) {
+        task->setError(QStringLiteral("Error opening tile pack: %1").arg(errorString));
+        return;
+    }
+    if(task->replace()) {
+        _resetDB();
+    }
+    QList<quint64> setIDs;
+    for(const QGCTilePack::TileSet_t &tileSet : pack.tileSets()) {
+        quint64 setID = 0;
+        if(!_insertImportedTileSet(tileSet, setID)) {
+            task->setError("Error adding imported tile set to database");
+            return;
+        }
+        setIDs.append(setID);
+    }
+    QList<quint64> savedCounts(setIDs.count(), 0);
+    QSqlQuery tileQuery(*_db);
+    tileQuery.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
+    QSqlQuery setTileQuery(*_db);
+    setTileQuery.prepare("INSERT INTO SetTiles(tileID, setID) VALUES(?, ?)");
+    const qint64 date = QDateTime::currentDateTime().toSecsSinceEpoch();
+    int lastProgress = -1;
+    //-- A tile in several sets has adjacent index entries, one per set
+    QString importedHash;
+    quint64 importedTileID = 0;
+    (void) _db->transaction();
+    for(qsizetype i = 0; i < pack.tileCount(); i++) {
+        QGCTilePack::Tile_t tile;
+        int packSet = 0;
+        if(pack.tile(i, tile, packSet)) {
+            if(tile.hash != importedHash) {
+                importedHash = tile.hash;
+                importedTileID = 0;
+                tileQuery.addBindValue(tile.hash);
+                tileQuery.addBindValue(tile.format);
+                tileQuery.addBindValue(tile.img);
+                tileQuery.addBindValue(tile.img.size());
+                tileQuery.addBindValue(tile.type);
+                tileQuery.addBindValue(date);
+                //-- Tiles already in the cache fail the unique hash constraint and are skipped
+                if(tileQuery.exec()) {
+                    importedTileID = tileQuery.lastInsertId().toULongLong();
+                }
+            }
+            //-- Link the tile imported by this pack to each of its sets
+            if(importedTileID) {
+                setTileQuery.addBindValue(importedTileID);
+                setTileQuery.addBindValue(setIDs[packSet]);
+                (void) setTileQuery.exec();
+                savedCounts[packSet]++;
+            }
+        }
+        if(((i + 1) % kTilePackChunkSize) == 0) {
+            (void) _db->commit();
+            (void) _db->transaction();
+            const int progress = static_cast<int>((i + 1) * 100 / pack.tileCount());
+            if(progress != lastProgress) {
+                lastProgress = progress;
+                task->setProgress(progress);
+            }
+        }
+    }
+    (void) _db->commit();
+    quint64 totalSaved = 0;
+    for(qsizetype i = 0; i < setIDs.count(); i++) {
+        totalSaved += savedCounts[i];
+        if(savedCounts[i]) {
+            //-- Update tile count (if any added)
+            TileStats_t stats;
+            if(_readTileStats(setIDs[i], stats)) {
+                QSqlQuery query(*_db);
+                (void) query.exec(QString("UPDATE TileSets SET numTiles = %1 WHERE setID = %2").arg(stats.tileCount).arg(setIDs[i]));
+            }
+        } else if(!pack.tileSets()[i].defaultSet) {
+            //-- If there was nothing new in this set, remove it.
+            qCDebug(QGCTileCacheWorkerLog) << "No unique tiles in" << pack.tileSets()[i].name << "Removing it.";
+            _deleteTileSet(setIDs[i]);
+        }
+    }
+    if(!totalSaved) {
+        task->setError("No unique tiles in imported tile pack");
+    }
+    task->setProgress(100);
+}
+
 //-----------------------------------------------------------------------------
 bool QGCCacheWorker::_testTask(QGCMapTask* mtask)
 {
@@ -1012,6 +1325,18 @@ QGCCacheWorker::_connectDB()
     _db->setDatabaseName(_databasePath);
     _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
     _valid = _db->open();
+    if (_valid) {
+        QSqlQuery query(*_db);
+        if (_concurrentAccess) {
+            // WAL lets the read connections run alongside the open write transaction. NORMAL sync is safe in WAL mode,
+            // a power loss can only lose the last transactions which are cached tiles we can fetch again.
+            if (!query.exec("PRAGMA journal_mode=WAL") || !query.exec("PRAGMA synchronous=NORMAL")) {
+                qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (enable WAL):" << query.lastError().text();
+            }
+        } else {
+            (void) query.exec("PRAGMA journal_mode=DELETE");
+        }
+    }
     return _valid;
 }
 
@@ -1034,6 +1359,8 @@ QGCCacheWorker::_createDB(QSqlDatabase& db, bool createDefault)
         qWarning() << "Map Cache SQL error (create Tiles db):" << query.lastError().text();
     } else {
         query.exec("CREATE INDEX IF NOT EXISTS hash ON Tiles ( hash, size, type ) ");
+        //-- Least recently used order for pruning
+        query.exec("CREATE INDEX IF NOT EXISTS date ON Tiles ( date ) ");
              
         if(!query.exec(
             "CREATE TABLE IF NOT EXISTS TileSets ("
@@ -1096,6 +1423,9 @@ QGCCacheWorker::_createDB(QSqlDatabase& db, bool createDefault)
             qWarning() << "Map Cache SQL error (Looking for default tile set):" << db.lastError();
         }
     }
+    if(res && !_createTileStats(db)) {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (create TileStats):" << db.lastError();
+    }
     if(!res) {
         QFile file(_databasePath);
         file.remove();
@@ -1103,12 +1433,213 @@ QGCCacheWorker::_createDB(QSqlDatabase& db, bool createDefault)
     return res;
 }
 
+//-----------------------------------------------------------------------------
+bool
+QGCCacheWorker::_createTileStats(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+    // Finds the sets of a tile in the statistics triggers
+    (void) query.exec("CREATE INDEX IF NOT EXISTS SetTilesTileID ON SetTiles ( tileID )");
+    if(!query.exec(
+        "CREATE TABLE IF NOT EXISTS TileStats ("
+        "setID INTEGER PRIMARY KEY NOT NULL, "
+        "tileCount INTEGER DEFAULT 0, "
+        "tileSize INTEGER DEFAULT 0, "
+        "uniqueCount INTEGER DEFAULT 0, "
+        "uniqueSize INTEGER DEFAULT 0)"))
+    {
+        return false;
+    }
+    if(query.exec("SELECT setID FROM TileStats WHERE setID = 0") && query.next()) {
+        return true;
+    }
+
+    //-- First use of this database with statistics, count what is already there
+    qCDebug(QGCTileCacheWorkerLog) << "Building tile statistics";
+    if(!db.transaction()) {
+        return false;
+    }
+    const QStringList statements = {
+        // Tiles used to be deleted without their set entries
+        "DELETE FROM SetTiles WHERE tileID NOT IN (SELECT tileID FROM Tiles)",
+        "DELETE FROM TileStats",
+        // Set 0 holds the totals of all tiles
+        "INSERT INTO TileStats(setID, tileCount, tileSize) SELECT 0, COUNT(size), IFNULL(SUM(size), 0) FROM Tiles",
+        "INSERT INTO TileStats(setID) SELECT setID FROM TileSets",
+        "UPDATE TileStats SET "
+            "tileCount = (SELECT COUNT(A.size) FROM Tiles A INNER JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = TileStats.setID), "
+            "tileSize = (SELECT IFNULL(SUM(A.size), 0) FROM Tiles A INNER JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = TileStats.setID) "
+            "WHERE setID != 0",
+        "UPDATE TileStats SET "
+            "uniqueCount = (SELECT COUNT(A.size) FROM Tiles A INNER JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = TileStats.setID AND (SELECT COUNT(*) FROM SetTiles C WHERE C.tileID = B.tileID) = 1), "
+            "uniqueSize = (SELECT IFNULL(SUM(A.size), 0) FROM Tiles A INNER JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = TileStats.setID AND (SELECT COUNT(*) FROM SetTiles C WHERE C.tileID = B.tileID) = 1) "
+            "WHERE setID != 0",
+        //-- From here on the statistics are kept up to date in the same transaction as the change
+        "CREATE TRIGGER IF NOT EXISTS TileSetsInsertStats AFTER INSERT ON TileSets BEGIN "
+            "INSERT OR IGNORE INTO TileStats(setID) VALUES(NEW.setID); "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS TileSetsDeleteStats AFTER DELETE ON TileSets BEGIN "
+            "DELETE FROM TileStats WHERE setID = OLD.setID; "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS TilesInsertStats AFTER INSERT ON Tiles BEGIN "
+            "UPDATE TileStats SET tileCount = tileCount + 1, tileSize = tileSize + IFNULL(NEW.size, 0) WHERE setID = 0; "
+        "END",
+        // Before so the set entries still see the tile size
+        "CREATE TRIGGER IF NOT EXISTS TilesDeleteStats BEFORE DELETE ON Tiles BEGIN "
+            "DELETE FROM SetTiles WHERE tileID = OLD.tileID; "
+            "UPDATE TileStats SET tileCount = tileCount - 1, tileSize = tileSize - IFNULL(OLD.size, 0) WHERE setID = 0; "
+        "END",
+        // A tile is unique while it has a single set entry
+        "CREATE TRIGGER IF NOT EXISTS SetTilesInsertStats AFTER INSERT ON SetTiles BEGIN "
+            "UPDATE TileStats SET tileCount = tileCount + 1, tileSize = tileSize + IFNULL((SELECT size FROM Tiles WHERE tileID = NEW.tileID), 0) "
+                "WHERE setID = NEW.setID AND EXISTS (SELECT 1 FROM Tiles WHERE tileID = NEW.tileID); "
+            "UPDATE TileStats SET uniqueCount = uniqueCount + 1, uniqueSize = uniqueSize + IFNULL((SELECT size FROM Tiles WHERE tileID = NEW.tileID), 0) "
+                "WHERE setID = NEW.setID AND EXISTS (SELECT 1 FROM Tiles WHERE tileID = NEW.tileID) "
+                "AND (SELECT COUNT(*) FROM SetTiles WHERE tileID = NEW.tileID) = 1; "
+            "UPDATE TileStats SET uniqueCount = uniqueCount - 1, uniqueSize = uniqueSize - IFNULL((SELECT size FROM Tiles WHERE tileID = NEW.tileID), 0) "
+                "WHERE setID = (SELECT setID FROM SetTiles WHERE tileID = NEW.tileID AND rowid != NEW.rowid) AND EXISTS (SELECT 1 FROM Tiles WHERE tileID = NEW.tileID) "
+                "AND (SELECT COUNT(*) FROM SetTiles WHERE tileID = NEW.tileID) = 2; "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS SetTilesDeleteStats AFTER DELETE ON SetTiles BEGIN "
+            "UPDATE TileStats SET tileCount = tileCount - 1, tileSize = tileSize - IFNULL((SELECT size FROM Tiles WHERE tileID = OLD.tileID), 0) "
+                "WHERE setID = OLD.setID AND EXISTS (SELECT 1 FROM Tiles WHERE tileID = OLD.tileID); "
+            "UPDATE TileStats SET uniqueCount = uniqueCount - 1, uniqueSize = uniqueSize - IFNULL((SELECT size FROM Tiles WHERE tileID = OLD.tileID), 0) "
+                "WHERE setID = OLD.setID AND EXISTS (SELECT 1 FROM Tiles WHERE tileID = OLD.tileID) "
+                "AND (SELECT COUNT(*) FROM SetTiles WHERE tileID = OLD.tileID) = 0; "
+            "UPDATE TileStats SET uniqueCount = uniqueCount + 1, uniqueSize = uniqueSize + IFNULL((SELECT size FROM Tiles WHERE tileID = OLD.tileID), 0) "
+                "WHERE setID = (SELECT setID FROM SetTiles WHERE tileID = OLD.tileID) AND EXISTS (SELECT 1 FROM Tiles WHERE tileID = OLD.tileID) "
+                "AND (SELECT COUNT(*) FROM SetTiles WHERE tileID = OLD.tileID) = 1; "
+        "END"
+    };
+    for(const QString &statement : statements) {
+        if(!query.exec(statement)) {
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (tile statistics):" << query.lastError().text();
+            (void) db.rollback();
+            return false;
+        }
+    }
+    return db.commit();
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCCacheWorker::_readTileStats(quint64 setID, TileStats_t &stats)
+{
+    QSqlQuery query(*_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT tileCount, tileSize, uniqueCount, uniqueSize FROM TileStats WHERE setID = ?");
+    query.addBindValue(setID);
+    if(!query.exec() || !query.next()) {
+        return false;
+    }
+    stats.tileCount = query.value(0).toUInt();
+    stats.tileSize = query.value(1).toULongLong();
+    stats.uniqueCount = query.value(2).toUInt();
+    stats.uniqueSize = query.value(3).toULongLong();
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_disconnectDB()
 {
     if (_db) {
+        _flushTouchedTiles();
+        _commitTileSaves();
         _db.reset();
         QSqlDatabase::removeDatabase(kSession);
     }
 }
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_commitTileSaves()
+{
+    if (!_tileBatchTimer.isValid()) {
+        return;
+    }
+
+    if (!_db->commit()) {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (commit tiles):" << _db->lastError().text();
+    }
+    qCDebug(QGCTileCacheWorkerLog) << "_commitTileSaves() tiles:" << _pendingTileSaves << "msecs:" << _tileBatchTimer.elapsed();
+
+    _pendingTileSaves = 0;
+    _tileBatchTimer.invalidate();
+}
+
+//-----------------------------------------------------------------------------
+/// @return The read only connection of the calling read pool thread, opened on first use and closed when the thread exits
+QSqlDatabase
+QGCCacheWorker::_readDB() const
+{
+    struct ReadSession_t {
+        ~ReadSession_t() {
+            if (!name.isEmpty()) {
+                QSqlDatabase::removeDatabase(name);
+            }
+        }
+        QString name;
+    };
+    static thread_local ReadSession_t session;
+
+    if (session.name.isEmpty()) {
+        session.name = QStringLiteral("%1-%2").arg(kReadSession).arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", session.name);
+        db.setDatabaseName(_databasePath);
+        // No shared cache, it would serialize the readers with the writer again
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    }
+
+    // Opens the connection if it isn't open yet
+    return QSqlDatabase::database(session.name);
+}
+
+//-----------------------------------------------------------------------------
+/// Runs tile fetches on the read pool when concurrent access is enabled
+///     @return false: task must go through the task queue
+bool
+QGCCacheWorker::_startReadTask(QGCMapTask *task)
+{
+    if (!_concurrentAccess || !_valid || (task->type() != QGCMapTask::taskFetchTile)) {
+        return false;
+    }
+
+    QMutexLocker lock(&_readPoolMutex);
+    if (_readPoolSuspended) {
+        return false;
+    }
+    if (!_readPool) {
+        _readPool = std::make_unique<QThreadPool>();
+        _readPool->setMaxThreadCount(kReadThreadCount);
+    }
+    _readPool->start([this, task]() {
+        QSqlDatabase db = _readDB();
+        _fetchTile(db, task);
+        task->deleteLater();
+    });
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/// Waits for the pending fetches and closes all read connections. Fetches go through the task queue until resumed.
+void
+QGCCacheWorker::_suspendReadPool()
+{
+    QMutexLocker lock(&_readPoolMutex);
+    _readPoolSuspended = true;
+    std::unique_ptr<QThreadPool> readPool = std::move(_readPool);
+    lock.unlock();
+
+    // Destroying the pool ends its threads, which removes their connections
+    readPool.reset();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_resumeReadPool()
+{
+    QMutexLocker lock(&_readPoolMutex);
+    _readPoolSuspended = false;
+}
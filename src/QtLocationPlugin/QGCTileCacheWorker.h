@@ -18,18 +18,27 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QThread>
 #include <QtCore/QWaitCondition>
 
+#include <memory>
+
+#include "QGCTilePack.h"
+
 Q_DECLARE_LOGGING_CATEGORY(QGCTileCacheWorkerLog)
 
 class QGCMapTask;
 class QGCCachedTileSet;
+class QGCExportTileTask;
+class QGCImportTileTask;
 class QSqlDatabase;
+class QThreadPool;
 
 class QGCCacheWorker : public QThread
 {
@@ -41,6 +50,16 @@ public:
 
     void setDatabaseFile(const QString &path) { _databasePath = path; }
 
+    /// Concurrent access journals the database in WAL mode, saves tiles in batched transactions and serves tile
+    /// fetches from read only connections on a thread pool, so fetches don't queue up behind saves. Must be set
+    /// before the first task is queued.
+    void setConcurrentAccess(bool concurrentAccess) { _concurrentAccess = concurrentAccess; }
+
+    /// Size limit in bytes of the tiles only in the default set, 0 for no limit. Once it is exceeded the least
+    /// recently used tiles are pruned in small batches while the worker is idle, down to kPruneLowWatermarkPercent
+    /// of the limit.
+    void setMaxDiskCache(quint64 maxDiskCache) { _maxDiskCache = maxDiskCache; }
+
 public slots:
     bool enqueueTask(QGCMapTask *task);
     void stop();
@@ -56,21 +75,33 @@ private:
 
     void _saveTile(QGCMapTask *task);
     void _getTile(QGCMapTask *task);
+    void _fetchTile(QSqlDatabase &db, QGCMapTask *task);
     void _getTileSets(QGCMapTask *task);
     void _createTileSet(QGCMapTask *task);
     void _getTileDownloadList(QGCMapTask *task);
     void _updateTileDownloadState(QGCMapTask *task);
-    void _pruneCache(QGCMapTask *task);
     void _deleteTileSet(QGCMapTask *task);
     void _renameTileSet(QGCMapTask *task);
     void _resetCacheDatabase(QGCMapTask *task);
     void _importSets(QGCMapTask *task);
     void _exportSets(QGCMapTask *task);
+    void _importTilePack(QGCImportTileTask *task);
+    void _exportTilePack(QGCExportTileTask *task);
+    bool _insertImportedTileSet(const QGCTilePack::TileSet_t &tileSet, quint64 &setID);
     bool _testTask(QGCMapTask *task);
 
     bool _connectDB();
     void _disconnectDB();
+    void _commitTileSaves();
+    void _pruneBatch();
+    void _touchTile(const QString &hash);
+    void _flushTouchedTiles();
+    QSqlDatabase _readDB() const;
+    bool _startReadTask(QGCMapTask *task);
+    void _suspendReadPool();
+    void _resumeReadPool();
     bool _createDB(QSqlDatabase &db, bool createDefault = true);
+    void _resetDB();
     bool _findTileSetID(const QString &name, quint64 &setID);
     bool _init();
     quint64 _findTile(const QString &hash);
@@ -80,6 +111,15 @@ private:
     void _updateSetTotals(QGCCachedTileSet *set);
     void _updateTotals();
 
+    struct TileStats_t {
+        quint32 tileCount = 0;
+        quint64 tileSize = 0;
+        quint32 uniqueCount = 0;    ///< Tiles in no other set
+        quint64 uniqueSize = 0;
+    };
+    static bool _createTileStats(QSqlDatabase &db);
+    bool _readTileStats(quint64 setID, TileStats_t &stats);
+
     std::shared_ptr<QSqlDatabase> _db = nullptr;
     QMutex _taskQueueMutex;
     QQueue<QGCMapTask*> _taskQueue;
@@ -94,10 +134,28 @@ private:
     int _updateTimeout = kShortTimeout;
     std::atomic_bool _failed = false;
     std::atomic_bool _valid = false;
+    bool _stopRequested = false;        ///< Protected by _taskQueueMutex
+    std::atomic<quint64> _maxDiskCache = 0;
+    bool _pruning = false;
+    QMutex _touchedTilesMutex;
+    QSet<QString> _touchedTiles;        ///< Hashes of fetched tiles whose date is yet to be updated
+    bool _concurrentAccess = false;
+    int _pendingTileSaves = 0;          ///< Tiles saved in the open transaction
+    QElapsedTimer _tileBatchTimer;      ///< Age of the open transaction
+    QMutex _readPoolMutex;
+    bool _readPoolSuspended = false;    ///< Fetches go through the task queue while the database file is replaced
+    std::unique_ptr<QThreadPool> _readPool; ///< Declared last so pending reads finish before anything else is destroyed
 
     static QByteArray _bingNoTileImage;
     static constexpr const char *kSession = "QGeoTileWorkerSession";
     static constexpr const char *kExportSession = "QGeoTileExportSession";
+    static constexpr const char *kReadSession = "QGeoTileReadSession";
     static constexpr int kShortTimeout = 2;
     static constexpr int kLongTimeout = 5;
+    static constexpr int kTileBatchSize = 64;
+    static constexpr int kTileBatchMsecs = 250;
+    static constexpr int kReadThreadCount = 2;
+    static constexpr int kTilePackChunkSize = 256;
+    static constexpr int kPruneBatchSize = 32;
+    static constexpr int kPruneLowWatermarkPercent = 90;
 };
@@ -0,0 +1,377 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTilePack.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <algorithm>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(QGCTilePackLog, "qgc.qtlocationplugin.qgctilepack")
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "Tile packs are stored in little endian byte order");
+
+namespace {
+    constexpr const char *kNameKey          = "name";
+    constexpr const char *kMapTypeStrKey    = "typeStr";
+    constexpr const char *kTopleftLatKey    = "topleftLat";
+    constexpr const char *kTopleftLonKey    = "topleftLon";
+    constexpr const char *kBottomRightLatKey= "bottomRightLat";
+    constexpr const char *kBottomRightLonKey= "bottomRightLon";
+    constexpr const char *kMinZoomKey       = "minZoom";
+    constexpr const char *kMaxZoomKey       = "maxZoom";
+    constexpr const char *kTypeKey          = "type";
+    constexpr const char *kNumTilesKey      = "numTiles";
+    constexpr const char *kDefaultSetKey    = "defaultSet";
+
+    /// Copies a string into a zero padded fixed size field
+    ///     @return false: string does not fit
+    template<size_t N>
+    bool toField(char (&field)[N], const QString &string)
+    {
+        const QByteArray bytes = string.toLatin1();
+        if (bytes.size() >= static_cast<qsizetype>(N)) {
+            return false;
+        }
+        memset(field, 0, N);
+        memcpy(field, bytes.constData(), static_cast<size_t>(bytes.size()));
+        return true;
+    }
+
+    template<size_t N>
+    QString fromField(const char (&field)[N])
+    {
+        return QString::fromLatin1(field, static_cast<qsizetype>(strnlen(field, N)));
+    }
+}
+
+QGCTilePack::~QGCTilePack()
+{
+    if (_data) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+    }
+}
+
+bool QGCTilePack::open(const QString &fileName, QString &errorString)
+{
+    errorString.clear();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    _size = _file.size();
+    if (_size < static_cast<qint64>(sizeof(Header_t))) {
+        errorString = QStringLiteral("Not a tile pack");
+        return false;
+    }
+
+    _data = _file.map(0, _size);
+    if (!_data) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    const Header_t *const header = reinterpret_cast<const Header_t*>(_data);
+    if (memcmp(header->magic, _magic, sizeof(header->magic)) != 0) {
+        errorString = QStringLiteral("Not a tile pack");
+        return false;
+    }
+    if ((header->version < _minVersion) || (header->version > _version)) {
+        errorString = QStringLiteral("Unsupported tile pack version %1").arg(header->version);
+        return false;
+    }
+
+    const quint64 size = static_cast<quint64>(_size);
+    if (header->tileCount > (size / sizeof(IndexEntry_t))) {
+        errorString = QStringLiteral("Tile pack is truncated");
+        return false;
+    }
+    const quint64 indexBytes = header->tileCount * sizeof(IndexEntry_t);
+    if ((header->indexOffset % _alignment) || (header->indexOffset > size) || (indexBytes > size - header->indexOffset) ||
+        (header->tileSetsOffset > header->indexOffset) || (header->tileSetsBytes > header->indexOffset - header->tileSetsOffset)) {
+        errorString = QStringLiteral("Tile pack is truncated");
+        return false;
+    }
+
+    const QByteArray tileSetsJson = QByteArray::fromRawData(reinterpret_cast<const char*>(_data + header->tileSetsOffset), static_cast<qsizetype>(header->tileSetsBytes));
+    if (!_parseTileSets(tileSetsJson, _tileSets)) {
+        errorString = QStringLiteral("Tile pack tile sets are invalid");
+        return false;
+    }
+
+    // Tile data lies between the header and the tile sets
+    const IndexEntry_t *const index = reinterpret_cast<const IndexEntry_t*>(_data + header->indexOffset);
+    for (quint64 i = 0; i < header->tileCount; i++) {
+        const IndexEntry_t &entry = index[i];
+        if ((entry.offset % _alignment) || (entry.offset < sizeof(Header_t)) || (entry.offset + entry.storedBytes > header->tileSetsOffset)) {
+            errorString = QStringLiteral("Tile pack tile data is truncated");
+            return false;
+        }
+        if (entry.tileSet >= _tileSets.count()) {
+            errorString = QStringLiteral("Tile pack tile is not in a tile set");
+            return false;
+        }
+        if ((i > 0) && (_compareEntries(index[i - 1], entry) >= 0)) {
+            errorString = QStringLiteral("Tile pack index is not sorted");
+            return false;
+        }
+    }
+
+    _index = index;
+    _tileCount = static_cast<qsizetype>(header->tileCount);
+
+    qCDebug(QGCTilePackLog) << "Opened" << fileName << "sets:" << _tileSets.count() << "tiles:" << _tileCount;
+
+    return true;
+}
+
+bool QGCTilePack::_parseTileSets(const QByteArray &json, QList<TileSet_t> &tileSets)
+{
+    tileSets.clear();
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if ((parseError.error != QJsonParseError::NoError) || !doc.isArray()) {
+        return false;
+    }
+
+    const QJsonArray array = doc.array();
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+
+        TileSet_t tileSet;
+        tileSet.name            = object[kNameKey].toString();
+        tileSet.mapTypeStr      = object[kMapTypeStrKey].toString();
+        tileSet.topleftLat      = object[kTopleftLatKey].toDouble();
+        tileSet.topleftLon      = object[kTopleftLonKey].toDouble();
+        tileSet.bottomRightLat  = object[kBottomRightLatKey].toDouble();
+        tileSet.bottomRightLon  = object[kBottomRightLonKey].toDouble();
+        tileSet.minZoom         = object[kMinZoomKey].toInt();
+        tileSet.maxZoom         = object[kMaxZoomKey].toInt();
+        tileSet.type            = object[kTypeKey].toInt();
+        tileSet.numTiles        = static_cast<quint32>(object[kNumTilesKey].toInteger());
+        tileSet.defaultSet      = object[kDefaultSetKey].toBool();
+        if (tileSet.name.isEmpty()) {
+            return false;
+        }
+        tileSets.append(tileSet);
+    }
+
+    return true;
+}
+
+int QGCTilePack::_compareEntries(const IndexEntry_t &a, const IndexEntry_t &b)
+{
+    const int result = strncmp(a.hash, b.hash, sizeof(a.hash));
+    if (result != 0) {
+        return result;
+    }
+    return static_cast<int>(a.tileSet) - static_cast<int>(b.tileSet);
+}
+
+qsizetype QGCTilePack::find(QStringView hash) const
+{
+    char key[sizeof(IndexEntry_t::hash)];
+    if (!_index || !toField(key, hash.toString())) {
+        return -1;
+    }
+
+    const IndexEntry_t *const end = _index + _tileCount;
+    const IndexEntry_t *const entry = std::lower_bound(_index, end, key, [](const IndexEntry_t &entry, const char *key) {
+        return strncmp(entry.hash, key, sizeof(entry.hash)) < 0;
+    });
+
+    if ((entry == end) || (strncmp(entry->hash, key, sizeof(key)) != 0)) {
+        return -1;
+    }
+
+    return entry - _index;
+}
+
+bool QGCTilePack::tile(qsizetype index, Tile_t &tile, int &tileSet) const
+{
+    if (!_index || (index < 0) || (index >= _tileCount)) {
+        return false;
+    }
+
+    const IndexEntry_t &entry = _index[index];
+    const uchar *const data = _data + entry.offset;
+
+    tile.hash = fromField(entry.hash);
+    tile.format = fromField(entry.format);
+    tile.type = entry.type;
+    tileSet = entry.tileSet;
+
+    if (entry.storedBytes == entry.tileBytes) {
+        tile.img = QByteArray::fromRawData(reinterpret_cast<const char*>(data), entry.storedBytes);
+        return true;
+    }
+
+    tile.img = qUncompress(data, static_cast<qsizetype>(entry.storedBytes));
+    if (tile.img.size() != static_cast<qsizetype>(entry.tileBytes)) {
+        qCWarning(QGCTilePackLog) << "Corrupt compressed tile" << tile.hash << "in" << fileName();
+        tile.img.clear();
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool QGCTilePackWriter::open(const QString &fileName, QString &errorString)
+{
+    errorString.clear();
+    _index.clear();
+    _tileSets.clear();
+    _storedTiles.clear();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly)) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    // The header is written again on commit once the offsets are known
+    const QGCTilePack::Header_t header{};
+    if (_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+int QGCTilePackWriter::addTileSet(const QGCTilePack::TileSet_t &tileSet)
+{
+    _tileSets.append(tileSet);
+    return static_cast<int>(_tileSets.count() - 1);
+}
+
+bool QGCTilePackWriter::addTiles(const QList<QGCTilePack::Tile_t> &tiles, int tileSet)
+{
+    const QList<QByteArray> storedTiles = QtConcurrent::blockingMapped<QList<QByteArray>>(tiles, [](const QGCTilePack::Tile_t &tile) {
+        const QByteArray compressed = qCompress(tile.img);
+        return (compressed.size() < tile.img.size()) ? compressed : tile.img;
+    });
+
+    for (qsizetype i = 0; i < tiles.count(); i++) {
+        const QGCTilePack::Tile_t &tile = tiles[i];
+        const QByteArray &stored = storedTiles[i];
+
+        QGCTilePack::IndexEntry_t entry{};
+        if (!toField(entry.hash, tile.hash) || !toField(entry.format, tile.format)) {
+            qCWarning(QGCTilePackLog) << "Skipping tile which does not fit the index" << tile.hash << tile.format;
+            continue;
+        }
+        entry.tileSet = static_cast<quint16>(tileSet);
+
+        // A tile shared by several sets references the data stored for the first one
+        const auto storedIt = _storedTiles.constFind(tile.hash);
+        if (storedIt != _storedTiles.constEnd()) {
+            const QGCTilePack::IndexEntry_t &storedEntry = _index[storedIt.value()];
+            entry.offset = storedEntry.offset;
+            entry.storedBytes = storedEntry.storedBytes;
+            entry.tileBytes = storedEntry.tileBytes;
+            entry.type = storedEntry.type;
+            _index.append(entry);
+            continue;
+        }
+
+        const qint64 padding = ((_file.pos() + QGCTilePack::_alignment - 1) & ~(QGCTilePack::_alignment - 1)) - _file.pos();
+        if (padding > 0) {
+            (void) _file.write(QByteArray(padding, '\0'));
+        }
+
+        entry.offset = static_cast<quint64>(_file.pos());
+        entry.storedBytes = static_cast<quint32>(stored.size());
+        entry.tileBytes = static_cast<quint32>(tile.img.size());
+        entry.type = tile.type;
+        if (_file.write(stored) != stored.size()) {
+            return false;
+        }
+        _storedTiles.insert(tile.hash, _index.count());
+        _index.append(entry);
+    }
+
+    return true;
+}
+
+bool QGCTilePackWriter::commit(QString &errorString)
+{
+    errorString.clear();
+
+    // A tile keeps an entry for each set it is in, only a tile added to the same set twice is dropped
+    std::sort(_index.begin(), _index.end(), [](const QGCTilePack::IndexEntry_t &a, const QGCTilePack::IndexEntry_t &b) {
+        return QGCTilePack::_compareEntries(a, b) < 0;
+    });
+    _index.erase(std::unique(_index.begin(), _index.end(), [](const QGCTilePack::IndexEntry_t &a, const QGCTilePack::IndexEntry_t &b) {
+        return QGCTilePack::_compareEntries(a, b) == 0;
+    }), _index.end());
+
+    QJsonArray tileSets;
+    for (const QGCTilePack::TileSet_t &tileSet : _tileSets) {
+        QJsonObject object;
+        object[kNameKey]            = tileSet.name;
+        object[kMapTypeStrKey]      = tileSet.mapTypeStr;
+        object[kTopleftLatKey]      = tileSet.topleftLat;
+        object[kTopleftLonKey]      = tileSet.topleftLon;
+        object[kBottomRightLatKey]  = tileSet.bottomRightLat;
+        object[kBottomRightLonKey]  = tileSet.bottomRightLon;
+        object[kMinZoomKey]         = tileSet.minZoom;
+        object[kMaxZoomKey]         = tileSet.maxZoom;
+        object[kTypeKey]            = tileSet.type;
+        object[kNumTilesKey]        = static_cast<qint64>(tileSet.numTiles);
+        object[kDefaultSetKey]      = tileSet.defaultSet;
+        tileSets.append(object);
+    }
+    const QByteArray tileSetsJson = QJsonDocument(tileSets).toJson(QJsonDocument::Compact);
+
+    QGCTilePack::Header_t header{};
+    memcpy(header.magic, QGCTilePack::_magic, sizeof(header.magic));
+    header.version = QGCTilePack::_version;
+    header.tileCount = static_cast<quint64>(_index.count());
+    header.tileSetsOffset = static_cast<quint64>(_file.pos());
+    header.tileSetsBytes = static_cast<quint64>(tileSetsJson.size());
+    (void) _file.write(tileSetsJson);
+
+    const qint64 padding = ((_file.pos() + QGCTilePack::_alignment - 1) & ~(QGCTilePack::_alignment - 1)) - _file.pos();
+    if (padding > 0) {
+        (void) _file.write(QByteArray(padding, '\0'));
+    }
+    header.indexOffset = static_cast<quint64>(_file.pos());
+    (void) _file.write(reinterpret_cast<const char*>(_index.constData()), _index.count() * static_cast<qsizetype>(sizeof(QGCTilePack::IndexEntry_t)));
+
+    if (!_file.seek(0) || (_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header))) {
+        errorString = _file.errorString();
+        _file.cancelWriting();
+        return false;
+    }
+
+    if (!_file.commit()) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    qCDebug(QGCTilePackLog) << "Wrote" << _file.fileName() << "sets:" << _tileSets.count() << "tiles:" << _index.count();
+
+    _index.clear();
+    _tileSets.clear();
+    _storedTiles.clear();
+
+    return true;
+}
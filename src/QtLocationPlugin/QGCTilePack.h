@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QSaveFile>
+#include <QtCore/QString>
+
+Q_DECLARE_LOGGING_CATEGORY(QGCTilePackLog)
+
+class QGCTilePackWriter;
+
+/// Read only, memory mapped archive of map tile sets, used to ship offline maps.
+///
+/// File format (little endian): a header, the tile data, the tile set descriptions as JSON and an index with one
+/// entry per tile and set it belongs to, sorted by tile hash and set. The data of a tile which is in several sets is
+/// stored once. Each tile is stored either as is or zlib compressed (qCompress), whichever is smaller. Tile data is
+/// 8 byte aligned so uncompressed tiles are used in place from the mapping.
+class QGCTilePack
+{
+public:
+    QGCTilePack() = default;
+    ~QGCTilePack();
+
+    struct TileSet_t {
+        QString name;
+        QString mapTypeStr;
+        double  topleftLat = 0.;
+        double  topleftLon = 0.;
+        double  bottomRightLat = 0.;
+        double  bottomRightLon = 0.;
+        int     minZoom = 3;
+        int     maxZoom = 3;
+        int     type = -1;
+        quint32 numTiles = 0;
+        bool    defaultSet = false;
+    };
+
+    struct Tile_t {
+        QString     hash;
+        QString     format;
+        QByteArray  img;
+        int         type = -1;
+    };
+
+    /// Maps the pack file and validates its index
+    ///     @return false: file could not be mapped or is not a tile pack
+    bool open(const QString &fileName, QString &errorString);
+
+    QString fileName() const { return _file.fileName(); }
+    const QList<TileSet_t> &tileSets() const { return _tileSets; }
+    qsizetype tileCount() const { return _tileCount; }
+
+    /// @return Index of the tile with the specified UrlFactory::getTileHash, -1 if it is not in the pack. A tile which
+    ///         is in several sets has an index entry for each, this is the first.
+    qsizetype find(QStringView hash) const;
+
+    /// Reads a tile. Uncompressed tiles reference the mapping without a copy, so the pack must outlive them.
+    ///     @param index 0 to tileCount() - 1, in hash and set order
+    ///     @param[out] tileSet Index into tileSets() of the set the tile belongs to
+    bool tile(qsizetype index, Tile_t &tile, int &tileSet) const;
+
+    static constexpr const char *fileExtension = "qgctiles";
+
+private:
+    struct IndexEntry_t {
+        char    hash[32];       ///< Zero padded
+        quint64 offset;         ///< From the start of the file
+        quint32 storedBytes;
+        quint32 tileBytes;      ///< storedBytes differs if the tile is compressed
+        qint32  type;
+        quint16 tileSet;
+        char    format[10];     ///< Zero padded
+    };
+    static_assert(sizeof(IndexEntry_t) == 64, "Index entry must be packed");
+
+    struct Header_t {
+        char    magic[8];
+        quint32 version;
+        quint32 reserved;
+        quint64 tileCount;
+        quint64 tileSetsOffset;
+        quint64 tileSetsBytes;
+        quint64 indexOffset;
+    };
+    static_assert(sizeof(Header_t) == 48, "Header must be packed");
+
+    static bool _parseTileSets(const QByteArray &json, QList<TileSet_t> &tileSets);
+    /// Index order, by hash and then by set
+    static int _compareEntries(const IndexEntry_t &a, const IndexEntry_t &b);
+
+    QFile _file;
+    const uchar *_data = nullptr;
+    qint64 _size = 0;
+    const IndexEntry_t *_index = nullptr;
+    qsizetype _tileCount = 0;
+    QList<TileSet_t> _tileSets;
+
+    static constexpr char _magic[] = "QGCTILES";
+    static constexpr quint32 _version = 2;               ///< 2: tiles in several sets have an index entry per set
+    static constexpr quint32 _minVersion = 1;
+    static constexpr qint64 _alignment = 8;
+
+    friend class QGCTilePackWriter;
+};
+
+/// Streams tiles into a new tile pack, so only the index is held in memory while writing
+class QGCTilePackWriter
+{
+public:
+    QGCTilePackWriter() = default;
+
+    bool open(const QString &fileName, QString &errorString);
+
+    /// @return Index of the set to pass to addTiles
+    int addTileSet(const QGCTilePack::TileSet_t &tileSet);
+
+    /// Compresses the tiles in parallel and appends them to the pack. A tile which is already in the pack is added
+    /// to the set without storing its data again.
+    bool addTiles(const QList<QGCTilePack::Tile_t> &tiles, int tileSet);
+
+    /// Writes the tile sets and the index and moves the pack in place
+    bool commit(QString &errorString);
+
+private:
+    QSaveFile _file;
+    QList<QGCTilePack::IndexEntry_t> _index;
+    QList<QGCTilePack::TileSet_t> _tileSets;
+    QHash<QString, qsizetype> _storedTiles;    ///< Hash to the _index entry which holds the data of the tile
+};
@@ -16,13 +16,33 @@
 #include "QGCMapUrlEngine.h"
 #include "QGCMapTasks.h"
 #include <QGCLoggingCategory.h>
+#include <QGCPerfCounter.h>
 
+#include <QtCore/QCache>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QDir>
+#include <QtCore/QMutex>
 
 QGC_LOGGING_CATEGORY(QGeoFileTileCacheQGCLog, "qgc.qtlocationplugin.qgeofiletilecacheqgc")
 
+namespace {
+    struct MemoryTile_t {
+        QByteArray image;
+        QString format;
+    };
+
+    /// Cost is in bytes of tile data, so the budget is the byte budget
+    struct MemoryTileCache_t {
+        QMutex mutex;
+        QCache<QString, MemoryTile_t> tiles{0};
+    };
+}
+
+Q_GLOBAL_STATIC(MemoryTileCache_t, s_memoryTileCache)
+
+static QGCPerfCounter s_memoryTileBytes("Memory", "Map tile cache", QGCPerfCounter::Bytes);
+
 QGeoFileTileCacheQGC::QGeoFileTileCacheQGC(const QVariantMap &parameters, QObject *parent)
     : QGeoFileTileCache(_getCachePath(parameters), parent)
 {
@@ -35,6 +55,11 @@ QGeoFileTileCacheQGC::QGeoFileTileCacheQGC(const QVariantMap &parameters, QObjec
     setCostStrategyTexture(QGeoFileTileCache::ByteSize);
     setMinTextureUsage(_getDefaultMinTexture());
     setExtraTextureUsage(_getDefaultExtraTexture() - minTextureUsage());
+
+    _setMaxTileMemCache(_getMaxTileMemCacheSetting());
+    (void) connect(qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxTileMemoryCacheSize(), &Fact::rawValueChanged, this, [](const QVariant &value) {
+        _setMaxTileMemCache(value.toUInt());
+    });
 }
 
 QGeoFileTileCacheQGC::~QGeoFileTileCacheQGC()
@@ -104,11 +129,57 @@ quint32 QGeoFileTileCacheQGC::_getMaxMemCacheSetting()
     return qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxCacheMemorySize()->rawValue().toUInt();
 }
 
+quint32 QGeoFileTileCacheQGC::_getMaxTileMemCacheSetting()
+{
+    return qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxTileMemoryCacheSize()->rawValue().toUInt();
+}
+
+void QGeoFileTileCacheQGC::_setMaxTileMemCache(quint32 megaBytes)
+{
+    // Value saved in MB
+    const qsizetype maxCost = static_cast<qsizetype>(qMin(megaBytes, 1024U)) * 1024 * 1024;
+
+    QMutexLocker lock(&s_memoryTileCache()->mutex);
+    s_memoryTileCache()->tiles.setMaxCost(maxCost);
+    s_memoryTileBytes.set(s_memoryTileCache()->tiles.totalCost());
+}
+
+bool QGeoFileTileCacheQGC::getMemoryTile(const QString &hash, QByteArray &image, QString &format)
+{
+    QMutexLocker lock(&s_memoryTileCache()->mutex);
+
+    const MemoryTile_t* const tile = s_memoryTileCache()->tiles.object(hash);
+    if (!tile) {
+        return false;
+    }
+
+    image = tile->image;
+    format = tile->format;
+    return true;
+}
+
+void QGeoFileTileCacheQGC::insertMemoryTile(const QString &hash, const QByteArray &image, const QString &format)
+{
+    QMutexLocker lock(&s_memoryTileCache()->mutex);
+
+    if (image.size() > s_memoryTileCache()->tiles.maxCost()) {
+        return;
+    }
+
+    (void) s_memoryTileCache()->tiles.insert(hash, new MemoryTile_t{ image, format }, image.size());
+    s_memoryTileBytes.set(s_memoryTileCache()->tiles.totalCost());
+}
+
 quint32 QGeoFileTileCacheQGC::getMaxDiskCacheSetting()
 {
     return qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxCacheDiskSize()->rawValue().toUInt();
 }
 
+bool QGeoFileTileCacheQGC::getConcurrentCacheAccessSetting()
+{
+    return qgcApp()->toolbox()->settingsManager()->mapsSettings()->concurrentCacheAccess()->rawValue().toBool();
+}
+
 void QGeoFileTileCacheQGC::cacheTile(const QString &type, int x, int y, int z, const QByteArray &image, const QString &format, qulonglong set)
 {
     const QString hash = UrlFactory::getTileHash(type, x, y, z);
@@ -25,11 +25,18 @@ public:
     ~QGeoFileTileCacheQGC();
 
     static quint32 getMaxDiskCacheSetting();
+    static bool getConcurrentCacheAccessSetting();
     static void cacheTile(const QString &type, int x, int y, int z, const QByteArray &image, const QString &format, qulonglong set = UINT64_MAX);
     static void cacheTile(const QString &type, const QString &hash, const QByteArray &image, const QString &format, qulonglong set = UINT64_MAX);
     static QGCFetchTileTask* createFetchTileTask (const QString &type, int x, int y, int z);
     static QString getCacheFilename() { return QStringLiteral("qgcMapCache.db"); }
 
+    /// In memory LRU of raw tile data in front of the cache database, shared by all maps
+    ///     @param hash UrlFactory::getTileHash of the tile
+    ///     @return false: tile is not in memory
+    static bool getMemoryTile(const QString &hash, QByteArray &image, QString &format);
+    static void insertMemoryTile(const QString &hash, const QByteArray &image, const QString &format);
+
 private:
     // QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const final;
     // QGeoTileSpec filenameToTileSpec(const QString &filename) const final;
@@ -43,4 +50,6 @@ private:
     static uint32_t _getDefaultMinTexture() { return 0; }
 
     static quint32 _getMaxMemCacheSetting();
+    static quint32 _getMaxTileMemCacheSetting();
+    static void _setMaxTileMemCache(quint32 megaBytes);
 };
@@ -14,10 +14,13 @@
 #include "QGCMapEngine.h"
 #include "QGCMapUrlEngine.h"
 #include "QGeoFileTileCacheQGC.h"
+#include "QGeoTileFetcherQGC.h"
+#include "VectorTileMapProvider.h"
 
 #include <DeviceInfo.h>
 #include <QGCFileDownload.h>
 #include <QGCLoggingCategory.h>
+#include <QGCPerfCounter.h>
 
 #include <QtCore/QFile>
 #include <QtLocation/private/qgeotilespec_p.h>
@@ -26,11 +29,40 @@
 
 QGC_LOGGING_CATEGORY(QGeoTiledMapReplyQGCLog, "qgc.qtlocationplugin.qgeomapreplyqgc")
 
+namespace {
+    QGCPerfCounter s_memoryHits("Map Tiles", "Memory cache hits", QGCPerfCounter::Count);
+    QGCPerfCounter s_databaseHits("Map Tiles", "Database cache hits", QGCPerfCounter::Count);
+    QGCPerfCounter s_downloads("Map Tiles", "Downloads", QGCPerfCounter::Count);
+    QGCPerfCounter s_hitRatio("Map Tiles", "Cache hit ratio", QGCPerfCounter::Percent);
+
+    void countTile(QGCPerfCounter &counter)
+    {
+        counter.add();
+
+        const qint64 hits = s_memoryHits.value() + s_databaseHits.value();
+        const qint64 total = hits + s_downloads.value();
+        s_hitRatio.set((hits * 100) / total);
+    }
+}
+
 QByteArray QGeoTiledMapReplyQGC::_bingNoTileImage;
 QByteArray QGeoTiledMapReplyQGC::_badTile;
 
 QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QNetworkAccessManager *networkManager, const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent)
+    : QGeoTiledMapReplyQGC(nullptr, networkManager, request, spec, parent)
+{
+
+}
+
+QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QGeoTileFetcherQGC *fetcher, const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent)
+    : QGeoTiledMapReplyQGC(fetcher, fetcher->networkManager(), request, spec, parent)
+{
+
+}
+
+QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QGeoTileFetcherQGC *fetcher, QNetworkAccessManager *networkManager, const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent)
     : QGeoTiledMapReply(spec, parent)
+    , _fetcher(fetcher)
     , _networkManager(networkManager)
     , _request(request)
 {
@@ -39,12 +71,49 @@ QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QNetworkAccessManager *networkManager
     _initDataFromResources();
 
     (void) connect(this, &QGeoTiledMapReplyQGC::errorOccurred, this, [this](QGeoTiledMapReply::Error error, const QString &errorString) {
-        qCWarning(QGeoTiledMapReplyQGCLog) << error << errorString;
+        if (!_stale) {
+            qCWarning(QGeoTiledMapReplyQGCLog) << error << errorString;
+        }
         setMapImageData(_badTile);
         setMapImageFormat("png");
         setCached(false);
     }, Qt::AutoConnection);
 
+    // Local tile files are indexed and mapped already, so their tiles skip the memory cache, the cache database and the network
+    const SharedMapProvider mapProvider = UrlFactory::getMapProviderFromQtMapId(spec.mapId());
+    if (mapProvider && mapProvider->isLocalFileProvider()) {
+        const QByteArray image = mapProvider->getLocalTile(spec.x(), spec.y(), spec.zoom());
+        if (image.isEmpty()) {
+            _tileUnavailable = true;
+            setError(QGeoTiledMapReply::CommunicationError, QStringLiteral("Tile Not In Local File"));
+            return;
+        }
+
+        const QString format = mapProvider->getImageFormat(image);
+        if (format.isEmpty()) {
+            setError(QGeoTiledMapReply::ParseError, QStringLiteral("Unknown Format"));
+            return;
+        }
+
+        setMapImageData(image);
+        setMapImageFormat(format);
+        setCached(true);
+        setFinished(true);
+        return;
+    }
+
+    // Hot tiles are served straight from memory. The fetcher checks isFinished() right after creating the reply.
+    QByteArray image;
+    QString format;
+    if (QGeoFileTileCacheQGC::getMemoryTile(_tileHash(), image, format)) {
+        countTile(s_memoryHits);
+        setMapImageData(image);
+        setMapImageFormat(format);
+        setCached(true);
+        setFinished(true);
+        return;
+    }
+
     QGCFetchTileTask* const task = QGeoFileTileCacheQGC::createFetchTileTask(UrlFactory::getProviderTypeFromQtMapId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
     (void) connect(task, &QGCFetchTileTask::tileFetched, this, &QGeoTiledMapReplyQGC::_cacheReply);
     (void) connect(task, &QGCMapTask::error, this, &QGeoTiledMapReplyQGC::_cacheError);
@@ -56,6 +125,11 @@ QGeoTiledMapReplyQGC::~QGeoTiledMapReplyQGC()
     // qCDebug(QGeoTiledMapReplyQGCLog) << Q_FUNC_INFO << this;
 }
 
+QString QGeoTiledMapReplyQGC::_tileHash() const
+{
+    return UrlFactory::getTileHash(UrlFactory::getProviderTypeFromQtMapId(tileSpec().mapId()), tileSpec().x(), tileSpec().y(), tileSpec().zoom());
+}
+
 void QGeoTiledMapReplyQGC::_initDataFromResources()
 {
     if (_bingNoTileImage.isEmpty()) {
@@ -109,6 +183,7 @@ void QGeoTiledMapReplyQGC::_networkReplyFinished()
     Q_CHECK_PTR(mapProvider);
 
     if (mapProvider->isBingProvider() && (image == _bingNoTileImage)) {
+        _tileUnavailable = true;
         setError(QGeoTiledMapReply::CommunicationError, QStringLiteral("Bing Tile Above Zoom Level"));
         return;
     }
@@ -121,20 +196,44 @@ void QGeoTiledMapReplyQGC::_networkReplyFinished()
             return;
         }
     }
-    setMapImageData(image);
 
-    const QString format = mapProvider->getImageFormat(image);
+    QString format = mapProvider->getImageFormat(image);
     if (format.isEmpty()) {
         setError(QGeoTiledMapReply::ParseError, QStringLiteral("Unknown Format"));
         return;
     }
-    setMapImageFormat(format);
 
+    countTile(s_downloads);
     QGeoFileTileCacheQGC::cacheTile(mapProvider->getMapName(), tileSpec().x(), tileSpec().y(), tileSpec().zoom(), image, format);
 
+    if (!_renderVectorTile(mapProvider, image, format)) {
+        return;
+    }
+
+    QGeoFileTileCacheQGC::insertMemoryTile(_tileHash(), image, format);
+    setMapImageData(image);
+    setMapImageFormat(format);
     setFinished(true);
 }
 
+bool QGeoTiledMapReplyQGC::_renderVectorTile(const SharedMapProvider &mapProvider, QByteArray &image, QString &format)
+{
+    if (!mapProvider || !mapProvider->isVectorTileProvider()) {
+        return true;
+    }
+
+    // The caches hold the vector tile, the memory cache and QtLocation the rendered image
+    const std::shared_ptr<const VectorTileMapProvider> vectorTileProvider = std::dynamic_pointer_cast<const VectorTileMapProvider>(mapProvider);
+    image = vectorTileProvider->render(image, tileSpec().zoom());
+    if (image.isEmpty()) {
+        setError(QGeoTiledMapReply::ParseError, QStringLiteral("Failed to Render Vector Tile"));
+        return false;
+    }
+    format = QStringLiteral("png");
+
+    return true;
+}
+
 void QGeoTiledMapReplyQGC::_networkReplyError(QNetworkReply::NetworkError error)
 {
     if (error != QNetworkReply::OperationCanceledError) {
@@ -169,11 +268,21 @@ void QGeoTiledMapReplyQGC::_networkReplySslErrors(const QList<QSslError> &errors
 void QGeoTiledMapReplyQGC::_cacheReply(QGCCacheTile *tile)
 {
     if (tile) {
-        setMapImageData(tile->img());
-        setMapImageFormat(tile->format());
+        countTile(s_databaseHits);
+        QByteArray image = tile->img();
+        QString format = tile->format();
+        const QString hash = tile->hash();
+        delete tile;
+
+        if (!_renderVectorTile(UrlFactory::getMapProviderFromQtMapId(tileSpec().mapId()), image, format)) {
+            return;
+        }
+
+        QGeoFileTileCacheQGC::insertMemoryTile(hash, image, format);
+        setMapImageData(image);
+        setMapImageFormat(format);
         setCached(true);
         setFinished(true);
-        delete tile;
     } else {
         setError(QGeoTiledMapReply::UnknownError, QStringLiteral("Invalid Cache Tile"));
     }
@@ -190,9 +299,20 @@ void QGeoTiledMapReplyQGC::_cacheError(QGCMapTask::TaskType type, QStringView er
         return;
     }
 
+    // Downloads are ordered by the fetcher so the tiles closest to the map views come first
+    if (_fetcher) {
+        _fetcher->queueNetworkRequest(this);
+    } else {
+        startNetworkRequest();
+    }
+}
+
+void QGeoTiledMapReplyQGC::startNetworkRequest()
+{
     _request.setOriginatingObject(this);
 
     QNetworkReply* const reply = _networkManager->get(_request);
+    _networkReply = reply;
     reply->setParent(this);
     QGCFileDownload::setIgnoreSSLErrorsIfNeeded(*reply);
 
@@ -208,3 +328,18 @@ void QGeoTiledMapReplyQGC::abort()
 {
     QGeoTiledMapReply::abort();
 }
+
+void QGeoTiledMapReplyQGC::abortStale()
+{
+    if (isFinished()) {
+        return;
+    }
+
+    if (_networkReply) {
+        (void) _networkReply->disconnect(this);
+        _networkReply->abort();
+    }
+
+    _stale = true;
+    setError(QGeoTiledMapReply::CommunicationError, QStringLiteral("Stale Tile Request"));
+}
@@ -10,14 +10,19 @@
 #pragma once
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
 
 #include "QGCMapTasks.h"
 
+#include <memory>
+
 Q_DECLARE_LOGGING_CATEGORY(QGeoTiledMapReplyQGCLog)
 
+class MapProvider;
+class QGeoTileFetcherQGC;
 class QNetworkAccessManager;
 class QSslError;
 
@@ -27,10 +32,22 @@ class QGeoTiledMapReplyQGC : public QGeoTiledMapReply
 
 public:
     QGeoTiledMapReplyQGC(QNetworkAccessManager *networkManager, const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent = nullptr);
+    /// Map tile reply, downloaded in the order the fetcher schedules
+    QGeoTiledMapReplyQGC(QGeoTileFetcherQGC *fetcher, const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent = nullptr);
     ~QGeoTiledMapReplyQGC();
 
     void abort() final;
 
+    /// Downloads the tile, called by the fetcher once the tile is the next one due
+    void startNetworkRequest();
+
+    /// Fails the reply for a tile none of the maps needs any more, so QtLocation only requests it again if it is
+    /// shown again
+    void abortStale();
+
+    /// @return true if the reply failed because the provider has no tile at this position and zoom level
+    bool tileUnavailable() const { return _tileUnavailable; }
+
 private slots:
     void _networkReplyFinished();
     void _networkReplyError(QNetworkReply::NetworkError error);
@@ -41,10 +58,20 @@ private slots:
     void _cacheError(QGCMapTask::TaskType type, QStringView errorString);
 
 private:
+    QGeoTiledMapReplyQGC(QGeoTileFetcherQGC *fetcher, QNetworkAccessManager *networkManager, const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent);
+
+    QString _tileHash() const;
+    /// Replaces a vector tile with its rendered image, other tiles are left as they are
+    ///     @return false: rendering failed and the error was set
+    bool _renderVectorTile(const std::shared_ptr<const MapProvider> &mapProvider, QByteArray &image, QString &format);
     static void _initDataFromResources();
 
+    QPointer<QGeoTileFetcherQGC> _fetcher;
     QNetworkAccessManager *_networkManager = nullptr;
     QNetworkRequest _request;
+    QPointer<QNetworkReply> _networkReply;
+    bool _stale = false;
+    bool _tileUnavailable = false;
 
     static QByteArray _bingNoTileImage;
     static QByteArray _badTile;
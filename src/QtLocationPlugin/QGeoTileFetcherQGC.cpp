@@ -12,6 +12,9 @@
 #include "QGeoMapReplyQGC.h"
 #include "QGCMapUrlEngine.h"
 #include "MapProvider.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "MapsSettings.h"
 #include <QGCLoggingCategory.h>
 
 // #include <QtNetwork/QNetworkDiskCache>
@@ -20,6 +23,9 @@
 #include <QtLocation/private/qgeotiledmappingmanagerengine_p.h>
 #include <QtLocation/private/qgeotilespec_p.h>
 
+#include <algorithm>
+#include <cmath>
+
 QGC_LOGGING_CATEGORY(QGeoTileFetcherQGCLog, "qgc.qtlocationplugin.qgeotilefetcherqgc")
 
 QGeoTileFetcherQGC::QGeoTileFetcherQGC(QNetworkAccessManager *networkManager, const QVariantMap &parameters, QGeoTiledMappingManagerEngineQGC *parent)
@@ -29,6 +35,10 @@ QGeoTileFetcherQGC::QGeoTileFetcherQGC(QNetworkAccessManager *networkManager, co
 {
     Q_CHECK_PTR(networkManager);
 
+    m_staleRequestTimer.setSingleShot(true);
+    m_staleRequestTimer.setInterval(kStaleRequestCheckMsecs);
+    (void) connect(&m_staleRequestTimer, &QTimer::timeout, this, &QGeoTileFetcherQGC::_abortStaleRequests);
+
     // qCDebug(QGeoTileFetcherQGCLog) << Q_FUNC_INFO << this;
 
     // TODO: Allow useragent override again
@@ -65,12 +75,16 @@ QGeoTiledMapReply* QGeoTileFetcherQGC::getTileImage(const QGeoTileSpec &spec)
         return nullptr;
     }*/
 
+    if (provider->isLocalFileProvider()) {
+        return new QGeoTiledMapReplyQGC(this, QNetworkRequest(), spec);
+    }
+
     const QNetworkRequest request = getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
     if (request.url().isEmpty()) {
         return nullptr;
     }
 
-    return new QGeoTiledMapReplyQGC(m_networkManager, request, spec);
+    return new QGeoTiledMapReplyQGC(this, request, spec);
 }
 
 bool QGeoTileFetcherQGC::initialized() const
@@ -107,6 +121,187 @@ void QGeoTileFetcherQGC::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpe
     }
 }
 
+uint32_t QGeoTileFetcherQGC::concurrentDownloads(const QString &type)
+{
+    const SharedMapProvider mapProvider = UrlFactory::getMapProviderFromProviderType(type);
+    return (mapProvider ? static_cast<uint32_t>(mapProvider->getMaxConcurrentDownloads()) : 6);
+}
+
+int QGeoTileFetcherQGC::interactiveDownloads(const QString &type)
+{
+    const SharedMapProvider mapProvider = UrlFactory::getMapProviderFromProviderType(type);
+    return (mapProvider ? mapProvider->getMaxInteractiveDownloads() : 6);
+}
+
+double QGeoTileFetcherQGC::maxDownloadRate(const QString &type)
+{
+    const double userRate = qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxTileDownloadRate()->rawValue().toDouble();
+
+    const SharedMapProvider mapProvider = UrlFactory::getMapProviderFromProviderType(type);
+    const double providerRate = (mapProvider ? mapProvider->getMaxDownloadRate() : 0.);
+
+    if ((userRate > 0.) && (providerRate > 0.)) {
+        return qMin(userRate, providerRate);
+    }
+    return qMax(userRate, providerRate);
+}
+
+void QGeoTileFetcherQGC::updateViewport(const QObject *map, const QGeoCoordinate &center, double zoomLevel)
+{
+    m_viewports.insert(map, Viewport_t{ center, zoomLevel });
+    // Views change with every camera update while panning, so the check runs at most once per interval
+    if (!m_staleRequestTimer.isActive()) {
+        m_staleRequestTimer.start();
+    }
+}
+
+void QGeoTileFetcherQGC::removeViewport(const QObject *map)
+{
+    (void) m_viewports.remove(map);
+}
+
+void QGeoTileFetcherQGC::queueNetworkRequest(QGeoTiledMapReplyQGC *reply)
+{
+    (void) connect(reply, &QGeoTiledMapReply::finished, this, [this, reply]() { _releaseRequest(reply); });
+    (void) connect(reply, &QGeoTiledMapReply::aborted, this, [this, reply]() { _releaseRequest(reply); });
+    (void) connect(reply, &QObject::destroyed, this, &QGeoTileFetcherQGC::_releaseRequest);
+
+    m_queuedReplies.append(reply);
+    _startQueuedRequests();
+}
+
+void QGeoTileFetcherQGC::_releaseRequest(QObject *reply)
+{
+    const bool wasActive = m_activeReplies.remove(reply);
+    (void) m_queuedReplies.removeOne(static_cast<QGeoTiledMapReplyQGC*>(reply));
+    if (wasActive) {
+        _startQueuedRequests();
+    }
+}
+
+void QGeoTileFetcherQGC::_startQueuedRequests()
+{
+    QHash<int, int> activeCounts;
+    for (const int mapId : std::as_const(m_activeReplies)) {
+        activeCounts[mapId]++;
+    }
+
+    QHash<int, int> limits;
+    bool slotFree = false;
+    for (const QGeoTiledMapReplyQGC *reply : std::as_const(m_queuedReplies)) {
+        const int mapId = reply->tileSpec().mapId();
+        if (!limits.contains(mapId)) {
+            limits[mapId] = interactiveDownloads(UrlFactory::getProviderTypeFromQtMapId(mapId));
+        }
+        slotFree |= (activeCounts.value(mapId) < limits[mapId]);
+    }
+    if (!slotFree) {
+        return;
+    }
+
+    // Start the queued tiles closest to a map view, as far as their provider has free download slots. Stable, so
+    // tiles of equal priority start in request order.
+    QList<QPair<double, QGeoTiledMapReplyQGC*>> candidates;
+    candidates.reserve(m_queuedReplies.size());
+    for (QGeoTiledMapReplyQGC *reply : std::as_const(m_queuedReplies)) {
+        candidates.append(qMakePair(_tilePriority(reply->tileSpec()), reply));
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    QList<QGeoTiledMapReplyQGC*> startReplies;
+    for (const auto &candidate : std::as_const(candidates)) {
+        const int mapId = candidate.second->tileSpec().mapId();
+        if (activeCounts.value(mapId) < limits[mapId]) {
+            activeCounts[mapId]++;
+            startReplies.append(candidate.second);
+        }
+    }
+
+    for (QGeoTiledMapReplyQGC *reply : std::as_const(startReplies)) {
+        (void) m_queuedReplies.removeOne(reply);
+        m_activeReplies.insert(reply, reply->tileSpec().mapId());
+    }
+    for (QGeoTiledMapReplyQGC *reply : std::as_const(startReplies)) {
+        reply->startNetworkRequest();
+    }
+}
+
+void QGeoTileFetcherQGC::_abortStaleRequests()
+{
+    QList<QGeoTiledMapReplyQGC*> staleReplies;
+    for (qsizetype i = m_queuedReplies.size() - 1; i >= 0; i--) {
+        if (_isStale(m_queuedReplies[i]->tileSpec())) {
+            staleReplies.append(m_queuedReplies.takeAt(i));
+        }
+    }
+    for (auto it = m_activeReplies.begin(); it != m_activeReplies.end();) {
+        QGeoTiledMapReplyQGC* const reply = static_cast<QGeoTiledMapReplyQGC*>(it.key());
+        if (_isStale(reply->tileSpec())) {
+            staleReplies.append(reply);
+            it = m_activeReplies.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (staleReplies.isEmpty()) {
+        return;
+    }
+
+    qCDebug(QGeoTileFetcherQGCLog) << "Aborting stale tile requests:" << staleReplies.size();
+
+    for (QGeoTiledMapReplyQGC *reply : std::as_const(staleReplies)) {
+        reply->abortStale();
+    }
+
+    _startQueuedRequests();
+}
+
+double QGeoTileFetcherQGC::_tileDistance(const QGeoTileSpec &spec, const Viewport_t &viewport)
+{
+    const double tiles = static_cast<double>(1 << spec.zoom());
+    const double latitude = qDegreesToRadians(qBound(-85.0511, viewport.center.latitude(), 85.0511));
+    const double centerX = (viewport.center.longitude() + 180.) / 360. * tiles;
+    const double centerY = (1. - (std::asinh(std::tan(latitude)) / M_PI)) / 2. * tiles;
+
+    // In tiles of the view's zoom level, so prefetched tiles of other levels cover the same distance
+    const int viewZoom = static_cast<int>(std::floor(viewport.zoomLevel));
+    return std::hypot(spec.x() + 0.5 - centerX, spec.y() + 0.5 - centerY) / std::ldexp(1., spec.zoom() - viewZoom);
+}
+
+double QGeoTileFetcherQGC::_tilePriority(const QGeoTileSpec &spec) const
+{
+    // Without a view the tiles are downloaded in request order
+    double priority = 0.;
+    bool first = true;
+    for (const Viewport_t &viewport : m_viewports) {
+        const int zoomLevels = std::abs(spec.zoom() - static_cast<int>(std::floor(viewport.zoomLevel)));
+        const double viewPriority = _tileDistance(spec, viewport) + (kZoomLevelPriority * zoomLevels);
+        if (first || (viewPriority < priority)) {
+            priority = viewPriority;
+            first = false;
+        }
+    }
+
+    return priority;
+}
+
+bool QGeoTileFetcherQGC::_isStale(const QGeoTileSpec &spec) const
+{
+    if (m_viewports.isEmpty()) {
+        return false;
+    }
+
+    for (const Viewport_t &viewport : m_viewports) {
+        const int zoomLevels = std::abs(spec.zoom() - static_cast<int>(std::floor(viewport.zoomLevel)));
+        if ((zoomLevels <= kStaleZoomLevels) && (_tileDistance(spec, viewport) <= kStaleTileDistance)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 QNetworkRequest QGeoTileFetcherQGC::getNetworkRequest(int mapId, int x, int y, int zoom)
 {
     const SharedMapProvider mapProvider = UrlFactory::getMapProviderFromQtMapId(mapId);
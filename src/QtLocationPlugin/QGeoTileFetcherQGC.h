@@ -10,8 +10,12 @@
 #pragma once
 
 #include <QtLocation/private/qgeotilefetcher_p.h>
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
 #include <QtNetwork/QNetworkRequest>
+#include <QtPositioning/QGeoCoordinate>
 
 Q_DECLARE_LOGGING_CATEGORY(QGeoTileFetcherQGCLog)
 
@@ -31,8 +35,24 @@ public:
 
     static QNetworkRequest getNetworkRequest(int mapId, int x, int y, int zoom);
     /* Note: QNetworkAccessManager queues the requests it receives. The number of requests executed in parallel is dependent on the protocol.
-     * Currently, for the HTTP protocol on desktop platforms, 6 requests are executed in parallel for one host/port combination. */
-    static uint32_t concurrentDownloads(const QString &type) { Q_UNUSED(type); return 6; }
+     * Currently, for the HTTP/1 protocol on desktop platforms, 6 requests are executed in parallel for one host/port combination.
+     * HTTP/2 multiplexes all requests over a single connection. */
+    static uint32_t concurrentDownloads(const QString &type);
+    /// @return Limit for tiles fetched for map views of the provider type, separate from the bulk download limit
+    static int interactiveDownloads(const QString &type);
+    /// @return Bulk download limit in tiles per second for the provider type, 0 for no limit
+    static double maxDownloadRate(const QString &type);
+
+    QNetworkAccessManager *networkManager() const { return m_networkManager; }
+
+    /// Updates the view of a map. Tile downloads are ordered by their distance to the closest map view and downloads
+    /// which no map view needs any more are aborted.
+    void updateViewport(const QObject *map, const QGeoCoordinate &center, double zoomLevel);
+    void removeViewport(const QObject *map);
+
+    /// Queues the download of a tile which is not in the cache. The reply is started through
+    /// QGeoTiledMapReplyQGC::startNetworkRequest once its provider has a free download slot.
+    void queueNetworkRequest(QGeoTiledMapReplyQGC *reply);
 
 private:
     QGeoTiledMapReply* getTileImage(const QGeoTileSpec &spec) final;
@@ -41,9 +61,31 @@ private:
     void timerEvent(QTimerEvent *event) final;
     void handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &spec) final;
 
+    struct Viewport_t {
+        QGeoCoordinate center;
+        double zoomLevel = 0.;
+    };
+
+    void _startQueuedRequests();
+    void _releaseRequest(QObject *reply);
+    void _abortStaleRequests();
+    double _tilePriority(const QGeoTileSpec &spec) const;
+    bool _isStale(const QGeoTileSpec &spec) const;
+    static double _tileDistance(const QGeoTileSpec &spec, const Viewport_t &viewport);
+
     QNetworkAccessManager *m_networkManager = nullptr;
     // QNetworkDiskCache *m_diskCache = nullptr;
 
+    QHash<const QObject*, Viewport_t> m_viewports;
+    QList<QGeoTiledMapReplyQGC*> m_queuedReplies;
+    QHash<QObject*, int> m_activeReplies;   ///< Reply to Qt map id
+    QTimer m_staleRequestTimer;             ///< Coalesces the stale request checks of view changes
+
+    static constexpr double kZoomLevelPriority = 4.;    ///< Priority cost of a zoom level away from the view, in tiles
+    static constexpr int kStaleZoomLevels = 2;          ///< Matches QGeoTiledMap::PrefetchTwoNeighbourLayers
+    static constexpr double kStaleTileDistance = 16.;   ///< Beyond the visible and prefetched tiles of a view
+    static constexpr int kStaleRequestCheckMsecs = 250;
+
 #if defined Q_OS_MAC
     static constexpr const char* s_userAgent = "Mozilla/5.0 (Macintosh; Intel Mac OS X 14.5; rv:125.0) Gecko/20100101 Firefox/125.0";
 #elif defined Q_OS_WIN
@@ -9,19 +9,32 @@
 
 #include "QGeoTiledMapQGC.h"
 #include "QGeoTiledMappingManagerEngineQGC.h"
+#include "QGeoTileFetcherQGC.h"
 #include <QGCLoggingCategory.h>
 
 QGC_LOGGING_CATEGORY(QGeoTiledMapQGCLog, "qgc.qtlocationplugin.qgeotiledmapqgc")
 
 QGeoTiledMapQGC::QGeoTiledMapQGC(QGeoTiledMappingManagerEngineQGC *engine, QObject *parent)
     : QGeoTiledMap(engine, parent)
+    , _tileFetcher(engine->tileFetcherQGC())
 {
 	// qCDebug(QGeoTiledMapQGCLog) << Q_FUNC_INFO << this;
+
+    // Lets the fetcher download the tiles closest to the view first and drop the ones left behind
+    (void) connect(this, &QGeoMap::cameraDataChanged, this, [this](const QGeoCameraData &cameraData) {
+        if (_tileFetcher) {
+            _tileFetcher->updateViewport(this, cameraData.center(), cameraData.zoomLevel());
+        }
+    });
 }
 
 QGeoTiledMapQGC::~QGeoTiledMapQGC()
 {
     // qCDebug(QGeoTiledMapQGCLog) << Q_FUNC_INFO << this;
+
+    if (_tileFetcher) {
+        _tileFetcher->removeViewport(this);
+    }
 }
 
 QGeoMap::Capabilities QGeoTiledMapQGC::capabilities() const
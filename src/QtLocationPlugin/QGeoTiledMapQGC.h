@@ -11,10 +11,12 @@
 
 #include <QtLocation/private/qgeotiledmap_p.h>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
 
 Q_DECLARE_LOGGING_CATEGORY(QGeoTiledMapQGCLog)
 
 class QGeoTiledMappingManagerEngineQGC;
+class QGeoTileFetcherQGC;
 
 class QGeoTiledMapQGC : public QGeoTiledMap
 {
@@ -27,5 +29,7 @@ public:
     QGeoMap::Capabilities capabilities() const final;
 
 private:
+    QPointer<QGeoTileFetcherQGC> _tileFetcher;
+
     // void evaluateCopyrights(const QSet<QGeoTileSpec> &visibleTiles) final;
 };
@@ -83,8 +83,8 @@ QGeoTiledMappingManagerEngineQGC::QGeoTiledMappingManagerEngineQGC(const QVarian
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
 
-    QGeoTileFetcherQGC* const tileFetcher = new QGeoTileFetcherQGC(m_networkManager, parameters, this);
-    setTileFetcher(tileFetcher); // Calls engineInitialized
+    m_tileFetcher = new QGeoTileFetcherQGC(m_networkManager, parameters, this);
+    setTileFetcher(m_tileFetcher); // Calls engineInitialized
 }
 
 QGeoTiledMappingManagerEngineQGC::~QGeoTiledMappingManagerEngineQGC()
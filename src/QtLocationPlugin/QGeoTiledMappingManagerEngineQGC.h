@@ -15,6 +15,7 @@
 
 Q_DECLARE_LOGGING_CATEGORY(QGeoTiledMappingManagerEngineQGCLog)
 
+class QGeoTileFetcherQGC;
 class QNetworkAccessManager;
 
 class QGeoTiledMappingManagerEngineQGC : public QGeoTiledMappingManagerEngine
@@ -27,7 +28,9 @@ public:
 
     QGeoMap* createMap() final;
     QNetworkAccessManager* networkManager() const { return m_networkManager; }
+    QGeoTileFetcherQGC* tileFetcherQGC() const { return m_tileFetcher; }
 
 private:
     QNetworkAccessManager *m_networkManager = nullptr;
+    QGeoTileFetcherQGC *m_tileFetcher = nullptr;
 };
@@ -214,7 +214,7 @@ Item {
     QGCFileDialog {
         id:             fileDialog
         folder:         QGroundControl.settingsManager.appSettings.missionSavePath
-        nameFilters:    [ qsTr("Tile Sets (*.%1)").arg(defaultSuffix) ]
+        nameFilters:    [ qsTr("Tile Sets (*.%1)").arg(defaultSuffix), qsTr("Tile Packs (*.%1)").arg(QGroundControl.mapEngineManager.tilePackFileExtension), qsTr("Terrain Packs (*.%1)").arg(QGroundControl.mapEngineManager.terrainPackFileExtension), qsTr("Elevation Models (*.tif *.tiff)") ]
         defaultSuffix:  _appSettings.tilesetFileExtension
 
         onAcceptedForSave: (file) => {
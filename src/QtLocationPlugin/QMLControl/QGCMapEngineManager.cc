@@ -19,8 +19,14 @@
 #include "QmlObjectListModel.h"
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
+#include "QGCTilePack.h"
+#include "TerrainDem.h"
+#include "TerrainPack.h"
+#include "TerrainTileManager.h"
 
 #include <QtCore/qapplicationstatic.h>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QSettings>
 #include <QtCore/QStorageInfo>
@@ -45,6 +51,7 @@ QGCMapEngineManager::QGCMapEngineManager(QObject *parent)
     qmlRegisterUncreatableType<QGCMapEngineManager>("QGroundControl.QGCMapEngineManager", 1, 0, "QGCMapEngineManager", "Reference only");
 
     (void) connect(getQGCMapEngine(), &QGCMapEngine::updateTotals, this, &QGCMapEngineManager::_updateTotals);
+    (void) connect(TerrainTileManager::instance(), &TerrainTileManager::terrainPackExported, this, &QGCMapEngineManager::_terrainPackExported);
 
    _updateDiskFreeSpace();
 
@@ -281,6 +288,9 @@ void QGCMapEngineManager::taskError(QGCMapTask::TaskType type, const QString &er
     case QGCMapTask::taskExport:
         task = QStringLiteral("Export Tile Sets");
         break;
+    case QGCMapTask::taskImport:
+        task = QStringLiteral("Import Tile Sets");
+        break;
     default:
         task = QStringLiteral("Database Error");
         break;
@@ -384,6 +394,10 @@ bool QGCMapEngineManager::importSets(const QString &path)
         return false;
     }
 
+    if (_isTerrainPack(path) || TerrainDem::isDemFile(path)) {
+        return _importTerrainPack(path);
+    }
+
     setImportAction(ActionImporting);
 
     QGCImportTileTask* const task = new QGCImportTileTask(path, _importReplace);
@@ -416,6 +430,10 @@ bool QGCMapEngineManager::exportSets(const QString &path)
         return false;
     }
 
+    if (_isTerrainPack(path)) {
+        return _exportTerrainPack(path, sets);
+    }
+
     setImportAction(ActionExporting);
 
     QGCExportTileTask* const task = new QGCExportTileTask(sets, path);
@@ -437,6 +455,105 @@ void QGCMapEngineManager::_actionCompleted()
     }
 }
 
+QString QGCMapEngineManager::terrainPackFileExtension()
+{
+    return QString(TerrainPack::fileExtension);
+}
+
+QString QGCMapEngineManager::tilePackFileExtension()
+{
+    return QString(QGCTilePack::fileExtension);
+}
+
+bool QGCMapEngineManager::_isTerrainPack(const QString &path)
+{
+    return path.endsWith(QStringLiteral(".") + terrainPackFileExtension(), Qt::CaseInsensitive);
+}
+
+/// Terrain packs and GeoTIFF elevation models are copied to the terrain pack directory, where they are memory mapped
+/// on each start
+bool QGCMapEngineManager::_importTerrainPack(const QString &path)
+{
+    QString errorString;
+    if (TerrainDem::isDemFile(path)) {
+        TerrainDem dem;
+        if (!dem.open(path, errorString)) {
+            taskError(QGCMapTask::taskImport, errorString);
+            return false;
+        }
+    } else {
+        TerrainPack pack;
+        if (!pack.open(path, errorString)) {
+            taskError(QGCMapTask::taskImport, errorString);
+            return false;
+        }
+    }
+
+    const QString packDirPath = getQGCMapEngine()->getTerrainPackPath();
+    if (!QDir::root().mkpath(packDirPath)) {
+        taskError(QGCMapTask::taskImport, tr("Could not create terrain pack directory %1").arg(packDirPath));
+        return false;
+    }
+
+    const QString packPath = QDir(packDirPath).absoluteFilePath(QFileInfo(path).fileName());
+    if (QFileInfo(path).absoluteFilePath() != packPath) {
+        setImportAction(ActionImporting);
+
+        // A pack of the same name may be mapped, release all packs while the file is replaced
+        TerrainTileManager::instance()->unloadTerrainPacks();
+        (void) QFile::remove(packPath);
+        const bool copied = QFile::copy(path, packPath);
+        TerrainTileManager::instance()->loadTerrainPacks(packDirPath);
+
+        if (!copied) {
+            setImportAction(ActionNone);
+            taskError(QGCMapTask::taskImport, tr("Could not copy terrain pack to %1").arg(packPath));
+            return false;
+        }
+    }
+
+    setImportAction(ActionDone);
+
+    return true;
+}
+
+/// Exports the terrain covering the combined area of the specified tile sets
+bool QGCMapEngineManager::_exportTerrainPack(const QString &path, const QVector<QGCCachedTileSet*> &sets)
+{
+    QGeoCoordinate northWest(sets.first()->topleftLat(), sets.first()->topleftLon());
+    QGeoCoordinate southEast(sets.first()->bottomRightLat(), sets.first()->bottomRightLon());
+    for (const QGCCachedTileSet *set : sets) {
+        northWest.setLatitude(qMax(northWest.latitude(), set->topleftLat()));
+        northWest.setLongitude(qMin(northWest.longitude(), set->topleftLon()));
+        southEast.setLatitude(qMin(southEast.latitude(), set->bottomRightLat()));
+        southEast.setLongitude(qMax(southEast.longitude(), set->bottomRightLon()));
+    }
+
+    QString errorString;
+    if (!TerrainTileManager::instance()->exportTerrainPack(path, northWest, southEast, errorString)) {
+        taskError(QGCMapTask::taskExport, errorString);
+        return false;
+    }
+
+    setImportAction(ActionExporting);
+
+    return true;
+}
+
+void QGCMapEngineManager::_terrainPackExported(const QString &fileName, bool success, const QString &errorString)
+{
+    Q_UNUSED(fileName);
+
+    if (_importAction != ActionExporting) {
+        return;
+    }
+
+    if (!success) {
+        taskError(QGCMapTask::taskExport, errorString);
+    }
+    setImportAction(ActionDone);
+}
+
 QString QGCMapEngineManager::getUniqueName() const
 {
     int count = 1;
@@ -41,6 +41,8 @@ class QGCMapEngineManager : public QObject
     Q_PROPERTY(QString              errorMessage    READ errorMessage                               NOTIFY errorMessageChanged)
     Q_PROPERTY(QString              tileCountStr    READ tileCountStr                               NOTIFY tileCountChanged)
     Q_PROPERTY(QString              tileSizeStr     READ tileSizeStr                                NOTIFY tileSizeChanged)
+    Q_PROPERTY(QString              terrainPackFileExtension READ terrainPackFileExtension              CONSTANT)
+    Q_PROPERTY(QString              tilePackFileExtension READ tilePackFileExtension                    CONSTANT)
     Q_PROPERTY(QStringList          mapList         READ mapList                                    CONSTANT)
     Q_PROPERTY(QStringList          mapProviderList READ mapProviderList                            CONSTANT)
     Q_PROPERTY(quint32              diskSpace       READ diskSpace)
@@ -85,6 +87,8 @@ public:
     QString errorMessage() const { return _errorMessage; }
     QString tileCountStr() const;
     QString tileSizeStr() const;
+    static QString terrainPackFileExtension();
+    static QString tilePackFileExtension();
     quint64 diskSpace() const { return _diskSpace; }
     quint64 freeDiskSpace() const { return _freeDiskSpace; }
     quint64 tileCount() const { return (_imageSet.tileCount + _elevationSet.tileCount); }
@@ -121,9 +125,13 @@ private slots:
     void _tileSetFetched(QGCCachedTileSet *tileSets);
     void _tileSetSaved(QGCCachedTileSet *set);
     void _updateTotals(quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize);
+    void _terrainPackExported(const QString &fileName, bool success, const QString &errorString);
 
 private:
     void _updateDiskFreeSpace(); 
+    bool _importTerrainPack(const QString &path);
+    bool _exportTerrainPack(const QString &path, const QVector<QGCCachedTileSet*> &sets);
+    static bool _isTerrainPack(const QString &path);
 
     QmlObjectListModel *_tileSets = nullptr;
     QGCTileSet _imageSet;
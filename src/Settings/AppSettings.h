@@ -34,6 +34,7 @@ public:
     DEFINE_SETTINGFACT(defaultMissionItemAltitude)
     DEFINE_SETTINGFACT(telemetrySave)
     DEFINE_SETTINGFACT(telemetrySaveNotArmed)
+    DEFINE_SETTINGFACT(telemetrySyncInterval)
     DEFINE_SETTINGFACT(audioMuted)
     DEFINE_SETTINGFACT(virtualJoystick)
     DEFINE_SETTINGFACT(virtualJoystickAutoCenterThrottle)
@@ -54,6 +55,7 @@ public:
     DEFINE_SETTINGFACT(qLocaleLanguage)
     DEFINE_SETTINGFACT(disableAllPersistence)
     DEFINE_SETTINGFACT(saveCsvTelemetry)
+    DEFINE_SETTINGFACT(saveTelemetryArchive)
     DEFINE_SETTINGFACT(firstRunPromptIdsShown)
     DEFINE_SETTINGFACT(forwardMavlink)
     DEFINE_SETTINGFACT(forwardMavlinkHostName)
@@ -61,6 +63,12 @@ public:
     DEFINE_SETTINGFACT(loginAirLink)
     DEFINE_SETTINGFACT(passAirLink)
     DEFINE_SETTINGFACT(mavlink2SigningKey)
+    DEFINE_SETTINGFACT(decodeMavlinkOnLinkThread)
+    DEFINE_SETTINGFACT(pipelinedPlanTransfer)
+    DEFINE_SETTINGFACT(partialPlanUpload)
+    DEFINE_SETTINGFACT(adaptiveStreamRates)
+    DEFINE_SETTINGFACT(trickleBackgroundVehicles)
+    DEFINE_SETTINGFACT(fleetOverview)
 
     // Although this is a global setting it only affects ArduPilot vehicle since PX4 automatically starts the stream from the vehicle side
     DEFINE_SETTINGFACT(apmStartMavlinkStreams)
@@ -23,6 +23,9 @@ DECLARE_SETTINGSFACT(GimbalControllerSettings, ControlType)
 DECLARE_SETTINGSFACT(GimbalControllerSettings, CameraVFov)
 DECLARE_SETTINGSFACT(GimbalControllerSettings, CameraHFov)
 DECLARE_SETTINGSFACT(GimbalControllerSettings, CameraSlideSpeed)
+DECLARE_SETTINGSFACT(GimbalControllerSettings, LatencyCompensation)
+DECLARE_SETTINGSFACT(GimbalControllerSettings, ControlRate)
+DECLARE_SETTINGSFACT(GimbalControllerSettings, VideoLatency)
 DECLARE_SETTINGSFACT(GimbalControllerSettings, showAzimuthIndicatorOnMap)
 DECLARE_SETTINGSFACT(GimbalControllerSettings, toolbarIndicatorShowAzimuth)
 DECLARE_SETTINGSFACT(GimbalControllerSettings, toolbarIndicatorShowAcquireReleaseControl)
\ No newline at end of file
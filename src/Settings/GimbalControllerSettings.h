@@ -23,6 +23,9 @@ public:
     DEFINE_SETTINGFACT(CameraVFov)
     DEFINE_SETTINGFACT(CameraHFov)
     DEFINE_SETTINGFACT(CameraSlideSpeed)
+    DEFINE_SETTINGFACT(LatencyCompensation)
+    DEFINE_SETTINGFACT(ControlRate)
+    DEFINE_SETTINGFACT(VideoLatency)
     DEFINE_SETTINGFACT(showAzimuthIndicatorOnMap)
     DEFINE_SETTINGFACT(toolbarIndicatorShowAzimuth)
     DEFINE_SETTINGFACT(toolbarIndicatorShowAcquireReleaseControl)
@@ -40,3 +40,10 @@ DECLARE_SETTINGGROUP(Maps, "Maps")
 
 DECLARE_SETTINGSFACT(MapsSettings, maxCacheDiskSize)
 DECLARE_SETTINGSFACT(MapsSettings, maxCacheMemorySize)
+DECLARE_SETTINGSFACT(MapsSettings, maxTileMemoryCacheSize)
+DECLARE_SETTINGSFACT(MapsSettings, maxTerrainMemoryCacheSize)
+DECLARE_SETTINGSFACT(MapsSettings, maxTileDownloadRate)
+DECLARE_SETTINGSFACT(MapsSettings, concurrentCacheAccess)
+DECLARE_SETTINGSFACT(MapsSettings, localTileFile)
+DECLARE_SETTINGSFACT(MapsSettings, vectorTileURL)
+DECLARE_SETTINGSFACT(MapsSettings, vectorTileStyleFile)
@@ -21,4 +21,11 @@ public:
 
     DEFINE_SETTINGFACT(maxCacheDiskSize)
     DEFINE_SETTINGFACT(maxCacheMemorySize)
+    DEFINE_SETTINGFACT(maxTileMemoryCacheSize)
+    DEFINE_SETTINGFACT(maxTerrainMemoryCacheSize)
+    DEFINE_SETTINGFACT(maxTileDownloadRate)
+    DEFINE_SETTINGFACT(concurrentCacheAccess)
+    DEFINE_SETTINGFACT(localTileFile)
+    DEFINE_SETTINGFACT(vectorTileURL)
+    DEFINE_SETTINGFACT(vectorTileStyleFile)
 };
@@ -23,3 +23,4 @@ DECLARE_SETTINGSFACT(RTKSettings, fixedBasePositionLatitude)
 DECLARE_SETTINGSFACT(RTKSettings, fixedBasePositionLongitude)
 DECLARE_SETTINGSFACT(RTKSettings, fixedBasePositionAltitude)
 DECLARE_SETTINGSFACT(RTKSettings, fixedBasePositionAccuracy)
+DECLARE_SETTINGSFACT(RTKSettings, rtcmBandwidthLimit)
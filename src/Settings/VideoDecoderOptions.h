@@ -17,4 +17,5 @@ enum VideoDecoderOptions {
     ForceVideoDecoderVAAPI,
     ForceVideoDecoderDirectX3D,
     ForceVideoDecoderVideoToolbox,
+    ForceVideoDecoderV4L2,
 };
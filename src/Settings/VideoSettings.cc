@@ -63,14 +63,17 @@ DECLARE_SETTINGGROUP(Video, "Video")
 #elif defined(Q_OS_WIN)
         VideoDecoderOptions::ForceVideoDecoderVAAPI,
         VideoDecoderOptions::ForceVideoDecoderVideoToolbox,
+        VideoDecoderOptions::ForceVideoDecoderV4L2,
 #elif defined(Q_OS_MAC)
         VideoDecoderOptions::ForceVideoDecoderDirectX3D,
         VideoDecoderOptions::ForceVideoDecoderVAAPI,
+        VideoDecoderOptions::ForceVideoDecoderV4L2,
 #elif defined(Q_OS_ANDROID)
         VideoDecoderOptions::ForceVideoDecoderDirectX3D,
         VideoDecoderOptions::ForceVideoDecoderVideoToolbox,
         VideoDecoderOptions::ForceVideoDecoderVAAPI,
         VideoDecoderOptions::ForceVideoDecoderNVIDIA,
+        VideoDecoderOptions::ForceVideoDecoderV4L2,
 #endif
     };
 
@@ -97,11 +100,15 @@ DECLARE_SETTINGSFACT(VideoSettings, gridLines)
 DECLARE_SETTINGSFACT(VideoSettings, showRecControl)
 DECLARE_SETTINGSFACT(VideoSettings, recordingFormat)
 DECLARE_SETTINGSFACT(VideoSettings, maxVideoSize)
+DECLARE_SETTINGSFACT(VideoSettings, recordingPreRoll)
+DECLARE_SETTINGSFACT(VideoSettings, recordTelemetrySidecar)
+DECLARE_SETTINGSFACT(VideoSettings, recordVideoMetadata)
 DECLARE_SETTINGSFACT(VideoSettings, enableStorageLimit)
 DECLARE_SETTINGSFACT(VideoSettings, rtspTimeout)
 DECLARE_SETTINGSFACT(VideoSettings, streamEnabled)
 DECLARE_SETTINGSFACT(VideoSettings, disableWhenDisarmed)
 DECLARE_SETTINGSFACT(VideoSettings, lowLatencyMode)
+DECLARE_SETTINGSFACT(VideoSettings, adaptiveStreamQuality)
 
 DECLARE_SETTINGSFACT_NO_FUNC(VideoSettings, videoSource)
 {
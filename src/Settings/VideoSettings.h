@@ -30,11 +30,15 @@ public:
     DEFINE_SETTINGFACT(showRecControl)
     DEFINE_SETTINGFACT(recordingFormat)
     DEFINE_SETTINGFACT(maxVideoSize)
+    DEFINE_SETTINGFACT(recordingPreRoll)
+    DEFINE_SETTINGFACT(recordTelemetrySidecar)
+    DEFINE_SETTINGFACT(recordVideoMetadata)
     DEFINE_SETTINGFACT(enableStorageLimit)
     DEFINE_SETTINGFACT(rtspTimeout)
     DEFINE_SETTINGFACT(streamEnabled)
     DEFINE_SETTINGFACT(disableWhenDisarmed)
     DEFINE_SETTINGFACT(lowLatencyMode)
+    DEFINE_SETTINGFACT(adaptiveStreamQuality)
     DEFINE_SETTINGFACT(forceVideoDecoder)
 
     Q_ENUM(VideoDecoderOptions)
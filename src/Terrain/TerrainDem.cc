@@ -0,0 +1,928 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainDem.h"
+#include "QGCGeo.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QSet>
+#include <QtCore/QtEndian>
+#include <QtCore/QtMath>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+QGC_LOGGING_CATEGORY(TerrainDemLog, "qgc.terrain.terraindem")
+
+namespace {
+    enum Tag : quint16 {
+        TagNewSubfileType =         254,
+        TagImageWidth =             256,
+        TagImageLength =            257,
+        TagBitsPerSample =          258,
+        TagCompression =            259,
+        TagStripOffsets =           273,
+        TagSamplesPerPixel =        277,
+        TagRowsPerStrip =           278,
+        TagStripByteCounts =        279,
+        TagPredictor =              317,
+        TagTileWidth =              322,
+        TagTileLength =             323,
+        TagTileOffsets =            324,
+        TagTileByteCounts =         325,
+        TagSampleFormat =           339,
+        TagModelPixelScale =        33550,
+        TagModelTiepoint =          33922,
+        TagModelTransformation =    34264,
+        TagGeoKeyDirectory =        34735,
+        TagGdalNoData =             42113,
+    };
+
+    enum GeoKey : quint16 {
+        GeoKeyModelType =           1024,
+        GeoKeyRasterType =          1025,
+        GeoKeyGeographicType =      2048,
+        GeoKeyProjectedType =       3072,
+    };
+
+    constexpr quint32 kSubfileReducedImage =    1;
+    constexpr quint32 kSubfilePageOrMask =      2 | 4;
+    constexpr quint16 kModelTypeProjected =     1;
+    constexpr quint16 kModelTypeGeographic =    2;
+    constexpr quint16 kRasterPixelIsPoint =     2;
+    constexpr double kMetersPerDegree =         111320.;
+
+    /// Size of one value of each TIFF field type, 0 for unknown types
+    quint64 fieldTypeSize(quint16 type)
+    {
+        switch (type) {
+        case 1: case 2: case 6: case 7:     // BYTE, ASCII, SBYTE, UNDEFINED
+            return 1;
+        case 3: case 8:                     // SHORT, SSHORT
+            return 2;
+        case 4: case 9: case 11:            // LONG, SLONG, FLOAT
+            return 4;
+        case 5: case 10: case 12:           // RATIONAL, SRATIONAL, DOUBLE
+        case 16: case 17: case 18:          // LONG8, SLONG8, IFD8
+            return 8;
+        default:
+            return 0;
+        }
+    }
+}
+
+TerrainDem::~TerrainDem()
+{
+    if (_data) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+    }
+}
+
+bool TerrainDem::isDemFile(const QString &fileName)
+{
+    const QString suffix = QFileInfo(fileName).suffix();
+    for (const char *extension : fileExtensions) {
+        if (suffix.compare(QLatin1String(extension), Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TerrainDem::open(const QString &fileName, QString &errorString)
+{
+    errorString.clear();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    _size = static_cast<quint64>(_file.size());
+    if (_size < 16) {
+        errorString = QStringLiteral("Not a GeoTIFF file");
+        return false;
+    }
+
+    _data = _file.map(0, _file.size());
+    if (!_data) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    return _readHeader(errorString);
+}
+
+quint16 TerrainDem::_read16(quint64 offset) const
+{
+    return _bigEndian ? qFromBigEndian<quint16>(_data + offset) : qFromLittleEndian<quint16>(_data + offset);
+}
+
+quint32 TerrainDem::_read32(quint64 offset) const
+{
+    return _bigEndian ? qFromBigEndian<quint32>(_data + offset) : qFromLittleEndian<quint32>(_data + offset);
+}
+
+quint64 TerrainDem::_read64(quint64 offset) const
+{
+    return _bigEndian ? qFromBigEndian<quint64>(_data + offset) : qFromLittleEndian<quint64>(_data + offset);
+}
+
+bool TerrainDem::_readHeader(QString &errorString)
+{
+    if ((_data[0] == 'I') && (_data[1] == 'I')) {
+        _bigEndian = false;
+    } else if ((_data[0] == 'M') && (_data[1] == 'M')) {
+        _bigEndian = true;
+    } else {
+        errorString = QStringLiteral("Not a GeoTIFF file");
+        return false;
+    }
+
+    quint64 offset = 0;
+    switch (_read16(2)) {
+    case 42:
+        _bigTiff = false;
+        offset = _read32(4);
+        break;
+    case 43:
+        _bigTiff = true;
+        if (_read16(4) != 8) {
+            errorString = QStringLiteral("Unsupported BigTIFF offset size");
+            return false;
+        }
+        offset = _read64(8);
+        break;
+    default:
+        errorString = QStringLiteral("Not a GeoTIFF file");
+        return false;
+    }
+
+    QSet<quint64> visited;
+    QList<Level_t> overviews;
+    while (offset != 0) {
+        if (visited.contains(offset)) {
+            break;
+        }
+        visited.insert(offset);
+
+        Level_t level;
+        quint32 subfileType = 0;
+        quint64 nextOffset = 0;
+        GeoTags_t geoTags;
+        QString directoryError;
+        const bool valid = _readDirectory(offset, level, subfileType, geoTags, nextOffset, directoryError);
+
+        if (_levels.isEmpty()) {
+            // The first image is the full resolution raster and holds the georeferencing
+            if (!valid) {
+                errorString = directoryError;
+                return false;
+            }
+            if (!_readGeoreferencing(geoTags, level, errorString)) {
+                return false;
+            }
+            _levels.append(level);
+        } else if (!valid) {
+            qCWarning(TerrainDemLog) << "Skipped image of" << fileName() << directoryError;
+        } else if ((subfileType & kSubfileReducedImage) && !(subfileType & kSubfilePageOrMask)) {
+            overviews.append(level);
+        }
+
+        offset = nextOffset;
+    }
+
+    if (_levels.isEmpty()) {
+        errorString = QStringLiteral("GeoTIFF file has no image");
+        return false;
+    }
+
+    // Overviews cover the same area as the full resolution raster with fewer, larger values
+    const Level_t &full = _levels.first();
+    std::sort(overviews.begin(), overviews.end(), [](const Level_t &a, const Level_t &b) { return a.width > b.width; });
+    for (Level_t &overview : overviews) {
+        overview.cornerX = full.cornerX;
+        overview.cornerY = full.cornerY;
+        overview.scaleX = full.scaleX * full.width / overview.width;
+        overview.scaleY = full.scaleY * full.height / overview.height;
+        overview.resolutionMeters = full.resolutionMeters * full.width / overview.width;
+        _levels.append(overview);
+    }
+
+    qCDebug(TerrainDemLog) << "Opened" << fileName() << "size:" << full.width << full.height << "resolution:" << full.resolutionMeters << "overviews:" << overviews.count() << "bounds:" << _bounds;
+
+    return true;
+}
+
+bool TerrainDem::_readValues(quint16 type, quint64 count, quint64 valueOffset, QList<double> &values) const
+{
+    values.resize(static_cast<qsizetype>(count));
+
+    const quint64 size = fieldTypeSize(type);
+    for (quint64 i = 0; i < count; i++) {
+        const quint64 offset = valueOffset + (i * size);
+        double value = 0;
+        switch (type) {
+        case 1: case 2: case 7:
+            value = _data[offset];
+            break;
+        case 6:
+            value = static_cast<qint8>(_data[offset]);
+            break;
+        case 3:
+            value = _read16(offset);
+            break;
+        case 8:
+            value = static_cast<qint16>(_read16(offset));
+            break;
+        case 4:
+            value = _read32(offset);
+            break;
+        case 9:
+            value = static_cast<qint32>(_read32(offset));
+            break;
+        case 5:
+            value = _read32(offset + 4) ? (static_cast<double>(_read32(offset)) / _read32(offset + 4)) : 0;
+            break;
+        case 10:
+            value = _read32(offset + 4) ? (static_cast<double>(static_cast<qint32>(_read32(offset))) / static_cast<qint32>(_read32(offset + 4))) : 0;
+            break;
+        case 11: {
+            const quint32 bits = _read32(offset);
+            float floatValue;
+            memcpy(&floatValue, &bits, sizeof(floatValue));
+            value = floatValue;
+            break;
+        }
+        case 12: {
+            const quint64 bits = _read64(offset);
+            memcpy(&value, &bits, sizeof(value));
+            break;
+        }
+        case 16: case 18:
+            value = static_cast<double>(_read64(offset));
+            break;
+        case 17:
+            value = static_cast<double>(static_cast<qint64>(_read64(offset)));
+            break;
+        default:
+            return false;
+        }
+        values[static_cast<qsizetype>(i)] = value;
+    }
+
+    return true;
+}
+
+bool TerrainDem::_readDirectory(quint64 offset, Level_t &level, quint32 &subfileType, GeoTags_t &geoTags, quint64 &nextOffset, QString &errorString)
+{
+    const quint64 countSize = _bigTiff ? 8 : 2;
+    const quint64 entrySize = _bigTiff ? 20 : 12;
+    const quint64 inlineSize = _bigTiff ? 8 : 4;
+
+    if ((offset + countSize) > _size) {
+        errorString = QStringLiteral("Image directory outside of file");
+        return false;
+    }
+    const quint64 entryCount = _bigTiff ? _read64(offset) : _read16(offset);
+    const quint64 entriesOffset = offset + countSize;
+    if ((entryCount > (_size / entrySize)) || ((entriesOffset + (entryCount * entrySize) + inlineSize) > _size)) {
+        errorString = QStringLiteral("Image directory outside of file");
+        return false;
+    }
+    const quint64 nextOffsetOffset = entriesOffset + (entryCount * entrySize);
+    nextOffset = _bigTiff ? _read64(nextOffsetOffset) : _read32(nextOffsetOffset);
+
+    quint32 rowsPerStrip = 0;
+    quint32 samplesPerPixel = 1;
+    QList<double> offsets;
+    QList<double> byteCounts;
+
+    for (quint64 i = 0; i < entryCount; i++) {
+        const quint64 entry = entriesOffset + (i * entrySize);
+        const quint16 tag = _read16(entry);
+        const quint16 type = _read16(entry + 2);
+        const quint64 count = _bigTiff ? _read64(entry + 4) : _read32(entry + 4);
+        const quint64 typeSize = fieldTypeSize(type);
+        if ((typeSize == 0) || (count == 0)) {
+            continue;
+        }
+        if (count > (_size / typeSize)) {
+            errorString = QStringLiteral("Invalid image directory entry");
+            return false;
+        }
+
+        const quint64 bytes = count * typeSize;
+        const quint64 valueField = entry + 4 + (_bigTiff ? 8 : 4);
+        const quint64 valueOffset = (bytes <= inlineSize) ? valueField : (_bigTiff ? _read64(valueField) : _read32(valueField));
+        if ((valueOffset > _size) || (bytes > (_size - valueOffset))) {
+            errorString = QStringLiteral("Image directory entry outside of file");
+            return false;
+        }
+
+        QList<double> values;
+        switch (tag) {
+        case TagNewSubfileType:
+        case TagImageWidth:
+        case TagImageLength:
+        case TagBitsPerSample:
+        case TagCompression:
+        case TagSamplesPerPixel:
+        case TagRowsPerStrip:
+        case TagPredictor:
+        case TagTileWidth:
+        case TagTileLength:
+        case TagSampleFormat:
+            // Only the first value matters, all samples are alike in a single band raster
+            (void) _readValues(type, 1, valueOffset, values);
+            break;
+        case TagStripOffsets:
+        case TagStripByteCounts:
+        case TagTileOffsets:
+        case TagTileByteCounts:
+        case TagModelPixelScale:
+        case TagModelTiepoint:
+        case TagModelTransformation:
+        case TagGeoKeyDirectory:
+            (void) _readValues(type, count, valueOffset, values);
+            break;
+        case TagGdalNoData:
+            geoTags.noData = QString::fromLatin1(reinterpret_cast<const char*>(_data + valueOffset), static_cast<qsizetype>(bytes)).remove(QChar('\0')).trimmed();
+            continue;
+        default:
+            continue;
+        }
+
+        const quint32 value = values.isEmpty() ? 0 : static_cast<quint32>(values.first());
+        switch (tag) {
+        case TagNewSubfileType:     subfileType = value;                            break;
+        case TagImageWidth:         level.width = value;                            break;
+        case TagImageLength:        level.height = value;                           break;
+        case TagBitsPerSample:      level.bitsPerSample = value;                    break;
+        case TagCompression:        level.compression = value;                      break;
+        case TagSamplesPerPixel:    samplesPerPixel = value;                        break;
+        case TagRowsPerStrip:       rowsPerStrip = value;                           break;
+        case TagPredictor:          level.predictor = value;                        break;
+        case TagTileWidth:          level.blockWidth = value;                       break;
+        case TagTileLength:         level.blockHeight = value;                      break;
+        case TagSampleFormat:       level.sampleFormat = value;                     break;
+        case TagStripOffsets:
+        case TagTileOffsets:        offsets = values;                               break;
+        case TagStripByteCounts:
+        case TagTileByteCounts:     byteCounts = values;                            break;
+        case TagModelPixelScale:    geoTags.pixelScale = values;                    break;
+        case TagModelTiepoint:      geoTags.tiepoints = values;                     break;
+        case TagModelTransformation: geoTags.transformation = values;              break;
+        case TagGeoKeyDirectory:    geoTags.geoKeys = values;                       break;
+        default:                                                                    break;
+        }
+    }
+
+    if ((subfileType & kSubfilePageOrMask) && !(subfileType & kSubfileReducedImage)) {
+        // Masks and other pages are of no interest, skip validating them
+        return true;
+    }
+
+    if ((level.width == 0) || (level.height == 0)) {
+        errorString = QStringLiteral("Image has no size");
+        return false;
+    }
+    if (samplesPerPixel != 1) {
+        errorString = QStringLiteral("Only single band elevation models are supported");
+        return false;
+    }
+
+    const bool validFormat =
+        (((level.sampleFormat == SampleFormatUnsigned) || (level.sampleFormat == SampleFormatSigned)) &&
+         ((level.bitsPerSample == 8) || (level.bitsPerSample == 16) || (level.bitsPerSample == 32))) ||
+        ((level.sampleFormat == SampleFormatFloat) && ((level.bitsPerSample == 32) || (level.bitsPerSample == 64)));
+    if (!validFormat) {
+        errorString = QStringLiteral("Unsupported sample format %1 with %2 bits").arg(level.sampleFormat).arg(level.bitsPerSample);
+        return false;
+    }
+
+    switch (level.compression) {
+    case CompressionNone:
+    case CompressionLzw:
+    case CompressionDeflate:
+    case CompressionDeflateLegacy:
+        break;
+    default:
+        errorString = QStringLiteral("Unsupported compression %1").arg(level.compression);
+        return false;
+    }
+    if ((level.predictor < 1) || (level.predictor > 3) || ((level.predictor == 3) && (level.sampleFormat != SampleFormatFloat))) {
+        errorString = QStringLiteral("Unsupported predictor %1").arg(level.predictor);
+        return false;
+    }
+    if ((level.predictor == 2) && (level.sampleFormat == SampleFormatFloat)) {
+        errorString = QStringLiteral("Unsupported predictor %1").arg(level.predictor);
+        return false;
+    }
+
+    level.tiled = (level.blockWidth != 0) && (level.blockHeight != 0);
+    if (!level.tiled) {
+        // Stripped image, each strip is a block as wide as the image
+        level.blockWidth = level.width;
+        level.blockHeight = ((rowsPerStrip == 0) || (rowsPerStrip > level.height)) ? level.height : rowsPerStrip;
+    }
+    level.blocksAcross = (level.width + level.blockWidth - 1) / level.blockWidth;
+    const quint64 blocksDown = (level.height + level.blockHeight - 1) / level.blockHeight;
+    const quint64 blockCount = static_cast<quint64>(level.blocksAcross) * blocksDown;
+    if ((static_cast<quint64>(offsets.count()) != blockCount) || (static_cast<quint64>(byteCounts.count()) != blockCount)) {
+        errorString = QStringLiteral("Image block offsets do not match its size");
+        return false;
+    }
+
+    level.blockOffsets.resize(offsets.count());
+    level.blockByteCounts.resize(byteCounts.count());
+    for (qsizetype i = 0; i < offsets.count(); i++) {
+        level.blockOffsets[i] = static_cast<quint64>(offsets[i]);
+        level.blockByteCounts[i] = static_cast<quint64>(byteCounts[i]);
+    }
+
+    return true;
+}
+
+bool TerrainDem::_readGeoreferencing(const GeoTags_t &geoTags, Level_t &level, QString &errorString)
+{
+    // Key directory: version, revision, minor revision, key count, then four values per key. Only keys with a value
+    // in place are needed.
+    quint16 modelType = 0;
+    quint16 rasterType = 0;
+    quint16 geographicType = 0;
+    quint16 projectedType = 0;
+    const QList<double> &keys = geoTags.geoKeys;
+    const qsizetype keyCount = (keys.count() >= 4) ? qMin<qsizetype>(static_cast<qsizetype>(keys[3]), (keys.count() - 4) / 4) : 0;
+    for (qsizetype i = 0; i < keyCount; i++) {
+        const qsizetype key = 4 + (i * 4);
+        if (keys[key + 1] != 0) {
+            continue;
+        }
+        const quint16 value = static_cast<quint16>(keys[key + 3]);
+        switch (static_cast<quint16>(keys[key])) {
+        case GeoKeyModelType:       modelType = value;      break;
+        case GeoKeyRasterType:      rasterType = value;     break;
+        case GeoKeyGeographicType:  geographicType = value; break;
+        case GeoKeyProjectedType:   projectedType = value;  break;
+        default:                                            break;
+        }
+    }
+
+    if (modelType == kModelTypeProjected) {
+        // WGS84 UTM north and south, NAD83 UTM and ETRS89 UTM
+        _geographic = false;
+        if ((projectedType >= 32601) && (projectedType <= 32660)) {
+            _utmZone = projectedType - 32600;
+        } else if ((projectedType >= 32701) && (projectedType <= 32760)) {
+            _utmZone = projectedType - 32700;
+            _utmSouth = true;
+        } else if ((projectedType >= 26901) && (projectedType <= 26923)) {
+            _utmZone = projectedType - 26900;
+        } else if ((projectedType >= 25828) && (projectedType <= 25838)) {
+            _utmZone = projectedType - 25800;
+        } else {
+            errorString = QStringLiteral("Unsupported projection EPSG:%1, the elevation model must be in WGS84 or UTM").arg(projectedType);
+            return false;
+        }
+    } else if ((modelType == kModelTypeGeographic) || ((modelType == 0) && (geographicType != 0))) {
+        // WGS84, NAD83 and ETRS89
+        if ((geographicType != 4326) && (geographicType != 4269) && (geographicType != 4258)) {
+            errorString = QStringLiteral("Unsupported coordinate system EPSG:%1, the elevation model must be in WGS84 or UTM").arg(geographicType);
+            return false;
+        }
+        _geographic = true;
+    } else {
+        errorString = QStringLiteral("Elevation model is not georeferenced");
+        return false;
+    }
+
+    // Raster coordinates of the raster space origin, the outer corner of the top left value
+    double originX = 0;
+    double originY = 0;
+    if ((geoTags.pixelScale.count() >= 2) && (geoTags.tiepoints.count() >= 6)) {
+        level.scaleX = geoTags.pixelScale[0];
+        level.scaleY = geoTags.pixelScale[1];
+        originX = geoTags.tiepoints[3] - (geoTags.tiepoints[0] * level.scaleX);
+        originY = geoTags.tiepoints[4] + (geoTags.tiepoints[1] * level.scaleY);
+    } else if (geoTags.transformation.count() >= 16) {
+        if ((geoTags.transformation[1] != 0) || (geoTags.transformation[4] != 0)) {
+            errorString = QStringLiteral("Rotated elevation models are not supported");
+            return false;
+        }
+        level.scaleX = geoTags.transformation[0];
+        level.scaleY = -geoTags.transformation[5];
+        originX = geoTags.transformation[3];
+        originY = geoTags.transformation[7];
+    } else {
+        errorString = QStringLiteral("Elevation model is not georeferenced");
+        return false;
+    }
+    if (!(level.scaleX > 0) || !(level.scaleY > 0)) {
+        errorString = QStringLiteral("Elevation model must be north up");
+        return false;
+    }
+
+    // With PixelIsPoint the origin is the center of the top left value instead of its corner
+    level.cornerX = originX - ((rasterType == kRasterPixelIsPoint) ? (level.scaleX / 2) : 0);
+    level.cornerY = originY + ((rasterType == kRasterPixelIsPoint) ? (level.scaleY / 2) : 0);
+
+    const double right = level.cornerX + (level.width * level.scaleX);
+    const double bottom = level.cornerY - (level.height * level.scaleY);
+    if (_geographic) {
+        _bounds = QGeoRectangle(QGeoCoordinate(level.cornerY, level.cornerX), QGeoCoordinate(bottom, right));
+        const double centerLatitude = qDegreesToRadians((level.cornerY + bottom) / 2);
+        level.resolutionMeters = qMin(level.scaleX * qCos(centerLatitude), level.scaleY) * kMetersPerDegree;
+    } else {
+        // The grid is not aligned with meridians, bound its edges
+        QList<QGeoCoordinate> edge;
+        static constexpr int kEdgeSteps = 8;
+        for (int i = 0; i <= kEdgeSteps; i++) {
+            const double fraction = static_cast<double>(i) / kEdgeSteps;
+            const double x = level.cornerX + ((right - level.cornerX) * fraction);
+            const double y = bottom + ((level.cornerY - bottom) * fraction);
+            for (const auto &point : { std::make_pair(x, level.cornerY), std::make_pair(x, bottom), std::make_pair(level.cornerX, y), std::make_pair(right, y) }) {
+                QGeoCoordinate coordinate;
+                if (!QGCGeo::convertUTMToGeo(point.first, point.second, _utmZone, _utmSouth, coordinate)) {
+                    errorString = QStringLiteral("Elevation model is outside of its UTM zone");
+                    return false;
+                }
+                edge.append(coordinate);
+            }
+        }
+        _bounds = QGeoRectangle(edge);
+        level.resolutionMeters = qMin(level.scaleX, level.scaleY);
+    }
+
+    bool ok = false;
+    const double noData = geoTags.noData.toDouble(&ok);
+    _hasNoData = ok;
+    _noData = noData;
+
+    return true;
+}
+
+bool TerrainDem::_toRaster(const QGeoCoordinate &coordinate, double &x, double &y) const
+{
+    if (_geographic) {
+        x = coordinate.longitude();
+        y = coordinate.latitude();
+        return true;
+    }
+
+    return QGCGeo::convertGeoToUTMZone(coordinate, _utmZone, _utmSouth, x, y);
+}
+
+qsizetype TerrainDem::elevations(const QGeoCoordinate *coordinates, qsizetype count, double spacingMeters, double *elevations)
+{
+    if (_levels.isEmpty()) {
+        return 0;
+    }
+
+    qsizetype levelIndex = 0;
+    for (qsizetype i = 1; i < _levels.count(); i++) {
+        if (_levels[i].resolutionMeters <= spacingMeters) {
+            levelIndex = i;
+        }
+    }
+    const Level_t &level = _levels[levelIndex];
+
+    qsizetype found = 0;
+    for (qsizetype i = 0; i < count; i++) {
+        double x;
+        double y;
+        if (!_bounds.contains(coordinates[i]) || !_toRaster(coordinates[i], x, y)) {
+            continue;
+        }
+
+        // Values sit at the centers of their cells
+        double column = ((x - level.cornerX) / level.scaleX) - 0.5;
+        double row = ((level.cornerY - y) / level.scaleY) - 0.5;
+        if ((column < -0.5) || (row < -0.5) || (column > (level.width - 0.5)) || (row > (level.height - 0.5))) {
+            continue;
+        }
+        column = qBound(0., column, static_cast<double>(level.width - 1));
+        row = qBound(0., row, static_cast<double>(level.height - 1));
+
+        const qint64 column0 = static_cast<qint64>(column);
+        const qint64 row0 = static_cast<qint64>(row);
+        const qint64 column1 = qMin<qint64>(column0 + 1, level.width - 1);
+        const qint64 row1 = qMin<qint64>(row0 + 1, level.height - 1);
+        const double fx = column - column0;
+        const double fy = row - row0;
+
+        // Missing values are left out of the interpolation rather than spoiling it
+        const struct { qint64 column; qint64 row; double weight; } corners[] = {
+            { column0, row0, (1 - fx) * (1 - fy) },
+            { column1, row0, fx * (1 - fy) },
+            { column0, row1, (1 - fx) * fy },
+            { column1, row1, fx * fy },
+        };
+        double sum = 0;
+        double weights = 0;
+        for (const auto &corner : corners) {
+            double value;
+            if ((corner.weight > 0) && _value(level, levelIndex, corner.column, corner.row, value) && !_isNoData(value)) {
+                sum += corner.weight * value;
+                weights += corner.weight;
+            }
+        }
+
+        if (weights > 0) {
+            elevations[i] = sum / weights;
+            found++;
+        }
+    }
+
+    return found;
+}
+
+bool TerrainDem::_value(const Level_t &level, qsizetype levelIndex, qint64 column, qint64 row, double &value)
+{
+    const quint32 blockIndex = static_cast<quint32>(((row / level.blockHeight) * level.blocksAcross) + (column / level.blockWidth));
+
+    Block_t block;
+    if (!_block(level, levelIndex, blockIndex, block)) {
+        return false;
+    }
+
+    const qsizetype index = static_cast<qsizetype>(((row % level.blockHeight) * level.blockWidth) + (column % level.blockWidth));
+    value = block.values ? block.values[index] : _rawValue(level, block.rawData + (index * (level.bitsPerSample / 8)));
+
+    return true;
+}
+
+double TerrainDem::_rawValue(const Level_t &level, const uchar *data) const
+{
+    switch (level.bitsPerSample) {
+    case 8:
+        return (level.sampleFormat == SampleFormatSigned) ? static_cast<double>(static_cast<qint8>(data[0])) : data[0];
+    case 16: {
+        const quint16 bits = _bigEndian ? qFromBigEndian<quint16>(data) : qFromLittleEndian<quint16>(data);
+        return (level.sampleFormat == SampleFormatSigned) ? static_cast<double>(static_cast<qint16>(bits)) : bits;
+    }
+    case 32: {
+        const quint32 bits = _bigEndian ? qFromBigEndian<quint32>(data) : qFromLittleEndian<quint32>(data);
+        if (level.sampleFormat == SampleFormatFloat) {
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        return (level.sampleFormat == SampleFormatSigned) ? static_cast<double>(static_cast<qint32>(bits)) : bits;
+    }
+    case 64: {
+        const quint64 bits = _bigEndian ? qFromBigEndian<quint64>(data) : qFromLittleEndian<quint64>(data);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    default:
+        return qQNaN();
+    }
+}
+
+/// Finds a block of values. Uncompressed blocks are used in place, compressed ones are decoded into the cache.
+///     @return false: block is missing or invalid
+bool TerrainDem::_block(const Level_t &level, qsizetype levelIndex, quint32 blockIndex, Block_t &block)
+{
+    // Neighboring lookups mostly fall in the same block
+    const quint64 key = (static_cast<quint64>(levelIndex) << 32) | blockIndex;
+    if (key == _lastBlockKey) {
+        block = _lastBlock;
+        return true;
+    }
+
+    if ((blockIndex >= static_cast<quint32>(level.blockOffsets.count())) || (level.blockByteCounts[blockIndex] == 0)) {
+        // Sparse files leave blocks without data out
+        return false;
+    }
+
+    if (level.compression == CompressionNone) {
+        const quint64 bytes = static_cast<quint64>(level.blockWidth) * _blockRows(level, blockIndex) * (level.bitsPerSample / 8);
+        const quint64 offset = level.blockOffsets[blockIndex];
+        if ((offset > _size) || (bytes > (_size - offset))) {
+            qCWarning(TerrainDemLog) << "Block" << blockIndex << "outside of" << fileName();
+            return false;
+        }
+        block.rawData = _data + offset;
+        block.values = nullptr;
+    } else {
+        QList<float> *values = _blocks.object(key);
+        if (!values) {
+            values = new QList<float>;
+            if (!_decodeBlock(level, blockIndex, *values)) {
+                delete values;
+                qCWarning(TerrainDemLog) << "Invalid block" << blockIndex << "in" << fileName();
+                return false;
+            }
+            // Inserting may evict the block the lookup shortcut refers to
+            _lastBlockKey = ~0ULL;
+            if (!_blocks.insert(key, values, values->count() * static_cast<qsizetype>(sizeof(float)))) {
+                return false;
+            }
+        }
+        block.rawData = nullptr;
+        block.values = values->constData();
+    }
+
+    _lastBlockKey = key;
+    _lastBlock = block;
+
+    return true;
+}
+
+quint32 TerrainDem::_blockRows(const Level_t &level, quint32 blockIndex)
+{
+    // Tiles are always full size, the last strip only holds the remaining rows
+    if (level.tiled) {
+        return level.blockHeight;
+    }
+
+    const quint64 firstRow = static_cast<quint64>(blockIndex) * level.blockHeight;
+    return static_cast<quint32>(qMin<quint64>(level.blockHeight, level.height - firstRow));
+}
+
+bool TerrainDem::_decodeBlock(const Level_t &level, quint32 blockIndex, QList<float> &values) const
+{
+    const quint64 offset = level.blockOffsets[blockIndex];
+    const quint64 storedBytes = level.blockByteCounts[blockIndex];
+    if ((offset > _size) || (storedBytes > (_size - offset))) {
+        return false;
+    }
+
+    const qsizetype bytesPerSample = level.bitsPerSample / 8;
+    const qsizetype rows = _blockRows(level, blockIndex);
+    const qsizetype rowBytes = static_cast<qsizetype>(level.blockWidth) * bytesPerSample;
+    const qsizetype expectedBytes = rowBytes * rows;
+
+    QByteArray decoded;
+    if (level.compression == CompressionLzw) {
+        if (!_decodeLzw(_data + offset, static_cast<qsizetype>(storedBytes), decoded, expectedBytes)) {
+            return false;
+        }
+    } else {
+        // TIFF DEFLATE is a zlib stream, qUncompress only needs the size prefixed
+        QByteArray compressed(static_cast<qsizetype>(storedBytes) + 4, Qt::Uninitialized);
+        qToBigEndian<quint32>(static_cast<quint32>(expectedBytes), compressed.data());
+        memcpy(compressed.data() + 4, _data + offset, storedBytes);
+        decoded = qUncompress(compressed);
+    }
+    if (decoded.size() < expectedBytes) {
+        return false;
+    }
+
+    uchar *const data = reinterpret_cast<uchar*>(decoded.data());
+    values.resize(static_cast<qsizetype>(level.blockWidth) * rows);
+
+    for (qsizetype row = 0; row < rows; row++) {
+        uchar *const rowData = data + (row * rowBytes);
+        float *const rowValues = values.data() + (row * level.blockWidth);
+
+        switch (level.predictor) {
+        case 2: {
+            // Horizontal differencing of the integers, wrapping around like the encoder did
+            const quint64 mask = (level.bitsPerSample == 32) ? 0xFFFFFFFFULL : ((1ULL << level.bitsPerSample) - 1);
+            const int signShift = 64 - level.bitsPerSample;
+            quint64 sum = 0;
+            for (quint32 i = 0; i < level.blockWidth; i++) {
+                const uchar *const sample = rowData + (i * bytesPerSample);
+                quint64 difference = sample[0];
+                if (bytesPerSample == 2) {
+                    difference = _bigEndian ? qFromBigEndian<quint16>(sample) : qFromLittleEndian<quint16>(sample);
+                } else if (bytesPerSample == 4) {
+                    difference = _bigEndian ? qFromBigEndian<quint32>(sample) : qFromLittleEndian<quint32>(sample);
+                }
+                sum = (sum + difference) & mask;
+                rowValues[i] = (level.sampleFormat == SampleFormatSigned) ? static_cast<float>(static_cast<qint64>(sum << signShift) >> signShift) : static_cast<float>(sum);
+            }
+            break;
+        }
+        case 3: {
+            // Floating point predictor: bytes are differenced across the row, which holds the most significant byte
+            // of every value first, then the next byte of every value and so on
+            for (qsizetype i = 1; i < rowBytes; i++) {
+                rowData[i] = static_cast<uchar>(rowData[i] + rowData[i - 1]);
+            }
+            uchar bytes[8];
+            for (quint32 i = 0; i < level.blockWidth; i++) {
+                for (qsizetype byte = 0; byte < bytesPerSample; byte++) {
+                    bytes[byte] = rowData[(byte * level.blockWidth) + i];
+                }
+                if (bytesPerSample == 4) {
+                    const quint32 bits = qFromBigEndian<quint32>(bytes);
+                    float value;
+                    memcpy(&value, &bits, sizeof(value));
+                    rowValues[i] = value;
+                } else {
+                    const quint64 bits = qFromBigEndian<quint64>(bytes);
+                    double value;
+                    memcpy(&value, &bits, sizeof(value));
+                    rowValues[i] = static_cast<float>(value);
+                }
+            }
+            break;
+        }
+        default:
+            for (quint32 i = 0; i < level.blockWidth; i++) {
+                rowValues[i] = static_cast<float>(_rawValue(level, rowData + (i * bytesPerSample)));
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
+/// TIFF flavor of LZW: codes of 9 to 12 bits, most significant bit first, widened one code early
+bool TerrainDem::_decodeLzw(const uchar *data, qsizetype size, QByteArray &decoded, qsizetype expectedBytes)
+{
+    static constexpr int kClearCode = 256;
+    static constexpr int kEndCode = 257;
+    static constexpr int kFirstCode = 258;
+    static constexpr int kMaxCodes = 4096;
+
+    // Old style LZW, least significant bit first, does not start with a clear code
+    if ((size < 2) || (data[0] != 0x80)) {
+        return false;
+    }
+
+    // Every string in the table is a previous output string plus one byte, which ends up in the output right after
+    // it. So a string is just a range of the output.
+    qsizetype entryOffsets[kMaxCodes];
+    qsizetype entryLengths[kMaxCodes];
+
+    decoded.clear();
+    decoded.reserve(expectedBytes + kMaxCodes);
+
+    qsizetype position = 0;
+    quint32 bitBuffer = 0;
+    int bitCount = 0;
+    int codeWidth = 9;
+    int nextCode = kFirstCode;
+    int previousCode = -1;
+    qsizetype previousOffset = 0;
+    qsizetype previousLength = 0;
+
+    while (decoded.size() < expectedBytes) {
+        while (bitCount < codeWidth) {
+            if (position >= size) {
+                return decoded.size() >= expectedBytes;
+            }
+            bitBuffer = (bitBuffer << 8) | data[position++];
+            bitCount += 8;
+        }
+        const int code = static_cast<int>((bitBuffer >> (bitCount - codeWidth)) & ((1U << codeWidth) - 1));
+        bitCount -= codeWidth;
+
+        if (code == kEndCode) {
+            break;
+        }
+        if (code == kClearCode) {
+            codeWidth = 9;
+            nextCode = kFirstCode;
+            previousCode = -1;
+            continue;
+        }
+
+        const qsizetype offset = decoded.size();
+        if (code < kClearCode) {
+            decoded.append(static_cast<char>(code));
+        } else if ((code < nextCode) && (previousCode >= 0)) {
+            const qsizetype length = entryLengths[code];
+            decoded.resize(offset + length);
+            memcpy(decoded.data() + offset, decoded.constData() + entryOffsets[code], length);
+        } else if ((code == nextCode) && (previousCode >= 0)) {
+            // The string being defined: the previous one plus its own first byte
+            decoded.resize(offset + previousLength + 1);
+            memcpy(decoded.data() + offset, decoded.constData() + previousOffset, previousLength);
+            decoded[offset + previousLength] = decoded[previousOffset];
+        } else {
+            return false;
+        }
+
+        if ((previousCode >= 0) && (nextCode < kMaxCodes)) {
+            entryOffsets[nextCode] = previousOffset;
+            entryLengths[nextCode] = previousLength + 1;
+            nextCode++;
+            if ((nextCode >= ((1 << codeWidth) - 1)) && (codeWidth < 12)) {
+                codeWidth++;
+            }
+        }
+
+        previousCode = code;
+        previousOffset = offset;
+        previousLength = decoded.size() - offset;
+    }
+
+    return decoded.size() >= expectedBytes;
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCache>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoRectangle>
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainDemLog)
+
+/// Read only, memory mapped digital elevation model in GeoTIFF format, for example a LiDAR DEM or a Cloud Optimized
+/// GeoTIFF, used in preference to the Copernicus tiles where it has coverage.
+///
+/// Supported: classic and BigTIFF, tiled or stripped single band rasters of 8 to 32 bit integers or 32/64 bit floats,
+/// uncompressed, DEFLATE or LZW compressed with any predictor. The raster is georeferenced in WGS84 (or NAD83/ETRS89,
+/// which are within a meter of it) geographic coordinates or in one of their UTM zones. Overviews, the reduced
+/// resolution images of a COG, are used when the requested sample spacing is coarser than the full resolution.
+///
+/// Uncompressed blocks are read in place from the mapping, compressed blocks are decoded on first use into a cache of
+/// limited size. Not thread safe, TerrainTileManager serializes access.
+class TerrainDem
+{
+public:
+    TerrainDem() = default;
+    ~TerrainDem();
+
+    /// Maps the file and reads its image directories and georeferencing
+    ///     @return false: file could not be mapped or is not a supported GeoTIFF, see errorString
+    bool open(const QString &fileName, QString &errorString);
+
+    QString fileName() const { return _file.fileName(); }
+
+    /// Geographic bounding box of the full resolution raster
+    const QGeoRectangle &bounds() const { return _bounds; }
+
+    /// Ground distance between values of the full resolution raster
+    double resolutionMeters() const { return _levels.isEmpty() ? 0 : _levels.first().resolutionMeters; }
+
+    /// Number of resolution levels, the full resolution raster and its overviews
+    qsizetype levelCount() const { return _levels.count(); }
+
+    /// Looks up elevations, bilinearly interpolated between the four surrounding values. The coarsest level whose
+    /// resolution is still finer than spacingMeters is used, so long or coarsely sampled paths touch less data.
+    ///     @param spacingMeters Spacing of the samples the caller needs, 0 for full resolution
+    ///     @param[out] elevations One per coordinate, left untouched where the DEM has no value
+    ///     @return Number of coordinates which were looked up
+    qsizetype elevations(const QGeoCoordinate *coordinates, qsizetype count, double spacingMeters, double *elevations);
+
+    /// Sets the memory budget of the cache of decoded compressed blocks
+    void setCacheBytes(qsizetype bytes) { _blocks.setMaxCost(bytes); }
+
+    /// @return true: the file name has one of the GeoTIFF extensions
+    static bool isDemFile(const QString &fileName);
+
+    static constexpr const char *fileExtensions[] = { "tif", "tiff" };
+    static constexpr qsizetype defaultCacheBytes = 64 * 1024 * 1024;
+
+private:
+    enum Compression {
+        CompressionNone =           1,
+        CompressionLzw =            5,
+        CompressionDeflate =        8,
+        CompressionDeflateLegacy =  32946,
+    };
+
+    enum SampleFormat {
+        SampleFormatUnsigned =  1,
+        SampleFormatSigned =    2,
+        SampleFormatFloat =     3,
+    };
+
+    /// One image of the file, the full resolution raster or an overview
+    struct Level_t {
+        quint32 width = 0;
+        quint32 height = 0;
+        quint32 blockWidth = 0;             ///< Tile size, or image width for strips
+        quint32 blockHeight = 0;            ///< Tile size, or rows per strip
+        quint32 blocksAcross = 0;
+        bool tiled = false;                 ///< false: blocks are strips
+        QList<quint64> blockOffsets;
+        QList<quint64> blockByteCounts;
+        quint16 compression = CompressionNone;
+        quint16 predictor = 1;
+        quint16 sampleFormat = SampleFormatUnsigned;
+        quint16 bitsPerSample = 0;
+        double cornerX = 0;                 ///< Raster coordinates of the outer corner of the top left value
+        double cornerY = 0;
+        double scaleX = 0;                  ///< Raster units per value
+        double scaleY = 0;
+        double resolutionMeters = 0;
+    };
+
+    struct Block_t {
+        const uchar *rawData = nullptr;     ///< Uncompressed block in the mapping, file byte order
+        const float *values = nullptr;      ///< Decoded block
+    };
+
+    /// GeoTIFF tags of the full resolution image
+    struct GeoTags_t {
+        QList<double> pixelScale;
+        QList<double> tiepoints;
+        QList<double> transformation;
+        QList<double> geoKeys;
+        QString noData;
+    };
+
+    bool _readHeader(QString &errorString);
+    bool _readDirectory(quint64 offset, Level_t &level, quint32 &subfileType, GeoTags_t &geoTags, quint64 &nextOffset, QString &errorString);
+    bool _readGeoreferencing(const GeoTags_t &geoTags, Level_t &level, QString &errorString);
+    bool _block(const Level_t &level, qsizetype levelIndex, quint32 blockIndex, Block_t &block);
+    bool _decodeBlock(const Level_t &level, quint32 blockIndex, QList<float> &values) const;
+    bool _value(const Level_t &level, qsizetype levelIndex, qint64 column, qint64 row, double &value);
+    double _rawValue(const Level_t &level, const uchar *data) const;
+    bool _toRaster(const QGeoCoordinate &coordinate, double &x, double &y) const;
+    bool _isNoData(double value) const { return qIsNaN(value) || (_hasNoData && ((value == _noData) || (static_cast<float>(value) == static_cast<float>(_noData)))); }
+
+    quint16 _read16(quint64 offset) const;
+    quint32 _read32(quint64 offset) const;
+    quint64 _read64(quint64 offset) const;
+    bool _readValues(quint16 type, quint64 count, quint64 valueOffset, QList<double> &values) const;
+
+    static quint32 _blockRows(const Level_t &level, quint32 blockIndex);
+    static bool _decodeLzw(const uchar *data, qsizetype size, QByteArray &decoded, qsizetype expectedBytes);
+
+    QFile _file;
+    const uchar *_data = nullptr;
+    quint64 _size = 0;
+    bool _bigEndian = false;
+    bool _bigTiff = false;
+
+    QList<Level_t> _levels;                 ///< Full resolution first, then overviews from fine to coarse
+    QGeoRectangle _bounds;
+    bool _geographic = true;                ///< false: raster coordinates are UTM eastings and northings
+    int _utmZone = 0;
+    bool _utmSouth = false;
+    bool _hasNoData = false;
+    double _noData = 0;
+
+    QCache<quint64, QList<float>> _blocks{ defaultCacheBytes };     ///< Decoded blocks by level and index, cost is bytes
+    quint64 _lastBlockKey = ~0ULL;
+    Block_t _lastBlock;
+};
@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainPack.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TerrainPackLog, "qgc.terrain.terrainpack")
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "Terrain packs are stored in little endian byte order");
+
+TerrainPack::~TerrainPack()
+{
+    if (_data) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+    }
+}
+
+bool TerrainPack::open(const QString &fileName, QString &errorString)
+{
+    errorString.clear();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    _size = _file.size();
+    if (_size < static_cast<qint64>(sizeof(Header_t))) {
+        errorString = QStringLiteral("Not a terrain pack");
+        return false;
+    }
+
+    _data = _file.map(0, _size);
+    if (!_data) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    const Header_t *const header = reinterpret_cast<const Header_t*>(_data);
+    if (memcmp(header->magic, _magic, sizeof(header->magic)) != 0) {
+        errorString = QStringLiteral("Not a terrain pack");
+        return false;
+    }
+    if (header->version != _version) {
+        errorString = QStringLiteral("Unsupported terrain pack version %1").arg(header->version);
+        return false;
+    }
+
+    const qint64 indexBytes = static_cast<qint64>(header->tileCount) * static_cast<qint64>(sizeof(IndexEntry_t));
+    if (static_cast<qint64>(sizeof(Header_t)) + indexBytes > _size) {
+        errorString = QStringLiteral("Terrain pack index is truncated");
+        return false;
+    }
+
+    const IndexEntry_t *const index = reinterpret_cast<const IndexEntry_t*>(_data + sizeof(Header_t));
+    for (quint32 i = 0; i < header->tileCount; i++) {
+        const IndexEntry_t &entry = index[i];
+        if ((entry.offset % _alignment) || (entry.offset + entry.storedBytes > static_cast<quint64>(_size))) {
+            errorString = QStringLiteral("Terrain pack tile data is truncated");
+            return false;
+        }
+        if ((i > 0) && (index[i - 1].tileId >= entry.tileId)) {
+            errorString = QStringLiteral("Terrain pack index is not sorted");
+            return false;
+        }
+    }
+
+    _index = index;
+    _tileCount = header->tileCount;
+
+    qCDebug(TerrainPackLog) << "Opened" << fileName << "tiles:" << _tileCount;
+
+    return true;
+}
+
+const TerrainPack::IndexEntry_t *TerrainPack::_findEntry(quint64 tileId) const
+{
+    if (!_index) {
+        return nullptr;
+    }
+
+    const IndexEntry_t *const end = _index + _tileCount;
+    const IndexEntry_t *const entry = std::lower_bound(_index, end, tileId, [](const IndexEntry_t &entry, quint64 id) {
+        return entry.tileId < id;
+    });
+
+    return ((entry != end) && (entry->tileId == tileId)) ? entry : nullptr;
+}
+
+QByteArray TerrainPack::tileData(quint64 tileId) const
+{
+    const IndexEntry_t *const entry = _findEntry(tileId);
+    if (!entry) {
+        return QByteArray();
+    }
+
+    const uchar *const tile = _data + entry->offset;
+    if (entry->storedBytes == entry->tileBytes) {
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(tile), entry->storedBytes);
+    }
+
+    const QByteArray tileBytes = qUncompress(tile, static_cast<qsizetype>(entry->storedBytes));
+    if (tileBytes.size() != static_cast<qsizetype>(entry->tileBytes)) {
+        qCWarning(TerrainPackLog) << "Corrupt compressed tile" << tileId << "in" << fileName();
+        return QByteArray();
+    }
+
+    return tileBytes;
+}
+
+bool TerrainPack::write(const QString &fileName, const QMap<quint64, QByteArray> &tiles, bool compress, QString &errorString)
+{
+    errorString.clear();
+
+    QList<IndexEntry_t> index;
+    QList<QByteArray> storedTiles;
+    index.reserve(tiles.count());
+    storedTiles.reserve(tiles.count());
+
+    // QMap iterates in key order which gives the sorted index
+    quint64 offset = sizeof(Header_t) + (static_cast<quint64>(tiles.count()) * sizeof(IndexEntry_t));
+    for (auto it = tiles.constBegin(); it != tiles.constEnd(); ++it) {
+        QByteArray stored = it.value();
+        if (compress) {
+            const QByteArray compressed = qCompress(it.value());
+            if (compressed.size() < stored.size()) {
+                stored = compressed;
+            }
+        }
+
+        offset = (offset + _alignment - 1) & ~static_cast<quint64>(_alignment - 1);
+        index.append({ it.key(), offset, static_cast<quint32>(stored.size()), static_cast<quint32>(it.value().size()) });
+        offset += static_cast<quint64>(stored.size());
+        storedTiles.append(stored);
+    }
+
+    Header_t header{};
+    memcpy(header.magic, _magic, sizeof(header.magic));
+    header.version = _version;
+    header.tileCount = static_cast<quint32>(tiles.count());
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorString = file.errorString();
+        return false;
+    }
+
+    (void) file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    (void) file.write(reinterpret_cast<const char*>(index.constData()), index.count() * static_cast<qsizetype>(sizeof(IndexEntry_t)));
+    for (qsizetype i = 0; i < index.count(); i++) {
+        const qint64 padding = static_cast<qint64>(index[i].offset) - file.pos();
+        if (padding > 0) {
+            (void) file.write(QByteArray(padding, '\0'));
+        }
+        (void) file.write(storedTiles[i]);
+    }
+
+    if (!file.commit()) {
+        errorString = file.errorString();
+        return false;
+    }
+
+    return true;
+}
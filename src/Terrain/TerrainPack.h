@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainPackLog)
+
+/// Read only, memory mapped file of pre-built Copernicus terrain tiles for a region, used for offline operation.
+///
+/// File format (little endian): an 8 byte magic, a 32 bit version and a 32 bit tile count, followed by the index with
+/// one entry per tile sorted by tile id, followed by the tile data. Each tile is stored either as is or zlib
+/// compressed (qCompress). Tile data is 8 byte aligned so uncompressed tiles are used in place from the mapping.
+class TerrainPack
+{
+public:
+    TerrainPack() = default;
+    ~TerrainPack();
+
+    /// Maps the pack file and validates its index
+    ///     @return false: file could not be mapped or is not a terrain pack
+    bool open(const QString &fileName, QString &errorString);
+
+    QString fileName() const { return _file.fileName(); }
+    qsizetype tileCount() const { return _tileCount; }
+    bool contains(quint64 tileId) const { return _findEntry(tileId) != nullptr; }
+
+    /// @return Serialized tile, empty if the tile is not in the pack. Uncompressed tiles reference the mapping
+    /// without a copy, so the pack must outlive the returned data.
+    QByteArray tileData(quint64 tileId) const;
+
+    /// Writes a pack holding the specified serialized tiles
+    ///     @param compress true: zlib compress tiles where it saves space
+    static bool write(const QString &fileName, const QMap<quint64, QByteArray> &tiles, bool compress, QString &errorString);
+
+    static constexpr const char *fileExtension = "qgcterrain";
+
+private:
+    struct IndexEntry_t {
+        quint64 tileId;
+        quint64 offset;         ///< From the start of the file
+        quint32 storedBytes;
+        quint32 tileBytes;      ///< storedBytes differs if the tile is compressed
+    };
+    static_assert(sizeof(IndexEntry_t) == 24, "Index entry must be packed");
+
+    struct Header_t {
+        char magic[8];
+        quint32 version;
+        quint32 tileCount;
+    };
+    static_assert(sizeof(Header_t) == 16, "Header must be packed");
+
+    const IndexEntry_t *_findEntry(quint64 tileId) const;
+
+    QFile _file;
+    const uchar *_data = nullptr;
+    qint64 _size = 0;
+    const IndexEntry_t *_index = nullptr;
+    qsizetype _tileCount = 0;
+
+    static constexpr char _magic[] = "QGCTPACK";
+    static constexpr quint32 _version = 1;
+    static constexpr qint64 _alignment = 8;
+};
@@ -10,6 +10,7 @@
 #include "TerrainQuery.h"
 #include "TerrainQueryAirMap.h"
 #include "TerrainTileManager.h"
+#include "TerrainTileCopernicus.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QTimer>
@@ -18,6 +19,7 @@ QGC_LOGGING_CATEGORY(TerrainQueryLog, "qgc.terrain.terrainquery")
 QGC_LOGGING_CATEGORY(TerrainQueryVerboseLog, "qgc.terrain.terrainquery.verbose")
 
 Q_GLOBAL_STATIC(TerrainAtCoordinateBatchManager, _terrainAtCoordinateBatchManager)
+Q_GLOBAL_STATIC(TerrainPathHeightCache, _terrainPathHeightCache)
 
 TerrainAtCoordinateBatchManager::TerrainAtCoordinateBatchManager(QObject *parent)
     : QObject(parent)
@@ -288,7 +290,29 @@ void TerrainPolyPathQuery::requestData(const QList<QGeoCoordinate> &polyPath)
 
     _rgCoords = polyPath;
     _curIndex = 0;
-    _pathQuery->requestData(_rgCoords[0], _rgCoords[1]);
+    _rgPathHeightInfo.clear();
+    _requestNextSegment();
+}
+
+void TerrainPolyPathQuery::_requestNextSegment()
+{
+    // Segments which were queried before don't need to go to the terrain system again
+    TerrainPathQuery::PathHeightInfo_t pathHeightInfo;
+    while ((_curIndex < (_rgCoords.count() - 1)) &&
+           TerrainPathHeightCache::instance()->lookup(_rgCoords[_curIndex], _rgCoords[_curIndex + 1], TerrainTileCopernicus::tileValueSpacingMeters, pathHeightInfo)) {
+        (void) _rgPathHeightInfo.append(pathHeightInfo);
+        _curIndex++;
+    }
+
+    if (_curIndex >= (_rgCoords.count() - 1)) {
+        qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "complete";
+        emit terrainDataReceived(true, _rgPathHeightInfo);
+        if (_autoDelete) {
+            deleteLater();
+        }
+    } else {
+        _pathQuery->requestData(_rgCoords[_curIndex], _rgCoords[_curIndex + 1]);
+    }
 }
 
 void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t &pathHeightInfo)
@@ -301,15 +325,45 @@ void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQ
         return;
     }
 
+    TerrainPathHeightCache::instance()->insert(_rgCoords[_curIndex], _rgCoords[_curIndex + 1], TerrainTileCopernicus::tileValueSpacingMeters, pathHeightInfo);
     (void) _rgPathHeightInfo.append(pathHeightInfo);
+    _curIndex++;
 
-    if (++_curIndex >= (_rgCoords.count() - 1)) {
-        qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "complete";
-        emit terrainDataReceived(true, _rgPathHeightInfo);
-        if (_autoDelete) {
-            deleteLater();
-        }
-    } else {
-        _pathQuery->requestData(_rgCoords[_curIndex], _rgCoords[_curIndex + 1]);
+    _requestNextSegment();
+}
+
+/*===========================================================================*/
+
+TerrainPathHeightCache *TerrainPathHeightCache::instance()
+{
+    return _terrainPathHeightCache();
+}
+
+TerrainPathHeightCache::SegmentKey_t TerrainPathHeightCache::_segmentKey(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double sampleSpacingMeters)
+{
+    static constexpr double kQuantization = 1e6;    // ~10cm
+
+    return {
+        static_cast<qint32>(qRound(fromCoord.latitude() * kQuantization)),
+        static_cast<qint32>(qRound(fromCoord.longitude() * kQuantization)),
+        static_cast<qint32>(qRound(toCoord.latitude() * kQuantization)),
+        static_cast<qint32>(qRound(toCoord.longitude() * kQuantization)),
+        static_cast<qint32>(qRound(sampleSpacingMeters * 100.0))
+    };
+}
+
+bool TerrainPathHeightCache::lookup(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double sampleSpacingMeters, TerrainPathQuery::PathHeightInfo_t &pathHeightInfo)
+{
+    const TerrainPathQuery::PathHeightInfo_t *const cached = _cache.object(_segmentKey(fromCoord, toCoord, sampleSpacingMeters));
+    if (!cached) {
+        return false;
     }
+
+    pathHeightInfo = *cached;
+    return true;
+}
+
+void TerrainPathHeightCache::insert(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double sampleSpacingMeters, const TerrainPathQuery::PathHeightInfo_t &pathHeightInfo)
+{
+    (void) _cache.insert(_segmentKey(fromCoord, toCoord, sampleSpacingMeters), new TerrainPathQuery::PathHeightInfo_t(pathHeightInfo), qMax<qsizetype>(1, pathHeightInfo.heights.count()));
 }
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <QtCore/QCache>
+#include <QtCore/QHashFunctions>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
@@ -143,6 +145,43 @@ Q_DECLARE_METATYPE(TerrainPathQuery::PathHeightInfo_t)
 
 /*===========================================================================*/
 
+/// Memoizes path heights by segment so repeated poly path queries over mostly unchanged geometry, such as survey
+/// transects being rebuilt while a polygon vertex is dragged, only query the segments which actually changed.
+/// Segments are keyed by their endpoints quantized to ~10cm and the sample spacing.
+class TerrainPathHeightCache
+{
+public:
+    static TerrainPathHeightCache *instance();
+
+    /// @return true: heights for the segment were found
+    bool lookup(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double sampleSpacingMeters, TerrainPathQuery::PathHeightInfo_t &pathHeightInfo);
+    void insert(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double sampleSpacingMeters, const TerrainPathQuery::PathHeightInfo_t &pathHeightInfo);
+
+    /// Forgets all segments, for when the terrain data changes
+    void clear() { _cache.clear(); }
+
+private:
+    struct SegmentKey_t {
+        qint32 fromLat, fromLon, toLat, toLon;
+        qint32 sampleSpacingCm;
+
+        bool operator==(const SegmentKey_t &other) const {
+            return (fromLat == other.fromLat) && (fromLon == other.fromLon) && (toLat == other.toLat) && (toLon == other.toLon) && (sampleSpacingCm == other.sampleSpacingCm);
+        }
+        friend size_t qHash(const SegmentKey_t &key, size_t seed = 0) {
+            return qHashMulti(seed, key.fromLat, key.fromLon, key.toLat, key.toLon, key.sampleSpacingCm);
+        }
+    };
+
+    static SegmentKey_t _segmentKey(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double sampleSpacingMeters);
+
+    QCache<SegmentKey_t, TerrainPathQuery::PathHeightInfo_t> _cache{ _maxCachedHeights };    ///< LRU, cost is the number of heights
+
+    static constexpr qsizetype _maxCachedHeights = 1000000;
+};
+
+/*===========================================================================*/
+
 class TerrainPolyPathQuery : public QObject
 {
     Q_OBJECT
@@ -166,6 +205,8 @@ private slots:
     void _terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t &pathHeightInfo);
 
 private:
+    void _requestNextSegment();
+
     bool _autoDelete = false;
     int _curIndex = 0;
     QList<QGeoCoordinate> _rgCoords;
@@ -302,3 +302,9 @@ void TerrainOfflineAirMapQuery::requestPathHeights(const QGeoCoordinate &fromCoo
     _queryMode = TerrainQuery::QueryModePath;
     TerrainTileManager::instance()->addPathQuery(this, fromCoord, toCoord);
 }
+
+void TerrainOfflineAirMapQuery::requestCarpetHeights(const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly)
+{
+    _queryMode = TerrainQuery::QueryModeCarpet;
+    TerrainTileManager::instance()->addCarpetQuery(this, swCoord, neCoord, statsOnly);
+}
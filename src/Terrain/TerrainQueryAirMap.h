@@ -61,4 +61,5 @@ public:
 
     void requestCoordinateHeights(const QList<QGeoCoordinate> &coordinates) final;
     void requestPathHeights(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord) final;
+    void requestCarpetHeights(const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly) final;
 };
@@ -10,9 +10,12 @@
 #include "TerrainTile.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QtMath>
 #include <QtCore/QtNumeric>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(TerrainTileLog, "qgc.terrain.terraintile");
 
 TerrainTile::TerrainTile()
@@ -54,18 +57,11 @@ TerrainTile::TerrainTile(const QByteArray &byteArray)
         return;
     }
 
-    _elevationData.resize(_tileInfo.gridSizeLat);
-    for (int k = 0; k < _tileInfo.gridSizeLat; k++) {
-        _elevationData[k].resize(_tileInfo.gridSizeLon);
-    }
-
-    int valueIndex = 0;
-    const int16_t* const pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _tileInfo.gridSizeLat; i++) {
-        for (int j = 0; j < _tileInfo.gridSizeLon; j++) {
-            _elevationData[i][j] = pTileData[valueIndex++];
-        }
-    }
+    // Reference the grid inside the serialized tile instead of copying it. QByteArray is implicitly shared so this
+    // only adds a reference to the cached data, and the header size keeps the grid 16 bit aligned.
+    static_assert((sizeof(TileInfo_t) % alignof(int16_t)) == 0, "Tile data must be aligned");
+    _tileData = byteArray;
+    _elevationData = reinterpret_cast<const int16_t*>(_tileData.constData() + cTileHeaderBytes);
 
     _isValid = true;
 }
@@ -75,42 +71,78 @@ TerrainTile::~TerrainTile()
     // qCDebug(TerrainTileLog) << Q_FUNC_INFO << this;
 }
 
-double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
+double TerrainTile::elevation(const QGeoCoordinate &coordinate, Sampling sampling) const
 {
     if (!_isValid) {
         qCWarning(TerrainTileLog) << this << "Request for elevation, but tile is invalid.";
         return qQNaN();
     }
 
-    const double latDeltaSw = coordinate.latitude() - _tileInfo.swLat;
-    const double lonDeltaSw = coordinate.longitude() - _tileInfo.swLon;
-
-    const int16_t latIndex = qFloor(latDeltaSw / _cellSizeLat);
-    const int16_t lonIndex = qFloor(lonDeltaSw / _cellSizeLon);
-
-    const bool latIndexInvalid = (latIndex < 0) || (latIndex > (_tileInfo.gridSizeLat - 1));
-    const bool lonIndexInvalid = (lonIndex < 0) || (lonIndex > (_tileInfo.gridSizeLon - 1));
-
-    if (latIndexInvalid || lonIndexInvalid) {
+    const double elevation = _sample(coordinate.latitude(), coordinate.longitude(), sampling);
+    if (qIsNaN(elevation)) {
         qCWarning(TerrainTileLog) << this << "Internal error: coordinate" << coordinate << "outside tile bounds";
         return qQNaN();
     }
 
-    if ((latIndex >= _elevationData.size()) || (lonIndex >= _elevationData[latIndex].size())) {
-        qCWarning(TerrainTileLog).noquote() << this << "Internal error: _elevationData size inconsistent _tileInfo << coordinate" << coordinate
-            << "\n\t_tillIndo.gridSizeLat: " << _tileInfo.gridSizeLat << " _tileInfo.gridSizeLon: " << _tileInfo.gridSizeLon
-            << "\n\t_data.size(): " << _elevationData.size() << " _elevationData[latIndex].size(): " << _elevationData[latIndex].size();
-        return qQNaN();
-    }
-    const auto elevation = _elevationData[latIndex][lonIndex];
-
     if (elevation < _tileInfo.minElevation) {
         qCWarning(TerrainTileLog) << this << "Warning: elevation read is below min elevation in tile:" << elevation << "<" << _tileInfo.minElevation;
     } else if (elevation > _tileInfo.maxElevation) {
         qCWarning(TerrainTileLog) << this << "Warning: elevation read is above max elevation in tile:" << elevation << ">" << _tileInfo.maxElevation;
     }
 
-    qCDebug(TerrainTileLog) << this << "latIndex, lonIndex:" << latIndex << lonIndex << "elevation:" << elevation;
+    qCDebug(TerrainTileLog) << this << "coordinate:" << coordinate << "elevation:" << elevation;
+
+    return elevation;
+}
+
+void TerrainTile::elevations(const QGeoCoordinate *coordinates, qsizetype count, double *elevations, Sampling sampling) const
+{
+    if (!_isValid) {
+        qCWarning(TerrainTileLog) << this << "Request for elevations, but tile is invalid.";
+        std::fill_n(elevations, count, qQNaN());
+        return;
+    }
+
+    for (qsizetype i = 0; i < count; i++) {
+        elevations[i] = _sample(coordinates[i].latitude(), coordinates[i].longitude(), sampling);
+    }
+}
+
+/// @return Elevation at the coordinate, NaN if it is outside the tile
+double TerrainTile::_sample(double latitude, double longitude, Sampling sampling) const
+{
+    const int gridSizeLat = _tileInfo.gridSizeLat;
+    const int gridSizeLon = _tileInfo.gridSizeLon;
+
+    // Position in units of grid cells from the south west corner
+    const double latCells = (latitude - _tileInfo.swLat) / _cellSizeLat;
+    const double lonCells = (longitude - _tileInfo.swLon) / _cellSizeLon;
+
+    const int latIndex = qFloor(latCells);
+    const int lonIndex = qFloor(lonCells);
+    if ((latIndex < 0) || (latIndex >= gridSizeLat) || (lonIndex < 0) || (lonIndex >= gridSizeLon)) {
+        return qQNaN();
+    }
+
+    if (sampling == Sampling::Nearest) {
+        return static_cast<double>(_elevationData[(latIndex * gridSizeLon) + lonIndex]);
+    }
 
-    return static_cast<double>(elevation);
+    // Grid values represent the center of their cell, interpolate between the surrounding centers and hold the
+    // edge values in the outer half cells
+    const double latPos = qBound(0.0, latCells - 0.5, static_cast<double>(gridSizeLat - 1));
+    const double lonPos = qBound(0.0, lonCells - 0.5, static_cast<double>(gridSizeLon - 1));
+    const int lat0 = static_cast<int>(latPos);
+    const int lon0 = static_cast<int>(lonPos);
+    const int lat1 = qMin(lat0 + 1, gridSizeLat - 1);
+    const int lon1 = qMin(lon0 + 1, gridSizeLon - 1);
+    const double latFraction = latPos - lat0;
+    const double lonFraction = lonPos - lon0;
+
+    const int16_t *const row0 = _elevationData + (lat0 * gridSizeLon);
+    const int16_t *const row1 = _elevationData + (lat1 * gridSizeLon);
+    const double south = row0[lon0] + (lonFraction * (row0[lon1] - row0[lon0]));
+    const double north = row1[lon0] + (lonFraction * (row1[lon1] - row1[lon0]));
+
+    return south + (latFraction * (north - south));
 }
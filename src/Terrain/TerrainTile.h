@@ -9,7 +9,7 @@
 
 #pragma once
 
-#include <QtCore/QList>
+#include <QtCore/QByteArray>
 #include <QtCore/QLoggingCategory>
 
 class QGeoCoordinate;
@@ -30,10 +30,30 @@ public:
     ///    @return true if data is valid
     bool isValid() const { return _isValid; }
 
+    enum class Sampling {
+        Nearest,    ///< Value of the grid cell containing the coordinate
+        Bilinear    ///< Interpolated between the four surrounding grid values
+    };
+
     /// Evaluates the elevation at the given coordinate
     ///    @param coordinate
-    ///    @return elevation
-    double elevation(const QGeoCoordinate &coordinate) const;
+    ///    @param sampling
+    ///    @return elevation, NaN if the coordinate is outside the tile
+    double elevation(const QGeoCoordinate &coordinate, Sampling sampling = Sampling::Nearest) const;
+
+    /// Evaluates the elevations for an array of coordinates. This is a tight loop over the flat elevation grid
+    /// without any per coordinate logging, so use it in preference to elevation() for large queries.
+    ///    @param coordinates Coordinates to evaluate
+    ///    @param count Number of coordinates
+    ///    @param[out] elevations Receives count values, NaN for coordinates outside the tile
+    ///    @param sampling
+    void elevations(const QGeoCoordinate *coordinates, qsizetype count, double *elevations, Sampling sampling = Sampling::Nearest) const;
+
+    /// @return The serialized tile the elevation data is read from
+    const QByteArray &serializedData() const { return _tileData; }
+
+    /// @return Memory used by the tile including its elevation data
+    qsizetype memoryBytes() const { return static_cast<qsizetype>(sizeof(TerrainTile)) + _tileData.size(); }
 
     /// Accessor for the minimum elevation of the tile
     ///    @return minimum elevation
@@ -56,8 +76,11 @@ protected:
     };
 
 private:
+    double _sample(double latitude, double longitude, Sampling sampling) const;
+
     TileInfo_t _tileInfo{};
-    QList<QList<int16_t>> _elevationData;   /// 2D elevation data array
+    QByteArray _tileData;                   /// serialized tile, keeps the elevation data referenced by _elevationData alive
+    const int16_t *_elevationData = nullptr;/// row major gridSizeLat x gridSizeLon elevation grid inside _tileData
     double _cellSizeLat = 0.0;              /// data grid size in latitude direction
     double _cellSizeLon = 0.0;              /// data grid size in longitude direction
     bool _isValid = false;                  /// data loaded is valid
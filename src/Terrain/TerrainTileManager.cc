@@ -8,6 +8,9 @@
  ****************************************************************************/
 
 #include "TerrainTileManager.h"
+#include "TerrainDem.h"
+#include "TerrainPack.h"
+#include "TerrainQuery.h"
 #include "TerrainTile.h"
 #include "TerrainTileCopernicus.h"
 // #include "TerrainQueryAirMap.h"
@@ -16,14 +19,22 @@
 #include "QGCMapUrlEngine.h"
 #include "ElevationMapProvider.h"
 #include "QGCLoggingCategory.h"
+#include "QGCPerfCounter.h"
+#include "QGCTrace.h"
 
+#include <QtCore/QDir>
 #include <QtLocation/private/qgeotilespec_p.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QNetworkRequest>
 
+#include <algorithm>
+#include <utility>
+
 QGC_LOGGING_CATEGORY(TerrainTileManagerLog, "qgc.terrain.terraintilemanager")
 
+static QGCPerfCounter s_queuedRequests("Terrain", "Queued queries", QGCPerfCounter::Gauge);
+
 Q_GLOBAL_STATIC(TerrainTileManager, _terrainTileManager)
 
 TerrainTileManager *TerrainTileManager::instance()
@@ -33,6 +44,7 @@ TerrainTileManager *TerrainTileManager::instance()
 
 TerrainTileManager::TerrainTileManager(QObject *parent)
     : QObject(parent)
+    , _tiles(defaultCacheMemoryBudgetMB * 1024 * 1024)
     , _networkManager(new QNetworkAccessManager(this))
 {
     // qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << this;
@@ -46,9 +58,9 @@ TerrainTileManager::TerrainTileManager(QObject *parent)
 
 TerrainTileManager::~TerrainTileManager()
 {
-    qDeleteAll(_tiles);
-
     // qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << this;
+
+    unloadTerrainPacks();
 }
 
 void TerrainTileManager::addCoordinateQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &coordinates)
@@ -71,6 +83,7 @@ void TerrainTileManager::addCoordinateQuery(TerrainQueryInterface *terrainQueryI
             coordinates
         };
         _requestQueue.enqueue(queuedRequestInfo);
+        s_queuedRequests.set(_requestQueue.count());
         return;
     }
 
@@ -85,11 +98,12 @@ void TerrainTileManager::addCoordinateQuery(TerrainQueryInterface *terrainQueryI
     terrainQueryInterface->signalCoordinateHeights((coordinates.count() == altitudes.count()), altitudes);
 }
 
-QList<QGeoCoordinate> TerrainTileManager::pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween)
+QList<QGeoCoordinate> TerrainTileManager::pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween, double spacingMeters)
 {
     const double lat = fromCoord.latitude();
     const double lon = fromCoord.longitude();
-    const int steps = qCeil(toCoord.distanceTo(fromCoord) / TerrainTileCopernicus::tileValueSpacingMeters);
+    const double spacing = (spacingMeters > 0) ? spacingMeters : TerrainTileCopernicus::tileValueSpacingMeters;
+    const int steps = qCeil(toCoord.distanceTo(fromCoord) / spacing);
     const double latDiff = toCoord.latitude() - lat;
     const double lonDiff = toCoord.longitude() - lon;
 
@@ -118,13 +132,19 @@ QList<QGeoCoordinate> TerrainTileManager::pathQueryToCoords(const QGeoCoordinate
 
 void TerrainTileManager::addPathQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint)
 {
+    // Paths over an elevation model are sampled at its resolution, more coarsely if they are very long
+    double spacingMeters = _demResolutionMeters(startPoint, endPoint);
+    if (spacingMeters > 0) {
+        spacingMeters = qMax(spacingMeters, startPoint.distanceTo(endPoint) / _maxPathSamples);
+    }
+
     double distanceBetween;
     double finalDistanceBetween;
-    const QList<QGeoCoordinate> coordinates = pathQueryToCoords(startPoint, endPoint, distanceBetween, finalDistanceBetween);
+    const QList<QGeoCoordinate> coordinates = pathQueryToCoords(startPoint, endPoint, distanceBetween, finalDistanceBetween, spacingMeters);
 
     bool error;
     QList<double> altitudes;
-    if (!getAltitudesForCoordinates(coordinates, altitudes, error)) {
+    if (!_getAltitudes(coordinates, distanceBetween, altitudes, error)) {
         qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "queue count" << _requestQueue.count();
         const QueuedRequestInfo_t queuedRequestInfo = {
             terrainQueryInterface,
@@ -134,6 +154,7 @@ void TerrainTileManager::addPathQuery(TerrainQueryInterface *terrainQueryInterfa
             coordinates
         };
         _requestQueue.enqueue(queuedRequestInfo);
+        s_queuedRequests.set(_requestQueue.count());
         return;
     }
 
@@ -148,31 +169,140 @@ void TerrainTileManager::addPathQuery(TerrainQueryInterface *terrainQueryInterfa
     terrainQueryInterface->signalPathHeights((coordinates.count() == altitudes.count()), distanceBetween, finalDistanceBetween, altitudes);
 }
 
+void TerrainTileManager::addCarpetQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly)
+{
+    if (!swCoord.isValid() || !neCoord.isValid() || (swCoord.latitude() > neCoord.latitude()) || (swCoord.longitude() > neCoord.longitude())) {
+        qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "invalid carpet bounds" << swCoord << neCoord;
+        terrainQueryInterface->signalCarpetHeights(false, qQNaN(), qQNaN(), QList<QList<double>>());
+        return;
+    }
+
+    // Spaced at the resolution of the elevation model covering the area, more coarsely if the carpet gets too large
+    double spacingMeters = _demResolutionMeters(swCoord, neCoord);
+    if (spacingMeters <= 0) {
+        spacingMeters = TerrainTileCopernicus::tileValueSpacingMeters;
+    }
+    const double widthMeters = swCoord.distanceTo(QGeoCoordinate(swCoord.latitude(), neCoord.longitude()));
+    const double heightMeters = swCoord.distanceTo(QGeoCoordinate(neCoord.latitude(), swCoord.longitude()));
+    spacingMeters = qMax(spacingMeters, qSqrt((widthMeters * heightMeters) / _maxCarpetSamples));
+    const qsizetype columns = qCeil(widthMeters / spacingMeters) + 1;
+    const qsizetype rows = qCeil(heightMeters / spacingMeters) + 1;
+
+    QueuedRequestInfo_t requestInfo = {
+        terrainQueryInterface,
+        TerrainQuery::QueryMode::QueryModeCarpet,
+        spacingMeters,
+        spacingMeters,
+        QList<QGeoCoordinate>(),
+        columns,
+        statsOnly
+    };
+    requestInfo.coordinates.reserve(rows * columns);
+    for (qsizetype row = 0; row < rows; row++) {
+        const double lat = (rows > 1) ? (swCoord.latitude() + (((neCoord.latitude() - swCoord.latitude()) * row) / (rows - 1))) : swCoord.latitude();
+        for (qsizetype column = 0; column < columns; column++) {
+            const double lon = (columns > 1) ? (swCoord.longitude() + (((neCoord.longitude() - swCoord.longitude()) * column) / (columns - 1))) : swCoord.longitude();
+            requestInfo.coordinates.append(QGeoCoordinate(lat, lon));
+        }
+    }
+
+    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "rows:columns:spacing" << rows << columns << spacingMeters;
+
+    bool error;
+    QList<double> altitudes;
+    if (!_getAltitudes(requestInfo.coordinates, spacingMeters, altitudes, error)) {
+        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "queue count" << _requestQueue.count();
+        _requestQueue.enqueue(requestInfo);
+        s_queuedRequests.set(_requestQueue.count());
+        return;
+    }
+
+    if (error) {
+        qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "signalling failure due to internal error";
+    }
+    _signalCarpetHeights(requestInfo, !error, altitudes);
+}
+
+void TerrainTileManager::_signalCarpetHeights(const QueuedRequestInfo_t &requestInfo, bool success, const QList<double> &altitudes)
+{
+    if (!success || altitudes.isEmpty() || (altitudes.count() != requestInfo.coordinates.count()) || (requestInfo.carpetColumns <= 0)) {
+        requestInfo.terrainQueryInterface->signalCarpetHeights(false, qQNaN(), qQNaN(), QList<QList<double>>());
+        return;
+    }
+
+    const auto [minHeight, maxHeight] = std::minmax_element(altitudes.cbegin(), altitudes.cend());
+
+    QList<QList<double>> carpet;
+    if (!requestInfo.carpetStatsOnly) {
+        carpet.reserve(altitudes.count() / requestInfo.carpetColumns);
+        for (qsizetype i = 0; i < altitudes.count(); i += requestInfo.carpetColumns) {
+            carpet.append(altitudes.mid(i, requestInfo.carpetColumns));
+        }
+    }
+
+    requestInfo.terrainQueryInterface->signalCarpetHeights(true, *minHeight, *maxHeight, carpet);
+}
+
 bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error)
 {
+    return _getAltitudes(coordinates, 0, altitudes, error);
+}
+
+/// Same as getAltitudesForCoordinates
+///     @param spacingMeters Spacing of the coordinates, lets elevation models use their overviews for sparse samples
+bool TerrainTileManager::_getAltitudes(const QList<QGeoCoordinate> &coordinates, double spacingMeters, QList<double> &altitudes, bool &error)
+{
+    QGC_TRACE_SCOPE("TerrainTileManager::getAltitudesForCoordinates");
+
     error = false;
 
+    const qsizetype firstAltitude = altitudes.count();
+    altitudes.resize(firstAltitude + coordinates.count());
+
+    // Elevation models take precedence, tiles are only needed for the coordinates they don't cover
+    QList<bool> demCovered;
+    if (_demElevations(coordinates, spacingMeters, altitudes.data() + firstAltitude, demCovered) == coordinates.count()) {
+        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "returning" << coordinates.count() << "elevations from elevation models";
+        return true;
+    }
+    const auto covered = [&demCovered](qsizetype index) { return !demCovered.isEmpty() && demCovered[index]; };
+
     static const QString kMapType = CopernicusElevationProvider::kProviderKey;
     const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(kMapType);
-    for (const QGeoCoordinate &coordinate: coordinates) {
-        const QString tileHash = UrlFactory::getTileHash(
-            provider->getMapName(),
-            provider->long2tileX(coordinate.longitude(), 1),
-            provider->lat2tileY(coordinate.latitude(), 1),
-            1
-        );
-        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "hash:coordinate" << tileHash << coordinate;
-
-        TerrainTile* const tile = _getCachedTile(tileHash);
-        if (tile) {
-            const double elevation = tile->elevation(coordinate);
-            if (qIsNaN(elevation)) {
-                error = true;
-                qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "Internal Error: missing elevation in tile cache";
-            } else {
-                qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "returning elevation from tile cache" << elevation;
+    for (qsizetype i = 0; i < coordinates.count();) {
+        if (covered(i)) {
+            i++;
+            continue;
+        }
+
+        const QGeoCoordinate &coordinate = coordinates[i];
+        const int tileX = provider->long2tileX(coordinate.longitude(), 1);
+        const int tileY = provider->lat2tileY(coordinate.latitude(), 1);
+        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "tile:coordinate" << tileX << tileY << coordinate;
+
+        // Consecutive coordinates, as in path and polygon queries, usually fall in the same tile. Look the whole
+        // run up in one batch.
+        qsizetype runEnd = i + 1;
+        while ((runEnd < coordinates.count()) && !covered(runEnd) &&
+               (provider->long2tileX(coordinates[runEnd].longitude(), 1) == tileX) &&
+               (provider->lat2tileY(coordinates[runEnd].latitude(), 1) == tileY)) {
+            runEnd++;
+        }
+
+        double* const elevations = altitudes.data() + firstAltitude + i;
+        if (_cachedTileElevations(_tileId(tileX, tileY), coordinates.constData() + i, runEnd - i, elevations)) {
+            for (qsizetype j = 0; j < (runEnd - i); j++) {
+                if (qIsNaN(elevations[j])) {
+                    error = true;
+                    qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "Internal Error: missing elevation in tile cache";
+                }
             }
-            altitudes.push_back(elevation);
+            qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "returning" << (runEnd - i) << "elevations from tile cache";
+            i = runEnd;
+        } else if (_prefetchesInFlight.contains(_tileId(tileX, tileY))) {
+            // The prefetch completion processes the queued request
+            altitudes.resize(firstAltitude + i);
+            return false;
         } else if (_state != TerrainQuery::State::Downloading) {
             QGeoTileSpec spec;
             spec.setX(provider->long2tileX(coordinate.longitude(), 1));
@@ -181,11 +311,13 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>
             spec.setMapId(provider->getMapId());
             const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
             QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
-            (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
             _state = TerrainQuery::State::Downloading;
+            _connectTileReply(reply, &TerrainTileManager::_terrainDone);
             // TODO: Batch Downloading?
+            altitudes.resize(firstAltitude + i);
             return false;
         } else {
+            altitudes.resize(firstAltitude + i);
             return false;
         }
     }
@@ -193,6 +325,46 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>
     return true;
 }
 
+bool TerrainTileManager::cachedElevations(const QList<QGeoCoordinate> &coordinates, QList<double> &elevations)
+{
+    elevations.resize(coordinates.count());
+
+    QList<bool> demCovered;
+    if (_demElevations(coordinates, 0, elevations.data(), demCovered) == coordinates.count()) {
+        return true;
+    }
+    const auto covered = [&demCovered](qsizetype index) { return !demCovered.isEmpty() && demCovered[index]; };
+
+    static const QString kMapType = CopernicusElevationProvider::kProviderKey;
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(kMapType);
+
+    bool allAvailable = true;
+    for (qsizetype i = 0; i < coordinates.count();) {
+        if (covered(i)) {
+            i++;
+            continue;
+        }
+
+        const int tileX = provider->long2tileX(coordinates[i].longitude(), 1);
+        const int tileY = provider->lat2tileY(coordinates[i].latitude(), 1);
+
+        qsizetype runEnd = i + 1;
+        while ((runEnd < coordinates.count()) && !covered(runEnd) &&
+               (provider->long2tileX(coordinates[runEnd].longitude(), 1) == tileX) &&
+               (provider->lat2tileY(coordinates[runEnd].latitude(), 1) == tileY)) {
+            runEnd++;
+        }
+
+        if (!_cachedTileElevations(_tileId(tileX, tileY), coordinates.constData() + i, runEnd - i, elevations.data() + i)) {
+            std::fill(elevations.begin() + i, elevations.begin() + runEnd, qQNaN());
+            allAvailable = false;
+        }
+        i = runEnd;
+    }
+
+    return allAvailable;
+}
+
 void TerrainTileManager::_tileFailed()
 {
     QList<double> noAltitudes;
@@ -205,16 +377,22 @@ void TerrainTileManager::_tileFailed()
         case TerrainQuery::QueryMode::QueryModePath:
             requestInfo.terrainQueryInterface->signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
             break;
+        case TerrainQuery::QueryMode::QueryModeCarpet:
+            _signalCarpetHeights(requestInfo, false, noAltitudes);
+            break;
         default:
             continue;
         }
     }
 
     _requestQueue.clear();
+    s_queuedRequests.set(0);
 }
 
 void TerrainTileManager::_terrainDone()
 {
+    QGC_TRACE_SCOPE("TerrainTileManager::_terrainDone");
+
     _state = TerrainQuery::State::Idle;
 
     QGeoTiledMapReplyQGC* const reply = qobject_cast<QGeoTiledMapReplyQGC*>(QObject::sender());
@@ -241,15 +419,21 @@ void TerrainTileManager::_terrainDone()
 
     qCDebug(TerrainTileManagerLog) << "Received some bytes of terrain data:" << responseBytes.size();
 
-    const QString hash = UrlFactory::getTileHash(UrlFactory::getProviderTypeFromQtMapId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
-    _cacheTile(responseBytes, hash);
+    _cacheTile(responseBytes, _tileId(spec.x(), spec.y()));
+
+    _processQueuedRequests();
+}
+
+void TerrainTileManager::_processQueuedRequests()
+{
+    QGC_TRACE_SCOPE("TerrainTileManager::_processQueuedRequests");
 
     for (qsizetype i = _requestQueue.count() - 1; i >= 0; i--) {
         bool error;
         QList<double> altitudes;
         QueuedRequestInfo_t &requestInfo = _requestQueue[i];
 
-        if (!getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
+        if (!_getAltitudes(requestInfo.coordinates, requestInfo.distanceBetween, altitudes, error)) {
             continue;
         }
 
@@ -274,21 +458,168 @@ void TerrainTileManager::_terrainDone()
                 requestInfo.terrainQueryInterface->signalPathHeights(requestInfo.coordinates.count() == altitudes.count(), requestInfo.distanceBetween, requestInfo.finalDistanceBetween, altitudes);
             }
             break;
+        case TerrainQuery::QueryMode::QueryModeCarpet:
+            if (error) {
+                qCWarning(TerrainTileManagerLog) << "signalling failure due to internal error";
+            }
+            _signalCarpetHeights(requestInfo, !error, altitudes);
+            break;
         default:
             break;
         }
 
         _requestQueue.removeAt(i);
     }
+
+    s_queuedRequests.set(_requestQueue.count());
+}
+
+bool TerrainTileManager::_tileIdsForArea(const QGeoCoordinate &northWest, const QGeoCoordinate &southEast, QList<quint64> &tileIds)
+{
+    tileIds.clear();
+
+    if (!northWest.isValid() || !southEast.isValid()) {
+        return false;
+    }
+
+    static const QString kMapType = CopernicusElevationProvider::kProviderKey;
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(kMapType);
+    const int x0 = provider->long2tileX(qMin(northWest.longitude(), southEast.longitude()), 1);
+    const int x1 = provider->long2tileX(qMax(northWest.longitude(), southEast.longitude()), 1);
+    const int y0 = provider->lat2tileY(qMin(northWest.latitude(), southEast.latitude()), 1);
+    const int y1 = provider->lat2tileY(qMax(northWest.latitude(), southEast.latitude()), 1);
+
+    const qint64 tileCount = (static_cast<qint64>(x1) - x0 + 1) * (static_cast<qint64>(y1) - y0 + 1);
+    if (tileCount > _maxPrefetchTiles) {
+        qCWarning(TerrainTileManagerLog) << "Terrain area too large, skipped. Tiles:" << tileCount;
+        return false;
+    }
+
+    tileIds.reserve(tileCount);
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            tileIds.append(_tileId(x, y));
+        }
+    }
+
+    return true;
+}
+
+void TerrainTileManager::prefetchTiles(const QGeoCoordinate &northWest, const QGeoCoordinate &southEast)
+{
+    QList<quint64> tileIds;
+    if (!_tileIdsForArea(northWest, southEast, tileIds)) {
+        return;
+    }
+
+    qsizetype queued = 0;
+    for (const quint64 tileId : tileIds) {
+        if (_prefetchesInFlight.contains(tileId) || _prefetchQueued.contains(tileId)) {
+            continue;
+        }
+        if (!_tileAvailable(tileId)) {
+            _prefetchQueue.enqueue(tileId);
+            _prefetchQueued.insert(tileId);
+            queued++;
+        }
+    }
+    qCDebug(TerrainTileManagerLog) << "Terrain prefetch queued" << queued << "of" << tileIds.count() << "tiles";
+
+    _startPrefetches();
 }
 
-void TerrainTileManager::_cacheTile(const QByteArray &data, const QString &hash)
+void TerrainTileManager::prefetchTiles(const QList<QGeoCoordinate> &coordinates)
 {
+    QGeoCoordinate northWest;
+    QGeoCoordinate southEast;
+
+    for (const QGeoCoordinate &coordinate : coordinates) {
+        if (!coordinate.isValid()) {
+            continue;
+        }
+        if (!northWest.isValid()) {
+            northWest = southEast = coordinate;
+            continue;
+        }
+        northWest.setLatitude(qMax(northWest.latitude(), coordinate.latitude()));
+        northWest.setLongitude(qMin(northWest.longitude(), coordinate.longitude()));
+        southEast.setLatitude(qMin(southEast.latitude(), coordinate.latitude()));
+        southEast.setLongitude(qMax(southEast.longitude(), coordinate.longitude()));
+    }
+
+    prefetchTiles(northWest, southEast);
+}
+
+void TerrainTileManager::_startPrefetches()
+{
+    static const QString kMapType = CopernicusElevationProvider::kProviderKey;
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(kMapType);
+
+    while ((_prefetchesInFlight.count() < _maxConcurrentPrefetches) && !_prefetchQueue.isEmpty()) {
+        const quint64 tileId = _prefetchQueue.dequeue();
+        (void) _prefetchQueued.remove(tileId);
+
+        QGeoTileSpec spec;
+        spec.setX(static_cast<int>(tileId >> 32));
+        spec.setY(static_cast<int>(tileId & 0xFFFFFFFF));
+        spec.setZoom(1);
+        spec.setMapId(provider->getMapId());
+        // The reply serves the tile from the SQLite cache if it is there, and stores downloaded tiles in it
+        const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
+        QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
+        _prefetchesInFlight.insert(tileId);
+        _connectTileReply(reply, &TerrainTileManager::_prefetchDone);
+    }
+}
+
+void TerrainTileManager::_connectTileReply(QGeoTiledMapReplyQGC *reply, void (TerrainTileManager::*slot)())
+{
+    (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, slot);
+    if (reply->isFinished()) {
+        // Served from memory or failed in the constructor, before finished could be connected. Signalled again from
+        // the event loop, so the slot doesn't run inside the query which created the reply.
+        (void) QMetaObject::invokeMethod(reply, &QGeoTiledMapReplyQGC::finished, Qt::QueuedConnection);
+    }
+}
+
+void TerrainTileManager::_prefetchDone()
+{
+    QGeoTiledMapReplyQGC* const reply = qobject_cast<QGeoTiledMapReplyQGC*>(QObject::sender());
+    if (!reply) {
+        qCWarning(TerrainTileManagerLog) << "Elevation tile prefetched but invalid reply data type.";
+        return;
+    }
+    reply->deleteLater();
+
+    const QGeoTileSpec spec = reply->tileSpec();
+    const quint64 tileId = _tileId(spec.x(), spec.y());
+    (void) _prefetchesInFlight.remove(tileId);
+
+    const QByteArray responseBytes = reply->mapImageData();
+    if ((reply->error() != QGeoTiledMapReplyQGC::NoError) || responseBytes.isEmpty()) {
+        // Requests waiting on this tile fall back to fetching it themselves
+        qCWarning(TerrainTileManagerLog) << "Elevation tile prefetch failed:" << reply->errorString();
+    } else {
+        _cacheTile(responseBytes, tileId);
+    }
+
+    if (_packExport.pendingTiles.contains(tileId)) {
+        _exportTileDone(tileId, (reply->error() == QGeoTiledMapReplyQGC::NoError) ? responseBytes : QByteArray());
+    }
+
+    _processQueuedRequests();
+    _startPrefetches();
+}
+
+void TerrainTileManager::_cacheTile(const QByteArray &data, quint64 tileId)
+{
+    QGC_TRACE_SCOPE("TerrainTileManager::_cacheTile");
+
     TerrainTile* const terrainTile = new TerrainTile(data);
     if (terrainTile->isValid()) {
         _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            (void) _tiles.insert(hash, terrainTile);
+        if (!_tiles.contains(tileId)) {
+            _insertTile(tileId, terrainTile);
         } else {
             delete terrainTile;
         }
@@ -299,22 +630,336 @@ void TerrainTileManager::_cacheTile(const QByteArray &data, const QString &hash)
     }
 }
 
-TerrainTile *TerrainTileManager::_getCachedTile(const QString &hash)
+/// Adds a tile to the memory cache, must be called with _tilesMutex held
+///     @return false: tile is larger than the whole budget and was deleted
+bool TerrainTileManager::_insertTile(quint64 tileId, TerrainTile *terrainTile)
+{
+    const qsizetype countBefore = _tiles.count();
+    // QCache takes ownership and evicts least recently used tiles to stay within the budget
+    const bool inserted = _tiles.insert(tileId, terrainTile, terrainTile->memoryBytes());
+    _cacheStats.evictions += static_cast<quint64>(qMax<qsizetype>(0, countBefore + (inserted ? 1 : 0) - _tiles.count()));
+
+    return inserted;
+}
+
+/// Loads a tile from the terrain packs into the memory cache, must be called with _tilesMutex held
+///     @return Cached tile, nullptr if no pack holds the tile
+const TerrainTile *TerrainTileManager::_loadPackTile(quint64 tileId)
+{
+    for (const TerrainPack *pack : _packs) {
+        const QByteArray data = pack->tileData(tileId);
+        if (data.isEmpty()) {
+            continue;
+        }
+
+        TerrainTile* const terrainTile = new TerrainTile(data);
+        if (!terrainTile->isValid()) {
+            delete terrainTile;
+            qCWarning(TerrainTileManagerLog) << "Invalid tile" << tileId << "in terrain pack" << pack->fileName();
+            continue;
+        }
+
+        _cacheStats.packLoads++;
+        return _insertTile(tileId, terrainTile) ? _tiles.object(tileId) : nullptr;
+    }
+
+    return nullptr;
+}
+
+bool TerrainTileManager::_tileAvailable(quint64 tileId)
+{
+    QMutexLocker locker(&_tilesMutex);
+
+    if (_tiles.contains(tileId)) {
+        return true;
+    }
+    for (const TerrainPack *pack : _packs) {
+        if (pack->contains(tileId)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Looks up elevations in a cached tile. The lookup happens with the cache locked so the tile can't be evicted
+/// while it is in use.
+///     @return false: tile not in cache
+bool TerrainTileManager::_cachedTileElevations(quint64 tileId, const QGeoCoordinate *coordinates, qsizetype count, double *elevations)
+{
+    QMutexLocker locker(&_tilesMutex);
+
+    const TerrainTile* tile = _tiles.object(tileId);
+    if (!tile) {
+        tile = _loadPackTile(tileId);
+    }
+    if (!tile) {
+        _cacheStats.misses++;
+        return false;
+    }
+
+    _cacheStats.hits++;
+    tile->elevations(coordinates, count, elevations);
+
+    return true;
+}
+
+/// Looks up elevations in the elevation models, finer models overriding coarser ones where they overlap
+///     @param[out] covered Whether each coordinate was looked up, empty if no model is loaded
+///     @return Number of coordinates looked up
+qsizetype TerrainTileManager::_demElevations(const QList<QGeoCoordinate> &coordinates, double spacingMeters, double *elevations, QList<bool> &covered)
 {
+    covered.clear();
+
+    QMutexLocker locker(&_tilesMutex);
+
+    if (_dems.isEmpty()) {
+        return 0;
+    }
+
+    QList<double> demElevations(coordinates.count(), qQNaN());
+    for (TerrainDem *dem : std::as_const(_dems)) {
+        (void) dem->elevations(coordinates.constData(), coordinates.count(), spacingMeters, demElevations.data());
+    }
+
+    locker.unlock();
+
+    qsizetype found = 0;
+    covered.resize(coordinates.count());
+    for (qsizetype i = 0; i < coordinates.count(); i++) {
+        covered[i] = !qIsNaN(demElevations[i]);
+        if (covered[i]) {
+            elevations[i] = demElevations[i];
+            found++;
+        }
+    }
+
+    return found;
+}
+
+/// @return Resolution of the finest elevation model covering both coordinates, 0 if none does
+double TerrainTileManager::_demResolutionMeters(const QGeoCoordinate &coord1, const QGeoCoordinate &coord2)
+{
+    QMutexLocker locker(&_tilesMutex);
+
+    double resolutionMeters = 0;
+    for (const TerrainDem *dem : std::as_const(_dems)) {
+        if (dem->bounds().contains(coord1) && dem->bounds().contains(coord2)) {
+            resolutionMeters = dem->resolutionMeters();
+        }
+    }
+
+    return resolutionMeters;
+}
+
+TerrainTileManager::CacheStats_t TerrainTileManager::cacheStats()
+{
+    QMutexLocker locker(&_tilesMutex);
+
+    CacheStats_t stats = _cacheStats;
+    stats.tileCount = _tiles.count();
+    stats.memoryBytes = _tiles.totalCost();
+
+    return stats;
+}
+
+void TerrainTileManager::setCacheMemoryBudgetMB(int budgetMB)
+{
+    QMutexLocker locker(&_tilesMutex);
+
+    const qsizetype countBefore = _tiles.count();
+    _tiles.setMaxCost(static_cast<qsizetype>(qMax(1, budgetMB)) * 1024 * 1024);
+    _cacheStats.evictions += static_cast<quint64>(countBefore - _tiles.count());
+}
+
+bool TerrainTileManager::loadTerrainPack(const QString &fileName, QString &errorString)
+{
+    TerrainPack* const pack = new TerrainPack();
+    if (!pack->open(fileName, errorString)) {
+        delete pack;
+        qCWarning(TerrainTileManagerLog) << "Unable to load terrain pack" << fileName << errorString;
+        return false;
+    }
+
+    qCDebug(TerrainTileManagerLog) << "Loaded terrain pack" << fileName << "tiles:" << pack->tileCount();
+
     _tilesMutex.lock();
-    if (!_tiles.contains(hash)) {
-        _tilesMutex.unlock();
-        return nullptr;
+    _packs.append(pack);
+    _tilesMutex.unlock();
+
+    // Queued requests may be waiting on tiles which the pack provides
+    _processQueuedRequests();
+
+    return true;
+}
+
+bool TerrainTileManager::loadTerrainDem(const QString &fileName, QString &errorString)
+{
+    TerrainDem* const dem = new TerrainDem();
+    if (!dem->open(fileName, errorString)) {
+        delete dem;
+        qCWarning(TerrainTileManagerLog) << "Unable to load elevation model" << fileName << errorString;
+        return false;
+    }
+
+    qCDebug(TerrainTileManagerLog) << "Loaded elevation model" << fileName << "resolution:" << dem->resolutionMeters() << "levels:" << dem->levelCount();
+
+    _tilesMutex.lock();
+    const auto it = std::upper_bound(_dems.begin(), _dems.end(), dem, [](const TerrainDem *a, const TerrainDem *b) {
+        return a->resolutionMeters() > b->resolutionMeters();
+    });
+    (void) _dems.insert(it, dem);
+    _tilesMutex.unlock();
+
+    // Path heights remembered so far were sampled from the tiles
+    TerrainPathHeightCache::instance()->clear();
+
+    _processQueuedRequests();
+
+    return true;
+}
+
+void TerrainTileManager::loadTerrainPacks(const QString &dirPath)
+{
+    const QDir dir(dirPath);
+    const QStringList fileNames = dir.entryList({ QStringLiteral("*.%1").arg(TerrainPack::fileExtension) }, QDir::Files);
+    for (const QString &fileName : fileNames) {
+        QString errorString;
+        (void) loadTerrainPack(dir.absoluteFilePath(fileName), errorString);
+    }
+
+    QStringList demNameFilters;
+    for (const char *extension : TerrainDem::fileExtensions) {
+        demNameFilters.append(QStringLiteral("*.%1").arg(QLatin1String(extension)));
+    }
+    const QStringList demFileNames = dir.entryList(demNameFilters, QDir::Files);
+    for (const QString &fileName : demFileNames) {
+        QString errorString;
+        (void) loadTerrainDem(dir.absoluteFilePath(fileName), errorString);
+    }
+}
+
+void TerrainTileManager::unloadTerrainPacks()
+{
+    QMutexLocker locker(&_tilesMutex);
+
+    // Uncompressed pack tiles reference the pack mapping, so they must go before the packs do
+    const QList<quint64> tileIds = _tiles.keys();
+    for (const quint64 tileId : tileIds) {
+        for (const TerrainPack *pack : _packs) {
+            if (pack->contains(tileId)) {
+                (void) _tiles.remove(tileId);
+                break;
+            }
+        }
+    }
+
+    qDeleteAll(_packs);
+    _packs.clear();
+
+    const bool hadDems = !_dems.isEmpty();
+    qDeleteAll(_dems);
+    _dems.clear();
+    locker.unlock();
+
+    // The cache may already be gone when the manager is destroyed at exit
+    TerrainPathHeightCache* const pathHeightCache = TerrainPathHeightCache::instance();
+    if (hadDems && pathHeightCache) {
+        pathHeightCache->clear();
+    }
+}
+
+bool TerrainTileManager::exportTerrainPack(const QString &fileName, const QGeoCoordinate &northWest, const QGeoCoordinate &southEast, QString &errorString)
+{
+    errorString.clear();
+
+    if (!_packExport.fileName.isEmpty()) {
+        errorString = tr("A terrain pack export is already in progress");
+        return false;
     }
 
-    TerrainTile* const tile = _tiles[hash];
+    QList<quint64> tileIds;
+    if (!_tileIdsForArea(northWest, southEast, tileIds)) {
+        errorString = tr("Terrain pack area is invalid or too large");
+        return false;
+    }
+
+    _packExport = PackExport_t();
+    _packExport.fileName = fileName;
+
+    for (const quint64 tileId : tileIds) {
+        QByteArray data;
 
-    if (!tile->isValid()) {
+        _tilesMutex.lock();
+        const TerrainTile* const tile = _tiles.object(tileId);
+        if (tile) {
+            data = tile->serializedData();
+        } else {
+            for (const TerrainPack *pack : _packs) {
+                data = pack->tileData(tileId);
+                if (!data.isEmpty()) {
+                    break;
+                }
+            }
+        }
+        // Deep copy, cached tiles loaded from a pack reference its mapping and the pack could be unloaded before
+        // the export is written
+        if (!data.isEmpty()) {
+            data = QByteArray(data.constData(), data.size());
+        }
         _tilesMutex.unlock();
-        return nullptr;
+
+        if (!data.isEmpty()) {
+            _packExport.tiles.insert(tileId, data);
+            continue;
+        }
+
+        _packExport.pendingTiles.insert(tileId);
+        if (!_prefetchesInFlight.contains(tileId) && !_prefetchQueued.contains(tileId)) {
+            _prefetchQueue.enqueue(tileId);
+            _prefetchQueued.insert(tileId);
+        }
     }
 
-    _tilesMutex.unlock();
+    qCDebug(TerrainTileManagerLog) << "Terrain pack export" << fileName << "tiles:" << tileIds.count() << "to fetch:" << _packExport.pendingTiles.count();
+
+    if (_packExport.pendingTiles.isEmpty()) {
+        // Signal completion after the caller has seen the export start
+        (void) QMetaObject::invokeMethod(this, &TerrainTileManager::_finishPackExport, Qt::QueuedConnection);
+    } else {
+        _startPrefetches();
+    }
+
+    return true;
+}
+
+void TerrainTileManager::_exportTileDone(quint64 tileId, const QByteArray &data)
+{
+    (void) _packExport.pendingTiles.remove(tileId);
+
+    if (data.isEmpty()) {
+        _packExport.failedTiles++;
+    } else {
+        _packExport.tiles.insert(tileId, data);
+    }
+
+    if (_packExport.pendingTiles.isEmpty()) {
+        _finishPackExport();
+    }
+}
+
+void TerrainTileManager::_finishPackExport()
+{
+    const PackExport_t packExport = std::exchange(_packExport, PackExport_t());
+
+    if (packExport.failedTiles > 0) {
+        emit terrainPackExported(packExport.fileName, false, tr("%1 terrain tiles could not be fetched").arg(packExport.failedTiles));
+        return;
+    }
+
+    QString errorString;
+    const bool success = TerrainPack::write(packExport.fileName, packExport.tiles, true, errorString);
+    qCDebug(TerrainTileManagerLog) << "Terrain pack export" << packExport.fileName << "tiles:" << packExport.tiles.count() << "success:" << success;
 
-    return tile;
+    emit terrainPackExported(packExport.fileName, success, errorString);
 }
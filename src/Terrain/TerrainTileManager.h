@@ -11,13 +11,19 @@
 
 #include "TerrainQueryInterface.h"
 
+#include <QtCore/QCache>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMap>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtPositioning/QGeoCoordinate>
 
+class TerrainDem;
+class TerrainPack;
 class TerrainTile;
+class QGeoTiledMapReplyQGC;
 class QNetworkAccessManager;
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainTileManagerLog)
@@ -35,21 +41,93 @@ public:
     void addCoordinateQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &coordinates);
     void addPathQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint);
 
+    /// Heights over a grid covering the area, rows from south to north with values from west to east. The grid is
+    /// spaced at the resolution of the elevation model covering the area, or of the terrain tiles.
+    void addCarpetQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly);
+
     /// Either returns altitudes from cache or queues database request
     ///     @param[out] error true: altitude not returned due to error, false: altitudes returned
     ///     @return true: altitude returned (check error as well), false: database query queued (altitudes not returned)
     bool getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error);
 
+    /// Looks up elevations in the elevation models and in the tiles which are in memory or in a terrain pack, without
+    /// queuing any download. Safe to call from any thread.
+    ///     @param[out] elevations One per coordinate, NaN where the tile is not available
+    ///     @return false: tiles were missing for some of the coordinates
+    bool cachedElevations(const QList<QGeoCoordinate> &coordinates, QList<double> &elevations);
+
     /// Returns a list of individual coordinates along the requested path spaced according to the terrain tile value spacing
-    static QList<QGeoCoordinate> pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween);
+    ///     @param spacingMeters Spacing to use instead, 0 for the terrain tile value spacing
+    static QList<QGeoCoordinate> pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween, double spacingMeters = 0);
+
+    struct CacheStats_t {
+        quint64 hits = 0;           ///< Tile lookups satisfied from memory
+        quint64 misses = 0;         ///< Tile lookups which required a fetch
+        quint64 packLoads = 0;      ///< Tiles loaded from terrain packs
+        quint64 evictions = 0;      ///< Tiles dropped to stay within the memory budget
+        qsizetype tileCount = 0;
+        qsizetype memoryBytes = 0;
+    };
+
+    CacheStats_t cacheStats();
+
+    /// Sets the memory budget of the in memory tile cache, least recently used tiles are evicted beyond it
+    void setCacheMemoryBudgetMB(int budgetMB);
+
+    static constexpr int defaultCacheMemoryBudgetMB = 256;  ///< Until QGCMapEngine applies MapsSettings::maxTerrainMemoryCacheSize
+
+    /// Fetches all tiles covering the specified area in the background, with a bounded number of downloads in
+    /// parallel. Fetched tiles end up in both the SQLite tile cache and the in memory cache so later queries over
+    /// the area don't wait on serial downloads.
+    void prefetchTiles(const QGeoCoordinate &northWest, const QGeoCoordinate &southEast);
+
+    /// Prefetches the bounding box of the specified coordinates, for example a polygon or mission items
+    void prefetchTiles(const QList<QGeoCoordinate> &coordinates);
+
+    /// Memory maps a terrain pack. Tiles in loaded packs are used in preference to the network and SQLite cache.
+    bool loadTerrainPack(const QString &fileName, QString &errorString);
+
+    /// Memory maps a GeoTIFF elevation model. Where models overlap the finest is used, where they have coverage they
+    /// are used in preference to the tiles.
+    bool loadTerrainDem(const QString &fileName, QString &errorString);
+
+    /// Loads all terrain packs and elevation models in the specified directory
+    void loadTerrainPacks(const QString &dirPath);
+
+    /// Unloads all terrain packs and elevation models, tiles taken from packs are dropped from the memory cache as well
+    void unloadTerrainPacks();
+
+    /// Writes a terrain pack covering the specified area. Missing tiles are fetched first, terrainPackExported is
+    /// signalled once the pack is written. Only one export can run at a time.
+    ///     @return false: export could not be started, see errorString
+    bool exportTerrainPack(const QString &fileName, const QGeoCoordinate &northWest, const QGeoCoordinate &southEast, QString &errorString);
+
+signals:
+    void terrainPackExported(const QString &fileName, bool success, const QString &errorString);
 
 private slots:
     void _terrainDone();
+    void _prefetchDone();
 
 private:
+    void _connectTileReply(QGeoTiledMapReplyQGC *reply, void (TerrainTileManager::*slot)());
     void _tileFailed();
-    void _cacheTile(const QByteArray &data, const QString &hash);
-    TerrainTile *_getCachedTile(const QString &hash);
+    bool _getAltitudes(const QList<QGeoCoordinate> &coordinates, double spacingMeters, QList<double> &altitudes, bool &error);
+    qsizetype _demElevations(const QList<QGeoCoordinate> &coordinates, double spacingMeters, double *elevations, QList<bool> &covered);
+    double _demResolutionMeters(const QGeoCoordinate &coord1, const QGeoCoordinate &coord2);
+    void _processQueuedRequests();
+    void _startPrefetches();
+    void _cacheTile(const QByteArray &data, quint64 tileId);
+    bool _insertTile(quint64 tileId, TerrainTile *terrainTile);
+    const TerrainTile *_loadPackTile(quint64 tileId);
+    bool _tileIdsForArea(const QGeoCoordinate &northWest, const QGeoCoordinate &southEast, QList<quint64> &tileIds);
+    bool _tileAvailable(quint64 tileId);
+    void _exportTileDone(quint64 tileId, const QByteArray &data);
+    void _finishPackExport();
+    bool _cachedTileElevations(quint64 tileId, const QGeoCoordinate *coordinates, qsizetype count, double *elevations);
+
+    /// Tiles are identified by their x/y tile coordinates packed into 64 bits
+    static quint64 _tileId(int x, int y) { return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y); }
 
     struct QueuedRequestInfo_t {
         TerrainQueryInterface *terrainQueryInterface;
@@ -57,13 +135,37 @@ private:
         double distanceBetween;                         ///< Distance between each returned height
         double finalDistanceBetween;                    ///< Distance between for final height
         QList<QGeoCoordinate> coordinates;
+        qsizetype carpetColumns = 0;
+        bool carpetStatsOnly = false;
     };
 
+    static void _signalCarpetHeights(const QueuedRequestInfo_t &requestInfo, bool success, const QList<double> &altitudes);
+
     QQueue<QueuedRequestInfo_t> _requestQueue;
     TerrainQuery::State _state = TerrainQuery::State::Idle;
 
     QMutex _tilesMutex;
-    QHash<QString, TerrainTile*> _tiles;
+    QCache<quint64, TerrainTile> _tiles;    ///< LRU, cost is the tile's memory use in bytes
+    CacheStats_t _cacheStats;
+
+    QQueue<quint64> _prefetchQueue;
+    QSet<quint64> _prefetchQueued;                          ///< Contents of _prefetchQueue for fast lookup
+    QSet<quint64> _prefetchesInFlight;
+    static constexpr int _maxConcurrentPrefetches = 4;
+    static constexpr qint64 _maxPrefetchTiles = 10000;       ///< ~100km x 100km
+
+    QList<TerrainPack*> _packs;                             ///< Accessed with _tilesMutex held
+    QList<TerrainDem*> _dems;                               ///< Coarsest first, accessed with _tilesMutex held
+    static constexpr qsizetype _maxPathSamples = 10000;     ///< Paths over elevation models are sampled more coarsely beyond this
+    static constexpr qsizetype _maxCarpetSamples = 1000000;
+
+    struct PackExport_t {
+        QString fileName;                                   ///< Empty: no export running
+        QSet<quint64> pendingTiles;
+        QMap<quint64, QByteArray> tiles;
+        qsizetype failedTiles = 0;
+    };
+    PackExport_t _packExport;
 
     QNetworkAccessManager *_networkManager = nullptr;
 };
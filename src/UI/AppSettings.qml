@@ -47,10 +47,10 @@ Rectangle {
     Component.onCompleted: {
         //-- Default Settings
         if (globals.commingFromRIDIndicator) {
-            rightPanel.source = "qrc:/qml/RemoteIDSettings.qml"
+            rightPanel.showPage("qrc:/qml/RemoteIDSettings.qml")
             globals.commingFromRIDIndicator = false
         } else {
-            rightPanel.source =  "/qml/GeneralSettings.qml"
+            rightPanel.showPage("/qml/GeneralSettings.qml")
         }
     }
 
@@ -119,7 +119,7 @@ Rectangle {
                             return
                         }
                         if (rightPanel.source !== url) {
-                            rightPanel.source = url
+                            rightPanel.showPage(url)
                         }
                         checked = true
                     }
@@ -168,6 +168,13 @@ Rectangle {
         anchors.right:          parent.right
         anchors.top:            parent.top
         anchors.bottom:         parent.bottom
+
+        function showPage(url) {
+            QGroundControl.qmlLoadStarted(rightPanel)
+            rightPanel.source = url
+        }
+
+        onLoaded: QGroundControl.qmlLoadFinished(rightPanel)
     }
 }
 
@@ -140,6 +140,7 @@ ApplicationWindow {
     function showTool(toolTitle, toolSource, toolIcon) {
         toolDrawer.backIcon     = flyView.visible ? "/qmlimages/PaperPlane.svg" : "/qmlimages/Plan.svg"
         toolDrawer.toolTitle    = toolTitle
+        QGroundControl.qmlLoadStarted(toolDrawerLoader)
         toolDrawer.toolSource   = toolSource
         toolDrawer.toolIcon     = toolIcon
         toolDrawer.visible      = true
@@ -523,6 +524,8 @@ ApplicationWindow {
             anchors.top:    toolDrawerToolbar.bottom
             anchors.bottom: parent.bottom
 
+            onLoaded: QGroundControl.qmlLoadFinished(toolDrawerLoader)
+
             Connections {
                 target:                 toolDrawerLoader.item
                 ignoreUnknownSignals:   true
@@ -36,7 +36,7 @@ SettingsPage {
 
     SettingsGroupLayout {
         Layout.fillWidth:   true
-        visible:             _adsbSettings.adsbServerHostAddress.visible || _adsbSettings.adsbServerPort.visible
+        visible:             _adsbSettings.adsbServerHostAddress.visible || _adsbSettings.adsbServerPort.visible || _adsbSettings.adsbServerFormat.visible
         enabled:             _adsbServerConnectEnabled.rawValue
 
         LabelledFactTextField {
@@ -52,5 +52,13 @@ SettingsPage {
             fact:               _adsbSettings.adsbServerPort
             visible:            fact.visible
         }
+
+        LabelledFactComboBox {
+            Layout.fillWidth:   true
+            label:              fact.shortDescription
+            fact:               _adsbSettings.adsbServerFormat
+            indexModel:         false
+            visible:            fact.visible
+        }
     }
 }
@@ -146,6 +146,62 @@ Item {
             }
         }
 
+        SettingsGroupLayout {
+            Layout.fillWidth:   true
+            heading:            qsTr("Map Overlays")
+            headingDescription: qsTr("KML or SHP files shown over the Fly and Plan maps for reference")
+
+            Repeater {
+                model: QGroundControl.mapOverlayManager.layers
+
+                RowLayout {
+                    Layout.fillWidth:   true
+                    spacing:            ScreenTools.defaultFontPixelWidth
+
+                    QGCCheckBox {
+                        checked:    object.visible
+                        onClicked:  object.visible = checked
+                    }
+
+                    Rectangle {
+                        width:          ScreenTools.defaultFontPixelHeight
+                        height:         width
+                        color:          object.color
+                        border.color:   QGroundControl.globalPalette.text
+                    }
+
+                    QGCLabel {
+                        Layout.fillWidth:   true
+                        text:               object.loading ? qsTr("%1 (loading)").arg(object.name) :
+                                                (object.errorString ? qsTr("%1 (%2)").arg(object.name).arg(object.errorString) :
+                                                                      qsTr("%1 (%2 shapes)").arg(object.name).arg(object.shapeCount))
+                        elide:              Text.ElideRight
+                    }
+
+                    QGCButton {
+                        text:       qsTr("Remove")
+                        onClicked:  QGroundControl.mapOverlayManager.removeLayer(object)
+                    }
+                }
+            }
+
+            LabelledButton {
+                label:      qsTr("Add Overlay")
+                buttonText: qsTr("Add")
+                onClicked:  overlayFileDialog.openForLoad()
+            }
+
+            KMLOrSHPFileDialog {
+                id:     overlayFileDialog
+                title:  qsTr("Select Overlay File")
+
+                onAcceptedForLoad: (file) => {
+                    QGroundControl.mapOverlayManager.addLayer(file)
+                    close()
+                }
+            }
+        }
+
         SettingsGroupLayout {
             Layout.fillWidth:   true
             heading:            qsTr("Tokens")
@@ -199,6 +255,36 @@ Item {
             }
         }
 
+        SettingsGroupLayout {
+            Layout.fillWidth:   true
+            heading:            qsTr("Local Tile File")
+            headingDescription: qsTr("MBTiles or PMTiles file shown by the LocalFile map provider")
+
+            LabelledFactTextField {
+                textFieldPreferredWidth:    _largeTextFieldWidth
+                label:                      qsTr("File")
+                fact:                       _mapsSettings.localTileFile
+            }
+        }
+
+        SettingsGroupLayout {
+            Layout.fillWidth:   true
+            heading:            qsTr("Vector Tiles")
+            headingDescription: qsTr("Mapbox Vector Tile server shown by the VectorTile map provider")
+
+            LabelledFactTextField {
+                textFieldPreferredWidth:    _largeTextFieldWidth
+                label:                      qsTr("Server URL")
+                fact:                       _mapsSettings.vectorTileURL
+            }
+
+            LabelledFactTextField {
+                textFieldPreferredWidth:    _largeTextFieldWidth
+                label:                      qsTr("Style File")
+                fact:                       _mapsSettings.vectorTileStyleFile
+            }
+        }
+
         SettingsGroupLayout {
             Layout.fillWidth:   true
             heading:            qsTr("Tile Cache")
@@ -209,13 +295,31 @@ Item {
 
             LabelledFactTextField {
                 fact: _mapsSettings.maxCacheMemorySize
-            }    
+            }
+
+            LabelledFactTextField {
+                fact: _mapsSettings.maxTileMemoryCacheSize
+            }
+
+            LabelledFactTextField {
+                fact: _mapsSettings.maxTerrainMemoryCacheSize
+            }
+
+            LabelledFactTextField {
+                fact: _mapsSettings.maxTileDownloadRate
+            }
+
+            FactCheckBoxSlider {
+                Layout.fillWidth:   true
+                text:               _mapsSettings.concurrentCacheAccess.shortDescription
+                fact:               _mapsSettings.concurrentCacheAccess
+            }
         }
 
         QGCFileDialog {
             id:             fileDialog
             folder:         _appSettings.missionSavePath
-            nameFilters:    [ qsTr("Tile Sets (*.%1)").arg(defaultSuffix) ]
+            nameFilters:    [ qsTr("Tile Sets (*.%1)").arg(defaultSuffix), qsTr("Tile Packs (*.%1)").arg(_mapEngineManager.tilePackFileExtension) ]
             defaultSuffix:  _appSettings.tilesetFileExtension
 
             onAcceptedForSave: (file) => {
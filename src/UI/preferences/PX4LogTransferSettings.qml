@@ -150,6 +150,21 @@ Rectangle {
                         }
                     }
                     //-----------------------------------------------------------------
+                    //-- Messages lost while streaming
+                    Row {
+                        spacing:    ScreenTools.defaultFontPixelWidth
+                        visible:    QGroundControl.mavlinkLogManager.logRunning
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        QGCLabel {
+                            width:              _labelWidth
+                            text:               qsTr("Dropped Messages:")
+                        }
+                        QGCLabel {
+                            width:              _valueWidth
+                            text:               QGroundControl.mavlinkLogManager.logDropCount
+                        }
+                    }
+                    //-----------------------------------------------------------------
                     //-- Enable auto log on arming
                     QGCCheckBox {
                         text:       qsTr("Enable automatic logging")
@@ -386,6 +401,28 @@ Rectangle {
                         }
                     }
                     //-----------------------------------------------------------------
+                    //-- Upload bandwidth
+                    Row {
+                        spacing:    ScreenTools.defaultFontPixelWidth
+                        QGCLabel {
+                            width:              _labelWidth
+                            anchors.baseline:   rateLimitField.baseline
+                            text:               qsTr("Upload Limit (KB/s, 0 = none):")
+                        }
+                        QGCTextField {
+                            id:                     rateLimitField
+                            text:                   QGroundControl.mavlinkLogManager.uploadRateLimit
+                            width:                  _valueWidth
+                            enabled:                !_disableDataPersistence
+                            inputMethodHints:       Qt.ImhDigitsOnly
+                            validator:              IntValidator { bottom: 0 }
+                            anchors.verticalCenter: parent.verticalCenter
+                            onEditingFinished: {
+                                QGroundControl.mavlinkLogManager.uploadRateLimit = parseInt(text)
+                            }
+                        }
+                    }
+                    //-----------------------------------------------------------------
                     //-- Delete log after upload
                     QGCCheckBox {
                         text:       qsTr("Delete log file after uploading")
@@ -20,7 +20,8 @@ ColumnLayout {
     spacing: _rowSpacing
 
     function saveSettings() {
-        // No Need
+        subEditConfig.minReadBytes = parseInt(minReadBytesField.text)
+        subEditConfig.readLatencyMsecs = parseInt(readLatencyField.text)
     }
 
     GridLayout {
@@ -169,5 +170,28 @@ ColumnLayout {
             currentIndex:           Math.max(Math.min(subEditConfig.stopBits - 1, 1), 0)
             onActivated: (index) => { subEditConfig.stopBits = index + 1 }
         }
+
+        QGCLabel { text: qsTr("Min Read Batch (bytes)") }
+        QGCTextField {
+            id:                     minReadBytesField
+            Layout.preferredWidth:  _secondColumnWidth
+            text:                   subEditConfig.minReadBytes.toString()
+            inputMethodHints:       Qt.ImhFormattedNumbersOnly
+        }
+
+        QGCLabel { text: qsTr("Read Latency (ms)") }
+        QGCTextField {
+            id:                     readLatencyField
+            Layout.preferredWidth:  _secondColumnWidth
+            text:                   subEditConfig.readLatencyMsecs.toString()
+            inputMethodHints:       Qt.ImhFormattedNumbersOnly
+        }
+
+        QGCCheckBox {
+            Layout.columnSpan:  2
+            text:               qsTr("Low Latency Mode")
+            checked:            subEditConfig.lowLatency
+            onCheckedChanged:   subEditConfig.lowLatency = checked
+        }
     }
 }
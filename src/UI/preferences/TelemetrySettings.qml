@@ -67,6 +67,48 @@ SettingsPage {
             checked:            QGroundControl.isVersionCheckEnabled
             onClicked:          QGroundControl.isVersionCheckEnabled = checked
         }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Decode MAVLink on link threads")
+            fact:               _appSettings.decodeMavlinkOnLinkThread
+            visible:            fact.visible
+        }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Pipelined plan transfer")
+            fact:               _appSettings.pipelinedPlanTransfer
+            visible:            fact.visible
+        }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Upload only changed mission items")
+            fact:               _appSettings.partialPlanUpload
+            visible:            fact.visible
+        }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Adapt stream rates to the link")
+            fact:               _appSettings.adaptiveStreamRates
+            visible:            fact.visible
+        }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Reduce telemetry from background vehicles")
+            fact:               _appSettings.trickleBackgroundVehicles
+            visible:            fact.visible
+        }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Monitor new vehicles in the fleet overview")
+            fact:               _appSettings.fleetOverview
+            visible:            fact.visible
+        }
     }
 
     SettingsGroupLayout {
@@ -162,6 +204,21 @@ SettingsPage {
             visible:            fact.visible
             property Fact _saveCsvTelemetry: _appSettings.saveCsvTelemetry
         }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Save columnar telemetry archive (Arrow)")
+            fact:               _saveTelemetryArchive
+            visible:            fact.visible
+            property Fact _saveTelemetryArchive: _appSettings.saveTelemetryArchive
+        }
+
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("Sync log to storage every")
+            fact:               _appSettings.telemetrySyncInterval
+            visible:            fact.visible
+        }
     }
 
     SettingsGroupLayout {
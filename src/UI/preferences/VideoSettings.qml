@@ -103,6 +103,13 @@ SettingsPage {
             visible:            !_videoAutoStreamConfig && _isStreamSource && fact.visible && _isGST
         }
 
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Adaptive Stream Quality")
+            fact:               _videoSettings.adaptiveStreamQuality
+            visible:            _videoAutoStreamConfig && fact.visible && _isGST
+        }
+
         LabelledFactComboBox {
             Layout.fillWidth:   true
             label:              qsTr("Video decode priority")
@@ -123,6 +130,28 @@ SettingsPage {
             visible:            _videoSettings.recordingFormat.visible
         }
 
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("Recording Pre-Roll")
+            fact:               _videoSettings.recordingPreRoll
+            visible:            fact.visible
+        }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Record Telemetry Sidecar")
+            fact:               _videoSettings.recordTelemetrySidecar
+            visible:            fact.visible
+        }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Record KLV Metadata")
+            fact:               _videoSettings.recordVideoMetadata
+            visible:            fact.visible
+            enabled:            _videoSettings.recordingFormat.rawValue === 3
+        }
+
         FactCheckBoxSlider {
             Layout.fillWidth:   true
             text:               qsTr("Auto-Delete Saved Recordings")
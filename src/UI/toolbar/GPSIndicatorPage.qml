@@ -166,6 +166,12 @@ ToolIndicatorPage {
                 enabled:            useFixedPosition
             }
 
+            LabelledFactTextField {
+                label:              rtkSettings.rtcmBandwidthLimit.shortDescription
+                fact:               rtkSettings.rtcmBandwidthLimit
+                visible:            rtkSettings.rtcmBandwidthLimit.visible
+            }
+
             RowLayout {
                 spacing: ScreenTools.defaultFontPixelWidth
 
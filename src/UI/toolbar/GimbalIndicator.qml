@@ -290,6 +290,34 @@ Item {
                         visible:            enableOnScreenControlCheckbox.checked && QGroundControl.settingsManager.gimbalControllerSettings.ControlType.rawValue === 1
                     }
 
+                    FactCheckBox {
+                        id:                 latencyCompensationCheckbox
+                        text:               "  " + QGroundControl.settingsManager.gimbalControllerSettings.LatencyCompensation.shortDescription
+                        fact:               QGroundControl.settingsManager.gimbalControllerSettings.LatencyCompensation
+                        checkedValue:       1
+                        uncheckedValue:     0
+                        visible:            enableOnScreenControlCheckbox.checked
+                        Layout.columnSpan:  2
+                    }
+
+                    QGCLabel {
+                        text:               qsTr("Send rate:")
+                        visible:            enableOnScreenControlCheckbox.checked && latencyCompensationCheckbox.checked
+                    }
+                    FactTextField {
+                        fact:               QGroundControl.settingsManager.gimbalControllerSettings.ControlRate
+                        visible:            enableOnScreenControlCheckbox.checked && latencyCompensationCheckbox.checked
+                    }
+
+                    QGCLabel {
+                        text:               qsTr("Extra video latency:")
+                        visible:            enableOnScreenControlCheckbox.checked && latencyCompensationCheckbox.checked
+                    }
+                    FactTextField {
+                        fact:               QGroundControl.settingsManager.gimbalControllerSettings.VideoLatency
+                        visible:            enableOnScreenControlCheckbox.checked && latencyCompensationCheckbox.checked
+                    }
+
                     // Separator
                     Rectangle {
                         Layout.columnSpan:       2
@@ -92,18 +92,15 @@ Item {
     Component {
         id: messageContentComponent
 
-        TextArea {
-            id:                     messageText
-            width:                  Math.max(ScreenTools.defaultFontPixelHeight * 20, contentWidth + ScreenTools.defaultFontPixelWidth)
-            height:                 Math.max(ScreenTools.defaultFontPixelHeight * 20, contentHeight)
-            readOnly:               true
-            textFormat:             TextEdit.RichText
-            color:                  qgcPal.text
-            placeholderText:        qsTr("No Messages")
-            placeholderTextColor:   qgcPal.text
-            padding:                0
-
-            property bool   _noMessages:    messageText.length === 0
+        QGCListView {
+            id:                     messageList
+            width:                  ScreenTools.defaultFontPixelHeight * 30
+            height:                 ScreenTools.defaultFontPixelHeight * 20
+            model:                  _activeVehicle.statusTextMessages
+            spacing:                0
+            clip:                   true
+
+            property bool   _noMessages:    count === 0
             property var    _fact:          null
 
             function formatMessage(message) {
@@ -113,21 +110,7 @@ Item {
                 return message;
             }
 
-            Component.onCompleted: {
-                messageText.text = formatMessage(_activeVehicle.formattedMessages)
-                _activeVehicle.resetAllMessages()
-            }
-
-            Connections {
-                target:                 _activeVehicle
-                onNewFormattedMessage: (formattedMessage) => { messageText.insert(0, formatMessage(formattedMessage)) }
-            }
-
-            FactPanelController {
-                id: controller
-            }
-
-            onLinkActivated: (link) => {
+            function openLink(link) {
                 if (link.startsWith('param://')) {
                     var paramName = link.substr(8);
                     _fact = controller.getParameterFact(-1, paramName, true)
@@ -139,12 +122,33 @@ Item {
                 }
             }
 
+            Component.onCompleted: _activeVehicle.resetAllMessages()
+
+            // Only the rows in view are formatted
+            delegate: QGCLabel {
+                width:              messageList.width
+                textFormat:         Text.RichText
+                wrapMode:           Text.WordWrap
+                text:               messageList.formatMessage(formattedText)
+                onLinkActivated:    (link) => messageList.openLink(link)
+            }
+
+            QGCLabel {
+                anchors.centerIn:   parent
+                text:               qsTr("No Messages")
+                visible:            messageList._noMessages
+            }
+
+            FactPanelController {
+                id: controller
+            }
+
             Component {
                 id: paramEditorDialogComponent
 
                 ParameterEditorDialog {
                     title:          qsTr("Edit Parameter")
-                    fact:           messageText._fact
+                    fact:           messageList._fact
                     destroyOnClose: true
                 }
             }
@@ -77,6 +77,16 @@ Rectangle {
         }
     }
 
+    // Plan file load progress bar
+    Rectangle {
+        anchors.left:   parent.left
+        anchors.bottom: parent.bottom
+        height:         4
+        width:          planMasterController.loadProgress * parent.width
+        color:          qgcPal.colorGreen
+        visible:        planMasterController.loadInProgress
+    }
+
     // Small mission download progress bar
     Rectangle {
         id:             progressBar
@@ -24,13 +24,13 @@ QPair<int, std::string> UTMSPBlenderRestInterface::setFlightPlan(const std::stri
     return executeRequest();
 }
 
-QPair<int, std::string> UTMSPBlenderRestInterface::requestTelemetry(const std::string& body)
+void UTMSPBlenderRestInterface::requestTelemetry(const std::string& body, const ResponseHandler& handler)
 {
     // Post RID data
     QString target = "/flight_stream/set_telemetry";
     modifyRequest(target, QNetworkAccessManager::PutOperation, QString::fromStdString(body));
 
-    return executeRequest();
+    executeRequestAsync(QNetworkRequest::HighPriority, handler);
 }
 
 QPair<int, std::string> UTMSPBlenderRestInterface::updateFlightState(const std::string& body, const std::string &flightID)
@@ -20,7 +20,8 @@ public:
     UTMSPBlenderRestInterface(QObject *parent = nullptr);
 
     QPair<int, std::string> setFlightPlan(const std::string& body);
-    QPair<int, std::string> requestTelemetry(const std::string& body);
+    /// Sent at high priority without waiting for the reply so position reports are not held up by other requests
+    void requestTelemetry(const std::string& body, const ResponseHandler& handler);
     QPair<int, std::string> updateFlightState(const std::string& body, const std::string& flightID);
     QPair<int, std::string> ping();
 
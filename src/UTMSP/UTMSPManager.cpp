@@ -11,13 +11,12 @@
 #include "UTMSPManager.h"
 #include "UTMSPLogger.h"
 
-#include "services/dispatcher.h"
 #include "Vehicle.h"
 #include "qqml.h"
 
 UTMSPManager::UTMSPManager(QGCApplication* app, QGCToolbox* toolbox) :
     QGCTool(app, toolbox),
-    _dispatcher(std::make_shared<Dispatcher>())
+    _remoteIDBatcher(std::make_shared<UTMSPRemoteIDBatcher>())
 {
     _utmspAuthorization = new UTMSPAuthorization();
     qmlRegisterUncreatableType<UTMSPManager>              ("QGroundControl.UTMSP",      1, 0, "UTMSPManager",                "Reference only");
@@ -41,7 +40,7 @@ void UTMSPManager::setToolbox(QGCToolbox* toolbox)
 UTMSPVehicle* UTMSPManager::instantiateVehicle(const Vehicle& vehicle)
 {
     // TODO: Investigate safe deletion of pointer in this modification of having a member pointer
-    _vehicle = new UTMSPVehicle(_dispatcher,vehicle);
+    _vehicle = new UTMSPVehicle(_remoteIDBatcher, vehicle);
 
     return _vehicle;
 }
@@ -15,7 +15,6 @@
 
 class UTMSPVehicle;
 class Vehicle;
-class Dispatcher;
 class UTMSPAuthorization;
 
 class UTMSPManager : public QGCTool
@@ -40,5 +39,5 @@ public:
 private:
     UTMSPVehicle*                        _vehicle                 = nullptr;
     UTMSPAuthorization*                  _utmspAuthorization      = nullptr;
-    std::shared_ptr<Dispatcher>          _dispatcher;
+    std::shared_ptr<UTMSPRemoteIDBatcher> _remoteIDBatcher;
 };
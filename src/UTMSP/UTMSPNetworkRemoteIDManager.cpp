@@ -10,8 +10,13 @@
 #include "UTMSPNetworkRemoteIDManager.h"
 #include "UTMSPLogger.h"
 
-UTMSPNetworkRemoteIDManager::UTMSPNetworkRemoteIDManager(std::shared_ptr<Dispatcher> dispatcher):
-    _dispatcher(dispatcher)
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+UTMSPNetworkRemoteIDManager::UTMSPNetworkRemoteIDManager(std::shared_ptr<UTMSPRemoteIDBatcher> remoteIDBatcher):
+    _remoteIDBatcher(remoteIDBatcher)
 {
 
 }
@@ -24,6 +29,7 @@ UTMSPNetworkRemoteIDManager::~UTMSPNetworkRemoteIDManager()
 void UTMSPNetworkRemoteIDManager::getCapabilty(const std::string &token)
 {
     setBearerToken(token.c_str());
+    _remoteIDBatcher->setBearerToken(token);
 }
 
 void UTMSPNetworkRemoteIDManager::startTelemetry(const double &latitude,
@@ -138,37 +144,9 @@ void UTMSPNetworkRemoteIDManager::startTelemetry(const double &latitude,
     json mix;
     mix["current_states"] = current_states;
     mix["flight_details"] = _flightDetailsJson;
-    json final_array = json::array();
-    final_array.push_back(mix);
-    json final_format;
-    final_format["observations"] = final_array;
-    json data = final_format;
-
-    auto [statusCode, response] = requestTelemetry(data.dump(4));
-    _statusCode = statusCode;
-    _response = response;
-    UTMSP_LOG_DEBUG()<< "Response " << _response;
-    UTMSP_LOG_DEBUG()<< "Status Code: " << _statusCode;
-
-    if(_statusCode == 201)
-    {
-        try {
-            auto now = std::chrono::system_clock::now();
-            std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-            char buffer[20];
-            std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&now_c));
-            UTMSP_LOG_DEBUG() <<"The Telemetry RID data submitted at " << buffer;
-            UTMSP_LOG_DEBUG() << "--------------Telemetry Submitted Successfully---------------";
-        }
-        catch (const json::parse_error& e) {
-            UTMSP_LOG_ERROR() << "UTMSPNetworkRemoteManager: Error parsing the Telemetry response: " << e.what();
-        }
-    }
-    else
-    {
-        UTMSP_LOG_ERROR() << "UTMSPNetworkRemoteManager: Invalid Status Code";
-    }
 
+    // Uploaded together with the other vehicles' observations at the next batch interval
+    _remoteIDBatcher->addObservation(aircraftSerialNumber, mix.dump());
 }
 
 bool UTMSPNetworkRemoteIDManager::stopTelemetry()
@@ -10,18 +10,18 @@
 #pragma once
 
 #include <nlohmann/json.hpp>
-#include "services/dispatcher.h"
 
 #include "UTMSPBlenderRestInterface.h"
+#include "UTMSPRemoteIDBatcher.h"
 
-class Dispatcher;
+#include <memory>
 
 using json = nlohmann::ordered_json;
 
 class UTMSPNetworkRemoteIDManager:public UTMSPBlenderRestInterface
 {
 public:
-    UTMSPNetworkRemoteIDManager(std::shared_ptr<Dispatcher> dispatcher);
+    UTMSPNetworkRemoteIDManager(std::shared_ptr<UTMSPRemoteIDBatcher> remoteIDBatcher);
     ~UTMSPNetworkRemoteIDManager();
 
     void getCapabilty(const std::string& token);
@@ -114,9 +114,7 @@ private:
     json                         _flightDetailsJson;
     RidData                      _ridData;
     json                         _ridDataJson;
-    int                          _statusCode;
-    std::string                  _response;
-    std::shared_ptr<Dispatcher>  _dispatcher;
+    std::shared_ptr<UTMSPRemoteIDBatcher> _remoteIDBatcher;   ///< Shared by all vehicles
     double                       _initLatitude;
     double                       _initLongitude;
     int                          _j=0;
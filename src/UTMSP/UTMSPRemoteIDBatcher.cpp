@@ -0,0 +1,67 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UTMSPRemoteIDBatcher.h"
+#include "UTMSPLogger.h"
+
+UTMSPRemoteIDBatcher::UTMSPRemoteIDBatcher(QObject *parent):
+    UTMSPBlenderRestInterface(parent)
+{
+    _uploadTimer.setSingleShot(true);
+    _uploadTimer.setInterval(uploadIntervalMSecs);
+    connect(&_uploadTimer, &QTimer::timeout, this, &UTMSPRemoteIDBatcher::_upload);
+}
+
+void UTMSPRemoteIDBatcher::addObservation(const std::string &serialNumber, std::string observation)
+{
+    _observations[serialNumber] = std::move(observation);
+
+    // While an upload is in flight the timer is restarted once it completes
+    if (!_uploadTimer.isActive() && !_uploadInFlight) {
+        _uploadTimer.start();
+    }
+}
+
+void UTMSPRemoteIDBatcher::_upload()
+{
+    if (_observations.empty()) {
+        return;
+    }
+
+    // The observations are already serialized, so the payload is put together without building a document for it
+    _payload.clear();
+    _payload.append("{\"observations\":[");
+    for (auto it = _observations.cbegin(); it != _observations.cend(); it++) {
+        if (it != _observations.cbegin()) {
+            _payload.push_back(',');
+        }
+        _payload.append(it->second);
+    }
+    _payload.append("]}");
+
+    const size_t observationCount = _observations.size();
+    _observations.clear();
+
+    _uploadInFlight = true;
+    requestTelemetry(_payload, [this, observationCount](int statusCode, const std::string &response) {
+        UTMSP_LOG_DEBUG() << "Response " << response;
+        UTMSP_LOG_DEBUG() << "Status Code: " << statusCode;
+
+        if (statusCode == 201) {
+            UTMSP_LOG_DEBUG() << "--------------Telemetry Submitted Successfully---------------" << observationCount << "vehicles";
+        } else {
+            UTMSP_LOG_ERROR() << "UTMSPRemoteIDBatcher: Invalid Status Code";
+        }
+
+        _uploadInFlight = false;
+        if (!_observations.empty()) {
+            _uploadTimer.start();
+        }
+    });
+}
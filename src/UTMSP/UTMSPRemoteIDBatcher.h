@@ -0,0 +1,39 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UTMSPBlenderRestInterface.h"
+
+#include <QTimer>
+
+#include <map>
+#include <string>
+
+// Collects network Remote ID observations from all vehicles and uploads them together, one request per interval.
+// Only the newest observation of each vehicle is kept, so when the USS is slow to answer the next upload skips ahead
+// to current positions instead of working through a backlog of stale ones.
+class UTMSPRemoteIDBatcher : public UTMSPBlenderRestInterface
+{
+public:
+    UTMSPRemoteIDBatcher(QObject *parent = nullptr);
+
+    /// @param observation Serialized JSON of one entry of the "observations" array
+    void addObservation(const std::string& serialNumber, std::string observation);
+
+    static constexpr int uploadIntervalMSecs = 1000;
+
+private:
+    void _upload();
+
+    std::map<std::string, std::string>  _observations;             ///< Newest observation, keyed by vehicle serial number
+    std::string                         _payload;                  ///< Reused between uploads so its buffer only grows once
+    QTimer                              _uploadTimer;
+    bool                                _uploadInFlight = false;
+};
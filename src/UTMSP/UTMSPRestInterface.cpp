@@ -9,21 +9,36 @@
 
 #include "UTMSPRestInterface.h"
 #include "UTMSPLogger.h"
+#include "QGCLoggingCategory.h"
 
+#include <QCoreApplication>
 #include <QList>
 #include <QNetworkInterface>
+#include <QPointer>
 #include "qeventloop.h"
 
+QGC_LOGGING_CATEGORY(UTMSPRestInterfaceLog, "qgc.utmsp.utmsprestinterface")
+
 UTMSPRestInterface::UTMSPRestInterface(QObject *parent):
     QObject(parent)
 {
-    _networkManager = new QNetworkAccessManager(this);
+    _networkManager = _sharedNetworkManager();
 }
 
 UTMSPRestInterface::~UTMSPRestInterface()
 {
-    delete _networkManager;
-    _networkManager = nullptr;
+
+}
+
+/// All interfaces send through one network access manager so requests to the same host reuse its kept alive
+/// connections. It runs up to six requests per host in parallel, so a slow upload does not hold up other requests.
+QNetworkAccessManager *UTMSPRestInterface::_sharedNetworkManager()
+{
+    static QPointer<QNetworkAccessManager> networkManager;
+    if (!networkManager) {
+        networkManager = new QNetworkAccessManager(QCoreApplication::instance());
+    }
+    return networkManager;
 }
 
 
@@ -62,35 +77,33 @@ void UTMSPRestInterface::modifyRequest(const QString &target, QNetworkAccessMana
     _currentBody = body;
 }
 
-QPair<int, std::string> UTMSPRestInterface::executeRequest()
+QNetworkReply *UTMSPRestInterface::_sendRequest(const QNetworkRequest &request)
 {
     if (!_networkManager) {
-        qDebug() << "Network manager is not initialized!";
-        return qMakePair(0, "Network manager is not initialized");
+        qCWarning(UTMSPRestInterfaceLog) << "Network manager is not initialized!";
+        return nullptr;
     }
 
-    QNetworkReply *reply = nullptr;
     switch(_currentMethod) {
     case QNetworkAccessManager::GetOperation:
-        reply = _networkManager->get(_currentRequest);
-        break;
+        return _networkManager->get(request);
     case QNetworkAccessManager::PostOperation:
-        reply = _networkManager->post(_currentRequest, _currentBody.toUtf8());
-        break;
+        return _networkManager->post(request, _currentBody.toUtf8());
     case QNetworkAccessManager::PutOperation:
-        reply = _networkManager->put(_currentRequest, _currentBody.toUtf8());
-        break;
+        return _networkManager->put(request, _currentBody.toUtf8());
     case QNetworkAccessManager::DeleteOperation:
-        reply = _networkManager->deleteResource(_currentRequest);
-        break;
+        return _networkManager->deleteResource(request);
     case QNetworkAccessManager::HeadOperation:
-        reply = _networkManager->head(_currentRequest);
-        break;
+        return _networkManager->head(request);
     default:
-        qDebug() << "Unsupported HTTP method: " << _currentMethod;
-        return qMakePair(0, "Unsupported HTTP method");
+        qCWarning(UTMSPRestInterfaceLog) << "Unsupported HTTP method: " << _currentMethod;
+        return nullptr;
     }
+}
 
+QPair<int, std::string> UTMSPRestInterface::executeRequest()
+{
+    QNetworkReply *reply = _sendRequest(_currentRequest);
     if (!reply) return qMakePair(0, "Failed to create network reply");
 
     QEventLoop loop;
@@ -105,6 +118,25 @@ QPair<int, std::string> UTMSPRestInterface::executeRequest()
     return qMakePair(statusCode, (QString::fromUtf8(response)).toStdString());
 }
 
+void UTMSPRestInterface::executeRequestAsync(QNetworkRequest::Priority priority, const ResponseHandler &handler)
+{
+    QNetworkRequest request = _currentRequest;
+    request.setPriority(priority);
+
+    QNetworkReply *reply = _sendRequest(request);
+    if (!reply) {
+        handler(0, "Failed to create network reply");
+        return;
+    }
+
+    connect(reply, &QNetworkReply::finished, this, [reply, handler]() {
+        const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        const std::string response = QString::fromUtf8(reply->readAll()).toStdString();
+        reply->deleteLater();
+        handler(statusCode, response);
+    });
+}
+
 void UTMSPRestInterface::setBearerToken(const std::string& token)
 {
     QString Token = QString::fromStdString(token);
@@ -10,12 +10,18 @@
 #pragma once
 
 #include <QObject>
+#include <QLoggingCategory>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
 #include <QString>
 #include <QUrl>
 #include <QPair>
+#include <QPointer>
+
+#include <functional>
+
+Q_DECLARE_LOGGING_CATEGORY(UTMSPRestInterfaceLog)
 
 class UTMSPRestInterface : public QObject {
     Q_OBJECT
@@ -29,14 +35,25 @@ public:
         BlenderClient
     };
 
+    /// Called with the HTTP status code, 0 if the request failed, and the response body
+    typedef std::function<void(int statusCode, const std::string &response)> ResponseHandler;
+
     void setBearerToken(const std::string &token);
     QPair<int, std::string> executeRequest();
+    /// Sends the current request without waiting for the reply. Higher priority requests are sent ahead of queued
+    /// lower priority ones. The handler is not called if this object is destroyed first.
+    void executeRequestAsync(QNetworkRequest::Priority priority, const ResponseHandler &handler);
     void modifyRequest(const QString &target, QNetworkAccessManager::Operation method, const QString &body = "");
     void setHost(const HostTarget &hostTarget);
     void setBasicToken(const QString &basicToken);
 
 private:
-    QNetworkAccessManager *             _networkManager = nullptr;
+    /// @return nullptr: The request could not be sent, the reason is logged
+    QNetworkReply *                     _sendRequest(const QNetworkRequest &request);
+
+    static QNetworkAccessManager *      _sharedNetworkManager();
+
+    QPointer<QNetworkAccessManager>     _networkManager;            ///< Shared by all UTM interfaces, not owned
     QNetworkRequest                     _currentRequest;
     QString                             _currentBody;
     QNetworkAccessManager::Operation    _currentMethod;
@@ -11,9 +11,9 @@
 #include "UTMSPLogger.h"
 #include <QGCMAVLink.h>
 
-UTMSPServiceController::UTMSPServiceController(QObject *parent):
+UTMSPServiceController::UTMSPServiceController(std::shared_ptr<UTMSPRemoteIDBatcher> remoteIDBatcher, QObject *parent):
     QObject(parent),
-    _utmspNetworkRemoteIDManager(std::make_shared<Dispatcher>()),
+    _utmspNetworkRemoteIDManager(remoteIDBatcher),
     _activationFlag(false),
     _clientID(""),
     _clientPassword(""),
@@ -23,7 +23,7 @@ class UTMSPServiceController : public QObject
     Q_OBJECT
 
 public:
-    UTMSPServiceController(QObject *parent = nullptr);
+    UTMSPServiceController(std::shared_ptr<UTMSPRemoteIDBatcher> remoteIDBatcher, QObject *parent = nullptr);
     ~UTMSPServiceController();
 
     Q_PROPERTY(QString              responseFlightID        READ responseFlightID   NOTIFY responseFlightIDChanged)
@@ -9,11 +9,10 @@
 
 #include "UTMSPVehicle.h"
 #include "UTMSPLogger.h"
-#include "services/dispatcher.h"
 #include "Vehicle.h"
 
-UTMSPVehicle::UTMSPVehicle(std::shared_ptr<Dispatcher> dispatcher, const Vehicle& vehicle):
-    _dispatcher(dispatcher),
+UTMSPVehicle::UTMSPVehicle(std::shared_ptr<UTMSPRemoteIDBatcher> remoteIDBatcher, const Vehicle& vehicle):
+    UTMSPServiceController(remoteIDBatcher),
     _remoteIDFlag(false),
     _stopFlag(false),
     _flightID(""),
@@ -14,7 +14,6 @@
 #include "UTMSPFlightDetails.h"
 
 // UTM-Adapter per vehicle management class.
-class Dispatcher;
 class Vehicle;
 
 class UTMSPVehicle : public UTMSPServiceController
@@ -24,7 +23,7 @@ class UTMSPVehicle : public UTMSPServiceController
     Q_PROPERTY(bool                    vehicleActivation              READ vehicleActivation         NOTIFY vehicleActivationChanged)
 
 public:
-    UTMSPVehicle        (std::shared_ptr<Dispatcher> dispatcher,const Vehicle& vehicle);
+    UTMSPVehicle        (std::shared_ptr<UTMSPRemoteIDBatcher> remoteIDBatcher, const Vehicle& vehicle);
     ~UTMSPVehicle       () override = default;
 
     Q_INVOKABLE void loadTelemetryFlag(bool value);
@@ -52,7 +51,6 @@ private:
     std::string                   _aircraftClass;
     std::string                   _operatorID;
     std::string                   _operatorClass;
-    std::shared_ptr<Dispatcher>   _dispatcher;
     bool                          _remoteIDFlag;
     bool                          _stopFlag;
     std::string                   _flightID;
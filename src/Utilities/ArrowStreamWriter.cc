@@ -0,0 +1,447 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ArrowStreamWriter.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QtEndian>
+
+namespace {
+    // Arrow Message.fbs and Schema.fbs
+    constexpr int16_t   metadataVersionV5 =         4;
+    constexpr uint8_t   messageHeaderSchema =       1;
+    constexpr uint8_t   messageHeaderRecordBatch =  3;
+    constexpr uint8_t   typeInt =                   2;
+    constexpr uint8_t   typeFloatingPoint =         3;
+    constexpr uint8_t   typeBinary =                4;
+    constexpr uint8_t   typeUtf8 =                  5;
+    constexpr uint8_t   typeTimestamp =             10;
+    constexpr int16_t   precisionSingle =           1;
+    constexpr int16_t   precisionDouble =           2;
+    constexpr int16_t   timeUnitMicrosecond =       2;
+    constexpr int       messageBodyLengthSlot =     3;
+    constexpr quint32   continuationMarker =        0xFFFFFFFF;
+
+    /// Minimal FlatBuffers builder for the Arrow metadata. Like the FlatBuffers library it builds back to front:
+    /// objects are prepended and referred to by their distance from the end of the buffer, so children are always
+    /// created before the object referring to them. Tables can not be nested while being built.
+    class FlatBufferBuilder
+    {
+    public:
+        uint32_t size(void) const { return static_cast<uint32_t>(_data.size()); }
+
+        void align(int alignment)
+        {
+            _pad((alignment - (_data.size() % alignment)) % alignment);
+        }
+
+        template<typename T>
+        void push(T value)
+        {
+            align(sizeof(T));
+            char bytes[sizeof(T)];
+            qToLittleEndian(value, bytes);
+            _data.prepend(bytes, sizeof(T));
+        }
+
+        void pushOffset(uint32_t target)
+        {
+            align(sizeof(uint32_t));
+            push<uint32_t>(size() + sizeof(uint32_t) - target);
+        }
+
+        uint32_t createString(const QByteArray& string)
+        {
+            _pad((4 - ((_data.size() + string.size() + 1) % 4)) % 4);
+            _data.prepend('\0');
+            _data.prepend(string);
+            push<uint32_t>(static_cast<uint32_t>(string.size()));
+            return size();
+        }
+
+        uint32_t createOffsetVector(const QList<uint32_t>& offsets)
+        {
+            align(sizeof(uint32_t));
+            for (qsizetype i = offsets.count() - 1; i >= 0; i--) {
+                pushOffset(offsets[i]);
+            }
+            push<uint32_t>(static_cast<uint32_t>(offsets.count()));
+            return size();
+        }
+
+        /// Vector of structs made of two longs, FieldNode and Buffer in Arrow
+        uint32_t createLongPairVector(const QList<QPair<qint64, qint64>>& pairs)
+        {
+            align(sizeof(qint64));
+            for (qsizetype i = pairs.count() - 1; i >= 0; i--) {
+                push<qint64>(pairs[i].second);
+                push<qint64>(pairs[i].first);
+            }
+            push<uint32_t>(static_cast<uint32_t>(pairs.count()));
+            return size();
+        }
+
+        void startTable(void)
+        {
+            _tableStart = size();
+            _tableFields.clear();
+        }
+
+        template<typename T>
+        void addScalar(int slot, T value)
+        {
+            push<T>(value);
+            _tableFields.append({ slot, size() });
+        }
+
+        void addOffset(int slot, uint32_t target)
+        {
+            pushOffset(target);
+            _tableFields.append({ slot, size() });
+        }
+
+        uint32_t endTable(void)
+        {
+            push<int32_t>(0);   // Offset to the vtable, set once the vtable is written
+            const uint32_t table = size();
+
+            int slotCount = 0;
+            for (const QPair<int, uint32_t>& field: _tableFields) {
+                slotCount = qMax(slotCount, field.first + 1);
+            }
+            QList<uint16_t> fieldOffsets(slotCount, 0);
+            for (const QPair<int, uint32_t>& field: _tableFields) {
+                fieldOffsets[field.first] = static_cast<uint16_t>(table - field.second);
+            }
+
+            for (int slot = slotCount - 1; slot >= 0; slot--) {
+                push<uint16_t>(fieldOffsets[slot]);
+            }
+            push<uint16_t>(static_cast<uint16_t>(table - _tableStart));
+            push<uint16_t>(static_cast<uint16_t>(4 + (2 * slotCount)));
+            const uint32_t vtable = size();
+
+            qToLittleEndian<int32_t>(static_cast<int32_t>(vtable - table), _data.data() + _data.size() - table);
+            return table;
+        }
+
+        /// @return Buffer with the root table offset, padded to 8 bytes as Arrow requires
+        QByteArray finish(uint32_t root)
+        {
+            align(sizeof(uint32_t));
+            _pad((8 - ((_data.size() + 4) % 8)) % 8);
+            pushOffset(root);
+            return _data;
+        }
+
+    private:
+        void _pad(qsizetype count)
+        {
+            if (count > 0) {
+                _data.prepend(count, '\0');
+            }
+        }
+
+        QByteArray                      _data;
+        uint32_t                        _tableStart = 0;
+        QList<QPair<int, uint32_t>>     _tableFields;
+    };
+
+    uint32_t createMessage(FlatBufferBuilder& builder, uint8_t headerType, uint32_t header, qint64 bodyLength)
+    {
+        // Message: version, header_type, header, bodyLength
+        builder.startTable();
+        builder.addScalar<qint64>(messageBodyLengthSlot, bodyLength);
+        builder.addOffset(2, header);
+        builder.addScalar<int16_t>(0, metadataVersionV5);
+        builder.addScalar<uint8_t>(1, headerType);
+        return builder.endTable();
+    }
+
+    int valueSize(ArrowStreamWriter::Type type)
+    {
+        switch (type) {
+        case ArrowStreamWriter::Type::Int8:
+        case ArrowStreamWriter::Type::UInt8:
+            return 1;
+        case ArrowStreamWriter::Type::Int16:
+        case ArrowStreamWriter::Type::UInt16:
+            return 2;
+        case ArrowStreamWriter::Type::Int32:
+        case ArrowStreamWriter::Type::UInt32:
+        case ArrowStreamWriter::Type::Float32:
+            return 4;
+        default:
+            return 8;
+        }
+    }
+
+    template<typename T>
+    void appendValue(QByteArray& values, T value)
+    {
+        char bytes[sizeof(T)];
+        qToLittleEndian(value, bytes);
+        values.append(bytes, sizeof(T));
+    }
+
+    void appendPadded(QByteArray& body, QList<QPair<qint64, qint64>>& buffers, const QByteArray& buffer)
+    {
+        buffers.append({ body.size(), buffer.size() });
+        body.append(buffer);
+        body.append((8 - (body.size() % 8)) % 8, '\0');
+    }
+}
+
+ArrowStreamWriter::ArrowStreamWriter(const QList<Field_t>& fields)
+    : _fields(fields)
+    , _columns(fields.count())
+{
+    for (qsizetype i = 0; i < _fields.count(); i++) {
+        if (_isVariableLength(_fields[i].type)) {
+            appendValue<int32_t>(_columns[i].offsets, 0);
+        }
+    }
+}
+
+void ArrowStreamWriter::appendInteger(int column, qint64 value)
+{
+    QByteArray& values = _columns[column].values;
+
+    switch (_fields[column].type) {
+    case Type::Int8:    appendValue<int8_t>(values, static_cast<int8_t>(value));      break;
+    case Type::Int16:   appendValue<int16_t>(values, static_cast<int16_t>(value));    break;
+    case Type::Int32:   appendValue<int32_t>(values, static_cast<int32_t>(value));    break;
+    case Type::UInt8:   appendValue<uint8_t>(values, static_cast<uint8_t>(value));    break;
+    case Type::UInt16:  appendValue<uint16_t>(values, static_cast<uint16_t>(value));  break;
+    case Type::UInt32:  appendValue<uint32_t>(values, static_cast<uint32_t>(value));  break;
+    case Type::UInt64:  appendValue<quint64>(values, static_cast<quint64>(value));    break;
+    case Type::Float32: appendValue<float>(values, static_cast<float>(value));        break;
+    case Type::Float64: appendValue<double>(values, static_cast<double>(value));      break;
+    case Type::Utf8:
+    case Type::Binary:  appendBytes(column, QByteArray::number(value));               break;
+    default:            appendValue<qint64>(values, value);                           break;
+    }
+}
+
+void ArrowStreamWriter::appendUnsigned(int column, quint64 value)
+{
+    if (_fields[column].type == Type::UInt64) {
+        appendValue<quint64>(_columns[column].values, value);
+    } else {
+        appendInteger(column, static_cast<qint64>(value));
+    }
+}
+
+void ArrowStreamWriter::appendDouble(int column, double value)
+{
+    switch (_fields[column].type) {
+    case Type::Float32: appendValue<float>(_columns[column].values, static_cast<float>(value));    break;
+    case Type::Float64: appendValue<double>(_columns[column].values, value);                      break;
+    default:            appendInteger(column, static_cast<qint64>(value));                        break;
+    }
+}
+
+void ArrowStreamWriter::appendBytes(int column, const QByteArray& value)
+{
+    Column_t& data = _columns[column];
+
+    if (!_isVariableLength(_fields[column].type)) {
+        appendInteger(column, value.toLongLong());
+        return;
+    }
+
+    data.values.append(value);
+    appendValue<int32_t>(data.offsets, static_cast<int32_t>(data.values.size()));
+}
+
+qint64 ArrowStreamWriter::bufferedBytes(void) const
+{
+    qint64 bytes = 0;
+    for (const Column_t& column: _columns) {
+        bytes += column.values.size() + column.offsets.size();
+    }
+    return bytes;
+}
+
+QByteArray ArrowStreamWriter::schemaMessage(void) const
+{
+    FlatBufferBuilder builder;
+
+    QList<uint32_t> fieldOffsets;
+    for (const Field_t& field: _fields) {
+        const uint32_t name = builder.createString(field.name.toUtf8());
+        const uint32_t timezone = (field.type == Type::TimestampMicros) ? builder.createString(QByteArrayLiteral("UTC")) : 0;
+
+        uint8_t typeType;
+        builder.startTable();
+        switch (field.type) {
+        case Type::Float32:
+        case Type::Float64:
+            typeType = typeFloatingPoint;
+            builder.addScalar<int16_t>(0, (field.type == Type::Float32) ? precisionSingle : precisionDouble);
+            break;
+        case Type::Utf8:
+            typeType = typeUtf8;
+            break;
+        case Type::Binary:
+            typeType = typeBinary;
+            break;
+        case Type::TimestampMicros:
+            typeType = typeTimestamp;
+            builder.addOffset(1, timezone);
+            builder.addScalar<int16_t>(0, timeUnitMicrosecond);
+            break;
+        default:
+            typeType = typeInt;
+            builder.addScalar<int32_t>(0, valueSize(field.type) * 8);
+            builder.addScalar<uint8_t>(1, (field.type >= Type::Int8) && (field.type <= Type::Int64));
+            break;
+        }
+        const uint32_t type = builder.endTable();
+
+        // Readers reject fields without a children vector, even an empty one
+        const uint32_t children = builder.createOffsetVector({});
+
+        // Field: name, nullable, type_type, type, dictionary, children
+        builder.startTable();
+        builder.addOffset(0, name);
+        builder.addOffset(3, type);
+        builder.addOffset(5, children);
+        builder.addScalar<uint8_t>(1, 0);
+        builder.addScalar<uint8_t>(2, typeType);
+        fieldOffsets.append(builder.endTable());
+    }
+    const uint32_t fields = builder.createOffsetVector(fieldOffsets);
+
+    // Schema: endianness (little), fields
+    builder.startTable();
+    builder.addOffset(1, fields);
+    builder.addScalar<int16_t>(0, 0);
+    const uint32_t schema = builder.endTable();
+
+    return _frame(builder.finish(createMessage(builder, messageHeaderSchema, schema, 0)), QByteArray());
+}
+
+QByteArray ArrowStreamWriter::takeRecordBatch(void)
+{
+    QByteArray body;
+    QList<QPair<qint64, qint64>> nodes;
+    QList<QPair<qint64, qint64>> buffers;
+
+    for (qsizetype i = 0; i < _columns.count(); i++) {
+        Column_t& column = _columns[i];
+
+        nodes.append({ _rowCount, 0 });
+        appendPadded(body, buffers, QByteArray());     // No validity bitmap, nothing is null
+        if (_isVariableLength(_fields[i].type)) {
+            appendPadded(body, buffers, column.offsets);
+            column.offsets.clear();
+            appendValue<int32_t>(column.offsets, 0);
+        }
+        appendPadded(body, buffers, column.values);
+        column.values.clear();
+    }
+
+    FlatBufferBuilder builder;
+    const uint32_t nodeVector = builder.createLongPairVector(nodes);
+    const uint32_t bufferVector = builder.createLongPairVector(buffers);
+
+    // RecordBatch: length, nodes, buffers
+    builder.startTable();
+    builder.addScalar<qint64>(0, _rowCount);
+    builder.addOffset(1, nodeVector);
+    builder.addOffset(2, bufferVector);
+    const uint32_t recordBatch = builder.endTable();
+
+    _rowCount = 0;
+    return _frame(builder.finish(createMessage(builder, messageHeaderRecordBatch, recordBatch, body.size())), body);
+}
+
+QByteArray ArrowStreamWriter::_frame(const QByteArray& metadata, const QByteArray& body)
+{
+    QByteArray message;
+    message.reserve(8 + metadata.size() + body.size());
+    appendValue<quint32>(message, continuationMarker);
+    appendValue<int32_t>(message, static_cast<int32_t>(metadata.size()));
+    message.append(metadata);
+    message.append(body);
+    return message;
+}
+
+QByteArray ArrowStreamWriter::endOfStreamMessage(void)
+{
+    QByteArray message;
+    appendValue<quint32>(message, continuationMarker);
+    appendValue<int32_t>(message, 0);
+    return message;
+}
+
+qint64 ArrowStreamWriter::completeLength(QIODevice* device, bool* endOfStream)
+{
+    if (endOfStream) {
+        *endOfStream = false;
+    }
+
+    const qint64 deviceSize = device->size();
+    qint64 position = 0;
+    while ((deviceSize - position) >= 8) {
+        if (!device->seek(position)) {
+            break;
+        }
+        const QByteArray prefix = device->read(8);
+        if ((prefix.size() != 8) || (qFromLittleEndian<quint32>(prefix.constData()) != continuationMarker)) {
+            break;
+        }
+        const qint32 metadataLength = qFromLittleEndian<qint32>(prefix.constData() + 4);
+        if (metadataLength == 0) {
+            if (endOfStream) {
+                *endOfStream = true;
+            }
+            return position + 8;
+        }
+        if ((metadataLength < 8) || ((position + 8 + metadataLength) > deviceSize)) {
+            break;
+        }
+
+        // Only the body length is needed from the Message table
+        const QByteArray metadata = device->read(metadataLength);
+        if (metadata.size() != metadataLength) {
+            break;
+        }
+        const char* const data = metadata.constData();
+        const quint32 table = qFromLittleEndian<quint32>(data);
+        if ((table + 4) > static_cast<quint32>(metadataLength)) {
+            break;
+        }
+        const qint64 vtable = static_cast<qint64>(table) - qFromLittleEndian<qint32>(data + table);
+        if ((vtable < 0) || ((vtable + 4) > metadataLength)) {
+            break;
+        }
+        const quint16 vtableLength = qFromLittleEndian<quint16>(data + vtable);
+        const int slotPosition = 4 + (2 * messageBodyLengthSlot);
+        qint64 bodyLength = 0;
+        if (((slotPosition + 2) <= vtableLength) && ((vtable + slotPosition + 2) <= metadataLength)) {
+            const quint16 fieldOffset = qFromLittleEndian<quint16>(data + vtable + slotPosition);
+            if (fieldOffset != 0) {
+                if ((table + fieldOffset + 8) > static_cast<quint32>(metadataLength)) {
+                    break;
+                }
+                bodyLength = qFromLittleEndian<qint64>(data + table + fieldOffset);
+            }
+        }
+
+        const qint64 next = position + 8 + metadataLength + bodyLength;
+        if ((bodyLength < 0) || (next > deviceSize)) {
+            break;
+        }
+        position = next;
+    }
+
+    return position;
+}
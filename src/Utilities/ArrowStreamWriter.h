@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+class QIODevice;
+
+/// Encodes a table in the Arrow IPC streaming format (https://arrow.apache.org/docs/format/Columnar.html), which
+/// pyarrow, polars, DuckDB and others read directly. Rows are collected column by column, takeRecordBatch() turns the
+/// collected rows into one record batch message. A stream is the schema message, any number of record batches and
+/// the end of stream marker:
+///
+///     device.write(writer.schemaMessage());
+///     ... append values, endRow() ...
+///     device.write(writer.takeRecordBatch());
+///     device.write(ArrowStreamWriter::endOfStreamMessage());
+///
+/// Every message is complete in itself, a stream cut off after any message is still readable once completeLength()
+/// has been used to drop a partial message and the end of stream marker is appended. Columns are never null.
+class ArrowStreamWriter
+{
+public:
+    enum class Type {
+        Int8,
+        Int16,
+        Int32,
+        Int64,
+        UInt8,
+        UInt16,
+        UInt32,
+        UInt64,
+        Float32,
+        Float64,
+        Utf8,
+        Binary,
+        TimestampMicros,    ///< Int64 microseconds since the epoch, UTC
+    };
+
+    typedef struct {
+        QString name;
+        Type    type;
+    } Field_t;
+
+    explicit ArrowStreamWriter(const QList<Field_t>& fields);
+
+    const QList<Field_t>& fields(void) const { return _fields; }
+
+    /// Values are converted to the type of the column, call exactly once per column and row
+    void appendInteger  (int column, qint64 value);
+    void appendUnsigned (int column, quint64 value);
+    void appendDouble   (int column, double value);
+    void appendBytes    (int column, const QByteArray& value);     ///< Utf8 and Binary columns
+    void endRow         (void) { _rowCount++; }
+
+    int     rowCount        (void) const { return _rowCount; }
+    qint64  bufferedBytes   (void) const;
+
+    QByteArray schemaMessage(void) const;
+
+    /// @return Record batch of all rows appended since the last call, the rows are then dropped
+    QByteArray takeRecordBatch(void);
+
+    static QByteArray endOfStreamMessage(void);
+
+    /// Walks the messages of a stream without reading the record batch bodies
+    ///     @param endOfStream Set to true if the stream ends with the end of stream marker
+    /// @return Length of the stream up to the end of the last complete message
+    static qint64 completeLength(QIODevice* device, bool* endOfStream = nullptr);
+
+private:
+    typedef struct {
+        QByteArray values;      ///< Little endian values, data for Utf8/Binary
+        QByteArray offsets;     ///< Int32 offsets into values, Utf8/Binary only
+    } Column_t;
+
+    static bool _isVariableLength(Type type) { return (type == Type::Utf8) || (type == Type::Binary); }
+    static QByteArray _frame(const QByteArray& metadata, const QByteArray& body);
+
+    QList<Field_t>  _fields;
+    QList<Column_t> _columns;
+    int             _rowCount = 0;
+};
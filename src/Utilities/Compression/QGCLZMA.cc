@@ -22,20 +22,8 @@ static std::once_flag crc_init;
 
 namespace QGCLZMA {
 
-bool inflateLZMAFile(const QString &lzmaFilename, const QString &decompressedFilename)
+bool inflateLZMA(QIODevice &input, const DataSink &sink)
 {
-    QFile inputFile(lzmaFilename);
-    if (!inputFile.open(QIODevice::ReadOnly)) {
-        qCWarning(QGCLZMALog) << "open input file failed" << lzmaFilename << inputFile.errorString();
-        return false;
-    }
-
-    QFile outputFile(decompressedFilename);
-    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        qCWarning(QGCLZMALog) << "open input file failed" << outputFile.fileName() << outputFile.errorString();
-        return false;
-    }
-
     std::call_once(crc_init, []() {
         xz_crc32_init();
         xz_crc64_init();
@@ -47,33 +35,37 @@ bool inflateLZMAFile(const QString &lzmaFilename, const QString &decompressedFil
         return false;
     }
 
-    constexpr int buf_size = 4 * 1024;
-    uint8_t in[buf_size];
-    uint8_t out[buf_size];
+    constexpr qsizetype buf_size = 64 * 1024;
+    QByteArray in(buf_size, Qt::Uninitialized);
+    QByteArray out(buf_size, Qt::Uninitialized);
 
     xz_buf b;
-    b.in = in;
+    b.in = reinterpret_cast<const uint8_t*>(in.constData());
     b.in_pos = 0;
     b.in_size = 0;
-    b.out = out;
+    b.out = reinterpret_cast<uint8_t*>(out.data());
     b.out_pos = 0;
     b.out_size = buf_size;
 
+    bool success = false;
     while (true) {
         if (b.in_pos == b.in_size) {
-            b.in_size = static_cast<size_t>(inputFile.read((char*)in, sizeof(in)));
+            const qint64 cBytesRead = input.read(in.data(), buf_size);
+            if (cBytesRead < 0) {
+                qCWarning(QGCLZMALog) << "input read failed:" << input.errorString();
+                break;
+            }
+            b.in_size = static_cast<size_t>(cBytesRead);
             b.in_pos = 0;
         }
 
-        xz_ret ret = xz_dec_run(s, &b);
+        const xz_ret ret = xz_dec_run(s, &b);
 
-        if (b.out_pos == sizeof(out)) {
-            const size_t cBytesWritten = static_cast<size_t>(outputFile.write((char*)out, static_cast<int>(b.out_pos)));
-            if (cBytesWritten != b.out_pos) {
-                qCWarning(QGCLZMALog) << "output file write failed:" << outputFile.fileName() << outputFile.errorString();
-                goto error;
+        // The sink gets a chunk each time the output buffer fills up, and whatever is left at the end
+        if ((b.out_pos == b.out_size) || ((ret != XZ_OK) && (ret != XZ_UNSUPPORTED_CHECK) && (b.out_pos > 0))) {
+            if (!sink(QByteArrayView(out.constData(), static_cast<qsizetype>(b.out_pos)))) {
+                break;
             }
-
             b.out_pos = 0;
         }
 
@@ -86,45 +78,58 @@ bool inflateLZMAFile(const QString &lzmaFilename, const QString &decompressedFil
             continue;
         }
 
-        const size_t cBytesWritten = static_cast<size_t>(outputFile.write((char*)out, static_cast<int>(b.out_pos)));
-        if (cBytesWritten != b.out_pos) {
-            qCWarning(QGCLZMALog) << "output file write failed:" << outputFile.fileName() << outputFile.errorString();
-            goto error;
-        }
-
         switch (ret) {
         case XZ_STREAM_END:
-            xz_dec_end(s);
-            return true;
+            success = true;
+            break;
         case XZ_MEM_ERROR:
             qCWarning(QGCLZMALog) << "Memory allocation failed";
-            goto error;
+            break;
         case XZ_MEMLIMIT_ERROR:
             qCWarning(QGCLZMALog) << "Memory usage limit reached";
-            goto error;
+            break;
         case XZ_FORMAT_ERROR:
             qCWarning(QGCLZMALog) << "Not a .xz file";
-            goto error;
+            break;
         case XZ_OPTIONS_ERROR:
             qCWarning(QGCLZMALog) << "Unsupported options in the .xz headers";
-            goto error;
+            break;
         case XZ_DATA_ERROR:
         case XZ_BUF_ERROR:
             qCWarning(QGCLZMALog) << "File is corrupt";
-            goto error;
+            break;
         default:
             qCWarning(QGCLZMALog) << "Bug!";
-            goto error;
+            break;
         }
+        break;
     }
 
     xz_dec_end(s);
-    return true;
+    return success;
+}
 
-error:
-    xz_dec_end(s);
-    return false;
+bool inflateLZMAFile(const QString &lzmaFilename, const QString &decompressedFilename)
+{
+    QFile inputFile(lzmaFilename);
+    if (!inputFile.open(QIODevice::ReadOnly)) {
+        qCWarning(QGCLZMALog) << "open input file failed" << lzmaFilename << inputFile.errorString();
+        return false;
+    }
 
+    QFile outputFile(decompressedFilename);
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(QGCLZMALog) << "open input file failed" << outputFile.fileName() << outputFile.errorString();
+        return false;
+    }
+
+    return inflateLZMA(inputFile, [&outputFile](QByteArrayView data) {
+        if (outputFile.write(data.data(), data.size()) != data.size()) {
+            qCWarning(QGCLZMALog) << "output file write failed:" << outputFile.fileName() << outputFile.errorString();
+            return false;
+        }
+        return true;
+    });
 }
 
 } // namespace QGCLZMA
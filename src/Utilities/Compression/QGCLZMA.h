@@ -9,12 +9,24 @@
 
 #pragma once
 
+#include <QtCore/QByteArrayView>
 #include <QtCore/QString>
 #include <QtCore/QLoggingCategory>
 
+#include <functional>
+
+class QIODevice;
+
 Q_DECLARE_LOGGING_CATEGORY(QGCLZMALog)
 
 namespace QGCLZMA {
+    /// Receives decompressed data one chunk at a time. Returning false stops the decompression.
+    using DataSink = std::function<bool(QByteArrayView data)>;
+
+    /// Decompresses xz data read from the specified device, only one chunk of input and output is held at a time
+    ///     @return true: the whole stream was decompressed
+    bool inflateLZMA(QIODevice &input, const DataSink &sink);
+
     /// Decompresses the specified file to the specified directory
     ///     @param lzmaFilename         Fully qualified path to lzma file
     ///     @param decompressedFilename Fully qualified path to for file to decompress to
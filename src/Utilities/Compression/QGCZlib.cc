@@ -18,15 +18,217 @@ QGC_LOGGING_CATEGORY(QGCZlibLog, "qgc.compression.qgczlib")
 
 namespace QGCZlib {
 
-bool inflateGzipFile(const QString &gzippedFileName, const QString &decompressedFilename)
+namespace {
+    constexpr qsizetype kChunkSize = 64 * 1024;
+}
+
+Inflater::Inflater(Format format, const DataSink &sink)
+    : _strm(std::make_unique<z_stream>())
+    , _sink(sink)
+    , _outputBuffer(kChunkSize, Qt::Uninitialized)
+{
+    int windowBits = MAX_WBITS;
+    if (format == Format::Gzip) {
+        windowBits += 16;
+    } else if (format == Format::Detect) {
+        windowBits += 32;
+    }
+
+    const int ret = inflateInit2(_strm.get(), windowBits);
+    if (ret != Z_OK) {
+        qCWarning(QGCZlibLog) << "inflateInit2 failed:" << ret;
+        return;
+    }
+    _valid = true;
+}
+
+Inflater::~Inflater()
+{
+    if (_valid) {
+        (void) inflateEnd(_strm.get());
+    }
+}
+
+bool Inflater::write(QByteArrayView data)
+{
+    if (!_valid) {
+        return false;
+    }
+    if (_finished) {
+        // Trailing data after the end of the stream is ignored
+        return true;
+    }
+
+    _strm->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    _strm->avail_in = static_cast<uInt>(data.size());
+
+    do {
+        _strm->next_out = reinterpret_cast<Bytef*>(_outputBuffer.data());
+        _strm->avail_out = static_cast<uInt>(_outputBuffer.size());
+
+        const int ret = inflate(_strm.get(), Z_NO_FLUSH);
+        if ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR)) {
+            qCWarning(QGCZlibLog) << "inflate failed:" << ret;
+            _valid = false;
+            (void) inflateEnd(_strm.get());
+            return false;
+        }
+
+        const qsizetype cBytesInflated = _outputBuffer.size() - static_cast<qsizetype>(_strm->avail_out);
+        if (cBytesInflated > 0) {
+            _totalOut += cBytesInflated;
+            if (!_sink(QByteArrayView(_outputBuffer.constData(), cBytesInflated))) {
+                return false;
+            }
+        }
+
+        if (ret == Z_STREAM_END) {
+            _finished = true;
+            break;
+        }
+    } while ((_strm->avail_in > 0) || (_strm->avail_out == 0));
+
+    return true;
+}
+
+Deflater::Deflater(const DataSink &sink, int level)
+    : _strm(std::make_unique<z_stream>())
+    , _sink(sink)
+    , _outputBuffer(kChunkSize, Qt::Uninitialized)
+{
+    // MAX_WBITS + 16 writes a gzip header and trailer
+    const int ret = deflateInit2(_strm.get(), level, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK) {
+        qCWarning(QGCZlibLog) << "deflateInit2 failed:" << ret;
+        return;
+    }
+    _valid = true;
+}
+
+Deflater::~Deflater()
+{
+    if (_valid) {
+        (void) deflateEnd(_strm.get());
+    }
+}
+
+bool Deflater::write(QByteArrayView data)
+{
+    if (!_valid) {
+        return false;
+    }
+
+    _strm->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    _strm->avail_in = static_cast<uInt>(data.size());
+
+    return _deflate(Z_NO_FLUSH);
+}
+
+bool Deflater::finish()
+{
+    if (!_valid) {
+        return false;
+    }
+
+    _strm->next_in = nullptr;
+    _strm->avail_in = 0;
+
+    const bool result = _deflate(Z_FINISH);
+    (void) deflateEnd(_strm.get());
+    _valid = false;
+
+    return result;
+}
+
+bool Deflater::_deflate(int flush)
+{
+    int ret;
+    do {
+        _strm->next_out = reinterpret_cast<Bytef*>(_outputBuffer.data());
+        _strm->avail_out = static_cast<uInt>(_outputBuffer.size());
+
+        ret = deflate(_strm.get(), flush);
+        if ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR)) {
+            qCWarning(QGCZlibLog) << "deflate failed:" << ret;
+            _valid = false;
+            (void) deflateEnd(_strm.get());
+            return false;
+        }
+
+        const qsizetype cBytesDeflated = _outputBuffer.size() - static_cast<qsizetype>(_strm->avail_out);
+        if (cBytesDeflated > 0) {
+            _totalOut += cBytesDeflated;
+            if (!_sink(QByteArrayView(_outputBuffer.constData(), cBytesDeflated))) {
+                return false;
+            }
+        }
+    } while ((_strm->avail_out == 0) || ((flush == Z_FINISH) && (ret != Z_STREAM_END)));
+
+    return true;
+}
+
+bool deflateGzipFile(const QString &fileName, const QString &gzippedFileName)
 {
-    bool success = true;
-    int ret = 0;
-    constexpr int cBuffer = 1024 * 5;
-    unsigned char inputBuffer[cBuffer];
-    unsigned char outputBuffer[cBuffer];
-    z_stream strm;
+    QFile inputFile(fileName);
+    if (!inputFile.open(QIODevice::ReadOnly)) {
+        qCWarning(QGCZlibLog) << "open input file failed" << fileName << inputFile.errorString();
+        return false;
+    }
+
+    QFile outputFile(gzippedFileName);
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(QGCZlibLog) << "open output file failed" << outputFile.fileName() << outputFile.errorString();
+        return false;
+    }
+
+    Deflater deflater([&outputFile](QByteArrayView data) {
+        if (outputFile.write(data.data(), data.size()) != data.size()) {
+            qCWarning(QGCZlibLog) << "output file write failed:" << outputFile.fileName() << outputFile.errorString();
+            return false;
+        }
+        return true;
+    });
+
+    QByteArray inputBuffer(kChunkSize, Qt::Uninitialized);
+    while (!inputFile.atEnd()) {
+        const qint64 cBytesRead = inputFile.read(inputBuffer.data(), inputBuffer.size());
+        if (cBytesRead < 0) {
+            qCWarning(QGCZlibLog) << "input read failed:" << inputFile.errorString();
+            return false;
+        }
+        if (!deflater.write(QByteArrayView(inputBuffer.constData(), cBytesRead))) {
+            return false;
+        }
+    }
 
+    return deflater.finish();
+}
+
+bool inflateGzip(QIODevice &input, const DataSink &sink)
+{
+    Inflater inflater(Inflater::Format::Gzip, sink);
+    QByteArray inputBuffer(kChunkSize, Qt::Uninitialized);
+
+    while (!inflater.finished()) {
+        const qint64 cBytesRead = input.read(inputBuffer.data(), inputBuffer.size());
+        if (cBytesRead < 0) {
+            qCWarning(QGCZlibLog) << "input read failed:" << input.errorString();
+            return false;
+        }
+        if (cBytesRead == 0) {
+            qCWarning(QGCZlibLog) << "unexpected end of compressed data";
+            return false;
+        }
+        if (!inflater.write(QByteArrayView(inputBuffer.constData(), cBytesRead))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool inflateGzipFile(const QString &gzippedFileName, const QString &decompressedFilename)
+{
     QFile inputFile(gzippedFileName);
     if (!inputFile.open(QIODevice::ReadOnly)) {
         qCWarning(QGCZlibLog) << "open input file failed" << gzippedFileName << inputFile.errorString();
@@ -39,52 +241,53 @@ bool inflateGzipFile(const QString &gzippedFileName, const QString &decompressed
         return false;
     }
 
-    strm.zalloc = nullptr;
-    strm.zfree = nullptr;
-    strm.opaque = nullptr;
-    strm.avail_in = 0;
-    strm.next_in = nullptr;
+    return inflateGzip(inputFile, [&outputFile](QByteArrayView data) {
+        if (outputFile.write(data.data(), data.size()) != data.size()) {
+            qCWarning(QGCZlibLog) << "output file write failed:" << outputFile.fileName() << outputFile.errorString();
+            return false;
+        }
+        return true;
+    });
+}
 
-    ret = inflateInit2(&strm, 16 + MAX_WBITS);
+QByteArray inflateGzip(QByteArrayView data)
+{
+    QByteArray inflated;
+    if (data.isEmpty()) {
+        return inflated;
+    }
+
+    z_stream strm{};
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    strm.avail_in = static_cast<uInt>(data.size());
+
+    // 32 + MAX_WBITS detects gzip or zlib headers
+    int ret = inflateInit2(&strm, 32 + MAX_WBITS);
     if (ret != Z_OK) {
         qCWarning(QGCZlibLog) << "inflateInit2 failed:" << ret;
-        goto Error;
+        return inflated;
     }
 
+    inflated.resize(qMax(data.size() * 4, static_cast<qsizetype>(1024)));
     do {
-        strm.avail_in = static_cast<unsigned>(inputFile.read(reinterpret_cast<char*>(inputBuffer), cBuffer));
-        if (strm.avail_in == 0) {
-            break;
+        if (strm.total_out == static_cast<uLong>(inflated.size())) {
+            inflated.resize(inflated.size() * 2);
         }
-        strm.next_in = inputBuffer;
+        strm.next_out = reinterpret_cast<Bytef*>(inflated.data()) + strm.total_out;
+        strm.avail_out = static_cast<uInt>(inflated.size() - static_cast<qsizetype>(strm.total_out));
 
-        do {
-            strm.avail_out = cBuffer;
-            strm.next_out = outputBuffer;
+        ret = inflate(&strm, Z_NO_FLUSH);
+    } while (ret == Z_OK);
 
-            ret = inflate(&strm, Z_NO_FLUSH);
-            if ((ret != Z_OK) && (ret != Z_STREAM_END)) {
-                qCWarning(QGCZlibLog) << "inflate failed:" << ret;
-                goto Error;
-            }
-
-            const unsigned cBytesInflated = cBuffer - strm.avail_out;
-            const qint64 cBytesWritten = outputFile.write(reinterpret_cast<char*>(outputBuffer), static_cast<int>(cBytesInflated));
-            if (cBytesWritten != cBytesInflated) {
-                qCWarning(QGCZlibLog) << "output file write failed:" << outputFile.fileName() << outputFile.errorString();
-                goto Error;
-
-            }
-        } while (strm.avail_out == 0);
-    } while (ret != Z_STREAM_END);
-
-Out:
-    inflateEnd(&strm);
-    return success;
+    if (ret != Z_STREAM_END) {
+        qCWarning(QGCZlibLog) << "inflate failed:" << ret;
+        inflated.clear();
+    } else {
+        inflated.resize(static_cast<qsizetype>(strm.total_out));
+    }
 
-Error:
-    success = false;
-    goto Out;
+    (void) inflateEnd(&strm);
+    return inflated;
 }
 
 } // namespace QGCZlib
@@ -9,14 +9,100 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QString>
 #include <QtCore/QLoggingCategory>
 
+#include <functional>
+#include <memory>
+
+struct z_stream_s;
+class QIODevice;
+
 Q_DECLARE_LOGGING_CATEGORY(QGCZlibLog)
 
 namespace QGCZlib {
+    /// Receives decompressed data one chunk at a time. Returning false stops the decompression.
+    using DataSink = std::function<bool(QByteArrayView data)>;
+
+    /// Incremental gzip/zlib decompression. Compressed data is pushed in as it becomes available and the
+    /// decompressed data is handed to the sink, so neither has to be held in memory as a whole.
+    class Inflater
+    {
+    public:
+        enum class Format {
+            Zlib,
+            Gzip,
+            Detect, ///< Gzip or zlib, from the header
+        };
+
+        Inflater(Format format, const DataSink &sink);
+        ~Inflater();
+
+        /// Decompresses the next slice of compressed data
+        ///     @return false: data is corrupt or the sink stopped the decompression
+        bool write(QByteArrayView data);
+
+        /// @return true: the end of the compressed stream was reached
+        bool finished() const { return _finished; }
+
+        /// @return Number of decompressed bytes handed to the sink so far
+        qint64 totalOut() const { return _totalOut; }
+
+    private:
+        std::unique_ptr<z_stream_s> _strm;
+        DataSink _sink;
+        QByteArray _outputBuffer;
+        qint64 _totalOut = 0;
+        bool _valid = false;
+        bool _finished = false;
+    };
+
+    /// Incremental gzip compression, the counterpart of Inflater
+    class Deflater
+    {
+    public:
+        /// @param level zlib compression level, 0-9
+        Deflater(const DataSink &sink, int level = 6);
+        ~Deflater();
+
+        /// Compresses the next slice of data
+        ///     @return false: compression failed or the sink stopped it
+        bool write(QByteArrayView data);
+
+        /// Flushes the remaining compressed data and the gzip trailer to the sink
+        ///     @return false: compression failed or the sink stopped it
+        bool finish();
+
+        /// @return Number of compressed bytes handed to the sink so far
+        qint64 totalOut() const { return _totalOut; }
+
+    private:
+        bool _deflate(int flush);
+
+        std::unique_ptr<z_stream_s> _strm;
+        DataSink _sink;
+        QByteArray _outputBuffer;
+        qint64 _totalOut = 0;
+        bool _valid = false;
+    };
+
+    /// Compresses the specified file to a gzip file, only one chunk of input and output is held at a time
+    ///     @param fileName             Fully qualified path to file to compress
+    ///     @param gzippedFileName      Fully qualified path to gzip file to create
+    bool deflateGzipFile(const QString &fileName, const QString &gzippedFileName);
+
+    /// Decompresses gzip data read from the specified device
+    ///     @return true: the whole stream was decompressed
+    bool inflateGzip(QIODevice &input, const DataSink &sink);
+
     /// Decompresses the specified file to the specified directory
     ///     @param gzippedFileName      Fully qualified path to gzip file
     ///     @param decompressedFilename Fully qualified path to for file to decompress to
     bool inflateGzipFile(const QString &gzippedFileName, const QString &decompressedFilename);
+
+    /// Decompresses gzip or zlib data held in memory
+    ///     @param data     Compressed bytes
+    ///     @return Decompressed bytes, empty on failure
+    QByteArray inflateGzip(QByteArrayView data);
 } // namespace QGCZlib
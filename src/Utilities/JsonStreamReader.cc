@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "JsonStreamReader.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonParseError>
+
+namespace {
+    bool _isWhitespace(char c)
+    {
+        return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+    }
+}
+
+bool JsonStreamReader::open(const QByteArray& bytes, QString& errorString)
+{
+    _bytes = bytes;
+    _header = QJsonObject();
+    _containerSpans.clear();
+
+    qsizetype pos = _skipWhitespace(0);
+    if ((pos >= _bytes.size()) || (_bytes[pos] != '{')) {
+        errorString = _errorAt(pos, tr("root is not an object"));
+        return false;
+    }
+
+    pos = _skipWhitespace(pos + 1);
+    bool more = (pos < _bytes.size()) && (_bytes[pos] != '}');
+    while (more) {
+        if ((pos >= _bytes.size()) || (_bytes[pos] != '"')) {
+            errorString = _errorAt(pos, tr("expected key"));
+            return false;
+        }
+
+        const qsizetype keyStart = pos;
+        if (!_skipString(pos)) {
+            errorString = _errorAt(keyStart, tr("unterminated string"));
+            return false;
+        }
+        QJsonValue keyValue;
+        if (!_buildValue({ keyStart, pos - keyStart }, keyValue, errorString)) {
+            return false;
+        }
+        const QString key = keyValue.toString();
+
+        pos = _skipWhitespace(pos);
+        if ((pos >= _bytes.size()) || (_bytes[pos] != ':')) {
+            errorString = _errorAt(pos, tr("expected ':'"));
+            return false;
+        }
+
+        pos = _skipWhitespace(pos + 1);
+        const qsizetype valueStart = pos;
+        if (!_skipValue(pos)) {
+            errorString = _errorAt(valueStart, tr("malformed value for key %1").arg(key));
+            return false;
+        }
+
+        const Span_t span = { valueStart, pos - valueStart };
+        const char first = _bytes[valueStart];
+        if ((first == '{') || (first == '[')) {
+            // Left empty in the header, only the type is needed to validate it
+            _containerSpans[key] = span;
+            _header[key] = (first == '{') ? QJsonValue(QJsonObject()) : QJsonValue(QJsonArray());
+        } else {
+            QJsonValue value;
+            if (!_buildValue(span, value, errorString)) {
+                return false;
+            }
+            _containerSpans.remove(key);
+            _header[key] = value;
+        }
+
+        pos = _skipWhitespace(pos);
+        if ((pos < _bytes.size()) && (_bytes[pos] == ',')) {
+            pos = _skipWhitespace(pos + 1);
+        } else {
+            more = false;
+        }
+    }
+
+    if ((pos >= _bytes.size()) || (_bytes[pos] != '}')) {
+        errorString = _errorAt(pos, tr("expected '}'"));
+        return false;
+    }
+    pos = _skipWhitespace(pos + 1);
+    if (pos != _bytes.size()) {
+        errorString = _errorAt(pos, tr("garbage at the end of the document"));
+        return false;
+    }
+
+    return true;
+}
+
+bool JsonStreamReader::openFile(const QString& fileName, QString& errorString)
+{
+    QFile jsonFile(fileName);
+    if (!jsonFile.open(QFile::ReadOnly)) {
+        errorString = tr("File open failed: file:error %1 %2").arg(jsonFile.fileName()).arg(jsonFile.errorString());
+        return false;
+    }
+
+    return open(jsonFile.readAll(), errorString);
+}
+
+QJsonValue JsonStreamReader::value(const QString& key, QString& errorString) const
+{
+    if (!_containerSpans.contains(key)) {
+        return _header.value(key);
+    }
+
+    QJsonValue value;
+    if (!_buildValue(_containerSpans[key], value, errorString)) {
+        return QJsonValue(QJsonValue::Undefined);
+    }
+    return value;
+}
+
+bool JsonStreamReader::readArray(const QString& key, const std::function<bool(const QJsonValue& element, QString& errorString)>& elementFn, QString& errorString) const
+{
+    if (!_header.value(key).isArray()) {
+        errorString = tr("Key %1 is not an array").arg(key);
+        return false;
+    }
+
+    const Span_t& span = _containerSpans[key];
+    const qsizetype end = span.start + span.length - 1;   // Closing bracket, the nesting was checked by open
+
+    qsizetype pos = _skipWhitespace(span.start + 1);
+    while (pos < end) {
+        const qsizetype elementStart = pos;
+        if (!_skipValue(pos) || (pos > end)) {
+            errorString = _errorAt(elementStart, tr("malformed array element"));
+            return false;
+        }
+
+        QJsonValue element;
+        if (!_buildValue({ elementStart, pos - elementStart }, element, errorString) || !elementFn(element, errorString)) {
+            return false;
+        }
+
+        pos = _skipWhitespace(pos);
+        if (pos < end) {
+            if (_bytes[pos] != ',') {
+                errorString = _errorAt(pos, tr("expected ','"));
+                return false;
+            }
+            pos = _skipWhitespace(pos + 1);
+            if (pos >= end) {
+                errorString = _errorAt(pos, tr("expected array element"));
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+qsizetype JsonStreamReader::_skipWhitespace(qsizetype pos) const
+{
+    while ((pos < _bytes.size()) && _isWhitespace(_bytes[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+/// Moves pos past the string which starts at pos. Escapes are only skipped, they are checked when the value is built.
+bool JsonStreamReader::_skipString(qsizetype& pos) const
+{
+    pos++;
+    while (pos < _bytes.size()) {
+        const char c = _bytes[pos++];
+        if (c == '\\') {
+            pos++;
+        } else if (c == '"') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Moves pos past the value which starts at pos. Objects and arrays are only checked for matching brackets,
+/// QJsonDocument checks the rest when the value is built.
+bool JsonStreamReader::_skipValue(qsizetype& pos) const
+{
+    if (pos >= _bytes.size()) {
+        return false;
+    }
+
+    const char first = _bytes[pos];
+    if (first == '"') {
+        return _skipString(pos);
+    }
+
+    if ((first == '{') || (first == '[')) {
+        QByteArray closers;
+        while (pos < _bytes.size()) {
+            const char c = _bytes[pos];
+            if (c == '"') {
+                if (!_skipString(pos)) {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '{') {
+                closers.append('}');
+            } else if (c == '[') {
+                closers.append(']');
+            } else if ((c == '}') || (c == ']')) {
+                if (closers.isEmpty() || (closers.back() != c)) {
+                    return false;
+                }
+                closers.chop(1);
+                if (closers.isEmpty()) {
+                    pos++;
+                    return true;
+                }
+            }
+            pos++;
+        }
+        return false;
+    }
+
+    // Number or literal
+    const qsizetype start = pos;
+    while ((pos < _bytes.size()) && !_isWhitespace(_bytes[pos]) && (_bytes[pos] != ',') && (_bytes[pos] != '}') && (_bytes[pos] != ']')) {
+        pos++;
+    }
+    return pos > start;
+}
+
+bool JsonStreamReader::_buildValue(const Span_t& span, QJsonValue& value, QString& errorString) const
+{
+    const char first = _bytes[span.start];
+    const bool container = (first == '{') || (first == '[');
+
+    // QJsonDocument only takes objects and arrays, scalars are wrapped in an array
+    QJsonParseError parseError;
+    const QJsonDocument jsonDoc = container ?
+                QJsonDocument::fromJson(QByteArray::fromRawData(_bytes.constData() + span.start, span.length), &parseError) :
+                QJsonDocument::fromJson(QByteArray(1, '[') + _bytes.mid(span.start, span.length) + ']', &parseError);
+
+    if (parseError.error != QJsonParseError::NoError) {
+        errorString = _errorAt(span.start + (container ? parseError.offset : qMax(0, parseError.offset - 1)), parseError.errorString());
+        return false;
+    }
+
+    if (jsonDoc.isObject()) {
+        value = jsonDoc.object();
+    } else if (container) {
+        value = jsonDoc.array();
+    } else {
+        value = jsonDoc.array().at(0);
+    }
+    return true;
+}
+
+QString JsonStreamReader::_errorAt(qsizetype pos, const QString& error) const
+{
+    return tr("Json parse error at offset %1: %2").arg(pos).arg(error);
+}
@@ -0,0 +1,65 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QString>
+
+#include <functional>
+
+/// Reads the members of a json root object directly from the file bytes, without building a QJsonDocument
+/// for the whole file. Scalar members are read while scanning, object and array members are only checked for
+/// well formed nesting and turned into a QJsonValue when they are asked for. Large arrays can be read one
+/// element at a time.
+class JsonStreamReader
+{
+    Q_DECLARE_TR_FUNCTIONS(JsonStreamReader)
+
+public:
+    /// Scans the root object of the specified json bytes
+    /// @return false: bytes are not a well formed json object
+    bool open(const QByteArray& bytes, QString& errorString);
+
+    /// Reads and scans the specified json file
+    bool openFile(const QString& fileName, QString& errorString);
+
+    /// The root object with object and array members left empty. Enough for JsonHelper::validateKeys and the
+    /// other header checks.
+    const QJsonObject& header(void) const { return _header; }
+
+    bool contains(const QString& key) const { return _header.contains(key); }
+
+    /// Builds the value of the specified member
+    QJsonValue value(const QString& key, QString& errorString) const;
+
+    /// Calls elementFn for each element of the specified array member. Only one element is built at a time.
+    /// @return false: member is not an array, an element is not well formed or elementFn returned false
+    bool readArray(const QString& key, const std::function<bool(const QJsonValue& element, QString& errorString)>& elementFn, QString& errorString) const;
+
+private:
+    typedef struct {
+        qsizetype start;
+        qsizetype length;
+    } Span_t;
+
+    qsizetype   _skipWhitespace (qsizetype pos) const;
+    bool        _skipString     (qsizetype& pos) const;
+    bool        _skipValue      (qsizetype& pos) const;
+    bool        _buildValue     (const Span_t& span, QJsonValue& value, QString& errorString) const;
+    QString     _errorAt        (qsizetype pos, const QString& error) const;
+
+    QByteArray              _bytes;
+    QJsonObject             _header;
+    QHash<QString, Span_t>  _containerSpans;    ///< Object and array members by key
+};
@@ -10,48 +10,57 @@
 #include "KMLHelper.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QXmlStreamReader>
 
-QDomDocument KMLHelper::_loadFile(const QString& kmlFile, QString& errorString)
-{
-    QFile file(kmlFile);
+#include <algorithm>
 
+bool KMLHelper::_openFile(QFile& file, const QString& kmlFile, QString& errorString)
+{
     errorString.clear();
 
     if (!file.exists()) {
         errorString = QString(_errorPrefix).arg(tr("File not found: %1").arg(kmlFile));
-        return QDomDocument();
+        return false;
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
         errorString = QString(_errorPrefix).arg(tr("Unable to open file: %1 error: $%2").arg(kmlFile).arg(file.errorString()));
-        return QDomDocument();
+        return false;
     }
 
-    QDomDocument doc;
-    QString errorMessage;
-    int errorLine;
-    if (!doc.setContent(&file, &errorMessage, &errorLine)) {
-        errorString = QString(_errorPrefix).arg(tr("Unable to parse KML file: %1 error: %2 line: %3").arg(kmlFile).arg(errorMessage).arg(errorLine));
-        return QDomDocument();
-    }
+    return true;
+}
 
-    return doc;
+QString KMLHelper::_parseError(const QString& kmlFile, const QXmlStreamReader& xml)
+{
+    return QString(_errorPrefix).arg(tr("Unable to parse KML file: %1 error: %2 line: %3").arg(kmlFile).arg(xml.errorString()).arg(xml.lineNumber()));
 }
 
 ShapeFileHelper::ShapeType KMLHelper::determineShapeType(const QString& kmlFile, QString& errorString)
 {
-    QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
+    QFile file(kmlFile);
+    if (!_openFile(file, kmlFile, errorString)) {
         return ShapeFileHelper::Error;
     }
 
-    QDomNodeList rgNodes = domDocument.elementsByTagName("Polygon");
-    if (rgNodes.count()) {
-        return ShapeFileHelper::Polygon;
+    // A Polygon anywhere in the file takes precedence over a LineString
+    bool foundLineString = false;
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::StartElement) {
+            if (xml.name() == QLatin1String("Polygon")) {
+                return ShapeFileHelper::Polygon;
+            } else if (xml.name() == QLatin1String("LineString")) {
+                foundLineString = true;
+            }
+        }
+    }
+    if (xml.hasError()) {
+        errorString = _parseError(kmlFile, xml);
+        return ShapeFileHelper::Error;
     }
 
-    rgNodes = domDocument.elementsByTagName("LineString");
-    if (rgNodes.count()) {
+    if (foundLineString) {
         return ShapeFileHelper::Polyline;
     }
 
@@ -59,42 +68,118 @@ ShapeFileHelper::ShapeType KMLHelper::determineShapeType(const QString& kmlFile,
     return ShapeFileHelper::Error;
 }
 
-bool KMLHelper::loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate>& vertices, QString& errorString)
+/// Loads the coordinates of the first element named elementPath[0]. The remaining names are the path of direct child
+/// elements leading from it to the coordinates element.
+bool KMLHelper::_loadCoordinates(const QString& kmlFile, const QStringList& elementPath, QList<QGeoCoordinate>& coords, QString& errorString)
 {
-    errorString.clear();
-    vertices.clear();
+    coords.clear();
 
-    QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
+    QFile file(kmlFile);
+    if (!_openFile(file, kmlFile, errorString)) {
         return false;
     }
 
-    QDomNodeList rgNodes = domDocument.elementsByTagName("Polygon");
-    if (rgNodes.count() == 0) {
-        errorString = QString(_errorPrefix).arg(tr("Unable to find Polygon node in KML"));
-        return false;
+    QXmlStreamReader xml(&file);
+    int depth = 0;
+    int shapeDepth = -1;    // Depth of the shape element once found
+    int matchedCount = 0;   // Number of elementPath entries matched along the current branch
+
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+
+        if (token == QXmlStreamReader::StartElement) {
+            depth++;
+            if (shapeDepth < 0) {
+                if (xml.name() == elementPath[0]) {
+                    shapeDepth = depth;
+                    matchedCount = 1;
+                }
+            } else if ((depth == shapeDepth + matchedCount) && (xml.name() == elementPath[matchedCount])) {
+                if (++matchedCount == elementPath.count()) {
+                    const QString coordinatesString = xml.readElementText();
+                    if (xml.hasError()) {
+                        break;
+                    }
+                    _parseCoordinates(coordinatesString, coords);
+                    return true;
+                }
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            if (depth == shapeDepth) {
+                errorString = QString(_errorPrefix).arg(tr("Internal error: Unable to find coordinates node in KML"));
+                return false;
+            }
+            matchedCount = qMin(matchedCount, depth - shapeDepth);
+            depth--;
+        }
     }
 
-    QDomNode coordinatesNode = rgNodes.item(0).namedItem("outerBoundaryIs").namedItem("LinearRing").namedItem("coordinates");
-    if (coordinatesNode.isNull()) {
-        errorString = QString(_errorPrefix).arg(tr("Internal error: Unable to find coordinates node in KML"));
-        return false;
+    if (xml.hasError()) {
+        errorString = _parseError(kmlFile, xml);
+    } else {
+        errorString = QString(_errorPrefix).arg(tr("Unable to find %1 node in KML").arg(elementPath[0]));
     }
+    return false;
+}
 
-    QString coordinatesString = coordinatesNode.toElement().text().simplified();
-    QStringList rgCoordinateStrings = coordinatesString.split(" ");
+void KMLHelper::_parseCoordinates(QStringView coordinatesString, QList<QGeoCoordinate>& coords)
+{
+    QList<QPointF> points;
+    _parseCoordinates(coordinatesString, points);
 
-    QList<QGeoCoordinate> rgCoords;
-    for (int i=0; i<rgCoordinateStrings.count()-1; i++) {
-        QString coordinateString = rgCoordinateStrings[i];
+    coords.reserve(coords.count() + points.count());
+    for (const QPointF& point : points) {
+        coords.append(QGeoCoordinate(point.y(), point.x()));
+    }
+}
 
-        QStringList rgValueStrings = coordinateString.split(",");
+/// Parses a KML coordinates string of whitespace separated lon,lat[,alt] tuples without splitting it into a string list.
+/// Points are x: longitude, y: latitude.
+void KMLHelper::_parseCoordinates(QStringView coordinatesString, QList<QPointF>& points)
+{
+    const qsizetype length = coordinatesString.length();
+    qsizetype index = 0;
+
+    while (index < length) {
+        while ((index < length) && coordinatesString[index].isSpace()) {
+            index++;
+        }
+        const qsizetype start = index;
+        while ((index < length) && !coordinatesString[index].isSpace()) {
+            index++;
+        }
+        if (index == start) {
+            break;
+        }
 
-        QGeoCoordinate coord;
-        coord.setLongitude(rgValueStrings[0].toDouble());
-        coord.setLatitude(rgValueStrings[1].toDouble());
+        const QStringView tuple = coordinatesString.sliced(start, index - start);
+        const qsizetype lonEnd = tuple.indexOf(u',');
+        if (lonEnd < 0) {
+            continue;
+        }
+        qsizetype latEnd = tuple.indexOf(u',', lonEnd + 1);
+        if (latEnd < 0) {
+            latEnd = tuple.length();
+        }
 
-        rgCoords.append(coord);
+        points.append(QPointF(tuple.first(lonEnd).toDouble(), tuple.sliced(lonEnd + 1, latEnd - lonEnd - 1).toDouble()));
+    }
+}
+
+bool KMLHelper::loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate>& vertices, QString& errorString)
+{
+    errorString.clear();
+    vertices.clear();
+
+    static const QStringList polygonPath = { QStringLiteral("Polygon"), QStringLiteral("outerBoundaryIs"), QStringLiteral("LinearRing"), QStringLiteral("coordinates") };
+    QList<QGeoCoordinate> rgCoords;
+    if (!_loadCoordinates(kmlFile, polygonPath, rgCoords, errorString)) {
+        return false;
+    }
+
+    // The last coordinate closes the ring
+    if (!rgCoords.isEmpty()) {
+        rgCoords.removeLast();
     }
 
     // Determine winding, reverse if needed. QGC wants clockwise winding
@@ -107,12 +192,7 @@ bool KMLHelper::loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate
     }
     bool reverse = sum < 0.0;
     if (reverse) {
-        QList<QGeoCoordinate> rgReversed;
-
-        for (int i=0; i<rgCoords.count(); i++) {
-            rgReversed.prepend(rgCoords[i]);
-        }
-        rgCoords = rgReversed;
+        std::reverse(rgCoords.begin(), rgCoords.end());
     }
 
     vertices = rgCoords;
@@ -125,40 +205,73 @@ bool KMLHelper::loadPolylineFromFile(const QString& kmlFile, QList<QGeoCoordinat
     errorString.clear();
     coords.clear();
 
-    QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
+    static const QStringList lineStringPath = { QStringLiteral("LineString"), QStringLiteral("coordinates") };
+    QList<QGeoCoordinate> rgCoords;
+    if (!_loadCoordinates(kmlFile, lineStringPath, rgCoords, errorString)) {
         return false;
     }
 
-    QDomNodeList rgNodes = domDocument.elementsByTagName("LineString");
-    if (rgNodes.count() == 0) {
-        errorString = QString(_errorPrefix).arg(tr("Unable to find LineString node in KML"));
-        return false;
+    if (!rgCoords.isEmpty()) {
+        rgCoords.removeLast();
     }
 
-    QDomNode coordinatesNode = rgNodes.item(0).namedItem("coordinates");
-    if (coordinatesNode.isNull()) {
-        errorString = QString(_errorPrefix).arg(tr("Internal error: Unable to find coordinates node in KML"));
-        return false;
-    }
-
-    QString coordinatesString = coordinatesNode.toElement().text().simplified();
-    QStringList rgCoordinateStrings = coordinatesString.split(" ");
+    coords = rgCoords;
 
-    QList<QGeoCoordinate> rgCoords;
-    for (int i=0; i<rgCoordinateStrings.count()-1; i++) {
-        QString coordinateString = rgCoordinateStrings[i];
+    return true;
+}
 
-        QStringList rgValueStrings = coordinateString.split(",");
+bool KMLHelper::loadAllShapesFromFile(const QString& kmlFile, QList<ShapeFileHelper::Shape_t>& shapes, QString& errorString)
+{
+    errorString.clear();
+    shapes.clear();
 
-        QGeoCoordinate coord;
-        coord.setLongitude(rgValueStrings[0].toDouble());
-        coord.setLatitude(rgValueStrings[1].toDouble());
+    QFile file(kmlFile);
+    if (!_openFile(file, kmlFile, errorString)) {
+        return false;
+    }
 
-        rgCoords.append(coord);
+    // Placemarks may nest their geometry in MultiGeometry and folders to any depth, so every Polygon and LineString
+    // is taken wherever it is. The coordinates of Points are skipped.
+    QXmlStreamReader xml(&file);
+    ShapeFileHelper::Shape_t shape;
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+
+        if (token == QXmlStreamReader::StartElement) {
+            if (xml.name() == QLatin1String("Polygon")) {
+                shape = { ShapeFileHelper::Polygon, {} };
+            } else if (xml.name() == QLatin1String("LineString")) {
+                shape = { ShapeFileHelper::Polyline, {} };
+            } else if ((xml.name() == QLatin1String("coordinates")) && (shape.type != ShapeFileHelper::Error)) {
+                const QString coordinatesString = xml.readElementText();
+                if (xml.hasError()) {
+                    break;
+                }
+                QList<QPointF> points;
+                _parseCoordinates(coordinatesString, points);
+                if (points.count() >= 2) {
+                    shape.parts.append(points);
+                }
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            if ((xml.name() == QLatin1String("Polygon")) || (xml.name() == QLatin1String("LineString"))) {
+                if (!shape.parts.isEmpty()) {
+                    shapes.append(shape);
+                }
+                shape = ShapeFileHelper::Shape_t();
+            }
+        }
     }
 
-    coords = rgCoords;
+    if (xml.hasError()) {
+        errorString = _parseError(kmlFile, xml);
+        shapes.clear();
+        return false;
+    }
+    if (shapes.isEmpty()) {
+        errorString = QString(_errorPrefix).arg(tr("No supported type found in KML file."));
+        return false;
+    }
 
     return true;
 }
@@ -10,12 +10,17 @@
 #pragma once
 
 #include <QtCore/QObject>
-#include <QtXml/QDomDocument>
 #include <QtCore/QList>
+#include <QtCore/QStringList>
 #include <QtPositioning/QGeoCoordinate>
 
 #include "ShapeFileHelper.h"
 
+class QFile;
+class QXmlStreamReader;
+
+/// KML files are read with QXmlStreamReader so large files are never held as a DOM tree. Reading stops as soon as the
+/// requested shape has been found.
 class KMLHelper : public QObject
 {
     Q_OBJECT
@@ -24,9 +29,14 @@ public:
     static ShapeFileHelper::ShapeType determineShapeType(const QString& kmlFile, QString& errorString);
     static bool loadPolygonFromFile(const QString& kmlFile, QList<QGeoCoordinate>& vertices, QString& errorString);
     static bool loadPolylineFromFile(const QString& kmlFile, QList<QGeoCoordinate>& coords, QString& errorString);
+    static bool loadAllShapesFromFile(const QString& kmlFile, QList<ShapeFileHelper::Shape_t>& shapes, QString& errorString);
 
 private:
-    static QDomDocument _loadFile(const QString& kmlFile, QString& errorString);
+    static bool     _openFile           (QFile& file, const QString& kmlFile, QString& errorString);
+    static QString  _parseError         (const QString& kmlFile, const QXmlStreamReader& xml);
+    static bool     _loadCoordinates    (const QString& kmlFile, const QStringList& elementPath, QList<QGeoCoordinate>& coords, QString& errorString);
+    static void     _parseCoordinates   (QStringView coordinatesString, QList<QGeoCoordinate>& coords);
+    static void     _parseCoordinates   (QStringView coordinatesString, QList<QPointF>& points);
 
     static constexpr const char* _errorPrefix = QT_TR_NOOP("KML file load failed. %1");
 };
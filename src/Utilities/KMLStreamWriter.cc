@@ -0,0 +1,75 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "KMLStreamWriter.h"
+
+#include <QtPositioning/QGeoCoordinate>
+
+KMLStreamWriter::KMLStreamWriter(QIODevice* device, const QString& name)
+    : QXmlStreamWriter(device)
+{
+    setAutoFormatting(true);
+    setAutoFormattingIndent(1);
+
+    writeStartDocument();
+    writeStartElement(QStringLiteral("kml"));
+    writeDefaultNamespace(QStringLiteral("http://www.opengis.net/kml/2.2"));
+    writeStartElement(QStringLiteral("Document"));
+
+    writeTextElement(QStringLiteral("name"), name);
+    writeTextElement(QStringLiteral("open"), QStringLiteral("1"));
+
+    _writeStandardStyles();
+}
+
+QString KMLStreamWriter::kmlCoordString(const QGeoCoordinate& coord)
+{
+    double altitude = qIsNaN(coord.altitude() ) ? 0 : coord.altitude();
+    return QStringLiteral("%1,%2,%3").arg(QString::number(coord.longitude(), 'f', 7)).arg(QString::number(coord.latitude(), 'f', 7)).arg(QString::number(altitude, 'f', 2));
+}
+
+QString KMLStreamWriter::kmlColorString (const QColor& color, double opacity)
+{
+    return QStringLiteral("%1%2%3%4").arg(static_cast<int>(255.0 * opacity), 2, 16, QChar('0')).arg(color.blue(), 2, 16, QChar('0')).arg(color.green(), 2, 16, QChar('0')).arg(color.red(), 2, 16, QChar('0'));
+}
+
+void KMLStreamWriter::_writeStandardStyles(void)
+{
+    writeStartElement("Style");
+    writeAttribute("id", balloonStyleName);
+    writeStartElement("BalloonStyle");
+    writeTextElement("text", "$[description]");
+    writeEndElement();
+    writeEndElement();
+}
+
+void KMLStreamWriter::writeLookAt(const QGeoCoordinate& coord)
+{
+    writeStartElement("LookAt");
+    writeTextElement("latitude",  QString::number(coord.latitude(), 'f', 7));
+    writeTextElement("longitude", QString::number(coord.longitude(), 'f', 7));
+    writeTextElement("altitude",  QString::number(coord.longitude(), 'f', 2));
+    writeTextElement("heading",   "-100");
+    writeTextElement("tilt",      "45");
+    writeTextElement("range",     "2500");
+    writeEndElement();
+}
+
+void KMLStreamWriter::writeStartPlacemark(const QString& name, bool visible)
+{
+    writeStartElement("Placemark");
+    writeTextElement("name",         name);
+    writeTextElement("visibility",   visible ? "1" : "0");
+}
+
+void KMLStreamWriter::finish(void)
+{
+    // Closes the Document and kml elements along with anything still open
+    writeEndDocument();
+}
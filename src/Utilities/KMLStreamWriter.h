@@ -0,0 +1,42 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QXmlStreamWriter>
+#include <QtGui/QColor>
+
+class QGeoCoordinate;
+class QIODevice;
+
+/// Writes a KML document straight to a device. Nothing is kept in memory, so arbitrarily large plans and tracks
+/// can be exported. Elements are written in document order with the QXmlStreamWriter calls, finish() closes the
+/// document.
+class KMLStreamWriter : public QXmlStreamWriter
+{
+
+public:
+    /// Writes the document header and the standard styles
+    KMLStreamWriter(QIODevice* device, const QString& name);
+
+    /// Starts a Placemark with its name and visibility, close it with writeEndElement
+    void writeStartPlacemark(const QString& name, bool visible);
+    void writeLookAt        (const QGeoCoordinate& coord);
+
+    /// Closes all open elements
+    void finish(void);
+
+    static QString kmlColorString   (const QColor& color, double opacity = 1);
+    static QString kmlCoordString   (const QGeoCoordinate& coord);
+
+    static constexpr const char* balloonStyleName = "BalloonStyle";
+
+private:
+    void _writeStandardStyles(void);
+};
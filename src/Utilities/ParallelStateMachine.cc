@@ -0,0 +1,91 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParallelStateMachine.h"
+
+#include <QtCore/QDebug>
+
+ParallelStateMachine::ParallelStateMachine(void)
+{
+
+}
+
+void ParallelStateMachine::advance(void)
+{
+    if (!_active) {
+        return;
+    }
+
+    if (_startedStates == 0) {
+        // Starting again after a previous run
+        _completedStates = 0;
+    }
+
+    for (int i=0; i<stateCount(); i++) {
+        const quint32 dependencies = stateDependencies(i);
+        if ((_startedStates & (1u << i)) || ((_completedStates & dependencies) != dependencies)) {
+            continue;
+        }
+
+        _startedStates |= (1u << i);
+        _stateIndex = i;
+        (*rgStates()[i])(this);
+
+        // States may complete right away, which advances the state machine from within the state function
+        if (!_active) {
+            return;
+        }
+    }
+
+    const quint32 allStates = (stateCount() < 32) ? ((1u << stateCount()) - 1) : 0xFFFFFFFF;
+    if (_completedStates == allStates) {
+        _active         = false;
+        _startedStates  = 0;
+        statesCompleted();
+    }
+}
+
+void ParallelStateMachine::stateComplete(StateFn stateFn)
+{
+    if (!_active) {
+        return;
+    }
+
+    const int stateIndex = _stateFnIndex(stateFn);
+    if (stateIndex < 0 || !_stateRunning(stateIndex)) {
+        qWarning() << "ParallelStateMachine::stateComplete called on state which is not running" << stateIndex;
+        return;
+    }
+
+    _completedStates |= (1u << stateIndex);
+    advance();
+}
+
+bool ParallelStateMachine::stateRunning(StateFn stateFn) const
+{
+    const int stateIndex = _stateFnIndex(stateFn);
+    return _active && stateIndex >= 0 && _stateRunning(stateIndex);
+}
+
+bool ParallelStateMachine::stateCompleted(StateFn stateFn) const
+{
+    const int stateIndex = _stateFnIndex(stateFn);
+    return stateIndex >= 0 && _stateCompleted(stateIndex);
+}
+
+int ParallelStateMachine::_stateFnIndex(StateFn stateFn) const
+{
+    for (int i=0; i<stateCount(); i++) {
+        if (rgStates()[i] == stateFn) {
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,51 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "StateMachine.h"
+
+/// State machine which starts each state as soon as the states it depends on have completed, so states which
+/// don't depend on each other run in parallel. States report their completion with stateComplete instead of
+/// calling advance. Supports up to 32 states.
+class ParallelStateMachine : public StateMachine
+{
+    Q_OBJECT
+
+public:
+    ParallelStateMachine(void);
+
+    /// @return Bit mask of the indices into rgStates which must complete before the state at stateIndex starts.
+    ///         A state can only depend on states which come before it in rgStates.
+    virtual quint32 stateDependencies(int stateIndex) const = 0;
+
+    /// Marks a running state as complete and starts all states which are now ready
+    void stateComplete(StateFn stateFn);
+
+    /// @return true: State has started and not completed yet
+    bool stateRunning(StateFn stateFn) const;
+
+    /// @return true: State has completed
+    bool stateCompleted(StateFn stateFn) const;
+
+    // Overrides from StateMachine
+
+    /// Starts all states whose dependencies have completed. Calls statesCompleted once all states have completed.
+    void advance(void) override;
+
+protected:
+    bool _stateRunning  (int stateIndex) const { return (_startedStates & (1u << stateIndex)) && !_stateCompleted(stateIndex); }
+    bool _stateCompleted(int stateIndex) const { return _completedStates & (1u << stateIndex); }
+
+private:
+    int _stateFnIndex(StateFn stateFn) const;
+
+    quint32 _startedStates      = 0;
+    quint32 _completedStates    = 0;
+};
@@ -14,6 +14,7 @@
 #include <QtCore/QtNumeric>
 
 #include <float.h>
+#include <chrono>
 
 namespace QGC
 {
@@ -40,6 +41,17 @@ quint64 groundTimeMilliseconds()
     return static_cast<quint64>(QDateTime::currentMSecsSinceEpoch());
 }
 
+quint64 utcTimeUsecs()
+{
+    using namespace std::chrono;
+
+    // Both anchors are taken once, from then on only the monotonic clock is used
+    static const steady_clock::time_point anchorSteady = steady_clock::now();
+    static const qint64 anchorUtcUsecs = duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+
+    return static_cast<quint64>(anchorUtcUsecs + duration_cast<microseconds>(steady_clock::now() - anchorSteady).count());
+}
+
 qreal groundTimeSeconds()
 {
     return static_cast<qreal>(groundTimeMilliseconds()) / 1000.0f;
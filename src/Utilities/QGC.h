@@ -26,6 +26,11 @@ quint64 groundTimeMilliseconds();
  * @note Precision is limited to milliseconds.
  */
 qreal groundTimeSeconds();
+/**
+ * @brief Get the current UTC time in microseconds with full microsecond precision.
+ * @note A monotonic clock anchored to UTC on first use, so it never jumps with wall clock adjustments.
+ */
+quint64 utcTimeUsecs();
 /** @brief Returns the angle limited to -pi - pi */
 float limitAngleToPMPIf(double angle);
 /** @brief Returns the angle limited to -pi - pi */
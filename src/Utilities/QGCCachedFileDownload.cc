@@ -37,10 +37,11 @@ bool QGCCachedFileDownload::download(const QString& url, int maxCacheAgeSec)
         QDateTime creationTime = metadata.attributes().find(QNetworkRequest::Attribute::User)->toDateTime();
         bool expired = creationTime.addSecs(maxCacheAgeSec) < QDateTime::currentDateTime();
         if (expired) {
-            // Force network download, as Qt would still use the cache otherwise (w/o checking the remote)
+            // Force network download, as Qt would still use the cache otherwise (w/o checking the remote).
+            // The request is conditional: if the file did not change the server only answers 304 and the cached file is used.
             auto attributes = QVector<QPair<QNetworkRequest::Attribute, QVariant>>{qMakePair(QNetworkRequest::CacheLoadControlAttribute, QVariant{QNetworkRequest::AlwaysNetwork})};
             _downloadFromNetwork = true;
-            return _fileDownload->download(url, attributes);
+            return _fileDownload->download(url, attributes, _revalidationHeaders(metadata));
         }
 
         auto attributes = QVector<QPair<QNetworkRequest::Attribute, QVariant>>{qMakePair(QNetworkRequest::CacheLoadControlAttribute, QVariant{QNetworkRequest::PreferCache})};
@@ -51,11 +52,29 @@ bool QGCCachedFileDownload::download(const QString& url, int maxCacheAgeSec)
     }
 }
 
+/// Headers which turn the request for a cached file into a conditional request
+QList<QNetworkReply::RawHeaderPair> QGCCachedFileDownload::_revalidationHeaders(const QNetworkCacheMetaData& metadata)
+{
+    QList<QNetworkReply::RawHeaderPair> headers;
+
+    for (const QNetworkCacheMetaData::RawHeader& header : metadata.rawHeaders()) {
+        if (header.first.compare("ETag", Qt::CaseInsensitive) == 0) {
+            headers.append(qMakePair(QByteArrayLiteral("If-None-Match"), header.second));
+        } else if (header.first.compare("Last-Modified", Qt::CaseInsensitive) == 0) {
+            headers.append(qMakePair(QByteArrayLiteral("If-Modified-Since"), header.second));
+        }
+    }
+
+    return headers;
+}
+
 void QGCCachedFileDownload::onDownloadCompleted(QString remoteFile, QString localFile, QString errorMsg)
 {
-    // Set cache creation time if not set already (the Qt docs mention there's a creation time, but I could not find any API)
+    // Set cache creation time if not set already (the Qt docs mention there's a creation time, but I could not find any API).
+    // A file which was revalidated with the server counts as new, the cache metadata of a 304 still holds the old time.
     QNetworkCacheMetaData metadata = _diskCache->metaData(remoteFile);
-    if (metadata.isValid() && !metadata.attributes().contains(QNetworkRequest::Attribute::User)) {
+    const bool revalidated = _downloadFromNetwork && errorMsg.isEmpty();
+    if (metadata.isValid() && (revalidated || !metadata.attributes().contains(QNetworkRequest::Attribute::User))) {
         QNetworkCacheMetaData::AttributesMap attributes = metadata.attributes();
         attributes.insert(QNetworkRequest::Attribute::User, QDateTime::currentDateTime());
         metadata.setAttributes(attributes);
@@ -11,8 +11,10 @@
 
 #include <QtCore/QString>
 #include <QtCore/QObject>
+#include <QtNetwork/QNetworkReply>
 
 class QGCFileDownload;
+class QNetworkCacheMetaData;
 class QNetworkDiskCache;
 
 class QGCCachedFileDownload : public QObject
@@ -22,7 +24,8 @@ class QGCCachedFileDownload : public QObject
 public:
     QGCCachedFileDownload(QObject* parent, const QString& cacheDirectory);
 
-    /// Download the specified remote file.
+    /// Download the specified remote file. A cached file older than maxCacheAgeSec is revalidated with a conditional
+    /// request, so an unchanged file is not downloaded again.
     ///     @param url   File to download
     ///     @param maxCacheAgeSec Maximum age of cached item in seconds
     /// @return true: Asynchronous download has started, false: Download initialization failed
@@ -35,6 +38,8 @@ signals:
 private:
     void onDownloadCompleted(QString remoteFile, QString localFile, QString errorMsg);
 
+    static QList<QNetworkReply::RawHeaderPair> _revalidationHeaders(const QNetworkCacheMetaData& metadata);
+
     QGCFileDownload* _fileDownload;
     QNetworkDiskCache* _diskCache;
     bool _downloadFromNetwork{false};
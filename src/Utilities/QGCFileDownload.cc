@@ -20,10 +20,16 @@ QGCFileDownload::QGCFileDownload(QObject* parent)
 
 }
 
-bool QGCFileDownload::download(const QString& remoteFile, const QVector<QPair<QNetworkRequest::Attribute, QVariant>>& requestAttributes, bool redirect)
+namespace {
+    constexpr const char* kPartSuffix       = ".part";
+    constexpr const char* kValidatorSuffix  = ".validator";
+}
+
+bool QGCFileDownload::download(const QString& remoteFile, const QVector<QPair<QNetworkRequest::Attribute, QVariant>>& requestAttributes, const QList<QNetworkReply::RawHeaderPair>& requestHeaders, bool redirect)
 {
     if (!redirect) {
         _requestAttributes = requestAttributes;
+        _requestHeaders = requestHeaders;
         _originalRemoteFile = remoteFile;
     }
 
@@ -49,6 +55,23 @@ bool QGCFileDownload::download(const QString& remoteFile, const QVector<QPair<QN
     for (const auto& attribute : requestAttributes) {
         networkRequest.setAttribute(attribute.first, attribute.second);
     }
+    for (const auto& header : requestHeaders) {
+        networkRequest.setRawHeader(header.first, header.second);
+    }
+
+    const QString downloadFilename = _downloadFileName(remoteUrl);
+    _partFile.close();
+    _partFile.setFileName(downloadFilename.isEmpty() ? QString() : downloadFilename + kPartSuffix);
+
+    // Continue an interrupted download. Downloads through the cache always start over, it can't store a partial response.
+    if (!cache() && !remoteUrl.isLocalFile() && !downloadFilename.isEmpty()) {
+        const QFileInfo partInfo(_partFile.fileName());
+        QFile validatorFile(_partFile.fileName() + kValidatorSuffix);
+        if ((partInfo.size() > 0) && validatorFile.open(QIODevice::ReadOnly)) {
+            networkRequest.setRawHeader("Range", "bytes=" + QByteArray::number(partInfo.size()) + "-");
+            networkRequest.setRawHeader("If-Range", validatorFile.readAll());
+        }
+    }
 
     QNetworkProxy tProxy;
     tProxy.setType(QNetworkProxy::DefaultProxy);
@@ -63,18 +86,86 @@ bool QGCFileDownload::download(const QString& remoteFile, const QVector<QPair<QN
     setIgnoreSSLErrorsIfNeeded(*networkReply);
 
     connect(networkReply, &QNetworkReply::downloadProgress, this, &QGCFileDownload::downloadProgress);
+    connect(networkReply, &QNetworkReply::metaDataChanged, this, &QGCFileDownload::_downloadMetaDataChanged);
+    connect(networkReply, &QNetworkReply::readyRead, this, &QGCFileDownload::_downloadReadyRead);
     connect(networkReply, &QNetworkReply::finished, this, &QGCFileDownload::_downloadFinished);
     connect(networkReply, &QNetworkReply::errorOccurred, this, &QGCFileDownload::_downloadError);
     return true;
 }
 
+void QGCFileDownload::_downloadMetaDataChanged(void)
+{
+    _openPartFile(qobject_cast<QNetworkReply*>(QObject::sender()));
+}
+
+/// Opens the part file once the response headers are known
+void QGCFileDownload::_openPartFile(QNetworkReply* reply)
+{
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (_partFile.isOpen() || _partFile.fileName().isEmpty() || ((statusCode >= 300) && (statusCode < 400))) {
+        // Redirects and not modified responses have no body worth keeping
+        return;
+    }
+
+    const QString validatorFilename = _partFile.fileName() + kValidatorSuffix;
+
+    if (statusCode == 206) {
+        // The server continues the interrupted download
+        if (!_partFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qWarning() << "Unable to open partial download" << _partFile.fileName() << _partFile.errorString();
+        }
+        return;
+    }
+
+    QFile::remove(validatorFilename);
+    if (!_partFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Unable to open partial download" << _partFile.fileName() << _partFile.errorString();
+        return;
+    }
+
+    if (!cache() && (statusCode == 200)) {
+        // If-Range needs a strong validator
+        QByteArray validator = reply->rawHeader("ETag");
+        if (validator.isEmpty() || validator.startsWith("W/")) {
+            validator = reply->rawHeader("Last-Modified");
+        }
+        if (!validator.isEmpty()) {
+            QFile validatorFile(validatorFilename);
+            if (validatorFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                (void) validatorFile.write(validator);
+            }
+        }
+    }
+}
+
+void QGCFileDownload::_downloadReadyRead(void)
+{
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if ((statusCode >= 300) && (statusCode < 400)) {
+        (void) reply->readAll();
+        return;
+    }
+
+    if (!_partFile.isOpen()) {
+        // Not all replies signal metaDataChanged, e.g. the ones for local files
+        _openPartFile(reply);
+    }
+    if (_partFile.isOpen()) {
+        (void) _partFile.write(reply->readAll());
+    }
+}
+
 void QGCFileDownload::_downloadFinished(void)
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
 
     // When an error occurs or the user cancels the download, we still end up here. So bail out in
-    // those cases.
+    // those cases. The part file is kept to continue the download later on.
     if (reply->error() != QNetworkReply::NoError) {
+        _partFile.close();
         reply->deleteLater();
         return;
     }
@@ -83,15 +174,63 @@ void QGCFileDownload::_downloadFinished(void)
     QVariant redirectionTarget = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
     if (!redirectionTarget.isNull()) {
         QUrl redirectUrl = reply->url().resolved(redirectionTarget.toUrl());
-        download(redirectUrl.toString(), _requestAttributes, true /* redirect */);
+        download(redirectUrl.toString(), _requestAttributes, _requestHeaders, true /* redirect */);
+        reply->deleteLater();
+        return;
+    }
+
+    // Determine location to download file to
+    const QString downloadFilename = _downloadFileName(reply->url());
+    if (downloadFilename.isEmpty() || _partFile.fileName().isEmpty()) {
+        emit downloadComplete(_originalRemoteFile, QString(), tr("Unabled to find writable download location. Tried downloads and temp directory."));
+        reply->deleteLater();
+        return;
+    }
+
+    if (!_partFile.isOpen()) {
+        if (!_partFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            emit downloadComplete(_originalRemoteFile, downloadFilename, tr("Could not save downloaded file to %1. Error: %2").arg(downloadFilename).arg(_partFile.errorString()));
+            reply->deleteLater();
+            return;
+        }
+
+        // A conditional request of a cached file which is still current. Qt normally answers it from the cache itself.
+        const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if ((statusCode == 304) && cache()) {
+            QIODevice* cachedData = cache()->data(reply->url());
+            if (cachedData) {
+                (void) _partFile.write(cachedData->readAll());
+                delete cachedData;
+            }
+        }
+    }
+    (void) _partFile.write(reply->readAll());
+
+    const bool writeFailed = _partFile.error() != QFileDevice::NoError;
+    const QString writeErrorString = _partFile.errorString();
+    _partFile.close();
+
+    QFile::remove(_partFile.fileName() + kValidatorSuffix);
+    QFile::remove(downloadFilename);
+    if (writeFailed || !QFile::rename(_partFile.fileName(), downloadFilename)) {
+        QFile::remove(_partFile.fileName());
+        emit downloadComplete(_originalRemoteFile, downloadFilename, tr("Could not save downloaded file to %1. Error: %2").arg(downloadFilename).arg(writeFailed ? writeErrorString : tr("rename failed")));
         reply->deleteLater();
         return;
     }
 
+    emit downloadComplete(_originalRemoteFile, downloadFilename, QString());
+
+    reply->deleteLater();
+}
+
+/// Location the remote file is downloaded to, empty if there is no writable location
+QString QGCFileDownload::_downloadFileName(const QUrl& url)
+{
     // Split out filename from path
-    QString remoteFileName = QFileInfo(reply->url().toString()).fileName();
+    QString remoteFileName = QFileInfo(url.toString()).fileName();
     if (remoteFileName.isEmpty()) {
-        qWarning() << "Unabled to parse filename from remote url" << reply->url().toString();
+        qWarning() << "Unabled to parse filename from remote url" << url.toString();
         remoteFileName = "DownloadedFile";
     }
 
@@ -101,36 +240,14 @@ void QGCFileDownload::_downloadFinished(void)
         remoteFileName  = remoteFileName.left(parameterIndex);
     }
 
-    // Determine location to download file to
     QString downloadFilename = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
     if (downloadFilename.isEmpty()) {
         downloadFilename = QStandardPaths::writableLocation(QStandardPaths::DownloadLocation);
         if (downloadFilename.isEmpty()) {
-            emit downloadComplete(_originalRemoteFile, QString(), tr("Unabled to find writable download location. Tried downloads and temp directory."));
-            return;
-        }
-    }
-    downloadFilename += "/"  + remoteFileName;
-
-    if (!downloadFilename.isEmpty()) {
-        // Store downloaded file in download location
-        QFile file(downloadFilename);
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-            emit downloadComplete(_originalRemoteFile, downloadFilename, tr("Could not save downloaded file to %1. Error: %2").arg(downloadFilename).arg(file.errorString()));
-            return;
+            return QString();
         }
-
-        file.write(reply->readAll());
-        file.close();
-
-        emit downloadComplete(_originalRemoteFile, downloadFilename, QString());
-    } else {
-        QString errorMsg = "Internal error";
-        qWarning() << errorMsg;
-        emit downloadComplete(_originalRemoteFile, downloadFilename, errorMsg);
     }
-
-    reply->deleteLater();
+    return downloadFilename + "/"  + remoteFileName;
 }
 
 /// @brief Called when an error occurs during download
@@ -144,6 +261,13 @@ void QGCFileDownload::_downloadError(QNetworkReply::NetworkError code)
     } else if (code == QNetworkReply::ContentNotFoundError) {
         errorMsg = tr("Error: File Not Found");
 
+    } else if (code == QNetworkReply::UnknownContentError) {
+        // E.g. 416, the part file can't be continued. It is dropped so that the next download starts over.
+        _partFile.close();
+        QFile::remove(_partFile.fileName());
+        QFile::remove(_partFile.fileName() + kValidatorSuffix);
+        errorMsg = tr("Error during download. Error: %1").arg(code);
+
     } else {
         errorMsg = tr("Error during download. Error: %1").arg(code);
     }
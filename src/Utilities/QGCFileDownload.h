@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <QtCore/QFile>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
 
@@ -22,9 +23,10 @@ public:
     /// Download the specified remote file.
     ///     @param remoteFile   File to download. Can be http address or file system path.
     ///     @param requestAttributes   Optional request attributes to set
+    ///     @param requestHeaders   Optional raw headers to set, e.g. for a conditional request
     ///     @param redirect     true: call is internal due to redirect
     /// @return true: Asynchronous download has started, false: Download initialization failed
-    bool download(const QString& remoteFile, const QVector<QPair<QNetworkRequest::Attribute, QVariant>>& requestAttributes={}, bool redirect = false);
+    bool download(const QString& remoteFile, const QVector<QPair<QNetworkRequest::Attribute, QVariant>>& requestAttributes={}, const QList<QNetworkReply::RawHeaderPair>& requestHeaders={}, bool redirect = false);
 
     static void setIgnoreSSLErrorsIfNeeded(QNetworkReply& networkReply);
 
@@ -33,9 +35,20 @@ signals:
     void downloadComplete(QString remoteFile, QString localFile, QString errorMsg);
 
 private:
+    void _downloadMetaDataChanged(void);
+    void _downloadReadyRead(void);
     void _downloadFinished(void);
     void _downloadError(QNetworkReply::NetworkError code);
+    void _openPartFile(QNetworkReply* reply);
+
+    static QString _downloadFileName(const QUrl& url);
 
     QString _originalRemoteFile;
     QVector<QPair<QNetworkRequest::Attribute, QVariant>> _requestAttributes;
+    QList<QNetworkReply::RawHeaderPair> _requestHeaders;
+
+    /// The body is written to <download file>.part as it arrives. Without a cache an interrupted download leaves the
+    /// part file and the ETag or Last-Modified of the response in <download file>.part.validator, the next download of
+    /// the same file then only requests the missing range.
+    QFile _partFile;
 };
@@ -13,6 +13,9 @@
 #include <QtCore/QStringList>
 #include <QtCore/QObject>
 
+#include <atomic>
+#include <chrono>
+
 // Add Global logging categories (not class specific) here using Q_DECLARE_LOGGING_CATEGORY
 Q_DECLARE_LOGGING_CATEGORY(FirmwareUpgradeLog)
 Q_DECLARE_LOGGING_CATEGORY(FirmwareUpgradeVerboseLog)
@@ -33,6 +36,55 @@ Q_DECLARE_LOGGING_CATEGORY(JoystickLog)
     static QGCLoggingCategory qgcCategory ## name (__VA_ARGS__); \
     Q_LOGGING_CATEGORY(name, __VA_ARGS__)
 
+/// @def qCDebugSampled
+/// Like qCDebug but only every nth call from this call site is logged. Meant for hot paths such as per message
+/// handling where turning on the category would otherwise flood the log. The category enabled check comes first
+/// and is the same lock free check qCDebug does, so a disabled category costs nothing extra.
+#define qCDebugSampled(category, n) \
+    if (!category().isDebugEnabled() || !QGC_LOG_SAMPLER().sample(n)) {} else \
+        QMessageLogger(QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC, category().categoryName()).debug()
+
+/// @def qCDebugRateLimited
+/// Like qCDebug but at most maxPerSecond lines per second are logged from this call site
+#define qCDebugRateLimited(category, maxPerSecond) \
+    if (!category().isDebugEnabled() || !QGC_LOG_SAMPLER().rateLimit(maxPerSecond)) {} else \
+        QMessageLogger(QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC, category().categoryName()).debug()
+
+/// @def qCWarningRateLimited
+/// Like qCWarning but at most maxPerSecond lines per second are logged from this call site
+#define qCWarningRateLimited(category, maxPerSecond) \
+    if (!category().isWarningEnabled() || !QGC_LOG_SAMPLER().rateLimit(maxPerSecond)) {} else \
+        QMessageLogger(QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC, category().categoryName()).warning()
+
+/// Each expansion is a distinct lambda type, so every call site gets its own sampler
+#define QGC_LOG_SAMPLER() ([]() -> QGCLogSampler& { static QGCLogSampler sampler; return sampler; }())
+
+/// Per call site state of the sampled and rate limited logging macros. Safe to use from any thread.
+class QGCLogSampler
+{
+public:
+    /// @return true: this is the nth call since the last logged one
+    bool sample(quint32 n)
+    {
+        return (n <= 1) || ((_count.fetch_add(1, std::memory_order_relaxed) % n) == 0);
+    }
+
+    /// @return true: fewer than maxPerSecond calls were logged in the current one second window
+    bool rateLimit(quint32 maxPerSecond)
+    {
+        const qint64 nowMsecs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        qint64 windowMsecs = _windowMsecs.load(std::memory_order_relaxed);
+        if (((nowMsecs - windowMsecs) >= 1000) && _windowMsecs.compare_exchange_strong(windowMsecs, nowMsecs, std::memory_order_relaxed)) {
+            _count.store(0, std::memory_order_relaxed);
+        }
+        return _count.fetch_add(1, std::memory_order_relaxed) < maxPerSecond;
+    }
+
+private:
+    std::atomic<quint32> _count { 0 };
+    std::atomic<qint64> _windowMsecs { 0 };
+};
+
 class QGCLoggingCategoryRegister : public QObject
 {
     Q_OBJECT
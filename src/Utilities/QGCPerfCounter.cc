@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCPerfCounter.h"
+
+// Constant initialized, so counters in other translation units can register during static initialization
+std::atomic<const QGCPerfCounter*> QGCPerfCounter::_head { nullptr };
+
+QGCPerfCounter::QGCPerfCounter(const char* group, const char* name, Type type)
+    : _group(group)
+    , _name(name)
+    , _type(type)
+{
+    const QGCPerfCounter* head = _head.load(std::memory_order_relaxed);
+    do {
+        _next = head;
+    } while (!_head.compare_exchange_weak(head, this, std::memory_order_release, std::memory_order_relaxed));
+}
+
+QList<const QGCPerfCounter*> QGCPerfCounter::counters(void)
+{
+    QList<const QGCPerfCounter*> counters;
+    for (const QGCPerfCounter* counter = _head.load(std::memory_order_acquire); counter; counter = counter->_next) {
+        counters.prepend(counter);
+    }
+    return counters;
+}
@@ -0,0 +1,60 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+
+#include <atomic>
+
+/// Named counter shown on the Performance analyze page. Counters are static objects placed next to the code they
+/// measure:
+///
+///     static QGCPerfCounter s_downloads("Map Tiles", "Downloads", QGCPerfCounter::Count);
+///     s_downloads.add();
+///
+/// Updates are relaxed atomics so counters can sit on hot paths in any thread. Creating a counter pushes it onto a
+/// lock-free list which the page walks, counters are never removed so they must have static storage duration.
+class QGCPerfCounter
+{
+public:
+    enum Type {
+        Count,      ///< Monotonic event count, displayed as a rate per second
+        Gauge,      ///< Current value, for example a queue depth
+        Bytes,      ///< Current memory use in bytes
+        Percent,    ///< Current value in percent
+    };
+
+    ///     @param group String literal, only the pointer is stored
+    ///     @param name String literal, only the pointer is stored
+    QGCPerfCounter(const char* group, const char* name, Type type);
+
+    QGCPerfCounter(const QGCPerfCounter&) = delete;
+    QGCPerfCounter& operator=(const QGCPerfCounter&) = delete;
+
+    void    add     (qint64 amount = 1) { _value.fetch_add(amount, std::memory_order_relaxed); }
+    void    set     (qint64 value)      { _value.store(value, std::memory_order_relaxed); }
+    qint64  value   (void) const        { return _value.load(std::memory_order_relaxed); }
+
+    const char* group   (void) const { return _group; }
+    const char* name    (void) const { return _name; }
+    Type        type    (void) const { return _type; }
+
+    /// @return All counters created so far, safe to call from any thread
+    static QList<const QGCPerfCounter*> counters(void);
+
+private:
+    const char* const       _group;
+    const char* const       _name;
+    const Type              _type;
+    std::atomic<qint64>     _value { 0 };
+    const QGCPerfCounter*   _next = nullptr;
+
+    static std::atomic<const QGCPerfCounter*> _head;
+};
@@ -37,15 +37,15 @@ QGCTemporaryFile::~QGCTemporaryFile()
 
 bool QGCTemporaryFile::open(QFile::OpenMode openMode)
 {
-    setFileName(_newTempFileFullyQualifiedName(_template));
+    setFileName(_newTempFileFullyQualifiedName(_template, _directory));
     
     return QFile::open(openMode);
 }
 
-QString QGCTemporaryFile::_newTempFileFullyQualifiedName(const QString& fileTemplate)
+QString QGCTemporaryFile::_newTempFileFullyQualifiedName(const QString& fileTemplate, const QString& directory)
 {
     QString nameTemplate = fileTemplate;
-    QDir tempDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation));
+    QDir tempDir(directory.isEmpty() ? QStandardPaths::writableLocation(QStandardPaths::TempLocation) : directory);
 
     // Generate unique, non-existing filename
 
@@ -32,11 +32,15 @@ public:
 
 	bool open(OpenMode openMode = ReadWrite);
 
+    /// Directory the next open creates the file in, empty for QStandardPaths::TempLocation
+    void setDirectory(const QString& directory) { _directory = directory; }
+
     void setAutoRemove(bool autoRemove) { _autoRemove = autoRemove; }
     
 private:
-    static QString _newTempFileFullyQualifiedName(const QString& fileTemplate);
+    static QString _newTempFileFullyQualifiedName(const QString& fileTemplate, const QString& directory);
 
     QString _template;
+    QString _directory;
     bool    _autoRemove = false;
 };
@@ -0,0 +1,133 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTrace.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+typedef struct {
+    std::atomic<quint64>    sequence { 0 };     ///< Odd while the event is being written
+    const char*             name = nullptr;
+    qint64                  beginNsecs = 0;
+    qint64                  durationNsecs = 0;
+    int                     threadId = 0;
+} TraceEvent_t;
+
+constexpr quint64 kEventCount = 65536;      ///< Must be a power of two
+
+TraceEvent_t            gEvents[kEventCount];
+std::atomic<quint64>    gNextEvent { 0 };
+std::atomic<int>        gNextThreadId { 1 };
+
+QMutex                  gThreadNamesMutex;
+QHash<int, QString>     gThreadNames;
+
+/// Small stable id per thread, the name is captured once when the thread records its first event
+int currentThreadId()
+{
+    thread_local int threadId = 0;
+    if (threadId == 0) {
+        threadId = gNextThreadId.fetch_add(1, std::memory_order_relaxed);
+
+        QString threadName = QThread::currentThread()->objectName();
+        if (threadName.isEmpty()) {
+            threadName = (QCoreApplication::instance() && (QThread::currentThread() == QCoreApplication::instance()->thread())) ? QStringLiteral("Main") : QStringLiteral("Thread %1").arg(threadId);
+        }
+
+        QMutexLocker locker(&gThreadNamesMutex);
+        gThreadNames.insert(threadId, threadName);
+    }
+
+    return threadId;
+}
+
+}
+
+qint64 QGCTrace::nowNsecs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void QGCTrace::record(const char* name, qint64 beginNsecs, qint64 endNsecs)
+{
+    const int threadId = currentThreadId();
+    const quint64 index = gNextEvent.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent_t& event = gEvents[index & (kEventCount - 1)];
+
+    // Seqlock style, the reader skips events which change while it copies them
+    event.sequence.store((index * 2) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name = name;
+    event.beginNsecs = beginNsecs;
+    event.durationNsecs = endNsecs - beginNsecs;
+    event.threadId = threadId;
+    event.sequence.store((index * 2) + 2, std::memory_order_release);
+}
+
+bool QGCTrace::writeChromeTrace(const QString& fileName)
+{
+    if (!supported()) {
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QByteArray json("{\"traceEvents\":[\n");
+    bool first = true;
+
+    {
+        QMutexLocker locker(&gThreadNamesMutex);
+        for (auto it = gThreadNames.constBegin(); it != gThreadNames.constEnd(); it++) {
+            QString threadName = it.value();
+            (void) threadName.replace('\\', QStringLiteral("\\\\")).replace('"', QStringLiteral("\\\""));
+            json += QStringLiteral("%1{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%2,\"tid\":%3,\"args\":{\"name\":\"%4\"}}")
+                        .arg(first ? QString() : QStringLiteral(",\n")).arg(pid).arg(it.key()).arg(threadName).toUtf8();
+            first = false;
+        }
+    }
+
+    for (quint64 i = 0; i < kEventCount; i++) {
+        const TraceEvent_t& event = gEvents[i];
+
+        const quint64 sequence = event.sequence.load(std::memory_order_acquire);
+        if ((sequence == 0) || (sequence & 1)) {
+            continue;
+        }
+        const char* const name = event.name;
+        const qint64 beginNsecs = event.beginNsecs;
+        const qint64 durationNsecs = event.durationNsecs;
+        const int threadId = event.threadId;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        json += QStringLiteral("%1{\"ph\":\"X\",\"name\":\"%2\",\"pid\":%3,\"tid\":%4,\"ts\":%5,\"dur\":%6}")
+                    .arg(first ? QString() : QStringLiteral(",\n"), QLatin1String(name)).arg(pid).arg(threadId)
+                    .arg(beginNsecs / 1000.0, 0, 'f', 3).arg(durationNsecs / 1000.0, 0, 'f', 3).toUtf8();
+        first = false;
+    }
+
+    json += "\n]}\n";
+
+    return file.write(json) == json.size();
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QString>
+
+/// @def QGC_TRACE_SCOPE
+/// Records the time spent in the enclosing scope as a trace event. Only compiled in when building with
+/// QGC_ENABLE_TRACE, otherwise it expands to nothing. The name must be a string literal.
+#ifdef QGC_TRACE
+#define QGC_TRACE_CONCAT_INNER(a, b) a ## b
+#define QGC_TRACE_CONCAT(a, b) QGC_TRACE_CONCAT_INNER(a, b)
+#define QGC_TRACE_SCOPE(name) const QGCTraceScope QGC_TRACE_CONCAT(qgcTraceScope, __LINE__)(name)
+#else
+#define QGC_TRACE_SCOPE(name) do {} while (0)
+#endif
+
+/// Scoped trace events for finding where time goes in the telemetry pipeline. Events are written into a fixed size
+/// ring shared by all threads, recording an event is a couple of stores and never locks or allocates. The ring keeps
+/// the most recent events and can be written out in the Chrome trace event format, which chrome://tracing and
+/// Perfetto open directly.
+class QGCTrace
+{
+public:
+    /// @return true: built with QGC_ENABLE_TRACE
+    static constexpr bool supported()
+    {
+#ifdef QGC_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static qint64 nowNsecs();
+
+    /// Records a complete event, safe to call from any thread
+    ///     @param name String literal, only the pointer is stored
+    static void record(const char* name, qint64 beginNsecs, qint64 endNsecs);
+
+    /// Writes the events currently in the ring as Chrome trace JSON
+    /// @return false: tracing not supported or the file could not be written
+    static bool writeChromeTrace(const QString& fileName);
+};
+
+class QGCTraceScope
+{
+public:
+    explicit QGCTraceScope(const char* name)
+        : _name(name)
+        , _beginNsecs(QGCTrace::nowNsecs())
+    {
+
+    }
+
+    ~QGCTraceScope()
+    {
+        QGCTrace::record(_name, _beginNsecs, QGCTrace::nowNsecs());
+    }
+
+    QGCTraceScope(const QGCTraceScope&) = delete;
+    QGCTraceScope& operator=(const QGCTraceScope&) = delete;
+
+private:
+    const char* _name;
+    qint64 _beginNsecs;
+};
@@ -176,3 +176,79 @@ Error:
     }
     return errorString.isEmpty();
 }
+
+bool SHPFileHelper::loadAllShapesFromFile(const QString& shpFile, QList<ShapeFileHelper::Shape_t>& shapes, QString& errorString)
+{
+    int     utmZone = 0;
+    bool    utmSouthernHemisphere = false;
+
+    errorString.clear();
+    shapes.clear();
+
+    SHPHandle shpHandle = SHPFileHelper::_loadShape(shpFile, &utmZone, &utmSouthernHemisphere, errorString);
+    if (!errorString.isEmpty()) {
+        return false;
+    }
+
+    int cEntities, shpType;
+    SHPGetInfo(shpHandle, &cEntities, &shpType, Q_NULLPTR /* padfMinBound */, Q_NULLPTR /* padfMaxBound */);
+
+    ShapeFileHelper::ShapeType shapeType;
+    switch (shpType) {
+    case SHPT_POLYGON:
+    case SHPT_POLYGONZ:
+    case SHPT_POLYGONM:
+        shapeType = ShapeFileHelper::Polygon;
+        break;
+    case SHPT_ARC:
+    case SHPT_ARCZ:
+    case SHPT_ARCM:
+        shapeType = ShapeFileHelper::Polyline;
+        break;
+    default:
+        SHPClose(shpHandle);
+        errorString = QString(_errorPrefix).arg(tr("No supported types found."));
+        return false;
+    }
+
+    shapes.reserve(cEntities);
+    for (int entity=0; entity<cEntities; entity++) {
+        SHPObject* shpObject = SHPReadObject(shpHandle, entity);
+        if (!shpObject) {
+            continue;
+        }
+
+        ShapeFileHelper::Shape_t shape;
+        shape.type = shapeType;
+
+        const int cParts = qMax(1, shpObject->nParts);
+        for (int part=0; part<cParts; part++) {
+            const int firstVertex = (shpObject->nParts > 0) ? shpObject->panPartStart[part] : 0;
+            const int endVertex = (part + 1 < shpObject->nParts) ? shpObject->panPartStart[part + 1] : shpObject->nVertices;
+
+            QList<QPointF> points;
+            points.reserve(endVertex - firstVertex);
+            for (int i=firstVertex; i<endVertex; i++) {
+                QGeoCoordinate coord;
+                if (utmZone && QGCGeo::convertUTMToGeo(shpObject->padfX[i], shpObject->padfY[i], utmZone, utmSouthernHemisphere, coord)) {
+                    points.append(QPointF(coord.longitude(), coord.latitude()));
+                } else {
+                    points.append(QPointF(shpObject->padfX[i], shpObject->padfY[i]));
+                }
+            }
+            if (points.count() >= 2) {
+                shape.parts.append(points);
+            }
+        }
+
+        SHPDestroyObject(shpObject);
+
+        if (!shape.parts.isEmpty()) {
+            shapes.append(shape);
+        }
+    }
+
+    SHPClose(shpHandle);
+
+    return true;
+}
@@ -26,6 +26,7 @@ class SHPFileHelper : public QObject
 public:
     static ShapeFileHelper::ShapeType determineShapeType(const QString& shpFile, QString& errorString);
     static bool loadPolygonFromFile(const QString& shpFile, QList<QGeoCoordinate>& vertices, QString& errorString);
+    static bool loadAllShapesFromFile(const QString& shpFile, QList<ShapeFileHelper::Shape_t>& shapes, QString& errorString);
 
 private:
     static bool         _validateSHPFiles(const QString& shpFile, int* utmZone, bool* utmSouthernHemisphere, QString& errorString);
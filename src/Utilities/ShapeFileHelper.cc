@@ -93,6 +93,23 @@ bool ShapeFileHelper::loadPolylineFromFile(const QString& file, QList<QGeoCoordi
     return errorString.isEmpty();
 }
 
+bool ShapeFileHelper::loadAllShapesFromFile(const QString& file, QList<Shape_t>& shapes, QString& errorString)
+{
+    errorString.clear();
+    shapes.clear();
+
+    bool fileIsKML = _fileIsKML(file, errorString);
+    if (errorString.isEmpty()) {
+        if (fileIsKML) {
+            KMLHelper::loadAllShapesFromFile(file, shapes, errorString);
+        } else {
+            SHPFileHelper::loadAllShapesFromFile(file, shapes, errorString);
+        }
+    }
+
+    return errorString.isEmpty();
+}
+
 QStringList ShapeFileHelper::fileDialogKMLFilters(void) const
 {
     return QStringList(tr("KML Files (*.%1)").arg(AppSettings::kmlFileExtension));
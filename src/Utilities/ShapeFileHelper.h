@@ -11,6 +11,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QList>
+#include <QtCore/QPointF>
 #include <QtCore/QVariant>
 #include <QtPositioning/QGeoCoordinate>
 
@@ -27,6 +28,13 @@ public:
     };
     Q_ENUM(ShapeType)
 
+    /// A shape loaded by loadAllShapesFromFile. Points are x: longitude, y: latitude. Each part of a polygon is a ring,
+    /// later rings of the same polygon are holes. Each part of a polyline is drawn as a separate line.
+    struct Shape_t {
+        ShapeType               type = Error;
+        QList<QList<QPointF>>   parts;
+    };
+
     Q_PROPERTY(QStringList fileDialogKMLFilters         READ fileDialogKMLFilters       CONSTANT) ///< File filter list for load/save KML file dialogs
     Q_PROPERTY(QStringList fileDialogKMLOrSHPFilters    READ fileDialogKMLOrSHPFilters  CONSTANT) ///< File filter list for load/save shape file dialogs
 
@@ -41,6 +49,10 @@ public:
     static bool loadPolygonFromFile(const QString& file, QList<QGeoCoordinate>& vertices, QString& errorString);
     static bool loadPolylineFromFile(const QString& file, QList<QGeoCoordinate>& coords, QString& errorString);
 
+    /// Loads every polygon and polyline in the file, with no limit on their number or parts, for reference overlays.
+    /// Safe to call from a worker thread.
+    static bool loadAllShapesFromFile(const QString& file, QList<Shape_t>& shapes, QString& errorString);
+
 private:
     static bool _fileIsKML(const QString& file, QString& errorString);
 
@@ -40,7 +40,7 @@ void Actuators::imageClicked(float x, float y)
     qCDebug(ActuatorsConfigLog) << "Image clicked:" << x << "," << y << "motor index:" << motorIndex;
 
     if (_motorAssignment.active()) {
-        QList<ActuatorGeometry>& actuators = provider->actuators();
+        QList<ActuatorGeometry> actuators = provider->actuators();
         bool found = false;
         for (auto& actuator : actuators) {
             if (actuator.type == ActuatorGeometry::Type::Motor && actuator.index == motorIndex) {
@@ -48,7 +48,7 @@ void Actuators::imageClicked(float x, float y)
                 found = true;
             }
         }
-        updateGeometryImage();
+        setGeometryImageActuators(actuators);
 
         if (found) {
             // call this outside of the loop as it might lead to an actuator refresh
@@ -77,11 +77,10 @@ void Actuators::updateGeometryImage()
 {
     GeometryImage::VehicleGeometryImageProvider* provider = GeometryImage::VehicleGeometryImageProvider::instance();
 
-    QList<ActuatorGeometry>& actuators = provider->actuators();
-    QList<ActuatorGeometry> previousActuators = actuators;
+    const QList<ActuatorGeometry>& previousActuators = provider->actuators();
 
     // collect the actuators
-    actuators.clear();
+    QList<ActuatorGeometry> actuators;
     for (int mixerGroupIdx = 0; mixerGroupIdx < _mixer.groups()->count(); ++mixerGroupIdx) {
         Mixer::MixerConfigGroup* mixerGroup = _mixer.groups()->value<Mixer::MixerConfigGroup*>(mixerGroupIdx);
         for (int mixerChannelIdx = 0; mixerChannelIdx < mixerGroup->channels()->count(); ++mixerChannelIdx) {
@@ -103,8 +102,7 @@ void Actuators::updateGeometryImage()
         }
     }
 
-    _imageRefreshFlag = !_imageRefreshFlag;
-    emit imageRefreshFlagChanged();
+    setGeometryImageActuators(actuators);
 
     _motorAssignmentEnabled = provider->numMotors() > 0;
     emit motorAssignmentEnabledChanged();
@@ -115,16 +113,10 @@ bool Actuators::isMultirotor() const
     return _mixer.configuredType() == "multirotor";
 }
 
-void Actuators::load(const QString &json_file)
+void Actuators::load(const QJsonDocument &metadata)
 {
-    QFile file;
-    file.setFileName(json_file);
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    QString json_data = file.readAll();
-    file.close();
-
     // store the metadata to be loaded later after all params are available
-    _jsonMetadata = QJsonDocument::fromJson(json_data.toUtf8());
+    _jsonMetadata = metadata;
 }
 
 void Actuators::init()
@@ -778,13 +770,22 @@ bool Actuators::initMotorAssignment()
 void Actuators::highlightActuators(bool highlight)
 {
     GeometryImage::VehicleGeometryImageProvider* provider = GeometryImage::VehicleGeometryImageProvider::instance();
-    QList<ActuatorGeometry>& actuators = provider->actuators();
+    QList<ActuatorGeometry> actuators = provider->actuators();
     for (auto& actuator : actuators) {
         if (actuator.type == ActuatorGeometry::Type::Motor) {
             actuator.renderOptions.highlight = highlight;
         }
     }
-    updateGeometryImage();
+    setGeometryImageActuators(actuators);
+}
+
+void Actuators::setGeometryImageActuators(const QList<ActuatorGeometry>& actuators)
+{
+    // the image is only reloaded if the geometry or the highlighting changed
+    if (GeometryImage::VehicleGeometryImageProvider::instance()->setActuators(actuators)) {
+        _imageRefreshFlag = !_imageRefreshFlag;
+        emit imageRefreshFlagChanged();
+    }
 }
 
 void Actuators::startMotorAssignment()
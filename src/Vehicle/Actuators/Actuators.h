@@ -45,9 +45,9 @@ public:
     Q_INVOKABLE void selectActuatorOutput(int index);
 
     /**
-     * load JSON metadata file
+     * load JSON metadata
      */
-    void load(const QString& json_file);
+    void load(const QJsonDocument& metadata);
 
     /**
      * Initialize the loaded metadata. Call this after all vehicle parameters are loaded.
@@ -106,6 +106,11 @@ private:
 
     void highlightActuators(bool highlight);
 
+    /**
+     * Pass the actuators to the image provider, and reload the image if that changed the rendering
+     */
+    void setGeometryImageActuators(const QList<ActuatorGeometry>& actuators);
+
     void updateFunctionMetadata();
 
     QSet<Fact*> _subscribedFacts{};
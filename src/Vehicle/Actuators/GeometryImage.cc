@@ -11,6 +11,7 @@
 
 #include <QtCore/QDir>
 
+#include <algorithm>
 #include <array>
 
 using namespace GeometryImage;
@@ -87,7 +88,7 @@ static void generateTestGeometries([[maybe_unused]] VehicleGeometryImageProvider
     for (unsigned sizeIdx = 0; sizeIdx < sizeof(sizes) / sizeof(sizes[0]); ++sizeIdx) {
         const QSize& size = sizes[sizeIdx];
         for (unsigned geometryIdx = 0; geometryIdx < sizeof(geometries) / sizeof(geometries[0]); ++geometryIdx) {
-            provider.actuators() = geometries[geometryIdx];
+            provider.setActuators(geometries[geometryIdx]);
             QPixmap pixmap = provider.requestPixmap("", nullptr, size);
 
             QString imageFileName = QDir(QDir::currentPath()).filePath(imagePrefix + QString::number(sizeIdx)+"_"
@@ -108,7 +109,7 @@ VehicleGeometryImageProvider::VehicleGeometryImageProvider()
     generateTestGeometries(*this);
 }
 
-void VehicleGeometryImageProvider::drawAxisIndicator(QPainter& p, const QPointF& origin, float fontSize, const QColor& color)
+void VehicleGeometryImageProvider::drawAxisIndicator(QPainter& p, const QPointF& origin, float fontSize, const QColor& color) const
 {
     const float lineLength = fontSize * 2.f;
     const float arrowWidth = 6.f;
@@ -162,88 +163,202 @@ void VehicleGeometryImageProvider::drawAxisIndicator(QPainter& p, const QPointF&
     }
 }
 
-QPixmap VehicleGeometryImageProvider::requestPixmap([[maybe_unused]] const QString& id, QSize* size, const QSize& requestedSize)
+bool VehicleGeometryImageProvider::_sameGeometry(const ActuatorGeometry& a, const ActuatorGeometry& b)
 {
-    int width = requestedSize.width();
-    int height = requestedSize.height();
-    if (size)
-        *size = QSize(width, height);
+    return a.type == b.type && a.index == b.index && a.labelIndexOffset == b.labelIndexOffset &&
+            a.position == b.position && a.spinDirection == b.spinDirection;
+}
 
-    QPixmap pixmap(width, height);
-    pixmap.fill(Qt::transparent);
+bool VehicleGeometryImageProvider::setActuators(const QList<ActuatorGeometry>& actuators)
+{
+    bool geometryChanged = actuators.size() != _actuators.size();
+    bool renderOptionsChanged = false;
+    for (int i = 0; i < actuators.size() && !geometryChanged; ++i) {
+        geometryChanged = !_sameGeometry(actuators[i], _actuators[i]);
+        renderOptionsChanged |= actuators[i].renderOptions.highlight != _actuators[i].renderOptions.highlight;
+    }
 
-    _actuatorImagePositions.clear();
+    _actuators = actuators;
+
+    if (geometryChanged) {
+        _layoutDirty = true;
+        _frame = Frame{};
+        _actuatorImagePositions.clear();
+        _maxImagePositionRadius = 0.f;
+        _pixmapCache.clear();
+    }
+    return geometryChanged || renderOptionsChanged;
+}
+
+void VehicleGeometryImageProvider::_updateLayout()
+{
+    if (!_layoutDirty) {
+        return;
+    }
+    _layoutDirty = false;
+    _motors.clear();
+    _coaxMotors.clear();
 
     // get the dimensions
-    QVector3D min{1e10f, 1e10f, 1e10f};
-    QVector3D max{-1e10f, -1e10f, -1e10f};
+    _min = QVector3D{1e10f, 1e10f, 1e10f};
+    _max = QVector3D{-1e10f, -1e10f, -1e10f};
     for (const auto& actuator : _actuators) {
         for (int i = 0; i < 3; ++i) {
-            if (actuator.position[i] < min[i]) {
-                min[i] = actuator.position[i];
+            if (actuator.position[i] < _min[i]) {
+                _min[i] = actuator.position[i];
             }
-            if (actuator.position[i] > max[i]) {
-                max[i] = actuator.position[i];
+            if (actuator.position[i] > _max[i]) {
+                _max[i] = actuator.position[i];
             }
         }
     }
 
-    if (_actuators.size() <= 1 || max.x() - min.x() < 0.0001f || max.y() - min.y() < 0.0001f ) {
-        return pixmap;
+    _layoutValid = _actuators.size() > 1 && _max.x() - _min.x() >= 0.0001f && _max.y() - _min.y() >= 0.0001f;
+    if (!_layoutValid) {
+        return;
     }
 
     // separate actuators, check for coax (on top of each other)
-    QList<ActuatorGeometry> actuators;
-    QList<ActuatorGeometry> coaxActuators;
-    for (const auto& actuator : _actuators) {
+    for (int actuatorIdx = 0; actuatorIdx < _actuators.size(); ++actuatorIdx) {
+        const ActuatorGeometry& actuator = _actuators[actuatorIdx];
         if (actuator.type == ActuatorGeometry::Type::Motor) {
             bool isCoax = false;
-            for (const auto& actuatorBefore : _actuators) {
+            for (int beforeIdx = 0; beforeIdx < actuatorIdx; ++beforeIdx) {
+                const ActuatorGeometry& actuatorBefore = _actuators[beforeIdx];
                 if (actuatorBefore.type == ActuatorGeometry::Type::Motor) {
-                    if (&actuatorBefore == &actuator) {
-                        break;
-                    }
                     QVector2D diff = actuatorBefore.position.toVector2D() - actuator.position.toVector2D();
                     if (diff.length() < 0.03f) {
-                        coaxActuators.append(actuator);
+                        _coaxMotors.append(actuatorIdx);
                         isCoax = true;
                         break;
                     }
                 }
             }
             if (!isCoax) {
-                actuators.append(actuator);
+                _motors.append(actuatorIdx);
             }
         }
     }
+}
 
-    QPainter p(&pixmap);
-    p.setRenderHint(QPainter::Antialiasing);
-    p.setRenderHint(QPainter::TextAntialiasing);
+void VehicleGeometryImageProvider::_updateFrame(const QSize& size)
+{
+    _updateLayout();
+
+    if (_frame.size == size) {
+        return;
+    }
+    _frame = Frame{};
+    _frame.size = size;
+    _actuatorImagePositions.clear();
+    _maxImagePositionRadius = 0.f;
+
+    if (!_layoutValid) {
+        return;
+    }
 
-    const float axisIndicatorSize = 15.f; // font size
-    const float margin = 5.f; // from image borders
+    const int width = size.width();
+    const int height = size.height();
 
     // scaling & center offset
-    float usableWidth = width - 2.f * margin;
-    float usableHeight = height - 2.f * margin;
+    float usableWidth = width - 2.f * _margin;
+    float usableHeight = height - 2.f * _margin;
     float extraOffsetX = 0.f;
     // if there's not enough space on the left for the axis to ensure there's no overlap, reduce the usable size
-    if (width < height + axisIndicatorSize * 4.f) {
-        usableWidth -= axisIndicatorSize;
-        usableHeight -= axisIndicatorSize;
-        extraOffsetX = axisIndicatorSize;
+    if (width < height + _axisIndicatorSize * 4.f) {
+        usableWidth -= _axisIndicatorSize;
+        usableHeight -= _axisIndicatorSize;
+        extraOffsetX = _axisIndicatorSize;
     }
 
     const float rotorDiameter = std::min(usableWidth, usableHeight) * (_actuators.length() <= 6 ? 0.31f : 0.25f);
     const float fontSize = rotorDiameter * 0.4f;
-    const float extraYMargin = coaxActuators.length() > 0 ? fontSize * 1.1f : 0.f;
+    const float extraYMargin = _coaxMotors.length() > 0 ? fontSize * 1.1f : 0.f;
 
-    const float scaleX = (usableWidth - rotorDiameter) / (max.y() - min.y());
-    const float scaleY = (usableHeight - extraYMargin - rotorDiameter) / (max.x() - min.x());
+    const float scaleX = (usableWidth - rotorDiameter) / (_max.y() - _min.y());
+    const float scaleY = (usableHeight - extraYMargin - rotorDiameter) / (_max.x() - _min.x());
     const float scale = std::min(scaleX, scaleY);
-    const float offsetX = margin + extraOffsetX + usableWidth / 2.f - (max.y() + min.y()) / 2.f * scale;
-    const float offsetY = margin + (usableHeight - extraYMargin) / 2.f + (max.x() + min.x()) / 2.f * scale;
+    const float offsetX = _margin + extraOffsetX + usableWidth / 2.f - (_max.y() + _min.y()) / 2.f * scale;
+    const float offsetY = _margin + (usableHeight - extraYMargin) / 2.f + (_max.x() + _min.x()) / 2.f * scale;
+
+    _frame.rotorDiameter = rotorDiameter;
+    _frame.offsetX = offsetX;
+    _frame.offsetY = offsetY;
+
+    auto placeMotors = [&](const QList<int>& actuatorIndices, float yPosOffset, bool labelAtBottom) {
+        for (int actuatorIdx : actuatorIndices) {
+            const ActuatorGeometry& actuator = _actuators[actuatorIdx];
+            QPointF pos{
+                offsetX + actuator.position.y()*scale,
+                offsetY - actuator.position.x()*scale + yPosOffset
+            };
+            QRectF textRect;
+            float radius;
+            if (labelAtBottom) {
+                textRect = QRectF{pos.x()-rotorDiameter/2.f, pos.y()+rotorDiameter/2.f-yPosOffset, rotorDiameter, yPosOffset};
+                radius = fontSize / 2.f;
+            } else {
+                textRect = QRectF{pos.x()-rotorDiameter/2.f, pos.y()-rotorDiameter/2.f, rotorDiameter, rotorDiameter};
+                radius = rotorDiameter / 2.f;
+            }
+            _frame.motors.append(MotorPlacement{actuatorIdx, pos, textRect, labelAtBottom});
+            _actuatorImagePositions.append(ImagePosition{actuator.type, actuator.index, actuatorIdx, textRect.center(), radius});
+            _maxImagePositionRadius = std::max(_maxImagePositionRadius, radius);
+        }
+    };
+
+    // coax motors are drawn first
+    placeMotors(_coaxMotors, extraYMargin, true);
+    placeMotors(_motors, 0.f, false);
+
+    std::sort(_actuatorImagePositions.begin(), _actuatorImagePositions.end(),
+            [](const ImagePosition& a, const ImagePosition& b) { return a.position.x() < b.position.x(); });
+}
+
+QString VehicleGeometryImageProvider::_pixmapCacheKey(const QSize& size) const
+{
+    QString highlight(_actuators.size(), QLatin1Char('0'));
+    for (int i = 0; i < _actuators.size(); ++i) {
+        if (_actuators[i].renderOptions.highlight) {
+            highlight[i] = QLatin1Char('1');
+        }
+    }
+    return QStringLiteral("%1x%2:%3:%4").arg(size.width()).arg(size.height()).arg(_palette.globalTheme()).arg(highlight);
+}
+
+QPixmap VehicleGeometryImageProvider::requestPixmap([[maybe_unused]] const QString& id, QSize* size, const QSize& requestedSize)
+{
+    int width = requestedSize.width();
+    int height = requestedSize.height();
+    if (size)
+        *size = QSize(width, height);
+
+    _updateFrame(QSize(width, height));
+
+    const QString cacheKey = _pixmapCacheKey(QSize(width, height));
+    if (const QPixmap* cached = _pixmapCache.object(cacheKey)) {
+        return *cached;
+    }
+
+    QPixmap pixmap(width, height);
+    pixmap.fill(Qt::transparent);
+    if (_layoutValid) {
+        _render(pixmap);
+    }
+
+    _pixmapCache.insert(cacheKey, new QPixmap(pixmap));
+    return pixmap;
+}
+
+void VehicleGeometryImageProvider::_render(QPixmap& pixmap) const
+{
+    QPainter p(&pixmap);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setRenderHint(QPainter::TextAntialiasing);
+
+    const float rotorDiameter = _frame.rotorDiameter;
+    const float offsetX = _frame.offsetX;
+    const float offsetY = _frame.offsetY;
 
     // style
     const QColor clockWiseColor{ 21, 158, 31, 200 };
@@ -255,24 +370,13 @@ QPixmap VehicleGeometryImageProvider::requestPixmap([[maybe_unused]] const QStri
     const QColor rotorHighlightColor{ frameArrowColor };
     const QColor fontColor{ _palette.text() };
 
-    auto iterateMotors = [scale, offsetX, offsetY](const QList<ActuatorGeometry> &actuators,
-            std::function<void(const ActuatorGeometry&, QPointF)> draw) {
-                for (const auto& actuator : actuators) {
-                    if (actuator.type == ActuatorGeometry::Type::Motor) {
-                        QPointF pos{
-                            offsetX + actuator.position.y()*scale,
-                            offsetY - actuator.position.x()*scale
-                        };
-                        draw(actuator, pos);
-                    }
-                }
-            };
-
     // draw line from center to actuators first
-    iterateMotors(actuators, [&]([[maybe_unused]] const ActuatorGeometry& actuator, QPointF pos) {
-        p.setPen(QPen{frameColor, frameWidth});
-        p.drawLine(QPointF{offsetX, offsetY}, pos);
-    });
+    for (const MotorPlacement& motor : _frame.motors) {
+        if (!motor.labelAtBottom) {
+            p.setPen(QPen{frameColor, frameWidth});
+            p.drawLine(QPointF{offsetX, offsetY}, motor.position);
+        }
+    }
 
     // frame body
     p.setPen(frameColor);
@@ -290,9 +394,13 @@ QPixmap VehicleGeometryImageProvider::requestPixmap([[maybe_unused]] const QStri
     };
     p.drawConvexPolygon(arrow, sizeof(arrow) / sizeof(arrow[0]));
 
-    drawAxisIndicator(p, QPointF{axisIndicatorSize / 2.f, height - axisIndicatorSize / 2.f}, axisIndicatorSize, fontColor);
+    drawAxisIndicator(p, QPointF{_axisIndicatorSize / 2.f, _frame.size.height() - _axisIndicatorSize / 2.f}, _axisIndicatorSize, fontColor);
+
+    for (const MotorPlacement& motor : _frame.motors) {
+        const ActuatorGeometry& actuator = _actuators[motor.actuatorIndex];
+        const QPointF& pos = motor.position;
+        const QRectF& textRect = motor.textRect;
 
-    auto drawMotor = [&](const ActuatorGeometry& actuator, QPointF pos, float yPosOffset, bool labelAtBottom) {
         p.setPen(Qt::NoPen);
         QColor arrowColor;
         if (actuator.spinDirection == ActuatorGeometry::SpinDirection::ClockWise) {
@@ -309,27 +417,18 @@ QPixmap VehicleGeometryImageProvider::requestPixmap([[maybe_unused]] const QStri
             arrowColor = arrowColor.lighter(130);
         }
 
-        pos.setY(pos.y() + yPosOffset);
-
         p.drawEllipse(pos, rotorDiameter/2, rotorDiameter/2);
 
-        QRectF textRect;
-        if (labelAtBottom) {
-            textRect = QRectF{pos.x()-rotorDiameter/2.f, pos.y()+rotorDiameter/2.f-yPosOffset, rotorDiameter, yPosOffset};
-        } else {
-            textRect = QRectF{pos.x()-rotorDiameter/2.f, pos.y()-rotorDiameter/2.f, rotorDiameter, rotorDiameter};
-        }
         if (actuator.renderOptions.highlight) {
             p.setPen(rotorHighlightColor);
             p.setBrush(rotorHighlightColor);
             float radius;
-            if (labelAtBottom) {
+            if (motor.labelAtBottom) {
                 radius = rotorFontSize / 2.f;
             } else {
                 radius = rotorDiameter / 2.f;
             }
             p.drawEllipse(textRect.center(), radius, radius);
-            _actuatorImagePositions.append(ImagePosition{actuator.type, actuator.index, textRect.center(), radius});
         }
         p.setPen(fontColor);
         QFont font = p.font();
@@ -345,7 +444,7 @@ QPixmap VehicleGeometryImageProvider::requestPixmap([[maybe_unused]] const QStri
         p.setPen(QPen{arrowColor, 2.5f});
         p.setBrush(arrowColor);
         std::array<int, 2> angleOffsets;
-        if (labelAtBottom) {
+        if (motor.labelAtBottom) {
             angleOffsets = {30, 180-30}; // bottom right + left sides
         } else {
             angleOffsets = {0, 180}; // right + left sides
@@ -370,19 +469,7 @@ QPixmap VehicleGeometryImageProvider::requestPixmap([[maybe_unused]] const QStri
             p.drawConvexPolygon(arrow, sizeof(arrow) / sizeof(arrow[0]));
             p.restore();
         }
-    };
-
-    // draw coax motors
-    iterateMotors(coaxActuators, [&](const ActuatorGeometry& actuator, QPointF pos) {
-        drawMotor(actuator, pos, extraYMargin, true);
-    });
-
-    // draw the rest of the motors
-    iterateMotors(actuators, [&](const ActuatorGeometry& actuator, QPointF pos) {
-        drawMotor(actuator, pos, 0.f, false);
-    });
-
-    return pixmap;
+    }
 }
 
 VehicleGeometryImageProvider* VehicleGeometryImageProvider::instance()
@@ -396,23 +483,26 @@ VehicleGeometryImageProvider* VehicleGeometryImageProvider::instance()
 
 int VehicleGeometryImageProvider::getHighlightedMotorIndexAtPos(const QPointF &position)
 {
+    // positions are sorted by x, so only the ones within the largest radius need to be checked
+    auto it = std::lower_bound(_actuatorImagePositions.cbegin(), _actuatorImagePositions.cend(), position.x() - _maxImagePositionRadius,
+            [](const ImagePosition& imagePosition, qreal x) { return imagePosition.position.x() < x; });
+
     int foundIdx = -1;
-    for (int i = 0; i < _actuatorImagePositions.size(); ++i) {
-        if (_actuatorImagePositions[i].type == ActuatorGeometry::Type::Motor) {
-            float radius = _actuatorImagePositions[i].radius;
-            if (QLineF{_actuatorImagePositions[i].position, position}.length() < radius) {
-                // in case of multiple matches (overlaps), be safe and do not return any match
-                if (foundIdx != -1) {
-                    return -1;
-                }
-                foundIdx = i;
+    bool found = false;
+    for (; it != _actuatorImagePositions.cend() && it->position.x() <= position.x() + _maxImagePositionRadius; ++it) {
+        if (it->type != ActuatorGeometry::Type::Motor || !_actuators[it->actuatorIndex].renderOptions.highlight) {
+            continue;
+        }
+        if (QLineF{it->position, position}.length() < it->radius) {
+            // in case of multiple matches (overlaps), be safe and do not return any match
+            if (found) {
+                return -1;
             }
+            found = true;
+            foundIdx = it->index;
         }
     }
-    if (foundIdx >= 0) {
-        return _actuatorImagePositions[foundIdx].index;
-    }
-    return -1;
+    return foundIdx;
 }
 
 int VehicleGeometryImageProvider::numMotors() const
@@ -12,6 +12,7 @@
 #include "QGCPalette.h"
 #include "Common.h"
 
+#include <QtCore/QCache>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtQuick/QQuickImageProvider>
@@ -21,7 +22,11 @@
 namespace GeometryImage {
 
 /**
- * Renders an image of an airframe geometry (currently only multirotor)
+ * Renders an image of an airframe geometry (currently only multirotor).
+ *
+ * The size independent layout (bounds, coax detection) is only recomputed when the actuator positions change,
+ * the placement of the motors when the requested size changes, and rendered images are cached by size, theme
+ * and highlighted motors.
  */
 class VehicleGeometryImageProvider : public QQuickImageProvider
 {
@@ -30,11 +35,12 @@ public:
     struct ImagePosition {
         ActuatorGeometry::Type type;
         int index;
+        int actuatorIndex; ///< index into actuators()
         QPointF position;
         float radius;
     };
 
-    void drawAxisIndicator(QPainter& p, const QPointF& origin, float fontSize, const QColor& color);
+    void drawAxisIndicator(QPainter& p, const QPointF& origin, float fontSize, const QColor& color) const;
 
     QPixmap requestPixmap(const QString& id, QSize* size, const QSize& requestedSize) override;
 
@@ -42,7 +48,14 @@ public:
 
     int getHighlightedMotorIndexAtPos(const QPointF& position);
 
-    QList<ActuatorGeometry>& actuators() { return _actuators; }
+    const QList<ActuatorGeometry>& actuators() const { return _actuators; }
+
+    /**
+     * Set the actuators to render. The cached layout is only dropped if the geometry changed, not if only
+     * the render options did.
+     * @return true if the rendered image changes
+     */
+    bool setActuators(const QList<ActuatorGeometry>& actuators);
 
     int numMotors() const;
 
@@ -50,10 +63,48 @@ private:
     VehicleGeometryImageProvider();
     ~VehicleGeometryImageProvider() = default;
 
+    struct MotorPlacement {
+        int actuatorIndex; ///< index into _actuators
+        QPointF position; ///< rotor center
+        QRectF textRect;
+        bool labelAtBottom; ///< coax motor
+    };
+
+    /// Everything needed to render the geometry at a given image size
+    struct Frame {
+        QSize size;
+        float rotorDiameter{0.f};
+        float offsetX{0.f};
+        float offsetY{0.f};
+        QList<MotorPlacement> motors{}; ///< in drawing order (coax motors first)
+    };
+
+    void _updateLayout();
+    void _updateFrame(const QSize& size);
+    void _render(QPixmap& pixmap) const;
+    QString _pixmapCacheKey(const QSize& size) const;
+
+    static bool _sameGeometry(const ActuatorGeometry& a, const ActuatorGeometry& b);
+
     QList<ActuatorGeometry> _actuators{};
 
-    QList<ImagePosition> _actuatorImagePositions{}; ///< highlighted actuators image positions
+    bool _layoutDirty{true};
+    bool _layoutValid{false}; ///< false if there is nothing to draw
+    QVector3D _min{};
+    QVector3D _max{};
+    QList<int> _motors{}; ///< indices into _actuators, not coax
+    QList<int> _coaxMotors{};
+
+    Frame _frame{};
+    QList<ImagePosition> _actuatorImagePositions{}; ///< motor image positions of _frame, sorted by x
+    float _maxImagePositionRadius{0.f};
+
+    QCache<QString, QPixmap> _pixmapCache{_pixmapCacheSize};
     QGCPalette           _palette;
+
+    static constexpr int _pixmapCacheSize = 16;
+    static constexpr float _axisIndicatorSize = 15.f; ///< font size
+    static constexpr float _margin = 5.f; ///< from image borders
 };
 
 } // namespace GeometryImage
@@ -63,6 +63,21 @@ void ChannelConfig::channelInstanceCreated(ChannelConfigInstance* instance)
             this, &ChannelConfig::instanceVisibleChanged);
 }
 
+void ChannelConfig::removeInstance(ChannelConfigInstance* instance)
+{
+    _instances.removeOne(instance);
+    disconnect(instance, &ChannelConfigInstance::visibleChanged,
+            this, &ChannelConfig::instanceVisibleChanged);
+
+    // constant values and parameter wrappers are owned by the config
+    if (instance->fact() && instance->fact()->parent() == this) {
+        instance->fact()->deleteLater();
+    }
+    instance->deleteLater();
+
+    instanceVisibleChanged();
+}
+
 void ChannelConfig::instanceVisibleChanged()
 {
     bool visible = false;
@@ -319,6 +334,15 @@ void MixerChannel::applyRule(bool noConstraints)
     _applyingRule = false;
 }
 
+void MixerChannel::releaseConfigInstances()
+{
+    for (int i = 0; i < _configInstances->count(); ++i) {
+        ChannelConfigInstance* configInstance = _configInstances->value<ChannelConfigInstance*>(i);
+        configInstance->channelConfig()->removeInstance(configInstance);
+    }
+    _configInstances->clear();
+}
+
 bool MixerChannel::getGeometry(const ActuatorTypes& actuatorTypes, const MixerOption::ActuatorGroup& group,
         ActuatorGeometry& geometry) const
 {
@@ -384,8 +408,13 @@ void MixerConfigGroup::addChannelConfig(ChannelConfig* channelConfig)
 
 void MixerConfigGroup::addChannel(MixerChannel* channel)
 {
+    // the model notifies the inserted row, a changed signal would reset the views
     _channels->append(channel);
-    emit channelsChanged();
+}
+
+MixerChannel* MixerConfigGroup::removeLastChannel()
+{
+    return qobject_cast<MixerChannel*>(_channels->removeAt(_channels->count() - 1));
 }
 
 void MixerConfigGroup::addConfigParam(ConfigParameter* param)
@@ -406,26 +435,76 @@ void Mixers::reset(const ActuatorTypes& actuatorTypes, const MixerOptions& mixer
     for (const auto& mixerOption : _mixerOptions) {
         _mixerConditions.append(Condition(mixerOption.option, _parameterManager));
     }
+    _rebuildRequired = true;
     update();
 }
 
 void Mixers::update()
 {
-    // clear first
-    _groups->clearAndDeleteContents();
-    _functionsSpecificLabel.clear();
-
-    unsubscribeFacts();
-
     // find configured mixer
-    _selectedMixer = -1;
+    int selectedMixer = -1;
     for (int i = 0; i < _mixerConditions.size(); ++i) {
         if (_mixerConditions[i].evaluate()) {
-            _selectedMixer = i;
+            selectedMixer = i;
             break;
         }
     }
 
+    if (_rebuildRequired || selectedMixer != _selectedMixer) {
+        _selectedMixer = selectedMixer;
+        rebuild();
+        return;
+    }
+
+    if (_selectedMixer == -1) {
+        return;
+    }
+
+    // Within a mixer only the group sizes depend on parameters. Channels are added or removed at the end of a group,
+    // so the views only see the inserted or removed rows. A group is only recreated if the output functions of its
+    // channels shifted, because a group of the same actuator type before it changed its size.
+    const auto& actuatorGroups = _mixerOptions[_selectedMixer].actuators;
+    QMap<QString, int> actuatorTypeCount;
+    for (int groupIdx = 0; groupIdx < actuatorGroups.size(); ++groupIdx) {
+        const auto& actuatorGroup = actuatorGroups[groupIdx];
+        const int count = groupCount(actuatorGroup);
+        const int actuatorTypeIndexStart = actuatorTypeCount.value(actuatorGroup.actuatorType, 0);
+        MixerConfigGroup* mixerGroup = _groups->value<MixerConfigGroup*>(groupIdx);
+
+        if (mixerGroup->actuatorTypeIndexStart() != actuatorTypeIndexStart) {
+            qCDebug(ActuatorsConfigLog) << "Recreating mixer group" << groupIdx;
+            for (int channelIdx = 0; channelIdx < mixerGroup->channels()->count(); ++channelIdx) {
+                detachChannel(mixerGroup->channels()->value<MixerChannel*>(channelIdx));
+            }
+            _groups->removeAt(groupIdx)->deleteLater();
+            _groups->insert(groupIdx, createGroup(actuatorGroup, count, actuatorTypeIndexStart));
+
+        } else if (count != mixerGroup->channels()->count()) {
+            qCDebug(ActuatorsConfigLog) << "Resizing mixer group" << groupIdx << "to" << count;
+            while (mixerGroup->channels()->count() > count) {
+                MixerChannel* channel = mixerGroup->removeLastChannel();
+                detachChannel(channel);
+                channel->releaseConfigInstances();
+                channel->deleteLater();
+            }
+            while (mixerGroup->channels()->count() < count) {
+                mixerGroup->addChannel(createChannel(mixerGroup, mixerGroup->channels()->count()));
+            }
+        }
+
+        actuatorTypeCount[actuatorGroup.actuatorType] = actuatorTypeIndexStart + count;
+    }
+}
+
+void Mixers::rebuild()
+{
+    _rebuildRequired = false;
+
+    // clear first
+    _groups->clearAndDeleteContents();
+    _functionsSpecificLabel.clear();
+
+    unsubscribeFacts();
 
     if (_selectedMixer != -1) {
 
@@ -436,113 +515,139 @@ void Mixers::update()
         const auto& actuatorGroups = _mixerOptions[_selectedMixer].actuators;
         QMap<QString, int> actuatorTypeCount;
         for (const auto &actuatorGroup : actuatorGroups) {
-            int count = actuatorGroup.fixedCount;
-            if (actuatorGroup.count != "") {
-                Fact* countFact = getFact(actuatorGroup.count);
-                if (countFact) {
-                    count = countFact->rawValue().toInt();
-                }
-            }
+            const int count = groupCount(actuatorGroup);
+            const int actuatorTypeIndexStart = actuatorTypeCount.value(actuatorGroup.actuatorType, 0);
+
+            _groups->append(createGroup(actuatorGroup, count, actuatorTypeIndexStart));
+            actuatorTypeCount[actuatorGroup.actuatorType] = actuatorTypeIndexStart + count;
+        }
+    }
 
-            int actuatorTypeIndex = actuatorTypeCount.value(actuatorGroup.actuatorType, 0);
+    emit groupsChanged();
 
-            MixerConfigGroup* currentMixerGroup = new MixerConfigGroup(this, actuatorGroup);
+}
 
-            // params
-            const auto actuatorType = _actuatorTypes.find(actuatorGroup.actuatorType);
-            if (actuatorType != _actuatorTypes.end()) {
-                for (const auto& perItemParam : actuatorType->perItemParams) {
-                    MixerParameter param{};
-                    param.param = perItemParam;
-                    currentMixerGroup->addChannelConfig(new ChannelConfig(currentMixerGroup, param, true));
-                }
-            }
+int Mixers::groupCount(const MixerOption::ActuatorGroup& actuatorGroup)
+{
+    int count = actuatorGroup.fixedCount;
+    if (actuatorGroup.count != "") {
+        Fact* countFact = getFact(actuatorGroup.count);
+        if (countFact) {
+            count = countFact->rawValue().toInt();
+        }
+    }
+    return count;
+}
 
-            const Rule* selectedRule{nullptr}; // at most 1 rule can be applied
-            int axisIdx[3]{-1, -1, -1};
-            for (const auto& perItemParam : actuatorGroup.perItemParameters) {
-                currentMixerGroup->addChannelConfig(new ChannelConfig(currentMixerGroup, perItemParam, false));
-
-                if (perItemParam.function == Function::AxisX) {
-                    axisIdx[0] = currentMixerGroup->channelConfigs()->count() - 1;
-                } else if (perItemParam.function == Function::AxisY) {
-                    axisIdx[1] = currentMixerGroup->channelConfigs()->count() - 1;
-                } else if (perItemParam.function == Function::AxisZ) {
-                    axisIdx[2] = currentMixerGroup->channelConfigs()->count() - 1;
-                }
+MixerConfigGroup* Mixers::createGroup(const MixerOption::ActuatorGroup& actuatorGroup, int count, int actuatorTypeIndexStart)
+{
+    MixerConfigGroup* currentMixerGroup = new MixerConfigGroup(this, actuatorGroup, actuatorTypeIndexStart);
+
+    // params
+    const auto actuatorType = _actuatorTypes.find(actuatorGroup.actuatorType);
+    if (actuatorType != _actuatorTypes.end()) {
+        for (const auto& perItemParam : actuatorType->perItemParams) {
+            MixerParameter param{};
+            param.param = perItemParam;
+            currentMixerGroup->addChannelConfig(new ChannelConfig(currentMixerGroup, param, true));
+        }
+    }
 
-                if (!perItemParam.identifier.isEmpty()) {
-                    for (const auto& rule : _rules) {
-                        if (rule.selectIdentifier == perItemParam.identifier) {
-                            selectedRule = &rule;
-                        }
-                    }
+    const Rule* selectedRule{nullptr}; // at most 1 rule can be applied
+    int axisIdx[3]{-1, -1, -1};
+    for (const auto& perItemParam : actuatorGroup.perItemParameters) {
+        currentMixerGroup->addChannelConfig(new ChannelConfig(currentMixerGroup, perItemParam, false));
+
+        if (perItemParam.function == Function::AxisX) {
+            axisIdx[0] = currentMixerGroup->channelConfigs()->count() - 1;
+        } else if (perItemParam.function == Function::AxisY) {
+            axisIdx[1] = currentMixerGroup->channelConfigs()->count() - 1;
+        } else if (perItemParam.function == Function::AxisZ) {
+            axisIdx[2] = currentMixerGroup->channelConfigs()->count() - 1;
+        }
+
+        if (!perItemParam.identifier.isEmpty()) {
+            for (const auto& rule : _rules) {
+                if (rule.selectIdentifier == perItemParam.identifier) {
+                    selectedRule = &rule;
                 }
             }
+        }
+    }
+    currentMixerGroup->setRule(selectedRule);
 
-            // Add virtual axis dropdown configuration param if all 3 axes are found
-            if (axisIdx[0] >= 0 && axisIdx[1] >= 0 && axisIdx[2] >= 0) {
-                ChannelConfig* axisXConfig = currentMixerGroup->channelConfigs()->value<ChannelConfig*>(axisIdx[0]);
-                MixerParameter parameter = axisXConfig->config(); // use axisX as base (somewhat arbitrary)
-                parameter.function = Function::Unspecified;
-                parameter.param.name = "";
-                parameter.param.label = tr("Axis");
-                parameter.identifier = "";
-                ChannelConfig* virtualChannelConfig = new ChannelConfigVirtualAxis(currentMixerGroup, parameter);
-                currentMixerGroup->channelConfigs()->insert(axisIdx[0], virtualChannelConfig);
-            }
+    // Add virtual axis dropdown configuration param if all 3 axes are found
+    if (axisIdx[0] >= 0 && axisIdx[1] >= 0 && axisIdx[2] >= 0) {
+        ChannelConfig* axisXConfig = currentMixerGroup->channelConfigs()->value<ChannelConfig*>(axisIdx[0]);
+        MixerParameter parameter = axisXConfig->config(); // use axisX as base (somewhat arbitrary)
+        parameter.function = Function::Unspecified;
+        parameter.param.name = "";
+        parameter.param.label = tr("Axis");
+        parameter.identifier = "";
+        ChannelConfig* virtualChannelConfig = new ChannelConfigVirtualAxis(currentMixerGroup, parameter);
+        currentMixerGroup->channelConfigs()->insert(axisIdx[0], virtualChannelConfig);
+    }
 
-            // 'count' param
-            if (actuatorGroup.count != "") {
-                currentMixerGroup->setCountParam(new ConfigParameter(currentMixerGroup, getFact(actuatorGroup.count),
-                        "", false));
-            }
+    // 'count' param
+    if (actuatorGroup.count != "") {
+        currentMixerGroup->setCountParam(new ConfigParameter(currentMixerGroup, getFact(actuatorGroup.count),
+                "", false));
+    }
 
-            for (int actuatorIdx = 0; actuatorIdx < count; ++actuatorIdx) {
-                QString label = "";
-                int actuatorFunction = 0;
-                if (actuatorType != _actuatorTypes.end()) {
-                    actuatorFunction = actuatorType->functionMin + actuatorTypeIndex;
-                    label = _functions.value(actuatorFunction).label;
-                    if (label == "") {
-                        qCWarning(ActuatorsConfigLog) << "No label for output function" << actuatorFunction;
-                    }
-                    QString itemLabelPrefix{};
-                    if (actuatorGroup.itemLabelPrefix.size() == 1) {
-                        QString paramIndex = QString::number(actuatorIdx + 1);
-                        itemLabelPrefix = actuatorGroup.itemLabelPrefix[0];
-                        itemLabelPrefix.replace("${i}", paramIndex);
-                    } else if (actuatorIdx < actuatorGroup.itemLabelPrefix.size()) {
-                        itemLabelPrefix = actuatorGroup.itemLabelPrefix[actuatorIdx];
-                    }
-                    if (itemLabelPrefix != "") {
-                        label = itemLabelPrefix + " (" + label + ")";
-                        _functionsSpecificLabel[actuatorFunction] = itemLabelPrefix;
-                    }
-                }
-                auto factAdded = [this](Function function, Fact* fact) {
-                    // Type might change more than the geometry
-                    subscribeFact(fact, function != Function::Type);
-                };
-                MixerChannel* channel = new MixerChannel(currentMixerGroup, label, actuatorFunction, actuatorIdx, actuatorTypeIndex,
-                        *currentMixerGroup->channelConfigs(), _parameterManager, selectedRule, factAdded);
-                currentMixerGroup->addChannel(channel);
-                ++actuatorTypeIndex;
-            }
+    for (int actuatorIdx = 0; actuatorIdx < count; ++actuatorIdx) {
+        currentMixerGroup->addChannel(createChannel(currentMixerGroup, actuatorIdx));
+    }
 
-            // config params
-            for (const auto& parameter : actuatorGroup.parameters) {
-                currentMixerGroup->addConfigParam(new ConfigParameter(currentMixerGroup, getFact(parameter.name),
-                        parameter.label, parameter.advanced));
-            }
+    // config params
+    for (const auto& parameter : actuatorGroup.parameters) {
+        currentMixerGroup->addConfigParam(new ConfigParameter(currentMixerGroup, getFact(parameter.name),
+                parameter.label, parameter.advanced));
+    }
+
+    return currentMixerGroup;
+}
 
-            _groups->append(currentMixerGroup);
-            actuatorTypeCount[actuatorGroup.actuatorType] = actuatorTypeIndex;
+MixerChannel* Mixers::createChannel(MixerConfigGroup* mixerGroup, int actuatorIdx)
+{
+    const MixerOption::ActuatorGroup& actuatorGroup = mixerGroup->group();
+    const int actuatorTypeIndex = mixerGroup->actuatorTypeIndexStart() + actuatorIdx;
+
+    QString label = "";
+    int actuatorFunction = 0;
+    const auto actuatorType = _actuatorTypes.find(actuatorGroup.actuatorType);
+    if (actuatorType != _actuatorTypes.end()) {
+        actuatorFunction = actuatorType->functionMin + actuatorTypeIndex;
+        label = _functions.value(actuatorFunction).label;
+        if (label == "") {
+            qCWarning(ActuatorsConfigLog) << "No label for output function" << actuatorFunction;
+        }
+        QString itemLabelPrefix{};
+        if (actuatorGroup.itemLabelPrefix.size() == 1) {
+            QString paramIndex = QString::number(actuatorIdx + 1);
+            itemLabelPrefix = actuatorGroup.itemLabelPrefix[0];
+            itemLabelPrefix.replace("${i}", paramIndex);
+        } else if (actuatorIdx < actuatorGroup.itemLabelPrefix.size()) {
+            itemLabelPrefix = actuatorGroup.itemLabelPrefix[actuatorIdx];
+        }
+        if (itemLabelPrefix != "") {
+            label = itemLabelPrefix + " (" + label + ")";
+            _functionsSpecificLabel[actuatorFunction] = itemLabelPrefix;
         }
     }
+    auto factAdded = [this](Function function, Fact* fact) {
+        // Type might change more than the geometry
+        subscribeFact(fact, function != Function::Type);
+    };
+    return new MixerChannel(mixerGroup, label, actuatorFunction, actuatorIdx, actuatorTypeIndex,
+            *mixerGroup->channelConfigs(), _parameterManager, mixerGroup->rule(), factAdded);
+}
 
-    emit groupsChanged();
-
+void Mixers::detachChannel(MixerChannel* channel)
+{
+    for (int i = 0; i < channel->configInstances()->count(); ++i) {
+        unsubscribeFact(channel->configInstances()->value<ChannelConfigInstance*>(i)->fact());
+    }
+    _functionsSpecificLabel.remove(channel->actuatorFunction());
 }
 
 QString Mixers::getSpecificLabelForFunction(int function) const
@@ -655,6 +760,16 @@ void Mixers::subscribeFact(Fact* fact, bool geometry)
     }
 }
 
+void Mixers::unsubscribeFact(Fact* fact)
+{
+    if (_subscribedFacts.remove(fact)) {
+        disconnect(fact, &Fact::rawValueChanged, this, &Mixers::paramChanged);
+    }
+    if (_subscribedFactsGeometry.remove(fact)) {
+        disconnect(fact, &Fact::rawValueChanged, this, &Mixers::geometryParamChanged);
+    }
+}
+
 void Mixers::unsubscribeFacts()
 {
     for (Fact* fact : _subscribedFacts) {
@@ -163,6 +163,11 @@ public:
     virtual ChannelConfigInstance* instantiate(int paramIndex, int actuatorTypeIndex,
         ParameterManager* parameterManager, std::function<void(Function, Fact*)> factAddedCb);
 
+    /**
+     * Delete an instance of a channel that is removed (and the fact it owns)
+     */
+    void removeInstance(ChannelConfigInstance* instance);
+
 signals:
     void visibleChanged();
 protected:
@@ -292,6 +297,11 @@ public:
 
     Fact* getFact(Function function) const;
 
+    /**
+     * Delete the config instances, call this before removing the channel from its group
+     */
+    void releaseConfigInstances();
+
 public slots:
     void applyRule(bool noConstraints = false);
 
@@ -316,8 +326,8 @@ class MixerConfigGroup : public QObject
 {
     Q_OBJECT
 public:
-    MixerConfigGroup(QObject* parent, const MixerOption::ActuatorGroup& group)
-        : QObject(parent), _group(group) {}
+    MixerConfigGroup(QObject* parent, const MixerOption::ActuatorGroup& group, int actuatorTypeIndexStart)
+        : QObject(parent), _group(group), _actuatorTypeIndexStart(actuatorTypeIndexStart) {}
 
     Q_PROPERTY(QString label                        READ label              CONSTANT)
     Q_PROPERTY(QmlObjectListModel* channels         READ channels           NOTIFY channelsChanged)
@@ -333,6 +343,7 @@ public:
 
     QmlObjectListModel* channels() { return _channels; }
     void addChannel(MixerChannel* channel);
+    MixerChannel* removeLastChannel();
 
     ConfigParameter* countParam() const { return _countParam; }
     void addConfigParam(ConfigParameter* param);
@@ -342,12 +353,19 @@ public:
 
     const MixerOption::ActuatorGroup& group() const { return _group; }
 
+    int actuatorTypeIndexStart() const { return _actuatorTypeIndexStart; } ///< actuator type index of the first channel
+
+    const Rule* rule() const { return _rule; }
+    void setRule(const Rule* rule) { _rule = rule; }
+
 signals:
     void channelsChanged();
     void channelConfigsChanged();
 
 private:
     const MixerOption::ActuatorGroup& _group;
+    const int _actuatorTypeIndexStart;
+    const Rule* _rule{nullptr};
     QmlObjectListModel* _channels = new QmlObjectListModel(this); ///< list of MixerChannel*
     QmlObjectListModel* _channelConfigs = new QmlObjectListModel(this); ///< list of ChannelConfig*
 
@@ -407,7 +425,8 @@ public:
 public slots:
 
     /**
-     * Call this on param update(s)
+     * Call this on param update(s). The groups are only rebuilt if another mixer got selected, otherwise only the
+     * channels of groups whose size changed are added or removed.
      */
     void update();
 
@@ -418,8 +437,15 @@ signals:
 
 private:
 
+    void rebuild();
+    int groupCount(const MixerOption::ActuatorGroup& actuatorGroup);
+    MixerConfigGroup* createGroup(const MixerOption::ActuatorGroup& actuatorGroup, int count, int actuatorTypeIndexStart);
+    MixerChannel* createChannel(MixerConfigGroup* mixerGroup, int actuatorIdx);
+    void detachChannel(MixerChannel* channel); ///< unsubscribe the channel facts
+
     Fact* getFact(const QString& paramName);
     void subscribeFact(Fact* fact, bool geometry=false);
+    void unsubscribeFact(Fact* fact);
     void unsubscribeFacts();
 
     QSet<Fact*> _subscribedFacts{};
@@ -431,6 +457,7 @@ private:
 
     QList<Condition> _mixerConditions;
     int _selectedMixer{-1};
+    bool _rebuildRequired{true}; ///< set on reset()
     QmlObjectListModel* _groups = new QmlObjectListModel(this); ///< list of MixerConfigGroup*
 
     QMap<int, QString> _functionsSpecificLabel; ///< function with specific label, e.g. 'Front Left Motor (Motor 1)'
@@ -9,14 +9,42 @@
 
 #include "Autotune.h"
 #include "QGCApplication.h"
+#include "MAVLinkProtocol.h"
+#include "ParameterManager.h"
+
+#include <QtCore/QtNumeric>
+
+const Autotune::GainParam_t Autotune::_gainParams[] = {
+    { "MC_ROLLRATE_P",  AxisRoll,   GainP },
+    { "MC_ROLLRATE_I",  AxisRoll,   GainI },
+    { "MC_ROLLRATE_D",  AxisRoll,   GainD },
+    { "MC_ROLLRATE_FF", AxisRoll,   GainFF },
+    { "MC_PITCHRATE_P", AxisPitch,  GainP },
+    { "MC_PITCHRATE_I", AxisPitch,  GainI },
+    { "MC_PITCHRATE_D", AxisPitch,  GainD },
+    { "MC_PITCHRATE_FF",AxisPitch,  GainFF },
+    { "MC_YAWRATE_P",   AxisYaw,    GainP },
+    { "MC_YAWRATE_I",   AxisYaw,    GainI },
+    { "MC_YAWRATE_D",   AxisYaw,    GainD },
+    { "MC_YAWRATE_FF",  AxisYaw,    GainFF },
+    { "FW_RR_P",        AxisRoll,   GainP },
+    { "FW_RR_I",        AxisRoll,   GainI },
+    { "FW_RR_FF",       AxisRoll,   GainFF },
+    { "FW_PR_P",        AxisPitch,  GainP },
+    { "FW_PR_I",        AxisPitch,  GainI },
+    { "FW_PR_FF",       AxisPitch,  GainFF },
+    { "FW_YR_P",        AxisYaw,    GainP },
+    { "FW_YR_I",        AxisYaw,    GainI },
+    { "FW_YR_FF",       AxisYaw,    GainFF },
+};
 
 //-----------------------------------------------------------------------------
 Autotune::Autotune(Vehicle *vehicle) :
     QObject(vehicle)
     , _vehicle(vehicle)
 {
-    _pollTimer.setInterval(1000); // 1s for the polling interval
-    _pollTimer.setSingleShot(false);
+    _pollTimer.setInterval(1000); // 1s between an answer and the next progress request
+    _pollTimer.setSingleShot(true);
     connect(&_pollTimer, &QTimer::timeout, this, &Autotune::sendMavlinkRequest);
 }
 
@@ -24,6 +52,11 @@ Autotune::Autotune(Vehicle *vehicle) :
 //-----------------------------------------------------------------------------
 void Autotune::autotuneRequest()
 {
+    _gainHistory.clear();
+    _autotuneTimer.start();
+    recordInitialGains();
+    emit gainHistoryChanged();
+
     sendMavlinkRequest();
 
     startTimers();
@@ -41,6 +74,7 @@ void Autotune::ackHandler(void* resultHandlerData, int compId, const mavlink_com
     Q_UNUSED(failureCode);
 
     auto * autotune = static_cast<Autotune *>(resultHandlerData);
+    autotune->_requestPending = false;
 
     if (autotune->_autotuneInProgress) {
         if (failureCode == Vehicle::MavCmdResultCommandResultOnly) {
@@ -56,6 +90,7 @@ void Autotune::ackHandler(void* resultHandlerData, int compId, const mavlink_com
         } else {
             autotune->handleAckFailure();
         }
+        autotune->scheduleNextRequest();
         emit autotune->autotuneChanged();
     } else {
         qWarning() << "Ack received for a command different from MAV_CMD_DO_AUTOTUNE_ENABLE ot wrong UI state.";
@@ -67,9 +102,12 @@ void Autotune::progressHandler(void* progressHandlerData, int compId, const mavl
     Q_UNUSED(compId);
 
     auto * autotune = static_cast<Autotune *>(progressHandlerData);
+    // PX4 answers with a single in progress ack, the command is done with it
+    autotune->_requestPending = false;
 
     if (autotune->_autotuneInProgress) {
         autotune->handleAckStatus(ack.progress);
+        autotune->scheduleNextRequest();
         emit autotune->autotuneChanged();
     } else {
         qWarning() << "Ack received for a command different from MAV_CMD_DO_AUTOTUNE_ENABLE ot wrong UI state.";
@@ -143,20 +181,147 @@ void Autotune::handleAckError(uint8_t ackError)
 //-----------------------------------------------------------------------------
 void Autotune::startTimers()
 {
-    _pollTimer.start();
+    // The gains the vehicle reports while tuning and once it applies them on disarm are picked from the PARAM_VALUE
+    // traffic, which ParameterManager receives anyway
+    MAVLinkProtocol* mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+    mavlinkProtocol->unsubscribeMessage(MAVLINK_MSG_ID_PARAM_VALUE, this);
+    mavlinkProtocol->subscribeMessage(MAVLINK_MSG_ID_PARAM_VALUE, this, [this](LinkInterface*, const mavlink_message_t& message) {
+        handleParamValue(message);
+    });
 }
 
 
 //-----------------------------------------------------------------------------
 void Autotune::stopTimers()
 {
+    // PARAM_VALUE stays subscribed, the tuned gains only arrive after the vehicle is disarmed
     _pollTimer.stop();
 }
 
 
+//-----------------------------------------------------------------------------
+void Autotune::scheduleNextRequest()
+{
+    // Progress is only reported in answer to a request. The next one goes out a while after the last answer, never
+    // while one is still outstanding, so a slow link does not pile up commands and retries.
+    if (_autotuneInProgress && !_requestPending) {
+        _pollTimer.start();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+void Autotune::recordInitialGains()
+{
+    ParameterManager* parameterManager = _vehicle->parameterManager();
+
+    for (const GainParam_t& gainParam : _gainParams) {
+        const QString name = QString::fromLatin1(gainParam.name);
+        if (parameterManager->parameterExists(ParameterManager::defaultComponentId, name)) {
+            const float value = parameterManager->getParameter(ParameterManager::defaultComponentId, name)->rawValue().toFloat();
+            addGainSample(0, gainParam.axis, gainParam.gain, value);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+void Autotune::handleParamValue(const mavlink_message_t& message)
+{
+    if (message.sysid != _vehicle->id()) {
+        return;
+    }
+
+    mavlink_param_value_t paramValue;
+    mavlink_msg_param_value_decode(&message, &paramValue);
+
+    char name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1] = {};
+    memcpy(name, paramValue.param_id, MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
+
+    for (const GainParam_t& gainParam : _gainParams) {
+        if (strcmp(name, gainParam.name) == 0) {
+            addGainSample(qMax<qint64>(1, _autotuneTimer.elapsed()), gainParam.axis, gainParam.gain, paramValue.param_value);
+            emit gainHistoryChanged();
+            return;
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+void Autotune::addGainSample(qint32 msecs, int axis, int gain, float value)
+{
+    // Repeats of the same value, e.g. from a parameter refresh, are not worth a sample
+    for (qsizetype i = _gainHistory.count() - 1; i >= 0; i--) {
+        const GainSample_t& sample = _gainHistory[i];
+        if ((sample.axis == axis) && (sample.gain == gain)) {
+            if (sample.value == value) {
+                return;
+            }
+            break;
+        }
+    }
+
+    if (_gainHistory.count() >= maxGainSamples) {
+        // Keep the gains from before tuning, they are what the comparison is made against
+        for (qsizetype i = 0; i < _gainHistory.count(); i++) {
+            if (_gainHistory[i].msecs != 0) {
+                _gainHistory.removeAt(i);
+                break;
+            }
+        }
+    }
+
+    _gainHistory.append({ msecs, static_cast<quint8>(axis), static_cast<quint8>(gain), value });
+}
+
+
+//-----------------------------------------------------------------------------
+QVariantList Autotune::gainComparison() const
+{
+    static const char* axisNames[AxisCount] = { QT_TR_NOOP("Roll"), QT_TR_NOOP("Pitch"), QT_TR_NOOP("Yaw") };
+    static const char* gainNames[GainCount] = { "P", "I", "D", "FF" };
+
+    float before[AxisCount][GainCount];
+    float after[AxisCount][GainCount];
+    for (int axis = 0; axis < AxisCount; axis++) {
+        for (int gain = 0; gain < GainCount; gain++) {
+            before[axis][gain] = qQNaN();
+            after[axis][gain] = qQNaN();
+        }
+    }
+    for (const GainSample_t& sample : _gainHistory) {
+        if (sample.msecs == 0) {
+            before[sample.axis][sample.gain] = sample.value;
+        } else {
+            after[sample.axis][sample.gain] = sample.value;
+        }
+    }
+
+    QVariantList comparison;
+    for (int axis = 0; axis < AxisCount; axis++) {
+        for (int gain = 0; gain < GainCount; gain++) {
+            if (qIsNaN(before[axis][gain]) && qIsNaN(after[axis][gain])) {
+                continue;
+            }
+            comparison.append(QVariantMap({
+                { QStringLiteral("axis"),   tr(axisNames[axis]) },
+                { QStringLiteral("gain"),   QString::fromLatin1(gainNames[gain]) },
+                { QStringLiteral("before"), before[axis][gain] },
+                { QStringLiteral("after"),  after[axis][gain] },
+            }));
+        }
+    }
+
+    return comparison;
+}
+
+
 //-----------------------------------------------------------------------------
 void Autotune::sendMavlinkRequest()
 {
+    _requestPending = true;
+
     Vehicle::MavCmdAckHandlerInfo_t handlerInfo = {};
     handlerInfo.resultHandler       = ackHandler;
     handlerInfo.resultHandlerData   = this;
@@ -12,7 +12,9 @@
 #include "Vehicle.h"
 #include "QGCMAVLink.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QTimer>
+#include <QtCore/QVariantList>
 
 class Autotune : public QObject
 {
@@ -25,6 +27,8 @@ public:
     Q_PROPERTY(bool      autotuneInProgress   READ autotuneInProgress     NOTIFY autotuneChanged)
     Q_PROPERTY(float     autotuneProgress     READ autotuneProgress       NOTIFY autotuneChanged)
     Q_PROPERTY(QString   autotuneStatus       READ autotuneStatus         NOTIFY autotuneChanged)
+    /// Rate controller gains before and after tuning: list of { axis, gain, before, after }, NaN where not known yet
+    Q_PROPERTY(QVariantList gainComparison   READ gainComparison         NOTIFY gainHistoryChanged)
 
     Q_INVOKABLE void autotuneRequest ();
 
@@ -34,6 +38,35 @@ public:
     bool      autotuneInProgress () { return _autotuneInProgress; }
     float     autotuneProgress   () { return _autotuneProgress; }
     QString   autotuneStatus     () { return _autotuneStatus; }
+    QVariantList gainComparison  () const;
+
+    enum Axis_t {
+        AxisRoll,
+        AxisPitch,
+        AxisYaw,
+        AxisCount
+    };
+
+    enum Gain_t {
+        GainP,
+        GainI,
+        GainD,
+        GainFF,
+        GainCount
+    };
+
+    /// A gain value the vehicle reported, 12 bytes so a whole session stays small
+    struct GainSample_t {
+        qint32  msecs;  ///< Since the autotune request, 0 for the gains before tuning
+        quint8  axis;   ///< Axis_t
+        quint8  gain;   ///< Gain_t
+        float   value;
+    };
+
+    /// Gains reported since the last autotune request, oldest first
+    const QList<GainSample_t>& gainHistory() const { return _gainHistory; }
+
+    static constexpr int maxGainSamples = 1024;
 
 
 public slots:
@@ -41,6 +74,7 @@ public slots:
 
 signals:
     void autotuneChanged ();
+    void gainHistoryChanged ();
 
 private:
     void handleAckStatus(uint8_t ackProgress);
@@ -48,6 +82,17 @@ private:
     void handleAckError(uint8_t ackError);
     void startTimers();
     void stopTimers();
+    void scheduleNextRequest();
+    void recordInitialGains();
+    void handleParamValue(const mavlink_message_t& message);
+    void addGainSample(qint32 msecs, int axis, int gain, float value);
+
+    struct GainParam_t {
+        const char* name;
+        Axis_t      axis;
+        Gain_t      gain;
+    };
+    static const GainParam_t _gainParams[];
 
 private:
     Vehicle* _vehicle                {nullptr};
@@ -56,6 +101,10 @@ private:
     QString  _autotuneStatus         {tr("Autotune: Not performed")};
     bool     _disarmMessageDisplayed {false};
 
-    QTimer   _pollTimer;         // the frequency at which the polling should be performed
+    QTimer   _pollTimer;         // paces the progress requests, restarted once the previous request is answered
+    bool     _requestPending         {false};
+
+    QList<GainSample_t> _gainHistory;
+    QElapsedTimer       _autotuneTimer;
 
 };
@@ -12,12 +12,23 @@
 #include "QGCMAVLink.h"
 
 #include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
 
 class FactMetaData;
 class Vehicle;
 class FirmwarePlugin;
 class CompInfoGeneral;
 
+/// Json meta data parsed ahead of applying it to a CompInfo. It is kept by meta data crc and shared by all
+/// vehicles using the same meta data, so it must not be changed once parsed.
+class CompInfoParsedJson
+{
+public:
+    virtual ~CompInfoParsedJson() = default;
+};
+
+typedef QSharedPointer<const CompInfoParsedJson> SharedCompInfoParsedJson;
+
 /// Base class for all CompInfo types
 class CompInfo : public QObject
 {
@@ -39,6 +50,13 @@ public:
 
     virtual void setJson(const QString& metaDataJsonFileName) = 0;
 
+    /// Parses the json without applying it, for types which can share the result with other vehicles
+    ///     @return nullptr: Type does not support sharing, setJson must be used
+    virtual SharedCompInfoParsedJson parseJson(const QString& /*metaDataJsonFileName*/) { return nullptr; }
+
+    /// Applies json returned by parseJson, which may have been parsed for another vehicle
+    virtual void setParsedJson(const SharedCompInfoParsedJson& /*parsedJson*/) { }
+
     bool available() const { return !_uris.uriMetaData.isEmpty(); }
 
     const COMP_METADATA_TYPE  type;
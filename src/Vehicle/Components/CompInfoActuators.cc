@@ -10,6 +10,8 @@
 #include "CompInfoActuators.h"
 #include "Vehicle.h"
 
+#include <QtCore/QFile>
+
 CompInfoActuators::CompInfoActuators(uint8_t compId, Vehicle* vehicle, QObject* parent)
     : CompInfo(COMP_METADATA_TYPE_ACTUATORS, compId, vehicle, parent)
 {
@@ -18,8 +20,31 @@ CompInfoActuators::CompInfoActuators(uint8_t compId, Vehicle* vehicle, QObject*
 
 void CompInfoActuators::setJson(const QString& metadataJsonFileName)
 {
-    if (!metadataJsonFileName.isEmpty()) {
-        vehicle->setActuatorsMetadata(compId, metadataJsonFileName);
+    setParsedJson(parseJson(metadataJsonFileName));
+}
+
+SharedCompInfoParsedJson CompInfoActuators::parseJson(const QString& metadataJsonFileName)
+{
+    if (metadataJsonFileName.isEmpty()) {
+        return nullptr;
+    }
+
+    QSharedPointer<ParsedJson> parsedJson(new ParsedJson);
+
+    QFile file(metadataJsonFileName);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        parsedJson->json = QJsonDocument::fromJson(file.readAll());
+    }
+
+    return parsedJson;
+}
+
+void CompInfoActuators::setParsedJson(const SharedCompInfoParsedJson& parsedJson)
+{
+    const ParsedJson* actuatorsJson = dynamic_cast<const ParsedJson*>(parsedJson.data());
+    if (actuatorsJson) {
+        _parsedJson = parsedJson;
+        vehicle->setActuatorsMetadata(compId, actuatorsJson->json);
     }
 }
 
@@ -11,6 +11,7 @@
 
 #include "CompInfo.h"
 
+#include <QtCore/QJsonDocument>
 #include <QtCore/QObject>
 
 class FactMetaData;
@@ -25,7 +26,16 @@ public:
     CompInfoActuators(uint8_t compId, Vehicle* vehicle, QObject* parent = nullptr);
 
     // Overrides from CompInfo
-    void setJson(const QString& metadataJsonFileName) override;
+    void                        setJson         (const QString& metadataJsonFileName) override;
+    SharedCompInfoParsedJson    parseJson       (const QString& metadataJsonFileName) override;
+    void                        setParsedJson   (const SharedCompInfoParsedJson& parsedJson) override;
 
 private:
+    class ParsedJson : public CompInfoParsedJson
+    {
+    public:
+        QJsonDocument json;
+    };
+
+    SharedCompInfoParsedJson _parsedJson;   ///< Keeps the shared meta data alive
 };
@@ -8,8 +8,11 @@
  ****************************************************************************/
 
 #include "CompInfoEvents.h"
+#include "EventsMetadata.h"
 #include "Vehicle.h"
 
+#include <QtCore/QFile>
+
 CompInfoEvents::CompInfoEvents(uint8_t compId, Vehicle* vehicle, QObject* parent)
     : CompInfo(COMP_METADATA_TYPE_EVENTS, compId, vehicle, parent)
 {
@@ -18,6 +21,32 @@ CompInfoEvents::CompInfoEvents(uint8_t compId, Vehicle* vehicle, QObject* parent
 
 void CompInfoEvents::setJson(const QString& metadataJsonFileName)
 {
-    vehicle->setEventsMetadata(compId, metadataJsonFileName);
+    setParsedJson(parseJson(metadataJsonFileName));
+}
+
+SharedCompInfoParsedJson CompInfoEvents::parseJson(const QString& metadataJsonFileName)
+{
+    QSharedPointer<ParsedJson> parsedJson(new ParsedJson);
+
+    // The file is read right away, it may be a temporary file which is removed once this returns
+    std::string definitions;
+    QFile file(metadataJsonFileName);
+    if (file.open(QIODevice::ReadOnly)) {
+        definitions = file.readAll().toStdString();
+    }
+
+    QString profile = "dev"; // TODO: should be configurable
+    parsedJson->metadata.reset(new EventsMetadata(std::move(definitions), profile));
+
+    return parsedJson;
+}
+
+void CompInfoEvents::setParsedJson(const SharedCompInfoParsedJson& parsedJson)
+{
+    const ParsedJson* eventsJson = dynamic_cast<const ParsedJson*>(parsedJson.data());
+    if (eventsJson) {
+        _parsedJson = parsedJson;
+        vehicle->setEventsMetadata(compId, eventsJson->metadata);
+    }
 }
 
@@ -12,6 +12,9 @@
 #include "CompInfo.h"
 
 #include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+
+class EventsMetadata;
 
 class FactMetaData;
 class Vehicle;
@@ -25,7 +28,17 @@ public:
     CompInfoEvents(uint8_t compId, Vehicle* vehicle, QObject* parent = nullptr);
 
     // Overrides from CompInfo
-    void setJson(const QString& metadataJsonFileName) override;
+    void                        setJson         (const QString& metadataJsonFileName) override;
+    SharedCompInfoParsedJson    parseJson       (const QString& metadataJsonFileName) override;
+    void                        setParsedJson   (const SharedCompInfoParsedJson& parsedJson) override;
 
 private:
+    /// The events parser, parsing starts with parseJson and continues on a worker thread
+    class ParsedJson : public CompInfoParsedJson
+    {
+    public:
+        QSharedPointer<const EventsMetadata> metadata;
+    };
+
+    SharedCompInfoParsedJson _parsedJson;   ///< Keeps the shared meta data alive
 };
@@ -0,0 +1,56 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CompInfoJsonCache.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(CompInfoJsonCacheLog, "CompInfoJsonCacheLog")
+
+CompInfoJsonCache& CompInfoJsonCache::instance()
+{
+    static CompInfoJsonCache instance;
+    return instance;
+}
+
+SharedCompInfoParsedJson CompInfoJsonCache::find(const QString& key) const
+{
+    const SharedCompInfoParsedJson parsedJson = _parsedJson.value(key).toStrongRef();
+    if (parsedJson) {
+        qCDebug(CompInfoJsonCacheLog) << "Cache hit" << key;
+    }
+    return parsedJson;
+}
+
+void CompInfoJsonCache::setPending(const QString& key)
+{
+    (void) _pendingKeys.insert(key);
+}
+
+void CompInfoJsonCache::finish(const QString& key, const SharedCompInfoParsedJson& parsedJson)
+{
+    if (!_pendingKeys.remove(key)) {
+        return;
+    }
+
+    // Drop entries which are no longer used by any vehicle
+    for (auto it = _parsedJson.begin(); it != _parsedJson.end(); ) {
+        if (it.value().isNull()) {
+            it = _parsedJson.erase(it);
+        } else {
+            it++;
+        }
+    }
+
+    if (parsedJson) {
+        qCDebug(CompInfoJsonCacheLog) << "Caching" << key;
+        _parsedJson[key] = parsedJson.toWeakRef();
+    }
+
+    emit finished(key);
+}
@@ -0,0 +1,52 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "CompInfo.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QWeakPointer>
+
+Q_DECLARE_LOGGING_CATEGORY(CompInfoJsonCacheLog)
+
+/// Process wide cache of parsed json meta data, keyed by meta data crc. Vehicles running the same firmware use the
+/// same meta data, so only the first one downloads, inflates and parses it. Vehicles connecting while the first one
+/// is still downloading wait for its result. Entries are held as long as a vehicle uses them.
+class CompInfoJsonCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static CompInfoJsonCache& instance();
+
+    /// @return Parsed json, nullptr if not cached
+    SharedCompInfoParsedJson find(const QString& key) const;
+
+    /// @return true: A vehicle is downloading the json, wait for finished
+    bool pending(const QString& key) const { return _pendingKeys.contains(key); }
+
+    /// Marks the json as being downloaded, other vehicles wait for it
+    void setPending(const QString& key);
+
+    /// Ends a pending download
+    ///     @param parsedJson nullptr if the download or parsing failed
+    void finish(const QString& key, const SharedCompInfoParsedJson& parsedJson);
+
+signals:
+    void finished(const QString& key);
+
+private:
+    QHash<QString, QWeakPointer<const CompInfoParsedJson>>  _parsedJson;
+    QSet<QString>                                           _pendingKeys;
+};
@@ -9,6 +9,7 @@
 
 #include "CompInfoParam.h"
 #include "JsonHelper.h"
+#include "JsonStreamReader.h"
 #include "FactMetaData.h"
 #include "FirmwarePlugin.h"
 #include "FirmwarePluginManager.h"
@@ -24,6 +25,8 @@
 
 QGC_LOGGING_CATEGORY(CompInfoParamLog, "CompInfoParamLog")
 
+QHash<QString, QWeakPointer<QObject>> CompInfoParam::_opaqueParameterMetaDataCache;
+
 CompInfoParam::CompInfoParam(uint8_t compId, Vehicle* vehicle, QObject* parent)
     : CompInfo(COMP_METADATA_TYPE_PARAMETER, compId, vehicle, parent)
 {
@@ -40,49 +43,77 @@ void CompInfoParam::setJson(const QString& metadataJsonFileName)
         return;
     }
 
-    QString         errorString;
-    QJsonDocument   jsonDoc;
+    setParsedJson(parseJson(metadataJsonFileName));
+}
+
+SharedCompInfoParsedJson CompInfoParam::parseJson(const QString& metadataJsonFileName)
+{
+    if (metadataJsonFileName.isEmpty()) {
+        return nullptr;
+    }
 
-    _noJsonMetadata = false;
+    QSharedPointer<ParsedJson>  parsedJson(new ParsedJson);
+    QString                     errorString;
+    JsonStreamReader            jsonReader;
 
-    if (!JsonHelper::isJsonFile(metadataJsonFileName, jsonDoc, errorString)) {
+    // The parameter array is read one element at a time, the file is never held as a whole QJsonDocument
+    if (!jsonReader.openFile(metadataJsonFileName, errorString)) {
         qCWarning(CompInfoParamLog) << "Metadata json file open failed: compid:" << compId << errorString;
-        return;
+        return parsedJson;
     }
-    QJsonObject jsonObj = jsonDoc.object();
 
     QList<JsonHelper::KeyValidateInfo> keyInfoList = {
         { JsonHelper::jsonVersionKey,   QJsonValue::Double, true },
         { _jsonParametersKey,           QJsonValue::Array,  true },
     };
-    if (!JsonHelper::validateKeys(jsonObj, keyInfoList, errorString)) {
+    if (!JsonHelper::validateKeys(jsonReader.header(), keyInfoList, errorString)) {
         qCWarning(CompInfoParamLog) << "Metadata json validation failed: compid:" << compId << errorString;
-        return;
+        return parsedJson;
     }
 
-    int version = jsonObj[JsonHelper::jsonVersionKey].toInt();
+    int version = jsonReader.header()[JsonHelper::jsonVersionKey].toInt();
     if (version != 1) {
         qCWarning(CompInfoParamLog) << "Metadata json unsupported version" << version;
-        return;
+        return parsedJson;
     }
 
-    QJsonArray rgParameters = jsonObj[_jsonParametersKey].toArray();
-    for (QJsonValue parameterValue: rgParameters) {
+    const bool success = jsonReader.readArray(_jsonParametersKey, [&parsedJson](const QJsonValue& parameterValue, QString& elementErrorString) {
         QMap<QString, QString> emptyDefineMap;
 
         if (!parameterValue.isObject()) {
-            qCWarning(CompInfoParamLog) << "Metadata json read failed: compid:" << compId << "parameters array contains non-object";
-            return;
+            elementErrorString = QStringLiteral("parameters array contains non-object");
+            return false;
         }
 
-        FactMetaData* newMetaData = FactMetaData::createFromJsonObject(parameterValue.toObject(), emptyDefineMap, this);
+        FactMetaData* newMetaData = FactMetaData::createFromJsonObject(parameterValue.toObject(), emptyDefineMap, &parsedJson->metaDataParent);
+        newMetaData->setShared(true);
 
         if (newMetaData->name().contains(_indexedNameTag)) {
-            _indexedNameMetaDataList.append(RegexFactMetaDataPair_t(newMetaData->name(), newMetaData));
+            parsedJson->indexedNameMetaDataList.append(RegexFactMetaDataPair_t(newMetaData->name(), newMetaData));
         } else {
-            _nameToMetaDataMap[newMetaData->name()] = newMetaData;
+            parsedJson->nameToMetaDataMap[newMetaData->name()] = newMetaData;
         }
+        return true;
+    }, errorString);
+    if (!success) {
+        qCWarning(CompInfoParamLog) << "Metadata json read failed: compid:" << compId << errorString;
     }
+
+    return parsedJson;
+}
+
+void CompInfoParam::setParsedJson(const SharedCompInfoParsedJson& parsedJson)
+{
+    const ParsedJson* paramJson = dynamic_cast<const ParsedJson*>(parsedJson.data());
+    if (!paramJson) {
+        return;
+    }
+
+    // Names which are not in the json get meta data of their own in _nameToMetaDataMap, the shared map stays as is
+    _noJsonMetadata             = false;
+    _parsedJson                 = parsedJson;
+    _nameToMetaDataMap          = paramJson->nameToMetaDataMap;
+    _indexedNameMetaDataList    = paramJson->indexedNameMetaDataList;
 }
 
 FactMetaData* CompInfoParam::factMetaDataForName(const QString& name, FactMetaData::ValueType_t type)
@@ -92,7 +123,11 @@ FactMetaData* CompInfoParam::factMetaDataForName(const QString& name, FactMetaDa
     if (_noJsonMetadata) {
         QObject* opaqueMetaData = _getOpaqueParameterMetaData();
         if (opaqueMetaData) {
+            // The firmware plugin meta data returns the same FactMetaData for a name to every vehicle
             factMetaData = vehicle->firmwarePlugin()->_getMetaDataForFact(opaqueMetaData, name, type, vehicle->vehicleType());
+            if (factMetaData) {
+                factMetaData->setShared(true);
+            }
         }
     }
 
@@ -173,7 +208,7 @@ QString CompInfoParam::_parameterMetaDataFile(Vehicle* vehicle, MAV_AUTOPILOT fi
         int cacheMinorVersion, cacheMajorVersion;
         QFile cacheFile(cacheDir.filePath(QString("%1.%2.%3.xml").arg(_cachedMetaDataFilePrefix).arg(firmwareType).arg(wantedMajorVersion)));
         if (cacheFile.exists()) {
-            fwPlugin->_getParameterMetaDataVersionInfo(cacheFile.fileName(), cacheMajorVersion, cacheMinorVersion);
+            fwPlugin->_cachedParameterMetaDataVersionInfo(cacheFile.fileName(), cacheMajorVersion, cacheMinorVersion);
             if (wantedMajorVersion != cacheMajorVersion) {
                 qWarning() << "Parameter meta data cache corruption:" << cacheFile.fileName() << "major version does not match file name" << "actual:excepted" << cacheMajorVersion << wantedMajorVersion;
             } else {
@@ -208,7 +243,7 @@ QString CompInfoParam::_parameterMetaDataFile(Vehicle* vehicle, MAV_AUTOPILOT fi
                 // We have a cache hit on a lower major version, read minor version as well
                 int majorVersion;
                 cacheFile.setFileName(cacheDir.filePath(cacheHits[cacheHitIndex]));
-                fwPlugin->_getParameterMetaDataVersionInfo(cacheFile.fileName(), majorVersion, cacheMinorVersion);
+                fwPlugin->_cachedParameterMetaDataVersionInfo(cacheFile.fileName(), majorVersion, cacheMinorVersion);
                 if (majorVersion != cacheMajorVersion) {
                     qWarning() << "Parameter meta data cache corruption:" << cacheFile.fileName() << "major version does not match file name" << "actual:excepted" << majorVersion << cacheMajorVersion;
                     cacheHit = false;
@@ -221,7 +256,7 @@ QString CompInfoParam::_parameterMetaDataFile(Vehicle* vehicle, MAV_AUTOPILOT fi
 
         int internalMinorVersion, internalMajorVersion;
         QString internalMetaDataFile = fwPlugin->_internalParameterMetaDataFile(vehicle);
-        fwPlugin->_getParameterMetaDataVersionInfo(internalMetaDataFile, internalMajorVersion, internalMinorVersion);
+        fwPlugin->_cachedParameterMetaDataVersionInfo(internalMetaDataFile, internalMajorVersion, internalMinorVersion);
         qCDebug(CompInfoParamLog) << "Internal metadata file:major:minor" << internalMetaDataFile << internalMajorVersion << internalMinorVersion;
         if (cacheHit) {
             // Cache hit is available, we need to check if internal meta data is a better match, if so use internal version
@@ -265,7 +300,7 @@ void CompInfoParam::_cachePX4MetaDataFile(const QString& metaDataFile)
     FirmwarePlugin* plugin = _anyVehicleTypeFirmwarePlugin(MAV_AUTOPILOT_PX4);
 
     int newMajorVersion, newMinorVersion;
-    plugin->_getParameterMetaDataVersionInfo(metaDataFile, newMajorVersion, newMinorVersion);
+    plugin->_cachedParameterMetaDataVersionInfo(metaDataFile, newMajorVersion, newMinorVersion);
     if (newMajorVersion != 1) {
         newMajorVersion = 1;
         qgcApp()->showAppMessage(tr("Internal Error: Parameter MetaData major must be 1"));
@@ -316,9 +351,21 @@ QObject* CompInfoParam::_getOpaqueParameterMetaData(void)
         // Load best parameter meta data set
         int majorVersion, minorVersion;
         QString metaDataFile = _parameterMetaDataFile(vehicle, vehicle->firmwareType(), majorVersion, minorVersion);
-        qCDebug(CompInfoParamLog) << "Loading meta data the old way file" << metaDataFile;
-        _opaqueParameterMetaData = vehicle->firmwarePlugin()->_loadParameterMetaData(metaDataFile);
+
+        const QString cacheKey = QStringLiteral("%1:%2").arg(vehicle->firmwareType()).arg(metaDataFile);
+        _opaqueParameterMetaData = _opaqueParameterMetaDataCache.value(cacheKey).toStrongRef();
+        if (_opaqueParameterMetaData) {
+            qCDebug(CompInfoParamLog) << "Sharing meta data loaded the old way file" << metaDataFile;
+        } else {
+            qCDebug(CompInfoParamLog) << "Loading meta data the old way file" << metaDataFile;
+            QObject* const opaqueMetaData = vehicle->firmwarePlugin()->_loadParameterMetaData(metaDataFile);
+            if (opaqueMetaData) {
+                // Facts of the last vehicle using it may still point to its FactMetaData while the vehicle goes away
+                _opaqueParameterMetaData = QSharedPointer<QObject>(opaqueMetaData, &QObject::deleteLater);
+                _opaqueParameterMetaDataCache[cacheKey] = _opaqueParameterMetaData;
+            }
+        }
     }
 
-    return _opaqueParameterMetaData;
+    return _opaqueParameterMetaData.data();
 }
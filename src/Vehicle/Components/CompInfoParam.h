@@ -13,8 +13,11 @@
 #include "QGCMAVLink.h"
 #include "FactMetaData.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QWeakPointer>
 
 class Vehicle;
 class FirmwarePlugin;
@@ -31,7 +34,9 @@ public:
     FactMetaData* factMetaDataForName(const QString& name, FactMetaData::ValueType_t type);
 
     // Overrides from CompInfo
-    void setJson(const QString& metadataJsonFileName) override;
+    void                        setJson         (const QString& metadataJsonFileName) override;
+    SharedCompInfoParsedJson    parseJson       (const QString& metadataJsonFileName) override;
+    void                        setParsedJson   (const SharedCompInfoParsedJson& parsedJson) override;
 
     static void _cachePX4MetaDataFile(const QString& metaDataFile);
 
@@ -43,10 +48,23 @@ private:
 
     typedef QPair<QString /* indexed name */, FactMetaData*> RegexFactMetaDataPair_t;
 
+    /// Meta data from the json, shared by all vehicles with the same parameter meta data
+    class ParsedJson : public CompInfoParsedJson
+    {
+    public:
+        QObject                             metaDataParent;
+        FactMetaData::NameToMetaDataMap_t   nameToMetaDataMap;
+        QList<RegexFactMetaDataPair_t>      indexedNameMetaDataList;
+    };
+
     bool                                _noJsonMetadata             = true;
     FactMetaData::NameToMetaDataMap_t   _nameToMetaDataMap;
     QList<RegexFactMetaDataPair_t>      _indexedNameMetaDataList;
-    QObject*                            _opaqueParameterMetaData    = nullptr;
+    QSharedPointer<QObject>             _opaqueParameterMetaData;               ///< Shared by all vehicles using the same meta data file
+    SharedCompInfoParsedJson            _parsedJson;                            ///< Keeps the shared meta data alive
+
+    /// Firmware plugin meta data by firmware type and file, loaded once for all vehicles which use it
+    static QHash<QString, QWeakPointer<QObject>> _opaqueParameterMetaDataCache;
 
     static constexpr const char* _jsonParametersKey           = "parameters";
     static constexpr const char* _cachedMetaDataFilePrefix    = "ParameterFactMetaData";
@@ -17,6 +17,7 @@
 #include "CompInfoParam.h"
 #include "CompInfoEvents.h"
 #include "CompInfoActuators.h"
+#include "CompInfoJsonCache.h"
 #include "QGCApplication.h"
 #include "QGCCachedFileDownload.h"
 #include "QGCLoggingCategory.h"
@@ -171,12 +172,23 @@ RequestMetaDataTypeStateMachine::RequestMetaDataTypeStateMachine(ComponentInform
 
 }
 
+RequestMetaDataTypeStateMachine::~RequestMetaDataTypeStateMachine()
+{
+    // Vehicles waiting for our download have to get the json themselves
+    _finishSharedJson(nullptr);
+}
+
 void RequestMetaDataTypeStateMachine::request(CompInfo* compInfo)
 {
     _compInfo   = compInfo;
     _stateIndex = -1;
     _jsonMetadataFileName.clear();
+    _jsonMetadataTranslatedFileName.clear();
+    _jsonMetadataTranslatedCached = false;
     _jsonTranslationFileName.clear();
+    _parsedJson.reset();
+    _pendingJsonKey.clear();
+    _waitingJsonKey.clear();
 
     start();
 }
@@ -338,6 +350,11 @@ QString RequestMetaDataTypeStateMachine::_downloadCompleteJsonWorker(const QStri
 
 void RequestMetaDataTypeStateMachine::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg)
 {
+    if (fileName != _ftpDownloadFile) {
+        return;
+    }
+    _ftpDownloadFile.clear();
+
     qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadComplete fileName:errorMsg" << fileName << errorMsg;
 
     disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
@@ -354,8 +371,12 @@ void RequestMetaDataTypeStateMachine::_ftpDownloadComplete(const QString& fileNa
     advance();
 }
 
-void RequestMetaDataTypeStateMachine::_ftpDownloadProgress(float progress)
+void RequestMetaDataTypeStateMachine::_ftpDownloadProgress(const QString& file, float progress)
 {
+    if (file != _ftpDownloadFile) {
+        return;
+    }
+
     int elapsedSec = _downloadStartTime.elapsed() / 1000;
     float totalDownloadTime = elapsedSec / progress;
     // abort download if it's too slow (e.g. over telemetry link) and use the fallback.
@@ -363,7 +384,7 @@ void RequestMetaDataTypeStateMachine::_ftpDownloadProgress(float progress)
     const int maxDownloadTimeSec = 40;
     if (elapsedSec > 10 && progress < 0.5 && totalDownloadTime > maxDownloadTimeSec) {
         qCDebug(ComponentInformationManagerLog) << "Slow download, aborting. Total time (s):" << totalDownloadTime;
-        _compInfo->vehicle->ftpManager()->cancelDownload();
+        _compInfo->vehicle->ftpManager()->cancelDownload(_ftpDownloadFile);
     }
 }
 
@@ -399,7 +420,8 @@ void RequestMetaDataTypeStateMachine::_requestFile(const QString& cacheFileTag,
             qCDebug(ComponentInformationManagerLog) << "Downloading json" << uri;
             if (_uriIsMAVLinkFTP(uri)) {
                 connect(ftpManager, &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
-                if (ftpManager->download(MAV_COMP_ID_AUTOPILOT1, uri, QStandardPaths::writableLocation(QStandardPaths::TempLocation))) {
+                _ftpDownloadFile = ftpManager->download(MAV_COMP_ID_AUTOPILOT1, uri, QStandardPaths::writableLocation(QStandardPaths::TempLocation));
+                if (!_ftpDownloadFile.isEmpty()) {
                     _downloadStartTime.start();
                     connect(ftpManager, &FTPManager::commandProgress, this, &RequestMetaDataTypeStateMachine::_ftpDownloadProgress);
                 } else {
@@ -431,13 +453,69 @@ void RequestMetaDataTypeStateMachine::_requestFile(const QString& cacheFileTag,
 
 }
 
+/// Looks for json meta data with the same crc parsed for another vehicle
+///     @return true: The shared json is used or being waited for, no download needed
+bool RequestMetaDataTypeStateMachine::_requestSharedJson(uint32_t crc, bool crcValid)
+{
+    if (!crcValid) {
+        return false;
+    }
+
+    // The translation is applied before parsing, so it is part of the key
+    const QString       key     = ComponentInformationManager::_getFileCacheTag(_compInfo->type, crc, false) + QStringLiteral("|") + _compInfo->uriTranslation();
+    CompInfoJsonCache&  cache   = CompInfoJsonCache::instance();
+
+    _parsedJson = cache.find(key);
+    if (_parsedJson) {
+        qCDebug(ComponentInformationManagerLog) << "Using json parsed for another vehicle" << key;
+        advance();
+        return true;
+    }
+
+    if (cache.pending(key)) {
+        qCDebug(ComponentInformationManagerLog) << "Waiting for json download of another vehicle" << key;
+        _waitingJsonKey = key;
+        connect(&cache, &CompInfoJsonCache::finished, this, &RequestMetaDataTypeStateMachine::_sharedJsonFinished);
+        return true;
+    }
+
+    cache.setPending(key);
+    _pendingJsonKey = key;
+    return false;
+}
+
+void RequestMetaDataTypeStateMachine::_sharedJsonFinished(const QString& key)
+{
+    if (key != _waitingJsonKey) {
+        return;
+    }
+    disconnect(&CompInfoJsonCache::instance(), &CompInfoJsonCache::finished, this, &RequestMetaDataTypeStateMachine::_sharedJsonFinished);
+    _waitingJsonKey.clear();
+
+    // Run the state again, it either picks up the parsed json or downloads it if the other vehicle failed
+    move(currentState());
+}
+
+void RequestMetaDataTypeStateMachine::_finishSharedJson(const SharedCompInfoParsedJson& parsedJson)
+{
+    if (!_pendingJsonKey.isEmpty()) {
+        const QString key = _pendingJsonKey;
+        _pendingJsonKey.clear();
+        CompInfoJsonCache::instance().finish(key, parsedJson);
+    }
+}
+
 void RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson(StateMachine* stateMachine)
 {
     RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
     CompInfo*                           compInfo        = requestMachine->compInfo();
+    if (requestMachine->_requestSharedJson(compInfo->crcMetaData(), compInfo->crcMetaDataValid())) {
+        return;
+    }
     const QString                       fileTag         = ComponentInformationManager::_getFileCacheTag(
             compInfo->type, compInfo->crcMetaData(), false);
     const QString                       uri             = compInfo->uriMetaData();
+    requestMachine->_jsonMetadataCrc                    = compInfo->crcMetaData();
     requestMachine->_jsonMetadataCrcValid               = compInfo->crcMetaDataValid();
     requestMachine->_requestFile(fileTag, compInfo->crcMetaDataValid(), uri, requestMachine->_jsonMetadataFileName);
 }
@@ -445,16 +523,24 @@ void RequestMetaDataTypeStateMachine::_stateRequestMetaDataJson(StateMachine* st
 void RequestMetaDataTypeStateMachine::_stateRequestMetaDataJsonFallback(StateMachine* stateMachine)
 {
     RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
-    if (!requestMachine->_jsonMetadataFileName.isEmpty()) {
+    if (!requestMachine->_jsonMetadataFileName.isEmpty() || requestMachine->_parsedJson) {
         requestMachine->advance();
         return;
     }
-    qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_stateRequestMetaDataJsonFallback: trying fallback download";
+
+    // The primary download failed, vehicles waiting for it fall back as well
+    requestMachine->_finishSharedJson(nullptr);
 
     CompInfo*                           compInfo        = requestMachine->compInfo();
+    if (requestMachine->_requestSharedJson(compInfo->crcMetaDataFallback(), compInfo->crcMetaDataFallbackValid())) {
+        return;
+    }
+    qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_stateRequestMetaDataJsonFallback: trying fallback download";
+
     const QString                       fileTag         = ComponentInformationManager::_getFileCacheTag(
             compInfo->type, compInfo->crcMetaDataFallback(), false);
     const QString                       uri             = compInfo->uriMetaDataFallback();
+    requestMachine->_jsonMetadataCrc                    = compInfo->crcMetaDataFallback();
     requestMachine->_jsonMetadataCrcValid               = compInfo->crcMetaDataFallbackValid();
     requestMachine->_requestFile(fileTag, compInfo->crcMetaDataFallbackValid(), uri, requestMachine->_jsonMetadataFileName);
 }
@@ -463,15 +549,36 @@ void RequestMetaDataTypeStateMachine::_stateRequestTranslationJson(StateMachine*
 {
     RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
     CompInfo*                           compInfo        = requestMachine->compInfo();
+    if (requestMachine->_parsedJson) {
+        requestMachine->advance();
+        return;
+    }
     const QString                       uri             = compInfo->uriTranslation();
+
+    // Metadata translated before for this locale, neither the translation download nor translating again is needed
+    if (requestMachine->_jsonMetadataCrcValid && compInfo->available() && !uri.isEmpty() && !requestMachine->_jsonMetadataFileName.isEmpty()) {
+        const QString cachedFile = requestMachine->_compMgr->fileCache().access(requestMachine->_translatedFileCacheTag());
+        if (!cachedFile.isEmpty()) {
+            qCDebug(ComponentInformationManagerLog) << "Using cached translated json" << cachedFile;
+            requestMachine->_jsonMetadataTranslatedFileName = cachedFile;
+            requestMachine->_jsonMetadataTranslatedCached = true;
+            requestMachine->advance();
+            return;
+        }
+    }
+
     requestMachine->_requestFile("", false, uri, requestMachine->_jsonTranslationFileName);
 }
 
 void RequestMetaDataTypeStateMachine::_stateRequestTranslate(StateMachine* stateMachine)
 {
     RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
+    if (requestMachine->_jsonMetadataTranslatedCached) {
+        requestMachine->advance();
+        return;
+    }
     requestMachine->_jsonMetadataTranslatedFileName = "";
-    if (requestMachine->_jsonTranslationFileName.isEmpty()) {
+    if (requestMachine->_parsedJson || requestMachine->_jsonTranslationFileName.isEmpty()) {
         requestMachine->advance();
     } else {
         connect(requestMachine->_compMgr->translation(), &ComponentInformationTranslation::downloadComplete,
@@ -494,19 +601,48 @@ void RequestMetaDataTypeStateMachine::_downloadAndTranslationComplete(QString tr
     _jsonMetadataTranslatedFileName = translatedJsonTempFile;
     if (!errorMsg.isEmpty()) {
         qCWarning(ComponentInformationManagerLog) << "Metadata translation failed:" << errorMsg;
+    } else if (_jsonMetadataCrcValid && !translatedJsonTempFile.isEmpty()) {
+        // Kept for the next connect of this or another vehicle with the same metadata (this moves the temp file)
+        const QString cachedFile = _compMgr->fileCache().insert(_translatedFileCacheTag(), translatedJsonTempFile);
+        if (!cachedFile.isEmpty()) {
+            _jsonMetadataTranslatedFileName = cachedFile;
+            _jsonMetadataTranslatedCached = true;
+        }
     }
     advance();
 }
 
+/// The translation is keyed by the crc of the translated metadata and the locale
+QString RequestMetaDataTypeStateMachine::_translatedFileCacheTag(void) const
+{
+    return ComponentInformationManager::_getFileCacheTag(_compInfo->type, _jsonMetadataCrc, true) + QStringLiteral("_") + ComponentInformationTranslation::locale();
+}
+
 void RequestMetaDataTypeStateMachine::_stateRequestComplete(StateMachine* stateMachine)
 {
     RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
     CompInfo*                           compInfo        = requestMachine->compInfo();
 
-    if (requestMachine->_jsonMetadataTranslatedFileName.isEmpty()) {
-        compInfo->setJson(requestMachine->_jsonMetadataFileName);
+    if (requestMachine->_parsedJson) {
+        compInfo->setParsedJson(requestMachine->_parsedJson);
+        requestMachine->_parsedJson.reset();
+        requestMachine->advance();
+        return;
+    }
+
+    const QString jsonFileName = requestMachine->_jsonMetadataTranslatedFileName.isEmpty() ?
+                requestMachine->_jsonMetadataFileName : requestMachine->_jsonMetadataTranslatedFileName;
+    SharedCompInfoParsedJson parsedJson;
+    if (!jsonFileName.isEmpty()) {
+        parsedJson = compInfo->parseJson(jsonFileName);
+    }
+    if (parsedJson) {
+        compInfo->setParsedJson(parsedJson);
     } else {
-        compInfo->setJson(requestMachine->_jsonMetadataTranslatedFileName);
+        compInfo->setJson(jsonFileName);
+    }
+    requestMachine->_finishSharedJson(parsedJson);
+    if (!requestMachine->_jsonMetadataTranslatedFileName.isEmpty() && !requestMachine->_jsonMetadataTranslatedCached) {
         QFile(requestMachine->_jsonMetadataTranslatedFileName).remove();
     }
 
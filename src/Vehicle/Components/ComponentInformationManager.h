@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "CompInfo.h"
 #include "QGCMAVLink.h"
 #include "StateMachine.h"
 
@@ -21,7 +22,6 @@ class Vehicle;
 class ComponentInformationManager;
 class ComponentInformationTranslation;
 class ComponentInformationCache;
-class CompInfo;
 class CompInfoParam;
 class CompInfoGeneral;
 class QGCCachedFileDownload;
@@ -32,6 +32,7 @@ class RequestMetaDataTypeStateMachine : public StateMachine
 
 public:
     RequestMetaDataTypeStateMachine(ComponentInformationManager* compMgr);
+    ~RequestMetaDataTypeStateMachine();
 
     void        request     (CompInfo* compInfo);
     QString     typeToString(void);
@@ -44,10 +45,11 @@ public:
 
 private slots:
     void    _ftpDownloadComplete                (const QString& file, const QString& errorMsg);
-    void    _ftpDownloadProgress                (float progress);
+    void    _ftpDownloadProgress                (const QString& file, float progress);
     void    _httpDownloadComplete               (QString remoteFile, QString localFile, QString errorMsg);
     QString _downloadCompleteJsonWorker         (const QString& jsonFileName);
     void _downloadAndTranslationComplete(QString translatedJsonTempFile, QString errorMsg);
+    void _sharedJsonFinished            (const QString& key);
 
 private:
     static void _stateRequestCompInfo           (StateMachine* stateMachine);
@@ -60,11 +62,16 @@ private:
     static bool _uriIsMAVLinkFTP                (const QString& uri);
 
     void _requestFile(const QString& cacheFileTag, bool crcValid, const QString& uri, QString& outputFileName);
+    bool _requestSharedJson(uint32_t crc, bool crcValid);
+    void _finishSharedJson(const SharedCompInfoParsedJson& parsedJson);
+    QString _translatedFileCacheTag(void) const;
 
     ComponentInformationManager*    _compMgr                    = nullptr;
     CompInfo*                       _compInfo                   = nullptr;
     QString                         _jsonMetadataFileName;
     QString                         _jsonMetadataTranslatedFileName;
+    bool                            _jsonMetadataTranslatedCached = false;    ///< _jsonMetadataTranslatedFileName is in the file cache, not a temp file
+    uint32_t                        _jsonMetadataCrc            = 0;
     bool                            _jsonMetadataCrcValid       = false;
     QString                         _jsonTranslationFileName;
     bool                            _jsonTranslationCrcValid    = false;
@@ -72,9 +79,14 @@ private:
     QString*                        _currentFileName            = nullptr;
     QString                         _currentCacheFileTag;
     bool                            _currentFileValidCrc        = false;
+    QString                         _ftpDownloadFile;           ///< Local file of the running FTP download, other downloads share the signals
 
     QElapsedTimer                   _downloadStartTime;
 
+    SharedCompInfoParsedJson        _parsedJson;                ///< Parsed json shared by another vehicle
+    QString                         _pendingJsonKey;            ///< Key of the shared json this vehicle downloads
+    QString                         _waitingJsonKey;            ///< Key of the shared json another vehicle downloads
+
     static constexpr const StateFn _rgStates[]= {
         _stateRequestCompInfo,
         _stateRequestCompInfoDeprecated,
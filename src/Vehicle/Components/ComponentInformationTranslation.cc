@@ -14,10 +14,12 @@
 #include "QGCLZMA.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDir>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QTemporaryFile>
 #include <QtCore/QXmlStreamReader>
 
 QGC_LOGGING_CATEGORY(ComponentInformationTranslationLog, "ComponentInformationTranslationLog")
@@ -26,6 +28,25 @@ ComponentInformationTranslation::ComponentInformationTranslation(QObject* parent
                                                                  QGCCachedFileDownload* cachedFileDownload)
     : QObject(parent), _cachedFileDownload(cachedFileDownload)
 {
+    (void) connect(&_translateWatcher, &QFutureWatcherBase::finished, this, &ComponentInformationTranslation::onTranslateFinished);
+}
+
+ComponentInformationTranslation::~ComponentInformationTranslation()
+{
+    // The worker uses _cancel, so it has to be done before we go away
+    cancel();
+    _translateWatcher.waitForFinished();
+}
+
+QString ComponentInformationTranslation::locale()
+{
+    return QLocale::system().name();
+}
+
+void ComponentInformationTranslation::cancel()
+{
+    disconnect(_cachedFileDownload, &QGCCachedFileDownload::downloadComplete, this, &ComponentInformationTranslation::onDownloadCompleted);
+    _cancel.storeRelaxed(true);
 }
 
 bool ComponentInformationTranslation::downloadAndTranslate(const QString& summaryJsonFile,
@@ -33,8 +54,8 @@ bool ComponentInformationTranslation::downloadAndTranslate(const QString& summar
 {
     // Parse summary: find url for current locale
     _toTranslateJsonFile = toTranslateJsonFile;
-    QString locale = QLocale::system().name();
-    QString url = getUrlFromSummaryJson(summaryJsonFile, locale);
+    _cancel.storeRelaxed(false);
+    QString url = getUrlFromSummaryJson(summaryJsonFile, locale());
     if (url.isEmpty()) {
         return false;
     }
@@ -77,38 +98,74 @@ void ComponentInformationTranslation::onDownloadCompleted(QString remoteFile, QS
 {
     disconnect(_cachedFileDownload, &QGCCachedFileDownload::downloadComplete, this, &ComponentInformationTranslation::onDownloadCompleted);
 
+    if (!errorMsg.isEmpty()) {
+        emit downloadComplete(QString(), errorMsg);
+        return;
+    }
+
+    // Translating the whole metadata document takes seconds for large parameter sets, keep it off the GUI thread
+    const QString toTranslateJsonFile = _toTranslateJsonFile;
+    const QAtomicInteger<bool>* cancel = &_cancel;
+    _translateWatcher.setFuture(QtConcurrent::run([remoteFile, localFile, toTranslateJsonFile, cancel]() {
+        return translateWorker(remoteFile, localFile, toTranslateJsonFile, cancel);
+    }));
+}
+
+void ComponentInformationTranslation::onTranslateFinished()
+{
+    const TranslateResult_t result = _translateWatcher.result();
+    if (_cancel.loadRelaxed()) {
+        qCDebug(ComponentInformationTranslationLog) << "Translation cancelled" << _toTranslateJsonFile;
+        if (!result.first.isEmpty()) {
+            QFile(result.first).remove();
+        }
+        return;
+    }
+
+    emit downloadComplete(result.first, result.second);
+}
+
+ComponentInformationTranslation::TranslateResult_t ComponentInformationTranslation::translateWorker(const QString& remoteFile, const QString& localFile,
+                                                                                                    const QString& toTranslateJsonFile,
+                                                                                                    const QAtomicInteger<bool>* cancel)
+{
+    QString errorMsg;
     QString tsFileName = localFile;
     bool deleteFile = false;
-    if (errorMsg.isEmpty()) {
 
-        // Decompress if needed
-        if (localFile.endsWith(".lzma", Qt::CaseInsensitive) || localFile.endsWith(".xz", Qt::CaseInsensitive)) {
-            tsFileName = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath("qgc_translation_file_decompressed.ts");
-            if (QGCLZMA::inflateLZMAFile(localFile, tsFileName)) {
-                deleteFile = true;
-            } else {
-                errorMsg = "Inflate of compressed json failed, " + remoteFile;
-            }
+    // Decompress if needed
+    if (localFile.endsWith(".lzma", Qt::CaseInsensitive) || localFile.endsWith(".xz", Qt::CaseInsensitive)) {
+        QTemporaryFile tsFile(QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath("qgc_translation_file_decompressed_XXXXXX.ts"));
+        tsFile.setAutoRemove(false);
+        if (tsFile.open()) {
+            tsFileName = tsFile.fileName();
+            tsFile.close();
+        }
+        if (tsFileName != localFile && QGCLZMA::inflateLZMAFile(localFile, tsFileName)) {
+            deleteFile = true;
+        } else {
+            errorMsg = "Inflate of compressed json failed, " + remoteFile;
         }
     }
 
     // Translate json file to new temp file
     QString translatedJsonFilename;
     if (errorMsg.isEmpty()) {
-        translatedJsonFilename = translateJsonUsingTS(_toTranslateJsonFile, tsFileName);
+        translatedJsonFilename = translateJsonUsingTS(toTranslateJsonFile, tsFileName, cancel);
         if (translatedJsonFilename.isEmpty()) {
             errorMsg = "Failed to translate json file";
         }
     }
 
     if (deleteFile) {
+        QFile(tsFileName).remove();
         QFile(localFile).remove();
     }
 
-    emit downloadComplete(translatedJsonFilename, errorMsg);
+    return TranslateResult_t(translatedJsonFilename, errorMsg);
 }
 
-QString ComponentInformationTranslation::translateJsonUsingTS(const QString &toTranslateJsonFile, const QString &tsFile)
+QString ComponentInformationTranslation::translateJsonUsingTS(const QString &toTranslateJsonFile, const QString &tsFile, const QAtomicInteger<bool>* cancel)
 {
     qCInfo(ComponentInformationTranslationLog) << "Translating" << toTranslateJsonFile << "using" << tsFile;
 
@@ -147,6 +204,9 @@ QString ComponentInformationTranslation::translateJsonUsingTS(const QString &toT
     bool insideTS = false;
 
     while (!xml.atEnd()) {
+        if (isCancelled(cancel)) {
+            return "";
+        }
         if (xml.isStartElement()) {
             QString elementName = xml.name().toString();
 
@@ -199,16 +259,19 @@ QString ComponentInformationTranslation::translateJsonUsingTS(const QString &toT
     }
 
     // Translate the json document
-    jsonDoc.setObject(translate(translationObj, translations, jsonDoc.object()));
-
-    // Write to file
-    QString translatedFileName = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath("qgc_translated_metadata.json");
+    jsonDoc.setObject(translate(translationObj, translations, jsonDoc.object(), cancel));
+    if (isCancelled(cancel)) {
+        return "";
+    }
 
-    QFile translatedFile(translatedFileName);
-    if (!translatedFile.open(QFile::WriteOnly|QFile::Truncate)) {
-        errorString = tr("File open failed: file:error %1 %2").arg(translatedFile.fileName()).arg(translatedFile.errorString());
+    // Write to file, unique as several vehicles may translate at the same time
+    QTemporaryFile translatedFile(QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath("qgc_translated_metadata_XXXXXX.json"));
+    translatedFile.setAutoRemove(false);
+    if (!translatedFile.open()) {
+        qCWarning(ComponentInformationTranslationLog) << "File open failed:" << translatedFile.fileName() << translatedFile.errorString();
         return "";
     }
+    const QString translatedFileName = translatedFile.fileName();
     translatedFile.write(jsonDoc.toJson());
     translatedFile.close();
 
@@ -217,14 +280,15 @@ QString ComponentInformationTranslation::translateJsonUsingTS(const QString &toT
 }
 
 QJsonObject ComponentInformationTranslation::translate(const QJsonObject& translationObj,
-                                                       const QHash<QString, QString>& translations, QJsonObject doc)
+                                                       const QHash<QString, QString>& translations, QJsonObject doc,
+                                                       const QAtomicInteger<bool>* cancel)
 {
     QJsonObject defs = translationObj["$defs"].toObject();
     if (translationObj.contains("items")) {
-        doc = translateItems("", defs, translationObj["items"].toObject(), translations, doc);
+        doc = translateItems("", defs, translationObj["items"].toObject(), translations, doc, cancel);
     }
     if (translationObj.contains("$ref")) {
-        doc = translateItems("", defs, defs[getRefName(translationObj["$ref"].toString())].toObject(), translations, doc);
+        doc = translateItems("", defs, defs[getRefName(translationObj["$ref"].toString())].toObject(), translations, doc, cancel);
     }
     return doc;
 }
@@ -232,9 +296,12 @@ QJsonObject ComponentInformationTranslation::translate(const QJsonObject& transl
 QJsonObject ComponentInformationTranslation::translateItems(const QString& prefix, const QJsonObject& defs,
                                                             const QJsonObject& translationObj,
                                                             const QHash<QString, QString>& translations,
-                                                            QJsonObject jsonData)
+                                                            QJsonObject jsonData, const QAtomicInteger<bool>* cancel)
 {
     for (auto translationItemIter = translationObj.begin(); translationItemIter != translationObj.end(); ++translationItemIter) {
+        if (isCancelled(cancel)) {
+            break;
+        }
         QStringList translationKeys;
         if (translationItemIter.key() == "*") {
             translationKeys = jsonData.keys();
@@ -245,7 +312,7 @@ QJsonObject ComponentInformationTranslation::translateItems(const QString& prefi
             QString nextPrefix = prefix + '/' + jsonItem;
             QJsonObject nextTranslationObj = translationItemIter.value().toObject();
             if (jsonData.contains(jsonItem)) {
-                jsonData[jsonItem] = translateTranslationItems(nextPrefix, defs, nextTranslationObj, translations, jsonData[jsonItem]);
+                jsonData[jsonItem] = translateTranslationItems(nextPrefix, defs, nextTranslationObj, translations, jsonData[jsonItem], cancel);
             }
         }
     }
@@ -261,7 +328,7 @@ QString ComponentInformationTranslation::getRefName(const QString& ref)
 QJsonValue ComponentInformationTranslation::translateTranslationItems(const QString& prefix, const QJsonObject& defs,
                                                                       const QJsonObject& translationObj,
                                                                       const QHash<QString, QString>& translations,
-                                                                      QJsonValue jsonData)
+                                                                      QJsonValue jsonData, const QAtomicInteger<bool>* cancel)
 {
     if (translationObj.contains("list")) {
         QJsonObject translationList = translationObj["list"].toObject();
@@ -275,7 +342,7 @@ QJsonValue ComponentInformationTranslation::translateTranslationItems(const QStr
             } else {
                 value = QString::number(idx);
             }
-            array[idx] = translateTranslationItems(prefix + '/' + value, defs, translationList, translations, listEntry);
+            array[idx] = translateTranslationItems(prefix + '/' + value, defs, translationList, translations, listEntry, cancel);
             ++idx;
         }
         jsonData = array;
@@ -335,10 +402,10 @@ QJsonValue ComponentInformationTranslation::translateTranslationItems(const QStr
         }
     }
     if (translationObj.contains("items")) {
-        jsonData = translateItems(prefix, defs, translationObj["items"].toObject(), translations, jsonData.toObject());
+        jsonData = translateItems(prefix, defs, translationObj["items"].toObject(), translations, jsonData.toObject(), cancel);
     }
     if (translationObj.contains("$ref")) {
-        jsonData = translateTranslationItems(prefix, defs, defs[getRefName(translationObj["$ref"].toString())].toObject(), translations, jsonData);
+        jsonData = translateTranslationItems(prefix, defs, defs[getRefName(translationObj["$ref"].toString())].toObject(), translations, jsonData, cancel);
     }
     return jsonData;
 }
@@ -9,9 +9,12 @@
 
 #pragma once
 
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonObject>
 #include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QPair>
 #include <QtCore/QString>
 #include <QtCore/QLoggingCategory>
 
@@ -25,8 +28,9 @@ class ComponentInformationTranslation : public QObject
     
 public:
     ComponentInformationTranslation(QObject* parent, QGCCachedFileDownload* cachedFileDownload);
+    ~ComponentInformationTranslation();
 
-    /// Download translation file according to the currently set locale and translate the json file.
+    /// Download translation file according to the currently set locale and translate the json file on a worker thread.
     /// emits downloadComplete() when done (with a temporary file that should be deleted)
     ///     @param summaryJsonFile json file with url's to translation files (.ts)
     ///     @param toTranslateJsonFile json file to be translated
@@ -34,24 +38,43 @@ public:
     /// @return true: Asynchronous download has started, false: Download initialization failed
     bool downloadAndTranslate(const QString& summaryJsonFile, const QString& toTranslateJsonFile, int maxCacheAgeSec);
 
-    QString translateJsonUsingTS(const QString& toTranslateJsonFile, const QString& tsFile);
+    /// Stops the download or translation in progress, downloadComplete() is not emitted for it
+    void cancel();
+
+    /// Locale translations are downloaded for
+    static QString locale();
+
+    /// Translates the json file into a new temporary file. Thread-safe.
+    ///     @param cancel Checked while translating, translation stops once it is set
+    /// @return Translated file, empty on error or if cancelled
+    static QString translateJsonUsingTS(const QString& toTranslateJsonFile, const QString& tsFile, const QAtomicInteger<bool>* cancel = nullptr);
 
 signals:
     void downloadComplete(QString translatedJsonTempFile, QString errorMsg);
 
 private slots:
     void onDownloadCompleted(QString remoteFile, QString localFile, QString errorMsg);
+    void onTranslateFinished();
 private:
+    typedef QPair<QString, QString> TranslateResult_t;   ///< Translated json file, error message
+
     QString getUrlFromSummaryJson(const QString& summaryJsonFile, const QString& locale);
 
-    static QJsonObject translate(const QJsonObject& translationObj, const QHash<QString, QString>& translations, QJsonObject doc);
+    static TranslateResult_t translateWorker(const QString& remoteFile, const QString& localFile, const QString& toTranslateJsonFile,
+                                             const QAtomicInteger<bool>* cancel);
+
+    static QJsonObject translate(const QJsonObject& translationObj, const QHash<QString, QString>& translations, QJsonObject doc,
+                                 const QAtomicInteger<bool>* cancel);
 
     static QJsonObject translateItems(const QString& prefix, const QJsonObject& defs, const QJsonObject& translationObj,
-                                      const QHash<QString, QString>& translations, QJsonObject jsonData);
+                                      const QHash<QString, QString>& translations, QJsonObject jsonData, const QAtomicInteger<bool>* cancel);
     static QJsonValue translateTranslationItems(const QString& prefix, const QJsonObject& defs, const QJsonObject& translationObj,
-                                                const QHash<QString, QString>& translations, QJsonValue jsonData);
+                                                const QHash<QString, QString>& translations, QJsonValue jsonData, const QAtomicInteger<bool>* cancel);
     static QString getRefName(const QString& ref);
+    static bool isCancelled(const QAtomicInteger<bool>* cancel) { return cancel && cancel->loadRelaxed(); }
 
     QGCCachedFileDownload* _cachedFileDownload = nullptr;
     QString _toTranslateJsonFile;
+    QFutureWatcher<TranslateResult_t> _translateWatcher;
+    QAtomicInteger<bool> _cancel = false;   ///< Set to stop the translation running on the worker thread
 };
@@ -23,206 +23,354 @@ FTPManager::FTPManager(Vehicle* vehicle)
     , _vehicle  (vehicle)
 {
     _ackOrNakTimeoutTimer.setSingleShot(true);
-    // Mock link responds immediately if at all, speed up unit tests with faster timoue
-    _ackOrNakTimeoutTimer.setInterval(qgcApp()->runningUnitTests() ? 10 : _ackOrNakTimeoutMsecs);
     connect(&_ackOrNakTimeoutTimer, &QTimer::timeout, this, &FTPManager::_ackOrNakTimeout);
     
     // Make sure we don't have bad structure packing
     Q_ASSERT(sizeof(MavlinkFTP::RequestHeader) == 12);
 }
 
-bool FTPManager::download(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName, bool checksize)
+FTPManager::~FTPManager()
 {
-    qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir << "fromCompId:" << fromCompId;
+    qDeleteAll(_operations);
+    qDeleteAll(_queuedOperations);
+}
 
-    if (!_rgStateMachine.isEmpty()) {
-        qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
-        return false;
-    }
+QString FTPManager::download(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName, bool checksize)
+{
+    qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir << "fromCompId:" << fromCompId;
 
     static const StateFunctions_t rgDownloadStateMachine[] = {
         { &FTPManager::_openFileROBegin,            &FTPManager::_openFileROAckOrNak,           &FTPManager::_openFileROTimeout },
         { &FTPManager::_burstReadFileBegin,         &FTPManager::_burstReadFileAckOrNak,        &FTPManager::_burstReadFileTimeout },
         { &FTPManager::_fillMissingBlocksBegin,     &FTPManager::_fillMissingBlocksAckOrNak,    &FTPManager::_fillMissingBlocksTimeout },
-        { &FTPManager::_resetSessionsBegin,         &FTPManager::_resetSessionsAckOrNak,        &FTPManager::_resetSessionsTimeout },
+        { &FTPManager::_closeSessionBegin,          &FTPManager::_closeSessionAckOrNak,         &FTPManager::_closeSessionTimeout },
         { &FTPManager::_downloadCompleteNoError,    nullptr,                                    nullptr },
     };
+
+    Operation_t* op = new Operation_t;
     for (size_t i=0; i<sizeof(rgDownloadStateMachine)/sizeof(rgDownloadStateMachine[0]); i++) {
-        _rgStateMachine.append(rgDownloadStateMachine[i]);
+        op->rgStateMachine.append(rgDownloadStateMachine[i]);
     }
 
-    _downloadState.reset();
-    _downloadState.toDir.setPath(toDir);
-    _downloadState.checksize = checksize;
+    DownloadState_t& downloadState = op->downloadState;
+    downloadState.toDir.setPath(toDir);
+    downloadState.checksize = checksize;
 
-    if (!_parseURI(fromCompId, fromURI, _downloadState.fullPathOnVehicle, _ftpCompId)) {
+    if (!_parseURI(fromCompId, fromURI, downloadState.fullPathOnVehicle, op->compId)) {
         qCWarning(FTPManagerLog) << "_parseURI failed";
-        return false;
+        delete op;
+        return QString();
     }
 
     // We need to strip off the file name from the fully qualified path. We can't use the usual QDir
     // routines because this path does not exist locally.
     int lastDirSlashIndex;
-    for (lastDirSlashIndex=_downloadState.fullPathOnVehicle.size()-1; lastDirSlashIndex>=0; lastDirSlashIndex--) {
-        if (_downloadState.fullPathOnVehicle[lastDirSlashIndex] == '/') {
+    for (lastDirSlashIndex=downloadState.fullPathOnVehicle.size()-1; lastDirSlashIndex>=0; lastDirSlashIndex--) {
+        if (downloadState.fullPathOnVehicle[lastDirSlashIndex] == '/') {
             break;
         }
     }
     lastDirSlashIndex++; // move past slash
 
     if (fileName.isEmpty()) {
-        _downloadState.fileName = _downloadState.fullPathOnVehicle.right(_downloadState.fullPathOnVehicle.size() - lastDirSlashIndex);
+        downloadState.fileName = downloadState.fullPathOnVehicle.right(downloadState.fullPathOnVehicle.size() - lastDirSlashIndex);
     } else {
-        _downloadState.fileName = fileName;
+        downloadState.fileName = fileName;
+    }
+
+    const QString filePath = downloadState.filePath();
+    for (const QList<Operation_t*>* rgOperations: { &_operations, &_queuedOperations }) {
+        for (const Operation_t* otherOp: *rgOperations) {
+            if (!otherOp->listDirectory && otherOp->downloadState.filePath() == filePath) {
+                qCDebug(FTPManagerLog) << "Cannot download. Already downloading to" << filePath;
+                delete op;
+                return QString();
+            }
+        }
     }
 
-    qCDebug(FTPManagerLog) << "_downloadState.fullPathOnVehicle:_downloadState.fileName" << _downloadState.fullPathOnVehicle << _downloadState.fileName;
+    qCDebug(FTPManagerLog) << "downloadState.fullPathOnVehicle:downloadState.fileName" << downloadState.fullPathOnVehicle << downloadState.fileName;
 
-    _startStateMachine();
+    _queueOperation(op);
 
-    return true;
+    return filePath;
 }
 
 bool FTPManager::listDirectory(uint8_t fromCompId, const QString& fromURI)
 {
     qCDebug(FTPManagerLog) << "list directory fromURI:" << fromURI << "fromCompId:" << fromCompId;
 
-    if (!_rgStateMachine.isEmpty()) {
-        qCDebug(FTPManagerLog) << "Cannot list directory. Already in another operation";
-        return false;
-    }
-
     static const StateFunctions_t rgStateMachine[] = {
         { &FTPManager::_listDirectoryBegin,             &FTPManager::_listDirectoryAckOrNak,        &FTPManager::_listDirectoryTimeout },
         { &FTPManager::_listDirectoryCompleteNoError,   nullptr,                                    nullptr },
     };
+
+    Operation_t* op = new Operation_t;
+    op->listDirectory = true;
     for (size_t i=0; i<sizeof(rgStateMachine)/sizeof(rgStateMachine[0]); i++) {
-        _rgStateMachine.append(rgStateMachine[i]);
+        op->rgStateMachine.append(rgStateMachine[i]);
     }
 
-    _listDirectoryState.reset();
-
-    if (!_parseURI(fromCompId, fromURI, _listDirectoryState.fullPathOnVehicle, _ftpCompId)) {
+    if (!_parseURI(fromCompId, fromURI, op->listDirectoryState.fullPathOnVehicle, op->compId)) {
         qCWarning(FTPManagerLog) << "_parseURI failed";
+        delete op;
         return false;
     }
 
-    qCDebug(FTPManagerLog) << "_listDirectoryState.fullPathOnVehicle" << _listDirectoryState.fullPathOnVehicle;
+    qCDebug(FTPManagerLog) << "listDirectoryState.fullPathOnVehicle" << op->listDirectoryState.fullPathOnVehicle;
 
-    _startStateMachine();
+    _queueOperation(op);
 
     return true;
 }
 
-void FTPManager::cancelDownload()
+void FTPManager::cancelDownload(const QString& file)
 {
-    if (!_downloadState.inProgress()) {
-        return;
+    for (Operation_t* op: _queuedOperations) {
+        if (!op->listDirectory && op->downloadState.filePath() == file) {
+            // Nothing was sent for it yet
+            _queuedOperations.removeOne(op);
+            _downloadComplete(op, "Aborted");
+            return;
+        }
     }
 
-    _ackOrNakTimeoutTimer.stop();
-    _rgStateMachine.clear();
-    static const StateFunctions_t rgTerminateStateMachine[] = {
-        { &FTPManager::_terminateSessionBegin,  &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
-        { &FTPManager::_terminateComplete,      nullptr,                                    nullptr },
-    };
-    for (size_t i=0; i<sizeof(rgTerminateStateMachine)/sizeof(rgTerminateStateMachine[0]); i++) {
-        _rgStateMachine.append(rgTerminateStateMachine[i]);
+    for (Operation_t* op: _operations) {
+        if (op->listDirectory || op->downloadState.filePath() != file || op->cancelRequested) {
+            continue;
+        }
+
+        op->cancelRequested = true;
+        if (!op->downloadState.sessionOpen) {
+            // The session is terminated as soon as the open ack tells its id
+            return;
+        }
+
+        _stopAckOrNakTimeout(op);
+        op->rgStateMachine.clear();
+        static const StateFunctions_t rgTerminateStateMachine[] = {
+            { &FTPManager::_terminateSessionBegin,  &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
+            { &FTPManager::_terminateComplete,      nullptr,                                    nullptr },
+        };
+        for (size_t i=0; i<sizeof(rgTerminateStateMachine)/sizeof(rgTerminateStateMachine[0]); i++) {
+            op->rgStateMachine.append(rgTerminateStateMachine[i]);
+        }
+        op->downloadState.retryCount = 0;
+        _startStateMachine(op);
+        return;
     }
-    _downloadState.retryCount = 0;
-    _startStateMachine();
 }
 
-void FTPManager::_terminateSessionBegin(void)
+void FTPManager::_terminateSessionBegin(Operation_t* op)
 {
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = op->downloadState.sessionId;
     request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
-    _sendRequestExpectAck(&request);
+    _sendRequestExpectAck(op, &request);
 }
 
-void FTPManager::_terminateSessionAckOrNak(const MavlinkFTP::Request *ackOrNak)
+void FTPManager::_terminateSessionAckOrNak(Operation_t* op, const MavlinkFTP::Request *ackOrNak)
 {
     MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
     if (requestOpCode != MavlinkFTP::kCmdTerminateSession) {
         qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Ack disregarding ack for incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+    if (ackOrNak->hdr.seqNumber != op->expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << op->expectedIncomingSeqNumber;
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
-    _advanceStateMachine();
+    _stopAckOrNakTimeout(op);
+    op->downloadState.sessionOpen = false;
+    _advanceStateMachine(op);
 }
 
-void FTPManager::_terminateSessionTimeout(void)
+void FTPManager::_terminateSessionTimeout(Operation_t* op)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
+    if (++op->downloadState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _downloadComplete(op, tr("Download failed"));
     } else {
         // Try again
-        qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
-        _terminateSessionBegin();
+        qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout: retrying - retryCount(%1)").arg(op->downloadState.retryCount);
+        _terminateSessionBegin(op);
     }
 
 }
 
-void FTPManager::_terminateComplete(void)
+void FTPManager::_terminateComplete(Operation_t* op)
 {
-    _downloadComplete("Aborted");
+    _downloadComplete(op, "Aborted");
 }
 
 /// Closes out a download session by writing the file and doing cleanup.
 ///     @param errorMsg Error message, empty if no error
-void FTPManager::_downloadComplete(const QString& errorMsg)
+void FTPManager::_downloadComplete(Operation_t* op, const QString& errorMsg)
 {
     qCDebug(FTPManagerLog) << QString("_downloadComplete: errorMsg(%1)").arg(errorMsg);
     
-    QString downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
-    QString error               = errorMsg;
-
-    _ackOrNakTimeoutTimer.stop();
-    _rgStateMachine.clear();
-    _currentStateMachineIndex = -1;
-    if (_downloadState.file.isOpen()) {
-        _downloadState.file.close();
+    QString downloadFilePath    = op->downloadState.filePath();
+
+    if (op->downloadState.sessionOpen) {
+        // Don't leave the session open on the vehicle, nobody waits for the answer
+        MavlinkFTP::Request request{};
+        request.hdr.session = op->downloadState.sessionId;
+        request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
+        _sendRequest(op, &request);
+        op->downloadState.sessionOpen = false;
+    }
+
+    if (op->downloadState.file.isOpen()) {
+        op->downloadState.file.close();
         if (!errorMsg.isEmpty()) {
-            _downloadState.file.remove();
+            op->downloadState.file.remove();
         }
     }
 
+    _finishOperation(op);
+
     emit downloadComplete(downloadFilePath, errorMsg);
 }
 
 /// Closes out a list directory sequence
 ///     @param errorMsg Error message, empty if no error
-void FTPManager::_listDirectoryComplete(const QString& errorMsg)
+void FTPManager::_listDirectoryComplete(Operation_t* op, const QString& errorMsg)
 {
     qCDebug(FTPManagerLog) << QString("_listDirectoryComplete: errorMsg(%1)").arg(errorMsg);
     
-    _ackOrNakTimeoutTimer.stop();
-    _rgStateMachine.clear();
-    _currentStateMachineIndex = -1;
-
-    QStringList rgDirectoryList = _listDirectoryState.rgDirectoryList;
+    QStringList rgDirectoryList = op->listDirectoryState.rgDirectoryList;
     if (!errorMsg.isEmpty()) {
         rgDirectoryList.clear();
     }
 
+    _finishOperation(op);
+
     emit listDirectoryComplete(rgDirectoryList, errorMsg);
 }
 
-void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
+/// Removes the operation and deletes it. Callers must not touch the operation afterwards.
+void FTPManager::_finishOperation(Operation_t* op)
 {
-    if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL ||
-            message.sysid != _vehicle->id() || message.compid != _ftpCompId) {
-        return;
+    _operations.removeOne(op);
+    _queuedOperations.removeOne(op);
+    delete op;
+
+    _rescheduleAckOrNakTimeout();
+    (void) QMetaObject::invokeMethod(this, &FTPManager::_startQueuedOperations, Qt::QueuedConnection);
+}
+
+void FTPManager::_queueOperation(Operation_t* op)
+{
+    _queuedOperations.append(op);
+
+    // Started from the event loop, so a caller can connect to the signals after the call
+    (void) QMetaObject::invokeMethod(this, &FTPManager::_startQueuedOperations, Qt::QueuedConnection);
+}
+
+void FTPManager::_startQueuedOperations(void)
+{
+    int i = 0;
+    while (i < _queuedOperations.count()) {
+        Operation_t* op = _queuedOperations[i];
+        if (!_canStartOperation(op->compId)) {
+            i++;
+            continue;
+        }
+
+        _queuedOperations.removeAt(i);
+        _operations.append(op);
+
+        // Keep the sequence numbers of parallel sessions apart, the vehicle resends its last reply for a repeated number
+        op->expectedIncomingSeqNumber = _nextSeqNumberBase;
+        _nextSeqNumberBase += _seqNumberSpacing;
+
+        qCDebug(FTPManagerLog) << "_startQueuedOperations: compId:operations:queued" << op->compId << _operations.count() << _queuedOperations.count();
+
+        // Opens and directory listings run one at a time per component, the next operation for the component waits
+        // until this one is past them
+        _startStateMachine(op);
+    }
+}
+
+bool FTPManager::_canStartOperation(uint8_t compId) const
+{
+    int cActive = 0;
+    for (const Operation_t* op: _operations) {
+        if (op->compId == compId) {
+            if (_isExclusiveState(op)) {
+                return false;
+            }
+            cActive++;
+        }
+    }
+
+    // ArduPilot closes the open session when it is asked to open another one while PX4 answers with kErrNoSessionsAvailable
+    const int maxSessions = _maxSessions.value(compId, _vehicle->px4Firmware() ? _maxSessionsPX4 : 1);
+
+    return cActive < maxSessions;
+}
+
+/// @return true: Replies for the current state can not be told apart by session id
+bool FTPManager::_isExclusiveState(const Operation_t* op) const
+{
+    const StateBeginFn beginFn = _currentBeginFn(op);
+
+    return (beginFn == &FTPManager::_openFileROBegin) ||
+           (beginFn == &FTPManager::_listDirectoryBegin) ||
+           ((beginFn == &FTPManager::_closeSessionBegin) && op->downloadState.resetSessions);
+}
+
+FTPManager::StateBeginFn FTPManager::_currentBeginFn(const Operation_t* op) const
+{
+    if (op->currentStateMachineIndex < 0 || op->currentStateMachineIndex >= op->rgStateMachine.count()) {
+        return nullptr;
+    }
+
+    return op->rgStateMachine[op->currentStateMachineIndex].beginFn;
+}
+
+FTPManager::Operation_t* FTPManager::_operationForReply(uint8_t compId, const MavlinkFTP::Request* ackOrNak) const
+{
+    const MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+
+    for (Operation_t* op: _operations) {
+        if (op->compId != compId) {
+            continue;
+        }
+
+        const StateBeginFn beginFn = _currentBeginFn(op);
+        switch (requestOpCode) {
+        case MavlinkFTP::kCmdOpenFileRO:
+            if (beginFn == &FTPManager::_openFileROBegin) {
+                return op;
+            }
+            break;
+        case MavlinkFTP::kCmdListDirectory:
+            if (beginFn == &FTPManager::_listDirectoryBegin) {
+                return op;
+            }
+            break;
+        case MavlinkFTP::kCmdResetSessions:
+            if (beginFn == &FTPManager::_closeSessionBegin && op->downloadState.resetSessions) {
+                return op;
+            }
+            break;
+        default:
+            if (!op->listDirectory && op->downloadState.sessionOpen && op->downloadState.sessionId == ackOrNak->hdr.session) {
+                return op;
+            }
+            break;
+        }
     }
 
-    if (_currentStateMachineIndex == -1) {
+    return nullptr;
+}
+
+void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
+{
+    if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL ||
+            message.sysid != _vehicle->id() || _operations.isEmpty()) {
         return;
     }
 
@@ -237,10 +385,20 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
     
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&data.payload[0];
 
-    // Ignore old/reordered packets (handle wrap-around properly)
+    Operation_t* op = _operationForReply(message.compid, request);
+    if (!op) {
+        qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: No operation for reply hdr.opcode:hdr.req_opcode:session"
+                               << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode))
+                               << request->hdr.session;
+        return;
+    }
+
+    // Ignore old/reordered packets (handle wrap-around properly). Reads for missing data are matched by offset
+    // instead, several of them are in flight.
     uint16_t actualIncomingSeqNumber = request->hdr.seqNumber;
-    if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
-        qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: Received old packet seqNum expected:actual" << _expectedIncomingSeqNumber << actualIncomingSeqNumber
+    if ((_currentBeginFn(op) != &FTPManager::_fillMissingBlocksBegin) &&
+            (uint16_t)((op->expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+        qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: Received old packet seqNum expected:actual" << op->expectedIncomingSeqNumber << actualIncomingSeqNumber
                                << "hdr.opcode:hdr.req_opcode" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode));
 
         return;
@@ -250,24 +408,93 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
                            << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode))
                            << request->hdr.seqNumber;
 
-    (this->*_rgStateMachine[_currentStateMachineIndex].ackNakFn)(request);
+    (this->*op->rgStateMachine[op->currentStateMachineIndex].ackNakFn)(op, request);
 }
 
-void FTPManager::_startStateMachine(void)
+void FTPManager::_startStateMachine(Operation_t* op)
 {
-    _currentStateMachineIndex = -1;
-    _advanceStateMachine();
+    op->currentStateMachineIndex = -1;
+    _advanceStateMachine(op);
 }
 
-void FTPManager::_advanceStateMachine(void)
+void FTPManager::_advanceStateMachine(Operation_t* op)
 {
-    _currentStateMachineIndex++;
-    (this->*_rgStateMachine[_currentStateMachineIndex].beginFn)();
+    op->currentStateMachineIndex++;
+    (this->*op->rgStateMachine[op->currentStateMachineIndex].beginFn)(op);
 }
 
 void FTPManager::_ackOrNakTimeout(void)
 {
-    (this->*_rgStateMachine[_currentStateMachineIndex].timeoutFn)();
+    // Timeout handlers may finish any operation
+    const QList<Operation_t*> rgOperations = _operations;
+    for (Operation_t* op: rgOperations) {
+        if (_operations.contains(op) && !op->ackOrNakDeadline.isForever() && op->ackOrNakDeadline.hasExpired()) {
+            op->ackOrNakDeadline = QDeadlineTimer(QDeadlineTimer::Forever);
+            (this->*op->rgStateMachine[op->currentStateMachineIndex].timeoutFn)(op);
+        }
+    }
+
+    _rescheduleAckOrNakTimeout();
+}
+
+void FTPManager::_startAckOrNakTimeout(Operation_t* op)
+{
+    op->ackOrNakDeadline.setRemainingTime(_ackOrNakTimeoutMsecs(op->compId));
+    _rescheduleAckOrNakTimeout();
+}
+
+void FTPManager::_stopAckOrNakTimeout(Operation_t* op)
+{
+    op->ackOrNakDeadline = QDeadlineTimer(QDeadlineTimer::Forever);
+    _rescheduleAckOrNakTimeout();
+}
+
+void FTPManager::_rescheduleAckOrNakTimeout(void)
+{
+    qint64 remainingMsecs = -1;
+    for (const Operation_t* op: _operations) {
+        if (!op->ackOrNakDeadline.isForever()) {
+            const qint64 opRemainingMsecs = op->ackOrNakDeadline.remainingTime();
+            if (remainingMsecs < 0 || opRemainingMsecs < remainingMsecs) {
+                remainingMsecs = opRemainingMsecs;
+            }
+        }
+    }
+
+    if (remainingMsecs < 0) {
+        _ackOrNakTimeoutTimer.stop();
+    } else {
+        _ackOrNakTimeoutTimer.start(static_cast<int>(remainingMsecs));
+    }
+}
+
+/// Updates the round trip estimate from the reply to the last request
+void FTPManager::_updateRoundTripTime(Operation_t* op)
+{
+    if (!op->requestTimer.isValid()) {
+        return;
+    }
+
+    const int sampleMsecs = static_cast<int>(op->requestTimer.elapsed());
+    const int roundTripMsecs = _roundTripMsecs.value(op->compId, -1);
+    _roundTripMsecs[op->compId] = (roundTripMsecs < 0) ? sampleMsecs : ((7 * roundTripMsecs) + sampleMsecs) / 8;
+}
+
+int FTPManager::_ackOrNakTimeoutMsecs(uint8_t compId) const
+{
+    if (qgcApp()->runningUnitTests()) {
+        // Mock link responds immediately if at all, speed up unit tests with faster timeout
+        return 10;
+    }
+
+    // While the link is backed up requests sit in its write queue, retrying early would only queue more of them
+    const SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    const int roundTripMsecs = _roundTripMsecs.value(compId, -1);
+    if ((roundTripMsecs < 0) || (sharedLink && sharedLink->writeBackpressure())) {
+        return _ackOrNakTimeoutMsecsMax;
+    }
+
+    return qBound(_ackOrNakTimeoutMsecsMin, _roundTripTimeoutFactor * roundTripMsecs, _ackOrNakTimeoutMsecsMax);
 }
 
 void FTPManager::_fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str)
@@ -293,449 +520,551 @@ QString FTPManager::_errorMsgFromNak(const MavlinkFTP::Request* nak)
     return errorMsg;
 }
 
-void FTPManager::_openFileROBegin(void)
+void FTPManager::_openFileROBegin(Operation_t* op)
 {
     MavlinkFTP::Request request{};
     request.hdr.session = 0;
     request.hdr.opcode  = MavlinkFTP::kCmdOpenFileRO;
     request.hdr.offset  = 0;
     request.hdr.size    = 0;
-    _fillRequestDataWithString(&request, _downloadState.fullPathOnVehicle);
-    _sendRequestExpectAck(&request);
+    _fillRequestDataWithString(&request, op->downloadState.fullPathOnVehicle);
+    _sendRequestExpectAck(op, &request);
 }
 
-void FTPManager::_openFileROTimeout(void)
+void FTPManager::_openFileROTimeout(Operation_t* op)
 {
     qCDebug(FTPManagerLog) << "_openFileROTimeout";
-    _downloadComplete(tr("Download failed"));
+    _downloadComplete(op, tr("Download failed"));
 }
 
-void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
+void FTPManager::_openFileROAckOrNak(Operation_t* op, const MavlinkFTP::Request* ackOrNak)
 {
     MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
     if (requestOpCode != MavlinkFTP::kCmdOpenFileRO) {
         qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack disregarding ack for incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+    if (ackOrNak->hdr.seqNumber != op->expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << op->expectedIncomingSeqNumber;
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    _stopAckOrNakTimeout(op);
+    _updateRoundTripTime(op);
+
+    DownloadState_t& downloadState = op->downloadState;
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
         qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack  - sessionId:openFileLength" << ackOrNak->hdr.session << ackOrNak->openFileLength;
 
         if (ackOrNak->hdr.size != sizeof(uint32_t)) {
             qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack ack->hdr.size != sizeof(uint32_t)" << ackOrNak->hdr.size << sizeof(uint32_t);
-            _downloadComplete(tr("Download failed"));
+            _downloadComplete(op, tr("Download failed"));
             return;
         }
 
-        _downloadState.sessionId        = ackOrNak->hdr.session;
-        _downloadState.fileSize         = ackOrNak->openFileLength;
-        _downloadState.expectedOffset   = 0;
+        downloadState.sessionId        = ackOrNak->hdr.session;
+        downloadState.sessionOpen      = true;
+        downloadState.fileSize         = ackOrNak->openFileLength;
+        downloadState.expectedOffset   = 0;
+
+        // The next operation for the component can open its file now
+        (void) QMetaObject::invokeMethod(this, &FTPManager::_startQueuedOperations, Qt::QueuedConnection);
+
+        if (op->cancelRequested) {
+            // Canceled while the file was being opened
+            op->cancelRequested = false;
+            cancelDownload(downloadState.filePath());
+            return;
+        }
 
-        _downloadState.file.setFileName(_downloadState.toDir.filePath(_downloadState.fileName));
-        if (_downloadState.file.open(QFile::WriteOnly | QFile::Truncate)) {
-            _advanceStateMachine();
+        downloadState.file.setFileName(downloadState.filePath());
+        if (downloadState.file.open(QFile::WriteOnly | QFile::Truncate)) {
+            _advanceStateMachine(op);
         } else {
-            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _downloadState.file open failed" << _downloadState.file.errorString();
-            _downloadComplete(tr("Download failed"));
+            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack downloadState.file open failed" << downloadState.file.errorString();
+            _downloadComplete(op, tr("Download failed"));
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+
+        if (errorCode == MavlinkFTP::kErrNoSessionsAvailable && !op->cancelRequested) {
+            int cOtherOperations = 0;
+            for (const Operation_t* otherOp: _operations) {
+                if (otherOp != op && otherOp->compId == op->compId) {
+                    cOtherOperations++;
+                }
+            }
+
+            if (cOtherOperations > 0) {
+                // The component has fewer sessions than we thought, wait for one of the others to finish
+                qCDebug(FTPManagerLog) << "_openFileROAckOrNak: No sessions available, compId:maxSessions" << op->compId << cOtherOperations;
+                _maxSessions[op->compId] = cOtherOperations;
+                _operations.removeOne(op);
+                op->currentStateMachineIndex = -1;
+                _queuedOperations.prepend(op);
+                (void) QMetaObject::invokeMethod(this, &FTPManager::_startQueuedOperations, Qt::QueuedConnection);
+                return;
+            }
+        }
+
         qCDebug(FTPManagerLog) << "_handlOpenFileROAck: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(tr("Download failed") + ": " + _errorMsgFromNak(ackOrNak));
+        _downloadComplete(op, tr("Download failed") + ": " + _errorMsgFromNak(ackOrNak));
     }
 }
 
-void FTPManager::_burstReadFileWorker(bool firstRequest)
+void FTPManager::_burstReadFileWorker(Operation_t* op, bool firstRequest)
 {
-    qCDebug(FTPManagerLog) << "_burstReadFileWorker: starting burst at offset:firstRequest:retryCount" << _downloadState.expectedOffset << firstRequest << _downloadState.retryCount;
+    DownloadState_t& downloadState = op->downloadState;
+
+    qCDebug(FTPManagerLog) << "_burstReadFileWorker: starting burst at offset:firstRequest:retryCount" << downloadState.expectedOffset << firstRequest << downloadState.retryCount;
 
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = downloadState.sessionId;
     request.hdr.opcode  = MavlinkFTP::kCmdBurstReadFile;
-    request.hdr.offset  = _downloadState.expectedOffset;
+    request.hdr.offset  = downloadState.expectedOffset;
     request.hdr.size    = sizeof(request.data);
 
     if (firstRequest) {
-        _downloadState.retryCount = 0;
+        downloadState.retryCount = 0;
     } else {
         // Must used same sequence number as previous request
-        _expectedIncomingSeqNumber -= 2;
+        op->expectedIncomingSeqNumber -= 2;
     }
 
-    _sendRequestExpectAck(&request);
+    _sendRequestExpectAck(op, &request);
 }
 
-void FTPManager::_burstReadFileBegin(void)
+void FTPManager::_burstReadFileBegin(Operation_t* op)
 {
-    _burstReadFileWorker(true /* firstRequestr */);
+    _burstReadFileWorker(op, true /* firstRequestr */);
 }
 
-void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+void FTPManager::_burstReadFileAckOrNak(Operation_t* op, const MavlinkFTP::Request* ackOrNak)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    DownloadState_t&        downloadState = op->downloadState;
+    MavlinkFTP::OpCode_t    requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
 
     if (requestOpCode != MavlinkFTP::kCmdBurstReadFile) {
         qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.session != _downloadState.sessionId) {
-        qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
+    if (ackOrNak->hdr.session != downloadState.sessionId) {
+        qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << downloadState.sessionId;
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    _stopAckOrNakTimeout(op);
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        if (ackOrNak->hdr.seqNumber < _expectedIncomingSeqNumber) {
-            qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding Ack due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        if (ackOrNak->hdr.seqNumber < op->expectedIncomingSeqNumber) {
+            qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding Ack due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << op->expectedIncomingSeqNumber;
             return;
         }
 
         qCDebug(FTPManagerLog) << QString("_burstReadFileAckOrNak: Ack offset(%1) size(%2) burstComplete(%3)").arg(ackOrNak->hdr.offset).arg(ackOrNak->hdr.size).arg(ackOrNak->hdr.burstComplete);
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (ackOrNak->hdr.offset > _downloadState.expectedOffset) {
+        if (ackOrNak->hdr.offset != downloadState.expectedOffset) {
+            if (ackOrNak->hdr.offset > downloadState.expectedOffset) {
                 // There is a hole in our data, record it as missing and continue on
                 MissingData_t missingData;
-                missingData.offset          = _downloadState.expectedOffset;
-                missingData.cBytesMissing   = ackOrNak->hdr.offset - _downloadState.expectedOffset;
-                _downloadState.rgMissingData.append(missingData);
+                missingData.offset          = downloadState.expectedOffset;
+                missingData.cBytesMissing   = ackOrNak->hdr.offset - downloadState.expectedOffset;
+                downloadState.rgMissingData.append(missingData);
                 qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: adding missing data offset:cBytesMissing" << missingData.offset << missingData.cBytesMissing;
             } else {
                 // Offset is past what we have already seen, disregard and wait for something usefule
-                _ackOrNakTimeoutTimer.start();
-                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: received offset less than expected offset received:expected" << ackOrNak->hdr.offset << _downloadState.expectedOffset;
+                _startAckOrNakTimeout(op);
+                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: received offset less than expected offset received:expected" << ackOrNak->hdr.offset << downloadState.expectedOffset;
                 return;
             }
         }
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
+        downloadState.file.seek(ackOrNak->hdr.offset);
+        int bytesWritten = downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
         if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
+            _downloadComplete(op, tr("Download failed: Error saving file"));
             return;
         }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
-        _downloadState.expectedOffset = ackOrNak->hdr.offset + ackOrNak->hdr.size;
+        downloadState.bytesWritten += ackOrNak->hdr.size;
+        downloadState.expectedOffset = ackOrNak->hdr.offset + ackOrNak->hdr.size;
 
         if (ackOrNak->hdr.burstComplete) {
             // The current burst is done, request next one in offset sequence
-            _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
-            _burstReadFileWorker(true /* firstRequest */);
+            op->expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
+            _burstReadFileWorker(op, true /* firstRequest */);
         } else {
             // Still within a burst, next ack should come automatically
-            _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber + 1;
-            _ackOrNakTimeoutTimer.start();
+            op->expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber + 1;
+            _startAckOrNakTimeout(op);
         }
 
         // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
+        if (downloadState.fileSize != 0) {
+            emit commandProgress(downloadState.filePath(), (float)(downloadState.bytesWritten) / (float)downloadState.fileSize);
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
         if (errorCode == MavlinkFTP::kErrEOF) {
             // Burst sequence has gone through the whole file
-            if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+            if (ackOrNak->hdr.seqNumber != op->expectedIncomingSeqNumber) {
                 qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: EOF Nak"
                     "with incorrect sequence nr actual:expected"
-                    << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+                    << ackOrNak->hdr.seqNumber << op->expectedIncomingSeqNumber;
                 /* We have received the EOF Nak but out of sequence, i.e. data is missing */
-                _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
-                _burstReadFileWorker(true); /* Retry from last expected offset */
+                op->expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
+                _burstReadFileWorker(op, true); /* Retry from last expected offset */
             } else {
                 qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak EOF";
-                _advanceStateMachine();
+                _advanceStateMachine(op);
             }
         } else { /* Don't care is this is out of sequence */
             qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-            _downloadComplete(tr("Download failed"));
+            _downloadComplete(op, tr("Download failed"));
         }
     }
 }
 
-void FTPManager::_burstReadFileTimeout(void)
+void FTPManager::_burstReadFileTimeout(Operation_t* op)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
+    if (++op->downloadState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _downloadComplete(op, tr("Download failed"));
     } else {
         // Try again
-        qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _burstReadFileWorker(false /* firstReqeust */);
+        qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout: retrying - retryCount(%1) offset(%2)").arg(op->downloadState.retryCount).arg(op->downloadState.expectedOffset);
+        _burstReadFileWorker(op, false /* firstReqeust */);
     }
 }
 
-void FTPManager::_listDirectoryWorker(bool firstRequest)
+void FTPManager::_listDirectoryWorker(Operation_t* op, bool firstRequest)
 {
-    qCDebug(FTPManagerLog) << "_listDirectoryWorker: offset:firstRequest:retryCount" << _listDirectoryState.expectedOffset << firstRequest << _listDirectoryState.retryCount;
+    ListDirectoryState_t& listDirectoryState = op->listDirectoryState;
+
+    qCDebug(FTPManagerLog) << "_listDirectoryWorker: offset:firstRequest:retryCount" << listDirectoryState.expectedOffset << firstRequest << listDirectoryState.retryCount;
 
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = 0;
     request.hdr.opcode  = MavlinkFTP::kCmdListDirectory;
-    request.hdr.offset  = _listDirectoryState.expectedOffset;
+    request.hdr.offset  = listDirectoryState.expectedOffset;
     request.hdr.size    = sizeof(request.data);
-    _fillRequestDataWithString(&request, _listDirectoryState.fullPathOnVehicle);
+    _fillRequestDataWithString(&request, listDirectoryState.fullPathOnVehicle);
     
     if (firstRequest) {
-        _listDirectoryState.retryCount = 0;
+        listDirectoryState.retryCount = 0;
     } else {
         // Must used same sequence number as previous request
-        _expectedIncomingSeqNumber -= 2;
+        op->expectedIncomingSeqNumber -= 2;
     }
 
-    _sendRequestExpectAck(&request);
+    _sendRequestExpectAck(op, &request);
 }
 
-void FTPManager::_listDirectoryBegin(void)
+void FTPManager::_listDirectoryBegin(Operation_t* op)
 {
-    _listDirectoryWorker(true /* firstRequest */);
+    _listDirectoryWorker(op, true /* firstRequest */);
 }
 
-void FTPManager::_listDirectoryAckOrNak(const MavlinkFTP::Request* ackOrNak)
+void FTPManager::_listDirectoryAckOrNak(Operation_t* op, const MavlinkFTP::Request* ackOrNak)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    ListDirectoryState_t&   listDirectoryState  = op->listDirectoryState;
+    MavlinkFTP::OpCode_t    requestOpCode       = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
 
     if (requestOpCode != MavlinkFTP::kCmdListDirectory) {
         qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    _stopAckOrNakTimeout(op);
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        if (ackOrNak->hdr.seqNumber < _expectedIncomingSeqNumber) {
-            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding Ack due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        if (ackOrNak->hdr.seqNumber < op->expectedIncomingSeqNumber) {
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding Ack due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << op->expectedIncomingSeqNumber;
             return;
         }
 
         qCDebug(FTPManagerLog) << QString("_listDirectoryAckOrNak: Ack size(%1)").arg(ackOrNak->hdr.size);
 
-        // Parse entries in ackOrNak->data into _listDirectoryState.rgDirectoryList
+        _updateRoundTripTime(op);
+
+        // Parse entries in ackOrNak->data into listDirectoryState.rgDirectoryList
         const char* curDataPtr = (const char*)ackOrNak->data;
         while (curDataPtr < (const char*)ackOrNak->data + ackOrNak->hdr.size) {
             QString dirEntry = curDataPtr;
             curDataPtr += dirEntry.size() + 1;
-            _listDirectoryState.rgDirectoryList.append(dirEntry);
-            _listDirectoryState.expectedOffset++;
+            listDirectoryState.rgDirectoryList.append(dirEntry);
+            listDirectoryState.expectedOffset++;
         }
 
         // Request next set of directory entries
-        _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
-        _listDirectoryWorker(true /* firstRequest */);
+        op->expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
+        _listDirectoryWorker(op, true /* firstRequest */);
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
         if (errorCode == MavlinkFTP::kErrEOF) {
             // All entries returned
-            if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-                qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding Nak due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-                _ackOrNakTimeoutTimer.start();
+            if (ackOrNak->hdr.seqNumber != op->expectedIncomingSeqNumber) {
+                qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding Nak due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << op->expectedIncomingSeqNumber;
+                _startAckOrNakTimeout(op);
                 return;
             } else {
                 qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak EOF";
-                _advanceStateMachine();
+                _advanceStateMachine(op);
             }
         } else { /* Don't care is this is out of sequence */
             qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-            _listDirectoryComplete(tr("List directory failed"));
+            _listDirectoryComplete(op, tr("List directory failed"));
         }
     }
 }
 
-void FTPManager::_listDirectoryTimeout(void)
+void FTPManager::_listDirectoryTimeout(Operation_t* op)
 {
-    if (++_listDirectoryState.retryCount > _maxRetry) {
+    ListDirectoryState_t& listDirectoryState = op->listDirectoryState;
+
+    if (++listDirectoryState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout retries exceeded");
-        _listDirectoryComplete(tr("List directory failed"));
+        _listDirectoryComplete(op, tr("List directory failed"));
     } else {
         // Try again
-        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout: retrying - retryCount(%1) offset(%2)").arg(_listDirectoryState.retryCount).arg(_listDirectoryState.expectedOffset);
-        _listDirectoryWorker(false /* firstReqeust */);
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout: retrying - retryCount(%1) offset(%2)").arg(listDirectoryState.retryCount).arg(listDirectoryState.expectedOffset);
+        _listDirectoryWorker(op, false /* firstReqeust */);
     }
 }
 
-void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
+/// Keeps a window of read requests for the missing data in flight. Replies are matched to the requests by offset.
+void FTPManager::_fillMissingBlocksWorker(Operation_t* op)
 {
-    if (_downloadState.rgMissingData.count()) {
+    DownloadState_t& downloadState = op->downloadState;
+
+    while (downloadState.rgPendingReads.count() < downloadState.readWindow && downloadState.rgMissingData.count()) {
         MavlinkFTP::Request request{};
-        MissingData_t&      missingData = _downloadState.rgMissingData.first();
+        MissingData_t&      missingData = downloadState.rgMissingData.first();
 
         uint32_t cBytesToRead = qMin((uint32_t)sizeof(request.data), missingData.cBytesMissing);
 
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksBegin: offset:cBytesToRead" << missingData.offset << cBytesToRead;
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: offset:cBytesToRead:readWindow" << missingData.offset << cBytesToRead << downloadState.readWindow;
 
-        request.hdr.session                 = _downloadState.sessionId;
+        request.hdr.session                 = downloadState.sessionId;
         request.hdr.opcode                  = MavlinkFTP::kCmdReadFile;
         request.hdr.offset                  = missingData.offset;
         request.hdr.size                    = cBytesToRead;
 
-        if (firstRequest) {
-            _downloadState.retryCount = 0;
-        } else {
-            // Must used same sequence number as previous request
-            _expectedIncomingSeqNumber -= 2;
+        downloadState.rgPendingReads.append({ missingData.offset, cBytesToRead });
+        missingData.offset          += cBytesToRead;
+        missingData.cBytesMissing   -= cBytesToRead;
+        if (missingData.cBytesMissing == 0) {
+            downloadState.rgMissingData.removeFirst();
         }
-        _downloadState.expectedOffset = request.hdr.offset;
 
-        _sendRequestExpectAck(&request);
-    } else {
+        _sendRequestExpectAck(op, &request);
+    }
+
+    if (downloadState.rgPendingReads.isEmpty()) {
         // We should have the full file now
-        if (_downloadState.checksize == false || _downloadState.bytesWritten == _downloadState.fileSize) {
-            _advanceStateMachine();
+        if (downloadState.checksize == false || downloadState.bytesWritten == downloadState.fileSize) {
+            _advanceStateMachine(op);
         } else {
-            qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: no missing blocks but file still incomplete - bytesWritten:fileSize" << _downloadState.bytesWritten << _downloadState.fileSize;
-            _downloadComplete(tr("Download failed"));
+            qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: no missing blocks but file still incomplete - bytesWritten:fileSize" << downloadState.bytesWritten << downloadState.fileSize;
+            _downloadComplete(op, tr("Download failed"));
         }
     }
 }
 
-void FTPManager::_fillMissingBlocksBegin(void)
+void FTPManager::_fillMissingBlocksBegin(Operation_t* op)
 {
-    _fillMissingBlocksWorker(true /* firstRequest */);
+    DownloadState_t& downloadState = op->downloadState;
+
+    downloadState.retryCount = 0;
+    // Without a valid file size the end of the file is only told by an EOF nak, which can't be matched to one of several reads
+    downloadState.readWindow = downloadState.checksize ? _initialReadWindow : 1;
+
+    _fillMissingBlocksWorker(op);
 }
 
-void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
+void FTPManager::_fillMissingBlocksAckOrNak(Operation_t* op, const MavlinkFTP::Request* ackOrNak)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    DownloadState_t&        downloadState = op->downloadState;
+    MavlinkFTP::OpCode_t    requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
 
     if (requestOpCode != MavlinkFTP::kCmdReadFile) {
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-        return;
-    }
-    if (ackOrNak->hdr.session != _downloadState.sessionId) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
+    if (ackOrNak->hdr.session != downloadState.sessionId) {
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << downloadState.sessionId;
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
-
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (++_downloadState.retryCount > _maxRetry) {
-                qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: offset mismatch, retries exceeded");
-                _downloadComplete(tr("Download failed"));
-                return;
+        int pendingIndex = -1;
+        for (int i=0; i<downloadState.rgPendingReads.count(); i++) {
+            if (downloadState.rgPendingReads[i].offset == ackOrNak->hdr.offset) {
+                pendingIndex = i;
+                break;
             }
-
-            // Ask for current offset again
-            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-            _fillMissingBlocksWorker(false /* firstReqeust */);
+        }
+        if (pendingIndex == -1 || ackOrNak->hdr.size == 0 || ackOrNak->hdr.size > downloadState.rgPendingReads[pendingIndex].cBytesMissing) {
+            // Duplicate or answer to a read which was already requested again
+            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding Ack with no matching read offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
             return;
         }
+        const MissingData_t pendingRead = downloadState.rgPendingReads.takeAt(pendingIndex);
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
+        downloadState.file.seek(ackOrNak->hdr.offset);
+        int bytesWritten = downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
         if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
+            _downloadComplete(op, tr("Download failed: Error saving file"));
             return;
         }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
+        downloadState.bytesWritten += ackOrNak->hdr.size;
 
-        MissingData_t& missingData = _downloadState.rgMissingData.first();
-        missingData.offset += ackOrNak->hdr.size;
-        missingData.cBytesMissing -= ackOrNak->hdr.size;
-        if (missingData.cBytesMissing == 0) {
-            // This block is finished, remove it
-            _downloadState.rgMissingData.takeFirst();
+        if (ackOrNak->hdr.size < pendingRead.cBytesMissing) {
+            // Short read, ask for the rest first
+            downloadState.rgMissingData.prepend({ pendingRead.offset + ackOrNak->hdr.size, pendingRead.cBytesMissing - ackOrNak->hdr.size });
+        }
+
+        // The link keeps up, keep one more read in flight
+        downloadState.retryCount = 0;
+        if (downloadState.checksize) {
+            downloadState.readWindow = qMin(downloadState.readWindow + 1, _maxReadWindow);
+        }
+
+        if (downloadState.rgPendingReads.isEmpty()) {
+            _stopAckOrNakTimeout(op);
+        } else {
+            _startAckOrNakTimeout(op);
         }
 
+        const QString   filePath    = downloadState.filePath();
+        const float     progress    = (downloadState.fileSize != 0) ? (float)(downloadState.bytesWritten) / (float)downloadState.fileSize : -1;
+
         // Move on to fill in possible next hole
-        _fillMissingBlocksWorker(true /* firstReqeust */);
+        _fillMissingBlocksWorker(op);
 
         // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
+        if (progress >= 0) {
+            emit commandProgress(filePath, progress);
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
+        _stopAckOrNakTimeout(op);
+
         if (errorCode == MavlinkFTP::kErrEOF) {
             qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak EOF";
-            if (_downloadState.checksize == false || _downloadState.bytesWritten == _downloadState.fileSize) {
+            if (downloadState.checksize == false || downloadState.bytesWritten == downloadState.fileSize) {
                 // We've successfully complete filling in all missing blocks
-                _advanceStateMachine();
+                downloadState.rgPendingReads.clear();
+                downloadState.rgMissingData.clear();
+                _advanceStateMachine(op);
                 return;
             }
         }
 
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(tr("Download failed"));
+        _downloadComplete(op, tr("Download failed"));
     }
 }
 
-void FTPManager::_fillMissingBlocksTimeout(void)
+void FTPManager::_fillMissingBlocksTimeout(Operation_t* op)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
+    DownloadState_t& downloadState = op->downloadState;
+
+    if (++downloadState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _downloadComplete(op, tr("Download failed"));
     } else {
-        // Ask for current offset again
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _fillMissingBlocksWorker(false /* firstReqeust */);
+        // Fewer reads in flight and ask for all unanswered reads again
+        downloadState.readWindow = qMax(1, downloadState.readWindow / 2);
+        for (int i=downloadState.rgPendingReads.count()-1; i>=0; i--) {
+            downloadState.rgMissingData.prepend(downloadState.rgPendingReads[i]);
+        }
+        downloadState.rgPendingReads.clear();
+
+        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) readWindow(%2)").arg(downloadState.retryCount).arg(downloadState.readWindow);
+        _fillMissingBlocksWorker(op);
     }
 }
 
-void FTPManager::_resetSessionsBegin(void)
+/// Closes the session of a finished download. Resetting the sessions also cleans up sessions left over on the
+/// vehicle, so that is done when no other operation has a session open on the component.
+void FTPManager::_closeSessionBegin(Operation_t* op)
 {
+    DownloadState_t& downloadState = op->downloadState;
+
+    int cComponentOperations = 0;
+    for (const Operation_t* otherOp: _operations) {
+        if (otherOp->compId == op->compId) {
+            cComponentOperations++;
+        }
+    }
+    downloadState.resetSessions = cComponentOperations == 1;
+
     MavlinkFTP::Request request{};
-    request.hdr.opcode  = MavlinkFTP::kCmdResetSessions;
-    request.hdr.size    = 0;
-    _sendRequestExpectAck(&request);
+    if (downloadState.resetSessions) {
+        request.hdr.opcode  = MavlinkFTP::kCmdResetSessions;
+    } else {
+        request.hdr.session = downloadState.sessionId;
+        request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
+    }
+    request.hdr.size = 0;
+    _sendRequestExpectAck(op, &request);
 }
 
-void FTPManager::_resetSessionsAckOrNak(const MavlinkFTP::Request* ackOrNak)
+void FTPManager::_closeSessionAckOrNak(Operation_t* op, const MavlinkFTP::Request* ackOrNak)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    MavlinkFTP::OpCode_t requestOpCode          = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    MavlinkFTP::OpCode_t expectedRequestOpCode  = op->downloadState.resetSessions ? MavlinkFTP::kCmdResetSessions : MavlinkFTP::kCmdTerminateSession;
 
-    if (requestOpCode != MavlinkFTP::kCmdResetSessions) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+    if (requestOpCode != expectedRequestOpCode) {
+        qCDebug(FTPManagerLog) << "_closeSessionAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+    if (ackOrNak->hdr.seqNumber != op->expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_closeSessionAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << op->expectedIncomingSeqNumber;
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    _stopAckOrNakTimeout(op);
+    _updateRoundTripTime(op);
+    op->downloadState.sessionOpen = false;
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Ack";
-        _advanceStateMachine();
+        qCDebug(FTPManagerLog) << "_closeSessionAckOrNak: Ack";
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
-        qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(QString());
+        qCDebug(FTPManagerLog) << "_closeSessionAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
     }
+
+    // The file is complete either way
+    _advanceStateMachine(op);
 }
 
-void FTPManager::_resetSessionsTimeout(void)
+void FTPManager::_closeSessionTimeout(Operation_t* op)
 {
-    qCDebug(FTPManagerLog) << "_resetSessionsTimeout";
-    _downloadComplete(QString());
+    qCDebug(FTPManagerLog) << "_closeSessionTimeout";
+    _downloadComplete(op, QString());
 }
 
-void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
+void FTPManager::_sendRequestExpectAck(Operation_t* op, MavlinkFTP::Request* request)
+{
+    _startAckOrNakTimeout(op);
+    _sendRequest(op, request);
+}
+
+void FTPManager::_sendRequest(Operation_t* op, MavlinkFTP::Request* request)
 {
-    _ackOrNakTimeoutTimer.start();
-    
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink) {
-        request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
-        _expectedIncomingSeqNumber += 2;
+        request->hdr.seqNumber = op->expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
+        op->expectedIncomingSeqNumber += 2;
+        op->requestTimer.start();
 
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
+        qCDebug(FTPManagerLog) << "_sendRequest opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber << "compId:" << op->compId;
 
         mavlink_message_t message;
         mavlink_msg_file_transfer_protocol_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
@@ -744,11 +1073,11 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
                                                      &message,
                                                      0,                                                     // Target network, 0=broadcast?
                                                      _vehicle->id(),
-                                                     _ftpCompId,
+                                                     op->compId,
                                                      (uint8_t*)request);                                    // Payload
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     } else {
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck No primary link. Allowing timeout to fail sequence.";
+        qCDebug(FTPManagerLog) << "_sendRequest No primary link. Allowing timeout to fail sequence.";
     }
 }
 
@@ -784,20 +1113,3 @@ bool FTPManager::_parseURI(uint8_t fromCompId, const QString& uri, QString& pars
 
     return true;
 }
-
-bool FTPManager::_isListDirectoryStateMachine(void)
-{
-    if (_rgStateMachine.isEmpty()) {
-        qCWarning(FTPManagerLog) << "INTERNAL ERROR: _isListDirectoryStateMachine called with empty state machine";
-        return false;
-    }
-
-    if (_rgStateMachine[0].beginFn == &FTPManager::_listDirectoryBegin) {
-        return true;
-    } else if (_rgStateMachine[0].beginFn == &FTPManager::_openFileROBegin) {
-        return false;
-    } else {
-        qCWarning(FTPManagerLog) << "INTERNAL ERROR: _isListDirectoryStateMachine called with invalid state machine";
-        return false;
-    }
-}
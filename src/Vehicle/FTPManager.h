@@ -12,7 +12,10 @@
 #include "MAVLinkFTP.h"
 
 #include <QtCore/QObject>
+#include <QtCore/QDeadlineTimer>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QTimer>
 #include <QtCore/QLoggingCategory>
 
@@ -28,8 +31,10 @@ class FTPManager : public QObject
     
 public:
     FTPManager(Vehicle* vehicle);
+    ~FTPManager();
 
-	/// Downloads the specified file.
+	/// Downloads the specified file. Downloads are queued and run in parallel in separate sessions as far as the
+    /// component allows it. Downloads from different components always run in parallel.
     ///     @param fromCompId Component id of the component to download from. If fromCompId is MAV_COMP_ID_ALL, then MAV_COMP_ID_AUTOPILOT1 is used.
     ///     @param fromURI    File to download from component, fully qualified path. May be in the format "mftp://[;comp=<id>]..." where the component id
     ///                       is specified. If component id is not specified, then the id set via fromCompId is used.
@@ -40,9 +45,9 @@ public:
     ///                       and the indicated filesize from MAVFTP fileopen response is ignored.
     ///                       This is used for the APM parameter download where the filesize is wrong due to
     ///                       a dynamic file creation on the vehicle.
-    /// @return true: download has started, false: error, no download
+    /// @return Local file the download is written to, downloadComplete and commandProgress report this file. Empty: error, no download
     /// Signals downloadComplete, commandProgress
-    bool download(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName="", bool checksize = true);
+    QString download(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName="", bool checksize = true);
 
 	/// Get the directory listing of the specified directory.
     ///     @param fromCompId Component id of the component to download from. If fromCompId is MAV_COMP_ID_ALL, then MAV_COMP_ID_AUTOPILOT1 is used.
@@ -52,9 +57,10 @@ public:
     /// Signals listDirectoryComplete
     bool listDirectory(uint8_t fromCompId, const QString& fromURI);
 
-    /// Cancel the download operation
-    /// This will emit downloadComplete() when done, and if there's currently a download in progress
-    void cancelDownload();
+    /// Cancel a download operation
+    /// This will emit downloadComplete() when done, and if the download is queued or in progress
+    ///     @param file Local file returned by download()
+    void cancelDownload(const QString& file);
 
     static constexpr const char* mavlinkFTPScheme = "mftp";
 
@@ -62,17 +68,21 @@ signals:
     void downloadComplete       (const QString& file, const QString& errorMsg);
     void listDirectoryComplete  (const QStringList& dirList, const QString& errorMsg);
 
-    /// Signalled during a lengthy command to show progress
+    /// Signalled during a lengthy download to show progress
+    ///     @param file Local file returned by download()
     ///     @param value Amount of progress: 0.0 = none, 1.0 = complete
-    void commandProgress(float value);
+    void commandProgress(const QString& file, float value);
 	
 private slots:
-    void _ackOrNakTimeout(void);
+    void _ackOrNakTimeout       (void);
+    void _startQueuedOperations (void);
 
 private:
-    typedef void (FTPManager::*StateBeginFn)    (void);
-    typedef void (FTPManager::*StateAckNakFn)   (const MavlinkFTP::Request* ackOrNak);
-    typedef void (FTPManager::*StateTimeoutFn)  (void);
+    struct Operation_t;
+
+    typedef void (FTPManager::*StateBeginFn)    (Operation_t* op);
+    typedef void (FTPManager::*StateAckNakFn)   (Operation_t* op, const MavlinkFTP::Request* ackOrNak);
+    typedef void (FTPManager::*StateTimeoutFn)  (Operation_t* op);
 
     struct StateFunctions_t {
         StateBeginFn    beginFn;
@@ -86,97 +96,109 @@ private:
     };
 
     struct DownloadState_t {
-        uint8_t                 sessionId;
-        uint32_t                expectedOffset;         ///< offset which should be coming next
-        uint32_t                bytesWritten;
+        uint8_t                 sessionId       = 0;
+        bool                    sessionOpen     = false;    ///< Session is open on the vehicle and has to be closed
+        bool                    resetSessions   = false;    ///< Session is closed by resetting all sessions of the component
+        uint32_t                expectedOffset  = 0;        ///< offset which should be coming next
+        uint32_t                bytesWritten    = 0;
         QList<MissingData_t>    rgMissingData;
-        QString                 fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
-        QDir                    toDir;                  ///< Directory to download file to
-        QString                 fileName;               ///< Filename (no path) for download file
-        uint32_t                fileSize;               ///< Size of file being downloaded
+        QList<MissingData_t>    rgPendingReads;             ///< Read requests for missing data which are not answered yet
+        int                     readWindow      = 0;        ///< Number of read requests for missing data kept in flight
+        QString                 fullPathOnVehicle;          ///< Fully qualified path to file on vehicle
+        QDir                    toDir;                      ///< Directory to download file to
+        QString                 fileName;                   ///< Filename (no path) for download file
+        uint32_t                fileSize        = 0;        ///< Size of file being downloaded
         QFile                   file;
-        int                     retryCount;
-        bool                    checksize;
-
-        bool inProgress() const { return fileSize > 0; }
-
-        void reset() {
-            sessionId       = 0;
-            expectedOffset  = 0;
-            bytesWritten    = 0;
-            retryCount      = 0;
-            fileSize        = 0;
-            fullPathOnVehicle.clear();
-            fileName.clear();
-            rgMissingData.clear();
-            file.close();
-        }
+        int                     retryCount      = 0;
+        bool                    checksize       = true;
+
+        QString filePath() const { return toDir.absoluteFilePath(fileName); }
     };
 
     struct ListDirectoryState_t {
-        uint8_t     sessionId;
-        uint32_t    expectedOffset;         ///< offset which should be coming next
+        uint32_t    expectedOffset  = 0;    ///< offset which should be coming next
         QString     fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
         QStringList rgDirectoryList;
-        int         retryCount;
-
-        bool inProgress() const { return rgDirectoryList.count() > 0; }
+        int         retryCount      = 0;
+    };
 
-        void reset() {
-            sessionId       = 0;
-            expectedOffset  = 0;
-            fullPathOnVehicle.clear();
-            rgDirectoryList.clear();
-            retryCount      = 0;
-        }
+    /// A download or directory listing with its own state machine. Replies are routed to the operation by the
+    /// session id, or by the state for the replies which do not belong to a session yet.
+    struct Operation_t {
+        QList<StateFunctions_t> rgStateMachine;
+        int                     currentStateMachineIndex    = -1;
+        uint8_t                 compId                      = MAV_COMP_ID_AUTOPILOT1;
+        uint16_t                expectedIncomingSeqNumber   = 0;
+        QDeadlineTimer          ackOrNakDeadline            { QDeadlineTimer::Forever };
+        QElapsedTimer           requestTimer;               ///< Time since the last request, to estimate the round trip time
+        bool                    listDirectory               = false;
+        bool                    cancelRequested             = false;
+        DownloadState_t         downloadState;
+        ListDirectoryState_t    listDirectoryState;
     };
 
     void    _mavlinkMessageReceived     (const mavlink_message_t& message);
-    void    _startStateMachine          (void);
-    void    _advanceStateMachine        (void);
-    void    _listDirectoryBegin         (void);
-    void    _listDirectoryAckOrNak      (const MavlinkFTP::Request* ackOrNak);
-    void    _listDirectoryTimeout       (void);
-    void    _openFileROBegin            (void);
-    void    _openFileROAckOrNak         (const MavlinkFTP::Request* ackOrNak);
-    void    _openFileROTimeout          (void);
-    void    _burstReadFileBegin         (void);
-    void    _burstReadFileAckOrNak      (const MavlinkFTP::Request* ackOrNak);
-    void    _burstReadFileTimeout       (void);
-    void    _fillMissingBlocksBegin     (void);
-    void    _fillMissingBlocksAckOrNak  (const MavlinkFTP::Request* ackOrNak);
-    void    _fillMissingBlocksTimeout   (void);
-    void    _resetSessionsBegin         (void);
-    void    _resetSessionsAckOrNak      (const MavlinkFTP::Request* ackOrNak);
-    void    _resetSessionsTimeout       (void);
+    static QList<uint32_t> _handledMessageIds(void) { return { MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL }; }
+    void    _queueOperation             (Operation_t* op);
+    bool    _canStartOperation          (uint8_t compId) const;
+    bool    _isExclusiveState           (const Operation_t* op) const;
+    Operation_t* _operationForReply     (uint8_t compId, const MavlinkFTP::Request* ackOrNak) const;
+    StateBeginFn _currentBeginFn        (const Operation_t* op) const;
+    void    _finishOperation            (Operation_t* op);
+    void    _startStateMachine          (Operation_t* op);
+    void    _advanceStateMachine        (Operation_t* op);
+    void    _startAckOrNakTimeout       (Operation_t* op);
+    void    _stopAckOrNakTimeout        (Operation_t* op);
+    void    _rescheduleAckOrNakTimeout  (void);
+    void    _updateRoundTripTime        (Operation_t* op);
+    int     _ackOrNakTimeoutMsecs       (uint8_t compId) const;
+    void    _listDirectoryBegin         (Operation_t* op);
+    void    _listDirectoryAckOrNak      (Operation_t* op, const MavlinkFTP::Request* ackOrNak);
+    void    _listDirectoryTimeout       (Operation_t* op);
+    void    _openFileROBegin            (Operation_t* op);
+    void    _openFileROAckOrNak         (Operation_t* op, const MavlinkFTP::Request* ackOrNak);
+    void    _openFileROTimeout          (Operation_t* op);
+    void    _burstReadFileBegin         (Operation_t* op);
+    void    _burstReadFileAckOrNak      (Operation_t* op, const MavlinkFTP::Request* ackOrNak);
+    void    _burstReadFileTimeout       (Operation_t* op);
+    void    _fillMissingBlocksBegin     (Operation_t* op);
+    void    _fillMissingBlocksAckOrNak  (Operation_t* op, const MavlinkFTP::Request* ackOrNak);
+    void    _fillMissingBlocksTimeout   (Operation_t* op);
+    void    _closeSessionBegin          (Operation_t* op);
+    void    _closeSessionAckOrNak       (Operation_t* op, const MavlinkFTP::Request* ackOrNak);
+    void    _closeSessionTimeout        (Operation_t* op);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
-    void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
-    void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
-    void    _downloadComplete           (const QString& errorMsg);
+    void    _sendRequestExpectAck       (Operation_t* op, MavlinkFTP::Request* request);
+    void    _sendRequest                (Operation_t* op, MavlinkFTP::Request* request);
+    void    _downloadCompleteNoError    (Operation_t* op) { _downloadComplete(op, QString()); }
+    void    _downloadComplete           (Operation_t* op, const QString& errorMsg);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
-    void    _fillMissingBlocksWorker    (bool firstRequest);
-    void    _burstReadFileWorker        (bool firstRequest);
-    void    _listDirectoryWorker        (bool firstRequest);
+    void    _fillMissingBlocksWorker    (Operation_t* op);
+    void    _burstReadFileWorker        (Operation_t* op, bool firstRequest);
+    void    _listDirectoryWorker        (Operation_t* op, bool firstRequest);
     bool    _parseURI                   (uint8_t fromCompId, const QString& uri, QString& parsedURI, uint8_t& compId);
-    bool    _isListDirectoryStateMachine(void);
-    void    _listDirectoryCompleteNoError(void) { _listDirectoryComplete(QString()); }
-    void    _listDirectoryComplete      (const QString& errorMsg);
+    void    _listDirectoryCompleteNoError(Operation_t* op) { _listDirectoryComplete(op, QString()); }
+    void    _listDirectoryComplete      (Operation_t* op, const QString& errorMsg);
 
-    void    _terminateSessionBegin      (void);
-    void    _terminateSessionAckOrNak   (const MavlinkFTP::Request* ackOrNak);
-    void    _terminateSessionTimeout    (void);
-    void    _terminateComplete          (void);
+    void    _terminateSessionBegin      (Operation_t* op);
+    void    _terminateSessionAckOrNak   (Operation_t* op, const MavlinkFTP::Request* ackOrNak);
+    void    _terminateSessionTimeout    (Operation_t* op);
+    void    _terminateComplete          (Operation_t* op);
 
     Vehicle*                _vehicle;
-    uint8_t                 _ftpCompId = MAV_COMP_ID_AUTOPILOT1;
-    QList<StateFunctions_t> _rgStateMachine;
-    DownloadState_t         _downloadState;
-    ListDirectoryState_t    _listDirectoryState;
-    QTimer                  _ackOrNakTimeoutTimer;
-    int                     _currentStateMachineIndex   = -1;
-    uint16_t                _expectedIncomingSeqNumber  = 0;
+    QList<Operation_t*>     _operations;                    ///< Operations with a running state machine
+    QList<Operation_t*>     _queuedOperations;              ///< Operations waiting for a free session
+    QHash<uint8_t, int>     _maxSessions;                   ///< Sessions each component supports, lowered when it runs out of sessions
+    QHash<uint8_t, int>     _roundTripMsecs;                ///< Smoothed round trip time of each component
+    QTimer                  _ackOrNakTimeoutTimer;          ///< Fires at the earliest ack/nak deadline of all operations
+    uint16_t                _nextSeqNumberBase          = 0;
     
-    static const int _ackOrNakTimeoutMsecs  = 1000;
-    static const int _maxRetry              = 3;
+    static constexpr int _ackOrNakTimeoutMsecsMax   = 1000;
+    static constexpr int _ackOrNakTimeoutMsecsMin   = 200;
+    static constexpr int _roundTripTimeoutFactor    = 4;
+    static constexpr int _maxRetry                  = 3;
+    static constexpr int _maxSessionsPX4            = 3;        ///< Initial guess, lowered when the vehicle runs out of sessions
+    static constexpr int _initialReadWindow         = 2;
+    static constexpr int _maxReadWindow             = 4;        ///< ArduPilot queues only a few FTP requests
+    static constexpr uint16_t _seqNumberSpacing = 0x4000;  ///< Operations use separate sequence number ranges
 };
-
@@ -39,6 +39,9 @@ public:
     Fact* active            (void) { return &_active; }
     Fact* numSatellites     (void) { return &_numSatellites; }
 
+    // Overrides from FactGroup
+    QList<uint32_t> handledMessageIds(void) const override { return {}; }   ///< Not driven by incoming messages
+
 private:
     const QString _connectedFactName =                QStringLiteral("connected");
     const QString _currentAccuracyFactName =          QStringLiteral("currentAccuracy");
@@ -47,6 +47,11 @@ VehicleEscStatusFactGroup::VehicleEscStatusFactGroup(QObject* parent)
     _addFact(&_voltageFourthFact,               _voltageFourthFactName);
 }
 
+QList<uint32_t> VehicleEscStatusFactGroup::handledMessageIds(void) const
+{
+    return { MAVLINK_MSG_ID_ESC_STATUS };
+}
+
 void VehicleEscStatusFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
 {
     if (message.msgid != MAVLINK_MSG_ID_ESC_STATUS) {
@@ -46,39 +46,51 @@ VehicleFactGroup::VehicleFactGroup(QObject* parent)
     , _throttlePctFact              (0, _throttlePctFactName,               FactMetaData::valueTypeUint16)
     , _imuTempFact                  (0, _imuTempFactName,                   FactMetaData::valueTypeInt16)
 {
-    _addFact(&_rollFact,                    _rollFactName);
-    _addFact(&_pitchFact,                   _pitchFactName);
-    _addFact(&_headingFact,                 _headingFactName);
-    _addFact(&_rollRateFact,                _rollRateFactName);
-    _addFact(&_pitchRateFact,               _pitchRateFactName);
-    _addFact(&_yawRateFact,                 _yawRateFactName);
-    _addFact(&_groundSpeedFact,             _groundSpeedFactName);
-    _addFact(&_airSpeedFact,                _airSpeedFactName);
-    _addFact(&_airSpeedSetpointFact,        _airSpeedSetpointFactName);
-    _addFact(&_climbRateFact,               _climbRateFactName);
-    _addFact(&_altitudeRelativeFact,        _altitudeRelativeFactName);
-    _addFact(&_altitudeAMSLFact,            _altitudeAMSLFactName);
-    _addFact(&_altitudeAboveTerrFact,       _altitudeAboveTerrFactName);
-    _addFact(&_altitudeTuningFact,          _altitudeTuningFactName);
-    _addFact(&_altitudeTuningSetpointFact,  _altitudeTuningSetpointFactName);
-    _addFact(&_xTrackErrorFact,             _xTrackErrorFactName);
-    _addFact(&_rangeFinderDistFact,         _rangeFinderDistFactName);
-    _addFact(&_flightDistanceFact,          _flightDistanceFactName);
-    _addFact(&_flightTimeFact,              _flightTimeFactName);
-    _addFact(&_distanceToHomeFact,          _distanceToHomeFactName);
-    _addFact(&_timeToHomeFact,              _timeToHomeFactName);
-    _addFact(&_missionItemIndexFact,        _missionItemIndexFactName);
-    _addFact(&_headingToNextWPFact,         _headingToNextWPFactName);
-    _addFact(&_distanceToNextWPFact,        _distanceToNextWPFactName);
-    _addFact(&_headingToHomeFact,           _headingToHomeFactName);
-    _addFact(&_distanceToGCSFact,           _distanceToGCSFactName);
-    _addFact(&_hobbsFact,                   _hobbsFactName);
-    _addFact(&_throttlePctFact,             _throttlePctFactName);
-    _addFact(&_imuTempFact,                 _imuTempFactName);
+    // Attitude and position arrive at high rates, the UI only needs to hear about them once per update
+    _setCoalescedUpdates(true);
+
+    _addValueBlockFact(&_rollFact,                   _rollFactName);
+    _addValueBlockFact(&_pitchFact,                  _pitchFactName);
+    _addValueBlockFact(&_headingFact,                _headingFactName);
+    _addValueBlockFact(&_rollRateFact,               _rollRateFactName);
+    _addValueBlockFact(&_pitchRateFact,              _pitchRateFactName);
+    _addValueBlockFact(&_yawRateFact,                _yawRateFactName);
+    _addValueBlockFact(&_groundSpeedFact,            _groundSpeedFactName);
+    _addValueBlockFact(&_airSpeedFact,               _airSpeedFactName);
+    _addValueBlockFact(&_airSpeedSetpointFact,       _airSpeedSetpointFactName);
+    _addValueBlockFact(&_climbRateFact,              _climbRateFactName);
+    _addValueBlockFact(&_altitudeRelativeFact,       _altitudeRelativeFactName);
+    _addValueBlockFact(&_altitudeAMSLFact,           _altitudeAMSLFactName);
+    _addFact(&_altitudeAboveTerrFact,                _altitudeAboveTerrFactName);
+    _addValueBlockFact(&_altitudeTuningFact,         _altitudeTuningFactName);
+    _addValueBlockFact(&_altitudeTuningSetpointFact, _altitudeTuningSetpointFactName);
+    _addValueBlockFact(&_xTrackErrorFact,            _xTrackErrorFactName);
+    _addValueBlockFact(&_rangeFinderDistFact,        _rangeFinderDistFactName);
+    _addFact(&_flightDistanceFact,                   _flightDistanceFactName);
+    _addFact(&_flightTimeFact,                       _flightTimeFactName);
+    _addFact(&_distanceToHomeFact,                   _distanceToHomeFactName);
+    _addFact(&_timeToHomeFact,                       _timeToHomeFactName);
+    _addFact(&_missionItemIndexFact,                 _missionItemIndexFactName);
+    _addFact(&_headingToNextWPFact,                  _headingToNextWPFactName);
+    _addValueBlockFact(&_distanceToNextWPFact,       _distanceToNextWPFactName);
+    _addFact(&_headingToHomeFact,                    _headingToHomeFactName);
+    _addFact(&_distanceToGCSFact,                    _distanceToGCSFactName);
+    _addFact(&_hobbsFact,                            _hobbsFactName);
+    _addValueBlockFact(&_throttlePctFact,            _throttlePctFactName);
+    _addValueBlockFact(&_imuTempFact,                _imuTempFactName);
 
     _hobbsFact.setRawValue(QVariant(QString("0000:00:00")));
 }
 
+QList<uint32_t> VehicleFactGroup::handledMessageIds(void) const
+{
+    QList<uint32_t> msgIds = { MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_ATTITUDE_QUATERNION, MAVLINK_MSG_ID_ALTITUDE, MAVLINK_MSG_ID_VFR_HUD, MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, MAVLINK_MSG_ID_RAW_IMU };
+#if !defined(NO_ARDUPILOT_DIALECT)
+    msgIds.append(MAVLINK_MSG_ID_RANGEFINDER);
+#endif
+    return msgIds;
+}
+
 void VehicleFactGroup::handleMessage(Vehicle* vehicle, mavlink_message_t& message)
 {
     switch (message.msgid) {
@@ -126,9 +138,9 @@ void VehicleFactGroup::_handleAttitudeWorker(double rollRadians, double pitchRad
     // truncate to integer so widget never displays 360
     yaw = trunc(yaw);
 
-    _rollFact.setRawValue(roll);
-    _pitchFact.setRawValue(pitch);
-    _headingFact.setRawValue(yaw);
+    _setValueBlockValue(_rollFact, roll);
+    _setValueBlockValue(_pitchFact, pitch);
+    _setValueBlockValue(_headingFact, yaw);
 }
 
 void VehicleFactGroup::_handleAttitude(Vehicle* vehicle, const mavlink_message_t &message)
@@ -155,8 +167,8 @@ void VehicleFactGroup::_handleAltitude(const mavlink_message_t &message)
 
     // Data from ALTITUDE message takes precedence over gps messages
     _altitudeMessageAvailable = true;
-    _altitudeRelativeFact.setRawValue(altitude.altitude_relative);
-    _altitudeAMSLFact.setRawValue(altitude.altitude_amsl);
+    _setValueBlockValue(_altitudeRelativeFact, altitude.altitude_relative);
+    _setValueBlockValue(_altitudeAMSLFact, altitude.altitude_amsl);
 }
 
 void VehicleFactGroup::_handleAttitudeQuaternion(Vehicle* vehicle, const mavlink_message_t &message)
@@ -187,9 +199,9 @@ void VehicleFactGroup::_handleAttitudeQuaternion(Vehicle* vehicle, const mavlink
 
     _handleAttitudeWorker(roll, pitch, yaw);
 
-    _rollRateFact.setRawValue(qRadiansToDegrees(rates[0]));
-    _pitchRateFact.setRawValue(qRadiansToDegrees(rates[1]));
-    _yawRateFact.setRawValue(qRadiansToDegrees(rates[2]));
+    _setValueBlockValue(_rollRateFact, qRadiansToDegrees(rates[0]));
+    _setValueBlockValue(_pitchRateFact, qRadiansToDegrees(rates[1]));
+    _setValueBlockValue(_yawRateFact, qRadiansToDegrees(rates[2]));
 }
 
 void VehicleFactGroup::_handleNavControllerOutput(const mavlink_message_t &message)
@@ -197,10 +209,10 @@ void VehicleFactGroup::_handleNavControllerOutput(const mavlink_message_t &messa
     mavlink_nav_controller_output_t navControllerOutput;
     mavlink_msg_nav_controller_output_decode(&message, &navControllerOutput);
 
-    _altitudeTuningSetpointFact.setRawValue(_altitudeTuningFact.rawValue().toDouble() - navControllerOutput.alt_error);
-    _xTrackErrorFact.setRawValue(navControllerOutput.xtrack_error);
-    _airSpeedSetpointFact.setRawValue(_airSpeedFact.rawValue().toDouble() - navControllerOutput.aspd_error);
-    _distanceToNextWPFact.setRawValue(navControllerOutput.wp_dist);
+    _setValueBlockValue(_altitudeTuningSetpointFact, _altitudeTuningFact.rawValue().toDouble() - navControllerOutput.alt_error);
+    _setValueBlockValue(_xTrackErrorFact, navControllerOutput.xtrack_error);
+    _setValueBlockValue(_airSpeedSetpointFact, _airSpeedFact.rawValue().toDouble() - navControllerOutput.aspd_error);
+    _setValueBlockValue(_distanceToNextWPFact, navControllerOutput.wp_dist);
 }
 
 void VehicleFactGroup::_handleVfrHud(const mavlink_message_t &message)
@@ -208,14 +220,14 @@ void VehicleFactGroup::_handleVfrHud(const mavlink_message_t &message)
     mavlink_vfr_hud_t vfrHud;
     mavlink_msg_vfr_hud_decode(&message, &vfrHud);
 
-    _airSpeedFact.setRawValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
-    _groundSpeedFact.setRawValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
-    _climbRateFact.setRawValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
-    _throttlePctFact.setRawValue(static_cast<int16_t>(vfrHud.throttle));
+    _setValueBlockValue(_airSpeedFact, qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
+    _setValueBlockValue(_groundSpeedFact, qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
+    _setValueBlockValue(_climbRateFact, qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
+    _setValueBlockValue(_throttlePctFact, static_cast<int16_t>(vfrHud.throttle));
     if (qIsNaN(_altitudeTuningOffset)) {
         _altitudeTuningOffset = vfrHud.alt;
     }
-    _altitudeTuningFact.setRawValue(vfrHud.alt - _altitudeTuningOffset);
+    _setValueBlockValue(_altitudeTuningFact, vfrHud.alt - _altitudeTuningOffset);
     if (!qIsNaN(vfrHud.groundspeed) && !qIsNaN(_distanceToHomeFact.cookedValue().toDouble())) {
       _timeToHomeFact.setRawValue(_distanceToHomeFact.cookedValue().toDouble() / vfrHud.groundspeed);
     }
@@ -226,7 +238,7 @@ void VehicleFactGroup::_handleRawImuTemp(const mavlink_message_t &message)
     mavlink_raw_imu_t imuRaw;
     mavlink_msg_raw_imu_decode(&message, &imuRaw);
 
-    _imuTempFact.setRawValue(imuRaw.temperature == 0 ? 0 : imuRaw.temperature * 0.01);
+    _setValueBlockValue(_imuTempFact, imuRaw.temperature == 0 ? 0 : imuRaw.temperature * 0.01);
 }
 
 #ifndef NO_ARDUPILOT_DIALECT
@@ -236,6 +248,6 @@ void VehicleFactGroup::_handleRangefinder(const mavlink_message_t &message)
     mavlink_rangefinder_t rangefinder;
     mavlink_msg_rangefinder_decode(&message, &rangefinder);
 
-    _rangeFinderDistFact.setRawValue(qIsNaN(rangefinder.distance) ? 0 : rangefinder.distance);
+    _setValueBlockValue(_rangeFinderDistFact, qIsNaN(rangefinder.distance) ? 0 : rangefinder.distance);
 }
 #endif
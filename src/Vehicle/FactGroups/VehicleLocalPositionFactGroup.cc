@@ -37,6 +37,11 @@ VehicleLocalPositionFactGroup::VehicleLocalPositionFactGroup(QObject* parent)
     _vzFact.setRawValue(qQNaN());
 }
 
+QList<uint32_t> VehicleLocalPositionFactGroup::handledMessageIds(void) const
+{
+    return { MAVLINK_MSG_ID_LOCAL_POSITION_NED };
+}
+
 void VehicleLocalPositionFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
 {
     if (message.msgid != MAVLINK_MSG_ID_LOCAL_POSITION_NED) {
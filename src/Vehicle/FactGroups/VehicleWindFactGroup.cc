@@ -28,6 +28,15 @@ VehicleWindFactGroup::VehicleWindFactGroup(QObject* parent)
     _verticalSpeedFact.setRawValue  (qQNaN());
 }
 
+QList<uint32_t> VehicleWindFactGroup::handledMessageIds(void) const
+{
+    QList<uint32_t> msgIds = { MAVLINK_MSG_ID_WIND_COV, MAVLINK_MSG_ID_HIGH_LATENCY, MAVLINK_MSG_ID_HIGH_LATENCY2 };
+#if !defined(NO_ARDUPILOT_DIALECT)
+    msgIds.append(MAVLINK_MSG_ID_WIND);
+#endif
+    return msgIds;
+}
+
 void VehicleWindFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_t& message)
 {
     switch (message.msgid) {
@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FleetVehicleState.h"
+#include "FirmwarePlugin.h"
+#include "QGCApplication.h"
+#include "LinkManager.h"
+
+#include <QtCore/QtMath>
+
+FleetVehicleState::FleetVehicleState(LinkInterface* link, int vehicleId, int componentId, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType, FirmwarePlugin* firmwarePlugin, QObject* parent)
+    : QObject           (parent)
+    , _id               (vehicleId)
+    , _componentId      (componentId)
+    , _firmwareType     (firmwareType)
+    , _vehicleType      (vehicleType)
+    , _firmwarePlugin   (firmwarePlugin)
+    , _link             (qgcApp()->toolbox()->linkManager()->sharedLinkInterfacePointerForLink(link))
+{
+    _lastHeardTimer.start();
+}
+
+QString FleetVehicleState::flightMode(void) const
+{
+    return _firmwarePlugin ? _firmwarePlugin->flightMode(_baseMode, _customMode) : QString();
+}
+
+void FleetVehicleState::handleMessage(const mavlink_message_t& message)
+{
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+        _handleHeartbeat(message);
+        break;
+    case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+        _handleGlobalPositionInt(message);
+        break;
+    case MAVLINK_MSG_ID_SYS_STATUS:
+        _handleSysStatus(message);
+        break;
+    default:
+        break;
+    }
+}
+
+void FleetVehicleState::_handleHeartbeat(const mavlink_message_t& message)
+{
+    mavlink_heartbeat_t heartbeat;
+    mavlink_msg_heartbeat_decode(&message, &heartbeat);
+
+    _lastHeardTimer.restart();
+    if ((heartbeat.base_mode != _baseMode) || (heartbeat.custom_mode != _customMode)) {
+        _baseMode   = heartbeat.base_mode;
+        _customMode = heartbeat.custom_mode;
+        _changed    = true;
+    }
+}
+
+void FleetVehicleState::_handleGlobalPositionInt(const mavlink_message_t& message)
+{
+    mavlink_global_position_int_t globalPosition;
+    mavlink_msg_global_position_int_decode(&message, &globalPosition);
+
+    if ((globalPosition.lat == 0) && (globalPosition.lon == 0)) {
+        return;
+    }
+    _coordinate         = QGeoCoordinate(globalPosition.lat / 1e7, globalPosition.lon / 1e7, globalPosition.alt / 1000.0);
+    _altitudeRelative   = globalPosition.relative_alt / 1000.0;
+    _groundSpeed        = qSqrt((static_cast<double>(globalPosition.vx) * globalPosition.vx) + (static_cast<double>(globalPosition.vy) * globalPosition.vy)) / 100.0;
+    _heading            = (globalPosition.hdg == UINT16_MAX) ? qQNaN() : (globalPosition.hdg / 100.0);
+    _changed            = true;
+}
+
+void FleetVehicleState::_handleSysStatus(const mavlink_message_t& message)
+{
+    mavlink_sys_status_t sysStatus;
+    mavlink_msg_sys_status_decode(&message, &sysStatus);
+
+    const uint32_t enabledSensors   = sysStatus.onboard_control_sensors_present & sysStatus.onboard_control_sensors_enabled;
+    _healthy            = (enabledSensors & ~sysStatus.onboard_control_sensors_health) == 0;
+    _batteryRemaining   = sysStatus.battery_remaining;
+    _batteryVoltage     = (sysStatus.voltage_battery == UINT16_MAX) ? qQNaN() : (sysStatus.voltage_battery / 1000.0);
+    _changed            = true;
+}
+
+void FleetVehicleState::publish(void)
+{
+    const bool communicationLost = _lastHeardTimer.elapsed() > communicationLostMSecs;
+    if (communicationLost != _communicationLost) {
+        _communicationLost = communicationLost;
+        _changed = true;
+    }
+
+    if (_changed) {
+        _changed = false;
+        emit stateChanged();
+    }
+}
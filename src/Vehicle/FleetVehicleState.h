@@ -0,0 +1,96 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MAVLinkLib.h"
+#include "LinkInterface.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtPositioning/QGeoCoordinate>
+
+class FirmwarePlugin;
+
+/// Lightweight state of a vehicle which is only monitored in the fleet overview. It is filled in from a handful of
+/// messages (HEARTBEAT, GLOBAL_POSITION_INT, SYS_STATUS) instead of running a full Vehicle with its managers and
+/// FactGroups. MultiVehicleManager::promoteOverviewVehicle turns it into a full Vehicle when the operator selects it.
+///
+/// Changes are published at most once per publish call so a large fleet does not flood QML with updates.
+class FleetVehicleState : public QObject
+{
+    Q_OBJECT
+
+public:
+    FleetVehicleState(LinkInterface* link, int vehicleId, int componentId, MAV_AUTOPILOT firmwareType, MAV_TYPE vehicleType, FirmwarePlugin* firmwarePlugin, QObject* parent = nullptr);
+
+    Q_PROPERTY(int              id                  READ id                 CONSTANT)
+    Q_PROPERTY(QGeoCoordinate   coordinate          READ coordinate         NOTIFY stateChanged)
+    Q_PROPERTY(double           heading             READ heading            NOTIFY stateChanged)
+    Q_PROPERTY(double           altitudeRelative    READ altitudeRelative   NOTIFY stateChanged)
+    Q_PROPERTY(double           groundSpeed         READ groundSpeed        NOTIFY stateChanged)
+    Q_PROPERTY(int              batteryRemaining    READ batteryRemaining   NOTIFY stateChanged)    ///< Percent, -1 if unknown
+    Q_PROPERTY(double           batteryVoltage      READ batteryVoltage     NOTIFY stateChanged)    ///< NaN if unknown
+    Q_PROPERTY(QString          flightMode          READ flightMode         NOTIFY stateChanged)
+    Q_PROPERTY(bool             armed               READ armed              NOTIFY stateChanged)
+    Q_PROPERTY(bool             healthy             READ healthy            NOTIFY stateChanged)    ///< All enabled sensors report healthy
+    Q_PROPERTY(bool             communicationLost   READ communicationLost  NOTIFY stateChanged)
+
+    int             id              (void) const { return _id; }
+    int             componentId     (void) const { return _componentId; }
+    MAV_AUTOPILOT   firmwareType    (void) const { return _firmwareType; }
+    MAV_TYPE        vehicleType     (void) const { return _vehicleType; }
+    WeakLinkInterfacePtr link       (void) const { return _link; }
+    QGeoCoordinate  coordinate      (void) const { return _coordinate; }
+    double          heading         (void) const { return _heading; }
+    double          altitudeRelative(void) const { return _altitudeRelative; }
+    double          groundSpeed     (void) const { return _groundSpeed; }
+    int             batteryRemaining(void) const { return _batteryRemaining; }
+    double          batteryVoltage  (void) const { return _batteryVoltage; }
+    QString         flightMode      (void) const;
+    bool            armed           (void) const { return _baseMode & MAV_MODE_FLAG_SAFETY_ARMED; }
+    bool            healthy         (void) const { return _healthy; }
+    bool            communicationLost(void) const { return _communicationLost; }
+
+    /// Updates the state from a message sent by the vehicle's autopilot
+    void handleMessage(const mavlink_message_t& message);
+
+    /// Signals stateChanged if anything changed since the last call and checks for communication loss
+    void publish(void);
+
+    static constexpr int communicationLostMSecs = 10000;
+
+signals:
+    void stateChanged(void);
+
+private:
+    void _handleHeartbeat           (const mavlink_message_t& message);
+    void _handleGlobalPositionInt   (const mavlink_message_t& message);
+    void _handleSysStatus           (const mavlink_message_t& message);
+
+    int                     _id;
+    int                     _componentId;
+    MAV_AUTOPILOT           _firmwareType;
+    MAV_TYPE                _vehicleType;
+    FirmwarePlugin*         _firmwarePlugin;
+    WeakLinkInterfacePtr    _link;
+    QElapsedTimer           _lastHeardTimer;
+    bool                    _changed            = false;
+
+    QGeoCoordinate          _coordinate;
+    double                  _heading            = qQNaN();
+    double                  _altitudeRelative   = qQNaN();
+    double                  _groundSpeed        = qQNaN();
+    int                     _batteryRemaining   = -1;
+    double                  _batteryVoltage     = qQNaN();
+    uint8_t                 _baseMode           = 0;
+    uint32_t                _customMode         = 0;
+    bool                    _healthy            = true;
+    bool                    _communicationLost  = false;
+};
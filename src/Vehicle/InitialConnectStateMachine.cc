@@ -18,6 +18,8 @@
 #include "StandardModes.h"
 #include "GeoFenceManager.h"
 #include "RallyPointManager.h"
+#include "QGCApplication.h"
+#include "MultiVehicleManager.h"
 #include "QGCLoggingCategory.h"
 
 QGC_LOGGING_CATEGORY(InitialConnectStateMachineLog, "InitialConnectStateMachineLog")
@@ -27,6 +29,8 @@ InitialConnectStateMachine::InitialConnectStateMachine(Vehicle* vehicle)
 {
     static_assert(sizeof(_rgStates)/sizeof(_rgStates[0]) == sizeof(_rgProgressWeights)/sizeof(_rgProgressWeights[0]),
             "array size mismatch");
+    static_assert(sizeof(_rgStates)/sizeof(_rgStates[0]) == sizeof(_rgStateDependencies)/sizeof(_rgStateDependencies[0]),
+            "array size mismatch");
 
     _progressWeightTotal = 0;
     for (int i = 0; i < _cStates; ++i) {
@@ -44,6 +48,11 @@ const InitialConnectStateMachine::StateFn* InitialConnectStateMachine::rgStates(
     return &_rgStates[0];
 }
 
+quint32 InitialConnectStateMachine::stateDependencies(int stateIndex) const
+{
+    return _rgStateDependencies[stateIndex];
+}
+
 void InitialConnectStateMachine::statesCompleted(void) const
 {
 
@@ -51,23 +60,47 @@ void InitialConnectStateMachine::statesCompleted(void) const
 
 void InitialConnectStateMachine::advance()
 {
-    StateMachine::advance();
+    ParallelStateMachine::advance();
     emit progressUpdate(_progress());
 }
 
 void InitialConnectStateMachine::gotProgressUpdate(float progressValue)
 {
-    emit progressUpdate(_progress(progressValue));
+    // Several states may be reporting progress at the same time
+    StateFn stateFn = nullptr;
+    if (sender() == _vehicle->_componentInformationManager) {
+        stateFn = _stateRequestCompInfo;
+    } else if (sender() == _vehicle->_parameterManager) {
+        stateFn = _stateRequestParameters;
+    } else if (sender() == _vehicle->_missionManager) {
+        stateFn = _stateRequestMission;
+    } else if (sender() == _vehicle->_geoFenceManager) {
+        stateFn = _stateRequestGeoFence;
+    } else if (sender() == _vehicle->_rallyPointManager) {
+        stateFn = _stateRequestRallyPoints;
+    }
+
+    for (int i = 0; i < _cStates; ++i) {
+        if (_rgStates[i] == stateFn && _stateRunning(i)) {
+            _rgStateProgress[i] = qBound(0.f, progressValue, 1.f);
+            break;
+        }
+    }
+
+    emit progressUpdate(_progress());
 }
 
-float InitialConnectStateMachine::_progress(float subProgress)
+float InitialConnectStateMachine::_progress(void) const
 {
-    int progressWeight = 0;
-    for (int i = 0; i < _stateIndex && i < _cStates; ++i) {
-        progressWeight += _rgProgressWeights[i];
+    float progressWeight = 0;
+    for (int i = 0; i < _cStates; ++i) {
+        if (_stateCompleted(i)) {
+            progressWeight += _rgProgressWeights[i];
+        } else if (_stateRunning(i)) {
+            progressWeight += _rgProgressWeights[i] * _rgStateProgress[i];
+        }
     }
-    int currentWeight = _stateIndex < _cStates ? _rgProgressWeights[_stateIndex] : 1;
-    return (progressWeight + currentWeight * subProgress) / (float)_progressWeightTotal;
+    return progressWeight / (float)_progressWeightTotal;
 }
 
 void InitialConnectStateMachine::_stateRequestAutopilotVersion(StateMachine* stateMachine)
@@ -78,11 +111,11 @@ void InitialConnectStateMachine::_stateRequestAutopilotVersion(StateMachine* sta
 
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:AUTOPILOT_VERSION request due to no primary link";
-        connectMachine->advance();
+        connectMachine->stateComplete(_stateRequestAutopilotVersion);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:AUTOPILOT_VERSION request due to link type";
-            connectMachine->advance();
+            connectMachine->stateComplete(_stateRequestAutopilotVersion);
         } else {
             qCDebug(InitialConnectStateMachineLog) << "Sending REQUEST_MESSAGE:AUTOPILOT_VERSION";
             vehicle->requestMessage(_autopilotVersionRequestMessageHandler,
@@ -179,7 +212,7 @@ void InitialConnectStateMachine::_autopilotVersionRequestMessageHandler(void* re
         vehicle->_setCapabilities(assumedCapabilities);
     }
 
-    connectMachine->advance();
+    connectMachine->stateComplete(_stateRequestAutopilotVersion);
 }
 
 void InitialConnectStateMachine::_stateRequestProtocolVersion(StateMachine* stateMachine)
@@ -190,14 +223,14 @@ void InitialConnectStateMachine::_stateRequestProtocolVersion(StateMachine* stat
 
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:PROTOCOL_VERSION request due to no primary link";
-        connectMachine->advance();
+        connectMachine->stateComplete(_stateRequestProtocolVersion);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:PROTOCOL_VERSION request due to link type";
-            connectMachine->advance();
+            connectMachine->stateComplete(_stateRequestProtocolVersion);
         } else if (vehicle->apmFirmware()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:PROTOCOL_VERSION request due to Ardupilot firmware";
-            connectMachine->advance();
+            connectMachine->stateComplete(_stateRequestProtocolVersion);
         } else {
             qCDebug(InitialConnectStateMachineLog) << "Sending REQUEST_MESSAGE:PROTOCOL_VERSION";
             vehicle->requestMessage(_protocolVersionRequestMessageHandler,
@@ -248,7 +281,7 @@ void InitialConnectStateMachine::_protocolVersionRequestMessageHandler(void* res
         vehicle->_setMaxProtoVersionFromBothSources();
     }
 
-    connectMachine->advance();
+    connectMachine->stateComplete(_stateRequestProtocolVersion);
 }
 void InitialConnectStateMachine::_stateRequestCompInfo(StateMachine* stateMachine)
 {
@@ -276,7 +309,7 @@ void InitialConnectStateMachine::standardModesRequestCompleted()
 {
     disconnect(_vehicle->_standardModes, &StandardModes::requestCompleted, this,
                &InitialConnectStateMachine::standardModesRequestCompleted);
-    advance();
+    stateComplete(_stateRequestStandardModes);
 }
 
 void InitialConnectStateMachine::_stateRequestCompInfoComplete(void* requestAllCompleteFnData)
@@ -285,7 +318,7 @@ void InitialConnectStateMachine::_stateRequestCompInfoComplete(void* requestAllC
     disconnect(connectMachine->_vehicle->_componentInformationManager, &ComponentInformationManager::progressUpdate,
             connectMachine, &InitialConnectStateMachine::gotProgressUpdate);
 
-    connectMachine->advance();
+    connectMachine->stateComplete(_stateRequestCompInfo);
 }
 
 void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMachine)
@@ -296,7 +329,16 @@ void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMach
     qCDebug(InitialConnectStateMachineLog) << "_stateRequestParameters";
     connect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
             &InitialConnectStateMachine::gotProgressUpdate);
-    vehicle->_parameterManager->refreshAllParameters();
+    // Vehicles sharing a link take turns downloading their parameters
+    qgcApp()->toolbox()->multiVehicleManager()->requestParameterDownload(vehicle);
+}
+
+void InitialConnectStateMachine::parametersLoadComplete(void)
+{
+    disconnect(_vehicle->_parameterManager, &ParameterManager::loadProgressChanged, this,
+               &InitialConnectStateMachine::gotProgressUpdate);
+    qgcApp()->toolbox()->multiVehicleManager()->parameterDownloadComplete(_vehicle);
+    stateComplete(_stateRequestParameters);
 }
 
 void InitialConnectStateMachine::_stateRequestMission(StateMachine* stateMachine)
@@ -305,37 +347,38 @@ void InitialConnectStateMachine::_stateRequestMission(StateMachine* stateMachine
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
-            &InitialConnectStateMachine::gotProgressUpdate);
-
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to no primary link";
-        connectMachine->advance();
+        connectMachine->stateComplete(_stateRequestMission);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to link type";
             vehicle->_firstMissionLoadComplete();
         } else {
             qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission";
-            vehicle->_missionManager->loadFromVehicle();
             connect(vehicle->_missionManager, &MissionManager::progressPctChanged, connectMachine,
                     &InitialConnectStateMachine::gotProgressUpdate);
+            vehicle->_missionManager->loadFromVehicle();
         }
     }
 }
 
+void InitialConnectStateMachine::missionLoadComplete(void)
+{
+    disconnect(_vehicle->_missionManager, &MissionManager::progressPctChanged, this,
+               &InitialConnectStateMachine::gotProgressUpdate);
+    stateComplete(_stateRequestMission);
+}
+
 void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachine)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_missionManager, &MissionManager::progressPctChanged, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
-
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to no primary link";
-        connectMachine->advance();
+        connectMachine->stateComplete(_stateRequestGeoFence);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to link type";
@@ -343,9 +386,9 @@ void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachin
         } else {
             if (vehicle->_geoFenceManager->supported()) {
                 qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence";
-                vehicle->_geoFenceManager->loadFromVehicle();
                 connect(vehicle->_geoFenceManager, &GeoFenceManager::progressPctChanged, connectMachine,
                         &InitialConnectStateMachine::gotProgressUpdate);
+                vehicle->_geoFenceManager->loadFromVehicle();
             } else {
                 qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: skipped due to no support";
                 vehicle->_firstGeoFenceLoadComplete();
@@ -354,27 +397,31 @@ void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachin
     }
 }
 
+void InitialConnectStateMachine::geoFenceLoadComplete(void)
+{
+    disconnect(_vehicle->_geoFenceManager, &GeoFenceManager::progressPctChanged, this,
+               &InitialConnectStateMachine::gotProgressUpdate);
+    stateComplete(_stateRequestGeoFence);
+}
+
 void InitialConnectStateMachine::_stateRequestRallyPoints(StateMachine* stateMachine)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_geoFenceManager, &GeoFenceManager::progressPctChanged, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
-
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to no primary link";
-        connectMachine->advance();
+        connectMachine->stateComplete(_stateRequestRallyPoints);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to link type";
             vehicle->_firstRallyPointLoadComplete();
         } else {
             if (vehicle->_rallyPointManager->supported()) {
-                vehicle->_rallyPointManager->loadFromVehicle();
                 connect(vehicle->_rallyPointManager, &RallyPointManager::progressPctChanged, connectMachine,
                         &InitialConnectStateMachine::gotProgressUpdate);
+                vehicle->_rallyPointManager->loadFromVehicle();
             } else {
                 qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: skipping due to no support";
                 vehicle->_firstRallyPointLoadComplete();
@@ -383,16 +430,19 @@ void InitialConnectStateMachine::_stateRequestRallyPoints(StateMachine* stateMac
     }
 }
 
+void InitialConnectStateMachine::rallyPointsLoadComplete(void)
+{
+    disconnect(_vehicle->_rallyPointManager, &RallyPointManager::progressPctChanged, this,
+               &InitialConnectStateMachine::gotProgressUpdate);
+    stateComplete(_stateRequestRallyPoints);
+}
+
 void InitialConnectStateMachine::_stateSignalInitialConnectComplete(StateMachine* stateMachine)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    disconnect(vehicle->_rallyPointManager, &RallyPointManager::progressPctChanged, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
-
-    connectMachine->advance();
+    connectMachine->stateComplete(_stateSignalInitialConnectComplete);
     qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete";
     emit vehicle->initialConnectComplete();
 }
-
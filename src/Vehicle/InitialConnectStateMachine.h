@@ -9,7 +9,7 @@
 
 #pragma once
 
-#include "StateMachine.h"
+#include "ParallelStateMachine.h"
 #include "QGCMAVLink.h"
 #include "Vehicle.h"
 
@@ -19,20 +19,29 @@ Q_DECLARE_LOGGING_CATEGORY(InitialConnectStateMachineLog)
 
 class Vehicle;
 
-class InitialConnectStateMachine : public StateMachine
+/// Requests everything needed from a newly connected vehicle. Requests which don't depend on each other run in
+/// parallel, such as the plan downloads alongside the component information and parameters.
+class InitialConnectStateMachine : public ParallelStateMachine
 {
     Q_OBJECT
 
 public:
     InitialConnectStateMachine(Vehicle* vehicle);
 
-    // Overrides from StateMachine
-    int             stateCount      (void) const final;
-    const StateFn*  rgStates        (void) const final;
-    void            statesCompleted (void) const final;
+    // Overrides from ParallelStateMachine
+    int             stateCount          (void) const final;
+    const StateFn*  rgStates            (void) const final;
+    quint32         stateDependencies   (int stateIndex) const final;
+    void            statesCompleted     (void) const final;
 
     void advance() override;
 
+    // Called by Vehicle once the first load of the respective data is done
+    void parametersLoadComplete     (void);
+    void missionLoadComplete        (void);
+    void geoFenceLoadComplete       (void);
+    void rallyPointsLoadComplete    (void);
+
 signals:
     void progressUpdate(float progress);
 
@@ -55,7 +64,7 @@ private:
     static void _autopilotVersionRequestMessageHandler  (void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& message);
     static void _protocolVersionRequestMessageHandler   (void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& message);
 
-    float _progress(float subProgress = 0.f);
+    float _progress(void) const;
 
     Vehicle* _vehicle;
 
@@ -64,8 +73,8 @@ private:
     static constexpr const StateMachine::StateFn _rgStates[] = {
         _stateRequestAutopilotVersion,
         _stateRequestProtocolVersion,
-        _stateRequestStandardModes,
         _stateRequestCompInfo,
+        _stateRequestStandardModes,
         _stateRequestParameters,
         _stateRequestMission,
         _stateRequestGeoFence,
@@ -76,8 +85,8 @@ private:
     static constexpr const int _rgProgressWeights[] = {
         1, //_stateRequestCapabilities
         1, //_stateRequestProtocolVersion
-        1, //_stateRequestStandardModes
         5, //_stateRequestCompInfo
+        1, //_stateRequestStandardModes
         5, //_stateRequestParameters
         2, //_stateRequestMission
         1, //_stateRequestGeoFence
@@ -85,5 +94,21 @@ private:
         1, //_stateSignalInitialConnectComplete
     };
 
+    // Only one REQUEST_MESSAGE command can be outstanding per component, so the states using it run one after another.
+    // The vehicle only handles one mission protocol transfer at a time, the plan downloads are chained for that reason.
+    static constexpr const quint32 _rgStateDependencies[] = {
+        0,                  //_stateRequestAutopilotVersion
+        1u << 0,            //_stateRequestProtocolVersion
+        1u << 1,            //_stateRequestCompInfo: downloads need the protocol version
+        1u << 2,            //_stateRequestStandardModes
+        1u << 2,            //_stateRequestParameters: needs the parameter meta data
+        1u << 1,            //_stateRequestMission: needs the capabilities and the protocol version
+        1u << 5,            //_stateRequestGeoFence
+        1u << 6,            //_stateRequestRallyPoints
+        (1u << 8) - 1,      //_stateSignalInitialConnectComplete: everything else
+    };
+
     static constexpr int _cStates = sizeof(_rgStates) / sizeof(_rgStates[0]);
+
+    float _rgStateProgress[_cStates] = {};  ///< Progress of the running states, [0.0,1.0]
 };
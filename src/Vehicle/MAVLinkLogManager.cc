@@ -16,7 +16,7 @@
 
 #include <QtQml/QQmlEngine>
 #include <QtCore/QSettings>
-#include <QtNetwork/QHttpPart>
+#include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkProxy>
 #include <QtCore/QDirIterator>
@@ -106,7 +106,6 @@ MAVLinkLogProcessor::MAVLinkLogProcessor()
     , _numDrops(0)
     , _gotHeader(false)
     , _error(false)
-    , _record(nullptr)
 {
 }
 
@@ -128,25 +127,15 @@ MAVLinkLogProcessor::close()
 
 //-----------------------------------------------------------------------------
 bool
-MAVLinkLogProcessor::valid()
+MAVLinkLogProcessor::open(const QString& fileName)
 {
-    return (_fd != nullptr) && (_record != nullptr);
-}
-
-//-----------------------------------------------------------------------------
-bool
-MAVLinkLogProcessor::create(MAVLinkLogManager* manager, const QString path, uint8_t id)
-{
-    _fileName = _fileName.asprintf("%s/%03d-%s%s",
-                      path.toLatin1().data(),
-                      id,
-                      QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss-zzz").toLocal8Bit().data(),
-                      manager->logExtension().toLocal8Bit().data());
+    _fileName = fileName;
     _fd = fopen(_fileName.toLocal8Bit().data(), "wb");
     if(_fd) {
-        _record = new MAVLinkLogFiles(manager, _fileName, true);
-        _record->setWriting(true);
+        //-- Fully buffered, the buffer is flushed to disk with each stats update
+        setvbuf(_fd, nullptr, _IOFBF, _writeBufferSize);
         _sequence = -1;
+        _statsTimer.start();
         return true;
     }
     return false;
@@ -194,9 +183,6 @@ MAVLinkLogProcessor::_writeData(void* data, int len)
         _error = fwrite(data, 1, len, _fd) != (size_t)len;
         if(!_error) {
             _written += len;
-            if(_record) {
-                _record->setSize(_written);
-            }
         } else {
             qCDebug(MAVLinkLogManagerLog) << "File IO error:" << len << "bytes into" << _fileName;
         }
@@ -221,9 +207,12 @@ MAVLinkLogProcessor::_writeUlogMessage(QByteArray& data)
 }
 
 //-----------------------------------------------------------------------------
-bool
+void
 MAVLinkLogProcessor::processStreamData(uint16_t sequence, uint8_t first_message, QByteArray data)
 {
+    if(!_fd) {
+        return;
+    }
     int num_drops = 0;
     _error = false;
     while(_checkSequence(sequence, num_drops)) {
@@ -232,7 +221,8 @@ MAVLinkLogProcessor::processStreamData(uint16_t sequence, uint8_t first_message,
             if(data.size() < 16) {
                 //-- Shouldn't happen but if it does, we might as well close shop.
                 qCWarning(MAVLinkLogManagerLog) << "Corrupt log header. Canceling log download.";
-                return false;
+                emit writeFailed();
+                return;
             }
             //-- Write header
             _writeData(data.data(), 16);
@@ -278,7 +268,20 @@ MAVLinkLogProcessor::processStreamData(uint16_t sequence, uint8_t first_message,
         _ulogMessage = _writeUlogMessage(data);
         break;
     }
-    return !_error;
+    if(_error) {
+        emit writeFailed();
+        return;
+    }
+    if(_statsTimer.elapsed() >= _statsIntervalMsecs) {
+        _statsTimer.restart();
+        _error = fflush(_fd) != 0;
+        if(_error) {
+            qCDebug(MAVLinkLogManagerLog) << "File IO error flushing" << _fileName;
+            emit writeFailed();
+            return;
+        }
+        emit statsChanged(_written, _numDrops);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -288,11 +291,13 @@ MAVLinkLogManager::MAVLinkLogManager(QGCApplication* app, QGCToolbox* toolbox)
     , _enableAutoUpload(true)
     , _enableAutoStart(false)
     , _nam(nullptr)
-    , _currentLogfile(nullptr)
+    , _uploadRateLimit(0)
     , _vehicle(nullptr)
     , _logRunning(false)
     , _loggingDisabled(false)
     , _logProcessor(nullptr)
+    , _logRecord(nullptr)
+    , _logDropCount(0)
     , _deleteAfterUpload(false)
     , _windSpeed(-1)
     , _publicLog(false)
@@ -311,11 +316,21 @@ MAVLinkLogManager::MAVLinkLogManager(QGCApplication* app, QGCToolbox* toolbox)
     setWindSpeed(settings.value(kWindSpeedKey, -1).toInt());
     setRating(settings.value(kRateKey, "notset").toString());
     setPublicLog(settings.value(kPublicLogKey, true).toBool());
+    setUploadRateLimit(settings.value(kUploadRateLimitKey, 0).toInt());
+
+    _logThread.setObjectName(QStringLiteral("MAVLinkLog"));
+    _logThread.start();
 }
 
 //-----------------------------------------------------------------------------
 MAVLinkLogManager::~MAVLinkLogManager()
 {
+    //-- Uploads go before the network access manager which owns their replies
+    qDeleteAll(_uploads);
+    _uploads.clear();
+    _releaseLogProcessor();
+    _logThread.quit();
+    _logThread.wait();
     _logFiles.clear();
 }
 
@@ -346,6 +361,8 @@ MAVLinkLogManager::setToolbox(QGCToolbox* toolbox)
         }
         qCDebug(MAVLinkLogManagerLog) << "MAVLink logs directory:" << _logPath;
         connect(toolbox->multiVehicleManager(), &MultiVehicleManager::activeVehicleChanged, this, &MAVLinkLogManager::_activeVehicleChanged);
+        // Created on first use, so a vehicle may already be active
+        _activeVehicleChanged(toolbox->multiVehicleManager()->activeVehicle());
     }
 }
 
@@ -470,39 +487,46 @@ MAVLinkLogManager::setPublicLog(bool pub)
     emit publicLogChanged();
 }
 
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogManager::setUploadRateLimit(int kbPerSecond)
+{
+    _uploadRateLimit = qMax(0, kbPerSecond);
+    _uploadLimiter.setRate(static_cast<qint64>(_uploadRateLimit) * 1024);
+    QSettings settings;
+    settings.beginGroup(kMAVLinkLogGroup);
+    settings.setValue(kUploadRateLimitKey, _uploadRateLimit);
+    emit uploadRateLimitChanged();
+}
+
 //-----------------------------------------------------------------------------
 bool
 MAVLinkLogManager::uploading()
 {
-    return _currentLogfile != nullptr;
+    return !_uploads.isEmpty();
 }
 
 //-----------------------------------------------------------------------------
 void
 MAVLinkLogManager::uploadLog()
 {
-    if(_currentLogfile) {
-        _currentLogfile->setUploading(false);
-    }
-    for(int i = 0; i < _logFiles.count(); i++) {
-        _currentLogfile = qobject_cast<MAVLinkLogFiles*>(_logFiles.get(i));
-        if (_currentLogfile) {
-            if(_currentLogfile->selected()) {
-                _currentLogfile->setSelected(false);
-                if(!_currentLogfile->uploaded() && !_emailAddress.isEmpty() && !_uploadURL.isEmpty()) {
-                    _currentLogfile->setUploading(true);
-                    _currentLogfile->setProgress(0.0);
-                    QString filePath = _makeFilename(_currentLogfile->name());
-                    _sendLog(filePath);
-                    emit uploadingChanged();
-                    return;
+    for(int i = 0; i < _logFiles.count() && _uploads.count() < kMaxConcurrentUploads; i++) {
+        MAVLinkLogFiles* log = qobject_cast<MAVLinkLogFiles*>(_logFiles.get(i));
+        if (log) {
+            if(log->selected() && !_uploads.contains(log)) {
+                log->setSelected(false);
+                if(!log->uploaded() && !_emailAddress.isEmpty() && !_uploadURL.isEmpty()) {
+                    log->setUploading(true);
+                    log->setProgress(0.0);
+                    if(!_sendLog(log)) {
+                        log->setUploading(false);
+                    }
                 }
             }
         } else {
             qWarning() << "Internal error";
         }
     }
-    _currentLogfile = nullptr;
     emit uploadingChanged();
 }
 
@@ -561,11 +585,21 @@ MAVLinkLogManager::deleteLog()
 void
 MAVLinkLogManager::_deleteLog(MAVLinkLogFiles* log)
 {
+    //-- Stop its upload (if any)
+    MAVLinkLogUpload* upload = _uploads.take(log);
+    if(upload) {
+        upload->disconnect(this);
+        delete upload;
+        emit uploadingChanged();
+    }
     QString filePath = _makeFilename(log->name());
     QFile gone(filePath);
     if(!gone.remove()) {
         qCWarning(MAVLinkLogManagerLog) << "Could not delete MAVLink log file:" << _logPath;
     }
+    //-- Remove resumable upload leftovers (if any)
+    QFile::remove(MAVLinkLogUpload::tusSidecarFile(filePath));
+    QFile::remove(MAVLinkLogUpload::gzipFile(filePath));
     //-- Remove sidecar file (if any)
     filePath.replace(_ulogExtension, kSidecarExtension);
     QFile sgone(filePath);
@@ -585,14 +619,14 @@ MAVLinkLogManager::cancelUpload()
     for(int i = 0; i < _logFiles.count(); i++) {
         MAVLinkLogFiles* pLogFile = qobject_cast<MAVLinkLogFiles*>(_logFiles.get(i));
         if (pLogFile) {
-            if(pLogFile->selected() && pLogFile != _currentLogfile) {
+            if(pLogFile->selected() && !_uploads.contains(pLogFile)) {
                 pLogFile->setSelected(false);
             }
         } else {
             qWarning() << "Internal error";
         }
     }
-    if(_currentLogfile) {
+    if(uploading()) {
         emit abortUpload();
     }
 }
@@ -623,43 +657,50 @@ MAVLinkLogManager::stopLogging()
         _vehicle->stopMavlinkLog();
     }
     if(_logProcessor) {
-        _logProcessor->close();
-        if(_logProcessor->record()) {
-            _logProcessor->record()->setWriting(false);
+        //-- The log file is complete on disk once this returns
+        _releaseLogProcessor();
+        if(_logRecord) {
+            _logRecord->setWriting(false);
             if(_enableAutoUpload) {
                 //-- Queue log for auto upload (set selected flag)
-                _logProcessor->record()->setSelected(true);
-                if(!uploading()) {
-                    uploadLog();
-                }
+                _logRecord->setSelected(true);
+                uploadLog();
             }
+            _logRecord = nullptr;
         }
-        delete _logProcessor;
-        _logProcessor = nullptr;
         _logRunning = false;
         emit logRunningChanged();
     }
 }
 
 //-----------------------------------------------------------------------------
-QHttpPart
-create_form_part(const QString& name, const QString& value)
-{
-    QHttpPart formPart;
-    formPart.setHeader(QNetworkRequest::ContentDispositionHeader, QString("form-data; name=\"%1\"").arg(name));
-    formPart.setBody(value.toUtf8());
-    return formPart;
-}
-
-//-----------------------------------------------------------------------------
-bool
-MAVLinkLogManager::_sendLog(const QString& logFile)
+MAVLinkLogUpload::FormFields_t
+MAVLinkLogManager::_uploadFields()
 {
     QString defaultDescription = _description;
     if(_description.isEmpty()) {
         qCWarning(MAVLinkLogManagerLog) << "Log description missing. Using defaults.";
         defaultDescription = kDefaultDescr;
     }
+    MAVLinkLogUpload::FormFields_t fields;
+    fields.append(qMakePair(QStringLiteral("email"),        _emailAddress));
+    fields.append(qMakePair(QStringLiteral("description"),  defaultDescription));
+    fields.append(qMakePair(QStringLiteral("source"),       QStringLiteral("QGroundControl")));
+    fields.append(qMakePair(QStringLiteral("version"),      _app->applicationVersion()));
+    fields.append(qMakePair(QStringLiteral("type"),         QStringLiteral("flightreport")));
+    fields.append(qMakePair(QStringLiteral("windSpeed"),    QString::number(_windSpeed)));
+    fields.append(qMakePair(QStringLiteral("rating"),       _rating));
+    fields.append(qMakePair(QStringLiteral("public"),       QString(_publicLog ? "true" : "false")));
+    //-- Optional
+    fields.append(qMakePair(QString(kFeedback),             _feedback.isEmpty() ? QStringLiteral("None Given") : _feedback));
+    fields.append(qMakePair(QString(kVideoURL),             _videoURL.isEmpty() ? QStringLiteral("None") : _videoURL));
+    return fields;
+}
+
+//-----------------------------------------------------------------------------
+bool
+MAVLinkLogManager::_sendLog(MAVLinkLogFiles* log)
+{
     if(_emailAddress.isEmpty()) {
         qCWarning(MAVLinkLogManagerLog) << "User email missing.";
         return false;
@@ -668,76 +709,25 @@ MAVLinkLogManager::_sendLog(const QString& logFile)
         qCWarning(MAVLinkLogManagerLog) << "Upload URL missing.";
         return false;
     }
-    QFileInfo fi(logFile);
-    if(!fi.exists()) {
+    const QString logFile = _makeFilename(log->name());
+    if(!QFileInfo::exists(logFile)) {
         qCWarning(MAVLinkLogManagerLog) << "Log file missing:" << logFile;
         return false;
     }
-    QFile* file = new QFile(logFile);
-    if(!file || !file->open(QIODevice::ReadOnly)) {
-        delete file;
-        file = nullptr;
-        qCWarning(MAVLinkLogManagerLog) << "Could not open log file:" << logFile;
-        return false;
-    }
     if(!_nam) {
         _nam = new QNetworkAccessManager(this);
-    }
-    QNetworkProxy savedProxy = _nam->proxy();
-    QNetworkProxy tempProxy;
-    tempProxy.setType(QNetworkProxy::DefaultProxy);
-    _nam->setProxy(tempProxy);
-    //-- Build POST request
-    QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
-    QHttpPart emailPart = create_form_part("email", _emailAddress);
-    QHttpPart descriptionPart = create_form_part("description", _description);
-    QHttpPart sourcePart      = create_form_part("source", "QGroundControl");
-    QHttpPart versionPart     = create_form_part("version", _app->applicationVersion());
-    QHttpPart typePart        = create_form_part("type", "flightreport");
-    QHttpPart windPart        = create_form_part("windSpeed", QString::number(_windSpeed));
-    QHttpPart ratingPart      = create_form_part("rating", _rating);
-    QHttpPart publicPart      = create_form_part("public", _publicLog ? "true" : "false");
-    //-- Assemble request and POST it
-    multiPart->append(emailPart);
-    multiPart->append(descriptionPart);
-    multiPart->append(sourcePart);
-    multiPart->append(versionPart);
-    multiPart->append(typePart);
-    multiPart->append(windPart);
-    multiPart->append(ratingPart);
-    multiPart->append(publicPart);
-    //-- Optional
-    QHttpPart feedbackPart;
-    if(_feedback.isEmpty()) {
-        feedbackPart = create_form_part(kFeedback, "None Given");
-    } else {
-        feedbackPart = create_form_part(kFeedback, _feedback);
-    }
-    multiPart->append(feedbackPart);
-    QHttpPart videoPart;
-    if(_videoURL.isEmpty()) {
-        videoPart = create_form_part(kVideoURL, "None");
-    } else {
-        videoPart = create_form_part(kVideoURL, _videoURL);
-    }
-    multiPart->append(videoPart);
-    //-- Actual Log File
-    QHttpPart logPart;
-    logPart.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
-    logPart.setHeader(QNetworkRequest::ContentDispositionHeader, QString("form-data; name=\"filearg\"; filename=\"%1\"").arg(fi.fileName()));
-    logPart.setBodyDevice(file);
-    multiPart->append(logPart);
-    file->setParent(multiPart);
-    QNetworkRequest request(_uploadURL);
-    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
-    QNetworkReply* reply = _nam->post(request, multiPart);
-    connect(reply, &QNetworkReply::finished,  this, &MAVLinkLogManager::_uploadFinished);
-    connect(this, &MAVLinkLogManager::abortUpload, reply, &QNetworkReply::abort);
-    //connect(reply, &QNetworkReply::readyRead, this, &MAVLinkLogManager::_dataAvailable);
-    connect(reply, &QNetworkReply::uploadProgress, this, &MAVLinkLogManager::_uploadProgress);
-    multiPart->setParent(reply);
-    qCDebug(MAVLinkLogManagerLog) << "Log" << fi.baseName() << "Uploading." << fi.size() << "bytes.";
-    _nam->setProxy(savedProxy);
+        QNetworkProxy proxy;
+        proxy.setType(QNetworkProxy::DefaultProxy);
+        _nam->setProxy(proxy);
+    }
+    MAVLinkLogUpload* upload = new MAVLinkLogUpload(_nam, &_uploadLimiter, QUrl(_uploadURL), logFile, _uploadFields(), this);
+    connect(upload, &MAVLinkLogUpload::progress, log, &MAVLinkLogFiles::setProgress);
+    connect(upload, &MAVLinkLogUpload::finished, this, [this, log](bool success, int http_code, QByteArray data) {
+        _uploadFinished(log, success, http_code, data);
+    });
+    connect(this, &MAVLinkLogManager::abortUpload, upload, &MAVLinkLogUpload::abort);
+    _uploads[log] = upload;
+    upload->start();
     return true;
 }
 
@@ -764,56 +754,36 @@ MAVLinkLogManager::_dataAvailable()
 
 //-----------------------------------------------------------------------------
 void
-MAVLinkLogManager::_uploadFinished()
+MAVLinkLogManager::_uploadFinished(MAVLinkLogFiles* log, bool success, int http_code, QByteArray data)
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if(!reply) {
-        return;
+    MAVLinkLogUpload* upload = _uploads.take(log);
+    if(upload) {
+        upload->deleteLater();
     }
-    const int http_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    QByteArray data = reply->readAll();
-    if(_processUploadResponse(http_code, data)) {
+    log->setUploading(false);
+    if(success && _processUploadResponse(http_code, data)) {
         qCDebug(MAVLinkLogManagerLog) << "Log uploaded.";
         emit succeed();
         if(_deleteAfterUpload) {
-            if(_currentLogfile) {
-                _deleteLog(_currentLogfile);
-                _currentLogfile = nullptr;
-            }
+            _deleteLog(log);
         } else {
-            if(_currentLogfile) {
-                _currentLogfile->setUploaded(true);
-                //-- Write side-car file to flag it as uploaded
-                QString sideCar = _makeFilename(_currentLogfile->name());
-                sideCar.replace(_ulogExtension, kSidecarExtension);
-                FILE* f = fopen(sideCar.toLatin1().data(), "wb");
-                if(f) {
-                    fclose(f);
-                }
+            log->setUploaded(true);
+            //-- Write side-car file to flag it as uploaded
+            QString sideCar = _makeFilename(log->name());
+            sideCar.replace(_ulogExtension, kSidecarExtension);
+            FILE* f = fopen(sideCar.toLatin1().data(), "wb");
+            if(f) {
+                fclose(f);
             }
         }
     } else {
-        qCWarning(MAVLinkLogManagerLog) << QString("Log Upload Error: %1 status: %2").arg(reply->errorString(), reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toString());
+        qCWarning(MAVLinkLogManagerLog) << "Log Upload Error:" << log->name() << "status:" << http_code;
         emit failed();
     }
-    reply->deleteLater();
     //-- Next (if any)
     uploadLog();
 }
 
-//-----------------------------------------------------------------------------
-void
-MAVLinkLogManager::_uploadProgress(qint64 bytesSent, qint64 bytesTotal)
-{
-    if(bytesTotal) {
-        qreal progress = static_cast<qreal>(bytesSent) / static_cast<qreal>(bytesTotal);
-        if(_currentLogfile) {
-            _currentLogfile->setProgress(progress);
-        }
-    }
-    qCDebug(MAVLinkLogManagerLog) << bytesSent << "of" << bytesTotal;
-}
-
 //-----------------------------------------------------------------------------
 void
 MAVLinkLogManager::_activeVehicleChanged(Vehicle* vehicle)
@@ -850,20 +820,68 @@ MAVLinkLogManager::_activeVehicleChanged(Vehicle* vehicle)
 void
 MAVLinkLogManager::_mavlinkLogData(Vehicle* /*vehicle*/, uint8_t /*target_system*/, uint8_t /*target_component*/, uint16_t sequence, uint8_t first_message, QByteArray data, bool /*acked*/)
 {
-    if(_logProcessor && _logProcessor->valid()) {
-        if(!_logProcessor->processStreamData(sequence, first_message, data)) {
-            qCWarning(MAVLinkLogManagerLog) << "Error writing MAVLink log file:" << _logProcessor->fileName();
-            delete _logProcessor;
-            _logProcessor = nullptr;
-            _logRunning = false;
-            _vehicle->stopMavlinkLog();
-            emit logRunningChanged();
-        }
+    //-- Acked data was already acknowledged by the vehicle when it arrived, all that is left is handing it to the log thread
+    if(_logProcessor) {
+        MAVLinkLogProcessor* processor = _logProcessor;
+        QMetaObject::invokeMethod(processor, [processor, sequence, first_message, data]() {
+            processor->processStreamData(sequence, first_message, data);
+        }, Qt::QueuedConnection);
     } else {
         qCWarning(MAVLinkLogManagerLog) << "MAVLink log data received when not expected.";
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogManager::_logWriteFailed()
+{
+    qCWarning(MAVLinkLogManagerLog) << "Error writing MAVLink log file:" << _logProcessor->fileName();
+    _releaseLogProcessor();
+    if(_logRecord) {
+        _logRecord->setWriting(false);
+        _logRecord = nullptr;
+    }
+    _logRunning = false;
+    if(_vehicle) {
+        _vehicle->stopMavlinkLog();
+    }
+    emit logRunningChanged();
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogManager::_logStatsChanged(quint32 written, int numDrops)
+{
+    if(_logRecord) {
+        _logRecord->setSize(written);
+    }
+    if(_logDropCount != numDrops) {
+        _logDropCount = numDrops;
+        emit logDropCountChanged();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogManager::_releaseLogProcessor()
+{
+    if(!_logProcessor) {
+        return;
+    }
+    //-- Close and delete on the log thread, waiting for the data still queued ahead of this to be written
+    MAVLinkLogProcessor* processor = _logProcessor;
+    _logProcessor = nullptr;
+    quint32 written = 0;
+    QMetaObject::invokeMethod(processor, [processor, &written]() {
+        processor->close();
+        written = processor->written();
+        delete processor;
+    }, Qt::BlockingQueuedConnection);
+    if(_logRecord) {
+        _logRecord->setSize(written);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 MAVLinkLogManager::_mavCommandResult(int vehicleId, int component, int command, int result, bool noReponseFromVehicle)
@@ -897,13 +915,10 @@ void
 MAVLinkLogManager::_discardLog()
 {
     //-- Delete (empty) log file (and record)
-    if(_logProcessor) {
-        _logProcessor->close();
-        if(_logProcessor->record()) {
-            _deleteLog(_logProcessor->record());
-        }
-        delete _logProcessor;
-        _logProcessor = nullptr;
+    _releaseLogProcessor();
+    if(_logRecord) {
+        _deleteLog(_logRecord);
+        _logRecord = nullptr;
     }
     _logRunning = false;
     emit logRunningChanged();
@@ -913,17 +928,37 @@ MAVLinkLogManager::_discardLog()
 bool
 MAVLinkLogManager::_createNewLog()
 {
-    delete _logProcessor;
-    _logProcessor = new MAVLinkLogProcessor;
-    if(_logProcessor->create(this, _logPath, static_cast<uint8_t>(_vehicle->id()))) {
-        _insertNewLog(_logProcessor->record());
-        emit logFilesChanged();
-    } else {
-        qCWarning(MAVLinkLogManagerLog) << "Could not create MAVLink log file:" << _logProcessor->fileName();
-        delete _logProcessor;
-        _logProcessor = nullptr;
+    _releaseLogProcessor();
+    const QString fileName = QString::asprintf("%s/%03d-%s%s",
+                      _logPath.toLatin1().data(),
+                      _vehicle->id(),
+                      QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss-zzz").toLocal8Bit().data(),
+                      logExtension().toLocal8Bit().data());
+    MAVLinkLogProcessor* processor = new MAVLinkLogProcessor;
+    if(!processor->open(fileName)) {
+        qCWarning(MAVLinkLogManagerLog) << "Could not create MAVLink log file:" << fileName;
+        delete processor;
+        return false;
     }
-    return _logProcessor != nullptr;
+    processor->moveToThread(&_logThread);
+    //-- Signals from a processor which has been released since are stale
+    (void) connect(processor, &MAVLinkLogProcessor::statsChanged, this, [this, processor](quint32 written, int numDrops) {
+        if(processor == _logProcessor) {
+            _logStatsChanged(written, numDrops);
+        }
+    }, Qt::QueuedConnection);
+    (void) connect(processor, &MAVLinkLogProcessor::writeFailed, this, [this, processor]() {
+        if(processor == _logProcessor) {
+            _logWriteFailed();
+        }
+    }, Qt::QueuedConnection);
+    _logProcessor = processor;
+    _logRecord = new MAVLinkLogFiles(this, fileName, true);
+    _logRecord->setWriting(true);
+    _logStatsChanged(0, 0);
+    _insertNewLog(_logRecord);
+    emit logFilesChanged();
+    return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -12,9 +12,13 @@
 
 #include "QGCToolbox.h"
 #include "QmlObjectListModel.h"
+#include "MAVLinkLogUploader.h"
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QThread>
 
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkLogManagerLog)
 
@@ -72,17 +76,23 @@ private:
 };
 
 //-----------------------------------------------------------------------------
-class MAVLinkLogProcessor
+/// Writes a ULog streamed over MAVLink. After open() the processor is moved to the log thread of MAVLinkLogManager,
+/// so a busy GUI thread doesn't hold up the writes. Everything else runs on that thread.
+class MAVLinkLogProcessor : public QObject
 {
+    Q_OBJECT
 public:
     MAVLinkLogProcessor();
     ~MAVLinkLogProcessor();
+    bool                open        (const QString& fileName);
     void                close       ();
-    bool                valid       ();
-    bool                create      (MAVLinkLogManager *manager, const QString path, uint8_t id);
-    MAVLinkLogFiles*    record      () { return _record; }
     QString             fileName    () { return _fileName; }
-    bool                processStreamData(uint16_t _sequence, uint8_t first_message, QByteArray data);
+    quint32             written     () const { return _written; }
+    void                processStreamData(uint16_t _sequence, uint8_t first_message, QByteArray data);
+signals:
+    /// Emitted at most once per _statsIntervalMsecs while the log streams in
+    void                statsChanged(quint32 written, int numDrops);
+    void                writeFailed ();
 private:
     bool                _checkSequence(uint16_t seq, int &num_drops);
     QByteArray          _writeUlogMessage(QByteArray &data);
@@ -96,7 +106,10 @@ private:
     bool                _error;
     QByteArray          _ulogMessage;
     QString             _fileName;
-    MAVLinkLogFiles*    _record;
+    QElapsedTimer       _statsTimer;
+
+    static constexpr size_t _writeBufferSize    = 256 * 1024;   ///< Log streams at 100+ KB/s, write in large blocks
+    static constexpr int    _statsIntervalMsecs = 1000;         ///< Also how often the write buffer is flushed to disk
 };
 
 //-----------------------------------------------------------------------------
@@ -123,6 +136,8 @@ public:
     Q_PROPERTY(QmlObjectListModel*  logFiles            READ    logFiles                                        NOTIFY logFilesChanged)
     Q_PROPERTY(int                  windSpeed           READ    windSpeed           WRITE setWindSpeed          NOTIFY windSpeedChanged)
     Q_PROPERTY(QString              rating              READ    rating              WRITE setRating             NOTIFY ratingChanged)
+    Q_PROPERTY(int                  logDropCount        READ    logDropCount                                    NOTIFY logDropCountChanged)
+    Q_PROPERTY(int                  uploadRateLimit     READ    uploadRateLimit     WRITE setUploadRateLimit    NOTIFY uploadRateLimitChanged)     ///< KB/s, 0: unlimited
 
     Q_INVOKABLE void uploadLog      ();
     Q_INVOKABLE void deleteLog      ();
@@ -144,6 +159,8 @@ public:
     bool        publicLog           () const{ return _publicLog; }
     int         windSpeed           () const{ return _windSpeed; }
     QString     rating              () { return _rating; }
+    int         logDropCount        () const{ return _logDropCount; }
+    int         uploadRateLimit     () const{ return _uploadRateLimit; }
     QString     logExtension        () { return _ulogExtension; }
 
     QmlObjectListModel* logFiles    () { return &_logFiles; }
@@ -159,6 +176,7 @@ public:
     void        setWindSpeed        (int speed);
     void        setRating           (QString rate);
     void        setPublicLog        (bool publicLog);
+    void        setUploadRateLimit  (int kbPerSecond);
 
     // Override from QGCTool
     void        setToolbox          (QGCToolbox *toolbox);
@@ -184,18 +202,20 @@ signals:
     void ratingChanged              ();
     void videoURLChanged            ();
     void publicLogChanged           ();
+    void logDropCountChanged        ();
+    void uploadRateLimitChanged     ();
 
 private slots:
-    void _uploadFinished            ();
     void _dataAvailable             ();
-    void _uploadProgress            (qint64 bytesSent, qint64 bytesTotal);
     void _activeVehicleChanged      (Vehicle* vehicle);
     void _mavlinkLogData            (Vehicle* vehicle, uint8_t target_system, uint8_t target_component, uint16_t sequence, uint8_t first_message, QByteArray data, bool acked);
     void _armedChanged              (bool armed);
     void _mavCommandResult          (int vehicleId, int component, int command, int result, bool noReponseFromVehicle);
 
 private:
-    bool _sendLog                   (const QString& logFile);
+    bool _sendLog                   (MAVLinkLogFiles* log);
+    void _uploadFinished            (MAVLinkLogFiles* log, bool success, int http_code, QByteArray data);
+    MAVLinkLogUpload::FormFields_t _uploadFields();
     bool _processUploadResponse     (int http_code, QByteArray &data);
     bool _createNewLog              ();
     int  _getFirstSelected          ();
@@ -203,6 +223,9 @@ private:
     void _deleteLog                 (MAVLinkLogFiles* log);
     void _discardLog                ();
     QString _makeFilename           (const QString& baseName);
+    void _releaseLogProcessor       ();
+    void _logWriteFailed            ();
+    void _logStatsChanged           (quint32 written, int numDrops);
 
 private:
     QString                 _description;
@@ -215,11 +238,16 @@ private:
     bool                    _enableAutoStart;
     QNetworkAccessManager*  _nam;
     QmlObjectListModel      _logFiles;
-    MAVLinkLogFiles*        _currentLogfile;
+    QHash<MAVLinkLogFiles*, MAVLinkLogUpload*> _uploads;    ///< Uploads in progress
+    BandwidthLimiter        _uploadLimiter;                 ///< Shared by all uploads
+    int                     _uploadRateLimit;
     Vehicle*                _vehicle;
     bool                    _logRunning;
     bool                    _loggingDisabled;
-    MAVLinkLogProcessor*    _logProcessor;
+    MAVLinkLogProcessor*    _logProcessor;          ///< Lives on _logThread
+    MAVLinkLogFiles*        _logRecord;             ///< Log being written
+    int                     _logDropCount;          ///< Messages dropped from the log being written
+    QThread                 _logThread;
     bool                    _deleteAfterUpload;
     int                     _windSpeed;
     QString                 _rating;
@@ -240,6 +268,8 @@ private:
     static constexpr const char* kWindSpeedKey            = "WindSpeed";
     static constexpr const char* kRateKey                 = "RateKey";
     static constexpr const char* kPublicLogKey            = "PublicLog";
+    static constexpr const char* kUploadRateLimitKey      = "UploadRateLimit";
     static constexpr const char* kFeedback                = "feedback";
     static constexpr const char* kVideoURL                = "videoUrl";
+    static constexpr int         kMaxConcurrentUploads    = 3;
 };
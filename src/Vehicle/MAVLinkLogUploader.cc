@@ -0,0 +1,597 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogUploader.h"
+#include "QGCZlib.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QFileInfo>
+#include <QtCore/QRandomGenerator>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+
+#include <cmath>
+
+QGC_LOGGING_CATEGORY(MAVLinkLogUploaderLog, "MAVLinkLogUploaderLog")
+
+namespace {
+    /// @return true: the request may succeed when repeated (no connection, timeout, server overloaded)
+    bool transientFailure(const QNetworkReply* reply, int httpCode)
+    {
+        if (httpCode == 0) {
+            return reply->error() != QNetworkReply::NoError;
+        }
+        return (httpCode >= 500) || (httpCode == 429);
+    }
+
+    int httpStatus(const QNetworkReply* reply)
+    {
+        return reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+BandwidthLimiter::setRate(qint64 bytesPerSecond)
+{
+    _rate = qMax<qint64>(0, bytesPerSecond);
+    _tokens = 0;
+    _refillTimer.start();
+}
+
+//-----------------------------------------------------------------------------
+void
+BandwidthLimiter::_refill()
+{
+    if (!_refillTimer.isValid()) {
+        _refillTimer.start();
+        return;
+    }
+    const qint64 elapsedNsecs = _refillTimer.nsecsElapsed();
+    _refillTimer.start();
+    const double burst = qMax<double>(_minBurstBytes, _rate * _burstMsecs / 1000.0);
+    _tokens = qMin(burst, _tokens + (_rate * (elapsedNsecs / 1e9)));
+}
+
+//-----------------------------------------------------------------------------
+qint64
+BandwidthLimiter::acquire(qint64 maxBytes)
+{
+    if (_rate == 0) {
+        return maxBytes;
+    }
+    _refill();
+    const qint64 bytes = qMin(maxBytes, static_cast<qint64>(_tokens));
+    _tokens -= bytes;
+    return bytes;
+}
+
+//-----------------------------------------------------------------------------
+int
+BandwidthLimiter::msecsUntilAvailable()
+{
+    if (_rate == 0) {
+        return 0;
+    }
+    _refill();
+    // Wait for a reasonable amount instead of handing out a few bytes at a time
+    const double wanted = qMin<double>(_minBurstBytes, _rate * _burstMsecs / 1000.0);
+    if (_tokens >= wanted) {
+        return 0;
+    }
+    return qMax(1, static_cast<int>(std::ceil((wanted - _tokens) * 1000.0 / _rate)));
+}
+
+//-----------------------------------------------------------------------------
+RateLimitedUploadDevice::RateLimitedUploadDevice(BandwidthLimiter* limiter, const QByteArray& prefix, const QString& fileName, qint64 fileOffset, qint64 fileLength, const QByteArray& suffix, QObject* parent)
+    : QIODevice(parent)
+    , _limiter(limiter)
+    , _prefix(prefix)
+    , _file(fileName)
+    , _fileOffset(fileOffset)
+    , _fileLength(fileLength)
+    , _suffix(suffix)
+    , _size(prefix.size() + fileLength + suffix.size())
+{
+    _throttleTimer.setSingleShot(true);
+    (void) connect(&_throttleTimer, &QTimer::timeout, this, &QIODevice::readyRead);
+}
+
+//-----------------------------------------------------------------------------
+bool
+RateLimitedUploadDevice::open(OpenMode mode)
+{
+    if (!_file.open(QIODevice::ReadOnly)) {
+        setErrorString(_file.errorString());
+        return false;
+    }
+    if (!_file.seek(_fileOffset)) {
+        setErrorString(_file.errorString());
+        _file.close();
+        return false;
+    }
+    _pos = 0;
+    // Unbuffered, otherwise QIODevice reads ahead of the pacing
+    return QIODevice::open(mode | QIODevice::Unbuffered);
+}
+
+//-----------------------------------------------------------------------------
+void
+RateLimitedUploadDevice::close()
+{
+    _throttleTimer.stop();
+    _file.close();
+    QIODevice::close();
+}
+
+//-----------------------------------------------------------------------------
+qint64
+RateLimitedUploadDevice::readData(char* data, qint64 maxlen)
+{
+    if (_pos >= _size) {
+        return -1;
+    }
+
+    const qint64 wanted = qMin(maxlen, _size - _pos);
+    const qint64 allowed = _limiter ? _limiter->acquire(wanted) : wanted;
+    if (allowed == 0) {
+        if (!_throttleTimer.isActive()) {
+            _throttleTimer.start(_limiter->msecsUntilAvailable());
+        }
+        return 0;
+    }
+
+    qint64 done = 0;
+    while (done < allowed) {
+        const qint64 fileStart = _prefix.size();
+        const qint64 suffixStart = fileStart + _fileLength;
+        qint64 count;
+        if (_pos < fileStart) {
+            count = qMin(allowed - done, fileStart - _pos);
+            memcpy(data + done, _prefix.constData() + _pos, count);
+        } else if (_pos < suffixStart) {
+            count = _file.read(data + done, qMin(allowed - done, suffixStart - _pos));
+            if (count <= 0) {
+                setErrorString(_file.errorString());
+                return -1;
+            }
+        } else {
+            count = allowed - done;
+            memcpy(data + done, _suffix.constData() + (_pos - suffixStart), count);
+        }
+        done += count;
+        _pos += count;
+    }
+
+    return done;
+}
+
+//-----------------------------------------------------------------------------
+qint64
+RateLimitedUploadDevice::writeData(const char* /*data*/, qint64 /*len*/)
+{
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+MAVLinkLogUpload::MAVLinkLogUpload(QNetworkAccessManager* nam, BandwidthLimiter* limiter, const QUrl& url, const QString& logFile, const FormFields_t& fields, QObject* parent)
+    : QObject(parent)
+    , _nam(nam)
+    , _limiter(limiter)
+    , _url(url)
+    , _logFile(logFile)
+    , _fields(fields)
+{
+    _retryTimer.setSingleShot(true);
+    (void) connect(&_retryTimer, &QTimer::timeout, this, [this]() {
+        (this->*_retryStep)();
+    });
+    (void) connect(&_compressWatcher, &QFutureWatcherBase::finished, this, &MAVLinkLogUpload::_compressFinished);
+}
+
+//-----------------------------------------------------------------------------
+MAVLinkLogUpload::~MAVLinkLogUpload()
+{
+    if (_reply) {
+        _reply->disconnect(this);
+        _reply->abort();
+        _reply->deleteLater();
+    }
+}
+
+//-----------------------------------------------------------------------------
+QString
+MAVLinkLogUpload::tusSidecarFile(const QString& logFile)
+{
+    return logFile + QStringLiteral(".tus");
+}
+
+//-----------------------------------------------------------------------------
+QString
+MAVLinkLogUpload::gzipFile(const QString& logFile)
+{
+    return logFile + QStringLiteral(".gz");
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::start()
+{
+    // Pick up an upload which was interrupted earlier
+    QFile sidecar(tusSidecarFile(_logFile));
+    if (sidecar.exists() && QFile::exists(gzipFile(_logFile)) && sidecar.open(QIODevice::ReadOnly)) {
+        _tusLocation = QUrl(QString::fromUtf8(sidecar.readAll().trimmed()));
+        sidecar.close();
+        if (_tusLocation.isValid()) {
+            _tusLength = QFileInfo(gzipFile(_logFile)).size();
+            qCDebug(MAVLinkLogUploaderLog) << "Resuming upload" << _logFile << _tusLocation;
+            _head();
+            return;
+        }
+    }
+    _clearTusState();
+    _probe();
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::abort()
+{
+    if (_aborted) {
+        return;
+    }
+    _aborted = true;
+    _retryTimer.stop();
+    if (_reply) {
+        _reply->disconnect(this);
+        _reply->abort();
+        _reply->deleteLater();
+        _reply = nullptr;
+    }
+    // The tus location and the compressed log stay, so the next upload of this log resumes
+    emit finished(false, 0, QByteArray());
+}
+
+//-----------------------------------------------------------------------------
+QNetworkReply*
+MAVLinkLogUpload::_takeReply()
+{
+    QNetworkReply* reply = _reply;
+    _reply = nullptr;
+    if (reply) {
+        reply->deleteLater();
+    }
+    return reply;
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_retry(void (MAVLinkLogUpload::*step)(), int httpCode, const QByteArray& response)
+{
+    if (++_retryCount > _maxRetries) {
+        qCWarning(MAVLinkLogUploaderLog) << "Giving up on" << _logFile << "after" << _maxRetries << "retries";
+        _finish(false, httpCode, response);
+        return;
+    }
+    const int delay = qMin(_retryMaxMsecs, _retryBaseMsecs << (_retryCount - 1));
+    qCDebug(MAVLinkLogUploaderLog) << "Retrying" << _logFile << "in" << delay << "msecs";
+    _retryStep = step;
+    _retryTimer.start(delay);
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_finish(bool success, int httpCode, const QByteArray& response)
+{
+    if (success) {
+        _clearTusState();
+        (void) QFile::remove(gzipFile(_logFile));
+    }
+    emit finished(success, httpCode, response);
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_clearTusState()
+{
+    _tusLocation.clear();
+    _tusOffset = 0;
+    (void) QFile::remove(tusSidecarFile(_logFile));
+}
+
+//-----------------------------------------------------------------------------
+QNetworkRequest
+MAVLinkLogUpload::_tusRequest(const QUrl& url) const
+{
+    QNetworkRequest request(url);
+    request.setRawHeader("Tus-Resumable", _tusVersion);
+    return request;
+}
+
+//-----------------------------------------------------------------------------
+QByteArray
+MAVLinkLogUpload::_uploadMetadata() const
+{
+    QByteArrayList metadata;
+    for (const QPair<QString, QString>& field : _fields) {
+        metadata.append(field.first.toUtf8() + ' ' + field.second.toUtf8().toBase64());
+    }
+    metadata.append(QByteArray("filename ") + QFileInfo(_logFile).fileName().toUtf8().toBase64());
+    metadata.append(QByteArray("encoding ") + QByteArray("gzip").toBase64());
+    return metadata.join(',');
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_probe()
+{
+    QNetworkRequest request = _tusRequest(_url);
+    _reply = _nam->sendCustomRequest(request, "OPTIONS");
+    (void) connect(_reply, &QNetworkReply::finished, this, &MAVLinkLogUpload::_probeFinished);
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_probeFinished()
+{
+    QNetworkReply* reply = _takeReply();
+    const int httpCode = httpStatus(reply);
+    if (httpCode == 0 && reply->error() != QNetworkReply::NoError) {
+        _retry(&MAVLinkLogUpload::_probe, httpCode, QByteArray());
+        return;
+    }
+    _retryCount = 0;
+    if (reply->hasRawHeader("Tus-Version") || reply->hasRawHeader("Tus-Resumable")) {
+        qCDebug(MAVLinkLogUploaderLog) << "Server supports resumable uploads" << _url;
+        _compress();
+    } else {
+        _post();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_compress()
+{
+    // Compressed to a file rather than on the fly, so the offsets of a resumed upload refer to the same bytes
+    const QString logFile = _logFile;
+    const QString gzFile = gzipFile(_logFile);
+    _compressWatcher.setFuture(QtConcurrent::run([logFile, gzFile]() {
+        return QGCZlib::deflateGzipFile(logFile, gzFile);
+    }));
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_compressFinished()
+{
+    if (_aborted) {
+        return;
+    }
+    if (!_compressWatcher.result()) {
+        qCWarning(MAVLinkLogUploaderLog) << "Compressing log failed, uploading it as is:" << _logFile;
+        (void) QFile::remove(gzipFile(_logFile));
+        _post();
+        return;
+    }
+    _tusLength = QFileInfo(gzipFile(_logFile)).size();
+    qCDebug(MAVLinkLogUploaderLog) << "Compressed" << _logFile << QFileInfo(_logFile).size() << "->" << _tusLength << "bytes";
+    _create();
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_create()
+{
+    QNetworkRequest request = _tusRequest(_url);
+    request.setRawHeader("Upload-Length", QByteArray::number(_tusLength));
+    request.setRawHeader("Upload-Metadata", _uploadMetadata());
+    request.setHeader(QNetworkRequest::ContentLengthHeader, 0);
+    _reply = _nam->post(request, QByteArray());
+    (void) connect(_reply, &QNetworkReply::finished, this, &MAVLinkLogUpload::_createFinished);
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_createFinished()
+{
+    QNetworkReply* reply = _takeReply();
+    const int httpCode = httpStatus(reply);
+    const QByteArray response = reply->readAll();
+    if (httpCode != 201 || !reply->hasRawHeader("Location")) {
+        if (transientFailure(reply, httpCode)) {
+            _retry(&MAVLinkLogUpload::_create, httpCode, response);
+        } else {
+            qCWarning(MAVLinkLogUploaderLog) << "Creating upload failed:" << httpCode << reply->errorString();
+            _finish(false, httpCode, response);
+        }
+        return;
+    }
+
+    _retryCount = 0;
+    _tusLocation = _url.resolved(QUrl(QString::fromUtf8(reply->rawHeader("Location"))));
+    _tusOffset = 0;
+    QFile sidecar(tusSidecarFile(_logFile));
+    if (sidecar.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        (void) sidecar.write(_tusLocation.toEncoded());
+    } else {
+        qCWarning(MAVLinkLogUploaderLog) << "Could not save upload location, the upload will not survive a restart:" << sidecar.errorString();
+    }
+    _patch();
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_head()
+{
+    _reply = _nam->head(_tusRequest(_tusLocation));
+    (void) connect(_reply, &QNetworkReply::finished, this, &MAVLinkLogUpload::_headFinished);
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_headFinished()
+{
+    QNetworkReply* reply = _takeReply();
+    const int httpCode = httpStatus(reply);
+    if (httpCode == 404 || httpCode == 410 || httpCode == 403) {
+        // Upload expired on the server, start over
+        qCDebug(MAVLinkLogUploaderLog) << "Upload no longer known to the server" << _tusLocation;
+        _clearTusState();
+        _create();
+        return;
+    }
+    if ((httpCode != 200 && httpCode != 204) || !reply->hasRawHeader("Upload-Offset")) {
+        if (transientFailure(reply, httpCode)) {
+            _retry(&MAVLinkLogUpload::_head, httpCode, QByteArray());
+        } else {
+            _finish(false, httpCode, reply->readAll());
+        }
+        return;
+    }
+
+    _retryCount = 0;
+    _tusOffset = reply->rawHeader("Upload-Offset").toLongLong();
+    if (_tusOffset >= _tusLength) {
+        _finish(true, httpCode, QByteArray());
+    } else {
+        _patch();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_patch()
+{
+    const qint64 chunkLength = qMin(_tusChunkSize, _tusLength - _tusOffset);
+    RateLimitedUploadDevice* device = new RateLimitedUploadDevice(_limiter, QByteArray(), gzipFile(_logFile), _tusOffset, chunkLength, QByteArray());
+    if (!device->open(QIODevice::ReadOnly)) {
+        qCWarning(MAVLinkLogUploaderLog) << "Could not open compressed log:" << device->errorString();
+        delete device;
+        _clearTusState();
+        _finish(false, 0, QByteArray());
+        return;
+    }
+
+    QNetworkRequest request = _tusRequest(_tusLocation);
+    request.setRawHeader("Upload-Offset", QByteArray::number(_tusOffset));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/offset+octet-stream");
+    request.setHeader(QNetworkRequest::ContentLengthHeader, chunkLength);
+    _reply = _nam->sendCustomRequest(request, "PATCH", device);
+    device->setParent(_reply);
+    (void) connect(_reply, &QNetworkReply::finished,       this, &MAVLinkLogUpload::_patchFinished);
+    (void) connect(_reply, &QNetworkReply::uploadProgress, this, &MAVLinkLogUpload::_patchProgress);
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_patchFinished()
+{
+    QNetworkReply* reply = _takeReply();
+    const int httpCode = httpStatus(reply);
+    if (httpCode == 409) {
+        // Offset mismatch, ask the server where it is
+        _head();
+        return;
+    }
+    if (httpCode != 204 || !reply->hasRawHeader("Upload-Offset")) {
+        if (transientFailure(reply, httpCode)) {
+            // Part of the chunk may have arrived, resynchronize before sending more
+            _retry(&MAVLinkLogUpload::_head, httpCode, QByteArray());
+        } else {
+            qCWarning(MAVLinkLogUploaderLog) << "Upload failed:" << httpCode << reply->errorString();
+            _finish(false, httpCode, reply->readAll());
+        }
+        return;
+    }
+
+    _retryCount = 0;
+    _tusOffset = reply->rawHeader("Upload-Offset").toLongLong();
+    if (_tusOffset >= _tusLength) {
+        qCDebug(MAVLinkLogUploaderLog) << "Log uploaded" << _logFile;
+        _finish(true, httpCode, reply->readAll());
+    } else {
+        _patch();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_patchProgress(qint64 bytesSent, qint64 /*bytesTotal*/)
+{
+    if (_tusLength > 0) {
+        emit progress(static_cast<qreal>(_tusOffset + bytesSent) / static_cast<qreal>(_tusLength));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_post()
+{
+    const QFileInfo fi(_logFile);
+    const QByteArray boundary = QByteArrayLiteral("qgc") + QByteArray::number(QRandomGenerator::global()->generate64(), 16);
+
+    QByteArray prefix;
+    for (const QPair<QString, QString>& field : _fields) {
+        prefix += "--" + boundary + "\r\n";
+        prefix += "Content-Disposition: form-data; name=\"" + field.first.toUtf8() + "\"\r\n\r\n";
+        prefix += field.second.toUtf8() + "\r\n";
+    }
+    prefix += "--" + boundary + "\r\n";
+    prefix += "Content-Type: application/octet-stream\r\n";
+    prefix += "Content-Disposition: form-data; name=\"filearg\"; filename=\"" + fi.fileName().toUtf8() + "\"\r\n\r\n";
+    const QByteArray suffix = "\r\n--" + boundary + "--\r\n";
+
+    RateLimitedUploadDevice* device = new RateLimitedUploadDevice(_limiter, prefix, _logFile, 0, fi.size(), suffix);
+    if (!device->open(QIODevice::ReadOnly)) {
+        qCWarning(MAVLinkLogUploaderLog) << "Could not open log file:" << _logFile << device->errorString();
+        delete device;
+        _finish(false, 0, QByteArray());
+        return;
+    }
+
+    QNetworkRequest request(_url);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, true);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArray("multipart/form-data; boundary=") + boundary);
+    request.setHeader(QNetworkRequest::ContentLengthHeader, device->size());
+    _reply = _nam->post(request, device);
+    device->setParent(_reply);
+    (void) connect(_reply, &QNetworkReply::finished,       this, &MAVLinkLogUpload::_postFinished);
+    (void) connect(_reply, &QNetworkReply::uploadProgress, this, &MAVLinkLogUpload::_postProgress);
+    qCDebug(MAVLinkLogUploaderLog) << "Log" << fi.baseName() << "Uploading." << fi.size() << "bytes.";
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_postFinished()
+{
+    QNetworkReply* reply = _takeReply();
+    const int httpCode = httpStatus(reply);
+    const QByteArray response = reply->readAll();
+    if (httpCode == 200) {
+        _finish(true, httpCode, response);
+    } else if (transientFailure(reply, httpCode)) {
+        qCDebug(MAVLinkLogUploaderLog) << "Upload interrupted:" << httpCode << reply->errorString();
+        emit progress(0);
+        _retry(&MAVLinkLogUpload::_post, httpCode, response);
+    } else {
+        qCWarning(MAVLinkLogUploaderLog) << QString("Log Upload Error: %1 status: %2").arg(reply->errorString()).arg(httpCode);
+        _finish(false, httpCode, response);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+MAVLinkLogUpload::_postProgress(qint64 bytesSent, qint64 bytesTotal)
+{
+    if (bytesTotal) {
+        emit progress(static_cast<qreal>(bytesSent) / static_cast<qreal>(bytesTotal));
+    }
+}
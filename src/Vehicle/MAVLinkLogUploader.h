@@ -0,0 +1,158 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QIODevice>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtNetwork/QNetworkRequest>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkLogUploaderLog)
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/// Token bucket shared by all log uploads, so together they stay below the configured rate and leave the rest of
+/// the link to telemetry.
+class BandwidthLimiter
+{
+public:
+    /// @param bytesPerSecond 0: unlimited
+    void    setRate             (qint64 bytesPerSecond);
+    qint64  rate                () const { return _rate; }
+
+    /// Takes up to maxBytes from the bucket
+    ///     @return Number of bytes which may be sent now, 0 if the bucket is empty
+    qint64  acquire             (qint64 maxBytes);
+
+    /// @return Time until acquire() hands out bytes again
+    int     msecsUntilAvailable ();
+
+private:
+    void _refill();
+
+    qint64          _rate   = 0;
+    double          _tokens = 0;
+    QElapsedTimer   _refillTimer;
+
+    static constexpr int _burstMsecs    = 250;      ///< Bucket holds this much of the rate
+    static constexpr int _minBurstBytes = 4096;
+};
+
+/// Request body made of a byte prefix, a range of a file and a byte suffix. Reads are paced by the
+/// BandwidthLimiter: while it is empty readData returns nothing and readyRead is emitted once it refilled.
+class RateLimitedUploadDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    RateLimitedUploadDevice(BandwidthLimiter* limiter, const QByteArray& prefix, const QString& fileName, qint64 fileOffset, qint64 fileLength, const QByteArray& suffix, QObject* parent = nullptr);
+
+    bool    open            (OpenMode mode) override;
+    void    close           () override;
+    bool    isSequential    () const override { return true; }
+    qint64  size            () const override { return _size; }
+    qint64  bytesAvailable  () const override { return (_size - _pos) + QIODevice::bytesAvailable(); }
+    bool    atEnd           () const override { return _pos >= _size; }
+
+protected:
+    qint64  readData        (char* data, qint64 maxlen) override;
+    qint64  writeData       (const char* data, qint64 len) override;
+
+private:
+    BandwidthLimiter*   _limiter;
+    QByteArray          _prefix;
+    QFile               _file;
+    qint64              _fileOffset;
+    qint64              _fileLength;
+    QByteArray          _suffix;
+    qint64              _size;
+    qint64              _pos = 0;
+    QTimer              _throttleTimer;
+};
+
+/// Uploads a single log. Servers speaking the tus resumable upload protocol get the log gzip compressed, sent in
+/// chunks, and resumed from the last acknowledged offset after a failure or a restart. The upload location is kept
+/// in a sidecar file next to the log for that. Other servers get the log as a multipart form POST, which is retried
+/// from the start.
+class MAVLinkLogUpload : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef QList<QPair<QString, QString>> FormFields_t;
+
+    /// @param fields Form fields sent with the log, tus uploads send them as Upload-Metadata
+    MAVLinkLogUpload(QNetworkAccessManager* nam, BandwidthLimiter* limiter, const QUrl& url, const QString& logFile, const FormFields_t& fields, QObject* parent = nullptr);
+    ~MAVLinkLogUpload();
+
+    void start  ();
+    void abort  ();
+
+    /// Sidecar files the upload of logFile may leave behind
+    static QString tusSidecarFile   (const QString& logFile);
+    static QString gzipFile         (const QString& logFile);
+
+signals:
+    void progress   (qreal progress);
+    void finished   (bool success, int httpCode, QByteArray response);
+
+private slots:
+    void _probeFinished     ();
+    void _compressFinished  ();
+    void _createFinished    ();
+    void _headFinished      ();
+    void _patchFinished     ();
+    void _postFinished      ();
+    void _patchProgress     (qint64 bytesSent, qint64 bytesTotal);
+    void _postProgress      (qint64 bytesSent, qint64 bytesTotal);
+
+private:
+    void            _probe          ();
+    void            _compress       ();
+    void            _create         ();
+    void            _head           ();
+    void            _patch          ();
+    void            _post           ();
+    void            _retry          (void (MAVLinkLogUpload::*step)(), int httpCode, const QByteArray& response);
+    void            _finish         (bool success, int httpCode, const QByteArray& response);
+    QNetworkReply*  _takeReply      ();
+    QNetworkRequest _tusRequest     (const QUrl& url) const;
+    QByteArray      _uploadMetadata () const;
+    void            _clearTusState  ();
+
+    QNetworkAccessManager*  _nam;
+    BandwidthLimiter*       _limiter;
+    QUrl                    _url;
+    QString                 _logFile;
+    FormFields_t            _fields;
+    QNetworkReply*          _reply          = nullptr;
+    QUrl                    _tusLocation;
+    qint64                  _tusOffset      = 0;
+    qint64                  _tusLength      = 0;
+    int                     _retryCount     = 0;
+    bool                    _aborted        = false;
+    QTimer                  _retryTimer;
+    void                    (MAVLinkLogUpload::*_retryStep)() = nullptr;
+    QFutureWatcher<bool>    _compressWatcher;
+
+    static constexpr qint64 _tusChunkSize       = 1024 * 1024;
+    static constexpr int    _maxRetries         = 6;
+    static constexpr int    _retryBaseMsecs     = 1000;     ///< Doubled on each retry
+    static constexpr int    _retryMaxMsecs      = 60000;
+    static constexpr const char* _tusVersion    = "1.0.0";
+};
@@ -0,0 +1,79 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageSubscription.h"
+
+QReadWriteLock                              MAVLinkMessageSubscription::_subscriptionsLock;
+QList<MAVLinkMessageSubscription*>          MAVLinkMessageSubscription::_subscriptions;
+QAtomicInt                                  MAVLinkMessageSubscription::_subscriptionCount;
+
+MAVLinkMessageSubscription::MAVLinkMessageSubscription(const QSet<uint32_t>& messageIds, int vehicleId, int maxQueuedMessages, QObject* parent)
+    : QObject(parent)
+    , _messageIds(messageIds)
+    , _vehicleId(vehicleId)
+    , _maxQueuedMessages(qMax(1, maxQueuedMessages))
+{
+    QWriteLocker locker(&_subscriptionsLock);
+    _subscriptions.append(this);
+    _subscriptionCount.storeRelease(_subscriptions.count());
+}
+
+MAVLinkMessageSubscription::~MAVLinkMessageSubscription()
+{
+    // Waits for a dispatch in progress, none can reach this subscription afterwards
+    QWriteLocker locker(&_subscriptionsLock);
+    (void) _subscriptions.removeOne(this);
+    _subscriptionCount.storeRelease(_subscriptions.count());
+}
+
+void MAVLinkMessageSubscription::dispatch(const mavlink_message_t& message)
+{
+    if (_subscriptionCount.loadAcquire() == 0) {
+        return;
+    }
+
+    QReadLocker locker(&_subscriptionsLock);
+    for (MAVLinkMessageSubscription* subscription: std::as_const(_subscriptions)) {
+        if (((subscription->_vehicleId == 0) || (subscription->_vehicleId == message.sysid)) &&
+                (subscription->_messageIds.isEmpty() || subscription->_messageIds.contains(message.msgid))) {
+            subscription->_queue(message);
+        }
+    }
+}
+
+void MAVLinkMessageSubscription::_queue(const mavlink_message_t& message)
+{
+    bool notify = false;
+    {
+        QMutexLocker locker(&_queueMutex);
+        if (_queuedMessages.count() >= _maxQueuedMessages) {
+            _queuedMessages.removeFirst();
+            (void) _droppedMessages.fetchAndAddRelaxed(1);
+        }
+        _queuedMessages.append(message);
+        notify = !_notified;
+        _notified = true;
+    }
+
+    // One wake up per batch, however many messages arrive before the subscriber gets to them
+    if (notify) {
+        (void) QMetaObject::invokeMethod(this, [this]() { emit messagesAvailable(); }, Qt::QueuedConnection);
+    }
+}
+
+QList<mavlink_message_t> MAVLinkMessageSubscription::takeMessages(void)
+{
+    QList<mavlink_message_t> messages;
+
+    QMutexLocker locker(&_queueMutex);
+    messages.swap(_queuedMessages);
+    _notified = false;
+
+    return messages;
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSet>
+
+#include "MAVLinkLib.h"
+
+/// Asynchronous copy of the messages received from vehicles, for plugins which would otherwise slow down message
+/// handling in QGCCorePlugin::mavlinkMessage. Matching messages are only queued while they are handled, the
+/// subscription signals messagesAvailable in its own thread and the subscriber takes all queued messages at once:
+///
+///     subscription = new MAVLinkMessageSubscription({ MAVLINK_MSG_ID_ATTITUDE });
+///     subscription->moveToThread(workerThread);
+///     connect(subscription, &MAVLinkMessageSubscription::messagesAvailable, worker, [subscription]() {
+///         for (const mavlink_message_t& message: subscription->takeMessages()) { ... }
+///     });
+///
+/// messagesAvailable is only signalled again once the messages were taken. The queue is bounded, if the subscriber
+/// does not keep up the oldest messages are dropped and counted. Messages are seen after the firmware plugin adjusted
+/// them and before the vehicle handles them.
+class MAVLinkMessageSubscription : public QObject
+{
+    Q_OBJECT
+
+public:
+    ///     @param messageIds Messages to receive, empty for all messages
+    ///     @param vehicleId Vehicle to receive messages from, 0 for all vehicles
+    ///     @param maxQueuedMessages Older messages are dropped beyond this
+    MAVLinkMessageSubscription(const QSet<uint32_t>& messageIds, int vehicleId = 0, int maxQueuedMessages = 1000, QObject* parent = nullptr);
+    ~MAVLinkMessageSubscription();
+
+    /// Thread safe
+    /// @return All messages queued since the last call, oldest first
+    QList<mavlink_message_t> takeMessages(void);
+
+    /// Thread safe
+    /// @return Number of messages dropped because the queue was full
+    quint64 droppedMessages(void) const { return _droppedMessages.loadRelaxed(); }
+
+    /// Queues the message for all matching subscriptions, called by Vehicle for each message it receives
+    static void dispatch(const mavlink_message_t& message);
+
+signals:
+    void messagesAvailable(void);
+
+private:
+    void _queue(const mavlink_message_t& message);
+
+    const QSet<uint32_t>        _messageIds;
+    const int                   _vehicleId;
+    const int                   _maxQueuedMessages;
+
+    QMutex                      _queueMutex;        ///< Only held to append or swap the queue
+    QList<mavlink_message_t>    _queuedMessages;
+    bool                        _notified =         false;
+    QAtomicInteger<quint64>     _droppedMessages =  0;
+
+    static QReadWriteLock                       _subscriptionsLock;
+    static QList<MAVLinkMessageSubscription*>   _subscriptions;
+    static QAtomicInt                           _subscriptionCount;     ///< Lets dispatch skip the lock while nobody subscribed
+};
@@ -0,0 +1,272 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkStreamRateController.h"
+#include "Vehicle.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+#include "QGCLoggingCategory.h"
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(MAVLinkStreamRateControllerLog, "qgc.vehicle.mavlinkstreamratecontroller")
+
+/// Messages which are never throttled since the vehicle state or command handling depends on them
+static constexpr int kProtectedMessageIds[] = {
+    MAVLINK_MSG_ID_HEARTBEAT,
+    MAVLINK_MSG_ID_SYS_STATUS,
+    MAVLINK_MSG_ID_COMMAND_ACK,
+    MAVLINK_MSG_ID_COMMAND_LONG,
+    MAVLINK_MSG_ID_STATUSTEXT,
+    MAVLINK_MSG_ID_PARAM_VALUE,
+    MAVLINK_MSG_ID_MISSION_ITEM_INT,
+    MAVLINK_MSG_ID_MISSION_REQUEST_INT,
+    MAVLINK_MSG_ID_MISSION_COUNT,
+    MAVLINK_MSG_ID_MISSION_ACK,
+    MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
+    MAVLINK_MSG_ID_RADIO_STATUS,
+    MAVLINK_MSG_ID_TIMESYNC,
+};
+
+MAVLinkStreamRateController::MAVLinkStreamRateController(Vehicle* vehicle)
+    : QObject   (vehicle)
+    , _vehicle  (vehicle)
+{
+    _evaluateTimer.setInterval(_evaluateIntervalMSecs);
+    (void) connect(&_evaluateTimer, &QTimer::timeout, this, &MAVLinkStreamRateController::_evaluate);
+
+    Fact* const adaptiveStreamRates = qgcApp()->toolbox()->settingsManager()->appSettings()->adaptiveStreamRates();
+    (void) connect(adaptiveStreamRates, &Fact::rawValueChanged, this, [this](const QVariant& value) {
+        setEnabled(value.toBool());
+    });
+    setEnabled(adaptiveStreamRates->rawValue().toBool());
+}
+
+void MAVLinkStreamRateController::setEnabled(bool enabled)
+{
+    if (enabled == _enabled) {
+        return;
+    }
+    _enabled = enabled;
+
+    if (_enabled) {
+        _streamStats.clear();
+        _lastReceivedCount  = _vehicle->mavlinkReceivedCount();
+        _lastLossCount      = _vehicle->mavlinkLossCount();
+        _minTxBufPercent    = 100;
+        _cleanEvaluations   = 0;
+        _evaluateClock.start();
+        _evaluateTimer.start();
+    } else if (_restoreNext()) {
+        _evaluateTimer.stop();
+    }
+}
+
+void MAVLinkStreamRateController::setRateFloor(QObject* consumer, int messageId, double rateHz)
+{
+    for (qsizetype i=_rateFloors.count() - 1; i>=0; i--) {
+        const auto& floor = _rateFloors[i];
+        if (floor.first.isNull() || ((floor.first == consumer) && (floor.second.first == messageId))) {
+            _rateFloors.removeAt(i);
+        }
+    }
+    if (rateHz > 0) {
+        _rateFloors.append(qMakePair(QPointer<QObject>(consumer), qMakePair(messageId, rateHz)));
+    }
+
+    // A stream already throttled below the new floor is raised right away
+    const auto it = _throttledStreams.constFind(messageId);
+    if ((it != _throttledStreams.constEnd()) && (it.value().currentHz < _rateFloor(messageId))) {
+        _setStreamRate(messageId, qMin(it.value().defaultHz, _rateFloor(messageId)));
+    }
+}
+
+void MAVLinkStreamRateController::messageReceived(const mavlink_message_t& message)
+{
+    if (!_enabled) {
+        return;
+    }
+
+    StreamStats_t& stats = _streamStats[message.msgid];
+    stats.count++;
+    stats.bytes += MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len;
+}
+
+QHash<int, double> MAVLinkStreamRateController::throttledRates(void) const
+{
+    QHash<int, double> rates;
+    for (auto it = _throttledStreams.constBegin(); it != _throttledStreams.constEnd(); it++) {
+        rates[it.key()] = it.value().currentHz;
+    }
+    return rates;
+}
+
+void MAVLinkStreamRateController::_evaluate(void)
+{
+    if (!_enabled) {
+        // Still restoring the streams throttled before the setting was turned off
+        if (_restoreNext()) {
+            _evaluateTimer.stop();
+        }
+        return;
+    }
+
+    const double elapsedSecs = _evaluateClock.restart() / 1000.0;
+
+    const quint64 receivedCount = _vehicle->mavlinkReceivedCount();
+    const quint64 lossCount     = _vehicle->mavlinkLossCount();
+    const quint64 received      = (receivedCount >= _lastReceivedCount) ? (receivedCount - _lastReceivedCount) : 0;
+    const quint64 lost          = (lossCount >= _lastLossCount) ? (lossCount - _lastLossCount) : 0;
+    const double lossRatio      = ((received + lost) > 0) ? (static_cast<double>(lost) / (received + lost)) : 0;
+    const int minTxBufPercent   = _minTxBufPercent;
+
+    _lastReceivedCount  = receivedCount;
+    _lastLossCount      = lossCount;
+    _minTxBufPercent    = 100;
+
+    if (!_suspended && (elapsedSecs > 0)) {
+        const bool degraded = (lossRatio > _degradedLossRatio) || (minTxBufPercent < _lowTxBufPercent);
+        const bool clean    = (lossRatio < _cleanLossRatio) && (minTxBufPercent >= _lowTxBufPercent);
+
+        qCDebug(MAVLinkStreamRateControllerLog) << "_evaluate lossRatio" << lossRatio << "txbuf" << minTxBufPercent << "throttled" << _throttledStreams.count();
+
+        // The vehicle rejects a second SET_MESSAGE_INTERVAL while one is outstanding, so at most one change goes out per evaluation
+        if (!_vehicle->isMavCommandPending(_vehicle->defaultComponentId(), MAV_CMD_SET_MESSAGE_INTERVAL)) {
+            if (degraded) {
+                _cleanEvaluations = 0;
+                (void) _lowerBusiestStream(elapsedSecs);
+            } else if (clean) {
+                if (++_cleanEvaluations >= _cleanEvaluationsToRaise) {
+                    if (_raiseThrottledStream()) {
+                        _cleanEvaluations = 0;
+                    }
+                }
+            } else {
+                _cleanEvaluations = 0;
+            }
+        }
+    }
+
+    _streamStats.clear();
+}
+
+double MAVLinkStreamRateController::_rateFloor(int messageId) const
+{
+    double floorHz = _defaultRateFloorHz;
+    for (const auto& floor: _rateFloors) {
+        if (!floor.first.isNull() && (floor.second.first == messageId)) {
+            floorHz = qMax(floorHz, floor.second.second);
+        }
+    }
+    return floorHz;
+}
+
+/// Halves the rate of the stream using the most bandwidth which is not yet at its floor
+///     @return true if a stream was lowered
+bool MAVLinkStreamRateController::_lowerBusiestStream(double elapsedSecs)
+{
+    int     busiestMessageId    = -1;
+    double  busiestBytesPerSec  = 0;
+    double  busiestRateHz       = 0;
+
+    for (auto it = _streamStats.constBegin(); it != _streamStats.constEnd(); it++) {
+        const int messageId = it.key();
+        if (std::find(std::begin(kProtectedMessageIds), std::end(kProtectedMessageIds), messageId) != std::end(kProtectedMessageIds)) {
+            continue;
+        }
+
+        const auto throttled = _throttledStreams.constFind(messageId);
+        const double rateHz = (throttled != _throttledStreams.constEnd()) ? throttled.value().currentHz : (it.value().count / elapsedSecs);
+        if ((rateHz / 2.0) < _rateFloor(messageId)) {
+            continue;
+        }
+
+        const double bytesPerSec = it.value().bytes / elapsedSecs;
+        if (bytesPerSec > busiestBytesPerSec) {
+            busiestMessageId    = messageId;
+            busiestBytesPerSec  = bytesPerSec;
+            busiestRateHz       = rateHz;
+        }
+    }
+
+    if (busiestMessageId < 0) {
+        return false;
+    }
+
+    if (!_throttledStreams.contains(busiestMessageId)) {
+        _throttledStreams[busiestMessageId] = { busiestRateHz, busiestRateHz };
+    }
+    qCDebug(MAVLinkStreamRateControllerLog) << "_lowerBusiestStream" << busiestMessageId << "bytes/s" << busiestBytesPerSec << "rate" << busiestRateHz;
+    _setStreamRate(busiestMessageId, busiestRateHz / 2.0);
+    return true;
+}
+
+/// Doubles the rate of the most throttled stream, back to the default rate once it gets there
+///     @return true if a stream was raised
+bool MAVLinkStreamRateController::_raiseThrottledStream(void)
+{
+    int     messageId   = -1;
+    double  lowestRatio = 1;
+
+    for (auto it = _throttledStreams.constBegin(); it != _throttledStreams.constEnd(); it++) {
+        const double ratio = it.value().currentHz / it.value().defaultHz;
+        if ((messageId < 0) || (ratio < lowestRatio)) {
+            messageId   = it.key();
+            lowestRatio = ratio;
+        }
+    }
+
+    if (messageId < 0) {
+        return false;
+    }
+
+    const ThrottledStream_t& stream = _throttledStreams[messageId];
+    qCDebug(MAVLinkStreamRateControllerLog) << "_raiseThrottledStream" << messageId << "rate" << stream.currentHz;
+    _setStreamRate(messageId, qMin(stream.currentHz * 2.0, stream.defaultHz));
+    return true;
+}
+
+void MAVLinkStreamRateController::_setStreamRate(int messageId, double rateHz)
+{
+    auto it = _throttledStreams.find(messageId);
+    if (it == _throttledStreams.end()) {
+        return;
+    }
+
+    float intervalUSecs;
+    if (rateHz >= it.value().defaultHz) {
+        // Back at the default rate, let the vehicle pick it again
+        _throttledStreams.erase(it);
+        intervalUSecs = 0;
+    } else {
+        it.value().currentHz = rateHz;
+        intervalUSecs = static_cast<float>(1000000.0 / rateHz);
+    }
+
+    _vehicle->sendMavCommand(_vehicle->defaultComponentId(),
+                             MAV_CMD_SET_MESSAGE_INTERVAL,
+                             false,                 // No error shown if fails
+                             messageId,
+                             intervalUSecs);
+}
+
+/// Sets one throttled stream back to its default rate
+///     @return true if all streams are back at their default rates
+bool MAVLinkStreamRateController::_restoreNext(void)
+{
+    if (_throttledStreams.isEmpty()) {
+        return true;
+    }
+    if (!_vehicle->isMavCommandPending(_vehicle->defaultComponentId(), MAV_CMD_SET_MESSAGE_INTERVAL)) {
+        const auto it = _throttledStreams.constBegin();
+        _setStreamRate(it.key(), it.value().defaultHz);
+    }
+    return _throttledStreams.isEmpty();
+}
@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MAVLinkLib.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkStreamRateControllerLog)
+
+class Vehicle;
+
+/// Adapts the rates of a vehicle's telemetry streams to what the link can carry. Every few seconds it looks at the
+/// message loss on the link and the free transmit buffer reported by RADIO_STATUS. While the link is degraded the
+/// stream using the most bandwidth is halved with MESSAGE_INTERVAL, once the link has been clean for a while the
+/// throttled streams are raised again step by step until they are back at their default rates.
+///
+/// Streams are never lowered below a floor. Messages a view relies on can be given a higher floor through
+/// setRateFloor for as long as the consumer exists.
+class MAVLinkStreamRateController : public QObject
+{
+    Q_OBJECT
+
+public:
+    MAVLinkStreamRateController(Vehicle* vehicle);
+
+    void setEnabled(bool enabled);
+    bool enabled(void) const { return _enabled; }
+
+    /// Stops adapting while something else (e.g. PID tuning) has taken over the stream rates
+    void setSuspended(bool suspended) { _suspended = suspended; }
+
+    /// Keeps the stream of messageId at rateHz or above until the consumer is destroyed or the floor is set to 0
+    void setRateFloor(QObject* consumer, int messageId, double rateHz);
+
+    /// Called for every message received from the vehicle
+    void messageReceived(const mavlink_message_t& message);
+
+    /// Called with the free transmit buffer percentage from RADIO_STATUS
+    void radioStatusReceived(int txbufPercent) { _minTxBufPercent = qMin(_minTxBufPercent, txbufPercent); }
+
+    /// @return Current rates of the throttled streams keyed by message id
+    QHash<int, double> throttledRates(void) const;
+
+private slots:
+    void _evaluate(void);
+
+private:
+    typedef struct {
+        quint32 count = 0;
+        quint64 bytes = 0;
+    } StreamStats_t;
+
+    typedef struct {
+        double defaultHz;
+        double currentHz;
+    } ThrottledStream_t;
+
+    double  _rateFloor          (int messageId) const;
+    bool    _lowerBusiestStream (double elapsedSecs);
+    bool    _raiseThrottledStream(void);
+    void    _setStreamRate      (int messageId, double rateHz);
+    bool    _restoreNext        (void);
+
+    Vehicle*                        _vehicle;
+    QTimer                          _evaluateTimer;
+    QElapsedTimer                   _evaluateClock;
+    bool                            _enabled            = false;
+    bool                            _suspended          = false;
+
+    QHash<int, StreamStats_t>       _streamStats;       ///< Messages received since the last evaluation
+    QHash<int, ThrottledStream_t>   _throttledStreams;
+    QList<QPair<QPointer<QObject>, QPair<int, double>>> _rateFloors;
+    quint64                         _lastReceivedCount  = 0;
+    quint64                         _lastLossCount      = 0;
+    int                             _minTxBufPercent    = 100;
+    int                             _cleanEvaluations   = 0;
+
+    static constexpr int    _evaluateIntervalMSecs  = 5000;
+    static constexpr double _degradedLossRatio      = 0.10;
+    static constexpr double _cleanLossRatio         = 0.02;
+    static constexpr int    _lowTxBufPercent        = 30;
+    static constexpr int    _cleanEvaluationsToRaise = 2;   ///< Clean evaluations in a row before raising a stream
+    static constexpr double _defaultRateFloorHz     = 1.0;
+};
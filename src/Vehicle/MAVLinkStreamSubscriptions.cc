@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkStreamSubscriptions.h"
+#include "MAVLinkStreamRateController.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(MAVLinkStreamSubscriptionsLog, "qgc.vehicle.mavlinkstreamsubscriptions")
+
+/// Streams which drop to a trickle on background vehicles unless subscribed
+static constexpr int kTrickleMessageIds[] = {
+    MAVLINK_MSG_ID_ATTITUDE,
+    MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+    MAVLINK_MSG_ID_ATTITUDE_TARGET,
+    MAVLINK_MSG_ID_VFR_HUD,
+    MAVLINK_MSG_ID_GPS_RAW_INT,
+    MAVLINK_MSG_ID_LOCAL_POSITION_NED,
+    MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED,
+    MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT,
+    MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT,
+    MAVLINK_MSG_ID_SERVO_OUTPUT_RAW,
+    MAVLINK_MSG_ID_RC_CHANNELS,
+    MAVLINK_MSG_ID_ALTITUDE,
+    MAVLINK_MSG_ID_HIGHRES_IMU,
+    MAVLINK_MSG_ID_SCALED_IMU,
+    MAVLINK_MSG_ID_ESTIMATOR_STATUS,
+    MAVLINK_MSG_ID_VIBRATION,
+    MAVLINK_MSG_ID_WIND_COV,
+    MAVLINK_MSG_ID_EXTENDED_SYS_STATE,
+    MAVLINK_MSG_ID_BATTERY_STATUS,
+};
+
+MAVLinkStreamSubscriptions::MAVLinkStreamSubscriptions(Vehicle* vehicle)
+    : QObject   (vehicle)
+    , _vehicle  (vehicle)
+{
+    _updateTimer.setSingleShot(true);
+    _updateTimer.setInterval(_updateDelayMSecs);
+    (void) connect(&_updateTimer, &QTimer::timeout, this, &MAVLinkStreamSubscriptions::_update);
+
+    _retryTimer.setSingleShot(true);
+    _retryTimer.setInterval(_retryDelayMSecs);
+    (void) connect(&_retryTimer, &QTimer::timeout, this, &MAVLinkStreamSubscriptions::_sendNext);
+
+    MultiVehicleManager* const multiVehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+    (void) connect(multiVehicleManager, &MultiVehicleManager::activeVehicleChanged, this, &MAVLinkStreamSubscriptions::_activeVehicleChanged);
+    _active = multiVehicleManager->activeVehicle() == _vehicle;
+
+    Fact* const trickleBackgroundVehicles = qgcApp()->toolbox()->settingsManager()->appSettings()->trickleBackgroundVehicles();
+    (void) connect(trickleBackgroundVehicles, &Fact::rawValueChanged, &_updateTimer, qOverload<>(&QTimer::start));
+}
+
+void MAVLinkStreamSubscriptions::subscribe(QObject* subscriber, int messageId, double rateHz)
+{
+    if (!subscriber) {
+        return;
+    }
+
+    if (!_subscriptions.contains(subscriber)) {
+        (void) connect(subscriber, &QObject::destroyed, this, &MAVLinkStreamSubscriptions::_subscriberDestroyed);
+    }
+    Rates_t& rates = _subscriptions[subscriber];
+    rates[messageId] = qMax(0.0, rateHz);
+
+    // Keeps the link adaptation from throttling the stream below what the subscriber needs
+    MAVLinkStreamRateController* const streamRateController = _vehicle->streamRateController();
+    if (streamRateController && (rateHz > 0)) {
+        streamRateController->setRateFloor(subscriber, messageId, rateHz);
+    }
+
+    _updateTimer.start();
+}
+
+void MAVLinkStreamSubscriptions::subscribeFactGroup(QObject* subscriber, const QString& factGroupName, double rateHz)
+{
+    const FactGroup* const factGroup = (factGroupName == QStringLiteral("Vehicle")) ? _vehicle : _vehicle->getFactGroup(factGroupName);
+    if (!factGroup) {
+        qCWarning(MAVLinkStreamSubscriptionsLog) << "subscribeFactGroup unknown FactGroup" << factGroupName;
+        return;
+    }
+    subscribeFactGroup(subscriber, factGroup, rateHz);
+}
+
+void MAVLinkStreamSubscriptions::subscribeFactGroup(QObject* subscriber, const FactGroup* factGroup, double rateHz)
+{
+    for (const uint32_t messageId: factGroup->handledMessageIds()) {
+        if (messageId != FactGroup::allMessageIds) {
+            subscribe(subscriber, static_cast<int>(messageId), rateHz);
+        }
+    }
+}
+
+void MAVLinkStreamSubscriptions::unsubscribe(QObject* subscriber)
+{
+    const auto it = _subscriptions.constFind(subscriber);
+    if (it == _subscriptions.constEnd()) {
+        return;
+    }
+
+    MAVLinkStreamRateController* const streamRateController = _vehicle->streamRateController();
+    if (streamRateController) {
+        for (auto rate = it.value().constBegin(); rate != it.value().constEnd(); rate++) {
+            streamRateController->setRateFloor(subscriber, rate.key(), 0);
+        }
+    }
+
+    (void) disconnect(subscriber, &QObject::destroyed, this, &MAVLinkStreamSubscriptions::_subscriberDestroyed);
+    _subscriptions.erase(it);
+    _updateTimer.start();
+}
+
+void MAVLinkStreamSubscriptions::_subscriberDestroyed(QObject* subscriber)
+{
+    // The rate controller drops floors of destroyed consumers by itself
+    if (_subscriptions.remove(subscriber)) {
+        _updateTimer.start();
+    }
+}
+
+void MAVLinkStreamSubscriptions::_activeVehicleChanged(Vehicle* activeVehicle)
+{
+    const bool active = activeVehicle == _vehicle;
+    if (active != _active) {
+        _active = active;
+        _updateTimer.start();
+    }
+}
+
+QHash<int, float> MAVLinkStreamSubscriptions::targetIntervals(const QHash<int, double>& subscribedRates, bool trickle)
+{
+    QHash<int, float> intervals;
+
+    for (auto it = subscribedRates.constBegin(); it != subscribedRates.constEnd(); it++) {
+        if (it.value() > 0) {
+            intervals[it.key()] = static_cast<float>(1000000.0 / it.value());
+        }
+    }
+
+    if (trickle) {
+        intervals[MAVLINK_MSG_ID_GLOBAL_POSITION_INT] = static_cast<float>(1000000.0 / _tricklePositionHz);
+        for (const int messageId: kTrickleMessageIds) {
+            if (!subscribedRates.contains(messageId)) {
+                intervals[messageId] = static_cast<float>(1000000.0 / _trickleHz);
+            }
+        }
+        if (subscribedRates.contains(MAVLINK_MSG_ID_GLOBAL_POSITION_INT)) {
+            const double rateHz = subscribedRates[MAVLINK_MSG_ID_GLOBAL_POSITION_INT];
+            if (rateHz > 0) {
+                intervals[MAVLINK_MSG_ID_GLOBAL_POSITION_INT] = static_cast<float>(1000000.0 / rateHz);
+            } else {
+                intervals.remove(MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+            }
+        }
+    }
+
+    return intervals;
+}
+
+void MAVLinkStreamSubscriptions::_update(void)
+{
+    _subscribedRates.clear();
+    for (const Rates_t& rates: _subscriptions) {
+        for (auto it = rates.constBegin(); it != rates.constEnd(); it++) {
+            _subscribedRates[it.key()] = qMax(_subscribedRates.value(it.key(), 0), it.value());
+        }
+    }
+
+    const bool trickle = !_active && qgcApp()->toolbox()->settingsManager()->appSettings()->trickleBackgroundVehicles()->rawValue().toBool();
+    const QHash<int, float> targets = targetIntervals(_subscribedRates, trickle);
+
+    // Streams no longer in the targets go back to the default rate, an interval of 0
+    _pendingIntervals.clear();
+    QList<int> messageIds = targets.keys();
+    messageIds.append(_sentIntervals.keys());
+    for (const int messageId: messageIds) {
+        const float target = targets.value(messageId, 0);
+        if (target != _sentIntervals.value(messageId, 0)) {
+            _pendingIntervals[messageId] = target;
+        }
+    }
+
+    qCDebug(MAVLinkStreamSubscriptionsLog) << "_update vehicle" << _vehicle->id() << "trickle" << trickle << "subscribed" << _subscribedRates.count() << "changes" << _pendingIntervals.count();
+    _sendNext();
+}
+
+void MAVLinkStreamSubscriptions::_sendNext(void)
+{
+    if (_sending || _pendingIntervals.isEmpty()) {
+        return;
+    }
+
+    // Only one SET_MESSAGE_INTERVAL can be outstanding, others (e.g. the link adaptation) may be using it
+    if (_vehicle->isMavCommandPending(_vehicle->defaultComponentId(), MAV_CMD_SET_MESSAGE_INTERVAL)) {
+        _retryTimer.start();
+        return;
+    }
+
+    const auto it = _pendingIntervals.constBegin();
+    const int messageId = it.key();
+    const float intervalUSecs = it.value();
+    (void) _pendingIntervals.erase(it);
+
+    Vehicle::MavCmdAckHandlerInfo_t handlerInfo = {};
+    handlerInfo.resultHandler       = _setMessageIntervalResultHandler;
+    handlerInfo.resultHandlerData   = this;
+
+    _sending            = true;
+    _sendingMessageId   = messageId;
+    _sendingInterval    = intervalUSecs;
+    _vehicle->sendMavCommandWithHandler(&handlerInfo, _vehicle->defaultComponentId(), MAV_CMD_SET_MESSAGE_INTERVAL, messageId, intervalUSecs);
+}
+
+void MAVLinkStreamSubscriptions::_setMessageIntervalResultHandler(void* resultHandlerData, int /*compId*/, const mavlink_command_ack_t& ack, Vehicle::MavCmdResultFailureCode_t failureCode)
+{
+    MAVLinkStreamSubscriptions* const subscriptions = static_cast<MAVLinkStreamSubscriptions*>(resultHandlerData);
+
+    subscriptions->_sending = false;
+    if (failureCode == Vehicle::MavCmdResultFailureDuplicateCommand) {
+        // Lost the race for the command to someone else, try again unless a newer interval is already queued
+        if (!subscriptions->_pendingIntervals.contains(subscriptions->_sendingMessageId)) {
+            subscriptions->_pendingIntervals[subscriptions->_sendingMessageId] = subscriptions->_sendingInterval;
+        }
+        subscriptions->_retryTimer.start();
+        return;
+    }
+
+    // Failures are recorded as sent as well, a vehicle which does not support the interval would otherwise be asked forever
+    if ((failureCode != Vehicle::MavCmdResultCommandResultOnly) || (ack.result != MAV_RESULT_ACCEPTED)) {
+        qCDebug(MAVLinkStreamSubscriptionsLog) << "SET_MESSAGE_INTERVAL failed" << subscriptions->_sendingMessageId << failureCode << ack.result;
+    }
+    if (subscriptions->_sendingInterval == 0) {
+        (void) subscriptions->_sentIntervals.remove(subscriptions->_sendingMessageId);
+    } else {
+        subscriptions->_sentIntervals[subscriptions->_sendingMessageId] = subscriptions->_sendingInterval;
+    }
+
+    // Deferred since the handler is called from within the vehicle's command handling
+    QTimer::singleShot(0, subscriptions, &MAVLinkStreamSubscriptions::_sendNext);
+}
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "Vehicle.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkStreamSubscriptionsLog)
+
+/// Registry of the telemetry a vehicle's consumers need. QML pages, FactGroups and instrument values subscribe to the
+/// messages they show, the registry keeps the highest rate asked for each message and drives MESSAGE_INTERVAL from it.
+///
+/// While the vehicle is not the active vehicle and the trickleBackgroundVehicles setting is on, the common telemetry
+/// streams nobody subscribed to drop to a trickle: position once a second, everything else every few seconds. Once the
+/// vehicle becomes active again the streams go back to the vehicle's default rates.
+class MAVLinkStreamSubscriptions : public QObject
+{
+    Q_OBJECT
+
+public:
+    MAVLinkStreamSubscriptions(Vehicle* vehicle);
+
+    /// Subscribes to a message until the subscriber is destroyed or unsubscribes
+    ///     @param rateHz Rate needed, 0 for the vehicle's default rate
+    Q_INVOKABLE void subscribe          (QObject* subscriber, int messageId, double rateHz = 0);
+
+    /// Subscribes to all messages the named FactGroup handles
+    Q_INVOKABLE void subscribeFactGroup (QObject* subscriber, const QString& factGroupName, double rateHz = 0);
+    void subscribeFactGroup             (QObject* subscriber, const FactGroup* factGroup, double rateHz = 0);
+
+    /// Drops all subscriptions of the subscriber
+    Q_INVOKABLE void unsubscribe        (QObject* subscriber);
+
+    bool isSubscribed(int messageId) const { return _subscribedRates.contains(messageId); }
+
+    /// @return Highest rate subscribed for messageId, 0 for the default rate or no subscription
+    double subscribedRate(int messageId) const { return _subscribedRates.value(messageId, 0); }
+
+    /// @return MESSAGE_INTERVAL in usecs to request for each stream: 0 for the default rate
+    static QHash<int, float> targetIntervals(const QHash<int, double>& subscribedRates, bool trickle);
+
+private slots:
+    void _activeVehicleChanged  (Vehicle* activeVehicle);
+    void _update                (void);
+    void _sendNext              (void);
+
+private:
+    void _subscriberDestroyed   (QObject* subscriber);
+
+    static void _setMessageIntervalResultHandler(void* resultHandlerData, int compId, const mavlink_command_ack_t& ack, Vehicle::MavCmdResultFailureCode_t failureCode);
+
+    typedef QHash<int, double> Rates_t;
+
+    Vehicle*                    _vehicle;
+    bool                        _active             = true;
+    QHash<QObject*, Rates_t>    _subscriptions;
+    Rates_t                     _subscribedRates;   ///< Highest rate per message over all subscribers
+    QHash<int, float>           _sentIntervals;     ///< Last interval sent per message, missing is the default rate
+    QHash<int, float>           _pendingIntervals;  ///< Intervals still to be sent
+    bool                        _sending            = false;
+    int                         _sendingMessageId   = 0;
+    float                       _sendingInterval    = 0;
+    QTimer                      _updateTimer;       ///< Coalesces subscription changes
+    QTimer                      _retryTimer;
+
+    static constexpr int    _updateDelayMSecs       = 250;
+    static constexpr int    _retryDelayMSecs        = 1000;
+    static constexpr double _tricklePositionHz      = 1.0;
+    static constexpr double _trickleHz              = 0.2;
+};
@@ -0,0 +1,168 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ManualControlSender.h"
+#include "Vehicle.h"
+#include "LinkConfiguration.h"
+#include "MAVLinkProtocol.h"
+#include "QGCApplication.h"
+#include "QGCToolbox.h"
+#include "QGCLoggingCategory.h"
+
+#include <chrono>
+#include <cstdlib>
+
+QGC_LOGGING_CATEGORY(ManualControlSenderLog, "qgc.vehicle.manualcontrolsender")
+
+ManualControlSender::ManualControlSender(Vehicle* vehicle)
+    : QThread(vehicle)
+    , _vehicle(vehicle)
+{
+    setObjectName(QStringLiteral("ManualControl"));
+}
+
+ManualControlSender::~ManualControlSender()
+{
+    stop();
+    wait();
+}
+
+void ManualControlSender::setSample(float roll, float pitch, float yaw, float thrust, quint16 buttons)
+{
+    const auto toCommand = [](float value) -> quint64 {
+        return static_cast<quint16>(static_cast<qint16>(qBound(-1.0f, value, 1.0f) * 1000.0f));
+    };
+
+    _axes.store(toCommand(pitch) | (toCommand(roll) << 16) | (toCommand(thrust) << 32) | (toCommand(yaw) << 48), std::memory_order_relaxed);
+    _buttons.store(buttons, std::memory_order_relaxed);
+    _sampleNSecs.store(_nowNSecs(), std::memory_order_release);
+
+    if (_idle.exchange(false)) {
+        _wake.release();
+    }
+}
+
+void ManualControlSender::setRateHz(float rateHz)
+{
+    _rateHz.store(qBound(_minRateHz, rateHz, _maxRateHz), std::memory_order_relaxed);
+}
+
+void ManualControlSender::setLink(const WeakLinkInterfacePtr& link)
+{
+    QMutexLocker locker(&_linkMutex);
+    _link = link;
+}
+
+void ManualControlSender::stop()
+{
+    _exitThread = true;
+    _wake.release();
+}
+
+void ManualControlSender::run()
+{
+    qint64 nextSendNSecs = 0;
+    qint64 lastSendNSecs = 0;
+    qint64 jitterWindowNSecs = _nowNSecs();
+    double deviationSumNSecs = 0;
+    int deviationCount = 0;
+
+    while (!_exitThread) {
+        qint64 now = _nowNSecs();
+
+        const qint64 sampleNSecs = _sampleNSecs.load(std::memory_order_acquire);
+        if ((sampleNSecs == 0) || ((now - sampleNSecs) > _sampleTimeoutNSecs)) {
+            // No joystick is sending, sleep until the next sample
+            _idle = true;
+            if (_sampleNSecs.load(std::memory_order_acquire) == sampleNSecs) {
+                _wake.acquire();
+            } else if (!_idle.exchange(false)) {
+                // A sample arrived in between and already released the semaphore
+                _wake.acquire();
+            }
+            lastSendNSecs = 0;
+            nextSendNSecs = _nowNSecs();
+            continue;
+        }
+
+        if (now < nextSendNSecs) {
+            QThread::usleep(static_cast<unsigned long>((nextSendNSecs - now) / 1000));
+            continue;
+        }
+
+        (void) _send();
+
+        // Jitter of the actual send interval against the period
+        const qint64 periodNSecs = static_cast<qint64>(1e9f / _rateHz.load(std::memory_order_relaxed));
+        if (lastSendNSecs != 0) {
+            deviationSumNSecs += std::llabs((now - lastSendNSecs) - periodNSecs);
+            deviationCount++;
+        }
+        lastSendNSecs = now;
+        if ((now - jitterWindowNSecs) >= 1000000000) {
+            if (deviationCount != 0) {
+                emit jitterChanged(deviationSumNSecs / deviationCount / 1e6);
+            }
+            deviationSumNSecs = 0;
+            deviationCount = 0;
+            jitterWindowNSecs = now;
+        }
+
+        // Advance by whole periods so the rate does not drift with the wake up latency
+        nextSendNSecs += periodNSecs;
+        if (nextSendNSecs <= now) {
+            nextSendNSecs = now + periodNSecs;
+        }
+    }
+}
+
+bool ManualControlSender::_send()
+{
+    SharedLinkInterfacePtr sharedLink;
+    {
+        QMutexLocker locker(&_linkMutex);
+        sharedLink = _link.lock();
+    }
+
+    if (!sharedLink) {
+        qCDebug(ManualControlSenderLog) << "primary link gone!";
+        return false;
+    }
+
+    if (sharedLink->linkConfiguration()->isHighLatency()) {
+        return false;
+    }
+
+    const quint64 axes = _axes.load(std::memory_order_relaxed);
+    const MAVLinkProtocol* const mavlink = qgcApp()->toolbox()->mavlinkProtocol();
+
+    mavlink_message_t message;
+    mavlink_msg_manual_control_pack_chan(
+        static_cast<uint8_t>(mavlink->getSystemId()),
+        static_cast<uint8_t>(mavlink->getComponentId()),
+        sharedLink->mavlinkChannel(),
+        &message,
+        static_cast<uint8_t>(_vehicle->id()),
+        static_cast<int16_t>(axes & 0xffff),
+        static_cast<int16_t>((axes >> 16) & 0xffff),
+        static_cast<int16_t>((axes >> 32) & 0xffff),
+        static_cast<int16_t>((axes >> 48) & 0xffff),
+        static_cast<uint16_t>(_buttons.load(std::memory_order_relaxed)), 0,
+        0,
+        0, 0,
+        0, 0, 0, 0, 0, 0
+    );
+
+    return _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+}
+
+qint64 ManualControlSender::_nowNSecs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "LinkInterface.h"
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+
+#include <atomic>
+
+Q_DECLARE_LOGGING_CATEGORY(ManualControlSenderLog)
+
+class Vehicle;
+
+/// Sends MANUAL_CONTROL at a fixed rate from its own thread. Joysticks publish their latest sample from any thread
+/// without locking, the sender encodes whatever sample is current when a send is due and queues it directly to the
+/// link thread, so a busy GUI thread no longer delays control output. The thread sleeps while no samples arrive.
+class ManualControlSender : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit ManualControlSender(Vehicle* vehicle);
+    ~ManualControlSender();
+
+    /// Publishes the latest control sample, safe to call from any thread
+    ///     @param roll, pitch, yaw, thrust Values in the range -1:1
+    void setSample(float roll, float pitch, float yaw, float thrust, quint16 buttons);
+
+    /// Sets the send rate, safe to call from any thread
+    void setRateHz(float rateHz);
+
+    /// Sets the link the messages are sent on, the sender keeps a weak reference
+    void setLink(const WeakLinkInterfacePtr& link);
+
+    void stop();
+
+signals:
+    /// Mean absolute deviation of the send interval from the period over the last second
+    void jitterChanged(double jitterMSecs);
+
+protected:
+    void run() override;
+
+private:
+    bool _send();
+    static qint64 _nowNSecs();
+
+    Vehicle*                _vehicle;
+    QMutex                  _linkMutex;
+    WeakLinkInterfacePtr    _link;
+
+    std::atomic<quint64>    _axes{0};               ///< Pitch, roll, thrust and yaw as int16 in MANUAL_CONTROL units
+    std::atomic<quint32>    _buttons{0};
+    std::atomic<qint64>     _sampleNSecs{0};        ///< Time of the latest sample, 0 if none
+    std::atomic<float>      _rateHz{25.0f};
+    std::atomic<bool>       _idle{false};
+    std::atomic<bool>       _exitThread{false};
+    QSemaphore              _wake;                  ///< Released by a sample arriving while the sender is idle
+
+    static constexpr qint64 _sampleTimeoutNSecs = 500000000;    ///< Sending stops when samples stop for this long
+    static constexpr float  _minRateHz = 1.0f;
+    static constexpr float  _maxRateHz = 200.0f;
+};
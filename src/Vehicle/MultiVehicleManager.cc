@@ -16,11 +16,18 @@
 #include "QGCOptions.h"
 #include "LinkManager.h"
 #include "Vehicle.h"
+#include "TrackRecorder.h"
+#include "FleetVehicleState.h"
+#include "SharedVehicleState.h"
+#include "AppSettings.h"
+#include "FirmwarePluginManager.h"
+#include "GeoFenceManager.h"
 #if defined (Q_OS_IOS) || defined(Q_OS_ANDROID)
 #include "MobileScreenMgr.h"
 #endif
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QThread>
 #include <QtQml/QQmlEngine>
 
 QGC_LOGGING_CATEGORY(MultiVehicleManagerLog, "MultiVehicleManagerLog")
@@ -40,6 +47,21 @@ MultiVehicleManager::MultiVehicleManager(QGCApplication* app, QGCToolbox* toolbo
     _gcsHeartbeatEnabled = settings.value(_gcsHeartbeatEnabledKey, true).toBool();
     _gcsHeartbeatTimer.setInterval(_gcsHeartbeatRateMSecs);
     _gcsHeartbeatTimer.setSingleShot(false);
+
+    _overviewPublishTimer.setInterval(_overviewPublishMSecs);
+    connect(&_overviewPublishTimer, &QTimer::timeout, this, &MultiVehicleManager::_publishOverviewVehicles);
+
+    _parameterDownloadClock.start();
+    _parameterDownloadTimer.setSingleShot(true);
+    connect(&_parameterDownloadTimer, &QTimer::timeout, this, &MultiVehicleManager::_startParameterDownloads);
+}
+
+MultiVehicleManager::~MultiVehicleManager()
+{
+    if (_fenceMonitorThread) {
+        _fenceMonitorThread->quit();
+        _fenceMonitorThread->wait();
+    }
 }
 
 void MultiVehicleManager::setToolbox(QGCToolbox *toolbox)
@@ -54,10 +76,13 @@ void MultiVehicleManager::setToolbox(QGCToolbox *toolbox)
     qmlRegisterUncreatableType<MultiVehicleManager>("QGroundControl.MultiVehicleManager", 1, 0, "MultiVehicleManager", "Reference only");
     qmlRegisterUncreatableType<Vehicle>            ("QGroundControl.Vehicle",             1, 0, "Vehicle",             "Reference only");
     qmlRegisterUncreatableType<VehicleLinkManager> ("QGroundControl.Vehicle",             1, 0, "VehicleLinkManager",  "Reference only");
+    qmlRegisterUncreatableType<FleetVehicleState>  ("QGroundControl.Vehicle",             1, 0, "FleetVehicleState",   "Reference only");
+    qmlRegisterUncreatableType<TrackRecorder>      ("QGroundControl.Vehicle",             1, 0, "TrackRecorder",       "Reference only");
 
     qRegisterMetaType<Vehicle::MavCmdResultFailureCode_t>("MavCmdResultFailureCode_t");
 
     connect(_mavlinkProtocol, &MAVLinkProtocol::vehicleHeartbeatInfo, this, &MultiVehicleManager::_vehicleHeartbeatInfo);
+    connect(_mavlinkProtocol, &MAVLinkProtocol::messageReceived,      this, &MultiVehicleManager::_mavlinkMessageReceived);
     connect(&_gcsHeartbeatTimer, &QTimer::timeout, this, &MultiVehicleManager::_sendGCSHeartbeat);
 
     if (_gcsHeartbeatEnabled) {
@@ -65,6 +90,27 @@ void MultiVehicleManager::setToolbox(QGCToolbox *toolbox)
     }
 
     _offlineEditingVehicle = new Vehicle(Vehicle::MAV_AUTOPILOT_TRACK, Vehicle::MAV_TYPE_TRACK, _firmwarePluginManager, this);
+
+    (void) qRegisterMetaType<QList<GeoFenceBreachMonitor::VehicleState_t>>("QList<GeoFenceBreachMonitor::VehicleState_t>");
+    (void) qRegisterMetaType<QList<GeoFenceBreachMonitor::Breach_t>>("QList<GeoFenceBreachMonitor::Breach_t>");
+
+    // The monitor has no parent so it can be moved to its thread, it is deleted when the thread finishes
+    _fenceMonitorThread = new QThread(this);
+    _fenceMonitorThread->setObjectName(QStringLiteral("GeoFenceBreach"));
+    _fenceMonitor = new GeoFenceBreachMonitor();
+    _fenceMonitor->moveToThread(_fenceMonitorThread);
+    (void) connect(_fenceMonitorThread, &QThread::finished, _fenceMonitor, &QObject::deleteLater);
+    // Only the newest snapshot matters if the fence monitor falls behind
+    qgcApp()->addCompressedSignal(&MultiVehicleManager::_fenceVehicleStatesChanged);
+    (void) connect(this, &MultiVehicleManager::_fenceVehicleStatesChanged, _fenceMonitor, &GeoFenceBreachMonitor::setVehicleStates, Qt::QueuedConnection);
+    (void) connect(_fenceMonitor, &GeoFenceBreachMonitor::breachesUpdated, this, &MultiVehicleManager::_fenceBreachesUpdated, Qt::QueuedConnection);
+    _fenceMonitorThread->start();
+
+    _fenceStateTimer.setInterval(_fenceStateMSecs);
+    (void) connect(&_fenceStateTimer, &QTimer::timeout, this, &MultiVehicleManager::_updateFenceVehicleStates);
+    _fenceStateTimer.start();
+
+    _sharedVehicleState = new SharedVehicleState(this, this);
 }
 
 void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicleId, int componentId, int vehicleFirmwareType, int vehicleType)
@@ -92,7 +138,7 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
     if (_vehicles.count() > 0 && !qgcApp()->toolbox()->corePlugin()->options()->multiVehicleEnabled()) {
         return;
     }
-    if (_ignoreVehicleIds.contains(vehicleId) || getVehicleById(vehicleId) || vehicleId == 0) {
+    if (_ignoreVehicleIds.contains(vehicleId) || getVehicleById(vehicleId) || _overviewVehicleMap.contains(vehicleId) || vehicleId == 0) {
         return;
     }
 
@@ -108,6 +154,21 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
         break;
     }
 
+    if (qgcApp()->toolbox()->settingsManager()->appSettings()->fleetOverview()->rawValue().toBool()) {
+        _addOverviewVehicle(link, vehicleId, componentId, static_cast<MAV_AUTOPILOT>(vehicleFirmwareType), static_cast<MAV_TYPE>(vehicleType));
+        return;
+    }
+
+    Vehicle* const vehicle = _createVehicle(link, vehicleId, componentId, static_cast<MAV_AUTOPILOT>(vehicleFirmwareType), static_cast<MAV_TYPE>(vehicleType));
+    if (_vehicles.count() > 1) {
+        qgcApp()->showAppMessage(tr("Connected to Vehicle %1").arg(vehicleId));
+    } else {
+        setActiveVehicle(vehicle);
+    }
+}
+
+Vehicle* MultiVehicleManager::_createVehicle(LinkInterface* link, int vehicleId, int componentId, MAV_AUTOPILOT vehicleFirmwareType, MAV_TYPE vehicleType)
+{
     qCDebug(MultiVehicleManagerLog()) << "Adding new vehicle link:vehicleId:componentId:vehicleFirmwareType:vehicleType "
                                       << link->linkConfiguration()->name()
                                       << vehicleId
@@ -119,12 +180,13 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
         _app->showAppMessage(tr("Warning: A vehicle is using the same system id as %1: %2").arg(QCoreApplication::applicationName()).arg(vehicleId));
     }
 
-    Vehicle* vehicle = new Vehicle(link, vehicleId, componentId, (MAV_AUTOPILOT)vehicleFirmwareType, (MAV_TYPE)vehicleType, _firmwarePluginManager, _joystickManager, this);
+    Vehicle* vehicle = new Vehicle(link, vehicleId, componentId, vehicleFirmwareType, vehicleType, _firmwarePluginManager, _joystickManager, this);
     connect(vehicle,                        &Vehicle::requestProtocolVersion,           this, &MultiVehicleManager::_requestProtocolVersion);
     connect(vehicle->vehicleLinkManager(),  &VehicleLinkManager::allLinksRemoved,       this, &MultiVehicleManager::_deleteVehiclePhase1);
     connect(vehicle->parameterManager(),    &ParameterManager::parametersReadyChanged,  this, &MultiVehicleManager::_vehicleParametersReadyChanged);
 
     _vehicles.append(vehicle);
+    _vehicleIdMap[vehicleId] = vehicle;
 
     // Send QGC heartbeat ASAP, this allows PX4 to start accepting commands
     _sendGCSHeartbeat();
@@ -133,12 +195,6 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
 
     emit vehicleAdded(vehicle);
 
-    if (_vehicles.count() > 1) {
-        qgcApp()->showAppMessage(tr("Connected to Vehicle %1").arg(vehicleId));
-    } else {
-        setActiveVehicle(vehicle);
-    }
-
 #if defined (Q_OS_IOS) || defined(Q_OS_ANDROID)
     if(_vehicles.count() == 1) {
         //-- Once a vehicle is connected, keep screen from going off
@@ -147,6 +203,74 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
     }
 #endif
 
+    return vehicle;
+}
+
+void MultiVehicleManager::_addOverviewVehicle(LinkInterface* link, int vehicleId, int componentId, MAV_AUTOPILOT vehicleFirmwareType, MAV_TYPE vehicleType)
+{
+    qCDebug(MultiVehicleManagerLog()) << "Adding overview vehicle link:vehicleId:componentId:vehicleFirmwareType:vehicleType "
+                                      << link->linkConfiguration()->name()
+                                      << vehicleId
+                                      << componentId
+                                      << vehicleFirmwareType
+                                      << vehicleType;
+
+    FleetVehicleState* const state = new FleetVehicleState(link, vehicleId, componentId, vehicleFirmwareType, vehicleType, _firmwarePluginManager->firmwarePluginForAutopilot(vehicleFirmwareType, vehicleType), this);
+    _overviewVehicles.append(state);
+    _overviewVehicleMap[vehicleId] = state;
+
+    if (!_overviewPublishTimer.isActive()) {
+        _overviewPublishTimer.start();
+    }
+
+    // The GCS heartbeat keeps the vehicle streaming to us, same as for a full vehicle
+    _sendGCSHeartbeat();
+}
+
+void MultiVehicleManager::_publishOverviewVehicles(void)
+{
+    for (int i=_overviewVehicles.count() - 1; i>=0; i--) {
+        FleetVehicleState* const state = _overviewVehicles.value<FleetVehicleState*>(i);
+        if (state->link().expired()) {
+            _removeOverviewVehicle(state);
+            continue;
+        }
+        state->publish();
+    }
+
+    if (_overviewVehicles.count() == 0) {
+        _overviewPublishTimer.stop();
+    }
+}
+
+void MultiVehicleManager::_removeOverviewVehicle(FleetVehicleState* state)
+{
+    qCDebug(MultiVehicleManagerLog) << "_removeOverviewVehicle" << state->id();
+
+    _overviewVehicleMap.remove(state->id());
+    _overviewVehicles.removeOne(state);
+    state->deleteLater();
+}
+
+bool MultiVehicleManager::promoteOverviewVehicle(int vehicleId)
+{
+    FleetVehicleState* const state = _overviewVehicleMap.value(vehicleId, nullptr);
+    if (!state) {
+        return false;
+    }
+
+    const SharedLinkInterfacePtr link = state->link().lock();
+    const int componentId = state->componentId();
+    const MAV_AUTOPILOT firmwareType = state->firmwareType();
+    const MAV_TYPE vehicleType = state->vehicleType();
+    _removeOverviewVehicle(state);
+    if (!link) {
+        return false;
+    }
+
+    qCDebug(MultiVehicleManagerLog) << "promoteOverviewVehicle" << vehicleId;
+    setActiveVehicle(_createVehicle(link.get(), vehicleId, componentId, firmwareType, vehicleType));
+    return true;
 }
 
 /// This slot is connected to the Vehicle::requestProtocolVersion signal such that the vehicle manager
@@ -193,6 +317,9 @@ void MultiVehicleManager::_deleteVehiclePhase1(Vehicle* vehicle)
     if (!found) {
         qWarning() << "Vehicle not found in map!";
     }
+    if (_vehicleIdMap.value(vehicle->id()) == vehicle) {
+        _vehicleIdMap.remove(vehicle->id());
+    }
 
     // First we must signal that a vehicle is no longer available.
     _activeVehicleAvailable = false;
@@ -201,6 +328,7 @@ void MultiVehicleManager::_deleteVehiclePhase1(Vehicle* vehicle)
     emit parameterReadyVehicleAvailableChanged(false);
     emit vehicleRemoved(vehicle);
     vehicle->prepareDelete();
+    _removeParameterDownload(vehicle);
 
 #if defined (Q_OS_IOS) || defined(Q_OS_ANDROID)
     if(_vehicles.count() == 0) {
@@ -317,6 +445,94 @@ void MultiVehicleManager::_vehicleParametersReadyChanged(bool parametersReady)
     }
 }
 
+void MultiVehicleManager::requestParameterDownload(Vehicle* vehicle)
+{
+    SharedLinkInterfacePtr sharedLink = vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (!sharedLink) {
+        vehicle->parameterManager()->refreshAllParameters();
+        return;
+    }
+
+    qCDebug(MultiVehicleManagerLog) << "Parameter download requested" << vehicle->id() << sharedLink->linkConfiguration()->name();
+    _parameterDownloadQueues[sharedLink.get()].queued.append(vehicle);
+    _startParameterDownloads();
+}
+
+void MultiVehicleManager::parameterDownloadComplete(Vehicle* vehicle)
+{
+    _removeParameterDownload(vehicle);
+}
+
+void MultiVehicleManager::_removeParameterDownload(Vehicle* vehicle)
+{
+    bool removed = false;
+    for (ParameterDownloadQueue_t& queue: _parameterDownloadQueues) {
+        removed |= queue.queued.removeAll(vehicle) > 0;
+        removed |= queue.running.removeIf([vehicle](const QPair<Vehicle*, qint64>& entry) { return entry.first == vehicle; }) > 0;
+    }
+
+    if (removed) {
+        // Next download starts from the event loop, this may be called from within a download
+        _parameterDownloadTimer.start(0);
+    }
+}
+
+void MultiVehicleManager::_startParameterDownloads(void)
+{
+    const qint64    nowMSecs        = _parameterDownloadClock.elapsed();
+    qint64          nextCheckMSecs  = -1;
+    QList<Vehicle*> startVehicles;
+
+    const auto scheduleCheck = [&nextCheckMSecs](qint64 msecs) {
+        nextCheckMSecs = (nextCheckMSecs < 0) ? msecs : qMin(nextCheckMSecs, msecs);
+    };
+
+    for (auto it = _parameterDownloadQueues.begin(); it != _parameterDownloadQueues.end(); ) {
+        ParameterDownloadQueue_t& queue = it.value();
+
+        (void) queue.running.removeIf([nowMSecs](const QPair<Vehicle*, qint64>& entry) {
+            if ((nowMSecs - entry.second) >= _parameterDownloadSlotMSecs) {
+                qCDebug(MultiVehicleManagerLog) << "Parameter download slow, freeing its slot" << entry.first->id();
+                return true;
+            }
+            return false;
+        });
+
+        while (!queue.queued.isEmpty() && (queue.running.count() < _maxParameterDownloadsPerLink)) {
+            const qint64 sinceLastStartMSecs = nowMSecs - queue.lastStartMSecs;
+            if ((queue.lastStartMSecs >= 0) && (sinceLastStartMSecs < _parameterDownloadStaggerMSecs)) {
+                scheduleCheck(_parameterDownloadStaggerMSecs - sinceLastStartMSecs);
+                break;
+            }
+
+            Vehicle* const vehicle = queue.queued.takeFirst();
+            queue.running.append(QPair<Vehicle*, qint64>(vehicle, nowMSecs));
+            queue.lastStartMSecs = nowMSecs;
+            startVehicles.append(vehicle);
+        }
+
+        for (const QPair<Vehicle*, qint64>& entry: queue.running) {
+            scheduleCheck(_parameterDownloadSlotMSecs - (nowMSecs - entry.second));
+        }
+
+        if (queue.queued.isEmpty() && queue.running.isEmpty()) {
+            it = _parameterDownloadQueues.erase(it);
+        } else {
+            it++;
+        }
+    }
+
+    if (nextCheckMSecs >= 0) {
+        _parameterDownloadTimer.start(static_cast<int>(nextCheckMSecs));
+    }
+
+    // Started last, a download may complete right away and call back into parameterDownloadComplete
+    for (Vehicle* vehicle: startVehicles) {
+        qCDebug(MultiVehicleManagerLog) << "Starting parameter download" << vehicle->id();
+        vehicle->parameterManager()->refreshAllParameters();
+    }
+}
+
 void MultiVehicleManager::saveSetting(const QString &name, const QString& value)
 {
     QSettings settings;
@@ -331,14 +547,32 @@ QString MultiVehicleManager::loadSetting(const QString &name, const QString& def
 
 Vehicle* MultiVehicleManager::getVehicleById(int vehicleId)
 {
-    for (int i=0; i< _vehicles.count(); i++) {
-        Vehicle* vehicle = qobject_cast<Vehicle*>(_vehicles[i]);
-        if (vehicle->id() == vehicleId) {
-            return vehicle;
+    return _vehicleIdMap.value(vehicleId, nullptr);
+}
+
+/// Routes incoming messages to the Vehicle which owns them instead of having every Vehicle filter the full stream
+void MultiVehicleManager::_mavlinkMessageReceived(LinkInterface* link, const mavlink_message_t& message)
+{
+    if (message.sysid == 0 || message.msgid == MAVLINK_MSG_ID_RADIO_STATUS) {
+        // Broadcast messages go to everyone. RADIO_STATUS is sent by radios with their own system id,
+        // each Vehicle decides whether it comes from one of its links.
+        const QList<Vehicle*> vehicles = _vehicleIdMap.values();
+        for (Vehicle* vehicle : vehicles) {
+            vehicle->_mavlinkMessageReceived(link, message);
         }
+        return;
+    }
+
+    Vehicle* vehicle = _vehicleIdMap.value(message.sysid, nullptr);
+    if (vehicle) {
+        vehicle->_mavlinkMessageReceived(link, message);
+        return;
     }
 
-    return nullptr;
+    FleetVehicleState* const state = _overviewVehicleMap.value(message.sysid, nullptr);
+    if (state && (message.compid == state->componentId())) {
+        state->handleMessage(message);
+    }
 }
 
 void MultiVehicleManager::setGcsHeartbeatEnabled(bool gcsHeartBeatEnabled)
@@ -381,7 +615,66 @@ void MultiVehicleManager::_sendGCSHeartbeat(void)
 
             uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
             int len = mavlink_msg_to_send_buffer(buffer, &message);
-            link->writeBytesThreadSafe((const char*)buffer, len);
+            link->writeBytesThreadSafe((const char*)buffer, len, LinkInterface::WritePriorityControl);
+        }
+    }
+}
+
+void MultiVehicleManager::_updateFenceVehicleStates(void)
+{
+    QList<GeoFenceBreachMonitor::VehicleState_t> vehicleStates;
+    for (int i = 0; i < _vehicles.count(); i++) {
+        Vehicle* const vehicle = _vehicles.value<Vehicle*>(i);
+
+        GeoFenceBreachMonitor::VehicleState_t vehicleState;
+        vehicleState.fence = vehicle->geoFenceManager()->fenceIndex();
+        if (!vehicleState.fence) {
+            continue;
+        }
+        vehicleState.vehicleId = vehicle->id();
+        vehicleState.coordinate = vehicle->coordinate();
+        vehicleState.groundSpeed = vehicle->groundSpeed()->rawValue().toDouble();
+        vehicleState.heading = vehicle->heading()->rawValue().toDouble();
+        vehicleStates.append(vehicleState);
+    }
+
+    if (!vehicleStates.isEmpty() || !_fenceWarningVehicleIds.isEmpty()) {
+        emit _fenceVehicleStatesChanged(vehicleStates);
+    }
+}
+
+void MultiVehicleManager::_fenceBreachesUpdated(const QList<GeoFenceBreachMonitor::Breach_t>& breaches)
+{
+    QSet<int> warningVehicleIds;
+    for (const GeoFenceBreachMonitor::Breach_t& breach : breaches) {
+        Vehicle* const vehicle = getVehicleById(breach.vehicleId);
+        if (!vehicle) {
+            continue;
+        }
+
+        switch (breach.state) {
+        case GeoFenceBreachMonitor::BreachActive:
+            vehicle->setFenceWarning(tr("Outside geofence"));
+            break;
+        case GeoFenceBreachMonitor::BreachPredicted:
+            vehicle->setFenceWarning(tr("Geofence breach in %1 s").arg(qRound(breach.timeToBreach)));
+            break;
+        case GeoFenceBreachMonitor::BreachProximity:
+            vehicle->setFenceWarning(tr("%1 m from geofence").arg(qRound(breach.boundaryDistance)));
+            break;
+        case GeoFenceBreachMonitor::BreachNone:
+            continue;
+        }
+        warningVehicleIds.insert(breach.vehicleId);
+    }
+
+    for (const int vehicleId : std::as_const(_fenceWarningVehicleIds)) {
+        if (!warningVehicleIds.contains(vehicleId)) {
+            Vehicle* const vehicle = getVehicleById(vehicleId);
+            if (vehicle) {
+                vehicle->setFenceWarning(QString());
+            }
         }
     }
+    _fenceWarningVehicleIds = warningVehicleIds;
 }
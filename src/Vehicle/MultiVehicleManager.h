@@ -14,11 +14,17 @@
 #pragma once
 
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QSet>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtCore/QLoggingCategory>
 
 #include "QGCToolbox.h"
 #include "QmlObjectListModel.h"
+#include "MAVLinkLib.h"
+#include "GeoFenceBreachMonitor.h"
 
 class FirmwarePluginManager;
 class JoystickManager;
@@ -26,6 +32,9 @@ class QGCApplication;
 class MAVLinkProtocol;
 class LinkInterface;
 class Vehicle;
+class FleetVehicleState;
+class SharedVehicleState;
+class QThread;
 
 Q_DECLARE_LOGGING_CATEGORY(MultiVehicleManagerLog)
 
@@ -36,6 +45,7 @@ class MultiVehicleManager : public QGCTool
 
 public:
     MultiVehicleManager(QGCApplication* app, QGCToolbox* toolbox);
+    ~MultiVehicleManager();
 
     Q_INVOKABLE void        saveSetting (const QString &key, const QString& value);
     Q_INVOKABLE QString     loadSetting (const QString &key, const QString& defaultValue);
@@ -44,6 +54,7 @@ public:
     Q_PROPERTY(bool                 parameterReadyVehicleAvailable  READ parameterReadyVehicleAvailable                                 NOTIFY parameterReadyVehicleAvailableChanged)
     Q_PROPERTY(Vehicle*             activeVehicle                   READ activeVehicle                  WRITE setActiveVehicle          NOTIFY activeVehicleChanged)
     Q_PROPERTY(QmlObjectListModel*  vehicles                        READ vehicles                                                       CONSTANT)
+    Q_PROPERTY(QmlObjectListModel*  overviewVehicles                READ overviewVehicles                                               CONSTANT)   ///< FleetVehicleState of the vehicles only monitored in the fleet overview
     Q_PROPERTY(bool                 gcsHeartBeatEnabled             READ gcsHeartbeatEnabled            WRITE setGcsHeartbeatEnabled    NOTIFY gcsHeartBeatEnabledChanged)
     Q_PROPERTY(Vehicle*             offlineEditingVehicle           READ offlineEditingVehicle                                          CONSTANT)
     Q_PROPERTY(QGeoCoordinate       lastKnownLocation               READ lastKnownLocation                                              NOTIFY lastKnownLocationChanged) //< Current vehicles last know location
@@ -52,6 +63,10 @@ public:
 
     Q_INVOKABLE Vehicle* getVehicleById(int vehicleId);
 
+    /// Replaces the overview state of a vehicle with a full Vehicle and makes it the active vehicle
+    ///     @return false if the vehicle is not in the overview or its link is gone
+    Q_INVOKABLE bool promoteOverviewVehicle(int vehicleId);
+
     // Property accessors
 
     bool activeVehicleAvailable(void) const{ return _activeVehicleAvailable; }
@@ -62,17 +77,28 @@ public:
     void setActiveVehicle(Vehicle* vehicle);
 
     QmlObjectListModel* vehicles(void) { return &_vehicles; }
+    QmlObjectListModel* overviewVehicles(void) { return &_overviewVehicles; }
 
     bool gcsHeartbeatEnabled(void) const { return _gcsHeartbeatEnabled; }
     void setGcsHeartbeatEnabled(bool gcsHeartBeatEnabled);
 
     Vehicle* offlineEditingVehicle(void) { return _offlineEditingVehicle; }
 
+    /// Snapshot of all vehicles which plugins can read from any thread
+    SharedVehicleState* sharedVehicleState(void) { return _sharedVehicleState; }
+
     // Override from QGCTool
     virtual void setToolbox(QGCToolbox *toolbox);
 
     QGeoCoordinate lastKnownLocation    () { return _lastKnownLocation; }
 
+    /// Starts the initial parameter download of the vehicle. Vehicles sharing a link take turns: only a few
+    /// downloads run on a link at the same time and their starts are staggered, the other vehicles are queued.
+    void requestParameterDownload(Vehicle* vehicle);
+
+    /// Must be called once the initial parameter download of the vehicle is done, frees its slot on the link
+    void parameterDownloadComplete(Vehicle* vehicle);
+
 signals:
     void vehicleAdded                   (Vehicle* vehicle);
     void vehicleRemoved                 (Vehicle* vehicle);
@@ -83,6 +109,7 @@ signals:
     void lastKnownLocationChanged       ();
 #ifndef DOXYGEN_SKIP
     void _deleteVehiclePhase2Signal     (void);
+    void _fenceVehicleStatesChanged     (const QList<GeoFenceBreachMonitor::VehicleState_t>& vehicleStates);
 #endif
 
 private slots:
@@ -94,9 +121,24 @@ private slots:
     void _vehicleHeartbeatInfo          (LinkInterface* link, int vehicleId, int componentId, int vehicleFirmwareType, int vehicleType);
     void _requestProtocolVersion        (unsigned version);
     void _coordinateChanged             (QGeoCoordinate coordinate);
+    void _mavlinkMessageReceived        (LinkInterface* link, const mavlink_message_t& message);
+    void _startParameterDownloads       (void);
+    void _publishOverviewVehicles       (void);
+    void _updateFenceVehicleStates      (void);
+    void _fenceBreachesUpdated          (const QList<GeoFenceBreachMonitor::Breach_t>& breaches);
 
 private:
     bool _vehicleExists(int vehicleId);
+    void _removeParameterDownload(Vehicle* vehicle);
+    Vehicle* _createVehicle(LinkInterface* link, int vehicleId, int componentId, MAV_AUTOPILOT vehicleFirmwareType, MAV_TYPE vehicleType);
+    void _addOverviewVehicle(LinkInterface* link, int vehicleId, int componentId, MAV_AUTOPILOT vehicleFirmwareType, MAV_TYPE vehicleType);
+    void _removeOverviewVehicle(FleetVehicleState* state);
+
+    typedef struct {
+        QList<Vehicle*>                     queued;
+        QList<QPair<Vehicle*, qint64>>      running;            ///< Vehicle, start time
+        qint64                              lastStartMSecs = -1;
+    } ParameterDownloadQueue_t;
 
     bool        _activeVehicleAvailable;            ///< true: An active vehicle is available
     bool        _parameterReadyVehicleAvailable;    ///< true: An active vehicle with ready parameters is available
@@ -109,6 +151,12 @@ private:
     QList<int>  _ignoreVehicleIds;          ///< List of vehicle id for which we ignore further communication
 
     QmlObjectListModel  _vehicles;
+    QHash<int, Vehicle*> _vehicleIdMap;     ///< Same vehicles as _vehicles keyed by id, used to route incoming messages
+
+    QmlObjectListModel              _overviewVehicles;
+    QHash<int, FleetVehicleState*>  _overviewVehicleMap;    ///< Same states as _overviewVehicles keyed by id
+    QTimer                          _overviewPublishTimer;  ///< Publishes overview changes to the ui
+    static constexpr int _overviewPublishMSecs = 1000;
 
     FirmwarePluginManager*      _firmwarePluginManager;
     JoystickManager*            _joystickManager;
@@ -119,4 +167,19 @@ private:
     bool                _gcsHeartbeatEnabled;           ///< Enabled/disable heartbeat emission
     static constexpr int    _gcsHeartbeatRateMSecs = 1000;  ///< Heartbeat rate
     static constexpr const char* _gcsHeartbeatEnabledKey = "gcsHeartbeatEnabled";
+
+    QMap<LinkInterface*, ParameterDownloadQueue_t>  _parameterDownloadQueues;   ///< Initial parameter downloads by primary link
+    QElapsedTimer                                   _parameterDownloadClock;
+    QTimer                                          _parameterDownloadTimer;    ///< Starts the next queued download
+    static constexpr int _maxParameterDownloadsPerLink  = 2;
+    static constexpr int _parameterDownloadStaggerMSecs = 250;      ///< Minimum time between download starts on a link
+    static constexpr int _parameterDownloadSlotMSecs    = 30000;    ///< Slow downloads give up their slot after this, they keep running
+
+    QThread*                _fenceMonitorThread = nullptr;  ///< Geofence breach checks run here
+    GeoFenceBreachMonitor*  _fenceMonitor = nullptr;
+
+    SharedVehicleState*     _sharedVehicleState = nullptr;
+    QTimer                  _fenceStateTimer;               ///< Sends the vehicle states to the fence monitor
+    QSet<int>               _fenceWarningVehicleIds;        ///< Vehicles which currently show a fence warning
+    static constexpr int _fenceStateMSecs = 1000;
 };
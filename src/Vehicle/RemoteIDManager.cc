@@ -24,7 +24,17 @@ QGC_LOGGING_CATEGORY(RemoteIDManagerLog, "RemoteIDManagerLog")
 #define ALLOWED_GPS_DELAY 5000
 #define RID_TIMEOUT 2500 // Messages should be arriving at 1 Hz, so we set a 2 second timeout
 
-const uint8_t* RemoteIDManager::_id_or_mac_unknown = new uint8_t[MAVLINK_MSG_OPEN_DRONE_ID_OPERATOR_ID_FIELD_ID_OR_MAC_LEN]();
+namespace {
+
+/// Copies bytes into a fixed size message field, padding with zeros or cutting off the extra bytes
+template<typename T, size_t N>
+void copyToField(T (&field)[N], const QByteArray& bytes)
+{
+    memset(field, 0, N);
+    memcpy(field, bytes.constData(), qMin(N, static_cast<size_t>(bytes.size())));
+}
+
+} // namespace
 
 RemoteIDManager::RemoteIDManager(Vehicle* vehicle)
     : QObject               (vehicle)
@@ -51,7 +61,8 @@ RemoteIDManager::RemoteIDManager(Vehicle* vehicle)
     _odidTimeoutTimer.setInterval(RID_TIMEOUT);
     connect(&_odidTimeoutTimer, &QTimer::timeout, this, &RemoteIDManager::_odidTimeout);
 
-    // Timer to send messages at a constant rate
+    // Timer to send messages at a constant rate. Regulations require at least 1 Hz, which a coarse timer may miss.
+    _sendMessagesTimer.setTimerType(Qt::PreciseTimer);
     _sendMessagesTimer.setInterval(SENDING_RATE_MSEC);
     connect(&_sendMessagesTimer, &QTimer::timeout, this, &RemoteIDManager::_sendMessages);
 
@@ -63,6 +74,21 @@ RemoteIDManager::RemoteIDManager(Vehicle* vehicle)
     connect(_settings->basicIDType(), &Fact::rawValueChanged, this, &RemoteIDManager::_checkGCSBasicID);
     connect(_settings->basicIDUaType(), &Fact::rawValueChanged, this, &RemoteIDManager::_checkGCSBasicID);
 
+    // Messages are only encoded again once a setting they are made from changes
+    _invalidateOnChange(_settings->basicID(),               EncodedBasicID);
+    _invalidateOnChange(_settings->basicIDType(),           EncodedBasicID);
+    _invalidateOnChange(_settings->basicIDUaType(),         EncodedBasicID);
+    _invalidateOnChange(_settings->selfIDType(),            EncodedSelfID);
+    _invalidateOnChange(_settings->selfIDFree(),            EncodedSelfID);
+    _invalidateOnChange(_settings->selfIDEmergency(),       EncodedSelfID);
+    _invalidateOnChange(_settings->selfIDExtended(),        EncodedSelfID);
+    _invalidateOnChange(_settings->operatorID(),            EncodedOperatorID);
+    _invalidateOnChange(_settings->operatorIDType(),        EncodedOperatorID);
+    _invalidateOnChange(_settings->locationType(),          EncodedSystem);
+    _invalidateOnChange(_settings->classificationType(),    EncodedSystem);
+    _invalidateOnChange(_settings->categoryEU(),            EncodedSystem);
+    _invalidateOnChange(_settings->classEU(),               EncodedSystem);
+
     // Assign vehicle sysid and compid. GCS must target these messages to autopilot, and autopilot will redirect them to RID device
     _targetSystem = _vehicle->id();
     _targetComponent = _vehicle->compId();
@@ -75,6 +101,13 @@ RemoteIDManager::RemoteIDManager(Vehicle* vehicle)
     }
 }
 
+void RemoteIDManager::_invalidateOnChange(Fact* fact, EncodedMessage encodedMessage)
+{
+    (void) connect(fact, &Fact::rawValueChanged, this, [this, encodedMessage]() {
+        _encodedMessages &= ~encodedMessage;
+    });
+}
+
 void RemoteIDManager::mavlinkMessageReceived(mavlink_message_t& message )
 {
     switch (message.msgid) {
@@ -120,6 +153,7 @@ void RemoteIDManager::_handleArmStatus(mavlink_message_t& message)
     // We set the targetsystem
     if (_targetSystem != message.sysid) {
         _targetSystem = message.sysid;
+        _encodedMessages = 0;
         qCDebug(RemoteIDManagerLog) << "Subscribing to ODID messages coming from system " << _targetSystem;
     }
 
@@ -167,105 +201,89 @@ void RemoteIDManager::_handleArmStatus(mavlink_message_t& message)
 // Function that sends messages periodically
 void RemoteIDManager::_sendMessages()
 {
+    SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    LinkInterface* link = sharedLink.get();
+
     // We always try to send System
-    _sendSystem();
+    _sendSystem(link);
+
+    if (!link) {
+        return;
+    }
 
     // only send it if the information is correct and the tickbox in settings is set
     if (_GCSBasicIDValid && _settings->sendBasicID()->rawValue().toBool()) {
-        _sendBasicID();
+        _sendBasicID(link);
     }
 
     // We only send selfID if the pilot wants it or in case of a declared emergency. If an emergency is cleared
     // we also keep sending the message, to be sure the non emergency state makes it up to the vehicle
     if (_settings->sendSelfID()->rawValue().toBool() || _emergencyDeclared || _enforceSendingSelfID) {
-        _sendSelfIDMsg();
+        _sendSelfIDMsg(link);
     }
 
     // We only send the OperatorID if the pilot wants it or if the region we have set is europe.
     // To be able to send it, it needs to be filled correclty
     if ((_settings->sendOperatorID()->rawValue().toBool() || (_settings->region()->rawValue().toInt() == Region::EU)) && _operatorIDGood) {
-        _sendOperatorID();
+        _sendOperatorID(link);
     }
 
 }
 
-void RemoteIDManager::_sendSelfIDMsg()
+void RemoteIDManager::_sendSelfIDMsg(LinkInterface* link)
 {
-    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
-    SharedLinkInterfacePtr sharedLink = weakLink.lock();
-
-    if (sharedLink) {
-        mavlink_message_t msg;
-
-        mavlink_msg_open_drone_id_self_id_pack_chan(_mavlink->getSystemId(),
-                                                    _mavlink->getComponentId(),
-                                                    sharedLink->mavlinkChannel(),
-                                                    &msg,
-                                                    _targetSystem,
-                                                    _targetComponent,
-                                                    _id_or_mac_unknown,
-                                                    _emergencyDeclared ? 1 : _settings->selfIDType()->rawValue().toInt(), // If emergency is delcared we send directly a 1 (1 = EMERGENCY)
-                                                    _getSelfIDDescription()); // Depending on the type of SelfID we send a different description
-        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+    if (!(_encodedMessages & EncodedSelfID)) {
+        // id_or_mac is left zeroed, which means unknown
+        _selfIDMessage = {};
+        _selfIDMessage.target_system = _targetSystem;
+        _selfIDMessage.target_component = _targetComponent;
+        _selfIDMessage.description_type = _emergencyDeclared ? 1 : _settings->selfIDType()->rawValue().toInt(); // If emergency is delcared we send directly a 1 (1 = EMERGENCY)
+        copyToField(_selfIDMessage.description, _getSelfIDDescription().toLocal8Bit()); // Depending on the type of SelfID we send a different description
+        _encodedMessages |= EncodedSelfID;
     }
+
+    mavlink_message_t msg;
+    mavlink_msg_open_drone_id_self_id_encode_chan(_mavlink->getSystemId(), _mavlink->getComponentId(), link->mavlinkChannel(), &msg, &_selfIDMessage);
+    _vehicle->sendMessageOnLinkThreadSafe(link, msg);
 }
 
 // We need to return the correct description for the self ID type we have selected
-const char* RemoteIDManager::_getSelfIDDescription()
+QString RemoteIDManager::_getSelfIDDescription()
 {
-    QString descriptionToSend;
-
     if (_emergencyDeclared) {
         // If emergency is declared we dont care about the settings and we send emergency directly
-        descriptionToSend = _settings->selfIDEmergency()->rawValue().toString();
-    } else {
-        switch (_settings->selfIDType()->rawValue().toInt()) {
-            case 0:
-                descriptionToSend = _settings->selfIDFree()->rawValue().toString();
-                break;
-            case 1:
-                descriptionToSend = _settings->selfIDEmergency()->rawValue().toString();
-                break;
-            case 2:
-                descriptionToSend = _settings->selfIDExtended()->rawValue().toString();
-                break;
-            default:
-                descriptionToSend = _settings->selfIDEmergency()->rawValue().toString();
-        }
+        return _settings->selfIDEmergency()->rawValue().toString();
     }
 
-    QByteArray descriptionBuffer = descriptionToSend.toLocal8Bit();
-    descriptionBuffer.resize(MAVLINK_MSG_OPEN_DRONE_ID_SELF_ID_FIELD_DESCRIPTION_LEN);
-    return descriptionBuffer.constData();
+    switch (_settings->selfIDType()->rawValue().toInt()) {
+        case 0:
+            return _settings->selfIDFree()->rawValue().toString();
+        case 1:
+            return _settings->selfIDEmergency()->rawValue().toString();
+        case 2:
+            return _settings->selfIDExtended()->rawValue().toString();
+        default:
+            return _settings->selfIDEmergency()->rawValue().toString();
+    }
 }
 
-void RemoteIDManager::_sendOperatorID()
+void RemoteIDManager::_sendOperatorID(LinkInterface* link)
 {
-    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
-    SharedLinkInterfacePtr sharedLink = weakLink.lock();
-
-    if (sharedLink) {
-        mavlink_message_t msg;
-
-        QByteArray bytesOperatorID = (_settings->operatorID()->rawValue().toString()).toLocal8Bit();
-        bytesOperatorID.resize(MAVLINK_MSG_OPEN_DRONE_ID_OPERATOR_ID_FIELD_OPERATOR_ID_LEN);
-
-        mavlink_msg_open_drone_id_operator_id_pack_chan(
-                                                    _mavlink->getSystemId(),
-                                                    _mavlink->getComponentId(),
-                                                    sharedLink->mavlinkChannel(),
-                                                    &msg,
-                                                    _targetSystem,
-                                                    _targetComponent,
-                                                    _id_or_mac_unknown,
-                                                    _settings->operatorIDType()->rawValue().toInt(),
-                                                    bytesOperatorID.constData());
-
-        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+    if (!(_encodedMessages & EncodedOperatorID)) {
+        _operatorIDMessage = {};
+        _operatorIDMessage.target_system = _targetSystem;
+        _operatorIDMessage.target_component = _targetComponent;
+        _operatorIDMessage.operator_id_type = _settings->operatorIDType()->rawValue().toInt();
+        copyToField(_operatorIDMessage.operator_id, _settings->operatorID()->rawValue().toString().toLocal8Bit());
+        _encodedMessages |= EncodedOperatorID;
     }
+
+    mavlink_message_t msg;
+    mavlink_msg_open_drone_id_operator_id_encode_chan(_mavlink->getSystemId(), _mavlink->getComponentId(), link->mavlinkChannel(), &msg, &_operatorIDMessage);
+    _vehicle->sendMessageOnLinkThreadSafe(link, msg);
 }
 
-void RemoteIDManager::_sendSystem()
+void RemoteIDManager::_sendSystem(LinkInterface* link)
 {
     QGeoCoordinate      gcsPosition;
     QGeoPositionInfo    geoPositionInfo;
@@ -327,33 +345,33 @@ void RemoteIDManager::_sendSystem()
 
     }
 
-    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
-    SharedLinkInterfacePtr sharedLink = weakLink.lock();
-
-    if (sharedLink) {
-        mavlink_message_t msg;
-
-        mavlink_msg_open_drone_id_system_pack_chan(_mavlink->getSystemId(),
-                                                    _mavlink->getComponentId(),
-                                                    sharedLink->mavlinkChannel(),
-                                                    &msg,
-                                                    _targetSystem,
-                                                    _targetComponent,
-                                                    _id_or_mac_unknown,
-                                                    _settings->locationType()->rawValue().toUInt(),
-                                                    _settings->classificationType()->rawValue().toUInt(),
-                                                    _gcsGPSGood ? ( gcsPosition.latitude()  * 1.0e7 ) : 0, // If position not valid, send a 0
-                                                    _gcsGPSGood ? ( gcsPosition.longitude() * 1.0e7 ) : 0, // If position not valid, send a 0
-                                                    AREA_COUNT,
-                                                    AREA_RADIUS,
-                                                    -1000.0f,
-                                                    -1000.0f,
-                                                    _settings->categoryEU()->rawValue().toUInt(),
-                                                    _settings->classEU()->rawValue().toUInt(),
-                                                    _gcsGPSGood ? gcsPosition.altitude() : 0, // If position not valid, send a 0
-                                                    _timestamp2019()), // Time stamp needs to be since 00:00:00 1/1/2019
-        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+    if (!link) {
+        return;
+    }
+
+    if (!(_encodedMessages & EncodedSystem)) {
+        _systemMessage = {};
+        _systemMessage.target_system = _targetSystem;
+        _systemMessage.target_component = _targetComponent;
+        _systemMessage.operator_location_type = _settings->locationType()->rawValue().toUInt();
+        _systemMessage.classification_type = _settings->classificationType()->rawValue().toUInt();
+        _systemMessage.area_count = AREA_COUNT;
+        _systemMessage.area_radius = AREA_RADIUS;
+        _systemMessage.area_ceiling = -1000.0f;
+        _systemMessage.area_floor = -1000.0f;
+        _systemMessage.category_eu = _settings->categoryEU()->rawValue().toUInt();
+        _systemMessage.class_eu = _settings->classEU()->rawValue().toUInt();
+        _encodedMessages |= EncodedSystem;
     }
+
+    _systemMessage.operator_latitude = _gcsGPSGood ? ( gcsPosition.latitude()  * 1.0e7 ) : 0; // If position not valid, send a 0
+    _systemMessage.operator_longitude = _gcsGPSGood ? ( gcsPosition.longitude() * 1.0e7 ) : 0; // If position not valid, send a 0
+    _systemMessage.operator_altitude_geo = _gcsGPSGood ? gcsPosition.altitude() : 0; // If position not valid, send a 0
+    _systemMessage.timestamp = _timestamp2019(); // Time stamp needs to be since 00:00:00 1/1/2019
+
+    mavlink_message_t msg;
+    mavlink_msg_open_drone_id_system_encode_chan(_mavlink->getSystemId(), _mavlink->getComponentId(), link->mavlinkChannel(), &msg, &_systemMessage);
+    _vehicle->sendMessageOnLinkThreadSafe(link, msg);
 }
 
 // Returns seconds elapsed since 00:00:00 1/1/2019
@@ -364,32 +382,21 @@ uint32_t RemoteIDManager::_timestamp2019()
     return ((QDateTime::currentDateTime().currentSecsSinceEpoch()) - secsSinceEpoch2019);
 }
 
-void RemoteIDManager::_sendBasicID()
+void RemoteIDManager::_sendBasicID(LinkInterface* link)
 {
-    WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
-    SharedLinkInterfacePtr sharedLink = weakLink.lock();
-
-    if (sharedLink) {
-        mavlink_message_t msg;
-
-        QString basicIDTemp = _settings->basicID()->rawValue().toString();
-        QByteArray ba = basicIDTemp.toLocal8Bit();
-        // To make sure the buffer is large enough to fit the message. It will add padding bytes if smaller, or exclude the extra ones if bigger
-        ba.resize(MAVLINK_MSG_OPEN_DRONE_ID_BASIC_ID_FIELD_UAS_ID_LEN);
-
-        mavlink_msg_open_drone_id_basic_id_pack_chan(_mavlink->getSystemId(),
-                                                    _mavlink->getComponentId(),
-                                                    sharedLink->mavlinkChannel(),
-                                                    &msg,
-                                                    _targetSystem,
-                                                    _targetComponent,
-                                                    _id_or_mac_unknown,
-                                                    _settings->basicIDType()->rawValue().toUInt(),
-                                                    _settings->basicIDUaType()->rawValue().toUInt(),
-                                                    reinterpret_cast<const unsigned char*>(ba.constData())),
-
-        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+    if (!(_encodedMessages & EncodedBasicID)) {
+        _basicIDMessage = {};
+        _basicIDMessage.target_system = _targetSystem;
+        _basicIDMessage.target_component = _targetComponent;
+        _basicIDMessage.id_type = _settings->basicIDType()->rawValue().toUInt();
+        _basicIDMessage.ua_type = _settings->basicIDUaType()->rawValue().toUInt();
+        copyToField(_basicIDMessage.uas_id, _settings->basicID()->rawValue().toString().toLocal8Bit());
+        _encodedMessages |= EncodedBasicID;
     }
+
+    mavlink_message_t msg;
+    mavlink_msg_open_drone_id_basic_id_encode_chan(_mavlink->getSystemId(), _mavlink->getComponentId(), link->mavlinkChannel(), &msg, &_basicIDMessage);
+    _vehicle->sendMessageOnLinkThreadSafe(link, msg);
 }
 
 void RemoteIDManager::_checkGCSBasicID()
@@ -485,6 +492,7 @@ QChar RemoteIDManager::_calculateLuhnMod36(const QString& input) const {
 void RemoteIDManager::setEmergency(bool declare)
 {
     _emergencyDeclared = declare;
+    _encodedMessages &= ~EncodedSelfID;
     emit emergencyDeclaredChanged();
     // Wether we are starting an emergency or cancelling it, we need to enforce sending
     // this message. Otherwise, if non optimal connection quality, vehicle RID device
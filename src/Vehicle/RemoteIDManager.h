@@ -23,6 +23,8 @@ class RemoteIDSettings;
 class QGCPositionManager;
 class Vehicle;
 class MAVLinkProtocol;
+class LinkInterface;
+class Fact;
 
 // Supporting Open Drone ID protocol
 class RemoteIDManager : public QObject
@@ -59,6 +61,9 @@ public:
 
     void mavlinkMessageReceived (mavlink_message_t& message);
 
+    /// @return Message ids handled by mavlinkMessageReceived
+    static QList<uint32_t> handledMessageIds(void) { return { MAVLINK_MSG_ID_OPEN_DRONE_ID_ARM_STATUS }; }
+
     enum LocationTypes {
         TAKEOFF,
         LiveGNSS,
@@ -87,21 +92,31 @@ private slots:
     void _checkGCSBasicID();
 
 private:
+    /// Messages whose contents are encoded from the settings once and kept until a setting they use changes
+    enum EncodedMessage {
+        EncodedBasicID      = 1 << 0,
+        EncodedSelfID       = 1 << 1,
+        EncodedOperatorID   = 1 << 2,
+        EncodedSystem       = 1 << 3,   ///< All but the GCS position and time stamp, which are filled in for each send
+        EncodedAll          = EncodedBasicID | EncodedSelfID | EncodedOperatorID | EncodedSystem
+    };
+
     void _handleArmStatus(mavlink_message_t& message);
+    void _invalidateOnChange(Fact* fact, EncodedMessage encodedMessage);
 
     // Self ID
-    void        _sendSelfIDMsg ();
-    const char* _getSelfIDDescription();
+    void        _sendSelfIDMsg (LinkInterface* link);
+    QString     _getSelfIDDescription();
 
     // Operator ID
-    void        _sendOperatorID ();
+    void        _sendOperatorID (LinkInterface* link);
 
     // System
-    void        _sendSystem();
+    void        _sendSystem(LinkInterface* link);
     uint32_t    _timestamp2019();
 
     // Basic ID
-    void        _sendBasicID();
+    void        _sendBasicID(LinkInterface* link);
 
     bool _isEUOperatorIDValid(const QString& operatorID) const;
     QChar _calculateLuhnMod36(const QString& input) const;
@@ -129,7 +144,11 @@ private:
     // After emergency cleared, this makes sure the non emergency selfID message makes it to the vehicle
     bool        _enforceSendingSelfID;
 
-    static const uint8_t* _id_or_mac_unknown;
+    int                                 _encodedMessages = 0;   ///< EncodedMessage flags of the messages below which are up to date
+    mavlink_open_drone_id_basic_id_t    _basicIDMessage;
+    mavlink_open_drone_id_self_id_t     _selfIDMessage;
+    mavlink_open_drone_id_operator_id_t _operatorIDMessage;
+    mavlink_open_drone_id_system_t      _systemMessage;
 
     // Timers
     QTimer _odidTimeoutTimer;
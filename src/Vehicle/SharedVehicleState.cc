@@ -0,0 +1,257 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SharedVehicleState.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "QGCLoggingCategory.h"
+#include "Vehicle.h"
+#include "VehicleBatteryFactGroup.h"
+#include "VehicleLinkManager.h"
+
+#include <QtCore/QSet>
+
+#include <chrono>
+#include <cstring>
+#include <new>
+
+QGC_LOGGING_CATEGORY(SharedVehicleStateLog, "qgc.vehicle.sharedvehiclestate")
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Sequence lock needs a lock free atomic");
+
+SharedVehicleState::SharedVehicleState(MultiVehicleManager* multiVehicleManager, QObject* parent)
+    : QObject(parent)
+    , _multiVehicleManager(multiVehicleManager)
+{
+    _sharedMemory.setKey(QString::fromLatin1(sharedMemoryKey));
+
+    // Unit tests must not take over the memory of a QGC running next to them. A segment left over by a crash on Unix
+    // is reused.
+    if (!qgcApp()->runningUnitTests() &&
+            (_sharedMemory.create(sizeof(Memory_t)) ||
+             ((_sharedMemory.error() == QSharedMemory::AlreadyExists) && _sharedMemory.attach() && (_sharedMemory.size() >= static_cast<qsizetype>(sizeof(Memory_t)))))) {
+        _memory = _initialize(_sharedMemory.data());
+    } else {
+        qCDebug(SharedVehicleStateLog) << "Shared memory not available, state is only readable in process:" << _sharedMemory.errorString();
+        if (_sharedMemory.isAttached()) {
+            (void) _sharedMemory.detach();
+        }
+        _localMemory.reset(new Memory_t);
+        _memory = _initialize(_localMemory.get());
+    }
+
+    _publishTimer.setInterval(publishIntervalMSecs);
+    (void) connect(&_publishTimer, &QTimer::timeout, this, &SharedVehicleState::_publish);
+    _publishTimer.start();
+}
+
+SharedVehicleState::~SharedVehicleState()
+{
+    // Readers attached to the shared memory must not see vehicles which are gone
+    for (const int slotIndex: std::as_const(_slotIndices)) {
+        State_t state{};
+        _write(_memory->vehicleSlots[slotIndex], state);
+    }
+}
+
+SharedVehicleState::Memory_t* SharedVehicleState::_initialize(void* data)
+{
+    Memory_t* const memory = static_cast<Memory_t*>(data);
+
+    // Marked invalid while the slots are being set up, in case a reader attaches meanwhile
+    memory->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    for (Slot_t& slot: memory->vehicleSlots) {
+        (void) new (&slot.sequence) std::atomic<uint32_t>(0);
+        memset(&slot.state, 0, sizeof(State_t));
+    }
+    memory->version = version;
+    memory->slotCount = maxVehicles;
+    memory->slotSize = sizeof(Slot_t);
+    std::atomic_thread_fence(std::memory_order_release);
+    memory->magic = magic;
+
+    return memory;
+}
+
+void SharedVehicleState::_write(Slot_t& slot, const State_t& state)
+{
+    // There is only one writer, so the sequence only needs to be published, not exchanged
+    const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.state, &state, sizeof(State_t));
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool SharedVehicleState::_readSlot(const Slot_t& slot, State_t& state)
+{
+    for (int attempt = 0; attempt < _maxReadAttempts; attempt++) {
+        const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        memcpy(&state, &slot.state, sizeof(State_t));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SharedVehicleState::_read(const Memory_t* memory, int vehicleId, State_t& state)
+{
+    if (vehicleId <= 0) {
+        return false;
+    }
+
+    for (const Slot_t& slot: memory->vehicleSlots) {
+        if (_readSlot(slot, state) && (state.vehicleId == vehicleId)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+QList<SharedVehicleState::State_t> SharedVehicleState::_readAll(const Memory_t* memory)
+{
+    QList<State_t> states;
+    State_t state;
+    for (const Slot_t& slot: memory->vehicleSlots) {
+        if (_readSlot(slot, state) && (state.vehicleId != 0)) {
+            states.append(state);
+        }
+    }
+    return states;
+}
+
+bool SharedVehicleState::read(int vehicleId, State_t& state) const
+{
+    return _read(_memory, vehicleId, state);
+}
+
+QList<SharedVehicleState::State_t> SharedVehicleState::readAll(void) const
+{
+    return _readAll(_memory);
+}
+
+void SharedVehicleState::_publish(void)
+{
+    const int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    QmlObjectListModel* const vehicles = _multiVehicleManager->vehicles();
+    QSet<int> vehicleIds;
+    for (int i = 0; i < vehicles->count(); i++) {
+        Vehicle* const vehicle = vehicles->value<Vehicle*>(i);
+        vehicleIds.insert(vehicle->id());
+
+        int slotIndex = _slotIndices.value(vehicle->id(), -1);
+        if (slotIndex < 0) {
+            QList<int> used = _slotIndices.values();
+            for (int j = 0; j < maxVehicles; j++) {
+                if (!used.contains(j)) {
+                    slotIndex = j;
+                    break;
+                }
+            }
+            if (slotIndex < 0) {
+                continue;
+            }
+            _slotIndices[vehicle->id()] = slotIndex;
+        }
+
+        State_t state{};
+        state.vehicleId =           vehicle->id();
+        state.updateUsecs =         now;
+        const QGeoCoordinate coordinate = vehicle->coordinate();
+        state.latitude =            coordinate.isValid() ? coordinate.latitude() : qQNaN();
+        state.longitude =           coordinate.isValid() ? coordinate.longitude() : qQNaN();
+        state.altitudeAMSL =        vehicle->altitudeAMSL()->rawValue().toDouble();
+        state.altitudeRelative =    vehicle->altitudeRelative()->rawValue().toDouble();
+        state.roll =                vehicle->roll()->rawValue().toFloat();
+        state.pitch =               vehicle->pitch()->rawValue().toFloat();
+        state.heading =             vehicle->heading()->rawValue().toFloat();
+        state.groundSpeed =         vehicle->groundSpeed()->rawValue().toFloat();
+        state.airSpeed =            vehicle->airSpeed()->rawValue().toFloat();
+        state.climbRate =           vehicle->climbRate()->rawValue().toFloat();
+        state.batteryVoltage =      qQNaN();
+        state.batteryCurrent =      qQNaN();
+        state.batteryRemaining =    -1;
+        if (vehicle->batteries()->count() > 0) {
+            VehicleBatteryFactGroup* const battery = vehicle->batteries()->value<VehicleBatteryFactGroup*>(0);
+            state.batteryVoltage =  battery->voltage()->rawValue().toFloat();
+            state.batteryCurrent =  battery->current()->rawValue().toFloat();
+            bool ok = false;
+            const int remaining =   battery->percentRemaining()->rawValue().toInt(&ok);
+            state.batteryRemaining = ok ? remaining : -1;
+        }
+        state.messagesReceived =    vehicle->mavlinkReceivedCount();
+        state.messagesLost =        vehicle->mavlinkLossCount();
+        state.linkLossPercent =     vehicle->mavlinkLossPercent();
+        state.armed =               vehicle->armed() ? 1 : 0;
+        state.communicationLost =   vehicle->vehicleLinkManager()->communicationLost() ? 1 : 0;
+        const QByteArray flightMode = vehicle->flightMode().toUtf8().left(sizeof(state.flightMode) - 1);
+        memcpy(state.flightMode, flightMode.constData(), flightMode.size());
+
+        _write(_memory->vehicleSlots[slotIndex], state);
+    }
+
+    // Free the slots of vehicles which are gone
+    for (auto it = _slotIndices.begin(); it != _slotIndices.end();) {
+        if (vehicleIds.contains(it.key())) {
+            ++it;
+        } else {
+            State_t state{};
+            _write(_memory->vehicleSlots[it.value()], state);
+            it = _slotIndices.erase(it);
+        }
+    }
+}
+
+SharedVehicleState::Reader::Reader(void)
+{
+    _sharedMemory.setKey(QString::fromLatin1(sharedMemoryKey));
+}
+
+bool SharedVehicleState::Reader::attach(void)
+{
+    if (_sharedMemory.isAttached()) {
+        (void) _sharedMemory.detach();
+    }
+    if (!_sharedMemory.attach(QSharedMemory::ReadOnly)) {
+        return false;
+    }
+
+    const Memory_t* const memory = static_cast<const Memory_t*>(_sharedMemory.constData());
+    if ((_sharedMemory.size() < static_cast<qsizetype>(sizeof(Memory_t))) || (memory->magic != magic) || (memory->version != version) ||
+            (memory->slotCount != maxVehicles) || (memory->slotSize != sizeof(Slot_t))) {
+        (void) _sharedMemory.detach();
+        return false;
+    }
+
+    return true;
+}
+
+bool SharedVehicleState::Reader::isAttached(void) const
+{
+    return _sharedMemory.isAttached();
+}
+
+bool SharedVehicleState::Reader::read(int vehicleId, State_t& state) const
+{
+    return isAttached() && _read(static_cast<const Memory_t*>(_sharedMemory.constData()), vehicleId, state);
+}
+
+QList<SharedVehicleState::State_t> SharedVehicleState::Reader::readAll(void) const
+{
+    return isAttached() ? _readAll(static_cast<const Memory_t*>(_sharedMemory.constData())) : QList<State_t>();
+}
@@ -0,0 +1,134 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QSharedMemory>
+#include <QtCore/QTimer>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+Q_DECLARE_LOGGING_CATEGORY(SharedVehicleStateLog)
+
+class MultiVehicleManager;
+
+/// Snapshot of the state of each vehicle which plugins and other processes read at their own rate, from any thread,
+/// without ever blocking message handling. The snapshot is refreshed every publishIntervalMSecs on the GUI thread.
+///
+/// Every vehicle has a slot protected by a sequence lock: the writer makes the sequence odd while it copies the new
+/// state in and even again once done. A reader copies the state out and retries if the sequence was odd or changed
+/// meanwhile. Neither side waits for the other and readers never disturb the writer.
+///
+/// The slots live in shared memory (sharedMemoryKey) so tools outside QGC can read them too, through Reader. If the
+/// shared memory is not available, for example in a mobile sandbox, the slots are kept in process memory and only
+/// read() works.
+class SharedVehicleState : public QObject
+{
+    Q_OBJECT
+
+public:
+    SharedVehicleState(MultiVehicleManager* multiVehicleManager, QObject* parent = nullptr);
+    ~SharedVehicleState();
+
+    /// Plain data, the layout is part of the shared memory format. Change version when changing it.
+    typedef struct {
+        int32_t     vehicleId;          ///< 0: Slot not in use
+        int32_t     batteryRemaining;   ///< Percent, -1: unknown
+        int64_t     updateUsecs;        ///< Time of the snapshot, microseconds since the epoch
+        double      latitude;           ///< Degrees, NaN: no position
+        double      longitude;
+        double      altitudeAMSL;       ///< Meters
+        double      altitudeRelative;
+        float       roll;               ///< Degrees
+        float       pitch;
+        float       heading;
+        float       groundSpeed;        ///< Meters/second
+        float       airSpeed;
+        float       climbRate;
+        float       batteryVoltage;     ///< Volts, NaN: unknown
+        float       batteryCurrent;     ///< Amps, NaN: unknown
+        uint64_t    messagesReceived;
+        uint64_t    messagesLost;
+        float       linkLossPercent;
+        uint8_t     armed;
+        uint8_t     communicationLost;
+        uint8_t     reserved[2];
+        char        flightMode[32];     ///< UTF-8, null terminated
+    } State_t;
+
+    static constexpr const char*    sharedMemoryKey =       "QGroundControl Vehicle State";
+    static constexpr uint32_t       magic =                 0x51474356;     ///< "QGCV"
+    static constexpr uint32_t       version =               1;
+    static constexpr int            maxVehicles =           32;
+    static constexpr int            publishIntervalMSecs =  50;
+
+    /// Thread safe
+    ///     @param state Filled in with the latest snapshot of the vehicle
+    /// @return false: vehicle not known
+    bool read(int vehicleId, State_t& state) const;
+
+    /// Thread safe
+    /// @return Latest snapshot of all vehicles
+    QList<State_t> readAll(void) const;
+
+    /// Reads the snapshots of a running QGC from another process
+    class Reader
+    {
+    public:
+        Reader(void);
+
+        /// @return false: QGC is not running or its snapshot format differs
+        bool attach(void);
+        bool isAttached(void) const;
+
+        bool            read    (int vehicleId, State_t& state) const;
+        QList<State_t>  readAll (void) const;
+
+    private:
+        QSharedMemory _sharedMemory;
+    };
+
+private slots:
+    void _publish(void);
+
+private:
+    typedef struct {
+        std::atomic<uint32_t>   sequence;   ///< Odd while the state is being written
+        State_t                 state;
+    } Slot_t;
+
+    typedef struct {
+        uint32_t    magic;
+        uint32_t    version;
+        uint32_t    slotCount;
+        uint32_t    slotSize;
+        Slot_t      vehicleSlots[maxVehicles];
+    } Memory_t;
+
+    static void             _write          (Slot_t& slot, const State_t& state);
+    static bool             _readSlot       (const Slot_t& slot, State_t& state);
+    static bool             _read           (const Memory_t* memory, int vehicleId, State_t& state);
+    static QList<State_t>   _readAll        (const Memory_t* memory);
+    static Memory_t*        _initialize     (void* data);
+
+    MultiVehicleManager*        _multiVehicleManager;
+    QSharedMemory               _sharedMemory;
+    std::unique_ptr<Memory_t>   _localMemory;       ///< Used if the shared memory is not available
+    Memory_t*                   _memory =   nullptr;
+    QHash<int, int>             _slotIndices;       ///< Slot of each vehicle id
+    QTimer                      _publishTimer;
+
+    static constexpr int _maxReadAttempts = 100;    ///< A reader gives up if the writer keeps changing the slot
+};
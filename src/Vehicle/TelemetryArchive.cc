@@ -0,0 +1,540 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryArchive.h"
+#include "AppSettings.h"
+#include "QGCApplication.h"
+#include "QGCLoggingCategory.h"
+#include "SettingsManager.h"
+#include "Vehicle.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QtEndian>
+
+#include <chrono>
+
+QGC_LOGGING_CATEGORY(TelemetryArchiveLog, "qgc.vehicle.telemetryarchive")
+
+bool TelemetryArchive::_recoveryDone = false;
+
+namespace {
+    constexpr const char* fileSuffix = ".arrows";
+    constexpr const char* vehicleFactGroupName = "vehicle";
+
+    ArrowStreamWriter::Type arrowType(mavlink_message_type_t type)
+    {
+        switch (type) {
+        case MAVLINK_TYPE_INT8_T:   return ArrowStreamWriter::Type::Int8;
+        case MAVLINK_TYPE_INT16_T:  return ArrowStreamWriter::Type::Int16;
+        case MAVLINK_TYPE_INT32_T:  return ArrowStreamWriter::Type::Int32;
+        case MAVLINK_TYPE_INT64_T:  return ArrowStreamWriter::Type::Int64;
+        case MAVLINK_TYPE_UINT16_T: return ArrowStreamWriter::Type::UInt16;
+        case MAVLINK_TYPE_UINT32_T: return ArrowStreamWriter::Type::UInt32;
+        case MAVLINK_TYPE_UINT64_T: return ArrowStreamWriter::Type::UInt64;
+        case MAVLINK_TYPE_FLOAT:    return ArrowStreamWriter::Type::Float32;
+        case MAVLINK_TYPE_DOUBLE:   return ArrowStreamWriter::Type::Float64;
+        default:                    return ArrowStreamWriter::Type::UInt8;
+        }
+    }
+
+    int typeSize(mavlink_message_type_t type)
+    {
+        switch (type) {
+        case MAVLINK_TYPE_INT16_T:
+        case MAVLINK_TYPE_UINT16_T:
+            return 2;
+        case MAVLINK_TYPE_INT32_T:
+        case MAVLINK_TYPE_UINT32_T:
+        case MAVLINK_TYPE_FLOAT:
+            return 4;
+        case MAVLINK_TYPE_INT64_T:
+        case MAVLINK_TYPE_UINT64_T:
+        case MAVLINK_TYPE_DOUBLE:
+            return 8;
+        default:
+            return 1;
+        }
+    }
+}
+
+TelemetryArchive::TelemetryArchive(Vehicle* vehicle, QObject* parent)
+    : QObject   (parent)
+    , _vehicle  (vehicle)
+{
+    _sendTimer.setInterval(_sendIntervalMsecs);
+    _factSampleTimer.setInterval(_factSampleIntervalMsecs);
+    (void) connect(&_sendTimer,         &QTimer::timeout, this, &TelemetryArchive::_sendPending);
+    (void) connect(&_factSampleTimer,   &QTimer::timeout, this, &TelemetryArchive::_sampleFactGroups);
+
+    AppSettings* const appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
+    (void) connect(_vehicle,                            &Vehicle::armedChanged,     this, &TelemetryArchive::_updateRecording);
+    (void) connect(appSettings->saveTelemetryArchive(), &Fact::rawValueChanged,     this, &TelemetryArchive::_updateRecording);
+    (void) connect(appSettings->telemetrySaveNotArmed(),&Fact::rawValueChanged,     this, &TelemetryArchive::_updateRecording);
+
+    _worker = new TelemetryArchiveWorker;
+    _worker->moveToThread(&_workerThread);
+    _workerThread.setObjectName(QStringLiteral("TelemetryArchive"));
+    _workerThread.start(QThread::LowPriority);
+
+    _updateRecording();
+}
+
+TelemetryArchive::~TelemetryArchive()
+{
+    // Waits for the worker to write the last batch and finish the files
+    _stop(true /* wait */);
+
+    _workerThread.quit();
+    _workerThread.wait();
+    delete _worker;
+}
+
+qint64 TelemetryArchive::_nowUsecs(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void TelemetryArchive::_updateRecording(void)
+{
+    AppSettings* const appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
+
+    // Like the csv log, only flights are recorded unless logs are also wanted without arming. Each flight gets its own
+    // archive.
+    const bool record = appSettings->saveTelemetryArchive()->rawValue().toBool() &&
+            (_vehicle->armed() || appSettings->telemetrySaveNotArmed()->rawValue().toBool());
+
+    if (record && !_recording) {
+        _start();
+    } else if (!record && _recording) {
+        _stop();
+    }
+}
+
+void TelemetryArchive::_start(void)
+{
+    const QDir telemetryDir(qgcApp()->toolbox()->settingsManager()->appSettings()->telemetrySavePath());
+
+    // Part files left over by a crash are collected before any archive of this run exists, so recovery can not touch
+    // the files of archives being written
+    if (!_recoveryDone) {
+        _recoveryDone = true;
+        QStringList partFiles;
+        QDirIterator it(telemetryDir.absolutePath(), { QStringLiteral("*%1%2").arg(fileSuffix, TelemetryArchiveWorker::partFileSuffix) }, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            partFiles.append(it.next());
+        }
+        if (!partFiles.isEmpty()) {
+            (void) QMetaObject::invokeMethod(_worker, [partFiles]() {
+                TelemetryArchiveWorker::recover(partFiles);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    const QString directory = telemetryDir.absoluteFilePath(QStringLiteral("%1 vehicle%2 archive")
+                                                            .arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyy-MM-dd hh-mm-ss")))
+                                                            .arg(_vehicle->id()));
+    qCDebug(TelemetryArchiveLog) << "Recording to" << directory;
+
+    TelemetryArchiveWorker* const worker = _worker;
+    (void) QMetaObject::invokeMethod(worker, [worker, directory]() {
+        worker->open(directory);
+    }, Qt::QueuedConnection);
+
+    _recording = true;
+    _droppedMessages = 0;
+    _lastFactValues.clear();
+    _sendTimer.start();
+    _factSampleTimer.start();
+}
+
+void TelemetryArchive::_stop(bool wait)
+{
+    if (!_recording) {
+        return;
+    }
+
+    _sendPending();
+    _recording = false;
+    _sendTimer.stop();
+    _factSampleTimer.stop();
+
+    TelemetryArchiveWorker* const worker = _worker;
+    (void) QMetaObject::invokeMethod(worker, [worker]() {
+        worker->close();
+    }, wait ? Qt::BlockingQueuedConnection : Qt::QueuedConnection);
+}
+
+void TelemetryArchive::messageReceived(const mavlink_message_t& message)
+{
+    if (!_recording) {
+        return;
+    }
+
+    if (_pendingMessages.count() >= _maxPendingMessages) {
+        _droppedMessages++;
+        return;
+    }
+
+    _pendingMessages.append({ _nowUsecs(), message });
+}
+
+void TelemetryArchive::_sendPending(void)
+{
+    if (_pendingMessages.isEmpty() && _pendingFactRows.isEmpty()) {
+        return;
+    }
+
+    TelemetryArchiveWorker* const worker = _worker;
+    const QList<Received_t> messages = std::exchange(_pendingMessages, {});
+    const QList<FactRow_t> factRows = std::exchange(_pendingFactRows, {});
+    const quint64 droppedMessages = std::exchange(_droppedMessages, 0);
+    _pendingMessages.reserve(messages.count());
+
+    (void) QMetaObject::invokeMethod(worker, [worker, messages, factRows, droppedMessages]() {
+        worker->writeMessages(messages, droppedMessages);
+        worker->writeFactRows(factRows);
+    }, Qt::QueuedConnection);
+}
+
+/// A row is only added for groups whose values changed since the last sample
+void TelemetryArchive::_sampleFactGroups(void)
+{
+    const qint64 now = _nowUsecs();
+
+    const auto sample = [this, now](const QString& group, FactGroup* factGroup) {
+        const QStringList names = factGroup->factNames();
+        QList<double> values;
+        values.reserve(names.count());
+        for (const QString& name: names) {
+            values.append(factGroup->getFact(name)->rawValue().toDouble());
+        }
+
+        // Compared bitwise so Facts without a value, which are NaN, do not count as changed
+        QList<double>& lastValues = _lastFactValues[group];
+        if (values.isEmpty() || ((values.count() == lastValues.count()) && (memcmp(values.constData(), lastValues.constData(), values.count() * sizeof(double)) == 0))) {
+            return;
+        }
+        lastValues = values;
+        _pendingFactRows.append({ group, names, now, values });
+    };
+
+    sample(QString::fromLatin1(vehicleFactGroupName), _vehicle);
+    for (const QString& groupName: _vehicle->factGroupNames()) {
+        sample(groupName, _vehicle->getFactGroup(groupName));
+    }
+}
+
+TelemetryArchiveWorker::TelemetryArchiveWorker(QObject* parent)
+    : QObject(parent)
+{
+}
+
+TelemetryArchiveWorker::~TelemetryArchiveWorker()
+{
+    close();
+}
+
+void TelemetryArchiveWorker::open(const QString& directory)
+{
+    close();
+
+    if (!QDir().mkpath(directory)) {
+        qCWarning(TelemetryArchiveLog) << "Unable to create" << directory;
+        return;
+    }
+    _directory = directory;
+    _unknownMessages = 0;
+
+    if (!_flushTimer) {
+        _flushTimer = new QTimer(this);
+        _flushTimer->setInterval(_flushIntervalMsecs);
+        (void) connect(_flushTimer, &QTimer::timeout, this, &TelemetryArchiveWorker::_flushAll);
+    }
+    _flushTimer->start();
+}
+
+void TelemetryArchiveWorker::close(void)
+{
+    if (_flushTimer) {
+        _flushTimer->stop();
+    }
+
+    for (Table_t* table: std::as_const(_messageTables)) {
+        if (table) {
+            _finish(table);
+        }
+    }
+    for (Table_t* table: std::as_const(_factTables)) {
+        if (table) {
+            _finish(table);
+        }
+    }
+    _messageTables.clear();
+    _factTables.clear();
+
+    if (!_directory.isEmpty() && _unknownMessages) {
+        qCDebug(TelemetryArchiveLog) << "Messages without definition not archived:" << _unknownMessages;
+    }
+    _directory.clear();
+}
+
+TelemetryArchiveWorker::Table_t* TelemetryArchiveWorker::_createTable(const QString& name, const QList<ArrowStreamWriter::Field_t>& fields)
+{
+    QFile* const file = new QFile(QDir(_directory).absoluteFilePath(name + fileSuffix + partFileSuffix));
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(TelemetryArchiveLog) << "Unable to create" << file->fileName() << file->errorString();
+        delete file;
+        return nullptr;
+    }
+
+    Table_t* const table = new Table_t{ file, new ArrowStreamWriter(fields), {} };
+    (void) file->write(table->writer->schemaMessage());
+    (void) file->flush();
+    return table;
+}
+
+TelemetryArchiveWorker::Table_t* TelemetryArchiveWorker::_messageTable(uint32_t msgid)
+{
+    const auto it = _messageTables.constFind(msgid);
+    if (it != _messageTables.constEnd()) {
+        return it.value();
+    }
+
+    const mavlink_message_info_t* const info = mavlink_get_message_info_by_id(msgid);
+    if (!info) {
+        _messageTables[msgid] = nullptr;
+        return nullptr;
+    }
+
+    QList<ArrowStreamWriter::Field_t> fields = {
+        { QStringLiteral("arrival_time"),   ArrowStreamWriter::Type::TimestampMicros },
+        { QStringLiteral("system_id"),      ArrowStreamWriter::Type::UInt8 },
+        { QStringLiteral("component_id"),   ArrowStreamWriter::Type::UInt8 },
+    };
+    QList<FieldColumn_t> fieldColumns;
+    for (unsigned i = 0; i < info->num_fields; i++) {
+        const mavlink_field_info_t& field = info->fields[i];
+        const QString name = QString::fromLatin1(field.name);
+        const int arrayLength = static_cast<int>(field.array_length);
+
+        if (arrayLength == 0) {
+            fieldColumns.append({ static_cast<int>(fields.count()), field.type, static_cast<int>(field.wire_offset), 0, 0 });
+            fields.append({ name, arrowType(field.type) });
+        } else if (typeSize(field.type) == 1) {
+            // Strings and byte buffers stay in one column
+            fieldColumns.append({ static_cast<int>(fields.count()), field.type, static_cast<int>(field.wire_offset), arrayLength, -1 });
+            fields.append({ name, (field.type == MAVLINK_TYPE_CHAR) ? ArrowStreamWriter::Type::Utf8 : ArrowStreamWriter::Type::Binary });
+        } else {
+            for (int index = 0; index < arrayLength; index++) {
+                fieldColumns.append({ static_cast<int>(fields.count()), field.type, static_cast<int>(field.wire_offset), arrayLength, index });
+                fields.append({ QStringLiteral("%1_%2").arg(name).arg(index), arrowType(field.type) });
+            }
+        }
+    }
+
+    Table_t* const table = _createTable(QString::fromLatin1(info->name), fields);
+    if (table) {
+        table->fieldColumns = fieldColumns;
+    }
+    _messageTables[msgid] = table;
+    return table;
+}
+
+void TelemetryArchiveWorker::writeMessages(const QList<TelemetryArchive::Received_t>& messages, quint64 droppedMessages)
+{
+    if (_directory.isEmpty()) {
+        return;
+    }
+    if (droppedMessages) {
+        qCWarning(TelemetryArchiveLog) << "Archive could not keep up, dropped messages:" << droppedMessages;
+    }
+
+    for (const TelemetryArchive::Received_t& received: messages) {
+        const mavlink_message_t& message = received.message;
+        Table_t* const table = _messageTable(message.msgid);
+        if (!table) {
+            _unknownMessages++;
+            continue;
+        }
+
+        // MAVLink 2 drops trailing zeros from the payload, fields past the received length are zero
+        char payload[MAVLINK_MAX_PAYLOAD_LEN] = {};
+        memcpy(payload, _MAV_PAYLOAD(&message), qMin<size_t>(message.len, sizeof(payload)));
+
+        ArrowStreamWriter* const writer = table->writer;
+        writer->appendInteger(0, received.arrivalUsecs);
+        writer->appendUnsigned(1, message.sysid);
+        writer->appendUnsigned(2, message.compid);
+        for (const FieldColumn_t& field: std::as_const(table->fieldColumns)) {
+            if (field.arrayIndex < 0) {
+                const char* const bytes = payload + field.wireOffset;
+                const int length = (field.type == MAVLINK_TYPE_CHAR) ? static_cast<int>(qstrnlen(bytes, field.arrayLength)) : field.arrayLength;
+                QByteArray value(bytes, length);
+                if (field.type == MAVLINK_TYPE_CHAR) {
+                    value = QString::fromUtf8(value).toUtf8();  // Utf8 columns must be valid
+                }
+                writer->appendBytes(field.column, value);
+                continue;
+            }
+
+            const char* const data = payload + field.wireOffset + (qMax(field.arrayIndex, 0) * typeSize(field.type));
+            switch (field.type) {
+            case MAVLINK_TYPE_CHAR:
+            case MAVLINK_TYPE_UINT8_T:  writer->appendUnsigned(field.column, static_cast<uint8_t>(*data));             break;
+            case MAVLINK_TYPE_INT8_T:   writer->appendInteger(field.column, static_cast<int8_t>(*data));               break;
+            case MAVLINK_TYPE_UINT16_T: writer->appendUnsigned(field.column, qFromLittleEndian<quint16>(data));        break;
+            case MAVLINK_TYPE_INT16_T:  writer->appendInteger(field.column, qFromLittleEndian<qint16>(data));          break;
+            case MAVLINK_TYPE_UINT32_T: writer->appendUnsigned(field.column, qFromLittleEndian<quint32>(data));        break;
+            case MAVLINK_TYPE_INT32_T:  writer->appendInteger(field.column, qFromLittleEndian<qint32>(data));          break;
+            case MAVLINK_TYPE_UINT64_T: writer->appendUnsigned(field.column, qFromLittleEndian<quint64>(data));        break;
+            case MAVLINK_TYPE_INT64_T:  writer->appendInteger(field.column, qFromLittleEndian<qint64>(data));          break;
+            case MAVLINK_TYPE_FLOAT:    writer->appendDouble(field.column, qFromLittleEndian<float>(data));            break;
+            case MAVLINK_TYPE_DOUBLE:   writer->appendDouble(field.column, qFromLittleEndian<double>(data));           break;
+            }
+        }
+        writer->endRow();
+
+        if (writer->rowCount() >= _rowGroupRows) {
+            _flush(table);
+        }
+    }
+
+    _checkBufferedBytes();
+}
+
+void TelemetryArchiveWorker::writeFactRows(const QList<TelemetryArchive::FactRow_t>& rows)
+{
+    if (_directory.isEmpty()) {
+        return;
+    }
+
+    for (const TelemetryArchive::FactRow_t& row: rows) {
+        auto it = _factTables.find(row.group);
+        if (it == _factTables.end()) {
+            QList<ArrowStreamWriter::Field_t> fields = {{ QStringLiteral("arrival_time"), ArrowStreamWriter::Type::TimestampMicros }};
+            for (const QString& name: row.names) {
+                fields.append({ name, ArrowStreamWriter::Type::Float64 });
+            }
+            it = _factTables.insert(row.group, _createTable(QStringLiteral("facts.%1").arg(row.group), fields));
+        }
+        Table_t* const table = it.value();
+        if (!table || (row.values.count() != (table->writer->fields().count() - 1))) {
+            continue;
+        }
+
+        table->writer->appendInteger(0, row.arrivalUsecs);
+        for (qsizetype i = 0; i < row.values.count(); i++) {
+            table->writer->appendDouble(static_cast<int>(i + 1), row.values[i]);
+        }
+        table->writer->endRow();
+
+        if (table->writer->rowCount() >= _rowGroupRows) {
+            _flush(table);
+        }
+    }
+
+    _checkBufferedBytes();
+}
+
+/// Writes a record batch of the rows collected so far. The file is flushed after each batch, so a crash loses only
+/// rows which were not written yet.
+void TelemetryArchiveWorker::_flush(Table_t* table)
+{
+    if (table->writer->rowCount() == 0) {
+        return;
+    }
+
+    if (table->file->write(table->writer->takeRecordBatch()) < 0) {
+        qCWarning(TelemetryArchiveLog) << "Write failed" << table->file->fileName() << table->file->errorString();
+    }
+    (void) table->file->flush();
+}
+
+void TelemetryArchiveWorker::_flushAll(void)
+{
+    for (Table_t* table: std::as_const(_messageTables)) {
+        if (table) {
+            _flush(table);
+        }
+    }
+    for (Table_t* table: std::as_const(_factTables)) {
+        if (table) {
+            _flush(table);
+        }
+    }
+}
+
+void TelemetryArchiveWorker::_checkBufferedBytes(void)
+{
+    qint64 bufferedBytes = 0;
+    for (const Table_t* table: std::as_const(_messageTables)) {
+        if (table) {
+            bufferedBytes += table->writer->bufferedBytes();
+        }
+    }
+    for (const Table_t* table: std::as_const(_factTables)) {
+        if (table) {
+            bufferedBytes += table->writer->bufferedBytes();
+        }
+    }
+
+    if (bufferedBytes > _maxBufferedBytes) {
+        _flushAll();
+    }
+}
+
+void TelemetryArchiveWorker::_finish(Table_t* table)
+{
+    _flush(table);
+    (void) table->file->write(ArrowStreamWriter::endOfStreamMessage());
+    table->file->close();
+
+    const QString partName = table->file->fileName();
+    const QString finalName = partName.chopped(static_cast<qsizetype>(qstrlen(partFileSuffix)));
+    if (!QFile::rename(partName, finalName)) {
+        qCWarning(TelemetryArchiveLog) << "Unable to rename" << partName;
+    }
+
+    delete table->writer;
+    delete table->file;
+    delete table;
+}
+
+void TelemetryArchiveWorker::recover(const QStringList& partFiles)
+{
+    for (const QString& partName: partFiles) {
+        QFile file(partName);
+        if (!file.open(QIODevice::ReadWrite)) {
+            qCWarning(TelemetryArchiveLog) << "Unable to recover" << partName << file.errorString();
+            continue;
+        }
+
+        bool endOfStream = false;
+        const qint64 length = ArrowStreamWriter::completeLength(&file, &endOfStream);
+        if (length == 0) {
+            // Not even the schema made it to disk
+            file.close();
+            (void) file.remove();
+            continue;
+        }
+
+        (void) file.resize(length);
+        if (!endOfStream) {
+            (void) file.seek(length);
+            (void) file.write(ArrowStreamWriter::endOfStreamMessage());
+        }
+        file.close();
+
+        qCDebug(TelemetryArchiveLog) << "Recovered" << partName << length;
+        (void) QFile::rename(partName, partName.chopped(static_cast<qsizetype>(qstrlen(partFileSuffix))));
+    }
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include "ArrowStreamWriter.h"
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryArchiveLog)
+
+class QFile;
+class TelemetryArchiveWorker;
+class Vehicle;
+
+/// Records what a vehicle sends during a flight into columnar files which analysis tools can query directly,
+/// without decoding tlogs. Every received MAVLink message type gets its own Arrow stream file with one column per
+/// field, and every FactGroup of the vehicle gets one with a column per Fact. All rows are timestamped with the
+/// arrival time at the ground station.
+///
+/// Messages are only copied on the GUI thread and handed to TelemetryArchiveWorker in batches, which decodes and
+/// writes them on its own thread.
+class TelemetryArchive : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryArchive(Vehicle* vehicle, QObject* parent = nullptr);
+    ~TelemetryArchive();
+
+    bool recording(void) const { return _recording; }
+
+    /// Called by Vehicle for every message it handles, does nothing unless recording
+    void messageReceived(const mavlink_message_t& message);
+
+    typedef struct {
+        qint64              arrivalUsecs;   ///< Microseconds since the epoch
+        mavlink_message_t   message;
+    } Received_t;
+
+    typedef struct {
+        QString             group;
+        QStringList         names;
+        qint64              arrivalUsecs;
+        QList<double>       values;
+    } FactRow_t;
+
+private slots:
+    void _updateRecording   (void);
+    void _sendPending       (void);
+    void _sampleFactGroups  (void);
+
+private:
+    void _start     (void);
+    void _stop      (bool wait = false);
+
+    static qint64 _nowUsecs(void);
+
+    Vehicle*                _vehicle;
+    QThread                 _workerThread;
+    TelemetryArchiveWorker* _worker = nullptr;
+    bool                    _recording = false;
+    QList<Received_t>       _pendingMessages;
+    QList<FactRow_t>        _pendingFactRows;
+    quint64                 _droppedMessages = 0;
+    QHash<QString, QList<double>> _lastFactValues;
+    QTimer                  _sendTimer;
+    QTimer                  _factSampleTimer;
+
+    static bool _recoveryDone;
+
+    static constexpr int _sendIntervalMsecs =       200;
+    static constexpr int _factSampleIntervalMsecs = 100;
+    static constexpr int _maxPendingMessages =      20000;  ///< ~6 MB, beyond this messages are dropped until the worker catches up
+};
+
+/// Writes the archive files, runs on the worker thread of TelemetryArchive.
+///
+/// Rows are collected per file and written as one record batch once a file has _rowGroupRows rows, once all files
+/// together buffer _maxBufferedBytes, or every _flushIntervalMsecs. So memory use is bounded and at most the last
+/// few seconds are lost if QGC crashes. Files are written as <name>.arrows.part and renamed once complete. Left over
+/// part files of a crash are cut back to their last complete record batch and finished by recover().
+class TelemetryArchiveWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryArchiveWorker(QObject* parent = nullptr);
+    ~TelemetryArchiveWorker();
+
+    void open       (const QString& directory);
+    void close      (void);
+    void writeMessages  (const QList<TelemetryArchive::Received_t>& messages, quint64 droppedMessages);
+    void writeFactRows  (const QList<TelemetryArchive::FactRow_t>& rows);
+
+    /// Finishes part files left over by a crash
+    static void recover(const QStringList& partFiles);
+
+    static constexpr const char* partFileSuffix = ".part";
+
+private:
+    typedef struct {
+        int                     column;
+        mavlink_message_type_t  type;
+        int                     wireOffset;
+        int                     arrayLength;
+        int                     arrayIndex;     ///< -1: whole array as one Utf8/Binary column
+    } FieldColumn_t;
+
+    typedef struct {
+        QFile*                  file;
+        ArrowStreamWriter*      writer;
+        QList<FieldColumn_t>    fieldColumns;
+    } Table_t;
+
+    Table_t*    _messageTable   (uint32_t msgid);
+    Table_t*    _createTable    (const QString& name, const QList<ArrowStreamWriter::Field_t>& fields);
+    void        _flush          (Table_t* table);
+    void        _flushAll       (void);
+    void        _finish         (Table_t* table);
+    void        _checkBufferedBytes(void);
+
+    QString                     _directory;
+    QHash<uint32_t, Table_t*>   _messageTables;
+    QHash<QString, Table_t*>    _factTables;
+    QTimer*                     _flushTimer = nullptr;
+    quint64                     _unknownMessages = 0;
+
+    static constexpr int    _rowGroupRows =         4096;
+    static constexpr qint64 _maxBufferedBytes =     8 * 1024 * 1024;
+    static constexpr int    _flushIntervalMsecs =   5000;
+};
@@ -0,0 +1,465 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryServer.h"
+#include "Fact.h"
+#include "FactGroup.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "QGCLoggingCategory.h"
+#include "QmlObjectListModel.h"
+#include "Vehicle.h"
+
+#include <QtCore/QtEndian>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include <chrono>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TelemetryServerLog, "qgc.vehicle.telemetryserver")
+
+namespace {
+    constexpr const char* vehicleFactGroupName = "vehicle";
+
+    template<typename T>
+    void appendValue(QByteArray& data, T value)
+    {
+        char bytes[sizeof(T)];
+        qToLittleEndian<T>(value, bytes);
+        data.append(bytes, sizeof(T));
+    }
+
+    void appendString(QByteArray& data, const QString& string)
+    {
+        const QByteArray utf8 = string.toUtf8().left(255);
+        appendValue<quint8>(data, static_cast<quint8>(utf8.size()));
+        data.append(utf8);
+    }
+
+    /// Starts a frame, finishFrame fills in the length once the payload is appended
+    QByteArray startFrame(TelemetryServer::FrameType type)
+    {
+        QByteArray frame;
+        appendValue<quint32>(frame, 0);
+        appendValue<quint8>(frame, static_cast<quint8>(type));
+        return frame;
+    }
+
+    void finishFrame(QByteArray& frame)
+    {
+        qToLittleEndian<quint32>(static_cast<quint32>(frame.size() - sizeof(quint32)), frame.data());
+    }
+
+    double factValue(const Fact* fact)
+    {
+        bool ok = false;
+        const double value = fact->rawValue().toDouble(&ok);
+        return ok ? value : qQNaN();
+    }
+
+    /// Compared bitwise so Facts without a value, which are NaN, do not count as changed
+    bool sameValue(double a, double b)
+    {
+        return memcmp(&a, &b, sizeof(double)) == 0;
+    }
+}
+
+TelemetryServer::TelemetryServer(QObject* parent)
+    : QObject(parent)
+{
+    _tickTimer.setTimerType(Qt::PreciseTimer);
+    (void) connect(&_tickTimer, &QTimer::timeout, this, &TelemetryServer::_tick);
+}
+
+TelemetryServer::~TelemetryServer()
+{
+    for (Client_t* client: std::as_const(_clients)) {
+        client->socket->disconnect(this);
+        client->socket->abort();
+        delete client->socket;
+        delete client;
+    }
+    qDeleteAll(_groups);
+}
+
+qint64 TelemetryServer::_nowUsecs(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool TelemetryServer::_parseOptions(const QString& options, quint16& port, int& rateHz)
+{
+    const QStringList pairs = options.split(',', Qt::SkipEmptyParts);
+    for (const QString& pair: pairs) {
+        const QStringList keyValue = pair.split('=');
+        if (keyValue.count() != 2) {
+            qCWarning(TelemetryServerLog) << "Invalid telemetry server option" << pair << "expected key=value";
+            return false;
+        }
+
+        const QString key = keyValue[0].trimmed();
+        bool ok = false;
+        const int value = keyValue[1].trimmed().toInt(&ok);
+        if (key == QStringLiteral("port") && ok && (value > 0) && (value <= 65535)) {
+            port = static_cast<quint16>(value);
+        } else if (key == QStringLiteral("rate") && ok && (value > 0) && (value <= 100)) {
+            rateHz = value;
+        } else {
+            qCWarning(TelemetryServerLog) << "Invalid telemetry server option" << pair;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TelemetryServer::start(const QString& options)
+{
+    quint16 port = defaultPort;
+    int rateHz = defaultRateHz;
+    if (!_parseOptions(options, port, rateHz)) {
+        return false;
+    }
+
+    _server = new QTcpServer(this);
+    if (!_server->listen(QHostAddress::Any, port)) {
+        qCWarning(TelemetryServerLog) << "Unable to listen on port" << port << _server->errorString();
+        return false;
+    }
+    (void) connect(_server, &QTcpServer::newConnection, this, &TelemetryServer::_newConnection);
+
+    const int tickMsecs = 1000 / rateHz;
+    _helloFrame = startFrame(FrameHello);
+    appendValue<quint8>(_helloFrame, protocolVersion);
+    appendValue<quint16>(_helloFrame, static_cast<quint16>(tickMsecs));
+    finishFrame(_helloFrame);
+
+    MultiVehicleManager* const multiVehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+    (void) connect(multiVehicleManager, &MultiVehicleManager::vehicleAdded,   this, &TelemetryServer::_vehicleAdded);
+    (void) connect(multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &TelemetryServer::_vehicleRemoved);
+    for (int i = 0; i < multiVehicleManager->vehicles()->count(); i++) {
+        _vehicleAdded(multiVehicleManager->vehicles()->value<Vehicle*>(i));
+    }
+
+    _tickTimer.start(tickMsecs);
+
+    qCInfo(TelemetryServerLog) << "Serving telemetry on port" << port << "at" << rateHz << "Hz";
+    return true;
+}
+
+void TelemetryServer::_vehicleAdded(Vehicle* vehicle)
+{
+    _addGroups(vehicle);
+    (void) connect(vehicle, &FactGroup::factGroupNamesChanged, this, [this, vehicle]() { _addGroups(vehicle); });
+}
+
+void TelemetryServer::_vehicleRemoved(Vehicle* vehicle)
+{
+    vehicle->disconnect(this);
+
+    QList<quint16> ids;
+    for (const Group_t* group: std::as_const(_groups)) {
+        if (group->vehicleId == vehicle->id()) {
+            ids.append(group->id);
+        }
+    }
+    for (const quint16 id: ids) {
+        _removeGroup(id);
+    }
+}
+
+void TelemetryServer::_addGroups(Vehicle* vehicle)
+{
+    QSet<QString> existing;
+    for (const Group_t* group: std::as_const(_groups)) {
+        if (group->vehicleId == vehicle->id()) {
+            existing.insert(group->name);
+        }
+    }
+
+    const QString vehicleGroupName = QString::fromLatin1(vehicleFactGroupName);
+    if (!existing.contains(vehicleGroupName)) {
+        _addGroup(vehicle, vehicleGroupName, vehicle);
+    }
+    for (const QString& name: vehicle->factGroupNames()) {
+        if (!existing.contains(name)) {
+            _addGroup(vehicle, name, vehicle->getFactGroup(name));
+        }
+    }
+}
+
+void TelemetryServer::_addGroup(Vehicle* vehicle, const QString& name, FactGroup* factGroup)
+{
+    if (!factGroup || factGroup->factNames().isEmpty()) {
+        return;
+    }
+
+    Group_t* const group = new Group_t;
+    group->id = _nextGroupId++;
+    if (_nextGroupId == 0) {
+        _nextGroupId = 1;
+    }
+    group->vehicleId = vehicle->id();
+    group->name = name;
+    group->factGroup = factGroup;
+
+    const QStringList factNames = factGroup->factNames();
+    group->groupFrame = startFrame(FrameGroup);
+    appendValue<quint16>(group->groupFrame, group->id);
+    appendValue<quint8>(group->groupFrame, static_cast<quint8>(group->vehicleId));
+    appendString(group->groupFrame, name);
+    appendValue<quint16>(group->groupFrame, static_cast<quint16>(factNames.count()));
+    for (const QString& factName: factNames) {
+        Fact* const fact = factGroup->getFact(factName);
+        group->facts.append(fact);
+        group->values.append(factValue(fact));
+        appendString(group->groupFrame, factName);
+        appendString(group->groupFrame, fact->rawUnits());
+    }
+    finishFrame(group->groupFrame);
+
+    _groups[group->id] = group;
+    qCDebug(TelemetryServerLog) << "Added group" << group->id << "vehicle" << group->vehicleId << name;
+
+    // Clients already subscribed to it get it right away
+    const qint64 now = _nowUsecs();
+    for (Client_t* client: std::as_const(_clients)) {
+        if (_matches(client, group)) {
+            client->groupIds.insert(group->id);
+            _sendSnapshots(client, { group->id }, now);
+        }
+    }
+}
+
+void TelemetryServer::_removeGroup(quint16 id)
+{
+    Group_t* const group = _groups.take(id);
+    if (!group) {
+        return;
+    }
+
+    QByteArray frame = startFrame(FrameGroupRemoved);
+    appendValue<quint16>(frame, id);
+    finishFrame(frame);
+
+    for (Client_t* client: std::as_const(_clients)) {
+        if (client->groupIds.remove(id)) {
+            (void) client->socket->write(frame);
+        }
+    }
+
+    delete group;
+}
+
+bool TelemetryServer::_matches(const Client_t* client, const Group_t* group) const
+{
+    return client->subscribed &&
+            ((client->vehicleId == 0) || (client->vehicleId == group->vehicleId)) &&
+            (client->groupNames.isEmpty() || client->groupNames.contains(group->name));
+}
+
+QByteArray TelemetryServer::_snapshotFrame(const Group_t* group, qint64 nowUsecs) const
+{
+    QByteArray frame = startFrame(FrameSnapshot);
+    frame.reserve(frame.size() + 12 + (group->values.count() * sizeof(double)));
+    appendValue<quint16>(frame, group->id);
+    appendValue<qint64>(frame, nowUsecs);
+    appendValue<quint16>(frame, static_cast<quint16>(group->values.count()));
+    for (const double value: group->values) {
+        appendValue<double>(frame, value);
+    }
+    finishFrame(frame);
+    return frame;
+}
+
+void TelemetryServer::_sendSnapshots(Client_t* client, const QSet<quint16>& ids, qint64 nowUsecs)
+{
+    for (const quint16 id: ids) {
+        const Group_t* const group = _groups.value(id);
+        if (group) {
+            (void) client->socket->write(group->groupFrame);
+            (void) client->socket->write(_snapshotFrame(group, nowUsecs));
+        }
+    }
+}
+
+void TelemetryServer::_updateSubscription(Client_t* client)
+{
+    const QSet<quint16> previousIds = client->groupIds;
+
+    client->groupIds.clear();
+    for (const Group_t* group: std::as_const(_groups)) {
+        if (_matches(client, group)) {
+            client->groupIds.insert(group->id);
+        }
+    }
+
+    // Groups no longer subscribed are left to the client to drop, new ones start with a snapshot
+    _sendSnapshots(client, client->groupIds - previousIds, _nowUsecs());
+
+    qCDebug(TelemetryServerLog) << "Client" << client->socket->peerAddress().toString() << "subscribed to" << client->groupIds.count() << "groups";
+}
+
+void TelemetryServer::_newConnection(void)
+{
+    while (QTcpSocket* const socket = _server->nextPendingConnection()) {
+        socket->setParent(nullptr);
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        Client_t* const client = new Client_t;
+        client->socket = socket;
+        client->vehicleId = 0;
+        client->subscribed = false;
+        client->resync = false;
+        _clients.append(client);
+
+        (void) connect(socket, &QTcpSocket::readyRead,    this, [this, client]() { _readClient(client); });
+        (void) connect(socket, &QTcpSocket::disconnected, this, [this, client]() { _removeClient(client); });
+
+        (void) socket->write(_helloFrame);
+        qCDebug(TelemetryServerLog) << "Client connected" << socket->peerAddress().toString() << "clients" << _clients.count();
+    }
+}
+
+void TelemetryServer::_removeClient(Client_t* client)
+{
+    if (!_clients.removeOne(client)) {
+        return;
+    }
+
+    qCDebug(TelemetryServerLog) << "Client disconnected" << client->socket->peerAddress().toString() << "clients" << _clients.count();
+    client->socket->disconnect(this);
+    client->socket->deleteLater();
+    delete client;
+}
+
+void TelemetryServer::_readClient(Client_t* client)
+{
+    client->readBuffer.append(client->socket->readAll());
+
+    while (client->readBuffer.size() >= static_cast<qsizetype>(sizeof(quint32) + sizeof(quint8))) {
+        const quint32 length = qFromLittleEndian<quint32>(client->readBuffer.constData());
+        if ((length < 1) || (length > _maxClientFrameBytes)) {
+            qCWarning(TelemetryServerLog) << "Invalid frame from" << client->socket->peerAddress().toString();
+            client->socket->abort();
+            return;
+        }
+        if (client->readBuffer.size() < static_cast<qsizetype>(sizeof(quint32) + length)) {
+            return;
+        }
+
+        const QByteArray frame = client->readBuffer.mid(sizeof(quint32), length);
+        client->readBuffer.remove(0, sizeof(quint32) + length);
+
+        const quint8 type = static_cast<quint8>(frame[0]);
+        if (type != FrameSubscribe) {
+            // Unknown frames are skipped so newer clients can talk to older servers
+            qCDebug(TelemetryServerLog) << "Ignoring frame type" << type;
+            continue;
+        }
+
+        // uint8 vehicle id, uint8 group count, { string group name }
+        qsizetype offset = 1;
+        const auto readByte = [&frame, &offset](quint8& value) {
+            if (offset >= frame.size()) {
+                return false;
+            }
+            value = static_cast<quint8>(frame[offset++]);
+            return true;
+        };
+
+        quint8 vehicleId = 0;
+        quint8 groupCount = 0;
+        QSet<QString> groupNames;
+        bool valid = readByte(vehicleId) && readByte(groupCount);
+        for (int i = 0; valid && (i < groupCount); i++) {
+            quint8 nameLength = 0;
+            valid = readByte(nameLength) && ((offset + nameLength) <= frame.size());
+            if (valid) {
+                groupNames.insert(QString::fromUtf8(frame.constData() + offset, nameLength));
+                offset += nameLength;
+            }
+        }
+        if (!valid) {
+            qCWarning(TelemetryServerLog) << "Invalid subscribe frame from" << client->socket->peerAddress().toString();
+            client->socket->abort();
+            return;
+        }
+
+        client->vehicleId = vehicleId;
+        client->groupNames = groupNames;
+        client->subscribed = true;
+        _updateSubscription(client);
+    }
+}
+
+void TelemetryServer::_tick(void)
+{
+    const qint64 now = _nowUsecs();
+
+    // Encode the changes of each group once, whatever the number of clients
+    for (Group_t* group: std::as_const(_groups)) {
+        group->deltaFrame.clear();
+        if (!group->factGroup) {
+            continue;
+        }
+
+        QByteArray changes;
+        quint16 changeCount = 0;
+        for (qsizetype i = 0; i < group->facts.count(); i++) {
+            const double value = factValue(group->facts[i]);
+            if (!sameValue(value, group->values[i])) {
+                group->values[i] = value;
+                appendValue<quint16>(changes, static_cast<quint16>(i));
+                appendValue<double>(changes, value);
+                changeCount++;
+            }
+        }
+        if (changeCount == 0) {
+            continue;
+        }
+
+        group->deltaFrame = startFrame(FrameDelta);
+        group->deltaFrame.reserve(group->deltaFrame.size() + 12 + changes.size());
+        appendValue<quint16>(group->deltaFrame, group->id);
+        appendValue<qint64>(group->deltaFrame, now);
+        appendValue<quint16>(group->deltaFrame, changeCount);
+        group->deltaFrame.append(changes);
+        finishFrame(group->deltaFrame);
+    }
+
+    for (Client_t* client: std::as_const(_clients)) {
+        if (client->groupIds.isEmpty()) {
+            continue;
+        }
+
+        // Deltas only make sense on top of everything before them, so a client which fell behind is skipped until it
+        // caught up and then starts over from snapshots
+        if (client->socket->bytesToWrite() > _maxClientBacklogBytes) {
+            if (!client->resync) {
+                qCDebug(TelemetryServerLog) << "Client falling behind, skipping updates" << client->socket->peerAddress().toString();
+            }
+            client->resync = true;
+            continue;
+        }
+        if (client->resync) {
+            client->resync = false;
+            _sendSnapshots(client, client->groupIds, now);
+            continue;
+        }
+
+        for (const quint16 id: std::as_const(client->groupIds)) {
+            const Group_t* const group = _groups.value(id);
+            if (group && !group->deltaFrame.isEmpty()) {
+                (void) client->socket->write(group->deltaFrame);
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryServerLog)
+
+class Fact;
+class FactGroup;
+class QTcpServer;
+class QTcpSocket;
+class Vehicle;
+
+/// Serves the decoded state of all vehicles to any number of viewers, used by the --telemetry-server headless mode.
+/// Viewers connect over TCP and subscribe to the FactGroups they want, they then get a snapshot of each group followed
+/// by the values which changed.
+///
+/// The FactGroups are sampled once per tick, not per message. A change is encoded once per tick and the same frame is
+/// written to every client subscribed to the group, so the cost is independent of the message rate and each client
+/// only costs the groups it subscribed to. A client which can not keep up is skipped until its backlog drains and then
+/// resynchronized with fresh snapshots, it never holds up the others.
+///
+/// All values are little endian. Every frame is uint32 length of the rest of the frame, uint8 type, payload. Strings
+/// are uint8 length and UTF-8.
+///
+/// Server to client:
+///     Hello           uint8 protocol version, uint16 tick milliseconds
+///     Group           uint16 group id, uint8 vehicle id, string group name, uint16 fact count, { string name, string units }
+///     Snapshot        uint16 group id, int64 time (usecs since epoch), uint16 value count, { float64 value }
+///     Delta           uint16 group id, int64 time (usecs since epoch), uint16 value count, { uint16 index, float64 value }
+///     GroupRemoved    uint16 group id
+///
+/// Client to server:
+///     Subscribe       uint8 vehicle id (0: all), uint8 group count (0: all), { string group name }
+///
+/// Subscribe replaces the previous subscription. Groups are sent to a client only after it subscribed, the vehicle's
+/// own Facts are the group "vehicle". Values which are not numbers are sent as NaN.
+class TelemetryServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryServer(QObject* parent = nullptr);
+    ~TelemetryServer();
+
+    /// Starts listening
+    ///     @param options port=<port>,rate=<Hz>, both optional
+    /// @return false: invalid options or the port could not be opened
+    bool start(const QString& options);
+
+    int clientCount(void) const { return _clients.count(); }
+
+    enum FrameType {
+        FrameHello =        1,
+        FrameGroup =        2,
+        FrameSnapshot =     3,
+        FrameDelta =        4,
+        FrameGroupRemoved = 5,
+        FrameSubscribe =    16,
+    };
+
+    static constexpr quint8     protocolVersion =   1;
+    static constexpr quint16    defaultPort =       5790;
+    static constexpr int        defaultRateHz =     10;
+
+private slots:
+    void _vehicleAdded      (Vehicle* vehicle);
+    void _vehicleRemoved    (Vehicle* vehicle);
+    void _newConnection     (void);
+    void _tick              (void);
+
+private:
+    typedef struct {
+        quint16             id;
+        int                 vehicleId;
+        QString             name;
+        QPointer<FactGroup> factGroup;
+        QList<Fact*>        facts;
+        QList<double>       values;
+        QByteArray          groupFrame;
+        QByteArray          deltaFrame;     ///< Changes of the current tick, empty if none
+    } Group_t;
+
+    typedef struct {
+        QTcpSocket*         socket;
+        QByteArray          readBuffer;
+        int                 vehicleId;      ///< 0: all
+        QSet<QString>       groupNames;     ///< Empty: all
+        bool                subscribed;
+        bool                resync;         ///< Skipped updates because of its backlog, needs new snapshots
+        QSet<quint16>       groupIds;       ///< Groups matching the subscription
+    } Client_t;
+
+    bool        _parseOptions       (const QString& options, quint16& port, int& rateHz);
+    void        _addGroups          (Vehicle* vehicle);
+    void        _addGroup           (Vehicle* vehicle, const QString& name, FactGroup* factGroup);
+    void        _removeGroup        (quint16 id);
+    bool        _matches            (const Client_t* client, const Group_t* group) const;
+    void        _updateSubscription (Client_t* client);
+    void        _sendSnapshots      (Client_t* client, const QSet<quint16>& ids, qint64 nowUsecs);
+    void        _readClient         (Client_t* client);
+    void        _removeClient       (Client_t* client);
+    QByteArray  _snapshotFrame      (const Group_t* group, qint64 nowUsecs) const;
+
+    static qint64 _nowUsecs(void);
+
+    QTcpServer*                 _server = nullptr;
+    QTimer                      _tickTimer;
+    QHash<quint16, Group_t*>    _groups;
+    QList<Client_t*>            _clients;
+    quint16                     _nextGroupId = 1;
+    QByteArray                  _helloFrame;
+
+    static constexpr qint64 _maxClientBacklogBytes =    256 * 1024;     ///< Client is skipped while more than this is waiting to be sent
+    static constexpr int    _maxClientFrameBytes =      4096;           ///< Larger frames from clients close the connection
+};
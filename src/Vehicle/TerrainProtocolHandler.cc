@@ -21,13 +21,14 @@ TerrainProtocolHandler::TerrainProtocolHandler(Vehicle* vehicle, TerrainFactGrou
     : QObject           (parent)
     , _vehicle          (vehicle)
     , _terrainFactGroup (terrainFactGroup)
+    , _terrainAreaCache (_cMaxCachedAreas)
 {
     _terrainDataSendTimer.setSingleShot(false);
-    _terrainDataSendTimer.setInterval(1000.0/12.0);
+    _terrainDataSendTimer.setInterval(_cSendIntervalMSecs);
     connect(&_terrainDataSendTimer, &QTimer::timeout, this, &TerrainProtocolHandler::_sendNextTerrainData);
 }
 
-bool TerrainProtocolHandler::mavlinkMessageReceived(const mavlink_message_t message)
+bool TerrainProtocolHandler::mavlinkMessageReceived(const mavlink_message_t& message)
 {
     switch (message.msgid) {
     case MAVLINK_MSG_ID_TERRAIN_REQUEST:
@@ -74,87 +75,103 @@ void TerrainProtocolHandler::_handleTerrainReport(const mavlink_message_t& messa
 void TerrainProtocolHandler::_sendNextTerrainData(void)
 {
     if (!_terrainRequestActive) {
+        _terrainDataSendTimer.stop();
         return;
     }
 
-    QGeoCoordinate terrainRequestCoordSWCorner(static_cast<double>(_currentTerrainRequest.lat) / 1e7, static_cast<double>(_currentTerrainRequest.lon) / 1e7);
-    int spacingBetweenGrids = _currentTerrainRequest.grid_spacing * 4;
+    // Until the terrain system has the heights for the whole area this retries on each timer tick
+    const TerrainArea_t* area = _terrainArea(_currentTerrainRequest);
+    if (area) {
+        constexpr int cTerrainDataMessageBytes = MAVLINK_MSG_ID_TERRAIN_DATA_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+        constexpr int cMaxMessagesPerTick = qMax(1, (_cTerrainDataBytesPerSecond * _cSendIntervalMSecs) / (1000 * cTerrainDataMessageBytes));
 
-    // Each TERRAIN_DATA sent to vehicle contains a 4x4 grid of heights
-    // TERRAIN_REQUEST.mask has a bit for each entry in an 8x7 grid
-    // gridBit = 0 refers to the the sw corner of the 8x7 grid
-
-    bool bitFound = false;
-    for (int rowIndex=0; rowIndex<7; rowIndex++) {
-        for (int colIndex=0; colIndex<8; colIndex++) {
-            uint8_t gridBit = (rowIndex * 8) + colIndex;
-            uint64_t checkBit = 1ull << gridBit;
+        // TERRAIN_REQUEST.mask has a bit for each block in the 8x7 area, gridBit = 0 refers to the sw corner block
+        int messagesSent = 0;
+        for (uint8_t gridBit=0; (gridBit < _cRequestBlockRows * _cRequestBlockCols) && (messagesSent < cMaxMessagesPerTick); gridBit++) {
+            const uint64_t checkBit = 1ull << gridBit;
             if (_currentTerrainRequest.mask & checkBit) {
-                // Move east and then north to generate the coordinate for sw corner of the specific gridBit
-                QGeoCoordinate swCorner = terrainRequestCoordSWCorner.atDistanceAndAzimuth(spacingBetweenGrids * colIndex, 90);
-                swCorner = swCorner.atDistanceAndAzimuth(spacingBetweenGrids * rowIndex, 0);
-                _sendTerrainData(swCorner, gridBit);
-                bitFound = true;
-                break;
+                _sendTerrainData(area, gridBit);
+                _currentTerrainRequest.mask &= ~checkBit;
+                messagesSent++;
             }
         }
-        if (bitFound) {
-            break;
-        }
     }
 
-    if (bitFound) {
-        // Kick timer to send next possible TERRAIN_DATA to vehicle
-        _terrainDataSendTimer.start();
-    } else {
+    if (_currentTerrainRequest.mask == 0) {
         _terrainRequestActive = false;
+        _terrainDataSendTimer.stop();
+    } else if (!_terrainDataSendTimer.isActive()) {
+        _terrainDataSendTimer.start();
     }
 }
 
-void TerrainProtocolHandler::_sendTerrainData(const QGeoCoordinate& swCorner, uint8_t gridBit)
+/// @return Heights for the request area, nullptr if the terrain system does not have them yet
+const TerrainProtocolHandler::TerrainArea_t* TerrainProtocolHandler::_terrainArea(const mavlink_terrain_request_t& request)
 {
+    const TerrainAreaKey_t key((static_cast<quint64>(static_cast<quint32>(request.lat)) << 32) | static_cast<quint32>(request.lon), request.grid_spacing);
+    if (const TerrainArea_t* area = _terrainAreaCache.object(key)) {
+        return area;
+    }
+
+    // Grid points of all blocks in gridBit order, each block row major from its sw corner
+    const QGeoCoordinate areaSWCorner(static_cast<double>(request.lat) / 1e7, static_cast<double>(request.lon) / 1e7);
+    const double spacing = request.grid_spacing;
+    const double spacingBetweenBlocks = spacing * _cBlockGridSize;
     QList<QGeoCoordinate> coordinates;
-    for (int rowIndex=0; rowIndex<4; rowIndex++) {
-        for (int colIndex=0; colIndex<4; colIndex++) {
-            // Move east and then north to generate the coordinate for grid point
-            QGeoCoordinate coord = swCorner.atDistanceAndAzimuth(_currentTerrainRequest.grid_spacing * colIndex, 90);
-            coord = coord.atDistanceAndAzimuth(_currentTerrainRequest.grid_spacing * rowIndex, 0);
-            coordinates.append(coord);
+    coordinates.reserve(_cRequestBlockRows * _cRequestBlockCols * _cBlockHeights);
+    for (int blockRow=0; blockRow<_cRequestBlockRows; blockRow++) {
+        for (int blockCol=0; blockCol<_cRequestBlockCols; blockCol++) {
+            // Move east and then north to generate the coordinate for sw corner of the block and then for each grid point
+            QGeoCoordinate blockSWCorner = areaSWCorner.atDistanceAndAzimuth(spacingBetweenBlocks * blockCol, 90);
+            blockSWCorner = blockSWCorner.atDistanceAndAzimuth(spacingBetweenBlocks * blockRow, 0);
+            for (int row=0; row<_cBlockGridSize; row++) {
+                for (int col=0; col<_cBlockGridSize; col++) {
+                    QGeoCoordinate coord = blockSWCorner.atDistanceAndAzimuth(spacing * col, 90);
+                    coord = coord.atDistanceAndAzimuth(spacing * row, 0);
+                    coordinates.append(coord);
+                }
+            }
         }
     }
 
     // Query terrain system for altitudes. If it has them available it will return them. If not they will be queued for download.
     bool            error = false;
     QList<double>   altitudes;
-    if (TerrainAtCoordinateQuery::getAltitudesForCoordinates(coordinates, altitudes, error)) {
-        if (error) {
-            qCWarning(TerrainProtocolHandlerLog) << "_sendTerrainData TerrainAtCoordinateQuery::getAltitudesForCoordinates failed";
-        } else {
-            // Only clear the bit if the query succeeds. Otherwise just let it try again on the next timer tick
-            uint64_t removeBit = ~(1ull << gridBit);
-            _currentTerrainRequest.mask &= removeBit;
-            int altIndex = 0;
-            int16_t terrainData[16];
-            for (const double& altitude : altitudes) {
-                terrainData[altIndex++] = static_cast<int16_t>(altitude);
-            }
+    if (!TerrainAtCoordinateQuery::getAltitudesForCoordinates(coordinates, altitudes, error)) {
+        return nullptr;
+    }
+    if (error) {
+        qCWarning(TerrainProtocolHandlerLog) << "_terrainArea TerrainAtCoordinateQuery::getAltitudesForCoordinates failed";
+        return nullptr;
+    }
 
-            SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
-            if (sharedLink) {
-                mavlink_message_t       msg;
-
-                mavlink_msg_terrain_data_pack_chan(
-                            qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
-                            qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
-                            sharedLink->mavlinkChannel(),
-                            &msg,
-                            _currentTerrainRequest.lat,
-                            _currentTerrainRequest.lon,
-                            _currentTerrainRequest.grid_spacing,
-                            gridBit,
-                            terrainData);
-                _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
-            }
-        }
+    TerrainArea_t* area = new TerrainArea_t;
+    int16_t* const heights = &area->blocks[0][0];
+    for (qsizetype i=0; i<altitudes.count(); i++) {
+        heights[i] = static_cast<int16_t>(altitudes[i]);
+    }
+    qCDebug(TerrainProtocolHandlerLog) << "Cached terrain request area" << areaSWCorner << "spacing" << request.grid_spacing;
+
+    (void) _terrainAreaCache.insert(key, area);
+    return area;
+}
+
+void TerrainProtocolHandler::_sendTerrainData(const TerrainArea_t* area, uint8_t gridBit)
+{
+    SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (sharedLink) {
+        mavlink_message_t       msg;
+
+        mavlink_msg_terrain_data_pack_chan(
+                    qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
+                    qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
+                    sharedLink->mavlinkChannel(),
+                    &msg,
+                    _currentTerrainRequest.lat,
+                    _currentTerrainRequest.lon,
+                    _currentTerrainRequest.grid_spacing,
+                    gridBit,
+                    area->blocks[gridBit]);
+        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
     }
 }
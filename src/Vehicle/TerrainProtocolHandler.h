@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <QtCore/QCache>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -21,6 +22,9 @@ class Vehicle;
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainProtocolHandlerLog)
 
+/// Answers the vehicle's TERRAIN_REQUESTs with TERRAIN_DATA. The heights for a whole request area (8x7 blocks of 4x4
+/// grid points) are looked up in one batched call and cached, so repeated requests for an area are answered without
+/// going back to the terrain system. Blocks are sent in batches each timer tick, limited to a share of the link.
 class TerrainProtocolHandler : public QObject
 {
     Q_OBJECT
@@ -29,19 +33,37 @@ public:
     explicit TerrainProtocolHandler(Vehicle* vehicle, TerrainFactGroup* terrainFactGroup, QObject *parent = nullptr);
 
     /// @return true: Allow vehicle to continue processing, false: Vehicle should not process message
-    bool mavlinkMessageReceived(const mavlink_message_t message);
+    bool mavlinkMessageReceived(const mavlink_message_t& message);
 
 private slots:
     void _sendNextTerrainData(void);
 
 private:
-    void _handleTerrainRequest  (const mavlink_message_t& message);
-    void _handleTerrainReport   (const mavlink_message_t& message);
-    void _sendTerrainData       (const QGeoCoordinate& swCorner, uint8_t gridBit);
+    static constexpr int _cRequestBlockRows =   7;
+    static constexpr int _cRequestBlockCols =   8;
+    static constexpr int _cBlockGridSize =      4;
+    static constexpr int _cBlockHeights =       _cBlockGridSize * _cBlockGridSize;
+
+    /// Heights of all blocks of a request area, indexed by TERRAIN_DATA.gridbit
+    typedef struct {
+        int16_t blocks[_cRequestBlockRows * _cRequestBlockCols][_cBlockHeights];
+    } TerrainArea_t;
+
+    typedef std::pair<quint64, quint16> TerrainAreaKey_t;   ///< lat/lon of the sw corner and grid spacing
+
+    void                    _handleTerrainRequest   (const mavlink_message_t& message);
+    void                    _handleTerrainReport    (const mavlink_message_t& message);
+    const TerrainArea_t*    _terrainArea            (const mavlink_terrain_request_t& request);
+    void                    _sendTerrainData        (const TerrainArea_t* area, uint8_t gridBit);
 
     Vehicle*                    _vehicle;
     TerrainFactGroup*           _terrainFactGroup;
     bool                        _terrainRequestActive =             false;
     mavlink_terrain_request_t   _currentTerrainRequest;
     QTimer                      _terrainDataSendTimer;
+    QCache<TerrainAreaKey_t, TerrainArea_t> _terrainAreaCache;
+
+    static constexpr int _cSendIntervalMSecs =          1000 / 12;
+    static constexpr int _cTerrainDataBytesPerSecond =  2000;   ///< Share of the link used for TERRAIN_DATA, about a third of a 57600 baud radio
+    static constexpr int _cMaxCachedAreas =             64;
 };
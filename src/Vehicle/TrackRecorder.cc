@@ -0,0 +1,282 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TrackRecorder.h"
+#include "Vehicle.h"
+#include "QGC.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+#include "KMLStreamWriter.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+
+#include <cmath>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TrackRecorderLog, "TrackRecorderLog")
+
+TrackRecorder::TrackRecorder(Vehicle* vehicle, QObject* parent)
+    : QObject   (parent)
+    , _vehicle  (vehicle)
+{
+    _flushTimer.setSingleShot(false);
+    _flushTimer.setInterval(_flushIntervalMsecs);
+    connect(&_flushTimer, &QTimer::timeout, this, &TrackRecorder::_flush);
+}
+
+TrackRecorder::~TrackRecorder()
+{
+    stop();
+}
+
+void TrackRecorder::start(void)
+{
+    stop();
+
+    connect(_vehicle, &Vehicle::coordinateChanged, this, &TrackRecorder::_vehicleCoordinateChanged);
+
+    _lastTimestampMsecs = 0;
+    _lastLatitude = 0;
+    _lastLongitude = 0;
+    _lastAltitude = 0;
+    _buffer.clear();
+
+    QString saveDirPath = qgcApp()->toolbox()->settingsManager()->appSettings()->telemetrySavePath();
+    if (saveDirPath.isEmpty()) {
+        saveDirPath = QDir::tempPath();
+    }
+    QDir saveDir(saveDirPath);
+    _fileName = saveDir.absoluteFilePath(QStringLiteral("%1 vehicle%2.%3")
+                                         .arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyy-MM-dd hh-mm-ss")))
+                                         .arg(_vehicle->id())
+                                         .arg(fileExtension));
+
+    _file.setFileName(_fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(TrackRecorderLog) << "Unable to open track file" << _fileName << _file.errorString();
+        return;
+    }
+
+    _buffer.append(_magic, _magicLength);
+    _buffer.append(_version);
+    _flushTimer.start();
+}
+
+void TrackRecorder::stop(void)
+{
+    disconnect(_vehicle, &Vehicle::coordinateChanged, this, &TrackRecorder::_vehicleCoordinateChanged);
+
+    if (_file.isOpen()) {
+        _flushTimer.stop();
+        _flush();
+        _file.close();
+    }
+}
+
+void TrackRecorder::_vehicleCoordinateChanged(QGeoCoordinate coordinate)
+{
+    if (!coordinate.isValid()) {
+        return;
+    }
+
+    if (_file.isOpen()) {
+        const quint64 timestampMsecs    = QGC::utcTimeUsecs() / 1000;
+        const qint64 latitude           = std::llround(coordinate.latitude() * 1e7);
+        const qint64 longitude          = std::llround(coordinate.longitude() * 1e7);
+        // No altitude repeats the previous one
+        const qint64 altitude           = std::isfinite(coordinate.altitude()) ? std::llround(coordinate.altitude() * 1000.0) : _lastAltitude;
+
+        _appendVarint(_buffer, static_cast<qint64>(timestampMsecs - _lastTimestampMsecs));
+        _appendVarint(_buffer, latitude - _lastLatitude);
+        _appendVarint(_buffer, longitude - _lastLongitude);
+        _appendVarint(_buffer, altitude - _lastAltitude);
+
+        _lastTimestampMsecs = timestampMsecs;
+        _lastLatitude       = latitude;
+        _lastLongitude      = longitude;
+        _lastAltitude       = altitude;
+
+        if (_buffer.size() >= _maxBufferBytes) {
+            _flush();
+        }
+    }
+
+    emit coordinateRecorded(coordinate);
+}
+
+/// Appends a zigzag encoded variable length integer, small magnitudes of either sign take few bytes
+void TrackRecorder::_appendVarint(QByteArray& buffer, qint64 value)
+{
+    quint64 zigzag = (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+
+    while (zigzag >= 0x80) {
+        buffer.append(static_cast<char>((zigzag & 0x7F) | 0x80));
+        zigzag >>= 7;
+    }
+    buffer.append(static_cast<char>(zigzag));
+}
+
+void TrackRecorder::_flush(void)
+{
+    if (_buffer.isEmpty() || !_file.isOpen()) {
+        return;
+    }
+
+    if (_file.write(_buffer) != _buffer.size()) {
+        qCWarning(TrackRecorderLog) << "Track file write failed" << _fileName << _file.errorString();
+        _flushTimer.stop();
+        _file.close();
+    } else {
+        (void) _file.flush();
+    }
+    _buffer.clear();
+}
+
+bool TrackRecorder::readSamples(const QString& fileName, const std::function<void(const Sample&)>& sampleCallback, QString& errorString)
+{
+    errorString.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorString = file.errorString();
+        return false;
+    }
+
+    // Mapping keeps long recordings out of the heap, the file is only read in where it can't be mapped
+    QByteArray readBytes;
+    qint64 size = file.size();
+    const char* bytes = (size > 0) ? reinterpret_cast<const char*>(file.map(0, size)) : nullptr;
+    if (!bytes) {
+        readBytes = file.readAll();
+        bytes = readBytes.constData();
+        size = readBytes.size();
+    }
+
+    if ((size < _magicLength + 1) || (memcmp(bytes, _magic, _magicLength) != 0)) {
+        errorString = tr("Not a track file");
+        return false;
+    }
+    if (bytes[_magicLength] != _version) {
+        errorString = tr("Unsupported track file version %1").arg(static_cast<int>(bytes[_magicLength]));
+        return false;
+    }
+
+    qint64 pos = _magicLength + 1;
+    const auto readVarint = [bytes, size, &pos](qint64& value) -> bool {
+        quint64 zigzag = 0;
+        for (int shift = 0; (shift < 64) && (pos < size); shift += 7) {
+            const quint8 byte = static_cast<quint8>(bytes[pos++]);
+            zigzag |= static_cast<quint64>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                value = static_cast<qint64>(zigzag >> 1) ^ -static_cast<qint64>(zigzag & 1);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    quint64 timestampMsecs = 0;
+    qint64 latitude = 0;
+    qint64 longitude = 0;
+    qint64 altitude = 0;
+    while (pos < size) {
+        qint64 deltas[4];
+        for (qint64& delta : deltas) {
+            if (!readVarint(delta)) {
+                if (pos < size) {
+                    errorString = tr("Malformed value at offset %1").arg(pos);
+                    return false;
+                }
+                // A partial record at the end is left by a recording which didn't stop cleanly, everything before it is good
+                qCWarning(TrackRecorderLog) << "Truncated record at end of track file" << fileName;
+                return true;
+            }
+        }
+
+        timestampMsecs  += static_cast<quint64>(deltas[0]);
+        latitude        += deltas[1];
+        longitude       += deltas[2];
+        altitude        += deltas[3];
+
+        sampleCallback({ timestampMsecs, QGeoCoordinate(latitude / 1e7, longitude / 1e7, altitude / 1000.0) });
+    }
+
+    return true;
+}
+
+bool TrackRecorder::loadSamples(const QString& fileName, QList<Sample>& samples, QString& errorString)
+{
+    samples.clear();
+
+    return readSamples(fileName, [&samples](const Sample& sample) { samples.append(sample); }, errorString);
+}
+
+bool TrackRecorder::writeKmlTrack(KMLStreamWriter& kml, QString& errorString)
+{
+    _flush();
+
+    if (_fileName.isEmpty()) {
+        errorString = tr("No track recorded");
+        return false;
+    }
+
+    // The Placemark is started with the first sample, so nothing is written for a file which can't be read
+    bool placemarkStarted = false;
+    const bool result = readSamples(_fileName, [&kml, &placemarkStarted](const Sample& sample) {
+        if (placemarkStarted) {
+            kml.writeCharacters(QStringLiteral(" "));
+        } else {
+            kml.writeStartPlacemark(tr("Flight track"), true);
+            kml.writeStartElement("LineString");
+            kml.writeTextElement("extrude", "0");
+            kml.writeTextElement("altitudeMode", "absolute");
+            kml.writeStartElement("coordinates");
+            placemarkStarted = true;
+        }
+        kml.writeCharacters(KMLStreamWriter::kmlCoordString(sample.coordinate));
+    }, errorString);
+
+    if (placemarkStarted) {
+        kml.writeEndElement();
+        kml.writeEndElement();
+        kml.writeEndElement();
+    }
+
+    return result;
+}
+
+bool TrackRecorder::exportToKml(const QString& kmlFileName)
+{
+    QFile file(kmlFileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qgcApp()->showAppMessage(tr("KML save error %1 : %2").arg(kmlFileName).arg(file.errorString()));
+        return false;
+    }
+
+    KMLStreamWriter kml(&file, QFileInfo(_fileName).completeBaseName());
+
+    QString errorString;
+    if (!writeKmlTrack(kml, errorString)) {
+        qgcApp()->showAppMessage(tr("Track export error %1 : %2").arg(_fileName).arg(errorString));
+        (void) file.remove();
+        return false;
+    }
+
+    kml.finish();
+    if (kml.hasError()) {
+        qgcApp()->showAppMessage(tr("KML save error %1 : %2").arg(kmlFileName).arg(file.errorString()));
+        return false;
+    }
+
+    return true;
+}
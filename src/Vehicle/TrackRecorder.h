@@ -0,0 +1,100 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtPositioning/QGeoCoordinate>
+
+#include <functional>
+
+Q_DECLARE_LOGGING_CATEGORY(TrackRecorderLog)
+
+class Vehicle;
+class KMLStreamWriter;
+
+/// Records every vehicle position at full resolution into a compact append-only binary file. Unlike the display
+/// trajectory nothing is dropped or merged, so the flown path can be reconstructed exactly afterwards.
+///
+/// File format: an 8 byte magic and a version byte followed by one record per sample. A record holds the deltas to
+/// the previous sample for time (msecs), latitude and longitude (1e-7 degrees) and altitude (millimeters), each
+/// zigzag encoded as a variable length integer. A typical sample takes 4-8 bytes.
+class TrackRecorder : public QObject
+{
+    Q_OBJECT
+
+    friend class TrackRecorderTest;
+
+public:
+    TrackRecorder(Vehicle* vehicle, QObject* parent = nullptr);
+    ~TrackRecorder();
+
+    struct Sample {
+        quint64         timestampMsecs; ///< UTC
+        QGeoCoordinate  coordinate;
+    };
+
+    /// Starts recording to a new file in the telemetry save directory
+    void start  (void);
+    void stop   (void);
+
+    bool    recording   (void) const { return _file.isOpen(); }
+    QString fileName    (void) const { return _fileName; }   ///< File of the current or last recording
+
+    /// Exports the current or last recording as a KML track
+    Q_INVOKABLE bool exportToKml(const QString& kmlFileName);
+
+    /// Writes the current or last recording as a track Placemark, the samples are streamed from the file
+    ///     @return false: no recording or the file could not be read (errorString set)
+    bool writeKmlTrack(KMLStreamWriter& kml, QString& errorString);
+
+    /// Calls sampleCallback for each sample of a track file in order, without holding the samples in memory. A partial
+    /// record at the end of the file, left by a recording which didn't stop cleanly, is skipped and is not an error.
+    ///     @return false: file could not be read, is not a track file or holds a malformed value
+    static bool readSamples(const QString& fileName, const std::function<void(const Sample&)>& sampleCallback, QString& errorString);
+
+    /// Reads all samples of a track file, see readSamples
+    ///     @return false: file could not be read, is not a track file or holds a malformed value, samples holds what
+    ///                    was read up to that point
+    static bool loadSamples(const QString& fileName, QList<Sample>& samples, QString& errorString);
+
+    static constexpr const char* fileExtension = "qgctrack";
+
+signals:
+    /// Signalled for each recorded position
+    void coordinateRecorded(QGeoCoordinate coordinate);
+
+private slots:
+    void _vehicleCoordinateChanged  (QGeoCoordinate coordinate);
+    void _flush                     (void);
+
+private:
+    static void _appendVarint(QByteArray& buffer, qint64 value);
+
+    Vehicle*    _vehicle;
+    QFile       _file;
+    QString     _fileName;
+    QByteArray  _buffer;
+    QTimer      _flushTimer;
+    quint64     _lastTimestampMsecs = 0;
+    qint64      _lastLatitude       = 0;
+    qint64      _lastLongitude      = 0;
+    qint64      _lastAltitude       = 0;
+
+    static constexpr char   _magic[]            = "QGCTRACK";
+    static constexpr int    _magicLength        = 8;
+    static constexpr char   _version            = 1;
+    static constexpr int    _flushIntervalMsecs = 1000;
+    static constexpr int    _maxBufferBytes     = 16 * 1024;
+};
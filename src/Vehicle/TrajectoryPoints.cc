@@ -9,11 +9,16 @@
 
 #include "TrajectoryPoints.h"
 #include "Vehicle.h"
+#include "TrackRecorder.h"
+
+#include <QtCore/QtMath>
+
+#include <cmath>
 
 TrajectoryPoints::TrajectoryPoints(Vehicle* vehicle, QObject* parent)
-    : QObject       (parent)
-    , _vehicle      (vehicle)
-    , _lastAzimuth  (qQNaN())
+    : QAbstractListModel(parent)
+    , _vehicle          (vehicle)
+    , _lastAzimuth      (qQNaN())
 {
 }
 
@@ -23,48 +28,274 @@ void TrajectoryPoints::_vehicleCoordinateChanged(QGeoCoordinate coordinate)
     // Fewer points means higher performance of map display.
 
     if (_lastPoint.isValid()) {
-        double distance = _lastPoint.distanceTo(coordinate);
+        // Distances and azimuths are computed in a flat frame around a recent position, which is only moved when the
+        // vehicle gets far from it. This keeps trigonometry out of the per sample work.
+        if (!_localFrame.inRange(coordinate)) {
+            _localFrame.setAnchor(coordinate);
+            _localFrame.toLocal(_lastPoint, _lastNorth, _lastEast);
+        }
+        double north, east;
+        _localFrame.toLocal(coordinate, north, east);
+
+        double distance = QGCGeo::LocalFrame::distance(_lastNorth, _lastEast, north, east);
         if (distance > _distanceTolerance) {
             //-- Update flight distance
             _vehicle->updateFlightDistance(distance);
             // Vehicle has moved far enough from previous point for an update
-            double newAzimuth = _lastPoint.azimuthTo(coordinate);
+            double newAzimuth = QGCGeo::LocalFrame::azimuth(_lastNorth, _lastEast, north, east);
             if (qIsNaN(_lastAzimuth) || qAbs(newAzimuth - _lastAzimuth) > _azimuthTolerance) {
                 // The new position IS NOT colinear with the last segment. Append the new position to the list.
-                _lastAzimuth = _lastPoint.azimuthTo(coordinate);
-                _lastPoint = coordinate;
-                _points.append(QVariant::fromValue(coordinate));
-                emit pointAdded(coordinate);
+                _lastAzimuth = newAzimuth;
+                _setLastPoint(coordinate, north, east);
+                _appendPoint(coordinate);
             } else {
                 // The new position IS colinear with the last segment. Don't add a new point, just update
                 // the last point to be the new position.
-                _lastPoint = coordinate;
-                _points[_points.count() - 1] = QVariant::fromValue(coordinate);
+                _setLastPoint(coordinate, north, east);
+                _tail.last() = { coordinate.latitude(), coordinate.longitude(), static_cast<float>(coordinate.altitude()) };
                 emit updateLastPoint(coordinate);
             }
         }
     } else {
         // Add the very first trajectory point to the list
-        _lastPoint = coordinate;
-        _points.append(QVariant::fromValue(coordinate));
-        emit pointAdded(coordinate);
+        _localFrame.setAnchor(coordinate);
+        _setLastPoint(coordinate, 0, 0);
+        _appendPoint(coordinate);
+    }
+}
+
+void TrajectoryPoints::_setLastPoint(const QGeoCoordinate& coordinate, double north, double east)
+{
+    _lastPoint = coordinate;
+    _lastNorth = north;
+    _lastEast = east;
+}
+
+void TrajectoryPoints::_appendPoint(const QGeoCoordinate& coordinate)
+{
+    // The last tail point can no longer change once a new point is added, so this is the time to complete a full tail
+    if (_tail.count() >= _chunkSize) {
+        _completeTailChunk();
+    }
+
+    if (_tail.isEmpty()) {
+        _tail.reserve(_chunkSize);
+    }
+    _tail.append({ coordinate.latitude(), coordinate.longitude(), static_cast<float>(coordinate.altitude()) });
+    emit pointAdded(coordinate);
+}
+
+void TrajectoryPoints::_completeTailChunk(void)
+{
+    if (_chunks.count() >= _maxChunks) {
+        beginRemoveRows(QModelIndex(), 0, 0);
+        _chunks.removeFirst();
+        endRemoveRows();
+    }
+
+    Chunk chunk;
+    for (int lodLevel = 0; lodLevel < _lodLevelCount; lodLevel++) {
+        chunk.lodPoints[lodLevel] = _simplify(lodLevel == 0 ? _tail : chunk.lodPoints[lodLevel - 1], _lodTolerance(lodLevel));
+    }
+    chunk.points = _tail;
+
+    beginInsertRows(QModelIndex(), _chunks.count(), _chunks.count());
+    _chunks.append(chunk);
+    endInsertRows();
+
+    // The new tail starts where the completed chunk ends so the path stays connected
+    const Point lastPoint = _tail.last();
+    _tail.clear();
+    _tail.append(lastPoint);
+    emit tailChanged();
+}
+
+QVariantList TrajectoryPoints::tail(void) const
+{
+    QVariantList points;
+
+    points.reserve(_tail.count());
+    for (const Point& point : _tail) {
+        points.append(QVariant::fromValue(_toCoordinate(point)));
+    }
+
+    return points;
+}
+
+QList<const QList<TrajectoryPoints::Point>*> TrajectoryPoints::paths(int lodLevel) const
+{
+    QList<const QList<Point>*> paths;
+
+    paths.reserve(_chunks.count() + 1);
+    for (const Chunk& chunk : _chunks) {
+        paths.append(((lodLevel < 0) || (lodLevel >= _lodLevelCount)) ? &chunk.points : &chunk.lodPoints[lodLevel]);
+    }
+    paths.append(&_tail);
+
+    return paths;
+}
+
+QVariantList TrajectoryPoints::list(void) const
+{
+    QVariantList points;
+
+    for (const Chunk& chunk : _chunks) {
+        // Skip the last point of each chunk, it is repeated as the first point of the next chunk
+        for (int i = 0; i < chunk.points.count() - 1; i++) {
+            points.append(QVariant::fromValue(_toCoordinate(chunk.points[i])));
+        }
+    }
+    points.append(tail());
+
+    return points;
+}
+
+void TrajectoryPoints::setMapZoomLevel(double mapZoomLevel)
+{
+    if (qFuzzyCompare(mapZoomLevel, _mapZoomLevel)) {
+        return;
+    }
+
+    _mapZoomLevel = mapZoomLevel;
+    emit mapZoomLevelChanged(_mapZoomLevel);
+
+    const int lodLevel = _lodLevelForZoom(_mapZoomLevel);
+    if (lodLevel != _lodLevel) {
+        _lodLevel = lodLevel;
+        if (!_chunks.isEmpty()) {
+            emit dataChanged(index(0), index(_chunks.count() - 1), { PathRole });
+        }
+    }
+}
+
+/// @return Coarsest level of detail whose tolerance is still below the size of a pixel at the specified zoom level
+int TrajectoryPoints::_lodLevelForZoom(double zoomLevel) const
+{
+    const double latitude = _lastPoint.isValid() ? _lastPoint.latitude() : 0;
+    const double metersPerPixel = 156543.03392 * qCos(qDegreesToRadians(latitude)) / std::pow(2.0, zoomLevel);
+
+    int lodLevel = -1;
+    while ((lodLevel + 1 < _lodLevelCount) && (_lodTolerance(lodLevel + 1) <= metersPerPixel)) {
+        lodLevel++;
+    }
+
+    return lodLevel;
+}
+
+double TrajectoryPoints::_lodTolerance(int lodLevel)
+{
+    // Each level quadruples the tolerance: 8, 32, 128, 512, 2048 meters
+    return _distanceTolerance * std::pow(4.0, lodLevel + 1);
+}
+
+/// Douglas-Peucker simplification using a local flat earth projection, which is accurate enough at chunk scale
+QList<TrajectoryPoints::Point> TrajectoryPoints::_simplify(const QList<Point>& points, double toleranceMeters)
+{
+    if (points.count() < 3) {
+        return points;
+    }
+
+    static constexpr double earthRadius = 6371000.0;
+    const double metersPerDegreeLat = qDegreesToRadians(earthRadius);
+    const double metersPerDegreeLon = metersPerDegreeLat * qCos(qDegreesToRadians(points.first().latitude));
+    const auto x = [&](int i) { return (points[i].longitude - points.first().longitude) * metersPerDegreeLon; };
+    const auto y = [&](int i) { return (points[i].latitude - points.first().latitude) * metersPerDegreeLat; };
+
+    QList<bool> keep(points.count(), false);
+    keep.first() = true;
+    keep.last() = true;
+
+    QList<std::pair<int, int>> segments;
+    segments.append({ 0, static_cast<int>(points.count()) - 1 });
+    while (!segments.isEmpty()) {
+        const auto [first, last] = segments.takeLast();
+
+        const double segmentX = x(last) - x(first);
+        const double segmentY = y(last) - y(first);
+        const double segmentLengthSquared = (segmentX * segmentX) + (segmentY * segmentY);
+
+        double maxDistance = 0;
+        int maxIndex = -1;
+        for (int i = first + 1; i < last; i++) {
+            const double pointX = x(i) - x(first);
+            const double pointY = y(i) - y(first);
+            double distance;
+            if (segmentLengthSquared > 0) {
+                const double t = qBound(0.0, ((pointX * segmentX) + (pointY * segmentY)) / segmentLengthSquared, 1.0);
+                distance = std::hypot(pointX - (t * segmentX), pointY - (t * segmentY));
+            } else {
+                distance = std::hypot(pointX, pointY);
+            }
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                maxIndex = i;
+            }
+        }
+
+        if (maxDistance > toleranceMeters) {
+            keep[maxIndex] = true;
+            segments.append({ first, maxIndex });
+            segments.append({ maxIndex, last });
+        }
+    }
+
+    QList<Point> simplified;
+    for (int i = 0; i < points.count(); i++) {
+        if (keep[i]) {
+            simplified.append(points[i]);
+        }
     }
+
+    return simplified;
+}
+
+int TrajectoryPoints::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return _chunks.count();
+}
+
+QVariant TrajectoryPoints::data(const QModelIndex& index, int role) const
+{
+    if ((role != PathRole) || (index.row() < 0) || (index.row() >= _chunks.count())) {
+        return QVariant();
+    }
+
+    const Chunk& chunk = _chunks[index.row()];
+    const QList<Point>& points = (_lodLevel < 0) ? chunk.points : chunk.lodPoints[_lodLevel];
+
+    QVariantList path;
+    path.reserve(points.count());
+    for (const Point& point : points) {
+        path.append(QVariant::fromValue(_toCoordinate(point)));
+    }
+
+    return path;
+}
+
+QHash<int, QByteArray> TrajectoryPoints::roleNames(void) const
+{
+    return { { PathRole, "path" } };
 }
 
 void TrajectoryPoints::start(void)
 {
     clear();
-    connect(_vehicle, &Vehicle::coordinateChanged, this, &TrajectoryPoints::_vehicleCoordinateChanged);
+    connect(_vehicle->trackRecorder(), &TrackRecorder::coordinateRecorded, this, &TrajectoryPoints::_vehicleCoordinateChanged);
 }
 
 void TrajectoryPoints::stop(void)
 {
-    disconnect(_vehicle, &Vehicle::coordinateChanged, this, &TrajectoryPoints::_vehicleCoordinateChanged);
+    disconnect(_vehicle->trackRecorder(), &TrackRecorder::coordinateRecorded, this, &TrajectoryPoints::_vehicleCoordinateChanged);
 }
 
 void TrajectoryPoints::clear(void)
 {
-    _points.clear();
+    beginResetModel();
+    _chunks.clear();
+    endResetModel();
+
+    _tail.clear();
     _lastPoint = QGeoCoordinate();
     _lastAzimuth = qQNaN();
     emit pointsCleared();
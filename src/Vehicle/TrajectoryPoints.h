@@ -9,41 +9,110 @@
 
 #pragma once
 
+#include "QGCGeo.h"
+
 #include <QtPositioning/QGeoCoordinate>
-#include <QtCore/QObject>
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QList>
 #include <QtCore/QVariantList>
 
+#include <array>
+
 class Vehicle;
 
-class TrajectoryPoints : public QObject
+/// Vehicle trajectory history for display on the map. Points are stored as plain structs in fixed size chunks which
+/// are kept in a ring: once the maximum number of chunks is reached the oldest chunk is dropped, so memory use is
+/// bounded no matter how long the flight is.
+///
+/// Completed chunks are exposed as a model with one row per chunk, each row providing the chunk's path at the level
+/// of detail selected by mapZoomLevel. The levels are computed once using Douglas-Peucker simplification when a chunk
+/// is completed. The chunk which is still being filled is exposed separately through tail() and the
+/// pointAdded/updateLastPoint signals so the map can append to it incrementally.
+class TrajectoryPoints : public QAbstractListModel
 {
     Q_OBJECT
 
 public:
     TrajectoryPoints(Vehicle* vehicle, QObject* parent = nullptr);
 
-    Q_INVOKABLE QVariantList list(void) const { return _points; }
+    Q_PROPERTY(double mapZoomLevel READ mapZoomLevel WRITE setMapZoomLevel NOTIFY mapZoomLevelChanged)
+
+    /// @return Points of the chunk which is currently being filled
+    Q_INVOKABLE QVariantList tail(void) const;
+
+    /// @return All retained points at full resolution
+    Q_INVOKABLE QVariantList list(void) const;
+
+    struct Point {
+        double latitude;
+        double longitude;
+        float  altitude;
+    };
+
+    /// @return Polylines of all retained points: the completed chunks at level of detail lodLevel, then the tail. The
+    /// lists are owned by this object and only valid until the next point is added.
+    QList<const QList<Point>*> paths(int lodLevel) const;
+
+    /// @return Level of detail for paths which is not visibly different from full resolution at zoomLevel, -1 for full
+    int lodLevelForZoom(double zoomLevel) const { return _lodLevelForZoom(zoomLevel); }
+
+    double  mapZoomLevel    (void) const { return _mapZoomLevel; }
+    void    setMapZoomLevel (double mapZoomLevel);
 
     void start  (void);
     void stop   (void);
 
+    // Overrides from QAbstractListModel
+    int                     rowCount    (const QModelIndex& parent = QModelIndex()) const override;
+    QVariant                data        (const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray>  roleNames   (void) const override;
+
 public slots:
     void clear  (void);
 
 signals:
-    void pointAdded     (QGeoCoordinate coordinate);
-    void updateLastPoint(QGeoCoordinate coordinate);
-    void pointsCleared  (void);
+    void pointAdded         (QGeoCoordinate coordinate);
+    void updateLastPoint    (QGeoCoordinate coordinate);
+    void pointsCleared      (void);
+    void tailChanged        (void);     ///< The tail was restarted after a chunk was completed, reload it with tail()
+    void mapZoomLevelChanged(double mapZoomLevel);
 
 private slots:
     void _vehicleCoordinateChanged(QGeoCoordinate coordinate);
 
 private:
+    static constexpr int _lodLevelCount = 5;
+
+    struct Chunk {
+        QList<Point>                            points;
+        std::array<QList<Point>, _lodLevelCount> lodPoints;     ///< Simplified points, index 0 is the least simplified
+    };
+
+    void            _appendPoint        (const QGeoCoordinate& coordinate);
+    void            _setLastPoint       (const QGeoCoordinate& coordinate, double north, double east);
+    void            _completeTailChunk  (void);
+    int             _lodLevelForZoom    (double zoomLevel) const;
+    static double   _lodTolerance       (int lodLevel);
+    static QList<Point> _simplify       (const QList<Point>& points, double toleranceMeters);
+    static QGeoCoordinate _toCoordinate (const Point& point) { return QGeoCoordinate(point.latitude, point.longitude, point.altitude); }
+
+    enum Roles {
+        PathRole = Qt::UserRole + 1,
+    };
+
     Vehicle*        _vehicle;
-    QVariantList    _points;
+    QList<Chunk>    _chunks;            ///< Completed chunks, oldest first
+    QList<Point>    _tail;              ///< Chunk being filled
     QGeoCoordinate  _lastPoint;
+    double          _lastNorth      = 0;    ///< _lastPoint in _localFrame
+    double          _lastEast       = 0;
     double          _lastAzimuth;
+    QGCGeo::LocalFrame _localFrame;
+    double          _mapZoomLevel   = 0;
+    int             _lodLevel       = -1;  ///< -1: full resolution
 
-    static constexpr double _distanceTolerance = 2.0;
-    static constexpr double _azimuthTolerance = 1.5;
+    static constexpr double _distanceTolerance  = 2.0;
+    static constexpr double _azimuthTolerance   = 1.5;
+    static constexpr int    _chunkSize          = 4096;
+    static constexpr int    _maxChunks          = 64;   ///< ~260k points retained, the oldest chunk is dropped after that
 };
@@ -35,14 +35,18 @@
 #include "QGCCameraManager.h"
 #include "QGCCorePlugin.h"
 #include "QGCImageProvider.h"
+#include "QGCLoggingCategory.h"
 #include "QGCQGeoCoordinate.h"
+#include "QGCTrace.h"
 #include "RallyPointManager.h"
 #include "RemoteIDManager.h"
 #include "SettingsManager.h"
 #include "StandardModes.h"
+#include "TelemetryArchive.h"
 #include "TerrainProtocolHandler.h"
 #include "TerrainQuery.h"
 #include "TrajectoryPoints.h"
+#include "TrackRecorder.h"
 #include "VehicleBatteryFactGroup.h"
 #include "VehicleLinkManager.h"
 #include "VehicleObjectAvoidance.h"
@@ -50,8 +54,13 @@
 #include "VideoSettings.h"
 #include <DeviceInfo.h>
 #include <StatusTextHandler.h>
+#include <StatusTextListModel.h>
 #include <MAVLinkSigning.h>
 #include "GimbalController.h"
+#include "ManualControlSender.h"
+#include "MAVLinkMessageSubscription.h"
+#include "MAVLinkStreamRateController.h"
+#include "MAVLinkStreamSubscriptions.h"
 
 #ifdef QGC_UTM_ADAPTER
 #include "UTMSPVehicle.h"
@@ -93,24 +102,16 @@ Vehicle::Vehicle(LinkInterface*             link,
     , _defaultHoverSpeed            (_settingsManager->appSettings()->offlineEditingHoverSpeed()->rawValue().toDouble())
     , _firmwarePluginManager        (firmwarePluginManager)
     , _joystickManager              (joystickManager)
+    , _trackRecorder                (new TrackRecorder(this, this))
     , _trajectoryPoints             (new TrajectoryPoints(this, this))
     , _mavlinkStreamConfig          (std::bind(&Vehicle::_setMessageInterval, this, std::placeholders::_1, std::placeholders::_2))
     , _vehicleFactGroup             (this)
     , _gpsFactGroup                 (this)
-    , _gps2FactGroup                (this)
-    , _windFactGroup                (this)
     , _vibrationFactGroup           (this)
-    , _temperatureFactGroup         (this)
     , _clockFactGroup               (this)
     , _setpointFactGroup            (this)
-    , _distanceSensorFactGroup      (this)
     , _localPositionFactGroup       (this)
     , _localPositionSetpointFactGroup(this)
-    , _escStatusFactGroup           (this)
-    , _estimatorStatusFactGroup     (this)
-    , _hygrometerFactGroup          (this)
-    , _generatorFactGroup           (this)
-    , _efiFactGroup                 (this)
     , _terrainFactGroup             (this)
     , _terrainProtocolHandler       (new TerrainProtocolHandler(this, &_terrainFactGroup, this))
 {
@@ -122,7 +123,7 @@ Vehicle::Vehicle(LinkInterface*             link,
     _mavlink = _toolbox->mavlinkProtocol();
     qCDebug(VehicleLog) << "Link started with Mavlink " << (_mavlink->getCurrentVersion() >= 200 ? "V2" : "V1");
 
-    connect(_mavlink, &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
+    // Incoming messages are routed to us by MultiVehicleManager
     connect(_mavlink, &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
 
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
@@ -164,9 +165,8 @@ Vehicle::Vehicle(LinkInterface*             link,
     _prearmErrorTimer.setSingleShot(true);
 
     // Send MAV_CMD ack timer
-    _mavCommandResponseCheckTimer.setSingleShot(false);
-    _mavCommandResponseCheckTimer.setInterval(_mavCommandResponseCheckTimeoutMSecs);
-    _mavCommandResponseCheckTimer.start();
+    _mavCommandClock.start();
+    _mavCommandResponseCheckTimer.setSingleShot(true);
     connect(&_mavCommandResponseCheckTimer, &QTimer::timeout, this, &Vehicle::_sendMavCommandResponseTimeoutCheck);
 
     // MAV_TYPE_GENERIC is used by unit test for creating a vehicle which doesn't do the connect sequence. This
@@ -193,6 +193,8 @@ Vehicle::Vehicle(LinkInterface*             link,
     connect(&_csvLogTimer, &QTimer::timeout, this, &Vehicle::_writeCsvLine);
     _csvLogTimer.start(1000);
 
+    _telemetryArchive = new TelemetryArchive(this, this);
+
     // Start timer to limit altitude above terrain queries
     _altitudeAboveTerrQueryTimer.restart();
 }
@@ -217,15 +219,13 @@ Vehicle::Vehicle(MAV_AUTOPILOT              firmwareType,
     , _capabilityBitsKnown              (true)
     , _capabilityBits                   (MAV_PROTOCOL_CAPABILITY_MISSION_FENCE | MAV_PROTOCOL_CAPABILITY_MISSION_RALLY)
     , _firmwarePluginManager            (firmwarePluginManager)
+    , _trackRecorder                    (new TrackRecorder(this, this))
     , _trajectoryPoints                 (new TrajectoryPoints(this, this))
     , _mavlinkStreamConfig              (std::bind(&Vehicle::_setMessageInterval, this, std::placeholders::_1, std::placeholders::_2))
     , _vehicleFactGroup                 (this)
     , _gpsFactGroup                     (this)
-    , _gps2FactGroup                    (this)
-    , _windFactGroup                    (this)
     , _vibrationFactGroup               (this)
     , _clockFactGroup                   (this)
-    , _distanceSensorFactGroup          (this)
     , _localPositionFactGroup           (this)
     , _localPositionSetpointFactGroup   (this)
 {
@@ -263,6 +263,7 @@ void Vehicle::stopTrackingFirmwareVehicleTypeChanges(void)
 void Vehicle::_commonInit()
 {
     _firmwarePlugin = _firmwarePluginManager->firmwarePluginForAutopilot(_firmwareType, _vehicleType);
+    _buildPluginMessageFilters();
 
     connect(_firmwarePlugin, &FirmwarePlugin::toolIndicatorsChanged, this, &Vehicle::toolIndicatorsChanged);
     connect(_firmwarePlugin, &FirmwarePlugin::modeIndicatorsChanged, this, &Vehicle::modeIndicatorsChanged);
@@ -271,6 +272,12 @@ void Vehicle::_commonInit()
     connect(this, &Vehicle::coordinateChanged,      this, &Vehicle::_updateDistanceToGCS);
     connect(this, &Vehicle::homePositionChanged,    this, &Vehicle::_updateDistanceHeadingToHome);
     connect(this, &Vehicle::hobbsMeterChanged,      this, &Vehicle::_updateHobbsMeter);
+
+    for (int& pwmValue: _rcChannels.pwmValues) {
+        pwmValue = -1;
+    }
+    _rcChannelsSignalTimer.setSingleShot(true);
+    connect(&_rcChannelsSignalTimer, &QTimer::timeout, this, &Vehicle::_emitRCChannels);
     connect(this, &Vehicle::coordinateChanged,      this, &Vehicle::_updateAltAboveTerrain);
     // Initialize alt above terrain to Nan so frontend can display it correctly in case the terrain query had no response
     _altitudeAboveTerrFact.setRawValue(qQNaN());
@@ -296,6 +303,19 @@ void Vehicle::_commonInit()
 
     _vehicleLinkManager             = new VehicleLinkManager            (this);
 
+    // MANUAL_CONTROL goes out from its own thread so GUI stalls don't add control latency
+    _manualControlSender = new ManualControlSender(this);
+    _streamRateController = new MAVLinkStreamRateController(this);
+    _streamSubscriptions = new MAVLinkStreamSubscriptions(this);
+    connect(_vehicleLinkManager, &VehicleLinkManager::primaryLinkChanged, this, [this]() {
+        _manualControlSender->setLink(_vehicleLinkManager->primaryLink());
+    });
+    connect(_manualControlSender, &ManualControlSender::jitterChanged, this, [this](double jitterMSecs) {
+        _manualControlJitter = jitterMSecs;
+        emit manualControlJitterChanged();
+    });
+    _manualControlSender->start(QThread::TimeCriticalPriority);
+
     connect(_standardModes, &StandardModes::modesUpdated, this, &Vehicle::flightModesChanged);
     connect(_standardModes, &StandardModes::modesUpdated, this, [this](){ Vehicle::flightModeChanged(flightMode()); });
 
@@ -327,23 +347,18 @@ void Vehicle::_commonInit()
 
     _createImageProtocolManager();
     _createStatusTextHandler();
+    _buildManagerMessageTable();
+
+    // Fact groups can be added at any time (batteries, gimbals), the message table is rebuilt on next use
+    connect(this, &FactGroup::factGroupNamesChanged, this, [this]() { _factGroupMessageTableDirty = true; });
 
     // _addFactGroup(_vehicleFactGroup,            _vehicleFactGroupName);
     _addFactGroup(&_gpsFactGroup,               _gpsFactGroupName);
-    _addFactGroup(&_gps2FactGroup,              _gps2FactGroupName);
-    _addFactGroup(&_windFactGroup,              _windFactGroupName);
     _addFactGroup(&_vibrationFactGroup,         _vibrationFactGroupName);
-    _addFactGroup(&_temperatureFactGroup,       _temperatureFactGroupName);
     _addFactGroup(&_clockFactGroup,             _clockFactGroupName);
     _addFactGroup(&_setpointFactGroup,          _setpointFactGroupName);
-    _addFactGroup(&_distanceSensorFactGroup,    _distanceSensorFactGroupName);
     _addFactGroup(&_localPositionFactGroup,     _localPositionFactGroupName);
     _addFactGroup(&_localPositionSetpointFactGroup,_localPositionSetpointFactGroupName);
-    _addFactGroup(&_escStatusFactGroup,         _escStatusFactGroupName);
-    _addFactGroup(&_estimatorStatusFactGroup,   _estimatorStatusFactGroupName);
-    _addFactGroup(&_hygrometerFactGroup,        _hygrometerFactGroupName);
-    _addFactGroup(&_generatorFactGroup,         _generatorFactGroupName);
-    _addFactGroup(&_efiFactGroup,               _efiFactGroupName);
     _addFactGroup(&_terrainFactGroup,           _terrainFactGroupName);
 
     // Add firmware-specific fact groups, if provided
@@ -378,6 +393,9 @@ Vehicle::~Vehicle()
 {
     qCDebug(VehicleLog) << "~Vehicle" << this;
 
+    delete _manualControlSender;
+    _manualControlSender = nullptr;
+
     delete _missionManager;
     _missionManager = nullptr;
 
@@ -428,6 +446,7 @@ void Vehicle::_offlineFirmwareTypeSettingChanged(QVariant varFirmwareType)
 {
     _firmwareType = static_cast<MAV_AUTOPILOT>(varFirmwareType.toInt());
     _firmwarePlugin = _firmwarePluginManager->firmwarePluginForAutopilot(_firmwareType, _vehicleType);
+    _buildPluginMessageFilters();
     if (_firmwareType == MAV_AUTOPILOT_ARDUPILOTMEGA) {
         _capabilityBits |= MAV_PROTOCOL_CAPABILITY_TERRAIN;
     } else {
@@ -471,6 +490,8 @@ void Vehicle::resetCounters()
 
 void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
+    QGC_TRACE_SCOPE("Vehicle::_mavlinkMessageReceived");
+
     // If the link is already running at Mavlink V2 set our max proto version to it.
     unsigned mavlinkVersion = _mavlink->getCurrentVersion();
     if (_maxProtoVersion != mavlinkVersion && mavlinkVersion >= 200) {
@@ -488,6 +509,19 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     // We give the link manager first whack since it it reponsible for adding new links
     _vehicleLinkManager->mavlinkMessageReceived(link, message);
 
+    // The link manager still sees the copies from every link so it can track each link's heartbeat
+    if (_vehicleLinkManager->isDuplicateMessage(link, message)) {
+        return;
+    }
+
+    if (_streamRateController && (message.compid == _defaultComponentId)) {
+        _streamRateController->messageReceived(message);
+    }
+
+    if (_telemetryArchive) {
+        _telemetryArchive->messageReceived(message);
+    }
+
     //-- Check link status
     _messagesReceived++;
     emit messagesReceivedChanged();
@@ -509,37 +543,49 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
             }
             _messageSeq = message.seq + 1;
             _messagesLost += packet_lost_count;
-            if(packet_lost_count)
+            if(packet_lost_count) {
+                qCDebugRateLimited(VehicleLog, 1) << "Lost" << packet_lost_count << "messages, total" << _messagesLost;
                 emit messagesLostChanged();
+            }
         }
     }
 
     // Give the plugin a change to adjust the message contents
-    if (!_firmwarePlugin->adjustIncomingMavlinkMessage(this, &message)) {
+    if (_firmwarePluginMessageFilter.contains(message.msgid) && !_firmwarePlugin->adjustIncomingMavlinkMessage(this, &message)) {
         return;
     }
 
-    // Give the Core Plugin access to all mavlink traffic
-    if (!_toolbox->corePlugin()->mavlinkMessage(this, link, message)) {
+    // Asynchronous subscribers only get a copy queued, they never hold up the vehicle
+    MAVLinkMessageSubscription::dispatch(message);
+
+    // Give the Core Plugin access to the mavlink traffic it asked for
+    if (_corePluginMessageFilter.contains(message.msgid) && !_toolbox->corePlugin()->mavlinkMessage(this, link, message)) {
         return;
     }
 
     if (!_terrainProtocolHandler->mavlinkMessageReceived(message)) {
         return;
     }
-    _ftpManager->_mavlinkMessageReceived(message);
-    _parameterManager->mavlinkMessageReceived(message);
-    (void) QMetaObject::invokeMethod(_imageProtocolManager, "mavlinkMessageReceived", Qt::AutoConnection, message);
-    _remoteIDManager->mavlinkMessageReceived(message);
+    for (const ManagerMessageHandler& handler : _managerMessageTable.handlers(message.msgid)) {
+        handler(message);
+    }
 
     _waitForMavlinkMessageMessageReceivedHandler(message);
 
     // Battery fact groups are created dynamically as new batteries are discovered
     VehicleBatteryFactGroup::handleMessageForFactGroupCreation(this, message);
+    _createFactGroupsForMessage(message);
 
     // Let the fact groups take a whack at the mavlink traffic
-    for (FactGroup* factGroup : factGroups()) {
-        factGroup->handleMessage(this, message);
+    if (_factGroupMessageTableDirty) {
+        _rebuildFactGroupMessageTable();
+    }
+    {
+        QGC_TRACE_SCOPE("FactGroup::handleMessage");
+        for (FactGroup* factGroup : _factGroupMessageTable.handlers(message.msgid)) {
+            factGroup->countHandledMessage();
+            factGroup->handleMessage(this, message);
+        }
     }
 
     this->handleMessage(this, message);
@@ -552,7 +598,7 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         _handleHeartbeat(message);
         break;
     case MAVLINK_MSG_ID_RADIO_STATUS:
-        _handleRadioStatus(message);
+        _handleRadioStatus(link, message);
         break;
     case MAVLINK_MSG_ID_RC_CHANNELS:
         _handleRCChannels(message);
@@ -1082,8 +1128,9 @@ void Vehicle::_handleBatteryStatus(mavlink_message_t& message)
         } else {
             batteryIdStr = batteryIdStr.arg("");
         }
-        _say(tr("warning"));
-        _say(QStringLiteral("%1 %2 ").arg(_vehicleIdSpeech()).arg(batteryMessage.arg(batteryIdStr)));
+        _say(tr("warning"), AudioOutputQueue::Priority::High);
+        _say(QStringLiteral("%1 %2 ").arg(_vehicleIdSpeech()).arg(batteryMessage.arg(batteryIdStr)), AudioOutputQueue::Priority::High,
+             QStringLiteral("battery%1").arg(batteryStatus.id));
     }
 }
 
@@ -1115,6 +1162,7 @@ void Vehicle::_updateArmed(bool armed)
         emit armedChanged(_armed);
         // We are transitioning to the armed state, begin tracking trajectory points for the map
         if (_armed) {
+            _trackRecorder->start();
             _trajectoryPoints->start();
             _flightTimerStart();
             _clearCameraTriggerPoints();
@@ -1122,6 +1170,7 @@ void Vehicle::_updateArmed(bool armed)
             _lowestBatteryChargeStateAnnouncedMap.clear();
         } else {
             _trajectoryPoints->stop();
+            _trackRecorder->stop();
             _flightTimerStop();
             // Also handle Video Streaming
             if(_settingsManager->videoSettings()->disableWhenDisarmed()->rawValue().toBool()) {
@@ -1251,14 +1300,14 @@ EventHandler& Vehicle::_eventHandler(uint8_t compid)
             }
         };
 
-        QString profile = "dev"; // TODO: should be configurable
-
-        QSharedPointer<EventHandler> eventHandler{new EventHandler(this, profile,
+        QSharedPointer<EventHandler> eventHandler{new EventHandler(this,
                 std::bind(&Vehicle::_handleEvent, this, compid, std::placeholders::_1),
                 sendRequestEventMessageCB,
                 _mavlink->getSystemId(), _mavlink->getComponentId(), _id, compid)};
         eventData = _events.insert(compid, eventHandler);
 
+        connect(eventHandler.data(), &EventHandler::metadataLoaded, this, [compid, this]() { _eventsMetadataLoaded(compid); });
+
         // connect health and arming check updates
         connect(eventHandler.data(), &EventHandler::healthAndArmingChecksUpdated, this, [compid, this]() {
             const QSharedPointer<EventHandler>& eventHandler = _events[compid];
@@ -1276,10 +1325,13 @@ EventHandler& Vehicle::_eventHandler(uint8_t compid)
     return *eventData->data();
 }
 
-void Vehicle::setEventsMetadata(uint8_t compid, const QString& metadataJsonFileName)
+void Vehicle::setEventsMetadata(uint8_t compid, const QSharedPointer<const EventsMetadata>& metadata)
 {
-    _eventHandler(compid).setMetadata(metadataJsonFileName);
+    _eventHandler(compid).setMetadata(metadata);
+}
 
+void Vehicle::_eventsMetadataLoaded(uint8_t compid)
+{
     // get the mode group for some well-known flight modes
     int modeGroups[2]{-1, -1};
     const QString modes[2]{"Takeoff", "Mission"};
@@ -1302,12 +1354,12 @@ void Vehicle::setEventsMetadata(uint8_t compid, const QString& metadataJsonFileN
 }
 
 void Vehicle::setActuatorsMetadata([[maybe_unused]] uint8_t compid,
-                                   const QString &metadataJsonFileName)
+                                   const QJsonDocument &metadata)
 {
     if (!_actuators) {
         _actuators = new Actuators(this, this);
     }
-    _actuators->load(metadataJsonFileName);
+    _actuators->load(metadata);
 }
 
 void Vehicle::_handleHeartbeat(mavlink_message_t& message)
@@ -1364,13 +1416,19 @@ void Vehicle::_handleCurrentMode(mavlink_message_t& message)
     }
 }
 
-void Vehicle::_handleRadioStatus(mavlink_message_t& message)
+void Vehicle::_handleRadioStatus(LinkInterface* link, mavlink_message_t& message)
 {
 
     //-- Process telemetry status message
     mavlink_radio_status_t rstatus;
     mavlink_msg_radio_status_decode(&message, &rstatus);
 
+    // Lets the link slow down before the radio's transmit buffer overflows
+    link->setRemoteTransmitBuffer(rstatus.txbuf);
+    if (_streamRateController) {
+        _streamRateController->radioStatusReceived(rstatus.txbuf);
+    }
+
     int rssi    = rstatus.rssi;
     int remrssi = rstatus.remrssi;
     int lnoise = (int)(int8_t)rstatus.noise;
@@ -1430,40 +1488,71 @@ void Vehicle::_handleRCChannels(mavlink_message_t& message)
 
     mavlink_msg_rc_channels_decode(&message, &channels);
 
-    uint16_t* _rgChannelvalues[QGCMAVLink::maxRcChannels] = {
-        &channels.chan1_raw,
-        &channels.chan2_raw,
-        &channels.chan3_raw,
-        &channels.chan4_raw,
-        &channels.chan5_raw,
-        &channels.chan6_raw,
-        &channels.chan7_raw,
-        &channels.chan8_raw,
-        &channels.chan9_raw,
-        &channels.chan10_raw,
-        &channels.chan11_raw,
-        &channels.chan12_raw,
-        &channels.chan13_raw,
-        &channels.chan14_raw,
-        &channels.chan15_raw,
-        &channels.chan16_raw,
-        &channels.chan17_raw,
-        &channels.chan18_raw,
+    const uint16_t rgChannelValues[QGCMAVLink::maxRcChannels] = {
+        channels.chan1_raw,
+        channels.chan2_raw,
+        channels.chan3_raw,
+        channels.chan4_raw,
+        channels.chan5_raw,
+        channels.chan6_raw,
+        channels.chan7_raw,
+        channels.chan8_raw,
+        channels.chan9_raw,
+        channels.chan10_raw,
+        channels.chan11_raw,
+        channels.chan12_raw,
+        channels.chan13_raw,
+        channels.chan14_raw,
+        channels.chan15_raw,
+        channels.chan16_raw,
+        channels.chan17_raw,
+        channels.chan18_raw,
     };
-    int pwmValues[QGCMAVLink::maxRcChannels];
 
+    // Changes accumulate in the mask until the next signal, so none is lost while the signal is held back
     for (int i=0; i<QGCMAVLink::maxRcChannels; i++) {
-        uint16_t channelValue = *_rgChannelvalues[i];
+        const int pwmValue = ((i < channels.chancount) && (rgChannelValues[i] != UINT16_MAX)) ? rgChannelValues[i] : -1;
+        if (_rcChannels.pwmValues[i] != pwmValue) {
+            _rcChannels.pwmValues[i] = pwmValue;
+            _rcChannels.changedMask |= 1u << i;
+        }
+    }
+    const int channelCount = qMin(static_cast<int>(channels.chancount), static_cast<int>(QGCMAVLink::maxRcChannels));
+    const bool channelCountChanged = _rcChannels.channelCount != channelCount;
+    _rcChannels.channelCount = channelCount;
+
+    // Now and then every channel is passed on, so consumers created since a channel last changed get its value too
+    if (!_rcChannelsRefreshClock.isValid() || (_rcChannelsRefreshClock.elapsed() >= _rcChannelsRefreshMsecs)) {
+        _rcChannelsRefreshClock.start();
+        _rcChannels.changedMask = (1u << QGCMAVLink::maxRcChannels) - 1;
+    }
+
+    emit remoteControlRSSIChanged(channels.rssi);
 
-        if (i < channels.chancount) {
-            pwmValues[i] = channelValue == UINT16_MAX ? -1 : channelValue;
+    if (_rcChannelsFullRateCount > 0) {
+        _emitRCChannels();
+    } else if (((_rcChannels.changedMask != 0) || channelCountChanged) && !_rcChannelsSignalTimer.isActive()) {
+        const qint64 elapsedMsecs = _rcChannelsSignalClock.isValid() ? _rcChannelsSignalClock.elapsed() : _rcChannelsSignalIntervalMsecs;
+        if (elapsedMsecs >= _rcChannelsSignalIntervalMsecs) {
+            _emitRCChannels();
         } else {
-            pwmValues[i] = -1;
+            _rcChannelsSignalTimer.start(static_cast<int>(_rcChannelsSignalIntervalMsecs - elapsedMsecs));
         }
     }
+}
 
-    emit remoteControlRSSIChanged(channels.rssi);
-    emit rcChannelsChanged(channels.chancount, pwmValues);
+void Vehicle::_emitRCChannels()
+{
+    _rcChannelsSignalTimer.stop();
+    _rcChannelsSignalClock.start();
+
+    emit rcChannelsChanged(_rcChannels);
+    _rcChannels.changedMask = 0;
+}
+
+void Vehicle::setRCChannelsFullRate(bool fullRate)
+{
+    _rcChannelsFullRateCount = qMax(0, _rcChannelsFullRateCount + (fullRate ? 1 : -1));
 }
 
 bool Vehicle::sendMessageOnLinkThreadSafe(LinkInterface* link, mavlink_message_t message)
@@ -1480,7 +1569,13 @@ bool Vehicle::sendMessageOnLinkThreadSafe(LinkInterface* link, mavlink_message_t
     uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
     int len = mavlink_msg_to_send_buffer(buffer, &message);
 
-    link->writeBytesThreadSafe((const char*)buffer, len);
+    const LinkInterface::WritePriority priority = LinkInterface::messageWritePriority(message.msgid);
+    link->writeBytesThreadSafe((const char*)buffer, len, priority);
+    for (const SharedLinkInterfacePtr& redundantLink: _vehicleLinkManager->redundantSendLinks(link, message.msgid)) {
+        if (redundantLink->isConnected()) {
+            redundantLink->writeBytesThreadSafe((const char*)buffer, len, priority);
+        }
+    }
     _messagesSent++;
     emit messagesSentChanged();
 
@@ -1816,13 +1911,13 @@ void Vehicle::_gotProgressUpdate(float progressValue)
 void Vehicle::_firstMissionLoadComplete()
 {
     disconnect(_missionManager, &MissionManager::newMissionItemsAvailable, this, &Vehicle::_firstMissionLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->missionLoadComplete();
 }
 
 void Vehicle::_firstGeoFenceLoadComplete()
 {
     disconnect(_geoFenceManager, &GeoFenceManager::loadComplete, this, &Vehicle::_firstGeoFenceLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->geoFenceLoadComplete();
 }
 
 void Vehicle::_firstRallyPointLoadComplete()
@@ -1830,7 +1925,7 @@ void Vehicle::_firstRallyPointLoadComplete()
     disconnect(_rallyPointManager, &RallyPointManager::loadComplete, this, &Vehicle::_firstRallyPointLoadComplete);
     _initialPlanRequestComplete = true;
     emit initialPlanRequestCompleteChanged(true);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->rallyPointsLoadComplete();
 }
 
 void Vehicle::_parametersReady(bool parametersReady)
@@ -1844,7 +1939,7 @@ void Vehicle::_parametersReady(bool parametersReady)
     if (parametersReady) {
         disconnect(_parameterManager, &ParameterManager::parametersReadyChanged, this, &Vehicle::_parametersReady);
         _setupAutoDisarmSignalling();
-        _initialConnectStateMachine->advance();
+        _initialConnectStateMachine->parametersLoadComplete();
     }
 
     _multirotor_speed_limits_available = _firmwarePlugin->mulirotorSpeedLimitsAvailable(this);
@@ -1917,9 +2012,11 @@ void Vehicle::virtualTabletJoystickValue(double roll, double pitch, double yaw,
     }
 }
 
-void Vehicle::_say(const QString& text)
+void Vehicle::_say(const QString& text, AudioOutputQueue::Priority priority, const QString& collapseKey)
 {
-    AudioOutput::instance()->say(text.toLower());
+    // Only the latest pending announcement of a kind is read for each vehicle
+    const QString vehicleCollapseKey = collapseKey.isEmpty() ? QString() : QStringLiteral("%1:%2").arg(_id).arg(collapseKey);
+    AudioOutput::instance()->say(text.toLower(), AudioOutput::TextMod::None, priority, vehicleCollapseKey);
 }
 
 bool Vehicle::airship() const
@@ -2004,13 +2101,13 @@ QString Vehicle::_vehicleIdSpeech()
 
 void Vehicle::_handleFlightModeChanged(const QString& flightMode)
 {
-    _say(tr("%1 %2 flight mode").arg(_vehicleIdSpeech()).arg(flightMode));
+    _say(tr("%1 %2 flight mode").arg(_vehicleIdSpeech()).arg(flightMode), AudioOutputQueue::Priority::Normal, QStringLiteral("flightMode"));
     emit guidedModeChanged(_firmwarePlugin->isGuidedMode(this));
 }
 
 void Vehicle::_announceArmedChanged(bool armed)
 {
-    _say(QString("%1 %2").arg(_vehicleIdSpeech()).arg(armed ? tr("armed") : tr("disarmed")));
+    _say(QString("%1 %2").arg(_vehicleIdSpeech()).arg(armed ? tr("armed") : tr("disarmed")), AudioOutputQueue::Priority::Normal, QStringLiteral("armed"));
     if(armed) {
         //-- Keep track of armed coordinates
         _armedPosition = _coordinate;
@@ -2442,21 +2539,42 @@ void Vehicle::sendMavCommandIntWithHandler(const MavCmdAckHandlerInfo_t* ackHand
 
 bool Vehicle::isMavCommandPending(int targetCompId, MAV_CMD command)
 {
-    bool pending = ((-1) < _findMavCommandListEntryIndex(targetCompId, command));
-    // qDebug() << "Pending target: " << targetCompId << ", command: " << (int)command << ", pending: " << (pending ? "yes" : "no");
-    return pending;
+    return _mavCommandMap.contains(_mavCommandKey(targetCompId, command));
 }
 
-int Vehicle::_findMavCommandListEntryIndex(int targetCompId, MAV_CMD command)
+Vehicle::MavCommandListEntry_t Vehicle::_takeMavCommand(quint64 key, int index)
 {
-    for (int i=0; i<_mavCommandList.count(); i++) {
-        const MavCommandListEntry_t& entry = _mavCommandList[i];
-        if (entry.targetCompId == targetCompId && entry.command == command) {
-            return i;
-        }
+    auto it = _mavCommandMap.find(key);
+    MavCommandListEntry_t entry = it->takeAt(index);
+    if (it->isEmpty()) {
+        _mavCommandMap.erase(it);
+    }
+    if (_mavCommandMap.isEmpty()) {
+        // Nothing left to time out, drop the stale deadlines so the vehicle is not checked while idle
+        _mavCommandDeadlines.clear();
+        _mavCommandResponseCheckTimer.stop();
+    }
+    return entry;
+}
+
+void Vehicle::_scheduleMavCommandDeadline(quint64 key, qint64 deadlineMSecs)
+{
+    (void) _mavCommandDeadlines.insert(deadlineMSecs, key);
+    _armMavCommandResponseCheckTimer();
+}
+
+void Vehicle::_armMavCommandResponseCheckTimer(void)
+{
+    if (_mavCommandDeadlines.isEmpty()) {
+        _mavCommandResponseCheckTimer.stop();
+        return;
     }
 
-    return -1;
+    const qint64 msecsToDeadline = _mavCommandDeadlines.firstKey() - _mavCommandClock.elapsed();
+    const int interval = static_cast<int>(qMax(static_cast<qint64>(0), msecsToDeadline));
+    if (!_mavCommandResponseCheckTimer.isActive() || (_mavCommandResponseCheckTimer.remainingTime() > interval)) {
+        _mavCommandResponseCheckTimer.start(interval);
+    }
 }
 
 bool Vehicle::_sendMavCommandShouldRetry(MAV_CMD command)
@@ -2564,23 +2682,27 @@ void Vehicle::_sendMavCommandWorker(
     entry.rgParam7          = param7;
     entry.maxTries          = _sendMavCommandShouldRetry(command) ? _mavCommandMaxRetryCount : 1;
     entry.ackTimeoutMSecs   = sharedLink->linkConfiguration()->isHighLatency() ? _mavCommandAckTimeoutMSecsHighLatency : _mavCommandAckTimeoutMSecs;
-    entry.elapsedTimer.start();
+    entry.deadlineMSecs     = _mavCommandClock.elapsed() + entry.ackTimeoutMSecs;
 
     qCDebug(VehicleLog) << Q_FUNC_INFO << "command:param1-7" << command << param1 << param2 << param3 << param4 << param5 << param6 << param7;
 
-    _mavCommandList.append(entry);
-    _sendMavCommandFromList(_mavCommandList.count() - 1);
+    const quint64 key = _mavCommandKey(targetCompId, command);
+    QList<MavCommandListEntry_t>& entries = _mavCommandMap[key];
+    entries.append(entry);
+    const int index = entries.count() - 1;
+    _scheduleMavCommandDeadline(key, entry.deadlineMSecs);
+    _sendMavCommandFromList(key, index);
 }
 
-void Vehicle::_sendMavCommandFromList(int index)
+void Vehicle::_sendMavCommandFromList(quint64 key, int index)
 {
-    MavCommandListEntry_t commandEntry = _mavCommandList[index];
+    MavCommandListEntry_t commandEntry = _mavCommandMap[key][index];
 
     QString rawCommandName  = _toolbox->missionCommandTree()->rawName(commandEntry.command);
 
-    if (++_mavCommandList[index].tryCount > commandEntry.maxTries) {
+    if (++_mavCommandMap[key][index].tryCount > commandEntry.maxTries) {
         qCDebug(VehicleLog) << Q_FUNC_INFO << "giving up after max retries" << rawCommandName;
-        _mavCommandList.removeAt(index);
+        (void) _takeMavCommand(key, index);
         if (commandEntry.ackHandlerInfo.resultHandler) {
             mavlink_command_ack_t ack = {};
             ack.result = MAV_RESULT_FAILED;
@@ -2657,18 +2779,36 @@ void Vehicle::_sendMavCommandFromList(int index)
 
 void Vehicle::_sendMavCommandResponseTimeoutCheck(void)
 {
-    if (_mavCommandList.isEmpty()) {
-        return;
+    const qint64 now = _mavCommandClock.elapsed();
+
+    // Only the commands whose deadline came due are looked at
+    QList<quint64> dueKeys;
+    while (!_mavCommandDeadlines.isEmpty() && (_mavCommandDeadlines.firstKey() <= now)) {
+        auto it = _mavCommandDeadlines.begin();
+        if (!dueKeys.contains(it.value())) {
+            dueKeys.append(it.value());
+        }
+        (void) _mavCommandDeadlines.erase(it);
     }
 
-    // Walk the list backwards since _sendMavCommandFromList can remove entries
-    for (int i=_mavCommandList.count()-1; i>=0; i--) {
-        MavCommandListEntry_t& commandEntry = _mavCommandList[i];
-        if (commandEntry.elapsedTimer.elapsed() > commandEntry.ackTimeoutMSecs) {
-            // Try sending command again
-            _sendMavCommandFromList(i);
+    for (const quint64 key : dueKeys) {
+        // Walk the entries backwards since _sendMavCommandFromList can remove entries
+        for (int i = _mavCommandMap.value(key).count() - 1; i >= 0; i--) {
+            auto it = _mavCommandMap.find(key);
+            if ((it == _mavCommandMap.end()) || (i >= it->count())) {
+                continue;
+            }
+            MavCommandListEntry_t& commandEntry = (*it)[i];
+            if (commandEntry.deadlineMSecs <= now) {
+                // Try sending command again, further tries follow at the check interval until the vehicle responds
+                commandEntry.deadlineMSecs = now + _mavCommandResponseCheckTimeoutMSecs;
+                (void) _mavCommandDeadlines.insert(commandEntry.deadlineMSecs, key);
+                _sendMavCommandFromList(key, i);
+            }
         }
     }
+
+    _armMavCommandResponseCheckTimer();
 }
 
 void Vehicle::_handleCommandAck(mavlink_message_t& message)
@@ -2704,26 +2844,29 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
     }
 #endif
 
-    int entryIndex = _findMavCommandListEntryIndex(message.compid, static_cast<MAV_CMD>(ack.command));
-    if (entryIndex != -1) {
+    const quint64 key = _mavCommandKey(message.compid, static_cast<MAV_CMD>(ack.command));
+    if (_mavCommandMap.contains(key)) {
+        // Acks for a duplicated command are matched to the oldest send
+        const int entryIndex = 0;
         if (ack.result == MAV_RESULT_IN_PROGRESS) {
             MavCommandListEntry_t commandEntry;
             if (px4Firmware() && ack.command == MAV_CMD_DO_AUTOTUNE_ENABLE) {
                 // HacK to support PX4 autotune which does not send final result ack and just sends in progress
-                commandEntry = _mavCommandList.takeAt(entryIndex);
+                commandEntry = _takeMavCommand(key, entryIndex);
             } else {
                 // Command has not completed yet, don't remove
-                MavCommandListEntry_t& commandEntryRef = _mavCommandList[entryIndex];
+                MavCommandListEntry_t& commandEntryRef = _mavCommandMap[key][entryIndex];
                 commandEntryRef.maxTries = 1;         // Vehicle responsed to command so don't retry
-                commandEntryRef.elapsedTimer.start(); // We've heard from vehicle, restart elapsed timer for no ack received timeout
+                commandEntryRef.deadlineMSecs = _mavCommandClock.elapsed() + commandEntryRef.ackTimeoutMSecs; // We've heard from vehicle, restart no ack received timeout
                 commandEntry = commandEntryRef;
+                _scheduleMavCommandDeadline(key, commandEntry.deadlineMSecs);
             }
 
             if (commandEntry.ackHandlerInfo.progressHandler) {
                 (*commandEntry.ackHandlerInfo.progressHandler)(commandEntry.ackHandlerInfo.progressHandlerData, message.compid, ack);
             }
         } else {
-            MavCommandListEntry_t commandEntry = _mavCommandList.takeAt(entryIndex);
+            MavCommandListEntry_t commandEntry = _takeMavCommand(key, entryIndex);
 
             if (commandEntry.ackHandlerInfo.resultHandler) {
                 (*commandEntry.ackHandlerInfo.resultHandler)(commandEntry.ackHandlerInfo.resultHandlerData, message.compid, ack, MavCmdResultCommandResultOnly);
@@ -2782,9 +2925,9 @@ void Vehicle::_waitForMavlinkMessageMessageReceivedHandler(const mavlink_message
 
         if (!pInfo->commandAckReceived) {
             qCDebug(VehicleLog) << Q_FUNC_INFO << "message received before ack came back.";
-            int entryIndex = _findMavCommandListEntryIndex(message.compid, MAV_CMD_REQUEST_MESSAGE);
-            if (entryIndex != -1) {
-                _mavCommandList.takeAt(entryIndex);
+            const quint64 key = _mavCommandKey(message.compid, MAV_CMD_REQUEST_MESSAGE);
+            if (_mavCommandMap.contains(key)) {
+                (void) _takeMavCommand(key, 0);
             } else {
                 qWarning() << Q_FUNC_INFO << "Removing request message command from list failed - not found in list";
             }
@@ -2903,6 +3046,34 @@ void Vehicle::setPrearmError(const QString& prearmError)
     }
 }
 
+void Vehicle::setTrafficConflict(const QString& trafficConflict)
+{
+    if (trafficConflict == _trafficConflict) {
+        return;
+    }
+
+    if (_trafficConflict.isEmpty()) {
+        _say(tr("%1 traffic alert").arg(_vehicleIdSpeech()));
+    }
+
+    _trafficConflict = trafficConflict;
+    emit trafficConflictChanged(_trafficConflict);
+}
+
+void Vehicle::setFenceWarning(const QString& fenceWarning)
+{
+    if (fenceWarning == _fenceWarning) {
+        return;
+    }
+
+    if (_fenceWarning.isEmpty()) {
+        _say(tr("%1 geofence warning").arg(_vehicleIdSpeech()));
+    }
+
+    _fenceWarning = fenceWarning;
+    emit fenceWarningChanged(_fenceWarning);
+}
+
 void Vehicle::_prearmErrorTimeout()
 {
     setPrearmError(QString());
@@ -3169,7 +3340,7 @@ void Vehicle::_handleMavlinkLoggingDataAcked(mavlink_message_t& message)
         qWarning() << "Invalid length for LOGGING_DATA_ACKED, discarding." << log.length;
     } else {
         emit mavlinkLogData(this, log.target_system, log.target_component, log.sequence,
-                            log.first_message_offset, QByteArray((const char*)log.data, log.length), false);
+                            log.first_message_offset, QByteArray((const char*)log.data, log.length), true);
     }
 }
 
@@ -3323,7 +3494,13 @@ void Vehicle::_handleADSBVehicle(const mavlink_message_t &message)
             vehicleInfo.availableFlags |= ADSB::HeadingAvailable;
         }
 
-        (void) QMetaObject::invokeMethod(ADSBVehicleManager::instance(), "adsbVehicleUpdate", Qt::AutoConnection, vehicleInfo);
+        if (adsbVehicleMsg.flags & ADSB_FLAGS_VALID_VELOCITY) {
+            vehicleInfo.velocity = adsbVehicleMsg.hor_velocity / 1e2;
+            vehicleInfo.verticalVelocity = adsbVehicleMsg.ver_velocity / 1e2;
+            vehicleInfo.availableFlags |= ADSB::VelocityAvailable;
+        }
+
+        (void) QMetaObject::invokeMethod(ADSBVehicleManager::instance(), "adsbVehicleUpdate", Qt::AutoConnection, vehicleInfo, ADSBVehicleManager::vehicleSourceBase + id());
     }
 }
 
@@ -3453,6 +3630,10 @@ void Vehicle::setPIDTuningTelemetryMode(PIDTuningTelemetryMode mode)
 {
     bool liveUpdate = mode != ModeDisabled;
     setLiveUpdates(liveUpdate);
+    if (_streamRateController) {
+        // The tuning presets own the stream rates while active
+        _streamRateController->setSuspended(liveUpdate);
+    }
     _setpointFactGroup.setLiveUpdates(liveUpdate);
     _localPositionFactGroup.setLiveUpdates(liveUpdate);
     _localPositionSetpointFactGroup.setLiveUpdates(liveUpdate);
@@ -3511,7 +3692,8 @@ void Vehicle::_initializeCsv()
     QTextStream stream(&_csvLogFile);
     QStringList allFactNames;
     allFactNames << factNames();
-    for (const QString& groupName: factGroupNames()) {
+    _csvLogFactGroupNames = factGroupNames();
+    for (const QString& groupName: _csvLogFactGroupNames) {
         for(const QString& factName: getFactGroup(groupName)->factNames()){
             allFactNames << QString("%1.%2").arg(groupName, factName);
         }
@@ -3542,7 +3724,7 @@ void Vehicle::_writeCsvLine()
         allFactValues << getFact(factName)->cookedValueString();
     }
     // write facts from Vehicle's FactGroups
-    for (const QString& groupName: factGroupNames()) {
+    for (const QString& groupName: _csvLogFactGroupNames) {
         for (const QString& factName : getFactGroup(groupName)->factNames()) {
             allFactValues << getFactGroup(groupName)->getFact(factName)->cookedValueString();
         }
@@ -3711,7 +3893,7 @@ void Vehicle::_handleFenceStatus(const mavlink_message_t& message)
                     break;
             }
 
-            _say(breachTypeStr + " " + tr("fence breached"));
+            _say(breachTypeStr + " " + tr("fence breached"), AudioOutputQueue::Priority::High);
         }
     } else {
         lastUpdate = now;
@@ -3785,41 +3967,16 @@ void Vehicle::clearAllParamMapRC(void)
 
 void Vehicle::sendJoystickDataThreadSafe(float roll, float pitch, float yaw, float thrust, quint16 buttons)
 {
-    SharedLinkInterfacePtr sharedLink = vehicleLinkManager()->primaryLink().lock();
-    if (!sharedLink) {
-        qCDebug(VehicleLog)<< "sendJoystickDataThreadSafe: primary link gone!";
-        return;
+    if (_manualControlSender) {
+        _manualControlSender->setSample(roll, pitch, yaw, thrust, buttons);
     }
+}
 
-    if (sharedLink->linkConfiguration()->isHighLatency()) {
-        return;
+void Vehicle::setManualControlRateHz(float rateHz)
+{
+    if (_manualControlSender) {
+        _manualControlSender->setRateHz(rateHz);
     }
-
-    mavlink_message_t message;
-
-    // Incoming values are in the range -1:1
-    float axesScaling =         1.0 * 1000.0;
-    float newRollCommand =      roll * axesScaling;
-    float newPitchCommand  =    pitch * axesScaling;    // Joystick data is reverse of mavlink values
-    float newYawCommand    =    yaw * axesScaling;
-    float newThrustCommand =    thrust * axesScaling;
-
-    mavlink_msg_manual_control_pack_chan(
-        static_cast<uint8_t>(_mavlink->getSystemId()),
-        static_cast<uint8_t>(_mavlink->getComponentId()),
-        sharedLink->mavlinkChannel(),
-        &message,
-        static_cast<uint8_t>(_id),
-        static_cast<int16_t>(newPitchCommand),
-        static_cast<int16_t>(newRollCommand),
-        static_cast<int16_t>(newThrustCommand),
-        static_cast<int16_t>(newYawCommand),
-        buttons, 0,
-        0,
-        0, 0,
-        0, 0, 0, 0, 0, 0
-    );
-    sendMessageOnLinkThreadSafe(sharedLink.get(), message);
 }
 
 void Vehicle::triggerSimpleCamera()
@@ -3994,6 +4151,7 @@ bool Vehicle::messageTypeWarning() const { return m_statusTextHandler->messageTy
 bool Vehicle::messageTypeError() const { return m_statusTextHandler->messageTypeError(); }
 int Vehicle::messageCount() const { return m_statusTextHandler->messageCount(); }
 QString Vehicle::formattedMessages() const { return m_statusTextHandler->formattedMessages(); }
+StatusTextListModel *Vehicle::statusTextMessages() const { return m_statusTextHandler->messages(); }
 
 void Vehicle::_createStatusTextHandler()
 {
@@ -4044,7 +4202,13 @@ void Vehicle::_textMessageReceived(MAV_COMPONENT componentid, MAV_SEVERITY sever
     }
 
     if (readAloud && !skipSpoken) {
-        _say(text);
+        AudioOutputQueue::Priority priority = AudioOutputQueue::Priority::Low;
+        if (severity <= MAV_SEVERITY::MAV_SEVERITY_CRITICAL) {
+            priority = AudioOutputQueue::Priority::High;
+        } else if (severity <= MAV_SEVERITY::MAV_SEVERITY_NOTICE) {
+            priority = AudioOutputQueue::Priority::Normal;
+        }
+        _say(text, priority);
     }
 
     m_statusTextHandler->handleTextMessage(componentid, severity, text.toHtmlEscaped(), description);
@@ -4094,6 +4258,116 @@ void Vehicle::sendSetupSigning()
 /*                        Image Protocol Manager                             */
 /*===========================================================================*/
 
+void Vehicle::_buildManagerMessageTable()
+{
+    _managerMessageTable.clear();
+    _managerMessageTable.add(FTPManager::_handledMessageIds(), [this](mavlink_message_t& message) {
+        _ftpManager->_mavlinkMessageReceived(message);
+    });
+    _managerMessageTable.add(ParameterManager::handledMessageIds(), [this](mavlink_message_t& message) {
+        _parameterManager->mavlinkMessageReceived(message);
+    });
+    _managerMessageTable.add(ImageProtocolManager::handledMessageIds(), [this](mavlink_message_t& message) {
+        (void) QMetaObject::invokeMethod(_imageProtocolManager, "mavlinkMessageReceived", Qt::AutoConnection, message);
+    });
+    _managerMessageTable.add(RemoteIDManager::handledMessageIds(), [this](mavlink_message_t& message) {
+        _remoteIDManager->mavlinkMessageReceived(message);
+    });
+}
+
+void Vehicle::_buildPluginMessageFilters()
+{
+    _firmwarePluginMessageFilter.clear();
+    _firmwarePluginMessageFilter.add(_firmwarePlugin->adjustedIncomingMessageIds());
+    _corePluginMessageFilter.clear();
+    _corePluginMessageFilter.add(_toolbox->corePlugin()->mavlinkMessageIds());
+}
+
+void Vehicle::_createFactGroupsForMessage(const mavlink_message_t& message)
+{
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_GPS2_RAW:
+        (void) gps2FactGroup();
+        break;
+    case MAVLINK_MSG_ID_WIND_COV:
+#if !defined(NO_ARDUPILOT_DIALECT)
+    case MAVLINK_MSG_ID_WIND:
+#endif
+        (void) windFactGroup();
+        break;
+    case MAVLINK_MSG_ID_SCALED_PRESSURE:
+    case MAVLINK_MSG_ID_SCALED_PRESSURE2:
+    case MAVLINK_MSG_ID_SCALED_PRESSURE3:
+        (void) temperatureFactGroup();
+        break;
+    case MAVLINK_MSG_ID_HIGH_LATENCY:
+    case MAVLINK_MSG_ID_HIGH_LATENCY2:
+        (void) windFactGroup();
+        (void) temperatureFactGroup();
+        break;
+    case MAVLINK_MSG_ID_DISTANCE_SENSOR:
+        (void) distanceSensorFactGroup();
+        break;
+    case MAVLINK_MSG_ID_ESC_STATUS:
+        (void) escStatusFactGroup();
+        break;
+    case MAVLINK_MSG_ID_ESTIMATOR_STATUS:
+        (void) estimatorStatusFactGroup();
+        break;
+    case MAVLINK_MSG_ID_HYGROMETER_SENSOR:
+        (void) hygrometerFactGroup();
+        break;
+    case MAVLINK_MSG_ID_GENERATOR_STATUS:
+        (void) generatorFactGroup();
+        break;
+    case MAVLINK_MSG_ID_EFI_STATUS:
+        (void) efiFactGroup();
+        break;
+    default:
+        break;
+    }
+}
+
+FactGroup* Vehicle::_createFactGroupOnDemand(const QString& name)
+{
+    if (name == _gps2FactGroupName) {
+        return gps2FactGroup();
+    } else if (name == _windFactGroupName) {
+        return windFactGroup();
+    } else if (name == _temperatureFactGroupName) {
+        return temperatureFactGroup();
+    } else if (name == _distanceSensorFactGroupName) {
+        return distanceSensorFactGroup();
+    } else if (name == _escStatusFactGroupName) {
+        return escStatusFactGroup();
+    } else if (name == _estimatorStatusFactGroupName) {
+        return estimatorStatusFactGroup();
+    } else if (name == _hygrometerFactGroupName) {
+        return hygrometerFactGroup();
+    } else if (name == _generatorFactGroupName) {
+        return generatorFactGroup();
+    } else if (name == _efiFactGroupName) {
+        return efiFactGroup();
+    }
+    return nullptr;
+}
+
+void Vehicle::_rebuildFactGroupMessageTable()
+{
+    _factGroupMessageTable.clear();
+
+    for (FactGroup* factGroup : factGroups()) {
+        const QList<uint32_t> msgIds = factGroup->handledMessageIds();
+        if (msgIds.contains(FactGroup::allMessageIds)) {
+            _factGroupMessageTable.addForAllIds(factGroup);
+        } else {
+            _factGroupMessageTable.add(msgIds, factGroup);
+        }
+    }
+
+    _factGroupMessageTableDirty = false;
+}
+
 void Vehicle::_createImageProtocolManager()
 {
     _imageProtocolManager = new ImageProtocolManager(this);
@@ -10,6 +10,8 @@
 #pragma once
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMultiMap>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QTime>
@@ -18,11 +20,13 @@
 #include <QtPositioning/QGeoCoordinate>
 #include <QtCore/QFile>
 
+#include "AudioOutputQueue.h"
 #include "HealthAndArmingCheckReport.h"
 #include "MAVLinkStreamConfig.h"
 #include "QGCMapCircle.h"
 #include "QGCMAVLink.h"
 #include "QmlObjectListModel.h"
+#include "MAVLinkMsgIdTable.h"
 #include "SysStatusSensorInfo.h"
 #include "VehicleLinkManager.h"
 
@@ -46,16 +50,19 @@
 #include "GimbalController.h"
 
 class Actuators;
+class QJsonDocument;
 class AutoPilotPlugin;
 class Autotune;
 class ComponentInformationManager;
 class EventHandler;
+class EventsMetadata;
 class FirmwarePlugin;
 class FirmwarePluginManager;
 class FTPManager;
 class GeoFenceManager;
 class ImageProtocolManager;
 class StatusTextHandler;
+class StatusTextListModel;
 class InitialConnectStateMachine;
 class Joystick;
 class JoystickManager;
@@ -75,10 +82,15 @@ class StandardModes;
 class TerrainAtCoordinateQuery;
 class TerrainProtocolHandler;
 class TrajectoryPoints;
+class TelemetryArchive;
+class TrackRecorder;
 class VehicleBatteryFactGroup;
 class VehicleObjectAvoidance;
 class QGCToolbox;
 class GimbalController;
+class ManualControlSender;
+class MAVLinkStreamRateController;
+class MAVLinkStreamSubscriptions;
 #ifdef QGC_UTM_ADAPTER
 class UTMSPVehicle;
 #endif
@@ -100,13 +112,17 @@ class Vehicle : public VehicleFactGroup
     Q_OBJECT
     Q_MOC_INCLUDE("AutoPilotPlugin.h")
     Q_MOC_INCLUDE("TrajectoryPoints.h")
+    Q_MOC_INCLUDE("TrackRecorder.h")
     Q_MOC_INCLUDE("ParameterManager.h")
     Q_MOC_INCLUDE("VehicleObjectAvoidance.h")
     Q_MOC_INCLUDE("Autotune.h")
     Q_MOC_INCLUDE("RemoteIDManager.h")
     Q_MOC_INCLUDE("QGCCameraManager.h")
+    Q_MOC_INCLUDE("StatusTextListModel.h")
+    Q_MOC_INCLUDE("MAVLinkStreamSubscriptions.h")
 
     friend class InitialConnectStateMachine;
+    friend class MultiVehicleManager;               // Routes incoming messages to _mavlinkMessageReceived
     friend class VehicleLinkManager;
     friend class VehicleBatteryFactGroup;           // Allow VehicleBatteryFactGroup to call _addFactGroup
     friend class SendMavCommandWithSignallingTest;  // Unit test
@@ -154,6 +170,7 @@ public:
     Q_PROPERTY(QStringList          flightModes                 READ flightModes                                                    NOTIFY flightModesChanged)
     Q_PROPERTY(QString              flightMode                  READ flightMode                 WRITE setFlightMode                 NOTIFY flightModeChanged)
     Q_PROPERTY(TrajectoryPoints*    trajectoryPoints            MEMBER _trajectoryPoints                                            CONSTANT)
+    Q_PROPERTY(TrackRecorder*       trackRecorder               READ trackRecorder                                                  CONSTANT)
     Q_PROPERTY(QmlObjectListModel*  cameraTriggerPoints         READ cameraTriggerPoints                                            CONSTANT)
     Q_PROPERTY(float                latitude                    READ latitude                                                       NOTIFY coordinateChanged)
     Q_PROPERTY(float                longitude                   READ longitude                                                      NOTIFY coordinateChanged)
@@ -166,6 +183,7 @@ public:
     Q_PROPERTY(uint                 messagesReceived            READ messagesReceived                                               NOTIFY messagesReceivedChanged)
     Q_PROPERTY(uint                 messagesSent                READ messagesSent                                                   NOTIFY messagesSentChanged)
     Q_PROPERTY(uint                 messagesLost                READ messagesLost                                                   NOTIFY messagesLostChanged)
+    Q_PROPERTY(double               manualControlJitter         READ manualControlJitter                                            NOTIFY manualControlJitterChanged)
     Q_PROPERTY(bool                 airship                     READ airship                                                        NOTIFY vehicleTypeChanged)
     Q_PROPERTY(bool                 fixedWing                   READ fixedWing                                                      NOTIFY vehicleTypeChanged)
     Q_PROPERTY(bool                 multiRotor                  READ multiRotor                                                     NOTIFY vehicleTypeChanged)
@@ -178,6 +196,8 @@ public:
     Q_PROPERTY(bool                 supportsRadio               READ supportsRadio                                                  CONSTANT)
     Q_PROPERTY(bool               supportsMotorInterference     READ supportsMotorInterference                                      CONSTANT)
     Q_PROPERTY(QString              prearmError                 READ prearmError                WRITE setPrearmError                NOTIFY prearmErrorChanged)
+    Q_PROPERTY(QString              trafficConflict             READ trafficConflict                                                NOTIFY trafficConflictChanged)
+    Q_PROPERTY(QString              fenceWarning                READ fenceWarning                                                   NOTIFY fenceWarningChanged)
     Q_PROPERTY(int                  motorCount                  READ motorCount                                                     CONSTANT)
     Q_PROPERTY(bool                 coaxialMotors               READ coaxialMotors                                                  CONSTANT)
     Q_PROPERTY(bool                 xConfigMotors               READ xConfigMotors                                                  CONSTANT)
@@ -255,6 +275,7 @@ public:
     Q_PROPERTY(VehicleObjectAvoidance*  objectAvoidance     READ objectAvoidance    CONSTANT)
     Q_PROPERTY(Autotune*                autotune            READ autotune           CONSTANT)
     Q_PROPERTY(RemoteIDManager*         remoteIDManager     READ remoteIDManager    CONSTANT)
+    Q_PROPERTY(MAVLinkStreamSubscriptions* streamSubscriptions READ streamSubscriptions CONSTANT)   ///< nullptr for offline vehicles
 
     // FactGroup object model properties
 
@@ -449,6 +470,7 @@ public:
     bool joystickEnabled            () const;
     void setJoystickEnabled         (bool enabled);
     void sendJoystickDataThreadSafe (float roll, float pitch, float yaw, float thrust, quint16 buttons);
+    void setManualControlRateHz     (float rateHz);
 
     // Property accesors
     int id() const{ return _id; }
@@ -515,6 +537,16 @@ public:
     QString prearmError() const { return _prearmError; }
     void setPrearmError(const QString& prearmError);
 
+    /// Most urgent ADS-B traffic conflict, empty if there is none
+    QString trafficConflict() const { return _trafficConflict; }
+    /// Announces the conflict when there was none before
+    void setTrafficConflict(const QString& trafficConflict);
+
+    /// Geofence breach, predicted breach or fence proximity, empty if there is none
+    QString fenceWarning() const { return _fenceWarning; }
+    /// Announces the warning when there was none before
+    void setFenceWarning(const QString& fenceWarning);
+
     QmlObjectListModel* cameraTriggerPoints () { return &_cameraTriggerPoints; }
 
     //-- Mavlink Logging
@@ -534,11 +566,16 @@ public:
     float           latitude                    () { return static_cast<float>(_coordinate.latitude()); }
     float           longitude                   () { return static_cast<float>(_coordinate.longitude()); }
     int             rcRSSI                      () const{ return _rcRSSI; }
+    const QGCMAVLink::RCChannels_t& rcChannels () const{ return _rcChannels; }
+
+    /// Requests rcChannelsChanged for every RC_CHANNELS message, for radio calibration. Calls must be balanced.
+    void setRCChannelsFullRate(bool fullRate);
     bool            px4Firmware                 () const { return _firmwareType == MAV_AUTOPILOT_PX4; }
     bool            apmFirmware                 () const { return _firmwareType == MAV_AUTOPILOT_ARDUPILOTMEGA; }
     bool            genericFirmware             () const { return !px4Firmware() && !apmFirmware(); }
     uint            messagesReceived            () const{ return _messagesReceived; }
     uint            messagesSent                () const{ return _messagesSent; }
+    double          manualControlJitter         () const{ return _manualControlJitter; }
     uint            messagesLost                () const{ return _messagesLost; }
     bool            flying                      () const { return _flying; }
     bool            landing                     () const { return _landing; }
@@ -597,21 +634,21 @@ public:
 
     FactGroup* vehicleFactGroup             () { return _vehicleFactGroup; }
     FactGroup* gpsFactGroup                 () { return &_gpsFactGroup; }
-    FactGroup* gps2FactGroup                () { return &_gps2FactGroup; }
-    FactGroup* windFactGroup                () { return &_windFactGroup; }
+    FactGroup* gps2FactGroup                () { return _findOrAddFactGroup(_gps2FactGroup, _gps2FactGroupName); }
+    FactGroup* windFactGroup                () { return _findOrAddFactGroup(_windFactGroup, _windFactGroupName); }
     FactGroup* vibrationFactGroup           () { return &_vibrationFactGroup; }
-    FactGroup* temperatureFactGroup         () { return &_temperatureFactGroup; }
+    FactGroup* temperatureFactGroup         () { return _findOrAddFactGroup(_temperatureFactGroup, _temperatureFactGroupName); }
     FactGroup* clockFactGroup               () { return &_clockFactGroup; }
     FactGroup* setpointFactGroup            () { return &_setpointFactGroup; }
-    FactGroup* distanceSensorFactGroup      () { return &_distanceSensorFactGroup; }
+    FactGroup* distanceSensorFactGroup      () { return _findOrAddFactGroup(_distanceSensorFactGroup, _distanceSensorFactGroupName); }
     FactGroup* localPositionFactGroup       () { return &_localPositionFactGroup; }
     FactGroup* localPositionSetpointFactGroup() { return &_localPositionSetpointFactGroup; }
-    FactGroup* escStatusFactGroup           () { return &_escStatusFactGroup; }
-    FactGroup* estimatorStatusFactGroup     () { return &_estimatorStatusFactGroup; }
+    FactGroup* escStatusFactGroup           () { return _findOrAddFactGroup(_escStatusFactGroup, _escStatusFactGroupName); }
+    FactGroup* estimatorStatusFactGroup     () { return _findOrAddFactGroup(_estimatorStatusFactGroup, _estimatorStatusFactGroupName); }
     FactGroup* terrainFactGroup             () { return &_terrainFactGroup; }
-    FactGroup* hygrometerFactGroup          () { return &_hygrometerFactGroup; }
-    FactGroup* generatorFactGroup           () { return &_generatorFactGroup; }
-    FactGroup* efiFactGroup                 () { return &_efiFactGroup; }
+    FactGroup* hygrometerFactGroup          () { return _findOrAddFactGroup(_hygrometerFactGroup, _hygrometerFactGroupName); }
+    FactGroup* generatorFactGroup           () { return _findOrAddFactGroup(_generatorFactGroup, _generatorFactGroupName); }
+    FactGroup* efiFactGroup                 () { return _findOrAddFactGroup(_efiFactGroup, _efiFactGroupName); }
     QmlObjectListModel* batteries           () { return &_batteryFactGroupListModel; }
 
     MissionManager*                 missionManager      () { return _missionManager; }
@@ -620,6 +657,9 @@ public:
     ParameterManager*               parameterManager    () { return _parameterManager; }
     ParameterManager*               parameterManager    () const { return _parameterManager; }
     VehicleLinkManager*             vehicleLinkManager  () { return _vehicleLinkManager; }
+    MAVLinkStreamRateController*    streamRateController() { return _streamRateController; }   ///< nullptr for offline vehicles
+    MAVLinkStreamSubscriptions*     streamSubscriptions () { return _streamSubscriptions; }    ///< nullptr for offline vehicles
+    TrackRecorder*                  trackRecorder       () { return _trackRecorder; }
     FTPManager*                     ftpManager          () { return _ftpManager; }
     ComponentInformationManager*    compInfoManager     () { return _componentInformationManager; }
     VehicleObjectAvoidance*         objectAvoidance     () { return _objectAvoidance; }
@@ -803,8 +843,8 @@ public:
 
     double loadProgress                 () const { return _loadProgress; }
 
-    void setEventsMetadata(uint8_t compid, const QString& metadataJsonFileName);
-    void setActuatorsMetadata(uint8_t compid, const QString& metadataJsonFileName);
+    void setEventsMetadata(uint8_t compid, const QSharedPointer<const EventsMetadata>& metadata);
+    void setActuatorsMetadata(uint8_t compid, const QJsonDocument& metadata);
 
     HealthAndArmingCheckReport* healthAndArmingCheckReport() { return &_healthAndArmingCheckReport; }
 
@@ -828,6 +868,8 @@ signals:
     void guidedModeChanged              (bool guidedMode);
     void vtolInFwdFlightChanged         (bool vtolInFwdFlight);
     void prearmErrorChanged             (const QString& prearmError);
+    void trafficConflictChanged         (const QString& trafficConflict);
+    void fenceWarningChanged            (const QString& fenceWarning);
     void soloFirmwareChanged            (bool soloFirmware);
     void defaultCruiseSpeedChanged      (double cruiseSpeed);
     void defaultHoverSpeedChanged       (double hoverSpeed);
@@ -872,10 +914,9 @@ signals:
     void vehicleUIDChanged              ();
     void loadProgressChanged            (float value);
 
-    /// New RC channel values coming from RC_CHANNELS message
-    ///     @param channelCount Number of available channels, maxRcChannels max
-    ///     @param pwmValues -1 signals channel not available
-    void rcChannelsChanged              (int channelCount, int pwmValues[QGCMAVLink::maxRcChannels]);
+    /// New RC channel values coming from RC_CHANNELS messages. Only emitted if a value changed and at most every
+    /// _rcChannelsSignalIntervalMsecs, unless full rate updates are requested through setRCChannelsFullRate.
+    void rcChannelsChanged              (const QGCMAVLink::RCChannels_t& channels);
 
     /// Remote control RSSI changed  (0% - 100%)
     void remoteControlRSSIChanged       (uint8_t rssi);
@@ -947,8 +988,9 @@ private:
     void _handleHomePosition            (mavlink_message_t& message);
     void _handleHeartbeat               (mavlink_message_t& message);
     void _handleCurrentMode             (mavlink_message_t& message);
-    void _handleRadioStatus             (mavlink_message_t& message);
+    void _handleRadioStatus             (LinkInterface* link, mavlink_message_t& message);
     void _handleRCChannels              (mavlink_message_t& message);
+    void _emitRCChannels                ();
     void _handleBatteryStatus           (mavlink_message_t& message);
     void _handleSysStatus               (mavlink_message_t& message);
     void _handleExtendedSysState        (mavlink_message_t& message);
@@ -971,7 +1013,7 @@ private:
     void _missionManagerError           (int errorCode, const QString& errorMsg);
     void _geoFenceManagerError          (int errorCode, const QString& errorMsg);
     void _rallyPointManagerError        (int errorCode, const QString& errorMsg);
-    void _say                           (const QString& text);
+    void _say                           (const QString& text, AudioOutputQueue::Priority priority = AudioOutputQueue::Priority::Normal, const QString& collapseKey = QString());
     QString _vehicleIdSpeech            ();
     void _handleMavlinkLoggingData      (mavlink_message_t& message);
     void _handleMavlinkLoggingDataAcked (mavlink_message_t& message);
@@ -987,6 +1029,7 @@ private:
     void _flightTimerStop               ();
     void _setMessageInterval            (int messageId, int rate);
     EventHandler& _eventHandler         (uint8_t compid);
+    void _eventsMetadataLoaded          (uint8_t compid);
     bool setFlightModeCustom            (const QString& flightMode, uint8_t* base_mode, uint32_t* custom_mode);
 
     static void _rebootCommandResultHandler(void* resultHandlerData, int compId, const mavlink_command_ack_t& ack, MavCmdResultFailureCode_t failureCode);
@@ -1007,6 +1050,7 @@ private:
 
     QTimer              _csvLogTimer;
     QFile               _csvLogFile;
+    QStringList         _csvLogFactGroupNames;  ///< Groups in the csv header, groups created later are not logged
 
     bool            _joystickEnabled = false;
     bool _isActiveVehicle = false;
@@ -1020,6 +1064,13 @@ private:
 
     int             _rcRSSI = 255;
     double          _rcRSSIstore = 255;
+    QGCMAVLink::RCChannels_t _rcChannels;
+    int             _rcChannelsFullRateCount = 0;
+    QElapsedTimer   _rcChannelsSignalClock;
+    QTimer          _rcChannelsSignalTimer;             ///< Single shot, emits the latest changes once the interval is over
+    QElapsedTimer   _rcChannelsRefreshClock;
+    static constexpr int _rcChannelsSignalIntervalMsecs = 100;
+    static constexpr int _rcChannelsRefreshMsecs = 1000;
     bool            _flying = false;
     bool            _landing = false;
     bool            _vtolInFwdFlight = false;
@@ -1058,6 +1109,9 @@ private:
     QTimer              _prearmErrorTimer;
     static const int    _prearmErrorTimeoutMSecs = 35 * 1000;   ///< Take away prearm error after 35 seconds
 
+    QString             _trafficConflict;
+    QString             _fenceWarning;
+
     bool                _initialPlanRequestComplete = false;
 
     LinkManager*                    _linkManager                    = nullptr;
@@ -1068,6 +1122,9 @@ private:
     VehicleObjectAvoidance*         _objectAvoidance                = nullptr;
     Autotune*                       _autotune                       = nullptr;
     GimbalController*               _gimbalController               = nullptr;
+    ManualControlSender*            _manualControlSender            = nullptr;
+    MAVLinkStreamRateController*    _streamRateController           = nullptr;
+    MAVLinkStreamSubscriptions*     _streamSubscriptions            = nullptr;
 
 #ifdef QGC_UTM_ADAPTER
     UTMSPVehicle*                    _utmspVehicle                    = nullptr;
@@ -1095,6 +1152,8 @@ private:
 
     QElapsedTimer                   _flightTimer;
     QTimer                          _flightTimeUpdater;
+    TrackRecorder*                  _trackRecorder = nullptr;
+    TelemetryArchive*               _telemetryArchive = nullptr;
     TrajectoryPoints*               _trajectoryPoints = nullptr;
     QmlObjectListModel              _cameraTriggerPoints;
     //QMap<QString, ADSBVehicle*>     _trafficVehicleMap;
@@ -1105,6 +1164,7 @@ private:
 
     uint                _messagesReceived = 0;
     uint                _messagesSent = 0;
+    double              _manualControlJitter = 0;
     uint                _messagesLost = 0;
     uint8_t             _messageSeq = 0;
     uint8_t             _compID = 0;
@@ -1197,12 +1257,16 @@ private:
         MavCmdAckHandlerInfo_t  ackHandlerInfo;
         int                     maxTries            = _mavCommandMaxRetryCount;
         int                     tryCount            = 0;
-        QElapsedTimer           elapsedTimer;
+        qint64                  deadlineMSecs       = 0;    ///< _mavCommandClock time at which the command is retried or given up on
         int                     ackTimeoutMSecs     = _mavCommandAckTimeoutMSecs;
     } MavCommandListEntry_t;
 
-    QList<MavCommandListEntry_t>    _mavCommandList;
-    QTimer                          _mavCommandResponseCheckTimer;
+    // Pending commands keyed by _mavCommandKey. A list only holds more than one entry for commands which can be duplicated.
+    QHash<quint64, QList<MavCommandListEntry_t>> _mavCommandMap;
+    // Command deadlines in time order. Deadlines of commands which completed are left in place and skipped when they come due.
+    QMultiMap<qint64 /* deadlineMSecs */, quint64 /* _mavCommandKey */> _mavCommandDeadlines;
+    QElapsedTimer                   _mavCommandClock;
+    QTimer                          _mavCommandResponseCheckTimer;  ///< Single shot, armed for the earliest deadline while commands are pending
     static const int                _mavCommandMaxRetryCount                = 3;
     static const int                _mavCommandResponseCheckTimeoutMSecs    = 500;
     static const int                _mavCommandAckTimeoutMSecs              = 3000;
@@ -1213,8 +1277,11 @@ private:
             const MavCmdAckHandlerInfo_t* ackHandlerInfo,   ///> nullptr to signale no handlers
             int compId, MAV_CMD command, MAV_FRAME frame, 
             float param1, float param2, float param3, float param4, double param5, double param6, float param7);
-    void _sendMavCommandFromList(int index);
-    int  _findMavCommandListEntryIndex(int targetCompId, MAV_CMD command);
+    void _sendMavCommandFromList(quint64 key, int index);
+    MavCommandListEntry_t _takeMavCommand(quint64 key, int index);
+    void _scheduleMavCommandDeadline(quint64 key, qint64 deadlineMSecs);
+    void _armMavCommandResponseCheckTimer(void);
+    static quint64 _mavCommandKey(int targetCompId, MAV_CMD command) { return (static_cast<quint64>(static_cast<quint32>(targetCompId)) << 32) | static_cast<quint32>(command); }
     bool _sendMavCommandShouldRetry(MAV_CMD command);
     bool _commandCanBeDuplicated(MAV_CMD command);
 
@@ -1251,20 +1318,20 @@ private:
 
     VehicleFactGroup*               _vehicleFactGroup;
     VehicleGPSFactGroup             _gpsFactGroup;
-    VehicleGPS2FactGroup            _gps2FactGroup;
-    VehicleWindFactGroup            _windFactGroup;
+    VehicleGPS2FactGroup*           _gps2FactGroup = nullptr;
+    VehicleWindFactGroup*           _windFactGroup = nullptr;
     VehicleVibrationFactGroup       _vibrationFactGroup;
-    VehicleTemperatureFactGroup     _temperatureFactGroup;
+    VehicleTemperatureFactGroup*    _temperatureFactGroup = nullptr;
     VehicleClockFactGroup           _clockFactGroup;
     VehicleSetpointFactGroup        _setpointFactGroup;
-    VehicleDistanceSensorFactGroup  _distanceSensorFactGroup;
+    VehicleDistanceSensorFactGroup* _distanceSensorFactGroup = nullptr;
     VehicleLocalPositionFactGroup   _localPositionFactGroup;
     VehicleLocalPositionSetpointFactGroup _localPositionSetpointFactGroup;
-    VehicleEscStatusFactGroup       _escStatusFactGroup;
-    VehicleEstimatorStatusFactGroup _estimatorStatusFactGroup;
-    VehicleHygrometerFactGroup      _hygrometerFactGroup;
-    VehicleGeneratorFactGroup       _generatorFactGroup;
-    VehicleEFIFactGroup             _efiFactGroup;
+    VehicleEscStatusFactGroup*      _escStatusFactGroup = nullptr;
+    VehicleEstimatorStatusFactGroup* _estimatorStatusFactGroup = nullptr;
+    VehicleHygrometerFactGroup*     _hygrometerFactGroup = nullptr;
+    VehicleGeneratorFactGroup*      _generatorFactGroup = nullptr;
+    VehicleEFIFactGroup*            _efiFactGroup = nullptr;
     TerrainFactGroup                _terrainFactGroup;
     QmlObjectListModel              _batteryFactGroupListModel;
 
@@ -1321,6 +1388,7 @@ private:
     Q_PROPERTY(bool    messageTypeError   READ messageTypeError   NOTIFY messageTypeChanged)
     Q_PROPERTY(int     messageCount       READ messageCount       NOTIFY messageCountChanged)
     Q_PROPERTY(QString formattedMessages  READ formattedMessages  NOTIFY formattedMessagesChanged)
+    Q_PROPERTY(StatusTextListModel *statusTextMessages READ statusTextMessages CONSTANT)
 
     // Q_PROPERTY(StatusTextHandler *statusTextHandler READ statusTextHandler NOTIFY statusTextHandlerChanged)
 
@@ -1335,6 +1403,7 @@ public:
     bool messageTypeError() const;
     int messageCount() const;
     QString formattedMessages() const;
+    StatusTextListModel *statusTextMessages() const;
 
     // StatusTextHandler* statusTextHandler() { return m_statusTextHandler; }
 
@@ -1343,6 +1412,7 @@ signals:
 
     void messagesReceivedChanged();
     void messagesSentChanged();
+    void manualControlJitterChanged();
     void messagesLostChanged();
     void messageTypeChanged();
     void messageCountChanged();
@@ -1374,6 +1444,33 @@ signals:
 
 private:
     void _createImageProtocolManager();
+    void _buildManagerMessageTable();
+    void _buildPluginMessageFilters();
+    void _rebuildFactGroupMessageTable();
+    void _createFactGroupsForMessage(const mavlink_message_t& message);
+
+    /// The FactGroups of sensors a vehicle may not have are created on first use: when QML or C++ first asks for them
+    /// or when the first message they handle comes in. Until then no memory is spent on them and nothing is decoded.
+    template<typename T>
+    T* _findOrAddFactGroup(T*& factGroup, const QString& name)
+    {
+        if (!factGroup) {
+            factGroup = new T(this);
+            _addFactGroup(factGroup, name);
+        }
+        return factGroup;
+    }
+
+    FactGroup* _createFactGroupOnDemand(const QString& name) override;
+
+    typedef std::function<void(mavlink_message_t& message)> ManagerMessageHandler;
+
+    /// Used to only deliver messages to the sub-managers and FactGroups which consume them
+    MAVLinkMsgIdTable<ManagerMessageHandler>    _managerMessageTable;
+    MAVLinkMsgIdTable<FactGroup*>               _factGroupMessageTable;
+    bool                                        _factGroupMessageTableDirty = true;
+    MAVLinkMsgIdFilter                          _firmwarePluginMessageFilter;   ///< FirmwarePlugin::adjustedIncomingMessageIds
+    MAVLinkMsgIdFilter                          _corePluginMessageFilter;       ///< QGCCorePlugin::mavlinkMessageIds
 
     ImageProtocolManager *_imageProtocolManager = nullptr;
 };
@@ -25,6 +25,8 @@ VehicleLinkManager::VehicleLinkManager(Vehicle* vehicle)
 {
     connect(this,                   &VehicleLinkManager::linkNamesChanged,  this, &VehicleLinkManager::linkStatusesChanged);
     connect(&_commLostCheckTimer,   &QTimer::timeout,                       this, &VehicleLinkManager::_commLostCheck);
+    connect(this,                   &VehicleLinkManager::linkStatusesChanged, this, &VehicleLinkManager::_updateRedundantLinks);
+    connect(this,                   &VehicleLinkManager::primaryLinkChanged,  this, &VehicleLinkManager::_updateRedundantLinks);
 
     _commLostCheckTimer.setSingleShot(false);
     _commLostCheckTimer.setInterval(_commLostCheckTimeoutMSecs);
@@ -73,7 +75,7 @@ void VehicleLinkManager::_commRegainedOnLink(LinkInterface* link)
     }
 
     if (!commRegainedMessage.isEmpty()) {
-        _vehicle->_say(commRegainedMessage);
+        _vehicle->_say(commRegainedMessage, AudioOutputQueue::Priority::High, QStringLiteral("communication"));
     }
     if (!primarySwitchMessage.isEmpty()) {
         _vehicle->_say(primarySwitchMessage);
@@ -146,7 +148,7 @@ void VehicleLinkManager::_commLostCheck(void)
                 closeVehicle();
                 return;
             }
-            _vehicle->_say(tr("%1Communication lost").arg(_vehicle->_vehicleIdSpeech()));
+            _vehicle->_say(tr("%1Communication lost").arg(_vehicle->_vehicleIdSpeech()), AudioOutputQueue::Priority::High, QStringLiteral("communication"));
 
             _communicationLost = true;
             emit communicationLostChanged(true);
@@ -154,6 +156,85 @@ void VehicleLinkManager::_commLostCheck(void)
     }
 }
 
+bool VehicleLinkManager::isDuplicateMessage(LinkInterface* link, const mavlink_message_t& message)
+{
+    if (_rgLinkInfo.count() < 2) {
+        return false;
+    }
+
+    const quint64 key = (static_cast<quint64>(message.sysid) << 56) |
+            (static_cast<quint64>(message.compid) << 48) |
+            (static_cast<quint64>(message.seq) << 40) |
+            (static_cast<quint64>(message.msgid & 0xFFFFFF) << 16) |
+            message.checksum;
+
+    for (const RecentMessage_t& recentMessage: _recentMessages) {
+        // The same link can legitimately repeat a key once the sequence number wraps
+        if ((recentMessage.key == key) && (recentMessage.link != link)) {
+            return true;
+        }
+    }
+
+    if (_recentMessages.count() < _duplicateWindowCount) {
+        _recentMessages.append({ key, link });
+    } else {
+        _recentMessages[_nextRecentMessageIndex] = { key, link };
+        _nextRecentMessageIndex = (_nextRecentMessageIndex + 1) % _duplicateWindowCount;
+    }
+
+    return false;
+}
+
+void VehicleLinkManager::setRedundantSend(bool redundantSend)
+{
+    if (redundantSend != _redundantSend) {
+        _redundantSend = redundantSend;
+        _updateRedundantLinks();
+        emit redundantSendChanged(redundantSend);
+    }
+}
+
+QList<SharedLinkInterfacePtr> VehicleLinkManager::redundantSendLinks(LinkInterface* primaryLink, uint32_t msgid) const
+{
+    QList<SharedLinkInterfacePtr> rgLinks;
+
+    // Only messages the vehicle can safely act on twice are repeated. Commands and transfers stay on a single link.
+    switch (msgid) {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
+        break;
+    default:
+        return rgLinks;
+    }
+
+    QMutexLocker locker(&_redundantLinksMutex);
+    for (const WeakLinkInterfacePtr& weakLink: _redundantLinks) {
+        SharedLinkInterfacePtr link = weakLink.lock();
+        if (link && (link.get() != primaryLink)) {
+            rgLinks.append(link);
+        }
+    }
+
+    return rgLinks;
+}
+
+/// Keeps a copy of the active links for the threads which send messages, empty while redundant sending is off
+void VehicleLinkManager::_updateRedundantLinks(void)
+{
+    QList<WeakLinkInterfacePtr> redundantLinks;
+    if (_redundantSend) {
+        for (const SharedLinkInterfacePtr& link: activeLinks()) {
+            redundantLinks.append(link);
+        }
+    }
+
+    QMutexLocker locker(&_redundantLinksMutex);
+    _redundantLinks = redundantLinks;
+}
+
 int VehicleLinkManager::_containsLinkIndex(LinkInterface* link)
 {
     for (int i=0; i<_rgLinkInfo.count(); i++) {
@@ -381,6 +462,23 @@ QStringList VehicleLinkManager::linkNames(void) const
     return rgNames;
 }
 
+QList<SharedLinkInterfacePtr> VehicleLinkManager::activeLinks(void) const
+{
+    QList<SharedLinkInterfacePtr> rgLinks;
+
+    const SharedLinkInterfacePtr primaryLink = _primaryLink.lock();
+    if (primaryLink) {
+        rgLinks.append(primaryLink);
+    }
+    for (const LinkInfo_t& linkInfo: _rgLinkInfo) {
+        if (!linkInfo.commLost && linkInfo.link != primaryLink) {
+            rgLinks.append(linkInfo.link);
+        }
+    }
+
+    return rgLinks;
+}
+
 QStringList VehicleLinkManager::linkStatuses(void) const
 {
     QStringList rgStatuses;
@@ -12,6 +12,7 @@
 #include "QGCMAVLink.h"
 #include "LinkInterface.h"
 
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtCore/QElapsedTimer>
@@ -39,6 +40,7 @@ public:
     Q_PROPERTY(bool             communicationLost           READ communicationLost                                              NOTIFY communicationLostChanged)
     Q_PROPERTY(bool             communicationLostEnabled    READ communicationLostEnabled   WRITE setCommunicationLostEnabled   NOTIFY communicationLostEnabledChanged)
     Q_PROPERTY(bool             autoDisconnect              MEMBER _autoDisconnect                                              NOTIFY autoDisconnectChanged)
+    Q_PROPERTY(bool             redundantSend               READ redundantSend              WRITE setRedundantSend              NOTIFY redundantSendChanged)   ///< true: Repeatable control messages are also sent on the secondary links
 
     void                    mavlinkMessageReceived      (LinkInterface* link, mavlink_message_t message);
     bool                    containsLink                (LinkInterface* link);
@@ -46,11 +48,22 @@ public:
     QString                 primaryLinkName             (void) const;
     QStringList             linkNames                   (void) const;
     QStringList             linkStatuses                (void) const;
+    QList<SharedLinkInterfacePtr> activeLinks           (void) const;   ///< Links which have not lost communication, primary link first
     bool                    communicationLost           (void) const { return _communicationLost; }
     bool                    communicationLostEnabled    (void) const { return _communicationLostEnabled; }
     void                    setPrimaryLinkByName        (const QString& name);
     void                    setCommunicationLostEnabled (bool communicationLostEnabled);
     void                    closeVehicle                (void);
+    bool                    redundantSend               (void) const { return _redundantSend; }
+    void                    setRedundantSend            (bool redundantSend);
+
+    /// Messages from a vehicle reachable over more than one link arrive once per link. Only the first copy is
+    /// dispatched, later copies from other links are recognized here by sender, sequence, id and checksum.
+    ///     @return true: message was already received on another link
+    bool                    isDuplicateMessage          (LinkInterface* link, const mavlink_message_t& message);
+
+    /// @return Links besides the specified primary link which the message should also be sent on. Thread safe.
+    QList<SharedLinkInterfacePtr> redundantSendLinks    (LinkInterface* primaryLink, uint32_t msgid) const;
 
 signals:
     void primaryLinkChanged             (void);
@@ -60,6 +73,7 @@ signals:
     void linkNamesChanged               (void);
     void linkStatusesChanged            (void);
     void autoDisconnectChanged          (bool autoDisconnect);
+    void redundantSendChanged           (bool redundantSend);
 
 private slots:
     void _commLostCheck(void);
@@ -72,6 +86,7 @@ private:
     bool                    _updatePrimaryLink      (void);
     SharedLinkInterfacePtr  _bestActivePrimaryLink  (void);
     void                    _commRegainedOnLink     (LinkInterface*  link);
+    void                    _updateRedundantLinks   (void);
 
     typedef struct LinkInfo {
         SharedLinkInterfacePtr  link;
@@ -87,6 +102,19 @@ private:
     bool                    _communicationLost          = false;
     bool                    _communicationLostEnabled   = true;
     bool                    _autoDisconnect             = false;    ///< true: Automatically disconnect vehicle when last connection goes away or lost heartbeat
+    bool                    _redundantSend              = false;
+
+    typedef struct {
+        quint64         key;    ///< sysid, compid, seq, msgid and checksum packed together
+        LinkInterface*  link;
+    } RecentMessage_t;
+    QList<RecentMessage_t>  _recentMessages;                        ///< Ring buffer of the last _duplicateWindowCount messages
+    int                     _nextRecentMessageIndex     = 0;
+
+    mutable QMutex          _redundantLinksMutex;
+    QList<WeakLinkInterfacePtr> _redundantLinks;                    ///< Active links, protected by _redundantLinksMutex
+
+    static constexpr int _duplicateWindowCount          = 64;
 
     static const int _commLostCheckTimeoutMSecs     = 1000;  // Check for comm lost once a second
     static const int _heartbeatMaxElpasedMSecs      = 3500;  // No heartbeat for longer than this indicates comm loss
@@ -40,13 +40,26 @@ VehicleObjectAvoidance::update(mavlink_obstacle_distance_t* message)
             _distances[i] = static_cast<int>(message->distances[i]);
         }
     }
+    //-- The plottable grid is only built when asked for, not on every message
+    _gridDirty = true;
+    emit objectAvoidanceChanged();
+}
+
+//-----------------------------------------------------------------------------
+void
+VehicleObjectAvoidance::_updateGrid()
+{
+    if(!_gridDirty) {
+        return;
+    }
+    _gridDirty = false;
     //-- Create a plottable grid with found objects
     _objGrid.clear();
     _objDistance.clear();
     auto* sp = qobject_cast<VehicleSetpointFactGroup*>(_vehicle->setpointFactGroup());
     qreal startAngle = sp->yaw()->rawValue().toDouble() + _angleOffset;
-    for(int i = 0; i < MAVLINK_MSG_OBSTACLE_DISTANCE_FIELD_DISTANCES_LEN; i++) {
-        if(_distances[i] < _maxDistance && message->distances[i] != UINT16_MAX) {
+    for(int i = 0; i < _distances.count(); i++) {
+        if(_distances[i] < _maxDistance && _distances[i] != UINT16_MAX) {
             qreal d = static_cast<qreal>(_distances[i]);
             d = d / static_cast<qreal>(_maxDistance);
             qreal a = (_increment * i) - startAngle;
@@ -57,7 +70,6 @@ VehicleObjectAvoidance::update(mavlink_obstacle_distance_t* message)
             _objDistance.append(d);
         }
     }
-    emit objectAvoidanceChanged();
 }
 
 //-----------------------------------------------------------------------------
@@ -97,6 +109,7 @@ VehicleObjectAvoidance::stop()
 QPointF
 VehicleObjectAvoidance::grid(int i)
 {
+    _updateGrid();
     if(i < _objGrid.count() && i >= 0) {
         return _objGrid[i];
     }
@@ -107,6 +120,7 @@ VehicleObjectAvoidance::grid(int i)
 qreal
 VehicleObjectAvoidance::distance(int i)
 {
+    _updateGrid();
     if(i < _objDistance.count() && i >= 0) {
         return _objDistance[i];
     }
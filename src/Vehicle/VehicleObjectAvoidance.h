@@ -47,7 +47,7 @@ public:
     int             minDistance () const{ return _minDistance; }
     int             maxDistance () const{ return _maxDistance; }
     qreal           angleOffset () const{ return _angleOffset; }
-    int             gridSize    () { return _objGrid.count(); }
+    int             gridSize    () { _updateGrid(); return _objGrid.count(); }
 
     void            update      (mavlink_obstacle_distance_t* message);
 
@@ -55,6 +55,8 @@ signals:
     void            objectAvoidanceChanged  ();
 
 private:
+    void            _updateGrid ();
+
     QList<int>      _distances;
     QVector<QPointF>_objGrid;
     QVector<qreal>  _objDistance;
@@ -62,6 +64,7 @@ private:
     int             _minDistance    = 0;
     int             _maxDistance    = 0;
     qreal           _angleOffset    = 0;
+    bool            _gridDirty      = false;
     Vehicle*        _vehicle        = nullptr;
 
     static constexpr const char* kColPrevParam = "CP_DIST";
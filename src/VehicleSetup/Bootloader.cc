@@ -13,6 +13,7 @@
 #include "QGC.h"
 #include <QtCore/QFile>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QQueue>
 
 /// This class manages interactions with the bootloader
 Bootloader::Bootloader(bool sikRadio, QObject *parent)
@@ -340,6 +341,14 @@ Error:
     return false;
 }
 
+/// @return Number of PROTO_PROG_MULTI/PROTO_READ_MULTI commands which may be sent ahead of their responses. The PX4
+///         bootloaders run over USB CDC which pushes back once their receive buffer is full, the SiK radio bootloader
+///         runs over a UART without flow control and must see each command answered first.
+int Bootloader::_chunksInFlight(void) const
+{
+    return _sikRadio ? 1 : _maxChunksInFlight;
+}
+
 bool Bootloader::_binProgram(const FirmwareImage* image)
 {
     QFile firmwareFile(image->binFilename());
@@ -352,6 +361,21 @@ bool Bootloader::_binProgram(const FirmwareImage* image)
     uint8_t imageBuf[PROG_MULTI_MAX];
     uint32_t bytesSent = 0;
     _imageCRC = 0;
+
+    // Chunks are sent ahead of their responses, which come back in order. Each entry is the address of a chunk still
+    // waiting for its response.
+    QQueue<uint32_t> chunksInFlight;
+    const int maxChunksInFlight = _chunksInFlight();
+
+    auto checkNextResponse = [&]() -> bool {
+        const uint32_t chunkAddress = chunksInFlight.dequeue();
+        if (!_getCommandResponse()) {
+            _errorString = tr("Flash failed: %1 at address 0x%2").arg(_errorString).arg(chunkAddress, 8, 16, QLatin1Char('0'));
+            return false;
+        }
+        emit updateProgress(chunksInFlight.isEmpty() ? bytesSent : chunksInFlight.head(), imageSize);
+        return true;
+    };
     
     Q_ASSERT(PROG_MULTI_MAX <= 0x8F);
     
@@ -371,29 +395,33 @@ bool Bootloader::_binProgram(const FirmwareImage* image)
         
         Q_ASSERT(bytesToSend <= 0x8F);
         
-        bool failed = true;
-        if (_write(PROTO_PROG_MULTI) &&
+        if (!(_write(PROTO_PROG_MULTI) &&
                 _write((uint8_t)bytesToSend) &&
                 _write(imageBuf, bytesToSend) &&
-                _write(PROTO_EOC)) {
-            if (_getCommandResponse()) {
-                failed = false;
-            }
-        }
-        if (failed) {
+                _write(PROTO_EOC))) {
             _errorString = tr("Flash failed: %1 at address 0x%2").arg(_errorString).arg(bytesSent, 8, 16, QLatin1Char('0'));
             return false;
         }
+        chunksInFlight.enqueue(bytesSent);
 
         bytesSent += bytesToSend;
 
         // Calculate the CRC now so we can test it after the board is flashed.
         _imageCRC = QGC::crc32((uint8_t *)imageBuf, bytesToSend, _imageCRC);
 
-        emit updateProgress(bytesSent, imageSize);
+        if (chunksInFlight.count() >= maxChunksInFlight && !checkNextResponse()) {
+            return false;
+        }
     }
     firmwareFile.close();
 
+    _port.flush();
+    while (!chunksInFlight.isEmpty()) {
+        if (!checkNextResponse()) {
+            return false;
+        }
+    }
+
     // We calculate the CRC using the entire flash size, filling the remainder with 0xFF.
     while (bytesSent < _boardFlashSize) {
         const uint8_t fill = 0xFF;
@@ -519,54 +547,70 @@ bool Bootloader::_binVerifyBytes(const FirmwareImage* image)
         return false;
     }
     
-    uint8_t fileBuf[READ_MULTI_MAX];
     uint8_t readBuf[READ_MULTI_MAX];
+    uint32_t bytesRequested = 0;
     uint32_t bytesVerified = 0;
+
+    // Reads are requested ahead of their replies, which come back in order. Each entry holds the file contents the
+    // reply is compared against.
+    QQueue<QByteArray> readsInFlight;
+    const int maxReadsInFlight = _chunksInFlight();
+
+    auto checkNextRead = [&]() -> bool {
+        const QByteArray fileBytes = readsInFlight.dequeue();
+        const int bytesToRead = fileBytes.length();
+        if (!_read(readBuf, bytesToRead) || !_getCommandResponse()) {
+            _errorString = tr("Read failed: %1 at address: 0x%2").arg(_errorString).arg(bytesVerified, 8, 16, QLatin1Char('0'));
+            return false;
+        }
+        for (int i=0; i<bytesToRead; i++) {
+            if (static_cast<uint8_t>(fileBytes[i]) != readBuf[i]) {
+                _errorString = tr("Compare failed: expected(0x%1) actual(0x%2) at address: 0x%3").arg(static_cast<uint8_t>(fileBytes[i]), 2, 16, QLatin1Char('0')).arg(readBuf[i], 2, 16, QLatin1Char('0')).arg(bytesVerified + i, 8, 16, QLatin1Char('0'));
+                return false;
+            }
+        }
+        bytesVerified += bytesToRead;
+        emit updateProgress(bytesVerified, imageSize);
+        return true;
+    };
     
     Q_ASSERT(PROG_MULTI_MAX <= 0x8F);
     
-    while (bytesVerified < imageSize) {
-        int bytesToRead = imageSize - bytesVerified;
+    while (bytesRequested < imageSize) {
+        int bytesToRead = imageSize - bytesRequested;
         if (bytesToRead > (int)sizeof(readBuf)) {
             bytesToRead = (int)sizeof(readBuf);
         }
         
         Q_ASSERT((bytesToRead % 4) == 0);
         
-        int bytesRead = firmwareFile.read((char *)fileBuf, bytesToRead);
-        if (bytesRead == -1 || bytesRead != bytesToRead) {
+        QByteArray fileBytes = firmwareFile.read(bytesToRead);
+        if (fileBytes.length() != bytesToRead) {
             _errorString = tr("Firmware file read failed: %1").arg(firmwareFile.errorString());
             return false;
         }
         
         Q_ASSERT(bytesToRead <= 0x8F);
         
-        bool failed = true;
-        if (_write(PROTO_READ_MULTI) &&
+        if (!(_write(PROTO_READ_MULTI) &&
                 _write((uint8_t)bytesToRead) &&
-                _write(PROTO_EOC)) {
-            _port.flush();
-            if (_read(readBuf, bytesToRead)) {
-                if (_getCommandResponse()) {
-                    failed = false;
-                }
-            }
+                _write(PROTO_EOC))) {
+            _errorString = tr("Read failed: %1 at address: 0x%2").arg(_errorString).arg(bytesRequested, 8, 16, QLatin1Char('0'));
+            return false;
         }
-        if (failed) {
-            _errorString = tr("Read failed: %1 at address: 0x%2").arg(_errorString).arg(bytesVerified, 8, 16, QLatin1Char('0'));
+        _port.flush();
+        readsInFlight.enqueue(fileBytes);
+        bytesRequested += bytesToRead;
+
+        if (readsInFlight.count() >= maxReadsInFlight && !checkNextRead()) {
             return false;
         }
+    }
 
-        for (int i=0; i<bytesToRead; i++) {
-            if (fileBuf[i] != readBuf[i]) {
-                _errorString = tr("Compare failed: expected(0x%1) actual(0x%2) at address: 0x%3").arg(fileBuf[i], 2, 16, QLatin1Char('0')).arg(readBuf[i], 2, 16, QLatin1Char('0')).arg(bytesVerified + i, 8, 16, QLatin1Char('0'));
-                return false;
-            }
+    while (!readsInFlight.isEmpty()) {
+        if (!checkNextRead()) {
+            return false;
         }
-        
-        bytesVerified += bytesToRead;
-        
-        emit updateProgress(bytesVerified, imageSize);
     }
     
     firmwareFile.close();
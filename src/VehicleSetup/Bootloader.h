@@ -52,6 +52,7 @@ private:
     bool    _sync               (void);
     bool    _syncWorker         (void);
     bool    _binProgram         (const FirmwareImage* image);
+    int     _chunksInFlight     (void) const;
     bool    _ihxProgram         (const FirmwareImage* image);
     bool    _write              (const uint8_t* data, qint64 maxSize);
     bool    _write              (const uint8_t byte);
@@ -119,4 +120,5 @@ private:
     static const int _responseTimeout                   = 2000;     ///< Msecs to wait for command response bytes
     static const int _flashSizeSmall                    = 1032192;  ///< Flash size for boards with silicon error
     static const int _bootloaderVersionV2CorrectFlash   = 5;        ///< Anything below this bootloader version on V2 boards cannot trust flash size
+    static const int _maxChunksInFlight                 = 8;        ///< Program/read commands sent ahead of their responses on USB bootloaders
 };
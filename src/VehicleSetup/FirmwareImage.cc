@@ -13,8 +13,10 @@
 #include "CompInfoParam.h"
 #include "Bootloader.h"
 #include "QGCLoggingCategory.h"
+#include "QGCZlib.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QSaveFile>
 #include <QtCore/QTextStream>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -32,6 +34,7 @@ bool FirmwareImage::load(const QString& imageFilename, uint32_t boardId)
 {
     _imageSize = 0;
     _boardId = boardId;
+    _firmwareBoardId = boardId;
     
     if (imageFilename.endsWith(".bin")) {
         _binFormat = true;
@@ -179,7 +182,7 @@ bool FirmwareImage::_ihxLoad(const QString& ihxFilename)
     return true;
 }
 
-bool FirmwareImage::isCompatible(uint32_t boardId, uint32_t firmwareId) {
+bool FirmwareImage::isCompatible(uint32_t boardId, uint32_t firmwareId) const {
     bool result = false;
     if (boardId == firmwareId ) {
         result = true;
@@ -241,33 +244,24 @@ bool FirmwareImage::_px4Load(const QString& imageFilename)
         emit statusMessage(tr("Downloaded firmware board id does not match hardware board id: %1 != %2").arg(firmwareBoardId).arg(_boardId));
         return false;
     }
+    _firmwareBoardId = firmwareBoardId;
 
     // What firmware type is this?
     MAV_AUTOPILOT firmwareType = (MAV_AUTOPILOT)px4Json[_jsonMavAutopilotKey].toInt(MAV_AUTOPILOT_PX4);
     emit statusMessage(QString("MAV_AUTOPILOT = %1").arg(firmwareType));
     
-    // Decompress the parameter xml and save to file
-    QByteArray decompressedBytes;
-    bool success = _decompressJsonValue(px4Json,               // JSON object
-                                        bytes,                 // Raw bytes of JSON document
-                                        _jsonParamXmlSizeKey,  // key which holds byte size
-                                        _jsonParamXmlKey,      // key which holds compressed bytes
-                                        decompressedBytes);    // Returned decompressed bytes
-    if (success) {
-        QString parameterFilename = QGCApplication::cachedParameterMetaDataFile();
-        QFile parameterFile(QGCApplication::cachedParameterMetaDataFile());
-
-        if (parameterFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-            qint64 bytesWritten = parameterFile.write(decompressedBytes);
-            if (bytesWritten != decompressedBytes.length()) {
-                emit statusMessage(tr("Write failed for parameter meta data file, error: %1").arg(parameterFile.errorString()));
-                parameterFile.close();
-                QFile::remove(parameterFilename);
-            } else {
-                parameterFile.close();
-            }
-        } else {
-            emit statusMessage(tr("Unable to open parameter meta data file %1 for writing, error: %2").arg(parameterFilename, parameterFile.errorString()));
+    // Decompress the parameter xml and save to file. The files are only replaced once they are written completely.
+    QString parameterFilename = QGCApplication::cachedParameterMetaDataFile();
+    QSaveFile parameterFile(parameterFilename);
+    if (!parameterFile.open(QIODevice::WriteOnly)) {
+        emit statusMessage(tr("Unable to open parameter meta data file %1 for writing, error: %2").arg(parameterFilename, parameterFile.errorString()));
+    } else if (_decompressJsonValue(px4Json,                // JSON object
+                                    bytes,                  // Raw bytes of JSON document
+                                    _jsonParamXmlSizeKey,   // key which holds byte size
+                                    _jsonParamXmlKey,       // key which holds compressed bytes
+                                    parameterFile)) {       // Device for decompressed bytes
+        if (!parameterFile.commit()) {
+            emit statusMessage(tr("Write failed for parameter meta data file, error: %1").arg(parameterFile.errorString()));
         }
 
         // Cache this file with the system
@@ -275,75 +269,61 @@ bool FirmwareImage::_px4Load(const QString& imageFilename)
     }
 
     // Decompress the airframe xml and save to file
-    success = _decompressJsonValue(px4Json,                         // JSON object
-                                        bytes,                      // Raw bytes of JSON document
-                                        _jsonAirframeXmlSizeKey,    // key which holds byte size
-                                        _jsonAirframeXmlKey,        // key which holds compressed bytes
-                                        decompressedBytes);         // Returned decompressed bytes
-    if (success) {
-        QString airframeFilename = QGCApplication::cachedAirframeMetaDataFile();
-        //qDebug() << airframeFilename;
-        QFile airframeFile(QGCApplication::cachedAirframeMetaDataFile());
-
-        if (airframeFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-            qint64 bytesWritten = airframeFile.write(decompressedBytes);
-            if (bytesWritten != decompressedBytes.length()) {
-                // FIXME: What about these warnings?
-                emit statusMessage(tr("Write failed for airframe meta data file, error: %1").arg(airframeFile.errorString()));
-                airframeFile.close();
-                QFile::remove(airframeFilename);
-            } else {
-                airframeFile.close();
-            }
-        } else {
-            emit statusMessage(tr("Unable to open airframe meta data file %1 for writing, error: %2").arg(airframeFilename, airframeFile.errorString()));
+    QString airframeFilename = QGCApplication::cachedAirframeMetaDataFile();
+    QSaveFile airframeFile(airframeFilename);
+    if (!airframeFile.open(QIODevice::WriteOnly)) {
+        emit statusMessage(tr("Unable to open airframe meta data file %1 for writing, error: %2").arg(airframeFilename, airframeFile.errorString()));
+    } else if (_decompressJsonValue(px4Json,                    // JSON object
+                                    bytes,                      // Raw bytes of JSON document
+                                    _jsonAirframeXmlSizeKey,    // key which holds byte size
+                                    _jsonAirframeXmlKey,        // key which holds compressed bytes
+                                    airframeFile)) {            // Device for decompressed bytes
+        if (!airframeFile.commit()) {
+            // FIXME: What about these warnings?
+            emit statusMessage(tr("Write failed for airframe meta data file, error: %1").arg(airframeFile.errorString()));
         }
     }
     
-    // Decompress the image and save to file
-    _imageSize = px4Json.value(QString("image_size")).toInt();
-    success = _decompressJsonValue(px4Json,               // JSON object
-                                   bytes,                 // Raw bytes of JSON document
-                                   _jsonImageSizeKey,     // key which holds byte size
-                                   _jsonImageKey,         // key which holds compressed bytes
-                                   decompressedBytes);    // Returned decompressed bytes
-    if (!success) {
-        return false;
-    }
-    
-    // Pad image to 4-byte boundary
-    while ((decompressedBytes.length() % 4) != 0) {
-        decompressedBytes.append(static_cast<char>(static_cast<unsigned char>(0xFF)));
-    }
-    
-    // Store decompressed image file in same location as original download file
-    QDir imageDir = QFileInfo(imageFilename).dir();
-    QString decompressFilename = imageDir.filePath("PX4FlashUpgrade.bin");
+    // Store decompressed image file in same location as original download file. Named after the download so
+    // images for different boards can be flashed at the same time.
+    QFileInfo imageInfo(imageFilename);
+    QString decompressFilename = imageInfo.dir().filePath(QStringLiteral("PX4FlashUpgrade_%1.bin").arg(imageInfo.completeBaseName()));
     
-    QFile decompressFile(decompressFilename);
-    if (!decompressFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    QSaveFile decompressFile(decompressFilename);
+    if (!decompressFile.open(QIODevice::WriteOnly)) {
         emit statusMessage(tr("Unable to open decompressed file %1 for writing, error: %2").arg(decompressFilename, decompressFile.errorString()));
         return false;
     }
+
+    // Decompress the image straight to the file
+    _imageSize = px4Json.value(QString("image_size")).toInt();
+    if (!_decompressJsonValue(px4Json,                  // JSON object
+                              bytes,                    // Raw bytes of JSON document
+                              _jsonImageSizeKey,        // key which holds byte size
+                              _jsonImageKey,            // key which holds compressed bytes
+                              decompressFile)) {        // Device for decompressed bytes
+        return false;
+    }
     
-    qint64 bytesWritten = decompressFile.write(decompressedBytes);
-    if (bytesWritten != decompressedBytes.length()) {
+    // Pad image to 4-byte boundary
+    const QByteArray padding((4 - (_imageSize % 4)) % 4, static_cast<char>(static_cast<unsigned char>(0xFF)));
+    if ((decompressFile.write(padding) != padding.length()) || !decompressFile.commit()) {
         emit statusMessage(tr("Write failed for decompressed image file, error: %1").arg(decompressFile.errorString()));
         return false;
     }
-    decompressFile.close();
     
     _binFilename = decompressFilename;
     
     return true;
 }
 
-/// Decompress a set of bytes stored in a Json document.
+/// Decompress a set of bytes stored in a Json document. The bytes are decoded and decompressed in slices
+/// and written to the output as they come, neither the compressed nor the decompressed bytes are held as a whole.
 bool FirmwareImage::_decompressJsonValue(const QJsonObject&	jsonObject,			///< JSON object
                                          const QByteArray&	jsonDocBytes,		///< Raw bytes of JSON document
                                          const QString&		sizeKey,			///< key which holds byte size
                                          const QString&		bytesKey,			///< key which holds compress bytes
-                                         QByteArray&		decompressedBytes)	///< Returned decompressed bytes
+                                         QIODevice&			output)				///< Device for decompressed bytes
 {
     // Validate decompressed size key
     if (!jsonObject.contains(sizeKey)) {
@@ -362,34 +342,46 @@ bool FirmwareImage::_decompressJsonValue(const QJsonObject&	jsonObject,			///< J
     // for the image string. Since its compressed / checksummed
     // this should be fine.
     
-    QStringList parts = QString(jsonDocBytes).split(QString("\"%1\": \"").arg(bytesKey));
-    if (parts.length() == 1) {
+    // The search is done on the raw bytes: converting the whole document to a QString for each key costs more
+    // than the decompression itself.
+    const QByteArray startMarker = QStringLiteral("\"%1\": \"").arg(bytesKey).toUtf8();
+    const qsizetype startIndex = jsonDocBytes.lastIndexOf(startMarker);
+    if (startIndex == -1) {
         emit statusMessage(tr("Could not find compressed bytes for %1 in Firmware file").arg(bytesKey));
         return false;
     }
-    parts = parts.last().split("\"");
-    if (parts.length() == 1) {
+    const qsizetype bytesIndex = startIndex + startMarker.length();
+    const qsizetype endIndex = jsonDocBytes.indexOf('"', bytesIndex);
+    if (endIndex == -1) {
         emit statusMessage(tr("Incorrectly formed compressed bytes section for %1 in Firmware file").arg(bytesKey));
         return false;
     }
     
-    // Store decompressed size as first four bytes. This is required by qUncompress routine.
-    QByteArray raw;
-    raw.append((unsigned char)((decompressedSize >> 24) & 0xFF));
-    raw.append((unsigned char)((decompressedSize >> 16) & 0xFF));
-    raw.append((unsigned char)((decompressedSize >> 8) & 0xFF));
-    raw.append((unsigned char)((decompressedSize >> 0) & 0xFF));
-    
-    QByteArray raw64 = parts.first().toUtf8();
-    raw.append(QByteArray::fromBase64(raw64));
-    decompressedBytes = qUncompress(raw);
-    
-    if (decompressedBytes.length() == 0) {
+    // The bytes are a plain zlib stream, the size prefix is only needed by qUncompress
+    bool writeFailed = false;
+    QGCZlib::Inflater inflater(QGCZlib::Inflater::Format::Zlib, [&output, &writeFailed](QByteArrayView data) {
+        writeFailed = output.write(data.data(), data.size()) != data.size();
+        return !writeFailed;
+    });
+
+    // Slices are a multiple of 4 characters so that each one decodes on its own
+    constexpr qsizetype base64SliceSize = 64 * 1024;
+    bool inflateOk = true;
+    for (qsizetype index = bytesIndex; inflateOk && (index < endIndex); index += base64SliceSize) {
+        const qsizetype length = qMin(base64SliceSize, endIndex - index);
+        inflateOk = inflater.write(QByteArray::fromBase64(QByteArray::fromRawData(jsonDocBytes.constData() + index, length)));
+    }
+
+    if (writeFailed) {
+        emit statusMessage(tr("Write failed for decompressed %1, error: %2").arg(bytesKey, output.errorString()));
+        return false;
+    }
+    if (!inflateOk || !inflater.finished() || (inflater.totalOut() == 0)) {
         emit statusMessage(tr("Firmware file has 0 length %1").arg(bytesKey));
         return false;
     }
-    if (decompressedBytes.length() != decompressedSize) {
-        emit statusMessage(tr("Size for decompressed %1 does not match stored size: Expected(%1) Actual(%2)").arg(decompressedSize).arg(decompressedBytes.length()));
+    if (inflater.totalOut() != decompressedSize) {
+        emit statusMessage(tr("Size for decompressed %1 does not match stored size: Expected(%2) Actual(%3)").arg(bytesKey).arg(decompressedSize).arg(inflater.totalOut()));
         return false;
     }
     
@@ -54,8 +54,11 @@ public:
     /// @return true: block retrieved
     bool ihxGetBlock(uint16_t index, uint16_t& address, QByteArray& bytes) const;
     
+    /// @return Board id the image was built for, the board id passed to load for formats which do not carry one
+    uint32_t firmwareBoardId(void) const { return _firmwareBoardId; }
+    
     /// @return true: actual boardId is compatible with firmware boardId
-    bool isCompatible(uint32_t boardId, uint32_t firmwareId);
+    bool isCompatible(uint32_t boardId, uint32_t firmwareId) const;
 
 signals:
     void errorMessage(const QString& errorString);
@@ -74,7 +77,7 @@ private:
                               const QByteArray&     jsonDocBytes,
                               const QString&		sizeKey,
                               const QString&		bytesKey,
-                              QByteArray&			decompressedBytes);
+                              QIODevice&			output);
     
     typedef struct {
         uint16_t    address;
@@ -83,6 +86,7 @@ private:
 
     bool                    _binFormat;
     uint32_t                _boardId;
+    uint32_t                _firmwareBoardId;
     QString                 _binFilename;
     QList<IntelHexBlock_t>  _ihxBlocks;
     uint32_t                _imageSize;
@@ -62,6 +62,7 @@ SetupPage {
             property bool   firmwareWarningMessageVisible:  false
             property bool   initialBoardSearch:             true
             property string firmwareName
+            property bool   batchFlash:                     false   ///< true: keep flashing every board plugged in
 
             property bool _singleFirmwareMode:          QGroundControl.corePlugin.options.firmwareUpgradeSingleURL.length != 0   ///< true: running in special single firmware download mode
 
@@ -76,7 +77,11 @@ SetupPage {
                 nameFilters:        [qsTr("Firmware Files (*.px4 *.apj *.bin *.ihx)"), qsTr("All Files (*)")]
                 folder:             QGroundControl.settingsManager.appSettings.logSavePath
                 onAcceptedForLoad: (file) => {
-                    controller.flashFirmwareUrl(file)
+                    if (batchFlash) {
+                        controller.startBatchFlashFirmwareUrl(file)
+                    } else {
+                        controller.flashFirmwareUrl(file)
+                    }
                     close()
                 }
             }
@@ -183,6 +188,7 @@ SetupPage {
                     }
 
                     onAccepted: {
+                        batchFlash = batchFlashCheckBox.checked
                         if (_singleFirmwareMode) {
                             controller.flashSingleFirmwareMode(controller.selectedFirmwareBuildType)
                         } else {
@@ -212,13 +218,19 @@ SetupPage {
                                         firmwareSelectDialog.preventClose = true
                                         return
                                     }
-                                    controller.flashFirmwareUrl(controller.apmFirmwareUrls[ardupilotFirmwareSelectionCombo.currentIndex])
+                                    if (batchFlash) {
+                                        controller.startBatchFlashFirmwareUrl(firmwareUrl)
+                                    } else {
+                                        controller.flashFirmwareUrl(firmwareUrl)
+                                    }
                                     return
                                 }
                             }
                             //-- If custom, get file path
                             if (firmwareBuildType === FirmwareUpgradeController.CustomFirmware) {
                                 customFirmwareDialog.openForLoad()
+                            } else if (batchFlash) {
+                                controller.startBatchFlash(stack, firmwareBuildType, vehicleType)
                             } else {
                                 controller.flash(stack, firmwareBuildType, vehicleType)
                             }
@@ -354,6 +366,13 @@ SetupPage {
                             visible:            !controller.downloadingFirmwareList && (QGroundControl.apmFirmwareSupported && controller.apmFirmwareNames.length === 0)
                         }
 
+                        QGCCheckBox {
+                            id:         batchFlashCheckBox
+                            text:       qsTr("Batch: also flash every board plugged in afterwards")
+                            checked:    false
+                            visible:    !_singleFirmwareMode
+                        }
+
                         QGCCheckBox {
                             id:         _advanced
                             text:       qsTr("Advanced settings")
@@ -420,6 +439,57 @@ SetupPage {
                 visible:                !flashBootloaderButton.visible
             }
 
+            // Per board progress while batch flashing
+            ColumnLayout {
+                Layout.fillWidth:   true
+                spacing:            ScreenTools.defaultFontPixelHeight / 4
+                visible:            controller.batchActive || controller.batchBoards.count > 0
+
+                RowLayout {
+                    Layout.fillWidth:   true
+
+                    QGCLabel {
+                        Layout.fillWidth:   true
+                        text:               controller.batchActive ? qsTr("Batch upgrade: plug in the boards to flash") : qsTr("Batch upgrade")
+                    }
+
+                    QGCButton {
+                        text:       qsTr("Stop Batch")
+                        visible:    controller.batchActive
+                        onClicked:  controller.cancel()
+                    }
+                }
+
+                Repeater {
+                    model: controller.batchBoards
+
+                    RowLayout {
+                        Layout.fillWidth:   true
+                        spacing:            ScreenTools.defaultFontPixelWidth
+
+                        property var _board: object
+
+                        QGCLabel {
+                            Layout.preferredWidth:  ScreenTools.defaultFontPixelWidth * 25
+                            text:                   _board.portName + " " + _board.boardName
+                            elide:                  Text.ElideRight
+                        }
+
+                        ProgressBar {
+                            Layout.preferredWidth:  ScreenTools.defaultFontPixelWidth * 20
+                            value:                  _board.progress
+                        }
+
+                        QGCLabel {
+                            Layout.fillWidth:   true
+                            text:               _board.status
+                            color:              _board.failed ? qgcPal.colorRed : qgcPal.text
+                            elide:              Text.ElideRight
+                        }
+                    }
+                }
+            }
+
             QGCButton {
                 id:         flashBootloaderButton
                 text:       qsTr("Flash ChibiOS Bootloader")
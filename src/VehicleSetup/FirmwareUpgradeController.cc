@@ -9,6 +9,7 @@
 
 #include "FirmwareUpgradeController.h"
 #include "PX4FirmwareUpgradeThread.h"
+#include "PX4FirmwareBatchFlasher.h"
 #include "Bootloader.h"
 #include "QGCApplication.h"
 #include "QGCFileDownload.h"
@@ -22,6 +23,7 @@
 #include "MultiVehicleManager.h"
 #include "FirmwareImage.h"
 #include "Fact.h"
+#include "QmlObjectListModel.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QDir>
@@ -137,6 +139,12 @@ FirmwareUpgradeController::FirmwareUpgradeController(void)
     
     connect(&_eraseTimer, &QTimer::timeout, this, &FirmwareUpgradeController::_eraseProgressTick);
 
+    _batchFlasher = new PX4FirmwareBatchFlasher(this);
+    connect(_batchFlasher, &PX4FirmwareBatchFlasher::foundBoardInfo,    this, &FirmwareUpgradeController::_batchFoundBoardInfo);
+    connect(_batchFlasher, &PX4FirmwareBatchFlasher::status,            this, &FirmwareUpgradeController::_batchStatus);
+    connect(_batchFlasher, &PX4FirmwareBatchFlasher::boardFinished,     this, &FirmwareUpgradeController::_batchBoardFinished);
+    connect(_batchFlasher, &PX4FirmwareBatchFlasher::activeChanged,     this, &FirmwareUpgradeController::_batchActiveChanged);
+
 #if !defined(NO_ARDUPILOT_DIALECT)
     connect(_apmChibiOSSetting,     &Fact::rawValueChanged, this, &FirmwareUpgradeController::_buildAPMFirmwareNames);
     connect(_apmVehicleTypeSetting, &Fact::rawValueChanged, this, &FirmwareUpgradeController::_buildAPMFirmwareNames);
@@ -151,6 +159,10 @@ FirmwareUpgradeController::FirmwareUpgradeController(void)
 
 FirmwareUpgradeController::~FirmwareUpgradeController()
 {
+    // Waits for boards which are being flashed, they still use the images
+    delete _batchFlasher;
+    qDeleteAll(_batchImages);
+
     qgcApp()->toolbox()->linkManager()->setConnectionsAllowed();
 }
 
@@ -212,6 +224,34 @@ void FirmwareUpgradeController::cancel(void)
 {
     _eraseTimer.stop();
     _threadController->cancel();
+    _batchFlasher->stop();
+}
+
+void FirmwareUpgradeController::startBatchFlash(AutoPilotStackType_t stackType,
+                                                FirmwareBuildType_t firmwareType,
+                                                FirmwareVehicleType_t vehicleType)
+{
+    qCDebug(FirmwareUpgradeLog) << "FirmwareUpgradeController::startBatchFlash stackType:firmwareType:vehicleType" << stackType << firmwareType << vehicleType;
+    _batchFirmwareId = FirmwareIdentifier(stackType, firmwareType, vehicleType);
+    _batchFirmwareUrl.clear();
+    _startBatch();
+}
+
+void FirmwareUpgradeController::startBatchFlashFirmwareUrl(QString firmwareUrl)
+{
+    qCDebug(FirmwareUpgradeLog) << "FirmwareUpgradeController::startBatchFlashFirmwareUrl" << firmwareUrl;
+    _batchFirmwareUrl = firmwareUrl;
+    _startBatch();
+}
+
+bool FirmwareUpgradeController::batchActive(void) const
+{
+    return _batchFlasher->active();
+}
+
+QmlObjectListModel* FirmwareUpgradeController::batchBoards(void)
+{
+    return _batchFlasher->boards();
 }
 
 QStringList FirmwareUpgradeController::availableBoardsName(void)
@@ -291,6 +331,138 @@ void FirmwareUpgradeController::_foundBoardInfo(int bootloaderVersion, int board
     }
 }
 
+void FirmwareUpgradeController::_startBatch(void)
+{
+    // Images of the last batch can only go once nothing is flashed from them anymore
+    if (!_batchFlasher->busy()) {
+        qDeleteAll(_batchImages);
+        _batchImages.clear();
+    }
+
+    _appendStatusLog(tr("Batch upgrade started. Plug in the boards to flash, they are flashed at the same time."), true);
+    _batchFlasher->start();
+
+    // The board search would compete for new boards. A board it found is held in its bootloader, hand it over.
+    _threadController->releaseBoard();
+    if (_bootloaderFound) {
+        _bootloaderFound = false;
+        _batchFlasher->addBoard(_boardInfo.portName());
+    }
+}
+
+void FirmwareUpgradeController::_batchFoundBoardInfo(const QString& portName, int /*bootloaderVersion*/, int boardID, int flashSize)
+{
+    _batchBoardInfo[portName] = { static_cast<uint32_t>(boardID), static_cast<uint32_t>(flashSize) };
+    _appendStatusLog(tr("%1: Connected to bootloader, board ID %2").arg(portName).arg(boardID));
+
+    QString firmwareUrl = _batchFirmwareUrl;
+    if (firmwareUrl.isEmpty()) {
+        firmwareUrl = _firmwareHashForBoardId(boardID)->value(_batchFirmwareId);
+        if (firmwareUrl.isEmpty()) {
+            _batchFlasher->fail(portName, tr("Unable to find specified firmware for board type"));
+            return;
+        }
+    }
+
+    if (_batchImages.contains(firmwareUrl)) {
+        _batchFlashPort(portName, _batchImages[firmwareUrl]);
+    } else if (_batchDownloads.contains(firmwareUrl)) {
+        // Another board of the same type is already downloading it
+        _batchDownloads[firmwareUrl].append(portName);
+    } else {
+        _batchDownloads[firmwareUrl] = QStringList(portName);
+
+        _appendStatusLog(tr("Downloading firmware..."));
+        _appendStatusLog(tr(" From: %1").arg(firmwareUrl));
+
+        QGCFileDownload* downloader = new QGCFileDownload(this);
+        connect(downloader, &QGCFileDownload::downloadComplete, this, [this, firmwareUrl](QString /*remoteFile*/, QString localFile, QString errorMsg) {
+            _batchDownloadComplete(firmwareUrl, localFile, errorMsg);
+        });
+        downloader->download(firmwareUrl);
+    }
+}
+
+void FirmwareUpgradeController::_batchDownloadComplete(const QString& firmwareUrl, const QString& localFile, const QString& errorMsg)
+{
+    // Boards which failed or were released while waiting are skipped
+    QStringList portNames;
+    for (const QString& portName: _batchDownloads.take(firmwareUrl)) {
+        if (_batchBoardInfo.contains(portName)) {
+            portNames.append(portName);
+        }
+    }
+    if (portNames.isEmpty()) {
+        return;
+    }
+
+    if (!errorMsg.isEmpty()) {
+        for (const QString& portName: portNames) {
+            _batchFlasher->fail(portName, errorMsg);
+        }
+        return;
+    }
+
+    // The image is decompressed once here and all boards using this url are flashed from it
+    FirmwareImage* image = new FirmwareImage(this);
+    connect(image, &FirmwareImage::statusMessage, this, &FirmwareUpgradeController::_status);
+
+    if (!image->load(localFile, _batchBoardInfo.value(portNames.first()).boardId)) {
+        delete image;
+        for (const QString& portName: portNames) {
+            _batchFlasher->fail(portName, tr("Image load failed"));
+        }
+        return;
+    }
+
+    _batchImages[firmwareUrl] = image;
+    for (const QString& portName: portNames) {
+        _batchFlashPort(portName, image);
+    }
+}
+
+void FirmwareUpgradeController::_batchFlashPort(const QString& portName, const FirmwareImage* image)
+{
+    const BatchBoardInfo_t boardInfo = _batchBoardInfo.value(portName);
+
+    if (!image->isCompatible(boardInfo.boardId, image->firmwareBoardId())) {
+        _batchFlasher->fail(portName, tr("Downloaded firmware board id does not match hardware board id: %1 != %2").arg(image->firmwareBoardId()).arg(boardInfo.boardId));
+    } else if (boardInfo.flashSize != 0 && image->imageSize() > boardInfo.flashSize) {
+        _batchFlasher->fail(portName, tr("Image size of %1 is too large for board flash size %2").arg(image->imageSize()).arg(boardInfo.flashSize));
+    } else {
+        _batchFlasher->flash(portName, image);
+    }
+}
+
+void FirmwareUpgradeController::_batchStatus(const QString& portName, const QString& statusText)
+{
+    _appendStatusLog(QStringLiteral("%1: %2").arg(portName, statusText));
+}
+
+void FirmwareUpgradeController::_batchBoardFinished(const QString& portName, bool success)
+{
+    _batchBoardInfo.remove(portName);
+    if (!success) {
+        _appendStatusLog(tr("%1: Upgrade failed").arg(portName), true);
+    }
+    _batchCheckFinished();
+}
+
+void FirmwareUpgradeController::_batchActiveChanged(bool active)
+{
+    emit batchActiveChanged(active);
+    _batchCheckFinished();
+}
+
+void FirmwareUpgradeController::_batchCheckFinished(void)
+{
+    if (!_batchFlasher->active() && !_batchFlasher->busy()) {
+        _appendStatusLog(tr("Batch upgrade finished"), true);
+        _appendStatusLog("------------------------------------------", false);
+        qgcApp()->toolbox()->linkManager()->setConnectionsAllowed();
+    }
+}
+
 /// @brief Called when the findBootloader process is unable to sync to the bootloader. Moves the state
 ///         machine to the appropriate error state.
 void FirmwareUpgradeController::_bootloaderSyncFailed(void)
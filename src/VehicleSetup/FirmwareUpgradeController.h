@@ -23,8 +23,10 @@
 
 class PX4FirmwareUpgradeThread;
 class PX4FirmwareUpgradeThreadController;
+class PX4FirmwareBatchFlasher;
 class FirmwareImage;
 class Fact;
+class QmlObjectListModel;
 
 /// Supported firmware types. If you modify these you will need to update the qml file as well.
 
@@ -85,6 +87,8 @@ public:
     FirmwareUpgradeController(void);
     ~FirmwareUpgradeController();
 
+    Q_MOC_INCLUDE("QmlObjectListModel.h")
+
     Q_PROPERTY(bool                 downloadingFirmwareList     MEMBER _downloadingFirmwareList                                     NOTIFY downloadingFirmwareListChanged)
     Q_PROPERTY(QString              boardPort                   READ boardPort                                                      NOTIFY boardFound)
     Q_PROPERTY(QString              boardDescription            READ boardDescription                                               NOTIFY boardFound)
@@ -96,6 +100,8 @@ public:
     Q_PROPERTY(QStringList          apmFirmwareUrls             MEMBER _apmFirmwareUrls                                             NOTIFY apmFirmwareNamesChanged)
     Q_PROPERTY(QString              px4StableVersion            READ px4StableVersion                                               NOTIFY px4StableVersionChanged)
     Q_PROPERTY(QString              px4BetaVersion              READ px4BetaVersion                                                 NOTIFY px4BetaVersionChanged)
+    Q_PROPERTY(bool                 batchActive                 READ batchActive                                                    NOTIFY batchActiveChanged)
+    Q_PROPERTY(QmlObjectListModel*  batchBoards                 READ batchBoards                                                    CONSTANT)
 
     /// TextArea for log output
     Q_PROPERTY(QQuickItem* statusLog READ statusLog WRITE setStatusLog)
@@ -119,6 +125,16 @@ public:
     /// Called to flash when upgrade is running in singleFirmwareMode
     Q_INVOKABLE void flashSingleFirmwareMode(FirmwareBuildType_t firmwareType);
 
+    /// Flashes every board which is plugged in from now on until cancel is called, the boards are flashed at the
+    /// same time. The firmware is picked per board id like flash does. A board which is already held in its
+    /// bootloader by the board search is the first one of the batch.
+    Q_INVOKABLE void startBatchFlash(AutoPilotStackType_t stackType,
+                                     FirmwareBuildType_t firmwareType = StableFirmware,
+                                     FirmwareVehicleType_t vehicleType = DefaultVehicleFirmware);
+
+    /// Same as startBatchFlash with the same firmware for all boards
+    Q_INVOKABLE void startBatchFlashFirmwareUrl(QString firmwareUrl);
+
     Q_INVOKABLE FirmwareVehicleType_t vehicleTypeFromFirmwareSelectionIndex(int index);
     
     // overload, not exposed to qml side
@@ -144,6 +160,9 @@ public:
 
     bool pixhawkBoard(void) const { return _boardType == QGCSerialPortInfo::BoardTypePixhawk; }
 
+    bool                batchActive (void) const;
+    QmlObjectListModel* batchBoards (void);
+
     /**
      * @brief Return a human friendly string of available boards
      *
@@ -164,6 +183,7 @@ signals:
     void px4StableVersionChanged        (const QString& px4StableVersion);
     void px4BetaVersionChanged          (const QString& px4BetaVersion);
     void downloadingFirmwareListChanged (bool downloadingFirmwareList);
+    void batchActiveChanged             (bool batchActive);
 
 private slots:
     void _firmwareDownloadProgress          (qint64 curr, qint64 total);
@@ -183,6 +203,10 @@ private slots:
     void _px4ReleasesGithubDownloadComplete (QString remoteFile, QString localFile, QString errorMsg);
     void _ardupilotManifestDownloadComplete (QString remoteFile, QString localFile, QString errorMsg);
     void _buildAPMFirmwareNames             (void);
+    void _batchFoundBoardInfo               (const QString& portName, int bootloaderVersion, int boardID, int flashSize);
+    void _batchStatus                       (const QString& portName, const QString& statusText);
+    void _batchBoardFinished                (const QString& portName, bool success);
+    void _batchActiveChanged                (bool active);
 
 private:
     QHash<FirmwareIdentifier, QString>* _firmwareHashForBoardId(int boardId);
@@ -192,6 +216,10 @@ private:
     void _errorCancel               (const QString& msg);
     void _determinePX4StableVersion (void);
     void _downloadArduPilotManifest (void);
+    void _startBatch                (void);
+    void _batchDownloadComplete     (const QString& firmwareUrl, const QString& localFile, const QString& errorMsg);
+    void _batchFlashPort            (const QString& portName, const FirmwareImage* image);
+    void _batchCheckFinished        (void);
 
     QString _singleFirmwareURL;
     bool    _singleFirmwareMode;
@@ -246,6 +274,19 @@ private:
 
     FirmwareImage*                  _image;
 
+    typedef struct {
+        uint32_t boardId;
+        uint32_t flashSize;
+    } BatchBoardInfo_t;
+
+    /// Batch flashing of all boards plugged in
+    PX4FirmwareBatchFlasher*            _batchFlasher;
+    FirmwareIdentifier                  _batchFirmwareId;
+    QString                             _batchFirmwareUrl;  ///< Same firmware for all boards, empty to pick it by board id
+    QHash<QString, FirmwareImage*>      _batchImages;       ///< Loaded images by url, decompressed once and shared by all boards
+    QHash<QString, QStringList>         _batchDownloads;    ///< Ports waiting for the download of an url
+    QHash<QString, BatchBoardInfo_t>    _batchBoardInfo;    ///< Bootloader information by port
+
     QString _px4StableVersion;  // Version strange for latest PX4 stable
     QString _px4BetaVersion;    // Version strange for latest PX4 beta
 
@@ -0,0 +1,346 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/// @file
+///     @brief Flashes several boards at once, each one on its own thread.
+
+#include "PX4FirmwareBatchFlasher.h"
+#include "Bootloader.h"
+#include "FirmwareImage.h"
+#include "QmlObjectListModel.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QThread>
+
+PX4FirmwareBatchBoard::PX4FirmwareBatchBoard(const QString& portName, const QString& boardName, QObject* parent)
+    : QObject   (parent)
+    , _portName (portName)
+    , _boardName(boardName)
+{
+
+}
+
+void PX4FirmwareBatchBoard::setBoardId(int boardId)
+{
+    if (boardId != _boardId) {
+        _boardId = boardId;
+        emit changed();
+    }
+}
+
+void PX4FirmwareBatchBoard::setStatus(const QString& status)
+{
+    if (status != _status) {
+        _status = status;
+        emit changed();
+    }
+}
+
+void PX4FirmwareBatchBoard::setProgress(double progress)
+{
+    if (!qFuzzyCompare(progress, _progress)) {
+        _progress = progress;
+        emit changed();
+    }
+}
+
+void PX4FirmwareBatchBoard::setFinished(bool failed)
+{
+    _finished = true;
+    _failed = failed;
+    emit changed();
+}
+
+PX4FirmwareBatchWorker::PX4FirmwareBatchWorker(const QString& portName, bool sikRadio)
+    : _portName (portName)
+    , _sikRadio (sikRadio)
+{
+
+}
+
+void PX4FirmwareBatchWorker::open(void)
+{
+    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareBatchWorker::open" << _portName;
+
+    // Created here so that the serial port lives on the worker thread
+    _bootloader = new Bootloader(_sikRadio, this);
+    connect(_bootloader, &Bootloader::updateProgress, this, &PX4FirmwareBatchWorker::updateProgress);
+
+    uint32_t bootloaderVersion;
+    uint32_t boardId;
+    uint32_t flashSize;
+    if (!_bootloader->open(_portName) || !_bootloader->getBoardInfo(bootloaderVersion, boardId, flashSize)) {
+        emit error(_bootloader->errorString());
+        _close(false);
+        return;
+    }
+
+    emit foundBoardInfo(bootloaderVersion, boardId, flashSize);
+}
+
+void PX4FirmwareBatchWorker::flash(const FirmwareImage* image)
+{
+    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareBatchWorker::flash" << _portName;
+
+    if (!_bootloader) {
+        return;
+    }
+
+    if (!_bootloader->initFlashSequence()) {
+        _fail();
+        return;
+    }
+
+    emit status(tr("Erasing previous program..."));
+    if (!_bootloader->erase()) {
+        _fail();
+        return;
+    }
+
+    emit status(tr("Programming new version..."));
+    if (!_bootloader->program(image)) {
+        _fail();
+        return;
+    }
+
+    emit status(tr("Verifying program..."));
+    if (!_bootloader->verify(image)) {
+        _fail();
+        return;
+    }
+
+    emit status(tr("Rebooting board"));
+    _close(true);
+    emit flashComplete();
+}
+
+void PX4FirmwareBatchWorker::cancel(void)
+{
+    qCDebug(FirmwareUpgradeVerboseLog) << "PX4FirmwareBatchWorker::cancel" << _portName;
+    if (_bootloader) {
+        _close(true);
+    }
+}
+
+void PX4FirmwareBatchWorker::_fail(void)
+{
+    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareBatchWorker flash failed" << _portName << _bootloader->errorString();
+    emit error(_bootloader->errorString());
+    _close(true);
+}
+
+void PX4FirmwareBatchWorker::_close(bool reboot)
+{
+    if (reboot) {
+        _bootloader->reboot();
+    }
+    _bootloader->close();
+    _bootloader->deleteLater();
+    _bootloader = nullptr;
+}
+
+PX4FirmwareBatchFlasher::PX4FirmwareBatchFlasher(QObject* parent)
+    : QObject   (parent)
+    , _boards   (new QmlObjectListModel(this))
+{
+    _findBoardTimer.setInterval(_findBoardIntervalMsecs);
+    connect(&_findBoardTimer, &QTimer::timeout, this, &PX4FirmwareBatchFlasher::_findBoards);
+}
+
+PX4FirmwareBatchFlasher::~PX4FirmwareBatchFlasher()
+{
+    for (const Port_t& port: _ports) {
+        // Queued behind a running flash, so a board is never left half programmed
+        QMetaObject::invokeMethod(port.worker, [worker = port.worker]() {
+            worker->cancel();
+            QThread::currentThread()->quit();
+        });
+        port.thread->wait();
+        delete port.worker;
+        delete port.thread;
+    }
+}
+
+void PX4FirmwareBatchFlasher::start(void)
+{
+    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareBatchFlasher::start";
+
+    // Boards from the last batch which are still being flashed stay in the list
+    QObjectList unfinishedBoards;
+    for (int i=0; i<_boards->count(); i++) {
+        PX4FirmwareBatchBoard* board = _boards->value<PX4FirmwareBatchBoard*>(i);
+        if (!board->finished()) {
+            unfinishedBoards.append(board);
+        }
+    }
+    QmlObjectListModel::deleteLaterBatch(_boards->applyObjectList(unfinishedBoards));
+
+    _skipPorts.clear();
+    for (const QGCSerialPortInfo& info: QGCSerialPortInfo::availablePorts()) {
+        if (info.canFlash() && !_ports.contains(info.portName())) {
+            _skipPorts += info.portName();
+        }
+    }
+
+    _findBoardTimer.start();
+    emit activeChanged(true);
+}
+
+void PX4FirmwareBatchFlasher::addBoard(const QString& portName)
+{
+    if (_ports.contains(portName)) {
+        return;
+    }
+
+    for (const QGCSerialPortInfo& info: QGCSerialPortInfo::availablePorts()) {
+        if (info.portName() == portName) {
+            _skipPorts.remove(portName);
+            _addPort(info);
+            return;
+        }
+    }
+}
+
+void PX4FirmwareBatchFlasher::stop(void)
+{
+    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareBatchFlasher::stop";
+
+    if (!_findBoardTimer.isActive()) {
+        return;
+    }
+    _findBoardTimer.stop();
+    emit activeChanged(false);
+
+    // Boards which are still waiting for an image are released, the ones being flashed run to the end
+    QStringList waitingPorts;
+    for (auto it = _ports.cbegin(); it != _ports.cend(); it++) {
+        if (!it.value().flashing) {
+            waitingPorts += it.key();
+        }
+    }
+    for (const QString& portName: waitingPorts) {
+        fail(portName, tr("Batch stopped"));
+    }
+}
+
+void PX4FirmwareBatchFlasher::flash(const QString& portName, const FirmwareImage* image)
+{
+    if (!_ports.contains(portName)) {
+        return;
+    }
+
+    Port_t& port = _ports[portName];
+    port.flashing = true;
+    port.board->setStatus(tr("Flashing"));
+    QMetaObject::invokeMethod(port.worker, [worker = port.worker, image]() { worker->flash(image); });
+}
+
+void PX4FirmwareBatchFlasher::fail(const QString& portName, const QString& errorString)
+{
+    _finishPort(portName, false, errorString);
+}
+
+void PX4FirmwareBatchFlasher::_findBoards(void)
+{
+    QSet<QString> flashablePorts;
+
+    for (const QGCSerialPortInfo& info: QGCSerialPortInfo::availablePorts()) {
+        if (!info.canFlash()) {
+            continue;
+        }
+        flashablePorts += info.portName();
+        if (!_skipPorts.contains(info.portName()) && !_ports.contains(info.portName())) {
+            _addPort(info);
+        }
+    }
+
+    // A skipped port which went away is flashed the next time a board shows up on it
+    _skipPorts.intersect(flashablePorts);
+}
+
+void PX4FirmwareBatchFlasher::_addPort(const QGCSerialPortInfo& portInfo)
+{
+    const QString portName = portInfo.portName();
+
+    QGCSerialPortInfo::BoardType_t  boardType;
+    QString                         boardName;
+    portInfo.getBoardInfo(boardType, boardName);
+
+    qCDebug(FirmwareUpgradeLog) << "PX4FirmwareBatchFlasher found board" << portName << boardName;
+
+    // A new board on a port replaces the entry of the last board flashed there
+    for (int i=0; i<_boards->count(); i++) {
+        if (_boards->value<PX4FirmwareBatchBoard*>(i)->portName() == portName) {
+            _boards->removeAt(i)->deleteLater();
+            break;
+        }
+    }
+
+    Port_t port;
+    port.flashing = false;
+    port.board  = new PX4FirmwareBatchBoard(portName, boardName, _boards);
+    port.worker = new PX4FirmwareBatchWorker(portName, boardType == QGCSerialPortInfo::BoardTypeSiKRadio);
+    port.thread = new QThread(this);
+    port.worker->moveToThread(port.thread);
+    port.board->setStatus(tr("Connecting to bootloader"));
+    _boards->append(port.board);
+    _ports[portName] = port;
+
+    PX4FirmwareBatchBoard* board = port.board;
+    connect(port.worker, &PX4FirmwareBatchWorker::foundBoardInfo, this, [this, portName, board](int bootloaderVersion, int boardID, int flashSize) {
+        board->setBoardId(boardID);
+        board->setStatus(tr("Waiting for firmware"));
+        emit foundBoardInfo(portName, bootloaderVersion, boardID, flashSize);
+    });
+    connect(port.worker, &PX4FirmwareBatchWorker::updateProgress, this, [board](int curr, int total) {
+        // Take care of cases where 0 / 0 is emitted as error return value
+        if (total > 0) {
+            board->setProgress(static_cast<double>(curr) / static_cast<double>(total));
+        }
+    });
+    connect(port.worker, &PX4FirmwareBatchWorker::status, this, [this, portName, board](const QString& statusText) {
+        board->setStatus(statusText);
+        emit status(portName, statusText);
+    });
+    connect(port.worker, &PX4FirmwareBatchWorker::error, this, [this, portName](const QString& errorString) {
+        _finishPort(portName, false, errorString);
+    });
+    connect(port.worker, &PX4FirmwareBatchWorker::flashComplete, this, [this, portName]() {
+        _finishPort(portName, true, tr("Upgrade complete"));
+    });
+
+    port.thread->start();
+    QMetaObject::invokeMethod(port.worker, [worker = port.worker]() { worker->open(); });
+}
+
+void PX4FirmwareBatchFlasher::_finishPort(const QString& portName, bool success, const QString& statusText)
+{
+    if (!_ports.contains(portName)) {
+        return;
+    }
+
+    const Port_t port = _ports.take(portName);
+    port.board->setStatus(statusText);
+    port.board->setFinished(!success);
+
+    // The rebooted board comes back on the same port, it must not be flashed again until it is unplugged
+    _skipPorts += portName;
+
+    // Reboots a board which is still held in its bootloader, then ends the thread
+    connect(port.thread, &QThread::finished, port.worker, &QObject::deleteLater);
+    connect(port.thread, &QThread::finished, port.thread, &QObject::deleteLater);
+    QMetaObject::invokeMethod(port.worker, [worker = port.worker]() {
+        worker->cancel();
+        QThread::currentThread()->quit();
+    });
+
+    emit status(portName, statusText);
+    emit boardFinished(portName, success);
+}
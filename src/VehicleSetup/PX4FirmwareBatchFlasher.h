@@ -0,0 +1,168 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/// @file
+///     @brief Flashes several boards at once, each one on its own thread.
+
+#pragma once
+
+#include "QGCSerialPortInfo.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+
+class Bootloader;
+class FirmwareImage;
+class QmlObjectListModel;
+class QThread;
+
+/// Flash state of a single board in a batch, shown per port in the ui
+class PX4FirmwareBatchBoard : public QObject
+{
+    Q_OBJECT
+
+public:
+    PX4FirmwareBatchBoard(const QString& portName, const QString& boardName, QObject* parent = nullptr);
+
+    Q_PROPERTY(QString  portName    READ portName   CONSTANT)
+    Q_PROPERTY(QString  boardName   READ boardName  CONSTANT)
+    Q_PROPERTY(int      boardId     READ boardId    NOTIFY changed)
+    Q_PROPERTY(QString  status      READ status     NOTIFY changed)
+    Q_PROPERTY(double   progress    READ progress   NOTIFY changed)     ///< 0 to 1
+    Q_PROPERTY(bool     finished    READ finished   NOTIFY changed)
+    Q_PROPERTY(bool     failed      READ failed     NOTIFY changed)
+
+    QString portName    (void) const { return _portName; }
+    QString boardName   (void) const { return _boardName; }
+    int     boardId     (void) const { return _boardId; }
+    QString status      (void) const { return _status; }
+    double  progress    (void) const { return _progress; }
+    bool    finished    (void) const { return _finished; }
+    bool    failed      (void) const { return _failed; }
+
+    void setBoardId     (int boardId);
+    void setStatus      (const QString& status);
+    void setProgress    (double progress);
+    void setFinished    (bool failed);
+
+signals:
+    void changed(void);
+
+private:
+    QString _portName;
+    QString _boardName;
+    int     _boardId    = 0;
+    QString _status;
+    double  _progress   = 0;
+    bool    _finished   = false;
+    bool    _failed     = false;
+};
+
+/// Runs the bootloader commands for a single port on its own thread. Only used by PX4FirmwareBatchFlasher.
+class PX4FirmwareBatchWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    PX4FirmwareBatchWorker(const QString& portName, bool sikRadio);
+
+    /// Connects to the bootloader and signals foundBoardInfo
+    void open(void);
+
+    /// Erases, programs and verifies the board, then reboots it. The image is only read so it can be shared
+    /// with the workers of the other ports.
+    void flash(const FirmwareImage* image);
+
+    /// Reboots the board if it is not being flashed yet
+    void cancel(void);
+
+signals:
+    void foundBoardInfo (int bootloaderVersion, int boardID, int flashSize);
+    void updateProgress (int curr, int total);
+    void status         (const QString& statusText);
+    void error          (const QString& errorString);
+    void flashComplete  (void);
+
+private:
+    void _fail(void);
+    void _close(bool reboot);
+
+    QString     _portName;
+    bool        _sikRadio;
+    Bootloader* _bootloader = nullptr;
+};
+
+/// Watches the serial ports for boards which enter their bootloader and flashes all of them concurrently.
+/// Boards which are already plugged in when the batch starts are skipped until they are plugged in again,
+/// since the bootloader only runs for a short time after power up.
+///
+/// The flasher does not pick the firmware: it signals foundBoardInfo for each board and the client calls
+/// flash (or fail) for that port once it has an image for the board id.
+class PX4FirmwareBatchFlasher : public QObject
+{
+    Q_OBJECT
+
+public:
+    PX4FirmwareBatchFlasher(QObject* parent = nullptr);
+    ~PX4FirmwareBatchFlasher();
+
+    /// List of PX4FirmwareBatchBoard, one for each board found since the batch started
+    QmlObjectListModel* boards(void) { return _boards; }
+
+    /// @return true: watching for new boards
+    bool active(void) const { return _findBoardTimer.isActive(); }
+
+    /// @return true: a board is still being flashed
+    bool busy(void) const { return !_ports.isEmpty(); }
+
+    /// Starts watching for boards. Clears the board list of the previous batch.
+    void start(void);
+
+    /// Adds a board which is already connected and held in its bootloader
+    void addBoard(const QString& portName);
+
+    /// Stops watching for new boards. Boards which are being flashed are finished.
+    void stop(void);
+
+    /// Flashes the board on the specified port. The image must stay valid until the board is finished.
+    void flash(const QString& portName, const FirmwareImage* image);
+
+    /// Gives up on the board on the specified port
+    void fail(const QString& portName, const QString& errorString);
+
+signals:
+    void foundBoardInfo (const QString& portName, int bootloaderVersion, int boardID, int flashSize);
+    void status         (const QString& portName, const QString& statusText);
+    void boardFinished  (const QString& portName, bool success);
+    void activeChanged  (bool active);
+
+private slots:
+    void _findBoards(void);
+
+private:
+    typedef struct {
+        PX4FirmwareBatchWorker* worker;
+        QThread*                thread;
+        PX4FirmwareBatchBoard*  board;
+        bool                    flashing;   ///< false: still waiting for an image
+    } Port_t;
+
+    void _addPort   (const QGCSerialPortInfo& portInfo);
+    void _finishPort(const QString& portName, bool success, const QString& statusText);
+
+    QmlObjectListModel*     _boards;
+    QHash<QString, Port_t>  _ports;         ///< Ports which are being flashed, by port name
+    QSet<QString>           _skipPorts;     ///< Ports which must go away before they are flashed
+    QTimer                  _findBoardTimer;
+
+    static constexpr int _findBoardIntervalMsecs = 500;
+};
@@ -28,6 +28,8 @@ PX4FirmwareUpgradeThreadWorker::PX4FirmwareUpgradeThreadWorker(PX4FirmwareUpgrad
     connect(_controller, &PX4FirmwareUpgradeThreadController::_flashOnThread,               this, &PX4FirmwareUpgradeThreadWorker::_flash);
     connect(_controller, &PX4FirmwareUpgradeThreadController::_rebootOnThread,              this, &PX4FirmwareUpgradeThreadWorker::_reboot);
     connect(_controller, &PX4FirmwareUpgradeThreadController::_cancel,                      this, &PX4FirmwareUpgradeThreadWorker::_cancel);
+    // Blocking so the port is closed by the time releaseBoard returns
+    connect(_controller, &PX4FirmwareUpgradeThreadController::_releaseOnThread,             this, &PX4FirmwareUpgradeThreadWorker::_release, Qt::BlockingQueuedConnection);
 }
 
 PX4FirmwareUpgradeThreadWorker::~PX4FirmwareUpgradeThreadWorker()
@@ -56,6 +58,18 @@ void PX4FirmwareUpgradeThreadWorker::_cancel(void)
     }
 }
 
+void PX4FirmwareUpgradeThreadWorker::_release(void)
+{
+    qCDebug(FirmwareUpgradeVerboseLog) << "_release";
+    _findBoardTimer->stop();
+    if (_bootloader) {
+        // The bootloader stays running once it has seen a command, no reboot so the board stays there
+        _bootloader->close();
+        _bootloader->deleteLater();
+        _bootloader = nullptr;
+    }
+}
+
 void PX4FirmwareUpgradeThreadWorker::_startFindBoardLoop(void)
 {
     _foundBoard = false;
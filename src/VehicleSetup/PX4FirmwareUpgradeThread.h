@@ -57,6 +57,7 @@ private slots:
     void _findBoardOnce     (void);
     void _updateProgress    (int curr, int total) { emit updateProgress(curr, total); }
     void _cancel            (void);
+    void _release           (void);
     
 private:
     bool _findBoardFromPorts(QGCSerialPortInfo& portInfo, QGCSerialPortInfo::BoardType_t& boardType, QString& boardName);
@@ -94,6 +95,10 @@ public:
     
     void flash(const FirmwareImage* image);
     
+    /// @brief Stops the board search and closes the connection to the bootloader without rebooting the board, so
+    /// it stays in the bootloader and can be flashed by someone else. Must not be called while flashing.
+    void releaseBoard(void) { emit _releaseOnThread(); }
+    
     const FirmwareImage* image(void) { return _image; }
     
 signals:
@@ -114,6 +119,7 @@ signals:
     void _rebootOnThread            (void);
     void _flashOnThread             (void);
     void _cancel                    (void);
+    void _releaseOnThread           (void);
     
 private slots:
     void _foundBoard            (bool firstAttempt, const QGCSerialPortInfo& portInfo, int type, QString name) { emit foundBoard(firstAttempt, portInfo, type, name); }
@@ -332,6 +332,7 @@ Rectangle {
         function setSource(source, vehicleComponent) {
             panelLoader.source = ""
             panelLoader.vehicleComponent = vehicleComponent
+            QGroundControl.qmlLoadStarted(panelLoader)
             panelLoader.source = source
         }
 
@@ -342,5 +343,7 @@ Rectangle {
         }
 
         property var vehicleComponent
+
+        onLoaded: QGroundControl.qmlLoadFinished(panelLoader)
     }
 }
@@ -21,15 +21,321 @@
 #include "FactValueGrid.h"
 #include "HorizontalFactValueGrid.h"
 #include "InstrumentValueData.h"
+#include "SettingsManager.h"
+#include "VideoSettings.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QDateTime>
-#include <QtCore/QString>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
+#include <QtCore/QWaitCondition>
+
+#include <cmath>
 
 QGC_LOGGING_CATEGORY(SubtitleWriterLog, "qgc.videomanager.subtitlewriter")
 
+/// Formats the telemetry samples and writes them to the subtitle and sidecar files. Samples are queued in a
+/// bounded ring buffer, if the disk can't keep up the oldest samples are dropped instead of blocking the GUI thread.
+class SubtitleFileWriter : public QThread
+{
+public:
+    SubtitleFileWriter(const QList<SubtitleWriter::Column_t>& columns, int subtitlePeriodMSecs, QObject* parent = nullptr)
+        : QThread(parent)
+        , _columns(columns)
+        , _subtitlePeriodMSecs(subtitlePeriodMSecs)
+    {
+        _samples.resize(_kMaxSamples);
+    }
+
+    ~SubtitleFileWriter()
+    {
+        stop();
+    }
+
+    bool open(const QString& subtitleFilePath, const QString& sidecarFilePath)
+    {
+        _subtitleFile.setFileName(subtitleFilePath);
+        if (!_subtitleFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(SubtitleWriterLog) << "Unable to write subtitle data to file" << subtitleFilePath;
+            return false;
+        }
+        _writeSubtitleHeader();
+
+        if (!sidecarFilePath.isEmpty()) {
+            _sidecarFile.setFileName(sidecarFilePath);
+            if (_sidecarFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                _writeSidecarHeader();
+            } else {
+                qCWarning(SubtitleWriterLog) << "Unable to write telemetry sidecar to file" << sidecarFilePath;
+            }
+        }
+
+        return true;
+    }
+
+    /// Queues a sample, called from the GUI thread
+    void push(SubtitleWriter::Sample_t&& sample)
+    {
+        QMutexLocker lock(&_samplesMutex);
+        if (_sampleCount == _kMaxSamples) {
+            // Overwrite the oldest sample
+            _firstSample = (_firstSample + 1) % _kMaxSamples;
+            _sampleCount--;
+            _droppedSamples++;
+        }
+        _samples[(_firstSample + _sampleCount) % _kMaxSamples] = std::move(sample);
+        _sampleCount++;
+        _samplesAvailable.wakeOne();
+    }
+
+    /// Writes the queued samples and closes the files
+    void stop()
+    {
+        if (!isRunning()) {
+            return;
+        }
+        {
+            QMutexLocker lock(&_samplesMutex);
+            _stopRequested = true;
+            _samplesAvailable.wakeOne();
+        }
+        wait();
+    }
+
+protected:
+    void run() override
+    {
+        QList<SubtitleWriter::Sample_t> samples;
+
+        while (true) {
+            bool stopRequested;
+            {
+                QMutexLocker lock(&_samplesMutex);
+                while (_sampleCount == 0 && !_stopRequested) {
+                    _samplesAvailable.wait(&_samplesMutex);
+                }
+                stopRequested = _stopRequested;
+                samples.reserve(_sampleCount);
+                for (; _sampleCount > 0; _sampleCount--) {
+                    samples.append(std::move(_samples[_firstSample]));
+                    _firstSample = (_firstSample + 1) % _kMaxSamples;
+                }
+            }
+
+            for (const SubtitleWriter::Sample_t& sample : samples) {
+                _writeSample(sample);
+            }
+            samples.clear();
+
+            if (stopRequested) {
+                break;
+            }
+        }
+
+        if (_droppedSamples > 0) {
+            qCWarning(SubtitleWriterLog) << "Dropped telemetry samples while writing:" << _droppedSamples;
+        }
+        _subtitleFile.close();
+        _sidecarFile.close();
+    }
+
+private:
+    void _writeSubtitleHeader()
+    {
+        QTextStream stream(&_subtitleFile);
+
+        // This is file header
+        stream << QStringLiteral(
+            "[Script Info]\n"
+            "Title: QGroundControl Subtitle Telemetry file\n"
+            "ScriptType: v4.00+\n"
+            "WrapStyle: 0\n"
+            "ScaledBorderAndShadow: yes\n"
+            "YCbCr Matrix: TV.601\n"
+            "PlayResX: 1920\n"
+            "PlayResY: 1080\n"
+            "\n"
+            "[V4+ Styles]\n"
+            "Format: Name, Fontname, Fontsize, PrimaryColour, SecondaryColour, OutlineColour, BackColour, Bold, Italic, Underline, StrikeOut, ScaleX, ScaleY, Spacing, Angle, BorderStyle, Outline, Shadow, Alignment, MarginL, MarginR, MarginV, Encoding\n"
+            "Style: Default,Monospace,30,&H00FFFFFF,&H000000FF,&H00000000,&H00000000,0,0,0,0,100,100,0,0,1,2,2,1,10,10,10,1\n"
+            "\n"
+            "[Events]\n"
+            "Format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text\n"
+        );
+
+        // TODO: Find a good way to input title
+        //stream << QStringLiteral("Dialogue: 0,0:00:00.00,999:00:00.00,Default,,0,0,0,,{\\pos(5,35)}%1\n");
+    }
+
+    void _writeSidecarHeader()
+    {
+        QStringList header = { QStringLiteral("pts_ms"), QStringLiteral("utc_ms") };
+        for (const SubtitleWriter::Column_t& column : _columns) {
+            QString name = column.units.isEmpty() ? column.name : QStringLiteral("%1 (%2)").arg(column.name, column.units);
+            header << QStringLiteral("\"%1\"").arg(name.replace(QLatin1Char('"'), QStringLiteral("\"\"")));
+        }
+
+        QTextStream stream(&_sidecarFile);
+        stream << header.join(QLatin1Char(',')) << '\n';
+    }
+
+    void _writeSample(const SubtitleWriter::Sample_t& sample)
+    {
+        if (_sidecarFile.isOpen()) {
+            _writeSidecarSample(sample);
+        }
+
+        // The subtitles keep their own rate, one subtitle always starts where the previous ended
+        if (sample.ptsMSecs >= _nextSubtitleMSecs) {
+            const qint64 end = sample.ptsMSecs + _subtitlePeriodMSecs;
+            _writeSubtitleSample(sample, _lastEndMSecs, end);
+            _lastEndMSecs = end;
+            _nextSubtitleMSecs = sample.ptsMSecs + _subtitlePeriodMSecs;
+        }
+    }
+
+    void _writeSidecarSample(const SubtitleWriter::Sample_t& sample)
+    {
+        QStringList fields = { QString::number(sample.ptsMSecs), QString::number(sample.utcMSecs) };
+        for (int i = 0; i < _columns.count() && i < sample.values.count(); i++) {
+            const SubtitleWriter::Column_t& column = _columns[i];
+            const QVariant& value = sample.values[i];
+
+            switch (column.type) {
+            case FactMetaData::valueTypeFloat:
+            case FactMetaData::valueTypeDouble:
+            case FactMetaData::valueTypeElapsedTimeInSeconds:
+            {
+                // Full precision, empty for NaN so the column stays numeric
+                const double dValue = value.toDouble();
+                fields << (std::isnan(dValue) ? QString() : QString::number(dValue, 'g', 10));
+            }
+                break;
+            case FactMetaData::valueTypeBool:
+                fields << QString::number(value.toBool() ? 1 : 0);
+                break;
+            case FactMetaData::valueTypeString:
+                fields << QStringLiteral("\"%1\"").arg(value.toString().replace(QLatin1Char('"'), QStringLiteral("\"\"")));
+                break;
+            default:
+                fields << value.toString();
+                break;
+            }
+        }
+
+        QTextStream stream(&_sidecarFile);
+        stream << fields.join(QLatin1Char(',')) << '\n';
+    }
+
+    void _writeSubtitleSample(const SubtitleWriter::Sample_t& sample, qint64 startMSecs, qint64 endMSecs)
+    {
+        static const float nRows = 3; // number of rows used for displaying data
+        static const int offsetFactor = 700; // Used to simulate a larger resolution and reduce the borders in the layout
+
+        // Each list corresponds to a column in the subtitles
+        QStringList namesStrings;
+        QStringList valuesStrings;
+
+        // Make a list of "factname:" strings and other with the values, so one can be aligned left and the other right
+        for (int i = 0; i < _columns.count() && i < sample.values.count(); i++) {
+            valuesStrings << QStringLiteral("%2 %3").arg(_valueString(_columns[i], sample.values[i]))
+                                                    .arg(_columns[i].units);
+            namesStrings << QStringLiteral("%1:").arg(_columns[i].name);
+        }
+
+        // The times to start and stop displaying this subtitle text
+        const QString start = QTime(0, 0).addMSecs(startMSecs).toString("H:mm:ss.zzz").chopped(2);
+        const QString end = QTime(0, 0).addMSecs(endMSecs).toString("H:mm:ss.zzz").chopped(2);
+
+        // This splits the screen in N parts and uses the N-1 internal parts to align the subtitles to.
+        // Should we try to get the resolution from the pipeline? This seems to work fine with other resolutions too.
+        static const int rowWidth = (1920 + offsetFactor)/(nRows+1);
+        int nValuesByRow = ceil(_columns.length() / nRows);
+
+        QStringList stringColumns;
+
+        // These templates are used for the data columns, one right-aligned for names and one for
+        // the facts values. The arguments expected are: start time, end time, xposition, and string content.
+        QString namesLine = QStringLiteral("Dialogue: 0,%2,%3,Default,,0,0,0,,{\\an3\\pos(%1,1075)}%4\n");
+        QString valuesLine = QStringLiteral("Dialogue: 0,%2,%3,Default,,0,0,0,,{\\pos(%1,1075)}%4\n");
+
+        // Split values into N columns and create a subtitle entry for each column
+        for (int i=0; i<nRows; i++) {
+            QStringList currentColumnNameStrings = namesStrings.mid((i)*nValuesByRow, nValuesByRow);
+            QStringList currentColumnValueStrings = valuesStrings.mid((i)*nValuesByRow, nValuesByRow);
+
+            // Fill templates for names of column i
+            QString names = namesLine.arg(-offsetFactor/2 + rowWidth*(i+1) - 10)
+                                     .arg(start)
+                                     .arg(end)
+                                     .arg(currentColumnNameStrings.join("\\N"));
+            stringColumns << names;
+
+            // Fill templates for values of column i
+            QString values = valuesLine.arg(-offsetFactor/2 +rowWidth*(i+1))
+                                       .arg(start)
+                                       .arg(end)
+                                       .arg(currentColumnValueStrings.join("\\N"));
+            stringColumns << values;
+        }
+
+        // Write the date to the corner
+        stringColumns << QStringLiteral("Dialogue: 0,%1,%2,Default,,0,0,0,,{\\pos(10,35)}%3\n")
+            .arg(start)
+            .arg(end)
+            .arg(QDateTime::fromMSecsSinceEpoch(sample.utcMSecs).toString(QLocale::system().dateFormat(QLocale::ShortFormat)));
+        // Write new data
+        QTextStream stream(&_subtitleFile);
+        for (const auto& i : stringColumns) {
+            stream << i;
+        }
+    }
+
+    /// Same formatting as Fact::cookedValueString
+    static QString _valueString(const SubtitleWriter::Column_t& column, const QVariant& value)
+    {
+        switch (column.type) {
+        case FactMetaData::valueTypeFloat:
+        case FactMetaData::valueTypeDouble:
+        {
+            const double dValue = value.toDouble();
+            return std::isnan(dValue) ? QStringLiteral("--.--") : QString("%1").arg(dValue, 0, 'f', column.decimalPlaces);
+        }
+        case FactMetaData::valueTypeBool:
+            return value.toBool() ? Fact::tr("true") : Fact::tr("false");
+        case FactMetaData::valueTypeElapsedTimeInSeconds:
+        {
+            const double dValue = value.toDouble();
+            return std::isnan(dValue) ? QStringLiteral("--:--:--") : QTime(0, 0, 0, 0).addSecs(dValue).toString(QStringLiteral("hh:mm:ss"));
+        }
+        default:
+            return value.toString();
+        }
+    }
+
+    const QList<SubtitleWriter::Column_t> _columns;
+    const int _subtitlePeriodMSecs;
+    QFile _subtitleFile;
+    QFile _sidecarFile;
+    qint64 _lastEndMSecs = 0;
+    qint64 _nextSubtitleMSecs = 0;
+
+    QMutex _samplesMutex;
+    QWaitCondition _samplesAvailable;
+    QList<SubtitleWriter::Sample_t> _samples;
+    int _firstSample = 0;
+    int _sampleCount = 0;
+    quint64 _droppedSamples = 0;
+    bool _stopRequested = false;
+
+    static constexpr int _kMaxSamples = 256;
+};
+
 SubtitleWriter::SubtitleWriter(QObject* parent)
     : QObject(parent)
     , _timer(new QTimer(this))
@@ -42,10 +348,14 @@ SubtitleWriter::SubtitleWriter(QObject* parent)
 SubtitleWriter::~SubtitleWriter()
 {
     // qCDebug(SubtitleWriterLog) << Q_FUNC_INFO << this;
+
+    stopCapturingTelemetry();
 }
 
 void SubtitleWriter::startCapturingTelemetry(const QString& videoFile)
 {
+    stopCapturingTelemetry();
+
     // Delete facts of last run
     _facts.clear();
 
@@ -63,123 +373,60 @@ void SubtitleWriter::startCapturingTelemetry(const QString& videoFile)
     }
     grid->deleteLater();
 
-    // One subtitle always starts where the previous ended
-    _lastEndTime = QTime(0, 0);
+    // Everything the writer thread needs to format a value is taken now, it never touches the facts
+    QList<Column_t> columns;
+    for (Fact* fact : _facts) {
+        columns.append({ fact->shortDescription(), fact->cookedUnits(), fact->type(), fact->decimalPlaces() });
+    }
+
+    const bool sidecar = qgcApp()->toolbox()->settingsManager()->videoSettings()->recordTelemetrySidecar()->rawValue().toBool();
 
     QFileInfo videoFileInfo(videoFile);
     QString subtitleFilePath = QStringLiteral("%1/%2.ass").arg(videoFileInfo.path(), videoFileInfo.completeBaseName());
-    qCDebug(SubtitleWriterLog) << "Writing overlay to file:" << subtitleFilePath;
-    _file.setFileName(subtitleFilePath);
+    QString sidecarFilePath = sidecar ? QStringLiteral("%1/%2.csv").arg(videoFileInfo.path(), videoFileInfo.completeBaseName()) : QString();
+    qCDebug(SubtitleWriterLog) << "Writing overlay to file:" << subtitleFilePath << sidecarFilePath;
 
-    if (!_file.open(QIODevice::ReadWrite)) {
-        qCWarning(SubtitleWriterLog) << "Unable to write subtitle data to file";
+    _fileWriter = new SubtitleFileWriter(columns, 1000/_sampleRate);
+    if (!_fileWriter->open(subtitleFilePath, sidecarFilePath)) {
+        delete _fileWriter;
+        _fileWriter = nullptr;
         return;
     }
+    _fileWriter->start(QThread::LowPriority);
 
-    QTextStream stream( &_file );
-
-    // This is file header
-    stream << QStringLiteral(
-        "[Script Info]\n"
-        "Title: QGroundControl Subtitle Telemetry file\n"
-        "ScriptType: v4.00+\n"
-        "WrapStyle: 0\n"
-        "ScaledBorderAndShadow: yes\n"
-        "YCbCr Matrix: TV.601\n"
-        "PlayResX: 1920\n"
-        "PlayResY: 1080\n"
-        "\n"
-        "[V4+ Styles]\n"
-        "Format: Name, Fontname, Fontsize, PrimaryColour, SecondaryColour, OutlineColour, BackColour, Bold, Italic, Underline, StrikeOut, ScaleX, ScaleY, Spacing, Angle, BorderStyle, Outline, Shadow, Alignment, MarginL, MarginR, MarginV, Encoding\n"
-        "Style: Default,Monospace,30,&H00FFFFFF,&H000000FF,&H00000000,&H00000000,0,0,0,0,100,100,0,0,1,2,2,1,10,10,10,1\n"
-        "\n"
-        "[Events]\n"
-        "Format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text\n"
-    );
-
-    // TODO: Find a good way to input title
-    //stream << QStringLiteral("Dialogue: 0,0:00:00.00,999:00:00.00,Default,,0,0,0,,{\\pos(5,35)}%1\n");
-
-    _timer->start(1000/_sampleRate);
+    // Called as the recording starts, so this matches the timestamps of the recorded video
+    _recordingTime.start();
+    _timer->start(1000/(sidecar ? _sidecarSampleRate : _sampleRate));
 }
 
 void SubtitleWriter::stopCapturingTelemetry()
 {
-    qCDebug(SubtitleWriterLog) << "Stopping writing";
     _timer->stop();
-    _file.close();
+    if (_fileWriter) {
+        qCDebug(SubtitleWriterLog) << "Stopping writing";
+        _fileWriter->stop();
+        delete _fileWriter;
+        _fileWriter = nullptr;
+    }
 }
 
 void SubtitleWriter::_captureTelemetry()
 {
-    static const float nRows = 3; // number of rows used for displaying data
-    static const int offsetFactor = 700; // Used to simulate a larger resolution and reduce the borders in the layout
-
     auto *vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
 
     if (!vehicle) {
         qCWarning(SubtitleWriterLog) << "Attempting to capture fact data with no active vehicle!";
         return;
     }
-    // Each list corresponds to a column in the subtitles
-    QStringList namesStrings;
-    QStringList valuesStrings;
 
-    // Make a list of "factname:" strings and other with the values, so one can be aligned left and the other right
+    // Only the values are copied here, the formatting is left to the writer thread
+    Sample_t sample;
+    sample.ptsMSecs = _recordingTime.elapsed();
+    sample.utcMSecs = QDateTime::currentMSecsSinceEpoch();
+    sample.values.reserve(_facts.count());
     for (const Fact* fact : _facts) {
-        valuesStrings << QStringLiteral("%2 %3").arg(fact->cookedValueString())
-                                                .arg(fact->cookedUnits());
-        namesStrings << QStringLiteral("%1:").arg(fact->shortDescription());
-    }
-
-    // The time to start displaying this subtitle text
-    QTime start = _lastEndTime;
-
-    // The time to stop displaying this subtitle text
-    QTime end = start.addMSecs(1000/_sampleRate);
-    _lastEndTime = end;
-
-    // This splits the screen in N parts and uses the N-1 internal parts to align the subtitles to.
-    // Should we try to get the resolution from the pipeline? This seems to work fine with other resolutions too.
-    static const int rowWidth = (1920 + offsetFactor)/(nRows+1);
-    int nValuesByRow = ceil(_facts.length() / nRows);
-
-    QList<QStringList> dataColumns;
-    QStringList stringColumns;
-
-    // These templates are used for the data columns, one right-aligned for names and one for
-    // the facts values. The arguments expected are: start time, end time, xposition, and string content.
-    QString namesLine = QStringLiteral("Dialogue: 0,%2,%3,Default,,0,0,0,,{\\an3\\pos(%1,1075)}%4\n");
-    QString valuesLine = QStringLiteral("Dialogue: 0,%2,%3,Default,,0,0,0,,{\\pos(%1,1075)}%4\n");
-
-    // Split values into N columns and create a subtitle entry for each column
-    for (int i=0; i<nRows; i++) {
-        QStringList currentColumnNameStrings = namesStrings.mid((i)*nValuesByRow, nValuesByRow);
-        QStringList currentColumnValueStrings = valuesStrings.mid((i)*nValuesByRow, nValuesByRow);
-
-        // Fill templates for names of column i
-        QString names = namesLine.arg(-offsetFactor/2 + rowWidth*(i+1) - 10)
-                                 .arg(start.toString("H:mm:ss.zzz").chopped(2))
-                                 .arg(end.toString("H:mm:ss.zzz").chopped(2))
-                                 .arg(currentColumnNameStrings.join("\\N"));
-        stringColumns << names;
-
-        // Fill templates for values of column i
-        QString values = valuesLine.arg(-offsetFactor/2 +rowWidth*(i+1))
-                                   .arg(start.toString("H:mm:ss.zzz").chopped(2))
-                                   .arg(end.toString("H:mm:ss.zzz").chopped(2))
-                                   .arg(currentColumnValueStrings.join("\\N"));
-        stringColumns << values;
-    }
-
-    // Write the date to the corner
-    stringColumns << QStringLiteral("Dialogue: 0,%1,%2,Default,,0,0,0,,{\\pos(10,35)}%3\n")
-        .arg(start.toString("H:mm:ss.zzz").chopped(2))
-        .arg(end.toString("H:mm:ss.zzz").chopped(2))
-        .arg(QDateTime::currentDateTime().toString(QLocale::system().dateFormat(QLocale::ShortFormat)));
-    // Write new data
-    QTextStream stream(&_file);
-    for (const auto& i : stringColumns) {
-        stream << i;
+        sample.values.append(fact->cookedValue());
     }
+
+    _fileWriter->push(std::move(sample));
 }
@@ -17,15 +17,19 @@
 #pragma once
 
 #include <QtCore/QObject>
-#include <QtCore/QTime>
-#include <QtCore/QFile>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
 
+#include "FactMetaData.h"
+
 class Fact;
 class QTimer;
+class SubtitleFileWriter;
 
 Q_DECLARE_LOGGING_CATEGORY(SubtitleWriterLog)
 
+/// Writes the telemetry bar values next to a video recording, as an ASS subtitle file and optionally as a CSV
+/// sidecar. The timer tick only snapshots the values, formatting and file writes happen on a writer thread.
 class SubtitleWriter : public QObject
 {
     Q_OBJECT
@@ -38,6 +42,21 @@ public:
     void startCapturingTelemetry(const QString &videoFile);
     void stopCapturingTelemetry();
 
+    /// How a column of the telemetry is formatted, taken once from its Fact when capturing starts
+    typedef struct {
+        QString                     name;
+        QString                     units;
+        FactMetaData::ValueType_t   type;
+        int                         decimalPlaces;
+    } Column_t;
+
+    /// Telemetry values at one tick
+    typedef struct {
+        qint64          ptsMSecs;       ///< Time since the recording started, matches the video timestamps
+        qint64          utcMSecs;
+        QVariantList    values;         ///< Cooked values in column order
+    } Sample_t;
+
 private slots:
     // Captures a snapshot of telemetry data from vehicle into the subtitles file.
     void _captureTelemetry();
@@ -45,8 +64,9 @@ private slots:
 private:
     QTimer* _timer = nullptr;
     QList<Fact*> _facts;
-    QTime _lastEndTime;
-    QFile _file;
+    QElapsedTimer _recordingTime;
+    SubtitleFileWriter* _fileWriter = nullptr;
 
     static constexpr int _sampleRate = 1; // Sample rate in Hz for getting telemetry data, most players do weird stuff when > 1Hz
+    static constexpr int _sidecarSampleRate = 10; // Sample rate in Hz of the CSV sidecar, every _sidecarSampleRate / _sampleRate sample goes to the subtitles
 };
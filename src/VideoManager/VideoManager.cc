@@ -19,8 +19,10 @@
 #include "VideoReceiver.h"
 #include "VideoSettings.h"
 #include "SubtitleWriter.h"
+#include "VideoMetadataWriter.h"
 #ifdef QGC_GST_STREAMING
 #include "GStreamer.h"
+#include "GstVideoWallReceiver.h"
 #include "VideoDecoderOptions.h"
 #else
 #include "GLVideoItemStub.h"
@@ -44,13 +46,15 @@ QGC_LOGGING_CATEGORY(VideoManagerLog, "qgc.videomanager.videomanager")
 static constexpr const char* kFileExtension[VideoReceiver::FILE_FORMAT_MAX - VideoReceiver::FILE_FORMAT_MIN] = {
     "mkv",
     "mov",
-    "mp4"
+    "mp4",
+    "ts"
 };
 
 //-----------------------------------------------------------------------------
 VideoManager::VideoManager(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
     , _subtitleWriter(new SubtitleWriter(this))
+    , _metadataWriter(new VideoMetadataWriter(this))
 {
 #ifdef QGC_GST_STREAMING
     // Gstreamer debug settings
@@ -75,6 +79,13 @@ VideoManager::VideoManager(QGCApplication* app, QGCToolbox* toolbox)
 //-----------------------------------------------------------------------------
 VideoManager::~VideoManager()
 {
+#ifdef QGC_GST_STREAMING
+    delete _videoWallReceiver;
+    _videoWallReceiver = nullptr;
+    GStreamer::releaseVideoSink(_videoWallSink);
+    _videoWallSink = nullptr;
+#endif
+
     for (VideoReceiverData &videoReceiver : _videoReceiverData) {
         if (videoReceiver.receiver != nullptr) {
             delete videoReceiver.receiver;
@@ -114,6 +125,8 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
    connect(_videoSettings->tcpUrl(),        &Fact::rawValueChanged, this, &VideoManager::_videoSourceChanged);
    connect(_videoSettings->aspectRatio(),   &Fact::rawValueChanged, this, &VideoManager::aspectRatioChanged);
    connect(_videoSettings->lowLatencyMode(),&Fact::rawValueChanged, this, &VideoManager::_lowLatencyModeChanged);
+   // The pre-roll is set up when the stream starts
+   connect(_videoSettings->recordingPreRoll(), &Fact::rawValueChanged, this, &VideoManager::_restartAllVideos);
    MultiVehicleManager *pVehicleMgr = _toolbox->multiVehicleManager();
    connect(pVehicleMgr, &MultiVehicleManager::activeVehicleChanged, this, &VideoManager::_setActiveVehicle);
 
@@ -126,6 +139,10 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
         videoReceiver.receiver = toolbox->corePlugin()->createVideoReceiver(this);
         videoReceiver.index = index;
         index++;
+
+        if (videoReceiver.receiver != nullptr) {
+            (void) connect(_metadataWriter, &VideoMetadataWriter::metadataPacket, videoReceiver.receiver, &VideoReceiver::writeMetadata);
+        }
     }
 
     if (_videoReceiverData[0].receiver != nullptr) {
@@ -170,11 +187,23 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
             emit decodingChanged();
         });
 
+        (void) connect(_videoReceiverData[0].receiver, &VideoReceiver::latencyStatsChanged, this, [this](double jitterMSecs, double decodeMSecs, double frameAgeMSecs, quint64 droppedFrames){
+            _videoJitter = jitterMSecs;
+            _videoDecodeTime = decodeMSecs;
+            _videoFrameAge = frameAgeMSecs;
+            _videoDroppedFrames = droppedFrames;
+            emit latencyStatsChanged();
+        });
+
+        (void) connect(_videoReceiverData[0].receiver, &VideoReceiver::stalled,            this, &VideoManager::_videoStalled);
+        (void) connect(_videoReceiverData[0].receiver, &VideoReceiver::frameLossChanged,   this, &VideoManager::_videoFrameLossChanged);
+
         (void) connect(_videoReceiverData[0].receiver, &VideoReceiver::recordingChanged, this, [this](bool active){
             qCDebug(VideoManagerLog) << "Video 0 recording changed, active: " << (active ? "yes" : "no");
             _recording = active;
             if (!active) {
                 _subtitleWriter->stopCapturingTelemetry();
+                _metadataWriter->stopCapturingMetadata();
             }
             emit recordingChanged();
         });
@@ -182,6 +211,9 @@ VideoManager::setToolbox(QGCToolbox *toolbox)
         (void) connect(_videoReceiverData[0].receiver, &VideoReceiver::recordingStarted, this, [this](){
             qCDebug(VideoManagerLog) << "Video 0 recording started";
             _subtitleWriter->startCapturingTelemetry(_videoFile);
+            if (_recordingMetadata) {
+                _metadataWriter->startCapturingMetadata();
+            }
         });
 
         (void) connect(_videoReceiverData[0].receiver, &VideoReceiver::videoSizeChanged, this, [this](QSize size){
@@ -335,9 +367,12 @@ VideoManager::startRecording(const QString& videoFile)
     const QString videoFile2 = _videoFile + "2." + ext;
     _videoFile += ext;
 
+    _recordingMetadata = (fileFormat == VideoReceiver::FILE_FORMAT_TS) && _videoSettings->recordVideoMetadata()->rawValue().toBool();
+
     const QStringList videoFiles = {_videoFile, videoFile2};
     for (VideoReceiverData &videoReceiver : _videoReceiverData) {
         if (videoReceiver.receiver && videoReceiver.started) {
+            videoReceiver.receiver->setRecordingMetadata(_recordingMetadata);
             videoReceiver.receiver->startRecording(videoFiles.at(videoReceiver.index), fileFormat);
         }
     }
@@ -378,6 +413,114 @@ VideoManager::grabImage(const QString& imageFile)
     _videoReceiverData[0].receiver->takeScreenshot(_imageFile);
 }
 
+//-----------------------------------------------------------------------------
+void
+VideoManager::startVideoWall(QQuickItem* widget, const QStringList& uris, int columns)
+{
+#ifdef QGC_GST_STREAMING
+    if (_app->runningUnitTests() || widget == nullptr) {
+        return;
+    }
+
+    if (_videoWallReceiver == nullptr) {
+        _videoWallReceiver = GStreamer::createVideoWallReceiver(this);
+
+        (void) connect(_videoWallReceiver, &GstVideoWallReceiver::onStartWallComplete, this, [this](VideoReceiver::STATUS status) {
+            qCDebug(VideoManagerLog) << "Video wall start complete, status: " << status;
+            _videoWallActive = (status == VideoReceiver::STATUS_OK);
+            emit videoWallActiveChanged();
+        });
+
+        (void) connect(_videoWallReceiver, &GstVideoWallReceiver::onStopWallComplete, this, [this](VideoReceiver::STATUS status) {
+            qCDebug(VideoManagerLog) << "Video wall stop complete, status: " << status;
+            _videoWallActive = false;
+            emit videoWallActiveChanged();
+        });
+
+        (void) connect(_videoWallReceiver, &GstVideoWallReceiver::wallStreamChanged, this, &VideoManager::videoWallStreamChanged);
+    }
+
+    // The sink is bound to its video item, a different item needs a new sink
+    if (_videoWallSink != nullptr) {
+        _videoWallReceiver->stopWall();
+        GStreamer::releaseVideoSink(_videoWallSink);
+        _videoWallSink = nullptr;
+    }
+
+    if ((_videoWallSink = GStreamer::createVideoSink(this, widget)) == nullptr) {
+        qCWarning(VideoManagerLog) << "createVideoSink() failed for the video wall";
+        return;
+    }
+
+    _videoWallReceiver->setWallSize(QSize(static_cast<int>(widget->width()), static_cast<int>(widget->height())));
+    _videoWallReceiver->startWall(uris, _videoWallSink, columns, _videoSettings->rtspTimeout()->rawValue().toUInt());
+#else
+    Q_UNUSED(widget)
+    Q_UNUSED(uris)
+    Q_UNUSED(columns)
+    qCWarning(VideoManagerLog) << "Video wall requires GStreamer";
+#endif
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoManager::stopVideoWall()
+{
+#ifdef QGC_GST_STREAMING
+    if (_videoWallReceiver != nullptr) {
+        _videoWallReceiver->stopWall();
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+void
+VideoManager::setVideoWallSize(int width, int height)
+{
+#ifdef QGC_GST_STREAMING
+    if (_videoWallReceiver != nullptr) {
+        _videoWallReceiver->setWallSize(QSize(width, height));
+    }
+#else
+    Q_UNUSED(width)
+    Q_UNUSED(height)
+#endif
+}
+
+//-----------------------------------------------------------------------------
+QStringList
+VideoManager::vehicleVideoUris() const
+{
+    QStringList uris;
+
+    QmlObjectListModel* const vehicles = _toolbox->multiVehicleManager()->vehicles();
+    for (int i = 0; i < vehicles->count(); i++) {
+        Vehicle* const vehicle = qobject_cast<Vehicle*>(vehicles->get(i));
+        if (vehicle == nullptr || vehicle->cameraManager() == nullptr) {
+            continue;
+        }
+
+        const QGCVideoStreamInfo* const pInfo = vehicle->cameraManager()->currentStreamInstance();
+        if (pInfo == nullptr || pInfo->uri().isEmpty()) {
+            continue;
+        }
+
+        switch (pInfo->type()) {
+            case VIDEO_STREAM_TYPE_RTPUDP:
+                uris.append(pInfo->uri().contains("udp://") ? pInfo->uri() : QStringLiteral("udp://0.0.0.0:%1").arg(pInfo->uri()));
+                break;
+            case VIDEO_STREAM_TYPE_MPEG_TS:
+                uris.append(QStringLiteral("mpegts://0.0.0.0:%1").arg(pInfo->uri()));
+                break;
+            default:
+                uris.append(pInfo->uri());
+                break;
+        }
+    }
+
+    return uris;
+}
+
 //-----------------------------------------------------------------------------
 double VideoManager::aspectRatio() const
 {
@@ -826,6 +969,7 @@ VideoManager::_startReceiver(unsigned id)
         return;
     }
 
+    _videoReceiverData[id].receiver->setRecordingPreRoll(_videoSettings->recordingPreRoll()->rawValue().toUInt());
     _videoReceiverData[id].receiver->start(_videoReceiverData[id].uri, timeout, _videoReceiverData[id].lowLatencyStreaming ? -1 : 0);
 }
 
@@ -861,6 +1005,7 @@ VideoManager::_setActiveVehicle(Vehicle* vehicle)
         }
     }
 
+    _resetStreamAdaption();
     _activeVehicle = vehicle;
     if(_activeVehicle) {
         connect(_activeVehicle->vehicleLinkManager(), &VehicleLinkManager::communicationLostChanged, this, &VideoManager::_communicationLostChanged);
@@ -888,3 +1033,129 @@ VideoManager::_communicationLostChanged(bool connectionLost)
     }
 }
 
+//----------------------------------------------------------------------------------------
+void
+VideoManager::_videoStalled()
+{
+    // MAVLink has no keyframe request. Starting the stream again makes most camera servers send one, the receiver
+    // itself asks through RTCP where the source supports it.
+    if(_activeVehicle && _activeVehicle->cameraManager()) {
+        MavlinkCameraControl* const pCamera = _activeVehicle->cameraManager()->currentCameraInstance();
+        if(pCamera && pCamera->autoStream()) {
+            qCDebug(VideoManagerLog) << "Video 0 stalled, restarting camera stream";
+            pCamera->resumeStream();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/// Steps down to a lower quality stream of the camera after a few seconds of heavy frame loss, and back towards the
+/// stream selected before once the video has been clean for a while.
+void
+VideoManager::_videoFrameLossChanged(double lossPercent)
+{
+    if(!_videoSettings->adaptiveStreamQuality()->rawValue().toBool() || !_activeVehicle || !_activeVehicle->cameraManager()) {
+        return;
+    }
+    MavlinkCameraControl* const pCamera = _activeVehicle->cameraManager()->currentCameraInstance();
+    if(!pCamera || !pCamera->autoStream() || (pCamera->streams()->count() < 2)) {
+        return;
+    }
+
+    const int currentStream = pCamera->currentStream();
+    if((_adaptedStream >= 0) && (currentStream != _adaptedStream)) {
+        // Selected by the user since, which is the quality to return to from now on
+        _resetStreamAdaption();
+    }
+
+    if(lossPercent >= _kHighLossPercent) {
+        _cleanIntervals = 0;
+        if(++_lossIntervals < _kStepDownIntervals) {
+            return;
+        }
+        _lossIntervals = 0;
+        const int lowerStream = _adjacentStream(pCamera, true);
+        if(lowerStream >= 0) {
+            qCDebug(VideoManagerLog) << "Video frame loss" << lossPercent << "%, switching to lower quality stream" << lowerStream;
+            if(_preferredStream < 0) {
+                _preferredStream = currentStream;
+            }
+            _adaptedStream = lowerStream;
+            pCamera->setCurrentStream(lowerStream);
+        }
+    } else if(lossPercent < _kLowLossPercent) {
+        _lossIntervals = 0;
+        if((_preferredStream < 0) || (++_cleanIntervals < _kStepUpIntervals)) {
+            return;
+        }
+        _cleanIntervals = 0;
+        const int higherStream = _adjacentStream(pCamera, false);
+        if(higherStream >= 0) {
+            qCDebug(VideoManagerLog) << "Video clean, switching to higher quality stream" << higherStream;
+            _adaptedStream = higherStream;
+            if(higherStream == _preferredStream) {
+                _preferredStream = -1;
+                _adaptedStream = -1;
+            }
+            pCamera->setCurrentStream(higherStream);
+        } else {
+            _resetStreamAdaption();
+        }
+    } else {
+        _lossIntervals = 0;
+        _cleanIntervals = 0;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void
+VideoManager::_resetStreamAdaption()
+{
+    _lossIntervals = 0;
+    _cleanIntervals = 0;
+    _preferredStream = -1;
+    _adaptedStream = -1;
+}
+
+//----------------------------------------------------------------------------------------
+/// @return Index of the stream next below (lower) or above the current one by resolution then bitrate, not going above
+/// the stream selected before stepping down. Thermal streams are skipped. -1 if there is none.
+int
+VideoManager::_adjacentStream(MavlinkCameraControl* camera, bool lower) const
+{
+    const QGCVideoStreamInfo* const pCurrent = camera->currentStreamInstance();
+    if(!pCurrent) {
+        return -1;
+    }
+
+    const auto quality = [](const QGCVideoStreamInfo* pInfo) {
+        return (static_cast<quint64>(pInfo->resolution().width()) * static_cast<quint64>(pInfo->resolution().height()) << 32) | pInfo->bitrate();
+    };
+
+    quint64 limit = std::numeric_limits<quint64>::max();
+    if(!lower && (_preferredStream >= 0) && (_preferredStream < camera->streams()->count())) {
+        limit = quality(camera->streams()->value<QGCVideoStreamInfo*>(_preferredStream));
+    }
+
+    const quint64 currentQuality = quality(pCurrent);
+    int best = -1;
+    quint64 bestQuality = 0;
+    for(int i = 0; i < camera->streams()->count(); i++) {
+        const QGCVideoStreamInfo* const pInfo = camera->streams()->value<QGCVideoStreamInfo*>(i);
+        if(!pInfo || (pInfo == pCurrent) || (pInfo->isThermal() != pCurrent->isThermal())) {
+            continue;
+        }
+        const quint64 streamQuality = quality(pInfo);
+        if(lower) {
+            if((streamQuality < currentQuality) && ((best < 0) || (streamQuality > bestQuality))) {
+                best = i;
+                bestQuality = streamQuality;
+            }
+        } else if((streamQuality > currentQuality) && (streamQuality <= limit) && ((best < 0) || (streamQuality < bestQuality))) {
+            best = i;
+            bestQuality = streamQuality;
+        }
+    }
+    return best;
+}
+
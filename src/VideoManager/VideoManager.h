@@ -11,6 +11,7 @@
 #pragma once
 
 #include <QtCore/QSize>
+#include <QtCore/QStringList>
 #include <QtCore/QRunnable>
 #include <QtCore/QLoggingCategory>
 
@@ -25,10 +26,15 @@ class Vehicle;
 class Joystick;
 class VideoReceiver;
 class SubtitleWriter;
+class VideoMetadataWriter;
+class GstVideoWallReceiver;
+class QQuickItem;
+class MavlinkCameraControl;
 
 class VideoManager : public QGCTool
 {
     Q_OBJECT
+    Q_MOC_INCLUDE(<QtQuick/QQuickItem>)
 
     Q_PROPERTY(bool             hasVideo                READ    hasVideo                                    NOTIFY hasVideoChanged)
     Q_PROPERTY(bool             isStreamSource          READ    isStreamSource                              NOTIFY isStreamSourceChanged)
@@ -49,6 +55,11 @@ class VideoManager : public QGCTool
     Q_PROPERTY(bool             decoding                READ    decoding                                    NOTIFY decodingChanged)
     Q_PROPERTY(bool             recording               READ    recording                                   NOTIFY recordingChanged)
     Q_PROPERTY(QSize            videoSize               READ    videoSize                                   NOTIFY videoSizeChanged)
+    Q_PROPERTY(bool             videoWallActive         READ    videoWallActive                             NOTIFY videoWallActiveChanged)
+    Q_PROPERTY(double           videoJitter             READ    videoJitter                                 NOTIFY latencyStatsChanged)
+    Q_PROPERTY(double           videoDecodeTime         READ    videoDecodeTime                             NOTIFY latencyStatsChanged)
+    Q_PROPERTY(double           videoFrameAge           READ    videoFrameAge                               NOTIFY latencyStatsChanged)
+    Q_PROPERTY(quint64          videoDroppedFrames      READ    videoDroppedFrames                          NOTIFY latencyStatsChanged)
 
 public:
     VideoManager(QGCApplication* app, QGCToolbox* toolbox);
@@ -74,6 +85,12 @@ public:
     bool recording() const { return _recording; }
     QSize videoSize() const { return QSize((_videoSize >> 16) & 0xFFFF, _videoSize & 0xFFFF); }
 
+    /// Latency stats of the primary stream, in milliseconds
+    double videoJitter() const { return _videoJitter; }
+    double videoDecodeTime() const { return _videoDecodeTime; }
+    double videoFrameAge() const { return _videoFrameAge; }
+    quint64 videoDroppedFrames() const { return _videoDroppedFrames; }
+
     virtual bool gstreamerEnabled() const;
     virtual bool uvcEnabled() const;
     virtual bool qtmultimediaEnabled() const;
@@ -88,6 +105,17 @@ public:
 
     Q_INVOKABLE void grabImage(const QString& imageFile = QString());
 
+    /// Decodes several streams in one pipeline and composites them into the video item as a grid of tiles
+    ///     @param columns Tiles per row, 0 picks the squarest layout
+    Q_INVOKABLE void startVideoWall(QQuickItem* widget, const QStringList& uris, int columns = 0);
+    Q_INVOKABLE void stopVideoWall();
+    /// Size the wall is shown at, the composited frame and the tiles are scaled to it
+    Q_INVOKABLE void setVideoWallSize(int width, int height);
+    /// @return Primary stream of every vehicle which reports one through its camera manager
+    Q_INVOKABLE QStringList vehicleVideoUris() const;
+
+    bool videoWallActive() const { return _videoWallActive; }
+
 signals:
     void hasVideoChanged            ();
     void isStreamSourceChanged      ();
@@ -103,6 +131,9 @@ signals:
     void recordingChanged           ();
     void recordingStarted           ();
     void videoSizeChanged           ();
+    void latencyStatsChanged        ();
+    void videoWallActiveChanged     ();
+    void videoWallStreamChanged     (int index, bool active);
 
 protected slots:
     void _videoSourceChanged        ();
@@ -110,6 +141,8 @@ protected slots:
     bool _updateUVC                 ();
     void _setActiveVehicle          (Vehicle* vehicle);
     void _communicationLostChanged  (bool communicationLost);
+    void _videoStalled              ();
+    void _videoFrameLossChanged     (double lossPercent);
 
 protected:
     friend class FinishVideoInitialization;
@@ -122,10 +155,14 @@ protected:
     void _restartVideo    (unsigned id);
     void _startReceiver   (unsigned id);
     void _stopReceiver    (unsigned id);
+    void _resetStreamAdaption();
+    int  _adjacentStream  (MavlinkCameraControl* camera, bool lower) const;
 
     QString                 _videoFile;
     QString                 _imageFile;
     SubtitleWriter*         _subtitleWriter = nullptr;
+    VideoMetadataWriter*    _metadataWriter = nullptr;
+    bool                    _recordingMetadata = false;
 
     struct VideoReceiverData {
         VideoReceiver* receiver = nullptr;
@@ -146,10 +183,28 @@ protected:
     QAtomicInteger<bool>    _decoding               = false;
     QAtomicInteger<bool>    _recording              = false;
     QAtomicInteger<quint32> _videoSize              = 0;
+    GstVideoWallReceiver*   _videoWallReceiver      = nullptr;
+    void*                   _videoWallSink          = nullptr;
+    bool                    _videoWallActive        = false;
+    double                  _videoJitter            = 0;
+    double                  _videoDecodeTime        = 0;
+    double                  _videoFrameAge          = 0;
+    quint64                 _videoDroppedFrames     = 0;
     VideoSettings*          _videoSettings          = nullptr;
     QString                 _uvcVideoSourceID;
     bool                    _fullScreen             = false;
     Vehicle*                _activeVehicle          = nullptr;
+
+    /// Stream quality adaption, see _videoFrameLossChanged
+    int                     _lossIntervals          = 0;    ///< Consecutive stats intervals with high frame loss
+    int                     _cleanIntervals         = 0;    ///< Consecutive stats intervals with almost no frame loss
+    int                     _preferredStream        = -1;   ///< Stream selected before stepping down, -1 if not stepped down
+    int                     _adaptedStream          = -1;   ///< Stream selected by the adaption, to notice a selection by the user
+
+    static constexpr double _kHighLossPercent       = 10;
+    static constexpr double _kLowLossPercent        = 1;
+    static constexpr int    _kStepDownIntervals     = 3;
+    static constexpr int    _kStepUpIntervals       = 30;
 };
 
 class FinishVideoInitialization : public QRunnable
@@ -0,0 +1,215 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+/**
+ * @file
+ *   @brief QGC Video Metadata Writer
+ */
+
+#include "VideoMetadataWriter.h"
+#include "QGCApplication.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "VehicleFactGroup.h"
+#include "GimbalController.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QTimer>
+#include <QtCore/QtEndian>
+
+#include <cmath>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(VideoMetadataWriterLog, "qgc.videomanager.videometadatawriter")
+
+namespace {
+
+// ST 0601 UAS Datalink Local Set universal key
+constexpr quint8 kUasLocalSetKey[16] = { 0x06, 0x0E, 0x2B, 0x34, 0x02, 0x0B, 0x01, 0x01, 0x0E, 0x01, 0x03, 0x01, 0x01, 0x00, 0x00, 0x00 };
+constexpr quint8 kLocalSetVersion = 17;
+
+enum Tag : quint8 {
+    TagChecksum                 = 1,
+    TagPrecisionTimeStamp       = 2,
+    TagPlatformHeading          = 5,
+    TagPlatformPitch            = 6,
+    TagPlatformRoll             = 7,
+    TagSensorLatitude           = 13,
+    TagSensorLongitude          = 14,
+    TagSensorTrueAltitude       = 15,
+    TagSensorRelativeAzimuth    = 18,
+    TagSensorRelativeElevation  = 19,
+    TagSensorRelativeRoll       = 20,
+    TagVersion                  = 65,
+};
+
+/// Appends a tag with a big endian integer value
+template<typename T>
+void appendItem(QByteArray& set, Tag tag, T value)
+{
+    set.append(static_cast<char>(tag));
+    set.append(static_cast<char>(sizeof(T)));
+    const T bigEndian = qToBigEndian(value);
+    set.append(reinterpret_cast<const char*>(&bigEndian), sizeof(T));
+}
+
+/// Maps value from [min, max] onto the unsigned integer range of T
+template<typename T>
+T mapUnsigned(double value, double min, double max)
+{
+    const double range = static_cast<double>(std::numeric_limits<T>::max());
+    return static_cast<T>(std::lround(qBound(0.0, (value - min) / (max - min), 1.0) * range));
+}
+
+/// Maps value from [-limit, limit] onto the signed integer range of T, the lowest value of T flags out of range
+template<typename T>
+T mapSigned(double value, double limit)
+{
+    if (std::isnan(value) || std::abs(value) > limit) {
+        return std::numeric_limits<T>::min();
+    }
+    return static_cast<T>(std::lround(value / limit * static_cast<double>(std::numeric_limits<T>::max())));
+}
+
+double wrap360(double degrees)
+{
+    degrees = std::fmod(degrees, 360.0);
+    return degrees < 0 ? degrees + 360.0 : degrees;
+}
+
+void appendBerLength(QByteArray& packet, int length)
+{
+    if (length < 128) {
+        packet.append(static_cast<char>(length));
+    } else {
+        // Long form, length of the length in the low bits
+        packet.append(static_cast<char>(0x82));
+        packet.append(static_cast<char>((length >> 8) & 0xFF));
+        packet.append(static_cast<char>(length & 0xFF));
+    }
+}
+
+quint16 checksum(const QByteArray& packet)
+{
+    quint16 bcc = 0;
+    for (int i = 0; i < packet.size(); i++) {
+        bcc += static_cast<quint8>(packet[i]) << (8 * ((i + 1) % 2));
+    }
+    return bcc;
+}
+
+}
+
+VideoMetadataWriter::VideoMetadataWriter(QObject* parent)
+    : QObject(parent)
+    , _timer(new QTimer(this))
+{
+    // qCDebug(VideoMetadataWriterLog) << Q_FUNC_INFO << this;
+
+    _timer->setTimerType(Qt::PreciseTimer);
+    (void) connect(_timer, &QTimer::timeout, this, &VideoMetadataWriter::_captureMetadata);
+}
+
+VideoMetadataWriter::~VideoMetadataWriter()
+{
+    // qCDebug(VideoMetadataWriterLog) << Q_FUNC_INFO << this;
+}
+
+void VideoMetadataWriter::startCapturingMetadata()
+{
+    qCDebug(VideoMetadataWriterLog) << "Starting metadata capture";
+    _timer->start(1000/_sampleRate);
+}
+
+void VideoMetadataWriter::stopCapturingMetadata()
+{
+    qCDebug(VideoMetadataWriterLog) << "Stopping metadata capture";
+    _timer->stop();
+}
+
+void VideoMetadataWriter::_captureMetadata()
+{
+    Vehicle* vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+
+    if (!vehicle) {
+        return;
+    }
+
+    const QByteArray klv = uasDatalinkLocalSet(vehicle, QDateTime::currentMSecsSinceEpoch() * 1000);
+    if (!klv.isEmpty()) {
+        emit metadataPacket(klv);
+    }
+}
+
+QByteArray VideoMetadataWriter::uasDatalinkLocalSet(Vehicle* vehicle, qint64 utcUSecs)
+{
+    const QGeoCoordinate coordinate = vehicle->coordinate();
+    if (!coordinate.isValid()) {
+        return QByteArray();
+    }
+
+    VehicleFactGroup* vehicleFacts = qobject_cast<VehicleFactGroup*>(vehicle->vehicleFactGroup());
+    if (!vehicleFacts) {
+        return QByteArray();
+    }
+
+    const double heading = vehicleFacts->heading()->rawValue().toDouble();
+    const double pitch = vehicleFacts->pitch()->rawValue().toDouble();
+    const double roll = vehicleFacts->roll()->rawValue().toDouble();
+    const double altitudeAMSL = vehicleFacts->altitudeAMSL()->rawValue().toDouble();
+
+    QByteArray set;
+    set.reserve(96);
+
+    // Precision time stamp must be the first item
+    appendItem<quint64>(set, TagPrecisionTimeStamp, static_cast<quint64>(utcUSecs));
+    if (!std::isnan(heading)) {
+        appendItem<quint16>(set, TagPlatformHeading, mapUnsigned<quint16>(wrap360(heading), 0, 360));
+    }
+    appendItem<qint16>(set, TagPlatformPitch, mapSigned<qint16>(pitch, 20));
+    appendItem<qint16>(set, TagPlatformRoll, mapSigned<qint16>(roll, 50));
+    appendItem<qint32>(set, TagSensorLatitude, mapSigned<qint32>(coordinate.latitude(), 90));
+    appendItem<qint32>(set, TagSensorLongitude, mapSigned<qint32>(coordinate.longitude(), 180));
+    if (!std::isnan(altitudeAMSL)) {
+        appendItem<quint16>(set, TagSensorTrueAltitude, mapUnsigned<quint16>(altitudeAMSL, -900, 19000));
+    }
+
+    // The sensor angles are relative to the platform
+    GimbalController* gimbalController = vehicle->gimbalController();
+    Gimbal* gimbal = gimbalController ? gimbalController->activeGimbal() : nullptr;
+    if (gimbal) {
+        const double bodyYaw = gimbal->bodyYaw()->rawValue().toDouble();
+        const double gimbalPitch = gimbal->absolutePitch()->rawValue().toDouble();
+        const double gimbalRoll = gimbal->absoluteRoll()->rawValue().toDouble();
+
+        if (!std::isnan(bodyYaw)) {
+            appendItem<quint32>(set, TagSensorRelativeAzimuth, mapUnsigned<quint32>(wrap360(bodyYaw), 0, 360));
+        }
+        if (!std::isnan(pitch) && !std::isnan(gimbalPitch)) {
+            appendItem<qint32>(set, TagSensorRelativeElevation, mapSigned<qint32>(gimbalPitch - pitch, 180));
+        }
+        if (!std::isnan(roll) && !std::isnan(gimbalRoll)) {
+            appendItem<quint32>(set, TagSensorRelativeRoll, mapUnsigned<quint32>(wrap360(gimbalRoll - roll), 0, 360));
+        }
+    }
+
+    appendItem<quint8>(set, TagVersion, kLocalSetVersion);
+
+    // The checksum covers the key, the length and every item up to its own value
+    QByteArray packet(reinterpret_cast<const char*>(kUasLocalSetKey), sizeof(kUasLocalSetKey));
+    appendBerLength(packet, set.size() + 4);
+    packet.append(set);
+    packet.append(static_cast<char>(TagChecksum));
+    packet.append(static_cast<char>(2));
+    const quint16 bcc = qToBigEndian(checksum(packet));
+    packet.append(reinterpret_cast<const char*>(&bcc), sizeof(bcc));
+
+    return packet;
+}
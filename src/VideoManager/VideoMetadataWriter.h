@@ -0,0 +1,52 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+/**
+ * @file
+ *   @brief QGC Video Metadata Writer
+ */
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+
+class QTimer;
+class Vehicle;
+
+Q_DECLARE_LOGGING_CATEGORY(VideoMetadataWriterLog)
+
+/// Samples the vehicle position, attitude and gimbal angles while recording and encodes them as MISB ST 0601 UAS
+/// Datalink Local Set KLV packets, which the video receivers mux next to the recorded video.
+class VideoMetadataWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VideoMetadataWriter(QObject* parent = nullptr);
+    ~VideoMetadataWriter();
+
+    void startCapturingMetadata();
+    void stopCapturingMetadata();
+
+    /// @return ST 0601 local set of the current vehicle state, empty without a vehicle position
+    static QByteArray uasDatalinkLocalSet(Vehicle* vehicle, qint64 utcUSecs);
+
+signals:
+    void metadataPacket(const QByteArray& klv);
+
+private slots:
+    void _captureMetadata();
+
+private:
+    QTimer* _timer = nullptr;
+
+    static constexpr int _sampleRate = 10; // Sample rate in Hz, the video rate isn't needed for photogrammetry
+};
@@ -16,6 +16,7 @@
 
 #include "GStreamer.h"
 #include "GstVideoReceiver.h"
+#include "GstVideoWallReceiver.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QDebug>
@@ -107,6 +108,29 @@ static void qgcputenv(const QString& key, const QString& root, const QString& pa
 }
 #endif
 
+static bool
+isHardwareVideoDecoder(GstElementFactory* factory)
+{
+    const gchar* klass = gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+    if (klass != nullptr && g_strrstr(klass, "Hardware") != nullptr) {
+        return true;
+    }
+
+    // Not every plugin tags its hardware decoders, MediaCodec elements are named after the codec instead
+    const gchar* name = GST_OBJECT_NAME(factory);
+    if (g_str_has_prefix(name, "amcviddec-")) {
+        return (g_strrstr(name, "omxgoogle") == nullptr) && (g_strrstr(name, "c2android") == nullptr);
+    }
+
+    for (const char* hardwareName : {"vaapih264dec", "vaapih265dec", "nvv4l2decoder", "v4l2h264dec", "v4l2h265dec", "vtdec_hw"}) {
+        if (g_strcmp0(name, hardwareName) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void
 GStreamer::blacklist(VideoDecoderOptions option)
 {
@@ -133,31 +157,54 @@ GStreamer::blacklist(VideoDecoderOptions option)
     // Set rank for specific features
     changeRank("bcmdec", GST_RANK_NONE);
 
+    // Hardware decoders go ahead of the software ones (avdec_* are primary), so decodebin3 only falls back to software
+    // decoding when no hardware decoder handles the stream. The forced decoders are ranked above this.
+    if (option != ForceVideoDecoderSoftware) {
+        GList* factories = gst_element_factory_list_get_elements(GST_ELEMENT_FACTORY_TYPE_DECODER | GST_ELEMENT_FACTORY_TYPE_MEDIA_VIDEO, GST_RANK_NONE);
+        for (GList* node = factories; node != nullptr; node = node->next) {
+            GstElementFactory* factory = GST_ELEMENT_FACTORY(node->data);
+            if (g_strcmp0(GST_OBJECT_NAME(factory), "bcmdec") == 0 || !isHardwareVideoDecoder(factory)) {
+                continue;
+            }
+            if (gst_plugin_feature_get_rank(GST_PLUGIN_FEATURE(factory)) < GST_RANK_PRIMARY + 1) {
+                changeRank(GST_OBJECT_NAME(factory), GST_RANK_PRIMARY + 1);
+            }
+        }
+        gst_plugin_feature_list_free(factories);
+    }
+
     switch (option) {
         case ForceVideoDecoderDefault:
             break;
         case ForceVideoDecoderSoftware:
             for(auto name : {"avdec_h264", "avdec_h265"}) {
-                changeRank(name, GST_RANK_PRIMARY + 1);
+                changeRank(name, GST_RANK_PRIMARY + 2);
             }
             break;
         case ForceVideoDecoderVAAPI:
-            for(auto name : {"vaapimpeg2dec", "vaapimpeg4dec", "vaapih263dec", "vaapih264dec", "vaapih265dec", "vaapivc1dec"}) {
-                changeRank(name, GST_RANK_PRIMARY + 1);
+            for(auto name : {"vaapimpeg2dec", "vaapimpeg4dec", "vaapih263dec", "vaapih264dec", "vaapih265dec", "vaapivc1dec", "vah264dec", "vah265dec", "vaav1dec", "vavp9dec"}) {
+                changeRank(name, GST_RANK_PRIMARY + 2);
             }
             break;
         case ForceVideoDecoderNVIDIA:
-            for(auto name : {"nvh265dec", "nvh265sldec", "nvh264dec", "nvh264sldec"}) {
-                changeRank(name, GST_RANK_PRIMARY + 1);
+            for(auto name : {"nvh265dec", "nvh265sldec", "nvh264dec", "nvh264sldec", "nvv4l2decoder"}) {
+                changeRank(name, GST_RANK_PRIMARY + 2);
             }
             break;
         case ForceVideoDecoderDirectX3D:
             for(auto name : {"d3d11vp9dec", "d3d11h265dec", "d3d11h264dec"}) {
-                changeRank(name, GST_RANK_PRIMARY + 1);
+                changeRank(name, GST_RANK_PRIMARY + 2);
             }
             break;
         case ForceVideoDecoderVideoToolbox:
-            changeRank("vtdec", GST_RANK_PRIMARY + 1);
+            for(auto name : {"vtdec_hw", "vtdec"}) {
+                changeRank(name, GST_RANK_PRIMARY + 2);
+            }
+            break;
+        case ForceVideoDecoderV4L2:
+            for(auto name : {"v4l2h264dec", "v4l2h265dec", "v4l2slh264dec", "v4l2slh265dec", "nvv4l2decoder"}) {
+                changeRank(name, GST_RANK_PRIMARY + 2);
+            }
             break;
         default:
             qCWarning(GStreamerLog) << "Can't handle decode option:" << option;
@@ -286,3 +333,10 @@ GStreamer::createVideoReceiver(QObject* parent)
     Q_UNUSED(parent)
     return new GstVideoReceiver(nullptr);
 }
+
+GstVideoWallReceiver*
+GStreamer::createVideoWallReceiver(QObject* parent)
+{
+    Q_UNUSED(parent)
+    return new GstVideoWallReceiver(nullptr);
+}
@@ -18,6 +18,7 @@ Q_DECLARE_LOGGING_CATEGORY(GStreamerLog)
 Q_DECLARE_LOGGING_CATEGORY(GStreamerAPILog)
 
 class VideoReceiver;
+class GstVideoWallReceiver;
 
 class GStreamer {
 public:
@@ -26,4 +27,5 @@ public:
     static void* createVideoSink(QObject* parent, QQuickItem* widget);
     static void releaseVideoSink(void* sink);
     static VideoReceiver* createVideoReceiver(QObject* parent);
+    static GstVideoWallReceiver* createVideoWallReceiver(QObject* parent);
 };
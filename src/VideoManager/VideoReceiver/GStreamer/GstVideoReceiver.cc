@@ -20,6 +20,7 @@
 #include <QtCore/QDebug>
 #include <QtCore/QUrl>
 #include <QtCore/QDateTime>
+#include <QtCore/QStringList>
 
 QGC_LOGGING_CATEGORY(VideoReceiverLog, "VideoReceiverLog")
 
@@ -33,6 +34,21 @@ QGC_LOGGING_CATEGORY(VideoReceiverLog, "VideoReceiverLog")
 //              +-->queue-->_recorderValve[-->_fileSink]
 //
 
+static void
+logDecoderOutputMemory(GstCaps* caps)
+{
+    GstCapsFeatures* features = (caps != nullptr && !gst_caps_is_empty(caps)) ? gst_caps_get_features(caps, 0) : nullptr;
+
+    // Only GL and DMABuf memory reach qml6glsink without being copied through system memory
+    if (features != nullptr && (gst_caps_features_contains(features, "memory:GLMemory") || gst_caps_features_contains(features, "memory:DMABuf"))) {
+        gchar* featuresString = gst_caps_features_to_string(features);
+        qCDebug(VideoReceiverLog) << "Decoder output is zero-copy:" << featuresString;
+        g_free(featuresString);
+    } else {
+        qCDebug(VideoReceiverLog) << "Decoder output is in system memory, frames are uploaded by glupload";
+    }
+}
+
 GstVideoReceiver::GstVideoReceiver(QObject* parent)
     : VideoReceiver(parent)
     , _streaming(false)
@@ -58,7 +74,8 @@ GstVideoReceiver::GstVideoReceiver(QObject* parent)
 {
     _slotHandler.start();
     connect(&_watchdogTimer, &QTimer::timeout, this, &GstVideoReceiver::_watchdog);
-    _watchdogTimer.start(1000);
+    // Short interval so a stall is noticed, and recovered from, well within a second
+    _watchdogTimer.start(_kWatchdogIntervalMSecs);
 }
 
 GstVideoReceiver::~GstVideoReceiver(void)
@@ -122,6 +139,7 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
         }
 
         _lastSourceFrameTime = 0;
+        _stalled = false;
 
         _teeProbeId = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _teeProbe, this, nullptr);
         gst_object_unref(pad);
@@ -151,6 +169,16 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
 
         g_object_set(_recorderValve, "drop", TRUE, nullptr);
 
+        if (_recordingPreRollSecs > 0) {
+            // Leak the oldest buffers once the pre-roll is held, instead of blocking the tee
+            g_object_set(recorderQueue,
+                         "leaky", 2 /* downstream */,
+                         "max-size-buffers", 0,
+                         "max-size-bytes", 0,
+                         "max-size-time", static_cast<guint64>(_recordingPreRollSecs) * GST_SECOND,
+                         nullptr);
+        }
+
         if ((_pipeline = gst_pipeline_new("receiver")) == nullptr) {
             qCCritical(VideoReceiverLog) << "gst_pipeline_new() failed";
             break;
@@ -202,6 +230,9 @@ GstVideoReceiver::start(const QString& uri, unsigned timeout, int buffer)
             break;
         }
 
+        _recorderQueue = recorderQueue;
+        _blockRecorderQueue();
+
         GstBus* bus = nullptr;
 
         if ((bus = gst_pipeline_get_bus(GST_PIPELINE(_pipeline))) != nullptr) {
@@ -351,11 +382,14 @@ GstVideoReceiver::stop(void)
         _pipeline = nullptr;
 
         _recorderValve = nullptr;
+        _recorderQueue = nullptr;
+        _preRollProbeId = 0;
         _decoderValve = nullptr;
         _tee = nullptr;
         _source = nullptr;
 
         _lastSourceFrameTime = 0;
+        _stalled = false;
 
         if (_streaming) {
             _streaming = false;
@@ -424,6 +458,7 @@ GstVideoReceiver::startDecoding(void* sink)
 
     _lastVideoFrameTime = 0;
     _resetVideoSink = true;
+    _resetLatencyStats();
 
     _videoSinkProbeId = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _videoSinkProbe, this, nullptr);
     gst_object_unref(pad);
@@ -563,11 +598,37 @@ GstVideoReceiver::startRecording(const QString& videoFile, FILE_FORMAT format)
     }
 
     gst_pad_add_probe(probepad, GST_PAD_PROBE_TYPE_BUFFER, _keyframeWatch, this, nullptr); // to drop the buffers until key frame is received
+
+    if (_metadataSource != nullptr) {
+        _recordingStartPts = GST_CLOCK_TIME_NONE;
+        _lastRecordedPts = GST_CLOCK_TIME_NONE;
+        _recordedFrameProbeId = gst_pad_add_probe(probepad, GST_PAD_PROBE_TYPE_BUFFER, _recordedFrameProbe, this, nullptr);
+    }
+
     gst_object_unref(probepad);
     probepad = nullptr;
 
     g_object_set(_recorderValve, "drop", FALSE, nullptr);
 
+    if (_preRollProbeId != 0) {
+        GstPad* queuePad;
+
+        if ((queuePad = gst_element_get_static_pad(_recorderQueue, "src")) != nullptr) {
+            // Once the queue leaked, the buffer held by the block is older than the rest of the pre-roll
+            guint64 levelTime = 0;
+            g_object_get(_recorderQueue, "current-level-time", &levelTime, nullptr);
+            _dropPreRollHead = levelTime >= static_cast<guint64>(_recordingPreRollSecs) * GST_SECOND;
+
+            gst_pad_remove_probe(queuePad, _preRollProbeId);
+            gst_object_unref(queuePad);
+            queuePad = nullptr;
+
+            qCDebug(VideoReceiverLog) << "Recording from pre-roll of" << GST_TIME_AS_MSECONDS(levelTime) << "ms" << _uri;
+        }
+
+        _preRollProbeId = 0;
+    }
+
     _recording = true;
     qCDebug(VideoReceiverLog) << "Recording started" << _uri;
     _dispatchSignal([this](){
@@ -600,6 +661,12 @@ GstVideoReceiver::stopRecording(void)
 
     g_object_set(_recorderValve, "drop", TRUE, nullptr);
 
+    // The mux only finishes the file once all of its streams ended
+    if (_metadataSource != nullptr) {
+        GstFlowReturn flowReturn;
+        g_signal_emit_by_name(_metadataSource, "end-of-stream", &flowReturn);
+    }
+
     _removingRecorder = true;
 
     bool ret = _unlinkBranch(_recorderValve);
@@ -628,10 +695,107 @@ GstVideoReceiver::takeScreenshot(const QString& imageFile)
     });
 }
 
+void
+GstVideoReceiver::setRecordingPreRoll(unsigned seconds)
+{
+    if (_needDispatch()) {
+        _slotHandler.dispatch([this, seconds]() {
+            setRecordingPreRoll(seconds);
+        });
+        return;
+    }
+
+    _recordingPreRollSecs = seconds;
+}
+
+void
+GstVideoReceiver::setFrameTap(const FrameTapConfig_t& config, FrameTapHandler handler)
+{
+    if (_needDispatch()) {
+        _slotHandler.dispatch([this, config, handler]() {
+            setFrameTap(config, handler);
+        });
+        return;
+    }
+
+    _frameTapConfig = config;
+    _frameTapHandler = handler;
+}
+
+void
+GstVideoReceiver::setRecordingMetadata(bool enabled)
+{
+    if (_needDispatch()) {
+        _slotHandler.dispatch([this, enabled]() {
+            setRecordingMetadata(enabled);
+        });
+        return;
+    }
+
+    _recordingMetadata = enabled;
+}
+
+void
+GstVideoReceiver::writeMetadata(const QByteArray& klv)
+{
+    if (_needDispatch()) {
+        QByteArray cachedKlv = klv;
+        _slotHandler.dispatch([this, cachedKlv]() {
+            writeMetadata(cachedKlv);
+        });
+        return;
+    }
+
+    if (_metadataSource == nullptr || !_recording || _removingRecorder) {
+        return;
+    }
+
+    const quint64 startPts = _recordingStartPts;
+    const quint64 lastPts = _lastRecordedPts;
+
+    // Nothing to attach the metadata to until the first keyframe was recorded
+    if (startPts == GST_CLOCK_TIME_NONE || lastPts == GST_CLOCK_TIME_NONE || lastPts < startPts) {
+        return;
+    }
+
+    GstBuffer* buffer = gst_buffer_new_allocate(nullptr, klv.size(), nullptr);
+    gst_buffer_fill(buffer, 0, klv.constData(), klv.size());
+    GST_BUFFER_PTS(buffer) = lastPts - startPts;
+    GST_BUFFER_DTS(buffer) = GST_BUFFER_PTS(buffer);
+
+    GstFlowReturn flowReturn;
+    g_signal_emit_by_name(_metadataSource, "push-buffer", buffer, &flowReturn);
+    gst_buffer_unref(buffer);
+
+    if (flowReturn != GST_FLOW_OK) {
+        qCDebug(VideoReceiverLog) << "Metadata buffer not written:" << gst_flow_get_name(flowReturn) << _uri;
+    }
+}
+
+void
+GstVideoReceiver::_blockRecorderQueue(void)
+{
+    if (_recordingPreRollSecs == 0 || _recorderQueue == nullptr || _preRollProbeId != 0) {
+        return;
+    }
+
+    GstPad* queuePad;
+
+    if ((queuePad = gst_element_get_static_pad(_recorderQueue, "src")) == nullptr) {
+        qCCritical(VideoReceiverLog) << "gst_element_get_static_pad() failed" << _uri;
+        return;
+    }
+
+    _preRollProbeId = gst_pad_add_probe(queuePad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM, _preRollBlock, this, nullptr);
+    gst_object_unref(queuePad);
+    queuePad = nullptr;
+}
+
 const char* GstVideoReceiver::_kFileMux[FILE_FORMAT_MAX - FILE_FORMAT_MIN] = {
     "matroskamux",
     "qtmux",
-    "mp4mux"
+    "mp4mux",
+    "mpegtsmux"
 };
 
 void
@@ -642,18 +806,26 @@ GstVideoReceiver::_watchdog(void)
             return;
         }
 
-        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
 
         if (_lastSourceFrameTime == 0) {
             _lastSourceFrameTime = now;
         }
 
-        if (now - _lastSourceFrameTime > _timeout) {
-            qCDebug(VideoReceiverLog) << "Stream timeout, no frames for " << now - _lastSourceFrameTime << "" << _uri;
+        const qint64 sourceIdleMSecs = now - _lastSourceFrameTime;
+        if (sourceIdleMSecs > static_cast<qint64>(_timeout) * 1000) {
+            qCDebug(VideoReceiverLog) << "Stream timeout, no frames for " << sourceIdleMSecs << "ms" << _uri;
             _dispatchSignal([this](){
                 emit timeout();
             });
             stop();
+        } else if (_streaming && (sourceIdleMSecs > _kStallMSecs) && _stalled.testAndSetRelaxed(false, true)) {
+            // Keep the pipeline for a short outage, the keyframe gets the decoder going again as soon as data is back
+            qCDebug(VideoReceiverLog) << "Stream stalled, no frames for " << sourceIdleMSecs << "ms" << _uri;
+            requestKeyframe();
+            _dispatchSignal([this](){
+                emit stalled();
+            });
         }
 
         if (_decoding && !_removingDecoder) {
@@ -661,12 +833,15 @@ GstVideoReceiver::_watchdog(void)
                 _lastVideoFrameTime = now;
             }
 
-            if (now - _lastVideoFrameTime > _timeout * 2) {
-                qCDebug(VideoReceiverLog) << "Video decoder timeout, no frames for " << now - _lastVideoFrameTime << " " << _uri;
+            if (now - _lastVideoFrameTime > static_cast<qint64>(_timeout) * 2000) {
+                qCDebug(VideoReceiverLog) << "Video decoder timeout, no frames for " << now - _lastVideoFrameTime << "ms" << _uri;
                 _dispatchSignal([this](){
                     emit timeout();
                 });
                 stop();
+            } else if (now - _lastLatencyStatsTime >= _kLatencyStatsIntervalMSecs) {
+                _lastLatencyStatsTime = now;
+                _emitLatencyStats();
             }
         }
     });
@@ -926,6 +1101,189 @@ GstVideoReceiver::_makeDecoder(GstCaps* caps, GstElement* videoSink)
     return decoder;
 }
 
+GstElement*
+GstVideoReceiver::_makeFrameTap(void)
+{
+    // queue-->videorate-->[glupload-->]convert-->scale-->capsfilter-->appsink
+    QList<GstElement*> elements;
+    GstCaps* caps = nullptr;
+    bool ok = false;
+
+    do {
+        GstElement* queue;
+
+        // Only the newest frame waits for the consumer
+        if ((queue = gst_element_factory_make("queue", nullptr)) == nullptr) {
+            qCCritical(VideoReceiverLog) << "gst_element_factory_make('queue') failed";
+            break;
+        }
+
+        elements << queue;
+
+        g_object_set(queue,
+                     "leaky", 2 /* downstream */,
+                     "max-size-buffers", 1,
+                     "max-size-bytes", 0,
+                     "max-size-time", (guint64) 0,
+                     nullptr);
+
+        GstElement* rate;
+
+        if ((rate = gst_element_factory_make("videorate", nullptr)) == nullptr) {
+            qCCritical(VideoReceiverLog) << "gst_element_factory_make('videorate') failed";
+            break;
+        }
+
+        elements << rate;
+
+        g_object_set(rate, "drop-only", TRUE, "skip-to-first", TRUE, nullptr);
+        if (_frameTapConfig.maxFrameRate > 0) {
+            g_object_set(rate, "max-rate", _frameTapConfig.maxFrameRate, nullptr);
+        }
+
+        // glupload passes GL memory from the decoder as it is, everything after it stays on the GPU
+        const QStringList converters = _frameTapConfig.glMemory
+            ? QStringList({ QStringLiteral("glupload"), QStringLiteral("glcolorconvert"), QStringLiteral("glcolorscale") })
+            : QStringList({ QStringLiteral("videoconvert"), QStringLiteral("videoscale") });
+
+        bool convertersMade = true;
+        for (const QString& name : converters) {
+            GstElement* converter;
+
+            if ((converter = gst_element_factory_make(qPrintable(name), nullptr)) == nullptr) {
+                qCCritical(VideoReceiverLog) << "gst_element_factory_make('" << name << "') failed";
+                convertersMade = false;
+                break;
+            }
+
+            elements << converter;
+        }
+
+        if (!convertersMade) {
+            break;
+        }
+
+        caps = gst_caps_from_string(_frameTapConfig.glMemory ? "video/x-raw(memory:GLMemory),format=RGBA" : "video/x-raw");
+
+        if (_frameTapConfig.width > 0) {
+            gst_caps_set_simple(caps, "width", G_TYPE_INT, _frameTapConfig.width, nullptr);
+        }
+        if (_frameTapConfig.height > 0) {
+            gst_caps_set_simple(caps, "height", G_TYPE_INT, _frameTapConfig.height, nullptr);
+        }
+
+        GstElement* capsfilter;
+
+        if ((capsfilter = gst_element_factory_make("capsfilter", nullptr)) == nullptr) {
+            qCCritical(VideoReceiverLog) << "gst_element_factory_make('capsfilter') failed";
+            break;
+        }
+
+        elements << capsfilter;
+
+        g_object_set(capsfilter, "caps", caps, nullptr);
+
+        GstElement* appsink;
+
+        if ((appsink = gst_element_factory_make("appsink", nullptr)) == nullptr) {
+            qCCritical(VideoReceiverLog) << "gst_element_factory_make('appsink') failed";
+            break;
+        }
+
+        elements << appsink;
+
+        g_object_set(appsink,
+                     "emit-signals", TRUE,
+                     "drop", TRUE,
+                     "max-buffers", 1,
+                     "sync", FALSE,
+                     "async", FALSE,
+                     "enable-last-sample", FALSE,
+                     nullptr);
+
+        // The handler is copied, so it stays the same for the life of this tap
+        g_signal_connect_data(appsink, "new-sample", G_CALLBACK(_onFrameTapSample), new FrameTapHandler(_frameTapHandler),
+                              [](gpointer data, GClosure* closure) { Q_UNUSED(closure); delete static_cast<FrameTapHandler*>(data); },
+                              static_cast<GConnectFlags>(0));
+
+        ok = true;
+    } while(0);
+
+    if (caps != nullptr) {
+        gst_caps_unref(caps);
+        caps = nullptr;
+    }
+
+    if (!ok) {
+        for (GstElement* element : elements) {
+            gst_object_unref(element);
+        }
+        return nullptr;
+    }
+
+    GstElement* bin = gst_bin_new("frametap");
+
+    for (GstElement* element : elements) {
+        gst_bin_add(GST_BIN(bin), element);
+    }
+
+    for (int i = 1; i < elements.count(); i++) {
+        if (!gst_element_link(elements[i - 1], elements[i])) {
+            qCCritical(VideoReceiverLog) << "Failed to link frame tap element" << GST_ELEMENT_NAME(elements[i]);
+            gst_object_unref(bin);
+            return nullptr;
+        }
+    }
+
+    GstPad* pad;
+
+    if ((pad = gst_element_get_static_pad(elements.first(), "sink")) == nullptr) {
+        qCCritical(VideoReceiverLog) << "gst_element_get_static_pad() failed";
+        gst_object_unref(bin);
+        return nullptr;
+    }
+
+    gst_element_add_pad(bin, gst_ghost_pad_new("sink", pad));
+    gst_object_unref(pad);
+    pad = nullptr;
+
+    return bin;
+}
+
+GstElement*
+GstVideoReceiver::_makeMetadataSource(GstElement* bin, GstElement* mux)
+{
+    GstElement* source;
+
+    if ((source = gst_element_factory_make("appsrc", nullptr)) == nullptr) {
+        qCCritical(VideoReceiverLog) << "gst_element_factory_make('appsrc') failed";
+        return nullptr;
+    }
+
+    // Buffers are timestamped by writeMetadata() in the time of the recorded file
+    GstCaps* caps = gst_caps_new_simple("meta/x-klv", "parsed", G_TYPE_BOOLEAN, TRUE, nullptr);
+    g_object_set(source,
+                 "caps", caps,
+                 "format", GST_FORMAT_TIME,
+                 "is-live", TRUE,
+                 "do-timestamp", FALSE,
+                 nullptr);
+    gst_caps_unref(caps);
+    caps = nullptr;
+
+    gst_bin_add(GST_BIN(bin), source);
+
+    if (!gst_element_link(source, mux)) {
+        qCCritical(VideoReceiverLog) << "Failed to link metadata source to mux";
+        gst_bin_remove(GST_BIN(bin), source);
+        return nullptr;
+    }
+
+    gst_object_ref(source);
+
+    return source;
+}
+
 GstElement*
 GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
 {
@@ -951,7 +1309,13 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
             break;
         }
 
-        g_object_set(static_cast<gpointer>(sink), "location", qPrintable(videoFile), nullptr);
+        // Write in large blocks, the muxer output is otherwise written in many small writes on the recording thread
+        g_object_set(static_cast<gpointer>(sink),
+                     "location", qPrintable(videoFile),
+                     "buffer-mode", 0 /* full */,
+                     "buffer-size", 4 * 1024 * 1024,
+                     "async", FALSE,
+                     nullptr);
 
         if ((bin = gst_bin_new("sinkbin")) == nullptr) {
             qCCritical(VideoReceiverLog) << "gst_bin_new('sinkbin') failed";
@@ -960,7 +1324,9 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
 
         GstPadTemplate* padTemplate;
 
-        if ((padTemplate = gst_element_class_get_pad_template(GST_ELEMENT_GET_CLASS(mux), "video_%u")) == nullptr) {
+        // mpegtsmux has a single template for all of its streams
+        if ((padTemplate = gst_element_class_get_pad_template(GST_ELEMENT_GET_CLASS(mux), "video_%u")) == nullptr &&
+            (padTemplate = gst_element_class_get_pad_template(GST_ELEMENT_GET_CLASS(mux), "sink_%d")) == nullptr) {
             qCCritical(VideoReceiverLog) << "gst_element_class_get_pad_template(mux) failed";
             break;
         }
@@ -989,6 +1355,14 @@ GstVideoReceiver::_makeFileSink(const QString& videoFile, FILE_FORMAT format)
             break;
         }
 
+        if (_recordingMetadata) {
+            if (format == FILE_FORMAT_TS) {
+                _metadataSource = _makeMetadataSource(bin, mux);
+            } else {
+                qCWarning(VideoReceiverLog) << "Metadata is only recorded to MPEG-TS files";
+            }
+        }
+
         fileSink = bin;
         bin = nullptr;
     } while(0);
@@ -1105,6 +1479,14 @@ GstVideoReceiver::_addDecoder(GstElement* src)
         return false;
     }
 
+    GstPad* decoderSinkPad;
+
+    if ((decoderSinkPad = gst_element_get_static_pad(_decoder, "sink")) != nullptr) {
+        gst_pad_add_probe(decoderSinkPad, GST_PAD_PROBE_TYPE_BUFFER, _decoderProbe, this, nullptr);
+        gst_object_unref(decoderSinkPad);
+        decoderSinkPad = nullptr;
+    }
+
     GstPad* srcPad = nullptr;
 
     GstIterator* it;
@@ -1142,7 +1524,41 @@ GstVideoReceiver::_addVideoSink(GstPad* pad)
 
     gst_bin_add(GST_BIN(_pipeline), _videoSink);
 
-    if(!gst_element_link(_decoder, _videoSink)) {
+    GstElement* videoSinkSource = _decoder;
+
+    if (_frameTapHandler) {
+        if ((_frameTap = _makeFrameTap()) == nullptr || (_decoderTee = gst_element_factory_make("tee", nullptr)) == nullptr) {
+            qCWarning(VideoReceiverLog) << "Frame tap not available, decoding without it" << _uri;
+            if (_frameTap != nullptr) {
+                gst_object_unref(_frameTap);
+                _frameTap = nullptr;
+            }
+        } else {
+            gst_object_ref(_decoderTee);
+            gst_object_ref(_frameTap);
+
+            gst_bin_add_many(GST_BIN(_pipeline), _decoderTee, _frameTap, nullptr);
+
+            if (gst_element_link(_decoder, _decoderTee) && gst_element_link(_decoderTee, _frameTap)) {
+                gst_element_sync_state_with_parent(_frameTap);
+                gst_element_sync_state_with_parent(_decoderTee);
+                videoSinkSource = _decoderTee;
+                qCDebug(VideoReceiverLog) << "Frame tap added, GL:" << _frameTapConfig.glMemory
+                                          << "size:" << _frameTapConfig.width << "x" << _frameTapConfig.height
+                                          << "max rate:" << _frameTapConfig.maxFrameRate << _uri;
+            } else {
+                qCCritical(VideoReceiverLog) << "Unable to link frame tap" << _uri;
+                gst_element_unlink(_decoder, _decoderTee);
+                gst_bin_remove_many(GST_BIN(_pipeline), _decoderTee, _frameTap, nullptr);
+                gst_object_unref(_decoderTee);
+                _decoderTee = nullptr;
+                gst_object_unref(_frameTap);
+                _frameTap = nullptr;
+            }
+        }
+    }
+
+    if(!gst_element_link(videoSinkSource, _videoSink)) {
         gst_bin_remove(GST_BIN(_pipeline), _videoSink);
         qCCritical(VideoReceiverLog) << "Unable to link video sink";
         if (caps != nullptr) {
@@ -1156,6 +1572,15 @@ GstVideoReceiver::_addVideoSink(GstPad* pad)
 
     g_object_set(_videoSink, "sync", _buffer >= 0, NULL);
 
+    GstCaps* decoderCaps = gst_pad_get_current_caps(pad);
+    if (decoderCaps != nullptr) {
+        logDecoderOutputMemory(decoderCaps);
+        gst_caps_unref(decoderCaps);
+        decoderCaps = nullptr;
+    } else {
+        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, _decoderCapsProbe, nullptr, nullptr);
+    }
+
     GST_DEBUG_BIN_TO_DOT_FILE(GST_BIN(_pipeline), GST_DEBUG_GRAPH_SHOW_ALL, "pipeline-with-videosink");
 
     if (_decoderValve != nullptr) {
@@ -1187,13 +1612,21 @@ GstVideoReceiver::_addVideoSink(GstPad* pad)
 void
 GstVideoReceiver::_noteTeeFrame(void)
 {
-    _lastSourceFrameTime = QDateTime::currentSecsSinceEpoch();
+    _lastSourceFrameTime = QDateTime::currentMSecsSinceEpoch();
+
+    if (_stalled.testAndSetRelaxed(true, false)) {
+        // The keyframe asked for at the stall may have been lost with the rest, so ask again now that data flows
+        _slotHandler.dispatch([this](){
+            qCDebug(VideoReceiverLog) << "Stream recovered" << _uri;
+            requestKeyframe();
+        });
+    }
 }
 
 void
 GstVideoReceiver::_noteVideoSinkFrame(void)
 {
-    _lastVideoFrameTime = QDateTime::currentSecsSinceEpoch();
+    _lastVideoFrameTime = QDateTime::currentMSecsSinceEpoch();
     if (!_decoding) {
         _decoding = true;
         qCDebug(VideoReceiverLog) << "Decoding started";
@@ -1203,6 +1636,158 @@ GstVideoReceiver::_noteVideoSinkFrame(void)
     }
 }
 
+void
+GstVideoReceiver::_noteFrameTimes(GstBuffer* buffer, bool decoderInput)
+{
+    const GstClockTime pts = GST_BUFFER_PTS(buffer);
+
+    if (!GST_CLOCK_TIME_IS_VALID(pts)) {
+        return;
+    }
+
+    const gint64 now = g_get_monotonic_time();
+
+    QMutexLocker lock(&_latencyStatsSync);
+
+    QMap<GstClockTime, gint64>& times = decoderInput ? _latencyStats.decoderTimes : _latencyStats.sourceTimes;
+
+    // Frames are only collected from the maps when they are rendered, this keeps them bounded while not decoding
+    if (times.count() >= _kMaxPendingFrameTimes) {
+        times.erase(times.begin());
+    }
+
+    times.insert(pts, now);
+
+    if (!decoderInput) {
+        // Frames reordered for B-frames arrive with a lower pts, only frames in presentation order are used for the jitter
+        if (!GST_CLOCK_TIME_IS_VALID(_latencyStats.lastPts) || pts > _latencyStats.lastPts) {
+            if (GST_CLOCK_TIME_IS_VALID(_latencyStats.lastPts)) {
+                const double deviation = static_cast<double>(now - _latencyStats.lastArrival) - static_cast<double>(GST_TIME_AS_USECONDS(pts - _latencyStats.lastPts));
+                _latencyStats.jitterUSecs += (qAbs(deviation) - _latencyStats.jitterUSecs) / 16.0;
+            }
+            _latencyStats.lastPts = pts;
+            _latencyStats.lastArrival = now;
+        }
+    }
+}
+
+void
+GstVideoReceiver::_noteRenderedFrame(GstBuffer* buffer)
+{
+    const GstClockTime pts = GST_BUFFER_PTS(buffer);
+
+    if (!GST_CLOCK_TIME_IS_VALID(pts)) {
+        return;
+    }
+
+    const gint64 now = g_get_monotonic_time();
+
+    QMutexLocker lock(&_latencyStatsSync);
+
+    auto smooth = [this](double& average, double sample) {
+        average = (_latencyStats.renderedFrames == 0) ? sample : average + ((sample - average) / 16.0);
+    };
+
+    auto decoderTime = _latencyStats.decoderTimes.constFind(pts);
+    if (decoderTime != _latencyStats.decoderTimes.constEnd()) {
+        smooth(_latencyStats.decodeUSecs, static_cast<double>(now - decoderTime.value()));
+    }
+
+    auto sourceTime = _latencyStats.sourceTimes.constFind(pts);
+    if (sourceTime != _latencyStats.sourceTimes.constEnd()) {
+        smooth(_latencyStats.frameAgeUSecs, static_cast<double>(now - sourceTime.value()));
+    }
+
+    // Decoders output in presentation order, so frames with a lower pts still waiting are not going to come out
+    while (!_latencyStats.decoderTimes.isEmpty() && _latencyStats.decoderTimes.firstKey() <= pts) {
+        if (_latencyStats.decoderTimes.firstKey() < pts) {
+            _latencyStats.droppedFrames++;
+        }
+        _latencyStats.decoderTimes.erase(_latencyStats.decoderTimes.begin());
+    }
+
+    while (!_latencyStats.sourceTimes.isEmpty() && _latencyStats.sourceTimes.firstKey() <= pts) {
+        _latencyStats.sourceTimes.erase(_latencyStats.sourceTimes.begin());
+    }
+
+    _latencyStats.renderedFrames++;
+}
+
+void
+GstVideoReceiver::_resetLatencyStats(void)
+{
+    QMutexLocker lock(&_latencyStatsSync);
+    _latencyStats = LatencyStats_t();
+    _lossDroppedFrames = 0;
+    _lossRenderedFrames = 0;
+}
+
+void
+GstVideoReceiver::_emitLatencyStats(void)
+{
+    double jitterMSecs;
+    double decodeMSecs;
+    double frameAgeMSecs;
+    quint64 droppedFrames;
+    quint64 renderedFrames;
+
+    {
+        QMutexLocker lock(&_latencyStatsSync);
+        jitterMSecs = _latencyStats.jitterUSecs / 1000.0;
+        decodeMSecs = _latencyStats.decodeUSecs / 1000.0;
+        frameAgeMSecs = _latencyStats.frameAgeUSecs / 1000.0;
+        droppedFrames = _latencyStats.droppedFrames + _latencyStats.sinkDropped;
+        renderedFrames = _latencyStats.renderedFrames;
+    }
+
+    // A buffer of -1 is low latency mode, logged so runs with different settings can be compared
+    qCDebug(VideoReceiverLog) << "Latency stats" << _uri << "buffer:" << _buffer
+                              << "jitter(ms):" << jitterMSecs << "decode(ms):" << decodeMSecs << "frame age(ms):" << frameAgeMSecs
+                              << "rendered:" << renderedFrames << "dropped:" << droppedFrames;
+
+    const quint64 intervalDropped = droppedFrames - qMin(_lossDroppedFrames, droppedFrames);
+    const quint64 intervalRendered = renderedFrames - qMin(_lossRenderedFrames, renderedFrames);
+    _lossDroppedFrames = droppedFrames;
+    _lossRenderedFrames = renderedFrames;
+    double lossPercent = 0;
+    if (_stalled) {
+        lossPercent = 100;
+    } else if ((intervalDropped + intervalRendered) > 0) {
+        lossPercent = (100.0 * intervalDropped) / (intervalDropped + intervalRendered);
+    }
+
+    _dispatchSignal([this, jitterMSecs, decodeMSecs, frameAgeMSecs, droppedFrames, lossPercent](){
+        emit latencyStatsChanged(jitterMSecs, decodeMSecs, frameAgeMSecs, droppedFrames);
+        emit frameLossChanged(lossPercent);
+    });
+}
+
+void
+GstVideoReceiver::requestKeyframe(void)
+{
+    if (_needDispatch()) {
+        _slotHandler.dispatch([this]() {
+            requestKeyframe();
+        });
+        return;
+    }
+
+    if (_tee == nullptr) {
+        return;
+    }
+
+    // The event gst_video_event_new_upstream_force_key_unit makes, without linking gstreamer-video. rtpsession turns it
+    // into an RTCP PLI or FIR for RTSP streams, other sources ignore it.
+    GstStructure* const structure = gst_structure_new("GstForceKeyUnit",
+                                                      "running-time", GST_TYPE_CLOCK_TIME, GST_CLOCK_TIME_NONE,
+                                                      "all-headers", G_TYPE_BOOLEAN, TRUE,
+                                                      "count", G_TYPE_UINT, 0,
+                                                      nullptr);
+    if (!gst_element_send_event(_tee, gst_event_new_custom(GST_EVENT_CUSTOM_UPSTREAM, structure))) {
+        qCDebug(VideoReceiverLog) << "Keyframe request not handled upstream" << _uri;
+    }
+}
+
 void
 GstVideoReceiver::_noteEndOfStream(void)
 {
@@ -1275,6 +1860,24 @@ GstVideoReceiver::_shutdownDecodingBranch(void)
         _decoder = nullptr;
     }
 
+    for (GstElement** element : { &_decoderTee, &_frameTap }) {
+        if (*element == nullptr) {
+            continue;
+        }
+
+        GstObject* parent;
+
+        if ((parent = gst_element_get_parent(*element)) != nullptr) {
+            gst_bin_remove(GST_BIN(_pipeline), *element);
+            gst_element_set_state(*element, GST_STATE_NULL);
+            gst_object_unref(parent);
+            parent = nullptr;
+        }
+
+        gst_object_unref(*element);
+        *element = nullptr;
+    }
+
     if (_videoSinkProbeId != 0) {
         GstPad* sinkpad;
         if ((sinkpad = gst_element_get_static_pad(_videoSink, "sink")) != nullptr) {
@@ -1315,6 +1918,23 @@ GstVideoReceiver::_shutdownDecodingBranch(void)
 void
 GstVideoReceiver::_shutdownRecordingBranch(void)
 {
+    if (_recordedFrameProbeId != 0) {
+        GstPad* pad;
+
+        if ((pad = gst_element_get_static_pad(_recorderValve, "src")) != nullptr) {
+            gst_pad_remove_probe(pad, _recordedFrameProbeId);
+            gst_object_unref(pad);
+            pad = nullptr;
+        }
+
+        _recordedFrameProbeId = 0;
+    }
+
+    if (_metadataSource != nullptr) {
+        gst_object_unref(_metadataSource);
+        _metadataSource = nullptr;
+    }
+
     gst_bin_remove(GST_BIN(_pipeline), _fileSink);
     gst_element_set_state(_fileSink, GST_STATE_NULL);
     gst_object_unref(_fileSink);
@@ -1322,6 +1942,11 @@ GstVideoReceiver::_shutdownRecordingBranch(void)
 
     _removingRecorder = false;
 
+    // Start holding the pre-roll for the next recording, unless the whole pipeline is going down
+    if (GST_STATE(_pipeline) != GST_STATE_NULL) {
+        _blockRecorderQueue();
+    }
+
     if (_recording) {
         _recording = false;
         qCDebug(VideoReceiverLog) << "Recording stopped";
@@ -1386,6 +2011,28 @@ GstVideoReceiver::_onBusMessage(GstBus* bus, GstMessage* msg, gpointer data)
             pThis->_handleEOS();
         });
         break;
+    case GST_MESSAGE_QOS:
+        do {
+            // Only the video sink drops are counted here, frames dropped by the decoder never reach the video sink probe
+            GstElement* element = GST_IS_ELEMENT(GST_MESSAGE_SRC(msg)) ? GST_ELEMENT(GST_MESSAGE_SRC(msg)) : nullptr;
+            GstElementFactory* factory = (element != nullptr) ? gst_element_get_factory(element) : nullptr;
+
+            if (factory == nullptr || g_strcmp0(GST_OBJECT_NAME(factory), "qml6glsink") != 0) {
+                break;
+            }
+
+            GstFormat format;
+            guint64 processed;
+            guint64 dropped;
+
+            gst_message_parse_qos_stats(msg, &format, &processed, &dropped);
+
+            if (format == GST_FORMAT_BUFFERS && dropped != static_cast<guint64>(-1)) {
+                QMutexLocker lock(&pThis->_latencyStatsSync);
+                pThis->_latencyStats.sinkDropped = dropped;
+            }
+        } while(0);
+        break;
     case GST_MESSAGE_ELEMENT:
         do {
             const GstStructure* s = gst_message_get_structure (msg);
@@ -1516,11 +2163,30 @@ GstPadProbeReturn
 GstVideoReceiver::_teeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
     Q_UNUSED(pad)
-    Q_UNUSED(info)
 
     if(user_data != nullptr) {
         GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
         pThis->_noteTeeFrame();
+
+        GstBuffer* buffer = gst_pad_probe_info_get_buffer(info);
+        if (buffer != nullptr) {
+            pThis->_noteFrameTimes(buffer, false);
+        }
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn
+GstVideoReceiver::_decoderProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+
+    if(user_data != nullptr) {
+        GstBuffer* buffer = gst_pad_probe_info_get_buffer(info);
+        if (buffer != nullptr) {
+            static_cast<GstVideoReceiver*>(user_data)->_noteFrameTimes(buffer, true);
+        }
     }
 
     return GST_PAD_PROBE_OK;
@@ -1530,7 +2196,6 @@ GstPadProbeReturn
 GstVideoReceiver::_videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
     Q_UNUSED(pad)
-    Q_UNUSED(info)
 
     if(user_data != nullptr) {
         GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
@@ -1563,11 +2228,35 @@ GstVideoReceiver::_videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer u
         }
 
         pThis->_noteVideoSinkFrame();
+
+        GstBuffer* buffer = gst_pad_probe_info_get_buffer(info);
+        if (buffer != nullptr) {
+            pThis->_noteRenderedFrame(buffer);
+        }
     }
 
     return GST_PAD_PROBE_OK;
 }
 
+GstPadProbeReturn
+GstVideoReceiver::_decoderCapsProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+    Q_UNUSED(user_data)
+
+    GstEvent* event = gst_pad_probe_info_get_event(info);
+
+    if (event == nullptr || GST_EVENT_TYPE(event) != GST_EVENT_CAPS) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    logDecoderOutputMemory(caps);
+
+    return GST_PAD_PROBE_REMOVE;
+}
+
 GstPadProbeReturn
 GstVideoReceiver::_eosProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
@@ -1586,6 +2275,57 @@ GstVideoReceiver::_eosProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_da
     return GST_PAD_PROBE_OK;
 }
 
+GstPadProbeReturn
+GstVideoReceiver::_preRollBlock(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+    Q_UNUSED(info)
+    Q_UNUSED(user_data)
+
+    // Stay blocked, the queue fills up with the pre-roll until the recording starts
+    return GST_PAD_PROBE_OK;
+}
+
+GstFlowReturn
+GstVideoReceiver::_onFrameTapSample(GstElement* appsink, gpointer user_data)
+{
+    GstSample* sample = nullptr;
+
+    g_signal_emit_by_name(appsink, "pull-sample", &sample);
+
+    if (sample == nullptr) {
+        return GST_FLOW_OK;
+    }
+
+    const FrameTapHandler* handler = static_cast<const FrameTapHandler*>(user_data);
+    if (handler != nullptr && *handler) {
+        (*handler)(sample);
+    }
+
+    gst_sample_unref(sample);
+
+    return GST_FLOW_OK;
+}
+
+GstPadProbeReturn
+GstVideoReceiver::_recordedFrameProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+
+    if (info == nullptr || user_data == nullptr) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstBuffer* buf = gst_pad_probe_info_get_buffer(info);
+
+    // Probes see the buffers before the pad offset is applied, writeMetadata() subtracts the start of the recording
+    if (buf != nullptr && GST_BUFFER_PTS_IS_VALID(buf)) {
+        static_cast<GstVideoReceiver*>(user_data)->_lastRecordedPts = GST_BUFFER_PTS(buf);
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
 GstPadProbeReturn
 GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
 {
@@ -1597,13 +2337,20 @@ GstVideoReceiver::_keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer us
     GstBuffer* buf = gst_pad_probe_info_get_buffer(info);
 
     if (GST_BUFFER_FLAG_IS_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT)) { // wait for a keyframe
+        static_cast<GstVideoReceiver*>(user_data)->_dropPreRollHead = false;
+        return GST_PAD_PROBE_DROP;
+    }
+
+    GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+
+    if (pThis->_dropPreRollHead) {
+        pThis->_dropPreRollHead = false;
         return GST_PAD_PROBE_DROP;
     }
 
     // set media file '0' offset to current timeline position - we don't want to touch other elements in the graph, except these which are downstream!
     gst_pad_set_offset(pad, -static_cast<gint64>(buf->pts));
-
-    GstVideoReceiver* pThis = static_cast<GstVideoReceiver*>(user_data);
+    pThis->_recordingStartPts = buf->pts;
 
     qCDebug(VideoReceiverLog) << "Got keyframe, stop dropping buffers";
 
@@ -15,12 +15,14 @@
 
 #pragma once
 
+#include <QtCore/QAtomicInteger>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QTimer>
 #include <QtCore/QThread>
 #include <QtCore/QWaitCondition>
 #include <QtCore/QMutex>
 #include <QtCore/QQueue>
+#include <QtCore/QMap>
 
 #include "VideoReceiver.h"
 
@@ -87,6 +89,22 @@ public:
     explicit GstVideoReceiver(QObject* parent = nullptr);
     ~GstVideoReceiver(void);
 
+    /// Decoded frames for onboard analytics, taken from a tee after the decoder so they are not decoded twice
+    typedef struct {
+        int     width           = 0;        ///< 0 keeps the decoded width, the aspect ratio is kept if only one of the sizes is set
+        int     height          = 0;
+        int     maxFrameRate    = 0;        ///< Frames per second, 0 passes every frame
+        bool    glMemory        = false;    ///< Frames stay RGBA GL textures in the GL context of the video sink, no copy to system memory
+    } FrameTapConfig_t;
+
+    /// Called on the streaming thread for each tapped frame. The handler takes its own reference of the sample to
+    /// keep it past the call. A slow handler only drops tapped frames, the video sink is not held up.
+    typedef std::function<void(GstSample* sample)> FrameTapHandler;
+
+    /// Used from the next startDecoding(), an empty handler removes the tap. A plugin sets it up on the receiver
+    /// it returns from QGCCorePlugin::createVideoReceiver().
+    void setFrameTap(const FrameTapConfig_t& config, FrameTapHandler handler);
+
 public slots:
     virtual void start(const QString& uri, unsigned timeout, int buffer = 0);
     virtual void stop(void);
@@ -95,6 +113,10 @@ public slots:
     virtual void startRecording(const QString& videoFile, FILE_FORMAT format);
     virtual void stopRecording(void);
     virtual void takeScreenshot(const QString& imageFile);
+    virtual void setRecordingPreRoll(unsigned seconds);
+    virtual void setRecordingMetadata(bool enabled);
+    virtual void writeMetadata(const QByteArray& klv);
+    virtual void requestKeyframe(void);
 
 protected slots:
     virtual void _watchdog(void);
@@ -104,6 +126,8 @@ protected:
     virtual GstElement* _makeSource(const QString& uri);
     virtual GstElement* _makeDecoder(GstCaps* caps = nullptr, GstElement* videoSink = nullptr);
     virtual GstElement* _makeFileSink(const QString& videoFile, FILE_FORMAT format);
+    GstElement* _makeMetadataSource(GstElement* bin, GstElement* mux);
+    GstElement* _makeFrameTap(void);
 
     virtual void _onNewSourcePad(GstPad* pad);
     virtual void _onNewDecoderPad(GstPad* pad);
@@ -111,10 +135,15 @@ protected:
     virtual bool _addVideoSink(GstPad* pad);
     virtual void _noteTeeFrame(void);
     virtual void _noteVideoSinkFrame(void);
+    virtual void _noteFrameTimes(GstBuffer* buffer, bool decoderInput);
+    virtual void _noteRenderedFrame(GstBuffer* buffer);
+    virtual void _resetLatencyStats(void);
+    virtual void _emitLatencyStats(void);
     virtual void _noteEndOfStream(void);
     virtual bool _unlinkBranch(GstElement* from);
     virtual void _shutdownDecodingBranch (void);
     virtual void _shutdownRecordingBranch(void);
+    virtual void _blockRecorderQueue(void);
 
     bool _needDispatch(void);
     void _dispatchSignal(std::function<void()> emitter);
@@ -127,8 +156,13 @@ protected:
     static gboolean _filterParserCaps(GstElement* bin, GstPad* pad, GstElement* element, GstQuery* query, gpointer data);
     static GstPadProbeReturn _teeProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _videoSinkProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _decoderProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _decoderCapsProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _eosProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
     static GstPadProbeReturn _keyframeWatch(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _preRollBlock(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstPadProbeReturn _recordedFrameProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static GstFlowReturn _onFrameTapSample(GstElement* appsink, gpointer user_data);
 
     bool                _streaming;
     bool                _decoding;
@@ -139,18 +173,70 @@ protected:
     GstElement*         _tee;
     GstElement*         _decoderValve;
     GstElement*         _recorderValve;
+    GstElement*         _recorderQueue = nullptr;
     GstElement*         _decoder;
     GstElement*         _videoSink;
     GstElement*         _fileSink;
     GstElement*         _pipeline;
 
-    qint64              _lastSourceFrameTime;
-    qint64              _lastVideoFrameTime;
+    qint64              _lastSourceFrameTime;       ///< msecs since epoch
+    qint64              _lastVideoFrameTime;        ///< msecs since epoch
+    qint64              _lastLatencyStatsTime = 0;
+    QAtomicInteger<bool> _stalled = false;          ///< No frames from the source for _kStallMSecs, cleared by the next frame
     bool                _resetVideoSink;
     gulong              _videoSinkProbeId = 0;
 
     gulong              _teeProbeId = 0;
 
+    /// decoder-->_decoderTee-->_videoSink
+    ///                      +-->_frameTap (queue-->videorate-->scale-->appsink)
+    FrameTapConfig_t    _frameTapConfig;
+    FrameTapHandler     _frameTapHandler;
+    GstElement*         _decoderTee = nullptr;
+    GstElement*         _frameTap = nullptr;
+
+    /// While not recording the recorder queue is blocked and leaks its oldest buffers, so it holds the last
+    /// _recordingPreRollSecs of the stream for the next recording
+    unsigned            _recordingPreRollSecs = 0;
+    gulong              _preRollProbeId = 0;
+    bool                _dropPreRollHead = false;   ///< The buffer held by the block is older than the pre-roll
+
+    /// KLV metadata stream of the recording, timed by the last video frame entering the recording. Both
+    /// times are written from the recording branch streaming thread.
+    bool                        _recordingMetadata = false;
+    GstElement*                 _metadataSource = nullptr;
+    gulong                      _recordedFrameProbeId = 0;
+    QAtomicInteger<quint64>     _recordingStartPts = GST_CLOCK_TIME_NONE;   ///< Pts of the first recorded keyframe
+    QAtomicInteger<quint64>     _lastRecordedPts = GST_CLOCK_TIME_NONE;
+
+    /// Per stage timing of the decoded frames, frames are matched between the probes by their pts. Updated from
+    /// the streaming threads, so guarded by _latencyStatsSync.
+    typedef struct {
+        QMap<GstClockTime, gint64> sourceTimes;     ///< Arrival at the tee by pts, monotonic usecs
+        QMap<GstClockTime, gint64> decoderTimes;    ///< Arrival at the decoder by pts, monotonic usecs
+        gint64          lastArrival     = 0;
+        GstClockTime    lastPts         = GST_CLOCK_TIME_NONE;
+        double          jitterUSecs     = 0;        ///< Smoothed variation of the arrival interval against the pts interval, RFC 3550 style
+        double          decodeUSecs     = 0;        ///< Smoothed decoder input to video sink input
+        double          frameAgeUSecs   = 0;        ///< Smoothed tee arrival to video sink input
+        quint64         droppedFrames   = 0;        ///< Frames which entered the decoder but never reached the video sink
+        quint64         sinkDropped     = 0;        ///< Late frames dropped by the video sink, from its QoS messages
+        quint64         renderedFrames  = 0;
+    } LatencyStats_t;
+
+    QMutex              _latencyStatsSync;
+    LatencyStats_t      _latencyStats;
+
+    static constexpr int _kMaxPendingFrameTimes = 256;
+
+    /// Frame counts at the previous latency stats, for the loss over the interval
+    quint64             _lossDroppedFrames = 0;
+    quint64             _lossRenderedFrames = 0;
+
+    static constexpr int _kWatchdogIntervalMSecs = 250;
+    static constexpr int _kStallMSecs = 500;
+    static constexpr int _kLatencyStatsIntervalMSecs = 1000;
+
     QTimer              _watchdogTimer;
 
     //-- RTSP UDP reconnect timeout
@@ -0,0 +1,555 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+/**
+ * @file
+ *   @brief QGC Video Wall Receiver
+ */
+
+#include "GstVideoWallReceiver.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QtMath>
+
+QGC_LOGGING_CATEGORY(VideoWallReceiverLog, "VideoWallReceiverLog")
+
+GstVideoWallReceiver::GstVideoWallReceiver(QObject* parent)
+    : GstVideoReceiver(parent)
+{
+}
+
+GstVideoWallReceiver::~GstVideoWallReceiver(void)
+{
+    // The wall has to go down before the members it uses, the base class only stops its own pipeline
+    _slotHandler.dispatch([this](){
+        _shutdownWall();
+    });
+    _slotHandler.shutdown();
+}
+
+void
+GstVideoWallReceiver::startWall(const QStringList& uris, void* sink, int columns, unsigned timeout)
+{
+    if (_needDispatch()) {
+        const QStringList cachedUris = uris;
+        _slotHandler.dispatch([this, cachedUris, sink, columns, timeout]() {
+            startWall(cachedUris, sink, columns, timeout);
+        });
+        return;
+    }
+
+    if (_wallPipeline != nullptr) {
+        qCDebug(VideoWallReceiverLog) << "Already running!";
+        _dispatchSignal([this](){
+            emit onStartWallComplete(STATUS_INVALID_STATE);
+        });
+        return;
+    }
+
+    if (uris.isEmpty() || sink == nullptr) {
+        qCDebug(VideoWallReceiverLog) << "Failed because no streams or no video sink are specified";
+        _dispatchSignal([this](){
+            emit onStartWallComplete(STATUS_INVALID_URL);
+        });
+        return;
+    }
+
+    _columns = (columns > 0) ? columns : qCeil(qSqrt(uris.count()));
+    _wallTimeout = timeout;
+    _buffer = 0;
+
+    qCDebug(VideoWallReceiverLog) << "Starting" << uris.count() << "streams in" << _columns << "columns";
+
+    bool running = false;
+    bool elementsAdded = false;
+
+    do {
+        if ((_wallPipeline = gst_pipeline_new("wall")) == nullptr) {
+            qCCritical(VideoWallReceiverLog) << "gst_pipeline_new() failed";
+            break;
+        }
+
+        if ((_mixer = gst_element_factory_make("glvideomixer", nullptr)) == nullptr) {
+            qCCritical(VideoWallReceiverLog) << "gst_element_factory_make('glvideomixer') failed";
+            break;
+        }
+
+        if ((_wallCaps = gst_element_factory_make("capsfilter", nullptr)) == nullptr) {
+            qCCritical(VideoWallReceiverLog) << "gst_element_factory_make('capsfilter') failed";
+            break;
+        }
+
+        // Streams are live and start at different times, mix them from their first buffer instead of waiting for a common start
+        GstElement* aggregator = nullptr;
+        g_object_get(_mixer, "mixer", &aggregator, nullptr);
+        if (aggregator != nullptr) {
+            g_object_set(aggregator, "start-time-selection", 1 /* GST_AGGREGATOR_START_TIME_SELECTION_FIRST */, nullptr);
+            gst_object_unref(aggregator);
+            aggregator = nullptr;
+        }
+
+        _wallSink = GST_ELEMENT(sink);
+        gst_object_ref(_wallSink);
+
+        gst_object_ref(_wallSink); // gst_bin_add() will steal one reference
+
+        gst_bin_add_many(GST_BIN(_wallPipeline), _mixer, _wallCaps, _wallSink, nullptr);
+        elementsAdded = true;
+
+        if (!gst_element_link_many(_mixer, _wallCaps, _wallSink, nullptr)) {
+            qCCritical(VideoWallReceiverLog) << "Unable to link mixer to the video sink";
+            break;
+        }
+
+        g_object_set(_wallSink, "sync", FALSE, nullptr);
+
+        bool streamsAdded = true;
+        for (int i = 0; i < uris.count(); i++) {
+            if (!_addWallStream(i, uris[i])) {
+                streamsAdded = false;
+                break;
+            }
+        }
+
+        if (!streamsAdded) {
+            break;
+        }
+
+        _layoutTiles();
+
+        GstBus* bus = nullptr;
+
+        if ((bus = gst_pipeline_get_bus(GST_PIPELINE(_wallPipeline))) != nullptr) {
+            gst_bus_enable_sync_message_emission(bus);
+            g_signal_connect(bus, "sync-message", G_CALLBACK(_onWallBusMessage), this);
+            gst_object_unref(bus);
+            bus = nullptr;
+        }
+
+        GST_DEBUG_BIN_TO_DOT_FILE(GST_BIN(_wallPipeline), GST_DEBUG_GRAPH_SHOW_ALL, "wall-initial");
+        running = gst_element_set_state(_wallPipeline, GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE;
+    } while(0);
+
+    if (!running) {
+        qCCritical(VideoWallReceiverLog) << "Failed";
+
+        // Once added the pipeline cleans up the mixer and the caps filter
+        if (!elementsAdded) {
+            if (_mixer != nullptr) {
+                gst_object_unref(_mixer);
+                _mixer = nullptr;
+            }
+
+            if (_wallCaps != nullptr) {
+                gst_object_unref(_wallCaps);
+                _wallCaps = nullptr;
+            }
+        }
+
+        _shutdownWall();
+
+        _dispatchSignal([this](){
+            emit onStartWallComplete(STATUS_FAIL);
+        });
+    } else {
+        GST_DEBUG_BIN_TO_DOT_FILE(GST_BIN(_wallPipeline), GST_DEBUG_GRAPH_SHOW_ALL, "wall-started");
+        qCDebug(VideoWallReceiverLog) << "Started";
+
+        _dispatchSignal([this](){
+            emit onStartWallComplete(STATUS_OK);
+        });
+    }
+}
+
+void
+GstVideoWallReceiver::stopWall(void)
+{
+    if (_needDispatch()) {
+        _slotHandler.dispatch([this]() {
+            stopWall();
+        });
+        return;
+    }
+
+    if (_wallPipeline == nullptr) {
+        _dispatchSignal([this](){
+            emit onStopWallComplete(STATUS_INVALID_STATE);
+        });
+        return;
+    }
+
+    qCDebug(VideoWallReceiverLog) << "Stopping";
+
+    _shutdownWall();
+
+    _dispatchSignal([this](){
+        emit onStopWallComplete(STATUS_OK);
+    });
+}
+
+void
+GstVideoWallReceiver::setWallSize(QSize size)
+{
+    if (_needDispatch()) {
+        _slotHandler.dispatch([this, size]() {
+            setWallSize(size);
+        });
+        return;
+    }
+
+    // Even sizes keep the GL converters from padding the composited frame
+    const QSize wallSize(qMax(size.width(), _kMinTileSize) & ~1, qMax(size.height(), _kMinTileSize) & ~1);
+
+    if (wallSize == _wallSize) {
+        return;
+    }
+
+    _wallSize = wallSize;
+
+    if (_wallPipeline != nullptr) {
+        _layoutTiles();
+    }
+}
+
+void
+GstVideoWallReceiver::_watchdog(void)
+{
+    GstVideoReceiver::_watchdog();
+
+    _slotHandler.dispatch([this](){
+        if (_wallPipeline == nullptr) {
+            return;
+        }
+
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+        for (WallStream_t* stream : _wallStreams) {
+            const bool active = (stream->lastFrameTime != 0) && (now - stream->lastFrameTime <= static_cast<qint64>(_wallTimeout));
+
+            if (active != stream->active) {
+                stream->active = active;
+                qCDebug(VideoWallReceiverLog) << "Stream" << stream->index << (active ? "decoding" : "timed out") << stream->uri;
+                const int index = stream->index;
+                _dispatchSignal([this, index, active](){
+                    emit wallStreamChanged(index, active);
+                });
+            }
+        }
+    });
+}
+
+bool
+GstVideoWallReceiver::_addWallStream(int index, const QString& uri)
+{
+    WallStream_t* stream = new WallStream_t;
+    stream->receiver = this;
+    stream->index = index;
+    stream->uri = uri;
+    _wallStreams.append(stream);
+
+    if ((stream->source = _makeSource(uri)) == nullptr) {
+        qCCritical(VideoWallReceiverLog) << "_makeSource() failed" << uri;
+        return false;
+    }
+
+    if ((stream->queue = gst_element_factory_make("queue", nullptr)) == nullptr) {
+        qCCritical(VideoWallReceiverLog) << "gst_element_factory_make('queue') failed";
+        gst_object_unref(stream->source);
+        stream->source = nullptr;
+        return false;
+    }
+
+    if ((stream->decoder = _makeDecoder()) == nullptr) {
+        qCCritical(VideoWallReceiverLog) << "_makeDecoder() failed";
+        gst_object_unref(stream->queue);
+        stream->queue = nullptr;
+        gst_object_unref(stream->source);
+        stream->source = nullptr;
+        return false;
+    }
+
+    gst_bin_add_many(GST_BIN(_wallPipeline), stream->source, stream->queue, stream->decoder, nullptr);
+
+    if (!gst_element_link(stream->queue, stream->decoder)) {
+        qCCritical(VideoWallReceiverLog) << "Unable to link decoder" << uri;
+        return false;
+    }
+
+    g_signal_connect(stream->decoder, "pad-added", G_CALLBACK(_onWallDecoderPad), stream);
+
+    GstPad* srcPad = nullptr;
+
+    GstIterator* it;
+
+    if ((it = gst_element_iterate_src_pads(stream->source)) != nullptr) {
+        GValue vpad = G_VALUE_INIT;
+
+        if (gst_iterator_next(it, &vpad) == GST_ITERATOR_OK) {
+            srcPad = GST_PAD(g_value_get_object(&vpad));
+            gst_object_ref(srcPad);
+            g_value_reset(&vpad);
+        }
+
+        gst_iterator_free(it);
+        it = nullptr;
+    }
+
+    if (srcPad != nullptr) {
+        _onWallSourcePad(stream->source, srcPad, stream);
+        gst_object_unref(srcPad);
+        srcPad = nullptr;
+    } else {
+        g_signal_connect(stream->source, "pad-added", G_CALLBACK(_onWallSourcePad), stream);
+    }
+
+    return true;
+}
+
+void
+GstVideoWallReceiver::_linkWallDecoder(WallStream_t* stream, GstPad* pad)
+{
+    GstPadTemplate* padTemplate;
+
+    if ((padTemplate = gst_element_class_get_pad_template(GST_ELEMENT_GET_CLASS(_mixer), "sink_%u")) == nullptr) {
+        qCCritical(VideoWallReceiverLog) << "gst_element_class_get_pad_template(mixer) failed";
+        return;
+    }
+
+    GstPad* mixerPad;
+
+    if ((mixerPad = gst_element_request_pad(_mixer, padTemplate, nullptr, nullptr)) == nullptr) {
+        qCCritical(VideoWallReceiverLog) << "gst_element_request_pad(mixer) failed";
+        return;
+    }
+
+    if (gst_pad_link(pad, mixerPad) != GST_PAD_LINK_OK) {
+        qCCritical(VideoWallReceiverLog) << "Unable to link stream" << stream->index << "to the mixer";
+        gst_element_release_request_pad(_mixer, mixerPad);
+        gst_object_unref(mixerPad);
+        return;
+    }
+
+    gst_pad_add_probe(pad, static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM), _wallFrameProbe, stream, nullptr);
+
+    stream->mixerPad = mixerPad;
+
+    _slotHandler.dispatch([this](){
+        _layoutTiles();
+    });
+}
+
+void
+GstVideoWallReceiver::_layoutTiles(void)
+{
+    if (_wallStreams.isEmpty() || _wallCaps == nullptr) {
+        return;
+    }
+
+    const int rows = (_wallStreams.count() + _columns - 1) / _columns;
+    const int tileWidth = qMax(_wallSize.width() / _columns, _kMinTileSize);
+    const int tileHeight = qMax(_wallSize.height() / rows, _kMinTileSize);
+
+    GstCaps* caps = gst_caps_new_simple("video/x-raw",
+                                        "width", G_TYPE_INT, tileWidth * _columns,
+                                        "height", G_TYPE_INT, tileHeight * rows,
+                                        nullptr);
+    gst_caps_set_features(caps, 0, gst_caps_features_new("memory:GLMemory", nullptr));
+    g_object_set(_wallCaps, "caps", caps, nullptr);
+    gst_caps_unref(caps);
+    caps = nullptr;
+
+    for (WallStream_t* stream : _wallStreams) {
+        if (stream->mixerPad == nullptr) {
+            continue;
+        }
+
+        const int column = stream->index % _columns;
+        const int row = stream->index / _columns;
+
+        // Letterbox the stream in its tile, the tile is filled until the stream resolution is known
+        int width = tileWidth;
+        int height = tileHeight;
+
+        const quint32 videoSize = stream->videoSize;
+        const int videoWidth = (videoSize >> 16) & 0xFFFF;
+        const int videoHeight = videoSize & 0xFFFF;
+
+        if (videoWidth > 0 && videoHeight > 0) {
+            const double scale = qMin(static_cast<double>(tileWidth) / videoWidth, static_cast<double>(tileHeight) / videoHeight);
+            width = qMax(static_cast<int>(videoWidth * scale), 1);
+            height = qMax(static_cast<int>(videoHeight * scale), 1);
+        }
+
+        g_object_set(stream->mixerPad,
+                     "xpos", (column * tileWidth) + ((tileWidth - width) / 2),
+                     "ypos", (row * tileHeight) + ((tileHeight - height) / 2),
+                     "width", width,
+                     "height", height,
+                     nullptr);
+    }
+
+    qCDebug(VideoWallReceiverLog) << "Tiles" << tileWidth << "x" << tileHeight << "in" << _columns << "x" << rows;
+}
+
+void
+GstVideoWallReceiver::_shutdownWall(void)
+{
+    if (_wallPipeline != nullptr) {
+        GstBus* bus;
+
+        if ((bus = gst_pipeline_get_bus(GST_PIPELINE(_wallPipeline))) != nullptr) {
+            gst_bus_disable_sync_message_emission(bus);
+            g_signal_handlers_disconnect_by_data(bus, this);
+            gst_object_unref(bus);
+            bus = nullptr;
+        }
+
+        gst_element_set_state(_wallPipeline, GST_STATE_NULL);
+
+        for (WallStream_t* stream : _wallStreams) {
+            if (stream->mixerPad != nullptr) {
+                gst_element_release_request_pad(_mixer, stream->mixerPad);
+                gst_object_unref(stream->mixerPad);
+                stream->mixerPad = nullptr;
+            }
+        }
+
+        // The video sink belongs to the caller, take it out before the pipeline goes
+        if (_wallSink != nullptr && GST_ELEMENT_PARENT(_wallSink) != nullptr) {
+            gst_bin_remove(GST_BIN(_wallPipeline), _wallSink);
+        }
+
+        // The pipeline owns the mixer and the streams' elements
+        gst_object_unref(_wallPipeline);
+        _wallPipeline = nullptr;
+        _mixer = nullptr;
+        _wallCaps = nullptr;
+    }
+
+    if (_wallSink != nullptr) {
+        gst_object_unref(_wallSink);
+        _wallSink = nullptr;
+    }
+
+    for (WallStream_t* stream : _wallStreams) {
+        if (stream->active) {
+            const int index = stream->index;
+            _dispatchSignal([this, index](){
+                emit wallStreamChanged(index, false);
+            });
+        }
+    }
+
+    qDeleteAll(_wallStreams);
+    _wallStreams.clear();
+}
+
+void
+GstVideoWallReceiver::_onWallSourcePad(GstElement* element, GstPad* pad, gpointer data)
+{
+    Q_UNUSED(element)
+
+    WallStream_t* stream = static_cast<WallStream_t*>(data);
+
+    GstPad* queuePad;
+
+    if ((queuePad = gst_element_get_static_pad(stream->queue, "sink")) == nullptr) {
+        qCCritical(VideoWallReceiverLog) << "gst_element_get_static_pad(queue) failed";
+        return;
+    }
+
+    if (gst_pad_is_linked(queuePad)) {
+        qCDebug(VideoWallReceiverLog) << "Ignoring additional source pad of stream" << stream->index;
+    } else if (gst_pad_link(pad, queuePad) != GST_PAD_LINK_OK) {
+        qCCritical(VideoWallReceiverLog) << "Unable to link source of stream" << stream->index;
+    }
+
+    gst_object_unref(queuePad);
+}
+
+void
+GstVideoWallReceiver::_onWallDecoderPad(GstElement* element, GstPad* pad, gpointer data)
+{
+    Q_UNUSED(element)
+
+    WallStream_t* stream = static_cast<WallStream_t*>(data);
+
+    if (stream->mixerPad != nullptr) {
+        qCDebug(VideoWallReceiverLog) << "Ignoring additional decoder pad of stream" << stream->index;
+        return;
+    }
+
+    stream->receiver->_linkWallDecoder(stream, pad);
+}
+
+GstPadProbeReturn
+GstVideoWallReceiver::_wallFrameProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+
+    WallStream_t* stream = static_cast<WallStream_t*>(user_data);
+
+    if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+        stream->lastFrameTime = QDateTime::currentSecsSinceEpoch();
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstEvent* event = gst_pad_probe_info_get_event(info);
+
+    if (event != nullptr && GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+        GstCaps* caps = nullptr;
+        gst_event_parse_caps(event, &caps);
+
+        const GstStructure* s = (caps != nullptr && !gst_caps_is_empty(caps)) ? gst_caps_get_structure(caps, 0) : nullptr;
+        gint width = 0;
+        gint height = 0;
+
+        if (s != nullptr && gst_structure_get_int(s, "width", &width) && gst_structure_get_int(s, "height", &height)) {
+            const quint32 videoSize = (static_cast<quint32>(width) << 16) | static_cast<quint32>(height);
+            if (stream->videoSize.fetchAndStoreRelaxed(videoSize) != videoSize) {
+                GstVideoWallReceiver* receiver = stream->receiver;
+                receiver->_slotHandler.dispatch([receiver](){
+                    receiver->_layoutTiles();
+                });
+            }
+        }
+    }
+
+    return GST_PAD_PROBE_OK;
+}
+
+gboolean
+GstVideoWallReceiver::_onWallBusMessage(GstBus* bus, GstMessage* msg, gpointer data)
+{
+    Q_UNUSED(bus)
+    Q_UNUSED(data)
+
+    if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR) {
+        gchar* debug = nullptr;
+        GError* error = nullptr;
+
+        gst_message_parse_error(msg, &error, &debug);
+
+        if (debug != nullptr) {
+            qCDebug(VideoWallReceiverLog) << "GStreamer debug: " << debug;
+            g_free(debug);
+            debug = nullptr;
+        }
+
+        // A failing stream only takes its own tile down, the watchdog reports it as timed out
+        if (error != nullptr) {
+            qCWarning(VideoWallReceiverLog) << "GStreamer error from" << GST_OBJECT_NAME(GST_MESSAGE_SRC(msg)) << ":" << error->message;
+            g_error_free(error);
+            error = nullptr;
+        }
+    }
+
+    return TRUE;
+}
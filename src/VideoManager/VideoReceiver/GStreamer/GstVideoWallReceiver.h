@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+/**
+ * @file
+ *   @brief QGC Video Wall Receiver
+ */
+
+#pragma once
+
+#include "GstVideoReceiver.h"
+
+#include <QtCore/QList>
+#include <QtCore/QSize>
+#include <QtCore/QStringList>
+
+Q_DECLARE_LOGGING_CATEGORY(VideoWallReceiverLog)
+
+/// Decodes several streams in a single pipeline and composites them on the GPU into one video sink, so a wall of
+/// streams needs one GL context and one texture instead of a full pipeline per stream.
+///
+///     source0-->queue-->decodebin3--+
+///     source1-->queue-->decodebin3--+-->glvideomixer-->capsfilter-->_wallSink
+///     ...                           |
+///
+/// The composited frame and its tiles are sized to the wall as it is shown, so small tiles are scaled down on the
+/// GPU instead of being rendered at the stream resolution.
+class GstVideoWallReceiver : public GstVideoReceiver
+{
+    Q_OBJECT
+
+public:
+    explicit GstVideoWallReceiver(QObject* parent = nullptr);
+    ~GstVideoWallReceiver(void);
+
+signals:
+    void onStartWallComplete(STATUS status);
+    void onStopWallComplete(STATUS status);
+    /// A tile started or stopped receiving decoded frames
+    void wallStreamChanged(int index, bool active);
+
+public slots:
+    /// Starts decoding the streams into one video sink, tiles are filled row by row
+    ///     @param columns Tiles per row, 0 picks the squarest layout
+    void startWall(const QStringList& uris, void* sink, int columns, unsigned timeout);
+    void stopWall(void);
+    /// Size the wall is shown at on screen
+    void setWallSize(QSize size);
+
+protected slots:
+    void _watchdog(void) override;
+
+private:
+    typedef struct {
+        GstVideoWallReceiver*   receiver        = nullptr;
+        int                     index           = 0;
+        QString                 uri;
+        GstElement*             source          = nullptr;
+        GstElement*             queue           = nullptr;
+        GstElement*             decoder         = nullptr;
+        GstPad*                 mixerPad        = nullptr;
+        QAtomicInteger<qint64>  lastFrameTime   = 0;
+        QAtomicInteger<quint32> videoSize       = 0;        ///< Width in the high, height in the low 16 bits
+        bool                    active          = false;
+    } WallStream_t;
+
+    bool _addWallStream(int index, const QString& uri);
+    void _linkWallDecoder(WallStream_t* stream, GstPad* pad);
+    void _layoutTiles(void);
+    void _shutdownWall(void);
+
+    static void _onWallSourcePad(GstElement* element, GstPad* pad, gpointer data);
+    static void _onWallDecoderPad(GstElement* element, GstPad* pad, gpointer data);
+    static GstPadProbeReturn _wallFrameProbe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static gboolean _onWallBusMessage(GstBus* bus, GstMessage* message, gpointer user_data);
+
+    GstElement*             _wallPipeline   = nullptr;
+    GstElement*             _mixer          = nullptr;
+    GstElement*             _wallCaps       = nullptr;
+    GstElement*             _wallSink       = nullptr;
+    QList<WallStream_t*>    _wallStreams;
+    int                     _columns        = 1;
+    unsigned                _wallTimeout    = 0;
+    QSize                   _wallSize       = QSize(1280, 720);
+
+    static constexpr int _kMinTileSize = 16;
+};
@@ -30,9 +30,19 @@ QtMultimediaReceiver::QtMultimediaReceiver(QObject *parent)
     , _captureSession(new QMediaCaptureSession(this))
     , _mediaRecorder(new QMediaRecorder(this))
     , _frameTimer(new QTimer(this))
+    , _latencyStatsTimer(new QTimer(this))
 {
     _captureSession->setRecorder(_mediaRecorder);
 
+    // Frames are taken from the producing thread, they are not worth a queued signal each
+    _frameSink = new QVideoSink(this);
+    (void) connect(_frameSink, &QVideoSink::videoFrameChanged, this, &QtMultimediaReceiver::_onFrame, Qt::DirectConnection);
+    _mediaPlayer->setVideoSink(_frameSink);
+    _frameClock.start();
+
+    _latencyStatsTimer->setInterval(1000);
+    (void) connect(_latencyStatsTimer, &QTimer::timeout, this, &QtMultimediaReceiver::_emitLatencyStats);
+
     (void) connect(_mediaPlayer, &QMediaPlayer::playingChanged, this, &QtMultimediaReceiver::streamingChanged);
     (void) connect(_mediaPlayer, &QMediaPlayer::hasVideoChanged, this, &QtMultimediaReceiver::decodingChanged);
     (void) connect(_mediaPlayer, &QMediaPlayer::playbackStateChanged, this, [this](QMediaPlayer::PlaybackState newState){
@@ -135,8 +145,6 @@ VideoReceiver *QtMultimediaReceiver::createVideoReceiver(QObject *parent)
 
 void QtMultimediaReceiver::start(const QString &uri, unsigned timeout, int buffer)
 {
-    Q_UNUSED(buffer);
-
     qCDebug(QtMultimediaReceiverLog) << Q_FUNC_INFO;
 
     if (_mediaPlayer->isPlaying()) {
@@ -154,6 +162,20 @@ void QtMultimediaReceiver::start(const QString &uri, unsigned timeout, int buffe
 
     _frameTimer->setInterval(timeout);
 
+    // Low latency mode only ever holds the newest frame
+    qsizetype poolSize = _kDefaultPoolSize;
+    if (buffer < 0) {
+        poolSize = 1;
+    } else if (buffer > 0) {
+        poolSize = qBound<qsizetype>(1, buffer / _kFrameIntervalMSecs, _kMaxPoolSize);
+    }
+    {
+        QMutexLocker lock(&_framePoolSync);
+        _framePool.capacity = poolSize;
+    }
+    _resetLatencyStats();
+    qCDebug(QtMultimediaReceiverLog) << "Frame pool size" << poolSize;
+
     // QAbstractVideoBuffer *buffer = _videoSink->videoFrame()->videoBuffer();
 
     /*if (!_mediaPlayer->hasVideo()) {
@@ -220,7 +242,11 @@ void QtMultimediaReceiver::startDecoding(void *sink)
     _rhi = _videoSink->rhi();
     _videoSink->setSubtitleText("");
 
-    _mediaPlayer->setVideoSink(_videoSink);
+    // With the RHI of the display the backend can hand over textures, which the display sink uses as they are
+    _frameSink->setRhi(_rhi);
+    _loggedFrameHandle = false;
+    _resetLatencyStats();
+    _latencyStatsTimer->start();
 
     qCDebug(QtMultimediaReceiverLog) << "Decoding";
 
@@ -238,8 +264,13 @@ void QtMultimediaReceiver::stopDecoding()
     }
 
     (void) disconnect(_videoSizeUpdater);
-    _mediaPlayer->setVideoSink(nullptr);
+    (void) disconnect(_videoFrameUpdater);
+    _latencyStatsTimer->stop();
     _videoSink = nullptr;
+    {
+        QMutexLocker lock(&_framePoolSync);
+        _framePool.frames.clear();
+    }
 
     qCDebug(QtMultimediaReceiverLog) << "Stopped Decoding";
 
@@ -323,3 +354,104 @@ void QtMultimediaReceiver::takeScreenshot(const QString &imageFile)
 
     emit onTakeScreenshotComplete(STATUS_NOT_IMPLEMENTED);
 }
+
+void QtMultimediaReceiver::_onFrame(const QVideoFrame &frame)
+{
+    if (!frame.isValid()) {
+        return;
+    }
+
+    const qint64 arrivalUSecs = _frameClock.nsecsElapsed() / 1000;
+
+    QMutexLocker lock(&_framePoolSync);
+
+    // Frames reference backend buffers, the bounded pool lets the backend recycle its buffers instead of allocating
+    while (_framePool.frames.count() >= _framePool.capacity) {
+        (void) _framePool.frames.dequeue();
+        _framePool.droppedFrames++;
+    }
+    _framePool.frames.enqueue({ frame, arrivalUSecs });
+
+    const qint64 startTime = frame.startTime();
+    if ((_framePool.lastStartTime >= 0) && (startTime > _framePool.lastStartTime)) {
+        const double deviation = qAbs(static_cast<double>((arrivalUSecs - _framePool.lastArrival) - (startTime - _framePool.lastStartTime)));
+        _framePool.jitterUSecs += (deviation - _framePool.jitterUSecs) / 16.0;
+    }
+    _framePool.lastArrival = arrivalUSecs;
+    _framePool.lastStartTime = startTime;
+
+    if (!_framePool.presentPending) {
+        _framePool.presentPending = true;
+        (void) QMetaObject::invokeMethod(this, &QtMultimediaReceiver::_presentFrame, Qt::QueuedConnection);
+    }
+}
+
+void QtMultimediaReceiver::_presentFrame()
+{
+    PooledFrame_t pooledFrame;
+    bool morePending;
+
+    {
+        QMutexLocker lock(&_framePoolSync);
+        if (_framePool.frames.isEmpty()) {
+            _framePool.presentPending = false;
+            return;
+        }
+        pooledFrame = _framePool.frames.dequeue();
+        morePending = !_framePool.frames.isEmpty();
+        _framePool.presentPending = morePending;
+
+        const double frameAge = static_cast<double>((_frameClock.nsecsElapsed() / 1000) - pooledFrame.arrivalUSecs);
+        _framePool.frameAgeUSecs += (frameAge - _framePool.frameAgeUSecs) / 16.0;
+        _framePool.presentedFrames++;
+    }
+
+    if (morePending) {
+        (void) QMetaObject::invokeMethod(this, &QtMultimediaReceiver::_presentFrame, Qt::QueuedConnection);
+    }
+
+    if (!_videoSink) {
+        return;
+    }
+
+    if (!_loggedFrameHandle) {
+        _loggedFrameHandle = true;
+        qCDebug(QtMultimediaReceiverLog) << "Frame format" << pooledFrame.frame.pixelFormat()
+                                         << "texture:" << (pooledFrame.frame.handleType() == QVideoFrame::RhiTextureHandle);
+    }
+
+    _videoSink->setVideoFrame(pooledFrame.frame);
+}
+
+void QtMultimediaReceiver::_resetLatencyStats()
+{
+    QMutexLocker lock(&_framePoolSync);
+    _framePool.lastArrival = 0;
+    _framePool.lastStartTime = -1;
+    _framePool.jitterUSecs = 0;
+    _framePool.frameAgeUSecs = 0;
+    _framePool.droppedFrames = 0;
+    _framePool.presentedFrames = 0;
+}
+
+void QtMultimediaReceiver::_emitLatencyStats()
+{
+    double jitterMSecs;
+    double frameAgeMSecs;
+    quint64 droppedFrames;
+    quint64 presentedFrames;
+
+    {
+        QMutexLocker lock(&_framePoolSync);
+        jitterMSecs = _framePool.jitterUSecs / 1000.0;
+        frameAgeMSecs = _framePool.frameAgeUSecs / 1000.0;
+        droppedFrames = _framePool.droppedFrames;
+        presentedFrames = _framePool.presentedFrames;
+    }
+
+    qCDebug(QtMultimediaReceiverLog) << "Latency stats" << "jitter(ms):" << jitterMSecs << "frame age(ms):" << frameAgeMSecs
+                                     << "presented:" << presentedFrames << "dropped:" << droppedFrames;
+
+    // Decoding happens inside QtMultimedia, its time isn't known here
+    emit latencyStatsChanged(jitterMSecs, 0, frameAgeMSecs, droppedFrames);
+}
@@ -12,6 +12,10 @@
 #include <QtCore/QString>
 #include <QtCore/QMetaObject>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QQueue>
+#include <QtMultimedia/QVideoFrame>
 
 #include "VideoReceiver.h"
 
@@ -26,6 +30,10 @@ class QTimer;
 class QQuickItem;
 class QQuickVideoOutput;
 
+/// Frames of the player or capture session go to an internal sink first. From there a bounded pool of frames is
+/// handed to the display sink on the GUI thread, the oldest frames are dropped when the GUI can't keep up, so a
+/// stalled frame never holds up the capture. The internal sink shares the RHI of the display sink, so the backend
+/// can deliver frames as textures instead of mapped memory.
 class QtMultimediaReceiver : public VideoReceiver
 {
     Q_OBJECT
@@ -48,7 +56,13 @@ public slots:
     void takeScreenshot(const QString &imageFile) override;
 
 protected:
+    void _onFrame(const QVideoFrame &frame);
+    void _presentFrame();
+    void _emitLatencyStats();
+    void _resetLatencyStats();
+
     QMediaPlayer *_mediaPlayer = nullptr;
+    QVideoSink *_frameSink = nullptr;
     QVideoSink *_videoSink = nullptr;
     QMediaCaptureSession *_captureSession = nullptr;
     QMediaRecorder *_mediaRecorder = nullptr;
@@ -58,4 +72,32 @@ protected:
     QRhi *_rhi = nullptr;
     const QIODevice *_streamDevice;
     QQuickVideoOutput *_videoOutput = nullptr;
+
+    typedef struct {
+        QVideoFrame frame;
+        qint64      arrivalUSecs;
+    } PooledFrame_t;
+
+    /// Filled on the thread delivering the frames, emptied on the GUI thread
+    typedef struct {
+        QQueue<PooledFrame_t> frames;
+        qsizetype   capacity        = _kDefaultPoolSize;
+        bool        presentPending  = false;
+        qint64      lastArrival     = 0;
+        qint64      lastStartTime   = -1;
+        double      jitterUSecs     = 0;        ///< Smoothed variation of the arrival interval against the frame time interval, RFC 3550 style
+        double      frameAgeUSecs   = 0;        ///< Smoothed arrival to hand over to the display sink
+        quint64     droppedFrames   = 0;
+        quint64     presentedFrames = 0;
+    } FramePool_t;
+
+    QMutex _framePoolSync;
+    FramePool_t _framePool;
+    QElapsedTimer _frameClock;
+    QTimer *_latencyStatsTimer = nullptr;
+    bool _loggedFrameHandle = false;
+
+    static constexpr qsizetype _kDefaultPoolSize = 3;
+    static constexpr qsizetype _kMaxPoolSize = 8;
+    static constexpr int _kFrameIntervalMSecs = 33;     ///< Used to turn a buffer length into frames
 };
@@ -30,7 +30,7 @@ UVCReceiver::UVCReceiver(QObject *parent)
 {
     _captureSession->setCamera(_camera);
     _captureSession->setImageCapture(_imageCapture);
-    _captureSession->setVideoSink(_videoSink);
+    _captureSession->setVideoSink(_frameSink);
 
     (void) connect(_captureSession, &QMediaCaptureSession::cameraChanged, this, [this] {
         adjustAspectRatio();
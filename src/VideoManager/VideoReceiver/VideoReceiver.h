@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QObject>
 #include <QtCore/QSize>
 
@@ -34,6 +35,7 @@ public:
         FILE_FORMAT_MKV = FILE_FORMAT_MIN,
         FILE_FORMAT_MOV,
         FILE_FORMAT_MP4,
+        FILE_FORMAT_TS,
         FILE_FORMAT_MAX
     } FILE_FORMAT;
 
@@ -54,6 +56,17 @@ signals:
     void recordingChanged(bool active);
     void recordingStarted(void);
     void videoSizeChanged(QSize size);
+    /// Emitted about once a second while decoding. Times are averages over the recent frames.
+    ///     @param jitterMSecs Variation of the frame arrival from the source against the frame timestamps
+    ///     @param decodeMSecs Time from decoder input to video sink input
+    ///     @param frameAgeMSecs Time from arrival from the source to video sink input
+    ///     @param droppedFrames Frames dropped by the decoder or the video sink since decoding started
+    void latencyStatsChanged(double jitterMSecs, double decodeMSecs, double frameAgeMSecs, quint64 droppedFrames);
+    /// Emitted with the latency stats, percentage of frames lost since the previous one, 100 while stalled
+    void frameLossChanged(double lossPercent);
+    /// Emitted once when the source stops delivering frames for a short time. The stream is kept running, it is only
+    /// stopped with timeout() once the outage lasts for the full timeout.
+    void stalled(void);
 
     void onStartComplete(STATUS status);
     void onStopComplete(STATUS status);
@@ -75,4 +88,17 @@ public slots:
     virtual void startRecording(const QString& videoFile, FILE_FORMAT format) = 0;
     virtual void stopRecording(void) = 0;
     virtual void takeScreenshot(const QString& imageFile) = 0;
+    // seconds:
+    //      seconds of encoded video kept while not recording, a recording starts from the oldest keyframe kept
+    //      used from the next start()
+    virtual void setRecordingPreRoll(unsigned seconds) { Q_UNUSED(seconds) }
+    // enabled:
+    //      mux a KLV metadata stream next to the video, only supported by FILE_FORMAT_TS
+    //      used from the next startRecording()
+    virtual void setRecordingMetadata(bool enabled) { Q_UNUSED(enabled) }
+    // klv:
+    //      KLV packet written to the metadata stream of the recording, timestamped with the last recorded video frame
+    virtual void writeMetadata(const QByteArray& klv) { Q_UNUSED(klv) }
+    // asks the source for a keyframe, so decoding recovers without waiting for the next regular one
+    virtual void requestKeyframe(void) {}
 };
@@ -11,6 +11,9 @@
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "OsmParser.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "Viewer3DUtils.h"
 
 
 CityMapGeometry::CityMapGeometry()
@@ -24,6 +27,9 @@ CityMapGeometry::CityMapGeometry()
 
     setOsmFilePath(_viewer3DSettings->osmFilePath()->rawValue());
     connect(_viewer3DSettings->osmFilePath(), &Fact::rawValueChanged, this, &CityMapGeometry::setOsmFilePath);
+
+    _activeVehicleChangedEvent(qgcApp()->toolbox()->multiVehicleManager()->activeVehicle());
+    connect(qgcApp()->toolbox()->multiVehicleManager(), &MultiVehicleManager::activeVehicleChanged, this, &CityMapGeometry::_activeVehicleChangedEvent);
 }
 
 void CityMapGeometry::setModelName(QString modelName)
@@ -65,6 +71,47 @@ bool CityMapGeometry::loadOsmMap()
     return false;
 }
 
+void CityMapGeometry::_activeVehicleChangedEvent(Vehicle *vehicle)
+{
+    if(_activeVehicle){
+        disconnect(_activeVehicle, &Vehicle::coordinateChanged, this, &CityMapGeometry::_activeVehicleCoordinateChanged);
+    }
+
+    _activeVehicle = vehicle;
+    if(_activeVehicle){
+        connect(_activeVehicle, &Vehicle::coordinateChanged, this, &CityMapGeometry::_activeVehicleCoordinateChanged);
+    }
+    _activeVehicleCoordinateChanged(QGeoCoordinate());
+}
+
+void CityMapGeometry::_activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate)
+{
+    Q_UNUSED(newCoordinate);
+
+    if(!_osmParser || !_osmParser->mapLoaded()){
+        return;
+    }
+
+    // The buildings are only uploaded again once the vehicle moves into range of other chunks
+    if(_osmParser->chunksInRange(viewCenter(), kViewRadius) != _visibleChunks){
+        updateViewer();
+    }
+}
+
+QVector2D CityMapGeometry::viewCenter() const
+{
+    if(_activeVehicle && _osmParser){
+        const QGeoCoordinate coordinate = _activeVehicle->coordinate();
+        if(coordinate.isValid() && (coordinate.latitude() || coordinate.longitude())){
+            const QVector3D localPoint = mapGpsToLocalPoint(QGeoCoordinate(coordinate.latitude(), coordinate.longitude(), 0), _osmParser->getGpsRef());
+            return QVector2D(localPoint.x(), localPoint.y());
+        }
+    }
+
+    // The center of the map
+    return QVector2D(0, 0);
+}
+
 void CityMapGeometry::updateViewer()
 {
     clear();
@@ -74,7 +121,8 @@ void CityMapGeometry::updateViewer()
     }
 
     if(_osmParser->mapLoaded()){
-        _vertexData = _osmParser->buildingToMesh();
+        _visibleChunks = _osmParser->chunksInRange(viewCenter(), kViewRadius);
+        _vertexData = _osmParser->buildingToMesh(_visibleChunks);
 
         int stride = 3 * sizeof(float);
         if(!_vertexData.isEmpty()){
@@ -95,5 +143,6 @@ void CityMapGeometry::clearViewer()
 {
     clear();
     _vertexData.clear();
+    _visibleChunks.clear();
     update();
 }
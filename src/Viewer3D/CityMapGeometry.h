@@ -10,12 +10,15 @@
 #pragma once
 
 #include <QtCore/QString>
+#include <QtGui/QVector2D>
+#include <QtPositioning/QGeoCoordinate>
 #include <QtQuick3D/QQuick3DGeometry>
 
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
 class Viewer3DSettings;
 class OsmParser;
+class Vehicle;
 
 class CityMapGeometry : public QQuick3DGeometry
 {
@@ -47,6 +50,9 @@ signals:
 private:
     void updateViewer();
     void clearViewer();
+    QVector2D viewCenter() const;
+
+    static constexpr float kViewRadius = 2000.0f; ///< Buildings are uploaded for the chunks within this range of the vehicle, in meters
 
     QString _modelName;
     QString _osmFilePath;
@@ -54,7 +60,11 @@ private:
     OsmParser *_osmParser;
     bool _mapLoadedFlag;
     Viewer3DSettings* _viewer3DSettings = nullptr;
+    Vehicle* _activeVehicle = nullptr;
+    QList<quint64> _visibleChunks;
 
 private slots:
     void setOsmFilePath(QVariant value);
+    void _activeVehicleChangedEvent(Vehicle* vehicle);
+    void _activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate);
 };
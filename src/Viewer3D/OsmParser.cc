@@ -10,18 +10,8 @@
 #include "OsmParser.h"
 #include "QGCApplication.h"
 #include "SettingsManager.h"
-#include "OsmParserThread.h"
-#include "earcut.hpp"
 
-typedef union {
-    uint array[3];
-
-    struct {
-        uint x;
-        uint y;
-        uint z;
-    } axis;
-} vec3i;
+#include <cmath>
 
 OsmParser::OsmParser(QObject *parent)
     : QObject{parent}
@@ -75,16 +65,21 @@ void OsmParser::osmParserFinished(bool isValid)
             _coordinateMin = _osmParserWorker->coordinateMin;
             _coordinateMax = _osmParserWorker->coordinateMax;
         }
+        _meshChunks = _osmParserWorker->takeMeshChunks();
         _mapLoadedFlag = true;
         emit mapChanged();
-        qDebug() << _osmParserWorker->mapBuildings.size() << " Buildings loaded!!!";
+
+        qsizetype buildingCount = 0;
+        for(const OsmParserThread::MeshChunk_t& chunk : std::as_const(_meshChunks)){
+            buildingCount += chunk.buildings.size();
+        }
+        qDebug() << buildingCount << " Buildings loaded!!!";
     }
 }
 
 void OsmParser::parseOsmFile(QString filePath)
 {
-    _osmParserWorker->mapNodes.clear();
-    _osmParserWorker->mapBuildings.clear();
+    _meshChunks.clear();
     _gpsRefSet = false;
     _mapLoadedFlag = false;
     resetGpsRef();
@@ -92,134 +87,60 @@ void OsmParser::parseOsmFile(QString filePath)
     _osmParserWorker->start(filePath);
 }
 
-QByteArray OsmParser::buildingToMesh()
+QList<quint64> OsmParser::chunksInRange(const QVector2D &center, float radius) const
 {
-    QByteArray vertexData;
-    QMapIterator<uint64_t, OsmParserThread::BuildingType_t> ii(_osmParserWorker->mapBuildings);
-
-    for (auto ii = _osmParserWorker->mapBuildings.begin(), end = _osmParserWorker->mapBuildings.end(); ii != end; ++ii) {
-        float bld_height = 0;
-        // std::vector<std::array<float, 2> > bld_points;
-        // std::vector<std::vector<std::array<float, 2> > > polygon;
-
-        std::vector<std::array<float, 2> > all_bld_points;
-        std::vector<std::array<float, 2> > bld_points;
-        std::vector<std::vector<std::array<float, 2> > > polygon;
-        std::vector<QVector3D> triangulated_mesh;
-
-        //        bld_height = (ii.value().height >= ii.value().levels * _buildingLevelHeight)?(ii.value().height):(ii.value().levels * _buildingLevelHeight);
-
-        if(ii.value().height > 0){
-            bld_height = ii.value().height;
-        }else if(ii.value().levels > 0){
-            bld_height = (float)(ii.value().levels) * _buildingLevelHeight;
-        }else{
-            continue;
-        }
-
-        for(unsigned int jj=0; jj<ii.value().points_local.size(); jj++) {
-            bld_points.push_back({ii.value().points_local[jj].x(), ii.value().points_local[jj].y()});
-            all_bld_points.push_back({ii.value().points_local[jj].x(), ii.value().points_local[jj].y()});
-        }
-        polygon.push_back(bld_points);
-
-        bld_points.clear();
-        for(unsigned int jj=0; jj<ii.value().points_local_inner.size(); jj++) {
-            bld_points.push_back({ii.value().points_local_inner[jj].x(), ii.value().points_local_inner[jj].y()});
-            all_bld_points.push_back({ii.value().points_local_inner[jj].x(), ii.value().points_local_inner[jj].y()});
-        }
-        if(bld_points.size() > 0){
-            polygon.push_back(bld_points);
-        }
-
-        std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon);
-
-        for(uint i_i=0; i_i<indices.size(); i_i+=3) {
-            // mesh for roof
-            uint n_idx = indices[i_i];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
-            n_idx = indices[i_i+1];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
-            n_idx = indices[i_i+2];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
-
-            // mesh for floor
-            n_idx = indices[i_i+2];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
-            n_idx = indices[i_i+1];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
-            n_idx = indices[i_i];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
-        }
-
-        if(bld_height > 0) {
-            trianglateWallsExtrudedPolygon(triangulated_mesh, ii.value().points_local, bld_height, 0, 0); // mesh for wall outside
-            trianglateWallsExtrudedPolygon(triangulated_mesh, ii.value().points_local, bld_height, 1, 0);// mesh for wall inside
-
-            trianglateWallsExtrudedPolygon(triangulated_mesh, ii.value().points_local_inner, bld_height, 0, 0); // mesh for wall outside
-            trianglateWallsExtrudedPolygon(triangulated_mesh, ii.value().points_local_inner, bld_height, 1, 0);// mesh for wall inside
-        }
-
-        QByteArray vertexData_tmp(triangulated_mesh.size() * 3 * sizeof(float), Qt::Initialization::Uninitialized);
-        float *p = reinterpret_cast<float *>(vertexData_tmp.data());
-
-        for(uint i_m=0; i_m<triangulated_mesh.size(); i_m++) {
-            *p++ =  (float)triangulated_mesh[i_m].x(); *p++ =  (float)triangulated_mesh[i_m].y(); *p++ =  (float)triangulated_mesh[i_m].z();
+    QList<quint64> chunks;
+    const float chunkSize = OsmParserThread::kChunkSize;
+    const int minX = static_cast<int>(std::floor((center.x() - radius) / chunkSize));
+    const int maxX = static_cast<int>(std::floor((center.x() + radius) / chunkSize));
+    const int minY = static_cast<int>(std::floor((center.y() - radius) / chunkSize));
+    const int maxY = static_cast<int>(std::floor((center.y() + radius) / chunkSize));
+
+    for(int x=minX; x<=maxX; x++){
+        for(int y=minY; y<=maxY; y++){
+            const quint64 key = OsmParserThread::chunkKey(x, y);
+            if(!_meshChunks.contains(key)){
+                continue;
+            }
+
+            // Distance from the center to the closest point of the grid square
+            const float dx = fmax(0.0f, fmax(x * chunkSize - center.x(), center.x() - (x + 1) * chunkSize));
+            const float dy = fmax(0.0f, fmax(y * chunkSize - center.y(), center.y() - (y + 1) * chunkSize));
+            if(dx * dx + dy * dy <= radius * radius){
+                chunks.append(key);
+            }
         }
-
-        ii.value().triangulated_mesh.insert(ii.value().triangulated_mesh.begin(), triangulated_mesh.begin(), triangulated_mesh.end());
-        vertexData.append(vertexData_tmp);
     }
-    return vertexData;
+    return chunks;
 }
 
-void OsmParser::trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector2D> verticesCcw, float h, bool inverseOrder, bool duplicateStartEndPoint)
+QByteArray OsmParser::buildingToMesh(const QList<quint64> &chunks) const
 {
-    std::vector<QVector3D> tmp_rec_ccw(4);
-    uint vertices_size = verticesCcw.size() - (uint)(duplicateStartEndPoint);
-
-    if(inverseOrder) {
-        for(uint i_p=0; i_p<vertices_size; i_p++) {
-            int i_p_p = (i_p < vertices_size-1)?(i_p+1):(0);
-            tmp_rec_ccw[0] = QVector3D(verticesCcw[i_p_p].x(), verticesCcw[i_p_p].y(), 0);
-            tmp_rec_ccw[1] = QVector3D(verticesCcw[i_p].x(), verticesCcw[i_p].y(), 0);
-            tmp_rec_ccw[2] = QVector3D(verticesCcw[i_p].x(), verticesCcw[i_p].y(), h);
-            tmp_rec_ccw[3] = QVector3D(verticesCcw[i_p_p].x(), verticesCcw[i_p_p].y(), h);
-            trianglateRectangle(triangulatedMesh, tmp_rec_ccw, 0);
-        }
-        trianglateRectangle(triangulatedMesh, tmp_rec_ccw, 1);
-    } else {
-        for(uint i_p=0; i_p<vertices_size; i_p++) {
-            int i_p_p = (i_p < vertices_size-1)?(i_p+1):(0);
-            tmp_rec_ccw[0] = QVector3D(verticesCcw[i_p].x(), verticesCcw[i_p].y(), 0);
-            tmp_rec_ccw[1] = QVector3D(verticesCcw[i_p_p].x(), verticesCcw[i_p_p].y(), 0);
-            tmp_rec_ccw[2] = QVector3D(verticesCcw[i_p_p].x(), verticesCcw[i_p_p].y(), h);
-            tmp_rec_ccw[3] = QVector3D(verticesCcw[i_p].x(), verticesCcw[i_p].y(), h);
-            trianglateRectangle(triangulatedMesh, tmp_rec_ccw, 0);
+    qsizetype vertexCount = 0;
+    for(const quint64 key : chunks){
+        const auto chunk = _meshChunks.constFind(key);
+        if(chunk != _meshChunks.constEnd()){
+            vertexCount += chunk->vertices.size();
         }
-        trianglateRectangle(triangulatedMesh, tmp_rec_ccw, 1);
     }
-}
 
-void OsmParser::trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector3D> verticesCcw, bool invertNormal)
-{
-    std::vector<vec3i> mesh_set_idx;
-    mesh_set_idx.resize(2);
-
-    if(invertNormal) {
-        mesh_set_idx[0] = {{3, 1, 0}};
-        mesh_set_idx[1] = {{3, 2, 1}};
-    } else {
-        mesh_set_idx[0] = {{0, 1, 3}};
-        mesh_set_idx[1] = {{1, 2, 3}};
-    }
+    QByteArray vertexData(vertexCount * 3 * sizeof(float), Qt::Initialization::Uninitialized);
+    float *p = reinterpret_cast<float *>(vertexData.data());
 
-    uint idx_tmp;
+    for(const quint64 key : chunks){
+        const auto chunk = _meshChunks.constFind(key);
+        if(chunk == _meshChunks.constEnd()){
+            continue;
+        }
 
-    for(uint i_m=0; i_m<mesh_set_idx.size(); i_m++) {
-        for(uint i_v=0; i_v<3; i_v++) {
-            idx_tmp = mesh_set_idx[i_m].array[i_v];
-            triangulatedMesh.push_back(QVector3D(verticesCcw[idx_tmp].x(), verticesCcw[idx_tmp].y(), verticesCcw[idx_tmp].z()));
+        const QVector3D* vertex = chunk->vertices.data();
+        for(const OsmParserThread::BuildingMesh_t& building : chunk->buildings){
+            // The mesh is stored with a unit height, so only its roof is moved to the building height
+            const float bld_height = (building.height > 0)?(building.height):(building.levels * _buildingLevelHeight);
+            for(quint32 i_m=0; i_m<building.vertexCount; i_m++, vertex++){
+                *p++ = vertex->x(); *p++ = vertex->y(); *p++ = vertex->z() * bld_height;
+            }
         }
     }
+    return vertexData;
 }
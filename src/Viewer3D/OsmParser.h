@@ -15,10 +15,11 @@
 #include <QtPositioning/QGeoCoordinate>
 #include <QtCore/QVariant>
 
+#include "OsmParserThread.h"
+
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
 class Viewer3DSettings;
-class OsmParserThread;
 
 class OsmParser : public QObject
 {
@@ -37,14 +38,17 @@ public:
     float buildingLevelHeight(void){return _buildingLevelHeight;}
     void parseOsmFile(QString filePath);
 
-    QByteArray buildingToMesh();
+    /// @return Keys of the building chunks within the radius of the local point, in a stable order
+    QList<quint64> chunksInRange(const QVector2D& center, float radius) const;
+
+    /// Vertex data of the buildings in the chunks, scaled to the current building level height
+    QByteArray buildingToMesh(const QList<quint64>& chunks) const;
 
-    void trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector2D> verticesCcw, float h, bool inverseOrder=0, bool duplicateStartEndPoint=0);
-    void trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector3D> verticesCcw, bool invertNormal);
     std::pair<QGeoCoordinate, QGeoCoordinate> getMapBoundingBoxCoordinate(){ return std::pair(_coordinateMin, _coordinateMax);}
 
 private:
     OsmParserThread* _osmParserWorker;
+    OsmParserThread::MeshChunks_t _meshChunks;
     QGeoCoordinate _gpsRefPoint;
     QGeoCoordinate _coordinateMin, _coordinateMax; //Osm map bounding boxes in global coordinate
 
@@ -8,9 +8,37 @@
  ****************************************************************************/
 
 #include "OsmParserThread.h"
+#include "QGCLoggingCategory.h"
 #include "Viewer3DUtils.h"
+#include "earcut.hpp"
 
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QXmlStreamReader>
+
+#include <cmath>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(OsmParserThreadLog, "qgc.viewer3d.osmparserthread")
+
+static_assert(sizeof(QVector3D) == 3 * sizeof(float), "Mesh cache stores QVector3D as raw floats");
+
+typedef union {
+    uint array[3];
+
+    struct {
+        uint x;
+        uint y;
+        uint z;
+    } axis;
+} vec3i;
 
 OsmParserThread::OsmParserThread(QObject *parent)
     : QThread{parent}
@@ -36,121 +64,137 @@ void OsmParserThread::start(QString filePath)
     emit startThread(filePath);
 }
 
-void OsmParserThread::parseOsmFile(QString filePath)
+OsmParserThread::MeshChunks_t OsmParserThread::takeMeshChunks()
+{
+    QMutexLocker lock(&_meshChunksMutex);
+    return std::move(_meshChunks);
+}
+
+quint64 OsmParserThread::chunkKey(const QVector2D &localPoint)
 {
-    mapNodes.clear();
-    mapBuildings.clear();
-    _mapLoadedFlag = false;
+    return chunkKey(static_cast<int>(std::floor(localPoint.x() / kChunkSize)), static_cast<int>(std::floor(localPoint.y() / kChunkSize)));
+}
 
+void OsmParserThread::parseOsmFile(QString filePath)
+{
+    _mapNodes.clear();
+    _mapBuildings.clear();
+    {
+        QMutexLocker lock(&_meshChunksMutex);
+        _meshChunks.clear();
+    }
 
     if(filePath == "Please select an OSM file"){
-        if(_mapLoadedFlag){
-            qDebug("The 3D View has been cleared!");
-        }else{
-            qDebug("No OSM File is selected!");
-        }
+        qCDebug(OsmParserThreadLog) << "No OSM File is selected!";
         return;
     }
 
-    //The QDomDocument class represents an XML document.
-    QDomDocument xml_content;
 // Load xml file as raw data
 #ifdef __unix__
     filePath = QString("/") + filePath;
 #endif
-    QFile f(filePath);
-    if (!f.open(QIODevice::ReadOnly )) {
-        // Error while loading file
-        qDebug() << "Error while loading OSM file" << filePath;
-        return;
-    }
-    qDebug("Loading the OSM file!!!");
-    // Set data into the QDomDocument before processing
-    xml_content.setContent(&f);
-    f.close();
 
-    if(decodeFile(xml_content, mapBuildings, mapNodes, coordinateMin, coordinateMax, gpsRefPoint)){
-        _mapLoadedFlag = true;
-        emit fileParsed(true);
-        return;
+    MeshChunks_t meshChunks;
+    if(!loadMeshCache(filePath, meshChunks)){
+        QFile f(filePath);
+        if (!f.open(QIODevice::ReadOnly )) {
+            // Error while loading file
+            qCWarning(OsmParserThreadLog) << "Error while loading OSM file" << filePath;
+            return;
+        }
+        qCDebug(OsmParserThreadLog) << "Loading the OSM file" << filePath;
+
+        // The file is decoded while it is read, so only the nodes and the buildings are held in memory
+        QXmlStreamReader xml(&f);
+        const bool isValid = decodeFile(xml, coordinateMin, coordinateMax, gpsRefPoint);
+        f.close();
+
+        // Buildings keep their local points only
+        _mapNodes.clear();
+        _mapNodes.squeeze();
+
+        if(!isValid){
+            _mapBuildings.clear();
+            emit fileParsed(false);
+            return;
+        }
+
+        meshChunks = buildMeshChunks();
+        _mapBuildings.clear();
+        _mapBuildings.squeeze();
+
+        saveMeshCache(filePath, meshChunks);
     }
 
-    emit fileParsed(false);
+    {
+        QMutexLocker lock(&_meshChunksMutex);
+        _meshChunks = std::move(meshChunks);
+    }
+    emit fileParsed(true);
 }
 
-bool OsmParserThread::decodeFile(QDomDocument &xml_content, QMap<uint64_t, OsmParserThread::BuildingType_t> &buildingMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordinateMin, QGeoCoordinate &coordinateMax, QGeoCoordinate &gpsRef)
+bool OsmParserThread::decodeFile(QXmlStreamReader &xml, QGeoCoordinate &coordinateMin, QGeoCoordinate &coordinateMax, QGeoCoordinate &gpsRef)
 {
-    QDomElement root = xml_content.documentElement();
-    QDomElement xmlComponent = root.firstChild().toElement();
     QGeoCoordinate tmpGpsRef;
     bool gpsRefIsSet = false;
-    while(!xmlComponent.isNull()) {
-        if(decodeNodeTags(xmlComponent, nodeMap, coordinateMin, coordinateMax, tmpGpsRef)){
-            gpsRefIsSet = true;
-            gpsRef = tmpGpsRef;
+    while(!xml.atEnd()) {
+        if(xml.readNext() != QXmlStreamReader::StartElement){
+            continue;
+        }
+
+        const QStringView tagName = xml.name();
+        if(tagName == u"node" || tagName == u"bounds"){
+            if(decodeNodeTags(xml, coordinateMin, coordinateMax, tmpGpsRef)){
+                gpsRefIsSet = true;
+                gpsRef = tmpGpsRef;
+            }
+        }else if(tagName == u"way"){
+            decodeBuildings(xml, coordinateMin, coordinateMax, gpsRef);
+        }else if(tagName == u"relation"){
+            decodeRelations(xml);
         }
-        decodeBuildings(xmlComponent, buildingMap, nodeMap, coordinateMin, coordinateMax, gpsRef);
-        decodeRelations(xmlComponent, buildingMap, nodeMap, gpsRef);
+    }
 
-        xmlComponent = xmlComponent.nextSibling().toElement();
+    if(xml.hasError()){
+        qCWarning(OsmParserThreadLog) << "Error while parsing OSM file:" << xml.errorString() << "at line" << xml.lineNumber();
+        return false;
     }
     return gpsRefIsSet;
 }
 
-bool OsmParserThread::decodeNodeTags(QDomElement &xmlComponent, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate &gpsRef)
+bool OsmParserThread::decodeNodeTags(QXmlStreamReader &xml, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate &gpsRef)
 {
-    int64_t id_tmp=0;
-    QGeoCoordinate gps_tmp;
-    QString attribute;
+    const QXmlStreamAttributes attributes = xml.attributes();
     bool gpsRefIsSet = false;
 
-    if (xmlComponent.tagName()=="node") {
-
-        attribute = xmlComponent.attribute("id","-1");
-        id_tmp = attribute.toLongLong();
-
-        attribute = xmlComponent.attribute("lat","0");
-        gps_tmp.setLatitude(attribute.toDouble());
-
-        attribute = xmlComponent.attribute("lon","0");
-        gps_tmp.setLongitude(attribute.toDouble());
-
-        gps_tmp.setAltitude(0);
-
+    if (xml.name() == u"node") {
+        const int64_t id_tmp = attributes.value(u"id").toLongLong();
         if(id_tmp > 0) {
-            nodeMap.insert((uint64_t)id_tmp, gps_tmp);
+            _mapNodes.insert((uint64_t)id_tmp, {attributes.value(u"lat").toDouble(), attributes.value(u"lon").toDouble()});
         }
-    }else if(xmlComponent.tagName() == "bounds") {
-        coordMin.setLatitude(xmlComponent.attribute("minlat","0").toFloat());
-        coordMin.setLongitude(xmlComponent.attribute("minlon","0").toFloat());
+    }else{
+        coordMin.setLatitude(attributes.value(u"minlat").toFloat());
+        coordMin.setLongitude(attributes.value(u"minlon").toFloat());
         coordMin.setAltitude(0);
-        coordMax.setLatitude(xmlComponent.attribute("maxlat","0").toFloat());
-        coordMax.setLongitude(xmlComponent.attribute("maxlon","0").toFloat());
+        coordMax.setLatitude(attributes.value(u"maxlat").toFloat());
+        coordMax.setLongitude(attributes.value(u"maxlon").toFloat());
         coordMax.setAltitude(0);
 
         gpsRefIsSet = true;
-        gps_tmp.setLatitude(0.5 * (coordMin.latitude() + coordMax.latitude()));
-        gps_tmp.setLongitude(0.5 * (coordMin.longitude() + coordMax.longitude()));
-        gps_tmp.setAltitude(0);
-        gpsRef = gps_tmp;
+        gpsRef = QGeoCoordinate(0.5 * (coordMin.latitude() + coordMax.latitude()), 0.5 * (coordMin.longitude() + coordMax.longitude()), 0);
     }
     return gpsRefIsSet;
 }
 
-void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate gpsRef)
+void OsmParserThread::decodeBuildings(QXmlStreamReader &xml, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate gpsRef)
 {
-    if (xmlComponent.tagName()!="way"){
-        return;
-    }
-
-    int64_t id_tmp = xmlComponent.attribute("id","0").toLongLong();
+    const int64_t id_tmp = xml.attributes().value(u"id").toLongLong();
     if(id_tmp == 0) {
+        xml.skipCurrentElement();
         return;
     }
     OsmParserThread::BuildingType_t bld_tmp;
-    QGeoCoordinate gps_pt_tmp;
     QVector3D local_pt_tmp;
-    std::vector<QGeoCoordinate> bld_points;
     std::vector<QVector2D> bld_points_local;
     double bld_lon_max, bld_lon_min, bld_lat_max, bld_lat_min;
     double bld_x_max, bld_x_min, bld_y_max, bld_y_min;
@@ -159,21 +203,17 @@ void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t,
     bld_lon_max = bld_lat_max = -1e10;
     bld_lon_min = bld_lat_min = 1e10;
 
-    int64_t ref_id;
-    QDomElement Child = xmlComponent.firstChild().toElement();
-    QString attribute;
-
     bld_tmp.height = 0;
     bld_tmp.levels = 0;
 
-    while (!Child.isNull()) {
-        if (Child.tagName()=="nd") {
-            ref_id = Child.attribute("ref","0").toLongLong();
+    while (xml.readNextStartElement()) {
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == u"nd") {
+            const int64_t ref_id = attributes.value(u"ref").toLongLong();
+            const auto node = _mapNodes.constFind(ref_id);
 
-            if(ref_id > 0) {
-                gps_pt_tmp = nodeMap[ref_id];
-                bld_points.push_back(gps_pt_tmp);
-                local_pt_tmp = mapGpsToLocalPoint(gps_pt_tmp, gpsRef);
+            if(ref_id > 0 && node != _mapNodes.constEnd()) {
+                local_pt_tmp = mapGpsToLocalPoint(QGeoCoordinate(node->lat, node->lon, 0), gpsRef);
                 bld_points_local.push_back(QVector2D(local_pt_tmp.x(), local_pt_tmp.y()));
 
                 bld_x_max = (bld_x_max < local_pt_tmp.x())?(local_pt_tmp.x()):(bld_x_max);
@@ -181,68 +221,56 @@ void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t,
                 bld_x_min = (bld_x_min > local_pt_tmp.x())?(local_pt_tmp.x()):(bld_x_min);
                 bld_y_min = (bld_y_min > local_pt_tmp.y())?(local_pt_tmp.y()):(bld_y_min);
 
-                bld_lon_max = fmax(bld_lon_max, gps_pt_tmp.longitude());
-                bld_lat_max = fmax(bld_lat_max, gps_pt_tmp.latitude());
-                bld_lon_min = fmin(bld_lon_min, gps_pt_tmp.longitude());
-                bld_lat_min = fmin(bld_lat_min, gps_pt_tmp.latitude());
+                bld_lon_max = fmax(bld_lon_max, node->lon);
+                bld_lat_max = fmax(bld_lat_max, node->lat);
+                bld_lon_min = fmin(bld_lon_min, node->lon);
+                bld_lat_min = fmin(bld_lat_min, node->lat);
             }
-        }else if (Child.tagName()=="tag") {
-            attribute = Child.attribute("k","0");
-            if(attribute == "building:levels") {
-                bld_tmp.levels = Child.attribute("v","0").toFloat();
-            }else if(attribute == "height") {
-                bld_tmp.height = Child.attribute("v","0").toFloat();
-            }else if(attribute == "building" && bld_tmp.levels == 0 && bld_tmp.height == 0){
-                QString attribute_2 = Child.attribute("v","0");
-                if(_singleStoreyBuildings.contains(attribute_2)){
+        }else if (xml.name() == u"tag") {
+            const QStringView attribute = attributes.value(u"k");
+            if(attribute == u"building:levels") {
+                bld_tmp.levels = attributes.value(u"v").toFloat();
+            }else if(attribute == u"height") {
+                bld_tmp.height = attributes.value(u"v").toFloat();
+            }else if(attribute == u"building" && bld_tmp.levels == 0 && bld_tmp.height == 0){
+                if(_singleStoreyBuildings.contains(attributes.value(u"v").toString())){
                     bld_tmp.levels = 1;
                 }else{
                     bld_tmp.levels = 2;
                 }
-            }else if(attribute == "leisure" && bld_tmp.levels == 0 && bld_tmp.height == 0){
-                QString attribute_2 = Child.attribute("v","0");
-                if(_doubleStoreyLeisure.contains(attribute_2)){
+            }else if(attribute == u"leisure" && bld_tmp.levels == 0 && bld_tmp.height == 0){
+                if(_doubleStoreyLeisure.contains(attributes.value(u"v").toString())){
                     bld_tmp.levels = 2;
                 }
             }
         }
 
-        Child = Child.nextSibling().toElement();
+        xml.skipCurrentElement();
     }
 
-    if(bld_points.size() > 2) {
-        //        float bld_height = (bld_tmp.height >= bld_tmp.levels * _buildingLevelHeight)?(bld_tmp.height):(bld_tmp.levels * _buildingLevelHeight);
-        //        bld_tmp.height = bld_height;
+    if(bld_points_local.size() > 2) {
         if(bld_tmp.levels > 0 || bld_tmp.height > 0){
             coordMin.setLatitude(fmin(coordMin.latitude(), bld_lat_min));
             coordMin.setLongitude(fmin(coordMin.longitude(), bld_lon_min));
             coordMax.setLatitude(fmax(coordMax.latitude(), bld_lat_max));
             coordMax.setLongitude(fmax(coordMax.longitude(), bld_lon_max));
         }
-        bld_tmp.points_gps = bld_points;
-        bld_tmp.points_local = bld_points_local;
+        bld_tmp.points_local = std::move(bld_points_local);
         bld_tmp.bb_max = QVector2D(bld_x_max, bld_y_max);
         bld_tmp.bb_min = QVector2D(bld_x_min, bld_y_min);
-        bldMap.insert(id_tmp, bld_tmp);
+        _mapBuildings.insert(id_tmp, std::move(bld_tmp));
     }
 }
 
-void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate gpsRef)
+void OsmParserThread::decodeRelations(QXmlStreamReader &xml)
 {
-    if (xmlComponent.tagName()!="relation"){
-        return;
-    }
-
-    int64_t id_tmp = xmlComponent.attribute("id","0").toLongLong();
+    const int64_t id_tmp = xml.attributes().value(u"id").toLongLong();
     if(id_tmp == 0) {
+        xml.skipCurrentElement();
         return;
     }
 
     OsmParserThread::BuildingType_t bld_tmp;
-    int64_t ref_id;
-    QDomElement Child = xmlComponent.firstChild().toElement();
-    QString attribute;
-    QString role;
 
     bld_tmp.height = 0;
     bld_tmp.levels = 0;
@@ -250,34 +278,33 @@ void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t,
     bool isBuilding = false;
     bool isMultipolygon = false;
 
-    while (!Child.isNull()) {
-        if (Child.tagName()=="member") {
-            ref_id = Child.attribute("ref","0").toLongLong();
-            role = Child.attribute("role","0");
-            auto bldItem = bldMap.find(ref_id);
-            if(bldItem != bldMap.end()) {
-                bld_tmp.append(bldItem.value().points_local, role == "inner");
-                bld_tmp.append(bldItem.value().points_gps, role == "inner");
-                bld_tmp.levels = fmax(bld_tmp.levels, bldItem.value().levels);
-                bld_tmp.height = fmax(bld_tmp.height, bldItem.value().height);
-
-                bld_tmp.bb_max[0] = fmax(bld_tmp.bb_max[0], bldItem.value().bb_max[0]);
-                bld_tmp.bb_max[1] = fmax(bld_tmp.bb_max[1], bldItem.value().bb_max[1]);
-                bld_tmp.bb_min[0] = fmin(bld_tmp.bb_min[0], bldItem.value().bb_min[0]);
-                bld_tmp.bb_min[1] = fmin(bld_tmp.bb_min[1], bldItem.value().bb_min[1]);
+    while (xml.readNextStartElement()) {
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == u"member") {
+            const int64_t ref_id = attributes.value(u"ref").toLongLong();
+            const auto bldItem = _mapBuildings.constFind(ref_id);
+            if(bldItem != _mapBuildings.constEnd()) {
+                bld_tmp.append(bldItem->points_local, attributes.value(u"role") == u"inner");
+                bld_tmp.levels = fmax(bld_tmp.levels, bldItem->levels);
+                bld_tmp.height = fmax(bld_tmp.height, bldItem->height);
+
+                bld_tmp.bb_max[0] = fmax(bld_tmp.bb_max[0], bldItem->bb_max[0]);
+                bld_tmp.bb_max[1] = fmax(bld_tmp.bb_max[1], bldItem->bb_max[1]);
+                bld_tmp.bb_min[0] = fmin(bld_tmp.bb_min[0], bldItem->bb_min[0]);
+                bld_tmp.bb_min[1] = fmin(bld_tmp.bb_min[1], bldItem->bb_min[1]);
                 bldToBeRemoved.push_back(ref_id);
             }
-        }else if (Child.tagName()=="tag") {
-            attribute = Child.attribute("k","0");
-            if(attribute == "type") {
-                if(Child.attribute("v","0") == "multipolygon"){
+        }else if (xml.name() == u"tag") {
+            const QStringView attribute = attributes.value(u"k");
+            if(attribute == u"type") {
+                if(attributes.value(u"v") == u"multipolygon"){
                     isMultipolygon = true;
                 }
-            }else if(attribute == "building"){
+            }else if(attribute == u"building"){
                 isBuilding = true;
             }
         }
-        Child = Child.nextSibling().toElement();
+        xml.skipCurrentElement();
     }
 
     if(isBuilding){
@@ -285,11 +312,276 @@ void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t,
             bld_tmp.levels = (bld_tmp.levels == 0)?(2):(bld_tmp.levels);
         }
     }
-    if(isMultipolygon){
+    if(isMultipolygon && !bldToBeRemoved.empty()){
         for(uint i_id=0; i_id<bldToBeRemoved.size(); i_id++){
-            bldMap.remove(bldToBeRemoved[i_id]);
+            _mapBuildings.remove(bldToBeRemoved[i_id]);
+        }
+        _mapBuildings.insert(bldToBeRemoved[0], std::move(bld_tmp));
+    }
+}
+
+OsmParserThread::MeshChunks_t OsmParserThread::buildMeshChunks()
+{
+    struct MeshJob_t {
+        const BuildingType_t* building;
+        std::vector<QVector3D> mesh;
+    };
+
+    std::vector<MeshJob_t> jobs;
+    jobs.reserve(_mapBuildings.size());
+    for (auto ii = _mapBuildings.cbegin(), end = _mapBuildings.cend(); ii != end; ++ii) {
+        if(ii.value().height > 0 || ii.value().levels > 0){
+            jobs.push_back({&ii.value(), {}});
+        }
+    }
+
+    // Buildings are independent of each other, so they are triangulated across the global thread pool
+    QtConcurrent::blockingMap(jobs, [](MeshJob_t& job) {
+        buildingToMesh(*job.building, job.mesh);
+    });
+
+    MeshChunks_t meshChunks;
+    for(const MeshJob_t& job : jobs){
+        if(job.mesh.empty()){
+            continue;
+        }
+        MeshChunk_t& chunk = meshChunks[chunkKey(0.5f * (job.building->bb_min + job.building->bb_max))];
+        chunk.vertices.insert(chunk.vertices.end(), job.mesh.begin(), job.mesh.end());
+        chunk.buildings.push_back({static_cast<quint32>(job.mesh.size()), job.building->height, job.building->levels});
+    }
+
+    qCDebug(OsmParserThreadLog) << jobs.size() << "buildings triangulated into" << meshChunks.size() << "chunks";
+    return meshChunks;
+}
+
+void OsmParserThread::buildingToMesh(const BuildingType_t &building, std::vector<QVector3D> &triangulatedMesh)
+{
+    std::vector<std::array<float, 2> > all_bld_points;
+    std::vector<std::array<float, 2> > bld_points;
+    std::vector<std::vector<std::array<float, 2> > > polygon;
+
+    for(unsigned int jj=0; jj<building.points_local.size(); jj++) {
+        bld_points.push_back({building.points_local[jj].x(), building.points_local[jj].y()});
+        all_bld_points.push_back({building.points_local[jj].x(), building.points_local[jj].y()});
+    }
+    polygon.push_back(bld_points);
+
+    bld_points.clear();
+    for(unsigned int jj=0; jj<building.points_local_inner.size(); jj++) {
+        bld_points.push_back({building.points_local_inner[jj].x(), building.points_local_inner[jj].y()});
+        all_bld_points.push_back({building.points_local_inner[jj].x(), building.points_local_inner[jj].y()});
+    }
+    if(bld_points.size() > 0){
+        polygon.push_back(bld_points);
+    }
+
+    std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon);
+
+    for(uint i_i=0; i_i<indices.size(); i_i+=3) {
+        // mesh for roof
+        uint n_idx = indices[i_i];
+        triangulatedMesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 1));
+        n_idx = indices[i_i+1];
+        triangulatedMesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 1));
+        n_idx = indices[i_i+2];
+        triangulatedMesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 1));
+
+        // mesh for floor
+        n_idx = indices[i_i+2];
+        triangulatedMesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
+        n_idx = indices[i_i+1];
+        triangulatedMesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
+        n_idx = indices[i_i];
+        triangulatedMesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
+    }
+
+    trianglateWallsExtrudedPolygon(triangulatedMesh, building.points_local, 1, 0, 0); // mesh for wall outside
+    trianglateWallsExtrudedPolygon(triangulatedMesh, building.points_local, 1, 1, 0);// mesh for wall inside
+
+    trianglateWallsExtrudedPolygon(triangulatedMesh, building.points_local_inner, 1, 0, 0); // mesh for wall outside
+    trianglateWallsExtrudedPolygon(triangulatedMesh, building.points_local_inner, 1, 1, 0);// mesh for wall inside
+}
+
+void OsmParserThread::trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, const std::vector<QVector2D>& verticesCcw, float h, bool inverseOrder, bool duplicateStartEndPoint)
+{
+    if(verticesCcw.empty()){
+        return;
+    }
+
+    std::vector<QVector3D> tmp_rec_ccw(4);
+    uint vertices_size = verticesCcw.size() - (uint)(duplicateStartEndPoint);
+
+    if(inverseOrder) {
+        for(uint i_p=0; i_p<vertices_size; i_p++) {
+            int i_p_p = (i_p < vertices_size-1)?(i_p+1):(0);
+            tmp_rec_ccw[0] = QVector3D(verticesCcw[i_p_p].x(), verticesCcw[i_p_p].y(), 0);
+            tmp_rec_ccw[1] = QVector3D(verticesCcw[i_p].x(), verticesCcw[i_p].y(), 0);
+            tmp_rec_ccw[2] = QVector3D(verticesCcw[i_p].x(), verticesCcw[i_p].y(), h);
+            tmp_rec_ccw[3] = QVector3D(verticesCcw[i_p_p].x(), verticesCcw[i_p_p].y(), h);
+            trianglateRectangle(triangulatedMesh, tmp_rec_ccw, 0);
+        }
+        trianglateRectangle(triangulatedMesh, tmp_rec_ccw, 1);
+    } else {
+        for(uint i_p=0; i_p<vertices_size; i_p++) {
+            int i_p_p = (i_p < vertices_size-1)?(i_p+1):(0);
+            tmp_rec_ccw[0] = QVector3D(verticesCcw[i_p].x(), verticesCcw[i_p].y(), 0);
+            tmp_rec_ccw[1] = QVector3D(verticesCcw[i_p_p].x(), verticesCcw[i_p_p].y(), 0);
+            tmp_rec_ccw[2] = QVector3D(verticesCcw[i_p_p].x(), verticesCcw[i_p_p].y(), h);
+            tmp_rec_ccw[3] = QVector3D(verticesCcw[i_p].x(), verticesCcw[i_p].y(), h);
+            trianglateRectangle(triangulatedMesh, tmp_rec_ccw, 0);
+        }
+        trianglateRectangle(triangulatedMesh, tmp_rec_ccw, 1);
+    }
+}
+
+void OsmParserThread::trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, const std::vector<QVector3D>& verticesCcw, bool invertNormal)
+{
+    vec3i mesh_set_idx[2];
+
+    if(invertNormal) {
+        mesh_set_idx[0] = {{3, 1, 0}};
+        mesh_set_idx[1] = {{3, 2, 1}};
+    } else {
+        mesh_set_idx[0] = {{0, 1, 3}};
+        mesh_set_idx[1] = {{1, 2, 3}};
+    }
+
+    for(uint i_m=0; i_m<2; i_m++) {
+        for(uint i_v=0; i_v<3; i_v++) {
+            triangulatedMesh.push_back(verticesCcw[mesh_set_idx[i_m].array[i_v]]);
+        }
+    }
+}
+
+QString OsmParserThread::meshCacheFileName(const QString &filePath)
+{
+    const QByteArray pathHash = QCryptographicHash::hash(QFileInfo(filePath).absoluteFilePath().toUtf8(), QCryptographicHash::Md5).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/QGCViewer3DMeshCache/") + QString::fromLatin1(pathHash) + QLatin1String(".mesh");
+}
+
+bool OsmParserThread::loadMeshCache(const QString &filePath, MeshChunks_t &meshChunks)
+{
+    const QFileInfo sourceInfo(filePath);
+    QFile file(meshCacheFileName(filePath));
+    if(!sourceInfo.exists() || !file.open(QIODevice::ReadOnly)){
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic, version;
+    qint64 sourceSize, sourceModified;
+    stream >> magic >> version >> sourceSize >> sourceModified;
+    if(magic != kMeshCacheMagic || version != kMeshCacheVersion || sourceSize != sourceInfo.size() || sourceModified != sourceInfo.lastModified().toMSecsSinceEpoch()){
+        return false;
+    }
+
+    double refLat, refLon, minLat, minLon, maxLat, maxLon;
+    stream >> refLat >> refLon >> minLat >> minLon >> maxLat >> maxLon;
+
+    if(stream.status() != QDataStream::Ok || !readMeshChunks(stream, meshChunks)){
+        qCWarning(OsmParserThreadLog) << "Invalid 3D mesh cache" << file.fileName();
+        meshChunks.clear();
+        return false;
+    }
+
+    gpsRefPoint = QGeoCoordinate(refLat, refLon, 0);
+    coordinateMin = QGeoCoordinate(minLat, minLon, 0);
+    coordinateMax = QGeoCoordinate(maxLat, maxLon, 0);
+    qCDebug(OsmParserThreadLog) << "Loaded" << meshChunks.size() << "building chunks from the 3D mesh cache";
+    return true;
+}
+
+bool OsmParserThread::readMeshChunks(QDataStream &stream, MeshChunks_t &meshChunks)
+{
+    constexpr qint64 chunkHeaderBytes = sizeof(quint64) + 2 * sizeof(quint32);
+
+    quint32 chunkCount;
+    stream >> chunkCount;
+    // Every count is checked against the rest of the file before anything is allocated, so a corrupt cache can't
+    // request huge buffers
+    if(stream.status() != QDataStream::Ok || (chunkCount * chunkHeaderBytes > stream.device()->bytesAvailable())){
+        return false;
+    }
+
+    for(quint32 i=0; i<chunkCount; i++){
+        quint64 key;
+        quint32 buildingCount, vertexCount;
+        stream >> key >> buildingCount >> vertexCount;
+        if(stream.status() != QDataStream::Ok){
+            return false;
+        }
+
+        const qint64 buildingBytes = static_cast<qint64>(buildingCount) * static_cast<qint64>(sizeof(BuildingMesh_t));
+        const qint64 vertexBytes = static_cast<qint64>(vertexCount) * static_cast<qint64>(sizeof(QVector3D));
+        if((buildingBytes + vertexBytes > stream.device()->bytesAvailable()) ||
+           (buildingBytes > std::numeric_limits<int>::max()) || (vertexBytes > std::numeric_limits<int>::max())){
+            return false;
+        }
+
+        MeshChunk_t& chunk = meshChunks[key];
+        chunk.buildings.resize(buildingCount);
+        chunk.vertices.resize(vertexCount);
+        if(stream.readRawData(reinterpret_cast<char*>(chunk.buildings.data()), static_cast<int>(buildingBytes)) != buildingBytes ||
+           stream.readRawData(reinterpret_cast<char*>(chunk.vertices.data()), static_cast<int>(vertexBytes)) != vertexBytes){
+            return false;
+        }
+
+        // The buildings are drawn from the vertices in order, so they must not claim more vertices than the chunk holds
+        quint64 buildingVertexCount = 0;
+        for(const BuildingMesh_t& building : chunk.buildings){
+            buildingVertexCount += building.vertexCount;
+        }
+        if(buildingVertexCount != vertexCount){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void OsmParserThread::saveMeshCache(const QString &filePath, const MeshChunks_t &meshChunks)
+{
+    const QFileInfo sourceInfo(filePath);
+    const QString cacheFileName = meshCacheFileName(filePath);
+    if(!QDir().mkpath(QFileInfo(cacheFileName).absolutePath())){
+        return;
+    }
+
+    QSaveFile file(cacheFileName);
+    if(!file.open(QIODevice::WriteOnly)){
+        qCWarning(OsmParserThreadLog) << "Error while writing the 3D mesh cache" << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << kMeshCacheMagic << kMeshCacheVersion << static_cast<qint64>(sourceInfo.size()) << static_cast<qint64>(sourceInfo.lastModified().toMSecsSinceEpoch());
+    stream << gpsRefPoint.latitude() << gpsRefPoint.longitude() << coordinateMin.latitude() << coordinateMin.longitude() << coordinateMax.latitude() << coordinateMax.longitude();
+    writeMeshChunks(stream, meshChunks);
+
+    if(stream.status() != QDataStream::Ok || !file.commit()){
+        qCWarning(OsmParserThreadLog) << "Error while writing the 3D mesh cache" << file.errorString();
+    }
+}
+
+void OsmParserThread::writeMeshChunks(QDataStream &stream, const MeshChunks_t &meshChunks)
+{
+    stream << static_cast<quint32>(meshChunks.size());
+
+    for (auto ii = meshChunks.cbegin(), end = meshChunks.cend(); ii != end; ++ii) {
+        const MeshChunk_t& chunk = ii.value();
+        const qint64 buildingBytes = static_cast<qint64>(chunk.buildings.size() * sizeof(BuildingMesh_t));
+        const qint64 vertexBytes = static_cast<qint64>(chunk.vertices.size() * sizeof(QVector3D));
+        if((buildingBytes > std::numeric_limits<int>::max()) || (vertexBytes > std::numeric_limits<int>::max())){
+            stream.setStatus(QDataStream::WriteFailed);
+            return;
         }
-        bldMap.insert(bldToBeRemoved[0], bld_tmp);
+        stream << ii.key() << static_cast<quint32>(chunk.buildings.size()) << static_cast<quint32>(chunk.vertices.size());
+        (void) stream.writeRawData(reinterpret_cast<const char*>(chunk.buildings.data()), static_cast<int>(buildingBytes));
+        (void) stream.writeRawData(reinterpret_cast<const char*>(chunk.vertices.data()), static_cast<int>(vertexBytes));
     }
 }
 
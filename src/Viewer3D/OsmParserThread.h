@@ -11,74 +11,114 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QThread>
-#include <QtXml/QDomDocument>
-#include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 #include <QtGui/QVector3D>
 #include <QtGui/QVector2D>
 #include <QtPositioning/QGeoCoordinate>
 
+class QDataStream;
+class QXmlStreamReader;
+
+Q_DECLARE_LOGGING_CATEGORY(OsmParserThreadLog)
+
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
 
 class OsmParserThread : public QThread
 {
+    friend class OsmParserThreadTest;
 
 public:
     typedef struct BuildingType_s
     {
-        std::vector<QGeoCoordinate> points_gps;
-        std::vector<QGeoCoordinate> points_gps_inner;
         std::vector<QVector2D> points_local;
         std::vector<QVector2D> points_local_inner;
-        std::vector<QVector3D> triangulated_mesh;
         QVector2D bb_max = QVector2D(-1e6, -1e6); //bounding boxes
         QVector2D bb_min = QVector2D(1e6, 1e6); //bounding boxes
         float height;
         float levels;
 
-        void append(std::vector<QGeoCoordinate> newPoints, bool isInner){
-            for(uint i=0; i<newPoints.size(); i++){
-                if(isInner){
-                    points_gps_inner.push_back(newPoints[i]);
-                }else{
-                    points_gps.push_back(newPoints[i]);
-                }
-            }
-        }
-
-        void append(std::vector<QVector2D> newPoints, bool isInner){
-            for(uint i=0; i<newPoints.size(); i++){
-                if(isInner){
-                    points_local_inner.push_back(newPoints[i]);
-                }else{
-                    points_local.push_back(newPoints[i]);
-                }
+        void append(const std::vector<QVector2D>& newPoints, bool isInner){
+            if(isInner){
+                points_local_inner.insert(points_local_inner.end(), newPoints.begin(), newPoints.end());
+            }else{
+                points_local.insert(points_local.end(), newPoints.begin(), newPoints.end());
             }
         }
     }BuildingType_t;
 
+    /// Building in a mesh chunk. Its vertices have z 0 at the floor and 1 at the roof, so a change of the building
+    /// level height only rescales the vertices instead of triangulating the buildings again.
+    typedef struct BuildingMesh_s
+    {
+        quint32 vertexCount;
+        float height;
+        float levels;
+    }BuildingMesh_t;
+
+    /// Triangulated buildings of one square of the map grid
+    typedef struct MeshChunk_s
+    {
+        std::vector<QVector3D> vertices;
+        std::vector<BuildingMesh_t> buildings;
+    }MeshChunk_t;
+
+    using MeshChunks_t = QHash<quint64, MeshChunk_t>;
+
     Q_OBJECT
 public:
     explicit OsmParserThread(QObject *parent = nullptr);
 
     QGeoCoordinate gpsRefPoint;
-    QMap<uint64_t, QGeoCoordinate> mapNodes;
-    QMap<uint64_t, BuildingType_t> mapBuildings;
     QGeoCoordinate coordinateMin, coordinateMax;
 
     void start(QString filePath);
 
+    /// Moves the building meshes of the last parsed file to the caller
+    MeshChunks_t takeMeshChunks();
+
+    /// @return Key of the grid square holding the local point
+    static quint64 chunkKey(const QVector2D& localPoint);
+    static quint64 chunkKey(int chunkX, int chunkY){ return (static_cast<quint64>(static_cast<quint32>(chunkX)) << 32) | static_cast<quint32>(chunkY); }
+
+    static constexpr float kChunkSize = 250.0f; ///< Edge length of a grid square in meters
+
 private:
+    struct Node_t {
+        double lat;
+        double lon;
+    };
+
     QThread* _mainThread;
-    bool _mapLoadedFlag;
     QList<QString> _singleStoreyBuildings;
     QList<QString> _doubleStoreyLeisure;
+    QHash<uint64_t, Node_t> _mapNodes;
+    QHash<uint64_t, BuildingType_t> _mapBuildings;
+    QMutex _meshChunksMutex;
+    MeshChunks_t _meshChunks;
 
     void parseOsmFile(QString filePath);
-    bool decodeFile(QDomDocument& xml_content, QMap<uint64_t, BuildingType_t > &buildingMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordinateMin, QGeoCoordinate& coordinateMax, QGeoCoordinate& gpsRef);
-    bool decodeNodeTags(QDomElement& xmlComponent, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate& gpsRef);
-    void decodeBuildings(QDomElement& xmlComponent, QMap<uint64_t, BuildingType_t > &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate gpsRef);
-    void decodeRelations(QDomElement& xmlComponent, QMap<uint64_t, BuildingType_t > &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate gpsRef);
+    bool decodeFile(QXmlStreamReader& xml, QGeoCoordinate& coordinateMin, QGeoCoordinate& coordinateMax, QGeoCoordinate& gpsRef);
+    bool decodeNodeTags(QXmlStreamReader& xml, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate& gpsRef);
+    void decodeBuildings(QXmlStreamReader& xml, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate gpsRef);
+    void decodeRelations(QXmlStreamReader& xml);
+    MeshChunks_t buildMeshChunks();
+
+    static void buildingToMesh(const BuildingType_t& building, std::vector<QVector3D>& triangulatedMesh);
+    static void trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, const std::vector<QVector2D>& verticesCcw, float h, bool inverseOrder=0, bool duplicateStartEndPoint=0);
+    static void trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, const std::vector<QVector3D>& verticesCcw, bool invertNormal);
+
+    static QString meshCacheFileName(const QString& filePath);
+    bool loadMeshCache(const QString& filePath, MeshChunks_t& meshChunks);
+    void saveMeshCache(const QString& filePath, const MeshChunks_t& meshChunks);
+    /// Reads the chunk section of a mesh cache. Fails on a truncated or corrupt stream, meshChunks may then hold a part of the chunks.
+    static bool readMeshChunks(QDataStream& stream, MeshChunks_t& meshChunks);
+    static void writeMeshChunks(QDataStream& stream, const MeshChunks_t& meshChunks);
+
+    static constexpr quint32 kMeshCacheMagic = 0x4d534751; ///< "QGSM"
+    static constexpr quint32 kMeshCacheVersion = 1;
 
 
 signals:
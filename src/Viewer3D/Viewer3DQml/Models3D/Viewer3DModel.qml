@@ -168,6 +168,8 @@ View3D {
                     property TextureInput someTextureMap: TextureInput {
                         texture: Texture {
                             textureData: _terrainTextureManager
+                            generateMipmaps: true
+                            mipFilter: Texture.Linear
                         }
                     }
                 }
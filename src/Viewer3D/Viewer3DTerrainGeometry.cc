@@ -12,6 +12,11 @@
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "Viewer3DSettings.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "TerrainTileManager.h"
+
+#include <QtConcurrent/QtConcurrentRun>
 
 #include "math.h"
 
@@ -19,45 +24,172 @@
 #define MaxLatitude         85.05112878
 #define EarthRadius         6378137
 
+static constexpr int kTerrainVertexFloats = 8; // position, normal and UV
+
 Viewer3DTerrainGeometry::Viewer3DTerrainGeometry()
 {
     _viewer3DSettings = qgcApp()->toolbox()->settingsManager()->viewer3DSettings();
     setSectorCount(0);
     setStackCount(0);
     setRadius(EarthRadius);
+
+    _elevationRetryTimer.setSingleShot(true);
+    _elevationRetryTimer.setInterval(kElevationRetryMSecs);
+    connect(&_elevationRetryTimer, &QTimer::timeout, this, [this]() {
+        _elevationRetries++;
+        _startTileGeneration(true);
+    });
+    connect(&_tileWatcher, &QFutureWatcherBase::finished, this, &Viewer3DTerrainGeometry::_tilesGenerated);
+
     connect(_viewer3DSettings->osmFilePath(), &Fact::rawValueChanged, this, &Viewer3DTerrainGeometry::clearScene);
     connect(this, &Viewer3DTerrainGeometry::refCoordinateChanged, this, &Viewer3DTerrainGeometry::updateEarthData);
+
+    _activeVehicleChangedEvent(qgcApp()->toolbox()->multiVehicleManager()->activeVehicle());
+    connect(qgcApp()->toolbox()->multiVehicleManager(), &MultiVehicleManager::activeVehicleChanged, this, &Viewer3DTerrainGeometry::_activeVehicleChangedEvent);
 }
 
 void Viewer3DTerrainGeometry::updateEarthData()
 {
-    clear();
-    int stride = 3 * sizeof(float);
-    stride += 3 * sizeof(float); // for normals
-    stride += 2 * sizeof(float); // for UV
+    if(_sectorCount == 0 || _stackCount == 0 || !_roiMin.isValid() || !_roiMax.isValid() || !_refCoordinate.isValid()){
+        return;
+    }
 
-    if(buildTerrain_2(roiMin(), roiMax(), refCoordinate(), 1) == 0){
+    TerrainGrid_t grid;
+    grid.roiMin = _roiMin;
+    grid.roiMax = _roiMax;
+    grid.refCoordinate = _refCoordinate;
+    grid.sectorCount = _sectorCount;
+    grid.stackCount = _stackCount;
+
+    if(!(grid == _grid)){
+        _grid = grid;
+        _generation++;
+        _meshTiles.clear();
+        _elevationRetries = 0;
+        _elevationRetryTimer.stop();
+        _uploadedViewTile = QPoint(-1, -1);
+
+        // Tiles generated before the elevation data is in are generated again once it was downloaded. The area
+        // is grown by a tile so the samples for the normals along the edges are covered as well.
+        const double latMargin = fabs(_roiMax.latitude() - _roiMin.latitude()) / _stackCount;
+        const double lonMargin = fabs(_roiMax.longitude() - _roiMin.longitude()) / _sectorCount;
+        TerrainTileManager::instance()->prefetchTiles(QGeoCoordinate(fmax(_roiMin.latitude(), _roiMax.latitude()) + latMargin, fmin(_roiMin.longitude(), _roiMax.longitude()) - lonMargin),
+                                                      QGeoCoordinate(fmin(_roiMin.latitude(), _roiMax.latitude()) - latMargin, fmax(_roiMin.longitude(), _roiMax.longitude()) + lonMargin));
+    }
+
+    _startTileGeneration();
+}
+
+void Viewer3DTerrainGeometry::_startTileGeneration(bool regenerateIncomplete)
+{
+    if(_grid.sectorCount == 0 || _grid.stackCount == 0){
         return;
     }
 
-    QByteArray vertexData;
-    vertexData.resize(_vertices.size() * stride);
-    float *p = reinterpret_cast<float *>(vertexData.data());
+    if(_tileWatcher.isRunning()){
+        // _tilesGenerated starts again for the tiles still missing once the running generation is done
+        return;
+    }
+
+    QList<QPoint> tiles;
+    QList<int> resolutions;
+    for(int row = 0; row < _grid.stackCount; row++){
+        for(int col = 0; col < _grid.sectorCount; col++){
+            const int resolution = _tileResolution(row, col);
+            const auto meshTile = _meshTiles.constFind(_meshTileKey(row, col, resolution));
+            if(meshTile == _meshTiles.constEnd() || (regenerateIncomplete && !meshTile->complete)){
+                tiles.append(QPoint(col, row));
+                resolutions.append(resolution);
+            }
+        }
+    }
+
+    if(tiles.isEmpty()){
+        if(_viewTile() != _uploadedViewTile){
+            _uploadTiles();
+        }
+        return;
+    }
 
-    for (uint i = 0; i < _vertices.size(); ++i) {
-        *p++ = _vertices[i].x();
-        *p++ = _vertices[i].y();
-        *p++ = _vertices[i].z();
+    const TerrainGrid_t grid = _grid;
+    const quint64 generation = _generation;
+    _tileWatcher.setFuture(QtConcurrent::run([grid, generation, tiles, resolutions]() {
+        return _generateTiles(grid, generation, tiles, resolutions);
+    }));
+}
 
-        *p++ = _normals[i].x();
-        *p++ = _normals[i].y();
-        *p++ = _normals[i].z();
+void Viewer3DTerrainGeometry::_tilesGenerated()
+{
+    const MeshTileResult_t result = _tileWatcher.result();
 
-        *p++ = _texCoords[i].x();
-        *p++ = _texCoords[i].y();
+    if(result.generation == _generation){
+        for(const auto& tile : result.tiles){
+            _meshTiles.insert(tile.first, tile.second);
+        }
+        _uploadTiles();
+    }
+
+    // The layout or the vehicle may have changed while the tiles were generated
+    _startTileGeneration();
+}
+
+void Viewer3DTerrainGeometry::_uploadTiles()
+{
+    const int stride = kTerrainVertexFloats * sizeof(float);
+
+    // Tiles whose level of detail is not generated yet are shown with any other level which is
+    QList<const MeshTile_t*> tiles;
+    tiles.reserve(_grid.stackCount * _grid.sectorCount);
+    qsizetype vertexBytes = 0;
+    qsizetype indexCount = 0;
+    bool incomplete = false;
+    for(int row = 0; row < _grid.stackCount; row++){
+        for(int col = 0; col < _grid.sectorCount; col++){
+            const MeshTile_t* meshTile = nullptr;
+            const auto exact = _meshTiles.constFind(_meshTileKey(row, col, _tileResolution(row, col)));
+            if(exact != _meshTiles.constEnd()){
+                meshTile = &exact.value();
+            }else{
+                for(int resolution = kMaxTileResolution; resolution >= kMinTileResolution && !meshTile; resolution /= 2){
+                    const auto other = _meshTiles.constFind(_meshTileKey(row, col, resolution));
+                    if(other != _meshTiles.constEnd()){
+                        meshTile = &other.value();
+                    }
+                }
+            }
+            if(!meshTile){
+                continue;
+            }
+            incomplete |= !meshTile->complete;
+            tiles.append(meshTile);
+            vertexBytes += meshTile->vertexData.size();
+            indexCount += _indexPattern(meshTile->resolution).size();
+        }
+    }
+
+    clear();
+
+    QByteArray vertexData;
+    vertexData.reserve(vertexBytes);
+    QByteArray indexData(indexCount * sizeof(quint32), Qt::Initialization::Uninitialized);
+    quint32 *ip = reinterpret_cast<quint32 *>(indexData.data());
+    quint32 baseVertex = 0;
+    for(const MeshTile_t* meshTile : tiles){
+        vertexData.append(meshTile->vertexData);
+        for(const quint32 index : _indexPattern(meshTile->resolution)){
+            *ip++ = baseVertex + index;
+        }
+        baseVertex += meshTile->vertexData.size() / stride;
+    }
+
+    _uploadedViewTile = _viewTile();
+    if(vertexData.isEmpty()){
+        update();
+        return;
     }
 
     setVertexData(vertexData);
+    setIndexData(indexData);
     setStride(stride);
 
     setPrimitiveType(QQuick3DGeometry::PrimitiveType::Triangles);
@@ -70,433 +202,259 @@ void Viewer3DTerrainGeometry::updateEarthData()
     addAttribute(QQuick3DGeometry::Attribute::TexCoordSemantic,
                  6 * sizeof(float),
                  QQuick3DGeometry::Attribute::F32Type);
+    addAttribute(QQuick3DGeometry::Attribute::IndexSemantic,
+                 0,
+                 QQuick3DGeometry::Attribute::U32Type);
 
     update();
-}
 
-QVector3D Viewer3DTerrainGeometry::computeFaceNormal(QVector3D x1, QVector3D x2, QVector3D x3)
-{
-    const float EPSILON = 0.000001f;
-
-    QVector3D normal(0, 0, 0);     // default return value (0,0,0)
-    float nx, ny, nz;
-
-    // find 2 edge vectors: v1-v2, v1-v3
-    float ex1 = x2.x() - x1.x();
-    float ey1 = x2.y() - x1.y();
-    float ez1 = x2.z() - x1.z();
-    float ex2 = x3.x() - x1.x();
-    float ey2 = x3.y() - x1.y();
-    float ez2 = x3.z() - x1.z();
-
-    // cross product: e1 x e2
-    nx = ey1 * ez2 - ez1 * ey2;
-    ny = ez1 * ex2 - ex1 * ez2;
-    nz = ex1 * ey2 - ey1 * ex2;
-
-    // normalize only if the length is > 0
-    float length = sqrtf(nx * nx + ny * ny + nz * nz);
-    if(length > EPSILON)
-    {
-        // normalize
-        float lengthInv = 1.0f / length;
-        normal.setX(nx * lengthInv);
-        normal.setY(ny * lengthInv);
-        normal.setZ(nz * lengthInv);
+    if(incomplete && _elevationRetries < kMaxElevationRetries && !_elevationRetryTimer.isActive()){
+        _elevationRetryTimer.start();
     }
-
-    return normal;
 }
 
-void Viewer3DTerrainGeometry::changeUpAxis(int from, int to)
+QPoint Viewer3DTerrainGeometry::_viewTile() const
 {
-    // initial transform matrix cols
-    float tx[] = {1.0f, 0.0f, 0.0f};    // x-axis (left)
-    float ty[] = {0.0f, 1.0f, 0.0f};    // y-axis (up)
-    float tz[] = {0.0f, 0.0f, 1.0f};    // z-axis (forward)
-
-    float sign_to = (to >= 0)?(1):(-1);
-
-    // X -> Y
-    if(from == 1 && to == 2)
-    {
-        tx[0] =  0.0f * sign_to; tx[1] =  1.0f * sign_to;
-        ty[0] = -1.0f * sign_to; ty[1] =  0.0f * sign_to;
-    }
-    // X -> Z
-    else if(from == 1 && to == 3)
-    {
-        tx[0] =  0.0f * sign_to; tx[2] =  1.0f * sign_to;
-        tz[0] = -1.0f * sign_to; tz[2] =  0.0f * sign_to;
-    }
-    // Y -> X
-    else if(from == 2 && to == 1)
-    {
-        tx[0] =  0.0f * sign_to; tx[1] = -1.0f * sign_to;
-        ty[0] =  1.0f * sign_to; ty[1] =  0.0f * sign_to;
-    }
-    // Y -> Z
-    else if(from == 2 && to == 3)
-    {
-        ty[1] =  0.0f * sign_to; ty[2] =  1.0f * sign_to;
-        tz[1] = -1.0f * sign_to; tz[2] =  0.0f * sign_to;
-    }
-    //  Z -> X
-    else if(from == 3 && to == 1)
-    {
-        tx[0] =  0.0f * sign_to; tx[2] = -1.0f * sign_to;
-        tz[0] =  1.0f * sign_to; tz[2] =  0.0f * sign_to;
-    }
-    // Z -> Y
-    else
-    {
-        ty[1] =  0.0f * sign_to; ty[2] = -1.0f * sign_to;
-        tz[1] =  1.0f * sign_to; tz[2] =  0.0f * sign_to;
+    QGeoCoordinate viewCoordinate = _grid.refCoordinate;
+    if(_activeVehicle){
+        const QGeoCoordinate vehicleCoordinate = _activeVehicle->coordinate();
+        if(vehicleCoordinate.isValid() && (vehicleCoordinate.latitude() || vehicleCoordinate.longitude())){
+            viewCoordinate = vehicleCoordinate;
+        }
     }
 
-    float vx, vy, vz;
-    float nx, ny, nz;
-    for(std::size_t i = 0; i < _vertices.size(); i++)
-    {
-        // transform vertices
-        vx = _vertices[i].x();
-        vy = _vertices[i].y();
-        vz = _vertices[i].z();
-        _vertices[i] = QVector3D(tx[0] * vx + ty[0] * vy + tz[0] * vz,
-                                 tx[1] * vx + ty[1] * vy + tz[1] * vz,
-                                 tx[2] * vx + ty[2] * vy + tz[2] * vz);
-
-        // transform normals
-        nx = _normals[i].x();
-        ny = _normals[i].y();
-        nz = _normals[i].z();
-        _normals[i]   = QVector3D(tx[0] * nx + ty[0] * ny + tz[0] * nz,
-                                tx[1] * nx + ty[1] * ny + tz[1] * nz,
-                                tx[2] * nx + ty[2] * ny + tz[2] * nz);
+    if(!viewCoordinate.isValid() || _grid.sectorCount == 0 || _grid.stackCount == 0){
+        return QPoint(_grid.sectorCount / 2, _grid.stackCount / 2);
     }
-}
 
-void Viewer3DTerrainGeometry::clearScene()
-{
-    clear();
-    setSectorCount(0);
-    setStackCount(0);
-    _vertices.clear();
-    _normals.clear();
-    _texCoords.clear();
-    update();
-}
-
-int Viewer3DTerrainGeometry::sectorCount() const
-{
-    return _sectorCount;
-}
+    const double stackStep = fabs(_grid.roiMax.latitude() - _grid.roiMin.latitude()) / _grid.stackCount;
+    const double sectorStep = fabs(_grid.roiMax.longitude() - _grid.roiMin.longitude()) / _grid.sectorCount;
+    const int col = static_cast<int>(floor((viewCoordinate.longitude() - _grid.roiMin.longitude()) / sectorStep));
+    const int row = static_cast<int>(floor((_grid.roiMax.latitude() - viewCoordinate.latitude()) / stackStep));
 
-void Viewer3DTerrainGeometry::setSectorCount(int newSectorCount)
-{
-    if (_sectorCount == newSectorCount)
-        return;
-    _sectorCount = newSectorCount;
-    emit sectorCountChanged();
+    return QPoint(qBound(0, col, _grid.sectorCount - 1), qBound(0, row, _grid.stackCount - 1));
 }
 
-int Viewer3DTerrainGeometry::stackCount() const
+int Viewer3DTerrainGeometry::_tileResolution(int row, int col) const
 {
-    return _stackCount;
-}
+    const QPoint viewTile = _viewTile();
+    const int ring = qMax(abs(row - viewTile.y()), abs(col - viewTile.x()));
 
-void Viewer3DTerrainGeometry::setStackCount(int newStackCount)
-{
-    if (_stackCount == newStackCount)
-        return;
-    _stackCount = newStackCount;
-    emit stackCountChanged();
+    return qMax(kMaxTileResolution >> qMin(ring / kLodRingWidth, 8), kMinTileResolution);
 }
 
-void Viewer3DTerrainGeometry::buildTerrain(QGeoCoordinate roiMinCoordinate, QGeoCoordinate roiMaxCoordinate, QGeoCoordinate refCoordinate, bool scale)
+const QList<quint32>& Viewer3DTerrainGeometry::_indexPattern(int resolution)
 {
-    float sectorLength = abs(roiMaxCoordinate.longitude() - roiMinCoordinate.longitude());
-    float stackLength = abs(roiMaxCoordinate.latitude() - roiMinCoordinate.latitude());
-    float stackRef = roiMaxCoordinate.latitude();
-    float sectorRef = roiMinCoordinate.longitude();
-
-
-    // tmp vertex definition (x,y,z,s,t)
-    struct Vertex{
-        float x, y, z, s, t;
-    };
-    std::vector<Vertex> tmpVertices;
-
-    float minT = 10;
-    float maxT = -10;
-    float minS = 10;
-    float maxS = -10;
-
-    // There si a bug now that the resolution of each polygon changes
-    // by thge portion. It hsould be fixed I think
-    float sectorStep =   sectorLength / _sectorCount;
-    float stackStep = stackLength / _stackCount;
-    float sectorAngle, stackAngle;
-
-    QVector3D refLocalPosition;
-    float refXY = _radius * cosf(refCoordinate.latitude() * DEG_TO_RAD);
-    refLocalPosition.setX(refXY * cosf(refCoordinate.longitude() * DEG_TO_RAD));
-    refLocalPosition.setY(refXY * sinf(refCoordinate.longitude() * DEG_TO_RAD));
-    refLocalPosition.setZ(_radius * sinf(refCoordinate.latitude() * DEG_TO_RAD));
-
-    // compute all vertices first, each vertex contains (x,y,z,s,t) except normal
-    for(int i = 0; i <= _stackCount; ++i){
-        stackAngle = stackRef - i * stackStep;        // starting from 90 to -90
-        float xy = _radius * cosf(stackAngle * DEG_TO_RAD);       // r * cos(u)
-        // float z = _radius * sinf(stackAngle * DEG_TO_RAD);        // r * sin(u)
-
-        // add (sectorCount+1) vertices per stack
-        // the first and last vertices have same position and normal, but different tex coords
-        for(int j = 0; j <= _sectorCount; ++j){
-            sectorAngle = sectorRef + j * sectorStep;           // starting from -180 to 180
-
-            Vertex vertex;
-            vertex.x = xy * cosf(sectorAngle * DEG_TO_RAD) - refLocalPosition.x();      // x = r * cos(u) * cos(v)
-            vertex.y = xy * sinf(sectorAngle * DEG_TO_RAD) - refLocalPosition.y();      // y = r * cos(u) * sin(v)
-            // vertex.z = z - refLocalPosition.z();                           // z = r * sin(u)
-            vertex.z = 0;                           // z = r * sin(u)
-
-            qDebug() << vertex.x << vertex.y << vertex.z;
-            vertex.s = (sectorAngle + 180.0f) / 360.0f;
-            minS = fmin(minS, vertex.s);
-            maxS = fmax(maxS, vertex.s);
-            if(abs(stackAngle) < MaxLatitude){
-                double sinLatitude = sin(stackAngle * DEG_TO_RAD);
-                vertex.t = 0.5 - log((1 + sinLatitude) / (1 - sinLatitude)) / (4 * PI);
-
-            }else{
-                vertex.t = (stackRef - stackAngle) / 180;
-            }
-            minT = fmin(minT, vertex.t);
-            maxT = fmax(maxT, vertex.t);
-
-            tmpVertices.push_back(vertex);
-        }
+    auto pattern = _indexPatterns.find(resolution);
+    if(pattern != _indexPatterns.end()){
+        return pattern.value();
     }
 
-    float scaleT = maxT - minT;
-    float scaleS = maxS - minS;
-    _vertices.clear();
-    _texCoords.clear();
-    _normals.clear();
-    Vertex v1, v2, v3, v4;                          // 4 vertex positions and tex coords
-    int i, j, vi1, vi2;
-    QVector3D _n;
-    for(i = 0; i < _stackCount; ++i){
-        vi1 = i * (_sectorCount + 1);                // index of tmpVertices
-        vi2 = (i + 1) * (_sectorCount + 1);
-        stackAngle = stackRef - i * stackStep;
-        for(j = 0; j < _sectorCount; ++j, ++vi1, ++vi2){
-            // get 4 vertices per sector
+    QList<quint32> indices;
+    const quint32 edge = resolution + 1;
+    const quint32 gridVertices = edge * edge;
+    indices.reserve(resolution * resolution * 6 + 4 * resolution * 12);
+
+    for(quint32 r = 0; r < static_cast<quint32>(resolution); r++){
+        for(quint32 c = 0; c < static_cast<quint32>(resolution); c++){
+            // get 4 vertices per quad
             //  v1--v3
             //  |    |
             //  v2--v4
+            const quint32 v1 = r * edge + c;
+            const quint32 v2 = (r + 1) * edge + c;
+            const quint32 v3 = v1 + 1;
+            const quint32 v4 = v2 + 1;
+            indices << v1 << v2 << v3;
+            indices << v3 << v2 << v4;
+        }
+    }
 
-            v1 = tmpVertices[vi1];
-            v2 = tmpVertices[vi2];
-            v3 = tmpVertices[vi1 + 1];
-            v4 = tmpVertices[vi2 + 1];
-
-            if(scale){
-                v1.s = (v1.s - minS) / scaleS;
-                v1.t = (v1.t - minT) / scaleT;
-                v2.s = (v2.s - minS) / scaleS;
-                v2.t = (v2.t - minT) / scaleT;
-                v3.s = (v3.s - minS) / scaleS;
-                v3.t = (v3.t - minT) / scaleT;
-                v4.s = (v4.s - minS) / scaleS;
-                v4.t = (v4.t - minT) / scaleT;
-            }
-
-            // 2 triangles per sector excluding 1st and last stacks
-            if(stackAngle < 90){
-                _vertices.push_back(QVector3D(v1.x, v1.y, v1.z));
-                _vertices.push_back(QVector3D(v2.x, v2.y, v2.z));
-                _vertices.push_back(QVector3D(v3.x, v3.y, v3.z));
-
-                _texCoords.push_back(QVector2D(v1.s, v1.t));
-                _texCoords.push_back(QVector2D(v2.s, v2.t));
-                _texCoords.push_back(QVector2D(v3.s, v3.t));
-
-                _n = computeFaceNormal(QVector3D(v1.x,v1.y,v1.z),
-                                       QVector3D(v2.x,v2.y,v2.z),
-                                       QVector3D(v3.x,v3.y,v3.z));
-
-                for(int k = 0; k < 3; ++k)  // same normals for 3 vertices
-                {
-                    _normals.push_back(_n);
-                }
+    // Skirts hang down from the top, bottom, left and right edges. Both sides are drawn so the winding doesn't
+    // depend on the edge.
+    for(quint32 side = 0; side < 4; side++){
+        for(quint32 k = 0; k < static_cast<quint32>(resolution); k++){
+            quint32 e1, e2;
+            switch(side){
+            case 0: e1 = k; e2 = k + 1; break;
+            case 1: e1 = resolution * edge + k; e2 = e1 + 1; break;
+            case 2: e1 = k * edge; e2 = (k + 1) * edge; break;
+            default: e1 = k * edge + resolution; e2 = (k + 1) * edge + resolution; break;
             }
+            const quint32 s1 = gridVertices + side * edge + k;
+            const quint32 s2 = s1 + 1;
+            indices << e1 << s1 << e2 << e2 << s1 << s2;
+            indices << e1 << e2 << s1 << e2 << s2 << s1;
+        }
+    }
 
-            if(stackAngle > -90){
-                _vertices.push_back(QVector3D(v3.x, v3.y, v3.z));
-                _vertices.push_back(QVector3D(v2.x, v2.y, v2.z));
-                _vertices.push_back(QVector3D(v4.x, v4.y, v4.z));
+    return _indexPatterns.insert(resolution, indices).value();
+}
 
-                _texCoords.push_back(QVector2D(v3.s, v3.t));
-                _texCoords.push_back(QVector2D(v2.s, v2.t));
-                _texCoords.push_back(QVector2D(v4.s, v4.t));
+Viewer3DTerrainGeometry::MeshTileResult_t Viewer3DTerrainGeometry::_generateTiles(const TerrainGrid_t &grid, quint64 generation, const QList<QPoint> &tiles, const QList<int> &resolutions)
+{
+    MeshTileResult_t result;
+    result.generation = generation;
 
-                _n = computeFaceNormal(QVector3D(v3.x,v3.y,v3.z),
-                                       QVector3D(v2.x,v2.y,v2.z),
-                                       QVector3D(v4.x,v4.y,v4.z));
+    QList<double> refElevation;
+    const bool refElevationValid = TerrainTileManager::instance()->cachedElevations({QGeoCoordinate(grid.refCoordinate.latitude(), grid.refCoordinate.longitude())}, refElevation);
 
-                for(int k = 0; k < 3; ++k)  // same normals for 3 vertices
-                {
-                    _normals.push_back(_n);
-                }
-            }
-        }
+    result.tiles.reserve(tiles.size());
+    for(qsizetype i = 0; i < tiles.size(); i++){
+        const int row = tiles[i].y();
+        const int col = tiles[i].x();
+        result.tiles.append({_meshTileKey(row, col, resolutions[i]), _generateTile(grid, row, col, resolutions[i], refElevationValid ? refElevation.first() : 0.0, refElevationValid)});
     }
-
-    changeUpAxis(3, 2);
+    return result;
 }
 
-bool Viewer3DTerrainGeometry::buildTerrain_2(QGeoCoordinate roiMinCoordinate, QGeoCoordinate roiMaxCoordinate, QGeoCoordinate refCoordinate, bool scale)
+/// Generates one tile from a snapshot of the layout. This doesn't touch the geometry so it is safe to run on a
+/// worker thread.
+Viewer3DTerrainGeometry::MeshTile_t Viewer3DTerrainGeometry::_generateTile(const TerrainGrid_t &grid, int row, int col, int resolution, double refElevation, bool refElevationValid)
 {
-    if(_sectorCount == 0 || _stackCount == 0){
-        return false;
+    const double stackStep = fabs(grid.roiMax.latitude() - grid.roiMin.latitude()) / grid.stackCount;
+    const double sectorStep = fabs(grid.roiMax.longitude() - grid.roiMin.longitude()) / grid.sectorCount;
+    const double north = grid.roiMax.latitude() - row * stackStep;
+    const double west = grid.roiMin.longitude() + col * sectorStep;
+    const double latStep = stackStep / resolution;
+    const double lonStep = sectorStep / resolution;
+
+    // Map texture coordinates over the whole region, in web mercator like the map tiles
+    auto mercatorY = [](double latitude) {
+        if(fabs(latitude) < MaxLatitude){
+            const double sinLatitude = sin(latitude * DEG_TO_RAD);
+            return 0.5 - log((1 + sinLatitude) / (1 - sinLatitude)) / (4 * PI);
+        }
+        return (90 - latitude) / 180;
+    };
+    const double tNorth = mercatorY(grid.roiMax.latitude());
+    const double tSouth = mercatorY(grid.roiMin.latitude());
+    const double roiWest = grid.roiMin.longitude();
+    const double roiWidth = fabs(grid.roiMax.longitude() - grid.roiMin.longitude());
+
+    // The samples have a border of one sample around the tile, so the normals along the edges match the neighbors
+    const int samples = resolution + 3;
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(samples * samples);
+    for(int r = -1; r <= resolution + 1; r++){
+        for(int c = -1; c <= resolution + 1; c++){
+            coordinates.append(QGeoCoordinate(north - r * latStep, west + c * lonStep));
+        }
     }
 
-    float sectorLength = abs(roiMaxCoordinate.longitude() - roiMinCoordinate.longitude());
-    float stackLength = abs(roiMaxCoordinate.latitude() - roiMinCoordinate.latitude());
-    float stackRef = roiMaxCoordinate.latitude();
-    float sectorRef = roiMinCoordinate.longitude();
+    QList<double> elevations;
+    MeshTile_t meshTile;
+    meshTile.resolution = resolution;
+    meshTile.complete = TerrainTileManager::instance()->cachedElevations(coordinates, elevations) && refElevationValid;
+
+    std::vector<QVector3D> positions(coordinates.size());
+    for(qsizetype i = 0; i < coordinates.size(); i++){
+        QVector3D localPoint = mapGpsToLocalPoint(QGeoCoordinate(coordinates[i].latitude(), coordinates[i].longitude(), 0), grid.refCoordinate);
+        const double elevation = elevations[i];
+        localPoint.setZ((refElevationValid && !qIsNaN(elevation)) ? static_cast<float>(elevation - refElevation) : 0.0f);
+        positions[i] = localPoint;
+    }
+    auto sample = [&positions, samples](int r, int c) -> const QVector3D& {
+        return positions[(r + 1) * samples + (c + 1)];
+    };
 
+    const int edge = resolution + 1;
+    const float skirtDepth = kSkirtDepth * fmin(sample(0, 0).distanceToPoint(sample(0, resolution)), sample(0, 0).distanceToPoint(sample(resolution, 0)));
+    meshTile.vertexData.resize((edge * edge + 4 * edge) * kTerrainVertexFloats * sizeof(float));
+    float *p = reinterpret_cast<float *>(meshTile.vertexData.data());
 
-    // tmp vertex definition (x,y,z,s,t)
-    struct Vertex{
-        float x, y, z, s, t;
-    };
-    std::vector<Vertex> tmpVertices;
-
-    float minT = 10;
-    float maxT = -10;
-    float minS = 10;
-    float maxS = -10;
-
-    // There si a bug now that the resolution of each polygon changes
-    // by thge portion. It hsould be fixed I think
-    float sectorStep =   sectorLength / _sectorCount;
-    float stackStep = stackLength / _stackCount;
-    float sectorAngle, stackAngle;
-
-    QVector3D refLocalPosition;
-    QVector3D localPoint;
-    float refXY = _radius * cosf(refCoordinate.latitude() * DEG_TO_RAD);
-    refLocalPosition.setX(refXY * cosf(refCoordinate.longitude() * DEG_TO_RAD));
-    refLocalPosition.setY(refXY * sinf(refCoordinate.longitude() * DEG_TO_RAD));
-    refLocalPosition.setZ(_radius * sinf(refCoordinate.latitude() * DEG_TO_RAD));
-
-    for(int i = 0; i <= _stackCount; ++i){
-        stackAngle = stackRef - i * stackStep;        // starting from 90 to -90
-
-        for(int j = 0; j <= _sectorCount; ++j){
-            sectorAngle = sectorRef + j * sectorStep;           // starting from -180 to 180
-
-            Vertex vertex;
-            localPoint = mapGpsToLocalPoint(QGeoCoordinate(stackAngle, sectorAngle, 0), refCoordinate);
-            vertex.x = localPoint.x();
-            vertex.y = localPoint.y();
-            vertex.z = 0;
-
-            vertex.s = (sectorAngle + 180.0f) / 360.0f;
-            minS = fmin(minS, vertex.s);
-            maxS = fmax(maxS, vertex.s);
-            if(abs(stackAngle) < MaxLatitude){
-                double sinLatitude = sin(stackAngle * DEG_TO_RAD);
-                vertex.t = 0.5 - log((1 + sinLatitude) / (1 - sinLatitude)) / (4 * PI);
+    auto appendVertex = [&](int r, int c, float zOffset) {
+        const QVector3D& position = sample(r, c);
+        const QVector3D east = sample(r, c + 1) - sample(r, c - 1);
+        const QVector3D northward = sample(r - 1, c) - sample(r + 1, c);
+        const QVector3D normal = QVector3D::crossProduct(east, northward).normalized();
 
-            }else{
-                vertex.t = (stackRef - stackAngle) / 180;
-            }
-            minT = fmin(minT, vertex.t);
-            maxT = fmax(maxT, vertex.t);
+        *p++ = position.x();
+        *p++ = position.y();
+        *p++ = position.z() - zOffset;
+
+        *p++ = normal.x();
+        *p++ = normal.y();
+        *p++ = normal.z();
+
+        *p++ = static_cast<float>((west + c * lonStep - roiWest) / roiWidth);
+        *p++ = static_cast<float>((mercatorY(north - r * latStep) - tNorth) / (tSouth - tNorth));
+    };
 
-            tmpVertices.push_back(vertex);
+    for(int r = 0; r <= resolution; r++){
+        for(int c = 0; c <= resolution; c++){
+            appendVertex(r, c, 0);
         }
     }
+    // Skirts in the order of _indexPattern: top, bottom, left and right edges
+    for(int k = 0; k <= resolution; k++){ appendVertex(0, k, skirtDepth); }
+    for(int k = 0; k <= resolution; k++){ appendVertex(resolution, k, skirtDepth); }
+    for(int k = 0; k <= resolution; k++){ appendVertex(k, 0, skirtDepth); }
+    for(int k = 0; k <= resolution; k++){ appendVertex(k, resolution, skirtDepth); }
 
-    float scaleT = maxT - minT;
-    float scaleS = maxS - minS;
-    _vertices.clear();
-    _texCoords.clear();
-    _normals.clear();
-    Vertex v1, v2, v3, v4;                          // 4 vertex positions and texture coords
-    int i, j, vi1, vi2;
-    QVector3D _n;
-    for(i = 0; i < _stackCount; ++i){
-        vi1 = i * (_sectorCount + 1);                // index of tmpVertices
-        vi2 = (i + 1) * (_sectorCount + 1);
-        stackAngle = stackRef - i * stackStep;
-        for(j = 0; j < _sectorCount; ++j, ++vi1, ++vi2){
-            // get 4 vertices per sector
-            //  v1--v3
-            //  |    |
-            //  v2--v4
+    return meshTile;
+}
 
-            v1 = tmpVertices[vi1];
-            v2 = tmpVertices[vi2];
-            v3 = tmpVertices[vi1 + 1];
-            v4 = tmpVertices[vi2 + 1];
-
-            if(scale){
-                v1.s = (v1.s - minS) / scaleS;
-                v1.t = (v1.t - minT) / scaleT;
-                v2.s = (v2.s - minS) / scaleS;
-                v2.t = (v2.t - minT) / scaleT;
-                v3.s = (v3.s - minS) / scaleS;
-                v3.t = (v3.t - minT) / scaleT;
-                v4.s = (v4.s - minS) / scaleS;
-                v4.t = (v4.t - minT) / scaleT;
-            }
+void Viewer3DTerrainGeometry::_activeVehicleChangedEvent(Vehicle *vehicle)
+{
+    if(_activeVehicle){
+        disconnect(_activeVehicle, &Vehicle::coordinateChanged, this, &Viewer3DTerrainGeometry::_activeVehicleCoordinateChanged);
+    }
 
-            // 2 triangles per sector excluding 1st and last stacks
-            if(stackAngle < 90){
-                _vertices.push_back(QVector3D(v1.x, v1.y, v1.z));
-                _vertices.push_back(QVector3D(v2.x, v2.y, v2.z));
-                _vertices.push_back(QVector3D(v3.x, v3.y, v3.z));
+    _activeVehicle = vehicle;
+    if(_activeVehicle){
+        connect(_activeVehicle, &Vehicle::coordinateChanged, this, &Viewer3DTerrainGeometry::_activeVehicleCoordinateChanged);
+    }
+    _activeVehicleCoordinateChanged(QGeoCoordinate());
+}
 
-                _texCoords.push_back(QVector2D(v1.s, v1.t));
-                _texCoords.push_back(QVector2D(v2.s, v2.t));
-                _texCoords.push_back(QVector2D(v3.s, v3.t));
+void Viewer3DTerrainGeometry::_activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate)
+{
+    Q_UNUSED(newCoordinate);
 
-                _n = computeFaceNormal(QVector3D(v1.x,v1.y,v1.z),
-                                       QVector3D(v2.x,v2.y,v2.z),
-                                       QVector3D(v3.x,v3.y,v3.z));
+    // Only the tiles whose level of detail changes are generated once the vehicle moves into another tile
+    if(_grid.sectorCount > 0 && _viewTile() != _uploadedViewTile){
+        _startTileGeneration();
+    }
+}
 
-                for(int k = 0; k < 3; ++k)  // same normals for 3 vertices
-                {
-                    _normals.push_back(_n);
-                }
-            }
+void Viewer3DTerrainGeometry::clearScene()
+{
+    clear();
+    setSectorCount(0);
+    setStackCount(0);
+    _grid = TerrainGrid_t();
+    _generation++;
+    _meshTiles.clear();
+    _elevationRetryTimer.stop();
+    _uploadedViewTile = QPoint(-1, -1);
+    update();
+}
 
-            if(stackAngle > -90){
-                _vertices.push_back(QVector3D(v3.x, v3.y, v3.z));
-                _vertices.push_back(QVector3D(v2.x, v2.y, v2.z));
-                _vertices.push_back(QVector3D(v4.x, v4.y, v4.z));
+int Viewer3DTerrainGeometry::sectorCount() const
+{
+    return _sectorCount;
+}
 
-                _texCoords.push_back(QVector2D(v3.s, v3.t));
-                _texCoords.push_back(QVector2D(v2.s, v2.t));
-                _texCoords.push_back(QVector2D(v4.s, v4.t));
+void Viewer3DTerrainGeometry::setSectorCount(int newSectorCount)
+{
+    if (_sectorCount == newSectorCount)
+        return;
+    _sectorCount = newSectorCount;
+    emit sectorCountChanged();
+}
 
-                _n = computeFaceNormal(QVector3D(v3.x,v3.y,v3.z),
-                                       QVector3D(v2.x,v2.y,v2.z),
-                                       QVector3D(v4.x,v4.y,v4.z));
+int Viewer3DTerrainGeometry::stackCount() const
+{
+    return _stackCount;
+}
 
-                for(int k = 0; k < 3; ++k)  // same normals for 3 vertices
-                {
-                    _normals.push_back(_n);
-                }
-            }
-        }
-    }
-    return true;
+void Viewer3DTerrainGeometry::setStackCount(int newStackCount)
+{
+    if (_stackCount == newStackCount)
+        return;
+    _stackCount = newStackCount;
+    emit stackCountChanged();
 }
 
 int Viewer3DTerrainGeometry::radius() const
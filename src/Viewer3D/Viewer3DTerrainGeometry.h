@@ -11,13 +11,22 @@
 
 #include <QtQuick3D/QQuick3DGeometry>
 #include <QtPositioning/QGeoCoordinate>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QPoint>
+#include <QtCore/QTimer>
 #include <QtGui/QVector3D>
 #include <QtGui/QVector2D>
 
 class Viewer3DSettings;
+class Vehicle;
 
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
+/// Terrain under the map texture. The region of interest is split into one mesh tile per map tile. Tiles close to
+/// the vehicle get the finest grid, tiles further away coarser ones. Tiles are generated on a worker thread from
+/// the cached elevation tiles and kept by tile and level of detail, so moving the vehicle only generates the
+/// tiles whose level of detail changed.
 class Viewer3DTerrainGeometry : public QQuick3DGeometry
 {
     Q_OBJECT
@@ -54,19 +63,48 @@ public:
     void setRefCoordinate(const QGeoCoordinate &newRefCoordinate);
 
 private:
+    /// Snapshot of the terrain layout, safe to use on the worker thread
+    typedef struct TerrainGrid_s
+    {
+        QGeoCoordinate roiMin;
+        QGeoCoordinate roiMax;
+        QGeoCoordinate refCoordinate;
+        int sectorCount = 0;
+        int stackCount = 0;
+
+        bool operator==(const TerrainGrid_s& other) const {
+            return roiMin == other.roiMin && roiMax == other.roiMax && refCoordinate == other.refCoordinate &&
+                   sectorCount == other.sectorCount && stackCount == other.stackCount;
+        }
+    }TerrainGrid_t;
+
+    typedef struct MeshTile_s
+    {
+        QByteArray vertexData;      ///< Interleaved position, normal and texture coordinate
+        int resolution = 0;         ///< Quads along each edge
+        bool complete = false;      ///< false: generated while some of the elevation data was missing
+    }MeshTile_t;
+
+    typedef struct MeshTileResult_s
+    {
+        quint64 generation = 0;
+        QList<std::pair<quint64, MeshTile_t>> tiles;
+    }MeshTileResult_t;
 
     int _sectorCount;
     int _stackCount;
-    std::vector<QVector3D> _vertices;
-    std::vector<QVector2D> _texCoords;
-    std::vector<QVector3D> _normals;
 
-    void buildTerrain(QGeoCoordinate roiMinCoordinate, QGeoCoordinate roiMaxCoordinate, QGeoCoordinate refCoordinate, bool scale);
-    bool buildTerrain_2(QGeoCoordinate roiMinCoordinate, QGeoCoordinate roiMaxCoordinate, QGeoCoordinate refCoordinate, bool scale);
-
-    QVector3D computeFaceNormal(QVector3D x1, QVector3D x2, QVector3D x3);
-    void changeUpAxis(int from, int to);
     void clearScene();
+    void _startTileGeneration(bool regenerateIncomplete = false);
+    void _tilesGenerated();
+    void _uploadTiles();
+    QPoint _viewTile() const;
+    int _tileResolution(int row, int col) const;
+    const QList<quint32>& _indexPattern(int resolution);
+
+    static quint64 _meshTileKey(int row, int col, int resolution) { return (static_cast<quint64>(row) << 40) | (static_cast<quint64>(col) << 16) | static_cast<quint64>(resolution); }
+    static MeshTile_t _generateTile(const TerrainGrid_t& grid, int row, int col, int resolution, double refElevation, bool refElevationValid);
+    static MeshTileResult_t _generateTiles(const TerrainGrid_t& grid, quint64 generation, const QList<QPoint>& tiles, const QList<int>& resolutions);
 
     int _radius;
     QGeoCoordinate _roiMin;
@@ -74,6 +112,26 @@ private:
     QGeoCoordinate _refCoordinate;
     Viewer3DSettings* _viewer3DSettings = nullptr;
 
+    TerrainGrid_t _grid;                                ///< Layout of the tiles in _meshTiles
+    quint64 _generation = 0;                            ///< Incremented whenever the layout changes
+    QHash<quint64, MeshTile_t> _meshTiles;
+    QHash<int, QList<quint32>> _indexPatterns;          ///< Triangle indices of a tile by resolution, shared by all tiles
+    QFutureWatcher<MeshTileResult_t> _tileWatcher;
+    QTimer _elevationRetryTimer;
+    int _elevationRetries = 0;
+    Vehicle* _activeVehicle = nullptr;
+    QPoint _uploadedViewTile{-1, -1};
+
+    static constexpr int kMaxTileResolution = 32;
+    static constexpr int kMinTileResolution = 4;
+    static constexpr int kLodRingWidth = 2;             ///< Tiles per level of detail around the vehicle
+    static constexpr float kSkirtDepth = 0.05f;         ///< Depth of the skirts hiding the cracks between levels of detail, in tile edge lengths
+    static constexpr int kElevationRetryMSecs = 2000;
+    static constexpr int kMaxElevationRetries = 15;     ///< Incomplete tiles are generated again until the elevation tiles are downloaded
+
+private slots:
+    void _activeVehicleChangedEvent(Vehicle* vehicle);
+    void _activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate);
 
 signals:
 
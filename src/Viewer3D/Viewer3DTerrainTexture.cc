@@ -46,27 +46,35 @@ void Viewer3DTerrainTexture::loadTexture()
         if(!_terrainTileLoader){
             _terrainTileLoader = new MapTileQuery(this);
             connect(_terrainTileLoader, &MapTileQuery::loadingMapCompleted, this, &Viewer3DTerrainTexture::updateTexture);
+            connect(_terrainTileLoader, &MapTileQuery::mapTextureUpdated, this, &Viewer3DTerrainTexture::uploadTexture);
             connect(_terrainTileLoader, &MapTileQuery::textureGeometryReady, this, &Viewer3DTerrainTexture::setTextureGeometry);
         }
+        connect(_terrainTileLoader, &MapTileQuery::mapTileDownloaded, this, &Viewer3DTerrainTexture::setTextureDownloadProgress, Qt::UniqueConnection);
         _terrainTileLoader->adaptiveMapTilesLoader(_mapType, _mapId,
                                                    _osmParser->getMapBoundingBoxCoordinate().first,
                                                    _osmParser->getMapBoundingBoxCoordinate().second);
-        connect(_terrainTileLoader, &MapTileQuery::mapTileDownloaded, this, &Viewer3DTerrainTexture::setTextureDownloadProgress);
     }
 }
 
-void Viewer3DTerrainTexture::updateTexture()
+/// Uploads the texture as far as it is loaded, the previous texture stays in place until the first level is in
+void Viewer3DTerrainTexture::uploadTexture()
 {
-    MapTileQuery* _extureQuery = qobject_cast<MapTileQuery*>(QObject::sender());
-
     setSize(_terrainTileLoader->getMapSize());
-    setFormat(QQuick3DTextureData::RGBA32F);
+    setFormat(QQuick3DTextureData::RGBA8);
     setHasTransparency(false);
 
     setTextureData(_terrainTileLoader->getMapData());
     setTextureLoaded(true);
     setTextureGeometryDone(true);
+}
+
+void Viewer3DTerrainTexture::updateTexture()
+{
+    MapTileQuery* _extureQuery = qobject_cast<MapTileQuery*>(QObject::sender());
+
+    uploadTexture();
     disconnect(_terrainTileLoader, &MapTileQuery::mapTileDownloaded, this, &Viewer3DTerrainTexture::setTextureDownloadProgress);
+    disconnect(_terrainTileLoader, &MapTileQuery::mapTextureUpdated, this, &Viewer3DTerrainTexture::uploadTexture);
     disconnect(_terrainTileLoader, &MapTileQuery::loadingMapCompleted, this, &Viewer3DTerrainTexture::updateTexture);
     _terrainTileLoader = nullptr;
     setTextureDownloadProgress(100.0);
@@ -185,6 +193,8 @@ void Viewer3DTerrainTexture::setTextureDownloadProgress(float newTextureDownload
 
 void Viewer3DTerrainTexture::setTextureGeometry(MapTileQuery::TileStatistics_t tileInfo)
 {
+    // The geometry is updated along with the next texture upload
+    setTextureGeometryDone(false);
     setRoiMinCoordinate(tileInfo.coordinateMin);
     setRoiMaxCoordinate(tileInfo.coordinateMax);
     setTileCount(tileInfo.tileCounts);
@@ -70,6 +70,7 @@ private:
     int _mapId;
 
     void updateTexture();
+    void uploadTexture();
     void setTextureLoaded(bool laoded){_textureLoaded = laoded; emit textureLoadedChanged();}
     void mapTypeChangedEvent(void);
 
@@ -8,20 +8,23 @@
  ****************************************************************************/
 
 #include "Viewer3DTileQuery.h"
+#include "QGCLoggingCategory.h"
+
+#include <QGCTileAtlas.h>
+
+#include <QtGui/QPainter>
+
+#include <cmath>
 
 #define PI                  acos(-1.0f)
 #define DEG_TO_RAD          PI/180.0f
 #define RAD_TO_DEG          180.0f/PI
 #define MAX_TILE_COUNTS     200
 #define MAX_ZOOM_LEVEL      23
+#define MAX_TEXTURE_SIZE    4096    // Supported by all GPUs Qt Quick 3D runs on
+#define MAX_TEXTURE_TILES   (MAX_TEXTURE_SIZE / QGCTileAtlas::kTileSize)
 
-
-enum RequestStat{
-    STARTED,
-    IN_PROGRESS,
-    FINISHED,
-    ERROR,
-};
+QGC_LOGGING_CATEGORY(Viewer3DTileQueryLog, "qgc.viewer3d.viewer3dtilequery")
 
 MapTileQuery::MapTileQuery(QObject *parent)
     : QObject{parent}
@@ -30,26 +33,17 @@ MapTileQuery::MapTileQuery(QObject *parent)
 
 void MapTileQuery::loadMapTiles(int zoomLevel, QPoint tileMinIndex, QPoint tileMaxIndex)
 {
-    _mapTilesLoadStat = RequestStat::STARTED;
-    _mapToBeLoaded.clear();
-    _mapToBeLoaded.zoomLevel = zoomLevel;
-    _mapToBeLoaded.tileMinIndex = tileMinIndex;
-    _mapToBeLoaded.tileMaxIndex = tileMaxIndex;
-    _mapToBeLoaded.init();
-
-    for (int x = tileMinIndex.x(); x <= tileMaxIndex.x(); x++) {
-        for (int y = tileMinIndex.y(); y <= tileMaxIndex.y(); y++) {
-            QString tileKey = getTileKey(_mapId, x, y, zoomLevel);
-            _mapToBeLoaded.tileList.append(tileKey);
-            Viewer3DTileReply* _reply = new Viewer3DTileReply(zoomLevel, x, y, _mapId, this);
-            connect(_reply, &Viewer3DTileReply::tileDone, this, &MapTileQuery::tileDone);
-            connect(_reply, &Viewer3DTileReply::tileGiveUp, this, &MapTileQuery::tileGiveUp);
-            connect(_reply, &Viewer3DTileReply::tileEmpty, this, &MapTileQuery::tileEmpty);
-        }
+    if(_tileAtlas){
+        _tileAtlas->disconnect(this);
+        _tileAtlas->deleteLater();
     }
-    totalTilesCount = _mapToBeLoaded.tileList.size();
-    downloadedTilesCount = 0;
-    qDebug() << totalTilesCount << "Tiles to be downloaded!!";
+
+    // Tiles come from the same caches the 2D map fills, so only tiles which were never shown get downloaded
+    _tileAtlas = new QGCTileAtlas(_mapId, zoomLevel, QRect(tileMinIndex, tileMaxIndex), QImage::Format_RGBA8888, this);
+    connect(_tileAtlas, &QGCTileAtlas::progress, this, &MapTileQuery::tileAtlasProgress);
+    connect(_tileAtlas, &QGCTileAtlas::finished, this, &MapTileQuery::tileAtlasFinished);
+    qCDebug(Viewer3DTileQueryLog) << _tileAtlas->tileCount() << "tiles to be loaded";
+    _tileAtlas->start();
 }
 
 MapTileQuery::TileStatistics_t MapTileQuery::findAndLoadMapTiles(int zoomLevel, QGeoCoordinate coordinate_1, QGeoCoordinate coordinate_2)
@@ -65,6 +59,7 @@ MapTileQuery::TileStatistics_t MapTileQuery::findAndLoadMapTiles(int zoomLevel,
 
     QPoint minTile = pixelXYToTileXY(minPixel);
     QPoint maxTile = pixelXYToTileXY(maxPixel);
+    _textureTiles = QRect(minTile, maxTile);
 
     minPixel = tileXYToPixelXY(minTile);
     maxPixel = tileXYToPixelXY(QPoint(maxTile.x() + 1, maxTile.y() + 1)); //since the coordinate is for the top left corner of each tile
@@ -76,7 +71,28 @@ MapTileQuery::TileStatistics_t MapTileQuery::findAndLoadMapTiles(int zoomLevel,
     QGeoCoordinate minCoordinate_ = QGeoCoordinate(maxCoordinate.latitude(), minCoordinate.longitude(), 0);
     QGeoCoordinate maxCoordinate_ = QGeoCoordinate(minCoordinate.latitude(), maxCoordinate.longitude(), 0);
 
-    loadMapTiles(zoomLevel, minTile, maxTile);
+    _mapTextureImage = QImage(_textureTiles.size() * QGCTileAtlas::kTileSize, QImage::Format_RGBA8888);
+    _mapTextureImage.fill(Qt::gray);
+
+    // Levels two and four zoom levels coarser have a sixteenth and a 256th of the tiles
+    _streamZoomLevels.clear();
+    _streamTileCount = 0;
+    _streamTilesDone = 0;
+    for(int zoomStep : {4, 2, 0}){
+        const int streamZoomLevel = zoomLevel - zoomStep;
+        if(streamZoomLevel < 0){
+            continue;
+        }
+        const QRect levelTiles = streamLevelTiles(streamZoomLevel);
+        const int levelTileCount = levelTiles.width() * levelTiles.height();
+        if(zoomStep != 0 && levelTileCount * 4 > _textureTiles.width() * _textureTiles.height()){
+            // Not much quicker than the texture zoom level itself
+            continue;
+        }
+        _streamZoomLevels.append(streamZoomLevel);
+        _streamTileCount += levelTileCount;
+    }
+    loadNextStreamLevel();
 
     TileStatistics_t _output;
     _output.coordinateMin = minCoordinate_;
@@ -92,7 +108,9 @@ void MapTileQuery::adaptiveMapTilesLoader(QString mapType, int mapId, QGeoCoordi
     _mapId = mapId;
     _mapType = mapType;
     for(_zoomLevel=MAX_ZOOM_LEVEL; _zoomLevel>0; _zoomLevel--){
-        if(maxTileCount(_zoomLevel, coordinate_1, coordinate_2) < MAX_TILE_COUNTS){
+        const QRect tiles = tileRect(_zoomLevel, coordinate_1, coordinate_2);
+        if(maxTileCount(_zoomLevel, coordinate_1, coordinate_2) < MAX_TILE_COUNTS &&
+                tiles.width() <= MAX_TEXTURE_TILES && tiles.height() <= MAX_TEXTURE_TILES){
             break;
         }
     }
@@ -102,6 +120,52 @@ void MapTileQuery::adaptiveMapTilesLoader(QString mapType, int mapId, QGeoCoordi
     emit textureGeometryReady(findAndLoadMapTiles(_zoomLevel, coordinate_1, coordinate_2));
 }
 
+/// Tiles which cover the area between the two coordinates
+QRect MapTileQuery::tileRect(int zoomLevel, QGeoCoordinate coordinate_1, QGeoCoordinate coordinate_2)
+{
+    QGeoCoordinate minCoordinate = QGeoCoordinate(fmax(coordinate_1.latitude(), coordinate_2.latitude()), fmin(coordinate_1.longitude(), coordinate_2.longitude()), 0);
+    QGeoCoordinate maxCoordinate = QGeoCoordinate(fmin(coordinate_1.latitude(), coordinate_2.latitude()), fmax(coordinate_1.longitude(), coordinate_2.longitude()), 0);
+
+    return QRect(pixelXYToTileXY(latLonToPixelXY(minCoordinate, zoomLevel)), pixelXYToTileXY(latLonToPixelXY(maxCoordinate, zoomLevel)));
+}
+
+/// Tiles of a coarser zoom level which cover the texture tiles
+QRect MapTileQuery::streamLevelTiles(int zoomLevel) const
+{
+    const int zoomStep = _zoomLevel - zoomLevel;
+    return QRect(QPoint(_textureTiles.left() >> zoomStep, _textureTiles.top() >> zoomStep),
+                 QPoint(_textureTiles.right() >> zoomStep, _textureTiles.bottom() >> zoomStep));
+}
+
+void MapTileQuery::loadNextStreamLevel()
+{
+    const int zoomLevel = _streamZoomLevels.takeFirst();
+    const QRect tiles = streamLevelTiles(zoomLevel);
+    loadMapTiles(zoomLevel, tiles.topLeft(), tiles.bottomRight());
+}
+
+/// Scales the part of a coarser level's atlas which the texture covers up to the whole texture
+void MapTileQuery::paintStreamLevel(const QGCTileAtlas* atlas)
+{
+    const double scale = 1.0 / (1 << (_zoomLevel - atlas->zoom()));
+    const QRectF source((_textureTiles.left() * scale - atlas->tiles().left()) * QGCTileAtlas::kTileSize,
+                        (_textureTiles.top() * scale - atlas->tiles().top()) * QGCTileAtlas::kTileSize,
+                        _textureTiles.width() * scale * QGCTileAtlas::kTileSize,
+                        _textureTiles.height() * scale * QGCTileAtlas::kTileSize);
+
+    QPainter painter(&_mapTextureImage);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(QRectF(_mapTextureImage.rect()), atlas->atlas(), source);
+}
+
+void MapTileQuery::tileAtlasProgress(float progress)
+{
+    if(!_tileAtlas || _streamTileCount == 0){
+        return;
+    }
+    emit mapTileDownloaded(100.f * (_streamTilesDone + progress / 100.f * _tileAtlas->tileCount()) / _streamTileCount);
+}
+
 int MapTileQuery::maxTileCount(int zoomLevel, QGeoCoordinate coordinateMin, QGeoCoordinate coordinateMax)
 {
     double mapSize = powf(2, zoomLevel);
@@ -174,60 +238,28 @@ QGeoCoordinate MapTileQuery::pixelXYToLatLong(QPoint pixel, int zoomLevel)
     return QGeoCoordinate(latitude, longitude, 0);
 }
 
-void MapTileQuery::tileDone(Viewer3DTileReply::tileInfo_t _tileData)
+void MapTileQuery::tileAtlasFinished()
 {
-    Viewer3DTileReply* reply = qobject_cast<Viewer3DTileReply*>(QObject::sender());
-
-    QString tileKey = getTileKey(_tileData.mapId, _tileData.x, _tileData.y, _tileData.zoomLevel);
-    qsizetype itemRemoved = _mapToBeLoaded.tileList.removeAll(tileKey);
-
-    if(itemRemoved > 0){
-        _mapToBeLoaded.currentTileIndex = QPoint(_tileData.x, _tileData.y);
-        _mapToBeLoaded.currentTileData = _tileData.data;
-        _mapToBeLoaded.currentTileStat = RequestStat::FINISHED;
-        _mapToBeLoaded.setMapTile();
-        downloadedTilesCount++;
-        emit mapTileDownloaded(100.0 * ((float) downloadedTilesCount/ (float)totalTilesCount));
-
-        // qDebug() << _tileData.x << _tileData.y << _tileData.zoomLevel << "tile downloaded!!!" << _mapToBeLoaded.tileList.size();
-
-        if(_mapToBeLoaded.tileList.size() == 0){
-            _mapTilesLoadStat = RequestStat::FINISHED;
-            qDebug() << "All tiles downloaded ";
-            downloadedTilesCount = totalTilesCount;
-            emit loadingMapCompleted();
-        }
-
+    QGCTileAtlas* atlas = _tileAtlas;
+    _tileAtlas = nullptr;
+    atlas->deleteLater();
+    _streamTilesDone += atlas->tileCount();
+
+    if(atlas->zoom() != _zoomLevel){
+        paintStreamLevel(atlas);
+        emit mapTextureUpdated();
+        loadNextStreamLevel();
+        return;
     }
-    disconnect(reply, &Viewer3DTileReply::tileDone, this, &MapTileQuery::tileDone);
-    disconnect(reply, &Viewer3DTileReply::tileGiveUp, this, &MapTileQuery::tileGiveUp);
-    disconnect(reply, &Viewer3DTileReply::tileEmpty, this, &MapTileQuery::tileEmpty);
-    reply->deleteLater();
-}
-
-void MapTileQuery::tileGiveUp(Viewer3DTileReply::tileInfo_t _tileData)
-{
-    Viewer3DTileReply* reply = qobject_cast<Viewer3DTileReply*>(QObject::sender());
-    disconnect(reply, &Viewer3DTileReply::tileDone, this, &MapTileQuery::tileDone);
-    disconnect(reply, &Viewer3DTileReply::tileGiveUp, this, &MapTileQuery::tileGiveUp);
-    disconnect(reply, &Viewer3DTileReply::tileEmpty, this, &MapTileQuery::tileEmpty);
-    reply->deleteLater();
-}
 
-void MapTileQuery::tileEmpty(Viewer3DTileReply::tileInfo_t _tileData)
-{
-    Viewer3DTileReply* reply = qobject_cast<Viewer3DTileReply*>(QObject::sender());
-    disconnect(reply, &Viewer3DTileReply::tileDone, this, &MapTileQuery::tileDone);
-    disconnect(reply, &Viewer3DTileReply::tileEmpty, this, &MapTileQuery::tileEmpty);
-    reply->deleteLater();
-    if(_tileData.zoomLevel > 0 && _tileData.zoomLevel == _zoomLevel){
+    if(atlas->unavailableCount() > 0 && _zoomLevel > 0){
+        // The provider has no tiles at this zoom level for part of the area
         _zoomLevel -= 1;
         emit textureGeometryReady(findAndLoadMapTiles(_zoomLevel, _textureCoordinateMin, _textureCoordinateMax));
+        return;
     }
-}
 
-QString MapTileQuery::getTileKey(int mapId, int x, int y, int zoomLevel)
-{
-    return QString::asprintf("%010d%08d%08d%03d", mapId, x, y, zoomLevel);
+    _mapTextureImage = atlas->atlas();
+    qCDebug(Viewer3DTileQueryLog) << "All tiles loaded," << atlas->failedCount() << "failed";
+    emit loadingMapCompleted();
 }
-
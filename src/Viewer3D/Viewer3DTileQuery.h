@@ -9,14 +9,12 @@
 
 #pragma once
 
-#include <QtGui/QPixmap>
 #include <QtCore/QObject>
-#include <QtGui/QImage>
-#include <QtGui/QPainter>
 #include <QtCore/QDebug>
+#include <QtGui/QImage>
 #include <QtPositioning/QGeoCoordinate>
 
-#include "Viewer3DTileReply.h"
+class QGCTileAtlas;
 
 
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
@@ -26,77 +24,6 @@ class MapTileQuery : public QObject
 {
 
 public:
-    typedef struct MapTileContainer_s
-    {
-        int L = 256; // length of each square image downloaded tile
-
-        QList<QString> tileList;
-        int zoomLevel;
-        QPoint tileMinIndex;
-        QPoint tileMaxIndex;
-        int currentTileStat;
-
-        QPoint currentTileIndex;
-        QByteArray currentTileData;
-
-        QImage mapTextureImage;
-        // QByteArray mapTextureImageData;
-        int mapWidth, mapHeight;
-        void init(){
-            mapWidth = (tileMaxIndex.x() - tileMinIndex.x() + 1) * L;
-            mapHeight = (tileMaxIndex.y() - tileMinIndex.y() + 1) * L;
-            mapTextureImage = QImage(mapWidth, mapHeight, QImage::Format_RGBA32FPx4);
-            mapTextureImage.fill(Qt::gray);
-            // mapTextureImageData.resize(mapWidth * mapHeight * 4 * 4); // 4 channnels and each 4 bytes
-            // mapTextureImageData = QByteArray((char*)mapTextureImage.bits(), mapTextureImage.sizeInBytes());
-        }
-
-        void setMapTile(){
-            QPixmap tmpPixmap;
-            tmpPixmap.loadFromData(currentTileData);
-            QImage tmpImage = tmpPixmap.toImage().convertToFormat(QImage::Format_RGBA32FPx4);
-
-            QPainter painter(&mapTextureImage);
-            int idxX = (currentTileIndex.x() - tileMinIndex.x()) * L;
-            int idxY = (currentTileIndex.y() - tileMinIndex.y()) * L;
-            painter.drawImage(idxX,
-                              idxY,
-                              tmpImage);
-
-            // int startByteIdx = idxX * mapHeight + idxY;
-            // startByteIdx = startByteIdx * 4 * 4;
-            // QByteArray tmpImageData =  QByteArray::fromRawData((const char*)tmpImage.bits(), tmpImage.sizeInBytes());
-            // memcpy(mapTextureImageData.data() + startByteIdx, tmpImageData.constData(), tmpImageData.size());
-            // mapTextureImageData.replace(startByteIdx, tmpImageData.size(), tmpImageData);
-
-            // QByteArray tmpImageData =  QByteArray::fromRawData((const char*)tmpImage.bits(), tmpImage.sizeInBytes());
-            // for(int i_x=0; i_x<tmpImageData.size(); i_x+=16){
-            //     mapTextureImageData.replace(startByteIdx, 4, tmpImageData.sliced(i_x, 4));
-            //     startByteIdx+=4;
-            //     mapTextureImageData.replace(startByteIdx, 4, tmpImageData.sliced(i_x+4, 4));
-            //     startByteIdx+=4;
-            //     mapTextureImageData.replace(startByteIdx, 4, tmpImageData.sliced(i_x+8, 4));
-            //     startByteIdx+=4;
-            //     mapTextureImageData.replace(startByteIdx, 4, tmpImageData.sliced(i_x+12, 4));
-            //     startByteIdx+=4;
-            //     // mapTextureImageData.replace(startByteIdx, 4, _alphaCh);
-            //     // startByteIdx+=4;
-            // }
-            // qDebug() << startByteIdx << mapTextureImageData.size();
-        }
-
-        QByteArray getMapData(){
-            QByteArray tmpImageData =  QByteArray::fromRawData((const char*)mapTextureImage.bits(), mapTextureImage.sizeInBytes());
-            tmpImageData.data();
-            return tmpImageData;
-            // return mapTextureImageData;
-        }
-
-        void clear(){
-            tileList.clear();
-        }
-    }MapTileContainer_t;
-
     typedef struct TileStatistics_s{
         QGeoCoordinate coordinateMin;
         QGeoCoordinate coordinateMax;
@@ -110,33 +37,41 @@ public:
     explicit MapTileQuery(QObject *parent = nullptr);
     void adaptiveMapTilesLoader(QString mapType, int mapId, QGeoCoordinate coordinate_1, QGeoCoordinate coordinate_2);
     int maxTileCount(int zoomLevel, QGeoCoordinate coordinateMin, QGeoCoordinate coordinateMax);
-    QByteArray getMapData(){ return _mapToBeLoaded.getMapData();}
-    QSize getMapSize(){ return QSize(_mapToBeLoaded.mapWidth, _mapToBeLoaded.mapHeight);}
+    QByteArray getMapData(){ return QByteArray(reinterpret_cast<const char*>(_mapTextureImage.constBits()), _mapTextureImage.sizeInBytes());}
+    QSize getMapSize(){ return _mapTextureImage.size();}
 
 private:
-    int _mapTilesLoadStat;
-    MapTileContainer_t _mapToBeLoaded;
-    int totalTilesCount, downloadedTilesCount;
+    QGCTileAtlas* _tileAtlas = nullptr;
+    QImage _mapTextureImage;
     int _mapId;
     int _zoomLevel;
     QString _mapType;
     QGeoCoordinate _textureCoordinateMin, _textureCoordinateMax;
 
+    // The texture is streamed in coarse to fine: the tiles of lower zoom levels, which are few and usually cached,
+    // fill the whole texture quickly and are replaced once the tiles of the texture zoom level are in.
+    QRect _textureTiles;                ///< Tiles of the texture at _zoomLevel
+    QList<int> _streamZoomLevels;       ///< Zoom levels still to be loaded, the last one is _zoomLevel
+    int _streamTileCount = 0;           ///< Tiles of all levels
+    int _streamTilesDone = 0;           ///< Tiles of the levels already loaded
+
     void loadMapTiles(int zoomLevel, QPoint tileMinIndex, QPoint tileMaxIndex);
+    void loadNextStreamLevel();
+    QRect streamLevelTiles(int zoomLevel) const;
+    void paintStreamLevel(const QGCTileAtlas* atlas);
+    QRect tileRect(int zoomLevel, QGeoCoordinate coordinate_1, QGeoCoordinate coordinate_2);
     TileStatistics_t findAndLoadMapTiles(int zoomLevel, QGeoCoordinate coordinate_1, QGeoCoordinate coordinate_2);
     double valueClip(double n, double _minValue, double _maxValue);
     QPoint latLonToPixelXY(QGeoCoordinate pointCoordinate, int zoomLevel);
     QPoint pixelXYToTileXY(QPoint pixel);
     QPoint tileXYToPixelXY(QPoint tile);
     QGeoCoordinate pixelXYToLatLong(QPoint pixel, int zoomLevel);
-    void tileDone(Viewer3DTileReply::tileInfo_t _tileData);
-    void tileGiveUp(Viewer3DTileReply::tileInfo_t _tileData);
-    void tileEmpty(Viewer3DTileReply::tileInfo_t _tileData);
-    void httpReadyRead();
-    QString getTileKey(int mapId, int x, int y, int zoomLevel);
+    void tileAtlasFinished();
+    void tileAtlasProgress(float progress);
 
 signals:
     void loadingMapCompleted();
+    void mapTextureUpdated();       ///< A coarser level of the texture is ready while the finer ones are loading
     void mapTileDownloaded(float progress);
     void textureGeometryReady(TileStatistics_t tileInfo);
 };
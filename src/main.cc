@@ -63,7 +63,10 @@ void sigHandler(int s)
 {
     std::signal(s, SIG_DFL);
     if(qgcApp()) {
-        qgcApp()->mainRootWindow()->close();
+        // Headless modes have no window
+        if (qgcApp()->mainRootWindow()) {
+            qgcApp()->mainRootWindow()->close();
+        }
         QEvent event{QEvent::Quit};
         qgcApp()->event(&event);
     }
@@ -127,6 +130,17 @@ int main(int argc, char *argv[])
     // install the message handler
     AppMessages::installHandler();
 
+    // Headless modes never show a window, so they also have to run on machines without a display
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        for (int i = 1; i < argc; i++) {
+            const QString arg(argv[i]);
+            if (arg.startsWith(QStringLiteral("--telemetry-server")) || arg.startsWith(QStringLiteral("--replay-log"))) {
+                qputenv("QT_QPA_PLATFORM", "offscreen");
+                break;
+            }
+        }
+    }
+
 #ifdef Q_OS_MAC
 #ifndef Q_OS_IOS
     // Prevent Apple's app nap from screwing us over
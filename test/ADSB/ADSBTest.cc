@@ -2,7 +2,7 @@
 #include "ADSBVehicleManager.h"
 #include "ADSBVehicle.h"
 #include "ADSBTCPLink.h"
-#include "QmlObjectListModel.h"
+#include "ADSBVehicleListModel.h"
 
 #include <QtNetwork/QTcpServer>
 #include <QtTest/QTest>
@@ -49,9 +49,10 @@ void ADSBTest::_adsbTcpLinkTest()
     QVERIFY(server);
     QVERIFY(server->listen(QHostAddress::SpecialAddress::AnyIPv4, 30003));
 
-    ADSBTCPLink* const adsbLink = new ADSBTCPLink(QHostAddress::LocalHost, 30003, this);
+    ADSBTCPLink* const adsbLink = new ADSBTCPLink(QHostAddress::LocalHost, 30003, ADSBTCPLink::SbsFormat, this);
     QVERIFY(adsbLink);
-    QSignalSpy spy(adsbLink, &ADSBTCPLink::adsbVehicleUpdate);
+    QSignalSpy spy(adsbLink, &ADSBTCPLink::adsbVehicleUpdates);
+    QVERIFY(adsbLink->init());
 
     bool timeout = false;
     QVERIFY(server->waitForNewConnection(1000, &timeout));
@@ -69,6 +70,39 @@ void ADSBTest::_adsbTcpLinkTest()
     server->close();
 }
 
+void ADSBTest::_adsbBeastTest()
+{
+    QTcpServer* const server = new QTcpServer(this);
+    QVERIFY(server);
+    QVERIFY(server->listen(QHostAddress::SpecialAddress::AnyIPv4, 30005));
+
+    ADSBTCPLink* const adsbLink = new ADSBTCPLink(QHostAddress::LocalHost, 30005, ADSBTCPLink::BeastFormat, this);
+    QVERIFY(adsbLink);
+    QSignalSpy spy(adsbLink, &ADSBTCPLink::adsbVehicleUpdates);
+    QVERIFY(adsbLink->init());
+
+    bool timeout = false;
+    QVERIFY(server->waitForNewConnection(1000, &timeout));
+    QVERIFY(!timeout);
+    QTcpSocket* const clientSocket = server->nextPendingConnection();
+    QVERIFY(clientSocket != nullptr);
+
+    // Long Mode S frame with a doubled escape byte in the timestamp, DF17 identification of KLM1023
+    QByteArray frame = QByteArray::fromHex("1a33001a1a00000000c0");
+    frame.append(QByteArray::fromHex("8D4840D6202CC371C32CE0576098"));
+    (void) clientSocket->write(frame);
+    QVERIFY(clientSocket->waitForBytesWritten(1000));
+
+    QVERIFY(spy.wait(5000));
+    const QList<ADSB::VehicleInfo_t> vehicleInfos = spy.first().first().value<QList<ADSB::VehicleInfo_t>>();
+    QCOMPARE(vehicleInfos.count(), 1);
+    QCOMPARE(vehicleInfos.first().icaoAddress, 0x4840D6u);
+    QCOMPARE(vehicleInfos.first().callsign, QStringLiteral("KLM1023"));
+    QVERIFY(vehicleInfos.first().availableFlags & ADSB::CallsignAvailable);
+
+    server->close();
+}
+
 void ADSBTest::_adsbVehicleManagerTest()
 {
     ADSBVehicleManager* const manager = ADSBVehicleManager::instance();
@@ -87,4 +121,44 @@ void ADSBTest::_adsbVehicleManagerTest()
 
     manager->adsbVehicleUpdate(vehicleInfo);
     QCOMPARE(manager->adsbVehicles()->count(), 1);
+
+    QCOMPARE(manager->aircraftWithin(QGeoCoordinate(1.01, 1.01), 5000.).count(), 1);
+    QCOMPARE(manager->aircraftWithin(QGeoCoordinate(2., 2.), 5000.).count(), 0);
+}
+
+void ADSBTest::_adsbAggregationTest()
+{
+    ADSBVehicleListModel model;
+
+    ADSB::VehicleInfo_t receiver1{};
+    receiver1.icaoAddress = 1;
+    receiver1.location = QGeoCoordinate(1., 1.);
+    receiver1.availableFlags = ADSB::LocationAvailable;
+    QVERIFY(model.update(receiver1, 1));
+    QCOMPARE(model.count(), 1);
+
+    // A second receiver does not move the aircraft while the first one is current, but fills in the callsign
+    ADSB::VehicleInfo_t receiver2{};
+    receiver2.icaoAddress = 1;
+    receiver2.callsign = QStringLiteral("ABC");
+    receiver2.location = QGeoCoordinate(1.001, 1.001);
+    receiver2.availableFlags = ADSB::LocationAvailable | ADSB::CallsignAvailable;
+    QVERIFY(model.update(receiver2, 2));
+    QCOMPARE(model.count(), 1);
+
+    ADSB::VehicleInfo_t info{};
+    QVERIFY(model.aircraftInfo(1, info));
+    QCOMPARE(info.location, receiver1.location);
+    QCOMPARE(info.callsign, receiver2.callsign);
+
+    // Repeating the same data from the second receiver changes nothing
+    receiver2.availableFlags = ADSB::LocationAvailable;
+    QVERIFY(!model.update(receiver2, 2));
+
+    receiver1.location = QGeoCoordinate(1.002, 1.002);
+    QVERIFY(model.update(receiver1, 1));
+    QVERIFY(model.aircraftInfo(1, info));
+    QCOMPARE(info.location, receiver1.location);
+
+    QVERIFY(!model.aircraftInfo(2, info));
 }
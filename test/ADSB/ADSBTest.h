@@ -9,5 +9,7 @@ class ADSBTest : public UnitTest
 private slots:
     void _adsbVehicleTest();
     void _adsbTcpLinkTest();
+    void _adsbBeastTest();
     void _adsbVehicleManagerTest();
+    void _adsbAggregationTest();
 };
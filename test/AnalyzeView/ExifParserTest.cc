@@ -2,6 +2,7 @@
 #include "ExifParser.h"
 #include "GeoTagWorker.h"
 
+#include <QtCore/QTemporaryDir>
 #include <QtTest/QTest>
 
 void ExifParserTest::_readTimeTest()
@@ -44,3 +45,38 @@ void ExifParserTest::_writeTest()
     // QVERIFY(outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
     // QCOMPARE(outputFile.write(imageBuffer), imageBuffer.size());
 }
+
+void ExifParserTest::_readTimeFromFileTest()
+{
+    QFile file(":/DSCN0010.jpg");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray imageBuffer = file.readAll();
+    file.close();
+
+    QCOMPARE(ExifParser::readTimeFromFile(":/DSCN0010.jpg"), ExifParser::readTime(imageBuffer));
+    QCOMPARE(ExifParser::readTimeFromFile(":/DoesNotExist.jpg"), -1.0);
+}
+
+void ExifParserTest::_writeFileTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString taggedFile = tempDir.filePath("tagged.jpg");
+    const QString retaggedFile = tempDir.filePath("retagged.jpg");
+
+    struct GeoTagWorker::cameraFeedbackPacket data;
+
+    data.latitude = 37.225;
+    data.longitude = -80.425;
+    data.altitude = 618.4392;
+
+    QVERIFY(ExifParser::writeFile(":/DSCN0010.jpg", taggedFile, data));
+    const double imageTime = ExifParser::readTimeFromFile(":/DSCN0010.jpg");
+    QCOMPARE(ExifParser::readTimeFromFile(taggedFile), imageTime);
+
+    // Tagging an already tagged image patches the copy in place, the size stays the same
+    data.latitude = -12.5;
+    QVERIFY(ExifParser::writeFile(taggedFile, retaggedFile, data));
+    QCOMPARE(QFileInfo(retaggedFile).size(), QFileInfo(taggedFile).size());
+    QCOMPARE(ExifParser::readTimeFromFile(retaggedFile), imageTime);
+}
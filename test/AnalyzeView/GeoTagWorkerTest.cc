@@ -0,0 +1,98 @@
+#include "GeoTagWorkerTest.h"
+#include "GeoTagWorker.h"
+
+#include <QtCore/QFileInfo>
+#include <QtTest/QTest>
+
+#include <cstring>
+
+namespace {
+    GeoTagWorker::cameraFeedbackPacket trigger(double timestamp, double timestampUTC, double latitude = 0, double longitude = 0, float altitude = 0)
+    {
+        GeoTagWorker::cameraFeedbackPacket packet;
+        (void) memset(&packet, 0, sizeof(packet));
+        packet.timestamp = timestamp;
+        packet.timestampUTC = timestampUTC;
+        packet.latitude = latitude;
+        packet.longitude = longitude;
+        packet.altitude = altitude;
+        return packet;
+    }
+}
+
+void GeoTagWorkerTest::_matchByTimeTest()
+{
+    GeoTagWorker worker;
+    worker._timeTolerance = 0.5;
+    worker._imageTimeOffset = 10;
+
+    // Logged out of time order
+    worker._triggerList = {
+        trigger(1, 100.0),
+        trigger(3, 102.0),
+        trigger(2, 101.0),
+        trigger(4, 150.0),
+    };
+
+    // Camera clock is 10 s ahead of UTC
+    worker._imageTime = {
+        111.2,      // 101.2: nearest trigger is 101.0
+        110.0,      // 100.0: exact match
+        112.4,      // 102.4: only 102.0 is within the tolerance
+        -1,         // No time, not matched
+        130.0,      // 120.0: no trigger within the tolerance
+        110.3,      // 100.3: 100.0 is already used and 101.0 is too far
+    };
+    for (int i = 0; i < worker._imageTime.count(); i++) {
+        worker._imageList.append(QFileInfo(QStringLiteral("IMG_%1.JPG").arg(i)));
+    }
+
+    worker._matchByTime();
+
+    // Matched in image time order
+    QCOMPARE(worker._imageIndices, QList<int>({ 1, 0, 2 }));
+    QCOMPARE(worker._triggerIndices, QList<int>({ 0, 2, 1 }));
+
+    // A tight tolerance leaves only the exact match
+    worker._imageIndices.clear();
+    worker._triggerIndices.clear();
+    worker._timeTolerance = 0.01;
+    worker._matchByTime();
+    QCOMPARE(worker._imageIndices, QList<int>({ 1 }));
+    QCOMPARE(worker._triggerIndices, QList<int>({ 0 }));
+}
+
+void GeoTagWorkerTest::_interpolateMissingPositionsTest()
+{
+    GeoTagWorker worker;
+
+    // Logged out of time order, with runs of triggers without a position fix in between, before and after
+    worker._triggerList = {
+        trigger(14, 0, 47.4, 8.4, 140),
+        trigger(11, 0),
+        trigger(5, 0),
+        trigger(10, 0, 47.0, 8.0, 100),
+        trigger(15, 0),
+        trigger(13, 0),
+    };
+
+    worker._interpolateMissingPositions();
+
+    const auto &triggers = worker._triggerList;
+    QCOMPARE(triggers[1].latitude, 47.1);
+    QCOMPARE(triggers[1].longitude, 8.1);
+    QCOMPARE(triggers[1].altitude, 110.f);
+    QCOMPARE(triggers[5].latitude, 47.3);
+    QCOMPARE(triggers[5].longitude, 8.3);
+    QCOMPARE(triggers[5].altitude, 130.f);
+
+    // Nothing to interpolate from on one side
+    QCOMPARE(triggers[2].latitude, 0.);
+    QCOMPARE(triggers[2].longitude, 0.);
+    QCOMPARE(triggers[4].latitude, 0.);
+    QCOMPARE(triggers[4].longitude, 0.);
+
+    // Triggers with a position are left alone
+    QCOMPARE(triggers[0].latitude, 47.4);
+    QCOMPARE(triggers[3].latitude, 47.0);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class GeoTagWorkerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    GeoTagWorkerTest() = default;
+
+private slots:
+    void _matchByTimeTest();
+    void _interpolateMissingPositionsTest();
+};
@@ -0,0 +1,67 @@
+#include "ImageIndexTest.h"
+#include "ImageIndex.h"
+#include "ExifParser.h"
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+void ImageIndexTest::_readImageInfoTest()
+{
+    ExifParser::ImageInfo info;
+    QVERIFY(ExifParser::readImageInfoFromFile(":/DSCN0010.jpg", info));
+    QCOMPARE(info.time, ExifParser::readTimeFromFile(":/DSCN0010.jpg"));
+    QVERIFY(info.hasPosition);
+    QVERIFY(qAbs(info.latitude - 43.4674) < 0.001);
+    QVERIFY(qAbs(info.longitude - 11.8851) < 0.001);
+    QVERIFY(!info.thumbnail.isEmpty());
+    QVERIFY(info.thumbnail.startsWith("\xFF\xD8"));
+
+    QVERIFY(!ExifParser::readImageInfoFromFile(":/DoesNotExist.jpg", info));
+}
+
+void ImageIndexTest::_indexTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(QFile::copy(":/DSCN0010.jpg", tempDir.filePath("IMG_0001.jpg")));
+    QVERIFY(QFile::copy(":/DSCN0010.jpg", tempDir.filePath("IMG_0002.jpg")));
+
+    qsizetype readCount = 0;
+    const ImageIndex::Progress_t countReads = [&readCount](qsizetype done, qsizetype total) {
+        Q_UNUSED(done);
+        readCount = total;
+        return true;
+    };
+
+    ImageIndex imageIndex(tempDir.path());
+    QVERIFY(!imageIndex.load());
+    QVERIFY(imageIndex.update(countReads));
+    QCOMPARE(readCount, 2);
+    QCOMPARE(imageIndex.entries().count(), 2);
+    const ImageIndex::Entry *const entry = imageIndex.entry("IMG_0002.jpg");
+    QVERIFY(entry);
+    QVERIFY(entry->valid);
+    QVERIFY(entry->info.hasPosition);
+    QCOMPARE(entry->info.time, ExifParser::readTimeFromFile(":/DSCN0010.jpg"));
+
+    // Opened again the index is loaded as saved, and only new images are read
+    ImageIndex reopened(tempDir.path());
+    QVERIFY(reopened.load());
+    QCOMPARE(reopened.entries().count(), 2);
+    QCOMPARE(reopened.entry("IMG_0001.jpg")->info.thumbnail, imageIndex.entry("IMG_0001.jpg")->info.thumbnail);
+
+    QVERIFY(QFile::copy(":/DSCN0010.jpg", tempDir.filePath("IMG_0003.jpg")));
+    readCount = 0;
+    QVERIFY(reopened.update(countReads));
+    QCOMPARE(readCount, 1);
+    QCOMPARE(reopened.entries().count(), 3);
+
+    // Cancelled updates are not saved
+    QVERIFY(QFile::copy(":/DSCN0010.jpg", tempDir.filePath("IMG_0004.jpg")));
+    QVERIFY(!reopened.update([](qsizetype, qsizetype) { return false; }));
+    ImageIndex cancelled(tempDir.path());
+    QVERIFY(cancelled.load());
+    QCOMPARE(cancelled.entries().count(), 3);
+
+    QVERIFY(QFile::remove(ImageIndex::indexFileName(tempDir.path())));
+}
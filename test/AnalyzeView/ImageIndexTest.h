@@ -0,0 +1,15 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class ImageIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    ImageIndexTest() = default;
+
+private slots:
+    void _readImageInfoTest();
+    void _indexTest();
+};
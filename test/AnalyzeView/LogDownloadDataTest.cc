@@ -0,0 +1,113 @@
+#include "LogDownloadDataTest.h"
+#include "LogEntry.h"
+#include "MAVLinkLib.h"
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+namespace {
+    constexpr uint kBinSize = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    constexpr uint kLogSize = (10 * kBinSize) + 17;    ///< The last bin is shorter
+
+    QByteArray logData()
+    {
+        QByteArray data(kLogSize, 0);
+        for (uint i = 0; i < kLogSize; i++) {
+            data[i] = static_cast<char>((i * 7) + (i / kBinSize));
+        }
+        return data;
+    }
+
+    bool storeBin(LogDownloadData& download, const QByteArray& data, uint32_t bin)
+    {
+        const uint32_t ofs = bin * kBinSize;
+        const uint8_t count = static_cast<uint8_t>(qMin<uint32_t>(kBinSize, kLogSize - ofs));
+        return download.storeData(ofs, reinterpret_cast<const uint8_t*>(data.constData() + ofs), count);
+    }
+
+    QDateTime logTime()
+    {
+        return QDateTime::fromSecsSinceEpoch(1714566600);
+    }
+}
+
+void LogDownloadDataTest::_resumeTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QByteArray data = logData();
+    QGCLogEntry entry(3, logTime(), kLogSize);
+
+    // Interrupted download with the front and the last bin
+    {
+        LogDownloadData download(&entry);
+        download.directory = tempDir.path() + QStringLiteral("/");
+        download.filename = QStringLiteral("log_3.ulg");
+        QVERIFY(download.openFile());
+        QCOMPARE(download.written, 0u);
+        QCOMPARE(download.numBins(), 11u);
+        for (uint32_t bin = 0; bin < 5; bin++) {
+            QVERIFY(storeBin(download, data, bin));
+        }
+        QVERIFY(storeBin(download, data, 10));
+        QVERIFY(!download.complete());
+    }
+    QVERIFY(QFile::exists(tempDir.filePath(QStringLiteral("log_3.ulg.part"))));
+
+    LogDownloadData download(&entry);
+    download.directory = tempDir.path() + QStringLiteral("/");
+    download.filename = QStringLiteral("log_3.ulg");
+    download.windowBins = 32;
+    QVERIFY(download.openFile());
+    QCOMPARE(download.written, (5 * kBinSize) + 17);
+    QCOMPARE(download.bins.count(true), 6);
+
+    // Only the missing bins are requested
+    uint32_t start = 0;
+    uint32_t end = 0;
+    QVERIFY(download.nextRange(start, end));
+    QCOMPARE(start, 5u);
+    QCOMPARE(end, 10u);
+    for (uint32_t bin = start; bin < end; bin++) {
+        QVERIFY(storeBin(download, data, bin));
+    }
+    QVERIFY(download.complete());
+    QVERIFY(!download.nextRange(start, end));
+
+    QVERIFY(download.finishFile());
+    QVERIFY(!QFile::exists(tempDir.filePath(QStringLiteral("log_3.ulg.part"))));
+    QFile file(tempDir.filePath(QStringLiteral("log_3.ulg")));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), data);
+}
+
+void LogDownloadDataTest::_resumeOtherLogTest()
+{
+    const QByteArray data = logData();
+    QGCLogEntry entry(3, logTime(), kLogSize);
+
+    // Logs of the same size which end up with the same part file name
+    QGCLogEntry otherTimeEntry(3, logTime().addSecs(60), kLogSize);
+    QGCLogEntry otherIdEntry(4, logTime(), kLogSize);
+    QGCLogEntry noTimeEntry(3, QDateTime(), kLogSize);
+    for (QGCLogEntry* const otherEntry : { &otherTimeEntry, &otherIdEntry, &noTimeEntry }) {
+        QTemporaryDir tempDir;
+        QVERIFY(tempDir.isValid());
+        {
+            LogDownloadData download(&entry);
+            download.directory = tempDir.path() + QStringLiteral("/");
+            download.filename = QStringLiteral("log.ulg");
+            QVERIFY(download.openFile());
+            for (uint32_t bin = 0; bin < 5; bin++) {
+                QVERIFY(storeBin(download, data, bin));
+            }
+        }
+
+        LogDownloadData download(otherEntry);
+        download.directory = tempDir.path() + QStringLiteral("/");
+        download.filename = QStringLiteral("log.ulg");
+        QVERIFY(download.openFile());
+        QCOMPARE(download.written, 0u);
+        QCOMPARE(download.bins.count(true), 0);
+    }
+}
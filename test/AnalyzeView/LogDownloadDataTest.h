@@ -0,0 +1,15 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class LogDownloadDataTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LogDownloadDataTest() = default;
+
+private slots:
+    void _resumeTest();
+    void _resumeOtherLogTest();
+};
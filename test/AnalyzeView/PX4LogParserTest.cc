@@ -2,8 +2,48 @@
 #include "PX4LogParser.h"
 #include "GeoTagWorker.h"
 
+#include <QtCore/QtEndian>
 #include <QtTest/QTest>
 
+namespace {
+    constexpr uint8_t kGpsType = 0x08;
+    constexpr uint8_t kGposType = 0x10;
+    constexpr uint8_t kCamtType = 0x37;
+    constexpr uint8_t kTimeType = 0x81;
+
+    constexpr uint8_t kGpsLength = 55;
+    constexpr uint8_t kGposLength = 15;
+    constexpr uint8_t kCamtLength = 15;
+    constexpr uint8_t kTimeLength = 11;
+
+    /// sdlog2 FMT message, only type and length are used by the parser
+    QByteArray formatMessage(uint8_t type, uint8_t length)
+    {
+        QByteArray message("\xA3\x95\x80", 3);
+        message.append(static_cast<char>(type));
+        message.append(static_cast<char>(length));
+        message.append(QByteArray(4 + 16 + 64, '\0'));
+        return message;
+    }
+
+    QByteArray message(uint8_t type, uint8_t length, const QByteArray &payload)
+    {
+        QByteArray message("\xA3\x95", 2);
+        message.append(static_cast<char>(type));
+        message.append(payload);
+        message.append(QByteArray(length - message.size(), '\0'));
+        return message;
+    }
+
+    template<typename T>
+    QByteArray bytes(T value)
+    {
+        QByteArray data(sizeof(T), Qt::Uninitialized);
+        qToLittleEndian(value, data.data());
+        return data;
+    }
+}
+
 void PX4LogParserTest::_getTagsFromLogTest()
 {
     /*QFile file("SamplePX4Log.");
@@ -20,3 +60,50 @@ void PX4LogParserTest::_getTagsFromLogTest()
     QVERIFY(!qFuzzyIsNull(firstCameraFeedback.timestamp));
     QVERIFY(firstCameraFeedback.imageSequence != 0);*/
 }
+
+void PX4LogParserTest::_utcTimestampTest()
+{
+    QByteArray log;
+    log.append(formatMessage(kGpsType, kGpsLength));
+    log.append(formatMessage(kGposType, kGposLength));
+    log.append(formatMessage(kCamtType, kCamtLength));
+    log.append(formatMessage(kTimeType, kTimeLength));
+
+    // Two logging cycles, each with the boot time, a GPS fix with its UTC time, a trigger and a position
+    log.append(message(kTimeType, kTimeLength, bytes<quint64>(1000000)));
+    log.append(message(kGpsType, kGpsLength, bytes<quint64>(1700000000500000)));
+    log.append(message(kCamtType, kCamtLength, bytes<quint64>(1200000) + bytes<quint32>(1)));
+    log.append(message(kGposType, kGposLength, bytes<qint32>(471234567) + bytes<qint32>(85000000) + bytes<float>(500.f)));
+
+    log.append(message(kTimeType, kTimeLength, bytes<quint64>(2000000)));
+    log.append(message(kGpsType, kGpsLength, bytes<quint64>(1700000001600000)));
+    log.append(message(kCamtType, kCamtLength, bytes<quint64>(2300000) + bytes<quint32>(2)));
+    log.append(message(kGposType, kGposLength, bytes<qint32>(471234667) + bytes<qint32>(85000100) + bytes<float>(501.f)));
+
+    // Messages are only accepted when the next one follows right after them
+    log.append(message(kTimeType, kTimeLength, bytes<quint64>(3000000)));
+
+    QList<GeoTagWorker::cameraFeedbackPacket> cameraFeedback;
+    QVERIFY(PX4LogParser::getTagsFromLog(log, cameraFeedback));
+    QCOMPARE(cameraFeedback.count(), 2);
+
+    QCOMPARE(cameraFeedback[0].imageSequence, 1u);
+    QVERIFY(qAbs(cameraFeedback[0].timestamp - 1.2) < 1e-6);
+    QVERIFY(qAbs(cameraFeedback[0].timestampUTC - 1700000000.7) < 1e-3);
+    QVERIFY(qAbs(cameraFeedback[0].latitude - 47.1234567) < 1e-7);
+    QCOMPARE(cameraFeedback[0].altitude, 500.f);
+
+    QCOMPARE(cameraFeedback[1].imageSequence, 2u);
+    QVERIFY(qAbs(cameraFeedback[1].timestampUTC - 1700000001.9) < 1e-3);
+
+    // Without GPS fixes there is no UTC time
+    QByteArray noGpsLog = log;
+    const QByteArray gpsHeader("\xA3\x95\x08", 3);
+    for (qsizetype index = noGpsLog.indexOf(gpsHeader); index >= 0; index = noGpsLog.indexOf(gpsHeader, index + 1)) {
+        (void) noGpsLog.replace(index + 3, 8, QByteArray(8, '\0'));
+    }
+    cameraFeedback.clear();
+    QVERIFY(PX4LogParser::getTagsFromLog(noGpsLog, cameraFeedback));
+    QCOMPARE(cameraFeedback.count(), 2);
+    QCOMPARE(cameraFeedback[0].timestampUTC, 0.);
+}
@@ -22,3 +22,26 @@ void ULogParserTest::_getTagsFromLogTest()
     // QVERIFY(!qFuzzyIsNull(firstCameraFeedback.timestamp));
     QVERIFY(firstCameraFeedback.imageSequence != 0);
 }
+
+void ULogParserTest::_getTagsFromLogFileTest()
+{
+    QFile file(":/SampleULog.ulg");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray logBuffer = file.readAll();
+    file.close();
+
+    QList<GeoTagWorker::cameraFeedbackPacket> bufferFeedback;
+    QString errorMessage;
+    QVERIFY(ULogParser::getTagsFromLog(logBuffer, bufferFeedback, errorMessage));
+
+    // Streaming the file in chunks gives the same tags as parsing the whole buffer
+    QList<GeoTagWorker::cameraFeedbackPacket> fileFeedback;
+    QVERIFY(ULogParser::getTagsFromLogFile(":/SampleULog.ulg", fileFeedback, errorMessage));
+    QVERIFY(errorMessage.isEmpty());
+    QCOMPARE(fileFeedback.count(), bufferFeedback.count());
+    QCOMPARE(fileFeedback.constFirst().imageSequence, bufferFeedback.constFirst().imageSequence);
+    QCOMPARE(fileFeedback.constLast().imageSequence, bufferFeedback.constLast().imageSequence);
+
+    QVERIFY(!ULogParser::getTagsFromLogFile(":/DoesNotExist.ulg", fileFeedback, errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+}
@@ -11,4 +11,5 @@ public:
 
 private slots:
     void _getTagsFromLogTest();
+    void _getTagsFromLogFileTest();
 };
@@ -9,6 +9,7 @@
 
 #include "AudioOutputTest.h"
 #include "AudioOutput.h"
+#include "AudioOutputQueue.h"
 
 #include <QtTest/QTest>
 
@@ -32,3 +33,84 @@ void AudioOutputTest::_testSpokenReplacements(void)
     result = AudioOutput::fixTextMessageForAudio(QStringLiteral("10moo"));
     QCOMPARE(result, QStringLiteral("10moo"));
 }
+
+void AudioOutputTest::_testMillisecondString(void)
+{
+    QString match;
+    int number = 0;
+    QVERIFY(AudioOutput::getMillisecondString(QStringLiteral("timeout after 2500ms"), match, number));
+    QCOMPARE(match, QStringLiteral("2500ms"));
+    QCOMPARE(number, 2500);
+    QVERIFY(!AudioOutput::getMillisecondString(QStringLiteral("no time here"), match, number));
+
+    QCOMPARE(AudioOutput::fixTextMessageForAudio(QStringLiteral("wait 2500ms")), QStringLiteral("wait 2 seconds"));
+    QCOMPARE(AudioOutput::fixTextMessageForAudio(QStringLiteral("wait 125000ms")), QStringLiteral("wait 2 minutes and 5 seconds"));
+}
+
+void AudioOutputTest::_testQueuePriority(void)
+{
+    AudioOutputQueue queue;
+    QVERIFY(queue.enqueue(QStringLiteral("low"), AudioOutputQueue::Priority::Low, QString(), 0));
+    QVERIFY(queue.enqueue(QStringLiteral("normal 1"), AudioOutputQueue::Priority::Normal, QString(), 0));
+    QVERIFY(queue.enqueue(QStringLiteral("high"), AudioOutputQueue::Priority::High, QString(), 0));
+    QVERIFY(queue.enqueue(QStringLiteral("normal 2"), AudioOutputQueue::Priority::Normal, QString(), 0));
+
+    QCOMPARE(queue.takeNext(0), QStringLiteral("high"));
+    QCOMPARE(queue.takeNext(0), QStringLiteral("normal 1"));
+    QCOMPARE(queue.takeNext(0), QStringLiteral("normal 2"));
+    QCOMPARE(queue.takeNext(0), QStringLiteral("low"));
+    QVERIFY(queue.takeNext(0).isEmpty());
+}
+
+void AudioOutputTest::_testQueueDuplicates(void)
+{
+    AudioOutputQueue queue;
+    QVERIFY(queue.enqueue(QStringLiteral("first"), AudioOutputQueue::Priority::Normal, QString(), 0));
+    QVERIFY(queue.enqueue(QStringLiteral("second"), AudioOutputQueue::Priority::Normal, QString(), 0));
+    QVERIFY(!queue.enqueue(QStringLiteral("second"), AudioOutputQueue::Priority::High, QString(), 0));
+    QCOMPARE(queue.count(), 2);
+
+    // The duplicate moved the pending text up to its priority
+    QCOMPARE(queue.takeNext(0), QStringLiteral("second"));
+    QCOMPARE(queue.takeNext(0), QStringLiteral("first"));
+
+    // Once read, the same text can be queued again
+    QVERIFY(queue.enqueue(QStringLiteral("first"), AudioOutputQueue::Priority::Normal, QString(), 0));
+
+    // The oldest text of the lowest priority goes when the queue is full
+    queue.clear();
+    QVERIFY(queue.enqueue(QStringLiteral("oldest low"), AudioOutputQueue::Priority::Low, QString(), 0));
+    for (qsizetype i = 0; i < AudioOutputQueue::kMaxSize; i++) {
+        QVERIFY(queue.enqueue(QString::number(i), AudioOutputQueue::Priority::Normal, QString(), 0));
+    }
+    QCOMPARE(queue.count(), AudioOutputQueue::kMaxSize);
+    for (qsizetype i = 0; i < AudioOutputQueue::kMaxSize; i++) {
+        QCOMPARE(queue.takeNext(0), QString::number(i));
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void AudioOutputTest::_testQueueCollapse(void)
+{
+    AudioOutputQueue queue;
+    QVERIFY(queue.enqueue(QStringLiteral("vehicle 1 hold flight mode"), AudioOutputQueue::Priority::Normal, QStringLiteral("1:flightMode"), 0));
+    QVERIFY(queue.enqueue(QStringLiteral("vehicle 2 hold flight mode"), AudioOutputQueue::Priority::Normal, QStringLiteral("2:flightMode"), 0));
+    QVERIFY(queue.enqueue(QStringLiteral("vehicle 1 mission flight mode"), AudioOutputQueue::Priority::Normal, QStringLiteral("1:flightMode"), 0));
+
+    QCOMPARE(queue.count(), 2);
+    QCOMPARE(queue.takeNext(0), QStringLiteral("vehicle 2 hold flight mode"));
+    QCOMPARE(queue.takeNext(0), QStringLiteral("vehicle 1 mission flight mode"));
+}
+
+void AudioOutputTest::_testQueueStaleLowPriority(void)
+{
+    AudioOutputQueue queue;
+    QVERIFY(queue.enqueue(QStringLiteral("stale low"), AudioOutputQueue::Priority::Low, QString(), 0));
+    QVERIFY(queue.enqueue(QStringLiteral("old normal"), AudioOutputQueue::Priority::Normal, QString(), 0));
+    QVERIFY(queue.enqueue(QStringLiteral("fresh low"), AudioOutputQueue::Priority::Low, QString(), AudioOutputQueue::kMaxLowPriorityAgeMs));
+
+    const qint64 now = AudioOutputQueue::kMaxLowPriorityAgeMs + 1;
+    QCOMPARE(queue.takeNext(now), QStringLiteral("old normal"));
+    QCOMPARE(queue.takeNext(now), QStringLiteral("fresh low"));
+    QVERIFY(queue.takeNext(now).isEmpty());
+}
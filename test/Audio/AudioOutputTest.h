@@ -20,4 +20,9 @@ public:
 
 private slots:
     void _testSpokenReplacements(void);
+    void _testMillisecondString(void);
+    void _testQueuePriority(void);
+    void _testQueueDuplicates(void);
+    void _testQueueCollapse(void);
+    void _testQueueStaleLowPriority(void);
 };
@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "BenchmarkTest.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define QGC_BENCHMARK_NO_ALLOCATION_COUNT
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define QGC_BENCHMARK_NO_ALLOCATION_COUNT
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(QGC_BENCHMARK_NO_ALLOCATION_COUNT)
+#define QGC_BENCHMARK_ALLOCATION_COUNT
+
+// Allocations are counted by interposing the glibc allocator entry points, which also catches the allocations Qt
+// containers make through malloc directly. Counting is per thread and only while a benchmark turns it on.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+}
+
+namespace {
+thread_local bool       gCountAllocations = false;
+thread_local quint64    gAllocationCount = 0;
+}
+
+extern "C" {
+void* malloc(size_t size)
+{
+    if (gCountAllocations) {
+        gAllocationCount++;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    if (gCountAllocations) {
+        gAllocationCount++;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    if (gCountAllocations) {
+        gAllocationCount++;
+    }
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+bool BenchmarkTest::_allocationCountSupported(void)
+{
+#ifdef QGC_BENCHMARK_ALLOCATION_COUNT
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 BenchmarkTest::_peakRssBytes(void)
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef Q_OS_MACOS
+        return static_cast<qint64>(usage.ru_maxrss);
+#else
+        return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return -1;
+}
+
+qint64 BenchmarkTest::_threadCpuNsecs(void)
+{
+#ifdef Q_OS_UNIX
+    struct timespec cpuTime;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime) == 0) {
+        return (static_cast<qint64>(cpuTime.tv_sec) * 1000000000) + cpuTime.tv_nsec;
+    }
+#endif
+    return -1;
+}
+
+void BenchmarkTest::initTestCase(void)
+{
+    _results.clear();
+    _metrics.clear();
+}
+
+void BenchmarkTest::cleanupTestCase(void)
+{
+    const QString outputDir = qEnvironmentVariable("QGC_BENCHMARK_OUTPUT_DIR");
+    if (!outputDir.isEmpty()) {
+        QVERIFY(_writeResults(QDir(outputDir).filePath(objectName() + QStringLiteral(".json"))));
+    }
+}
+
+void BenchmarkTest::_measure(const QString& name, int opsPerBatch, const std::function<void(void)>& batch)
+{
+    for (int i=0; i<_warmupBatches; i++) {
+        batch();
+    }
+
+    double allocationsPerOp = -1;
+#ifdef QGC_BENCHMARK_ALLOCATION_COUNT
+    gAllocationCount = 0;
+    gCountAllocations = true;
+    batch();
+    gCountAllocations = false;
+    allocationsPerOp = static_cast<double>(gAllocationCount) / opsPerBatch;
+#endif
+
+    QList<double> samples;
+    quint64 operations = 0;
+    for (int i=0; i<_samples; i++) {
+        QElapsedTimer timer;
+        quint64 sampleOperations = 0;
+
+        timer.start();
+        do {
+            batch();
+            sampleOperations += opsPerBatch;
+        } while (timer.nsecsElapsed() < _minSampleNsecs);
+
+        samples.append(static_cast<double>(timer.nsecsElapsed()) / sampleOperations);
+        operations += sampleOperations;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const Result_t result = { name, operations, samples[samples.count() / 2], samples.first(), allocationsPerOp };
+    _results.append(result);
+
+    qDebug() << qPrintable(QStringLiteral("%1: %2 ns/op (min %3), %4 ops/s, %5 allocs/op")
+                           .arg(name, -48).arg(result.nsPerOp, 0, 'f', 1).arg(result.minNsPerOp, 0, 'f', 1).arg(1e9 / result.nsPerOp, 0, 'f', 0)
+                           .arg(result.allocationsPerOp, 0, 'f', 2));
+}
+
+void BenchmarkTest::_recordMetric(const QString& name, double value, const QString& unit)
+{
+    _metrics.append({ name, value, unit });
+    qDebug() << qPrintable(QStringLiteral("%1: %2 %3").arg(name, -48).arg(value, 0, 'f', 2).arg(unit));
+}
+
+bool BenchmarkTest::_writeResults(const QString& fileName) const
+{
+    QJsonArray benchmarks;
+    for (const Result_t& result: _results) {
+        benchmarks.append(QJsonObject {
+            { "name",               result.name },
+            { "operations",         static_cast<qint64>(result.operations) },
+            { "nsPerOp",            result.nsPerOp },
+            { "minNsPerOp",         result.minNsPerOp },
+            { "opsPerSec",          1e9 / result.nsPerOp },
+            { "allocationsPerOp",   (result.allocationsPerOp < 0) ? QJsonValue() : QJsonValue(result.allocationsPerOp) },
+        });
+    }
+
+    QJsonArray metrics;
+    for (const Metric_t& metric: _metrics) {
+        metrics.append(QJsonObject {
+            { "name",   metric.name },
+            { "value",  metric.value },
+            { "unit",   metric.unit },
+        });
+    }
+
+    const QJsonObject root {
+        { "schemaVersion",  _schemaVersion },
+        { "suite",          objectName() },
+        { "appVersion",     QCoreApplication::applicationVersion() },
+        { "qtVersion",      QString(qVersion()) },
+#ifdef QT_DEBUG
+        { "buildType",      "debug" },
+#else
+        { "buildType",      "release" },
+#endif
+        { "timestamp",      QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+        { "benchmarks",     benchmarks },
+        { "metrics",        metrics },
+    };
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "BenchmarkTest: unable to write" << fileName << file.errorString();
+        return false;
+    }
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    return file.write(json) == json.size();
+}
@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtCore/QList>
+
+#include <functional>
+
+/// Base class for benchmarks. Benchmarks are registered standalone so they only run when asked for, normally through
+/// the qgc_benchmarks build target.
+///
+/// Results are written as JSON to <objectName>.json in the directory named by the QGC_BENCHMARK_OUTPUT_DIR environment
+/// variable. The format is versioned by "schemaVersion" and benchmark names are kept stable so results can be
+/// compared across releases.
+class BenchmarkTest : public UnitTest
+{
+    Q_OBJECT
+
+protected slots:
+    virtual void initTestCase   (void);
+    virtual void cleanupTestCase(void);
+
+protected:
+    /// Times batch repeatedly and records the result. Heap allocations are counted over one extra untimed batch on
+    /// platforms which support it.
+    ///     @param opsPerBatch Number of operations a single call to batch performs
+    void _measure(const QString& name, int opsPerBatch, const std::function<void(void)>& batch);
+
+    /// Records a single value which is not a per operation timing, for example a throughput or memory figure
+    void _recordMetric(const QString& name, double value, const QString& unit);
+
+    /// @return true: allocation counts are available on this platform
+    static bool _allocationCountSupported(void);
+
+    /// @return Peak resident set size of the process in bytes, -1 if not available on this platform
+    static qint64 _peakRssBytes(void);
+
+    /// @return CPU time consumed by the calling thread in nanoseconds, -1 if not available on this platform
+    static qint64 _threadCpuNsecs(void);
+
+private:
+    typedef struct {
+        QString name;
+        quint64 operations;         ///< Total operations timed across all samples
+        double  nsPerOp;            ///< Median of the samples
+        double  minNsPerOp;
+        double  allocationsPerOp;   ///< -1 if not supported
+    } Result_t;
+
+    typedef struct {
+        QString name;
+        double  value;
+        QString unit;
+    } Metric_t;
+
+    bool _writeResults(const QString& fileName) const;
+
+    QList<Result_t> _results;
+    QList<Metric_t> _metrics;
+
+    static constexpr int    _warmupBatches  = 3;
+    static constexpr int    _samples        = 7;
+    static constexpr qint64 _minSampleNsecs = 50 * 1000 * 1000;
+    static constexpr int    _schemaVersion  = 1;
+};
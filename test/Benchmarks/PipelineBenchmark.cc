@@ -0,0 +1,237 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "PipelineBenchmark.h"
+#include "QGCApplication.h"
+#include "QGCToolbox.h"
+#include "LinkManager.h"
+#include "MAVLinkProtocol.h"
+#include "FactGroup.h"
+#include "TerrainTile.h"
+#include "TerrainTileCopernicus.h"
+#include "TrackRecorder.h"
+#include "TrajectoryPoints.h"
+#include "Vehicle.h"
+#include "QGC.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QRandomGenerator>
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+void PipelineBenchmark::initTestCase(void)
+{
+    BenchmarkTest::initTestCase();
+
+    _packChannel = qgcApp()->toolbox()->linkManager()->allocateMavlinkChannel();
+    QVERIFY(_packChannel != LinkManager::invalidMavlinkChannel());
+
+    // Benchmark messages are mavlink 2, the same as a current autopilot sends
+    mavlink_get_channel_status(_packChannel)->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+}
+
+void PipelineBenchmark::cleanupTestCase(void)
+{
+    qgcApp()->toolbox()->linkManager()->freeMavlinkChannel(_packChannel);
+
+    BenchmarkTest::cleanupTestCase();
+}
+
+/// A repeating mix of the high rate messages a flying vehicle streams
+QList<mavlink_message_t> PipelineBenchmark::_telemetryMessages(int count)
+{
+    const uint8_t systemId = static_cast<uint8_t>(_vehicle->id());
+    const uint8_t componentId = static_cast<uint8_t>(_vehicle->defaultComponentId());
+    const int32_t latitude = static_cast<int32_t>(_vehicle->coordinate().latitude() * 1e7);
+    const int32_t longitude = static_cast<int32_t>(_vehicle->coordinate().longitude() * 1e7);
+
+    QList<mavlink_message_t> messages;
+    messages.reserve(count);
+    for (int i=0; i<count; i++) {
+        mavlink_message_t msg;
+        const uint32_t timeBootMsecs = static_cast<uint32_t>(i * 10);
+        const float angle = static_cast<float>(i % 360) * 0.0174533f;
+
+        switch (i % 6) {
+        case 0:
+            mavlink_msg_attitude_pack_chan(systemId, componentId, _packChannel, &msg, timeBootMsecs, 0.1f, -0.1f, angle, 0.01f, 0.01f, 0.02f);
+            break;
+        case 1:
+            mavlink_msg_global_position_int_pack_chan(systemId, componentId, _packChannel, &msg, timeBootMsecs, latitude + i, longitude + i, 50000, 50000, 100, 100, 0, static_cast<uint16_t>((i % 360) * 100));
+            break;
+        case 2:
+            mavlink_msg_gps_raw_int_pack_chan(systemId, componentId, _packChannel, &msg, timeBootMsecs * 1000ull, GPS_FIX_TYPE_3D_FIX, latitude + i, longitude + i, 50000, 100, 100, UINT16_MAX, UINT16_MAX, 12, 0, 0, 0, 0, 0, UINT16_MAX);
+            break;
+        case 3:
+            mavlink_msg_vfr_hud_pack_chan(systemId, componentId, _packChannel, &msg, 10.0f, 10.0f, static_cast<int16_t>(i % 360), 50, 50.0f, 0.5f);
+            break;
+        case 4:
+            mavlink_msg_local_position_ned_pack_chan(systemId, componentId, _packChannel, &msg, timeBootMsecs, 1.0f, 2.0f, -50.0f, 1.0f, 1.0f, 0.0f);
+            break;
+        default:
+            mavlink_msg_vibration_pack_chan(systemId, componentId, _packChannel, &msg, timeBootMsecs * 1000ull, 5.0f, 6.0f, 7.0f, 0, 0, 0);
+            break;
+        }
+        messages.append(msg);
+    }
+
+    return messages;
+}
+
+/// Parsing plus everything downstream of it, this is the full cost of a byte arriving from a link
+void PipelineBenchmark::_benchmarkReceiveBytes(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_GENERIC);
+    QVERIFY(_vehicle);
+
+    constexpr int messageCount = 600;
+    QByteArray bytes;
+    for (const mavlink_message_t& msg: _telemetryMessages(messageCount)) {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
+        bytes.append(reinterpret_cast<const char*>(buffer), cBuffer);
+    }
+
+    MAVLinkProtocol* const mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+    LinkInterface* const link = _mockLink;
+    _measure(QStringLiteral("MAVLinkProtocol::receiveBytes"), messageCount, [mavlinkProtocol, link, &bytes]() {
+        mavlinkProtocol->receiveBytes(link, bytes, QGC::utcTimeUsecs());
+    });
+}
+
+/// Already decoded messages routed through MultiVehicleManager into Vehicle::_mavlinkMessageReceived
+void PipelineBenchmark::_benchmarkVehicleDispatch(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_GENERIC);
+    QVERIFY(_vehicle);
+
+    constexpr int messageCount = 600;
+    const QList<mavlink_message_t> messages = _telemetryMessages(messageCount);
+
+    MAVLinkProtocol* const mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+    LinkInterface* const link = _mockLink;
+    _measure(QStringLiteral("Vehicle::_mavlinkMessageReceived"), messageCount, [mavlinkProtocol, link, &messages]() {
+        for (const mavlink_message_t& msg: messages) {
+            emit mavlinkProtocol->messageReceived(link, msg);
+        }
+    });
+}
+
+void PipelineBenchmark::_benchmarkFactGroupHandleMessage(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_GENERIC);
+    QVERIFY(_vehicle);
+
+    const QList<mavlink_message_t> messages = _telemetryMessages(6);
+    const struct {
+        const char* name;
+        FactGroup*  factGroup;
+        uint32_t    msgId;
+    } rgGroups[] = {
+        { "vehicle ATTITUDE",                   _vehicle->vehicleFactGroup(),       MAVLINK_MSG_ID_ATTITUDE },
+        { "vehicle VFR_HUD",                    _vehicle->vehicleFactGroup(),       MAVLINK_MSG_ID_VFR_HUD },
+        { "gps GPS_RAW_INT",                    _vehicle->gpsFactGroup(),           MAVLINK_MSG_ID_GPS_RAW_INT },
+        { "localPosition LOCAL_POSITION_NED",   _vehicle->localPositionFactGroup(), MAVLINK_MSG_ID_LOCAL_POSITION_NED },
+        { "vibration VIBRATION",                _vehicle->vibrationFactGroup(),     MAVLINK_MSG_ID_VIBRATION },
+    };
+
+    for (const auto& group: rgGroups) {
+        auto it = std::find_if(messages.cbegin(), messages.cend(), [&group](const mavlink_message_t& msg) { return msg.msgid == group.msgId; });
+        QVERIFY(it != messages.cend());
+
+        mavlink_message_t msg = *it;
+        Vehicle* const vehicle = _vehicle;
+        FactGroup* const factGroup = group.factGroup;
+        constexpr int batchCount = 1000;
+        _measure(QStringLiteral("FactGroup::handleMessage %1").arg(group.name), batchCount, [vehicle, factGroup, &msg]() {
+            for (int i=0; i<batchCount; i++) {
+                factGroup->handleMessage(vehicle, msg);
+            }
+        });
+    }
+}
+
+void PipelineBenchmark::_benchmarkTrajectoryPointsAppend(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_GENERIC);
+    QVERIFY(_vehicle);
+
+    TrajectoryPoints* const trajectoryPoints = _vehicle->property("trajectoryPoints").value<TrajectoryPoints*>();
+    TrackRecorder* const trackRecorder = _vehicle->trackRecorder();
+    QVERIFY(trajectoryPoints);
+    trajectoryPoints->start();
+
+    // Zig zag so that every point is far enough from, and not colinear with, the previous one
+    constexpr int pointCount = 1000;
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(pointCount);
+    QGeoCoordinate position(47.397, 8.545, 50);
+    for (int i=0; i<pointCount; i++) {
+        position = position.atDistanceAndAzimuth(10, (i % 2) ? 45 : 135);
+        coordinates.append(position);
+    }
+
+    _measure(QStringLiteral("TrajectoryPoints::append"), pointCount, [trackRecorder, &coordinates]() {
+        for (const QGeoCoordinate& coordinate: coordinates) {
+            emit trackRecorder->coordinateRecorded(coordinate);
+        }
+    });
+
+    trajectoryPoints->stop();
+    trajectoryPoints->clear();
+}
+
+void PipelineBenchmark::_benchmarkTerrainTileElevation(void)
+{
+    constexpr double swLat = 47.39;
+    constexpr double swLon = 8.54;
+    constexpr int gridSize = 37;
+    constexpr double tileSize = TerrainTileCopernicus::tileSizeDegrees;
+
+    QJsonArray carpet;
+    for (int row=0; row<gridSize; row++) {
+        QJsonArray values;
+        for (int column=0; column<gridSize; column++) {
+            values.append(400 + row + column);
+        }
+        carpet.append(values);
+    }
+    const QJsonObject data {
+        { "bounds", QJsonObject { { "sw", QJsonArray { swLat, swLon } }, { "ne", QJsonArray { swLat + tileSize, swLon + tileSize } } } },
+        { "stats", QJsonObject { { "min", 400 }, { "max", 400 + (2 * (gridSize - 1)) }, { "avg", 400 + gridSize - 1 } } },
+        { "carpet", carpet },
+    };
+    const QJsonObject root { { "status", "success" }, { "data", data } };
+
+    const TerrainTile tile(TerrainTileCopernicus::serializeFromJson(QJsonDocument(root).toJson(QJsonDocument::Compact)));
+    QVERIFY(tile.isValid());
+
+    constexpr int coordinateCount = 1000;
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(coordinateCount);
+    QRandomGenerator random(1);
+    for (int i=0; i<coordinateCount; i++) {
+        coordinates.append(QGeoCoordinate(swLat + (random.generateDouble() * tileSize), swLon + (random.generateDouble() * tileSize)));
+    }
+
+    volatile double sink = 0;
+    _measure(QStringLiteral("TerrainTile::elevation nearest"), coordinateCount, [&tile, &coordinates, &sink]() {
+        for (const QGeoCoordinate& coordinate: coordinates) {
+            sink = sink + tile.elevation(coordinate);
+        }
+    });
+    _measure(QStringLiteral("TerrainTile::elevation bilinear"), coordinateCount, [&tile, &coordinates, &sink]() {
+        for (const QGeoCoordinate& coordinate: coordinates) {
+            sink = sink + tile.elevation(coordinate, TerrainTile::Sampling::Bilinear);
+        }
+    });
+}
@@ -0,0 +1,35 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "BenchmarkTest.h"
+
+#include <QtCore/QList>
+
+/// Throughput benchmarks for the path a telemetry message takes from the link into Facts and the map
+class PipelineBenchmark : public BenchmarkTest
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase(void) final;
+    void cleanupTestCase(void) final;
+
+    void _benchmarkReceiveBytes(void);
+    void _benchmarkVehicleDispatch(void);
+    void _benchmarkFactGroupHandleMessage(void);
+    void _benchmarkTrajectoryPointsAppend(void);
+    void _benchmarkTerrainTileElevation(void);
+
+private:
+    QList<mavlink_message_t> _telemetryMessages(int count);
+
+    uint8_t _packChannel = 0;
+};
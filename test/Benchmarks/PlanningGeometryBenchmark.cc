@@ -0,0 +1,183 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "PlanningGeometryBenchmark.h"
+#include "PlanMasterController.h"
+#include "SurveyComplexItem.h"
+#include "CorridorScanComplexItem.h"
+#include "StructureScanComplexItem.h"
+#include "CameraCalc.h"
+#include "QGCMapPolygon.h"
+#include "QGCMapPolyline.h"
+#include "QGCGeo.h"
+
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QtMath>
+#include <QtTest/QTest>
+
+namespace {
+const QGeoCoordinate gOrigin(47.3977, 8.5456, 0);
+constexpr double gFootprint = 20;   ///< Meters, sets the transect spacing
+}
+
+void PlanningGeometryBenchmark::init(void)
+{
+    BenchmarkTest::init();
+
+    _masterController = new PlanMasterController(this);
+}
+
+void PlanningGeometryBenchmark::cleanup(void)
+{
+    // Items are deleted along with the controller
+    delete _masterController;
+    _masterController = nullptr;
+
+    BenchmarkTest::cleanup();
+}
+
+QGeoCoordinate PlanningGeometryBenchmark::_nedToGeo(double north, double east)
+{
+    QGeoCoordinate coord;
+    QGCGeo::convertNedToGeo(north, east, 0, gOrigin, coord);
+    return coord;
+}
+
+/// Star shaped field with a randomly varying edge, concave at most vertices
+QList<QGeoCoordinate> PlanningGeometryBenchmark::_blobPolygon(double radius, int vertexCount)
+{
+    QRandomGenerator random(static_cast<quint32>(vertexCount));
+    QList<QGeoCoordinate> vertices;
+    vertices.reserve(vertexCount);
+    for (int i=0; i<vertexCount; i++) {
+        const double angle = (2.0 * M_PI * i) / vertexCount;
+        const double vertexRadius = radius * (0.6 + (0.4 * random.generateDouble()));
+        vertices.append(_nedToGeo(vertexRadius * qCos(angle), vertexRadius * qSin(angle)));
+    }
+    return vertices;
+}
+
+/// Field with deep parallel fingers, every transect crossing it is split into many segments. This is the worst case
+/// for the survey polygon intersection.
+QList<QGeoCoordinate> PlanningGeometryBenchmark::_combPolygon(double width, int vertexCount)
+{
+    const int teeth = qMax(3, vertexCount / 4);
+    const double pitch = width / teeth;
+    const double height = width / 2;
+    const double valley = height / 5;
+
+    QList<QGeoCoordinate> vertices;
+    vertices.reserve(teeth * 4);
+    vertices.append(_nedToGeo(0, 0));
+    vertices.append(_nedToGeo(0, width));
+    for (int tooth=teeth-1; tooth>=0; tooth--) {
+        const double left = tooth * pitch;
+        vertices.append(_nedToGeo(height, left + (pitch / 2)));
+        vertices.append(_nedToGeo(height, left));
+        if (tooth > 0) {
+            vertices.append(_nedToGeo(valley, left));
+            vertices.append(_nedToGeo(valley, left - (pitch / 2)));
+        }
+    }
+    return vertices;
+}
+
+/// Road like path which keeps changing direction
+QList<QGeoCoordinate> PlanningGeometryBenchmark::_windingPolyline(int vertexCount)
+{
+    constexpr double segmentLength = 50;
+
+    QList<QGeoCoordinate> vertices;
+    vertices.reserve(vertexCount);
+    double north = 0;
+    double east = 0;
+    for (int i=0; i<vertexCount; i++) {
+        vertices.append(_nedToGeo(north, east));
+        const double heading = qDegreesToRadians(30.0 * qSin(i / 5.0));
+        north += segmentLength * qCos(heading);
+        east += segmentLength * qSin(heading);
+    }
+    return vertices;
+}
+
+QList<PlanningGeometryBenchmark::Shape_t> PlanningGeometryBenchmark::_polygonCorpus(double radius)
+{
+    QList<Shape_t> corpus;
+    for (const int vertexCount: _vertexCounts) {
+        corpus.append({ QStringLiteral("blob %1").arg(vertexCount), _blobPolygon(radius, vertexCount) });
+    }
+    for (const int vertexCount: _vertexCounts) {
+        const QList<QGeoCoordinate> vertices = _combPolygon(radius * 2, vertexCount);
+        corpus.append({ QStringLiteral("comb %1").arg(vertices.count()), vertices });
+    }
+    return corpus;
+}
+
+QList<PlanningGeometryBenchmark::Shape_t> PlanningGeometryBenchmark::_polylineCorpus(void)
+{
+    QList<Shape_t> corpus;
+    for (const int vertexCount: _vertexCounts) {
+        corpus.append({ QStringLiteral("winding %1").arg(vertexCount), _windingPolyline(vertexCount) });
+    }
+    return corpus;
+}
+
+void PlanningGeometryBenchmark::_benchmarkSurvey(void)
+{
+    for (const Shape_t& shape: _polygonCorpus(500)) {
+        SurveyComplexItem* const survey = new SurveyComplexItem(_masterController, false /* flyView */, QString() /* kmlFile */);
+        survey->cameraCalc()->adjustedFootprintSide()->setRawValue(gFootprint);
+        survey->cameraCalc()->adjustedFootprintFrontal()->setRawValue(gFootprint);
+        survey->surveyAreaPolygon()->appendVertices(shape.vertices);
+
+        const SurveyComplexItem::TransectGenerationParams_t params = survey->_transectGenerationParams();
+        QVERIFY(!SurveyComplexItem::_generateTransects(params).isEmpty());
+
+        _measure(QStringLiteral("Survey transects %1").arg(shape.name), 1, [&params]() {
+            (void) SurveyComplexItem::_generateTransects(params);
+        });
+
+        // Transects plus the flight path, camera shots and visuals built from them
+        _measure(QStringLiteral("Survey rebuild %1").arg(shape.name), 1, [survey, &params]() {
+            survey->_setBackgroundTransects(SurveyComplexItem::_generateTransects(params));
+        });
+    }
+}
+
+void PlanningGeometryBenchmark::_benchmarkCorridorScan(void)
+{
+    for (const Shape_t& shape: _polylineCorpus()) {
+        CorridorScanComplexItem* const corridor = new CorridorScanComplexItem(_masterController, false /* flyView */, QString() /* kmlFile */);
+        corridor->cameraCalc()->adjustedFootprintSide()->setRawValue(gFootprint);
+        corridor->cameraCalc()->adjustedFootprintFrontal()->setRawValue(gFootprint);
+        corridor->corridorWidth()->setRawValue(100);
+        corridor->corridorPolyline()->appendVertices(shape.vertices);
+
+        _measure(QStringLiteral("CorridorScan rebuild %1").arg(shape.name), 1, [corridor]() {
+            corridor->_rebuildCorridorPolygon();
+            corridor->_rebuildTransects();
+        });
+        QVERIFY(!corridor->_transects.isEmpty());
+    }
+}
+
+void PlanningGeometryBenchmark::_benchmarkStructureScan(void)
+{
+    for (const Shape_t& shape: _polygonCorpus(50)) {
+        StructureScanComplexItem* const structure = new StructureScanComplexItem(_masterController, false /* flyView */, QString() /* kmlOrSHPFile */);
+        structure->cameraCalc()->adjustedFootprintSide()->setRawValue(gFootprint / 4);
+        structure->cameraCalc()->adjustedFootprintFrontal()->setRawValue(gFootprint / 4);
+        structure->structurePolygon()->appendVertices(shape.vertices);
+
+        _measure(QStringLiteral("StructureScan rebuild %1").arg(shape.name), 1, [structure]() {
+            structure->_rebuildFlightPolygon();
+        });
+        QVERIFY(structure->_flightPolygon.count() >= 3);
+    }
+}
@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "BenchmarkTest.h"
+
+#include <QtCore/QList>
+#include <QtPositioning/QGeoCoordinate>
+
+class PlanMasterController;
+
+/// Rebuild time and allocation counts for the complex item pattern generators, run over a corpus of generated shapes
+/// from 10 to 2000 vertices
+class PlanningGeometryBenchmark : public BenchmarkTest
+{
+    Q_OBJECT
+
+protected:
+    void init   (void) final;
+    void cleanup(void) final;
+
+private slots:
+    void _benchmarkSurvey       (void);
+    void _benchmarkCorridorScan (void);
+    void _benchmarkStructureScan(void);
+
+private:
+    typedef struct {
+        QString                 name;
+        QList<QGeoCoordinate>   vertices;
+    } Shape_t;
+
+    static QList<Shape_t>           _polygonCorpus  (double radius);
+    static QList<Shape_t>           _polylineCorpus (void);
+    static QList<QGeoCoordinate>    _blobPolygon    (double radius, int vertexCount);
+    static QList<QGeoCoordinate>    _combPolygon    (double width, int vertexCount);
+    static QList<QGeoCoordinate>    _windingPolyline(int vertexCount);
+    static QGeoCoordinate           _nedToGeo       (double north, double east);
+
+    PlanMasterController* _masterController = nullptr;
+
+    static constexpr int _vertexCounts[] = { 10, 100, 500, 2000 };
+};
@@ -0,0 +1,186 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ReplayBenchmark.h"
+#include "QGCApplication.h"
+#include "QGCToolbox.h"
+#include "LinkManager.h"
+#include "LogReplayLink.h"
+#include "MAVLinkProtocol.h"
+#include "MultiVehicleManager.h"
+#include "QmlObjectListModel.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+/// Writes a log of a single vehicle streaming typical telemetry rates
+bool ReplayBenchmark::_writeSyntheticLog(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    LinkManager* const linkManager = qgcApp()->toolbox()->linkManager();
+    const uint8_t channel = linkManager->allocateMavlinkChannel();
+    if (channel == LinkManager::invalidMavlinkChannel()) {
+        return false;
+    }
+    mavlink_get_channel_status(channel)->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+    constexpr uint8_t systemId = 1;
+    constexpr uint8_t componentId = MAV_COMP_ID_AUTOPILOT1;
+    constexpr int ticksPerSec = 100;
+    constexpr quint64 startTimeUsecs = 1700000000ull * 1000000ull;
+    constexpr int32_t latitude = 473977000;
+    constexpr int32_t longitude = 85456000;
+
+    QByteArray bytes;
+    const auto writeMessage = [&bytes](quint64 timeUsecs, const mavlink_message_t& msg) {
+        const quint64 timestamp = qToBigEndian(timeUsecs);
+        bytes.append(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
+        bytes.append(reinterpret_cast<const char*>(buffer), cBuffer);
+    };
+
+    for (int tick=0; tick<_syntheticLogSecs * ticksPerSec; tick++) {
+        const quint64 timeUsecs = startTimeUsecs + (static_cast<quint64>(tick) * (1000000 / ticksPerSec));
+        const uint32_t timeBootMsecs = static_cast<uint32_t>(tick * (1000 / ticksPerSec));
+        const float angle = static_cast<float>(tick % 3600) * 0.001745f;
+        const int32_t offset = tick % 10000;
+        mavlink_message_t msg;
+
+        if ((tick % 100) == 0) {
+            mavlink_msg_heartbeat_pack_chan(systemId, componentId, channel, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_GENERIC, MAV_MODE_FLAG_CUSTOM_MODE_ENABLED | MAV_MODE_FLAG_SAFETY_ARMED, 0, MAV_STATE_ACTIVE);
+            writeMessage(timeUsecs, msg);
+        }
+        if ((tick % 2) == 0) {
+            mavlink_msg_attitude_pack_chan(systemId, componentId, channel, &msg, timeBootMsecs, 0.05f, -0.05f, angle, 0.01f, 0.01f, 0.1f);
+            writeMessage(timeUsecs, msg);
+        }
+        if ((tick % 10) == 0) {
+            mavlink_msg_global_position_int_pack_chan(systemId, componentId, channel, &msg, timeBootMsecs, latitude + offset, longitude + offset, 500000, 50000, 100, 100, 0, static_cast<uint16_t>((tick % 36000)));
+            writeMessage(timeUsecs, msg);
+            mavlink_msg_vfr_hud_pack_chan(systemId, componentId, channel, &msg, 10.0f, 10.0f, static_cast<int16_t>((tick / 10) % 360), 50, 50.0f, 0.1f);
+            writeMessage(timeUsecs, msg);
+            mavlink_msg_local_position_ned_pack_chan(systemId, componentId, channel, &msg, timeBootMsecs, offset * 0.01f, offset * 0.01f, -50.0f, 1.0f, 1.0f, 0.0f);
+            writeMessage(timeUsecs, msg);
+        }
+        if ((tick % 20) == 0) {
+            mavlink_msg_gps_raw_int_pack_chan(systemId, componentId, channel, &msg, timeUsecs, GPS_FIX_TYPE_3D_FIX, latitude + offset, longitude + offset, 500000, 100, 100, 1000, UINT16_MAX, 12, 0, 0, 0, 0, 0, UINT16_MAX);
+            writeMessage(timeUsecs, msg);
+        }
+        if ((tick % 50) == 0) {
+            mavlink_msg_vibration_pack_chan(systemId, componentId, channel, &msg, timeUsecs, 5.0f, 6.0f, 7.0f, 0, 0, 0);
+            writeMessage(timeUsecs, msg);
+        }
+    }
+
+    linkManager->freeMavlinkChannel(channel);
+
+    return file.write(bytes) == bytes.size();
+}
+
+void ReplayBenchmark::_benchmarkReplay(void)
+{
+    QTemporaryDir tempDir;
+    QString logFile = qEnvironmentVariable("QGC_REPLAY_LOG");
+    if (logFile.isEmpty()) {
+        QVERIFY(tempDir.isValid());
+        logFile = tempDir.filePath(QStringLiteral("ReplayBenchmark.tlog"));
+        QVERIFY(_writeSyntheticLog(logFile));
+    }
+    QVERIFY(QFile::exists(logFile));
+
+    MAVLinkProtocol* const mavlinkProtocol = qgcApp()->toolbox()->mavlinkProtocol();
+    LinkManager* const linkManager = qgcApp()->toolbox()->linkManager();
+    MultiVehicleManager* const multiVehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+
+    mavlinkProtocol->clearMessageHandlerStats();
+    mavlinkProtocol->setMessageHandlerStatsEnabled(true);
+
+    QElapsedTimer wallTimer;
+    wallTimer.start();
+    const qint64 startCpuNsecs = _threadCpuNsecs();
+
+    LogReplayLink* const link = linkManager->startLogReplay(logFile, true /* fastReplay */);
+    QVERIFY(link);
+    QSignalSpy spyAtEnd(link, &LogReplayLink::playbackAtEnd);
+    QVERIFY(spyAtEnd.wait(_replayTimeoutMsecs));
+
+    const qint64 wallNsecs = wallTimer.nsecsElapsed();
+    const qint64 cpuNsecs = _threadCpuNsecs() - startCpuNsecs;
+    mavlinkProtocol->setMessageHandlerStatsEnabled(false);
+
+    QVERIFY(multiVehicleManager->vehicles()->count() > 0);
+
+    // Results
+    const QHash<uint32_t, MAVLinkProtocol::MessageHandlerStats_t>& stats = mavlinkProtocol->messageHandlerStats();
+    quint64 messageCount = 0;
+    quint64 handlerNsecs = 0;
+    QList<uint32_t> msgIds;
+    for (auto it = stats.constBegin(); it != stats.constEnd(); it++) {
+        messageCount += it.value().count;
+        handlerNsecs += it.value().nsecs;
+        msgIds.append(it.key());
+    }
+    QVERIFY(messageCount > 0);
+
+    const double wallSecs = wallNsecs / 1e9;
+    const double messagesPerSec = messageCount / wallSecs;
+    const double busyPercent = (startCpuNsecs < 0) ? -1 : ((100.0 * cpuNsecs) / wallNsecs);
+    const qint64 peakRssBytes = _peakRssBytes();
+
+    _recordMetric(QStringLiteral("replay messages"), messageCount, QStringLiteral("messages"));
+    _recordMetric(QStringLiteral("replay wall time"), wallSecs, QStringLiteral("s"));
+    _recordMetric(QStringLiteral("replay throughput"), messagesPerSec, QStringLiteral("messages/s"));
+    _recordMetric(QStringLiteral("replay handler time"), handlerNsecs / 1e6, QStringLiteral("ms"));
+    if (busyPercent >= 0) {
+        _recordMetric(QStringLiteral("replay main thread busy"), busyPercent, QStringLiteral("%"));
+    }
+    if (peakRssBytes >= 0) {
+        _recordMetric(QStringLiteral("replay peak rss"), peakRssBytes / (1024.0 * 1024.0), QStringLiteral("MB"));
+    }
+
+    std::sort(msgIds.begin(), msgIds.end(), [&stats](uint32_t a, uint32_t b) { return stats[a].nsecs > stats[b].nsecs; });
+    for (int i=0; i<qMin(msgIds.count(), _reportedHandlerCount); i++) {
+        const MAVLinkProtocol::MessageHandlerStats_t& msgStats = stats[msgIds[i]];
+        const mavlink_message_info_t* const msgInfo = mavlink_get_message_info_by_id(msgIds[i]);
+        const QString msgName = msgInfo ? QString(msgInfo->name) : QString::number(msgIds[i]);
+        _recordMetric(QStringLiteral("handler %1 time").arg(msgName), msgStats.nsecs / 1e6, QStringLiteral("ms"));
+        _recordMetric(QStringLiteral("handler %1 per message").arg(msgName), static_cast<double>(msgStats.nsecs) / msgStats.count, QStringLiteral("ns"));
+    }
+
+    linkManager->disconnectAll();
+    QTRY_VERIFY_WITH_TIMEOUT(multiVehicleManager->vehicles()->count() == 0, 10000);
+
+    // Optional limits for CI
+    bool ok = false;
+    const double minMessagesPerSec = qEnvironmentVariable("QGC_REPLAY_MIN_MSGS_PER_SEC").toDouble(&ok);
+    if (ok) {
+        QVERIFY2(messagesPerSec >= minMessagesPerSec, qPrintable(QStringLiteral("%1 messages/s is below %2").arg(messagesPerSec).arg(minMessagesPerSec)));
+    }
+    const double maxBusyPercent = qEnvironmentVariable("QGC_REPLAY_MAX_BUSY_PERCENT").toDouble(&ok);
+    if (ok && (busyPercent >= 0)) {
+        QVERIFY2(busyPercent <= maxBusyPercent, qPrintable(QStringLiteral("main thread busy %1% is above %2%").arg(busyPercent).arg(maxBusyPercent)));
+    }
+    const double maxPeakRssMB = qEnvironmentVariable("QGC_REPLAY_MAX_PEAK_RSS_MB").toDouble(&ok);
+    if (ok && (peakRssBytes >= 0)) {
+        const double peakRssMB = peakRssBytes / (1024.0 * 1024.0);
+        QVERIFY2(peakRssMB <= maxPeakRssMB, qPrintable(QStringLiteral("peak rss %1 MB is above %2 MB").arg(peakRssMB).arg(maxPeakRssMB)));
+    }
+}
@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "BenchmarkTest.h"
+
+/// End to end ingest test: replays a telemetry log through LogReplayLink as fast as it can be processed, with the full
+/// Vehicle and FactGroup stack behind it, and reports message throughput, main thread busy time, time per message id
+/// and the peak resident set size.
+///
+/// The log comes from the QGC_REPLAY_LOG environment variable, a synthetic log is generated if it is not set. The
+/// test fails if a result is worse than the optional limits given by QGC_REPLAY_MIN_MSGS_PER_SEC,
+/// QGC_REPLAY_MAX_BUSY_PERCENT and QGC_REPLAY_MAX_PEAK_RSS_MB.
+class ReplayBenchmark : public BenchmarkTest
+{
+    Q_OBJECT
+
+private slots:
+    void _benchmarkReplay(void);
+
+private:
+    static bool _writeSyntheticLog(const QString& fileName);
+
+    static constexpr int    _syntheticLogSecs       = 600;
+    static constexpr int    _replayTimeoutMsecs     = 10 * 60 * 1000;
+    static constexpr int    _reportedHandlerCount   = 10;       ///< Most expensive message ids reported individually
+};
@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkInterfaceDecodeTest.h"
+#include "LinkInterface.h"
+#include "MockLink.h"
+#include "QGC.h"
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+namespace {
+
+/// Link which only feeds the bytes it is given to bytesReceived
+class DecodeTestLink : public LinkInterface
+{
+public:
+    DecodeTestLink(SharedLinkConfigurationPtr &config)
+        : LinkInterface(config)
+    {
+        (void) _allocateMavlinkChannel();
+    }
+
+    ~DecodeTestLink()
+    {
+        _freeMavlinkChannel();
+    }
+
+    void disconnect() override {}
+    bool isConnected() const override { return true; }
+
+    void receive(const QByteArray &bytes) { emit bytesReceived(this, bytes, QGC::utcTimeUsecs()); }
+
+private:
+    void _writeBytes(const QByteArray &bytes) override { Q_UNUSED(bytes); }
+    bool _connect() override { return true; }
+};
+
+} // namespace
+
+void LinkInterfaceDecodeTest::_testDecodeOnLinkThread(void)
+{
+    SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkInterfaceDecodeTest"));
+    DecodeTestLink link(config);
+    QVERIFY(link.mavlinkChannelIsSet());
+    link.setDecodeOnLinkThread(true);
+
+    const uint8_t channel = link.mavlinkChannel();
+    mavlink_status_t *const channelStatus = mavlink_get_channel_status(channel);
+    channelStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+    constexpr int kMessageCount = 200;
+    QByteArray bytes;
+    QList<uint8_t> sentSequences;
+    for (int i = 0; i < kMessageCount; i++) {
+        mavlink_message_t message;
+        (void) mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, channel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, static_cast<uint32_t>(i), MAV_STATE_ACTIVE);
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t length = mavlink_msg_to_send_buffer(buffer, &message);
+        bytes.append(reinterpret_cast<const char*>(buffer), length);
+        sentSequences.append(message.seq);
+    }
+    const uint32_t channelRxSuccessCount = channelStatus->packet_rx_success_count;
+
+    QList<mavlink_message_t> received;
+    QAtomicInteger<int> foreignThreadBatches = 0;
+    QThread *decodeThread = nullptr;
+    (void) connect(&link, &LinkInterface::messagesReceived, &link, [&foreignThreadBatches, &decodeThread](LinkInterface*, const QList<mavlink_message_t>&, quint64) {
+        if (QThread::currentThread() != decodeThread) {
+            foreignThreadBatches++;
+        }
+    }, Qt::DirectConnection);
+    (void) connect(&link, &LinkInterface::messagesReceived, this, [&received](LinkInterface*, const QList<mavlink_message_t> &messages, quint64) {
+        received.append(messages);
+    }, Qt::QueuedConnection);
+
+    // Chunks which split frames so the parse state has to carry over from one buffer to the next
+    decodeThread = QThread::create([&link, bytes]() {
+        constexpr qsizetype kChunkSize = 7;
+        for (qsizetype offset = 0; offset < bytes.size(); offset += kChunkSize) {
+            link.receive(bytes.mid(offset, kChunkSize));
+        }
+    });
+    decodeThread->start();
+
+    // Meanwhile the main thread keeps using the channel status the way outbound packing and version switching do
+    while (!decodeThread->isFinished()) {
+        channelStatus->flags ^= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        QThread::yieldCurrentThread();
+    }
+    QVERIFY(decodeThread->wait(5000));
+    channelStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+    QTRY_COMPARE(received.count(), kMessageCount);
+    QCOMPARE(foreignThreadBatches.loadRelaxed(), 0);
+    for (int i = 0; i < kMessageCount; i++) {
+        QCOMPARE(received[i].msgid, static_cast<uint32_t>(MAVLINK_MSG_ID_HEARTBEAT));
+        QCOMPARE(received[i].magic, static_cast<uint8_t>(MAVLINK_STX));
+        QCOMPARE(received[i].seq, sentSequences[i]);
+        QCOMPARE(mavlink_msg_heartbeat_get_custom_mode(&received[i]), static_cast<uint32_t>(i));
+    }
+
+    // The link thread decodes with its own parse state and leaves the channel status to the main thread
+    QCOMPARE(channelStatus->packet_rx_success_count, channelRxSuccessCount);
+
+    delete decodeThread;
+}
@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriterTest.h"
+#include "MAVLinkLogWriter.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+void MAVLinkLogWriterTest::_testRecords(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("test.tlog"));
+
+    MAVLinkLogWriter writer;
+    QVERIFY(writer.startWriting(fileName, 0));
+    QVERIFY(writer.queueRecord(1000, "abc", 3, 0));
+    QVERIFY(writer.queueRecord(2000, "de", 2, 1));
+    writer.stopWriting();
+    QVERIFY(!writer.isWriting());
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray bytes = file.readAll();
+    QCOMPARE(bytes.size(), 8 + 3 + 8 + 2);
+
+    const uchar* const data = reinterpret_cast<const uchar*>(bytes.constData());
+    QCOMPARE(qFromBigEndian<quint64>(data), quint64(1000));
+    QCOMPARE(bytes.mid(8, 3), QByteArray("abc"));
+    QCOMPARE(qFromBigEndian<quint64>(data + 11), quint64(2000));
+    QCOMPARE(bytes.mid(19, 2), QByteArray("de"));
+}
+
+void MAVLinkLogWriterTest::_testIndex(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("test.tlog"));
+
+    MAVLinkLogWriter writer;
+    QVERIFY(writer.startWriting(fileName, 0));
+    writer.setLinkName(2, QStringLiteral("Radio"));
+
+    // One record every 10 ms from two links for one second, which is ten index intervals
+    constexpr int recordCount = 100;
+    constexpr quint64 startUSecs = 1'000'000;
+    for (int i = 0; i < recordCount; i++) {
+        QVERIFY(writer.queueRecord(startUSecs + (i * 10'000), "0123456789", 10, (i % 2) ? 2 : 3));
+    }
+    writer.stopWriting();
+
+    QFile indexFile(MAVLinkLogWriter::indexFileName(fileName));
+    QVERIFY(indexFile.open(QIODevice::ReadOnly));
+    const QByteArray bytes = indexFile.readAll();
+    QVERIFY(bytes.startsWith(MAVLinkLogWriter::indexMagic));
+
+    const uchar* const data = reinterpret_cast<const uchar*>(bytes.constData());
+    qsizetype pos = 8;
+
+    // Link names come before the records of the link
+    QCOMPARE(bytes[pos], MAVLinkLogWriter::indexLinkType);
+    QCOMPARE(data[pos + 1], uchar(2));
+    QCOMPARE(bytes.mid(pos + 3, data[pos + 2]), QByteArray("Radio"));
+    pos += 3 + data[pos + 2];
+
+    QList<quint64> timestamps;
+    while (pos < bytes.size()) {
+        QCOMPARE(bytes[pos], MAVLinkLogWriter::indexEntryType);
+        const quint64 timestamp = qFromLittleEndian<quint64>(data + pos + 1);
+        const quint64 offset = qFromLittleEndian<quint64>(data + pos + 9);
+        const quint32 linkMask = qFromLittleEndian<quint32>(data + pos + 17);
+        pos += 21;
+
+        // Every record is 18 bytes, so the offset follows from the timestamp
+        QCOMPARE(offset, ((timestamp - startUSecs) / 10'000) * 18);
+        if (!timestamps.isEmpty()) {
+            QCOMPARE(linkMask, quint32((1 << 2) | (1 << 3)));
+        }
+        timestamps.append(timestamp);
+    }
+
+    QCOMPARE(timestamps.count(), 10);
+    QCOMPARE(timestamps.first(), startUSecs);
+    QCOMPARE(timestamps.last(), startUSecs + (9 * MAVLinkLogWriter::indexIntervalUSecs));
+}
@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageStatsTest.h"
+#include "MAVLinkMessageStats.h"
+#include "MAVLinkLib.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtTest/QTest>
+
+void MAVLinkMessageStatsTest::_testRecord(void)
+{
+    MAVLinkMessageStats stats;
+
+    // Heartbeats at 1 Hz and attitude at 50 Hz from one component, with 3 messages lost before the last attitude
+    for (int i = 0; i < 10; i++) {
+        stats.record(1, 1, MAVLINK_MSG_ID_HEARTBEAT, 21, i * 1'000'000ull, 0);
+    }
+    for (int i = 0; i < 50; i++) {
+        stats.record(1, 1, MAVLINK_MSG_ID_ATTITUDE, 40, i * 20'000ull, (i == 49) ? 3 : 0);
+    }
+
+    const QList<MAVLinkMessageStats::Snapshot_t> snapshot = stats.snapshot();
+    QCOMPARE(snapshot.count(), 3);
+
+    // Sorted by msgid, with the component entry last
+    const MAVLinkMessageStats::Snapshot_t& heartbeat = snapshot[0];
+    QCOMPARE(heartbeat.msgid, quint32(MAVLINK_MSG_ID_HEARTBEAT));
+    QCOMPARE(heartbeat.count, quint64(10));
+    QCOMPARE(heartbeat.bytes, quint64(210));
+    QCOMPARE(heartbeat.intervalUSecs, quint64(1'000'000));
+    QCOMPARE(heartbeat.jitterUSecs, quint64(0));
+    QCOMPARE(heartbeat.lost, quint64(0));
+
+    const MAVLinkMessageStats::Snapshot_t& attitude = snapshot[1];
+    QCOMPARE(attitude.msgid, quint32(MAVLINK_MSG_ID_ATTITUDE));
+    QCOMPARE(attitude.count, quint64(50));
+    QCOMPARE(attitude.intervalUSecs, quint64(20'000));
+    QCOMPARE(attitude.firstUSecs, quint64(0));
+    QCOMPARE(attitude.lastUSecs, quint64(49 * 20'000));
+
+    const MAVLinkMessageStats::Snapshot_t& component = snapshot[2];
+    QCOMPARE(component.msgid, MAVLinkMessageStats::componentMsgId);
+    QCOMPARE(component.count, quint64(60));
+    QCOMPARE(component.bytes, quint64(210 + 2000));
+    QCOMPARE(component.lost, quint64(3));
+}
+
+void MAVLinkMessageStatsTest::_testJson(void)
+{
+    MAVLinkMessageStats stats;
+
+    for (int i = 0; i <= 10; i++) {
+        stats.record(1, 1, MAVLINK_MSG_ID_HEARTBEAT, 21, i * 100'000ull, 0);
+    }
+    stats.record(2, 1, MAVLINK_MSG_ID_HEARTBEAT, 21, 0, 1);
+
+    const QJsonArray array = QJsonDocument::fromJson(stats.toJson().toUtf8()).array();
+    QCOMPARE(array.count(), 4);
+
+    const QJsonObject heartbeat = array[0].toObject();
+    QCOMPARE(heartbeat[QStringLiteral("sysid")].toInt(), 1);
+    QCOMPARE(heartbeat[QStringLiteral("name")].toString(), QStringLiteral("HEARTBEAT"));
+    QCOMPARE(heartbeat[QStringLiteral("count")].toInt(), 11);
+    QCOMPARE(heartbeat[QStringLiteral("rateHz")].toDouble(), 10.0);
+    QCOMPARE(heartbeat[QStringLiteral("intervalMSecs")].toDouble(), 100.0);
+
+    const QJsonObject component = array[3].toObject();
+    QCOMPARE(component[QStringLiteral("sysid")].toInt(), 2);
+    QVERIFY(!component.contains(QStringLiteral("msgid")));
+    QCOMPARE(component[QStringLiteral("lost")].toInt(), 1);
+    QCOMPARE(component[QStringLiteral("lossPercent")].toDouble(), 50.0);
+}
+
+void MAVLinkMessageStatsTest::_testReset(void)
+{
+    MAVLinkMessageStats stats;
+
+    stats.record(1, 1, MAVLINK_MSG_ID_HEARTBEAT, 21, 0, 0);
+    QCOMPARE(stats.snapshot().count(), 2);
+
+    // Takes effect with the next record
+    stats.reset();
+    stats.record(1, 1, MAVLINK_MSG_ID_ATTITUDE, 40, 1000, 0);
+
+    const QList<MAVLinkMessageStats::Snapshot_t> snapshot = stats.snapshot();
+    QCOMPARE(snapshot.count(), 2);
+    QCOMPARE(snapshot[0].msgid, quint32(MAVLINK_MSG_ID_ATTITUDE));
+    QCOMPARE(snapshot[1].count, quint64(1));
+}
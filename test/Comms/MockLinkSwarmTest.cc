@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockLinkSwarmTest.h"
+#include "MockLinkSwarm.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "LinkManager.h"
+#include "MissionManager.h"
+#include "Vehicle.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QTest>
+
+void MockLinkSwarmTest::_testParseOptions(void)
+{
+    MockConfiguration::Swarm_t swarm;
+    int linkCount = 1;
+    QString errorString;
+
+    QVERIFY(MockLinkSwarm::parseOptions(QStringLiteral("vehicles=120,links=3,position=20,attitude=0,mission=25,params=400,radius=50.5"), swarm, linkCount, errorString));
+    QCOMPARE(swarm.vehicleCount, 120);
+    QCOMPARE(linkCount, 3);
+    QCOMPARE(swarm.positionRateHz, 20);
+    QCOMPARE(swarm.attitudeRateHz, 0);
+    QCOMPARE(swarm.missionItemCount, 25);
+    QCOMPARE(swarm.paramCount, 400);
+    QCOMPARE(swarm.pathRadius, 50.5);
+    QVERIFY(errorString.isEmpty());
+
+    // Rates are capped to what the swarm tick can deliver
+    QVERIFY(MockLinkSwarm::parseOptions(QStringLiteral("position=1000"), swarm, linkCount, errorString));
+    QCOMPARE(swarm.positionRateHz, 100);
+
+    QVERIFY(!MockLinkSwarm::parseOptions(QStringLiteral("vehicles"), swarm, linkCount, errorString));
+    QVERIFY(!errorString.isEmpty());
+    QVERIFY(!MockLinkSwarm::parseOptions(QStringLiteral("vehicles=-1"), swarm, linkCount, errorString));
+    QVERIFY(!MockLinkSwarm::parseOptions(QStringLiteral("wingspan=3"), swarm, linkCount, errorString));
+}
+
+void MockLinkSwarmTest::_testSwarmConnect(void)
+{
+    MockConfiguration::Swarm_t swarm;
+    swarm.vehicleCount = 5;
+    swarm.missionItemCount = 5;
+    swarm.paramCount = 50;
+    int linkCount = 2;
+
+    const QString benchmarkOptions = qEnvironmentVariable("QGC_MOCK_SWARM");
+    if (!benchmarkOptions.isEmpty()) {
+        QString errorString;
+        QVERIFY2(MockLinkSwarm::parseOptions(benchmarkOptions, swarm, linkCount, errorString), qPrintable(errorString));
+    }
+
+    MultiVehicleManager* const multiVehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+
+    QElapsedTimer connectTimer;
+    connectTimer.start();
+
+    const QList<MockLinkSwarm*> links = MockLinkSwarm::startSwarm(swarm, linkCount);
+    QCOMPARE(links.count(), linkCount);
+
+    int vehicleCount = 0;
+    for (const MockLinkSwarm* link: links) {
+        vehicleCount += link->vehicleCount();
+    }
+    QCOMPARE(vehicleCount, swarm.vehicleCount);
+
+    // Scale the timeout with the amount of traffic needed to bring all vehicles up
+    const int timeoutMsecs = 30000 + (vehicleCount * 200) + ((vehicleCount * swarm.paramCount) / 10);
+
+    QTRY_COMPARE_WITH_TIMEOUT(multiVehicleManager->vehicles()->count(), vehicleCount, timeoutMsecs);
+    const qint64 vehiclesCreatedMsecs = connectTimer.elapsed();
+
+    auto allInitialConnectComplete = [multiVehicleManager]() {
+        for (int i = 0; i < multiVehicleManager->vehicles()->count(); i++) {
+            if (!multiVehicleManager->vehicles()->value<Vehicle*>(i)->isInitialConnectComplete()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(allInitialConnectComplete(), timeoutMsecs);
+    const qint64 initialConnectMsecs = connectTimer.elapsed();
+
+    for (int i = 0; i < multiVehicleManager->vehicles()->count(); i++) {
+        Vehicle* const vehicle = multiVehicleManager->vehicles()->value<Vehicle*>(i);
+        QCOMPARE(vehicle->missionManager()->missionItems().count(), swarm.missionItemCount);
+    }
+
+    // Steady state telemetry throughput
+    auto totalMessagesSent = [&links]() {
+        quint64 total = 0;
+        for (const MockLinkSwarm* link: links) {
+            total += link->messagesSent();
+        }
+        return total;
+    };
+    const quint64 messagesSentStart = totalMessagesSent();
+    QTest::qWait(2000);
+    const quint64 messagesSent = totalMessagesSent() - messagesSentStart;
+
+    qCInfo(MockLinkSwarmLog) << "MockLinkSwarm:" << vehicleCount << "vehicles on" << linkCount << "links,"
+                             << "created" << vehiclesCreatedMsecs << "ms,"
+                             << "initial connect" << initialConnectMsecs << "ms,"
+                             << "steady state" << (messagesSent / 2) << "msgs/s";
+
+    _linkManager->disconnectAll();
+    QTRY_COMPARE_WITH_TIMEOUT(multiVehicleManager->vehicles()->count(), 0, 10000);
+}
@@ -0,0 +1,23 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// The connect test doubles as a scaling benchmark: set QGC_MOCK_SWARM to MockLinkSwarm options, for example
+/// QGC_MOCK_SWARM=vehicles=200,links=4,params=1000 and run with --unittest:MockLinkSwarmTest
+class MockLinkSwarmTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testParseOptions(void);
+    void _testSwarmConnect(void);
+};
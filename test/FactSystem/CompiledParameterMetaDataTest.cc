@@ -0,0 +1,189 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CompiledParameterMetaDataTest.h"
+#include "CompiledParameterMetaData.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+#include <cstddef>
+
+namespace {
+    QList<CompiledParameterMetaData::RawMetaData> testParameters()
+    {
+        QList<CompiledParameterMetaData::RawMetaData> parameters;
+
+        CompiledParameterMetaData::RawMetaData enumParameter;
+        enumParameter.name              = QStringLiteral("COM_FLTMODE1");
+        enumParameter.type              = QStringLiteral("INT32");
+        enumParameter.category          = QStringLiteral("Standard");
+        enumParameter.group             = QStringLiteral("Commander");
+        enumParameter.shortDescription  = QStringLiteral("First flightmode slot");
+        enumParameter.longDescription   = QStringLiteral("If the main switch channel is in this range the selected flight mode will be applied.");
+        enumParameter.min               = QStringLiteral("-1");
+        enumParameter.max               = QStringLiteral("12");
+        enumParameter.defaultValue      = QStringLiteral("-1");
+        enumParameter.flags             = CompiledParameterMetaData::FlagRebootRequired;
+        enumParameter.values            = { { QStringLiteral("-1"), QStringLiteral("Unassigned") }, { QStringLiteral("0"), QStringLiteral("Manual") }, { QStringLiteral("2"), QStringLiteral("Position") } };
+        parameters.append(enumParameter);
+
+        CompiledParameterMetaData::RawMetaData bitmaskParameter;
+        bitmaskParameter.name           = QStringLiteral("EKF2_AID_MASK");
+        bitmaskParameter.type           = QStringLiteral("INT32");
+        bitmaskParameter.units          = QStringLiteral("°");
+        bitmaskParameter.flags          = CompiledParameterMetaData::FlagReadOnly | CompiledParameterMetaData::FlagVolatile;
+        bitmaskParameter.bitmask        = { { QStringLiteral("0"), QStringLiteral("use GPS") }, { QStringLiteral("1"), QStringLiteral("use optical flow") } };
+        parameters.append(bitmaskParameter);
+
+        // The same name in two vehicle scopes
+        CompiledParameterMetaData::RawMetaData copterParameter;
+        copterParameter.scope           = QStringLiteral("Copter");
+        copterParameter.name            = QStringLiteral("WPNAV_SPEED");
+        copterParameter.type            = QStringLiteral("FLOAT");
+        copterParameter.increment       = QStringLiteral("50");
+        copterParameter.decimalPlaces   = QStringLiteral("0");
+        copterParameter.units           = QStringLiteral("cm/s");
+        parameters.append(copterParameter);
+
+        CompiledParameterMetaData::RawMetaData roverParameter = copterParameter;
+        roverParameter.scope            = QStringLiteral("Rover");
+        roverParameter.units            = QStringLiteral("m/s");
+        roverParameter.flags            = CompiledParameterMetaData::FlagBoolean | CompiledParameterMetaData::FlagDuplicate;
+        parameters.append(roverParameter);
+
+        return parameters;
+    }
+}
+
+void CompiledParameterMetaDataTest::init(void)
+{
+    UnitTest::init();
+
+    QVERIFY(_tempDir.isValid());
+    // Unique base name, so the compiled files of this test never collide with those of a real meta data file
+    _sourceFile = _tempDir.filePath(QStringLiteral("CompiledParameterMetaDataTest.%1.xml").arg(QCoreApplication::applicationPid()));
+}
+
+void CompiledParameterMetaDataTest::cleanup(void)
+{
+    // Compiled files of every source version written by the test
+    QByteArray content;
+    const QString compiledFileName = CompiledParameterMetaData::_compiledFileName(_sourceFile, content);
+    if (!compiledFileName.isEmpty()) {
+        QDir compiledDir = QFileInfo(compiledFileName).absoluteDir();
+        const QStringList compiledFiles = compiledDir.entryList({ QFileInfo(_sourceFile).completeBaseName() + QStringLiteral(".*.bin") }, QDir::Files);
+        for (const QString& compiledFile : compiledFiles) {
+            (void) compiledDir.remove(compiledFile);
+        }
+    }
+
+    UnitTest::cleanup();
+}
+
+bool CompiledParameterMetaDataTest::_writeSourceFile(const QByteArray& content)
+{
+    QFile file(_sourceFile);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && (file.write(content) == content.size());
+}
+
+void CompiledParameterMetaDataTest::_testCompileLoad(void)
+{
+    QVERIFY(_writeSourceFile("<parameters version=\"1\"/>"));
+
+    const QList<CompiledParameterMetaData::RawMetaData> parameters = testParameters();
+    {
+        CompiledParameterMetaData compiled;
+        QVERIFY(!compiled.open(_sourceFile));
+        QVERIFY(compiled.compile(_sourceFile, parameters));
+        QVERIFY(compiled.isOpen());
+    }
+
+    // A new instance maps the file written before
+    CompiledParameterMetaData compiled;
+    QVERIFY(compiled.open(_sourceFile));
+
+    for (const CompiledParameterMetaData::RawMetaData& expected : parameters) {
+        CompiledParameterMetaData::RawMetaData actual;
+        QVERIFY2(compiled.find(expected.scope, expected.name, actual), qPrintable(expected.scope + QStringLiteral(":") + expected.name));
+        QCOMPARE(actual.scope,              expected.scope);
+        QCOMPARE(actual.name,               expected.name);
+        QCOMPARE(actual.type,               expected.type);
+        QCOMPARE(actual.category,           expected.category);
+        QCOMPARE(actual.group,              expected.group);
+        QCOMPARE(actual.shortDescription,   expected.shortDescription);
+        QCOMPARE(actual.longDescription,    expected.longDescription);
+        QCOMPARE(actual.min,                expected.min);
+        QCOMPARE(actual.max,                expected.max);
+        QCOMPARE(actual.defaultValue,       expected.defaultValue);
+        QCOMPARE(actual.increment,          expected.increment);
+        QCOMPARE(actual.units,              expected.units);
+        QCOMPARE(actual.decimalPlaces,      expected.decimalPlaces);
+        QCOMPARE(actual.flags,              expected.flags);
+        QCOMPARE(actual.values,             expected.values);
+        QCOMPARE(actual.bitmask,            expected.bitmask);
+    }
+
+    CompiledParameterMetaData::RawMetaData missing;
+    QVERIFY(!compiled.find(QString(), QStringLiteral("NOT_A_PARAM"), missing));
+    QVERIFY(!compiled.find(QStringLiteral("Plane"), QStringLiteral("WPNAV_SPEED"), missing));
+    QVERIFY(!compiled.find(QStringLiteral("Copter"), QStringLiteral("COM_FLTMODE1"), missing));
+}
+
+void CompiledParameterMetaDataTest::_testSourceChanged(void)
+{
+    QVERIFY(_writeSourceFile("<parameters version=\"1\"/>"));
+    {
+        CompiledParameterMetaData compiled;
+        QVERIFY(compiled.compile(_sourceFile, testParameters()));
+    }
+
+    // The compiled file is keyed by the source content, so a new source version must be compiled again
+    QVERIFY(_writeSourceFile("<parameters version=\"2\"/>"));
+    CompiledParameterMetaData compiled;
+    QVERIFY(!compiled.open(_sourceFile));
+    QVERIFY(!compiled.isOpen());
+}
+
+void CompiledParameterMetaDataTest::_testVersionMismatch(void)
+{
+    QVERIFY(_writeSourceFile("<parameters version=\"1\"/>"));
+    {
+        CompiledParameterMetaData compiled;
+        QVERIFY(compiled.compile(_sourceFile, testParameters()));
+    }
+
+    // Compiled file written by a different version of the format
+    QByteArray content;
+    const QString compiledFileName = CompiledParameterMetaData::_compiledFileName(_sourceFile, content);
+    QVERIFY(QFile::exists(compiledFileName));
+    {
+        QFile file(compiledFileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(offsetof(CompiledParameterMetaData::Header_t, version)));
+        const quint32 otherVersion = qToLittleEndian<quint32>(CompiledParameterMetaData::kVersion + 1);
+        QCOMPARE(file.write(reinterpret_cast<const char*>(&otherVersion), sizeof(otherVersion)), static_cast<qint64>(sizeof(otherVersion)));
+    }
+
+    CompiledParameterMetaData compiled;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Invalid compiled meta data"));
+    QVERIFY(!compiled.open(_sourceFile));
+    QVERIFY(!compiled.isOpen());
+
+    // The rejected file is removed, so the next load compiles the source again
+    QVERIFY(!QFile::exists(compiledFileName));
+    QVERIFY(compiled.compile(_sourceFile, testParameters()));
+    CompiledParameterMetaData::RawMetaData rawMetaData;
+    QVERIFY(compiled.find(QString(), QStringLiteral("COM_FLTMODE1"), rawMetaData));
+}
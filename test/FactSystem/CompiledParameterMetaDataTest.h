@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtCore/QTemporaryDir>
+
+/// Compiles parameter meta data and reads it back from the mapped compiled file
+class CompiledParameterMetaDataTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init(void) override;
+    void cleanup(void) override;
+
+    void _testCompileLoad(void);
+    void _testSourceChanged(void);
+    void _testVersionMismatch(void);
+
+private:
+    bool _writeSourceFile(const QByteArray& content);
+
+    QTemporaryDir   _tempDir;
+    QString         _sourceFile;
+};
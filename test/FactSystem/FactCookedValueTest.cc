@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactCookedValueTest.h"
+#include "Fact.h"
+#include "FactGroup.h"
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+    QVariant _halfTranslator(const QVariant& from) { return QVariant(from.toDouble() / 2.0); }
+    QVariant _doubleTranslator(const QVariant& from) { return QVariant(from.toDouble() * 2.0); }
+
+    class ValueBlockFactGroup : public FactGroup
+    {
+    public:
+        ValueBlockFactGroup()
+            : FactGroup(0 /* updateRateMsecs */)
+            , intFact   (0, QStringLiteral("int"),      FactMetaData::valueTypeInt16)
+            , doubleFact(0, QStringLiteral("double"),   FactMetaData::valueTypeDouble)
+        {
+            _addValueBlockFact(&intFact,    intFact.name());
+            _addValueBlockFact(&doubleFact, doubleFact.name());
+        }
+
+        void setValue(Fact& fact, double value) { _setValueBlockValue(fact, value); }
+
+        Fact intFact;
+        Fact doubleFact;
+    };
+}
+
+void FactCookedValueTest::_rawValueChange_test(void)
+{
+    Fact fact(0, QStringLiteral("Test"), FactMetaData::valueTypeDouble);
+    fact.metaData()->setRawUnits(QStringLiteral("centi-degrees"));
+    fact.metaData()->setDecimalPlaces(1);
+
+    fact.setRawValue(1250);
+    QCOMPARE(fact.cookedValue().toDouble(), 12.5);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("12.5"));
+
+    fact.setRawValue(-300);
+    QCOMPARE(fact.cookedValue().toDouble(), -3.0);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("-3.0"));
+
+    // Values from the vehicle take the same path
+    fact._containerSetRawValue(QVariant(50.0));
+    QCOMPARE(fact.cookedValue().toDouble(), 0.5);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("0.5"));
+}
+
+void FactCookedValueTest::_translationChange_test(void)
+{
+    Fact fact(0, QStringLiteral("Test"), FactMetaData::valueTypeDouble);
+    fact.metaData()->setDecimalPlaces(2);
+    fact.setRawValue(10.0);
+    QCOMPARE(fact.cookedValue().toDouble(), 10.0);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("10.00"));
+
+    // A units setting change installs new translators
+    fact.metaData()->setTranslators(_halfTranslator, _doubleTranslator);
+    QCOMPARE(fact.cookedValue().toDouble(), 5.0);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("5.00"));
+
+    // Swapping in other meta data
+    FactMetaData metaData(FactMetaData::valueTypeDouble);
+    metaData.setDecimalPlaces(2);
+    metaData.setRawUnits(QStringLiteral("norm"));
+    fact.setMetaData(&metaData);
+    QCOMPARE(fact.cookedValue().toDouble(), 1000.0);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("1000.00"));
+}
+
+void FactCookedValueTest::_decimalPlacesChange_test(void)
+{
+    Fact fact(0, QStringLiteral("Test"), FactMetaData::valueTypeDouble);
+    fact.metaData()->setDecimalPlaces(1);
+    fact.setRawValue(2.125);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("2.1"));
+
+    fact.metaData()->setDecimalPlaces(3);
+    QCOMPARE(fact.metaData()->decimalPlaces(), 3);
+    QCOMPARE(fact.cookedValueString(), QStringLiteral("2.125"));
+}
+
+void FactCookedValueTest::_valueBlock_test(void)
+{
+    ValueBlockFactGroup factGroup;
+    QSignalSpy intSpy(&factGroup.intFact, &Fact::rawValueChanged);
+    QSignalSpy doubleSpy(&factGroup.doubleFact, &Fact::rawValueChanged);
+
+    factGroup.setValue(factGroup.intFact, 25.3);
+    factGroup.setValue(factGroup.doubleFact, 25.3);
+    QCOMPARE(intSpy.count(), 1);
+    QCOMPARE(doubleSpy.count(), 1);
+    QCOMPARE(factGroup.intFact.rawValue().toInt(), 25);
+    QCOMPARE(factGroup.doubleFact.rawValue().toDouble(), 25.3);
+
+    // Jitter which doesn't change the converted value is not signalled for integer Facts
+    factGroup.setValue(factGroup.intFact, 25.4);
+    factGroup.setValue(factGroup.doubleFact, 25.4);
+    QCOMPARE(intSpy.count(), 1);
+    QCOMPARE(doubleSpy.count(), 2);
+
+    factGroup.setValue(factGroup.intFact, 26.0);
+    QCOMPARE(intSpy.count(), 2);
+    QCOMPARE(factGroup.intFact.rawValue().toInt(), 26);
+}
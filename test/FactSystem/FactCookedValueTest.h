@@ -0,0 +1,24 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Checks that the cached cooked value and string of a Fact follow raw value and meta data changes
+class FactCookedValueTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _rawValueChange_test(void);
+    void _translationChange_test(void);
+    void _decimalPlacesChange_test(void);
+    void _valueBlock_test(void);
+};
@@ -14,6 +14,7 @@
 #include "QGCApplication.h"
 #include "ParameterManager.h"
 
+#include <QtCore/QTextStream>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
 
@@ -184,6 +185,48 @@ void ParameterManagerTest::_FTPnoFailure()
     QCOMPARE(arguments.at(0).toFloat(), 0.0f);
 }
 
+void ParameterManagerTest::_bulkWrite(void)
+{
+    Q_ASSERT(!_mockLink);
+    _mockLink = MockLink::startPX4MockLink(false);
+
+    MultiVehicleManager* vehicleMgr = qgcApp()->toolbox()->multiVehicleManager();
+    QVERIFY(vehicleMgr);
+
+    QSignalSpy spyParamsReady(vehicleMgr, SIGNAL(parameterReadyVehicleAvailableChanged(bool)));
+    QCOMPARE(spyParamsReady.wait(60000), true);
+    Vehicle* vehicle = vehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    ParameterManager* paramMgr = vehicle->parameterManager();
+
+    // Change all float parameters of the autopilot, more than fit in the write window
+    QString paramFile;
+    QStringList changedParams;
+    QTextStream outStream(&paramFile);
+    for (const QString& paramName: paramMgr->parameterNames(MAV_COMP_ID_AUTOPILOT1)) {
+        Fact* fact = paramMgr->getParameter(MAV_COMP_ID_AUTOPILOT1, paramName);
+        const bool change = fact->type() == FactMetaData::valueTypeFloat;
+        const double value = fact->rawValue().toDouble() + (change ? 1.0 : 0.0);
+        outStream << vehicle->id() << "\t" << MAV_COMP_ID_AUTOPILOT1 << "\t" << paramName << "\t" << QString::number(value, 'g', 9) << "\t" << QString::number(ParameterManager::factTypeToMavType(fact->type())) << "\n";
+        if (change) {
+            changedParams.append(paramName);
+        }
+    }
+    outStream.flush();
+    QVERIFY(changedParams.count() > 10);
+
+    QSignalSpy spyPendingWrites(paramMgr, SIGNAL(pendingWritesChanged(bool)));
+    QTextStream inStream(&paramFile);
+    QCOMPARE(paramMgr->readParametersFromStream(inStream), QString());
+    QCOMPARE(paramMgr->pendingWrites(), true);
+
+    // All writes are acked by the vehicle
+    while (paramMgr->pendingWrites()) {
+        QVERIFY(spyPendingWrites.wait(10000));
+    }
+    QCOMPARE(spyPendingWrites.last().at(0).toBool(), false);
+}
+
 #if 0
 void ParameterManagerTest::_FTPChangeParam()
 {
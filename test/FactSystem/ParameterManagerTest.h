@@ -24,6 +24,7 @@ private slots:
     void _requestListMissingParamSuccess(void);
     void _requestListMissingParamFail(void);
     void _FTPnoFailure(void);
+    void _bulkWrite(void);
     // void _FTPChangeParam(void);
 
 
@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SettingsWriteBackTest.h"
+#include "SettingsWriteBack.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QSettings>
+#include <QtTest/QTest>
+
+void SettingsWriteBackTest::cleanup(void)
+{
+    SettingsWriteBack::instance()->flush();
+
+    QSettings settings;
+    settings.remove(_settingsGroup);
+
+    UnitTest::cleanup();
+}
+
+void SettingsWriteBackTest::_pendingValue_test(void)
+{
+    SettingsWriteBack* const writeBack = SettingsWriteBack::instance();
+
+    writeBack->setValue(_settingsGroup, "Value", 1);
+    writeBack->setValue(_settingsGroup, "Value", 2);
+
+    // Visible through the write-back layer only until flushed
+    QVERIFY(writeBack->hasPendingChanges());
+    QCOMPARE(writeBack->value(_settingsGroup, "Value", 0).toInt(), 2);
+    QVERIFY(!QSettings().contains(QStringLiteral("%1/Value").arg(_settingsGroup)));
+    QVERIFY(QFile::exists(SettingsWriteBack::journalFileName()));
+
+    writeBack->flush();
+
+    QVERIFY(!writeBack->hasPendingChanges());
+    QCOMPARE(QSettings().value(QStringLiteral("%1/Value").arg(_settingsGroup)).toInt(), 2);
+    QCOMPARE(writeBack->value(_settingsGroup, "Value", 0).toInt(), 2);
+    QVERIFY(!QFile::exists(SettingsWriteBack::journalFileName()));
+}
+
+void SettingsWriteBackTest::_flushTimer_test(void)
+{
+    SettingsWriteBack* const writeBack = SettingsWriteBack::instance();
+
+    writeBack->setValue(_settingsGroup, "Value", 3);
+    QVERIFY(writeBack->hasPendingChanges());
+
+    QTRY_VERIFY_WITH_TIMEOUT(!writeBack->hasPendingChanges(), SettingsWriteBack::idleFlushMSecs * 3);
+    QCOMPARE(QSettings().value(QStringLiteral("%1/Value").arg(_settingsGroup)).toInt(), 3);
+}
+
+void SettingsWriteBackTest::_journalRecovery_test(void)
+{
+    SettingsWriteBack* const writeBack = SettingsWriteBack::instance();
+
+    writeBack->setValue(_settingsGroup, "First", QStringLiteral("a"));
+    writeBack->setValue(_settingsGroup, "Second", 4.5);
+
+    // Replaying the journal as the next start would, while the changes are still pending
+    writeBack->recoverJournal();
+
+    QSettings settings;
+    settings.beginGroup(_settingsGroup);
+    QCOMPARE(settings.value("First").toString(), QStringLiteral("a"));
+    QCOMPARE(settings.value("Second").toDouble(), 4.5);
+    QVERIFY(!QFile::exists(SettingsWriteBack::journalFileName()));
+
+    // Later changes go to a new journal, not to the removed one
+    writeBack->setValue(_settingsGroup, "Third", 5);
+    QVERIFY(QFile::exists(SettingsWriteBack::journalFileName()));
+    writeBack->flush();
+    QVERIFY(!QFile::exists(SettingsWriteBack::journalFileName()));
+}
@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class SettingsWriteBackTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup(void) final;
+
+    void _pendingValue_test(void);
+    void _flushTimer_test(void);
+    void _journalRecovery_test(void);
+
+private:
+    static constexpr const char* _settingsGroup = "SettingsWriteBackTest";
+};
@@ -86,6 +86,115 @@ void GeoTest::_convertNedToGeoAtOrigin_test()
     QVERIFY(compareDoubles(coord.altitude(), m_origin.altitude()));
 }
 
+void GeoTest::_convertGeoToNedBatch_test()
+{
+    // Includes the origin itself, which the single coordinate version special cases
+    const QList<double> lat = { m_origin.latitude(), 47.364869, 47.5, 46.9, m_origin.latitude() };
+    const QList<double> lon = { m_origin.longitude(), 8.594398, 8.3, 8.9, 8.6 };
+    const QList<double> alt = { 0., 10., -5., 100., 0. };
+    const qsizetype count = lat.count();
+
+    QList<double> x(count), y(count), z(count);
+    QGCGeo::convertGeoToNed(lat.constData(), lon.constData(), alt.constData(), count, m_origin, x.data(), y.data(), z.data());
+
+    for (qsizetype i = 0; i < count; i++) {
+        double expectedX = 0., expectedY = 0., expectedZ = 0.;
+        QGCGeo::convertGeoToNed(QGeoCoordinate(lat[i], lon[i], alt[i]), m_origin, expectedX, expectedY, expectedZ);
+
+        QVERIFY(compareDoubles(x[i], expectedX));
+        QVERIFY(compareDoubles(y[i], expectedY));
+        QVERIFY(compareDoubles(z[i], expectedZ));
+    }
+}
+
+void GeoTest::_convertNedToGeoBatch_test()
+{
+    const QList<double> x = { 0., -1282.58731618, 15000., -8000. };
+    const QList<double> y = { 0., 3490.85591324, -2000., 25000. };
+    const qsizetype count = x.count();
+
+    // Without altitudes
+    QList<double> lat(count), lon(count);
+    QGCGeo::convertNedToGeo(x.constData(), y.constData(), nullptr, count, m_origin, lat.data(), lon.data(), nullptr);
+
+    for (qsizetype i = 0; i < count; i++) {
+        QGeoCoordinate expected;
+        QGCGeo::convertNedToGeo(x[i], y[i], 0, m_origin, expected);
+
+        QVERIFY(compareDoubles(lat[i], expected.latitude(), 1e-9));
+        QVERIFY(compareDoubles(lon[i], expected.longitude(), 1e-9));
+    }
+}
+
+void GeoTest::_distancesFrom_test()
+{
+    const QList<double> lat = { m_origin.latitude(), 47.364869, 47.5, 46.9, 48.0, 47.3764 };
+    const QList<double> lon = { m_origin.longitude(), 8.594398, 8.3, 8.9, 7.0, 8.0 };
+    const qsizetype count = lat.count();
+
+    QList<double> distances(count), azimuths(count);
+    QGCGeo::distancesFrom(m_origin, lat.constData(), lon.constData(), count, distances.data(), azimuths.data());
+
+    for (qsizetype i = 0; i < count; i++) {
+        const QGeoCoordinate coord(lat[i], lon[i]);
+        QVERIFY(compareDoubles(distances[i], m_origin.distanceTo(coord), 1e-6));
+        if (i > 0) {
+            QVERIFY(compareDoubles(azimuths[i], m_origin.azimuthTo(coord), 1e-9));
+        }
+    }
+}
+
+void GeoTest::_localFrame_test()
+{
+    QGCGeo::LocalFrame frame;
+    QVERIFY(!frame.inRange(m_origin));
+
+    frame.setAnchor(m_origin);
+    QVERIFY(frame.isAnchored());
+    QVERIFY(frame.inRange(m_origin.atDistanceAndAzimuth(QGCGeo::LocalFrame::reanchorDistance * 0.9, 30)));
+    QVERIFY(!frame.inRange(m_origin.atDistanceAndAzimuth(QGCGeo::LocalFrame::reanchorDistance * 1.1, 30)));
+
+    // Steps between points anywhere in range of the anchor
+    const QGeoCoordinate from = m_origin.atDistanceAndAzimuth(800, 225);
+    for (const double stepAzimuth: { 0., 45., 135., 200., 359. }) {
+        const QGeoCoordinate to = from.atDistanceAndAzimuth(50, stepAzimuth);
+
+        double fromNorth, fromEast, toNorth, toEast;
+        frame.toLocal(from, fromNorth, fromEast);
+        frame.toLocal(to, toNorth, toEast);
+
+        QVERIFY(compareDoubles(QGCGeo::LocalFrame::distance(fromNorth, fromEast, toNorth, toEast), from.distanceTo(to), 0.05));
+        QVERIFY(compareDoubles(QGCGeo::LocalFrame::azimuth(fromNorth, fromEast, toNorth, toEast), from.azimuthTo(to), 0.05));
+    }
+}
+
+void GeoTest::_simplifyPolygon_test()
+{
+    const QList<QGeoCoordinate> corners = {
+        m_origin,
+        m_origin.atDistanceAndAzimuth(100, 90),
+        m_origin.atDistanceAndAzimuth(100, 90).atDistanceAndAzimuth(100, 180),
+        m_origin.atDistanceAndAzimuth(100, 180),
+    };
+
+    // Densify each edge with vertices zigzagging a few centimeters off the outline
+    QList<QGeoCoordinate> polygon;
+    for (int i = 0; i < corners.count(); i++) {
+        const QGeoCoordinate& from = corners[i];
+        const QGeoCoordinate& to = corners[(i + 1) % corners.count()];
+        const double azimuth = from.azimuthTo(to);
+        polygon.append(from);
+        for (int step = 1; step < 20; step++) {
+            const QGeoCoordinate onEdge = from.atDistanceAndAzimuth(from.distanceTo(to) * step / 20, azimuth);
+            polygon.append(onEdge.atDistanceAndAzimuth(0.05, azimuth + (((step % 2) == 0) ? 90 : -90)));
+        }
+    }
+
+    QCOMPARE(QGCGeo::simplifyPolygon(polygon, 0), polygon);
+    QCOMPARE(QGCGeo::simplifyPolygon(polygon, 0.5), corners);
+    QCOMPARE(QGCGeo::simplifyPolygon(corners, 1000), corners);
+}
+
 void GeoTest::_convertGeoToUTM_test()
 {
     const QGeoCoordinate coord(m_origin);
@@ -31,6 +31,11 @@ private slots:
     void _convertGeoToNedAtOrigin_test(void);
     void _convertNedToGeo_test(void);
     void _convertNedToGeoAtOrigin_test(void);
+    void _convertGeoToNedBatch_test(void);
+    void _convertNedToGeoBatch_test(void);
+    void _distancesFrom_test(void);
+    void _localFrame_test(void);
+    void _simplifyPolygon_test(void);
 
     void _convertGeoToUTM_test(void);
     void _convertUTMToGeo_test(void);
@@ -0,0 +1,112 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ImageProtocolManagerTest.h"
+#include "ImageProtocolManager.h"
+
+#include <QtTest/QTest>
+#include <QtTest/QSignalSpy>
+
+namespace {
+
+constexpr int kWidth = 20;
+constexpr int kHeight = 10;
+constexpr int kPayload = 64;
+constexpr uint16_t kPackets = ((kWidth * kHeight) + kPayload - 1) / kPayload;
+
+QByteArray rawImageBytes()
+{
+    QByteArray bytes(kWidth * kHeight, Qt::Uninitialized);
+    for (qsizetype i = 0; i < bytes.size(); i++) {
+        bytes[i] = static_cast<char>(i & 0xFF);
+    }
+    return bytes;
+}
+
+void sendHandshake(ImageProtocolManager &manager, uint32_t size)
+{
+    mavlink_message_t message;
+    (void) mavlink_msg_data_transmission_handshake_pack(1, MAV_COMP_ID_CAMERA, &message, MAVLINK_DATA_STREAM_IMG_RAW8U, size, kWidth, kHeight, kPackets, kPayload, 100);
+    manager.mavlinkMessageReceived(message);
+}
+
+void sendPacket(ImageProtocolManager &manager, const QByteArray &imageBytes, uint16_t seqnr)
+{
+    uint8_t data[MAVLINK_MSG_ENCAPSULATED_DATA_FIELD_DATA_LEN] = {};
+    const QByteArray chunk = imageBytes.mid(seqnr * kPayload, kPayload);
+    (void) memcpy(data, chunk.constData(), chunk.size());
+
+    mavlink_message_t message;
+    (void) mavlink_msg_encapsulated_data_pack(1, MAV_COMP_ID_CAMERA, &message, seqnr, data);
+    manager.mavlinkMessageReceived(message);
+}
+
+} // namespace
+
+void ImageProtocolManagerTest::_testRawImage()
+{
+    ImageProtocolManager manager;
+    QSignalSpy spyImageReady(&manager, &ImageProtocolManager::imageReady);
+
+    const QByteArray imageBytes = rawImageBytes();
+    sendHandshake(manager, imageBytes.size());
+    for (uint16_t seqnr = 0; seqnr < kPackets; seqnr++) {
+        sendPacket(manager, imageBytes, seqnr);
+    }
+
+    QVERIFY(spyImageReady.wait(1000));
+    const QImage image = spyImageReady.takeFirst().at(0).value<QImage>();
+    QCOMPARE(image.width(), kWidth);
+    QCOMPARE(image.height(), kHeight);
+    QCOMPARE(qGray(image.pixel(0, 0)), 0);
+    QCOMPARE(qGray(image.pixel(5, 1)), kWidth + 5);
+    QCOMPARE(manager.flowImageIndex(), 1u);
+    QCOMPARE(manager.lostPackets(), 0u);
+}
+
+void ImageProtocolManagerTest::_testDuplicatePacket()
+{
+    ImageProtocolManager manager;
+    QSignalSpy spyImageReady(&manager, &ImageProtocolManager::imageReady);
+
+    // A repeated packet must not count towards completion
+    const QByteArray imageBytes = rawImageBytes();
+    sendHandshake(manager, imageBytes.size());
+    for (uint16_t seqnr = 0; seqnr < kPackets - 1; seqnr++) {
+        sendPacket(manager, imageBytes, seqnr);
+        sendPacket(manager, imageBytes, seqnr);
+    }
+    QVERIFY(!spyImageReady.wait(100));
+
+    sendPacket(manager, imageBytes, kPackets - 1);
+    QVERIFY(spyImageReady.wait(1000));
+}
+
+void ImageProtocolManagerTest::_testLostPacket()
+{
+    ImageProtocolManager manager;
+    QSignalSpy spyImageReady(&manager, &ImageProtocolManager::imageReady);
+
+    const QByteArray imageBytes = rawImageBytes();
+    sendHandshake(manager, imageBytes.size());
+    for (uint16_t seqnr = 1; seqnr < kPackets; seqnr++) {
+        sendPacket(manager, imageBytes, seqnr);
+    }
+    QVERIFY(!spyImageReady.wait(100));
+
+    // The next handshake discards the incomplete image
+    sendHandshake(manager, imageBytes.size());
+    QCOMPARE(manager.lostPackets(), 1u);
+
+    for (uint16_t seqnr = 0; seqnr < kPackets; seqnr++) {
+        sendPacket(manager, imageBytes, seqnr);
+    }
+    QVERIFY(spyImageReady.wait(1000));
+    QCOMPARE(manager.flowImageIndex(), 1u);
+}
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class ImageProtocolManagerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    ImageProtocolManagerTest() = default;
+
+private slots:
+    void _testRawImage();
+    void _testDuplicatePacket();
+    void _testLostPacket();
+};
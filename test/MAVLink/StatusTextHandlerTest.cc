@@ -9,6 +9,7 @@
 
 #include "StatusTextHandlerTest.h"
 #include "StatusTextHandler.h"
+#include "StatusTextListModel.h"
 #include <MAVLinkLib.h>
 
 #include <QtTest/QTest>
@@ -48,3 +49,32 @@ void StatusTextHandlerTest::_testHandleTextMessage()
     QCOMPARE(statusTextHandler->getWarningCount(), 0);
     QCOMPARE(statusTextHandler->messageCount(), 0);
 }
+
+void StatusTextHandlerTest::_testMessageHistoryBounded()
+{
+    StatusTextHandler* statusTextHandler = new StatusTextHandler(this);
+    StatusTextListModel* const messages = statusTextHandler->messages();
+    const int capacity = messages->capacity();
+
+    for (int i = 0; i < capacity + 10; i++) {
+        const MAV_SEVERITY severity = (i < 10) ? MAV_SEVERITY_ERROR : MAV_SEVERITY_INFO;
+        statusTextHandler->handleTextMessage(MAV_COMP_ID_USER1, severity, QStringLiteral("Message%1.").arg(i), QString());
+    }
+
+    // The oldest messages are dropped, newest first
+    QCOMPARE(messages->count(), capacity);
+    QCOMPARE(messages->at(0).getText(), QStringLiteral("Message%1.").arg(capacity + 9));
+    QCOMPARE(messages->at(capacity - 1).getText(), QStringLiteral("Message10."));
+    QCOMPARE(messages->severityCount(MAV_SEVERITY_ERROR), 0);
+    QCOMPARE(messages->severityCount(MAV_SEVERITY_INFO), capacity);
+
+    // The formatted history follows the retained messages
+    const QString formatted = statusTextHandler->formattedMessages();
+    QVERIFY(formatted.startsWith(messages->at(0).getFormattedText()));
+    QVERIFY(formatted.endsWith(messages->at(capacity - 1).getFormattedText()));
+    QVERIFY(!formatted.contains(QStringLiteral("Message9.")));
+
+    statusTextHandler->clearMessages();
+    QCOMPARE(messages->count(), 0);
+    QVERIFY(statusTextHandler->formattedMessages().isEmpty());
+}
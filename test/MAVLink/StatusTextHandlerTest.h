@@ -21,4 +21,5 @@ public:
 private slots:
     void _testGetMessageText();
     void _testHandleTextMessage();
+    void _testMessageHistoryBounded();
 };
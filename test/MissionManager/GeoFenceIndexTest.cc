@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GeoFenceIndexTest.h"
+#include "GeoFenceIndex.h"
+#include "GeoFenceBreachMonitor.h"
+
+#include <QtTest/QTest>
+
+QList<QGeoCoordinate> GeoFenceIndexTest::_square(const QGeoCoordinate& center, double halfSide)
+{
+    const QGeoCoordinate north = center.atDistanceAndAzimuth(halfSide, 0);
+    const QGeoCoordinate south = center.atDistanceAndAzimuth(halfSide, 180);
+
+    return QList<QGeoCoordinate>({
+        north.atDistanceAndAzimuth(halfSide, 270),
+        north.atDistanceAndAzimuth(halfSide, 90),
+        south.atDistanceAndAzimuth(halfSide, 90),
+        south.atDistanceAndAzimuth(halfSide, 270),
+    });
+}
+
+void GeoFenceIndexTest::_testPolygonBreach(void)
+{
+    const QGeoCoordinate center(_lat, _lon);
+    const GeoFenceIndex fence({ { _square(center, 500), true } }, {}, true);
+
+    QVERIFY(!fence.isEmpty());
+    QVERIFY(!fence.breached(center));
+    QVERIFY(!fence.breached(center.atDistanceAndAzimuth(450, 45)));
+    QVERIFY(fence.breached(center.atDistanceAndAzimuth(550, 0)));
+    QVERIFY(fence.breached(center.atDistanceAndAzimuth(5000, 200)));
+
+    // Distance to the closest edge, capped at the requested maximum
+    QVERIFY(qAbs(fence.boundaryDistance(center.atDistanceAndAzimuth(480, 90), 100) - 20) < 1);
+    QCOMPARE(fence.boundaryDistance(center, 100), 100.0);
+
+    QVERIFY(GeoFenceIndex().isEmpty());
+    QVERIFY(!GeoFenceIndex().breached(center));
+}
+
+void GeoFenceIndexTest::_testExclusionCircle(void)
+{
+    const QGeoCoordinate center(_lat, _lon);
+    const QGeoCoordinate circleCenter = center.atDistanceAndAzimuth(200, 90);
+    const GeoFenceIndex fence({ { _square(center, 500), true } }, { { circleCenter, 100, false } }, true);
+
+    QVERIFY(!fence.breached(center));
+    QVERIFY(fence.breached(circleCenter));
+    QVERIFY(fence.breached(circleCenter.atDistanceAndAzimuth(90, 0)));
+    QVERIFY(!fence.breached(circleCenter.atDistanceAndAzimuth(110, 0)));
+
+    // Exclusion circle alone, everything outside of it is allowed
+    const GeoFenceIndex exclusionOnly({}, { { circleCenter, 100, false } }, true);
+    QVERIFY(!exclusionOnly.breached(center));
+    QVERIFY(exclusionOnly.breached(circleCenter));
+}
+
+void GeoFenceIndexTest::_testInclusionModes(void)
+{
+    const QGeoCoordinate center(_lat, _lon);
+    const QGeoCoordinate otherCenter = center.atDistanceAndAzimuth(800, 90);
+    const QList<GeoFenceIndex::Polygon_t> polygons = { { _square(center, 500), true }, { _square(otherCenter, 500), true } };
+
+    // Only inside the first square, inside both squares
+    const QGeoCoordinate first = center.atDistanceAndAzimuth(100, 270);
+    const QGeoCoordinate both = center.atDistanceAndAzimuth(400, 90);
+
+    const GeoFenceIndex allRequired(polygons, {}, true);
+    QVERIFY(allRequired.breached(first));
+    QVERIFY(!allRequired.breached(both));
+
+    const GeoFenceIndex anyAllowed(polygons, {}, false);
+    QVERIFY(!anyAllowed.breached(first));
+    QVERIFY(!anyAllowed.breached(both));
+    QVERIFY(anyAllowed.breached(otherCenter.atDistanceAndAzimuth(600, 90)));
+}
+
+void GeoFenceIndexTest::_testBreachingSegments(void)
+{
+    const QGeoCoordinate center(_lat, _lon);
+    const QGeoCoordinate circleCenter = center.atDistanceAndAzimuth(200, 0);
+    const GeoFenceIndex fence({ { _square(center, 500), true } }, { { circleCenter, 50, false } }, true);
+
+    // Legs: through the exclusion circle, clear, out of the square, back in
+    const QList<QGeoCoordinate> path = {
+        circleCenter.atDistanceAndAzimuth(150, 270),
+        circleCenter.atDistanceAndAzimuth(150, 90),
+        center.atDistanceAndAzimuth(300, 180),
+        center.atDistanceAndAzimuth(700, 180),
+        center,
+    };
+
+    QCOMPARE(fence.breachingSegments(path), QList<int>({ 0, 2, 3 }));
+    QVERIFY(!fence.segmentInside(path[0], path[1]));
+    QVERIFY(fence.segmentInside(path[1], path[2]));
+
+    // Both ends inside, the leg cuts across the notch of a concave polygon
+    const QList<QGeoCoordinate> notched = {
+        center.atDistanceAndAzimuth(500, 315),
+        center.atDistanceAndAzimuth(100, 180),
+        center.atDistanceAndAzimuth(500, 45),
+        center.atDistanceAndAzimuth(500, 135),
+        center.atDistanceAndAzimuth(500, 225),
+    };
+    const GeoFenceIndex notchedFence({ { notched, true } }, {}, true);
+    const QGeoCoordinate left = center.atDistanceAndAzimuth(300, 270);
+    const QGeoCoordinate right = center.atDistanceAndAzimuth(300, 90);
+    QVERIFY(!notchedFence.breached(left));
+    QVERIFY(!notchedFence.breached(right));
+    QVERIFY(!notchedFence.segmentInside(left, right));
+}
+
+void GeoFenceIndexTest::_testBreachMonitor(void)
+{
+    const QGeoCoordinate center(_lat, _lon);
+
+    GeoFenceBreachMonitor::VehicleState_t vehicle;
+    vehicle.vehicleId = 1;
+    vehicle.fence = QSharedPointer<const GeoFenceIndex>::create(QList<GeoFenceIndex::Polygon_t>({ { _square(center, 500), true } }), QList<GeoFenceIndex::Circle_t>(), true);
+
+    vehicle.coordinate = center;
+    QCOMPARE(GeoFenceBreachMonitor::evaluate(vehicle).state, GeoFenceBreachMonitor::BreachNone);
+
+    vehicle.coordinate = center.atDistanceAndAzimuth(600, 90);
+    QCOMPARE(GeoFenceBreachMonitor::evaluate(vehicle).state, GeoFenceBreachMonitor::BreachActive);
+
+    // Heading for the east edge 400 meters away at 20 m/s
+    vehicle.coordinate = center.atDistanceAndAzimuth(100, 90);
+    vehicle.groundSpeed = 20;
+    vehicle.heading = 90;
+    GeoFenceBreachMonitor::Breach_t breach = GeoFenceBreachMonitor::evaluate(vehicle);
+    QCOMPARE(breach.state, GeoFenceBreachMonitor::BreachPredicted);
+    QVERIFY(qAbs(breach.timeToBreach - 20) < 1);
+
+    // Close to the edge while flying away from it
+    vehicle.coordinate = center.atDistanceAndAzimuth(470, 90);
+    vehicle.heading = 270;
+    breach = GeoFenceBreachMonitor::evaluate(vehicle);
+    QCOMPARE(breach.state, GeoFenceBreachMonitor::BreachProximity);
+    QVERIFY(qAbs(breach.boundaryDistance - 30) < 1);
+
+    vehicle.fence.reset();
+    QCOMPARE(GeoFenceBreachMonitor::evaluate(vehicle).state, GeoFenceBreachMonitor::BreachNone);
+}
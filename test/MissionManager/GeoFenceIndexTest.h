@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtPositioning/QGeoCoordinate>
+
+class GeoFenceIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testPolygonBreach(void);
+    void _testExclusionCircle(void);
+    void _testInclusionModes(void);
+    void _testBreachingSegments(void);
+    void _testBreachMonitor(void);
+
+private:
+    /// @return Square with sides of 2 * halfSide meters around center
+    static QList<QGeoCoordinate> _square(const QGeoCoordinate& center, double halfSide);
+
+    static constexpr double _lat = 47.633;
+    static constexpr double _lon = -122.089;
+};
@@ -232,6 +232,104 @@ void MissionControllerTest::_testVehicleYawRecalc(void)
     }
 }
 
+MissionControllerTest::FlightStatusResult_t MissionControllerTest::_flightStatusResult(void)
+{
+    const MissionController::MissionFlightStatus_t& status = _missionController->_missionFlightStatus;
+
+    FlightStatusResult_t result;
+    result.totalDistance        = status.totalDistance;
+    result.totalTime            = status.totalTime;
+    result.hoverDistance        = status.hoverDistance;
+    result.hoverTime            = status.hoverTime;
+    result.cruiseDistance       = status.cruiseDistance;
+    result.cruiseTime           = status.cruiseTime;
+    result.maxTelemetryDistance = status.maxTelemetryDistance;
+    result.hoverAmpsTotal       = status.hoverAmpsTotal;
+    result.cruiseAmpsTotal      = status.cruiseAmpsTotal;
+    result.batteryChangePoint   = status.batteryChangePoint;
+    result.batteriesRequired    = status.batteriesRequired;
+    for (int i=0; i<_missionController->visualItems()->count(); i++) {
+        VisualMissionItem* visualItem = _missionController->visualItems()->value<VisualMissionItem*>(i);
+        result.itemDistances.append(visualItem->distance());
+        result.itemDistancesFromStart.append(visualItem->distanceFromStart());
+        result.itemAltDifferences.append(visualItem->altDifference());
+        result.itemAzimuths.append(visualItem->azimuth());
+    }
+
+    return result;
+}
+
+void MissionControllerTest::_compareFlightStatus(const FlightStatusResult_t& actual, const FlightStatusResult_t& expected, bool compareBattery)
+{
+    QCOMPARE(actual.totalDistance,          expected.totalDistance);
+    QCOMPARE(actual.totalTime,              expected.totalTime);
+    QCOMPARE(actual.hoverDistance,          expected.hoverDistance);
+    QCOMPARE(actual.hoverTime,              expected.hoverTime);
+    QCOMPARE(actual.cruiseDistance,         expected.cruiseDistance);
+    QCOMPARE(actual.cruiseTime,             expected.cruiseTime);
+    QCOMPARE(actual.maxTelemetryDistance,   expected.maxTelemetryDistance);
+    QCOMPARE(actual.itemDistances,          expected.itemDistances);
+    QCOMPARE(actual.itemDistancesFromStart, expected.itemDistancesFromStart);
+    QCOMPARE(actual.itemAltDifferences,     expected.itemAltDifferences);
+    QCOMPARE(actual.itemAzimuths,           expected.itemAzimuths);
+    if (compareBattery) {
+        QCOMPARE(actual.hoverAmpsTotal,         expected.hoverAmpsTotal);
+        QCOMPARE(actual.cruiseAmpsTotal,        expected.cruiseAmpsTotal);
+        QCOMPARE(actual.batteryChangePoint,     expected.batteryChangePoint);
+        QCOMPARE(actual.batteriesRequired,      expected.batteriesRequired);
+    }
+}
+
+void MissionControllerTest::_testIncrementalFlightStatus(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    const int cMissionItems = 6;
+    QGeoCoordinate currentCoord(47.3977419, 8.5455938);
+    for (int i=1; i<=cMissionItems; i++) {
+        _missionController->insertSimpleMissionItem(currentCoord, i);
+        currentCoord = currentCoord.atDistanceAndAzimuth(400 + (i * 150), i * 50);
+    }
+    QTest::qWait(100); // Recalcs in MissionController are queued to remove dups. Allow return to main message loop.
+
+    QCOMPARE(_missionController->_flightStatusCheckpoints.count(), _missionController->visualItems()->count());
+
+    // The offline vehicle has no battery data, so battery consumption is fed in through the state saved before the
+    // first waypoint. Every walk from there on carries it, an incremental walk through the later checkpoints too.
+    const int batteryIndex = 1;
+    MissionController::MissionFlightStatus_t& batteryStatus = _missionController->_flightStatusCheckpoints[batteryIndex].missionFlightStatus;
+    batteryStatus.mAhBattery            = 5000;
+    batteryStatus.hoverAmps             = 20;
+    batteryStatus.cruiseAmps            = 10;
+    batteryStatus.ampMinutesAvailable   = 3;
+    _missionController->_setFlightStatusDirty(batteryIndex);
+    _missionController->_recalcMissionFlightStatus();
+    QVERIFY(_missionController->batteriesRequired() > 0);
+
+    // Edit an item in the middle of the mission
+    const int editIndex = 4;
+    SimpleMissionItem* simpleItem = _missionController->visualItems()->value<SimpleMissionItem*>(editIndex);
+    QVERIFY(simpleItem);
+    simpleItem->setCoordinate(simpleItem->coordinate().atDistanceAndAzimuth(700, 200));
+    simpleItem->altitude()->setRawValue(simpleItem->altitude()->rawValue().toDouble() + 35);
+
+    // Only the edited item and the ones after it are walked again
+    QCOMPARE(_missionController->_flightStatusDirtyIndex, editIndex);
+    _missionController->_recalcMissionFlightStatus();
+    const FlightStatusResult_t incremental = _flightStatusResult();
+    QVERIFY(incremental.batteriesRequired > 0);
+
+    // Full recalc through every item after the battery data was fed in
+    _missionController->_setFlightStatusDirty(batteryIndex);
+    _missionController->_recalcMissionFlightStatus();
+    _compareFlightStatus(incremental, _flightStatusResult(), true /* compareBattery */);
+
+    // Full recalc from the start, which has no battery data
+    _missionController->_setFlightStatusDirty(0);
+    _missionController->_recalcMissionFlightStatus();
+    _compareFlightStatus(incremental, _flightStatusResult(), false /* compareBattery */);
+}
+
 void MissionControllerTest::_testLoadJsonSectionAvailable(void)
 {
     _initForFirmwareType(MAV_AUTOPILOT_PX4);
@@ -34,6 +34,7 @@ private slots:
     void _testGlobalAltMode             (void);
     void _testGimbalRecalc              (void);
     void _testVehicleYawRecalc          (void);
+    void _testIncrementalFlightStatus   (void);
 
 private:
 #if 0
@@ -50,6 +51,28 @@ private:
 #endif
     void _setupVisualItemSignals(VisualMissionItem* visualItem);
 
+    /// Flight status results of a recalc
+    typedef struct {
+        double          totalDistance;
+        double          totalTime;
+        double          hoverDistance;
+        double          hoverTime;
+        double          cruiseDistance;
+        double          cruiseTime;
+        double          maxTelemetryDistance;
+        double          hoverAmpsTotal;
+        double          cruiseAmpsTotal;
+        int             batteryChangePoint;
+        int             batteriesRequired;
+        QList<double>   itemDistances;
+        QList<double>   itemDistancesFromStart;
+        QList<double>   itemAltDifferences;
+        QList<double>   itemAzimuths;
+    } FlightStatusResult_t;
+
+    FlightStatusResult_t    _flightStatusResult     (void);
+    void                    _compareFlightStatus    (const FlightStatusResult_t& actual, const FlightStatusResult_t& expected, bool compareBattery);
+
     // MissiomItems signals
 
     enum {
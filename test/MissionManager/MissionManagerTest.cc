@@ -11,6 +11,9 @@
 #include "MissionManagerTest.h"
 #include "MissionManager.h"
 #include "MultiSignalSpy.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
 
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
@@ -333,6 +336,64 @@ void MissionManagerTest::_testReadFailureHandlingPX4(void)
     _testReadFailureHandlingWorker();
 }
 
+void MissionManagerTest::_setPipelinedTransfer(bool pipelined)
+{
+    qgcApp()->toolbox()->settingsManager()->appSettings()->pipelinedPlanTransfer()->setRawValue(pipelined);
+}
+
+void MissionManagerTest::_testPipelinedReadDroppedRequestsPX4(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+    _setPipelinedTransfer(true);
+
+    typedef struct {
+        const char*                                 failureText;
+        MockLinkMissionItemHandler::FailureMode_t   failureMode;
+        bool                                        shouldFail;
+    } ReadTestCase_t;
+
+    // Several MISSION_REQUEST_INTs are in flight, so a dropped request is only noticed by the timeout
+    static const ReadTestCase_t rgTestCases[] = {
+        { "No Failure",                         MockLinkMissionItemHandler::FailNone,                           false },
+        { "FailReadRequest1FirstResponse",      MockLinkMissionItemHandler::FailReadRequest1FirstResponse,      false },
+        { "FailReadRequest0NoResponse",         MockLinkMissionItemHandler::FailReadRequest0NoResponse,         true },
+        { "FailReadRequest1NoResponse",         MockLinkMissionItemHandler::FailReadRequest1NoResponse,         true },
+    };
+
+    for (size_t i=0; i<sizeof(rgTestCases)/sizeof(rgTestCases[0]); i++) {
+        const ReadTestCase_t* pCase = &rgTestCases[i];
+        qDebug() << "TEST CASE _testPipelinedReadDroppedRequestsPX4" << pCase->failureText;
+        _roundTripItems(pCase->failureMode, MAV_MISSION_ERROR, pCase->shouldFail);
+        _mockLink->resetMissionItemHandler();
+        _multiSpyMissionManager->clearAllSignals();
+    }
+
+    _setPipelinedTransfer(false);
+}
+
+void MissionManagerTest::_testPipelinedTimeoutLimit(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    // A slow link with retries must still give up waiting after the upper limit
+    _missionManager->_pipelinedTransfer = true;
+    _missionManager->_srttMSecs = MissionManager::_maxAdaptiveTimeoutMilliseconds - 1000;
+    _missionManager->_rttVarMSecs = 0;
+    _missionManager->_retryCount = 0;
+    _missionManager->_startAckTimeout(PlanManager::AckMissionItem);
+    QCOMPARE(_missionManager->_ackTimeoutTimer->interval(), MissionManager::_maxAdaptiveTimeoutMilliseconds - 1000);
+
+    _missionManager->_retryCount = 3;
+    _missionManager->_startAckTimeout(PlanManager::AckMissionItem);
+    QCOMPARE(_missionManager->_ackTimeoutTimer->interval(), MissionManager::_maxAdaptiveTimeoutMilliseconds);
+
+    _missionManager->_ackTimeoutTimer->stop();
+    _missionManager->_expectedAck = PlanManager::AckNone;
+    _missionManager->_retryCount = 0;
+    _missionManager->_srttMSecs = -1;
+    _missionManager->_updatePipelinedTransfer();
+}
+
 void MissionManagerTest::_testErrorAckFailureStrings(void)
 {
     _initForFirmwareType(MAV_AUTOPILOT_PX4);
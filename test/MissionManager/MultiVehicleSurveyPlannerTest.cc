@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MultiVehicleSurveyPlannerTest.h"
+#include "MultiVehicleSurveyPlanner.h"
+#include "MissionController.h"
+#include "PlanMasterController.h"
+#include "QGCMapPolygon.h"
+#include "QmlObjectListModel.h"
+#include "SurveyComplexItem.h"
+
+#include <QtTest/QSignalSpy>
+
+MultiVehicleSurveyPlannerTest::MultiVehicleSurveyPlannerTest(void)
+{
+    _polyPoints << QGeoCoordinate(47.635638361473475, -122.09269407980834) <<
+                   QGeoCoordinate(47.635638361473475, -122.08545246602667) <<
+                   QGeoCoordinate(47.63057923872075, -122.08545246602667) <<
+                   QGeoCoordinate(47.63057923872075, -122.09269407980834);
+}
+
+void MultiVehicleSurveyPlannerTest::_testPartitionWeights(void)
+{
+    // Transects run north/south at a grid angle of 0 so the strips are cut east/west
+    const QList<QList<QGeoCoordinate>> partitions = MultiVehicleSurveyPlanner::partitionSurveyArea(_polyPoints, 0, 0, { 1, 3 });
+    QCOMPARE(partitions.count(), 2);
+
+    const double west = _polyPoints[0].longitude();
+    const double width = _polyPoints[1].longitude() - west;
+    QList<double> stripWidths;
+    for (const QList<QGeoCoordinate>& partition: partitions) {
+        QVERIFY(partition.count() >= 3);
+        double minLon = 180;
+        double maxLon = -180;
+        for (const QGeoCoordinate& coord: partition) {
+            minLon = qMin(minLon, coord.longitude());
+            maxLon = qMax(maxLon, coord.longitude());
+        }
+        stripWidths.append(maxLon - minLon);
+    }
+    QVERIFY(qAbs((stripWidths[0] / width) - 0.25) < 0.01);
+    QVERIFY(qAbs((stripWidths[1] / width) - 0.75) < 0.01);
+}
+
+void MultiVehicleSurveyPlannerTest::_testPartitionNoWeights(void)
+{
+    // No capabilities at all splits the area evenly
+    const QList<QList<QGeoCoordinate>> partitions = MultiVehicleSurveyPlanner::partitionSurveyArea(_polyPoints, 45, 10, { 0, 0, 0 });
+    QCOMPARE(partitions.count(), 3);
+    for (const QList<QGeoCoordinate>& partition: partitions) {
+        QVERIFY(partition.count() >= 3);
+    }
+
+    QVERIFY(MultiVehicleSurveyPlanner::partitionSurveyArea(_polyPoints.mid(0, 2), 0, 10, { 1 })[0].isEmpty());
+}
+
+void MultiVehicleSurveyPlannerTest::_testPlans(void)
+{
+    PlanMasterController* const masterController = new PlanMasterController(this);
+    masterController->start();
+    SurveyComplexItem* const survey = qobject_cast<SurveyComplexItem*>(masterController->missionController()->insertComplexMissionItem(SurveyComplexItem::name, _polyPoints[0], 1));
+    QVERIFY(survey);
+    survey->surveyAreaPolygon()->setPath(_polyPoints);
+
+    MultiVehicleSurveyPlanner planner;
+    QSignalSpy completeSpy(&planner, &MultiVehicleSurveyPlanner::planComplete);
+    planner.start(survey, { { 1200, 10 }, { 600, 10 } });
+    QVERIFY(completeSpy.wait(10000));
+
+    QCOMPARE(planner.plans().count(), 2);
+    for (PlanMasterController* const plan: planner.plans()) {
+        QmlObjectListModel* const visualItems = plan->missionController()->visualItems();
+        QCOMPARE(visualItems->count(), 2);
+        SurveyComplexItem* const planSurvey = visualItems->value<SurveyComplexItem*>(1);
+        QVERIFY(planSurvey);
+        QVERIFY(planSurvey->surveyAreaPolygon()->count() >= 3);
+        QVERIFY(planSurvey->visualTransectPoints().count() > 0);
+        QCOMPARE(planSurvey->gridAngle()->rawValue(), survey->gridAngle()->rawValue());
+    }
+
+    delete masterController;
+}
@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtPositioning/QGeoCoordinate>
+
+class MultiVehicleSurveyPlannerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MultiVehicleSurveyPlannerTest(void);
+
+private slots:
+    void _testPartitionWeights(void);
+    void _testPartitionNoWeights(void);
+    void _testPlans(void);
+
+private:
+    QList<QGeoCoordinate> _polyPoints;
+};
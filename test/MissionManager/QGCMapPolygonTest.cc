@@ -13,6 +13,8 @@
 #include "MultiSignalSpy.h"
 #include "QmlObjectListModel.h"
 
+#include <QtTest/QSignalSpy>
+
 QGCMapPolygonTest::QGCMapPolygonTest(void)
 {
     _polyPoints << QGeoCoordinate(47.635638361473475, -122.09269407980834 ) <<
@@ -223,6 +225,23 @@ void QGCMapPolygonTest::_testKMLLoad(void)
     checkExpectedMessageBox();
 }
 
+void QGCMapPolygonTest::_testKMLLoadAsync(void)
+{
+    QSignalSpy completeSpy(_mapPolygon, &QGCMapPolygon::loadKMLOrSHPFileComplete);
+
+    _mapPolygon->loadKMLOrSHPFileAsync(QStringLiteral(":/unittest/PolygonGood.kml"));
+    QVERIFY(completeSpy.wait());
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), true);
+    QCOMPARE(_mapPolygon->count(), 4);
+    QCOMPARE(_pathModel->count(), 4);
+
+    setExpectedMessageBox(QMessageBox::Ok);
+    _mapPolygon->loadKMLOrSHPFileAsync(QStringLiteral(":/unittest/PolygonBadXml.kml"));
+    QVERIFY(completeSpy.wait());
+    QCOMPARE(completeSpy.takeFirst()[0].toBool(), false);
+    checkExpectedMessageBox();
+}
+
 void QGCMapPolygonTest::_testSelectVertex(void)
 {
     // Create polygon
@@ -337,3 +356,50 @@ void QGCMapPolygonTest::_testSegmentSplit(void)
     QVERIFY(_mapPolygon->count() == 14);
     QVERIFY(_mapPolygon->selectedVertex() == _mapPolygon->count()-2);
 }
+
+void QGCMapPolygonTest::_testIncrementalUpdate(void)
+{
+    _mapPolygon->appendVertices(_polyPoints);
+
+    // Prime the planar cache, then move vertices one at a time
+    QVERIFY(_mapPolygon->area() > 0);
+    QList<QGeoCoordinate> movedPoints = _polyPoints;
+    movedPoints[2] = movedPoints[2].atDistanceAndAzimuth(50, 135);
+    _mapPolygon->adjustVertex(2, movedPoints[2]);
+    movedPoints[0] = movedPoints[0].atDistanceAndAzimuth(30, 315);
+    _mapPolygon->adjustVertex(0, movedPoints[0]);
+    _mapPolygon->splitPolygonSegment(1);
+    movedPoints.insert(2, _mapPolygon->vertexCoordinate(2));
+
+    // Results must match a polygon built from scratch with the same vertices
+    QGCMapPolygon freshPolygon;
+    freshPolygon.appendVertices(movedPoints);
+
+    QCOMPARE(_mapPolygon->coordinateList(), movedPoints);
+    QCOMPARE(_mapPolygon->path().count(), movedPoints.count());
+    QCOMPARE(_mapPolygon->path()[2].value<QGeoCoordinate>(), movedPoints[2]);
+    QVERIFY(qAbs(_mapPolygon->area() - freshPolygon.area()) < 0.01);
+    QVERIFY(_mapPolygon->center().distanceTo(freshPolygon.center()) < 0.01);
+    QVERIFY(_mapPolygon->containsCoordinate(freshPolygon.center()));
+    QVERIFY(!_mapPolygon->containsCoordinate(movedPoints[2].atDistanceAndAzimuth(10, 135)));
+}
+
+void QGCMapPolygonTest::_testOffset(void)
+{
+    _mapPolygon->appendVertices(_polyPoints);
+
+    QGCMapPolygon collinearPolygon;
+    collinearPolygon.appendVertices(_polyPoints);
+    collinearPolygon.splitPolygonSegment(0);
+    collinearPolygon.appendVertex(_polyPoints.last());  // Repeated vertex
+
+    const double originalArea = _mapPolygon->area();
+    _mapPolygon->offset(10);
+    collinearPolygon.offset(10);
+
+    // Collinear and repeated vertices must not make the offset fail
+    QCOMPARE(_mapPolygon->count(), _polyPoints.count());
+    QCOMPARE(collinearPolygon.count(), _polyPoints.count() + 1);
+    QVERIFY(qAbs(_mapPolygon->area() - originalArea) > 1000);
+    QVERIFY(qAbs(_mapPolygon->area() - collinearPolygon.area()) < 1.0);
+}
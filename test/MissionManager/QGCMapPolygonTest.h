@@ -30,8 +30,11 @@ private slots:
     void _testDirty(void);
     void _testVertexManipulation(void);
     void _testKMLLoad(void);
+    void _testKMLLoadAsync(void);
     void _testSelectVertex(void);
     void _testSegmentSplit(void);
+    void _testIncrementalUpdate(void);
+    void _testOffset(void);
 
 private:
     enum {
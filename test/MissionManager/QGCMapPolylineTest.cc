@@ -238,3 +238,22 @@ void QGCMapPolylineTest::_testSelectVertex(void)
     _mapPolyline->removeVertex(0);
     QVERIFY(_mapPolyline->selectedVertex() == _mapPolyline->count() - 1);
 }
+
+void QGCMapPolylineTest::_testOffsetPolyline(void)
+{
+    _mapPolyline->appendVertices(_linePoints);
+
+    // Offsetting a polyline converted once must match offsetting the polyline itself
+    const QList<QPointF> nedPolyline = QGCMapPolyline::nedPolyline(_linePoints);
+    QCOMPARE(nedPolyline, _mapPolyline->nedPolyline());
+
+    for (const double distance: { 0.0, 25.0, -40.0 }) {
+        const QList<QGeoCoordinate> offsetPolyline = _mapPolyline->offsetPolyline(distance);
+        QCOMPARE(QGCMapPolyline::offsetPolyline(nedPolyline, _linePoints.first(), distance), offsetPolyline);
+        QCOMPARE(offsetPolyline.count(), _linePoints.count());
+    }
+
+    // The first vertex moves sideways by the offset distance
+    const QList<QGeoCoordinate> offsetPolyline = _mapPolyline->offsetPolyline(25);
+    QVERIFY(qAbs(offsetPolyline.first().distanceTo(_linePoints.first()) - 25.0) < 0.1);
+}
@@ -31,6 +31,7 @@ private slots:
     void _testVertexManipulation(void);
 //    void _testKMLLoad(void);
     void _testSelectVertex(void);
+    void _testOffsetPolyline(void);
 
 private:
     enum {
@@ -166,6 +166,15 @@ void TransectStyleComplexItemTest::_testRebuildTransects(void)
     //QVERIFY(_transectStyleItem->recalcComplexDistanceCalled);
     QVERIFY(_multiSpy->checkSignalsByMask(lastSequenceNumberChangedMask));
     _multiSpy->clearAllSignals();
+
+    // Without hover and capture a new trigger distance only changes the camera shots, the transects stay as is
+    _transectStyleItem->hoverAndCapture()->setRawValue(false);
+    _transectStyleItem->rebuildTransectsPhase1Called = false;
+    _transectStyleItem->recalcCameraShotsCalled = false;
+    changeFactValue(_transectStyleItem->cameraCalc()->frontalOverlap());
+    QVERIFY(!_transectStyleItem->rebuildTransectsPhase1Called);
+    QVERIFY(_transectStyleItem->recalcCameraShotsCalled);
+    _multiSpy->clearAllSignals();
 }
 
 void TransectStyleComplexItemTest::_testDistanceSignalling(void)
@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GCSMotionEstimatorTest.h"
+#include "GCSMotionEstimator.h"
+
+#include <QtTest/QTest>
+
+namespace {
+    const QGeoCoordinate origin(47.3977420, 8.5455941, 488.);
+}
+
+void GCSMotionEstimatorTest::_constantVelocityTest()
+{
+    // Boat heading east at 10 m/s, 10 Hz fixes
+    GCSMotionEstimator estimator;
+    QVERIFY(!estimator.estimate(0).valid);
+
+    for (int i = 0; i <= 50; i++) {
+        const qint64 msecs = i * 100;
+        estimator.updatePosition(msecs, origin.atDistanceAndAzimuth(i, 90.), 2., 3.);
+    }
+
+    const GCSMotionEstimator::Estimate_t estimate = estimator.estimate(5000);
+    QVERIFY(estimate.valid);
+    QVERIFY(estimate.altitudeValid);
+    QVERIFY(qAbs(estimate.velocity[0]) < 0.5);
+    QVERIFY(qAbs(estimate.velocity[1] - 10.) < 0.5);
+    QVERIFY(qAbs(estimate.velocity[2]) < 0.5);
+    QVERIFY(estimate.coordinate.distanceTo(origin.atDistanceAndAzimuth(50., 90.)) < 1.);
+
+    // Half a second past the last fix the position moved on with the boat
+    const GCSMotionEstimator::Estimate_t ahead = estimator.estimate(5500);
+    QCOMPARE(ahead.timestampMsecs, static_cast<qint64>(5500));
+    QVERIFY(ahead.coordinate.distanceTo(origin.atDistanceAndAzimuth(55., 90.)) < 1.);
+    QVERIFY(GCSMotionEstimator::extrapolate(estimate, 5500).coordinate.distanceTo(ahead.coordinate) < 0.01);
+}
+
+void GCSMotionEstimatorTest::_accelerationTest()
+{
+    // Accelerating north at 2 m/s/s from standstill, with ground speed reports
+    GCSMotionEstimator estimator;
+    for (int i = 0; i <= 40; i++) {
+        const double t = i * 0.1;
+        const qint64 msecs = i * 100;
+        estimator.updatePosition(msecs, origin.atDistanceAndAzimuth(t * t, 0.), 1., qQNaN());
+        estimator.updateVelocity(msecs, 2. * t, 0, qQNaN());
+    }
+
+    const GCSMotionEstimator::Estimate_t estimate = estimator.estimate(4000);
+    QVERIFY(qAbs(estimate.velocity[0] - 8.) < 0.5);
+    QVERIFY(qAbs(estimate.acceleration[0] - 2.) < 0.5);
+    QVERIFY(qAbs(estimate.acceleration[1]) < 0.5);
+}
+
+void GCSMotionEstimatorTest::_resetAfterGapTest()
+{
+    GCSMotionEstimator estimator;
+    for (int i = 0; i <= 20; i++) {
+        estimator.updatePosition(i * 100, origin.atDistanceAndAzimuth(i, 0.), 2., qQNaN());
+    }
+    QVERIFY(estimator.estimate(2000).velocity[0] > 5.);
+
+    // A fix long after the last one starts over instead of blending with a stale track
+    const QGeoCoordinate later = origin.atDistanceAndAzimuth(100., 180.);
+    estimator.updatePosition(60000, later, 2., qQNaN());
+    const GCSMotionEstimator::Estimate_t estimate = estimator.estimate(60000);
+    QCOMPARE(estimate.velocity[0], 0.);
+    QVERIFY(estimate.coordinate.distanceTo(later) < 0.01);
+}
@@ -0,0 +1,485 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainDemTest.h"
+#include "TerrainDem.h"
+#include "TerrainQueryAirMap.h"
+#include "TerrainTileManager.h"
+#include "QGCGeo.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QtEndian>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    enum FieldType : quint16 {
+        TypeAscii =     2,
+        TypeShort =     3,
+        TypeLong =      4,
+        TypeDouble =    12,
+    };
+
+    struct Entry_t {
+        quint16 tag;
+        quint16 type;
+        QList<double> values;
+    };
+
+    /// Minimal TIFF writer, just enough to lay out the images of the tests
+    class TiffWriter
+    {
+    public:
+        explicit TiffWriter(bool bigEndian)
+            : _bigEndian(bigEndian)
+        {
+            _data.append(bigEndian ? "MM" : "II");
+            _append16(42);
+            _append32(0);
+        }
+
+        void addImage(QList<Entry_t> entries, bool tiled, const QList<QByteArray> &blocks)
+        {
+            QList<double> offsets;
+            QList<double> byteCounts;
+            for (const QByteArray &block : blocks) {
+                _align();
+                offsets.append(_data.size());
+                byteCounts.append(block.size());
+                _data.append(block);
+            }
+            entries.append({ static_cast<quint16>(tiled ? 324 : 273), TypeLong, offsets });
+            entries.append({ static_cast<quint16>(tiled ? 325 : 279), TypeLong, byteCounts });
+            std::sort(entries.begin(), entries.end(), [](const Entry_t &a, const Entry_t &b) { return a.tag < b.tag; });
+
+            _align();
+            const qsizetype directoryOffset = _data.size();
+            _patch32(_nextDirectoryPointer, static_cast<quint32>(directoryOffset));
+
+            qsizetype valuesOffset = directoryOffset + 2 + (entries.count() * 12) + 4;
+            _append16(static_cast<quint16>(entries.count()));
+            for (const Entry_t &entry : entries) {
+                _append16(entry.tag);
+                _append16(entry.type);
+                _append32(static_cast<quint32>(entry.values.count()));
+                const qsizetype bytes = _typeSize(entry.type) * entry.values.count();
+                if (bytes <= 4) {
+                    for (const double value : entry.values) {
+                        _appendValue(entry.type, value);
+                    }
+                    _data.append(QByteArray(4 - bytes, '\0'));
+                } else {
+                    _append32(static_cast<quint32>(valuesOffset));
+                    valuesOffset += bytes + (bytes & 1);
+                }
+            }
+            _nextDirectoryPointer = _data.size();
+            _append32(0);
+
+            for (const Entry_t &entry : entries) {
+                if ((_typeSize(entry.type) * entry.values.count()) > 4) {
+                    for (const double value : entry.values) {
+                        _appendValue(entry.type, value);
+                    }
+                    _align();
+                }
+            }
+        }
+
+        QByteArray data() const { return _data; }
+
+    private:
+        static qsizetype _typeSize(quint16 type) { return (type == TypeDouble) ? 8 : ((type == TypeLong) ? 4 : ((type == TypeShort) ? 2 : 1)); }
+
+        void _align() { if (_data.size() & 1) { _data.append('\0'); } }
+
+        void _append16(quint16 value)
+        {
+            uchar bytes[2];
+            _bigEndian ? qToBigEndian(value, bytes) : qToLittleEndian(value, bytes);
+            _data.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        }
+
+        void _append32(quint32 value)
+        {
+            uchar bytes[4];
+            _bigEndian ? qToBigEndian(value, bytes) : qToLittleEndian(value, bytes);
+            _data.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        }
+
+        void _appendValue(quint16 type, double value)
+        {
+            switch (type) {
+            case TypeShort:
+                _append16(static_cast<quint16>(value));
+                break;
+            case TypeLong:
+                _append32(static_cast<quint32>(value));
+                break;
+            case TypeDouble: {
+                quint64 bits;
+                memcpy(&bits, &value, sizeof(bits));
+                uchar bytes[8];
+                _bigEndian ? qToBigEndian(bits, bytes) : qToLittleEndian(bits, bytes);
+                _data.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+                break;
+            }
+            default:
+                _data.append(static_cast<char>(value));
+                break;
+            }
+        }
+
+        void _patch32(qsizetype offset, quint32 value)
+        {
+            uchar* const bytes = reinterpret_cast<uchar*>(_data.data()) + offset;
+            _bigEndian ? qToBigEndian(value, bytes) : qToLittleEndian(value, bytes);
+        }
+
+        bool _bigEndian;
+        QByteArray _data;
+        qsizetype _nextDirectoryPointer = 4;
+    };
+
+    QList<Entry_t> imageEntries(quint32 width, quint32 height, quint16 bits, quint16 sampleFormat, quint16 compression, quint16 predictor)
+    {
+        return {
+            { 256, TypeLong, { static_cast<double>(width) } },
+            { 257, TypeLong, { static_cast<double>(height) } },
+            { 258, TypeShort, { static_cast<double>(bits) } },
+            { 259, TypeShort, { static_cast<double>(compression) } },
+            { 277, TypeShort, { 1 } },
+            { 317, TypeShort, { static_cast<double>(predictor) } },
+            { 339, TypeShort, { static_cast<double>(sampleFormat) } },
+        };
+    }
+
+    QList<Entry_t> geoEntries(double scaleX, double scaleY, double originX, double originY, quint16 epsg, bool projected)
+    {
+        return {
+            { 33550, TypeDouble, { scaleX, scaleY, 0 } },
+            { 33922, TypeDouble, { 0, 0, 0, originX, originY, 0 } },
+            { 34735, TypeShort, { 1, 1, 0, 3,
+                                  1024, 0, 1, static_cast<double>(projected ? 1 : 2),
+                                  1025, 0, 1, 1,
+                                  static_cast<double>(projected ? 3072 : 2048), 0, 1, static_cast<double>(epsg) } },
+        };
+    }
+
+    Entry_t noDataEntry(const QByteArray &noData)
+    {
+        Entry_t entry{ 42113, TypeAscii, {} };
+        for (const char c : noData) {
+            entry.values.append(static_cast<uchar>(c));
+        }
+        entry.values.append(0);
+        return entry;
+    }
+
+    /// Zlib stream without the size qCompress puts in front
+    QByteArray deflate(const QByteArray &data)
+    {
+        return qCompress(data).mid(4);
+    }
+
+    /// TIFF LZW with 9 bit codes, the tables of the test data never grow beyond them
+    QByteArray lzw(const QByteArray &data)
+    {
+        QByteArray encoded;
+        quint32 bitBuffer = 0;
+        int bitCount = 0;
+        const auto writeCode = [&](int code) {
+            bitBuffer = (bitBuffer << 9) | static_cast<quint32>(code);
+            bitCount += 9;
+            while (bitCount >= 8) {
+                encoded.append(static_cast<char>((bitBuffer >> (bitCount - 8)) & 0xFF));
+                bitCount -= 8;
+            }
+        };
+
+        QHash<QByteArray, int> table;
+        for (int i = 0; i < 256; i++) {
+            table.insert(QByteArray(1, static_cast<char>(i)), i);
+        }
+        int nextCode = 258;
+
+        writeCode(256);
+        QByteArray string;
+        for (const char c : data) {
+            const QByteArray extended = string + c;
+            if (table.contains(extended)) {
+                string = extended;
+            } else {
+                writeCode(table.value(string));
+                table.insert(extended, nextCode++);
+                string = QByteArray(1, c);
+            }
+        }
+        if (!string.isEmpty()) {
+            writeCode(table.value(string));
+        }
+        writeCode(257);
+        if (bitCount > 0) {
+            encoded.append(static_cast<char>((bitBuffer << (8 - bitCount)) & 0xFF));
+        }
+
+        Q_ASSERT(nextCode < 510);
+        return encoded;
+    }
+
+    QByteArray int16Block(const QList<qint16> &values, bool bigEndian)
+    {
+        QByteArray block(values.count() * 2, Qt::Uninitialized);
+        for (qsizetype i = 0; i < values.count(); i++) {
+            uchar* const bytes = reinterpret_cast<uchar*>(block.data()) + (i * 2);
+            bigEndian ? qToBigEndian(values[i], bytes) : qToLittleEndian(values[i], bytes);
+        }
+        return block;
+    }
+
+    bool writeFile(const QString &fileName, const QByteArray &data)
+    {
+        QFile file(fileName);
+        return file.open(QIODevice::WriteOnly) && (file.write(data) == data.size());
+    }
+
+    double lookup(TerrainDem &dem, const QGeoCoordinate &coordinate, double spacingMeters = 0)
+    {
+        double elevation = qQNaN();
+        (void) dem.elevations(&coordinate, 1, spacingMeters, &elevation);
+        return elevation;
+    }
+
+    constexpr double kGeoScale = 0.001;
+    constexpr double kGeoWest = 10.;
+    constexpr double kGeoNorth = 47.;
+
+    /// Center of a value of the geographic test model, which holds row * 10 + column
+    QGeoCoordinate geoCenter(double column, double row)
+    {
+        return QGeoCoordinate(kGeoNorth - ((row + 0.5) * kGeoScale), kGeoWest + ((column + 0.5) * kGeoScale));
+    }
+}
+
+/// 32 x 32 little endian int16 in 16 x 16 uncompressed tiles, with one value missing
+QString TerrainDemTest::_writeGeographicTiled()
+{
+    static constexpr int kSize = 32;
+    static constexpr int kTileSize = 16;
+
+    QList<QByteArray> tiles;
+    for (int tileRow = 0; tileRow < (kSize / kTileSize); tileRow++) {
+        for (int tileColumn = 0; tileColumn < (kSize / kTileSize); tileColumn++) {
+            QList<qint16> values;
+            for (int row = 0; row < kTileSize; row++) {
+                for (int column = 0; column < kTileSize; column++) {
+                    const int imageRow = (tileRow * kTileSize) + row;
+                    const int imageColumn = (tileColumn * kTileSize) + column;
+                    values.append(((imageRow == 10) && (imageColumn == 10)) ? -9999 : static_cast<qint16>((imageRow * 10) + imageColumn));
+                }
+            }
+            tiles.append(int16Block(values, false));
+        }
+    }
+
+    QList<Entry_t> entries = imageEntries(kSize, kSize, 16, 2, 1, 1);
+    entries.append({ 322, TypeShort, { kTileSize } });
+    entries.append({ 323, TypeShort, { kTileSize } });
+    entries.append(geoEntries(kGeoScale, kGeoScale, kGeoWest, kGeoNorth, 4326, false));
+    entries.append(noDataEntry("-9999"));
+
+    TiffWriter writer(false);
+    writer.addImage(entries, true, tiles);
+
+    const QString fileName = _tempDir.filePath(QStringLiteral("geographic.tif"));
+    return writeFile(fileName, writer.data()) ? fileName : QString();
+}
+
+void TerrainDemTest::_testGeographicTiled()
+{
+    const QString fileName = _writeGeographicTiled();
+    QVERIFY(!fileName.isEmpty());
+
+    TerrainDem dem;
+    QString errorString;
+    QVERIFY2(dem.open(fileName, errorString), qPrintable(errorString));
+    QCOMPARE(dem.levelCount(), 1);
+    QVERIFY(dem.bounds().contains(geoCenter(0, 0)));
+    QVERIFY(qAbs(dem.resolutionMeters() - (kGeoScale * qCos(qDegreesToRadians(kGeoNorth - 0.016)) * 111320.)) < 1.);
+
+    // Values at their centers, interpolated in between, also across tiles
+    QVERIFY(qAbs(lookup(dem, geoCenter(3, 5)) - 53.) < 0.01);
+    QVERIFY(qAbs(lookup(dem, geoCenter(3.5, 5)) - 53.5) < 0.01);
+    QVERIFY(qAbs(lookup(dem, geoCenter(3, 5.5)) - 58.) < 0.01);
+    QVERIFY(qAbs(lookup(dem, geoCenter(15.5, 15.5)) - 170.5) < 0.01);
+
+    // The missing value is left out of the interpolation, on its own there is no elevation
+    QVERIFY(qIsNaN(lookup(dem, geoCenter(10, 10))));
+    QVERIFY(qAbs(lookup(dem, geoCenter(9.5, 10)) - 109.) < 0.01);
+
+    // Outside of the model
+    QVERIFY(qIsNaN(lookup(dem, geoCenter(-2, 5))));
+    QVERIFY(qIsNaN(lookup(dem, geoCenter(5, 40))));
+}
+
+/// 8 x 8 big endian float32 in UTM zone 32N, DEFLATE compressed with the floating point predictor, in strips of 3 rows
+void TerrainDemTest::_testUtmDeflateFloat()
+{
+    static constexpr int kSize = 8;
+    static constexpr int kRowsPerStrip = 3;
+    static constexpr double kEasting = 500000.;
+    static constexpr double kNorthing = 5300000.;
+
+    QList<QByteArray> strips;
+    for (int firstRow = 0; firstRow < kSize; firstRow += kRowsPerStrip) {
+        QByteArray strip;
+        for (int row = firstRow; row < qMin(firstRow + kRowsPerStrip, kSize); row++) {
+            // Bytes of the row are grouped by significance, then differenced
+            QByteArray rowBytes(kSize * 4, Qt::Uninitialized);
+            for (int column = 0; column < kSize; column++) {
+                const float value = 400.f + (column * 0.5f) + (row * 0.25f);
+                quint32 bits;
+                memcpy(&bits, &value, sizeof(bits));
+                for (int byte = 0; byte < 4; byte++) {
+                    rowBytes[(byte * kSize) + column] = static_cast<char>((bits >> (24 - (byte * 8))) & 0xFF);
+                }
+            }
+            for (qsizetype i = rowBytes.size() - 1; i > 0; i--) {
+                rowBytes[i] = static_cast<char>(rowBytes[i] - rowBytes[i - 1]);
+            }
+            strip.append(rowBytes);
+        }
+        strips.append(deflate(strip));
+    }
+
+    QList<Entry_t> entries = imageEntries(kSize, kSize, 32, 3, 8, 3);
+    entries.append({ 278, TypeShort, { kRowsPerStrip } });
+    entries.append(geoEntries(1, 1, kEasting, kNorthing, 32632, true));
+
+    TiffWriter writer(true);
+    writer.addImage(entries, false, strips);
+    const QString fileName = _tempDir.filePath(QStringLiteral("utm.tif"));
+    QVERIFY(writeFile(fileName, writer.data()));
+
+    TerrainDem dem;
+    QString errorString;
+    QVERIFY2(dem.open(fileName, errorString), qPrintable(errorString));
+    QCOMPARE(dem.resolutionMeters(), 1.);
+
+    QGeoCoordinate coordinate;
+    QVERIFY(QGCGeo::convertUTMToGeo(kEasting + 2.5, kNorthing - 4.5, 32, false, coordinate));
+    QVERIFY(qAbs(lookup(dem, coordinate) - 402.) < 0.01);
+
+    // In the last, shorter strip
+    QVERIFY(QGCGeo::convertUTMToGeo(kEasting + 7.5, kNorthing - 7.5, 32, false, coordinate));
+    QVERIFY(qAbs(lookup(dem, coordinate) - 405.25) < 0.01);
+}
+
+/// 8 x 8 int16 LZW compressed with horizontal differencing, plus an uncompressed 4 x 4 overview
+void TerrainDemTest::_testLzwOverview()
+{
+    static constexpr int kSize = 8;
+    static constexpr double kScale = 0.0001;
+
+    QList<qint16> differences;
+    for (int row = 0; row < kSize; row++) {
+        for (int column = 0; column < kSize; column++) {
+            differences.append(static_cast<qint16>((column == 0) ? -100 : 1));
+        }
+    }
+    QList<Entry_t> entries = imageEntries(kSize, kSize, 16, 2, 5, 2);
+    entries.append({ 278, TypeShort, { kSize } });
+    entries.append(geoEntries(kScale, kScale, 0, 1, 4326, false));
+
+    QList<Entry_t> overviewEntries = imageEntries(kSize / 2, kSize / 2, 16, 2, 1, 1);
+    overviewEntries.append({ 254, TypeLong, { 1 } });
+    overviewEntries.append({ 278, TypeShort, { kSize / 2 } });
+
+    TiffWriter writer(false);
+    writer.addImage(entries, false, { lzw(int16Block(differences, false)) });
+    writer.addImage(overviewEntries, false, { int16Block(QList<qint16>((kSize / 2) * (kSize / 2), 5000), false) });
+    const QString fileName = _tempDir.filePath(QStringLiteral("overview.tiff"));
+    QVERIFY(writeFile(fileName, writer.data()));
+
+    TerrainDem dem;
+    QString errorString;
+    QVERIFY2(dem.open(fileName, errorString), qPrintable(errorString));
+    QCOMPARE(dem.levelCount(), 2);
+
+    // Full resolution values run from -100 at the west edge, the overview only holds 5000
+    const QGeoCoordinate coordinate(1 - (2.5 * kScale), 3.5 * kScale);
+    QVERIFY(qAbs(lookup(dem, coordinate) + 97.) < 0.01);
+    QVERIFY(qAbs(lookup(dem, coordinate, dem.resolutionMeters() * 3) - 5000.) < 0.01);
+}
+
+void TerrainDemTest::_testInvalidFile()
+{
+    const QString fileName = _tempDir.filePath(QStringLiteral("invalid.tif"));
+    QVERIFY(writeFile(fileName, QByteArray(64, 'x')));
+
+    TerrainDem dem;
+    QString errorString;
+    QVERIFY(!dem.open(fileName, errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    // Image without georeferencing
+    TiffWriter writer(false);
+    writer.addImage(imageEntries(2, 2, 16, 2, 1, 1), false, { int16Block({ 1, 2, 3, 4 }, false) });
+    QVERIFY(writeFile(fileName, writer.data()));
+    TerrainDem unreferencedDem;
+    QVERIFY(!unreferencedDem.open(fileName, errorString));
+
+    QVERIFY(TerrainDem::isDemFile(QStringLiteral("site.TIF")));
+    QVERIFY(!TerrainDem::isDemFile(QStringLiteral("site.qgcterrain")));
+}
+
+void TerrainDemTest::_testTileManager()
+{
+    const QString fileName = _writeGeographicTiled();
+    QVERIFY(!fileName.isEmpty());
+
+    TerrainTileManager* const manager = TerrainTileManager::instance();
+    QString errorString;
+    QVERIFY2(manager->loadTerrainDem(fileName, errorString), qPrintable(errorString));
+
+    QList<double> elevations;
+    QVERIFY(manager->cachedElevations({ geoCenter(3, 5), geoCenter(20, 30) }, elevations));
+    QCOMPARE(elevations.count(), 2);
+    QVERIFY(qAbs(elevations[0] - 53.) < 0.01);
+    QVERIFY(qAbs(elevations[1] - 320.) < 0.01);
+
+    // Covered by the model, so answered right away
+    TerrainOfflineAirMapQuery query;
+    QSignalSpy carpetSpy(&query, &TerrainQueryInterface::carpetHeightsReceived);
+    query.requestCarpetHeights(geoCenter(12, 20), geoCenter(20, 4), false);
+    QCOMPARE(carpetSpy.count(), 1);
+    const QVariantList arguments = carpetSpy.takeFirst();
+    QVERIFY(arguments.at(0).toBool());
+    QVERIFY(qAbs(arguments.at(1).toDouble() - 52.) < 0.01);
+    QVERIFY(qAbs(arguments.at(2).toDouble() - 220.) < 0.01);
+    const QList<QList<double>> carpet = arguments.at(3).value<QList<QList<double>>>();
+    QVERIFY(!carpet.isEmpty());
+    QVERIFY(qAbs(carpet.first().first() - 212.) < 0.01);
+    QVERIFY(qAbs(carpet.last().last() - 60.) < 0.01);
+
+    QSignalSpy pathSpy(&query, &TerrainQueryInterface::pathHeightsReceived);
+    query.requestPathHeights(geoCenter(2, 5), geoCenter(8, 5));
+    QCOMPARE(pathSpy.count(), 1);
+    QVERIFY(pathSpy.first().at(0).toBool());
+    const QList<double> heights = pathSpy.first().at(3).value<QList<double>>();
+    QVERIFY(heights.count() >= 2);
+    QVERIFY(qAbs(heights.first() - 52.) < 0.01);
+    QVERIFY(qAbs(heights.last() - 58.) < 0.01);
+
+    manager->unloadTerrainPacks();
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtCore/QTemporaryDir>
+
+/// Reads GeoTIFF elevation models written by the test in the layouts and encodings TerrainDem supports
+class TerrainDemTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testGeographicTiled();
+    void _testUtmDeflateFloat();
+    void _testLzwOverview();
+    void _testInvalidFile();
+    void _testTileManager();
+
+private:
+    QString _writeGeographicTiled();
+
+    QTemporaryDir _tempDir;
+};
@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainPackTest.h"
+#include "TerrainPack.h"
+#include "TerrainTileCopernicus.h"
+#include "TerrainTileManager.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QRandomGenerator>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <cmath>
+
+namespace {
+    constexpr double kTileSize = TerrainTileCopernicus::tileSizeDegrees;
+
+    /// Tile indices as CopernicusElevationProvider computes them
+    int tileX(double longitude) { return static_cast<int>(std::floor((longitude + 180.0) / kTileSize)); }
+    int tileY(double latitude) { return static_cast<int>(std::floor((latitude + 90.0) / kTileSize)); }
+    quint64 tileId(int x, int y) { return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y); }
+
+    /// Serialized Copernicus tile with elevations rising from baseElevation
+    QByteArray tileData(int x, int y, int baseElevation)
+    {
+        constexpr int gridSize = 37;
+        const double swLat = (y * kTileSize) - 90.0;
+        const double swLon = (x * kTileSize) - 180.0;
+
+        QJsonArray carpet;
+        for (int row = 0; row < gridSize; row++) {
+            QJsonArray values;
+            for (int column = 0; column < gridSize; column++) {
+                values.append(baseElevation + row + column);
+            }
+            carpet.append(values);
+        }
+        const QJsonObject data {
+            { "bounds", QJsonObject { { "sw", QJsonArray { swLat, swLon } }, { "ne", QJsonArray { swLat + kTileSize, swLon + kTileSize } } } },
+            { "stats", QJsonObject { { "min", baseElevation }, { "max", baseElevation + (2 * (gridSize - 1)) }, { "avg", baseElevation + gridSize - 1 } } },
+            { "carpet", carpet },
+        };
+        const QJsonObject root { { "status", "success" }, { "data", data } };
+
+        return TerrainTileCopernicus::serializeFromJson(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    }
+}
+
+void TerrainPackTest::_testWriteOpen()
+{
+    QVERIFY(_tempDir.isValid());
+
+    QMap<quint64, QByteArray> tiles;
+    tiles.insert(tileId(10, 20), tileData(10, 20, 100));
+    tiles.insert(tileId(11, 20), tileData(11, 20, 200));
+    tiles.insert(tileId(10, 21), tileData(10, 21, 300));
+    // Incompressible, so it is stored as is even when compressing
+    QByteArray noise(4096, Qt::Uninitialized);
+    QRandomGenerator random(1);
+    for (qsizetype i = 0; i < noise.size(); i++) {
+        noise[i] = static_cast<char>(random.bounded(256));
+    }
+    tiles.insert(tileId(12, 20), noise);
+
+    for (const bool compress : { false, true }) {
+        const QString fileName = _tempDir.filePath(QStringLiteral("write%1.%2").arg(compress).arg(TerrainPack::fileExtension));
+        QString errorString;
+        QVERIFY2(TerrainPack::write(fileName, tiles, compress, errorString), qPrintable(errorString));
+
+        TerrainPack pack;
+        QVERIFY2(pack.open(fileName, errorString), qPrintable(errorString));
+        QCOMPARE(pack.tileCount(), tiles.count());
+        for (auto it = tiles.constBegin(); it != tiles.constEnd(); it++) {
+            QVERIFY(pack.contains(it.key()));
+            QCOMPARE(pack.tileData(it.key()), it.value());
+        }
+        QVERIFY(!pack.contains(tileId(13, 20)));
+        QVERIFY(pack.tileData(tileId(13, 20)).isEmpty());
+    }
+}
+
+void TerrainPackTest::_testInvalidFile()
+{
+    QVERIFY(_tempDir.isValid());
+
+    QMap<quint64, QByteArray> tiles;
+    tiles.insert(tileId(10, 20), tileData(10, 20, 100));
+    tiles.insert(tileId(11, 20), tileData(11, 20, 200));
+
+    const QString fileName = _tempDir.filePath(QStringLiteral("invalid.%1").arg(TerrainPack::fileExtension));
+    QString errorString;
+    QVERIFY2(TerrainPack::write(fileName, tiles, false, errorString), qPrintable(errorString));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint64 size = file.size();
+
+    // Tile data cut off
+    QVERIFY(file.resize(size - 16));
+    file.close();
+    TerrainPack truncatedPack;
+    QVERIFY(!truncatedPack.open(fileName, errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    // Not a pack at all
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    (void) file.write(QByteArray(64, 'x'));
+    file.close();
+    TerrainPack garbagePack;
+    QVERIFY(!garbagePack.open(fileName, errorString));
+}
+
+void TerrainPackTest::_testExportRoundTrip()
+{
+    QVERIFY(_tempDir.isValid());
+
+    // Southern ocean, away from the areas other terrain tests use
+    const QGeoCoordinate coordinate(-62.345, -141.235);
+    const int x = tileX(coordinate.longitude());
+    const int y = tileY(coordinate.latitude());
+    const QByteArray sourceData = tileData(x, y, 500);
+    QVERIFY(!sourceData.isEmpty());
+
+    QMap<quint64, QByteArray> tiles;
+    tiles.insert(tileId(x, y), sourceData);
+    const QString sourceFileName = _tempDir.filePath(QStringLiteral("source.%1").arg(TerrainPack::fileExtension));
+    QString errorString;
+    // Uncompressed, so the tile the manager caches references the pack mapping
+    QVERIFY2(TerrainPack::write(sourceFileName, tiles, false, errorString), qPrintable(errorString));
+
+    TerrainTileManager* const manager = TerrainTileManager::instance();
+    QVERIFY2(manager->loadTerrainPack(sourceFileName, errorString), qPrintable(errorString));
+
+    QList<double> elevations;
+    QVERIFY(manager->cachedElevations({ coordinate }, elevations));
+    QCOMPARE(elevations.count(), 1);
+    QVERIFY(!std::isnan(elevations.first()));
+
+    const QString exportFileName = _tempDir.filePath(QStringLiteral("export.%1").arg(TerrainPack::fileExtension));
+    QSignalSpy exportSpy(manager, &TerrainTileManager::terrainPackExported);
+    QVERIFY2(manager->exportTerrainPack(exportFileName, coordinate, coordinate, errorString), qPrintable(errorString));
+
+    // The export is written later, it must not depend on the source pack still being mapped
+    manager->unloadTerrainPacks();
+
+    QVERIFY(exportSpy.wait(5000));
+    QCOMPARE(exportSpy.count(), 1);
+    QCOMPARE(exportSpy.first().at(0).toString(), exportFileName);
+    QVERIFY2(exportSpy.first().at(1).toBool(), qPrintable(exportSpy.first().at(2).toString()));
+
+    TerrainPack exportedPack;
+    QVERIFY2(exportedPack.open(exportFileName, errorString), qPrintable(errorString));
+    QCOMPARE(exportedPack.tileCount(), 1);
+    QCOMPARE(exportedPack.tileData(tileId(x, y)), sourceData);
+
+    // The exported pack answers queries the same as the source did
+    QVERIFY2(manager->loadTerrainPack(exportFileName, errorString), qPrintable(errorString));
+    QList<double> exportedElevations;
+    QVERIFY(manager->cachedElevations({ coordinate }, exportedElevations));
+    QCOMPARE(exportedElevations, elevations);
+
+    manager->unloadTerrainPacks();
+}
@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtCore/QTemporaryDir>
+
+/// Writes terrain packs and reads them back, directly and through a TerrainTileManager export
+class TerrainPackTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testWriteOpen();
+    void _testInvalidFile();
+    void _testExportRoundTrip();
+
+private:
+    QTemporaryDir _tempDir;
+};
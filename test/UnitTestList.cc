@@ -17,6 +17,9 @@
 
 // AnalyzeView
 #include "ExifParserTest.h"
+#include "GeoTagWorkerTest.h"
+#include "ImageIndexTest.h"
+#include "LogDownloadDataTest.h"
 // #include "MavlinkLogTest.h"
 // #include "LogDownloadTest.h"
 #include "PX4LogParserTest.h"
@@ -28,13 +31,25 @@
 // AutoPilotPlugins
 // #include "RadioConfigTest.h"
 
+// Benchmarks
+#include "PipelineBenchmark.h"
+#include "PlanningGeometryBenchmark.h"
+#include "ReplayBenchmark.h"
+
 // Comms
+#include "LinkInterfaceDecodeTest.h"
+#include "MAVLinkLogWriterTest.h"
+#include "MAVLinkMessageStatsTest.h"
+#include "MockLinkSwarmTest.h"
 #include "QGCSerialPortInfoTest.h"
 
 // FactSystem
+#include "CompiledParameterMetaDataTest.h"
+#include "FactCookedValueTest.h"
 #include "FactSystemTestGeneric.h"
 #include "FactSystemTestPX4.h"
 #include "ParameterManagerTest.h"
+#include "SettingsWriteBackTest.h"
 
 // FollowMe
 #include "FollowMeTest.h"
@@ -43,6 +58,7 @@
 #include "GeoTest.h"
 
 // MAVLink
+#include "ImageProtocolManagerTest.h"
 #include "StatusTextHandlerTest.h"
 #include "SigningTest.h"
 
@@ -51,6 +67,7 @@
 #include "CameraSectionTest.h"
 #include "CorridorScanComplexItemTest.h"
 // #include "FWLandingPatternTest.h"
+#include "GeoFenceIndexTest.h"
 // #include "LandingComplexItemTest.h"
 // #include "MissionCommandTreeEditorTest.h"
 #include "MissionCommandTreeTest.h"
@@ -59,6 +76,7 @@
 #include "MissionItemTest.h"
 #include "MissionManagerTest.h"
 #include "MissionSettingsTest.h"
+#include "MultiVehicleSurveyPlannerTest.h"
 #include "PlanMasterControllerTest.h"
 #include "QGCMapPolygonTest.h"
 #include "QGCMapPolylineTest.h"
@@ -70,6 +88,9 @@
 #include "TransectStyleComplexItemTest.h"
 // #include "VisualMissionItemTest.h"
 
+// PositionManager
+#include "GCSMotionEstimatorTest.h"
+
 // qgcunittest
 #include "ComponentInformationCacheTest.h"
 #include "ComponentInformationTranslationTest.h"
@@ -80,11 +101,18 @@
 // QmlControls
 
 // Terrain
+#include "TerrainDemTest.h"
+#include "TerrainPackTest.h"
 #include "TerrainQueryTest.h"
 
 // UI
 
 // Utilities
+#include "ArrowStreamWriterTest.h"
+#include "JsonStreamReaderTest.h"
+#include "KMLStreamWriterTest.h"
+#include "ParallelStateMachineTest.h"
+#include "ShapeFileHelperTest.h"
 // Compression
 #include "DecompressionTest.h"
 
@@ -97,6 +125,12 @@
 // #include "RequestMessageTest.h"
 // #include "SendMavCommandWithHandlerTest.h"
 // #include "SendMavCommandWithSignalingTest.h"
+#include "TrackRecorderTest.h"
+
+// Viewer3D
+#ifdef QGC_VIEWER3D
+#include "OsmParserThreadTest.h"
+#endif
 
 // Missing
 // #include "FlightGearUnitTest.h"
@@ -113,6 +147,9 @@ int runTests(bool stress, QStringView unitTestOptions)
 
 	// AnalyzeView
 	UT_REGISTER_TEST(ExifParserTest)
+	UT_REGISTER_TEST(GeoTagWorkerTest)
+	UT_REGISTER_TEST(ImageIndexTest)
+	UT_REGISTER_TEST(LogDownloadDataTest)
 	// UT_REGISTER_TEST(MavlinkLogTest)
 	// UT_REGISTER_TEST(LogDownloadTest)
 	UT_REGISTER_TEST(PX4LogParserTest)
@@ -124,13 +161,25 @@ int runTests(bool stress, QStringView unitTestOptions)
 	// AutoPilotPlugins
 	// UT_REGISTER_TEST(RadioConfigTest)
 
+	// Benchmarks
+	UT_REGISTER_TEST_STANDALONE(PipelineBenchmark)
+	UT_REGISTER_TEST_STANDALONE(PlanningGeometryBenchmark)
+	UT_REGISTER_TEST_STANDALONE(ReplayBenchmark)
+
 	// Comms
+	UT_REGISTER_TEST(LinkInterfaceDecodeTest)
+	UT_REGISTER_TEST(MAVLinkLogWriterTest)
+	UT_REGISTER_TEST(MAVLinkMessageStatsTest)
+	UT_REGISTER_TEST(MockLinkSwarmTest)
 	UT_REGISTER_TEST(QGCSerialPortInfoTest)
 
 	// FactSystem
+	UT_REGISTER_TEST(CompiledParameterMetaDataTest)
+	UT_REGISTER_TEST(FactCookedValueTest)
 	UT_REGISTER_TEST(FactSystemTestGeneric)
 	UT_REGISTER_TEST(FactSystemTestPX4)
 	UT_REGISTER_TEST(ParameterManagerTest)
+	UT_REGISTER_TEST(SettingsWriteBackTest)
 
 	// FollowMe
 	UT_REGISTER_TEST(FollowMeTest)
@@ -139,6 +188,7 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(GeoTest)
 
     // MAVLink
+    UT_REGISTER_TEST(ImageProtocolManagerTest)
     UT_REGISTER_TEST(StatusTextHandlerTest)
     UT_REGISTER_TEST(SigningTest)
 
@@ -147,6 +197,7 @@ int runTests(bool stress, QStringView unitTestOptions)
 	UT_REGISTER_TEST(CameraSectionTest)
 	UT_REGISTER_TEST(CorridorScanComplexItemTest)
 	// UT_REGISTER_TEST(FWLandingPatternTest)
+	UT_REGISTER_TEST(GeoFenceIndexTest)
 	// UT_REGISTER_TEST(LandingComplexItemTest)
 	// UT_REGISTER_TEST_STANDALONE(MissionCommandTreeEditorTest)
 	UT_REGISTER_TEST(MissionCommandTreeTest)
@@ -155,6 +206,7 @@ int runTests(bool stress, QStringView unitTestOptions)
 	UT_REGISTER_TEST(MissionItemTest)
 	UT_REGISTER_TEST(MissionManagerTest)
 	UT_REGISTER_TEST(MissionSettingsTest)
+	UT_REGISTER_TEST(MultiVehicleSurveyPlannerTest)
 	UT_REGISTER_TEST(PlanMasterControllerTest)
 	UT_REGISTER_TEST(QGCMapPolygonTest)
 	UT_REGISTER_TEST(QGCMapPolylineTest)
@@ -166,6 +218,9 @@ int runTests(bool stress, QStringView unitTestOptions)
 	UT_REGISTER_TEST(TransectStyleComplexItemTest)
 	// UT_REGISTER_TEST(VisualMissionItemTest)
 
+	// PositionManager
+	UT_REGISTER_TEST(GCSMotionEstimatorTest)
+
 	// qgcunittest
 	// UT_REGISTER_TEST(FileDialogTest)
 	// UT_REGISTER_TEST(MainWindowTest)
@@ -174,11 +229,18 @@ int runTests(bool stress, QStringView unitTestOptions)
 	// QmlControls
 
 	// Terrain
+	UT_REGISTER_TEST(TerrainDemTest)
+	UT_REGISTER_TEST(TerrainPackTest)
 	UT_REGISTER_TEST(TerrainQueryTest)
 
 	// UI
 
 	// Utilities
+	UT_REGISTER_TEST(ArrowStreamWriterTest)
+	UT_REGISTER_TEST(JsonStreamReaderTest)
+	UT_REGISTER_TEST(KMLStreamWriterTest)
+	UT_REGISTER_TEST(ParallelStateMachineTest)
+	UT_REGISTER_TEST(ShapeFileHelperTest)
 	// Compression
 	UT_REGISTER_TEST(DecompressionTest)
 
@@ -191,6 +253,12 @@ int runTests(bool stress, QStringView unitTestOptions)
 	// UT_REGISTER_TEST(RequestMessageTest)
 	// UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
 	// UT_REGISTER_TEST(SendMavCommandWithSignalingTest)
+	UT_REGISTER_TEST(TrackRecorderTest)
+
+	// Viewer3D
+#ifdef QGC_VIEWER3D
+	UT_REGISTER_TEST(OsmParserThreadTest)
+#endif
 
 	// Missing
 	// UT_REGISTER_TEST(FlightGearUnitTest)
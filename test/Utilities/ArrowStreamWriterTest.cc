@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ArrowStreamWriterTest.h"
+#include "ArrowStreamWriter.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+namespace {
+    ArrowStreamWriter testWriter(void)
+    {
+        return ArrowStreamWriter({
+            { QStringLiteral("time"),   ArrowStreamWriter::Type::TimestampMicros },
+            { QStringLiteral("alt"),    ArrowStreamWriter::Type::Float32 },
+            { QStringLiteral("text"),   ArrowStreamWriter::Type::Utf8 },
+        });
+    }
+
+    void appendRows(ArrowStreamWriter& writer, int count)
+    {
+        for (int i = 0; i < count; i++) {
+            writer.appendInteger(0, 1000000 + i);
+            writer.appendDouble(1, i * 0.5);
+            writer.appendBytes(2, QByteArray(i, 'x'));
+            writer.endRow();
+        }
+    }
+}
+
+void ArrowStreamWriterTest::_testRecordBatch(void)
+{
+    ArrowStreamWriter writer = testWriter();
+
+    const QByteArray schema = writer.schemaMessage();
+    QCOMPARE(qFromLittleEndian<quint32>(schema.constData()), 0xFFFFFFFFu);
+    const qint32 schemaMetadataLength = qFromLittleEndian<qint32>(schema.constData() + 4);
+    QCOMPARE(schemaMetadataLength % 8, 0);
+    QCOMPARE(schema.size(), 8 + schemaMetadataLength);
+    QVERIFY(schema.contains("time"));
+    QVERIFY(schema.contains("UTC"));
+
+    appendRows(writer, 3);
+    QCOMPARE(writer.rowCount(), 3);
+    QVERIFY(writer.bufferedBytes() > 0);
+
+    const QByteArray batch = writer.takeRecordBatch();
+    QCOMPARE(writer.rowCount(), 0);
+    QCOMPARE(writer.bufferedBytes(), static_cast<qint64>(4));  // Just the first offset of the Utf8 column
+    const qint32 metadataLength = qFromLittleEndian<qint32>(batch.constData() + 4);
+    QCOMPARE(metadataLength % 8, 0);
+
+    // Body: time 3 * 8, alt 3 * 4 padded to 16, text offsets 4 * 4, text "" "x" "xx" padded to 8
+    const QByteArray body = batch.mid(8 + metadataLength);
+    QCOMPARE(body.size(), 24 + 16 + 16 + 8);
+    QCOMPARE(qFromLittleEndian<qint64>(body.constData() + 16), static_cast<qint64>(1000002));
+    QCOMPARE(qFromLittleEndian<float>(body.constData() + 24 + 4), 0.5f);
+    QCOMPARE(qFromLittleEndian<qint32>(body.constData() + 40 + 12), 3);
+    QCOMPARE(body.mid(56, 3), QByteArray("xxx"));
+
+    QCOMPARE(ArrowStreamWriter::endOfStreamMessage(), QByteArray("\xFF\xFF\xFF\xFF\x00\x00\x00\x00", 8));
+}
+
+void ArrowStreamWriterTest::_testCompleteLength(void)
+{
+    ArrowStreamWriter writer = testWriter();
+
+    QByteArray stream = writer.schemaMessage();
+    appendRows(writer, 5);
+    stream += writer.takeRecordBatch();
+    const qint64 firstBatchEnd = stream.size();
+    appendRows(writer, 7);
+    stream += writer.takeRecordBatch();
+
+    bool endOfStream = true;
+    QBuffer buffer(&stream);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QCOMPARE(ArrowStreamWriter::completeLength(&buffer, &endOfStream), static_cast<qint64>(stream.size()));
+    QVERIFY(!endOfStream);
+    buffer.close();
+
+    // A stream cut off within the last batch is complete up to the previous one
+    QByteArray truncated = stream.left(stream.size() - 3);
+    QBuffer truncatedBuffer(&truncated);
+    QVERIFY(truncatedBuffer.open(QIODevice::ReadOnly));
+    QCOMPARE(ArrowStreamWriter::completeLength(&truncatedBuffer, &endOfStream), firstBatchEnd);
+    QVERIFY(!endOfStream);
+    truncatedBuffer.close();
+
+    QByteArray finished = stream + ArrowStreamWriter::endOfStreamMessage();
+    QBuffer finishedBuffer(&finished);
+    QVERIFY(finishedBuffer.open(QIODevice::ReadOnly));
+    QCOMPARE(ArrowStreamWriter::completeLength(&finishedBuffer, &endOfStream), static_cast<qint64>(finished.size()));
+    QVERIFY(endOfStream);
+}
@@ -3,6 +3,7 @@
 #include "QGCZlib.h"
 #include "QGCZip.h"
 
+#include <QtCore/QFile>
 #include <QtTest/QTest>
 
 void DecompressionTest::_testDecompressGzip()
@@ -28,3 +29,81 @@ void DecompressionTest::_testUnzip()
     const bool result = QGCZip::unzipFile(zipFilename, decompressedPath);
     QVERIFY(result);
 }
+
+void DecompressionTest::_testInflaterSlices()
+{
+    QByteArray original;
+    for (int i = 0; i < 100000; i++) {
+        original.append(QByteArray::number(i % 977));
+    }
+    // qCompress prefixes the zlib stream with the decompressed size
+    const QByteArray compressed = qCompress(original).mid(4);
+
+    QByteArray inflated;
+    QGCZlib::Inflater inflater(QGCZlib::Inflater::Format::Zlib, [&inflated](QByteArrayView data) {
+        inflated.append(data);
+        return true;
+    });
+    for (qsizetype index = 0; index < compressed.size(); index += 1000) {
+        QVERIFY(inflater.write(QByteArrayView(compressed).sliced(index, qMin<qsizetype>(1000, compressed.size() - index))));
+    }
+    QVERIFY(inflater.finished());
+    QCOMPARE(inflater.totalOut(), original.size());
+    QCOMPARE(inflated, original);
+
+    // The sink can stop the decompression
+    QGCZlib::Inflater stoppedInflater(QGCZlib::Inflater::Format::Zlib, [](QByteArrayView) { return false; });
+    QVERIFY(!stoppedInflater.write(compressed));
+    QVERIFY(!stoppedInflater.finished());
+}
+
+void DecompressionTest::_testDeflaterRoundTrip()
+{
+    QByteArray original;
+    for (int i = 0; i < 100000; i++) {
+        original.append(QByteArray::number(i % 977));
+    }
+
+    QByteArray compressed;
+    QGCZlib::Deflater deflater([&compressed](QByteArrayView data) {
+        compressed.append(data);
+        return true;
+    });
+    for (qsizetype index = 0; index < original.size(); index += 1000) {
+        QVERIFY(deflater.write(QByteArrayView(original).sliced(index, qMin<qsizetype>(1000, original.size() - index))));
+    }
+    QVERIFY(deflater.finish());
+    QCOMPARE(deflater.totalOut(), compressed.size());
+    QVERIFY(compressed.size() < original.size());
+
+    QByteArray inflated;
+    QGCZlib::Inflater inflater(QGCZlib::Inflater::Format::Gzip, [&inflated](QByteArrayView data) {
+        inflated.append(data);
+        return true;
+    });
+    QVERIFY(inflater.write(compressed));
+    QVERIFY(inflater.finished());
+    QCOMPARE(inflated, original);
+}
+
+void DecompressionTest::_testInflateLZMAStream()
+{
+    QFile lzmaFile(QStringLiteral(":/manifest.json.xz"));
+    QVERIFY(lzmaFile.open(QIODevice::ReadOnly));
+    QByteArray inflated;
+    QVERIFY(QGCLZMA::inflateLZMA(lzmaFile, [&inflated](QByteArrayView data) {
+        inflated.append(data);
+        return true;
+    }));
+
+    QFile gzipFile(QStringLiteral(":/manifest.json.gz"));
+    QVERIFY(gzipFile.open(QIODevice::ReadOnly));
+    QByteArray gzipInflated;
+    QVERIFY(QGCZlib::inflateGzip(gzipFile, [&gzipInflated](QByteArrayView data) {
+        gzipInflated.append(data);
+        return true;
+    }));
+
+    QVERIFY(!inflated.isEmpty());
+    QCOMPARE(inflated, gzipInflated);
+}
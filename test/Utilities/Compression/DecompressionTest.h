@@ -10,4 +10,7 @@ private slots:
     void _testDecompressGzip();
     void _testDecompressLZMA();
     void _testUnzip();
+    void _testInflaterSlices();
+    void _testDeflaterRoundTrip();
+    void _testInflateLZMAStream();
 };
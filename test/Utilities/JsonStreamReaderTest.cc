@@ -0,0 +1,91 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "JsonStreamReaderTest.h"
+#include "JsonStreamReader.h"
+#include "JsonHelper.h"
+
+#include <QtCore/QJsonArray>
+#include <QtTest/QTest>
+
+void JsonStreamReaderTest::_testHeader(void)
+{
+    JsonStreamReader reader;
+    QString errorString;
+
+    QVERIFY(reader.open(QByteArrayLiteral(" { \"version\": 1, \"name\": \"a\\\"b\", \"flag\": true, \"items\": [ { \"x\": \"]\" } ], \"obj\": {} } "), errorString));
+
+    const QJsonObject& header = reader.header();
+    QCOMPARE(header["version"].toInt(), 1);
+    QCOMPARE(header["name"].toString(), QStringLiteral("a\"b"));
+    QCOMPARE(header["flag"].toBool(), true);
+    QVERIFY(header["items"].isArray());
+    QVERIFY(header["items"].toArray().isEmpty());
+    QVERIFY(header["obj"].isObject());
+
+    QList<JsonHelper::KeyValidateInfo> keyInfoList = {
+        { "version",    QJsonValue::Double, true },
+        { "items",      QJsonValue::Array,  true },
+    };
+    QVERIFY(JsonHelper::validateKeys(header, keyInfoList, errorString));
+
+    const QJsonValue items = reader.value(QStringLiteral("items"), errorString);
+    QCOMPARE(items.toArray().count(), 1);
+    QCOMPARE(items.toArray()[0].toObject()["x"].toString(), QStringLiteral("]"));
+}
+
+void JsonStreamReaderTest::_testReadArray(void)
+{
+    JsonStreamReader reader;
+    QString errorString;
+
+    QVERIFY(reader.open(QByteArrayLiteral("{\"values\":[1, {\"a\":2}, [3], \"4\"], \"empty\": [ ]}"), errorString));
+
+    QList<QJsonValue> elements;
+    auto collect = [&elements](const QJsonValue& element, QString&) {
+        elements.append(element);
+        return true;
+    };
+    QVERIFY(reader.readArray(QStringLiteral("values"), collect, errorString));
+    QCOMPARE(elements.count(), 4);
+    QCOMPARE(elements[0].toInt(), 1);
+    QCOMPARE(elements[1].toObject()["a"].toInt(), 2);
+    QCOMPARE(elements[2].toArray()[0].toInt(), 3);
+    QCOMPARE(elements[3].toString(), QStringLiteral("4"));
+
+    elements.clear();
+    QVERIFY(reader.readArray(QStringLiteral("empty"), collect, errorString));
+    QVERIFY(elements.isEmpty());
+
+    // Reading stops at the first element the callback rejects
+    int count = 0;
+    QVERIFY(!reader.readArray(QStringLiteral("values"), [&count](const QJsonValue&, QString& elementErrorString) {
+        elementErrorString = QStringLiteral("stop");
+        return ++count < 2;
+    }, errorString));
+    QCOMPARE(count, 2);
+    QCOMPARE(errorString, QStringLiteral("stop"));
+}
+
+void JsonStreamReaderTest::_testMalformed(void)
+{
+    JsonStreamReader reader;
+    QString errorString;
+
+    QVERIFY(!reader.open(QByteArrayLiteral("[1, 2]"), errorString));
+    QVERIFY(!reader.open(QByteArrayLiteral("{\"a\": 1,}"), errorString));
+    QVERIFY(!reader.open(QByteArrayLiteral("{\"a\": tru}"), errorString));
+    QVERIFY(!reader.open(QByteArrayLiteral("{\"a\": [1, 2}"), errorString));
+    QVERIFY(!reader.open(QByteArrayLiteral("{\"a\": 1} x"), errorString));
+
+    // Nested values are only checked when they are read
+    QVERIFY(reader.open(QByteArrayLiteral("{\"a\": [1, {\"b\" 2}]}"), errorString));
+    QVERIFY(!reader.readArray(QStringLiteral("a"), [](const QJsonValue&, QString&) { return true; }, errorString));
+    QVERIFY(!reader.readArray(QStringLiteral("missing"), [](const QJsonValue&, QString&) { return true; }, errorString));
+}
@@ -0,0 +1,61 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "KMLStreamWriterTest.h"
+#include "KMLStreamWriter.h"
+
+#include <QtCore/QBuffer>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtTest/QTest>
+#include <QtXml/QDomDocument>
+
+void KMLStreamWriterTest::_testDocument(void)
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+
+    KMLStreamWriter kml(&buffer, QStringLiteral("Test <Doc>"));
+    kml.writeStartPlacemark(QStringLiteral("Track"), false);
+    kml.writeLookAt(QGeoCoordinate(47.5, 8.25, 100));
+    kml.writeStartElement("LineString");
+    kml.writeStartElement("coordinates");
+    for (int i=0; i<3; i++) {
+        kml.writeCharacters(KMLStreamWriter::kmlCoordString(QGeoCoordinate(47.5 + i, 8.25, 100)) + QStringLiteral("\n"));
+    }
+    // Elements left open are closed by finish
+    kml.finish();
+    QVERIFY(!kml.hasError());
+
+    QDomDocument doc;
+    QVERIFY(doc.setContent(buffer.data()));
+
+    const QDomElement kmlElement = doc.documentElement();
+    QCOMPARE(kmlElement.tagName(), QStringLiteral("kml"));
+    QCOMPARE(kmlElement.attribute(QStringLiteral("xmlns")), QStringLiteral("http://www.opengis.net/kml/2.2"));
+
+    const QDomElement documentElement = kmlElement.firstChildElement(QStringLiteral("Document"));
+    QCOMPARE(documentElement.firstChildElement(QStringLiteral("name")).text(), QStringLiteral("Test <Doc>"));
+    QCOMPARE(documentElement.firstChildElement(QStringLiteral("Style")).attribute(QStringLiteral("id")), QString(KMLStreamWriter::balloonStyleName));
+
+    const QDomElement placemarkElement = documentElement.firstChildElement(QStringLiteral("Placemark"));
+    QCOMPARE(placemarkElement.firstChildElement(QStringLiteral("name")).text(), QStringLiteral("Track"));
+    QCOMPARE(placemarkElement.firstChildElement(QStringLiteral("visibility")).text(), QStringLiteral("0"));
+    QCOMPARE(placemarkElement.firstChildElement(QStringLiteral("LookAt")).firstChildElement(QStringLiteral("latitude")).text(), QStringLiteral("47.5000000"));
+
+    const QString coordinates = placemarkElement.firstChildElement(QStringLiteral("LineString")).firstChildElement(QStringLiteral("coordinates")).text();
+    QCOMPARE(coordinates.split(QLatin1Char('\n'), Qt::SkipEmptyParts),
+             QStringList({ QStringLiteral("8.2500000,47.5000000,100.00"), QStringLiteral("8.2500000,48.5000000,100.00"), QStringLiteral("8.2500000,49.5000000,100.00") }));
+}
+
+void KMLStreamWriterTest::_testStrings(void)
+{
+    QCOMPARE(KMLStreamWriter::kmlCoordString(QGeoCoordinate(-33.25, 151.125)), QStringLiteral("151.1250000,-33.2500000,0.00"));
+    // aabbggrr
+    QCOMPARE(KMLStreamWriter::kmlColorString(QColor(0x11, 0x22, 0x33), 0.5), QStringLiteral("7f332211"));
+}
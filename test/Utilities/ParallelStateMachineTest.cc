@@ -0,0 +1,167 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParallelStateMachineTest.h"
+#include "ParallelStateMachine.h"
+
+#include <QtCore/QRegularExpression>
+#include <QtCore/QTimer>
+#include <QtTest/QTest>
+
+namespace {
+
+/// Two independent branches A and B, C waits for both of them and D only for A:
+///     A -> C, A -> D, B -> C
+class TestStateMachine : public ParallelStateMachine
+{
+public:
+    enum StateMode_t {
+        CompleteNow,        ///< State completes from within its state function
+        CompleteManually,   ///< Test completes the state
+        FailNow,            ///< State fails right away and reports it by completing, as the initial connect requests do
+        TimeoutThenFail,    ///< State gets no response, fails once its timeout expires and completes
+    };
+
+    static constexpr int stateTimeoutMsecs = 50;
+
+    int stateCount(void) const final { return _cStates; }
+    const StateFn* rgStates(void) const final { return &_rgStates[0]; }
+    quint32 stateDependencies(int stateIndex) const final { return _rgStateDependencies[stateIndex]; }
+
+    void statesCompleted(void) const final { completedCount++; }
+
+    StateMode_t mode[4] = { CompleteNow, CompleteNow, CompleteNow, CompleteNow };
+    QStringList started;
+    QStringList failed;
+    mutable int completedCount = 0;
+
+    static void stateA(StateMachine* stateMachine) { static_cast<TestStateMachine*>(stateMachine)->_runState(0, stateA); }
+    static void stateB(StateMachine* stateMachine) { static_cast<TestStateMachine*>(stateMachine)->_runState(1, stateB); }
+    static void stateC(StateMachine* stateMachine) { static_cast<TestStateMachine*>(stateMachine)->_runState(2, stateC); }
+    static void stateD(StateMachine* stateMachine) { static_cast<TestStateMachine*>(stateMachine)->_runState(3, stateD); }
+
+private:
+    void _runState(int stateIndex, StateFn stateFn)
+    {
+        const QString name(QChar('A' + stateIndex));
+        started.append(name);
+
+        switch (mode[stateIndex]) {
+        case CompleteNow:
+            stateComplete(stateFn);
+            break;
+        case CompleteManually:
+            break;
+        case FailNow:
+            failed.append(name);
+            stateComplete(stateFn);
+            break;
+        case TimeoutThenFail:
+            QTimer::singleShot(stateTimeoutMsecs, this, [this, name, stateFn]() {
+                failed.append(name);
+                stateComplete(stateFn);
+            });
+            break;
+        }
+    }
+
+    static constexpr int _cStates = 4;
+    static constexpr StateFn _rgStates[_cStates] = { stateA, stateB, stateC, stateD };
+    static constexpr quint32 _rgStateDependencies[_cStates] = { 0, 0, (1u << 0) | (1u << 1), (1u << 0) };
+};
+
+}
+
+void ParallelStateMachineTest::_testAllBranchesComplete(void)
+{
+    TestStateMachine stateMachine;
+    stateMachine.mode[0] = TestStateMachine::CompleteManually;
+    stateMachine.mode[1] = TestStateMachine::CompleteManually;
+
+    stateMachine.start();
+
+    // Both independent branches run at the same time, the states depending on them wait
+    QCOMPARE(stateMachine.started, QStringList({ "A", "B" }));
+    QVERIFY(stateMachine.stateRunning(TestStateMachine::stateA));
+    QVERIFY(stateMachine.stateRunning(TestStateMachine::stateB));
+    QVERIFY(!stateMachine.stateRunning(TestStateMachine::stateC));
+
+    // D only needs A, C still waits for B
+    stateMachine.stateComplete(TestStateMachine::stateA);
+    QCOMPARE(stateMachine.started, QStringList({ "A", "B", "D" }));
+    QVERIFY(stateMachine.stateCompleted(TestStateMachine::stateD));
+    QVERIFY(!stateMachine.stateCompleted(TestStateMachine::stateC));
+    QVERIFY(stateMachine.active());
+    QCOMPARE(stateMachine.completedCount, 0);
+
+    stateMachine.stateComplete(TestStateMachine::stateB);
+    QCOMPARE(stateMachine.started, QStringList({ "A", "B", "D", "C" }));
+    QVERIFY(!stateMachine.active());
+    QCOMPARE(stateMachine.completedCount, 1);
+    QVERIFY(stateMachine.failed.isEmpty());
+
+    // Late completions after the machine finished are ignored
+    stateMachine.stateComplete(TestStateMachine::stateA);
+    QCOMPARE(stateMachine.completedCount, 1);
+
+    // The machine can be run again
+    stateMachine.mode[0] = TestStateMachine::CompleteNow;
+    stateMachine.mode[1] = TestStateMachine::CompleteNow;
+    stateMachine.started.clear();
+    stateMachine.start();
+    QCOMPARE(stateMachine.started.count(), 4);
+    QCOMPARE(stateMachine.completedCount, 2);
+}
+
+void ParallelStateMachineTest::_testBranchFailure(void)
+{
+    TestStateMachine stateMachine;
+    stateMachine.mode[1] = TestStateMachine::FailNow;
+
+    stateMachine.start();
+
+    // A failed branch doesn't hold up the rest, the states depending on it run with whatever it left behind
+    QCOMPARE(stateMachine.failed, QStringList({ "B" }));
+    QCOMPARE(stateMachine.started.count(), 4);
+    QVERIFY(stateMachine.stateCompleted(TestStateMachine::stateC));
+    QVERIFY(!stateMachine.active());
+    QCOMPARE(stateMachine.completedCount, 1);
+
+    // Completing a state which isn't running is ignored
+    stateMachine.mode[1] = TestStateMachine::CompleteManually;
+    stateMachine.started.clear();
+    stateMachine.start();
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("not running"));
+    stateMachine.stateComplete(TestStateMachine::stateC);
+    QVERIFY(stateMachine.active());
+    QVERIFY(!stateMachine.stateCompleted(TestStateMachine::stateC));
+    stateMachine.stateComplete(TestStateMachine::stateB);
+    QCOMPARE(stateMachine.completedCount, 2);
+}
+
+void ParallelStateMachineTest::_testBranchTimeout(void)
+{
+    TestStateMachine stateMachine;
+    stateMachine.mode[0] = TestStateMachine::TimeoutThenFail;
+
+    stateMachine.start();
+
+    // B finishes while A waits for its timeout, nothing depending on A starts meanwhile
+    QVERIFY(stateMachine.stateCompleted(TestStateMachine::stateB));
+    QVERIFY(stateMachine.stateRunning(TestStateMachine::stateA));
+    QCOMPARE(stateMachine.started, QStringList({ "A", "B" }));
+    QVERIFY(stateMachine.active());
+
+    QCOMPARE(stateMachine.completedCount, 0);
+    QTRY_COMPARE_WITH_TIMEOUT(stateMachine.completedCount, 1, TestStateMachine::stateTimeoutMsecs * 20);
+    QCOMPARE(stateMachine.failed, QStringList({ "A" }));
+    QCOMPARE(stateMachine.started, QStringList({ "A", "B", "C", "D" }));
+    QVERIFY(!stateMachine.active());
+    QCOMPARE(stateMachine.completedCount, 1);
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ShapeFileHelperTest.h"
+#include "ShapeFileHelper.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+void ShapeFileHelperTest::_testLoadAllShapesKML(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString fileName = tempDir.filePath(QStringLiteral("overlay.kml"));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    (void) file.write(R"(<?xml version="1.0" encoding="UTF-8"?>
+<kml xmlns="http://www.opengis.net/kml/2.2">
+<Document>
+  <Folder>
+    <Placemark>
+      <Polygon>
+        <outerBoundaryIs><LinearRing><coordinates>
+          8.0,47.0,0 8.1,47.0,0 8.1,47.1,0 8.0,47.1,0 8.0,47.0,0
+        </coordinates></LinearRing></outerBoundaryIs>
+        <innerBoundaryIs><LinearRing><coordinates>
+          8.04,47.04 8.06,47.04 8.06,47.06 8.04,47.04
+        </coordinates></LinearRing></innerBoundaryIs>
+      </Polygon>
+    </Placemark>
+    <Placemark>
+      <MultiGeometry>
+        <Point><coordinates>8.5,47.5,0</coordinates></Point>
+        <LineString><coordinates>9.0,46.0 9.5,46.5</coordinates></LineString>
+      </MultiGeometry>
+    </Placemark>
+  </Folder>
+</Document>
+</kml>
+)");
+    file.close();
+
+    QList<ShapeFileHelper::Shape_t> shapes;
+    QString errorString;
+    QVERIFY(ShapeFileHelper::loadAllShapesFromFile(fileName, shapes, errorString));
+    QVERIFY(errorString.isEmpty());
+    QCOMPARE(shapes.count(), 2);
+
+    QCOMPARE(shapes[0].type, ShapeFileHelper::Polygon);
+    QCOMPARE(shapes[0].parts.count(), 2);
+    QCOMPARE(shapes[0].parts[0].count(), 5);
+    QCOMPARE(shapes[0].parts[0][1], QPointF(8.1, 47.0));
+    QCOMPARE(shapes[0].parts[1].count(), 4);
+
+    QCOMPARE(shapes[1].type, ShapeFileHelper::Polyline);
+    QCOMPARE(shapes[1].parts.count(), 1);
+    QCOMPARE(shapes[1].parts[0], QList<QPointF>({ QPointF(9.0, 46.0), QPointF(9.5, 46.5) }));
+}
+
+void ShapeFileHelperTest::_testLoadAllShapesError(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString fileName = tempDir.filePath(QStringLiteral("points.kml"));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    (void) file.write(R"(<?xml version="1.0" encoding="UTF-8"?>
+<kml xmlns="http://www.opengis.net/kml/2.2"><Placemark><Point><coordinates>8.5,47.5,0</coordinates></Point></Placemark></kml>
+)");
+    file.close();
+
+    QList<ShapeFileHelper::Shape_t> shapes;
+    QString errorString;
+    QVERIFY(!ShapeFileHelper::loadAllShapesFromFile(fileName, shapes, errorString));
+    QVERIFY(!errorString.isEmpty());
+    QVERIFY(shapes.isEmpty());
+
+    QVERIFY(!ShapeFileHelper::loadAllShapesFromFile(tempDir.filePath(QStringLiteral("missing.txt")), shapes, errorString));
+    QVERIFY(!errorString.isEmpty());
+}
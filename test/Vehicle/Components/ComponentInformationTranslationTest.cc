@@ -40,6 +40,25 @@ void ComponentInformationTranslationTest::_basic_test()
     QVERIFY(expectedJson == translatedJson);
 }
 
+void ComponentInformationTranslationTest::_cancel_test()
+{
+    QString translationJson = ":/unittest/TranslationTest.json";
+    QString translationTs = ":/unittest/TranslationTest_de_DE.ts";
+
+    QAtomicInteger<bool> cancel = true;
+    QVERIFY(ComponentInformationTranslation::translateJsonUsingTS(translationJson, translationTs, &cancel).isEmpty());
+
+    // Not cancelled each translation gets its own file
+    cancel = false;
+    QString tempFilename1 = ComponentInformationTranslation::translateJsonUsingTS(translationJson, translationTs, &cancel);
+    QString tempFilename2 = ComponentInformationTranslation::translateJsonUsingTS(translationJson, translationTs, &cancel);
+    QVERIFY(!tempFilename1.isEmpty());
+    QVERIFY(!tempFilename2.isEmpty());
+    QVERIFY(tempFilename1 != tempFilename2);
+    QFile(tempFilename1).remove();
+    QFile(tempFilename2).remove();
+}
+
 void ComponentInformationTranslationTest::readJson(const QByteArray& bytes, QJsonDocument& jsonDoc)
 {
     QJsonParseError parseError;
@@ -25,6 +25,7 @@ public:
 
 private slots:
     void _basic_test();
+    void _cancel_test();
 private:
     void readJson(const QByteArray& bytes, QJsonDocument& jsonDoc);
 };
@@ -125,6 +125,39 @@ void FTPManagerTest::_testLostPackets(void)
     _disconnectMockLink();
 }
 
+void FTPManagerTest::_testParallelDownloads(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager*         ftpManager  = _vehicle->ftpManager();
+    const QList<int>    rgFileSizes = { 2 * 1024, 3 * 1024 };
+    QStringList         rgFiles;
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    // MockLink only has a single session, the second download has to wait for the first one
+    for (int fileSize: rgFileSizes) {
+        QString filename = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+        rgFiles.append(ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+        QVERIFY(!rgFiles.last().isEmpty());
+    }
+
+    for (int i=0; i<rgFileSizes.count() && spyDownloadComplete.count() < rgFileSizes.count(); i++) {
+        QVERIFY(spyDownloadComplete.wait(10000));
+    }
+    QCOMPARE(spyDownloadComplete.count(), rgFileSizes.count());
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    for (const QList<QVariant>& arguments: spyDownloadComplete) {
+        QVERIFY(arguments[1].toString().isEmpty());
+        const int index = rgFiles.indexOf(arguments[0].toString());
+        QVERIFY(index != -1);
+        _verifyFileSizeAndDelete(rgFiles[index], rgFileSizes[index]);
+    }
+
+    _disconnectMockLink();
+}
+
 void FTPManagerTest::_verifyFileSizeAndDelete(const QString& filename, int expectedSize)
 {
     QFileInfo fileInfo(filename);
@@ -17,6 +17,7 @@ class FTPManagerTest : public UnitTest
 
 private slots:
     void _testLostPackets                               (void);
+    void _testParallelDownloads                         (void);
     void _testListDirectory                             (void);
     void _testListDirectoryNoResponse                   (void);
     void _testListDirectoryNakResponse                  (void);
@@ -0,0 +1,151 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TrackRecorderTest.h"
+#include "TrackRecorder.h"
+
+#include <QtCore/QFile>
+#include <QtTest/QTest>
+
+#include <cmath>
+
+namespace {
+    struct TestSample_t {
+        quint64 timestampMsecs;
+        qint64  latitude;   ///< 1e-7 degrees
+        qint64  longitude;  ///< 1e-7 degrees
+        qint64  altitude;   ///< millimeters
+    };
+
+    // Small and large steps of either sign, so one and multi byte varints are both covered
+    const TestSample_t rgSamples[] = {
+        { 1718000000000ull,  473977419,   85455938,    488123 },
+        { 1718000000100ull,  473977420,   85455937,    488100 },
+        { 1718000000200ull,  473977420,   85455937,    488100 },
+        { 1718000005000ull, -335000000, -1512000000,  -12000 },
+        { 1718000005100ull,  900000000,  1800000000, 8848000 },
+    };
+    const int cSamples = sizeof(rgSamples) / sizeof(rgSamples[0]);
+}
+
+QString TrackRecorderTest::_writeTrackFile(const QString& name, const QByteArray& records)
+{
+    const QString fileName = _tempDir.filePath(name);
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return QString();
+    }
+    (void) file.write(TrackRecorder::_magic, TrackRecorder::_magicLength);
+    (void) file.write(&TrackRecorder::_version, 1);
+    (void) file.write(records);
+    return fileName;
+}
+
+void TrackRecorderTest::_roundTripTest(void)
+{
+    QVERIFY(_tempDir.isValid());
+
+    QByteArray records;
+    TestSample_t last = { 0, 0, 0, 0 };
+    for (const TestSample_t& sample : rgSamples) {
+        TrackRecorder::_appendVarint(records, static_cast<qint64>(sample.timestampMsecs - last.timestampMsecs));
+        TrackRecorder::_appendVarint(records, sample.latitude - last.latitude);
+        TrackRecorder::_appendVarint(records, sample.longitude - last.longitude);
+        TrackRecorder::_appendVarint(records, sample.altitude - last.altitude);
+        last = sample;
+    }
+
+    const QString fileName = _writeTrackFile(QStringLiteral("roundtrip.qgctrack"), records);
+    QVERIFY(!fileName.isEmpty());
+
+    QList<TrackRecorder::Sample> samples;
+    QString errorString;
+    QVERIFY2(TrackRecorder::loadSamples(fileName, samples, errorString), qPrintable(errorString));
+    QVERIFY(errorString.isEmpty());
+    QCOMPARE(samples.count(), cSamples);
+
+    for (int i = 0; i < cSamples; i++) {
+        const TestSample_t& expected = rgSamples[i];
+        QCOMPARE(samples[i].timestampMsecs, expected.timestampMsecs);
+        QCOMPARE(std::llround(samples[i].coordinate.latitude() * 1e7), expected.latitude);
+        QCOMPARE(std::llround(samples[i].coordinate.longitude() * 1e7), expected.longitude);
+        QCOMPARE(std::llround(samples[i].coordinate.altitude() * 1000.0), expected.altitude);
+    }
+}
+
+void TrackRecorderTest::_truncatedFileTest(void)
+{
+    QVERIFY(_tempDir.isValid());
+
+    QByteArray records;
+    TrackRecorder::_appendVarint(records, 1000);
+    TrackRecorder::_appendVarint(records, 473977419);
+    TrackRecorder::_appendVarint(records, 85455938);
+    TrackRecorder::_appendVarint(records, 488123);
+    const int firstRecordSize = records.size();
+
+    // Second record cut off inside its latitude, as left by a recording which didn't stop cleanly
+    TrackRecorder::_appendVarint(records, 100);
+    TrackRecorder::_appendVarint(records, 1000000);
+    records.chop(1);
+    QVERIFY(records.size() > firstRecordSize);
+
+    const QString fileName = _writeTrackFile(QStringLiteral("truncated.qgctrack"), records);
+    QVERIFY(!fileName.isEmpty());
+
+    QList<TrackRecorder::Sample> samples;
+    QString errorString;
+    QVERIFY(TrackRecorder::loadSamples(fileName, samples, errorString));
+    QVERIFY(errorString.isEmpty());
+    QCOMPARE(samples.count(), 1);
+    QCOMPARE(samples[0].timestampMsecs, 1000ull);
+    QCOMPARE(std::llround(samples[0].coordinate.latitude() * 1e7), 473977419ll);
+}
+
+void TrackRecorderTest::_malformedFileTest(void)
+{
+    QVERIFY(_tempDir.isValid());
+
+    QByteArray records;
+    TrackRecorder::_appendVarint(records, 1000);
+    TrackRecorder::_appendVarint(records, 473977419);
+    TrackRecorder::_appendVarint(records, 85455938);
+    TrackRecorder::_appendVarint(records, 488123);
+    // A varint which never ends within 64 bits, followed by more data
+    records.append(11, static_cast<char>(0xFF));
+    records.append(4, '\0');
+
+    const QString fileName = _writeTrackFile(QStringLiteral("malformed.qgctrack"), records);
+    QVERIFY(!fileName.isEmpty());
+
+    QList<TrackRecorder::Sample> samples;
+    QString errorString;
+    QVERIFY(!TrackRecorder::loadSamples(fileName, samples, errorString));
+    QVERIFY(!errorString.isEmpty());
+    QCOMPARE(samples.count(), 1);
+}
+
+void TrackRecorderTest::_invalidHeaderTest(void)
+{
+    QVERIFY(_tempDir.isValid());
+
+    const QString fileName = _tempDir.filePath(QStringLiteral("invalid.qgctrack"));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    (void) file.write("NOTATRACK");
+    file.close();
+
+    QList<TrackRecorder::Sample> samples;
+    QString errorString;
+    QVERIFY(!TrackRecorder::loadSamples(fileName, samples, errorString));
+    QVERIFY(!errorString.isEmpty());
+    QVERIFY(samples.isEmpty());
+
+    QVERIFY(!TrackRecorder::loadSamples(_tempDir.filePath(QStringLiteral("missing.qgctrack")), samples, errorString));
+}
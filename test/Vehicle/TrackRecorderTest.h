@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtCore/QTemporaryDir>
+
+/// Encodes track files as TrackRecorder writes them and reads them back with TrackRecorder::loadSamples
+class TrackRecorderTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _roundTripTest     (void);
+    void _truncatedFileTest (void);
+    void _malformedFileTest (void);
+    void _invalidHeaderTest (void);
+
+private:
+    QString _writeTrackFile(const QString& name, const QByteArray& records);
+
+    QTemporaryDir _tempDir;
+};
@@ -319,6 +319,43 @@ void VehicleLinkManagerTest::_highLatencyLinkTest(void)
     spyTransmissionEnabledChanged.clear();
 }
 
+void VehicleLinkManagerTest::_duplicateMessageTest(void)
+{
+    SharedLinkConfigurationPtr  mockConfig1;
+    SharedLinkInterfacePtr      mockLink1;
+    SharedLinkConfigurationPtr  mockConfig2;
+    SharedLinkInterfacePtr      mockLink2;
+
+    QSignalSpy spyVehicleCreate(_multiVehicleMgr, &MultiVehicleManager::activeVehicleChanged);
+
+    _startMockLink(1, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig1, mockLink1);
+    _startMockLink(2, false /*highLatency*/, false /*incrementVehicleId*/, mockConfig2, mockLink2);
+
+    QCOMPARE(spyVehicleCreate.wait(1000),           true);
+    Vehicle* vehicle = _multiVehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    QSignalSpy spyVehicleInitialConnectComplete(vehicle, &Vehicle::initialConnectComplete);
+    QCOMPARE(spyVehicleInitialConnectComplete.wait(3000), true);
+    VehicleLinkManager* vehicleLinkManager = vehicle->vehicleLinkManager();
+    QCOMPARE(vehicleLinkManager->linkNames().count(), 2);
+
+    mavlink_message_t message;
+    mavlink_msg_system_time_pack_chan(vehicle->id(), MAV_COMP_ID_AUTOPILOT1, mockLink1->mavlinkChannel(), &message, 1234, 5678);
+
+    // A copy from a second link is a duplicate, a repeat on the same link is not
+    QCOMPARE(vehicleLinkManager->isDuplicateMessage(mockLink1.get(), message), false);
+    QCOMPARE(vehicleLinkManager->isDuplicateMessage(mockLink2.get(), message), true);
+    QCOMPARE(vehicleLinkManager->isDuplicateMessage(mockLink1.get(), message), false);
+
+    // Only repeatable control messages go out on the secondary link, and only when enabled
+    QVERIFY(vehicleLinkManager->redundantSendLinks(mockLink1.get(), MAVLINK_MSG_ID_MANUAL_CONTROL).isEmpty());
+    vehicleLinkManager->setRedundantSend(true);
+    const QList<SharedLinkInterfacePtr> redundantLinks = vehicleLinkManager->redundantSendLinks(mockLink1.get(), MAVLINK_MSG_ID_MANUAL_CONTROL);
+    QCOMPARE(redundantLinks.count(), 1);
+    QCOMPARE(redundantLinks[0], mockLink2);
+    QVERIFY(vehicleLinkManager->redundantSendLinks(mockLink1.get(), MAVLINK_MSG_ID_COMMAND_LONG).isEmpty());
+}
+
 void VehicleLinkManagerTest::_startMockLink(int mockIndex, bool highLatency, bool incrementVehicleId, SharedLinkConfigurationPtr& mockConfig, SharedLinkInterfacePtr& mockLink)
 {
     MockConfiguration* pMockConfig = new MockConfiguration(QStringLiteral("Mock %1").arg(mockIndex));
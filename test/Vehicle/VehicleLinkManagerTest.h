@@ -34,6 +34,7 @@ private slots:
     void _multiLinkSingleVehicleTest(void);
     void _connectionRemovedTest     (void);
     void _highLatencyLinkTest       (void);
+    void _duplicateMessageTest      (void);
 
 private:
     void _startMockLink(int mockIndex, bool highLatency, bool incrementVehicleId, SharedLinkConfigurationPtr& sharedConfig, SharedLinkInterfacePtr& mockLink);
@@ -0,0 +1,125 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "OsmParserThreadTest.h"
+#include "OsmParserThread.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
+#include <QtTest/QTest>
+
+namespace {
+    /// Two chunks, the first with two buildings sharing its vertices
+    OsmParserThread::MeshChunks_t testChunks()
+    {
+        OsmParserThread::MeshChunks_t meshChunks;
+
+        OsmParserThread::MeshChunk_t& first = meshChunks[OsmParserThread::chunkKey(0, 0)];
+        for (int i = 0; i < 9; i++) {
+            first.vertices.push_back(QVector3D(i, -i, (i % 2) ? 1.0f : 0.0f));
+        }
+        first.buildings.push_back({ 6, 12.5f, 0.0f });
+        first.buildings.push_back({ 3, 0.0f, 4.0f });
+
+        OsmParserThread::MeshChunk_t& second = meshChunks[OsmParserThread::chunkKey(-3, 7)];
+        for (int i = 0; i < 3; i++) {
+            second.vertices.push_back(QVector3D(100.0f + i, 200.0f, 1.0f));
+        }
+        second.buildings.push_back({ 3, 0.0f, 2.0f });
+
+        return meshChunks;
+    }
+
+    QByteArray writeChunks(const OsmParserThread::MeshChunks_t& meshChunks)
+    {
+        QByteArray bytes;
+        QBuffer buffer(&bytes);
+        (void) buffer.open(QIODevice::WriteOnly);
+        QDataStream stream(&buffer);
+        stream.setVersion(QDataStream::Qt_6_0);
+        OsmParserThread::writeMeshChunks(stream, meshChunks);
+        return bytes;
+    }
+
+    bool readChunks(QByteArray bytes, OsmParserThread::MeshChunks_t& meshChunks)
+    {
+        QBuffer buffer(&bytes);
+        (void) buffer.open(QIODevice::ReadOnly);
+        QDataStream stream(&buffer);
+        stream.setVersion(QDataStream::Qt_6_0);
+        return OsmParserThread::readMeshChunks(stream, meshChunks);
+    }
+}
+
+void OsmParserThreadTest::_testMeshCacheRoundTrip()
+{
+    const OsmParserThread::MeshChunks_t meshChunks = testChunks();
+
+    OsmParserThread::MeshChunks_t loaded;
+    QVERIFY(readChunks(writeChunks(meshChunks), loaded));
+    QCOMPARE(loaded.size(), meshChunks.size());
+
+    for (auto it = meshChunks.cbegin(); it != meshChunks.cend(); ++it) {
+        QVERIFY(loaded.contains(it.key()));
+        const OsmParserThread::MeshChunk_t& chunk = loaded[it.key()];
+        QVERIFY(chunk.vertices == it.value().vertices);
+        QCOMPARE(chunk.buildings.size(), it.value().buildings.size());
+        for (size_t i = 0; i < chunk.buildings.size(); i++) {
+            QCOMPARE(chunk.buildings[i].vertexCount, it.value().buildings[i].vertexCount);
+            QCOMPARE(chunk.buildings[i].height, it.value().buildings[i].height);
+            QCOMPARE(chunk.buildings[i].levels, it.value().buildings[i].levels);
+        }
+    }
+}
+
+void OsmParserThreadTest::_testTruncatedMeshCache()
+{
+    const QByteArray bytes = writeChunks(testChunks());
+
+    // Every cut, including one inside the chunk count and one inside the vertex data, must be rejected
+    for (const qsizetype length : { qsizetype(0), qsizetype(2), qsizetype(10), bytes.size() / 2, bytes.size() - 1 }) {
+        OsmParserThread::MeshChunks_t loaded;
+        QVERIFY2(!readChunks(bytes.left(length), loaded), qPrintable(QStringLiteral("length %1").arg(length)));
+    }
+}
+
+void OsmParserThreadTest::_testCorruptMeshCache()
+{
+    // Chunk count far beyond the data which follows
+    {
+        QByteArray bytes;
+        QDataStream stream(&bytes, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << quint32(0xFFFFFFFF) << quint64(0) << quint32(0) << quint32(0);
+
+        OsmParserThread::MeshChunks_t loaded;
+        QVERIFY(!readChunks(bytes, loaded));
+    }
+
+    // Building and vertex counts which would overflow an int byte count
+    {
+        QByteArray bytes;
+        QDataStream stream(&bytes, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << quint32(1) << quint64(0) << quint32(0xFFFFFFFF) << quint32(0xFFFFFFFF);
+        bytes.append(64, '\0');
+
+        OsmParserThread::MeshChunks_t loaded;
+        QVERIFY(!readChunks(bytes, loaded));
+    }
+
+    // Buildings which claim more vertices than the chunk holds
+    {
+        OsmParserThread::MeshChunks_t meshChunks = testChunks();
+        meshChunks[OsmParserThread::chunkKey(0, 0)].buildings[1].vertexCount = 300;
+
+        OsmParserThread::MeshChunks_t loaded;
+        QVERIFY(!readChunks(writeChunks(meshChunks), loaded));
+    }
+}